@@ -23,6 +23,15 @@ if(X11_FOUND)
   set(EQ_GLX_USED 1)
 endif()
 
+# headless rendering on GPUs without an X server
+if(EQ_GLX_USED AND NOT APPLE)
+  find_path(EGL_INCLUDE_DIR EGL/egl.h)
+  find_library(EGL_LIBRARY EGL)
+  if(EGL_INCLUDE_DIR AND EGL_LIBRARY)
+    set(EQ_EGL_USED 1)
+  endif()
+endif()
+
 if(Qt4_FOUND OR QT4_FOUND AND QTVERSION VERSION_LESS 4.7)
   set(QT4_FOUND)
   set(Qt4_FOUND)
@@ -54,6 +63,9 @@ if(EQ_GLX_USED)
   list(APPEND FIND_PACKAGES_DEFINES GLX) # deprecated
   list(APPEND FIND_PACKAGES_DEFINES EQ_GLX_USED)
 endif()
+if(EQ_EGL_USED)
+  list(APPEND FIND_PACKAGES_DEFINES EQ_EGL_USED)
+endif()
 if(EQ_AGL_USED)
   list(APPEND FIND_PACKAGES_DEFINES AGL) # deprecated
   list(APPEND FIND_PACKAGES_DEFINES EQ_AGL_USED)
@@ -76,3 +88,12 @@ endif()
 if(HWLOC_GL_FOUND)
   list(APPEND FIND_PACKAGES_DEFINES EQUALIZER_USE_HWLOC_GL)
 endif()
+
+# H.264 image compression
+option(EQUALIZER_USE_LIBAVCODEC "Test for libavcodec H.264 support" ON)
+if(EQUALIZER_USE_LIBAVCODEC AND PKG_CONFIG_EXECUTABLE)
+  pkg_check_modules(LIBAVCODEC QUIET libavcodec libavutil libswscale)
+endif()
+if(LIBAVCODEC_FOUND)
+  list(APPEND FIND_PACKAGES_DEFINES EQUALIZER_USE_LIBAVCODEC)
+endif()
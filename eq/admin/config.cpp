@@ -30,6 +30,10 @@
 #include "view.h"
 #include "window.h"
 
+#include <eq/fabric/commands.h>
+#include <co/objectICommand.h>
+#include <co/objectOCommand.h>
+
 namespace eq
 {
 namespace admin
@@ -41,6 +45,16 @@ Config::Config( ServerPtr parent )
 Config::~Config()
 {}
 
+void Config::attach( const uint128_t& id, const uint32_t instanceID )
+{
+    Super::attach( id, instanceID );
+
+    registerCommand( fabric::CMD_CONFIG_GET_METRICS_REPLY,
+                     co::CommandFunc< Config >( this,
+                                                &Config::_cmdGetMetricsReply ),
+                     getMainThreadQueue( ));
+}
+
 co::CommandQueue* Config::getMainThreadQueue()
 {
     return getClient()->getMainThreadQueue();
@@ -61,6 +75,37 @@ uint128_t Config::commit( const uint32_t /*incarnation*/ )
     return Super::commit( CO_COMMIT_NEXT );
 }
 
+void Config::dumpTrace( const std::string& filename )
+{
+    send( getServer(), fabric::CMD_CONFIG_DUMP_TRACE ) << filename;
+}
+
+std::string Config::getMetrics()
+{
+    ClientPtr client = getClient();
+    std::string metrics;
+    const lunchbox::Request< void >& request =
+        client->registerRequest< void >( &metrics );
+    send( getServer(), fabric::CMD_CONFIG_GET_METRICS ) << request.getID();
+
+    while( !request.isReady( ))
+        client->processCommand();
+    return metrics;
+}
+
+bool Config::_cmdGetMetricsReply( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    const uint32_t requestID = command.read< uint32_t >();
+
+    ClientPtr client = getClient();
+    std::string* metrics =
+        static_cast< std::string* >( client->getRequestData( requestID ));
+    *metrics = command.read< std::string >();
+    client->serveRequest( requestID );
+    return true;
+}
+
 }
 }
 
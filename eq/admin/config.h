@@ -50,6 +50,30 @@ public:
     EQADMIN_API virtual uint128_t commit( const uint32_t incarnation =
                                           CO_COMMIT_NEXT );
 
+    /**
+     * Write the statistics trace recorded by the server.
+     *
+     * @param filename the file to write, or empty for the default file.
+     * @sa eq::Config::dumpTrace()
+     * @version 1.8
+     */
+    EQADMIN_API void dumpTrace( const std::string& filename = std::string( ));
+
+    /**
+     * Get the live performance metrics of the running config.
+     *
+     * The server aggregates the statistics of all channels, windows and pipes,
+     * and exports the state of all equalizers: their damping, activity, the
+     * target framerate and zoom of DFR equalizers and the share of each
+     * child compound. The metrics are collected from the first request on
+     * unless the server already serves them over HTTP. Equalizer parameters
+     * are changed at runtime using View::getEqualizer() and commit().
+     *
+     * @return the metrics in the Prometheus text format.
+     * @version 1.9
+     */
+    EQADMIN_API std::string getMetrics();
+
     /** @internal */
     const Channel* findChannel( const std::string& name ) const
     { return find< Channel >( name ); }
@@ -57,6 +81,13 @@ public:
     void output( std::ostream& ) const {} //!< @internal
     virtual bool mapViewObjects() const { return true; } //!< @internal
     virtual bool mapNodeObjects() const { return true; } //!< @internal
+
+    /** @internal */
+    EQADMIN_API virtual void attach( const uint128_t& id,
+                                     const uint32_t instanceID );
+
+private:
+    bool _cmdGetMetricsReply( co::ICommand& command );
 };
 }
 }
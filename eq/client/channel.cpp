@@ -26,7 +26,10 @@
 #ifndef EQ_2_0_API
 #  include "configEvent.h"
 #endif
+#include "detail/blocks.h"
 #include "detail/fileFrameWriter.h"
+#include "detail/sharedImageArena.h"
+#include "detail/spans.h"
 #include "error.h"
 #include "frame.h"
 #include "frameData.h"
@@ -37,6 +40,7 @@
 #include "log.h"
 #include "node.h"
 #include "nodeFactory.h"
+#include "observer.h"
 #include "pipe.h"
 #include "pixelData.h"
 #include "server.h"
@@ -50,13 +54,15 @@
 #include <eq/fabric/frameData.h>
 #include <eq/fabric/task.h>
 #include <eq/fabric/tile.h>
+#include <eq/fabric/wall.h>
 
 #include <co/connectionDescription.h>
 #include <co/exception.h>
 #include <co/objectICommand.h>
 #include <co/queueSlave.h>
 #include <co/sendToken.h>
-#include <lunchbox/rng.h>
+#include <lunchbox/bitOperation.h>
+#include <lunchbox/clock.h>
 #include <lunchbox/scopedMutex.h>
 #include <pression/plugins/compressor.h>
 
@@ -65,7 +71,10 @@
 #  include <GLStats/GLStats.h>
 #endif
 
+#include <algorithm>
 #include <bitset>
+#include <cstring>
+#include <new>
 #include <set>
 
 #include "detail/channel.ipp"
@@ -85,6 +94,377 @@ using detail::STATE_RUNNING;
 using detail::STATE_FAILED;
 /** @endcond */
 
+namespace
+{
+/**
+ * @return the number of rows per transmitted band of the image.
+ * @param bandwidth the lowest bandwidth of all receivers in KB/s, or 0.
+ */
+uint32_t _getTransmitRows( const Image& image, const bool useCompression,
+                           const int32_t hint, const float bandwidth )
+{
+    const PixelViewport& pvp = image.getPixelViewport();
+    const uint32_t height = pvp.h;
+    if( hint == fabric::OFF || pvp.w <= 0 || height == 0 )
+        return height;
+
+    // only unmodified, uncompressed pixel data can be split into rows
+    const Frame::Buffer buffers[] = { Frame::BUFFER_COLOR,
+                                      Frame::BUFFER_DEPTH };
+    for( unsigned i = 0; i < 2; ++i )
+    {
+        if( !image.hasPixelData( buffers[i] ))
+            continue;
+
+        const PixelData& data = image.getPixelData( buffers[i] );
+        if( data.pvp != pvp || data.compressedData.isCompressed( ))
+            return height;
+    }
+
+    if( hint > fabric::ON )
+        return std::min( uint32_t( hint ), height );
+
+    if( !useCompression )
+    {
+        // Control commands share the connection with the image data. Send
+        // uncompressed images in bands of about 2ms on the slowest link, so
+        // that they are not delayed by large images.
+        if( bandwidth <= 0.f )
+            return height;
+
+        uint64_t rowSize = 0;
+        for( unsigned i = 0; i < 2; ++i )
+            if( image.hasPixelData( buffers[i] ))
+                rowSize += image.getPixelDataSize( buffers[i] ) / height;
+
+        const uint64_t bandSize = uint64_t( bandwidth * 2.f ); // KB/s * 2ms
+        if( rowSize == 0 || rowSize * height <= bandSize )
+            return height;
+
+        const uint32_t rows = std::max( uint32_t( bandSize / rowSize ),
+                                        ( height + 15 ) / 16 );
+        return std::min( std::max( rows, 1u ), height );
+    }
+
+    // bands of about 256k pixels, but not more than 16 bands per image
+    const uint32_t rows = std::max( 262144u / uint32_t( pvp.w ),
+                                    ( height + 15 ) / 16 );
+    return std::min( std::max( rows, 1u ), height );
+}
+
+/** Fill the given area of a main memory frame buffer with a byte value. */
+void _clearPixels( PixelData* data, const PixelViewport& pvp,
+                   const uint8_t value )
+{
+    if( !data )
+        return;
+
+    PixelViewport area = pvp;
+    area.intersect( data->pvp );
+    uint8_t* pixels = static_cast< uint8_t* >( data->pixels );
+    const size_t rowSize = size_t( data->pvp.w ) * data->pixelSize;
+    const size_t size = size_t( area.w ) * data->pixelSize;
+
+    for( int32_t y = area.y; y < area.getYEnd(); ++y )
+        memset( pixels + size_t( y - data->pvp.y ) * rowSize +
+                size_t( area.x - data->pvp.x ) * data->pixelSize, value, size );
+}
+
+/** One destination of a transmitted image. */
+struct Receiver
+{
+    uint128_t nodeID;
+    co::NodePtr node;
+    co::ConnectionPtr connection;
+    bool useCompression[2];
+    co::LocalNode::SendToken token;
+};
+typedef std::vector< Receiver > Receivers;
+
+bool _lessNetNode( const Receiver& a, const Receiver& b )
+{
+    return a.node->getNodeID() < b.node->getNodeID();
+}
+
+/**
+ * Encode uncompressed pixel data against the last image sent to the same
+ * receivers, and keep it as the new reference.
+ * @return the FrameData::Temporal encoding of the added chunks.
+ */
+uint32_t _encodeTemporal( detail::TransmitReference& reference,
+                          const std::vector< uint128_t >& nodes,
+                          const PixelData& data,
+                          pression::CompressorChunks& chunks )
+{
+    const uint8_t* pixels = static_cast< const uint8_t* >( data.pixels );
+    const size_t nPixels = data.pvp.getArea();
+    const size_t size = nPixels * data.pixelSize;
+    uint32_t temporal = FrameData::TEMPORAL_KEY;
+
+    if( reference.nodes == nodes && reference.pvp == data.pvp &&
+        reference.externalFormat == data.externalFormat &&
+        reference.pixelSize == data.pixelSize &&
+        reference.pixels.size() == size )
+    {
+        const size_t nChanged = detail::blocks::compare( pixels,
+                                     &reference.pixels[0], data.pixelSize,
+                                     data.pvp.w, data.pvp.h, reference.mask );
+
+        // a key frame is cheaper if most blocks changed
+        if( nChanged * 4 < nPixels * 3 )
+        {
+            reference.packed.resize( nChanged * data.pixelSize );
+            if( nChanged > 0 )
+                detail::blocks::pack( pixels, data.pixelSize, data.pvp.w,
+                                      data.pvp.h, reference.mask,
+                                      &reference.packed[0] );
+            chunks.push_back( pression::CompressorChunk( &reference.mask[0],
+                                                     reference.mask.size( )));
+            chunks.push_back( pression::CompressorChunk(
+                nChanged > 0 ? &reference.packed[0] : 0,
+                reference.packed.size( )));
+            temporal = FrameData::TEMPORAL_DELTA;
+        }
+    }
+
+    if( temporal == FrameData::TEMPORAL_KEY )
+        chunks.push_back( pression::CompressorChunk( data.pixels, size ));
+
+    reference.nodes = nodes;
+    reference.pvp = data.pvp;
+    reference.externalFormat = data.externalFormat;
+    reference.pixelSize = data.pixelSize;
+    reference.pixels.assign( pixels, pixels + size );
+    return temporal;
+}
+
+/** @return the last image sent of a frame data image buffer. */
+detail::TransmitReference& _getTransmitReference( detail::Channel& channel,
+                                                  const uint128_t& frameData,
+                                                  const uint64_t buffer )
+{
+    const detail::TransmitReferenceKey key( frameData, buffer );
+    lunchbox::ScopedWrite mutex( channel.transmitReferencesLock );
+    return channel.transmitReferences[ key ];
+}
+
+/**
+ * Encode pixel data as a delta without changes against the last image sent to
+ * the same receivers, which then repeat that image.
+ * @return false if there is no matching reference.
+ */
+bool _repeatTemporal( detail::TransmitReference& reference,
+                      const std::vector< uint128_t >& nodes,
+                      const PixelData& data,
+                      pression::CompressorChunks& chunks )
+{
+    if( reference.nodes != nodes || reference.pvp != data.pvp ||
+        reference.externalFormat != data.externalFormat ||
+        reference.pixelSize != data.pixelSize || reference.pixels.empty( ))
+    {
+        return false;
+    }
+
+    // the reference is kept, it is still the image of the receivers
+    reference.mask.assign( detail::blocks::getNumBlocks( data.pvp.w,
+                                                         data.pvp.h ), 0 );
+    reference.packed.clear();
+    chunks.push_back( pression::CompressorChunk( &reference.mask[0],
+                                                 reference.mask.size( )));
+    chunks.push_back( pression::CompressorChunk( 0, 0 ));
+    return true;
+}
+
+/**
+ * Send an uncompressed image to the receivers on this host through the shared
+ * memory arena, and remove them from the receivers.
+ */
+void _transmitShared( detail::SharedImageArena& arena, const Image& image,
+                      const co::ObjectVersion& frameDataVersion,
+                      const uint32_t frameNumber, Receivers& receivers )
+{
+    typedef detail::SharedImageArena::Handle Handle;
+
+    Receivers local;
+    Receivers remote;
+    BOOST_FOREACH( const Receiver& receiver, receivers )
+    {
+        if( arena.isLocal( receiver.node->getNodeID( )))
+            local.push_back( receiver );
+        else
+            remote.push_back( receiver );
+    }
+    if( local.empty( ))
+        return;
+
+    const Frame::Buffer buffers[] = { Frame::BUFFER_COLOR,
+                                      Frame::BUFFER_DEPTH };
+    std::vector< FrameData::ImageHeader > headers;
+    std::vector< Handle > handles;
+    uint32_t commandBuffers = Frame::BUFFER_NONE;
+    bool written = true;
+    for( unsigned j = 0; j < 2 && written; ++j )
+    {
+        const Frame::Buffer buffer = buffers[j];
+        if( !image.hasPixelData( buffer ))
+            continue;
+
+        // pixels compressed by the download plugin are sent as they are
+        const PixelData& data = image.getPixelData( buffer );
+        Handle handle;
+        written = !data.compressedData.isCompressed() &&
+                  arena.write( data.pixels, uint64_t( data.pvp.getArea( )) *
+                                            data.pixelSize,
+                               uint32_t( local.size( )), handle );
+        if( !written )
+            break;
+
+        const FrameData::ImageHeader header =
+            { data.internalFormat, data.externalFormat, data.pixelSize,
+              data.pvp, EQ_COMPRESSOR_NONE, data.compressorFlags, 1,
+              image.getQuality( buffer ), 0, FrameData::TEMPORAL_NONE, 1 };
+        headers.push_back( header );
+        handles.push_back( handle );
+        commandBuffers |= buffer;
+    }
+
+    if( !written || headers.empty( ))
+    {
+        // arena full, use the network for all receivers
+        BOOST_FOREACH( const Handle& handle, handles )
+            arena.discard( handle );
+        return;
+    }
+
+    const uint64_t handleSize = sizeof( Handle );
+    const uint64_t imageDataSize = headers.size() *
+        ( sizeof( FrameData::ImageHeader ) + sizeof( handleSize ) + handleSize );
+    BOOST_FOREACH( const Receiver& receiver, local )
+    {
+        co::ConnectionPtr connection = receiver.connection;
+        co::ObjectOCommand command( co::Connections( 1, connection ),
+                                    fabric::CMD_NODE_FRAMEDATA_TRANSMIT,
+                                    co::COMMANDTYPE_OBJECT,
+                                    receiver.nodeID, CO_INSTANCE_ALL );
+        command << frameDataVersion << image.getPixelViewport()
+                << image.getZoom() << commandBuffers << frameNumber
+                << image.getAlphaUsage();
+        command.sendHeader( imageDataSize );
+
+        for( size_t j = 0; j < headers.size(); ++j )
+        {
+            connection->send( &headers[j], sizeof( FrameData::ImageHeader ),
+                              true );
+            connection->send( &handleSize, sizeof( handleSize ), true );
+            connection->send( &handles[j], handleSize, true );
+        }
+    }
+    receivers.swap( remote );
+}
+
+/**
+ * Update the frustum and head transformation of a render context computed by
+ * the server with a newer head matrix, see server::Compound::computeFrustum.
+ */
+void _latchHead( RenderContext& context, const Matrix4f& head,
+                 const Vector3f& eyePosition, const float modelUnit )
+{
+    if( context.wallType == Wall::TYPE_HMD )
+    {
+        // frustum is fixed to the head, only the head transformation changes
+        Matrix4f inverseHead;
+        if( head.inverse( inverseHead ))
+            context.headTransform = context.headTransform *
+                                    context.headMatrix * inverseHead;
+        return;
+    }
+
+    const Vector3f& eye = context.eyeWall;
+    const Vector3f motion = ( head * eyePosition -
+                              context.headMatrix * eyePosition ) * modelUnit;
+    // wall rotation is the linear part of the server's head transformation
+    const Vector4f delta4 = context.headTransform *
+                            Vector4f( motion.x(), motion.y(), motion.z(), 0.f );
+    const Vector3f delta( delta4.x(), delta4.y(), delta4.z( ));
+    const Vector3f newEye = eye + delta;
+    if( eye.z() <= 0.f || newEye.z() <= 0.f )
+        return; // eye behind the wall, keep server frustum
+
+    // recompute the frustum for the new eye position on the same wall area
+    Frustumf& frustum = context.frustum;
+    const float ratio = frustum.near_plane() / eye.z();
+    const float newRatio = frustum.near_plane() / newEye.z();
+    frustum.left() = ( frustum.left() / ratio + eye.x() - newEye.x( )) *
+                     newRatio;
+    frustum.right() = ( frustum.right() / ratio + eye.x() - newEye.x( )) *
+                      newRatio;
+    frustum.bottom() = ( frustum.bottom() / ratio + eye.y() - newEye.y( )) *
+                       newRatio;
+    frustum.top() = ( frustum.top() / ratio + eye.y() - newEye.y( )) *
+                    newRatio;
+
+    // headTransform = -trans(newEye) * view matrix
+    Matrix4f& xfm = context.headTransform;
+    for( int i = 0; i < 16; i += 4 )
+    {
+        xfm.array[i]   -= delta[0] * xfm.array[i+3];
+        xfm.array[i+1] -= delta[1] * xfm.array[i+3];
+        xfm.array[i+2] -= delta[2] * xfm.array[i+3];
+    }
+    context.headMatrix = head;
+    context.eyeWall = newEye;
+}
+
+/**
+ * Merge neighbouring regions while the per-image overhead saved outweighs the
+ * background pixels added by the merged region, both in pixels.
+ */
+void _mergeRegions( PixelViewports& regions, const int64_t overhead )
+{
+    while( regions.size() > 1 )
+    {
+        int64_t bestGain = 0;
+        size_t first = 0;
+        size_t second = 0;
+
+        for( size_t i = 0; i < regions.size()-1; ++i )
+            for( size_t j = i+1; j < regions.size(); ++j )
+            {
+                PixelViewport merged = regions[i];
+                merged.merge( regions[j] );
+                const int64_t gain = overhead + regions[i].getArea() +
+                                     regions[j].getArea() - merged.getArea();
+                if( gain <= bestGain )
+                    continue;
+
+                // the merged region may not cover any other region
+                bool overlap = false;
+                for( size_t k = 0; k < regions.size() && !overlap; ++k )
+                {
+                    if( k == i || k == j )
+                        continue;
+                    PixelViewport pvp = merged;
+                    pvp.intersect( regions[k] );
+                    overlap = pvp.hasArea();
+                }
+                if( overlap )
+                    continue;
+
+                bestGain = gain;
+                first = i;
+                second = j;
+            }
+
+        if( bestGain == 0 )
+            return;
+
+        regions[first].merge( regions[second] );
+        std::swap( regions[second], regions.back( ));
+        regions.pop_back();
+    }
+}
+}
+
 Channel::Channel( Window* parent )
         : Super( parent )
         , _impl( new detail::Channel )
@@ -115,6 +495,8 @@ void Channel::attach( const uint128_t& id, const uint32_t instanceID )
                      CmdFunc( this, &Channel::_cmdFrameClear ), queue );
     registerCommand( fabric::CMD_CHANNEL_FRAME_DRAW,
                      CmdFunc( this, &Channel::_cmdFrameDraw ), queue );
+    registerCommand( fabric::CMD_CHANNEL_FRAME_DRAW_MULTIVIEW,
+                     CmdFunc( this, &Channel::_cmdFrameDrawMultiView ), queue );
     registerCommand( fabric::CMD_CHANNEL_FRAME_DRAW_FINISH,
                      CmdFunc( this, &Channel::_cmdFrameDrawFinish ), queue );
     registerCommand( fabric::CMD_CHANNEL_FRAME_ASSEMBLE,
@@ -140,6 +522,12 @@ void Channel::attach( const uint128_t& id, const uint32_t instanceID )
     registerCommand( fabric::CMD_CHANNEL_DELETE_TRANSFER_CONTEXT,
                      CmdFunc( this,&Channel::_cmdDeleteTransferContext ),
                      transferQ );
+    registerCommand( fabric::CMD_CHANNEL_WAIT_ASSEMBLY,
+                     CmdFunc( this, &Channel::_cmdWaitAssembly ), transferQ );
+    registerCommand( fabric::CMD_CHANNEL_FINISH_ASSEMBLY,
+                     CmdFunc( this, &Channel::_cmdFinishAssembly ), queue );
+    registerCommand( fabric::CMD_CHANNEL_REPROJECT,
+                     CmdFunc( this, &Channel::_cmdReproject ), queue );
 }
 
 co::CommandQueue* Channel::getPipeThreadQueue()
@@ -218,6 +606,12 @@ const DrawableConfig& Channel::getDrawableConfig() const
     return window->getDrawableConfig();
 }
 
+PixelData* Channel::getPixelData( const Frame::Buffer buffer )
+{
+    SystemWindow* systemWindow = getWindow()->getSystemWindow();
+    return systemWindow ? systemWindow->getPixelData( buffer ) : 0;
+}
+
 const GLEWContext* Channel::glewGetContext() const
 {
     const Window* window = getWindow();
@@ -274,19 +668,22 @@ void Channel::notifyStopFrame( const uint32_t )
 
 void Channel::addStatistic( Event& event )
 {
-    {
-        const uint32_t frameNumber = event.statistic.frameNumber;
-        const size_t index = frameNumber % _impl->statistics->size();
-        LBASSERT( index < _impl->statistics->size( ));
-        LBASSERTINFO( _impl->statistics.data[ index ].used > 0, frameNumber );
-
-        lunchbox::ScopedFastWrite mutex( _impl->statistics );
-        Statistics& statistics = _impl->statistics.data[ index ].data;
-        statistics.push_back( event.statistic );
-    }
+    _storeStatistic( event.statistic );
     processEvent( event );
 }
 
+void Channel::_storeStatistic( const Statistic& statistic )
+{
+    const uint32_t frameNumber = statistic.frameNumber;
+    const size_t index = frameNumber % _impl->statistics->size();
+    LBASSERT( index < _impl->statistics->size( ));
+    LBASSERTINFO( _impl->statistics.data[ index ].used > 0, frameNumber );
+
+    lunchbox::ScopedFastWrite mutex( _impl->statistics );
+    Statistics& statistics = _impl->statistics.data[ index ].data;
+    statistics.push_back( statistic );
+}
+
 //---------------------------------------------------------------------------
 // operations
 //---------------------------------------------------------------------------
@@ -298,6 +695,14 @@ void Channel::waitFrameFinished( const uint32_t frame ) const
 void Channel::frameClear( const uint128_t& )
 {
     resetRegions();
+    if( getPixelData( Frame::BUFFER_COLOR ))
+    {
+        const PixelViewport& pvp = getPixelViewport();
+        _clearPixels( getPixelData( Frame::BUFFER_COLOR ), pvp, 0 );
+        _clearPixels( getPixelData( Frame::BUFFER_DEPTH ), pvp, 0xFF );
+        return;
+    }
+
     EQ_GL_CALL( applyBuffer( ));
     EQ_GL_CALL( applyViewport( ));
 
@@ -315,6 +720,9 @@ void Channel::frameClear( const uint128_t& )
 
 void Channel::frameDraw( const uint128_t& )
 {
+    if( getPixelData( Frame::BUFFER_COLOR ))
+        return; // rendered by the application into the main memory buffer
+
     EQ_GL_CALL( applyBuffer( ));
     EQ_GL_CALL( applyViewport( ));
 
@@ -332,8 +740,19 @@ void Channel::frameDraw( const uint128_t& )
     EQ_GL_CALL( applyHeadTransform( ));
 }
 
+bool Channel::frameDrawMultiView( const uint128_t& )
+{
+    return false;
+}
+
 void Channel::frameAssemble( const uint128_t&, const Frames& frames )
 {
+    if( getPixelData( Frame::BUFFER_COLOR ))
+    {
+        Compositor::assembleFramesMemory( frames, this );
+        return;
+    }
+
     EQ_GL_CALL( applyBuffer( ));
     EQ_GL_CALL( applyViewport( ));
     EQ_GL_CALL( setupAssemblyState( ));
@@ -354,6 +773,15 @@ void Channel::frameReadback( const uint128_t&, const Frames& frames )
     if( !region.hasArea( ))
         return;
 
+    const SystemWindow* systemWindow = getWindow()->getSystemWindow();
+    if( systemWindow->getPixelData( Frame::BUFFER_COLOR ))
+    {
+        for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
+            (*i)->referenceFrameBuffer( getDrawableConfig(), getRegions(),
+                                        *systemWindow );
+        return;
+    }
+
     EQ_GL_CALL( applyBuffer( ));
     EQ_GL_CALL( applyViewport( ));
     EQ_GL_CALL( setupAssemblyState( ));
@@ -361,14 +789,49 @@ void Channel::frameReadback( const uint128_t&, const Frames& frames )
     util::ObjectManager&  glObjects   = getObjectManager();
     const DrawableConfig& drawable    = getDrawableConfig();
     const PixelViewports& regions     = getRegions();
+    const util::FrameBufferObject* fbo = systemWindow->getFrameBufferObject();
+    const bool copyImage = systemWindow->hasCopyImage();
+    bool peerReadback = false;
+
+    // each transmitted image has a fixed cost, merge small regions which are
+    // cheaper to send as one image
+    const int64_t imageOverhead = regions.size() > 1 ?
+        int64_t( _impl->compressionSelector.getImageOverhead( )) : 0;
 
     for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
     {
         Frame* frame = *i;
-        frame->startReadback( glObjects, drawable, regions );
+        const bool transmit = !frame->getInputNodes( getEye( )).empty();
+        // memory frames used only on this node are copied from GPU to GPU
+        if( copyImage && !transmit &&
+            frame->getFrameData()->getType() == Frame::TYPE_MEMORY &&
+            frame->getZoom() == Zoom::NONE )
+        {
+            frame->startPeerReadback( glObjects, drawable, regions,
+                                      *systemWindow );
+            peerReadback = true;
+        }
+        else if( transmit && imageOverhead > 0 )
+        {
+            // 4 bytes per pixel and buffer
+            const uint32_t buffers = frame->getFrameData()->getBuffers();
+            const int64_t pixelSize =
+                ( buffers & Frame::BUFFER_COLOR ? 4 : 0 ) +
+                ( buffers & Frame::BUFFER_DEPTH ? 4 : 0 );
+            PixelViewports merged( regions );
+            if( pixelSize > 0 )
+                _mergeRegions( merged, imageOverhead / pixelSize );
+            frame->startReadback( glObjects, drawable, merged, fbo );
+        }
+        else
+            frame->startReadback( glObjects, drawable, regions, fbo );
     }
 
     EQ_GL_CALL( resetAssemblyState( ));
+
+    // the input frames copy the textures from their context
+    if( peerReadback )
+        EQ_GL_CALL( glFinish( ));
 }
 
 void Channel::startFrame( const uint32_t ) { /* nop */ }
@@ -424,6 +887,17 @@ void Channel::_overrideContext( RenderContext& context )
     window->_addRenderContext( context );
 }
 
+RenderContext Channel::_readContext( co::ObjectICommand& command )
+{
+    _impl->lastContext.deserialize( command );
+    return _impl->lastContext;
+}
+
+const RenderContext& Channel::getEyeContext( const Eye eye ) const
+{
+    return eye == EYE_RIGHT ? _impl->rightContext : getContext();
+}
+
 Frustumf Channel::getScreenFrustum() const
 {
     const Pixel& pixel = getPixel();
@@ -505,7 +979,8 @@ void Channel::applyBuffer()
 {
     LB_TS_THREAD( _pipeThread );
     const Window* window = getWindow();
-    if( !window->getSystemWindow()->getFrameBufferObject( ))
+    if( !window->getSystemWindow()->getFrameBufferObject() &&
+        !_impl->multiView.isBound( ))
     {
         EQ_GL_CALL( glReadBuffer( getReadBuffer( )));
         EQ_GL_CALL( glDrawBuffer( getDrawBuffer( )));
@@ -523,7 +998,8 @@ void Channel::bindFrameBuffer()
 
     if( _impl->_updateFrameBuffer )
     {
-        window->updateFrameBuffer();
+        // only the channel was drawn, resolve it for readback and assembly
+        window->updateFrameBuffer( getNativePixelViewport( ));
         _impl->_updateFrameBuffer = false;
     }
     window->bindFrameBuffer();
@@ -653,12 +1129,21 @@ static Vector2f* _lookupJitterTable( const uint32_t size )
     }
     return 0;
 }
+
+/** @return the sub-pixel offset of a frame for temporal upsampling. */
+const Vector2f& _getTemporalJitter( const uint32_t frameNumber )
+{
+    return Jitter::j8[ frameNumber % 8 ];
+}
 }
 
 Vector2f Channel::getJitter() const
 {
     const SubPixel& subpixel = getSubPixel();
-    if( subpixel == SubPixel::ALL )
+    const Zoom& zoom = getZoom();
+    const bool upsampled = ( zoom.x() < 1.f || zoom.y() < 1.f ) &&
+                        getIAttribute( IATTR_HINT_TEMPORAL_UPSAMPLING ) == ON;
+    if( subpixel == SubPixel::ALL && !upsampled )
         return Vector2f::ZERO;
 
     // Compute a pixel size
@@ -675,16 +1160,13 @@ Vector2f Channel::getJitter() const
 
     const Vector2f pixelSize( pixel_w, pixel_h );
 
-    Vector2f* table = _lookupJitterTable( subpixel.size );
-    Vector2f jitter;
-    if( !table )
-    {
-        static lunchbox::RNG rng;
-        jitter.x() = rng.get< float >();
-        jitter.y() = rng.get< float >();
-    }
-    else
-        jitter = table[ subpixel.index ];
+    // downscaled sources vary their sample position over time
+    if( subpixel == SubPixel::ALL )
+        return _getTemporalJitter( getCurrentFrame( )) * pixelSize;
+
+    const Vector2f* table = _lookupJitterTable( subpixel.size );
+    Vector2f jitter = table ? table[ subpixel.index ] :
+                              Jitter::getHalton( subpixel.index );
 
     const Pixel& pixel = getPixel();
     jitter.x() /= static_cast<float>( pixel.w );
@@ -693,6 +1175,21 @@ Vector2f Channel::getJitter() const
     return jitter * pixelSize;
 }
 
+Vector2f Channel::getJitterSample( const uint32_t index ) const
+{
+    const PixelViewport& pvp = getPixelViewport();
+    const Frustumf& frustum = getFrustum();
+    const Vector2f pixelSize( frustum.get_width() / float( pvp.w ),
+                              frustum.get_height() / float( pvp.h ));
+
+    const Pixel& pixel = getPixel();
+    Vector2f jitter = Jitter::getHalton( index );
+    jitter.x() /= float( pixel.w );
+    jitter.y() /= float( pixel.h );
+
+    return jitter * pixelSize;
+}
+
 bool Channel::isStopped() const { return _impl->state == STATE_STOPPED; }
 
 const Vector3ub& Channel::getUniqueColor() const { return _impl->color; }
@@ -825,11 +1322,14 @@ bool Channel::processEvent( const Event& event )
         case Event::CHANNEL_POINTER_BUTTON_PRESS:
         case Event::CHANNEL_POINTER_BUTTON_RELEASE:
         case Event::CHANNEL_POINTER_WHEEL:
-        case Event::STATISTIC:
         case Event::KEY_PRESS:
         case Event::KEY_RELEASE:
             break;
 
+        case Event::STATISTIC:
+            getPipe()->addStatistic( event );
+            return true;
+
         case Event::CHANNEL_RESIZE:
         {
             const uint128_t& viewID = getNativeContext().view.identifier;
@@ -884,16 +1384,39 @@ void Channel::drawStatistics()
     EQ_GL_CALL( glDisable( GL_COLOR_LOGIC_OP ));
 
 #ifdef EQUALIZER_USE_GLSTATS
-    const util::BitmapFont* font = window->getSmallFont();
     const Config* config = getConfig();
-    const GLStats::Data& data = config->getStatistics();
-    detail::StatsRenderer renderer( font );
     const Viewport& vp = getViewport();
     const uint32_t width = uint32_t( pvp.w / vp.w );
     const uint32_t height = uint32_t( pvp.h / vp.h);
+    const uint64_t version = config->getStatisticsVersion();
+
+    // The channels of a window share one display list of the overlay, which
+    // is recorded again only when the statistics or the overlay size change.
+    util::ObjectManager& om = window->getObjectManager();
+    const void* key = &window->_statsVersion;
+    GLuint list = om.getList( key );
+    if( list != util::ObjectManager::INVALID &&
+        window->_statsVersion == version && window->_statsWidth == width &&
+        window->_statsHeight == height )
+    {
+        EQ_GL_CALL( glCallList( list ));
+    }
+    else
+    {
+        if( list == util::ObjectManager::INVALID )
+            list = om.newList( key );
 
-    renderer.setViewport( width, height );
-    renderer.draw( data );
+        detail::StatsRenderer renderer( window->getSmallFont( ));
+        renderer.setViewport( width, height );
+
+        EQ_GL_CALL( glNewList( list, GL_COMPILE_AND_EXECUTE ));
+        renderer.draw( config->getStatistics( ));
+        EQ_GL_CALL( glEndList( ));
+
+        window->_statsVersion = version;
+        window->_statsWidth = width;
+        window->_statsHeight = height;
+    }
 #endif
 
     EQ_GL_CALL( glColor3f( 1.f, 1.f, 1.f ));
@@ -936,10 +1459,18 @@ namespace detail
 {
 struct RBStat
 {
-    RBStat( eq::Channel* channel )
+    /** @return a new readback statistic using the channel's task storage. */
+    static RBStat* create( eq::Channel* channel, TaskStorage& storage )
+    {
+        return new( storage.alloc( sizeof( RBStat ))) RBStat( channel,
+                                                              storage );
+    }
+
+    RBStat( eq::Channel* channel, TaskStorage& storage_ )
             : event( Statistic::CHANNEL_READBACK, channel )
             , uncompressed( 0 )
             , compressed( 0 )
+            , _storage( storage_ )
         {
             event.event.data.statistic.plugins[0] = EQ_COMPRESSOR_NONE;
             event.event.data.statistic.plugins[1] = EQ_COMPRESSOR_NONE;
@@ -962,13 +1493,17 @@ struct RBStat
                                                    float( uncompressed );
             else
                 event.event.data.statistic.ratio = 1.0f;
-            delete this;
+
+            TaskStorage& storage = _storage;
+            this->~RBStat(); // sends the statistic
+            storage.release( this );
             return true;
         }
 
     int32_t getRefCount() const { return _refCount; }
 
 private:
+    TaskStorage& _storage;
     a_int32_t _refCount;
 };
 }
@@ -976,7 +1511,8 @@ private:
 typedef lunchbox::RefPtr< detail::RBStat > RBStatPtr;
 
 void Channel::_frameTiles( RenderContext& context, const bool isLocal,
-                           const uint128_t& queueID, const uint32_t tasks,
+                           const std::vector< uint128_t >& queueIDs,
+                           const uint32_t tasks,
                            const co::ObjectVersions& frameIDs )
 {
     _overrideContext( context );
@@ -984,12 +1520,14 @@ void Channel::_frameTiles( RenderContext& context, const bool isLocal,
     frameTilesStart( context.frameID );
 
     RBStatPtr stat;
-    Frames frames;
     if( tasks & fabric::TASK_READBACK )
     {
-        frames = _getFrames( frameIDs, true );
-        stat = new detail::RBStat( this );
+        _getFrames( frameIDs, true );
+        stat = detail::RBStat::create( this, _impl->rbStats );
     }
+    else
+        _impl->outputFrames.clear();
+    const Frames& frames = _impl->outputFrames;
 
     int64_t startTime = getConfig()->getTime();
     int64_t clearTime = 0;
@@ -998,20 +1536,73 @@ void Channel::_frameTiles( RenderContext& context, const bool isLocal,
     bool hasAsyncReadback = false;
     const uint32_t timeout = getConfig()->getTimeout();
 
-    co::QueueSlave* queue = _getQueue( queueID );
+    // Measured tile render and empty-pop times, tuning the queue prefetch
+    lunchbox::Clock clock;
+    float tileTime = 0.f;
+    float emptyTime = 0.f;
+    size_t nTiles = 0;
+    size_t nEmpty = 0;
+
+    // Remote tiles are drawn at the origin of the drawable, or side by side
+    // into the slots of the tile atlas, read back together.
+    const int32_t atlasHint = getIAttribute( IATTR_HINT_TILE_ATLAS );
+    const bool useAtlas = !isLocal && ( tasks & fabric::TASK_READBACK ) &&
+                          atlasHint != OFF;
+    const uint32_t maxAtlasTiles = atlasHint > ON ? atlasHint : 0;
+    detail::TileAtlas& atlas = _impl->tileAtlas;
+    atlas.reset( PixelViewport(), PixelViewport(), 0 );
+
+    // Drain the own queue first, then steal from the neighbors' queues
+    size_t current = 0;
+    co::QueueSlave* queue = _getQueue( queueIDs[ current ] );
     LBASSERT( queue );
     for( ;; )
     {
+        clock.reset();
         co::ObjectICommand tileCmd = queue->pop( timeout );
         if( !tileCmd.isValid( ))
-            break;
+        {
+            // an empty pop always asks the master: one queue round trip
+            emptyTime += clock.getTimef();
+            ++nEmpty;
+            if( ++current >= queueIDs.size( ))
+                break;
+            queue = _getQueue( queueIDs[ current ] );
+            LBASSERT( queue );
+            continue;
+        }
 
         const Tile& tile = tileCmd.read< Tile >();
+        const int64_t tileStartTime = getConfig()->getTime();
+        clock.reset();
         context.apply( tile );
 
         const PixelViewport tilePVP = context.pvp;
 
-        if ( !isLocal )
+        bool inAtlas = false;
+        if( useAtlas )
+        {
+            if( !atlas.fits( tilePVP ))
+            {
+                if( !atlas.tiles.empty( ))
+                {
+                    const int64_t time = getConfig()->getTime();
+                    if( _readbackTileAtlas( context, frames ))
+                        hasAsyncReadback = true;
+                    readbackTime += getConfig()->getTime() - time;
+                }
+                atlas.reset( getNativePixelViewport(), tilePVP, maxAtlasTiles );
+            }
+            inAtlas = atlas.fits( tilePVP );
+        }
+
+        if( inAtlas )
+        {
+            const PixelViewport slot = atlas.getNextSlot( tilePVP );
+            context.pvp.x = slot.x;
+            context.pvp.y = slot.y;
+        }
+        else if ( !isLocal )
         {
             context.pvp.x = 0;
             context.pvp.y = 0;
@@ -1031,12 +1622,27 @@ void Channel::_frameTiles( RenderContext& context, const bool isLocal,
             drawTime += getConfig()->getTime() - time;
         }
 
-        if( tasks & fabric::TASK_READBACK )
+        if( inAtlas )
+        {
+            // regions are relative to the slot, keep them for the readback
+            detail::TileAtlas::Tile atlasTile;
+            atlasTile.slot = context.pvp;
+            atlasTile.pvp = tilePVP;
+            BOOST_FOREACH( const PixelViewport& region, getRegions( ))
+                if( region.hasArea( ))
+                    atlasTile.regions.push_back( region +
+                                   Vector2i( context.pvp.x, context.pvp.y ));
+            atlas.tiles.push_back( atlasTile );
+            resetRegions();
+        }
+        else if( tasks & fabric::TASK_READBACK )
         {
             const int64_t time = getConfig()->getTime();
             const size_t nFrames = frames.size();
 
-            std::vector< size_t > nImages( nFrames, 0 );
+            std::vector< size_t >& nImages = _impl->nImages;
+            _impl->reserve( nImages, nFrames );
+            nImages.resize( nFrames );
             for( size_t i = 0; i < nFrames; ++i )
             {
                 nImages[i] = frames[i]->getImages().size();
@@ -1063,8 +1669,39 @@ void Channel::_frameTiles( RenderContext& context, const bool isLocal,
             if( _asyncFinishReadback( nImages, frames ))
                 hasAsyncReadback = true;
         }
+
+        if( tasks & fabric::TASK_DRAW &&
+            getIAttribute( IATTR_HINT_STATISTICS ) != OFF )
+        {
+            // Per-tile cost for the server's tile ordering. Only send to the
+            // server, one event per tile would flood the statistics overlay.
+            Statistic statistic = Statistic();
+            statistic.type = Statistic::CHANNEL_TILE;
+            statistic.frameNumber = getCurrentFrame();
+            statistic.task = getTaskID();
+            statistic.startTime = tileStartTime;
+            statistic.endTime = LB_MAX( getConfig()->getTime(),
+                                        tileStartTime + 1 );
+            statistic.tileX = tile.pvp.x;
+            statistic.tileY = tile.pvp.y;
+            _storeStatistic( statistic );
+        }
+        tileTime += clock.getTimef();
+        ++nTiles;
+    }
+
+    if( !atlas.tiles.empty( ))
+    {
+        const int64_t time = getConfig()->getTime();
+        if( _readbackTileAtlas( context, frames ))
+            hasAsyncReadback = true;
+        readbackTime += getConfig()->getTime() - time;
     }
 
+    if( nTiles > 0 && nEmpty > 0 )
+        getPipe()->updateTilePrefetch( tileTime / float( nTiles ),
+                                       emptyTime / float( nEmpty ));
+
     if( tasks & fabric::TASK_CLEAR )
     {
         ChannelStatistics event( Statistic::CHANNEL_CLEAR, this );
@@ -1094,6 +1731,62 @@ void Channel::_frameTiles( RenderContext& context, const bool isLocal,
     resetContext();
 }
 
+bool Channel::_readbackTileAtlas( RenderContext& context,
+                                  const Frames& frames )
+{
+    detail::TileAtlas& atlas = _impl->tileAtlas;
+    LBASSERT( !atlas.tiles.empty( ));
+
+    // One readback pass over the used slots, one image per declared region
+    const PixelViewport area = atlas.getArea();
+    context.pvp = PixelViewport( 0, 0, area.x + area.w, area.y + area.h );
+    resetRegions();
+    BOOST_FOREACH( const detail::TileAtlas::Tile& tile, atlas.tiles )
+        _impl->regions.insert( _impl->regions.end(), tile.regions.begin(),
+                               tile.regions.end( ));
+
+    const size_t nFrames = frames.size();
+    std::vector< size_t >& nImages = _impl->nImages;
+    _impl->reserve( nImages, nFrames );
+    nImages.resize( nFrames );
+    for( size_t i = 0; i < nFrames; ++i )
+    {
+        nImages[i] = frames[i]->getImages().size();
+        frames[i]->getFrameData()->setPixelViewport( getPixelViewport( ));
+    }
+
+    frameReadback( context.frameID, frames );
+
+    // Move each image from its slot to the destination of its tile
+    for( size_t i = 0; i < nFrames; ++i )
+    {
+        const Images& images = frames[i]->getImages();
+        for( size_t j = nImages[i]; j < images.size(); ++j )
+        {
+            Image* image = images[j];
+            const PixelViewport& pvp = image->getPixelViewport();
+            BOOST_FOREACH( const detail::TileAtlas::Tile& tile, atlas.tiles )
+            {
+                const PixelViewport& slot = tile.slot;
+                if( pvp.x < slot.x || pvp.x >= slot.x + slot.w ||
+                    pvp.y < slot.y || pvp.y >= slot.y + slot.h )
+                {
+                    continue;
+                }
+                image->setOffset( pvp.x - slot.x + tile.pvp.x,
+                                  pvp.y - slot.y + tile.pvp.y );
+                break;
+            }
+        }
+    }
+
+    LBLOG( LOG_TASKS ) << "Read back " << atlas.tiles.size()
+                       << " tiles from atlas " << area << std::endl;
+    atlas.tiles.clear();
+    resetRegions();
+    return _asyncFinishReadback( nImages, frames );
+}
+
 void Channel::_refFrame( const uint32_t frameNumber )
 {
     const size_t index = frameNumber % _impl->statistics->size();
@@ -1115,15 +1808,55 @@ void Channel::_unrefFrame( const uint32_t frameNumber )
     stats.data.clear();
     stats.region = Viewport::FULL;
 
-    _impl->finishedFrame = frameNumber;
+    // frames with GPU-timed statistics may finish after later frames
+    if( frameNumber > _impl->finishedFrame.get( ))
+        _impl->finishedFrame = frameNumber;
+}
+
+detail::TimerQueries* Channel::_getTimerQueries()
+{
+    LB_TS_THREAD( _pipeThread );
+    if( !_impl->timerQueries && _impl->checkTimerQueries )
+    {
+        _impl->checkTimerQueries = false;
+        util::ObjectManager& om = getObjectManager();
+        if( detail::TimerQueries::isSupported( om ))
+            _impl->timerQueries = new detail::TimerQueries( om );
+    }
+    return _impl->timerQueries;
+}
+
+void Channel::_addTimerStatistic( const Event& event,
+                                  const void* beginQuery )
+{
+    // keep the frame statistics until the GPU times are known
+    _refFrame( event.statistic.frameNumber );
+    _impl->timerQueries->end( event, beginQuery );
+}
+
+void Channel::_collectTimerStatistics( const uint32_t waitFrame )
+{
+    detail::TimerQueries* queries = _impl->timerQueries;
+    if( !queries || queries->isEmpty( ))
+        return;
+
+    const int64_t time = getConfig()->getTime();
+    Event event;
+    while( queries->pop( event, time, waitFrame ))
+    {
+        addStatistic( event );
+        _unrefFrame( event.statistic.frameNumber );
+    }
 }
 
-Frames Channel::_getFrames( const co::ObjectVersions& frameIDs,
-                            const bool isOutput )
+const Frames& Channel::_getFrames( const co::ObjectVersions& frameIDs,
+                                   const bool isOutput )
 {
     LB_TS_THREAD( _pipeThread );
 
-    Frames frames;
+    Frames& frames = isOutput ? _impl->outputFrames : _impl->inputFrames;
+    frames.clear();
+    _impl->reserve( frames, frameIDs.size( ));
     for( size_t i = 0; i < frameIDs.size(); ++i )
     {
         Pipe*  pipe  = getPipe();
@@ -1134,29 +1867,246 @@ Frames Channel::_getFrames( const co::ObjectVersions& frameIDs,
         frames.push_back( frame );
     }
 
+    // getFrame() may have run a deferred assembly of another window
+    getWindow()->makeCurrent();
     return frames;
 }
 
+void Channel::_copyResourceName( char* name, const size_t size )
+{
+    lunchbox::ScopedFastWrite mutex( _impl->resourceNameLock );
+    const std::string& channelName = getName();
+    if( _impl->resourceName.empty() ||
+        channelName != _impl->resourceNameSource )
+    {
+        _impl->resourceNameSource = channelName;
+        _impl->resourceName = channelName.empty() ?
+            "Channel " + getID().getShortString() : channelName;
+    }
+
+    strncpy( name, _impl->resourceName.c_str(), size - 1 );
+    name[ size - 1 ] = 0;
+}
+
 //---------------------------------------------------------------------------
-// Asynchronous image readback, compression and transmission
+// Asynchronous assembly
 //---------------------------------------------------------------------------
-void Channel::_frameReadback( const uint128_t& frameID,
-                              const co::ObjectVersions& frameIDs )
+bool Channel::_startAsyncAssembly( const Frames& frames )
 {
     LB_TS_THREAD( _pipeThread );
+    const int32_t reprojection = getIAttribute( IATTR_HINT_REPROJECTION );
+    const bool reproject = reprojection != OFF &&
+                           _impl->reprojector.hasImage();
+    if(( getIAttribute( IATTR_HINT_ASYNC_ASSEMBLY ) != ON && !reproject ) ||
+       frames.empty( ))
+    {
+        return false;
+    }
 
-    RBStatPtr stat = new detail::RBStat( this );
-    const Frames& frames = _getFrames( frameIDs, true );
+    bool ready = true;
+    for( FramesCIter i = frames.begin(); i != frames.end() && ready; ++i )
+        ready = (*i)->isReady();
+    if( ready ) // nothing to wait for
+        return false;
 
-    std::vector< size_t > nImages( frames.size(), 0 );
-    for( size_t i = 0; i < frames.size(); ++i )
-        nImages[i] = frames[i]->getImages().size();
+    if( !getPipe()->startTransferThread( ))
+        return false;
 
-    frameReadback( frameID, frames );
-    LBASSERT( stat->event.event.data.statistic.frameNumber > 0 );
-    const bool async = _asyncFinishReadback( nImages, frames );
-    _setReady( async, stat.get(), frames );
-}
+    detail::AsyncAssemblyPtr assembly =
+        new detail::AsyncAssembly( getContext(), frames, getCurrentFrame( ));
+    for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
+        (*i)->addListener( assembly->ready );
+    if( reproject )
+    {
+        // ON and AUTO use the interval of a 60 Hz display
+        assembly->interval = reprojection > ON ? reprojection : 16;
+        assembly->deadline = _impl->reprojector.getTime() +
+                             assembly->interval;
+    }
+    else if( getWindow()->createTransferWindow( ))
+    {
+        assembly->upload = true;
+        _impl->uploader.start( assembly.get( ));
+    }
+
+    LBLOG( LOG_ASSEMBLY ) << "Defer assembly of " << frames.size()
+                          << " frames for frame " << assembly->frameNumber
+                          << std::endl;
+
+    _impl->asyncAssembly = assembly;
+    _refFrame( assembly->frameNumber );
+
+    assembly->ref(); // released by _cmdFinishAssembly
+    send( getLocalNode(), fabric::CMD_CHANNEL_WAIT_ASSEMBLY )
+        << assembly.get();
+    return true;
+}
+
+bool Channel::_deferTask( co::ICommand& command,
+                          bool (Channel::*handler)( co::ICommand& ))
+{
+    LB_TS_THREAD( _pipeThread );
+    detail::AsyncAssemblyPtr assembly = _impl->asyncAssembly;
+    if( !assembly )
+        return false;
+
+    assembly->tasks.push_back( detail::AsyncAssembly::Task( command,
+                                                            handler ));
+    return true;
+}
+
+bool Channel::flushAssembly( const uint128_t& frameDataID )
+{
+    LB_TS_THREAD( _pipeThread );
+    detail::AsyncAssemblyPtr assembly = _impl->asyncAssembly;
+    if( !assembly )
+        return false;
+
+    const Frames& frames = assembly->frames;
+    if( frameDataID != uint128_t( ))
+    {
+        FramesCIter i = frames.begin();
+        for( ; i != frames.end(); ++i )
+            if( (*i)->getFrameData()->getID() == frameDataID )
+                break;
+        if( i == frames.end( ))
+            return false;
+    }
+
+    _impl->asyncAssembly = 0;
+    for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
+        (*i)->removeListener( assembly->ready );
+    assembly->ready = uint32_t( frames.size( )); // release transfer thread
+
+    getWindow()->makeCurrent();
+    if( assembly->upload )
+        _impl->uploader.stop( glewGetContext( ));
+    overrideContext( assembly->context );
+    {
+        ChannelStatistics event( Statistic::CHANNEL_ASSEMBLE, this,
+                                 assembly->frameNumber );
+        frameAssemble( assembly->context.frameID, frames );
+    }
+    resetContext();
+    if( assembly->upload )
+        _impl->uploader.release( glewGetContext( ));
+    _unrefFrame( assembly->frameNumber );
+
+    // Replay the queued tasks in order. A replayed assembly may defer again,
+    // in which case the remaining tasks are queued behind it.
+    while( !assembly->tasks.empty( ))
+    {
+        detail::AsyncAssembly::Task task = assembly->tasks.front();
+        assembly->tasks.pop_front();
+        (this->*task.handler)( task.command );
+    }
+    return true;
+}
+
+const util::Texture* Channel::getUploadedTexture( const Image* image,
+                                      const fabric::Frame::Buffer buffer ) const
+{
+    return _impl->uploader.getTexture( image, buffer );
+}
+
+void Channel::_uploadAssembly( detail::AsyncAssembly& assembly )
+{
+    // Upload each input frame on the shared transfer context as soon as it is
+    // ready, overlapping the uploads with the wait for the remaining frames
+    Window* window = getWindow();
+    window->makeCurrentTransfer();
+    const GLEWContext* gl = window->getTransferGlewContext();
+
+    const Frames& frames = assembly.frames;
+    const uint32_t nFrames = uint32_t( frames.size( ));
+    std::vector< bool > uploaded( nFrames, false );
+    uint32_t nUploaded = 0;
+
+    while( nUploaded < nFrames )
+    {
+        assembly.ready.waitGE( nUploaded + 1 );
+
+        const uint32_t nPrevious = nUploaded;
+        for( size_t i = 0; i < nFrames; ++i )
+        {
+            if( uploaded[i] || !frames[i]->isReady( ))
+                continue;
+            if( !_impl->uploader.upload( &assembly, *frames[i], gl ))
+                return; // assembly already run by the pipe thread
+            uploaded[i] = true;
+            ++nUploaded;
+        }
+
+        // released by flushAssembly() before all frames were ready
+        if( nUploaded == nPrevious && assembly.ready.get() >= nFrames )
+            return;
+    }
+}
+
+//---------------------------------------------------------------------------
+// Asynchronous image readback, compression and transmission
+//---------------------------------------------------------------------------
+void Channel::_frameReadback( const uint128_t& frameID,
+                              const co::ObjectVersions& frameIDs )
+{
+    LB_TS_THREAD( _pipeThread );
+
+    RBStatPtr stat = detail::RBStat::create( this, _impl->rbStats );
+    const Frames& frames = _getFrames( frameIDs, true );
+
+    std::vector< size_t >& nImages = _impl->nImages;
+    _impl->reserve( nImages, frames.size( ));
+    nImages.resize( frames.size( ));
+    for( size_t i = 0; i < frames.size(); ++i )
+        nImages[i] = frames[i]->getImages().size();
+
+    if( getSAttribute( SATTR_PLAYBACK_IMAGES ).empty( ))
+        frameReadback( frameID, frames );
+    else
+        _playbackReadback( frames );
+    LBASSERT( stat->event.event.data.statistic.frameNumber > 0 );
+    const bool async = _asyncFinishReadback( nImages, frames );
+    _setReady( async, stat.get(), frames );
+}
+
+void Channel::_playbackReadback( const Frames& frames )
+{
+    const Image* recorded = _impl->imagePlayback.getImage(
+        getSAttribute( SATTR_PLAYBACK_IMAGES ), getCurrentFrame( ));
+    if( !recorded )
+        return;
+
+    const Frame::Buffer buffers[] = { Frame::BUFFER_COLOR,
+                                      Frame::BUFFER_DEPTH };
+    const PixelViewport& recordedPVP = recorded->getPixelViewport();
+    BOOST_FOREACH( Frame* frame, frames )
+    {
+        FrameDataPtr frameData = frame->getFrameData();
+        const PixelViewport& framePVP = frameData->getPixelViewport();
+        if( frameData->getType() != Frame::TYPE_MEMORY ||
+            recordedPVP.w > framePVP.w || recordedPVP.h > framePVP.h )
+        {
+            LBWARN << "Can't play back " << recordedPVP << " image into "
+                   << frameData->getType() << " frame of " << framePVP
+                   << std::endl;
+            continue;
+        }
+
+        // the recorded image replaces the readback of the whole frame
+        Image* image = frameData->newImage( Frame::TYPE_MEMORY,
+                                            getDrawableConfig( ));
+        image->setPixelViewport( recordedPVP );
+        for( unsigned i = 0; i < 2; ++i )
+        {
+            const Frame::Buffer buffer = buffers[i];
+            if(( frameData->getBuffers() & buffer ) &&
+               recorded->hasPixelData( buffer ))
+            {
+                image->setPixelData( buffer, recorded->getPixelData( buffer ));
+            }
+        }
+    }
+}
 
 bool Channel::_asyncFinishReadback( const std::vector< size_t >& imagePos,
                                     const Frames& frames )
@@ -1235,27 +2185,26 @@ void Channel::_asyncTransmit( FrameDataPtr frame, const uint32_t frameNumber,
                               const uint32_t taskID )
 {
     LBASSERT( nodes.size() == netNodes.size( ));
-    co::NodeIDs::const_iterator j = netNodes.begin();
-    for( std::vector< uint128_t >::const_iterator i = nodes.begin();
-         i != nodes.end(); ++i, ++j )
-    {
-        _refFrame( frameNumber );
+    if( nodes.empty( ))
+        return;
 
-        LBLOG( LOG_TASKS|LOG_ASSEMBLY ) << "Start transmit frame data " << frame
-                                        << " receiver " << *i << " on " << *j
-                                        << std::endl;
-        send( getLocalNode(), fabric::CMD_CHANNEL_FRAME_TRANSMIT_IMAGE )
-                << co::ObjectVersion( frame ) << *i << *j << image
-                << frameNumber << taskID;
-    }
+    _refFrame( frameNumber );
+
+    LBLOG( LOG_TASKS|LOG_ASSEMBLY ) << "Start transmit frame data " << frame
+                                    << " to " << nodes.size() << " receivers"
+                                    << std::endl;
+    send( getLocalNode(), fabric::CMD_CHANNEL_FRAME_TRANSMIT_IMAGE )
+            << co::ObjectVersion( frame ) << nodes << netNodes << image
+            << frameNumber << taskID << getConfig()->getTime();
 }
 
 void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
-                              const uint128_t& nodeID,
-                              const co::NodeID& netNodeID,
+                              const std::vector< uint128_t >& nodes,
+                              const co::NodeIDs& netNodes,
                               const uint64_t imageIndex,
                               const uint32_t frameNumber,
-                              const uint32_t taskID )
+                              const uint32_t taskID,
+                              const int64_t queueTime )
 {
     LBLOG( LOG_TASKS|LOG_ASSEMBLY ) << "Transmit" << std::endl;
     FrameDataPtr frameData = getNode()->getFrameData( frameDataVersion );
@@ -1275,178 +2224,382 @@ void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
     Image* image = images[ imageIndex ];
     LBASSERT( images.size() > imageIndex );
 
-    if( image->getStorageType() == Frame::TYPE_TEXTURE )
+    if( image->getStorageType() != Frame::TYPE_MEMORY )
     {
-        LBWARN << "Can't transmit image of type TEXTURE" << std::endl;
+        LBWARN << "Can't transmit texture or external image" << std::endl;
         LBUNIMPLEMENTED;
         return;
     }
 
+    const Frame::Buffer buffers[] = { Frame::BUFFER_COLOR,
+                                      Frame::BUFFER_DEPTH };
+    detail::CompressionSelector& selector = _impl->compressionSelector;
     co::LocalNodePtr localNode = getLocalNode();
-    co::NodePtr toNode = localNode->connect( netNodeID );
-    if( !toNode || !toNode->isReachable( ))
+    bool useCompression[] = { false, false };
+    float minBandwidth = 0.f;
+
+    // The image is compressed once for all receivers, and each band is written
+    // to all receivers before the next band is compressed.
+    LBASSERT( nodes.size() == netNodes.size( ));
+    Receivers receivers;
+    for( size_t i = 0; i < nodes.size(); ++i )
     {
-        LBWARN << "Can't connect node " << netNodeID << " to send output frame"
-               << std::endl;
+        co::NodePtr toNode = localNode->connect( netNodes[i] );
+        if( !toNode || !toNode->isReachable( ))
+        {
+            LBWARN << "Can't connect node " << netNodes[i]
+                   << " to send output frame" << std::endl;
+            continue;
+        }
+
+        Receiver receiver;
+        receiver.nodeID = nodes[i];
+        receiver.node = toNode;
+        receiver.connection = toNode->getConnection();
+        receivers.push_back( receiver );
+    }
+
+    // processes on this host read the pixels from shared memory
+    detail::SharedImageArena* arena = frameData->getSharedImageArena();
+    if( arena && !receivers.empty( ))
+        _transmitShared( *arena, *image, frameDataVersion, frameNumber,
+                         receivers );
+
+    if( receivers.empty( ))
         return;
+
+    BOOST_FOREACH( Receiver& receiver, receivers )
+    {
+        const float bandwidth =
+            receiver.connection->getDescription()->bandwidth;
+        if( bandwidth > 0.f &&
+            ( minBandwidth == 0.f || bandwidth < minBandwidth ))
+        {
+            minBandwidth = bandwidth;
+        }
+        for( unsigned j = 0; j < 2; ++j )
+        {
+            receiver.useCompression[j] = image->hasPixelData( buffers[j] ) &&
+                selector.useCompression( receiver.node->getNodeID(),
+                                         buffers[j], bandwidth );
+            useCompression[j] |= receiver.useCompression[j];
+        }
     }
 
-    co::ConnectionPtr connection = toNode->getConnection();
-    co::ConstConnectionDescriptionPtr description =connection->getDescription();
+    // acquire all send tokens in the same order to avoid deadlocks
+    std::sort( receivers.begin(), receivers.end(), _lessNetNode );
 
-    // use compression on links up to 2 GBit/s
-    const bool useCompression = ( description->bandwidth <= 262144 );
+    const bool temporal =
+        getIAttribute( IATTR_HINT_TEMPORAL_TRANSMIT ) == ON;
 
-    std::vector< const PixelData* > pixelDatas;
-    std::vector< float > qualities;
+    // Images which waited longer than the deadline, e.g., behind a slow link,
+    // are repeated from the receivers' reference to catch up.
+    const int32_t deadline = getIAttribute( IATTR_HINT_TRANSMIT_DEADLINE );
+    const bool repeat = temporal && deadline > OFF &&
+                        getConfig()->getTime() - queueTime > deadline;
+    if( repeat )
+    {
+        LBLOG( LOG_ASSEMBLY ) << "Repeat image " << imageIndex << " of frame "
+                              << frameNumber << ", missed deadline by "
+                              << getConfig()->getTime() - queueTime - deadline
+                              << " ms" << std::endl;
+    }
 
-    uint32_t commandBuffers = Frame::BUFFER_NONE;
-    uint64_t imageDataSize = 0;
+    std::vector< uint128_t > receiverIDs;
+    if( temporal )
+        BOOST_FOREACH( const Receiver& receiver, receivers )
+            receiverIDs.push_back( receiver.node->getNodeID( ));
+
+    const bool compress = useCompression[0] || useCompression[1];
+    const PixelViewport& pvp = image->getPixelViewport();
+    LBASSERT( pvp.isValid( ));
 
+    // Uncompressed depth images covering less than half of their viewport
+    // are sent as a table of active spans followed by the active pixels.
+    bool sparse = false;
+    if( !compress && !repeat && image->computeSpans( ))
     {
-        uint64_t rawSize( 0 );
-        ChannelStatistics compressEvent( Statistic::CHANNEL_FRAME_COMPRESS,
-                                         this, frameNumber,
-                                         useCompression ? AUTO : OFF );
-        compressEvent.event.data.statistic.task = taskID;
-        compressEvent.event.data.statistic.ratio = 1.0f;
-        compressEvent.event.data.statistic.plugins[0] = EQ_COMPRESSOR_NONE;
-        compressEvent.event.data.statistic.plugins[1] = EQ_COMPRESSOR_NONE;
+        const PixelData& depth = image->getPixelData( Frame::BUFFER_DEPTH );
+        sparse = detail::spans::getNumActivePixels( depth.spans, depth.pvp.h )
+                     < size_t( depth.pvp.getArea( )) / 2;
+    }
+    std::vector< uint8_t > activePixels[2];
+
+    // Large images are sent in bands of rows, so that the receiver can
+    // decompress one band while the next one is compressed and transmitted.
+    const uint32_t nRows = ( sparse || repeat ) ? uint32_t( pvp.h ) :
+                           _getTransmitRows( *image, compress,
+                                 getIAttribute( IATTR_HINT_TRANSMIT_ROWS ),
+                                 minBandwidth );
+    const bool banded = nRows < uint32_t( pvp.h );
+    lunchbox::Clock clock;
+
+    for( uint32_t startRow = 0; startRow < uint32_t( pvp.h );
+         startRow += nRows )
+    {
+        PixelViewport bandPVP( pvp );
+        bandPVP.y += startRow;
+        bandPVP.h = std::min( nRows, uint32_t( pvp.h ) - startRow );
 
-        // Prepare image pixel data
-        Frame::Buffer buffers[] = {Frame::BUFFER_COLOR,Frame::BUFFER_DEPTH};
+        std::vector< FrameData::ImageHeader > headers;
+        std::vector< pression::CompressorChunks > chunks;
+        uint32_t commandBuffers = Frame::BUFFER_NONE;
+        uint64_t imageDataSize = 0;
 
-        // for each image attachment
-        for( unsigned j = 0; j < 2; ++j )
         {
-            Frame::Buffer buffer = buffers[j];
-            if( image->hasPixelData( buffer ))
+            uint64_t rawSize( 0 );
+            ChannelStatistics compressEvent( Statistic::CHANNEL_FRAME_COMPRESS,
+                                             this, frameNumber,
+                                             compress ? AUTO : OFF );
+            compressEvent.event.data.statistic.task = taskID;
+            compressEvent.event.data.statistic.ratio = 1.0f;
+            compressEvent.event.data.statistic.plugins[0] = EQ_COMPRESSOR_NONE;
+            compressEvent.event.data.statistic.plugins[1] = EQ_COMPRESSOR_NONE;
+
+            // for each image attachment
+            for( unsigned j = 0; j < 2; ++j )
             {
-                // format, type, nChunks, compressor name
-                imageDataSize += sizeof( FrameData::ImageHeader );
+                const Frame::Buffer buffer = buffers[j];
+                if( !image->hasPixelData( buffer ))
+                    continue;
+
+                pression::CompressorChunks bufferChunks;
+                uint32_t compressor = EQ_COMPRESSOR_NONE;
+                uint32_t temporalMode = FrameData::TEMPORAL_NONE;
+                const PixelData* data = 0;
+                uint64_t bufferSize = 0;
+                bool measure = useCompression[j];
+
+                clock.reset();
+                if( banded )
+                {
+                    data = &image->getPixelData( buffer );
+                    bufferSize = uint64_t( bandPVP.getArea( )) *
+                                 data->pixelSize;
+                    if( useCompression[j] )
+                    {
+                        const pression::CompressorResult& result =
+                            image->compressPixelRows( buffer, startRow,
+                                                      bandPVP.h );
+                        if( result.isCompressed( ))
+                        {
+                            compressor = result.compressor;
+                            bufferChunks = result.chunks;
+                        }
+                    }
+                    if( compressor == EQ_COMPRESSOR_NONE )
+                    {
+                        const size_t offset =
+                            size_t( startRow ) * pvp.w * data->pixelSize;
+                        bufferChunks.push_back( pression::CompressorChunk(
+                            static_cast< uint8_t* >( data->pixels ) + offset,
+                            bufferSize ));
+                    }
+                }
+                else if( sparse )
+                {
+                    data = &image->getPixelData( buffer );
+                    bufferSize = image->getPixelDataSize( buffer );
+                    const std::vector< uint32_t >& spans = data->spans;
+                    const uint32_t h = data->pvp.h;
+                    std::vector< uint8_t >& active = activePixels[j];
+                    active.resize( detail::spans::getNumActivePixels( spans,
+                                                                      h ) *
+                                   data->pixelSize );
+                    if( !active.empty( ))
+                        detail::spans::pack(
+                            static_cast< const uint8_t* >( data->pixels ),
+                            data->pixelSize, data->pvp.w, h, spans,
+                            &active[0] );
+
+                    bufferChunks.push_back( pression::CompressorChunk(
+                        const_cast< uint32_t* >( &spans[0] ),
+                        spans.size() * sizeof( uint32_t )));
+                    bufferChunks.push_back( pression::CompressorChunk(
+                        active.empty() ? 0 : &active[0], active.size( )));
+                }
+                else if( repeat &&
+                         _repeatTemporal( _getTransmitReference( *_impl,
+                                              frameDataVersion.identifier,
+                                              imageIndex * 2 + j ),
+                                          receiverIDs,
+                                          image->getPixelData( buffer ),
+                                          bufferChunks ))
+                {
+                    data = &image->getPixelData( buffer );
+                    bufferSize = image->getPixelDataSize( buffer );
+                    temporalMode = FrameData::TEMPORAL_DELTA;
+                    measure = false;
+                }
+                else
+                {
+                    // pixel data compressed by the download plugin
+                    if( image->getPixelData( buffer ).compressedData.
+                        isCompressed( ))
+                    {
+                        measure = false;
+                    }
+                    data = useCompression[j] ?
+                        &image->compressPixelData( buffer ) :
+                        &image->getPixelData( buffer );
+                    bufferSize = image->getPixelDataSize( buffer );
+                    if( data->compressedData.isCompressed( ))
+                    {
+                        compressor = data->compressedData.compressor;
+                        bufferChunks = data->compressedData.chunks;
+                    }
+                    else if( temporal && data->pvp.hasArea( ))
+                    {
+                        temporalMode = _encodeTemporal(
+                            _getTransmitReference( *_impl,
+                                                   frameDataVersion.identifier,
+                                                   imageIndex * 2 + j ),
+                            receiverIDs, *data, bufferChunks );
+                    }
+                    else
+                    {
+                        const uint64_t dataSize =
+                            data->pvp.getArea() * data->pixelSize;
+                        bufferChunks.push_back( pression::CompressorChunk(
+                                                    data->pixels, dataSize ));
+                    }
+                }
+
+                const float compressTime = clock.getTimef();
 
-                const PixelData& data = useCompression ?
-                    image->compressPixelData( buffer ) :
-                    image->getPixelData( buffer );
-                pixelDatas.push_back( &data );
-                qualities.push_back( image->getQuality( buffer ));
+                const FrameData::ImageHeader header =
+                    { data->internalFormat, data->externalFormat,
+                      data->pixelSize, banded ? bandPVP : data->pvp,
+                      compressor, data->compressorFlags,
+                      uint32_t( bufferChunks.size( )),
+                      image->getQuality( buffer ), sparse ? 1u : 0u,
+                      temporalMode, 0 };
 
-                if( data.compressedData.isCompressed( ))
+                // format, type, nChunks, compressor name
+                imageDataSize += sizeof( FrameData::ImageHeader );
+                uint64_t compressedSize = 0;
+                BOOST_FOREACH( const pression::CompressorChunk& chunk,
+                               bufferChunks )
                 {
-                    imageDataSize += data.compressedData.getSize() +
-                        data.compressedData.chunks.size() * sizeof( uint64_t );
-                    compressEvent.event.data.statistic.plugins[j] =
-                        data.compressedData.compressor;
+                    imageDataSize += sizeof( uint64_t ) + chunk.getNumBytes();
+                    compressedSize += chunk.getNumBytes();
+                }
+                if( measure && compressor != EQ_COMPRESSOR_NONE )
+                {
+                    BOOST_FOREACH( const Receiver& receiver, receivers )
+                        if( receiver.useCompression[j] )
+                            selector.compressed( receiver.node->getNodeID(),
+                                                 buffer, bufferSize,
+                                                 compressedSize, compressTime );
                 }
-                else
-                    imageDataSize += sizeof( uint64_t ) +
-                                     image->getPixelDataSize( buffer );
 
+                compressEvent.event.data.statistic.plugins[j] = compressor;
+                headers.push_back( header );
+                chunks.push_back( bufferChunks );
                 commandBuffers |= buffer;
-                rawSize += image->getPixelDataSize( buffer );
+                rawSize += bufferSize;
             }
-        }
 
-        if( rawSize > 0 )
-            compressEvent.event.data.statistic.ratio =
-            static_cast< float >( imageDataSize ) /
-            static_cast< float >( rawSize );
-    }
+            if( rawSize > 0 )
+                compressEvent.event.data.statistic.ratio =
+                static_cast< float >( imageDataSize ) /
+                static_cast< float >( rawSize );
+        }
 
-    if( pixelDatas.empty( ))
-        return;
+        if( headers.empty( ))
+            return;
 
-    // send image pixel data command
-    co::LocalNode::SendToken token;
-    if( getIAttribute( IATTR_HINT_SENDTOKEN ) == ON )
-    {
-        ChannelStatistics waitEvent( Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN,
-                                     this, frameNumber );
-        waitEvent.event.data.statistic.task = taskID;
-        token = getLocalNode()->acquireSendToken( toNode );
-    }
-    LBASSERT( image->getPixelViewport().isValid( ));
+        // send image pixel data command to each receiver
+        if( startRow == 0 && getIAttribute( IATTR_HINT_SENDTOKEN ) == ON )
+        {
+            ChannelStatistics waitEvent(
+                Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN, this, frameNumber );
+            waitEvent.event.data.statistic.task = taskID;
+            BOOST_FOREACH( Receiver& receiver, receivers )
+                receiver.token = localNode->acquireSendToken( receiver.node );
+        }
 
-    co::ObjectOCommand command( co::Connections( 1, connection ),
-                                fabric::CMD_NODE_FRAMEDATA_TRANSMIT,
-                                co::COMMANDTYPE_OBJECT, nodeID,
-                                CO_INSTANCE_ALL );
-    command << frameDataVersion << image->getPixelViewport() << image->getZoom()
-            << commandBuffers << frameNumber << image->getAlphaUsage();
-    command.sendHeader( imageDataSize );
+        BOOST_FOREACH( const Receiver& receiver, receivers )
+        {
+            co::ConnectionPtr connection = receiver.connection;
+            co::ObjectOCommand command( co::Connections( 1, connection ),
+                                        fabric::CMD_NODE_FRAMEDATA_TRANSMIT,
+                                        co::COMMANDTYPE_OBJECT,
+                                        receiver.nodeID, CO_INSTANCE_ALL );
+            command << frameDataVersion << bandPVP << image->getZoom()
+                    << commandBuffers << frameNumber << image->getAlphaUsage();
+            command.sendHeader( imageDataSize );
 
 #ifndef NDEBUG
-    size_t sentBytes = 0;
+            size_t sentBytes = 0;
 #endif
 
-    for( uint32_t j=0; j < pixelDatas.size(); ++j )
-    {
+            clock.reset();
+            for( size_t j = 0; j < headers.size(); ++j )
+            {
+                connection->send( &headers[j],
+                                  sizeof( FrameData::ImageHeader ), true );
 #ifndef NDEBUG
-        sentBytes += sizeof( FrameData::ImageHeader );
+                sentBytes += sizeof( FrameData::ImageHeader );
 #endif
-        const PixelData* data = pixelDatas[j];
-        const bool isCompressed = data->compressedData.isCompressed();
-        const uint32_t nChunks = isCompressed ?
-            uint32_t( data->compressedData.chunks.size( )) : 1;
-
-        const FrameData::ImageHeader header =
-              { data->internalFormat, data->externalFormat,
-                data->pixelSize, data->pvp,
-                isCompressed ? data->compressedData.compressor :
-                               EQ_COMPRESSOR_NONE,
-                data->compressorFlags, nChunks, qualities[ j ] };
-
-        connection->send( &header, sizeof( header ), true );
-
-        if( isCompressed )
-        {
-            BOOST_FOREACH( const pression::CompressorChunk& chunk,
-                           data->compressedData.chunks )
-            {
-                const uint64_t dataSize = chunk.getNumBytes();
+                BOOST_FOREACH( const pression::CompressorChunk& chunk,
+                               chunks[j] )
+                {
+                    const uint64_t dataSize = chunk.getNumBytes();
 
-                connection->send( &dataSize, sizeof( dataSize ), true );
-                if( dataSize > 0 )
-                    connection->send( chunk.data, dataSize, true );
+                    connection->send( &dataSize, sizeof( dataSize ), true );
+                    if( dataSize > 0 )
+                        connection->send( chunk.data, dataSize, true );
 #ifndef NDEBUG
-                sentBytes += sizeof( dataSize ) + dataSize;
+                    sentBytes += sizeof( dataSize ) + dataSize;
 #endif
+                }
             }
-        }
-        else
-        {
-            const uint64_t dataSize = data->pvp.getArea() * data->pixelSize;
-            connection->send( &dataSize, sizeof( dataSize ), true );
-            connection->send( data->pixels, dataSize, true );
+            selector.sent( receiver.node->getNodeID(), imageDataSize,
+                           clock.getTimef( ));
 #ifndef NDEBUG
-            sentBytes += sizeof( dataSize ) + dataSize;
+            LBASSERTINFO( sentBytes == imageDataSize,
+                          sentBytes << " != " << imageDataSize );
 #endif
         }
     }
-#ifndef NDEBUG
-    LBASSERTINFO( sentBytes == imageDataSize,
-        sentBytes << " != " << imageDataSize );
-#endif
 }
 
 void Channel::_setReady( const bool async, detail::RBStat* stat,
                          const Frames& frames )
 {
-    for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
+    // batch the frames with the same receivers, which share a transmit lane
+    const Eye eye = getEye();
+    std::vector< bool >& done = _impl->readyFrames;
+    done.assign( frames.size(), false );
+    co::ObjectVersions& batch = _impl->readyBatch;
+    _impl->reserve( batch, frames.size( ));
+    for( size_t i = 0; i < frames.size(); ++i )
     {
-        Frame* frame = *i;
-        const Eye eye = getEye();
-        const std::vector< uint128_t >& nodes = frame->getInputNodes( eye );
-        const co::NodeIDs& netNodes = frame->getInputNetNodes(eye);
+        if( done[i] )
+            continue;
+
+        const std::vector< uint128_t >& nodes =
+            frames[i]->getInputNodes( eye );
+        const co::NodeIDs& netNodes = frames[i]->getInputNetNodes( eye );
+        batch.clear();
+        for( size_t j = i; j < frames.size(); ++j )
+        {
+            if( done[j] || frames[j]->getInputNetNodes( eye ) != netNodes )
+                continue;
+            batch.push_back( co::ObjectVersion( frames[j]->getFrameData( )));
+            done[j] = true;
+        }
 
         if( async )
-            _asyncSetReady( frame->getFrameData(), stat, nodes, netNodes );
+            _asyncSetReady( batch, stat, nodes, netNodes );
         else
-            _setReady( frame->getFrameData(), stat, nodes, netNodes );
+            _setReady( batch, stat, nodes, netNodes );
     }
 }
 
-void Channel::_asyncSetReady( const FrameDataPtr frame, detail::RBStat* stat,
+void Channel::_asyncSetReady( const co::ObjectVersions& frames,
+                              detail::RBStat* stat,
                               const std::vector< uint128_t >& nodes,
                               const co::NodeIDs& netNodes )
 {
@@ -1458,29 +2611,42 @@ void Channel::_asyncSetReady( const FrameDataPtr frame, detail::RBStat* stat,
     stat->ref( 0 );
 
     send( getLocalNode(), fabric::CMD_CHANNEL_FRAME_SET_READY )
-            << co::ObjectVersion( frame ) << stat << nodes << netNodes;
+            << frames << stat << nodes << netNodes;
 }
 
-void Channel::_setReady( FrameDataPtr frame, detail::RBStat* stat,
+void Channel::_setReady( const co::ObjectVersions& frames,
+                         detail::RBStat* stat,
                          const std::vector< uint128_t >& nodes,
                          const co::NodeIDs& netNodes )
 {
-    LBLOG( LOG_TASKS|LOG_ASSEMBLY ) << "Set ready " << co::ObjectVersion(frame)
-                                    << std::endl;
-    frame->setReady();
+    for( co::ObjectVersions::const_iterator i = frames.begin();
+         i != frames.end(); ++i )
+    {
+        LBLOG( LOG_TASKS|LOG_ASSEMBLY ) << "Set ready " << *i << std::endl;
+        FrameDataPtr frame = getNode()->getFrameData( *i );
+        frame->setReady();
+        _addReadbackStatistics( *frame, stat );
+    }
 
+    // One notification per receiving node for all frames, queued in the same
+    // transmit lane as the images sent to these receivers, see
+    // detail::TransmitQueue
     const uint32_t frameNumber = stat->event.event.data.statistic.frameNumber;
+    LBASSERT( nodes.size() == netNodes.size( ));
     _refFrame( frameNumber );
-
     send( getLocalNode(), fabric::CMD_CHANNEL_FRAME_SET_READY_NODE )
-            << co::ObjectVersion( frame ) << nodes << netNodes << frameNumber;
+        << frames << nodes << netNodes << frameNumber;
+}
 
+void Channel::_addReadbackStatistics( const FrameData& frame,
+                                      detail::RBStat* stat )
+{
     const DrawableConfig& dc = getDrawableConfig();
     const size_t colorBytes = ( 3 * dc.colorBits + dc.alphaBits ) / 8;
 
     {
         lunchbox::ScopedFastWrite mutex( stat->lock );
-        const Images& images = frame->getImages();
+        const Images& images = frame.getImages();
         for( ImagesCIter i = images.begin(); i != images.end(); ++i )
         {
             const Image* image = *i;
@@ -1526,6 +2692,7 @@ bool Channel::_cmdConfigInit( co::ICommand& cmd )
 
     const Config* config = getConfig();
     changeLatency( config->getLatency( ));
+    _impl->lastContext = RenderContext(); // reset by the server on init
 
     bool result = false;
     const Window* window = getWindow();
@@ -1560,7 +2727,22 @@ bool Channel::_cmdConfigExit( co::ICommand& cmd )
     LBLOG( LOG_INIT ) << "Exit channel " << co::ObjectICommand( cmd )
                       << std::endl;
 
+    flushAssembly();
     _deleteTransferContext();
+    if( _impl->reprojector.hasImage() || _impl->timerQueries ||
+        _impl->multiView.hasFrameBuffers() || _hasUpsamplingHistory( ))
+    {
+        getWindow()->makeCurrent();
+        _impl->reprojector.flush( *this );
+        for( size_t i = 0; i < NUM_EYES; ++i )
+            _impl->upsamplers[ i ].flush( *this );
+        _impl->multiView.flush( *this );
+        _collectTimerStatistics( LB_UNDEFINED_UINT32 );
+        delete _impl->timerQueries;
+        _impl->timerQueries = 0;
+    }
+    _impl->checkTimerQueries = true;
+    _impl->useMultiView = true;
 
     if( _impl->state != STATE_STOPPED )
         _impl->state = configExit() ? STATE_STOPPED : STATE_FAILED;
@@ -1572,9 +2754,12 @@ bool Channel::_cmdConfigExit( co::ICommand& cmd )
 
 bool Channel::_cmdFrameStart( co::ICommand& cmd )
 {
+    if( _deferTask( cmd, &Channel::_cmdFrameStart ))
+        return true;
+
     co::ObjectICommand command( cmd );
 
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _readContext( command );
     const uint128_t& version = command.read< uint128_t >();
     const uint32_t frameNumber = command.read< uint32_t >();
 
@@ -1588,6 +2773,10 @@ bool Channel::_cmdFrameStart( co::ICommand& cmd )
     bindFrameBuffer();
     frameStart( context.frameID, frameNumber );
 
+    // the statistics slot of this frame has to be released
+    const uint32_t nSlots = uint32_t( _impl->statistics->size( ));
+    _collectTimerStatistics( frameNumber > nSlots ? frameNumber - nSlots : 0 );
+
     const size_t index = frameNumber % _impl->statistics->size();
     detail::Channel::FrameStatistics& statistic = _impl->statistics.data[index];
     LBASSERTINFO( statistic.used == 0,
@@ -1601,9 +2790,12 @@ bool Channel::_cmdFrameStart( co::ICommand& cmd )
 
 bool Channel::_cmdFrameFinish( co::ICommand& cmd )
 {
+    if( _deferTask( cmd, &Channel::_cmdFrameFinish ))
+        return true;
+
     co::ObjectICommand command( cmd );
 
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _readContext( command );
     const uint32_t frameNumber = command.read< uint32_t >();
 
     LBLOG( LOG_TASKS ) << "TASK frame finish " << getName() <<  " " << command
@@ -1613,16 +2805,32 @@ bool Channel::_cmdFrameFinish( co::ICommand& cmd )
     frameFinish( context.frameID, frameNumber );
     resetContext();
 
+    _collectTimerStatistics( 0 );
     _unrefFrame( frameNumber );
+
+#ifndef NDEBUG
+    // verify that the steady state frame loop does not allocate task memory
+    const size_t nAllocations = _impl->getTaskAllocations();
+    if( nAllocations != _impl->nTaskAllocations )
+    {
+        LBLOG( LOG_TASKS ) << nAllocations - _impl->nTaskAllocations
+                           << " task allocations in frame " << frameNumber
+                           << " of " << getName() << std::endl;
+        _impl->nTaskAllocations = nAllocations;
+    }
+#endif
     return true;
 }
 
 bool Channel::_cmdFrameClear( co::ICommand& cmd )
 {
+    if( _deferTask( cmd, &Channel::_cmdFrameClear ))
+        return true;
+
     LBASSERT( _impl->state == STATE_RUNNING );
 
     co::ObjectICommand command( cmd );
-    RenderContext context  = command.read< RenderContext >();
+    RenderContext context  = _readContext( command );
 
     LBLOG( LOG_TASKS ) << "TASK clear " << getName() <<  " " << command
                        << " " << context << std::endl;
@@ -1639,20 +2847,36 @@ bool Channel::_cmdFrameClear( co::ICommand& cmd )
 
 bool Channel::_cmdFrameDraw( co::ICommand& cmd )
 {
+    if( _deferTask( cmd, &Channel::_cmdFrameDraw ))
+        return true;
+
     co::ObjectICommand command( cmd );
-    RenderContext context  = command.read< RenderContext >();
+    RenderContext context  = _readContext( command );
     const bool finish = command.read< bool >();
 
     LBLOG( LOG_TASKS ) << "TASK draw " << getName() <<  " " << command
                        << " " << context << std::endl;
 
+    // late latching: use the latest head matrix of the tracker
+    const View* view = getPipe()->getView( context.view );
+    const Observer* observer = view ? view->getObserver() : 0;
+    Matrix4f head;
+    if( observer && observer->getLatchedHeadMatrix( head ))
+        _latchHead( context, head, observer->getEyePosition( context.eye ),
+                    view->getModelUnit( ));
+
     bindDrawFrameBuffer();
     _overrideContext( context );
     const uint32_t frameNumber = getCurrentFrame();
     ChannelStatistics event( Statistic::CHANNEL_DRAW, this, frameNumber,
                              finish ? NICEST : AUTO );
 
-    frameDraw( context.frameID );
+    // the right eye of a multi view draw only needs to be copied
+    if( context.eye == EYE_RIGHT && _impl->multiView.hasImage( context ))
+        _impl->multiView.blit( *this, EYE_RIGHT );
+    else if( getSAttribute( SATTR_PLAYBACK_IMAGES ).empty( )) // else replayed
+        frameDraw( context.frameID );
+
     // Update ROI for server equalizers
     if( !getRegion().isValid( ))
         declareRegion( getPixelViewport( ));
@@ -1665,8 +2889,74 @@ bool Channel::_cmdFrameDraw( co::ICommand& cmd )
     return true;
 }
 
+bool Channel::_cmdFrameDrawMultiView( co::ICommand& cmd )
+{
+    if( _deferTask( cmd, &Channel::_cmdFrameDrawMultiView ))
+        return true;
+
+    co::ObjectICommand command( cmd );
+    RenderContext context = _readContext( command );
+    _impl->rightContext = _readContext( command );
+    const bool finish = command.read< bool >();
+
+    LBLOG( LOG_TASKS ) << "TASK draw multiview " << getName() <<  " "
+                       << command << " " << context << std::endl;
+
+    const View* view = getPipe()->getView( context.view );
+    const Observer* observer = view ? view->getObserver() : 0;
+    Matrix4f head;
+    if( observer && observer->getLatchedHeadMatrix( head ))
+    {
+        _latchHead( context, head, observer->getEyePosition( EYE_LEFT ),
+                    view->getModelUnit( ));
+        _latchHead( _impl->rightContext, head,
+                    observer->getEyePosition( EYE_RIGHT ),
+                    view->getModelUnit( ));
+    }
+
+    bindDrawFrameBuffer();
+    _overrideContext( context );
+    const uint32_t frameNumber = getCurrentFrame();
+    ChannelStatistics event( Statistic::CHANNEL_DRAW, this, frameNumber,
+                             finish ? NICEST : AUTO );
+
+    bool drawn = false;
+    if( _impl->useMultiView && _impl->multiView.bind( *this ))
+    {
+        drawn = frameDrawMultiView( context.frameID );
+        _impl->multiView.unbind( *this );
+        if( drawn )
+        {
+            _impl->multiView.setImage( context );
+            _impl->multiView.blit( *this, EYE_LEFT );
+        }
+        else
+        {
+            LBINFO << "Channel " << getName() << " does not implement "
+                   << "frameDrawMultiView, drawing eyes separately"
+                   << std::endl;
+            _impl->useMultiView = false;
+        }
+    }
+    if( !drawn )
+        frameDraw( context.frameID );
+
+    if( !getRegion().isValid( ))
+        declareRegion( getPixelViewport( ));
+    const size_t index = frameNumber % _impl->statistics->size();
+    _impl->statistics.data[ index ].region = getRegion() / getPixelViewport();
+
+    resetContext();
+    bindFrameBuffer();
+
+    return true;
+}
+
 bool Channel::_cmdFrameDrawFinish( co::ICommand& cmd )
 {
+    if( _deferTask( cmd, &Channel::_cmdFrameDrawFinish ))
+        return true;
+
     co::ObjectICommand command( cmd );
     const uint128_t& frameID = command.read< uint128_t >();
     const uint32_t frameNumber = command.read< uint32_t >();
@@ -1683,8 +2973,11 @@ bool Channel::_cmdFrameDrawFinish( co::ICommand& cmd )
 
 bool Channel::_cmdFrameAssemble( co::ICommand& cmd )
 {
+    if( _deferTask( cmd, &Channel::_cmdFrameAssemble ))
+        return true;
+
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _readContext( command );
     const co::ObjectVersions& frameIDs = command.read< co::ObjectVersions >();
 
     LBLOG( LOG_TASKS | LOG_ASSEMBLY )
@@ -1693,9 +2986,20 @@ bool Channel::_cmdFrameAssemble( co::ICommand& cmd )
 
     _overrideContext( context );
 
-    ChannelStatistics event( Statistic::CHANNEL_ASSEMBLE, this );
     const Frames& frames = _getFrames( frameIDs, false );
-    frameAssemble( context.frameID, frames );
+    BOOST_FOREACH( const Frame* frame, frames )
+    {
+        Zoom zoom = frame->getZoom();
+        zoom.apply( frame->getFrameData()->getZoom( ));
+        _impl->inputZoom.x() = std::max( _impl->inputZoom.x(), zoom.x( ));
+        _impl->inputZoom.y() = std::max( _impl->inputZoom.y(), zoom.y( ));
+    }
+
+    if( !_startAsyncAssembly( frames ))
+    {
+        ChannelStatistics event( Statistic::CHANNEL_ASSEMBLE, this );
+        frameAssemble( context.frameID, frames );
+    }
 
     resetContext();
     return true;
@@ -1703,8 +3007,11 @@ bool Channel::_cmdFrameAssemble( co::ICommand& cmd )
 
 bool Channel::_cmdFrameReadback( co::ICommand& cmd )
 {
+    if( _deferTask( cmd, &Channel::_cmdFrameReadback ))
+        return true;
+
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _readContext( command );
     const co::ObjectVersions& frames = command.read< co::ObjectVersions >();
     LBLOG( LOG_TASKS | LOG_ASSEMBLY ) << "TASK readback " << getName() <<  " "
                                       << command << " " << context<< " nFrames "
@@ -1742,8 +3049,7 @@ bool Channel::_cmdFrameSetReady( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
 
-    const co::ObjectVersion frameDataVersion =
-            command.read< co::ObjectVersion >();
+    const co::ObjectVersions& frames = command.read< co::ObjectVersions >();
     detail::RBStat* stat = command.read< detail::RBStat* >();
     const std::vector< uint128_t >& nodes =
             command.read< std::vector< uint128_t > >();
@@ -1751,8 +3057,7 @@ bool Channel::_cmdFrameSetReady( co::ICommand& cmd )
 
     LBASSERT( stat->event.event.data.statistic.frameNumber > 0 );
 
-    FrameDataPtr frameData = getNode()->getFrameData( frameDataVersion );
-    _setReady( frameData, stat, nodes, netNodes );
+    _setReady( frames, stat, nodes, netNodes );
 
     const uint32_t frame = stat->event.event.data.statistic.frameNumber;
     stat->unref( 0 );
@@ -1764,18 +3069,20 @@ bool Channel::_cmdFrameTransmitImage( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
     const co::ObjectVersion& frameData = command.read< co::ObjectVersion >();
-    const uint128_t& nodeID = command.read< uint128_t >();
-    const co::NodeID& netNodeID = command.read< co::NodeID >();
+    const std::vector< uint128_t >& nodes =
+        command.read< std::vector< uint128_t > >();
+    const co::NodeIDs& netNodes = command.read< co::NodeIDs >();
     const uint64_t imageIndex = command.read< uint64_t >();
     const uint32_t frameNumber = command.read< uint32_t >();
     const uint32_t taskID = command.read< uint32_t >();
+    const int64_t queueTime = command.read< int64_t >();
 
     LBLOG( LOG_TASKS|LOG_ASSEMBLY ) << "Transmit " << command << " frame data "
-                                    << frameData << " receiver " << nodeID
-                                    << " on " << netNodeID << std::endl;
+                                    << frameData << " to " << nodes.size()
+                                    << " receivers" << std::endl;
 
-    _transmitImage( frameData, nodeID, netNodeID, imageIndex, frameNumber,
-                    taskID );
+    _transmitImage( frameData, nodes, netNodes, imageIndex, frameNumber,
+                    taskID, queueTime );
     _unrefFrame( frameNumber );
     return true;
 }
@@ -1784,15 +3091,14 @@ bool Channel::_cmdFrameSetReadyNode( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
 
-    const co::ObjectVersion& frameDataVersion =
-            command.read< co::ObjectVersion >();
+    const co::ObjectVersions& frames = command.read< co::ObjectVersions >();
     const std::vector< uint128_t >& nodes =
             command.read< std::vector< uint128_t > >();
     const co::NodeIDs& netNodes = command.read< co::NodeIDs >();
     const uint32_t frameNumber = command.read< uint32_t >();
 
     co::LocalNodePtr localNode = getLocalNode();
-    const FrameDataPtr frameData = getNode()->getFrameData( frameDataVersion );
+    Node* node = getNode();
 
     co::NodeIDs::const_iterator j = netNodes.begin();
     for( std::vector< uint128_t >::const_iterator i = nodes.begin();
@@ -1805,10 +3111,17 @@ bool Channel::_cmdFrameSetReadyNode( co::ICommand& cmd )
                     << frameNumber << std::endl;
             continue;
         }
-        co::ObjectOCommand( co::Connections( 1, toNode->getConnection( )),
-                            fabric::CMD_NODE_FRAMEDATA_READY,
-                            co::COMMANDTYPE_OBJECT, *i, CO_INSTANCE_ALL )
-            << frameDataVersion << frameData->getData();
+        co::ObjectOCommand command( co::Connections( 1,
+                                                     toNode->getConnection( )),
+                                    fabric::CMD_NODE_FRAMEDATA_READY,
+                                    co::COMMANDTYPE_OBJECT, *i,
+                                    CO_INSTANCE_ALL );
+        command << uint32_t( frames.size( ));
+        for( co::ObjectVersions::const_iterator k = frames.begin();
+             k != frames.end(); ++k )
+        {
+            command << *k << node->getFrameData( *k )->getData();
+        }
     }
 
     _unrefFrame( frameNumber );
@@ -1817,8 +3130,11 @@ bool Channel::_cmdFrameSetReadyNode( co::ICommand& cmd )
 
 bool Channel::_cmdFrameViewStart( co::ICommand& cmd )
 {
+    if( _deferTask( cmd, &Channel::_cmdFrameViewStart ))
+        return true;
+
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _readContext( command );
 
     LBLOG( LOG_TASKS ) << "TASK view start " << getName() <<  " " << command
                        << " " << context << std::endl;
@@ -1830,15 +3146,49 @@ bool Channel::_cmdFrameViewStart( co::ICommand& cmd )
     return true;
 }
 
+void Channel::_resolveUpsampling()
+{
+    const Zoom zoom = _impl->inputZoom;
+    _impl->inputZoom = Zoom::NONE;
+
+    detail::TemporalUpsampler& upsampler =
+        _impl->upsamplers[ lunchbox::getIndexOfLastBit( getEye( ))];
+    if( getIAttribute( IATTR_HINT_TEMPORAL_UPSAMPLING ) != ON ||
+        ( zoom.x() <= 1.f && zoom.y() <= 1.f ))
+    {
+        upsampler.reset();
+        return;
+    }
+
+    // the sources are jittered in their pixels, see getJitter()
+    const Vector2f& jitter = _getTemporalJitter( getCurrentFrame( ));
+    const Vector2f offset( jitter.x() * zoom.x(), jitter.y() * zoom.y( ));
+    upsampler.resolve( *this, offset );
+}
+
+bool Channel::_hasUpsamplingHistory() const
+{
+    for( size_t i = 0; i < NUM_EYES; ++i )
+        if( _impl->upsamplers[ i ].hasHistory( ))
+            return true;
+    return false;
+}
+
 bool Channel::_cmdFrameViewFinish( co::ICommand& cmd )
 {
+    if( _deferTask( cmd, &Channel::_cmdFrameViewFinish ))
+        return true;
+
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _readContext( command );
 
     LBLOG( LOG_TASKS ) << "TASK view finish " << getName() <<  " " << command
                        << " " << context << std::endl;
 
     _overrideContext( context );
+    _resolveUpsampling();
+    if( getIAttribute( IATTR_HINT_REPROJECTION ) != OFF )
+        _impl->reprojector.capture( *this );
     {
         ChannelStatistics event( Statistic::CHANNEL_VIEW_FINISH, this );
         frameViewFinish( context.frameID );
@@ -1861,17 +3211,21 @@ bool Channel::_cmdStopFrame( co::ICommand& cmd )
 
 bool Channel::_cmdFrameTiles( co::ICommand& cmd )
 {
+    if( _deferTask( cmd, &Channel::_cmdFrameTiles ))
+        return true;
+
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _readContext( command );
     const bool isLocal = command.read< bool >();
-    const uint128_t& queueID = command.read< uint128_t >();
+    const std::vector< uint128_t >& queueIDs =
+        command.read< std::vector< uint128_t > >();
     const uint32_t tasks = command.read< uint32_t >();
     const co::ObjectVersions& frames = command.read< co::ObjectVersions >();
 
     LBLOG( LOG_TASKS ) << "TASK channel frame tiles " << getName() <<  " "
                        << command << " " << context << std::endl;
 
-    _frameTiles( context, isLocal, queueID, tasks, frames );
+    _frameTiles( context, isLocal, queueIDs, tasks, frames );
     return true;
 }
 
@@ -1881,16 +3235,126 @@ bool Channel::_cmdDeleteTransferContext( co::ICommand& cmd )
 
     LBLOG( LOG_INIT ) << "Delete transfer context " << command << std::endl;
 
-    getWindow()->deleteTransferSystemWindow();
+    Window* window = getWindow();
+    if( !_impl->uploader.isEmpty( ))
+    {
+        // another channel of the window might have deleted the context
+        const GLEWContext* gl = 0;
+        if( window->hasTransferWindow( ))
+        {
+            window->makeCurrentTransfer();
+            gl = window->getTransferGlewContext();
+        }
+        _impl->uploader.flush( gl );
+    }
+    window->deleteTransferSystemWindow();
     getLocalNode()->serveRequest( command.read< uint32_t >( ));
     return true;
 }
 
+bool Channel::_cmdWaitAssembly( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    detail::AsyncAssembly* assembly =
+        command.read< detail::AsyncAssembly* >();
+
+    LBLOG( LOG_TASKS|LOG_ASSEMBLY ) << "Wait for async assembly " << command
+                                    << std::endl;
+
+    // Does not block earlier transfer tasks of this pipe, since they were
+    // queued before this command.
+    const uint32_t nFrames = uint32_t( assembly->frames.size( ));
+    if( assembly->interval > 0 )
+    {
+        // Reproject the last image on the pipe thread for each missed
+        // display interval until the input frames are ready
+        const Config* config = getConfig();
+        for( ;; )
+        {
+            const int64_t wait = assembly->deadline - config->getTime();
+            if( wait > 0 &&
+                assembly->ready.timedWaitGE( nFrames, uint32_t( wait )))
+            {
+                break;
+            }
+            if( assembly->ready.get() >= nFrames )
+                break;
+
+            while( assembly->deadline <= config->getTime( ))
+                assembly->deadline += assembly->interval;
+            assembly->ref(); // released by _cmdReproject
+            send( getLocalNode(), fabric::CMD_CHANNEL_REPROJECT ) << assembly;
+        }
+    }
+    else if( assembly->upload )
+        _uploadAssembly( *assembly );
+    else
+        assembly->ready.waitGE( nFrames );
+    send( getLocalNode(), fabric::CMD_CHANNEL_FINISH_ASSEMBLY ) << assembly;
+    return true;
+}
+
+bool Channel::_cmdFinishAssembly( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    detail::AsyncAssembly* assembly =
+        command.read< detail::AsyncAssembly* >();
+
+    LBLOG( LOG_TASKS|LOG_ASSEMBLY ) << "TASK finish async assembly "
+                                    << getName() << " " << command
+                                    << std::endl;
+
+    // a no-op if the assembly was already flushed by a later task
+    if( _impl->asyncAssembly.get() == assembly )
+        flushAssembly();
+    assembly->unref();
+    return true;
+}
+
+bool Channel::_cmdReproject( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    detail::AsyncAssembly* assembly =
+        command.read< detail::AsyncAssembly* >();
+
+    LBLOG( LOG_TASKS|LOG_ASSEMBLY ) << "TASK reproject " << getName() << " "
+                                    << command << std::endl;
+
+    // the frame might have been assembled in the meantime
+    if( _impl->asyncAssembly.get() != assembly )
+    {
+        assembly->unref();
+        return true;
+    }
+
+    // reproject to the newest head position known
+    RenderContext context = assembly->context;
+    const View* view = getPipe()->getView( context.view );
+    const Observer* observer = view ? view->getObserver() : 0;
+    Matrix4f head;
+    if( observer && observer->getLatchedHeadMatrix( head ))
+        _latchHead( context, head, observer->getEyePosition( context.eye ),
+                    view->getModelUnit( ));
+
+    Window* window = getWindow();
+    window->makeCurrent();
+    overrideContext( context );
+    if( _impl->reprojector.draw( *this ))
+    {
+        window->swapBuffers();
+        _impl->reprojector.restore( *this );
+    }
+    resetContext();
+    assembly->unref();
+    return true;
+}
+
 }
 
 namespace lunchbox
 {
 template<> inline void byteswap( eq::detail::RBStat*& ) { /*NOP*/ }
+template<> inline void byteswap( eq::detail::AsyncAssembly*& ) { /*NOP*/ }
 }
 
 #include "../fabric/channel.ipp"
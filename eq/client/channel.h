@@ -24,10 +24,14 @@
 #include <eq/client/types.h>
 
 #include <eq/fabric/channel.h>        // base class
+#include <eq/fabric/frame.h>          // enum Frame::Buffer
 
 namespace eq
 {
-namespace detail { class Channel; struct RBStat; }
+namespace detail
+{
+class Channel; struct RBStat; class TimerQueries; class AsyncAssembly;
+}
 
 /**
  * A channel represents a two-dimensional viewport within a Window.
@@ -56,6 +60,23 @@ public:
     EQ_API uint32_t getCurrentFrame() const; //!< @internal render thr only
     void waitFrameFinished( const uint32_t frame ) const; //!< @internal
 
+    /**
+     * @internal Run a deferred assembly and the tasks queued behind it.
+     *
+     * @param frameDataID if set, flush only if the deferred assembly reads
+     *                    this frame data.
+     * @return true if a deferred assembly was run.
+     */
+    bool flushAssembly( const uint128_t& frameDataID = uint128_t( ));
+
+    /**
+     * @internal
+     * @return the texture of an image buffer uploaded during the deferred
+     *         assembly, or 0 if the image has to be uploaded by the caller.
+     */
+    const util::Texture* getUploadedTexture( const Image* image,
+                                     const fabric::Frame::Buffer buffer ) const;
+
     /**
      * @return true if this channel is stopped, false otherwise.
      * @version 1.0
@@ -104,6 +125,18 @@ public:
     /** @return the channel's drawable config. @version 1.0 */
     EQ_API const DrawableConfig& getDrawableConfig() const;
 
+    /**
+     * Get the main memory frame buffer of the window.
+     *
+     * CPU renderers using a memory::Window draw the channel's pixel viewport
+     * into the returned pixels. The frame buffer covers the whole window.
+     *
+     * @return the window's main memory frame buffer of the given buffer, or 0
+     *         if the window renders using OpenGL.
+     * @version 1.9
+     */
+    EQ_API PixelData* getPixelData( const Frame::Buffer buffer );
+
     /**
      * Get the channel's native view.
      *
@@ -137,11 +170,24 @@ public:
      */
     //@{
     /**
-     * @return the jitter vector for the current subpixel decomposition.
+     * @return the jitter vector for the current subpixel decomposition, or
+     *         for temporal upsampling of a downscaled rendering.
      * @version 1.0
+     * @sa IATTR_HINT_TEMPORAL_UPSAMPLING
      */
     EQ_API virtual Vector2f getJitter() const;
 
+    /**
+     * @return the jitter vector of one sample of a low-discrepancy sequence.
+     *
+     * Used for progressive anti-aliasing over many frames. The channels of a
+     * sub-pixel compound should interleave the sample indices, e.g., by using
+     * step * SubPixel::size + SubPixel::index, so that the accumulated samples
+     * cover the pixel evenly after each step.
+     * @version 1.9
+     */
+    EQ_API Vector2f getJitterSample( uint32_t index ) const;
+
     /**
      * Get the channel's current View.
      *
@@ -169,6 +215,18 @@ public:
      * @version 1.0
      */
     EQ_API Frustumf getScreenFrustum() const;
+
+    /**
+     * Returns the render context of one eye during frameDrawMultiView().
+     *
+     * The current context is the context of the left eye.
+     *
+     * @param eye the eye, EYE_LEFT or EYE_RIGHT.
+     * @return the render context with the frustum and head transforms of the
+     *         given eye.
+     * @version 1.8
+     */
+    EQ_API const RenderContext& getEyeContext( const Eye eye ) const;
     //@}
 
     /**
@@ -504,6 +562,27 @@ protected:
      */
     EQ_API virtual void frameDraw( const uint128_t& frameID );
 
+    /**
+     * Draw the scene for the left and the right eye in one pass.
+     *
+     * Called instead of frameDraw() for the left eye if the channel uses
+     * IATTR_HINT_MULTIVIEW. A cleared, layered frame buffer is bound, with
+     * the left eye in layer 0 and the right eye in layer 1. The application
+     * selects the layer of each primitive, e.g., using GL_OVR_multiview or
+     * instanced drawing writing gl_Layer, using the frustum and head
+     * transform of each eye from getEyeContext(). The right eye layer is
+     * copied to its draw buffer by the draw task of the right eye, without
+     * traversing the scene again.
+     *
+     * The default implementation returns false, and frameDraw() is called
+     * for each eye.
+     *
+     * @param frameID the per-frame identifier.
+     * @return true if both eyes have been drawn, false otherwise.
+     * @version 1.8
+     */
+    EQ_API virtual bool frameDrawMultiView( const uint128_t& frameID );
+
     /**
      * Assemble all input frames.
      *
@@ -586,18 +665,27 @@ protected:
 private:
     detail::Channel* const _impl;
     friend class fabric::Window< Pipe, Window, Channel, WindowSettings >;
+    friend class ChannelStatistics;
 
     //-------------------- Methods --------------------
     /** Setup the current rendering context. */
     void _overrideContext( RenderContext& context );
 
+    /** @return the delta-encoded render context read from a task command. */
+    RenderContext _readContext( co::ObjectICommand& command );
+
     /** Initialize the channel's drawable config. */
     void _initDrawableConfig();
 
     /** Tile render loop. */
+    void _storeStatistic( const Statistic& statistic );
+
     void _frameTiles( RenderContext& context, const bool isLocal,
-                      const uint128_t& queueID, const uint32_t tasks,
-                      const co::ObjectVersions& frames );
+                      const std::vector< uint128_t >& queueIDs,
+                      const uint32_t tasks, const co::ObjectVersions& frames );
+
+    /** Read back the tiles of the tile atlas. @return true if async. */
+    bool _readbackTileAtlas( RenderContext& context, const Frames& frames );
 
     /** Reference the frame for an async operation. */
     void _refFrame( const uint32_t frameNumber );
@@ -605,16 +693,30 @@ private:
     /** Check for and send frame finish reply. */
     void _unrefFrame( const uint32_t frameNumber );
 
-    /** Transmit one image of a frame to one node. */
+    /** @return the GPU timer queries, or 0 if not supported. */
+    detail::TimerQueries* _getTimerQueries();
+
+    /** Queue a GPU-timed statistic until its results are available. */
+    void _addTimerStatistic( const Event& event, const void* beginQuery );
+
+    /**
+     * Add the available GPU-timed statistics, waiting for the ones of all
+     * frames up to waitFrame.
+     */
+    void _collectTimerStatistics( uint32_t waitFrame );
+
+    /** Compress one image of a frame once and transmit it to all nodes. */
     void _transmitImage( const co::ObjectVersion& frameDataVersion,
-                         const uint128_t& nodeID,
-                         const co::NodeID& netNodeID,
+                         const std::vector< uint128_t >& nodes,
+                         const co::NodeIDs& netNodes,
                          const uint64_t imageIndex,
                          const uint32_t frameNumber,
-                         const uint32_t taskID );
+                         const uint32_t taskID,
+                         const int64_t queueTime );
 
     void _frameReadback( const uint128_t& frameID,
                          const co::ObjectVersions& frames );
+    void _playbackReadback( const Frames& frames );
     void _finishReadback( const co::ObjectVersion& frameDataVersion,
                           const uint64_t imageIndex,
                           const uint32_t frameNumber,
@@ -633,22 +735,44 @@ private:
 
     void _setReady( const bool async, detail::RBStat* stat,
                     const Frames& frames );
-    void _asyncSetReady( const FrameDataPtr frame, detail::RBStat* stat,
+    void _asyncSetReady( const co::ObjectVersions& frames,
+                         detail::RBStat* stat,
                          const std::vector< uint128_t >& nodes,
                          const co::NodeIDs& netNodes );
 
-    void _setReady( FrameDataPtr frame, detail::RBStat* stat,
+    /** Set the frames with the given receivers ready, batched per node. */
+    void _setReady( const co::ObjectVersions& frames, detail::RBStat* stat,
                     const std::vector< uint128_t >& nodes,
                     const co::NodeIDs& netNodes );
+    void _addReadbackStatistics( const FrameData& frame,
+                                 detail::RBStat* stat );
 
     /** Getsthe channel's current input queue. */
     co::QueueSlave* _getQueue( const uint128_t& queueID );
 
-    Frames _getFrames( const co::ObjectVersions& frameIDs,
-                       const bool isOutput );
+    /** @return the frames, valid until the next call for the same type. */
+    const Frames& _getFrames( const co::ObjectVersions& frameIDs,
+                              const bool isOutput );
+
+    /** Copy the resource name of the statistics. Thread safe. */
+    void _copyResourceName( char* name, const size_t size );
 
     void _deleteTransferContext();
 
+    /** Defer the assembly of not yet ready input frames, if enabled. */
+    bool _startAsyncAssembly( const Frames& frames );
+
+    /** Upload the input frames of a deferred assembly as they arrive. */
+    void _uploadAssembly( detail::AsyncAssembly& assembly );
+
+    /** Accumulate the upscaled input frames of this frame, if enabled. */
+    void _resolveUpsampling();
+    bool _hasUpsamplingHistory() const;
+
+    /** Queue a pipe thread task behind a deferred assembly. */
+    bool _deferTask( co::ICommand& command,
+                     bool (Channel::*handler)( co::ICommand& ));
+
     /* The command handler functions. */
     bool _cmdConfigInit( co::ICommand& command );
     bool _cmdConfigExit( co::ICommand& command );
@@ -656,6 +780,7 @@ private:
     bool _cmdFrameFinish( co::ICommand& command );
     bool _cmdFrameClear( co::ICommand& command );
     bool _cmdFrameDraw( co::ICommand& command );
+    bool _cmdFrameDrawMultiView( co::ICommand& command );
     bool _cmdFrameDrawFinish( co::ICommand& command );
     bool _cmdFrameAssemble( co::ICommand& command );
     bool _cmdFrameReadback( co::ICommand& command );
@@ -668,6 +793,9 @@ private:
     bool _cmdStopFrame( co::ICommand& command );
     bool _cmdFrameTiles( co::ICommand& command );
     bool _cmdDeleteTransferContext( co::ICommand& command );
+    bool _cmdWaitAssembly( co::ICommand& command );
+    bool _cmdFinishAssembly( co::ICommand& command );
+    bool _cmdReproject( co::ICommand& command );
 
     LB_TS_VAR( _pipeThread );
 };
@@ -20,47 +20,72 @@
 
 #include "channel.h"
 #include "config.h"
+#include "detail/timerQueries.h"
 #include "global.h"
 #include "pipe.h"
 #include "window.h"
 
-#include <cstdio>
+namespace eq
+{
+namespace
+{
+/** @return true for task types which run on the pipe thread. */
+bool _isPipeTask( const Statistic::Type type )
+{
+    return type != Statistic::CHANNEL_ASYNC_READBACK &&
+           type != Statistic::CHANNEL_FRAME_TRANSMIT &&
+           type != Statistic::CHANNEL_FRAME_COMPRESS &&
+           type != Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN;
+}
 
-#ifdef _MSC_VER
-#  define snprintf _snprintf
-#endif
+/** @return true for task types measured on the GPU with timer queries. */
+bool _isGPUTask( const Statistic::Type type )
+{
+    switch( type )
+    {
+    case Statistic::CHANNEL_CLEAR:
+    case Statistic::CHANNEL_DRAW:
+    case Statistic::CHANNEL_ASSEMBLE:
+    case Statistic::CHANNEL_READBACK:
+    case Statistic::CHANNEL_VIEW_FINISH:
+    case Statistic::CHANNEL_TILE:
+        return true;
+    default:
+        return false;
+    }
+}
 
-namespace eq
+int32_t _getHint( const Channel* channel, const int32_t hint )
 {
+    if( hint == AUTO )
+        return channel->getIAttribute( Channel::IATTR_HINT_STATISTICS );
+    return hint;
+}
+}
 
 ChannelStatistics::ChannelStatistics( const Statistic::Type type,
                                       Channel* channel, const uint32_t frame,
                                       const int32_t hint )
-        : StatisticSampler< Channel >( type, channel, frame )
-        , _hint( hint )
+        : StatisticSampler< Channel >( type, channel, frame,
+                                       _getHint( channel, hint ))
+        , _query( 0 )
 {
-    if( _hint == AUTO )
-        _hint = channel->getIAttribute( Channel::IATTR_HINT_STATISTICS );
-    if( _hint == OFF )
+    if( !isEnabled( ))
         return;
 
     event.data.statistic.task = channel->getTaskID();
 
-    const std::string& name = channel->getName();
-    if( name.empty( ))
-        snprintf( event.data.statistic.resourceName, 32, "Channel %s",
-                  channel->getID().getShortString().c_str( ));
-    else
-        snprintf( event.data.statistic.resourceName, 32, "%s", name.c_str( ));
-    event.data.statistic.resourceName[31] = 0;
-
-    if( _hint == NICEST &&
-        type != Statistic::CHANNEL_ASYNC_READBACK &&
-        type != Statistic::CHANNEL_FRAME_TRANSMIT &&
-        type != Statistic::CHANNEL_FRAME_COMPRESS &&
-        type != Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN )
+    channel->_copyResourceName( event.data.statistic.resourceName, 32 );
+
+    // Nicest statistics use timer queries if available, which deliver the
+    // GPU times later without synchronizing the GPU
+    if( _hint == NICEST && _isPipeTask( type ))
     {
-        channel->getWindow()->finish();
+        detail::TimerQueries* queries = channel->_getTimerQueries();
+        if( !queries )
+            channel->getWindow()->finish();
+        else if( _isGPUTask( type ))
+            _query = queries->begin();
     }
 
     event.data.statistic.startTime  = channel->getConfig()->getTime();
@@ -69,15 +94,12 @@ ChannelStatistics::ChannelStatistics( const Statistic::Type type,
 
 ChannelStatistics::~ChannelStatistics()
 {
-    if( _hint == OFF )
+    if( !isEnabled( ))
         return;
 
     const Statistic::Type type = event.data.statistic.type;
-    if( _hint == NICEST &&
-        type != Statistic::CHANNEL_ASYNC_READBACK &&
-        type != Statistic::CHANNEL_FRAME_TRANSMIT &&
-        type != Statistic::CHANNEL_FRAME_COMPRESS &&
-        type != Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN )
+    if( _hint == NICEST && _isPipeTask( type ) && !_query &&
+        !_owner->_getTimerQueries( ))
     {
         _owner->getWindow()->finish();
     }
@@ -87,7 +109,12 @@ ChannelStatistics::~ChannelStatistics()
     if( event.data.statistic.endTime <= event.data.statistic.startTime )
         event.data.statistic.endTime = event.data.statistic.startTime + 1;
 
-    _owner->addStatistic( event.data );
+    if( _query )
+        _owner->_addTimerStatistic( event.data, _query );
+    else if( isLocal( ))
+        _owner->getConfig()->addLocalStatistic( event.data.statistic );
+    else
+        _owner->addStatistic( event.data );
 }
 
 }
@@ -44,7 +44,8 @@ namespace eq
         virtual EQ_API ~ChannelStatistics();
 
     private:
-        int32_t _hint;
+        const void* _query; //!< GPU timestamp query of the start time
+
     };
 }
 
@@ -64,6 +64,7 @@ public:
         : queue( co::Global::getCommandQueueLimit( ))
         , modelUnit( EQ_UNDEFINED_UNIT )
         , running( false )
+        , resident( false )
     {}
 
     CommandQueue queue; //!< The command->node command queue.
@@ -72,6 +73,7 @@ public:
     std::string gpuFilter;
     float modelUnit;
     bool running;
+    bool resident; //!< Keep serving configs after the server exits
 };
 }
 
@@ -181,6 +183,8 @@ bool Client::initLocal( const int argc, char** argv )
                 LBASSERT( !clientOpts.empty( ));
             }
         }
+        else if( std::string( "--eq-resident" ) == argv[i] )
+            _impl->resident = true;
         else if( _isParameterOption( "--eq-layout", argc, argv, i ))
             _impl->activeLayouts.push_back( argv[++i] );
         else if( _isParameterOption( "--eq-gpufilter" , argc, argv, i ))
@@ -207,7 +211,14 @@ bool Client::initLocal( const int argc, char** argv )
             return false;
         }
 
-        clientLoop();
+        do
+        {
+            clientLoop();
+            if( _impl->resident )
+                LBINFO << "Resident client waiting for the next config"
+                       << std::endl;
+        }
+        while( _impl->resident );
         exitClient();
     }
 
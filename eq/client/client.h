@@ -68,14 +68,20 @@ public:
     /**
      * Initialize a local, listening node.
      *
-     * The <code>--eq-client</code>, <code>--eq-layout</code> and
-     * <code>--eq-modelunit</code> command line options are recognized by this
-     * method.
+     * The <code>--eq-client</code>, <code>--eq-resident</code>,
+     * <code>--eq-layout</code> and <code>--eq-modelunit</code> command line
+     * options are recognized by this method.
      *
      * <code>--eq-client</code> is used for remote nodes which have been
      * auto-launched by another node, e.g., remote render clients. This method
      * does not return when this command line option is present.
      *
+     * <code>--eq-resident</code> together with <code>--eq-client</code> keeps a
+     * pre-started render client running after its config exits. The process
+     * keeps listening and serves the next config which connects to it, which
+     * avoids the process start-up, plugin loading and any data the application
+     * caches in the process for each session.
+     *
      * <code>--eq-layout</code> can apply multiple times. Each instance has to
      * be followed by the name of a layout. The given layouts will be activated
      * on all canvases using them during Config::init().
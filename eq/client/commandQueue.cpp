@@ -20,14 +20,32 @@
 
 #include "messagePump.h"
 
+#include <eq/fabric/commands.h>
 #include <co/iCommand.h>
 #include <lunchbox/clock.h>
+#include <lunchbox/scopedMutex.h>
 
 namespace eq
 {
 namespace
 {
 static lunchbox::Clock _clock;
+
+/** @return true for local commands which may overtake the render tasks. */
+bool _isUrgent( const co::ICommand& command )
+{
+    if( !command.isValid( ))
+        return false;
+
+    switch( command.getCommand( ))
+    {
+    case fabric::CMD_CHANNEL_FINISH_ASSEMBLY:
+    case fabric::CMD_CHANNEL_REPROJECT:
+        return true;
+    default:
+        return false;
+    }
+}
 }
 
 CommandQueue::CommandQueue( const size_t maxSize )
@@ -45,13 +63,30 @@ CommandQueue::~CommandQueue()
 
 void CommandQueue::push( const co::ICommand& command )
 {
-    co::CommandQueue::push( command );
+    if( _isUrgent( command ))
+    {
+        // the command in the base queue marks the position of the next
+        // urgent command, see _select()
+        {
+            lunchbox::ScopedWrite mutex( _lock );
+            _urgent.push_back( command );
+        }
+        co::CommandQueue::pushFront( command );
+    }
+    else
+        co::CommandQueue::push( command );
+
     if( _messagePump )
         _messagePump->postWakeup();
 }
 
 void CommandQueue::pushFront( const co::ICommand& command )
 {
+    if( _isUrgent( command ))
+    {
+        lunchbox::ScopedWrite mutex( _lock );
+        _urgent.push_front( command );
+    }
     co::CommandQueue::pushFront( command );
     if( _messagePump )
         _messagePump->postWakeup();
@@ -70,7 +105,7 @@ co::ICommand CommandQueue::pop( const uint32_t timeout )
         {
             if( start > -1 )
                 _waitTime += ( _clock.getTime64() - start );
-            return co::CommandQueue::pop( timeout );
+            return _select( co::CommandQueue::pop( timeout ));
         }
 
         if( _messagePump )
@@ -85,7 +120,7 @@ co::ICommand CommandQueue::pop( const uint32_t timeout )
             // blocking
             const co::ICommand& command = co::CommandQueue::pop( timeout );
             _waitTime += ( _clock.getTime64() - start );
-            return command;
+            return _select( command );
         }
     }
 }
@@ -103,7 +138,10 @@ co::ICommands CommandQueue::popAll( const uint32_t timeout )
         {
             if( start > -1 )
                 _waitTime += ( _clock.getTime64() - start );
-            return co::CommandQueue::popAll( 0 );
+            co::ICommands commands = co::CommandQueue::popAll( 0 );
+            for( size_t i = 0; i < commands.size(); ++i )
+                commands[i] = _select( commands[i] );
+            return commands;
         }
 
         if( _messagePump )
@@ -116,8 +154,10 @@ co::ICommands CommandQueue::popAll( const uint32_t timeout )
         {
             start = _clock.getTime64();
             // blocking
-            const co::ICommands& commands = co::CommandQueue::popAll( timeout );
+            co::ICommands commands = co::CommandQueue::popAll( timeout );
             _waitTime += ( _clock.getTime64() - start );
+            for( size_t i = 0; i < commands.size(); ++i )
+                commands[i] = _select( commands[i] );
             return commands;
         }
     }
@@ -128,7 +168,19 @@ co::ICommand CommandQueue::tryPop()
     if( _messagePump )
         _messagePump->dispatchAll(); // non-blocking
 
-    return co::CommandQueue::tryPop();
+    return _select( co::CommandQueue::tryPop( ));
+}
+
+co::ICommand CommandQueue::_select( const co::ICommand& command )
+{
+    if( !_isUrgent( command ))
+        return command;
+
+    lunchbox::ScopedWrite mutex( _lock );
+    LBASSERT( !_urgent.empty( ));
+    const co::ICommand urgent = _urgent.front();
+    _urgent.pop_front();
+    return urgent;
 }
 
 void CommandQueue::pump()
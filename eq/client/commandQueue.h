@@ -22,6 +22,9 @@
 #include <eq/client/types.h>
 #include <eq/client/windowSystem.h> // enum
 #include <co/commandQueue.h>    // base class
+#include <lunchbox/lock.h>     // member
+
+#include <deque>
 
 namespace eq
 {
@@ -29,6 +32,10 @@ namespace eq
      * @internal
      * Augments an co::CommandQueue to pump system-specific events where
      * required by the underlying window/operating system.
+     *
+     * Urgent commands, which do not depend on the order of the render tasks,
+     * are kept in a separate lane and are dispatched before all other commands
+     * in the order they were pushed.
      */
     class CommandQueue : public co::CommandQueue
     {
@@ -64,8 +71,14 @@ namespace eq
     private:
         MessagePump* _messagePump;
 
+        lunchbox::Lock _lock; //!< protects _urgent
+        std::deque< co::ICommand > _urgent; //!< the lane of urgent commands
+
         /** The time spent waiting in pop(). */
         int64_t _waitTime;
+
+        /** @return the urgent command dispatched for the given one. */
+        co::ICommand _select( const co::ICommand& command );
     };
 }
 
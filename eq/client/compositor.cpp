@@ -24,6 +24,9 @@
 #include "client.h"
 #include "compositor.h"
 #include "config.h"
+#include "detail/compositorKernels.h"
+#include "detail/spans.h"
+#include "detail/textureUploader.h"
 #include "exception.h"
 #include "frameData.h"
 #include "gl.h"
@@ -31,6 +34,7 @@
 #include "log.h"
 #include "pixelData.h"
 #include "server.h"
+#include "systemWindow.h"
 #include "window.h"
 #include "windowSystem.h"
 
@@ -48,6 +52,8 @@
 #  include <pcapi.h>
 #endif
 
+#include <algorithm>
+
 using lunchbox::Monitor;
 
 namespace eq
@@ -62,10 +68,247 @@ static const char seed = 42;
 static const char* shaderDBKey = &seed;
 static const char* colorDBKey  = shaderDBKey + 1;
 static const char* depthDBKey  = shaderDBKey + 2;
+static const char* shaderArrayDBKey    = shaderDBKey + 3;
+static const char* shaderArrayBlendKey = shaderDBKey + 4;
+static const char* colorArrayKey = shaderDBKey + 5;
+static const char* depthArrayKey = shaderDBKey + 6;
+static const char* quadArrayKey  = shaderDBKey + 7;
+static const char* shaderStencilKey = shaderDBKey + 8;
 
 // Image used for CPU-based assembly
 static lunchbox::PerThread< Image > _resultImage;
 
+// Image used for CPU-based sub pixel assembly
+static lunchbox::PerThread< Image > _subPixelImage;
+
+// Target size of one CPU compositing tile, chosen to fit into the L2 cache
+static const size_t _tileSize = 256 * 1024;
+
+// Background runs shorter than this are depth-tested, not skipped
+static const size_t _minBackgroundRun = 16;
+
+/**
+ * Depth-test one row, skipping runs of background pixels in the source.
+ *
+ * Source pixels at the far plane never pass the depth test, so long
+ * background runs of sparse images are skipped without reading their color or
+ * touching the destination.
+ */
+static void _mergeDepthSpans( const detail::PixelKernels& kernels,
+                              uint8_t* destColor, uint8_t* destDepth,
+                              const uint8_t* color, const uint8_t* depth,
+                              const size_t n )
+{
+    static const uint32_t farPlane = 0xffffffffu;
+    LBASSERT( kernels.depthSize == sizeof( uint32_t ));
+    const uint32_t* values = reinterpret_cast< const uint32_t* >( depth );
+    const size_t colorSize = kernels.colorSize;
+    const size_t depthSize = kernels.depthSize;
+
+    size_t i = 0;
+    while( i < n )
+    {
+        while( i < n && values[i] == farPlane )
+            ++i;
+        if( i == n )
+            return;
+
+        // extend the span over foreground and short background runs
+        size_t end = i;
+        while( end < n )
+        {
+            if( values[end] != farPlane )
+            {
+                ++end;
+                continue;
+            }
+            size_t run = end;
+            while( run < n && values[run] == farPlane )
+                ++run;
+            if( run == n || run - end >= _minBackgroundRun )
+                break;
+            end = run;
+        }
+
+        kernels.mergeDepth( destColor + i * colorSize,
+                            destDepth + i * depthSize,
+                            color + i * colorSize, depth + i * depthSize,
+                            end - i );
+        i = end;
+    }
+}
+
+/** @return the assembly parameters of an image, as used by assembleFrame. */
+static Compositor::ImageOp _getMergeOp( const Frame* frame,
+                                        const Image* image )
+{
+    Compositor::ImageOp op;
+    op.offset = frame->getOffset();
+    op.pixel = frame->getPixel();
+    op.zoom = frame->getZoom();
+    op.zoom.apply( frame->getFrameData()->getZoom( ));
+    op.zoomFilter = ( op.zoom == Zoom::NONE ) ? FILTER_NEAREST :
+                                                frame->getZoomFilter();
+    op.zoom.apply( image->getZoom( ));
+    return op;
+}
+
+/** @return the destination area covered by an image, see _getCoords. */
+static PixelViewport _getMergeViewport( const PixelViewport& pvp,
+                                        const Compositor::ImageOp& op )
+{
+    if( !pvp.hasArea( ))
+        return PixelViewport();
+
+    if( op.zoom != Zoom::NONE )
+    {
+        const int32_t x = op.offset.x() + pvp.x;
+        const int32_t y = op.offset.y() + pvp.y;
+        const int32_t xEnd = op.offset.x() +
+                             int32_t( pvp.getXEnd() * op.zoom.x() + .5f );
+        const int32_t yEnd = op.offset.y() +
+                             int32_t( pvp.getYEnd() * op.zoom.y() + .5f );
+        return PixelViewport( x, y, xEnd - x, yEnd - y );
+    }
+
+    // pixel images cover every pixel.w-th column and pixel.h-th row
+    const int32_t w = int32_t( op.pixel.w );
+    const int32_t h = int32_t( op.pixel.h );
+    return PixelViewport( op.offset.x() + pvp.x * w + int32_t( op.pixel.x ),
+                          op.offset.y() + pvp.y * h + int32_t( op.pixel.y ),
+                          ( pvp.w - 1 ) * w + 1, ( pvp.h - 1 ) * h + 1 );
+}
+
+/**
+ * Compute the source rows of a pixel image within the destination rows
+ * [yBegin, yEnd), given the destination row of its first row.
+ */
+static void _getMergeRows( const int32_t destY, const int32_t step,
+                           const int32_t nRows, const int32_t yBegin,
+                           const int32_t yEnd, int32_t& begin, int32_t& end )
+{
+    begin = yBegin > destY ? ( yBegin - destY + step - 1 ) / step : 0;
+    end = yEnd > destY ? std::min(( yEnd - destY + step - 1 ) / step, nRows )
+                       : 0;
+}
+
+/** Depth-test a run of pixels into every step-th destination pixel. */
+static void _mergeDepthRun( const detail::PixelKernels& kernels,
+                            uint8_t* destColor, uint8_t* destDepth,
+                            const uint8_t* color, const uint8_t* depth,
+                            const size_t begin, const size_t end,
+                            const size_t step )
+{
+    const size_t colorSize = kernels.colorSize;
+    const size_t depthSize = kernels.depthSize;
+    if( step == 1 )
+    {
+        kernels.mergeDepth( destColor + begin * colorSize,
+                            destDepth + begin * depthSize,
+                            color + begin * colorSize,
+                            depth + begin * depthSize, end - begin );
+        return;
+    }
+
+    LBASSERT( depthSize == sizeof( uint32_t ));
+    uint32_t* destD = reinterpret_cast< uint32_t* >( destDepth );
+    const uint32_t* srcD = reinterpret_cast< const uint32_t* >( depth );
+    for( size_t i = begin; i < end; ++i )
+    {
+        const size_t j = i * step;
+        if( destD[j] > srcD[i] )
+        {
+            destD[j] = srcD[i];
+            memcpy( destColor + j * colorSize, color + i * colorSize,
+                    colorSize );
+        }
+    }
+}
+
+/** @return true if the frames are assembled by the CPU sub pixel path. */
+static bool _useCPUSubPixelAssembly( const Frames& frames, Channel* channel )
+{
+    // Averaging the sub pixel steps on the CPU saves the accumulation buffer
+    // round trips if all images are in main memory anyway
+    const uint32_t steps = frames.back()->getSubPixel().size;
+    if( steps < 2 || steps > 256 )
+        return false;
+
+    for( Frames::const_iterator i = frames.begin(); i != frames.end(); ++i )
+    {
+        const Frame* frame = *i;
+        if( frame->getPixel() != Pixel::ALL ||
+            frame->getZoom() != Zoom::NONE ||
+            frame->getSubPixel().size != steps )
+        {
+            return false;
+        }
+    }
+
+    std::vector< PixelViewport > pvps( steps );
+    uint32_t colorInternalFormat = 0;
+    uint32_t colorExternalFormat = 0;
+    const uint32_t timeout = channel->getConfig()->getTimeout();
+
+    for( Frames::const_iterator i = frames.begin(); i != frames.end(); ++i )
+    {
+        const Frame* frame = *i;
+        {
+            ChannelStatistics event( Statistic::CHANNEL_FRAME_WAIT_READY,
+                                     channel );
+            frame->waitReady( timeout );
+        }
+
+        const uint32_t step = frame->getSubPixel().index;
+        const Images& images = frame->getImages();
+        for( Images::const_iterator j = images.begin(); j != images.end(); ++j)
+        {
+            const Image* image = *j;
+            if( image->getStorageType() != Frame::TYPE_MEMORY ||
+                !image->hasPixelData( Frame::BUFFER_COLOR ) ||
+                _getMergeOp( frame, image ).zoom != Zoom::NONE )
+            {
+                return false;
+            }
+
+            if( colorExternalFormat == 0 )
+            {
+                colorInternalFormat =
+                    image->getInternalFormat( Frame::BUFFER_COLOR );
+                colorExternalFormat =
+                    image->getExternalFormat( Frame::BUFFER_COLOR );
+                if( colorExternalFormat != EQ_COMPRESSOR_DATATYPE_RGBA &&
+                    colorExternalFormat != EQ_COMPRESSOR_DATATYPE_BGRA )
+                {
+                    return false;
+                }
+            }
+            else if( colorInternalFormat !=
+                     image->getInternalFormat( Frame::BUFFER_COLOR ) ||
+                     colorExternalFormat !=
+                     image->getExternalFormat( Frame::BUFFER_COLOR ))
+            {
+                return false;
+            }
+
+            if( image->hasPixelData( Frame::BUFFER_DEPTH ) &&
+                image->getExternalFormat( Frame::BUFFER_DEPTH ) !=
+                EQ_COMPRESSOR_DATATYPE_DEPTH_UNSIGNED_INT )
+            {
+                return false;
+            }
+            pvps[ step ].merge( image->getPixelViewport() +
+                                frame->getOffset( ));
+        }
+    }
+
+    // all steps have to cover the same area to be averaged per pixel
+    for( size_t i = 0; i < steps; ++i )
+        if( !pvps[i].hasArea() || pvps[i] != pvps.front( ))
+            return false;
+    return true;
+}
+
 static bool _useCPUAssembly( const Frames& frames, Channel* channel,
                              const bool blendAlpha = false )
 {
@@ -73,26 +316,32 @@ static bool _useCPUAssembly( const Frames& frames, Channel* channel,
     if( frames.size() < 2 )
         return false;
 
-    // Test that at least two input frames have color and depth buffers or that
-    // alpha-blended assembly is used with multiple RGBA buffers. We assume then
-    // that we will have at least one image per frame so most likely it's worth
-    // to wait for the images and to do a CPU-based assembly.
-    // Also test early for unsupport decomposition modes
+    // Test that at least two input frames have color and depth buffers, that
+    // alpha-blended assembly is used with multiple RGBA buffers, or that the
+    // frames are interleaved by a pixel decomposition. We assume then that we
+    // will have at least one image per frame so most likely it's worth to wait
+    // for the images and to do a CPU-based assembly.
+    // Also test early for unsupported decomposition modes
     const uint32_t desiredBuffers = blendAlpha ? Frame::BUFFER_COLOR :
                                     Frame::BUFFER_COLOR | Frame::BUFFER_DEPTH;
+    const SubPixel& subpixel = frames.front()->getSubPixel();
     size_t nFrames = 0;
     for( Frames::const_iterator i = frames.begin(); i != frames.end(); ++i )
     {
         const Frame* frame = *i;
-        if( frame->getPixel() != Pixel::ALL ||
-            frame->getSubPixel() != SubPixel::ALL ||
-            frame->getZoom() != Zoom::NONE ) // Not supported by CPU compositor
-        {
+        if( frame->getSubPixel() != subpixel ) // steps are averaged later
             return false;
-        }
 
-        if( frame->getBuffers() == desiredBuffers )
+        const bool isPixel = frame->getPixel() != Pixel::ALL;
+        const bool isZoom = frame->getZoom() != Zoom::NONE;
+        if(( isPixel && isZoom ) || ( blendAlpha && ( isPixel || isZoom )))
+            return false; // Not supported by CPU compositor
+
+        if( frame->getBuffers() == desiredBuffers ||
+            frame->getPixel() != Pixel::ALL )
+        {
             ++nFrames;
+        }
     }
     if( nFrames < 2 )
         return false;
@@ -117,14 +366,17 @@ static bool _useCPUAssembly( const Frames& frames, Channel* channel,
             frame->waitReady( timeout );
         }
 
-        if( frame->getFrameData()->getZoom() != Zoom::NONE )
-            return false;
-
         const Images& images = frame->getImages();
         for( Images::const_iterator j = images.begin();
              j != images.end(); ++j )
         {
             const Image* image = *j;
+            const Compositor::ImageOp& op = _getMergeOp( frame, image );
+            if( op.zoom != Zoom::NONE &&
+                ( blendAlpha || op.pixel != Pixel::ALL || !op.zoom.isValid( )))
+            {
+                return false;
+            }
 
             const bool hasColor = image->hasPixelData( Frame::BUFFER_COLOR );
             const bool hasDepth = image->hasPixelData( Frame::BUFFER_DEPTH );
@@ -132,7 +384,9 @@ static bool _useCPUAssembly( const Frames& frames, Channel* channel,
             if( // Not an alpha-blending compositing
                 ( !blendAlpha || !hasColor || !image->hasAlpha( )) &&
                 // and not a depth-sorting compositing
-                ( !hasColor || !hasDepth ))
+                ( !hasColor || !hasDepth ) &&
+                // and not a pixel interleaving
+                ( !hasColor || op.pixel == Pixel::ALL ))
             {
                 return false;
             }
@@ -144,23 +398,8 @@ static bool _useCPUAssembly( const Frames& frames, Channel* channel,
                 colorExternalFormat =
                     image->getExternalFormat( Frame::BUFFER_COLOR );
 
-                switch( colorExternalFormat )
-                {
-                    case EQ_COMPRESSOR_DATATYPE_RGB10_A2:
-                    case EQ_COMPRESSOR_DATATYPE_BGR10_A2:
-                        if( !hasDepth )
-                            // blending of RGB10A2 not implemented
-                            return false;
-                        break;
-
-                    case EQ_COMPRESSOR_DATATYPE_RGBA:
-                    case EQ_COMPRESSOR_DATATYPE_BGRA:
-                        break;
-
-                    default:
-                        return false;
-                }
-
+                if( !detail::getPixelKernels( colorExternalFormat, 0 ))
+                    return false;
             }
             else if( colorInternalFormat !=
                      image->getInternalFormat( Frame::BUFFER_COLOR ) ||
@@ -197,6 +436,384 @@ static bool _useCPUAssembly( const Frames& frames, Channel* channel,
     }
     return (nImages > 1);
 }
+
+// Minimum number of input images for single-pass texture array assembly
+static const size_t _minArrayImages = 8;
+// Maximum number of input images per pass, limited by the uniform array size
+#define EQ_ARRAY_MAX_IMAGES 32
+
+static bool _useBlendTree( const Frames& frames )
+{
+    // Merging pairs out of order only pays off if a frame may arrive late
+    if( frames.size() < 3 )
+        return false;
+
+    bool allReady = true;
+    for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
+    {
+        const Frame* frame = *i;
+        if( frame->getPixel() != Pixel::ALL ||
+            frame->getSubPixel() != SubPixel::ALL ||
+            frame->getZoom() != Zoom::NONE ||
+            frame->getBuffers() != Frame::BUFFER_COLOR )
+        {
+            return false;
+        }
+        allReady = allReady && frame->isReady();
+    }
+    return !allReady;
+}
+
+/** @return true if images are assembled with the core profile GLSL path. */
+static bool _useGLSL( const Channel* channel )
+{
+    return GLEW_VERSION_3_3;
+}
+
+/** @return the orthographic projection over the channel's pixel viewport. */
+static Matrix4f _getAssemblyProjection( const Channel* channel )
+{
+    const PixelViewport& pvp = channel->getPixelViewport();
+    eq::Frustumf frustum;
+    frustum.left() = pvp.x;
+    frustum.right() = pvp.getXEnd();
+    frustum.bottom() = pvp.y;
+    frustum.top() = pvp.getYEnd();
+    frustum.far_plane() = 1.0f;
+    frustum.near_plane() = -1.0f;
+    return frustum.compute_ortho_matrix();
+}
+
+/**
+ * @return the vertex array with the corners of a unit quad in attribute 0,
+ *         shared by all assembly programs drawing quads.
+ */
+static GLuint _obtainQuadArray( Channel* channel )
+{
+    util::ObjectManager& om = channel->getObjectManager();
+    GLuint vertexArray = om.getVertexArray( quadArrayKey );
+    if( vertexArray != util::ObjectManager::INVALID )
+        return vertexArray;
+
+    static const GLfloat corners[] = { 0.f, 0.f,  1.f, 0.f,
+                                       0.f, 1.f,  1.f, 1.f };
+    vertexArray = om.newVertexArray( quadArrayKey );
+    const GLuint buffer = om.newBuffer( quadArrayKey );
+
+    EQ_GL_CALL( glBindVertexArray( vertexArray ));
+    EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, buffer ));
+    EQ_GL_CALL( glBufferData( GL_ARRAY_BUFFER, sizeof( corners ), corners,
+                              GL_STATIC_DRAW ));
+    EQ_GL_CALL( glVertexAttribPointer( 0, 2, GL_FLOAT, GL_FALSE, 0, 0 ));
+    EQ_GL_CALL( glEnableVertexAttribArray( 0 ));
+    EQ_GL_CALL( glBindVertexArray( 0 ));
+    EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, 0 ));
+    return vertexArray;
+}
+
+/** @return true if the image textures are owned by another GPU's context. */
+static bool _isPeerImage( const Image* image, const Channel* channel )
+{
+    const SystemWindow* source = image->getSourceWindow();
+    return source && source != channel->getWindow()->getSystemWindow();
+}
+
+/**
+ * @return the texture of an image of another GPU copied into the channel's
+ *         context, or 0 if the copy failed.
+ */
+static const util::Texture* _copyPeerImage( const Image* image,
+                                            const Frame::Buffer which,
+                                            Channel* channel )
+{
+    const util::Texture& from = image->getTexture( which );
+    const PixelViewport& pvp = image->getPixelViewport();
+    util::Texture* texture = channel->getObjectManager().obtainEqTexture(
+        which == Frame::BUFFER_COLOR ? colorDBKey : depthDBKey,
+        GL_TEXTURE_RECTANGLE_ARB );
+    texture->setStreaming( true ); // image sizes vary from frame to frame
+    texture->init( from.getInternalFormat(), pvp.w, pvp.h );
+
+    const SystemWindow* window = channel->getWindow()->getSystemWindow();
+    if( window->copyImage( *image->getSourceWindow(), from, *texture,
+                           Vector2i( pvp.w, pvp.h )))
+    {
+        return texture;
+    }
+
+    LBWARN << "Copy of " << pvp << " from another GPU failed, skipping image"
+           << std::endl;
+    return 0;
+}
+
+static bool _useArrayAssembly( const Frames& frames, Channel* channel,
+                               const bool blendAlpha = false )
+{
+    if( !_useGLSL( channel ))
+        return false;
+
+    // Test early if enough frames could provide images and if all frames use
+    // a supported decomposition mode
+    const uint32_t desiredBuffers = blendAlpha ? Frame::BUFFER_COLOR :
+                                    Frame::BUFFER_COLOR | Frame::BUFFER_DEPTH;
+    for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
+    {
+        const Frame* frame = *i;
+        if( frame->getPixel() != Pixel::ALL ||
+            frame->getSubPixel() != SubPixel::ALL ||
+            frame->getZoom() != Zoom::NONE ||
+            frame->getBuffers() != desiredBuffers )
+        {
+            return false;
+        }
+    }
+    if( frames.size() < _minArrayImages )
+        return false;
+
+    // Wait for all images and check that they are memory images of the same
+    // supported format
+    const uint32_t timeout = channel->getConfig()->getTimeout();
+    size_t nImages = 0;
+    uint32_t colorFormat = 0;
+    uint32_t depthFormat = 0;
+
+    for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
+    {
+        const Frame* frame = *i;
+        {
+            ChannelStatistics event( Statistic::CHANNEL_FRAME_WAIT_READY,
+                                     channel );
+            frame->waitReady( timeout );
+        }
+
+        if( frame->getFrameData()->getZoom() != Zoom::NONE )
+            return false;
+
+        const Images& images = frame->getImages();
+        for( ImagesCIter j = images.begin(); j != images.end(); ++j )
+        {
+            const Image* image = *j;
+            if( image->getStorageType() != Frame::TYPE_MEMORY ||
+                !image->hasPixelData( Frame::BUFFER_COLOR ) ||
+                image->getZoom() != Zoom::NONE )
+            {
+                return false;
+            }
+            if( blendAlpha ? !image->hasAlpha() :
+                             !image->hasPixelData( Frame::BUFFER_DEPTH ))
+            {
+                return false;
+            }
+
+            const uint32_t color =
+                image->getExternalFormat( Frame::BUFFER_COLOR );
+            const uint32_t depth = blendAlpha ? 0 :
+                image->getExternalFormat( Frame::BUFFER_DEPTH );
+            if( nImages == 0 )
+            {
+                colorFormat = color;
+                depthFormat = depth;
+                if( !detail::getUploadFormat( colorFormat ) ||
+                    ( !blendAlpha && !detail::getUploadFormat( depthFormat )))
+                {
+                    return false;
+                }
+            }
+            else if( color != colorFormat || depth != depthFormat )
+                return false;
+            ++nImages;
+        }
+    }
+
+    if( nImages < _minArrayImages )
+        return false;
+
+    // Depth-based passes are composed by the depth test, blending needs all
+    // images in one pass
+    GLint maxLayers = 0;
+    EQ_GL_CALL( glGetIntegerv( GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers ));
+    return !blendAlpha ||
+           ( nImages <= EQ_ARRAY_MAX_IMAGES && nImages <= size_t( maxLayers ));
+}
+
+/** An input image of the array assembly, with the offset of its frame. */
+struct ArrayImage
+{
+    const Image* image;
+    Vector2i offset;
+};
+typedef std::vector< ArrayImage > ArrayImages;
+
+static void _uploadArrayTexture( Channel* channel, const GLuint texture,
+                                 const Frame::Buffer buffer,
+                                 const ArrayImage* images,
+                                 const PixelViewport& destPVP,
+                                 const GLsizei nLayers )
+{
+    const detail::UploadFormat* format =
+        detail::getUploadFormat( images->image->getExternalFormat( buffer ));
+    LBASSERT( format );
+
+    EQ_GL_CALL( glBindTexture( GL_TEXTURE_2D_ARRAY, texture ));
+
+    GLint width = 0, height = 0, depth = 0, internalFormat = 0;
+    glGetTexLevelParameteriv( GL_TEXTURE_2D_ARRAY, 0, GL_TEXTURE_WIDTH,
+                              &width );
+    glGetTexLevelParameteriv( GL_TEXTURE_2D_ARRAY, 0, GL_TEXTURE_HEIGHT,
+                              &height );
+    glGetTexLevelParameteriv( GL_TEXTURE_2D_ARRAY, 0, GL_TEXTURE_DEPTH,
+                              &depth );
+    glGetTexLevelParameteriv( GL_TEXTURE_2D_ARRAY, 0,
+                              GL_TEXTURE_INTERNAL_FORMAT, &internalFormat );
+
+    if( width < destPVP.w || height < destPVP.h || depth < nLayers ||
+        internalFormat != format->internalFormat )
+    {
+        EQ_GL_CALL( glTexParameteri( GL_TEXTURE_2D_ARRAY,
+                                     GL_TEXTURE_MIN_FILTER, GL_NEAREST ));
+        EQ_GL_CALL( glTexParameteri( GL_TEXTURE_2D_ARRAY,
+                                     GL_TEXTURE_MAG_FILTER, GL_NEAREST ));
+        EQ_GL_CALL( glTexImage3D( GL_TEXTURE_2D_ARRAY, 0,
+                                  format->internalFormat,
+                                  std::max( width, destPVP.w ),
+                                  std::max( height, destPVP.h ),
+                                  std::max( depth, nLayers ), 0,
+                                  format->format, format->type, 0 ));
+    }
+
+    for( GLint layer = 0; layer < nLayers; ++layer )
+    {
+        const Image* image = images[ layer ].image;
+        const PixelViewport& pvp = image->getPixelViewport();
+        const GLint x = images[ layer ].offset.x() + pvp.x - destPVP.x;
+        const GLint y = images[ layer ].offset.y() + pvp.y - destPVP.y;
+
+        // copy on the GPU if uploaded during the async assembly
+        const util::Texture* uploaded =
+            channel->getUploadedTexture( image, buffer );
+        if( uploaded && GLEW_ARB_copy_image )
+        {
+            EQ_GL_CALL( glCopyImageSubData( uploaded->getName(),
+                                            uploaded->getTarget(), 0, 0,
+                                            0, 0, texture,
+                                            GL_TEXTURE_2D_ARRAY, 0, x, y,
+                                            layer, pvp.w, pvp.h, 1 ));
+            continue;
+        }
+
+        EQ_GL_CALL( glTexSubImage3D( GL_TEXTURE_2D_ARRAY, 0, x, y,
+                                     layer, pvp.w, pvp.h, 1,
+                                     format->format, format->type,
+                                     image->getPixelPointer( buffer )));
+    }
+}
+
+/** A run of adjacent frames, blended into one buffer by the blend tree. */
+struct BlendSegment
+{
+    BlendSegment() : begin( 0 ), end( 0 ) {}
+
+    size_t begin; //!< index of the first frame
+    size_t end;   //!< index after the last frame
+    PixelViewport pvp;
+    std::vector< uint8_t > pixels;
+};
+
+static uint8_t* _getSegmentPtr( BlendSegment& segment, const int32_t x,
+                                const int32_t y, const size_t pixelSize )
+{
+    const size_t index = size_t( y - segment.pvp.y ) * segment.pvp.w +
+                         size_t( x - segment.pvp.x );
+    return &segment.pixels[ index * pixelSize ];
+}
+
+/** Grow the segment to pvp, new pixels are transparent. */
+static void _resizeSegment( BlendSegment& segment, const PixelViewport& pvp,
+                            const detail::PixelKernels& kernels )
+{
+    if( segment.pvp == pvp )
+        return;
+
+    const size_t pixelSize = kernels.colorSize;
+    BlendSegment grown;
+    grown.pvp = pvp;
+    grown.pixels.resize( size_t( pvp.w ) * pvp.h * pixelSize );
+    for( size_t i = 0; i < grown.pixels.size(); i += pixelSize )
+        memcpy( &grown.pixels[i], kernels.transparent, pixelSize );
+
+    const PixelViewport& old = segment.pvp;
+    if( old.hasArea( ))
+    {
+        const size_t rowLength = old.w * pixelSize;
+        for( int32_t y = 0; y < old.h; ++y )
+            memcpy( _getSegmentPtr( grown, old.x, old.y + y, pixelSize ),
+                    _getSegmentPtr( segment, old.x, old.y + y, pixelSize ),
+                    rowLength );
+    }
+    segment.pvp = pvp;
+    segment.pixels.swap( grown.pixels );
+}
+
+/** Initialize the segment from the disjoint images of one frame. */
+static void _fillSegment( BlendSegment& segment, const Frame* frame,
+                          const detail::PixelKernels& kernels )
+{
+    const Images& images = frame->getImages();
+    PixelViewport pvp;
+    for( ImagesCIter i = images.begin(); i != images.end(); ++i )
+        pvp.merge( (*i)->getPixelViewport() + frame->getOffset( ));
+    if( !pvp.hasArea( ))
+        return;
+
+    _resizeSegment( segment, pvp, kernels );
+
+    const size_t pixelSize = kernels.colorSize;
+    for( ImagesCIter i = images.begin(); i != images.end(); ++i )
+    {
+        const Image* image = *i;
+        const PixelViewport imagePVP = image->getPixelViewport() +
+                                       frame->getOffset();
+        const uint8_t* color = image->getPixelPointer( Frame::BUFFER_COLOR );
+        const size_t rowLength = imagePVP.w * pixelSize;
+
+        for( int32_t y = 0; y < imagePVP.h; ++y )
+            memcpy( _getSegmentPtr( segment, imagePVP.x, imagePVP.y + y,
+                                    pixelSize ),
+                    color + y * rowLength, rowLength );
+    }
+}
+
+/** Blend the later segment over the earlier one, which receives the result. */
+static void _mergeSegments( BlendSegment& earlier, BlendSegment& later,
+                            const detail::PixelKernels* kernels )
+{
+    LBASSERT( earlier.end == later.begin );
+    earlier.end = later.end;
+
+    if( !later.pvp.hasArea( ))
+        return;
+    if( !earlier.pvp.hasArea( ))
+    {
+        earlier.pvp = later.pvp;
+        earlier.pixels.swap( later.pixels );
+        return;
+    }
+
+    LBASSERT( kernels );
+    PixelViewport pvp = earlier.pvp;
+    pvp.merge( later.pvp );
+    _resizeSegment( earlier, pvp, *kernels );
+
+    const size_t pixelSize = kernels->colorSize;
+    const PixelViewport& src = later.pvp;
+#pragma omp parallel for
+    for( int32_t y = 0; y < src.h; ++y )
+        kernels->blend( _getSegmentPtr( earlier, src.x, src.y + y, pixelSize ),
+                        _getSegmentPtr( later, src.x, src.y + y, pixelSize ),
+                        src.w );
+
+    std::vector< uint8_t >().swap( later.pixels );
+}
 }
 
 uint32_t Compositor::assembleFrames( const Frames& frames,
@@ -205,6 +822,9 @@ uint32_t Compositor::assembleFrames( const Frames& frames,
     if( frames.empty( ))
         return 0;
 
+    if( _useArrayAssembly( frames, channel ))
+        return assembleFramesArray( frames, channel );
+
     if( _useCPUAssembly( frames, channel ))
         return assembleFramesCPU( frames, channel );
 
@@ -216,23 +836,84 @@ util::Accum* Compositor::_obtainAccum( Channel* channel )
 {
     const PixelViewport& pvp = channel->getPixelViewport();
 
-    LBASSERT( pvp.isValid( ));
+    LBASSERT( pvp.isValid( ));
+
+    util::ObjectManager& objects = channel->getObjectManager();
+    util::Accum* accum = objects.getEqAccum( channel );
+    if( !accum )
+    {
+        accum = objects.newEqAccum( channel );
+        if( !accum->init( pvp, channel->getWindow()->getColorFormat( )))
+        {
+            LBERROR << "Accumulation initialization failed." << std::endl;
+        }
+    }
+    else
+        accum->resize( pvp.w, pvp.h );
+
+    accum->clear();
+    return accum;
+}
+
+namespace
+{
+/** @return the distance of the range's slab from the given z coordinate. */
+float _getSlabDistance( const Range& range, const float z )
+{
+    const float start = -1.f + 2.f * range.start;
+    const float end = -1.f + 2.f * range.end;
+    if( z < start )
+        return start - z;
+    if( z > end )
+        return z - end;
+    return 0.f;
+}
+
+typedef std::pair< float, Frame* > SortedFrame;
+bool _isFarther( const SortedFrame& a, const SortedFrame& b )
+{
+    return a.first > b.first;
+}
+}
+
+void Compositor::sortFramesByRange( Frames& frames, const Matrix4f& modelView,
+                                    const bool orthographic )
+{
+    Matrix4f modelViewInv;
+    if( !modelView.inverse( modelViewInv ))
+    {
+        LBWARN << "Singular model-view matrix, frames not sorted" << std::endl;
+        return;
+    }
 
-    util::ObjectManager& objects = channel->getObjectManager();
-    util::Accum* accum = objects.getEqAccum( channel );
-    if( !accum )
+    std::vector< SortedFrame > sorted;
+    sorted.reserve( frames.size( ));
+    if( orthographic )
     {
-        accum = objects.newEqAccum( channel );
-        if( !accum->init( pvp, channel->getWindow()->getColorFormat( )))
+        // farther slabs have larger z when looking along +z in model space
+        const float direction =
+            ( modelViewInv * Vector4f( 0.f, 0.f, -1.f, 0.f )).z();
+        for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
         {
-            LBERROR << "Accumulation initialization failed." << std::endl;
+            const Range& range = (*i)->getRange();
+            const float center = range.start + range.end;
+            sorted.push_back( std::make_pair( direction > 0.f ? center :
+                                                                -center, *i ));
         }
     }
     else
-        accum->resize( pvp.w, pvp.h );
+    {
+        const Vector4f eye = modelViewInv * Vector4f( 0.f, 0.f, 0.f, 1.f );
+        const float z = eye.z() / eye.w();
+        for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
+            sorted.push_back( std::make_pair(
+                                  _getSlabDistance( (*i)->getRange(), z ), *i ));
+    }
 
-    accum->clear();
-    return accum;
+    // back-to-front: largest distance or depth first
+    std::stable_sort( sorted.begin(), sorted.end(), _isFarther );
+    for( size_t i = 0; i < sorted.size(); ++i )
+        frames[i] = sorted[i].second;
 }
 
 uint32_t Compositor::assembleFramesSorted( const Frames& frames,
@@ -244,6 +925,9 @@ uint32_t Compositor::assembleFramesSorted( const Frames& frames,
 
     if( _isSubPixelDecomposition( frames ))
     {
+        if( !accum && _useCPUSubPixelAssembly( frames, channel ))
+            return _assembleSubPixelCPU( frames, channel, blendAlpha );
+
         const bool coreProfile = channel->getWindow()->getIAttribute(
                     WindowSettings::IATTR_HINT_CORE_PROFILE ) == ON;
         if( coreProfile )
@@ -288,7 +972,11 @@ uint32_t Compositor::assembleFramesSorted( const Frames& frames,
     }
 
     uint32_t count = 0;
-    if( _useCPUAssembly( frames, channel, blendAlpha ))
+    if( blendAlpha && _useBlendTree( frames ))
+        count |= assembleFramesBlendTree( frames, channel );
+    else if( _useArrayAssembly( frames, channel, blendAlpha ))
+        count |= assembleFramesArray( frames, channel, blendAlpha );
+    else if( _useCPUAssembly( frames, channel, blendAlpha ))
         count |= assembleFramesCPU( frames, channel, blendAlpha );
     else
     {
@@ -370,6 +1058,9 @@ uint32_t Compositor::assembleFramesUnsorted( const Frames& frames,
     LBVERB << "Unsorted GPU assembly" << std::endl;
     if( _isSubPixelDecomposition( frames ))
     {
+        if( !accum && _useCPUSubPixelAssembly( frames, channel ))
+            return _assembleSubPixelCPU( frames, channel, false );
+
         const bool coreProfile = channel->getWindow()->getIAttribute(
                     WindowSettings::IATTR_HINT_CORE_PROFILE ) == ON;
         if( coreProfile )
@@ -498,54 +1189,582 @@ Frame* Compositor::waitFrame( WaitHandle* handle )
                 throw Exception( Exception::TIMEOUT_INPUTFRAME );
             }
         }
-    }
+    }
+
+    for( FramesIter i = handle->left.begin(); i != handle->left.end(); ++i )
+    {
+        Frame* frame = *i;
+        if( !frame->isReady( ))
+            continue;
+
+        frame->removeListener( handle->monitor );
+        handle->left.erase( i );
+        return frame;
+    }
+
+    LBASSERTINFO( false, "Unreachable code" );
+    delete handle;
+    return 0;
+}
+
+uint32_t Compositor::assembleFramesArray( const Frames& frames,
+                                          Channel* channel,
+                                          const bool blendAlpha )
+{
+    if( frames.empty( ))
+        return 0;
+
+    LBVERB << "Single-pass GPU assembly" << std::endl;
+
+    ArrayImages arrayImages;
+    for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
+    {
+        const Frame* frame = *i;
+        frame->waitReady( channel->getConfig()->getTimeout( ));
+
+        const Images& images = frame->getImages();
+        for( ImagesCIter j = images.begin(); j != images.end(); ++j )
+        {
+            const ArrayImage arrayImage = { *j, frame->getOffset() };
+            arrayImages.push_back( arrayImage );
+        }
+    }
+
+    GLint maxLayers = 0;
+    EQ_GL_CALL( glGetIntegerv( GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers ));
+    const size_t passLayers = std::min( size_t( EQ_ARRAY_MAX_IMAGES ),
+                                        size_t( std::max( maxLayers, 0 )));
+    if( arrayImages.empty() || passLayers == 0 ||
+        ( blendAlpha && arrayImages.size() > passLayers ))
+    {
+        return 0;
+    }
+
+    util::ObjectManager& om = channel->getObjectManager();
+    const char* key = blendAlpha ? shaderArrayBlendKey : shaderArrayDBKey;
+    GLuint program = om.getProgram( key );
+    GLuint vertexArray = om.getVertexArray( key );
+    GLuint vertexBuffer = om.getBuffer( key );
+    if( program == util::ObjectManager::INVALID )
+    {
+        vertexBuffer = om.newBuffer( key );
+        vertexArray = om.newVertexArray( key );
+        program = om.newProgram( key );
+
+        const char* vertexShaderGLSL = {
+            "#version 330 core\n"
+            "layout(location = 0) in vec4 vert;\n"
+            "uniform mat4 proj;\n"
+            "out vec2 fragCoord;\n"
+            "void main() {\n"
+            "    fragCoord = vert.zw;\n"
+            "    gl_Position = proj * vec4(vert.xy, 0, 1);\n"
+            "}\n"
+        };
+
+        // Each layer holds one input image at its position in the
+        // destination area, viewports gives the region covered by each layer.
+        const char* fragmentShaderGLSL = { blendAlpha ?
+            "#version 330 core\n"
+            "uniform sampler2DArray color;\n"
+            "uniform ivec4 viewports[ 32 ];\n"
+            "uniform int nLayers;\n"
+            "in vec2 fragCoord;\n"
+            "out vec4 finalColor;\n"
+            "void main() {\n"
+            "    ivec2 pos = ivec2( fragCoord );\n"
+            "    vec4 result = vec4( 0, 0, 0, 1 );\n"
+            "    for( int i = 0; i < nLayers; ++i ) {\n"
+            "        ivec4 vp = viewports[i];\n"
+            "        if( any( lessThan( pos, vp.xy )) ||\n"
+            "            any( greaterThanEqual( pos, vp.zw )))\n"
+            "            continue;\n"
+            "        vec4 c = texelFetch( color, ivec3( pos, i ), 0 );\n"
+            "        result.rgb = c.rgb + c.a * result.rgb;\n"
+            "        result.a *= c.a;\n"
+            "    }\n"
+            "    finalColor = result;\n"
+            "}\n"
+                : // depth test
+            "#version 330 core\n"
+            "uniform sampler2DArray color;\n"
+            "uniform sampler2DArray depth;\n"
+            "uniform ivec4 viewports[ 32 ];\n"
+            "uniform int nLayers;\n"
+            "in vec2 fragCoord;\n"
+            "out vec4 finalColor;\n"
+            "void main() {\n"
+            "    ivec2 pos = ivec2( fragCoord );\n"
+            "    float nearest = 1.0;\n"
+            "    int front = -1;\n"
+            "    for( int i = 0; i < nLayers; ++i ) {\n"
+            "        ivec4 vp = viewports[i];\n"
+            "        if( any( lessThan( pos, vp.xy )) ||\n"
+            "            any( greaterThanEqual( pos, vp.zw )))\n"
+            "            continue;\n"
+            "        float z = texelFetch( depth, ivec3( pos, i ), 0 ).x;\n"
+            "        if( z < nearest ) {\n"
+            "            nearest = z;\n"
+            "            front = i;\n"
+            "        }\n"
+            "    }\n"
+            "    if( front < 0 )\n"
+            "        discard;\n"
+            "    finalColor = texelFetch( color, ivec3( pos, front ), 0 );\n"
+            "    gl_FragDepth = nearest;\n"
+            "}\n"
+        };
+
+        LBCHECK( util::shader::linkProgram( glewGetContext(), program,
+                                            vertexShaderGLSL,
+                                            fragmentShaderGLSL ));
+
+        EQ_GL_CALL( glUseProgram( program ));
+        GLint param = glGetUniformLocation( program, "color" );
+        EQ_GL_CALL( glUniform1i( param, 0 ));
+        if( !blendAlpha )
+        {
+            param = glGetUniformLocation( program, "depth" );
+            EQ_GL_CALL( glUniform1i( param, 1 ));
+        }
+    }
+
+    const eq::Matrix4f& proj = _getAssemblyProjection( channel );
+
+    if( !blendAlpha )
+        EQ_GL_CALL( glEnable( GL_DEPTH_TEST ));
+
+    EQ_GL_CALL( glBindVertexArray( vertexArray ));
+    EQ_GL_CALL( glUseProgram( program ));
+
+    const GLint projection = glGetUniformLocation( program, "proj" );
+    EQ_GL_CALL( glUniformMatrix4fv( projection, 1, GL_FALSE, &proj[0] ));
+    const GLint viewportsParam = glGetUniformLocation( program, "viewports" );
+    const GLint nLayersParam = glGetUniformLocation( program, "nLayers" );
+
+    // Depth-based passes of up to passLayers images each, later passes are
+    // depth-tested against the result of the earlier ones
+    for( size_t begin = 0; begin < arrayImages.size(); begin += passLayers )
+    {
+        const ArrayImage* images = &arrayImages[ begin ];
+        const GLsizei nLayers =
+            GLsizei( std::min( passLayers, arrayImages.size() - begin ));
+
+        PixelViewport destPVP;
+        for( GLsizei i = 0; i < nLayers; ++i )
+            destPVP.merge( images[i].image->getPixelViewport() +
+                           images[i].offset );
+        if( !destPVP.hasArea( ))
+            continue;
+
+        // upload all images into one layer each
+        if( !blendAlpha )
+        {
+            EQ_GL_CALL( glActiveTexture( GL_TEXTURE1 ));
+            _uploadArrayTexture( channel, om.obtainTexture( depthArrayKey ),
+                                 Frame::BUFFER_DEPTH, images, destPVP,
+                                 nLayers );
+        }
+        EQ_GL_CALL( glActiveTexture( GL_TEXTURE0 ));
+        _uploadArrayTexture( channel, om.obtainTexture( colorArrayKey ),
+                             Frame::BUFFER_COLOR, images, destPVP, nLayers );
+
+        GLint viewports[ EQ_ARRAY_MAX_IMAGES * 4 ];
+        GLint* viewport = viewports;
+        for( GLsizei i = 0; i < nLayers; ++i )
+        {
+            const PixelViewport pvp = images[i].image->getPixelViewport() +
+                                      images[i].offset;
+            *viewport++ = pvp.x - destPVP.x;
+            *viewport++ = pvp.y - destPVP.y;
+            *viewport++ = pvp.getXEnd() - destPVP.x;
+            *viewport++ = pvp.getYEnd() - destPVP.y;
+
+            ImageOp op;
+            op.channel = channel;
+            op.offset = images[i].offset;
+            declareRegion( images[i].image, op );
+        }
+
+        // one quad covering the destination area, with destination-relative
+        // pixel coordinates
+        const GLfloat x = float( destPVP.x );
+        const GLfloat y = float( destPVP.y );
+        const GLfloat w = float( destPVP.w );
+        const GLfloat h = float( destPVP.h );
+        const GLfloat vertices[] = {
+            x,     y,     0.f, 0.f,
+            x + w, y,     w,   0.f,
+            x,     y + h, 0.f, h,
+            x + w, y + h, w,   h
+        };
+
+        EQ_GL_CALL( glUniform4iv( viewportsParam, nLayers, viewports ));
+        EQ_GL_CALL( glUniform1i( nLayersParam, nLayers ));
+
+        EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, vertexBuffer ));
+        EQ_GL_CALL( glBufferData( GL_ARRAY_BUFFER, sizeof(vertices), vertices,
+                                  GL_DYNAMIC_DRAW ));
+        EQ_GL_CALL( glVertexAttribPointer( 0, 4, GL_FLOAT, GL_FALSE, 0, 0 ));
+        EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, 0 ));
+
+        EQ_GL_CALL( glEnableVertexAttribArray( 0 ));
+        EQ_GL_CALL( glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 ));
+        EQ_GL_CALL( glDisableVertexAttribArray( 0 ));
+    }
+
+    EQ_GL_CALL( glBindVertexArray( 0 ));
+    EQ_GL_CALL( glUseProgram( 0 ));
+
+    EQ_GL_CALL( glBindTexture( GL_TEXTURE_2D_ARRAY, 0 ));
+    if( !blendAlpha )
+    {
+        EQ_GL_CALL( glActiveTexture( GL_TEXTURE1 ));
+        EQ_GL_CALL( glBindTexture( GL_TEXTURE_2D_ARRAY, 0 ));
+        EQ_GL_CALL( glActiveTexture( GL_TEXTURE0 ));
+        EQ_GL_CALL( glDisable( GL_DEPTH_TEST ));
+    }
+    return 1;
+}
+
+uint32_t Compositor::assembleFramesBlendTree( const Frames& frames,
+                                              Channel* channel )
+{
+    if( frames.empty( ))
+        return 0;
+
+    LBVERB << "Blend tree CPU assembly" << std::endl;
+
+    // Frames are blended into segments of adjacent frames as they arrive. A
+    // new segment is merged with its ready neighbors right away, so only the
+    // final merges wait for late frames.
+    const size_t nFrames = frames.size();
+    std::vector< BlendSegment > segments( nFrames );
+    std::vector< BlendSegment* > byBegin( nFrames, 0 );
+    std::vector< BlendSegment* > byLast( nFrames, 0 );
+    const detail::PixelKernels* kernels = 0;
+    uint32_t internalFormat = 0;
+    bool fallback = false;
+
+    WaitHandle* handle = startWaitFrames( frames, channel );
+    for( Frame* frame = waitFrame( handle ); frame; frame = waitFrame( handle ))
+    {
+        if( fallback )
+            continue;
+
+        // check that all images can be blended on the CPU
+        const Images& images = frame->getImages();
+        for( ImagesCIter i = images.begin(); i != images.end(); ++i )
+        {
+            const Image* image = *i;
+            if( image->getStorageType() != Frame::TYPE_MEMORY ||
+                !image->hasPixelData( Frame::BUFFER_COLOR ) ||
+                !image->hasAlpha() || image->getZoom() != Zoom::NONE )
+            {
+                fallback = true;
+                break;
+            }
+
+            const uint32_t format =
+                image->getExternalFormat( Frame::BUFFER_COLOR );
+            if( !kernels )
+            {
+                kernels = detail::getPixelKernels( format, 0 );
+                internalFormat =
+                    image->getInternalFormat( Frame::BUFFER_COLOR );
+            }
+            if( !kernels || kernels->colorFormat != format )
+            {
+                fallback = true;
+                break;
+            }
+        }
+        if( fallback )
+            continue;
+
+        const size_t index = std::find( frames.begin(), frames.end(), frame ) -
+                             frames.begin();
+        LBASSERT( index < nFrames );
+
+        BlendSegment* segment = &segments[ index ];
+        segment->begin = index;
+        segment->end = index + 1;
+        if( kernels )
+            _fillSegment( *segment, frame, *kernels );
+
+        if( index > 0 && byLast[ index - 1 ] )
+        {
+            BlendSegment* earlier = byLast[ index - 1 ];
+            byLast[ index - 1 ] = 0;
+            _mergeSegments( *earlier, *segment, kernels );
+            segment = earlier;
+        }
+        if( segment->end < nFrames && byBegin[ segment->end ] )
+        {
+            BlendSegment* later = byBegin[ segment->end ];
+            byBegin[ segment->end ] = 0;
+            byLast[ later->end - 1 ] = 0;
+            _mergeSegments( *segment, *later, kernels );
+        }
+        byBegin[ segment->begin ] = segment;
+        byLast[ segment->end - 1 ] = segment;
+    }
+
+    if( fallback )
+    {
+        // all frames are ready now, assemble them in order on the GPU
+        uint32_t count = 0;
+        for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
+        {
+            if( (*i)->getImages().empty( ))
+                continue;
+            count = 1;
+            assembleFrame( *i, channel );
+        }
+        return count;
+    }
+
+    const BlendSegment* segment = byBegin[ 0 ];
+    LBASSERT( segment && segment->end == nFrames );
+    if( !kernels || !segment || !segment->pvp.hasArea( ))
+        return 0;
+
+    if( !_resultImage )
+        _resultImage = new Image;
+    Image* result = _resultImage.get();
+    result->setPixelViewport( segment->pvp );
+
+    PixelData colorPixels;
+    colorPixels.internalFormat = internalFormat;
+    colorPixels.externalFormat = kernels->colorFormat;
+    colorPixels.pixelSize      = uint32_t( kernels->colorSize );
+    colorPixels.pvp            = segment->pvp;
+    result->setPixelData( Frame::BUFFER_COLOR, colorPixels );
+    memcpy( result->getPixelPointer( Frame::BUFFER_COLOR ),
+            &segment->pixels[0], segment->pixels.size( ));
+
+    ImageOp operation;
+    operation.channel = channel;
+    operation.buffers = Frame::BUFFER_COLOR;
+    assembleImage( result, operation );
+    return 1;
+}
+
+uint32_t Compositor::assembleFramesCPU( const Frames& frames, Channel* channel,
+                                        const bool blendAlpha )
+{
+    if( frames.empty( ))
+        return 0;
+
+    LBVERB << "Sorted CPU assembly" << std::endl;
+    // Assembles images from DB, 2D, Pixel and zoomed compounds using the CPU
+    // and then assembles the result image. Does not yet support Eye
+    // compounds.
+
+    const Image* result = mergeFramesCPU( frames, blendAlpha,
+                                          channel->getConfig()->getTimeout( ));
+    if( !result )
+        return 0;
+
+    // assemble result on dest channel
+    ImageOp operation;
+    operation.channel = channel;
+    operation.buffers = Frame::BUFFER_COLOR | Frame::BUFFER_DEPTH;
+    assembleImage( result, operation );
+
+#if 0
+    static uint32_t counter = 0;
+    ostringstream stringstream;
+    stringstream << "Image_" << ++counter;
+    result->writeImages( stringstream.str( ));
+#endif
+
+    return 1;
+}
+
+uint32_t Compositor::assembleFramesMemory( const Frames& frames,
+                                           Channel* channel,
+                                           const bool blendAlpha )
+{
+    if( frames.empty( ))
+        return 0;
+
+    PixelData* color = channel->getPixelData( Frame::BUFFER_COLOR );
+    if( !color || color->pixelSize != 4 )
+    {
+        LBWARN << "No RGBA main memory frame buffer for assembly" << std::endl;
+        return 0;
+    }
+
+    const Image* result = mergeFramesCPU( frames, blendAlpha,
+                                          channel->getConfig()->getTimeout( ));
+    if( !result )
+        return 0;
+
+    if( result->getExternalFormat( Frame::BUFFER_COLOR ) !=
+        color->externalFormat )
+    {
+        LBWARN << "Frame format differs from the main memory frame buffer"
+               << std::endl;
+        return 0;
+    }
+
+    PixelData* depth = channel->getPixelData( Frame::BUFFER_DEPTH );
+    const bool useDepth = depth && result->hasPixelData( Frame::BUFFER_DEPTH );
+
+    // the result is relative to the channel, the frame buffer to the window
+    const PixelViewport& channelPVP = channel->getPixelViewport();
+    const PixelViewport& resultPVP = result->getPixelViewport();
+    const Vector2i offset( channelPVP.x - resultPVP.x,
+                           channelPVP.y - resultPVP.y );
+    PixelViewport area = resultPVP + Vector2i( channelPVP.x, channelPVP.y );
+    area.intersect( channelPVP );
+    area.intersect( color->pvp );
+    if( !area.hasArea( ))
+        return 0;
+
+    const uint32_t* srcColor = reinterpret_cast< const uint32_t* >(
+        result->getPixelPointer( Frame::BUFFER_COLOR ));
+    const uint32_t* srcDepth = useDepth ?
+        reinterpret_cast< const uint32_t* >(
+            result->getPixelPointer( Frame::BUFFER_DEPTH )) : 0;
+    uint32_t* dstColor = static_cast< uint32_t* >( color->pixels );
+    uint32_t* dstDepth = useDepth ? static_cast< uint32_t* >( depth->pixels )
+                                  : 0;
+
+    for( int32_t y = area.y; y < area.getYEnd(); ++y )
+    {
+        const size_t from = size_t( y - offset.y( )) * resultPVP.w +
+                            size_t( area.x - offset.x( ));
+        const size_t to = size_t( y - color->pvp.y ) * color->pvp.w +
+                          size_t( area.x - color->pvp.x );
+        if( useDepth )
+        {
+            for( int32_t x = 0; x < area.w; ++x )
+            {
+                if( srcDepth[ from + x ] < dstDepth[ to + x ] )
+                {
+                    dstDepth[ to + x ] = srcDepth[ from + x ];
+                    dstColor[ to + x ] = srcColor[ from + x ];
+                }
+            }
+        }
+        else if( blendAlpha ) // glBlendFunc( GL_ONE, GL_SRC_ALPHA )
+        {
+            const uint8_t* src =
+                reinterpret_cast< const uint8_t* >( srcColor + from );
+            uint8_t* dst = reinterpret_cast< uint8_t* >( dstColor + to );
+            for( int32_t x = 0; x < area.w * 4; x += 4 )
+            {
+                const uint32_t alpha = src[ x + 3 ];
+                for( int32_t c = 0; c < 4; ++c )
+                    dst[ x + c ] = uint8_t( LB_MIN( src[ x + c ] +
+                                               dst[ x + c ] * alpha / 255u,
+                                               255u ));
+            }
+        }
+        else
+            ::memcpy( dstColor + to, srcColor + from, size_t( area.w ) * 4 );
+    }
+    return 1;
+}
+
+uint32_t Compositor::_assembleSubPixelCPU( const Frames& frames,
+                                           Channel* channel,
+                                           const bool blendAlpha )
+{
+    LBVERB << "Sub pixel CPU assembly" << std::endl;
+    // Merges the frames of each sub pixel step on the CPU, sums the steps in
+    // 16 bit per channel and assembles their average. The steps were checked
+    // by _useCPUSubPixelAssembly to cover the same area in RGBA8 or BGRA8.
+
+    const detail::CompositorKernels& kernels = detail::getCompositorKernels();
+    const uint32_t steps = frames.back()->getSubPixel().size;
+    const uint32_t timeout = channel->getConfig()->getTimeout();
+
+    PixelViewport pvp;
+    uint32_t internalFormat = 0;
+    uint32_t externalFormat = 0;
+    std::vector< uint16_t > sums;
+    uint32_t count = 0;
+
+    Frames framesLeft = frames;
+    while( !framesLeft.empty( ))
+    {
+        const Frames current = _extractOneSubPixel( framesLeft );
+
+        // a single image is averaged in place, others are merged first
+        const Image* image = 0;
+        PixelViewport imagePVP;
+        if( current.size() == 1 && current.front()->getImages().size() == 1 )
+        {
+            const Frame* frame = current.front();
+            frame->waitReady( timeout );
+            image = frame->getImages().front();
+            imagePVP = image->getPixelViewport() + frame->getOffset();
+        }
+        else
+        {
+            image = mergeFramesCPU( current, blendAlpha, timeout );
+            if( image )
+                imagePVP = image->getPixelViewport();
+        }
+        if( !image )
+            continue;
 
-    for( FramesIter i = handle->left.begin(); i != handle->left.end(); ++i )
-    {
-        Frame* frame = *i;
-        if( !frame->isReady( ))
+        if( sums.empty( ))
+        {
+            pvp = imagePVP;
+            internalFormat = image->getInternalFormat( Frame::BUFFER_COLOR );
+            externalFormat = image->getExternalFormat( Frame::BUFFER_COLOR );
+            sums.resize( size_t( pvp.getArea( )) * 4, 0 );
+        }
+        LBASSERT( imagePVP == pvp );
+        if( imagePVP != pvp )
             continue;
 
-        frame->removeListener( handle->monitor );
-        handle->left.erase( i );
-        return frame;
+        const uint32_t* color = reinterpret_cast< const uint32_t* >(
+            image->getPixelPointer( Frame::BUFFER_COLOR ));
+        uint16_t* const sum = &sums.front();
+#pragma omp parallel for schedule( static )
+        for( int32_t y = 0; y < pvp.h; ++y )
+        {
+            const size_t row = size_t( y ) * pvp.w;
+            kernels.accumRGBA8( sum + row * 4, color + row, pvp.w );
+        }
+        ++count;
     }
-
-    LBASSERTINFO( false, "Unreachable code" );
-    delete handle;
-    return 0;
-}
-
-uint32_t Compositor::assembleFramesCPU( const Frames& frames, Channel* channel,
-                                        const bool blendAlpha )
-{
-    if( frames.empty( ))
+    if( count == 0 )
         return 0;
 
-    LBVERB << "Sorted CPU assembly" << std::endl;
-    // Assembles images from DB and 2D compounds using the CPU and then
-    // assembles the result image. Does not yet support Pixel or Eye
-    // compounds.
+    if( !_subPixelImage )
+        _subPixelImage = new Image;
+    Image* result = _subPixelImage.get();
+    result->setPixelViewport( pvp );
 
-    const Image* result = mergeFramesCPU( frames, blendAlpha,
-                                          channel->getConfig()->getTimeout( ));
-    if( !result )
-        return 0;
+    PixelData colorPixels;
+    colorPixels.internalFormat = internalFormat;
+    colorPixels.externalFormat = externalFormat;
+    colorPixels.pixelSize      = 4;
+    colorPixels.pvp            = pvp;
+    result->setPixelData( Frame::BUFFER_COLOR, colorPixels );
+
+    uint32_t* dest = reinterpret_cast< uint32_t* >(
+        result->getPixelPointer( Frame::BUFFER_COLOR ));
+    // missing steps are black, as with the accumulation buffer
+    const uint16_t* const sum = &sums.front();
+#pragma omp parallel for schedule( static )
+    for( int32_t y = 0; y < pvp.h; ++y )
+    {
+        const size_t row = size_t( y ) * pvp.w;
+        kernels.resolveRGBA8( dest + row, sum + row * 4, steps, pvp.w );
+    }
 
-    // assemble result on dest channel
     ImageOp operation;
     operation.channel = channel;
-    operation.buffers = Frame::BUFFER_COLOR | Frame::BUFFER_DEPTH;
+    operation.buffers = Frame::BUFFER_COLOR;
     assembleImage( result, operation );
-
-#if 0
-    static uint32_t counter = 0;
-    ostringstream stringstream;
-    stringstream << "Image_" << ++counter;
-    result->writeImages( stringstream.str( ));
-#endif
-
-    return 1;
+    return count;
 }
 
 const Image* Compositor::mergeFramesCPU( const Frames& frames,
@@ -579,6 +1798,12 @@ const Image* Compositor::mergeFramesCPU( const Frames& frames,
 
     // pre-condition check for current _merge implementations
     LBASSERT( colorInternalFormat != 0 );
+    if( !detail::getPixelKernels( colorExternalFormat, depthExternalFormat ))
+    {
+        LBWARN << "Pixel format not supported by the CPU compositor"
+               << std::endl;
+        return 0;
+    }
 
     result->setPixelViewport( destPVP );
 
@@ -622,14 +1847,6 @@ bool Compositor::_collectOutputData(
         Frame* frame = *i;
         frame->waitReady( timeout );
 
-        LBASSERTINFO( frame->getPixel() == Pixel::ALL &&
-                      frame->getSubPixel() == SubPixel::ALL &&
-                      frame->getFrameData()->getZoom() == Zoom::NONE &&
-                      frame->getZoom() == Zoom::NONE,
-                      "CPU-based compositing not implemented for given frames");
-        if( frame->getPixel() != Pixel::ALL )
-            return false;
-
         const Images& images = frame->getImages();
         for( Images::const_iterator j = images.begin(); j != images.end(); ++j )
         {
@@ -641,7 +1858,8 @@ bool Compositor::_collectOutputData(
             if( !image->hasPixelData( Frame::BUFFER_COLOR ))
                 continue;
 
-            destPVP.merge( image->getPixelViewport() + frame->getOffset( ));
+            destPVP.merge( _getMergeViewport( image->getPixelViewport(),
+                                              _getMergeOp( frame, image )));
 
             _collectOutputData( image->getPixelData( Frame::BUFFER_COLOR ),
                                 colorInternalFormat, colorPixelSize,
@@ -708,29 +1926,17 @@ bool Compositor::mergeFramesCPU( const Frames& frames,
 
     // pre-condition check for current _merge implementations
     LBASSERT( colorInternalFormat != 0 );
+    if( !detail::getPixelKernels( colorExternalFormat, depthExternalFormat ))
+    {
+        LBWARN << "Pixel format not supported by the CPU compositor"
+               << std::endl;
+        return false;
+    }
 
     // check output buffers
     const uint32_t area = outPVP.getArea();
-    uint32_t nChannels = 0;
-
-    switch ( colorInternalFormat )
-    {
-        case EQ_COMPRESSOR_DATATYPE_RGBA:
-        case EQ_COMPRESSOR_DATATYPE_RGBA16F:
-        case EQ_COMPRESSOR_DATATYPE_RGBA32F:
-        case EQ_COMPRESSOR_DATATYPE_RGB10_A2:
-            nChannels = 4;
-            break;
-        case EQ_COMPRESSOR_DATATYPE_RGB:
-        case EQ_COMPRESSOR_DATATYPE_RGB16F:
-        case EQ_COMPRESSOR_DATATYPE_RGB32F:
-            nChannels = 3;
-            break;
-        default:
-            LBASSERT( false );
-    }
 
-    if( colorBufferSize < area * nChannels )
+    if( colorBufferSize < area * colorPixelSize )
     {
         LBWARN << "Color output buffer to small" << std::endl;
         return false;
@@ -765,46 +1971,69 @@ void Compositor::_mergeFrames( const Frames& frames, const bool blendAlpha,
                                void* colorBuffer, void* depthBuffer,
                                const PixelViewport& destPVP )
 {
-    for( Frames::const_iterator i = frames.begin(); i != frames.end(); ++i)
-    {
-        const Frame* frame = *i;
-        const Images& images = frame->getImages();
-        for( Images::const_iterator j = images.begin(); j != images.end(); ++j )
-        {
-            const Image* image = *j;
+    // The destination is split into tiles of full rows, sized to stay in the
+    // cache while all images are merged into them in order. All tiles are
+    // composited in one parallel loop. The static schedule gives each thread
+    // the same rows in all frames, which it also touches first in a newly
+    // allocated result buffer, placing them on the thread's NUMA node.
+    const size_t rowSize = size_t( destPVP.w ) * ( depthBuffer ? 8 : 4 );
+    int32_t tileRows = int32_t( std::max( _tileSize / rowSize, size_t( 1 )));
+#if defined( EQ_USE_PARACOMP_DEPTH ) || defined( EQ_USE_PARACOMP_BLEND )
+    tileRows = destPVP.h; // Paracomp composites full images
+#endif
+    const int32_t nTiles = ( destPVP.h + tileRows - 1 ) / tileRows;
 
-            if( !image->hasPixelData( Frame::BUFFER_COLOR ))
-                continue;
+#pragma omp parallel for schedule( static )
+    for( int32_t tile = 0; tile < nTiles; ++tile )
+    {
+        const int32_t yBegin = tile * tileRows;
+        const int32_t yEnd = std::min( yBegin + tileRows, destPVP.h );
 
-            if( image->hasPixelData( Frame::BUFFER_DEPTH ))
-                _mergeDBImage( colorBuffer, depthBuffer, destPVP,
-                               image, frame->getOffset( ));
-            else if( blendAlpha && image->hasAlpha( ))
-                _mergeBlendImage( colorBuffer, destPVP,
-                                  image, frame->getOffset( ));
-            else
-                _merge2DImage( colorBuffer, depthBuffer, destPVP,
-                               image, frame->getOffset());
+        for( Frames::const_iterator i = frames.begin(); i != frames.end(); ++i)
+        {
+            const Frame* frame = *i;
+            const Images& images = frame->getImages();
+            for( Images::const_iterator j = images.begin();
+                 j != images.end(); ++j )
+            {
+                const Image* image = *j;
+
+                if( !image->hasPixelData( Frame::BUFFER_COLOR ))
+                    continue;
+
+                const ImageOp& op = _getMergeOp( frame, image );
+                if( op.zoom != Zoom::NONE )
+                    _mergeZoomedImage( colorBuffer, depthBuffer, destPVP,
+                                       image, op, yBegin, yEnd );
+                else if( image->hasPixelData( Frame::BUFFER_DEPTH ))
+                    _mergeDBImage( colorBuffer, depthBuffer, destPVP,
+                                   image, op, yBegin, yEnd );
+                else if( blendAlpha && image->hasAlpha( ))
+                    _mergeBlendImage( colorBuffer, destPVP,
+                                      image, op.offset, yBegin, yEnd );
+                else
+                    _merge2DImage( colorBuffer, depthBuffer, destPVP,
+                                   image, op, yBegin, yEnd );
+            }
         }
     }
 }
 
 void Compositor::_mergeDBImage( void* destColor, void* destDepth,
                                 const PixelViewport& destPVP,
-                                const Image* image,
-                                const Vector2i& offset )
+                                const Image* image, const ImageOp& op,
+                                const int32_t yBegin, const int32_t yEnd )
 {
     LBASSERT( destColor && destDepth );
 
-    LBVERB << "CPU-DB assembly" << std::endl;
-
-    uint32_t* destC = reinterpret_cast< uint32_t* >( destColor );
-    uint32_t* destD = reinterpret_cast< uint32_t* >( destDepth );
+    uint8_t* destC = reinterpret_cast< uint8_t* >( destColor );
+    uint8_t* destD = reinterpret_cast< uint8_t* >( destDepth );
 
     const PixelViewport&  pvp    = image->getPixelViewport();
 
 #ifdef EQ_USE_PARACOMP_DEPTH
-    if( pvp == destPVP && offset == eq::Vector2i::ZERO )
+    if( pvp == destPVP && op.offset == eq::Vector2i::ZERO &&
+        op.pixel == Pixel::ALL && yBegin == 0 && yEnd == destPVP.h )
     {
         // Use Paracomp to composite
         if( _mergeImage_PC( PC_COMP_DEPTH, destColor, destDepth, image ))
@@ -814,53 +2043,79 @@ void Compositor::_mergeDBImage( void* destColor, void* destDepth,
     }
 #endif
 
-    const int32_t         destX  = offset.x() + pvp.x - destPVP.x;
-    const int32_t         destY  = offset.y() + pvp.y - destPVP.y;
+    const PixelViewport& area = _getMergeViewport( pvp, op );
+    const int32_t destX = area.x - destPVP.x;
+    const int32_t destY = area.y - destPVP.y;
+    const int32_t stepX = int32_t( op.pixel.w );
+    const int32_t stepY = int32_t( op.pixel.h );
 
-    const uint32_t* color = reinterpret_cast< const uint32_t* >
-        ( image->getPixelPointer( Frame::BUFFER_COLOR ));
-    const uint32_t* depth = reinterpret_cast< const uint32_t* >
-        ( image->getPixelPointer( Frame::BUFFER_DEPTH ));
+    const uint8_t* color = image->getPixelPointer( Frame::BUFFER_COLOR );
+    const uint8_t* depth = image->getPixelPointer( Frame::BUFFER_DEPTH );
 
-#pragma omp parallel for
-    for( int32_t y = 0; y < pvp.h; ++y )
-    {
-        const uint32_t skip =  (destY + y) * destPVP.w + destX;
-        uint32_t* destColorIt = destC + skip;
-        uint32_t* destDepthIt = destD + skip;
-        const uint32_t* colorIt = color + y * pvp.w;
-        const uint32_t* depthIt = depth + y * pvp.w;
+    const detail::PixelKernels* kernels = detail::getPixelKernels(
+        image->getExternalFormat( Frame::BUFFER_COLOR ),
+        image->getExternalFormat( Frame::BUFFER_DEPTH ));
+    LBASSERT( kernels );
+    if( !kernels )
+        return;
 
-        for( int32_t x = 0; x < pvp.w; ++x )
+    const size_t colorSize = kernels->colorSize;
+    const size_t depthSize = kernels->depthSize;
+
+    // sparse images: merge only the active spans of each row
+    const PixelData& depthData = image->getPixelData( Frame::BUFFER_DEPTH );
+    const std::vector< uint32_t >& spans = depthData.spans;
+    LBASSERT( spans.empty() || depthData.pvp == pvp );
+
+    // pixel images merge each source row into every stepY-th row
+    int32_t begin = 0;
+    int32_t end = 0;
+    _getMergeRows( destY, stepY, pvp.h, yBegin, yEnd, begin, end );
+    for( int32_t y = begin; y < end; ++y )
+    {
+        const size_t skip = size_t( destY + y * stepY ) * destPVP.w + destX;
+        const size_t row = size_t( y ) * pvp.w;
+        uint8_t* const destCRow = destC + skip * colorSize;
+        uint8_t* const destDRow = destD + skip * depthSize;
+        const uint8_t* const colorRow = color + row * colorSize;
+        const uint8_t* const depthRow = depth + row * depthSize;
+
+        if( !spans.empty( ))
         {
-            if( *destDepthIt > *depthIt )
+            const uint32_t h = pvp.h;
+            const uint32_t spanRow = y;
+            for( const uint32_t* i = detail::spans::getBegin( spans, h,
+                                                              spanRow );
+                 i != detail::spans::getEnd( spans, h, spanRow ); i += 2 )
             {
-                *destColorIt = *colorIt;
-                *destDepthIt = *depthIt;
+                _mergeDepthRun( *kernels, destCRow, destDRow, colorRow,
+                                depthRow, i[0], i[1], stepX );
             }
-
-            ++destColorIt;
-            ++destDepthIt;
-            ++colorIt;
-            ++depthIt;
+            continue;
         }
+        if( stepX == 1 )
+            _mergeDepthSpans( *kernels, destCRow, destDRow, colorRow,
+                              depthRow, pvp.w );
+        else
+            _mergeDepthRun( *kernels, destCRow, destDRow, colorRow, depthRow,
+                            0, pvp.w, stepX );
     }
 }
 
 void Compositor::_merge2DImage( void* destColor, void* destDepth,
                                 const eq::PixelViewport& destPVP,
-                                const Image* image,
-                                const Vector2i& offset )
+                                const Image* image, const ImageOp& op,
+                                const int32_t yBegin, const int32_t yEnd )
 {
     // This is mostly copy&paste code from _mergeDBImage :-/
-    LBVERB << "CPU-2D assembly" << std::endl;
-
     uint8_t* destC = reinterpret_cast< uint8_t* >( destColor );
     uint8_t* destD = reinterpret_cast< uint8_t* >( destDepth );
 
     const PixelViewport&  pvp    = image->getPixelViewport();
-    const int32_t         destX  = offset.x() + pvp.x - destPVP.x;
-    const int32_t         destY  = offset.y() + pvp.y - destPVP.y;
+    const PixelViewport&  area   = _getMergeViewport( pvp, op );
+    const int32_t         destX  = area.x - destPVP.x;
+    const int32_t         destY  = area.y - destPVP.y;
+    const size_t          stepX  = op.pixel.w;
 
     LBASSERT( image->hasPixelData( Frame::BUFFER_COLOR ));
 
@@ -868,36 +2123,202 @@ void Compositor::_merge2DImage( void* destColor, void* destDepth,
     const size_t pixelSize = image->getPixelSize( Frame::BUFFER_COLOR );
     const size_t rowLength = pvp.w * pixelSize;
 
-#pragma omp parallel for
-    for( int32_t y = 0; y < pvp.h; ++y )
+    int32_t begin = 0;
+    int32_t end = 0;
+    _getMergeRows( destY, int32_t( op.pixel.h ), pvp.h, yBegin, yEnd,
+                   begin, end );
+    for( int32_t y = begin; y < end; ++y )
+    {
+        const size_t destRow = size_t( destY + y * int32_t( op.pixel.h ));
+        const size_t skip = ( destRow * destPVP.w + destX ) * pixelSize;
+        const uint8_t* row = color + size_t( y ) * rowLength;
+        if( stepX == 1 )
+        {
+            memcpy( destC + skip, row, rowLength );
+            // clear depth, for depth-assembly into existing FB
+            if( destD )
+                lunchbox::setZero( destD + skip, rowLength );
+            continue;
+        }
+
+        // pixel images fill every stepX-th pixel of the row
+        const size_t depthSkip = ( destRow * destPVP.w + destX ) *
+                                 sizeof( uint32_t );
+        for( size_t x = 0; x < size_t( pvp.w ); ++x )
+        {
+            memcpy( destC + skip + x * stepX * pixelSize, row + x * pixelSize,
+                    pixelSize );
+            if( destD )
+                lunchbox::setZero( destD + depthSkip +
+                                   x * stepX * sizeof( uint32_t ),
+                                   sizeof( uint32_t ));
+        }
+    }
+}
+
+void Compositor::_mergeZoomedImage( void* destColor, void* destDepth,
+                                    const PixelViewport& destPVP,
+                                    const Image* image, const ImageOp& op,
+                                    const int32_t yBegin, const int32_t yEnd )
+{
+    // Resamples each destination row into a contiguous row, which is then
+    // merged using the unzoomed row kernels. Depth images are sampled nearest,
+    // since interpolated depth values do not exist in the source. 2D images
+    // with 8 bit channels are filtered linearly if requested.
+    uint8_t* destC = reinterpret_cast< uint8_t* >( destColor );
+    uint8_t* destD = reinterpret_cast< uint8_t* >( destDepth );
+
+    const PixelViewport& pvp = image->getPixelViewport();
+    const PixelViewport& area = _getMergeViewport( pvp, op );
+    const int32_t destX = area.x - destPVP.x;
+    const int32_t destY = area.y - destPVP.y;
+    if( !area.hasArea( ))
+        return;
+
+    const bool hasDepth = image->hasPixelData( Frame::BUFFER_DEPTH );
+    const uint32_t colorFormat = image->getExternalFormat(Frame::BUFFER_COLOR);
+    const detail::PixelKernels* kernels = detail::getPixelKernels(
+        colorFormat,
+        hasDepth ? image->getExternalFormat( Frame::BUFFER_DEPTH ) : 0 );
+    LBASSERT( kernels );
+    if( !kernels )
+        return;
+
+    const size_t colorSize = kernels->colorSize;
+    const uint8_t* color = image->getPixelPointer( Frame::BUFFER_COLOR );
+    const uint32_t* depth = hasDepth ? reinterpret_cast< const uint32_t* >(
+        image->getPixelPointer( Frame::BUFFER_DEPTH )) : 0;
+    const std::vector< uint32_t > noSpans;
+    const std::vector< uint32_t >& spans = hasDepth ?
+        image->getPixelData( Frame::BUFFER_DEPTH ).spans : noSpans;
+    const bool linear = !hasDepth && op.zoomFilter == FILTER_LINEAR &&
+                        ( colorFormat == EQ_COMPRESSOR_DATATYPE_RGBA ||
+                          colorFormat == EQ_COMPRESSOR_DATATYPE_BGRA );
+
+    // source column and 8 bit weight of the next column, per destination
+    const float scaleX = float( pvp.w ) / float( area.w );
+    const float scaleY = float( pvp.h ) / float( area.h );
+    std::vector< uint32_t > columns( area.w );
+    std::vector< uint32_t > weights( area.w, 0 );
+    for( int32_t x = 0; x < area.w; ++x )
+    {
+        const float sx = ( float( x ) + .5f ) * scaleX;
+        if( !linear )
+        {
+            columns[x] = std::min( uint32_t( sx ), uint32_t( pvp.w - 1 ));
+            continue;
+        }
+        const float center = std::max( sx - .5f, 0.f );
+        columns[x] = std::min( uint32_t( center ), uint32_t( pvp.w - 1 ));
+        weights[x] = uint32_t(( center - float( columns[x] )) * 256.f );
+    }
+
+    std::vector< uint8_t > colorRow( area.w * colorSize );
+    std::vector< uint32_t > depthRow( hasDepth ? area.w : 0 );
+
+    const int32_t begin = std::max( yBegin, destY );
+    const int32_t end = std::min( yEnd, destY + area.h );
+    for( int32_t y = begin; y < end; ++y )
     {
-        const size_t skip = ( (destY + y) * destPVP.w + destX ) * pixelSize;
-        memcpy( destC + skip, color + y * pvp.w * pixelSize, rowLength);
+        const float sy = ( float( y - destY ) + .5f ) * scaleY;
+        if( linear )
+        {
+            const float center = std::max( sy - .5f, 0.f );
+            const uint32_t row0 = std::min( uint32_t( center ),
+                                            uint32_t( pvp.h - 1 ));
+            const uint32_t row1 = std::min( row0 + 1, uint32_t( pvp.h - 1 ));
+            const uint32_t wy = uint32_t(( center - float( row0 )) * 256.f );
+            const uint8_t* src0 = color + size_t( row0 ) * pvp.w * 4;
+            const uint8_t* src1 = color + size_t( row1 ) * pvp.w * 4;
+            for( int32_t x = 0; x < area.w; ++x )
+            {
+                const uint32_t c0 = columns[x] * 4;
+                const uint32_t c1 = std::min( columns[x] + 1,
+                                              uint32_t( pvp.w - 1 )) * 4;
+                const uint32_t wx = weights[x];
+                for( size_t c = 0; c < 4; ++c )
+                {
+                    const uint32_t top = src0[c0 + c] * ( 256 - wx ) +
+                                         src0[c1 + c] * wx;
+                    const uint32_t bottom = src1[c0 + c] * ( 256 - wx ) +
+                                            src1[c1 + c] * wx;
+                    colorRow[x * 4 + c] = uint8_t(
+                        ( top * ( 256 - wy ) + bottom * wy + 32768 ) >> 16 );
+                }
+            }
+        }
+        else
+        {
+            const uint32_t srcRow = std::min( uint32_t( sy ),
+                                              uint32_t( pvp.h - 1 ));
+            const uint8_t* src = color + size_t( srcRow ) * pvp.w * colorSize;
+            for( int32_t x = 0; x < area.w; ++x )
+                memcpy( &colorRow[ x * colorSize ],
+                        src + columns[x] * colorSize, colorSize );
+
+            if( hasDepth )
+            {
+                const uint32_t* srcD = depth + size_t( srcRow ) * pvp.w;
+                for( int32_t x = 0; x < area.w; ++x )
+                    depthRow[x] = srcD[ columns[x] ];
+
+                // pixels outside of the active spans are background
+                if( !spans.empty( ))
+                {
+                    const uint32_t h = pvp.h;
+                    const uint32_t* span = detail::spans::getBegin( spans, h,
+                                                                    srcRow );
+                    const uint32_t* last = detail::spans::getEnd( spans, h,
+                                                                  srcRow );
+                    for( int32_t x = 0; x < area.w; ++x )
+                    {
+                        while( span != last && span[1] <= columns[x] )
+                            span += 2;
+                        if( span == last || columns[x] < span[0] )
+                            depthRow[x] = 0xffffffffu;
+                    }
+                }
+            }
+        }
+
+        const size_t skip = size_t( y ) * destPVP.w + destX;
+        if( hasDepth )
+        {
+            LBASSERT( destD );
+            _mergeDepthSpans( *kernels, destC + skip * colorSize,
+                              destD + skip * sizeof( uint32_t ),
+                              &colorRow.front(),
+                              reinterpret_cast< const uint8_t* >(
+                                  &depthRow.front( )),
+                              area.w );
+            continue;
+        }
+
+        memcpy( destC + skip * colorSize, &colorRow.front(), colorRow.size( ));
         // clear depth, for depth-assembly into existing FB
         if( destD )
-            lunchbox::setZero( destD + skip, rowLength );
+            lunchbox::setZero( destD + skip * sizeof( uint32_t ),
+                               area.w * sizeof( uint32_t ));
     }
 }
 
-
 void Compositor::_mergeBlendImage( void* dest, const eq::PixelViewport& destPVP,
                                    const Image* image,
-                                   const Vector2i& offset )
+                                   const Vector2i& offset,
+                                   const int32_t yBegin, const int32_t yEnd )
 {
-    LBVERB << "CPU-Blend assembly"<< std::endl;
-
-    int32_t* destColor = reinterpret_cast< int32_t* >( dest );
+    uint8_t* destColor = reinterpret_cast< uint8_t* >( dest );
 
     const PixelViewport&  pvp    = image->getPixelViewport();
     const int32_t         destX  = offset.x() + pvp.x - destPVP.x;
     const int32_t         destY  = offset.y() + pvp.y - destPVP.y;
 
-    LBASSERT( image->getPixelSize( Frame::BUFFER_COLOR ) == 4 );
     LBASSERT( image->hasPixelData( Frame::BUFFER_COLOR ));
     LBASSERT( image->hasAlpha( ));
 
 #ifdef EQ_USE_PARACOMP_BLEND
-    if( pvp == destPVP && offset == eq::Vector2i::ZERO )
+    if( pvp == destPVP && offset == eq::Vector2i::ZERO &&
+        yBegin == 0 && yEnd == destPVP.h )
     {
         // Use Paracomp to composite
         if( !_mergeImage_PC( PC_COMP_ALPHA_SORT2_HP, dest, 0, image ))
@@ -908,8 +2329,7 @@ void Compositor::_mergeBlendImage( void* dest, const eq::PixelViewport& destPVP,
     }
 #endif
 
-    const int32_t* color = reinterpret_cast< const int32_t* >
-                               ( image->getPixelPointer( Frame::BUFFER_COLOR ));
+    const uint8_t* color = image->getPixelPointer( Frame::BUFFER_COLOR );
 
     // Blending of two slices, none of which is on final image (i.e. result
     // could be blended on to something else) should be performed with:
@@ -920,27 +2340,22 @@ void Compositor::_mergeBlendImage( void* dest, const eq::PixelViewport& destPVP,
     // because we accumulate light which is go through (= 1-Alpha) and we
     // already have colors as Alpha*Color
 
-    int32_t* destColorStart = destColor + destY*destPVP.w + destX;
-    const uint32_t step = sizeof( int32_t );
-
-#pragma omp parallel for
-    for( int32_t y = 0; y < pvp.h; ++y )
-    {
-        const unsigned char* src =
-            reinterpret_cast< const uint8_t* >( color + pvp.w * y );
-        unsigned char*       dst =
-            reinterpret_cast< uint8_t* >( destColorStart + destPVP.w * y );
+    const detail::PixelKernels* kernels = detail::getPixelKernels(
+        image->getExternalFormat( Frame::BUFFER_COLOR ), 0 );
+    LBASSERT( kernels );
+    if( !kernels )
+        return;
 
-        for( int32_t x = 0; x < pvp.w; ++x )
-        {
-            dst[0] = LB_MIN( src[0] + (src[3]*dst[0] >> 8), 255 );
-            dst[1] = LB_MIN( src[1] + (src[3]*dst[1] >> 8), 255 );
-            dst[2] = LB_MIN( src[2] + (src[3]*dst[2] >> 8), 255 );
-            dst[3] =                   src[3]*dst[3] >> 8;
+    const size_t pixelSize = kernels->colorSize;
 
-            src += step;
-            dst += step;
-        }
+    const int32_t begin = std::max( yBegin, destY );
+    const int32_t end = std::min( yEnd, destY + pvp.h );
+    for( int32_t y = begin; y < end; ++y )
+    {
+        kernels->blend( destColor +
+                            ( size_t( y ) * destPVP.w + destX ) * pixelSize,
+                        color + size_t( pvp.w ) * ( y - destY ) * pixelSize,
+                        pvp.w );
     }
 }
 
@@ -1110,15 +2525,6 @@ void Compositor::assembleFrame( const Frame* frame, Channel* channel )
 
 void Compositor::assembleImage( const Image* image, const ImageOp& op )
 {
-    const bool coreProfile = op.channel->getWindow()->getIAttribute(
-                WindowSettings::IATTR_HINT_CORE_PROFILE ) == ON;
-    if( coreProfile && op.pixel != Pixel::ALL )
-    {
-        LBERROR << "No support for pixel assembly for OpenGL core profile,"
-                   "skipping assemble" << std::endl;
-        return;
-    }
-
     ImageOp operation = op;
     operation.buffers = Frame::BUFFER_NONE;
 
@@ -1170,6 +2576,24 @@ void Compositor::setupStencilBuffer( const Image* image, const ImageOp& op )
     EQ_GL_CALL( glDepthMask( false ));
     EQ_GL_CALL( glColorMask( false, false, false, false ));
 
+    Channel* channel = op.channel; // needed for glewGetContext
+    if( _useGLSL( channel ))
+        _setupStencilBufferGLSL( image, op );
+    else
+        _setupStencilBufferFF( image, op );
+
+    EQ_GL_CALL( glDisable( GL_DEPTH_TEST ));
+    EQ_GL_CALL( glStencilFunc( GL_EQUAL, 0, 1 ));
+    EQ_GL_CALL( glStencilOp( GL_KEEP, GL_KEEP, GL_KEEP ));
+
+    const ColorMask& colorMask = op.channel->getDrawBufferMask();
+    EQ_GL_CALL( glColorMask( colorMask.red, colorMask.green, colorMask.blue,
+                             true ));
+    EQ_GL_CALL( glDepthMask( true ));
+}
+
+void Compositor::_setupStencilBufferFF( const Image* image, const ImageOp& op )
+{
     const PixelViewport& pvp = image->getPixelViewport();
 
     EQ_GL_CALL( glPixelZoom( float( op.pixel.w ), float( op.pixel.h )));
@@ -1215,15 +2639,97 @@ void Compositor::setupStencilBuffer( const Image* image, const ImageOp& op )
         }
         glEnd();
     }
+}
 
-    EQ_GL_CALL( glDisable( GL_DEPTH_TEST ));
-    EQ_GL_CALL( glStencilFunc( GL_EQUAL, 0, 1 ));
-    EQ_GL_CALL( glStencilOp( GL_KEEP, GL_KEEP, GL_KEEP ));
+void Compositor::_setupStencilBufferGLSL( const Image* image,
+                                          const ImageOp& op )
+{
+    Channel* channel = op.channel; // needed for glewGetContext
+    util::ObjectManager& om = channel->getObjectManager();
+    GLuint program = om.getProgram( shaderStencilKey );
+    if( program == util::ObjectManager::INVALID )
+    {
+        program = om.newProgram( shaderStencilKey );
 
-    const ColorMask& colorMask = op.channel->getDrawBufferMask();
-    EQ_GL_CALL( glColorMask( colorMask.red, colorMask.green, colorMask.blue,
-                             true ));
-    EQ_GL_CALL( glDepthMask( true ));
+        // one instance per masked column or row, offset by step
+        const char* vertexShaderGLSL = {
+            "#version 330 core\n"
+            "layout(location = 0) in vec2 corner;\n"
+            "uniform mat4 proj;\n"
+            "uniform vec4 quad;\n"
+            "uniform vec2 step;\n"
+            "void main() {\n"
+            "    vec2 vert = mix( quad.xz, quad.yw, corner ) +\n"
+            "                step * float( gl_InstanceID );\n"
+            "    gl_Position = proj * vec4( vert, 0, 1 );\n"
+            "}\n"
+        };
+
+        const char* fragmentShaderGLSL = {
+            "#version 330 core\n"
+            "void main() {}\n"
+        };
+
+        LBCHECK( util::shader::linkProgram( glewGetContext(), program,
+                                            vertexShaderGLSL,
+                                            fragmentShaderGLSL ));
+    }
+
+    const PixelViewport& pvp = image->getPixelViewport();
+    const eq::Matrix4f& proj = _getAssemblyProjection( channel );
+
+    EQ_GL_CALL( glBindVertexArray( _obtainQuadArray( channel )));
+    EQ_GL_CALL( glUseProgram( program ));
+    EQ_GL_CALL( glUniformMatrix4fv( glGetUniformLocation( program, "proj" ),
+                                    1, GL_FALSE, &proj[0] ));
+    const GLint quad = glGetUniformLocation( program, "quad" );
+    const GLint step = glGetUniformLocation( program, "step" );
+
+    // same masked stripes as the fixed function path
+    if( op.pixel.w > 1 )
+    {
+        const float width  = float( pvp.w * op.pixel.w );
+        const float stepX  = float( op.pixel.w );
+        const float startX = float( op.offset.x() + pvp.x ) + 0.5f -
+                             float( op.pixel.w );
+        const float endX   = startX + width + op.pixel.w + stepX;
+        const float startY = float( op.offset.y() + pvp.y + op.pixel.y );
+        const float endY   = float( startY + pvp.h*op.pixel.h );
+        const float firstX = startX + op.pixel.x + 1.0f;
+
+        GLsizei nColumns = 0;
+        for( float x = firstX; x < endX; x += stepX )
+            ++nColumns;
+
+        EQ_GL_CALL( glUniform4f( quad, firstX - stepX, firstX - 1.0f,
+                                 startY, endY ));
+        EQ_GL_CALL( glUniform2f( step, stepX, 0.f ));
+        EQ_GL_CALL( glDrawArraysInstanced( GL_TRIANGLE_STRIP, 0, 4,
+                                           nColumns ));
+    }
+    if( op.pixel.h > 1 )
+    {
+        const float height = float( pvp.h * op.pixel.h );
+        const float stepY  = float( op.pixel.h );
+        const float startX = float( op.offset.x() + pvp.x + op.pixel.x );
+        const float endX   = float( startX + pvp.w * op.pixel.w );
+        const float startY = float( op.offset.y() + pvp.y ) + 0.5f -
+                             float( op.pixel.h );
+        const float endY   = startY + height + op.pixel.h + stepY;
+        const float firstY = startY + op.pixel.y;
+
+        GLsizei nRows = 0;
+        for( float y = firstY; y < endY; y += stepY )
+            ++nRows;
+
+        EQ_GL_CALL( glUniform4f( quad, startX, endX, firstY - stepY,
+                                 firstY - 1.0f ));
+        EQ_GL_CALL( glUniform2f( step, 0.f, stepY ));
+        EQ_GL_CALL( glDrawArraysInstanced( GL_TRIANGLE_STRIP, 0, 4, nRows ));
+    }
+
+    EQ_GL_CALL( glBindVertexArray( 0 ));
+    EQ_GL_CALL( glUseProgram( 0 ));
 }
 
 void Compositor::clearStencilBuffer( const ImageOp& op )
@@ -1231,7 +2737,9 @@ void Compositor::clearStencilBuffer( const ImageOp& op )
     if( op.pixel == Pixel::ALL )
         return;
 
-    EQ_GL_CALL( glPixelZoom( 1.f, 1.f ));
+    Channel* channel = op.channel; // needed for glewGetContext
+    if( !_useGLSL( channel ))
+        EQ_GL_CALL( glPixelZoom( 1.f, 1.f ));
     EQ_GL_CALL( glDisable( GL_STENCIL_TEST ));
 }
 
@@ -1240,7 +2748,7 @@ void Compositor::assembleImage2D( const Image* image, const ImageOp& op )
     // cppcheck-suppress unreadVariable
     Channel* channel = op.channel;
 
-    if( GLEW_VERSION_3_3 )
+    if( _useGLSL( channel ))
         _drawPixelsGLSL( image, op, Frame::BUFFER_COLOR );
     else
         _drawPixelsFF( image, op, Frame::BUFFER_COLOR );
@@ -1325,15 +2833,15 @@ bool Compositor::_setupDrawPixels( const Image* image, const ImageOp& op,
 {
     Channel* channel = op.channel; // needed for glewGetContext
     const PixelViewport& pvp = image->getPixelViewport();
-    const util::Texture* texture = 0;
-    if( image->getStorageType() == Frame::TYPE_MEMORY )
+    // memory images might have been uploaded during the async assembly
+    const util::Texture* texture = channel->getUploadedTexture( image, which );
+    if( !texture && image->getStorageType() == Frame::TYPE_MEMORY )
     {
         LBASSERT( image->hasPixelData( which ));
         util::ObjectManager& objects = channel->getObjectManager();
 
-        const bool coreProfile = channel->getWindow()->getIAttribute(
-                    WindowSettings::IATTR_HINT_CORE_PROFILE ) == ON;
-        if( op.zoom == Zoom::NONE && !coreProfile )
+        // glDrawPixels is only used by the fixed function path
+        if( op.zoom == Zoom::NONE && !_useGLSL( channel ))
         {
             image->upload( which, 0, op.offset, objects );
             return false;
@@ -1341,12 +2849,19 @@ bool Compositor::_setupDrawPixels( const Image* image, const ImageOp& op,
         util::Texture* ncTexture = objects.obtainEqTexture(
             which == Frame::BUFFER_COLOR ? colorDBKey : depthDBKey,
             GL_TEXTURE_RECTANGLE_ARB );
+        ncTexture->setStreaming( true ); // image sizes vary from frame to frame
         texture = ncTexture;
 
         const Vector2i offset( -pvp.x, -pvp.y ); // will be applied with quad
         image->upload( which, ncTexture, offset, objects );
     }
-    else // texture image
+    else if( !texture && _isPeerImage( image, channel ))
+    {
+        texture = _copyPeerImage( image, which, channel );
+        if( !texture )
+            return false;
+    }
+    else if( !texture ) // texture image
     {
         LBASSERT( image->hasTextureData( which ));
         texture = &image->getTexture( which );
@@ -1384,25 +2899,22 @@ void Compositor::_drawTexturedQuad( const T* key, const ImageOp& op,
     Channel* channel = op.channel; // needed for glewGetContext
     util::ObjectManager& om = channel->getObjectManager();
     GLuint program = om.getProgram( key );
-    GLuint vertexArray = om.getVertexArray( key );
-    GLuint vertexBuffer = om.getBuffer( key );
-    GLuint uvBuffer = om.getBuffer( key + 1 );
     if( program == util::ObjectManager::INVALID )
     {
-        vertexBuffer = om.newBuffer( key );
-        uvBuffer = om.newBuffer( key + 1 );
-        vertexArray = om.newVertexArray( key );
         program = om.newProgram( key );
 
+        // the quad is positioned by uniforms, no per-draw vertex upload
         const char* vertexShaderGLSL = {
             "#version 330 core\n"
-            "layout(location = 0) in vec3 vert;\n"
-            "layout(location = 1) in vec2 vertTexCoord;\n"
+            "layout(location = 0) in vec2 corner;\n"
             "uniform mat4 proj;\n"
+            "uniform vec4 quad;\n"
+            "uniform vec2 texSize;\n"
             "out vec2 fragTexCoord;\n"
             "void main() {\n"
-            "    fragTexCoord = vertTexCoord;\n"
-            "    gl_Position = proj * vec4(vert, 1);\n"
+            "    fragTexCoord = corner * texSize;\n"
+            "    gl_Position = proj * vec4( mix( quad.xz, quad.yw, corner ),\n"
+            "                               0, 1 );\n"
             "}\n"
         };
 
@@ -1444,54 +2956,22 @@ void Compositor::_drawTexturedQuad( const T* key, const ImageOp& op,
     }
 
     const Vector4f& coords = _getCoords( op, pvp );
-    const GLfloat vertices[] = {
-        coords[0], coords[2], 0.0f,
-        coords[1], coords[2], 0.0f,
-        coords[0], coords[3], 0.0f,
-        coords[1], coords[3], 0.0f
-    };
-
-    const GLfloat uvs[] = {
-        0.0f, 0.0f,
-        float( pvp.w ), 0.0f,
-        0.0f, float( pvp.h ),
-        float( pvp.w ), float( pvp.h )
-    };
-
-    eq::Frustumf frustum;
-    frustum.left() = channel->getPixelViewport().x;
-    frustum.right() = channel->getPixelViewport().getXEnd();
-    frustum.bottom() = channel->getPixelViewport().y;
-    frustum.top() = channel->getPixelViewport().getYEnd();
-    frustum.far_plane() = 1.0f;
-    frustum.near_plane() = -1.0f;
-    const eq::Matrix4f& proj = frustum.compute_ortho_matrix();
+    const eq::Matrix4f& proj = _getAssemblyProjection( channel );
 
     if( withDepth )
         EQ_GL_CALL( glEnable( GL_DEPTH_TEST ));
 
-    EQ_GL_CALL( glBindVertexArray( vertexArray ));
+    EQ_GL_CALL( glBindVertexArray( _obtainQuadArray( channel )));
     EQ_GL_CALL( glUseProgram( program ));
 
-    const GLuint projection = glGetUniformLocation( program, "proj" );
-    EQ_GL_CALL( glUniformMatrix4fv( projection, 1, GL_FALSE, &proj[0] ));
-
-    EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, vertexBuffer ));
-    EQ_GL_CALL( glBufferData( GL_ARRAY_BUFFER, sizeof(vertices), vertices,
-                              GL_DYNAMIC_DRAW ));
-    EQ_GL_CALL( glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, 0, 0 ));
+    EQ_GL_CALL( glUniformMatrix4fv( glGetUniformLocation( program, "proj" ),
+                                    1, GL_FALSE, &proj[0] ));
+    EQ_GL_CALL( glUniform4f( glGetUniformLocation( program, "quad" ),
+                             coords[0], coords[1], coords[2], coords[3] ));
+    EQ_GL_CALL( glUniform2f( glGetUniformLocation( program, "texSize" ),
+                             float( pvp.w ), float( pvp.h )));
 
-    EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, uvBuffer ));
-    EQ_GL_CALL( glBufferData( GL_ARRAY_BUFFER, sizeof(uvs), uvs,
-                              GL_DYNAMIC_DRAW ));
-    EQ_GL_CALL( glVertexAttribPointer( 1, 2, GL_FLOAT, GL_FALSE, 0, 0 ));
-    EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, 0 ));
-
-    EQ_GL_CALL( glEnableVertexAttribArray( 0 ));
-    EQ_GL_CALL( glEnableVertexAttribArray( 1 ));
     EQ_GL_CALL( glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 ));
-    EQ_GL_CALL( glDisableVertexAttribArray( 0 ));
-    EQ_GL_CALL( glDisableVertexAttribArray( 1 ));
 
     EQ_GL_CALL( glBindVertexArray( 0 ));
     EQ_GL_CALL( glUseProgram( 0 ));
@@ -1505,7 +2985,7 @@ void Compositor::assembleImageDB( const Image* image, const ImageOp& op )
     // cppcheck-suppress unreadVariable
     Channel* channel = op.channel;
 
-    if( GLEW_VERSION_3_3 )
+    if( _useGLSL( channel ))
         assembleImageDB_GLSL( image, op );
     else
         assembleImageDB_FF( image, op );
@@ -1558,21 +3038,39 @@ void Compositor::assembleImageDB_GLSL( const Image* image, const ImageOp& op )
 
     Channel* channel = op.channel; // needed for glewGetContext
     util::ObjectManager& om = channel->getObjectManager();
-    const bool useImageTexture = image->getStorageType() == Frame::TYPE_TEXTURE;
+    const bool useImageTexture = image->getStorageType() != Frame::TYPE_MEMORY;
 
     const util::Texture* textureColor = 0;
     const util::Texture* textureDepth = 0;
-    if ( useImageTexture )
+    if( _isPeerImage( image, channel ))
+    {
+        textureColor = _copyPeerImage( image, Frame::BUFFER_COLOR, channel );
+        textureDepth = _copyPeerImage( image, Frame::BUFFER_DEPTH, channel );
+        if( !textureColor || !textureDepth )
+            return;
+    }
+    else if ( useImageTexture )
     {
         textureColor = &image->getTexture( Frame::BUFFER_COLOR );
         textureDepth = &image->getTexture( Frame::BUFFER_DEPTH );
     }
+    else if( channel->getUploadedTexture( image, Frame::BUFFER_COLOR ) &&
+             channel->getUploadedTexture( image, Frame::BUFFER_DEPTH ))
+    {
+        // uploaded during the async assembly
+        textureColor = channel->getUploadedTexture( image,
+                                                    Frame::BUFFER_COLOR );
+        textureDepth = channel->getUploadedTexture( image,
+                                                    Frame::BUFFER_DEPTH );
+    }
     else
     {
         util::Texture* ncTextureColor = om.obtainEqTexture( colorDBKey,
                                                      GL_TEXTURE_RECTANGLE_ARB );
         util::Texture* ncTextureDepth = om.obtainEqTexture( depthDBKey,
                                                      GL_TEXTURE_RECTANGLE_ARB );
+        ncTextureColor->setStreaming( true );
+        ncTextureDepth->setStreaming( true );
         const Vector2i offset( -pvp.x, -pvp.y ); // will be applied with quad
 
         image->upload( Frame::BUFFER_COLOR, ncTextureColor, offset, om );
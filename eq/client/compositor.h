@@ -91,6 +91,24 @@ namespace eq
                                               util::Accum* accum,
                                               const bool blendAlpha = false );
 
+        /**
+         * Sort database frames back-to-front for assembleFramesSorted().
+         *
+         * Assumes that the ranges of the frames partition the model along its
+         * z axis, with the range [0, 1] mapping to z in [-1, 1], as done by
+         * slice-based volume renderers. Ranges on each side of the eye are
+         * blended from the farthest to the nearest slab, the slab containing
+         * the eye is blended last.
+         *
+         * @param frames the frames to sort.
+         * @param modelView the model-view matrix used for rendering.
+         * @param orthographic true if an orthographic projection is used.
+         * @version 1.9
+         */
+        static void sortFramesByRange( Frames& frames,
+                                       const Matrix4f& modelView,
+                                       const bool orthographic );
+
         /**
          * Assemble all frames in the order they become available directly on
          * the given channel.
@@ -127,6 +145,73 @@ namespace eq
                                            Channel* channel,
                                            const bool blendAlpha = false );
 
+        /**
+         * Assemble all frames in the given order into the main memory frame
+         * buffer of the given channel.
+         *
+         * The frames are merged as in assembleFramesCPU(). The result is
+         * depth-tested against the frame buffer if both have depth, blended as
+         * in assembleFramesCPU() if blendAlpha is set, and copied otherwise.
+         * The frame buffer has to use the color format of the frames.
+         *
+         * @param frames the frames to assemble.
+         * @param channel the destination channel.
+         * @param blendAlpha blend color-only images if they have an alpha
+         *                   channel
+         * @return the number of different subpixel steps assembled (0 or 1).
+         * @sa Channel::getPixelData()
+         * @version 1.9
+         */
+        static uint32_t assembleFramesMemory( const Frames& frames,
+                                              Channel* channel,
+                                              const bool blendAlpha = false );
+
+        /**
+         * Assemble all frames in the given order in one draw pass on the given
+         * channel.
+         *
+         * All input images are uploaded into the layers of a color and, for
+         * depth-based assembly, a depth texture array. A single shader pass
+         * over the destination area resolves the depth test, or blends the
+         * images in order as described in assembleFramesCPU(). This avoids
+         * the per-image state setup and overdraw of the other GPU assembly
+         * functions. It is used automatically for eight or more input frames
+         * with memory images of the same format when OpenGL 3.3 is
+         * available, and falls back to the other algorithms otherwise.
+         * Depth-based assembly of more images than one pass can hold is done
+         * in several passes, which are resolved by the depth test.
+         *
+         * @param frames the frames to assemble.
+         * @param channel the destination channel.
+         * @param blendAlpha blend color-only images instead of depth-based
+         *                   assembly
+         * @return the number of different subpixel steps assembled (0 or 1).
+         * @version 1.8
+         */
+        static uint32_t assembleFramesArray( const Frames& frames,
+                                             Channel* channel,
+                                             const bool blendAlpha = false );
+
+        /**
+         * Blend all frames in the given order using the CPU, merging frames
+         * in the order they become available.
+         *
+         * Each arriving frame is blended with its adjacent, already merged
+         * neighbors, building a merge tree over the frame sequence. A slow
+         * input frame therefore only delays the merges which depend on it. The
+         * result is the same as blending the frames in order as described in
+         * assembleFramesCPU(). Used by assembleFramesSorted() for alpha
+         * blending if not all frames are ready. Falls back to in-order GPU
+         * assembly if an image can't be blended on the CPU.
+         *
+         * @param frames the frames to assemble.
+         * @param channel the destination channel.
+         * @return the number of different subpixel steps assembled (0 or 1).
+         * @version 1.8
+         */
+        static uint32_t assembleFramesBlendTree( const Frames& frames,
+                                                 Channel* channel );
+
         /**
          * Merge the provided frames in the given order into one image in main
          * memory.
@@ -274,6 +359,11 @@ namespace eq
         static bool _isSubPixelDecomposition( const Frames& frames );
         static const Frames _extractOneSubPixel( Frames& frames );
 
+        /** Average all sub pixel steps on the CPU and assemble the result. */
+        static uint32_t _assembleSubPixelCPU( const Frames& frames,
+                                              Channel* channel,
+                                              bool blendAlpha );
+
         static bool _collectOutputData(
                              const Frames& frames,
                              PixelViewport& destPVP,
@@ -297,18 +387,24 @@ namespace eq
 
         static void _mergeDBImage( void* destColor, void* destDepth,
                                    const PixelViewport& destPVP,
-                                   const Image* image,
-                                   const Vector2i& offset );
+                                   const Image* image, const ImageOp& op,
+                                   int32_t yBegin, int32_t yEnd );
 
         static void _merge2DImage( void* destColor, void* destDepth,
                                    const PixelViewport& destPVP,
-                                   const Image* input,
-                                   const Vector2i& offset );
+                                   const Image* input, const ImageOp& op,
+                                   int32_t yBegin, int32_t yEnd );
+
+        static void _mergeZoomedImage( void* destColor, void* destDepth,
+                                       const PixelViewport& destPVP,
+                                       const Image* input, const ImageOp& op,
+                                       int32_t yBegin, int32_t yEnd );
 
         static void _mergeBlendImage( void* dest,
                                       const PixelViewport& destPVP,
                                       const Image* input,
-                                      const Vector2i& offset );
+                                      const Vector2i& offset,
+                                      int32_t yBegin, int32_t yEnd );
         static bool _mergeImage_PC( int operation, void* destColor,
                                     void* destDepth, const Image* source );
         /**
@@ -326,6 +422,11 @@ namespace eq
         static Vector4f _getCoords( const ImageOp& op,
                                     const PixelViewport& pvp );
 
+        static void _setupStencilBufferFF( const Image* image,
+                                           const ImageOp& op );
+        static void _setupStencilBufferGLSL( const Image* image,
+                                             const ImageOp& op );
+
         template< typename T >
         static void _drawTexturedQuad( const T* key,const ImageOp& op,
                                        const PixelViewport& pvp,
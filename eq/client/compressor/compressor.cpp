@@ -68,6 +68,16 @@ Compressor::Functions::Functions( const unsigned name_,
         , isCompatible( isCompatible_ )
 {}
 
+void Compressor::compressImage( const void* const inData,
+                                const eq_uint64_t inDims[4],
+                                const eq_uint64_t flags )
+{
+    const bool useAlpha = !(flags & EQ_COMPRESSOR_IGNORE_ALPHA);
+    const eq_uint64_t nPixels = (flags & EQ_COMPRESSOR_DATA_1D) ?
+                                  inDims[1]: inDims[1] * inDims[3];
+    compress( inData, nPixels, useAlpha );
+}
+
 void Compressor::registerEngine( const Compressor::Functions& functions )
 {
     if( !_functions ) // resolve 'static initialization order fiasco'
@@ -120,13 +130,9 @@ void EqCompressorCompress( void* const ptr, const unsigned /*name*/,
                            const eq_uint64_t flags )
 {
     assert( ptr );
-    const bool useAlpha = !(flags & EQ_COMPRESSOR_IGNORE_ALPHA);
-    const eq_uint64_t nPixels = (flags & EQ_COMPRESSOR_DATA_1D) ?
-                                  inDims[1]: inDims[1] * inDims[3];
-
     eq::plugin::Compressor* compressor =
         reinterpret_cast< eq::plugin::Compressor* >( ptr );
-    compressor->compress( in, nPixels, useAlpha );
+    compressor->compressImage( in, inDims, flags );
 }
 
 unsigned EqCompressorGetNumResults( void* const ptr,
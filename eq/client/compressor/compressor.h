@@ -73,6 +73,20 @@ namespace plugin
                                const eq_uint64_t nPixels LB_UNUSED,
                                const bool useAlpha LB_UNUSED ) { LBDONTCALL; }
 
+        /**
+         * Compress two-dimensional data.
+         *
+         * The default implementation calls compress() with the number of
+         * pixels given by the dimensions.
+         *
+         * @param inData data to compress.
+         * @param inDims the dimensions of the input data (x, w, y, h).
+         * @param flags capability flags for the compression.
+         */
+        virtual void compressImage( const void* const inData,
+                                    const eq_uint64_t inDims[4],
+                                    const eq_uint64_t flags );
+
         typedef lunchbox::Bufferb Result;
         typedef std::vector< Result* > Results;
 
@@ -0,0 +1,344 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "compressorDXT.h"
+
+#include <eq/util/frameBufferObject.h>
+#include <eq/util/texture.h>
+#include <eq/client/zoomFilter.h>
+#include <eq/fabric/pixelViewport.h>
+
+#include "dxt1readback_glsl.h"
+
+#define glewGetContext() glewContext
+
+namespace eq
+{
+namespace plugin
+{
+namespace
+{
+static void _getInfo( EqCompressorInfo* const info )
+{
+    info->version         = EQ_COMPRESSOR_VERSION;
+    info->name            = EQ_COMPRESSOR_TRANSFER_RGBA_TO_DXT1;
+    info->capabilities    = EQ_COMPRESSOR_TRANSFER | EQ_COMPRESSOR_DATA_2D |
+                            EQ_COMPRESSOR_IGNORE_ALPHA |
+                            EQ_COMPRESSOR_USE_TEXTURE_RECT |
+                            EQ_COMPRESSOR_USE_FRAMEBUFFER;
+    info->tokenType       = EQ_COMPRESSOR_DATATYPE_RGBA;
+    info->outputTokenType = EQ_COMPRESSOR_DATATYPE_DXT1;
+    info->outputTokenSize = 4;
+    info->quality         = 0.3f;
+    info->ratio           = 0.125f;
+    info->speed           = 0.4f;
+}
+
+static bool _register()
+{
+    Compressor::registerEngine(
+        Compressor::Functions( EQ_COMPRESSOR_TRANSFER_RGBA_TO_DXT1,
+                               _getInfo, CompressorDXT::getNewCompressor,
+                               CompressorDXT::getNewDecompressor, 0,
+                               CompressorDXT::isCompatible ));
+    return true;
+}
+
+static bool _initialized LB_UNUSED = _register();
+
+inline eq_uint64_t _getBlocks( const eq_uint64_t pixels )
+{
+    return ( pixels + 3 ) / 4;
+}
+}
+
+CompressorDXT::CompressorDXT()
+    : Compressor()
+    , _program( 0 )
+    , _fbo( 0 )
+    , _texture( 0 )
+    , _blocks( 0 )
+    , _glewContext( 0 )
+{}
+
+CompressorDXT::~CompressorDXT()
+{
+    delete _fbo;
+    _fbo = 0;
+
+    if( _texture )
+    {
+        _texture->flush();
+        delete _texture;
+    }
+    _texture = 0;
+
+    if( _blocks )
+    {
+        const GLEWContext* glewContext = _glewContext;
+        EQ_GL_CALL( glDeleteTextures( 1, &_blocks ));
+    }
+    _blocks = 0;
+}
+
+bool CompressorDXT::isCompatible( const GLEWContext* glewContext )
+{
+    return ( GLEW_ARB_texture_non_power_of_two &&
+             GLEW_EXT_texture_compression_s3tc &&
+             GLEW_VERSION_2_0 &&
+             GLEW_EXT_framebuffer_object );
+}
+
+void CompressorDXT::_initShader( const GLEWContext* glewContext LB_UNUSED )
+{
+    if( _program )
+    {
+        EQ_GL_CALL( glUseProgram( _program ));
+        return;
+    }
+
+    const GLuint shader = glCreateShader( GL_FRAGMENT_SHADER );
+    const char* source = dxt1readback_glsl.c_str();
+    EQ_GL_CALL( glShaderSource( shader, 1, &source, 0 ));
+    EQ_GL_CALL( glCompileShader( shader ));
+
+    GLint status;
+    glGetShaderiv( shader, GL_COMPILE_STATUS, &status );
+    LBASSERT( status );
+
+    _program = glCreateProgram();
+    EQ_GL_CALL( glAttachShader( _program, shader ));
+    EQ_GL_CALL( glLinkProgram( _program ));
+    EQ_GL_CALL( glDeleteShader( shader ));
+
+    glGetProgramiv( _program, GL_LINK_STATUS, &status );
+    LBASSERT( status );
+
+    EQ_GL_CALL( glUseProgram( _program ));
+}
+
+void CompressorDXT::_encode( const GLEWContext* glewContext,
+                             const eq_uint64_t inDims[4],
+                             const eq_uint64_t outDims[4] )
+{
+    GLint oldFBO = 0;
+    glGetIntegerv( GL_FRAMEBUFFER_BINDING_EXT, &oldFBO );
+
+    if( _fbo )
+    {
+        LBCHECK( _fbo->resize( outDims[1], outDims[3] ));
+        _fbo->bind();
+    }
+    else
+    {
+        _fbo = new util::FrameBufferObject( glewContext );
+        LBCHECK( _fbo->init( outDims[1], outDims[3], GL_RGBA, 0, 0 ));
+    }
+
+    _texture->bind();
+    glDisable( GL_LIGHTING );
+    glDisable( GL_DEPTH_TEST );
+    glEnable( GL_TEXTURE_RECTANGLE_ARB );
+    _texture->applyZoomFilter( FILTER_NEAREST );
+    _texture->applyWrap();
+
+    _initShader( glewContext );
+    EQ_GL_CALL( glUniform1i( glGetUniformLocation( _program, "color" ), 0 ));
+    EQ_GL_CALL( glUniform2f( glGetUniformLocation( _program, "size" ),
+                             float( inDims[1] ), float( inDims[3] )));
+
+    // one fragment per output texel, independent of the channel's projection
+    glViewport( 0, 0, GLsizei( outDims[1] ), GLsizei( outDims[3] ));
+    glMatrixMode( GL_PROJECTION );
+    glPushMatrix();
+    glLoadIdentity();
+    glMatrixMode( GL_MODELVIEW );
+    glPushMatrix();
+    glLoadIdentity();
+
+    glBegin( GL_QUADS );
+        glVertex2f( -1.0f, -1.0f );
+        glVertex2f(  1.0f, -1.0f );
+        glVertex2f(  1.0f,  1.0f );
+        glVertex2f( -1.0f,  1.0f );
+    glEnd();
+
+    glPopMatrix();
+    glMatrixMode( GL_PROJECTION );
+    glPopMatrix();
+    glMatrixMode( GL_MODELVIEW );
+
+    glDisable( GL_TEXTURE_RECTANGLE_ARB );
+    EQ_GL_CALL( glUseProgram( 0 ));
+    EQ_GL_CALL( glBindFramebufferEXT( GL_FRAMEBUFFER_EXT, oldFBO ));
+}
+
+void CompressorDXT::download( const GLEWContext* glewContext,
+                              const eq_uint64_t  inDims[4],
+                              const unsigned     source,
+                              const eq_uint64_t  flags,
+                                    eq_uint64_t  outDims[4],
+                              void**             out )
+{
+    glPushAttrib( GL_ENABLE_BIT | GL_DEPTH_BUFFER_BIT | GL_TEXTURE_BIT |
+                  GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT | GL_LIGHTING_BIT |
+                  GL_VIEWPORT_BIT );
+    glColorMask( true, true, true, true );
+
+    // two RGBA tokens per block: the endpoints and the indices
+    outDims[0] = inDims[0];
+    outDims[1] = _getBlocks( inDims[1] ) * 2;
+    outDims[2] = inDims[2];
+    outDims[3] = _getBlocks( inDims[3] );
+    _buffer.resize( outDims[1] * outDims[3] * 4 );
+
+    if( !_texture )
+        _texture = new util::Texture( GL_TEXTURE_RECTANGLE_ARB, glewContext );
+
+    if( flags & EQ_COMPRESSOR_USE_FRAMEBUFFER )
+    {
+        const eq::fabric::PixelViewport pvp( inDims[0], inDims[2],
+                                             inDims[1], inDims[3] );
+        _texture->init( GL_RGBA, inDims[1], inDims[3] );
+        _texture->copyFromFrameBuffer( GL_RGBA, pvp );
+        _encode( glewContext, inDims, outDims );
+    }
+    else if( flags & EQ_COMPRESSOR_USE_TEXTURE_RECT )
+    {
+        _texture->setGLData( source, GL_RGBA, inDims[1], inDims[3] );
+        _encode( glewContext, inDims, outDims );
+        _texture->flushNoDelete();
+    }
+    else
+    {
+        LBUNIMPLEMENTED;
+        out[0] = _buffer.getData();
+        glPopAttrib();
+        return;
+    }
+
+    util::Texture* texture = _fbo->getColorTextures()[0];
+    LBASSERT( texture->getFormat() == GL_RGBA );
+    LBASSERT( texture->getType() == GL_UNSIGNED_BYTE );
+    texture->download( _buffer.getData( ));
+
+    out[0] = _buffer.getData();
+    glPopAttrib();
+}
+
+void CompressorDXT::_decode( const GLEWContext* glewContext,
+                             const void* data,
+                             const eq_uint64_t inDims[4],
+                             const eq_uint64_t outDims[4] )
+{
+    // the token rows are the block rows of the compressed texture
+    const GLsizei width = GLsizei( inDims[1] / 2 * 4 );
+    const GLsizei height = GLsizei( inDims[3] * 4 );
+    const GLsizei size = GLsizei( inDims[1] * inDims[3] * 4 );
+
+    if( !_blocks )
+    {
+        EQ_GL_CALL( glGenTextures( 1, &_blocks ));
+        _glewContext = glewContext;
+    }
+    LBASSERT( _glewContext == glewContext );
+
+    glDepthMask( false );
+    glDisable( GL_LIGHTING );
+    glEnable( GL_TEXTURE_2D );
+    EQ_GL_CALL( glBindTexture( GL_TEXTURE_2D, _blocks ));
+    EQ_GL_CALL( glCompressedTexImage2D( GL_TEXTURE_2D, 0,
+                                        GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+                                        width, height, 0, size, data ));
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+    glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE );
+
+    // the blocks are padded to a multiple of four pixels
+    const float s = float( outDims[1] ) / float( width );
+    const float t = float( outDims[3] ) / float( height );
+    const float startX = static_cast< float >( outDims[0] );
+    const float endX   = static_cast< float >( outDims[1] ) + startX;
+    const float startY = static_cast< float >( outDims[2] );
+    const float endY   = static_cast< float >( outDims[3] ) + startY;
+
+    glColor3f( 1.0f, 1.0f, 1.0f );
+    glBegin( GL_QUADS );
+        glTexCoord2f( 0.0f, 0.0f );
+        glVertex3f( startX, startY, 0.0f );
+        glTexCoord2f( s, 0.0f );
+        glVertex3f(   endX, startY, 0.0f );
+        glTexCoord2f( s, t );
+        glVertex3f(   endX,   endY, 0.0f );
+        glTexCoord2f( 0.0f, t );
+        glVertex3f( startX,   endY, 0.0f );
+    glEnd();
+
+    EQ_GL_CALL( glBindTexture( GL_TEXTURE_2D, 0 ));
+    glDisable( GL_TEXTURE_2D );
+    glDepthMask( true );
+}
+
+void CompressorDXT::upload( const GLEWContext* glewContext,
+                            const void*        data,
+                            const eq_uint64_t  inDims[4],
+                            const eq_uint64_t  flags,
+                            const eq_uint64_t  outDims[4],
+                            const unsigned     destination )
+{
+    glPushAttrib( GL_ENABLE_BIT | GL_DEPTH_BUFFER_BIT | GL_TEXTURE_BIT |
+                  GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT | GL_LIGHTING_BIT );
+
+    if( flags & EQ_COMPRESSOR_USE_FRAMEBUFFER )
+        _decode( glewContext, data, inDims, outDims );
+    else if( flags & EQ_COMPRESSOR_USE_TEXTURE_RECT )
+    {
+        GLint oldFBO = 0;
+        glGetIntegerv( GL_FRAMEBUFFER_BINDING_EXT, &oldFBO );
+
+        if( !_fbo )
+            _fbo = new util::FrameBufferObject( glewContext );
+
+        util::Texture* texture = _fbo->getColorTextures().front();
+        texture->setGLData( destination, GL_RGBA, outDims[1], outDims[3] );
+
+        if( _fbo->isValid( ))
+        {
+            _fbo->bind();
+            texture->bindToFBO( GL_COLOR_ATTACHMENT0, outDims[1], outDims[3] );
+        }
+        else
+        {
+            LBCHECK( _fbo->init( outDims[1], outDims[3], GL_RGBA, 0, 0 ));
+        }
+
+        _decode( glewContext, data, inDims, outDims );
+
+        EQ_GL_CALL( glBindFramebufferEXT( GL_FRAMEBUFFER_EXT, oldFBO ));
+        texture->flushNoDelete();
+    }
+    else
+    {
+        LBASSERT( 0 );
+    }
+    glPopAttrib();
+}
+
+}
+}
@@ -0,0 +1,87 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_PLUGIN_COMPRESSORDXT
+#define EQ_PLUGIN_COMPRESSORDXT
+
+#include "compressor.h"
+
+#include <eq/client/gl.h>
+#include <eq/util/types.h>
+#include <lunchbox/buffer.h>
+
+/** Private transfer plugin name, not yet allocated in compressorTokens.h. */
+#ifndef EQ_COMPRESSOR_TRANSFER_RGBA_TO_DXT1
+#  define EQ_COMPRESSOR_TRANSFER_RGBA_TO_DXT1 0xef000103u
+#endif
+/** Private data type of BC1 blocks, two tokens of four bytes per block. */
+#ifndef EQ_COMPRESSOR_DATATYPE_DXT1
+#  define EQ_COMPRESSOR_DATATYPE_DXT1 0xef000104u
+#endif
+
+namespace eq
+{
+namespace plugin
+{
+/**
+ * Lossy transfer plugin encoding RGB images to BC1 (DXT1) on the GPU.
+ *
+ * The download renders one fragment per half 4x4 block into an RGBA8 FBO,
+ * whose rows are the BC1 block rows, and reads back 4 bits per pixel. The
+ * upload passes the blocks unmodified to a compressed texture and draws it.
+ * Alpha is not transferred, the plugin is only used for images ignoring alpha.
+ */
+class CompressorDXT : public Compressor
+{
+public:
+    CompressorDXT();
+    virtual ~CompressorDXT();
+
+    static void* getNewCompressor( const unsigned )
+        { return new CompressorDXT; }
+    static void* getNewDecompressor( const unsigned )
+        { return new CompressorDXT; }
+
+    virtual void compress( const void* const, const uint64_t, const bool )
+        { LBDONTCALL; }
+
+    static bool isCompatible( const GLEWContext* );
+
+    void download( const GLEWContext*, const eq_uint64_t*, const unsigned,
+                   const eq_uint64_t, eq_uint64_t*, void** ) override;
+
+    void upload( const GLEWContext*, const void*, const eq_uint64_t*,
+                 const eq_uint64_t, const eq_uint64_t*,
+                 const unsigned ) override;
+
+private:
+    void _initShader( const GLEWContext* );
+    void _encode( const GLEWContext*, const eq_uint64_t*, const eq_uint64_t* );
+    void _decode( const GLEWContext*, const void*, const eq_uint64_t*,
+                  const eq_uint64_t* );
+
+    GLuint _program;
+    lunchbox::Bufferb _buffer;
+    util::FrameBufferObject* _fbo;
+    util::Texture* _texture; //!< the source image of the download
+    GLuint _blocks; //!< the compressed texture of the upload
+    const GLEWContext* _glewContext; //!< the context of the blocks texture
+};
+
+}
+}
+#endif // EQ_PLUGIN_COMPRESSORDXT
@@ -0,0 +1,376 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "compressorDepth.h"
+
+#include <lunchbox/log.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace eq
+{
+namespace plugin
+{
+namespace detail
+{
+/** How the significant bits of the depth values are stored. */
+enum Coding
+{
+    CODING_32,        //!< all 32 bits
+    CODING_24_SCALED, //!< 24 bit, expanded by normalized conversion
+    CODING_24_REPEAT, //!< 24 bit, expanded by bit replication
+    CODING_16_REPEAT  //!< 16 bit, expanded by bit replication
+};
+
+/** Leads each result, describing one band of rows. */
+struct Header
+{
+    uint32_t width;
+    uint32_t height; //!< The rows of this band
+    uint32_t coding;
+    uint32_t size;   //!< The size of the coded data following the header
+};
+
+static const uint32_t _farPlane = 0xffffffffu;
+
+// rows per band, chosen to give each thread several bands of common images
+static const uint32_t _bandRows = 64;
+
+inline uint32_t _expandScaled( const uint32_t value )
+{
+    // round( value * ( 2^32 - 1 ) / ( 2^24 - 1 )), with 2^24 - 1 = 255 * 65793
+    return ( value << 8 ) + ( value + 32896 ) / 65793;
+}
+
+inline uint32_t _expandRepeat( const uint32_t value )
+{
+    return ( value << 8 ) | ( value >> 16 );
+}
+
+/** Expands 16 bit depth, the same as the normalized conversion of GL. */
+inline uint32_t _expandRepeat16( const uint32_t value )
+{
+    return ( value << 16 ) | value;
+}
+
+inline uint32_t _expand( const uint32_t value, const uint32_t coding )
+{
+    switch( coding )
+    {
+    case CODING_24_SCALED: return _expandScaled( value );
+    case CODING_24_REPEAT: return _expandRepeat( value );
+    case CODING_16_REPEAT: return _expandRepeat16( value );
+    default:               return value;
+    }
+}
+
+/** @return the coding storing all depth values of the band losslessly. */
+Coding _getCoding( const uint32_t* depth, const size_t nPixels )
+{
+    bool repeat16 = true;
+    bool scaled = true;
+    bool repeat = true;
+    for( size_t i = 0; i < nPixels && ( repeat16 || scaled || repeat ); ++i )
+    {
+        const uint32_t value = depth[i];
+        if( value == _farPlane )
+            continue;
+        repeat16 = repeat16 && _expandRepeat16( value >> 16 ) == value;
+        scaled = scaled && _expandScaled( value >> 8 ) == value;
+        repeat = repeat && _expandRepeat( value >> 8 ) == value;
+    }
+    if( repeat16 )
+        return CODING_16_REPEAT;
+    if( scaled )
+        return CODING_24_SCALED;
+    return repeat ? CODING_24_REPEAT : CODING_32;
+}
+
+/** @return the number of insignificant low bits of the coding. */
+inline uint32_t _getShift( const uint32_t coding )
+{
+    switch( coding )
+    {
+    case CODING_32:        return 0;
+    case CODING_16_REPEAT: return 16;
+    default:               return 8;
+    }
+}
+
+/** The planar prediction of a pixel from its coded neighbors. */
+class Predictor
+{
+public:
+    Predictor( const uint32_t shift )
+        : _shift( shift )
+        , _max( int64_t( _farPlane >> shift ))
+        , _last( 0 )
+    {}
+
+    uint32_t operator()( const uint32_t* row, const uint32_t* up,
+                         const size_t x ) const
+    {
+        const bool hasLeft = x > 0 && row[ x - 1 ] != _farPlane;
+        const bool hasUp = up && up[x] != _farPlane;
+        if( hasLeft && hasUp && up[ x - 1 ] != _farPlane )
+        {
+            const int64_t plane = int64_t( row[ x - 1 ] >> _shift ) +
+                                  int64_t( up[x] >> _shift ) -
+                                  int64_t( up[ x - 1 ] >> _shift );
+            return uint32_t( std::min( std::max( plane, int64_t( 0 )),
+                                       _max ));
+        }
+        if( hasLeft )
+            return row[ x - 1 ] >> _shift;
+        if( hasUp )
+            return up[x] >> _shift;
+        return _last;
+    }
+
+    void update( const uint32_t value ) { _last = value; }
+
+private:
+    const uint32_t _shift;
+    const int64_t _max;
+    uint32_t _last;
+};
+
+inline uint8_t* _writeVarint( uint8_t* out, uint64_t value )
+{
+    while( value >= 0x80 )
+    {
+        *out++ = uint8_t( value | 0x80 );
+        value >>= 7;
+    }
+    *out++ = uint8_t( value );
+    return out;
+}
+
+inline const uint8_t* _readVarint( const uint8_t* in, const uint8_t* end,
+                                   uint64_t& value )
+{
+    value = 0;
+    for( unsigned shift = 0; in < end && shift < 64; shift += 7 )
+    {
+        const uint8_t byte = *in++;
+        value |= uint64_t( byte & 0x7f ) << shift;
+        if( !( byte & 0x80 ))
+            return in;
+    }
+    return 0;
+}
+
+/** Code one band of rows, returns the end of the coded data. */
+uint8_t* _compressBand( const uint32_t* depth, const uint32_t width,
+                        const uint32_t height, const uint32_t coding,
+                        uint8_t* out )
+{
+    const uint32_t shift = _getShift( coding );
+    const size_t nPixels = size_t( width ) * height;
+    Predictor predict( shift );
+
+    // alternating runs of far plane and foreground pixels, in row order
+    size_t i = 0;
+    while( i < nPixels )
+    {
+        size_t end = i;
+        while( end < nPixels && depth[ end ] == _farPlane )
+            ++end;
+        out = _writeVarint( out, end - i );
+        i = end;
+
+        while( end < nPixels && depth[ end ] != _farPlane )
+            ++end;
+        out = _writeVarint( out, end - i );
+
+        for( ; i < end; ++i )
+        {
+            const size_t x = i % width;
+            const size_t y = i / width;
+            const uint32_t* row = depth + y * width;
+            const uint32_t* up = y > 0 ? row - width : 0;
+            const uint32_t value = depth[i] >> shift;
+            const int64_t residual = int64_t( value ) -
+                                     int64_t( predict( row, up, x ));
+            out = _writeVarint( out, ( uint64_t( residual ) << 1 ) ^
+                                     uint64_t( residual >> 63 ));
+            predict.update( value );
+        }
+    }
+    return out;
+}
+
+/** Decode one band of rows, returns false on corrupt data. */
+bool _decompressBand( const uint8_t* in, const uint8_t* inEnd,
+                      const uint32_t width, const uint32_t height,
+                      const uint32_t coding, uint32_t* depth )
+{
+    const uint32_t shift = _getShift( coding );
+    const size_t nPixels = size_t( width ) * height;
+    Predictor predict( shift );
+
+    size_t i = 0;
+    while( i < nPixels )
+    {
+        uint64_t background = 0;
+        uint64_t foreground = 0;
+        in = _readVarint( in, inEnd, background );
+        if( in )
+            in = _readVarint( in, inEnd, foreground );
+        if( !in || background + foreground > nPixels - i )
+            return false;
+
+        std::fill( depth + i, depth + i + background, _farPlane );
+        i += background;
+
+        const size_t end = i + foreground;
+        for( ; i < end; ++i )
+        {
+            uint64_t code = 0;
+            in = _readVarint( in, inEnd, code );
+            if( !in )
+                return false;
+
+            const size_t x = i % width;
+            const size_t y = i / width;
+            const uint32_t* row = depth + y * width;
+            const uint32_t* up = y > 0 ? row - width : 0;
+            const int64_t residual = int64_t( code >> 1 ) ^
+                                     -int64_t( code & 1 );
+            const uint32_t value = uint32_t( int64_t( predict( row, up, x )) +
+                                             residual );
+            depth[i] = _expand( value, coding );
+            predict.update( value );
+        }
+    }
+    return true;
+}
+}
+
+namespace
+{
+void _getInfo( EqCompressorInfo* const info )
+{
+    info->version         = EQ_COMPRESSOR_VERSION;
+    info->name            = EQ_COMPRESSOR_DEPTH_PLANE;
+    info->capabilities    = EQ_COMPRESSOR_DATA_2D;
+    info->tokenType       = EQ_COMPRESSOR_DATATYPE_DEPTH_UNSIGNED_INT;
+    info->quality         = 1.0f;
+    info->ratio           = 0.15f;
+    info->speed           = 0.8f;
+}
+
+static bool _register()
+{
+    Compressor::registerEngine(
+        Compressor::Functions( EQ_COMPRESSOR_DEPTH_PLANE, _getInfo,
+                               CompressorDepth::getNewCompressor,
+                               CompressorDepth::getNewDecompressor,
+                               CompressorDepth::decompress, 0 ));
+    return true;
+}
+
+static bool _initialized LB_UNUSED = _register();
+}
+
+void CompressorDepth::compressImage( const void* const inData,
+                                     const eq_uint64_t inDims[4],
+                                     const eq_uint64_t flags LB_UNUSED )
+{
+    LBASSERT( !( flags & EQ_COMPRESSOR_DATA_1D ));
+
+    const uint32_t* depth = static_cast< const uint32_t* >( inData );
+    const uint32_t width = uint32_t( inDims[1] );
+    const uint32_t height = uint32_t( inDims[3] );
+    const int nBands = int(( height + detail::_bandRows - 1 ) /
+                           detail::_bandRows );
+
+    while( _results.size() < size_t( nBands ))
+        _results.push_back( new Result );
+    _nResults = unsigned( nBands );
+
+#pragma omp parallel for schedule( dynamic )
+    for( int i = 0; i < nBands; ++i )
+    {
+        const uint32_t begin = uint32_t( i ) * detail::_bandRows;
+        const uint32_t rows = std::min( detail::_bandRows, height - begin );
+        const uint32_t* band = depth + size_t( begin ) * width;
+        const size_t nPixels = size_t( width ) * rows;
+
+        // worst case: a ten byte residual per pixel and one run per pixel
+        Result* result = _results[i];
+        const size_t maxSize = sizeof( detail::Header ) + nPixels * 12 + 20;
+        result->reserve( maxSize );
+
+        detail::Header header = { width, rows,
+                                  detail::_getCoding( band, nPixels ), 0 };
+        uint8_t* data = result->getData() + sizeof( header );
+        const uint8_t* end = detail::_compressBand( band, width, rows,
+                                                    header.coding, data );
+        header.size = uint32_t( end - data );
+        ::memcpy( result->getData(), &header, sizeof( header ));
+        result->setSize( sizeof( header ) + header.size );
+    }
+}
+
+void CompressorDepth::decompress( const void* const* inData,
+                                  const eq_uint64_t* const inSizes,
+                                  const unsigned nInputs, void* const outData,
+                                  const eq_uint64_t nPixels, const bool )
+{
+    // find the first row of each band
+    std::vector< size_t > offsets( nInputs + 1, 0 );
+    for( unsigned i = 0; i < nInputs; ++i )
+    {
+        detail::Header header;
+        if( inSizes[i] < sizeof( header ))
+        {
+            LBERROR << "Invalid plane depth compressed image" << std::endl;
+            return;
+        }
+        ::memcpy( &header, inData[i], sizeof( header ));
+        offsets[ i + 1 ] = offsets[i] + size_t( header.width ) * header.height;
+    }
+    LBASSERT( offsets.back() == nPixels );
+    if( offsets.back() > nPixels )
+    {
+        LBERROR << "Plane depth compressed image larger than output"
+                << std::endl;
+        return;
+    }
+
+    uint32_t* depth = static_cast< uint32_t* >( outData );
+#pragma omp parallel for schedule( dynamic )
+    for( int i = 0; i < int( nInputs ); ++i )
+    {
+        detail::Header header;
+        ::memcpy( &header, inData[i], sizeof( header ));
+        const uint8_t* in = static_cast< const uint8_t* >( inData[i] ) +
+                            sizeof( header );
+        const uint8_t* end = in + std::min( uint64_t( header.size ),
+                                            inSizes[i] - sizeof( header ));
+        if( !detail::_decompressBand( in, end, header.width, header.height,
+                                      header.coding, depth + offsets[i] ))
+        {
+            LBWARN << "Corrupt plane depth compressed band" << std::endl;
+        }
+    }
+}
+
+}
+}
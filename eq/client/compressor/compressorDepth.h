@@ -0,0 +1,64 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_PLUGIN_COMPRESSORDEPTH
+#define EQ_PLUGIN_COMPRESSORDEPTH
+
+#include "compressor.h"
+
+/** Private compressor name, not yet allocated in compressorTokens.h. */
+#ifndef EQ_COMPRESSOR_DEPTH_PLANE
+#  define EQ_COMPRESSOR_DEPTH_PLANE 0xef000102u
+#endif
+
+namespace eq
+{
+namespace plugin
+{
+/**
+ * Lossless compressor for unsigned int depth images of sort-last compositing.
+ *
+ * Runs of far plane pixels are stored as their length only. Other pixels are
+ * predicted from their left, upper and upper left neighbors, which is exact
+ * for the planar depth of rasterized triangles, and the residuals are stored
+ * as variable-length integers. Depth values converted from a 24 bit depth
+ * buffer are coded in 24 bit, discarding the stencil and conversion bits, and
+ * values of a 16 bit readback are coded in 16 bit.
+ * Bands of rows are coded in parallel, one result per band.
+ */
+class CompressorDepth : public Compressor
+{
+public:
+    CompressorDepth() {}
+    virtual ~CompressorDepth() {}
+
+    static void* getNewCompressor( const unsigned )
+        { return new CompressorDepth; }
+    static void* getNewDecompressor( const unsigned ) { return 0; }
+
+    void compressImage( const void* const inData, const eq_uint64_t inDims[4],
+                        const eq_uint64_t flags ) override;
+
+    static void decompress( const void* const* inData,
+                            const eq_uint64_t* const inSizes,
+                            const unsigned nInputs, void* const outData,
+                            const eq_uint64_t nPixels, const bool useAlpha );
+};
+
+}
+}
+#endif // EQ_PLUGIN_COMPRESSORDEPTH
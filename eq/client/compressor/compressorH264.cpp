@@ -0,0 +1,497 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "compressorH264.h"
+
+#ifdef EQUALIZER_USE_LIBAVCODEC
+
+#include <lunchbox/log.h>
+#include <lunchbox/perThread.h>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavutil/opt.h>
+#include <libswscale/swscale.h>
+}
+
+#include <algorithm>
+#include <cstring>
+
+namespace eq
+{
+namespace plugin
+{
+namespace detail
+{
+enum Source
+{
+    SOURCE_RGBA,
+    SOURCE_BGRA,
+    SOURCE_ALPHA
+};
+
+/** Leads the first result, describing the encoded image. */
+struct Header
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t source; //!< Source of the color frame
+    uint32_t raw;    //!< 1 if the pixels are stored uncompressed
+};
+
+static AVPixelFormat _getFormat( const Source source )
+{
+    return source == SOURCE_RGBA ? AV_PIX_FMT_RGBA : AV_PIX_FMT_BGRA;
+}
+
+/** Encodes the color or alpha channel of images into single intra frames. */
+class H264Encoder
+{
+public:
+    H264Encoder()
+        : _context( 0 ), _frame( 0 ), _packet( 0 ), _sws( 0 ), _pts( 0 ) {}
+    ~H264Encoder() { _close(); }
+
+    /** Encode one image, appending the bitstream to the result. */
+    bool encode( const uint8_t* data, const int width, const int height,
+                 const Source source, lunchbox::Bufferb& result )
+    {
+        if( !_open( width, height ) || av_frame_make_writable( _frame ) < 0 )
+            return false;
+
+        if( source == SOURCE_ALPHA )
+            _fillAlpha( data, width, height );
+        else
+        {
+            _sws = sws_getCachedContext( _sws, width, height,
+                                         _getFormat( source ), width, height,
+                                         AV_PIX_FMT_YUV420P,
+                                         SWS_FAST_BILINEAR, 0, 0, 0 );
+            if( !_sws )
+                return false;
+
+            const uint8_t* const src[1] = { data };
+            const int stride[1] = { width * 4 };
+            sws_scale( _sws, src, stride, 0, height, _frame->data,
+                       _frame->linesize );
+        }
+
+        _frame->pts = _pts++;
+        if( avcodec_send_frame( _context, _frame ) < 0 )
+            return false;
+
+        bool drained = false;
+        int ret = avcodec_receive_packet( _context, _packet );
+        if( ret == AVERROR( EAGAIN )) // encoder delays output, drain it
+        {
+            avcodec_send_frame( _context, 0 );
+            ret = avcodec_receive_packet( _context, _packet );
+            drained = true;
+        }
+
+        if( ret == 0 )
+        {
+            result.append( _packet->data, _packet->size );
+            av_packet_unref( _packet );
+        }
+        if( drained ) // a drained encoder can't be reused
+            _close();
+        return ret == 0;
+    }
+
+private:
+    AVCodecContext* _context;
+    AVFrame* _frame;
+    AVPacket* _packet;
+    SwsContext* _sws;
+    int64_t _pts;
+
+    bool _open( const int width, const int height )
+    {
+        // H.264 needs even dimensions, the padding is cropped on decode
+        const int w = ( width + 1 ) & ~1;
+        const int h = ( height + 1 ) & ~1;
+        if( _context && _context->width == w && _context->height == h )
+            return true;
+
+        _close();
+
+        static const char* const encoders[] = { "h264_nvenc", "libx264" };
+        for( size_t i = 0; i < 2 && !_context; ++i )
+        {
+            const AVCodec* codec = avcodec_find_encoder_by_name( encoders[i] );
+            if( !codec )
+                continue;
+
+            _context = avcodec_alloc_context3( codec );
+            _context->width = w;
+            _context->height = h;
+            _context->pix_fmt = AV_PIX_FMT_YUV420P;
+            _context->time_base = av_make_q( 1, 60 );
+            _context->gop_size = 1; // intra only
+            _context->max_b_frames = 0;
+            _context->flags |= AV_CODEC_FLAG_LOW_DELAY;
+
+            if( i == 0 )
+            {
+                av_opt_set( _context->priv_data, "preset", "p1", 0 );
+                av_opt_set( _context->priv_data, "tune", "ull", 0 );
+                av_opt_set( _context->priv_data, "zerolatency", "1", 0 );
+                av_opt_set( _context->priv_data, "delay", "0", 0 );
+            }
+            else
+            {
+                av_opt_set( _context->priv_data, "preset", "ultrafast", 0 );
+                av_opt_set( _context->priv_data, "tune", "zerolatency", 0 );
+            }
+
+            if( avcodec_open2( _context, codec, 0 ) < 0 )
+            {
+                avcodec_free_context( &_context );
+                continue;
+            }
+
+            static bool reported = false;
+            if( !reported )
+            {
+                LBINFO << "Using " << encoders[i]
+                       << " for H.264 image compression" << std::endl;
+                reported = true;
+            }
+        }
+
+        if( !_context )
+        {
+            LBWARN << "No H.264 encoder available" << std::endl;
+            return false;
+        }
+
+        _frame = av_frame_alloc();
+        _frame->format = AV_PIX_FMT_YUV420P;
+        _frame->width = w;
+        _frame->height = h;
+        _packet = av_packet_alloc();
+        if( av_frame_get_buffer( _frame, 0 ) < 0 )
+        {
+            _close();
+            return false;
+        }
+
+        // The padding column and row stay black
+        for( int i = 0; i < 3; ++i )
+        {
+            const int rows = i == 0 ? h : h / 2;
+            ::memset( _frame->data[i], i == 0 ? 0 : 128,
+                      size_t( _frame->linesize[i] ) * rows );
+        }
+        return true;
+    }
+
+    void _close()
+    {
+        avcodec_free_context( &_context );
+        av_frame_free( &_frame );
+        av_packet_free( &_packet );
+        sws_freeContext( _sws );
+        _sws = 0;
+    }
+
+    /** Put the alpha channel into the luma plane. */
+    void _fillAlpha( const uint8_t* data, const int width, const int height )
+    {
+        for( int y = 0; y < height; ++y )
+        {
+            const uint8_t* in = data + size_t( y ) * width * 4 + 3;
+            uint8_t* out = _frame->data[0] + size_t( y ) * _frame->linesize[0];
+            for( int x = 0; x < width; ++x, in += 4 )
+                out[x] = *in;
+        }
+    }
+};
+
+/** Decodes intra frames into the color or alpha channel of an image. */
+class H264Decoder
+{
+public:
+    H264Decoder() : _context( 0 ), _frame( av_frame_alloc( ))
+                  , _packet( av_packet_alloc( )), _sws( 0 ) {}
+
+    ~H264Decoder()
+    {
+        avcodec_free_context( &_context );
+        av_frame_free( &_frame );
+        av_packet_free( &_packet );
+        sws_freeContext( _sws );
+    }
+
+    bool decode( const void* data, const uint64_t size, const int width,
+                 const int height, const Source target, uint8_t* out )
+    {
+        if( !_open( ))
+            return false;
+
+        // libavcodec reads past the end of the input
+        _input.resize( size + AV_INPUT_BUFFER_PADDING_SIZE );
+        ::memcpy( _input.getData(), data, size );
+        ::memset( _input.getData() + size, 0, AV_INPUT_BUFFER_PADDING_SIZE );
+        _packet->data = _input.getData();
+        _packet->size = int( size );
+
+        int ret = avcodec_send_packet( _context, _packet );
+        if( ret == 0 )
+        {
+            ret = avcodec_receive_frame( _context, _frame );
+            if( ret == AVERROR( EAGAIN )) // decoder delays output, drain it
+            {
+                avcodec_send_packet( _context, 0 );
+                ret = avcodec_receive_frame( _context, _frame );
+            }
+        }
+        avcodec_flush_buffers( _context );
+        if( ret < 0 )
+            return false;
+
+        bool good = true;
+        if( target == SOURCE_ALPHA )
+        {
+            for( int y = 0; y < height; ++y )
+            {
+                const uint8_t* in = _frame->data[0] +
+                                    size_t( y ) * _frame->linesize[0];
+                uint8_t* pixel = out + size_t( y ) * width * 4 + 3;
+                for( int x = 0; x < width; ++x, pixel += 4 )
+                    *pixel = in[x];
+            }
+        }
+        else
+        {
+            _sws = sws_getCachedContext( _sws, width, height,
+                                         AVPixelFormat( _frame->format ),
+                                         width, height, _getFormat( target ),
+                                         SWS_FAST_BILINEAR, 0, 0, 0 );
+            if( _sws )
+            {
+                uint8_t* const dst[1] = { out };
+                const int stride[1] = { width * 4 };
+                sws_scale( _sws, _frame->data, _frame->linesize, 0, height,
+                           dst, stride );
+            }
+            else
+                good = false;
+        }
+        av_frame_unref( _frame );
+        return good;
+    }
+
+private:
+    AVCodecContext* _context;
+    AVFrame* _frame;
+    AVPacket* _packet;
+    SwsContext* _sws;
+    lunchbox::Bufferb _input;
+
+    bool _open()
+    {
+        if( _context )
+            return true;
+
+        const AVCodec* codec = avcodec_find_decoder( AV_CODEC_ID_H264 );
+        if( !codec )
+            return false;
+
+        _context = avcodec_alloc_context3( codec );
+        _context->flags |= AV_CODEC_FLAG_LOW_DELAY;
+        if( avcodec_open2( _context, codec, 0 ) == 0 )
+            return true;
+
+        avcodec_free_context( &_context );
+        return false;
+    }
+};
+}
+
+namespace
+{
+lunchbox::PerThread< detail::H264Decoder > _decoders;
+
+detail::H264Decoder& _getDecoder()
+{
+    if( !_decoders.get( ))
+        _decoders = new detail::H264Decoder;
+    return *_decoders.get();
+}
+
+void _getInfo( EqCompressorInfo* const info, const unsigned name,
+               const unsigned tokenType )
+{
+    info->version         = EQ_COMPRESSOR_VERSION;
+    info->name            = name;
+    info->capabilities    = EQ_COMPRESSOR_DATA_2D;
+    info->tokenType       = tokenType;
+    info->quality         = 0.7f;
+    info->ratio           = 0.05f;
+    info->speed           = 0.5f;
+}
+
+void _getInfoRGBA( EqCompressorInfo* const info )
+{
+    _getInfo( info, EQ_COMPRESSOR_H264_RGBA, EQ_COMPRESSOR_DATATYPE_RGBA );
+}
+
+void _getInfoBGRA( EqCompressorInfo* const info )
+{
+    _getInfo( info, EQ_COMPRESSOR_H264_BGRA, EQ_COMPRESSOR_DATATYPE_BGRA );
+}
+
+bool _register()
+{
+#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT( 58, 9, 100 )
+    avcodec_register_all();
+#endif
+    if( !avcodec_find_decoder( AV_CODEC_ID_H264 ) ||
+        ( !avcodec_find_encoder_by_name( "h264_nvenc" ) &&
+          !avcodec_find_encoder_by_name( "libx264" )))
+    {
+        return false;
+    }
+
+    Compressor::registerEngine(
+        Compressor::Functions( EQ_COMPRESSOR_H264_RGBA, _getInfoRGBA,
+                               CompressorH264::getNewCompressor,
+                               CompressorH264::getNewDecompressor,
+                               CompressorH264::decompress, 0 ));
+    Compressor::registerEngine(
+        Compressor::Functions( EQ_COMPRESSOR_H264_BGRA, _getInfoBGRA,
+                               CompressorH264::getNewCompressor,
+                               CompressorH264::getNewDecompressor,
+                               CompressorH264::decompress, 0 ));
+    return true;
+}
+
+static bool _initialized LB_UNUSED = _register();
+}
+
+CompressorH264::CompressorH264( const unsigned name )
+    : Compressor()
+    , _name( name )
+    , _color( 0 )
+    , _alpha( 0 )
+{}
+
+CompressorH264::~CompressorH264()
+{
+    delete _color;
+    delete _alpha;
+}
+
+Compressor::Result* CompressorH264::_getResult( const unsigned index )
+{
+    while( _results.size() <= index )
+        _results.push_back( new Result );
+    _results[ index ]->setSize( 0 );
+    return _results[ index ];
+}
+
+void CompressorH264::compressImage( const void* const inData,
+                                    const eq_uint64_t inDims[4],
+                                    const eq_uint64_t flags )
+{
+    LBASSERT( !( flags & EQ_COMPRESSOR_DATA_1D ));
+    const uint8_t* data = static_cast< const uint8_t* >( inData );
+    const int width = int( inDims[1] );
+    const int height = int( inDims[3] );
+    const detail::Source source = _name == EQ_COMPRESSOR_H264_RGBA ?
+                                      detail::SOURCE_RGBA : detail::SOURCE_BGRA;
+    detail::Header header = { uint32_t( width ), uint32_t( height ),
+                              uint32_t( source ), 0 };
+
+    Result* color = _getResult( 0 );
+    color->append( reinterpret_cast< const uint8_t* >( &header ),
+                   sizeof( header ));
+    _nResults = 1;
+
+    if( !_color )
+        _color = new detail::H264Encoder;
+    bool good = _color->encode( data, width, height, source, *color );
+
+    if( good && !( flags & EQ_COMPRESSOR_IGNORE_ALPHA ))
+    {
+        if( !_alpha )
+            _alpha = new detail::H264Encoder;
+        good = _alpha->encode( data, width, height, detail::SOURCE_ALPHA,
+                               *_getResult( 1 ));
+        _nResults = 2;
+    }
+    if( good )
+        return;
+
+    // no usable encoder, store the pixels
+    header.raw = 1;
+    color->setSize( 0 );
+    color->append( reinterpret_cast< const uint8_t* >( &header ),
+                   sizeof( header ));
+    color->append( data, uint64_t( width ) * height * 4 );
+    _nResults = 1;
+}
+
+void CompressorH264::decompress( const void* const* inData,
+                                 const eq_uint64_t* const inSizes,
+                                 const unsigned nInputs, void* const outData,
+                                 const eq_uint64_t nPixels,
+                                 const bool useAlpha )
+{
+    if( nInputs == 0 || inSizes[0] < sizeof( detail::Header ))
+    {
+        LBERROR << "Invalid H.264 compressed image" << std::endl;
+        return;
+    }
+
+    detail::Header header;
+    ::memcpy( &header, inData[0], sizeof( header ));
+    LBASSERT( uint64_t( header.width ) * header.height == nPixels );
+
+    const uint8_t* color = static_cast< const uint8_t* >( inData[0] ) +
+                           sizeof( header );
+    const uint64_t colorSize = inSizes[0] - sizeof( header );
+    uint8_t* out = static_cast< uint8_t* >( outData );
+    if( header.raw )
+    {
+        ::memcpy( out, color, std::min( colorSize, nPixels * 4 ));
+        return;
+    }
+
+    detail::H264Decoder& decoder = _getDecoder();
+    const int width = int( header.width );
+    const int height = int( header.height );
+    if( !decoder.decode( color, colorSize, width, height,
+                         detail::Source( header.source ), out ))
+    {
+        LBWARN << "H.264 color decoding failed" << std::endl;
+    }
+
+    if( useAlpha && nInputs > 1 &&
+        !decoder.decode( inData[1], inSizes[1], width, height,
+                         detail::SOURCE_ALPHA, out ))
+    {
+        LBWARN << "H.264 alpha decoding failed" << std::endl;
+    }
+}
+
+}
+}
+#endif // EQUALIZER_USE_LIBAVCODEC
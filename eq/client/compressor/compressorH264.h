@@ -0,0 +1,74 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQ_PLUGIN_COMPRESSORH264
+#define EQ_PLUGIN_COMPRESSORH264
+
+#include "compressor.h"
+
+#ifdef EQUALIZER_USE_LIBAVCODEC
+
+/** Private compressor names, not yet allocated in compressorTokens.h. */
+#ifndef EQ_COMPRESSOR_H264_RGBA
+#  define EQ_COMPRESSOR_H264_RGBA 0xef000100u
+#  define EQ_COMPRESSOR_H264_BGRA 0xef000101u
+#endif
+
+namespace eq
+{
+namespace plugin
+{
+namespace detail { class H264Encoder; }
+
+/**
+ * Lossy H.264 compressor for 8 bit RGBA and BGRA images using libavcodec.
+ *
+ * The hardware encoder (NVENC) is used if available, x264 otherwise. Each
+ * image is encoded as one intra frame, since images are decompressed
+ * independently of each other. A used alpha channel is encoded as a second,
+ * gray frame.
+ */
+class CompressorH264 : public Compressor
+{
+public:
+    explicit CompressorH264( const unsigned name );
+    virtual ~CompressorH264();
+
+    static void* getNewCompressor( const unsigned name )
+        { return new CompressorH264( name ); }
+    static void* getNewDecompressor( const unsigned ) { return 0; }
+
+    void compressImage( const void* const inData, const eq_uint64_t inDims[4],
+                        const eq_uint64_t flags ) override;
+
+    static void decompress( const void* const* inData,
+                            const eq_uint64_t* const inSizes,
+                            const unsigned nInputs, void* const outData,
+                            const eq_uint64_t nPixels, const bool useAlpha );
+
+private:
+    const unsigned _name;
+    detail::H264Encoder* _color;
+    detail::H264Encoder* _alpha;
+
+    Result* _getResult( const unsigned index );
+};
+
+}
+}
+#endif // EQUALIZER_USE_LIBAVCODEC
+#endif // EQ_PLUGIN_COMPRESSORH264
@@ -24,6 +24,8 @@
 #include <eq/util/pixelBufferObject.h>
 #include <lunchbox/buffer.h>
 
+#include <cstdlib>
+
 #define glewGetContext() glewContext
 
 namespace eq
@@ -36,6 +38,19 @@ namespace
 int _warned = 0;
 static stde::hash_map< unsigned, unsigned > _depths;
 
+/** @return the number of PBOs allocated up-front for async readback. */
+size_t _getPBORingSize()
+{
+    static size_t size = 0;
+    if( size == 0 )
+    {
+        const char* env = getenv( "EQ_READBACK_PBOS" );
+        const int value = env ? atoi( env ) : 0;
+        size = value > 0 ? size_t( value ) : 2;
+    }
+    return size;
+}
+
 #define REGISTER_TRANSFER( in, out, size, quality_, ratio_, speed_, alpha ) \
     static void _getInfo ## in ## out( EqCompressorInfo* const info )   \
     {                                                                   \
@@ -107,16 +122,43 @@ REGISTER_TRANSFER( RGBA32F, RGB, 3, .25, .25, 1., true );
 REGISTER_TRANSFER( RGBA32F, BGR, 3, .25, .25, 1.1, true );
 
 REGISTER_TRANSFER( DEPTH, DEPTH_UNSIGNED_INT, 4, 1., 1., 1., false );
+
+// Depth read back in 16 bit, used for a depth quality below one. The output
+// stays unsigned int, so all compositors and compressors handle it unchanged.
+static void _getInfoDEPTH16( EqCompressorInfo* const info )
+{
+    _getInfoDEPTHDEPTH_UNSIGNED_INT( info );
+    info->quality = .5f;
+    info->ratio   = .5f;
+    info->speed   = 1.5f;
+    info->name    = EQ_COMPRESSOR_TRANSFER_DEPTH_TO_DEPTH_UNSIGNED_INT_16;
+}
+
+static bool _registerDEPTH16()
+{
+    const unsigned name = EQ_COMPRESSOR_TRANSFER_DEPTH_TO_DEPTH_UNSIGNED_INT_16;
+    Compressor::registerEngine(
+        Compressor::Functions( name, _getInfoDEPTH16,
+                               CompressorReadDrawPixels::getNewCompressor,
+                               CompressorReadDrawPixels::getNewDecompressor,
+                               0, CompressorReadDrawPixels::isCompatible ));
+    _depths[ name ] = 2;
+    return true;
+}
+
+static bool _initializedDEPTH16 LB_UNUSED = _registerDEPTH16();
 }
 
 CompressorReadDrawPixels::CompressorReadDrawPixels( const unsigned name )
         : Compressor()
         , _texture( 0 )
-        , _pbo( 0 )
+        , _nextPBO( 0 )
         , _internalFormat( 0 )
         , _format( 0 )
         , _type( 0 )
         , _depth( _depths[ name ] )
+        , _packed( name ==
+                   EQ_COMPRESSOR_TRANSFER_DEPTH_TO_DEPTH_UNSIGNED_INT_16 )
 {
     LBASSERT( _depth > 0 );
     switch( name )
@@ -267,6 +309,11 @@ CompressorReadDrawPixels::CompressorReadDrawPixels( const unsigned name )
             _type = GL_UNSIGNED_INT;
             _internalFormat = GL_DEPTH_COMPONENT;
             break;
+        case EQ_COMPRESSOR_TRANSFER_DEPTH_TO_DEPTH_UNSIGNED_INT_16:
+            _format = GL_DEPTH_COMPONENT;
+            _type = GL_UNSIGNED_SHORT;
+            _internalFormat = GL_DEPTH_COMPONENT;
+            break;
 
         default: LBASSERT( false );
     }
@@ -277,12 +324,25 @@ CompressorReadDrawPixels::~CompressorReadDrawPixels( )
     delete _texture;
     _texture = 0;
 
-    if( _pbo )
+    while( !_pendingRanges.empty( ))
     {
-        _pbo->destroy();
-        delete _pbo;
-        _pbo = 0;
+        _pool->release( _pendingRanges.front( ));
+        _pendingRanges.pop_front();
+    }
+    _pool = 0;
+
+    // Fences of unfinished downloads are not deleted, since no GL context is
+    // available here. They are released with the context.
+    for( size_t i = 0; i < _pbos.size(); ++i )
+    {
+        PBO& pbo = _pbos[i];
+        if( pbo.pbo )
+        {
+            pbo.pbo->destroy();
+            delete pbo.pbo;
+        }
     }
+    _pbos.clear();
 }
 
 bool CompressorReadDrawPixels::isCompatible( const GLEWContext* )
@@ -405,16 +465,15 @@ void CompressorReadDrawPixels::download( const GLEWContext* glewContext,
     {
         EQ_GL_CALL( glReadPixels( inDims[0], inDims[2], inDims[1], inDims[3],
                                   _format, _type, _buffer.getData( )));
-        *out = _buffer.getData();
     }
     else
     {
         _initTexture( glewContext, flags );
         _texture->setGLData( source, _internalFormat, inDims[1], inDims[3] );
         _texture->setExternalFormat( _format, _type );
-        *out = _downloadTexture( glewContext, FLUSH_TEXTURE );
+        _downloadTexture( glewContext, FLUSH_TEXTURE );
     }
-
+    *out = _getResult( inDims );
 }
 
 void CompressorReadDrawPixels::upload( const GLEWContext* glewContext,
@@ -426,10 +485,12 @@ void CompressorReadDrawPixels::upload( const GLEWContext* glewContext,
 {
     _initUnpackAlignment( inDims[1] );
 
+    // uploads get the expanded unsigned int depth of the download
+    const unsigned type = _packed ? GL_UNSIGNED_INT : _type;
     if( flags & EQ_COMPRESSOR_USE_FRAMEBUFFER )
     {
         EQ_GL_CALL( glRasterPos2i( outDims[0], outDims[2] ));
-        EQ_GL_CALL( glDrawPixels( outDims[1], outDims[3], _format, _type,
+        EQ_GL_CALL( glDrawPixels( outDims[1], outDims[3], _format, type,
                     buffer ));
     }
     else
@@ -438,22 +499,43 @@ void CompressorReadDrawPixels::upload( const GLEWContext* glewContext,
         _initTexture( glewContext, flags );
         _texture->setGLData( destination, _internalFormat,
                              outDims[1], outDims[3] );
-        _texture->setExternalFormat( _format, _type );
+        _texture->setExternalFormat( _format, type );
         _texture->upload( outDims[1], outDims[3], buffer );
         _texture->flushNoDelete();
     }
 }
 
-bool CompressorReadDrawPixels::_initPBO( const GLEWContext* glewContext,
-                                         const eq_uint64_t size )
+CompressorReadDrawPixels::PBO*
+CompressorReadDrawPixels::_initPBO( const GLEWContext* glewContext,
+                                    const eq_uint64_t size )
 {
+    if( _pbos.empty( ))
+        _pbos.resize( _getPBORingSize( ));
+
+    // all PBOs are used by unfinished downloads, grow the ring
+    if( _pendingPBOs.size() == _pbos.size( ))
+    {
+        _nextPBO = _pbos.size();
+        _pbos.push_back( PBO( ));
+    }
+    while( _pbos[ _nextPBO ].pending )
+        _nextPBO = ( _nextPBO + 1 ) % _pbos.size();
+
+    PBO& pbo = _pbos[ _nextPBO ];
+    LBASSERT( !pbo.fence );
+
     // create thread-safe PBO
-    if( !_pbo )
-        _pbo = new util::PixelBufferObject( glewContext, true );
+    if( !pbo.pbo )
+        pbo.pbo = new util::PixelBufferObject( glewContext, true );
 
-    const Error error = _pbo->setup( size, GL_READ_ONLY_ARB );
+    const Error error = pbo.pbo->setup( size, GL_READ_ONLY_ARB );
     if( !error )
-        return true;
+    {
+        pbo.pending = true;
+        _pendingPBOs.push_back( _nextPBO );
+        _nextPBO = ( _nextPBO + 1 ) % _pbos.size();
+        return &pbo;
+    }
 
     if( _warned < 10 )
     {
@@ -461,7 +543,34 @@ bool CompressorReadDrawPixels::_initPBO( const GLEWContext* glewContext,
                << std::endl;
         ++_warned;
     }
-    return false;
+    return 0;
+}
+
+bool CompressorReadDrawPixels::_startPoolDownload(
+    const GLEWContext* glewContext, const eq_uint64_t dims[4],
+    const eq_uint64_t size )
+{
+    if( !_pool || _pool->glewGetContext() != glewContext )
+    {
+        if( !_pendingRanges.empty( ))
+            return false;
+        _pool = util::PixelBufferPool::get( glewContext );
+    }
+    if( !_pool )
+        return false;
+
+    const util::PixelBufferPool::Range range = _pool->allocate( size );
+    if( !range.isValid( ))
+        return false;
+
+    EQ_GL_CALL( glBindBufferARB( GL_PIXEL_PACK_BUFFER_ARB, range.name ));
+    EQ_GL_CALL( glReadPixels( dims[0], dims[2], dims[1], dims[3], _format,
+                              _type, (GLvoid*)range.offset ));
+    EQ_GL_CALL( glBindBufferARB( GL_PIXEL_PACK_BUFFER_ARB, 0 ));
+    _pool->fence();
+    glFlush(); // see startDownload()
+    _pendingRanges.push_back( range );
+    return true;
 }
 
 void CompressorReadDrawPixels::startDownload( const GLEWContext* glewContext,
@@ -485,11 +594,19 @@ void CompressorReadDrawPixels::startDownload( const GLEWContext* glewContext,
             return;
         }
 
-        if( _initPBO( glewContext, size ))
+        if( _startPoolDownload( glewContext, dims, size ))
+            return;
+
+        // PBO ring if pools are not supported, see _startPoolDownload()
+        PBO* pbo = _pendingRanges.empty() && !_pool ?
+                       _initPBO( glewContext, size ) : 0;
+        if( pbo )
         {
             EQ_GL_CALL( glReadPixels( dims[0], dims[2], dims[1], dims[3],
                                       _format, _type, 0 ));
-            _pbo->unbind();
+            pbo->pbo->unbind();
+            if( GLEW_ARB_sync )
+                pbo->fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
             glFlush(); // Fixes https://github.com/Eyescale/Equalizer/issues/118
             return;
         }
@@ -520,6 +637,27 @@ void* CompressorReadDrawPixels::_downloadTexture(
     return _buffer.getData();
 }
 
+void* CompressorReadDrawPixels::_getResult( const eq_uint64_t dims[4] )
+{
+    if( !_packed )
+        return _buffer.getData();
+
+    // Expand in place from the back, the same as the normalized conversion of
+    // GL from 16 to 32 bit. Far plane pixels stay at 0xffffffff.
+    const size_t nPixels = dims[1] * dims[3];
+    _buffer.reserve( nPixels * 4 );
+    _buffer.setSize( nPixels * 4 );
+    uint8_t* data = _buffer.getData();
+    for( size_t i = nPixels; i > 0; --i )
+    {
+        uint16_t value;
+        memcpy( &value, data + ( i - 1 ) * 2, 2 );
+        const uint32_t depth = ( uint32_t( value ) << 16 ) | value;
+        memcpy( data + ( i - 1 ) * 4, &depth, 4 );
+    }
+    return data;
+}
+
 void CompressorReadDrawPixels::finishDownload(
     const GLEWContext* glewContext, const eq_uint64_t inDims[4],
     const eq_uint64_t flags, eq_uint64_t outDims[4], void** out )
@@ -529,7 +667,8 @@ void CompressorReadDrawPixels::finishDownload(
 
     if( flags & (EQ_COMPRESSOR_USE_TEXTURE_RECT|EQ_COMPRESSOR_USE_TEXTURE_2D) )
     {
-        *out = _downloadTexture( glewContext, FLUSH_TEXTURE );
+        _downloadTexture( glewContext, FLUSH_TEXTURE );
+        *out = _getResult( inDims );
         return;
     }
 
@@ -538,20 +677,54 @@ void CompressorReadDrawPixels::finishDownload(
     // async RB through texture
     if( !GLEW_ARB_pixel_buffer_object )
     {
-        *out = _downloadTexture( glewContext, KEEP_TEXTURE );
+        _downloadTexture( glewContext, KEEP_TEXTURE );
+        *out = _getResult( inDims );
         return;
     }
 
-    if( _pbo && _pbo->isInitialized( ))
+    if( !_pendingRanges.empty( ))
     {
+        const util::PixelBufferPool::Range range = _pendingRanges.front();
+        _pendingRanges.pop_front();
+
+        const eq_uint64_t size = inDims[1] * inDims[3] * _depth;
+        _resizeBuffer( size );
+
+        // wait for this readback only, not for later ones in the pool
+        if( _pool->wait( range ))
+            memcpy( _buffer.getData(), range.data, size );
+        else
+            LBERROR << "Can't wait for pixel buffer pool readback" << std::endl;
+        _pool->release( range );
+    }
+    else if( !_pendingPBOs.empty( ))
+    {
+        PBO& pbo = _pbos[ _pendingPBOs.front() ];
+        _pendingPBOs.pop_front();
+        pbo.pending = false;
+        LBASSERT( pbo.pbo && pbo.pbo->isInitialized( ));
+
+        if( pbo.fence )
+        {
+            // wait for this readback only, not for later ones in the ring
+            while( glClientWaitSync( pbo.fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                     1000000000ull /* 1s */ ) ==
+                   GL_TIMEOUT_EXPIRED )
+            {
+                LBWARN << "Readback fence not signaled after 1s" << std::endl;
+            }
+            glDeleteSync( pbo.fence );
+            pbo.fence = 0;
+        }
+
         const eq_uint64_t size = inDims[1] * inDims[3] * _depth;
         _resizeBuffer( size );
 
-        const void* ptr = _pbo->mapRead();
+        const void* ptr = pbo.pbo->mapRead();
         if( ptr )
         {
             memcpy( _buffer.getData(), ptr, size );
-            _pbo->unmap();
+            pbo.pbo->unmap();
         }
         else
         {
@@ -559,7 +732,7 @@ void CompressorReadDrawPixels::finishDownload(
             EQ_GL_ERROR( "PixelBufferObject::mapRead()" );
         }
     }
-    *out = _buffer.getData();
+    *out = _getResult( inDims );
 }
 
 }
@@ -21,8 +21,19 @@
 
 #include "compressor.h"
 #include <eq/client/gl.h>
+#include <eq/util/pixelBufferPool.h>
 #include <eq/util/types.h>
 
+#include <deque>
+
+/**
+ * Private transfer name, not yet allocated in compressorTokens.h. Reads back
+ * depth with 16 bit precision and expands it to unsigned int on the CPU.
+ */
+#ifndef EQ_COMPRESSOR_TRANSFER_DEPTH_TO_DEPTH_UNSIGNED_INT_16
+#  define EQ_COMPRESSOR_TRANSFER_DEPTH_TO_DEPTH_UNSIGNED_INT_16 0xef000105u
+#endif
+
 namespace eq
 {
 namespace plugin
@@ -67,20 +78,40 @@ public:
 protected:
     lunchbox::Bufferb _buffer;
     util::Texture*    _texture;
-    util::PixelBufferObject* _pbo;
+
+    /** A ring of PBOs for asynchronous readback. */
+    struct PBO
+    {
+        PBO() : pbo( 0 ), fence( 0 ), pending( false ) {}
+
+        util::PixelBufferObject* pbo;
+        GLsync fence; //!< signaled when the readback into pbo is done
+        bool pending; //!< used by an unfinished download
+    };
+    std::vector< PBO > _pbos;
+    size_t _nextPBO; //!< ring slot used by the next download
+    std::deque< size_t > _pendingPBOs; //!< started downloads, oldest first
+
+    /** The context's pool for async readback, replaces the PBO ring. */
+    util::PixelBufferPoolPtr _pool;
+    std::deque< util::PixelBufferPool::Range > _pendingRanges;
     unsigned    _internalFormat; //!< the GL format
     unsigned    _format;         //!< the GL format
     unsigned    _type;           //!< the GL type
-    const unsigned _depth;       //!< the size of one output token
+    const unsigned _depth;       //!< the size of one transferred token
+    const bool     _packed;      //!< 16 bit depth transfer, expanded to 32
 
     void _resizeBuffer( const eq_uint64_t );
     void _initTexture( const GLEWContext*, const eq_uint64_t );
     void _initAsyncTexture( const GLEWContext*, const eq_uint64_t,
                             const eq_uint64_t );
-    bool _initPBO( const GLEWContext*, const eq_uint64_t );
+    PBO* _initPBO( const GLEWContext*, const eq_uint64_t );
+    bool _startPoolDownload( const GLEWContext*, const eq_uint64_t*,
+                             const eq_uint64_t );
     void _initDownload( const GLEWContext*, const eq_uint64_t*, eq_uint64_t* );
     void* _downloadTexture( const GLEWContext* glewContext,
                             const FlushMode mode );
+    void* _getResult( const eq_uint64_t dims[4] );
 };
 
 }
@@ -0,0 +1,106 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Encodes one half of a BC1 block of 4x4 pixels per fragment: even fragments
+// write the two 565 endpoints, odd fragments the 2 bit indices of the four rows.
+
+uniform sampler2DRect color;
+uniform vec2 size;
+
+vec3 quantize( vec3 c )
+{
+    return floor( c * vec3( 31.0, 63.0, 31.0 ) + 0.5 );
+}
+
+vec3 dequantize( vec3 q )
+{
+    return q / vec3( 31.0, 63.0, 31.0 );
+}
+
+float pack565( vec3 q )
+{
+    return q.r * 2048.0 + q.g * 32.0 + q.b;
+}
+
+vec3 fetch( vec2 origin, float x, float y )
+{
+    vec2 pos = min( origin + vec2( x, y ), size - 1.0 ) + 0.5;
+    return texture2DRect( color, pos ).rgb;
+}
+
+void main(void)
+{
+    vec2 pos = floor( gl_FragCoord.xy );
+    vec2 origin = vec2( floor( pos.x * 0.5 ), pos.y ) * 4.0;
+
+    vec3 minColor = vec3( 1.0 );
+    vec3 maxColor = vec3( 0.0 );
+    for( float y = 0.0; y < 4.0; y += 1.0 )
+        for( float x = 0.0; x < 4.0; x += 1.0 )
+        {
+            vec3 c = fetch( origin, x, y );
+            minColor = min( minColor, c );
+            maxColor = max( maxColor, c );
+        }
+
+    // inset the bounding box to reduce the error of the interpolated colors
+    vec3 inset = ( maxColor - minColor ) / 16.0;
+    vec3 q0 = quantize( maxColor - inset );
+    vec3 q1 = quantize( minColor + inset );
+    float c0 = pack565( q0 );
+    float c1 = pack565( q1 );
+
+    if( fract( pos.x * 0.5 ) < 0.25 )
+    {
+        gl_FragColor = vec4( mod( c0, 256.0 ), floor( c0 / 256.0 ),
+                             mod( c1, 256.0 ), floor( c1 / 256.0 )) / 255.0;
+        return;
+    }
+
+    // palette order of the indices 0..3, c0 > c1 selects four color mode
+    vec3 p0 = dequantize( q0 );
+    vec3 p1 = dequantize( q1 );
+    vec3 p2 = ( 2.0 * p0 + p1 ) / 3.0;
+    vec3 p3 = ( p0 + 2.0 * p1 ) / 3.0;
+
+    vec4 rows = vec4( 0.0 );
+    for( float y = 0.0; y < 4.0; y += 1.0 )
+    {
+        float row = 0.0;
+        float weight = 1.0;
+        for( float x = 0.0; x < 4.0; x += 1.0 )
+        {
+            vec3 c = fetch( origin, x, y );
+            vec4 d = vec4( dot( c - p0, c - p0 ), dot( c - p1, c - p1 ),
+                           dot( c - p2, c - p2 ), dot( c - p3, c - p3 ));
+            float index = 0.0;
+            float best = d.x;
+            if( d.y < best ) { index = 1.0; best = d.y; }
+            if( d.z < best ) { index = 2.0; best = d.z; }
+            if( d.w < best ) { index = 3.0; }
+            if( c0 == c1 )
+                index = 0.0;
+
+            row += index * weight;
+            weight *= 4.0;
+        }
+        if( y < 0.5 )      rows.x = row;
+        else if( y < 1.5 ) rows.y = row;
+        else if( y < 2.5 ) rows.z = row;
+        else               rows.w = row;
+    }
+    gl_FragColor = rows / 255.0;
+}
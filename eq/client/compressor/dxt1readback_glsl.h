@@ -0,0 +1,3 @@
+//Generated file - Edit dxt1readback.glsl!
+#include <string>
+static const std::string dxt1readback_glsl = "/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>\n  *\n  * This library is free software; you can redistribute it and/or modify it under\n  * the terms of the GNU Lesser General Public License version 2.1 as published\n  * by the Free Software Foundation.\n  *\n  * This library is distributed in the hope that it will be useful, but WITHOUT\n  * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS\n  * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more\n  * details.\n  *\n  * You should have received a copy of the GNU Lesser General Public License\n  * along with this library; if not, write to the Free Software Foundation, Inc.,\n  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.\n  */\n \n // Encodes one half of a BC1 block of 4x4 pixels per fragment: even fragments\n // write the two 565 endpoints, odd fragments the 2 bit indices of the four rows.\n \n uniform sampler2DRect color;\n uniform vec2 size;\n \n vec3 quantize( vec3 c )\n {\n     return floor( c * vec3( 31.0, 63.0, 31.0 ) + 0.5 );\n }\n \n vec3 dequantize( vec3 q )\n {\n     return q / vec3( 31.0, 63.0, 31.0 );\n }\n \n float pack565( vec3 q )\n {\n     return q.r * 2048.0 + q.g * 32.0 + q.b;\n }\n \n vec3 fetch( vec2 origin, float x, float y )\n {\n     vec2 pos = min( origin + vec2( x, y ), size - 1.0 ) + 0.5;\n     return texture2DRect( color, pos ).rgb;\n }\n \n void main(void)\n {\n     vec2 pos = floor( gl_FragCoord.xy );\n     vec2 origin = vec2( floor( pos.x * 0.5 ), pos.y ) * 4.0;\n \n     vec3 minColor = vec3( 1.0 );\n     vec3 maxColor = vec3( 0.0 );\n     for( float y = 0.0; y < 4.0; y += 1.0 )\n         for( float x = 0.0; x < 4.0; x += 1.0 )\n         {\n             vec3 c = fetch( origin, x, y );\n             minColor = min( minColor, c );\n             maxColor = max( maxColor, c );\n         }\n \n     // inset the bounding box to reduce the error of the interpolated colors\n     vec3 inset = ( maxColor - minColor ) / 16.0;\n     vec3 q0 = quantize( maxColor - inset );\n     vec3 q1 = quantize( minColor + inset );\n     float c0 = pack565( q0 );\n     float c1 = pack565( q1 );\n \n     if( fract( pos.x * 0.5 ) < 0.25 )\n     {\n         gl_FragColor = vec4( mod( c0, 256.0 ), floor( c0 / 256.0 ),\n                              mod( c1, 256.0 ), floor( c1 / 256.0 )) / 255.0;\n         return;\n     }\n \n     // palette order of the indices 0..3, c0 > c1 selects four color mode\n     vec3 p0 = dequantize( q0 );\n     vec3 p1 = dequantize( q1 );\n     vec3 p2 = ( 2.0 * p0 + p1 ) / 3.0;\n     vec3 p3 = ( p0 + 2.0 * p1 ) / 3.0;\n \n     vec4 rows = vec4( 0.0 );\n     for( float y = 0.0; y < 4.0; y += 1.0 )\n     {\n         float row = 0.0;\n         float weight = 1.0;\n         for( float x = 0.0; x < 4.0; x += 1.0 )\n         {\n             vec3 c = fetch( origin, x, y );\n             vec4 d = vec4( dot( c - p0, c - p0 ), dot( c - p1, c - p1 ),\n                            dot( c - p2, c - p2 ), dot( c - p3, c - p3 ));\n             float index = 0.0;\n             float best = d.x;\n             if( d.y < best ) { index = 1.0; best = d.y; }\n             if( d.z < best ) { index = 2.0; best = d.z; }\n             if( d.w < best ) { index = 3.0; }\n             if( c0 == c1 )\n                 index = 0.0;\n \n             row += index * weight;\n             weight *= 4.0;\n         }\n         if( y < 0.5 )      rows.x = row;\n         else if( y < 1.5 ) rows.y = row;\n         else if( y < 2.5 ) rows.z = row;\n         else               rows.w = row;\n     }\n     gl_FragColor = rows / 255.0;\n }\n \n ";
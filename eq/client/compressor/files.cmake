@@ -3,12 +3,18 @@
 
 set(EQ_COMPRESSOR_SOURCES
   compressor/compressor.cpp
+  compressor/compressorDXT.cpp
+  compressor/compressorDepth.cpp
+  compressor/compressorH264.cpp
   compressor/compressorReadDrawPixels.cpp
   compressor/compressorYUV.cpp
 )
 
 set(EQ_COMPRESSOR_HEADERS
   compressor/compressor.h
+  compressor/compressorDXT.h
+  compressor/compressorDepth.h
+  compressor/compressorH264.h
   compressor/compressorReadDrawPixels.h
   compressor/compressorYUV.h
 )
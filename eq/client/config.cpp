@@ -38,6 +38,7 @@
 #include "window.h"
 
 #include <eq/fabric/commands.h>
+#include <eq/fabric/metricsExporter.h>
 #include <eq/fabric/task.h>
 
 #include <co/exception.h>
@@ -46,11 +47,20 @@
 #include <co/global.h>
 
 #include <lunchbox/clock.h>
+#include <lunchbox/condition.h>
 #include <lunchbox/monitor.h>
+#include <lunchbox/mtQueue.h>
 #include <lunchbox/scopedMutex.h>
 #include <lunchbox/spinLock.h>
+#include <lunchbox/thread.h>
 #include <pression/plugins/compressor.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+
 #ifdef EQUALIZER_USE_GLSTATS
 #  include <GLStats/GLStats.h>
 #else
@@ -96,11 +106,348 @@ enum
     THREAD_ASYNC2,
 };
 }
+
+/** Add a statistic event as an item to the statistics data. */
+void _addItem( GLStats::Data& data, const uint32_t originator,
+               const Statistic& stat )
+{
+    GLStats::Item item;
+    item.entity = originator;
+    item.type = stat.type;
+    item.frame = stat.frameNumber;
+    item.start = stat.startTime;
+    item.end = stat.endTime;
+
+    GLStats::Entity entity;
+    entity.name = stat.resourceName;
+
+    GLStats::Type type;
+    const Vector3f& color = Statistic::getColor( stat.type );
+
+    type.color[0] = color[0];
+    type.color[1] = color[1];
+    type.color[2] = color[2];
+    type.name = Statistic::getName( stat.type );
+
+    switch( stat.type )
+    {
+      case Statistic::CHANNEL_FRAME_COMPRESS:
+      case Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN:
+          type.subgroup = "transmit";
+          item.thread = THREAD_ASYNC2;
+          // no break;
+      case Statistic::CHANNEL_FRAME_WAIT_READY:
+          type.group = "channel";
+          item.layer = 1;
+          break;
+      case Statistic::CHANNEL_CLEAR:
+      case Statistic::CHANNEL_DRAW:
+      case Statistic::CHANNEL_DRAW_FINISH:
+      case Statistic::CHANNEL_ASSEMBLE:
+      case Statistic::CHANNEL_READBACK:
+      case Statistic::CHANNEL_VIEW_FINISH:
+          type.group = "channel";
+          break;
+      case Statistic::CHANNEL_ASYNC_READBACK:
+          type.group = "channel";
+          type.subgroup = "transfer";
+          item.thread = THREAD_ASYNC1;
+          break;
+      case Statistic::CHANNEL_FRAME_TRANSMIT:
+          type.group = "channel";
+          type.subgroup = "transmit";
+          item.thread = THREAD_ASYNC2;
+          break;
+
+      case Statistic::WINDOW_FINISH:
+      case Statistic::WINDOW_THROTTLE_FRAMERATE:
+      case Statistic::WINDOW_SWAP_BARRIER:
+      case Statistic::WINDOW_SWAP:
+          type.group = "window";
+          break;
+      case Statistic::NODE_FRAME_DECOMPRESS:
+          type.group = "node";
+          break;
+
+      case Statistic::CONFIG_WAIT_FINISH_FRAME:
+          item.layer = 1;
+          // no break;
+      case Statistic::CONFIG_START_FRAME:
+      case Statistic::CONFIG_FINISH_FRAME:
+          type.group = "config";
+          break;
+
+      case Statistic::PIPE_IDLE:
+      {
+          const std::string& string = data.getText();
+          const float idle = stat.idleTime * 100ll / stat.totalTime;
+          std::stringstream text;
+          if( string.empty( ))
+              text <<  "Idle: " << stat.resourceName << ' ' << idle << "%";
+          else
+          {
+              const size_t pos = string.find( stat.resourceName );
+
+              if( pos == std::string::npos ) // append new pipe
+                  text << string << ", " << stat.resourceName << ' '
+                       << idle << "%";
+              else // replace existing text
+              {
+                  const std::string& left = string.substr( pos + 1 );
+
+                  text << string.substr( 0, pos ) << stat.resourceName << ' '
+                       << idle << left.substr( left.find( '%' ));
+              }
+          }
+          data.setText( text.str( ));
+      }
+      // no break;
+
+      case Statistic::WINDOW_FPS:
+      case Statistic::CONFIG_INPUT_LATENCY:
+      case Statistic::PIPE_GPU_MEMORY:
+      case Statistic::NODE_IMAGE_POOL:
+      case Statistic::CHANNEL_TILE:
+      case Statistic::NONE:
+      case Statistic::ALL:
+          return;
+    }
+    switch( stat.type )
+    {
+      case Statistic::CHANNEL_FRAME_COMPRESS:
+      case Statistic::CHANNEL_ASYNC_READBACK:
+      case Statistic::CHANNEL_READBACK:
+      {
+          std::stringstream text;
+          text << unsigned( 100.f * stat.ratio ) << '%';
+
+          if( stat.plugins[ 0 ] > EQ_COMPRESSOR_NONE )
+              text << " 0x" << std::hex << stat.plugins[0] << std::dec;
+          if( stat.plugins[ 1 ] > EQ_COMPRESSOR_NONE &&
+              stat.plugins[ 0 ] != stat.plugins[ 1 ] )
+          {
+              text << " 0x" << std::hex << stat.plugins[1] << std::dec;
+          }
+          item.text = text.str();
+          break;
+      }
+      default:
+          break;
+    }
+
+    data.setType( stat.type, type );
+    data.setEntity( originator, entity );
+    data.addItem( item );
+}
 #endif
 }
 
 namespace detail
 {
+#ifdef EQUALIZER_USE_GLSTATS
+/**
+ * Aggregates the statistics events into GLStats::Data in its own thread.
+ *
+ * The receiver and application threads only queue the events. The thread
+ * applies all queued events, copies the result into the back buffer and
+ * swaps it with the front buffer read by getSnapshot().
+ */
+class StatisticsAggregator : public lunchbox::Thread
+{
+public:
+    StatisticsAggregator() : _front( 0 ), _version( 0 ) {}
+
+    ~StatisticsAggregator()
+    {
+        if( !isRunning( ))
+            return;
+        _tasks.push( Task( Task::EXIT ));
+        join();
+    }
+
+    void add( const uint32_t originator, const Statistic& stat )
+        { _push( Task( originator, stat )); }
+
+    /** Drop the statistics of all but the last frames. */
+    void obsolete() { _push( Task( Task::OBSOLETE )); }
+
+    void clear() { _push( Task( Task::CLEAR )); }
+
+    GLStats::Data getSnapshot() const
+    {
+        lunchbox::ScopedFastRead mutex( _lock );
+        return _snapshots[ _front ];
+    }
+
+    /** @return a counter incremented with each new snapshot. */
+    uint64_t getVersion() const
+    {
+        lunchbox::ScopedFastRead mutex( _lock );
+        return _version;
+    }
+
+protected:
+    bool init() override { setName( "Statistics" ); return true; }
+
+    void run() override
+    {
+        for( ;; )
+        {
+            Task task = _tasks.pop();
+            do
+            {
+                switch( task.type )
+                {
+                case Task::ADD:
+                    _addItem( _data, task.originator, task.stat );
+                    break;
+                case Task::OBSOLETE:
+                    _data.obsolete( 2 /* frames to keep */ );
+                    break;
+                case Task::CLEAR:
+                    _data.clear();
+                    break;
+                case Task::EXIT:
+                    return;
+                }
+            }
+            while( _tasks.tryPop( task ));
+
+            // only this thread changes _front, the readers use it locked
+            const unsigned back = 1 - _front;
+            _snapshots[ back ] = _data;
+
+            lunchbox::ScopedFastWrite mutex( _lock );
+            _front = back;
+            ++_version;
+        }
+    }
+
+private:
+    struct Task
+    {
+        enum Type { ADD, OBSOLETE, CLEAR, EXIT };
+
+        Task() : type( EXIT ), originator( 0 ) {}
+        explicit Task( const Type type_ ) : type( type_ ), originator( 0 ) {}
+        Task( const uint32_t originator_, const Statistic& stat_ )
+            : type( ADD ), originator( originator_ ), stat( stat_ ) {}
+
+        Type type;
+        uint32_t originator;
+        Statistic stat;
+    };
+
+    lunchbox::MTQueue< Task > _tasks;
+    lunchbox::Lock _startLock;
+
+    GLStats::Data _data; //!< the aggregate, used only by the thread
+    GLStats::Data _snapshots[2]; //!< front and back buffer
+    unsigned _front;
+    uint64_t _version;
+    mutable lunchbox::SpinLock _lock; //!< protects _front and _version
+
+    void _push( const Task& task )
+    {
+        if( !isRunning( ))
+        {
+            lunchbox::ScopedMutex<> mutex( _startLock );
+            if( !isRunning( ))
+                start();
+        }
+        _tasks.push( task );
+    }
+};
+#endif
+
+/**
+ * Measures the time from input events to the swap of the frames applying them.
+ *
+ * The input events handled before a frame start are assigned to this frame,
+ * which carries the time of the oldest one. The swap statistics of the frame
+ * then yield one latency per window. Event and statistic times are both
+ * taken from the synchronized config clock.
+ */
+class InputLatency
+{
+public:
+    InputLatency() : _inputTime( -1 ) {}
+
+    /** Record an input event to be applied by the next frame. */
+    void addInput( const int64_t time )
+    {
+        lunchbox::ScopedFastWrite mutex( _lock );
+        if( _inputTime < 0 || time < _inputTime )
+            _inputTime = time;
+    }
+
+    /** Assign the pending input events to the given, started frame. */
+    void startFrame( const uint32_t frame )
+    {
+        lunchbox::ScopedFastWrite mutex( _lock );
+        if( _inputTime >= 0 )
+        {
+            _frames[ frame ] = _inputTime;
+            _inputTime = -1;
+        }
+        while( _frames.size() > _maxFrames )
+            _frames.erase( _frames.begin( ));
+    }
+
+    /**
+     * Measure the latency of a swap statistic.
+     * @return true if the swapped frame applied input events.
+     */
+    bool swap( const Statistic& swap, Statistic& latency )
+    {
+        lunchbox::ScopedFastWrite mutex( _lock );
+        const Frames::const_iterator i = _frames.find( swap.frameNumber );
+        if( i == _frames.end() || swap.endTime < i->second )
+            return false;
+
+        latency = swap;
+        latency.type = Statistic::CONFIG_INPUT_LATENCY;
+        latency.startTime = i->second;
+        _latencies.push_back( float( latency.endTime - latency.startTime ));
+        if( _latencies.size() > _maxLatencies )
+            _latencies.pop_front();
+        return true;
+    }
+
+    /** @return the given percentile of the last latencies, in ms. */
+    float getPercentile( const float percentile ) const
+    {
+        std::vector< float > latencies;
+        {
+            lunchbox::ScopedFastRead mutex( _lock );
+            latencies.assign( _latencies.begin(), _latencies.end( ));
+        }
+        if( latencies.empty( ))
+            return 0.f;
+
+        // nearest rank
+        const float rank = std::ceil( std::max( 0.f, percentile ) / 100.f *
+                                      float( latencies.size( )));
+        const size_t index = std::min( latencies.size(),
+                                       std::max( size_t( 1 ), size_t( rank )));
+        const std::vector< float >::iterator nth =
+            latencies.begin() + index - 1;
+        std::nth_element( latencies.begin(), nth, latencies.end( ));
+        return *nth;
+    }
+
+private:
+    static const size_t _maxFrames = 64; //!< frames awaiting their swap
+    static const size_t _maxLatencies = 1024; //!< measurements kept
+
+    typedef std::map< uint32_t, int64_t > Frames;
+
+    mutable lunchbox::SpinLock _lock;
+    int64_t _inputTime; //!< oldest input for the next frame, -1 if none
+    Frames _frames; //!< frame number -> oldest input time
+    std::deque< float > _latencies;
+};
+
 class Config
 {
 public:
@@ -110,12 +457,21 @@ public:
         , unlockedFrame( 0 )
         , finishedFrame( 0 )
         , running( false )
+        , metrics( 0 )
+        , maxAutoLatency( 0 )
+        , interactive( false )
+        , waitTime( 0 )
+        , lastFinishTime( 0 )
+        , autoFrames( 0 )
+        , autoPeriods( 0 )
+        , lowerPeriod( 0 )
     {
         lunchbox::Log::setClock( &clock );
     }
 
     ~Config()
     {
+        delete metrics;
         appNode = 0;
         lunchbox::Log::setClock( 0 );
     }
@@ -132,9 +488,18 @@ public:
     /** The connections configured by the server for this config. */
     co::Connections connections;
 
+    /** @name Received data exchange parts, see receiveExchange(). */
+    //@{
+    typedef std::pair< uint128_t, uint32_t > ExchangeKey;
+    typedef std::vector< co::ICommand > ExchangeParts;
+    typedef std::map< ExchangeKey, ExchangeParts > ExchangeMap;
+    ExchangeMap exchanges;
+    lunchbox::Condition exchangeCondition;
+    //@}
+
 #ifdef EQUALIZER_USE_GLSTATS
     /** Global statistics data. */
-    lunchbox::Lockable< GLStats::Data, lunchbox::SpinLock > statistics;
+    StatisticsAggregator statistics;
 #endif
 
     /** The last started frame. */
@@ -147,6 +512,9 @@ public:
     /** The global clock. */
     lunchbox::Clock clock;
 
+    /** The input to swap latency of the last frames. */
+    InputLatency inputLatency;
+
     std::deque< int64_t > frameTimes; //!< Start time of last frames
 
     /** list of the current latency object */
@@ -160,6 +528,23 @@ public:
 
     /** Errors from last call to update() */
     Errors errors;
+
+    /** The metrics endpoint while IATTR_METRICS_PORT is set. */
+    fabric::MetricsExporter* metrics;
+
+    /** The statistics sampled in HISTOGRAM mode in this process. */
+    fabric::MetricsExporter localMetrics;
+
+    /** @name Automatic latency, see setAutoLatency(). */
+    //@{
+    uint32_t maxAutoLatency; //!< 0 if disabled
+    bool interactive;
+    int64_t waitTime; //!< in finishFrame() during the current period
+    int64_t lastFinishTime;
+    uint32_t autoFrames; //!< finished frames in the current period
+    uint32_t autoPeriods; //!< completed measurement periods
+    uint32_t lowerPeriod; //!< first period which may lower the latency
+    //@}
 };
 }
 
@@ -208,8 +593,10 @@ void Config::attach( const uint128_t& id, const uint32_t instanceID )
                      ConfigFunc( this, &Config::_cmdFrameFinish ), 0 );
     registerCommand( fabric::CMD_CONFIG_EVENT_OLD, ConfigFunc( 0, 0 ),
                      &_impl->eventQueue );
-    registerCommand( fabric::CMD_CONFIG_EVENT, ConfigFunc( 0, 0 ),
-                     &_impl->eventQueue );
+    registerCommand( fabric::CMD_CONFIG_EVENT,
+                     ConfigFunc( this, &Config::_cmdEvent ), 0 );
+    registerCommand( fabric::CMD_CONFIG_EXCHANGE,
+                     ConfigFunc( this, &Config::_cmdExchange ), 0 );
     registerCommand( fabric::CMD_CONFIG_SYNC_CLOCK,
                      ConfigFunc( this, &Config::_cmdSyncClock ), 0 );
     registerCommand( fabric::CMD_CONFIG_SWAP_OBJECT,
@@ -305,9 +692,20 @@ bool Config::init( const uint128_t& initID )
 
     handleEvents();
     if( !_impl->running )
+    {
         LBWARN << "Config initialization failed" << std::endl
                << "    Consult client log for further information" << std::endl;
-    return _impl->running;
+        return false;
+    }
+
+    const int32_t port = getIAttribute( IATTR_METRICS_PORT );
+    if( port > 0 && port <= 0xffff )
+    {
+        if( !_impl->metrics )
+            _impl->metrics = new fabric::MetricsExporter;
+        _impl->metrics->start( uint16_t( port ));
+    }
+    return true;
 }
 
 bool Config::exit()
@@ -335,6 +733,9 @@ bool Config::exit()
     _impl->lastEvent.clear();
     _impl->eventQueue.flush();
     _impl->running = false;
+
+    if( _impl->metrics )
+        _impl->metrics->stop();
     return ret;
 }
 
@@ -379,7 +780,7 @@ bool Config::update()
     const bool result = request.wait();
     client->enableSendOnRegister();
 #ifdef EQUALIZER_USE_GLSTATS
-    _impl->statistics->clear();
+    _impl->statistics.clear();
 #endif
     handleEvents();
     return result;
@@ -395,6 +796,7 @@ uint32_t Config::startFrame( const uint128_t& frameID )
 
     // New frame
     ++_impl->currentFrame;
+    _impl->inputLatency.startFrame( _impl->currentFrame );
     send( getServer(), fabric::CMD_CONFIG_START_FRAME ) << frameID;
 
     LBLOG( LOG_TASKS ) << "---- Started Frame ---- " << _impl->currentFrame
@@ -423,6 +825,7 @@ uint32_t Config::finishFrame()
 
     ConfigStatistics stat( Statistic::CONFIG_FINISH_FRAME, this );
     stat.event.data.statistic.frameNumber = frameToFinish;
+    const int64_t waitStart = _impl->clock.getTime64();
     {
         ConfigStatistics waitStat( Statistic::CONFIG_WAIT_FINISH_FRAME, this );
         waitStat.event.data.statistic.frameNumber = frameToFinish;
@@ -465,10 +868,12 @@ uint32_t Config::finishFrame()
         LBLOG( LOG_TASKS ) << "Global sync " << frameToFinish << " @ "
                            << _impl->currentFrame << std::endl;
     }
+    _impl->waitTime += _impl->clock.getTime64() - waitStart;
 
     handleEvents();
     _updateStatistics();
     _releaseObjects();
+    _adaptLatency();
 
     LBLOG( LOG_TASKS ) << "---- Finished Frame --- " << frameToFinish
                        << " (" << _impl->currentFrame << ')' << std::endl;
@@ -560,6 +965,72 @@ void Config::changeLatency( const uint32_t latency )
     accept( changeLatencyVisitor );
 }
 
+void Config::setAutoLatency( const uint32_t maxLatency )
+{
+    _impl->maxAutoLatency = maxLatency;
+    _impl->waitTime = 0;
+    _impl->autoFrames = 0;
+    _impl->lastFinishTime = _impl->clock.getTime64();
+}
+
+void Config::setInteractive( const bool interactive )
+{
+    if( _impl->interactive == interactive )
+        return;
+
+    _impl->interactive = interactive;
+    if( _impl->maxAutoLatency == 0 )
+        return;
+
+    setLatency( interactive ? 0 : _impl->maxAutoLatency );
+    setAutoLatency( _impl->maxAutoLatency ); // restart measurement
+}
+
+namespace
+{
+/** Frames measured before the automatic latency is adapted. */
+static const uint32_t _autoLatencyPeriod = 32;
+
+/** Periods after raising the latency before probing a lower one again. */
+static const uint32_t _autoLatencyHold = 16;
+}
+
+void Config::_adaptLatency()
+{
+    if( _impl->maxAutoLatency == 0 || _impl->interactive ||
+        ++_impl->autoFrames < _autoLatencyPeriod )
+    {
+        return;
+    }
+
+    // Raise latency while the application waits for the rendering, and lower
+    // it while overlapping frames does not reduce the wait.
+    const int64_t now = _impl->clock.getTime64();
+    const int64_t totalTime = now - _impl->lastFinishTime;
+    const float waitRatio = totalTime > 0 ?
+                            float( _impl->waitTime ) / float( totalTime ) : 0.f;
+    const uint32_t latency = getLatency();
+    ++_impl->autoPeriods;
+
+    if( waitRatio > .1f && latency < _impl->maxAutoLatency )
+    {
+        setLatency( latency + 1 );
+        // the lower latency stalled, don't bounce back right away
+        _impl->lowerPeriod = _impl->autoPeriods + _autoLatencyHold;
+    }
+    else if( waitRatio < .01f && latency > 0 &&
+             _impl->autoPeriods >= _impl->lowerPeriod )
+    {
+        setLatency( latency - 1 );
+    }
+
+    if( latency != getLatency( ))
+        LBLOG( LOG_TASKS ) << "Waited " << int( waitRatio * 100.f )
+                           << "% of the time, latency now " << getLatency()
+                           << std::endl;
+    setAutoLatency( _impl->maxAutoLatency );
+}
+
 void Config::sendEvent( ConfigEvent& event )
 {
     LBASSERT( event.data.type != Event::STATISTIC ||
@@ -625,6 +1096,73 @@ EventOCommand Config::sendError( const uint32_t type, const Error& error )
     return Super::sendError( getApplicationNode(), type, error );
 }
 
+bool Config::sendExchange( const co::NodeID& nodeID,
+                           const uint128_t& exchangeID, const uint32_t sequence,
+                           const uint64_t offset, const void* data,
+                           const uint64_t size )
+{
+    co::NodePtr node = getLocalNode()->connect( nodeID );
+    if( !node )
+    {
+        LBWARN << "Can't connect node " << nodeID << " for data exchange"
+               << std::endl;
+        return false;
+    }
+
+    send( node, fabric::CMD_CONFIG_EXCHANGE )
+        << exchangeID << sequence << offset << size
+        << co::Array< void >( const_cast< void* >( data ), size );
+    return true;
+}
+
+bool Config::receiveExchange( const uint128_t& exchangeID,
+                              const uint32_t sequence, const size_t nParts,
+                              void* buffer, const uint64_t size,
+                              const uint32_t timeout )
+{
+    const detail::Config::ExchangeKey key( exchangeID, sequence );
+    detail::Config::ExchangeParts parts;
+    lunchbox::Condition& condition = _impl->exchangeCondition;
+
+    condition.lock();
+    for( ;; )
+    {
+        detail::Config::ExchangeMap::iterator i = _impl->exchanges.find( key );
+        if( i != _impl->exchanges.end() && i->second.size() >= nParts )
+        {
+            parts.swap( i->second );
+            _impl->exchanges.erase( i );
+            break;
+        }
+        if( !condition.timedWait( timeout ))
+        {
+            condition.unlock();
+            LBWARN << "Timeout receiving data exchange " << exchangeID
+                   << " round " << sequence << std::endl;
+            return false;
+        }
+    }
+    condition.unlock();
+
+    uint8_t* const data = static_cast< uint8_t* >( buffer );
+    for( detail::Config::ExchangeParts::iterator i = parts.begin();
+         i != parts.end(); ++i )
+    {
+        co::ObjectICommand command( *i );
+        command.read< uint128_t >(); // exchangeID
+        command.read< uint32_t >(); // sequence
+        const uint64_t offset = command.read< uint64_t >();
+        const uint64_t partSize = command.read< uint64_t >();
+
+        LBASSERTINFO( offset + partSize <= size,
+                      offset << "+" << partSize << " > " << size );
+        if( offset + partSize > size )
+            continue;
+        command >> co::Array< void >( data + offset, partSize );
+    }
+    return true;
+}
+
 Errors Config::getErrors()
 {
     Errors errors;
@@ -665,16 +1203,146 @@ bool Config::checkEvent() const
     return !_impl->eventQueue.isEmpty();
 }
 
+namespace
+{
+bool _isCoalescable( const uint32_t type )
+{
+    switch( type )
+    {
+    case Event::CHANNEL_POINTER_MOTION:
+    case Event::WINDOW_POINTER_MOTION:
+    case Event::WINDOW_RESIZE:
+    case Event::CHANNEL_RESIZE:
+    case Event::VIEW_RESIZE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool _isInput( const uint32_t type )
+{
+    switch( type )
+    {
+    case Event::CHANNEL_POINTER_MOTION:
+    case Event::CHANNEL_POINTER_BUTTON_PRESS:
+    case Event::CHANNEL_POINTER_BUTTON_RELEASE:
+#ifndef EQ_USE_DEPRECATED
+    case Event::CHANNEL_POINTER_WHEEL:
+#endif
+    case Event::WINDOW_POINTER_WHEEL:
+    case Event::WINDOW_POINTER_MOTION:
+    case Event::WINDOW_POINTER_BUTTON_PRESS:
+    case Event::WINDOW_POINTER_BUTTON_RELEASE:
+    case Event::KEY_PRESS:
+    case Event::KEY_RELEASE:
+    case Event::MAGELLAN_AXIS:
+    case Event::MAGELLAN_BUTTON:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/** A dequeued event command, or the last of several coalesced events. */
+struct PendingEvent
+{
+    explicit PendingEvent( const co::ICommand& command_ )
+        : command( command_ ), coalesced( false ) {}
+
+    co::ICommand command;
+    ConfigEvent event; //!< the old event of the command, if any
+    bool coalesced;
+};
+typedef std::vector< PendingEvent > PendingEvents;
+
+/** Copy the old event of the command, for plain ConfigEvents only. */
+bool _readConfigEvent( const co::ICommand& command, ConfigEvent& event )
+{
+    if( command.getCommand() != fabric::CMD_CONFIG_EVENT_OLD )
+        return false;
+
+    co::ObjectICommand copy( command );
+    const uint64_t size = copy.read< uint64_t >();
+    if( size != sizeof( ConfigEvent )) // application-specific subclass
+        return false;
+
+    ::memcpy( &event, copy.getRemainingBuffer( size ), size );
+    return true;
+}
+
+void _coalesce( PendingEvent& pending, const ConfigEvent& next )
+{
+    Event& event = pending.event.data;
+    if( event.type == Event::CHANNEL_POINTER_MOTION ||
+        event.type == Event::WINDOW_POINTER_MOTION )
+    {
+        const int32_t dx = event.pointerMotion.dx + next.data.pointerMotion.dx;
+        const int32_t dy = event.pointerMotion.dy + next.data.pointerMotion.dy;
+        event = next.data;
+        event.pointerMotion.dx = dx;
+        event.pointerMotion.dy = dy;
+    }
+    else
+        event = next.data;
+    pending.coalesced = true;
+}
+}
+
 void Config::handleEvents()
 {
-    for( ;; )
+    handleEvents( std::numeric_limits< size_t >::max( ));
+}
+
+size_t Config::handleEvents( const size_t budget )
+{
+    // originator -> index of its last coalescable event
+    typedef std::map< uint128_t, size_t > Coalescables;
+    Coalescables coalescables;
+    PendingEvents events;
+    size_t nEvents = 0;
+
+    for( ; nEvents < budget; ++nEvents )
     {
-        EventICommand event = getNextEvent( 0 );
-        if( !event.isValid( ))
+        const co::ICommand command = getNextEvent( 0 );
+        if( !command.isValid( ))
             break;
 
-        handleEvent( event );
+        ConfigEvent event;
+        const bool isConfigEvent = _readConfigEvent( command, event );
+        if( isConfigEvent && _isInput( event.data.type ))
+            _impl->inputLatency.addInput( event.data.time );
+
+        if( !isConfigEvent || !_isCoalescable( event.data.type ))
+        {
+            // keep the order of coalesced events to all other events
+            coalescables.clear();
+            events.push_back( PendingEvent( command ));
+            continue;
+        }
+
+        const uint128_t& originator = event.data.originator;
+        Coalescables::const_iterator i = coalescables.find( originator );
+        if( i != coalescables.end() &&
+            events[ i->second ].event.data.type == event.data.type )
+        {
+            _coalesce( events[ i->second ], event );
+            continue;
+        }
+
+        coalescables[ originator ] = events.size();
+        events.push_back( PendingEvent( command ));
+        events.back().event = event;
+    }
+
+    for( PendingEvents::iterator i = events.begin(); i != events.end(); ++i )
+    {
+        if( i->coalesced )
+            handleEvent( &i->event );
+        else
+            handleEvent( EventICommand( i->command ));
     }
+    return nEvents;
 }
 
 bool Config::_handleNewEvent( EventICommand& command )
@@ -710,6 +1378,20 @@ bool Config::_handleNewEvent( EventICommand& command )
         _impl->errors.push_back( error );
         return false;
     }
+
+    case Event::STATISTIC: // batch of statistics from one pipe
+    {
+        const std::vector< uint32_t >& serials =
+            command.read< std::vector< uint32_t > >();
+        const Statistics& statistics = command.read< Statistics >();
+        LBASSERT( serials.size() == statistics.size( ));
+        for( size_t i = 0; i < statistics.size(); ++i )
+        {
+            LBLOG( LOG_STATS ) << statistics[i] << std::endl;
+            addStatistic( serials[i], statistics[i] );
+        }
+        return false;
+    }
     }
     return false;
 }
@@ -759,9 +1441,20 @@ bool Config::_handleEvent( const Event& event )
     return false;
 }
 
-void Config::addStatistic( const uint32_t originator LB_UNUSED,
-                           const Statistic& stat LB_UNUSED )
+void Config::addStatistic( const uint32_t originator,
+                           const Statistic& stat )
 {
+    if( _impl->metrics )
+        _impl->metrics->add( stat );
+
+    if( stat.type == Statistic::WINDOW_SWAP ||
+        stat.type == Statistic::WINDOW_SWAP_BARRIER )
+    {
+        Statistic latency;
+        if( _impl->inputLatency.swap( stat, latency ))
+            addStatistic( originator, latency );
+    }
+
 #ifdef EQUALIZER_USE_GLSTATS
     const uint32_t frame = stat.frameNumber;
     LBASSERT( stat.type != Statistic::NONE );
@@ -770,131 +1463,20 @@ void Config::addStatistic( const uint32_t originator LB_UNUSED,
     if( frame == 0 || stat.type == Statistic::NONE )
         return;
 
-    lunchbox::ScopedFastWrite mutex( _impl->statistics );
-    GLStats::Item item;
-    item.entity = originator;
-    item.type = stat.type;
-    item.frame = stat.frameNumber;
-    item.start = stat.startTime;
-    item.end = stat.endTime;
-
-    GLStats::Entity entity;
-    entity.name = stat.resourceName;
-
-    GLStats::Type type;
-    const Vector3f& color = Statistic::getColor( stat.type );
-
-    type.color[0] = color[0];
-    type.color[1] = color[1];
-    type.color[2] = color[2];
-    type.name = Statistic::getName( stat.type );
-
-    switch( stat.type )
-    {
-      case Statistic::CHANNEL_FRAME_COMPRESS:
-      case Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN:
-          type.subgroup = "transmit";
-          item.thread = THREAD_ASYNC2;
-          // no break;
-      case Statistic::CHANNEL_FRAME_WAIT_READY:
-          type.group = "channel";
-          item.layer = 1;
-          break;
-      case Statistic::CHANNEL_CLEAR:
-      case Statistic::CHANNEL_DRAW:
-      case Statistic::CHANNEL_DRAW_FINISH:
-      case Statistic::CHANNEL_ASSEMBLE:
-      case Statistic::CHANNEL_READBACK:
-      case Statistic::CHANNEL_VIEW_FINISH:
-          type.group = "channel";
-          break;
-      case Statistic::CHANNEL_ASYNC_READBACK:
-          type.group = "channel";
-          type.subgroup = "transfer";
-          item.thread = THREAD_ASYNC1;
-          break;
-      case Statistic::CHANNEL_FRAME_TRANSMIT:
-          type.group = "channel";
-          type.subgroup = "transmit";
-          item.thread = THREAD_ASYNC2;
-          break;
-
-      case Statistic::WINDOW_FINISH:
-      case Statistic::WINDOW_THROTTLE_FRAMERATE:
-      case Statistic::WINDOW_SWAP_BARRIER:
-      case Statistic::WINDOW_SWAP:
-          type.group = "window";
-          break;
-      case Statistic::NODE_FRAME_DECOMPRESS:
-          type.group = "node";
-          break;
-
-      case Statistic::CONFIG_WAIT_FINISH_FRAME:
-          item.layer = 1;
-          // no break;
-      case Statistic::CONFIG_START_FRAME:
-      case Statistic::CONFIG_FINISH_FRAME:
-          type.group = "config";
-          break;
-
-      case Statistic::PIPE_IDLE:
-      {
-          const std::string& string = _impl->statistics->getText();
-          const float idle = stat.idleTime * 100ll / stat.totalTime;
-          std::stringstream text;
-          if( string.empty( ))
-              text <<  "Idle: " << stat.resourceName << ' ' << idle << "%";
-          else
-          {
-              const size_t pos = string.find( stat.resourceName );
-
-              if( pos == std::string::npos ) // append new pipe
-                  text << string << ", " << stat.resourceName << ' '
-                       << idle << "%";
-              else // replace existing text
-              {
-                  const std::string& left = string.substr( pos + 1 );
-
-                  text << string.substr( 0, pos ) << stat.resourceName << ' '
-                       << idle << left.substr( left.find( '%' ));
-              }
-          }
-          _impl->statistics->setText( text.str( ));
-      }
-      // no break;
-
-      case Statistic::WINDOW_FPS:
-      case Statistic::NONE:
-      case Statistic::ALL:
-          return;
-    }
-    switch( stat.type )
-    {
-      case Statistic::CHANNEL_FRAME_COMPRESS:
-      case Statistic::CHANNEL_ASYNC_READBACK:
-      case Statistic::CHANNEL_READBACK:
-      {
-          std::stringstream text;
-          text << unsigned( 100.f * stat.ratio ) << '%';
+    _impl->statistics.add( originator, stat );
+#endif
+}
 
-          if( stat.plugins[ 0 ] > EQ_COMPRESSOR_NONE )
-              text << " 0x" << std::hex << stat.plugins[0] << std::dec;
-          if( stat.plugins[ 1 ] > EQ_COMPRESSOR_NONE &&
-              stat.plugins[ 0 ] != stat.plugins[ 1 ] )
-          {
-              text << " 0x" << std::hex << stat.plugins[1] << std::dec;
-          }
-          item.text = text.str();
-          break;
-      }
-      default:
-          break;
-    }
+void Config::addLocalStatistic( const Statistic& stat )
+{
+    _impl->localMetrics.add( stat );
+    if( _impl->metrics )
+        _impl->metrics->add( stat );
+}
 
-    _impl->statistics->setType( stat.type, type );
-    _impl->statistics->setEntity( originator, entity );
-    _impl->statistics->addItem( item );
-#endif
+std::string Config::getLocalMetrics() const
+{
+    return _impl->localMetrics.getText();
 }
 
 bool Config::_needsLocalSync() const
@@ -931,21 +1513,33 @@ void Config::_updateStatistics()
 {
 #ifdef EQUALIZER_USE_GLSTATS
     // keep statistics for three frames
-    lunchbox::ScopedFastWrite mutex( _impl->statistics );
-    _impl->statistics->obsolete( 2 /* frames to keep */ );
+    _impl->statistics.obsolete();
 #endif
 }
 
 GLStats::Data Config::getStatistics() const
 {
 #ifdef EQUALIZER_USE_GLSTATS
-    lunchbox::ScopedFastRead mutex( _impl->statistics );
-    return _impl->statistics.data;
+    return _impl->statistics.getSnapshot();
 #else
     return GLStats::_fakeStats;
 #endif
 }
 
+uint64_t Config::getStatisticsVersion() const
+{
+#ifdef EQUALIZER_USE_GLSTATS
+    return _impl->statistics.getVersion();
+#else
+    return 0;
+#endif
+}
+
+void Config::dumpTrace( const std::string& filename )
+{
+    send( getServer(), fabric::CMD_CONFIG_DUMP_TRACE ) << filename;
+}
+
 uint32_t Config::getCurrentFrame() const
 {
     return _impl->currentFrame;
@@ -956,6 +1550,11 @@ uint32_t Config::getFinishedFrame() const
     return _impl->finishedFrame.get();
 }
 
+float Config::getInputLatency( const float percentile ) const
+{
+    return _impl->inputLatency.getPercentile( percentile );
+}
+
 bool Config::isRunning() const
 {
     return _impl->running;
@@ -1281,6 +1880,32 @@ bool Config::_cmdSwapObject( co::ICommand& cmd )
     getLocalNode()->serveRequest( requestID );
     return true;
 }
+
+bool Config::_cmdEvent( co::ICommand& command )
+{
+    // statistics are handled by the receiver thread, keeping the bulk of them
+    // out of the application's event queue
+    EventICommand event( command );
+    if( event.getEventType() == Event::STATISTIC )
+        _handleNewEvent( event );
+    else
+        _impl->eventQueue.push( command );
+    return true;
+}
+
+bool Config::_cmdExchange( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    const uint128_t exchangeID = command.read< uint128_t >();
+    const uint32_t sequence = command.read< uint32_t >();
+
+    lunchbox::Condition& condition = _impl->exchangeCondition;
+    condition.lock();
+    _impl->exchanges[ std::make_pair( exchangeID, sequence ) ].push_back( cmd );
+    condition.broadcast();
+    condition.unlock();
+    return true;
+}
 }
 
 #include "../fabric/config.ipp"
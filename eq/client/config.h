@@ -89,9 +89,45 @@ public:
     /** @return the frame number of the last frame finished. @version 1.0 */
     EQ_API uint32_t getFinishedFrame() const;
 
-    /** @internal Get all received statistics. */
+    /**
+     * Get the input latency of the last frames.
+     *
+     * The input latency is the time from a pointer, key or SpaceMouse event
+     * to the swap of the first frame started after the application handled
+     * it, measured for each window. It is only measured while the windows
+     * send their swap statistics to the application, see
+     * WindowSettings::IATTR_HINT_STATISTICS. Each measurement is also added
+     * as a CONFIG_INPUT_LATENCY statistic. Thread safe.
+     *
+     * @param percentile the percentile in [0, 100], e.g., 50 for the median.
+     * @return the percentile of the last measurements in milliseconds, or 0
+     *         if no latency was measured.
+     * @version 1.9
+     */
+    EQ_API float getInputLatency( float percentile ) const;
+
+    /**
+     * @internal
+     * @return a snapshot of the received statistics, aggregated in a
+     *         separate thread and updated after each batch of events.
+     */
     EQ_API GLStats::Data getStatistics() const;
 
+    /** @internal @return a counter incremented with each new snapshot. */
+    EQ_API uint64_t getStatisticsVersion() const;
+
+    /**
+     * Write the statistics trace recorded by the server.
+     *
+     * The trace is recorded if the config attribute trace_events is set, and
+     * is written asynchronously by the server process in the Chrome trace
+     * format.
+     *
+     * @param filename the file to write, or empty for the default file.
+     * @version 1.8
+     */
+    EQ_API void dumpTrace( const std::string& filename = std::string( ));
+
     /**
      * @return true while the config is initialized and no exit event
      *         has happened.
@@ -188,6 +224,32 @@ public:
 
     /** @sa fabric::Config::setLatency() */
     EQ_API virtual void setLatency( const uint32_t latency );
+
+    /**
+     * Adapt the latency automatically between 0 and the given maximum.
+     *
+     * The latency is raised while the application thread waits for the
+     * rendering to finish in finishFrame(), and lowered while overlapping more
+     * frames does not reduce this wait. Each change of the latency finishes
+     * all pending frames. 0 disables the automatic latency.
+     *
+     * @param maxLatency the maximum latency.
+     * @version 1.8
+     */
+    EQ_API void setAutoLatency( const uint32_t maxLatency );
+
+    /**
+     * Hint that the user is interacting with the application.
+     *
+     * With the automatic latency enabled, interaction uses a latency of 0 for
+     * the best responsiveness, and the end of interaction restores the maximum
+     * latency for the best throughput, e.g., during idle refinement.
+     *
+     * @param interactive true while the user interacts.
+     * @sa setAutoLatency()
+     * @version 1.8
+     */
+    EQ_API void setInteractive( const bool interactive );
     //@}
 
     /** @name Object registry. */
@@ -412,6 +474,56 @@ public:
      */
     EQ_API Errors getErrors();
 
+    /** @name Data exchange between nodes */
+    //@{
+    /**
+     * Send a part of a data exchange directly to another node.
+     *
+     * Used by render clients to exchange data partitioned by range, e.g., to
+     * gather the results of all pipes without routing them through the
+     * application node or distributed object versions. Each receiver picks a
+     * unique exchange identifier, and the parts of one round are identified by
+     * their sequence number. The data is copied into the sent command. Thread
+     * safe.
+     *
+     * @param node the identifier of the receiving node, may be the local node.
+     * @param exchangeID the identifier of the exchange on the receiver.
+     * @param sequence the round of the exchange.
+     * @param offset the byte offset of the part in the receiver's buffer.
+     * @param data the data of the part.
+     * @param size the size of the data in bytes.
+     * @return true if the part was sent, false if the node is not reachable.
+     * @version 1.8
+     */
+    EQ_API bool sendExchange( const co::NodeID& node,
+                              const uint128_t& exchangeID,
+                              const uint32_t sequence, const uint64_t offset,
+                              const void* data, const uint64_t size );
+
+    /**
+     * Receive all parts of one round of a data exchange.
+     *
+     * Blocks until nParts parts sent with the given exchange identifier and
+     * sequence have been received, and copies each of them to its offset in
+     * the given buffer. Parts of later rounds received in the meantime are
+     * kept for their receiveExchange(). Thread safe.
+     *
+     * @param exchangeID the identifier of the exchange.
+     * @param sequence the round of the exchange.
+     * @param nParts the number of parts to receive.
+     * @param buffer the destination of the received parts.
+     * @param size the size of the buffer in bytes.
+     * @param timeout the time in ms to wait for all parts.
+     * @return true if all parts were received, false on timeout.
+     * @version 1.8
+     */
+    EQ_API bool receiveExchange( const uint128_t& exchangeID,
+                                 const uint32_t sequence, const size_t nParts,
+                                 void* buffer, const uint64_t size,
+                                 const uint32_t timeout =
+                                     LB_TIMEOUT_INDEFINITE );
+    //@}
+
     /**
      * Get the next event.
      *
@@ -446,19 +558,57 @@ public:
      * To be called only on the application node. Called automatically at the
      * end of each frame to handle pending config events. The default
      * implementation calls handleEvent() on all pending events, without
-     * blocking. Not thread safe.
+     * blocking, using handleEvents( size_t ). Not thread safe.
      * @version 1.0
      */
     EQ_API virtual void handleEvents();
 
+    /**
+     * Handle a bounded number of pending config events.
+     *
+     * To be called only on the application node. Consecutive pointer motion
+     * and resize events of the same originator are coalesced into the last
+     * one, accumulating the pointer motion deltas. Events left in the queue
+     * are handled by the next call. Does not block. Not thread safe.
+     *
+     * @param budget the maximum number of events taken from the queue.
+     * @return the number of events taken from the queue.
+     * @version 1.8
+     */
+    EQ_API size_t handleEvents( const size_t budget );
+
     /**
      * Add an statistic event to the statistics overlay. Thread safe.
      *
+     * Called from the receiver thread for each statistic received from the
+     * render clients. Overrides have to call the base class implementation,
+     * which queues the event for the statistics aggregation thread.
+     *
      * @param originator the originator serial id.
      * @param stat the statistic event.
      * @warning experimental, may not be supported in the future
+     * @version 1.9
      */
-    void addStatistic( const uint32_t originator, const Statistic& stat );
+    EQ_API virtual void addStatistic( const uint32_t originator,
+                                      const Statistic& stat );
+
+    /**
+     * Aggregate a statistic into the local histograms without sending it.
+     *
+     * Used by the statistics samplers in HISTOGRAM mode, see
+     * Channel::IATTR_HINT_STATISTICS. The statistic is also exported by the
+     * metrics endpoint of this process, if any. Thread safe.
+     *
+     * @param stat the statistic sampled in this process.
+     * @version 1.9
+     */
+    EQ_API void addLocalStatistic( const Statistic& stat );
+
+    /**
+     * @return the local histograms in the Prometheus text format.
+     * @version 1.9
+     */
+    EQ_API std::string getLocalMetrics() const;
     //@}
 
     /**
@@ -497,6 +647,9 @@ private:
     /** Update statistics for the last finished frame */
     void _updateStatistics();
 
+    /** Adapt the latency at the end of a measurement period. */
+    void _adaptLatency();
+
     /** Release all deregistered buffered objects after their latency is
         done. */
     void _releaseObjects();
@@ -515,6 +668,8 @@ private:
     bool _cmdReleaseFrameLocal( co::ICommand& command );
     bool _cmdFrameFinish( co::ICommand& command );
     bool _cmdSwapObject( co::ICommand& command );
+    bool _cmdEvent( co::ICommand& command );
+    bool _cmdExchange( co::ICommand& command );
 };
 }
 
@@ -33,6 +33,9 @@ ConfigStatistics::ConfigStatistics( const Statistic::Type type,
                                     Config* config )
         : StatisticSampler< Config >( type, config, config->getCurrentFrame( ))
 {
+    if( !isEnabled( ))
+        return;
+
     const std::string& name = config->getName();
     if( name.empty( ))
         snprintf( event.data.statistic.resourceName, 32, "config" );
@@ -45,6 +48,9 @@ ConfigStatistics::ConfigStatistics( const Statistic::Type type,
 
 ConfigStatistics::~ConfigStatistics()
 {
+    if( !isEnabled( ))
+        return;
+
     event.data.statistic.endTime = _owner->getTime();
     if( event.data.statistic.endTime <= event.data.statistic.startTime )
         event.data.statistic.endTime = event.data.statistic.startTime + 1;
@@ -34,6 +34,8 @@
 #include <lunchbox/buffer.h>
 #include <deflect/Stream.h>
 
+#include <cstring>
+
 namespace eq
 {
 namespace dc
@@ -55,6 +57,8 @@ public:
         : _stream( 0 )
         , _eventHandler( 0 )
         , _channel( ch )
+        , _current( 0 )
+        , _sentPVP( 0, 0, 0, 0 )
         , _sendFuture( make_ready_future( false ))
         , _running( false )
     {
@@ -97,16 +101,32 @@ public:
     {
         LBASSERT( &channel == _channel );
 
-        // wait for completion of previous send
-        _running = _sendFuture.get();
+        const PixelViewport& pvp = image.getPixelViewport();
+        if( _isUnchanged( image ))
+        {
+            // keep the previous send in flight, DisplayCluster keeps showing
+            // the last frame
+            if( _sendFuture.is_ready( ))
+            {
+                _running = _sendFuture.get();
+                _sendFuture = make_ready_future( _running );
+            }
+            return;
+        }
 
-        // copy pixels to perform swapYAxis()
+        // copy pixels to perform swapYAxis(), while the previous frame is
+        // still being sent from the other buffer
+        lunchbox::Bufferb& buffer = _buffers[ _current ];
         const size_t dataSize = image.getPixelDataSize( Frame::BUFFER_COLOR );
         buffer.replace( image.getPixelPointer( Frame::BUFFER_COLOR ), dataSize);
-        const PixelViewport& pvp = image.getPixelViewport();
         deflect::ImageWrapper::swapYAxis( buffer.getData(), pvp.w, pvp.h,
                                      image.getPixelSize( Frame::BUFFER_COLOR ));
 
+        // wait for completion of previous send
+        _running = _sendFuture.get();
+        _sentPVP = pvp;
+        _current = 1 - _current;
+
         // determine image offset wrt global view
         const Viewport& vp = _channel->getViewport();
         const int32_t width = pvp.w / vp.w;
@@ -125,9 +145,40 @@ public:
     deflect::Stream* _stream;
     EventHandler* _eventHandler;
     eq::Channel* _channel;
-    lunchbox::Bufferb buffer;
+    lunchbox::Bufferb _buffers[2]; //!< streamed from and copied to in turns
+    unsigned _current; //!< the buffer for the next frame
+    PixelViewport _sentPVP; //!< of the last streamed frame
     deflect::Stream::Future _sendFuture;
     bool _running;
+
+private:
+    /** @return true if the image equals the last streamed frame. */
+    bool _isUnchanged( const eq::Image& image ) const
+    {
+        const PixelViewport& pvp = image.getPixelViewport();
+        if( pvp != _sentPVP || !pvp.hasArea( ))
+            return false;
+
+        // the last frame is read-only while it is being sent
+        const lunchbox::Bufferb& last = _buffers[ 1 - _current ];
+        const size_t rowSize = size_t( pvp.w ) *
+                               image.getPixelSize( Frame::BUFFER_COLOR );
+        if( last.getSize() != rowSize * pvp.h )
+            return false;
+
+        // compare bottom-up, the streamed frame has a swapped y axis
+        const uint8_t* pixels = image.getPixelPointer( Frame::BUFFER_COLOR );
+        const uint8_t* lastPixels = last.getData();
+        for( int32_t y = 0; y < pvp.h; ++y )
+        {
+            if( ::memcmp( pixels + y * rowSize,
+                          lastPixels + ( pvp.h - 1 - y ) * rowSize, rowSize ))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
 };
 }
 
@@ -0,0 +1,111 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "blocks.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace eq
+{
+namespace detail
+{
+namespace blocks
+{
+size_t compare( const uint8_t* pixels, const uint8_t* reference,
+                const size_t pixelSize, const uint32_t w, const uint32_t h,
+                std::vector< uint8_t >& mask )
+{
+    mask.assign( getNumBlocks( w, h ), 0 );
+    const size_t rowSize = size_t( w ) * pixelSize;
+    size_t nPixels = 0;
+    size_t block = 0;
+    for( uint32_t y = 0; y < h; y += SIZE )
+    {
+        const uint32_t blockH = std::min( SIZE, h - y );
+        for( uint32_t x = 0; x < w; x += SIZE, ++block )
+        {
+            const uint32_t blockW = std::min( SIZE, w - x );
+            const size_t offset = y * rowSize + x * pixelSize;
+            for( uint32_t i = 0; i < blockH; ++i )
+            {
+                const size_t row = offset + i * rowSize;
+                if( ::memcmp( pixels + row, reference + row,
+                              blockW * pixelSize ) != 0 )
+                {
+                    mask[ block ] = 1;
+                    nPixels += blockW * blockH;
+                    break;
+                }
+            }
+        }
+    }
+    return nPixels;
+}
+
+void pack( const uint8_t* pixels, const size_t pixelSize, const uint32_t w,
+           const uint32_t h, const std::vector< uint8_t >& mask,
+           uint8_t* packed )
+{
+    const size_t rowSize = size_t( w ) * pixelSize;
+    size_t block = 0;
+    for( uint32_t y = 0; y < h; y += SIZE )
+    {
+        const uint32_t blockH = std::min( SIZE, h - y );
+        for( uint32_t x = 0; x < w; x += SIZE, ++block )
+        {
+            if( !mask[ block ] )
+                continue;
+
+            const size_t size = std::min( SIZE, w - x ) * pixelSize;
+            const uint8_t* row = pixels + y * rowSize + x * pixelSize;
+            for( uint32_t i = 0; i < blockH; ++i, row += rowSize )
+            {
+                ::memcpy( packed, row, size );
+                packed += size;
+            }
+        }
+    }
+}
+
+void unpack( const uint8_t* packed, const size_t pixelSize, const uint32_t w,
+             const uint32_t h, const std::vector< uint8_t >& mask,
+             uint8_t* pixels )
+{
+    const size_t rowSize = size_t( w ) * pixelSize;
+    size_t block = 0;
+    for( uint32_t y = 0; y < h; y += SIZE )
+    {
+        const uint32_t blockH = std::min( SIZE, h - y );
+        for( uint32_t x = 0; x < w; x += SIZE, ++block )
+        {
+            if( !mask[ block ] )
+                continue;
+
+            const size_t size = std::min( SIZE, w - x ) * pixelSize;
+            uint8_t* row = pixels + y * rowSize + x * pixelSize;
+            for( uint32_t i = 0; i < blockH; ++i, row += rowSize )
+            {
+                ::memcpy( row, packed, size );
+                packed += size;
+            }
+        }
+    }
+}
+}
+}
+}
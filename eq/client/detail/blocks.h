@@ -0,0 +1,68 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQ_DETAIL_BLOCKS_H
+#define EQ_DETAIL_BLOCKS_H
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * Block deltas of consecutive images, see
+ * Channel::IATTR_HINT_TEMPORAL_TRANSMIT.
+ *
+ * An image of w*h pixels is divided into blocks of SIZE*SIZE pixels, clipped at
+ * the right and top border. A mask has one byte per block in row-major order,
+ * set for the blocks which differ from the reference image. Packed data holds
+ * the pixels of the changed blocks, block by block and row by row.
+ */
+namespace blocks
+{
+/** The edge length of a block in pixels. */
+static const uint32_t SIZE = 16;
+
+/** @return the number of blocks of a w*h image. */
+inline size_t getNumBlocks( const uint32_t w, const uint32_t h )
+{
+    return size_t(( w + SIZE - 1 ) / SIZE ) * (( h + SIZE - 1 ) / SIZE );
+}
+
+/**
+ * Compare two w*h images block by block.
+ * @return the number of pixels in the changed blocks.
+ */
+size_t compare( const uint8_t* pixels, const uint8_t* reference,
+                size_t pixelSize, uint32_t w, uint32_t h,
+                std::vector< uint8_t >& mask );
+
+/** Copy the pixels of the changed blocks of a w*h image. */
+void pack( const uint8_t* pixels, size_t pixelSize, uint32_t w, uint32_t h,
+           const std::vector< uint8_t >& mask, uint8_t* packed );
+
+/** Copy packed changed blocks into a w*h image. */
+void unpack( const uint8_t* packed, size_t pixelSize, uint32_t w, uint32_t h,
+             const std::vector< uint8_t >& mask, uint8_t* pixels );
+}
+}
+}
+
+#endif // EQ_DETAIL_BLOCKS_H
@@ -20,9 +20,27 @@
 #include "../channel.h"
 #include "../image.h"
 #include "../resultImageListener.h"
+#include "compressionSelector.h"
 #include "fileFrameWriter.h"
+#include "frameCounter.h"
+#include "imagePlayback.h"
+#include "multiView.h"
+#include "reprojector.h"
+#include "sharedMemoryWriter.h"
+#include "temporalUpsampler.h"
+#include "textureUploader.h"
+#include "timerQueries.h"
 
+#include <co/iCommand.h>
+#include <lunchbox/lock.h>
+#include <lunchbox/monitor.h>
+#include <lunchbox/referenced.h>
+#include <lunchbox/refPtr.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/spinLock.h>
 #include <boost/foreach.hpp>
+#include <deque>
+#include <map>
 
 #ifdef EQUALIZER_USE_DEFLECT
 #  include "../dc/proxy.h"
@@ -41,6 +59,190 @@ enum State
     STATE_FAILED
 };
 
+/**
+ * An assembly task deferred until its input frames are ready.
+ *
+ * The pipe thread queues all later tasks of the channel behind it, while the
+ * transfer thread waits on the ready listener and schedules the assembly on
+ * the pipe thread once all input frames have arrived.
+ */
+class AsyncAssembly : public lunchbox::Referenced
+{
+public:
+    typedef bool (eq::Channel::*Handler)( co::ICommand& );
+
+    struct Task
+    {
+        Task( co::ICommand& command_, const Handler handler_ )
+            : command( command_ ), handler( handler_ ) {}
+
+        co::ICommand command;
+        Handler handler;
+    };
+
+    AsyncAssembly( const RenderContext& context_, const Frames& frames_,
+                   const uint32_t frameNumber_ )
+        : context( context_ ), frames( frames_ ), frameNumber( frameNumber_ )
+        , deadline( 0 ), interval( 0 ), upload( false )
+    {}
+
+    RenderContext context;
+    const Frames frames;
+    const uint32_t frameNumber;
+
+    /** Config time of the next reprojection, see IATTR_HINT_REPROJECTION. */
+    int64_t deadline;
+
+    /** Display interval in milliseconds, 0 if reprojection is disabled. */
+    int64_t interval;
+
+    /** Upload the input frames on the transfer thread as they arrive. */
+    bool upload;
+
+    /** Incremented once for each ready input frame. */
+    lunchbox::Monitor< uint32_t > ready;
+
+    /** The channel tasks received after the assembly, in order. */
+    std::deque< Task > tasks;
+};
+typedef lunchbox::RefPtr< AsyncAssembly > AsyncAssemblyPtr;
+
+/**
+ * Consecutive tiles rendered into the slots of one drawable, which are read
+ * back together. See IATTR_HINT_TILE_ATLAS.
+ */
+class TileAtlas
+{
+public:
+    struct Tile
+    {
+        PixelViewport slot; //!< the slot in the drawable
+        PixelViewport pvp; //!< the destination of the tile
+        PixelViewports regions; //!< the declared regions, drawable-relative
+    };
+    typedef std::vector< Tile > Tiles;
+
+    TileAtlas() : columns( 0 ), capacity( 0 ) {}
+
+    /**
+     * Lay out the slots for tiles of the given size in the given area.
+     * @return false if no tile fits.
+     */
+    bool reset( const PixelViewport& area, const PixelViewport& tile,
+                const uint32_t maxTiles )
+    {
+        tiles.clear();
+        slotSize = Vector2i( tile.w, tile.h );
+        columns = tile.w > 0 ? area.w / tile.w : 0;
+        const size_t rows = tile.h > 0 ? area.h / tile.h : 0;
+        capacity = columns * rows;
+        if( maxTiles > 0 )
+            capacity = LB_MIN( capacity, size_t( maxTiles ));
+        return capacity > 0;
+    }
+
+    /** @return true if the given tile fits in the next free slot. */
+    bool fits( const PixelViewport& tile ) const
+    {
+        return tiles.size() < capacity &&
+               tile.w <= slotSize.x() && tile.h <= slotSize.y();
+    }
+
+    /** @return the next free slot for the given tile. */
+    PixelViewport getNextSlot( const PixelViewport& tile ) const
+    {
+        LBASSERT( fits( tile ));
+        const size_t index = tiles.size();
+        return PixelViewport( int32_t( index % columns ) * slotSize.x(),
+                              int32_t( index / columns ) * slotSize.y(),
+                              tile.w, tile.h );
+    }
+
+    /** @return the area covered by the used slots. */
+    PixelViewport getArea() const
+    {
+        PixelViewport area;
+        BOOST_FOREACH( const Tile& tile, tiles )
+            area.merge( tile.slot );
+        return area;
+    }
+
+    Tiles tiles;
+    Vector2i slotSize;
+    size_t columns;
+    size_t capacity;
+};
+
+/**
+ * The last image sent for an output frame buffer to a set of receivers, see
+ * IATTR_HINT_TEMPORAL_TRANSMIT.
+ */
+struct TransmitReference
+{
+    TransmitReference() : externalFormat( 0 ), pixelSize( 0 ) {}
+
+    std::vector< uint128_t > nodes; //!< the receivers holding the reference
+    PixelViewport pvp;
+    uint32_t externalFormat;
+    uint32_t pixelSize;
+    std::vector< uint8_t > pixels;
+    std::vector< uint8_t > mask; //!< of the last delta, see detail::blocks
+    std::vector< uint8_t > packed; //!< blocks of the last delta
+};
+
+/** Frame data identifier and image buffer index of a TransmitReference. */
+typedef std::pair< uint128_t, uint64_t > TransmitReferenceKey;
+typedef std::map< TransmitReferenceKey, TransmitReference > TransmitReferences;
+
+/**
+ * Recycled storage of objects allocated for each task, e.g., the readback
+ * statistics. The objects may be released by other threads.
+ */
+class TaskStorage : public boost::noncopyable
+{
+public:
+    TaskStorage() : nAllocations( 0 ), _size( 0 ) {}
+
+    ~TaskStorage()
+    {
+        BOOST_FOREACH( void* storage, _free )
+            ::operator delete( storage );
+    }
+
+    /** @return storage of the given size, which has to be the same always. */
+    void* alloc( const size_t size )
+    {
+        {
+            lunchbox::ScopedFastWrite mutex( _lock );
+            LBASSERT( _size == 0 || _size == size );
+            _size = size;
+            if( !_free.empty( ))
+            {
+                void* storage = _free.back();
+                _free.pop_back();
+                return storage;
+            }
+        }
+        ++nAllocations;
+        return ::operator new( size );
+    }
+
+    /** Recycle the given storage. Thread safe. */
+    void release( void* storage )
+    {
+        lunchbox::ScopedFastWrite mutex( _lock );
+        _free.push_back( storage );
+    }
+
+    /** The number of heap allocations, which stops in the steady state. */
+    lunchbox::a_int32_t nAllocations;
+
+private:
+    lunchbox::SpinLock _lock;
+    std::vector< void* > _free;
+    size_t _size;
+};
+
 class Channel
 {
 public:
@@ -51,6 +253,11 @@ public:
         , _dcProxy( 0 )
 #endif
         , _updateFrameBuffer( false )
+        , timerQueries( 0 )
+        , checkTimerQueries( true )
+        , useMultiView( true )
+        , nScratchAllocations( 0 )
+        , nTaskAllocations( 0 )
     {
         lunchbox::RNG rng;
         color.r() = rng.get< uint8_t >();
@@ -82,18 +289,28 @@ public:
             resultImageListeners.erase( i );
     }
 
-    void frameViewFinish( eq::Channel& channel )
+    void updateResultImageListener( const eq::Channel& channel,
+                                    const eq::Channel::SAttribute attribute,
+                                    ResultImageListener* listener )
     {
-        if( channel.getSAttribute( channel.SATTR_DUMP_IMAGE ).empty( ))
-            removeResultImageListener( &frameWriter );
+        if( channel.getSAttribute( attribute ).empty( ))
+            removeResultImageListener( listener );
         else
         {
             ResultImageListeners::iterator i =
                     std::find( resultImageListeners.begin(),
-                               resultImageListeners.end(), &frameWriter );
+                               resultImageListeners.end(), listener );
             if( i == resultImageListeners.end( ))
-                addResultImageListener( &frameWriter );
+                addResultImageListener( listener );
         }
+    }
+
+    void frameViewFinish( eq::Channel& channel )
+    {
+        updateResultImageListener( channel, channel.SATTR_DUMP_IMAGE,
+                                   &frameWriter );
+        updateResultImageListener( channel, channel.SATTR_SHARED_MEMORY,
+                                   &sharedMemoryWriter );
 
 #ifdef EQUALIZER_USE_DEFLECT
         if( _dcProxy && !_dcProxy->isRunning( ))
@@ -156,7 +373,7 @@ public:
     PixelViewports regions;
 
     /** The number of the last finished frame. */
-    lunchbox::Monitor< uint32_t > finishedFrame;
+    FrameCounter finishedFrame;
 
     /** Listeners that get notified on each new rendered image */
     typedef std::vector< ResultImageListener* > ResultImageListeners;
@@ -172,7 +389,90 @@ public:
     /** Dumps images when the channel is configured to do so */
     FileFrameWriter frameWriter;
 
+    /** Publishes images when the channel is configured to do so */
+    SharedMemoryWriter sharedMemoryWriter;
+
+    /** Loads recorded images when the channel is configured to do so */
+    ImagePlayback imagePlayback;
+
+    /** Compression decisions for output frames, used by the transmitter. */
+    CompressionSelector compressionSelector;
+
+    /** The last sent images, see IATTR_HINT_TEMPORAL_TRANSMIT. */
+    TransmitReferences transmitReferences;
+    lunchbox::Lock transmitReferencesLock;
+
     bool _updateFrameBuffer;
+
+    /** The deferred assembly, see IATTR_HINT_ASYNC_ASSEMBLY. */
+    AsyncAssemblyPtr asyncAssembly;
+
+    /** Uploads the input frames of the deferred assembly as they arrive. */
+    TextureUploader uploader;
+
+    /** The last complete image, see IATTR_HINT_REPROJECTION. */
+    Reprojector reprojector;
+
+    /** GPU-timed statistics, created on first use. */
+    TimerQueries* timerQueries;
+
+    /** Unset if the context does not support timer queries. */
+    bool checkTimerQueries;
+
+    /** The render context of the last task, base for the next task. */
+    RenderContext lastContext;
+
+    /** The layered frame buffer, see IATTR_HINT_MULTIVIEW. */
+    MultiView multiView;
+
+    /** The right eye context during frameDrawMultiView(). */
+    RenderContext rightContext;
+
+    /** Unset if the application does not implement frameDrawMultiView(). */
+    bool useMultiView;
+
+    /** The tiles pending readback, see IATTR_HINT_TILE_ATLAS. */
+    TileAtlas tileAtlas;
+
+    /** The per-eye history of IATTR_HINT_TEMPORAL_UPSAMPLING. */
+    TemporalUpsampler upsamplers[ NUM_EYES ];
+
+    /** The largest upscale of the input frames assembled in this frame. */
+    Zoom inputZoom;
+
+    /** @name Scratch memory of the tasks, reused to avoid allocations. */
+    //@{
+    Frames outputFrames; //!< see eq::Channel::_getFrames()
+    Frames inputFrames; //!< see eq::Channel::_getFrames()
+    std::vector< size_t > nImages; //!< image counts before the readback
+    std::vector< bool > readyFrames; //!< see eq::Channel::_setReady()
+    co::ObjectVersions readyBatch; //!< see eq::Channel::_setReady()
+    TaskStorage rbStats; //!< see detail::RBStat
+    //@}
+
+    /** Grow the capacity of the given scratch container. */
+    template< class T > void reserve( T& scratch, const size_t size )
+    {
+        if( scratch.capacity() >= size )
+            return;
+        scratch.reserve( size );
+        ++nScratchAllocations;
+    }
+
+    /** @return the heap allocations of the tasks. */
+    size_t getTaskAllocations() const
+        { return nScratchAllocations + size_t( rbStats.nAllocations ); }
+
+    /** The number of scratch container allocations. */
+    size_t nScratchAllocations;
+
+    /** The value of getTaskAllocations() at the last frame finish. */
+    size_t nTaskAllocations;
+
+    /** The statistics resource name, cached for resourceNameSource. */
+    std::string resourceName;
+    std::string resourceNameSource; //!< the channel name of resourceName
+    lunchbox::SpinLock resourceNameLock;
 };
 
 }
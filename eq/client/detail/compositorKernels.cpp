@@ -0,0 +1,558 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "compositorKernels.h"
+#include "pixelFormat.h"
+
+#include <lunchbox/log.h>
+#include <pression/plugins/compressor.h>
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+#  define EQ_KERNELS_X86
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#    define EQ_TARGET( isa )
+#  else
+#    define EQ_TARGET( isa ) __attribute__(( target( isa )))
+#  endif
+#  include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define EQ_KERNELS_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+void _mergeDepthScalar( uint32_t* destColor, uint32_t* destDepth,
+                        const uint32_t* color, const uint32_t* depth,
+                        const size_t n )
+{
+    for( size_t i = 0; i < n; ++i )
+    {
+        if( destDepth[i] > depth[i] )
+        {
+            destColor[i] = color[i];
+            destDepth[i] = depth[i];
+        }
+    }
+}
+
+void _blendRGBA8Scalar( uint32_t* dest, const uint32_t* src, const size_t n )
+{
+    const uint8_t* s = reinterpret_cast< const uint8_t* >( src );
+    uint8_t* d = reinterpret_cast< uint8_t* >( dest );
+
+    for( size_t i = 0; i < n; ++i, s += 4, d += 4 )
+    {
+        d[0] = std::min( s[0] + (s[3]*d[0] >> 8), 255 );
+        d[1] = std::min( s[1] + (s[3]*d[1] >> 8), 255 );
+        d[2] = std::min( s[2] + (s[3]*d[2] >> 8), 255 );
+        d[3] =                   s[3]*d[3] >> 8;
+    }
+}
+
+// GL_UNSIGNED_INT_10_10_10_2: three 10 bit color components in the upper 30
+// bits, alpha in the lowest two bits.
+void _blendRGB10A2Scalar( uint32_t* dest, const uint32_t* src,
+                          const size_t n )
+{
+    for( size_t i = 0; i < n; ++i )
+    {
+        const uint32_t s = src[i];
+        const uint32_t d = dest[i];
+        const uint32_t alpha = s & 0x3u;
+
+        uint32_t result = ( alpha * ( d & 0x3u )) / 3;
+        for( unsigned shift = 2; shift < 32; shift += 10 )
+        {
+            const uint32_t sc = ( s >> shift ) & 0x3ffu;
+            const uint32_t dc = ( d >> shift ) & 0x3ffu;
+            const uint32_t c = std::min( sc + alpha * dc / 3, 0x3ffu );
+            result |= c << shift;
+        }
+        dest[i] = result;
+    }
+}
+
+void _accumRGBA8Scalar( uint16_t* sum, const uint32_t* src, const size_t n )
+{
+    const uint8_t* s = reinterpret_cast< const uint8_t* >( src );
+    for( size_t i = 0; i < n * 4; ++i )
+        sum[i] += s[i];
+}
+
+/** @return the 16 bit fixed point reciprocal used to divide by steps. */
+inline uint32_t _getReciprocal( const uint32_t steps )
+{
+    LBASSERT( steps >= 2 && steps <= 256 );
+    return ( 65536u + steps - 1 ) / steps;
+}
+
+void _resolveRGBA8Scalar( uint32_t* dest, const uint16_t* sum,
+                          const uint32_t steps, const size_t n )
+{
+    const uint32_t reciprocal = _getReciprocal( steps );
+    const uint32_t half = steps / 2;
+    uint8_t* d = reinterpret_cast< uint8_t* >( dest );
+    for( size_t i = 0; i < n * 4; ++i )
+        d[i] = uint8_t( std::min(( uint32_t( sum[i] ) + half ) * reciprocal
+                                 >> 16, 255u ));
+}
+
+#ifdef EQ_KERNELS_X86
+EQ_TARGET( "sse4.1" )
+void _mergeDepthSSE41( uint32_t* destColor, uint32_t* destDepth,
+                       const uint32_t* color, const uint32_t* depth,
+                       const size_t n )
+{
+    size_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        __m128i* dc = reinterpret_cast< __m128i* >( destColor + i );
+        __m128i* dd = reinterpret_cast< __m128i* >( destDepth + i );
+        const __m128i srcC = _mm_loadu_si128(
+            reinterpret_cast< const __m128i* >( color + i ));
+        const __m128i srcD = _mm_loadu_si128(
+            reinterpret_cast< const __m128i* >( depth + i ));
+        const __m128i dstC = _mm_loadu_si128( dc );
+        const __m128i dstD = _mm_loadu_si128( dd );
+
+        // keep destination where source >= destination (unsigned)
+        const __m128i keep = _mm_cmpeq_epi32( _mm_max_epu32( srcD, dstD ),
+                                              srcD );
+        _mm_storeu_si128( dc, _mm_blendv_epi8( srcC, dstC, keep ));
+        _mm_storeu_si128( dd, _mm_min_epu32( srcD, dstD ));
+    }
+    _mergeDepthScalar( destColor + i, destDepth + i, color + i, depth + i,
+                       n - i );
+}
+
+EQ_TARGET( "avx2" )
+void _mergeDepthAVX2( uint32_t* destColor, uint32_t* destDepth,
+                      const uint32_t* color, const uint32_t* depth,
+                      const size_t n )
+{
+    size_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        __m256i* dc = reinterpret_cast< __m256i* >( destColor + i );
+        __m256i* dd = reinterpret_cast< __m256i* >( destDepth + i );
+        const __m256i srcC = _mm256_loadu_si256(
+            reinterpret_cast< const __m256i* >( color + i ));
+        const __m256i srcD = _mm256_loadu_si256(
+            reinterpret_cast< const __m256i* >( depth + i ));
+        const __m256i dstC = _mm256_loadu_si256( dc );
+        const __m256i dstD = _mm256_loadu_si256( dd );
+
+        const __m256i keep =
+            _mm256_cmpeq_epi32( _mm256_max_epu32( srcD, dstD ), srcD );
+        _mm256_storeu_si256( dc, _mm256_blendv_epi8( srcC, dstC, keep ));
+        _mm256_storeu_si256( dd, _mm256_min_epu32( srcD, dstD ));
+    }
+    _mergeDepthScalar( destColor + i, destDepth + i, color + i, depth + i,
+                       n - i );
+}
+
+EQ_TARGET( "sse2" )
+inline __m128i _blendRGBA8SSE2( const __m128i src, const __m128i dst,
+                                const __m128i colorMask )
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i srcLo = _mm_unpacklo_epi8( src, zero );
+    const __m128i srcHi = _mm_unpackhi_epi8( src, zero );
+    const __m128i dstLo = _mm_unpacklo_epi8( dst, zero );
+    const __m128i dstHi = _mm_unpackhi_epi8( dst, zero );
+
+    // broadcast the source alpha of each pixel to all four 16 bit lanes
+    const int bcast = _MM_SHUFFLE( 3, 3, 3, 3 );
+    const __m128i alphaLo =
+        _mm_shufflehi_epi16( _mm_shufflelo_epi16( srcLo, bcast ), bcast );
+    const __m128i alphaHi =
+        _mm_shufflehi_epi16( _mm_shufflelo_epi16( srcHi, bcast ), bcast );
+
+    const __m128i prodLo = _mm_srli_epi16( _mm_mullo_epi16( alphaLo, dstLo ),
+                                           8 );
+    const __m128i prodHi = _mm_srli_epi16( _mm_mullo_epi16( alphaHi, dstHi ),
+                                           8 );
+
+    // the alpha lane gets only the product, pack saturates color to 255
+    const __m128i resLo = _mm_adds_epu16( _mm_and_si128( srcLo, colorMask ),
+                                          prodLo );
+    const __m128i resHi = _mm_adds_epu16( _mm_and_si128( srcHi, colorMask ),
+                                          prodHi );
+    return _mm_packus_epi16( resLo, resHi );
+}
+
+EQ_TARGET( "sse2" )
+void _blendRGBA8SSE2( uint32_t* dest, const uint32_t* src, const size_t n )
+{
+    const __m128i colorMask = _mm_set_epi16( 0, -1, -1, -1, 0, -1, -1, -1 );
+
+    size_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        __m128i* d = reinterpret_cast< __m128i* >( dest + i );
+        const __m128i s = _mm_loadu_si128(
+            reinterpret_cast< const __m128i* >( src + i ));
+        _mm_storeu_si128( d, _blendRGBA8SSE2( s, _mm_loadu_si128( d ),
+                                              colorMask ));
+    }
+    _blendRGBA8Scalar( dest + i, src + i, n - i );
+}
+
+EQ_TARGET( "avx2" )
+void _blendRGBA8AVX2( uint32_t* dest, const uint32_t* src, const size_t n )
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i colorMask = _mm256_set_epi16( 0, -1, -1, -1, 0, -1, -1, -1,
+                                                0, -1, -1, -1, 0, -1, -1, -1 );
+    const int bcast = _MM_SHUFFLE( 3, 3, 3, 3 );
+
+    size_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        __m256i* d = reinterpret_cast< __m256i* >( dest + i );
+        const __m256i s = _mm256_loadu_si256(
+            reinterpret_cast< const __m256i* >( src + i ));
+        const __m256i dst = _mm256_loadu_si256( d );
+
+        // unpack and pack operate per 128 bit lane, preserving pixel order
+        const __m256i srcLo = _mm256_unpacklo_epi8( s, zero );
+        const __m256i srcHi = _mm256_unpackhi_epi8( s, zero );
+        const __m256i dstLo = _mm256_unpacklo_epi8( dst, zero );
+        const __m256i dstHi = _mm256_unpackhi_epi8( dst, zero );
+
+        const __m256i alphaLo = _mm256_shufflehi_epi16(
+            _mm256_shufflelo_epi16( srcLo, bcast ), bcast );
+        const __m256i alphaHi = _mm256_shufflehi_epi16(
+            _mm256_shufflelo_epi16( srcHi, bcast ), bcast );
+
+        const __m256i prodLo =
+            _mm256_srli_epi16( _mm256_mullo_epi16( alphaLo, dstLo ), 8 );
+        const __m256i prodHi =
+            _mm256_srli_epi16( _mm256_mullo_epi16( alphaHi, dstHi ), 8 );
+
+        const __m256i resLo = _mm256_adds_epu16(
+            _mm256_and_si256( srcLo, colorMask ), prodLo );
+        const __m256i resHi = _mm256_adds_epu16(
+            _mm256_and_si256( srcHi, colorMask ), prodHi );
+        _mm256_storeu_si256( d, _mm256_packus_epi16( resLo, resHi ));
+    }
+    _blendRGBA8Scalar( dest + i, src + i, n - i );
+}
+
+EQ_TARGET( "sse2" )
+void _accumRGBA8SSE2( uint16_t* sum, const uint32_t* src, const size_t n )
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const __m128i s = _mm_loadu_si128(
+            reinterpret_cast< const __m128i* >( src + i ));
+        __m128i* lo = reinterpret_cast< __m128i* >( sum + i * 4 );
+        __m128i* hi = reinterpret_cast< __m128i* >( sum + i * 4 + 8 );
+        _mm_storeu_si128( lo, _mm_add_epi16( _mm_loadu_si128( lo ),
+                                             _mm_unpacklo_epi8( s, zero )));
+        _mm_storeu_si128( hi, _mm_add_epi16( _mm_loadu_si128( hi ),
+                                             _mm_unpackhi_epi8( s, zero )));
+    }
+    _accumRGBA8Scalar( sum + i * 4, src + i, n - i );
+}
+
+EQ_TARGET( "sse2" )
+void _resolveRGBA8SSE2( uint32_t* dest, const uint16_t* sum,
+                        const uint32_t steps, const size_t n )
+{
+    const __m128i reciprocal = _mm_set1_epi16(
+        short( _getReciprocal( steps )));
+    const __m128i half = _mm_set1_epi16( short( steps / 2 ));
+    size_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const __m128i lo = _mm_loadu_si128(
+            reinterpret_cast< const __m128i* >( sum + i * 4 ));
+        const __m128i hi = _mm_loadu_si128(
+            reinterpret_cast< const __m128i* >( sum + i * 4 + 8 ));
+        const __m128i avgLo = _mm_mulhi_epu16( _mm_adds_epu16( lo, half ),
+                                               reciprocal );
+        const __m128i avgHi = _mm_mulhi_epu16( _mm_adds_epu16( hi, half ),
+                                               reciprocal );
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( dest + i ),
+                          _mm_packus_epi16( avgLo, avgHi ));
+    }
+    _resolveRGBA8Scalar( dest + i, sum + i * 4, steps, n - i );
+}
+
+struct CPUFeatures
+{
+    CPUFeatures() : sse2( false ), sse41( false ), avx2( false )
+    {
+#  ifdef _MSC_VER
+        int info[4];
+        __cpuid( info, 0 );
+        const int nIDs = info[0];
+
+        __cpuid( info, 1 );
+        sse2 = ( info[3] & ( 1 << 26 )) != 0;
+        sse41 = ( info[2] & ( 1 << 19 )) != 0;
+        const bool osxsave = ( info[2] & ( 1 << 27 )) != 0;
+        const bool avx = ( info[2] & ( 1 << 28 )) != 0;
+        const bool ymmState = osxsave && ( _xgetbv( 0 ) & 0x6 ) == 0x6;
+
+        if( nIDs >= 7 && avx && ymmState )
+        {
+            __cpuidex( info, 7, 0 );
+            avx2 = ( info[1] & ( 1 << 5 )) != 0;
+        }
+#  else
+        __builtin_cpu_init();
+        sse2 = __builtin_cpu_supports( "sse2" );
+        sse41 = __builtin_cpu_supports( "sse4.1" );
+        avx2 = __builtin_cpu_supports( "avx2" );
+#  endif
+    }
+
+    bool sse2;
+    bool sse41;
+    bool avx2;
+};
+#endif // EQ_KERNELS_X86
+
+#ifdef EQ_KERNELS_NEON
+void _mergeDepthNEON( uint32_t* destColor, uint32_t* destDepth,
+                      const uint32_t* color, const uint32_t* depth,
+                      const size_t n )
+{
+    size_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const uint32x4_t srcC = vld1q_u32( color + i );
+        const uint32x4_t srcD = vld1q_u32( depth + i );
+        const uint32x4_t dstC = vld1q_u32( destColor + i );
+        const uint32x4_t dstD = vld1q_u32( destDepth + i );
+
+        const uint32x4_t take = vcgtq_u32( dstD, srcD );
+        vst1q_u32( destColor + i, vbslq_u32( take, srcC, dstC ));
+        vst1q_u32( destDepth + i, vminq_u32( srcD, dstD ));
+    }
+    _mergeDepthScalar( destColor + i, destDepth + i, color + i, depth + i,
+                       n - i );
+}
+
+void _blendRGBA8NEON( uint32_t* dest, const uint32_t* src, const size_t n )
+{
+    uint8_t* d = reinterpret_cast< uint8_t* >( dest );
+    const uint8_t* s = reinterpret_cast< const uint8_t* >( src );
+
+    size_t i = 0;
+    for( ; i + 16 <= n; i += 16 )
+    {
+        const uint8x16x4_t srcPx = vld4q_u8( s + i * 4 );
+        uint8x16x4_t dstPx = vld4q_u8( d + i * 4 );
+        const uint8x8_t aLo = vget_low_u8( srcPx.val[3] );
+        const uint8x8_t aHi = vget_high_u8( srcPx.val[3] );
+
+        for( unsigned c = 0; c < 4; ++c )
+        {
+            const uint8x16_t dc = dstPx.val[c];
+            const uint8x16_t prod = vcombine_u8(
+                vshrn_n_u16( vmull_u8( aLo, vget_low_u8( dc )), 8 ),
+                vshrn_n_u16( vmull_u8( aHi, vget_high_u8( dc )), 8 ));
+            dstPx.val[c] = ( c == 3 ) ? prod : vqaddq_u8( srcPx.val[c], prod );
+        }
+        vst4q_u8( d + i * 4, dstPx );
+    }
+    _blendRGBA8Scalar( dest + i, src + i, n - i );
+}
+
+void _accumRGBA8NEON( uint16_t* sum, const uint32_t* src, const size_t n )
+{
+    const uint8_t* s = reinterpret_cast< const uint8_t* >( src );
+    size_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const uint8x16_t px = vld1q_u8( s + i * 4 );
+        uint16_t* lo = sum + i * 4;
+        uint16_t* hi = sum + i * 4 + 8;
+        vst1q_u16( lo, vaddw_u8( vld1q_u16( lo ), vget_low_u8( px )));
+        vst1q_u16( hi, vaddw_u8( vld1q_u16( hi ), vget_high_u8( px )));
+    }
+    _accumRGBA8Scalar( sum + i * 4, src + i, n - i );
+}
+#endif
+
+CompositorKernels _selectKernels()
+{
+    CompositorKernels kernels = getScalarCompositorKernels();
+#ifdef EQ_KERNELS_X86
+    const CPUFeatures features;
+    if( features.avx2 )
+    {
+        kernels.mergeDepth = _mergeDepthAVX2;
+        kernels.blendRGBA8 = _blendRGBA8AVX2;
+        kernels.accumRGBA8 = _accumRGBA8SSE2;
+        kernels.resolveRGBA8 = _resolveRGBA8SSE2;
+        kernels.name = "AVX2";
+    }
+    else if( features.sse41 )
+    {
+        kernels.mergeDepth = _mergeDepthSSE41;
+        kernels.blendRGBA8 = _blendRGBA8SSE2;
+        kernels.accumRGBA8 = _accumRGBA8SSE2;
+        kernels.resolveRGBA8 = _resolveRGBA8SSE2;
+        kernels.name = "SSE4.1";
+    }
+    else if( features.sse2 )
+    {
+        kernels.blendRGBA8 = _blendRGBA8SSE2;
+        kernels.accumRGBA8 = _accumRGBA8SSE2;
+        kernels.resolveRGBA8 = _resolveRGBA8SSE2;
+        kernels.name = "SSE2";
+    }
+#elif defined( EQ_KERNELS_NEON )
+    kernels.mergeDepth = _mergeDepthNEON;
+    kernels.blendRGBA8 = _blendRGBA8NEON;
+    kernels.accumRGBA8 = _accumRGBA8NEON;
+    kernels.name = "NEON";
+#endif
+    LBVERB << "Using " << kernels.name << " CPU compositing kernels"
+           << std::endl;
+    return kernels;
+}
+}
+
+const CompositorKernels& getScalarCompositorKernels()
+{
+    static const CompositorKernels kernels = { _mergeDepthScalar,
+                                               _blendRGBA8Scalar,
+                                               _blendRGB10A2Scalar,
+                                               _accumRGBA8Scalar,
+                                               _resolveRGBA8Scalar,
+                                               "scalar" };
+    return kernels;
+}
+
+const CompositorKernels& getCompositorKernels()
+{
+    static const CompositorKernels kernels = _selectKernels();
+    return kernels;
+}
+
+template<> void blend< RGBA16F >( void* dest, const void* src,
+                                 const size_t n )
+{
+    static const size_t chunk = 256; // pixels converted at once
+    float destF[ chunk * 4 ];
+    float srcF[ chunk * 4 ];
+
+    uint16_t* d = static_cast< uint16_t* >( dest );
+    const uint16_t* s = static_cast< const uint16_t* >( src );
+
+    for( size_t i = 0; i < n; i += chunk )
+    {
+        const size_t nPixels = std::min( chunk, n - i );
+        const size_t nValues = nPixels * 4;
+        half_to_float_n( d + i * 4, destF, nValues );
+        half_to_float_n( s + i * 4, srcF, nValues );
+        blend< RGBA32F >( destF, srcF, nPixels );
+        half_from_float_n( destF, d + i * 4, nValues );
+    }
+}
+
+namespace
+{
+void _mergeDepth32( void* destColor, void* destDepth, const void* color,
+                    const void* depth, const size_t n )
+{
+    getCompositorKernels().mergeDepth(
+        static_cast< uint32_t* >( destColor ),
+        static_cast< uint32_t* >( destDepth ),
+        static_cast< const uint32_t* >( color ),
+        static_cast< const uint32_t* >( depth ), n );
+}
+
+void _blendRGBA8( void* dest, const void* src, const size_t n )
+{
+    getCompositorKernels().blendRGBA8( static_cast< uint32_t* >( dest ),
+                                       static_cast< const uint32_t* >( src ),
+                                       n );
+}
+
+void _blendRGB10A2( void* dest, const void* src, const size_t n )
+{
+    getCompositorKernels().blendRGB10A2( static_cast< uint32_t* >( dest ),
+                                         static_cast< const uint32_t* >( src ),
+                                         n );
+}
+
+// transparent pixels: no color and full transmittance in alpha
+const uint8_t _transparentRGBA8[] = { 0, 0, 0, 255 };
+const uint32_t _transparentRGB10A2 = 0x3u;
+const uint16_t _transparentRGBA16F[] = { 0, 0, 0, 0x3c00 };
+const float _transparentRGBA32F[] = { 0.f, 0.f, 0.f, 1.f };
+
+#define EQ_DEPTH_UINT EQ_COMPRESSOR_DATATYPE_DEPTH_UNSIGNED_INT
+#define EQ_FLOAT_KERNELS( format, Format )                                \
+    { format, EQ_DEPTH_UINT, sizeof( Format::Pixel ), sizeof( uint32_t ), \
+      mergeDepth< Format, DepthUnsignedInt >, blend< Format >,          \
+      _transparent ## Format }
+
+const PixelKernels _pixelKernels[] =
+{
+    { EQ_COMPRESSOR_DATATYPE_RGBA, EQ_DEPTH_UINT, 4, 4,
+      _mergeDepth32, _blendRGBA8, _transparentRGBA8 },
+    { EQ_COMPRESSOR_DATATYPE_BGRA, EQ_DEPTH_UINT, 4, 4,
+      _mergeDepth32, _blendRGBA8, _transparentRGBA8 },
+    { EQ_COMPRESSOR_DATATYPE_RGB10_A2, EQ_DEPTH_UINT, 4, 4,
+      _mergeDepth32, _blendRGB10A2, &_transparentRGB10A2 },
+    { EQ_COMPRESSOR_DATATYPE_BGR10_A2, EQ_DEPTH_UINT, 4, 4,
+      _mergeDepth32, _blendRGB10A2, &_transparentRGB10A2 },
+    EQ_FLOAT_KERNELS( EQ_COMPRESSOR_DATATYPE_RGBA16F, RGBA16F ),
+    EQ_FLOAT_KERNELS( EQ_COMPRESSOR_DATATYPE_BGRA16F, RGBA16F ),
+    EQ_FLOAT_KERNELS( EQ_COMPRESSOR_DATATYPE_RGBA32F, RGBA32F ),
+    EQ_FLOAT_KERNELS( EQ_COMPRESSOR_DATATYPE_BGRA32F, RGBA32F )
+};
+
+#undef EQ_FLOAT_KERNELS
+#undef EQ_DEPTH_UINT
+}
+
+const PixelKernels* getPixelKernels( const uint32_t colorFormat,
+                                     const uint32_t depthFormat )
+{
+    const size_t nKernels = sizeof( _pixelKernels ) / sizeof( PixelKernels );
+    for( size_t i = 0; i < nKernels; ++i )
+    {
+        const PixelKernels& kernels = _pixelKernels[i];
+        if( kernels.colorFormat == colorFormat &&
+            ( depthFormat == 0 || kernels.depthFormat == depthFormat ))
+        {
+            return &kernels;
+        }
+    }
+    return 0;
+}
+
+}
+}
@@ -0,0 +1,122 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_COMPOSITORKERNELS_H
+#define EQ_DETAIL_COMPOSITORKERNELS_H
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * Row kernels used by the CPU compositor.
+ *
+ * Each kernel processes one row of n pixels. The scalar implementation is the
+ * reference and the fallback; vectorized implementations are selected at
+ * runtime based on the instruction sets supported by the CPU.
+ */
+struct CompositorKernels
+{
+    /**
+     * Depth-test one row: for each pixel where the source depth is closer
+     * than the destination depth, copy source color and depth.
+     */
+    void (*mergeDepth)( uint32_t* destColor, uint32_t* destDepth,
+                        const uint32_t* color, const uint32_t* depth,
+                        size_t n );
+
+    /**
+     * Blend one row of premultiplied 8-bit RGBA or BGRA pixels into the
+     * destination, with dst = src + srcAlpha * dst for color and
+     * dst = srcAlpha * dst for alpha.
+     */
+    void (*blendRGBA8)( uint32_t* dest, const uint32_t* src, size_t n );
+
+    /** Blend one row of premultiplied RGB10_A2 or BGR10_A2 pixels. */
+    void (*blendRGB10A2)( uint32_t* dest, const uint32_t* src, size_t n );
+
+    /**
+     * Add one row of 8-bit RGBA or BGRA pixels to the per-channel 16-bit
+     * sums, four sums per pixel.
+     */
+    void (*accumRGBA8)( uint16_t* sum, const uint32_t* src, size_t n );
+
+    /**
+     * Store the rounded average of the given number of accumulated steps,
+     * 2 to 256, as one row of 8-bit pixels. May be off by one from the exact
+     * average.
+     */
+    void (*resolveRGBA8)( uint32_t* dest, const uint16_t* sum,
+                          uint32_t steps, size_t n );
+
+    /** The name of the instruction set used by the kernels. */
+    const char* name;
+};
+
+/** @return the fastest kernels supported by the running CPU. */
+const CompositorKernels& getCompositorKernels();
+
+/** @return the reference scalar kernels. */
+const CompositorKernels& getScalarCompositorKernels();
+
+/**
+ * The row kernels for one combination of color and depth format.
+ *
+ * Four byte formats use the CompositorKernels selected for the running CPU,
+ * floating point formats use kernels instantiated from the traits in
+ * pixelFormat.h.
+ */
+struct PixelKernels
+{
+    /** The external color format, e.g., EQ_COMPRESSOR_DATATYPE_RGBA16F. */
+    uint32_t colorFormat;
+
+    /** The external depth format used by mergeDepth. */
+    uint32_t depthFormat;
+
+    /** The size of one color pixel in bytes. */
+    size_t colorSize;
+
+    /** The size of one depth value in bytes. */
+    size_t depthSize;
+
+    /** Depth-test one row, see CompositorKernels::mergeDepth. */
+    void (*mergeDepth)( void* destColor, void* destDepth,
+                        const void* color, const void* depth, size_t n );
+
+    /** Blend one row of premultiplied pixels, see CompositorKernels. */
+    void (*blend)( void* dest, const void* src, size_t n );
+
+    /** One fully transparent pixel of colorSize bytes. */
+    const void* transparent;
+};
+
+/**
+ * @param colorFormat the external color format of the images.
+ * @param depthFormat the external depth format of the images, or 0 if the
+ *                    images have no depth buffer.
+ * @return the kernels for the given formats, or 0 if the CPU compositor does
+ *         not support them.
+ */
+const PixelKernels* getPixelKernels( uint32_t colorFormat,
+                                     uint32_t depthFormat );
+}
+}
+
+#endif // EQ_DETAIL_COMPOSITORKERNELS_H
@@ -0,0 +1,173 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "compressionSelector.h"
+
+#include <lunchbox/debug.h>
+#include <lunchbox/log.h>
+#include <lunchbox/scopedMutex.h>
+
+#include <algorithm>
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+/** Weight of a new sample in the running estimates. */
+const float _weight = 0.2f;
+
+/** Consecutive frames needed to change a decision. */
+const uint32_t _hysteresis = 5;
+
+/** Frames between compressions while not compressing. */
+const uint32_t _probeInterval = 100;
+
+/** The bandwidth up to which compression is used initially, in KB/s. */
+const int64_t _compressionBandwidth = 262144; // 2 GBit/s
+
+/** The minimum overhead of one image, in bytes of raw data. */
+const uint64_t _minImageOverhead = 16384; // 64x64 RGBA pixels
+
+void _update( float& value, const float sample )
+{
+    value = ( value > 0.f ) ? value + _weight * ( sample - value ) : sample;
+}
+
+unsigned _getIndex( const Frame::Buffer buffer )
+{
+    return buffer == Frame::BUFFER_DEPTH ? 1 : 0;
+}
+}
+
+CompressionSelector::Link&
+CompressionSelector::_getLink( const co::NodeID& node, const int64_t bandwidth )
+{
+    Links::iterator i = _links.find( node );
+    if( i != _links.end( ))
+        return i->second;
+
+    Link& link = _links[ node ];
+    const bool compress = ( bandwidth <= _compressionBandwidth );
+    link.estimates[0].compress = compress;
+    link.estimates[1].compress = compress;
+    return link;
+}
+
+bool CompressionSelector::useCompression( const co::NodeID& node,
+                                          const Frame::Buffer buffer,
+                                          const int64_t bandwidth )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    Link& link = _getLink( node, bandwidth );
+    Estimate& estimate = link.estimates[ _getIndex( buffer )];
+
+    if( link.throughput > 0.f && estimate.rate > 0.f )
+    {
+        // time per raw byte: compress + send compressed + decompress vs. send
+        const float compressTime = 2.f / estimate.rate +
+                                   estimate.ratio / link.throughput;
+        const float rawTime = 1.f / link.throughput;
+        const bool compress = compressTime < rawTime;
+
+        if( compress == estimate.compress )
+            estimate.votes = 0;
+        else if( ++estimate.votes >= _hysteresis )
+        {
+            LBVERB << "Switch compression " << ( compress ? "on" : "off" )
+                   << " for " << node << ", " << rawTime << " raw vs "
+                   << compressTime << " ms/byte compressed" << std::endl;
+            estimate.compress = compress;
+            estimate.votes = 0;
+        }
+    }
+
+    if( estimate.compress )
+        return true;
+
+    if( ++estimate.probe < _probeInterval )
+        return false;
+    estimate.probe = 0;
+    return true;
+}
+
+void CompressionSelector::sent( const co::NodeID& node, const uint64_t bytes,
+                                const float time )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    Links::iterator i = _links.find( node );
+    LBASSERT( i != _links.end( ));
+    if( i == _links.end() || time <= 0.f || bytes == 0 )
+        return;
+
+    Link& link = i->second;
+    _update( link.throughput, float( bytes ) / time );
+
+    // least squares fit of time = overhead + bytes * slope
+    const double weight = link.samples++ == 0 ? 1. : double( _weight );
+    const double x = double( bytes );
+    const double y = double( time );
+    link.meanBytes += weight * ( x - link.meanBytes );
+    link.meanTime += weight * ( y - link.meanTime );
+    link.meanBytes2 += weight * ( x * x - link.meanBytes2 );
+    link.meanBytesTime += weight * ( x * y - link.meanBytesTime );
+
+    const double variance = link.meanBytes2 - link.meanBytes * link.meanBytes;
+    // the fit needs samples of different sizes
+    if( variance <= 0.01 * link.meanBytes * link.meanBytes )
+        return;
+
+    const double slope = ( link.meanBytesTime -
+                           link.meanBytes * link.meanTime ) / variance;
+    if( slope > 0. )
+        link.overhead = float( std::max( 0., link.meanTime -
+                                              slope * link.meanBytes ));
+}
+
+void CompressionSelector::compressed( const co::NodeID& node,
+                                      const Frame::Buffer buffer,
+                                      const uint64_t rawBytes,
+                                      const uint64_t compressedBytes,
+                                      const float time )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    Links::iterator i = _links.find( node );
+    LBASSERT( i != _links.end( ));
+    if( i == _links.end() || rawBytes == 0 )
+        return;
+
+    Estimate& estimate = i->second.estimates[ _getIndex( buffer )];
+    estimate.probe = 0;
+    _update( estimate.ratio, float( compressedBytes ) / float( rawBytes ));
+    if( time > 0.f )
+        _update( estimate.rate, float( rawBytes ) / time );
+}
+
+uint64_t CompressionSelector::getImageOverhead() const
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    uint64_t overhead = _minImageOverhead;
+    for( Links::const_iterator i = _links.begin(); i != _links.end(); ++i )
+    {
+        const Link& link = i->second;
+        overhead = std::max( overhead,
+                             uint64_t( link.overhead * link.throughput ));
+    }
+    return overhead;
+}
+}
+}
@@ -0,0 +1,115 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_COMPRESSIONSELECTOR_H
+#define EQ_DETAIL_COMPRESSIONSELECTOR_H
+
+#include <eq/client/frame.h> // Frame::Buffer
+#include <co/types.h>
+#include <lunchbox/lock.h>
+
+#include <map>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * Selects per destination node and frame buffer if output frames are sent
+ * compressed.
+ *
+ * Keeps running estimates of the link throughput and of the compression rate
+ * and ratio of the image compressor. The buffer is compressed if compressing,
+ * sending and decompressing the data is estimated to be faster than sending
+ * the raw data. The decompression rate is not known on the sending side and
+ * is assumed to be the same as the compression rate.
+ *
+ * A decision is only changed after the other choice has been better for a
+ * number of consecutive frames. While not compressing, a buffer is compressed
+ * periodically to update the compression estimates.
+ *
+ * The per-image overhead of each link is estimated from a linear fit of the
+ * send times over the sent sizes, and used to decide if neighbouring image
+ * regions are merged before the readback.
+ *
+ * Thread safe, used from the transmit workers of all destinations.
+ */
+class CompressionSelector
+{
+public:
+    CompressionSelector() {}
+
+    /**
+     * @param node the destination node.
+     * @param buffer the frame buffer attachment.
+     * @param bandwidth the connection bandwidth in KB/s.
+     * @return true if the buffer should be compressed for the node.
+     */
+    bool useCompression( const co::NodeID& node, Frame::Buffer buffer,
+                         int64_t bandwidth );
+
+    /** Update the link throughput after sending data to the node. */
+    void sent( const co::NodeID& node, uint64_t bytes, float time );
+
+    /** Update the compression estimates after compressing a buffer. */
+    void compressed( const co::NodeID& node, Frame::Buffer buffer,
+                     uint64_t rawBytes, uint64_t compressedBytes, float time );
+
+    /**
+     * @return the number of raw bytes costing as much to send as the fixed
+     *         overhead of one image on the slowest known link.
+     */
+    uint64_t getImageOverhead() const;
+
+private:
+    struct Estimate
+    {
+        Estimate() : rate( 0.f ), ratio( 1.f ), compress( false ), votes( 0 )
+                   , probe( 0 ) {}
+
+        float rate; //!< compression rate in bytes/ms, 0 if unknown
+        float ratio; //!< compressed / raw size
+        bool compress; //!< the current decision
+        uint32_t votes; //!< consecutive frames preferring the other choice
+        uint32_t probe; //!< frames since compression estimates were updated
+    };
+
+    struct Link
+    {
+        Link() : throughput( 0.f ), overhead( 0.f ), samples( 0 )
+               , meanBytes( 0. ), meanTime( 0. ), meanBytes2( 0. )
+               , meanBytesTime( 0. ) {}
+
+        float throughput; //!< in bytes/ms, 0 if unknown
+        float overhead; //!< fixed time per sent image in ms, 0 if unknown
+        uint32_t samples; //!< number of send times in the fit
+        double meanBytes; //!< running means for the overhead fit
+        double meanTime;
+        double meanBytes2;
+        double meanBytesTime;
+        Estimate estimates[2]; //!< color, depth
+    };
+
+    typedef std::map< co::NodeID, Link > Links;
+    Links _links;
+    mutable lunchbox::Lock _lock;
+
+    Link& _getLink( const co::NodeID& node, int64_t bandwidth );
+};
+}
+}
+
+#endif // EQ_DETAIL_COMPRESSIONSELECTOR_H
@@ -0,0 +1,147 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "decompressPool.h"
+
+#include "../image.h"
+#include "../log.h"
+#include "../nodeStatistics.h"
+#include "../pixelData.h"
+
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/thread.h>
+#include <boost/foreach.hpp>
+
+#include <algorithm>
+#include <thread>
+
+#ifdef EQUALIZER_USE_HWLOC_GL
+#  include <hwloc.h>
+#endif
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+/** The upper limit of decompression threads per node. */
+const size_t _maxThreads = 8;
+
+size_t _getNumCores()
+{
+#ifdef EQUALIZER_USE_HWLOC_GL
+    hwloc_topology_t topology;
+    if( hwloc_topology_init( &topology ) == 0 )
+    {
+        int nCores = -1;
+        if( hwloc_topology_load( topology ) == 0 )
+            nCores = hwloc_get_nbobjs_by_type( topology, HWLOC_OBJ_CORE );
+        hwloc_topology_destroy( topology );
+        if( nCores > 0 )
+            return size_t( nCores );
+    }
+#endif
+    return std::max( 1u, std::thread::hardware_concurrency( ));
+}
+}
+
+class DecompressThread : public lunchbox::Thread
+{
+public:
+    explicit DecompressThread( DecompressPool& pool ) : _pool( pool ) {}
+    virtual ~DecompressThread() {}
+
+protected:
+    bool init() override { setName( "Decompress" ); return true; }
+
+    void run() override
+    {
+        while( true )
+        {
+            const DecompressPool::Task task = _pool._tasks.pop();
+            if( !task.image )
+                return;
+
+            {
+                NodeStatistics event( Statistic::NODE_FRAME_DECOMPRESS,
+                                      _pool._node, task.frameNumber );
+
+                BOOST_FOREACH( const DecompressPool::Buffer& buffer,
+                               task.buffers )
+                {
+                    PixelData pixelData;
+                    pixelData.internalFormat  = buffer.internalFormat;
+                    pixelData.externalFormat  = buffer.externalFormat;
+                    pixelData.pixelSize       = buffer.pixelSize;
+                    pixelData.pvp             = buffer.pvp;
+                    pixelData.compressorFlags = buffer.compressorFlags;
+                    pixelData.compressedData  = buffer.data;
+                    task.image->setPixelData( buffer.buffer, pixelData );
+                }
+            }
+            --( *task.pending );
+        }
+    }
+
+private:
+    DecompressPool& _pool;
+};
+
+DecompressPool::DecompressPool( Node* node )
+    : _node( node )
+{}
+
+DecompressPool::~DecompressPool()
+{
+    for( size_t i = 0; i < _threads.size(); ++i )
+        _tasks.push( Task( )); // stop
+    BOOST_FOREACH( DecompressThread* thread, _threads )
+    {
+        thread->join();
+        delete thread;
+    }
+}
+
+void DecompressPool::push( const Task& task )
+{
+    LBASSERT( task.image );
+    LBASSERT( task.pending );
+    _start();
+    _tasks.push( task );
+}
+
+void DecompressPool::_start()
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    if( !_threads.empty( ))
+        return;
+
+    // leave one core to the receiving command thread
+    const size_t nCores = _getNumCores();
+    const size_t nThreads = std::min( std::max( nCores, size_t( 2 )) - 1,
+                                      _maxThreads );
+    for( size_t i = 0; i < nThreads; ++i )
+    {
+        DecompressThread* thread = new DecompressThread( *this );
+        thread->start();
+        _threads.push_back( thread );
+    }
+    LBLOG( LOG_ASSEMBLY ) << "Started " << nThreads << " decompression threads"
+                          << std::endl;
+}
+}
+}
@@ -0,0 +1,89 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_DECOMPRESSPOOL_H
+#define EQ_DETAIL_DECOMPRESSPOOL_H
+
+#include <eq/client/frame.h> // Frame::Buffer
+#include <eq/client/types.h>
+#include <eq/fabric/pixelViewport.h>
+
+#include <lunchbox/lock.h>
+#include <lunchbox/monitor.h>
+#include <lunchbox/mtQueue.h>
+#include <pression/compressorResult.h>
+
+#include <vector>
+
+namespace eq
+{
+namespace detail
+{
+class DecompressThread;
+
+/**
+ * A node-wide set of threads decompressing received images in parallel.
+ *
+ * The number of threads is derived from the number of cores. Tasks are
+ * executed in the order they are pushed, by whichever thread is idle.
+ */
+class DecompressPool
+{
+public:
+    /** The compressed data of one image buffer. */
+    struct Buffer
+    {
+        Frame::Buffer buffer;
+        uint32_t internalFormat;
+        uint32_t externalFormat;
+        uint32_t pixelSize;
+        PixelViewport pvp;
+        uint32_t compressorFlags;
+        pression::CompressorResult data;
+    };
+    typedef std::vector< Buffer > Buffers;
+
+    /** Decompress all buffers of one image. */
+    struct Task
+    {
+        Task() : image( 0 ), pending( 0 ), frameNumber( 0 ) {}
+
+        Image* image; //!< the destination image, 0 to stop a thread
+        Buffers buffers;
+        lunchbox::Monitor< uint32_t >* pending; //!< decremented when done
+        uint32_t frameNumber; //!< for the NODE_FRAME_DECOMPRESS statistic
+    };
+
+    /** @param node the node owning the pool, used for statistics. */
+    explicit DecompressPool( Node* node );
+    ~DecompressPool();
+
+    /** Queue a decompression task, starting the threads if needed. */
+    void push( const Task& task );
+
+private:
+    friend class DecompressThread;
+    Node* const _node;
+    lunchbox::MTQueue< Task > _tasks;
+    std::vector< DecompressThread* > _threads;
+    lunchbox::Lock _lock;
+
+    void _start();
+};
+}
+}
+
+#endif // EQ_DETAIL_DECOMPRESSPOOL_H
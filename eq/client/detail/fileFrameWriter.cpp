@@ -23,11 +23,22 @@
 #include <eq/client/pipe.h>
 
 #include <lunchbox/log.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/thread.h>
+#include <boost/foreach.hpp>
 
+#include <algorithm>
 #include <sstream>
+#include <thread>
 
 namespace
 {
+/** The upper limit of writer threads per channel. */
+const size_t _maxThreads = 4;
+
+/** The number of pooled images per writer thread. */
+const size_t _imagesPerThread = 2;
+
 std::string _buildFileName( const eq::Channel& channel )
 {
     std::stringstream name;
@@ -41,21 +52,122 @@ namespace eq
 {
 namespace detail
 {
+class FileWriterThread : public lunchbox::Thread
+{
+public:
+    explicit FileWriterThread( FileFrameWriter& writer ) : _writer( writer ) {}
+    virtual ~FileWriterThread() {}
+
+protected:
+    bool init() override { setName( "FileWriter" ); return true; }
+
+    void run() override
+    {
+        while( true )
+        {
+            const FileFrameWriter::Task task = _writer._tasks.pop();
+            if( !task.image )
+                return;
+
+            if( !task.image->writeImage( task.fileName,
+                                         eq::Frame::BUFFER_COLOR ))
+            {
+                LBWARN << "Could not write file " << task.fileName
+                       << std::endl;
+            }
+            _writer._releaseImage( task.image );
+        }
+    }
+
+private:
+    FileFrameWriter& _writer;
+};
+
 FileFrameWriter::FileFrameWriter()
     : ResultImageListener()
+    , _dropped( 0 )
+{
+}
+
+FileFrameWriter::~FileFrameWriter()
 {
+    // finish all queued writes
+    for( size_t i = 0; i < _threads.size(); ++i )
+        _tasks.push( Task( )); // stop
+    BOOST_FOREACH( FileWriterThread* thread, _threads )
+    {
+        thread->join();
+        delete thread;
+    }
+
+    BOOST_FOREACH( eq::Image* image, _images )
+        delete image;
+
+    if( _dropped > 0 )
+        LBWARN << "Dropped " << _dropped << " frames while dumping images"
+               << std::endl;
 }
 
 void FileFrameWriter::notifyNewImage( eq::Channel& channel,
                                       const eq::Image& image )
 {
-    const std::string& fileName = _buildFileName( channel );
-    if( !image.writeImage( fileName, eq::Frame::BUFFER_COLOR ))
-        LBWARN << "Could not write file " << fileName << std::endl;
+    if( !image.hasPixelData( eq::Frame::BUFFER_COLOR ))
+        return;
+
+    eq::Image* copy = _getImage();
+    if( !copy )
+    {
+        if( ++_dropped == 1 )
+            LBWARN << "Image writers are busy, dropping frames" << std::endl;
+        return;
+    }
+
+    copy->setPixelData( eq::Frame::BUFFER_COLOR,
+                        image.getPixelData( eq::Frame::BUFFER_COLOR ));
+
+    Task task;
+    task.image = copy;
+    task.fileName = _buildFileName( channel );
+    _tasks.push( task );
 }
 
-FileFrameWriter::~FileFrameWriter()
+eq::Image* FileFrameWriter::_getImage()
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    if( !_freeImages.empty( ))
+    {
+        eq::Image* image = _freeImages.back();
+        _freeImages.pop_back();
+        return image;
+    }
+
+    if( _threads.empty( ))
+    {
+        const size_t nThreads =
+            std::min( size_t( std::max( 1u, std::thread::hardware_concurrency()
+                                            / 2 )), _maxThreads );
+        for( size_t i = 0; i < nThreads; ++i )
+        {
+            FileWriterThread* thread = new FileWriterThread( *this );
+            thread->start();
+            _threads.push_back( thread );
+        }
+    }
+
+    if( _images.size() >= _threads.size() * _imagesPerThread )
+        return 0;
+
+    eq::Image* image = new eq::Image;
+    image->setAlphaUsage( true );
+    image->setStorageType( eq::Frame::TYPE_MEMORY );
+    _images.push_back( image );
+    return image;
+}
+
+void FileFrameWriter::_releaseImage( eq::Image* image )
 {
+    lunchbox::ScopedMutex<> mutex( _lock );
+    _freeImages.push_back( image );
 }
 
 }
@@ -21,14 +21,25 @@
 #include <eq/client/resultImageListener.h> // base class
 #include <eq/client/types.h>
 
+#include <lunchbox/atomic.h>
+#include <lunchbox/lock.h>
+#include <lunchbox/mtQueue.h>
+
+#include <vector>
+
 namespace eq
 {
 namespace detail
 {
+class FileWriterThread;
 
 /**
  * Persist the color buffer of a channel to a file.
- * The name of the file is Channel::SATTR_DUMP_IMAGE.rgb
+ * The name of the file is Channel::SATTR_DUMP_IMAGE<frameNumber>.rgb
+ *
+ * The pixels are copied into a pooled image on the pipe thread, and written
+ * by a set of background threads. If all pooled images are queued, the frame
+ * is dropped instead of blocking the rendering.
  */
 class FileFrameWriter : public ResultImageListener
 {
@@ -37,6 +48,29 @@ public:
     ~FileFrameWriter();
 
     void notifyNewImage( eq::Channel& channel, const eq::Image& image ) final;
+
+private:
+    friend class FileWriterThread;
+
+    struct Task
+    {
+        Task() : image( 0 ) {}
+
+        eq::Image* image; //!< the image to write, 0 to stop a thread
+        std::string fileName;
+    };
+
+    lunchbox::MTQueue< Task > _tasks;
+    std::vector< FileWriterThread* > _threads;
+
+    lunchbox::Lock _lock; //!< protects the image pool
+    std::vector< eq::Image* > _images; //!< all pooled images
+    std::vector< eq::Image* > _freeImages; //!< pooled images not queued
+
+    lunchbox::a_int32_t _dropped; //!< frames not written
+
+    eq::Image* _getImage();
+    void _releaseImage( eq::Image* image );
 };
 
 }
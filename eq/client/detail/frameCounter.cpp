@@ -0,0 +1,62 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "frameCounter.h"
+
+#include <lunchbox/thread.h>
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+/** Polls of the frame number before parking a waiting thread. */
+const size_t _nSpins = 100;
+}
+
+FrameCounter& FrameCounter::operator = ( const uint32_t value )
+{
+    // Sequentially consistent with the waiter registration in waitGE: either
+    // the waiter sees the new value, or we see the waiter.
+    _value.store( value );
+    if( _waiters.load() == 0 )
+        return *this;
+
+    _condition.lock();
+    _condition.broadcast();
+    _condition.unlock();
+    return *this;
+}
+
+void FrameCounter::waitGE( const uint32_t value ) const
+{
+    for( size_t i = 0; i < _nSpins; ++i )
+    {
+        if( get() >= value )
+            return;
+        lunchbox::Thread::yield();
+    }
+
+    _condition.lock();
+    ++_waiters;
+    while( _value.load() < value )
+        _condition.wait();
+    --_waiters;
+    _condition.unlock();
+}
+}
+}
@@ -0,0 +1,62 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_FRAMECOUNTER_H
+#define EQ_DETAIL_FRAMECOUNTER_H
+
+#include <lunchbox/condition.h> // member
+#include <lunchbox/nonCopyable.h> // base class
+
+#include <atomic>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * A frame number which threads can wait on.
+ *
+ * Replaces a lunchbox::Monitor for the per-frame hand-off between the node,
+ * pipe and channel threads. Reading and advancing the number is lock-free. A
+ * waiter spins briefly, since the frame is often finished by the time it
+ * waits, and only then parks on a condition. Setting the number takes the
+ * condition lock only if a thread is parked.
+ */
+class FrameCounter : public lunchbox::NonCopyable
+{
+public:
+    explicit FrameCounter( const uint32_t value = 0 )
+        : _value( value ), _waiters( 0 ) {}
+
+    /** Set a new frame number and wake up the threads waiting on it. */
+    FrameCounter& operator = ( const uint32_t value );
+
+    /** @return the current frame number. */
+    uint32_t get() const { return _value.load( std::memory_order_acquire ); }
+    operator uint32_t() const { return get(); }
+
+    /** Wait until the frame number is greater or equal to the given one. */
+    void waitGE( const uint32_t value ) const;
+
+private:
+    std::atomic< uint32_t > _value;
+    mutable std::atomic< uint32_t > _waiters; //!< parked threads
+    mutable lunchbox::Condition _condition;
+};
+}
+}
+
+#endif // EQ_DETAIL_FRAMECOUNTER_H
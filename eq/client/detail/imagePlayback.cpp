@@ -0,0 +1,188 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "imagePlayback.h"
+
+#include <eq/client/image.h>
+
+#include <lunchbox/log.h>
+#include <lunchbox/thread.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+/** The number of frames loaded ahead of the current frame. */
+const uint32_t _readAhead = 4;
+}
+
+class ImageLoaderThread : public lunchbox::Thread
+{
+public:
+    explicit ImageLoaderThread( ImagePlayback& playback )
+        : _playback( playback ) {}
+    virtual ~ImageLoaderThread() {}
+
+protected:
+    bool init() override { setName( "ImageLoader" ); return true; }
+
+    void run() override
+    {
+        for( ;; )
+        {
+            const uint32_t frameNumber = _playback._requests.pop();
+            if( frameNumber == 0 )
+                return;
+            _playback._results.push( _playback._load( frameNumber ));
+        }
+    }
+
+private:
+    ImagePlayback& _playback;
+};
+
+ImagePlayback::ImagePlayback()
+    : _thread( 0 )
+    , _image( 0 )
+    , _nextRequest( 0 )
+    , _nFrames( 0 )
+{
+}
+
+ImagePlayback::~ImagePlayback()
+{
+    _stop();
+}
+
+const Image* ImagePlayback::getImage( const std::string& filenameTemplate,
+                                      const uint32_t frameNumber )
+{
+    if( frameNumber == 0 )
+        return 0;
+
+    if( filenameTemplate != _template )
+    {
+        _stop();
+        _template = filenameTemplate;
+    }
+
+    if( !_thread )
+    {
+        _thread = new ImageLoaderThread( *this );
+        if( !_thread->start( ))
+        {
+            LBWARN << "Can't start image loader thread" << std::endl;
+            delete _thread;
+            _thread = 0;
+            return 0;
+        }
+        _nextRequest = frameNumber;
+    }
+
+    // frames skipped by the caller are loaded and dropped below
+    _nextRequest = std::max( _nextRequest, frameNumber );
+    while( _nextRequest < frameNumber + _readAhead )
+        _requests.push( _nextRequest++ );
+
+    delete _image;
+    _image = 0;
+    for( ;; )
+    {
+        const Task task = _results.pop();
+        if( task.frameNumber == frameNumber )
+        {
+            _image = task.image;
+            return _image;
+        }
+        delete task.image;
+    }
+}
+
+void ImagePlayback::_stop()
+{
+    if( _thread )
+    {
+        _requests.push( 0 );
+        _thread->join();
+        delete _thread;
+        _thread = 0;
+    }
+
+    Task task;
+    while( _results.tryPop( task ))
+        delete task.image;
+    delete _image;
+    _image = 0;
+    _nFrames = 0;
+}
+
+ImagePlayback::Task ImagePlayback::_load( const uint32_t frameNumber )
+{
+    Task task;
+    task.frameNumber = frameNumber;
+
+    uint32_t recorded = _nFrames > 0 ? ( frameNumber - 1 ) % _nFrames + 1 :
+                                       frameNumber;
+    std::string filename = _getFilename( recorded, ".rgb" );
+    if( !std::ifstream( filename.c_str( )).is_open( ))
+    {
+        // the first missing frame ends the recording
+        if( _nFrames > 0 || recorded == 1 )
+        {
+            if( recorded == 1 )
+                LBWARN << "No recorded image " << filename << std::endl;
+            return task;
+        }
+        _nFrames = recorded - 1;
+        recorded = ( frameNumber - 1 ) % _nFrames + 1;
+        filename = _getFilename( recorded, ".rgb" );
+        LBINFO << "Repeating " << _nFrames << " recorded frames of "
+               << _template << std::endl;
+    }
+
+    Image* image = new Image;
+    image->setAlphaUsage( true );
+    image->setStorageType( Frame::TYPE_MEMORY );
+    if( !image->readImage( filename, Frame::BUFFER_COLOR ))
+    {
+        delete image;
+        return task;
+    }
+
+    const std::string depthname = _getFilename( recorded, "_depth.rgb" );
+    if( std::ifstream( depthname.c_str( )).is_open( ))
+        image->readImage( depthname, Frame::BUFFER_DEPTH );
+
+    task.image = image;
+    return task;
+}
+
+std::string ImagePlayback::_getFilename( const uint32_t frameNumber,
+                                         const std::string& suffix ) const
+{
+    std::ostringstream name;
+    name << _template << frameNumber << suffix;
+    return name.str();
+}
+}
+}
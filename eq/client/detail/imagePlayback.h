@@ -0,0 +1,79 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQ_DETAIL_IMAGEPLAYBACK_H
+#define EQ_DETAIL_IMAGEPLAYBACK_H
+
+#include <eq/client/types.h>
+
+#include <lunchbox/mtQueue.h>
+
+namespace eq
+{
+namespace detail
+{
+class ImageLoaderThread;
+
+/**
+ * Loads the recorded images of a channel for Channel::SATTR_PLAYBACK_IMAGES.
+ *
+ * The color of frame n is read from <template>n.rgb, as written by
+ * Channel::SATTR_DUMP_IMAGE, and the depth, if present, from
+ * <template>n_depth.rgb. A background thread reads the following frames
+ * ahead. A recording of n frames is repeated every n frames.
+ */
+class ImagePlayback
+{
+public:
+    ImagePlayback();
+    ~ImagePlayback();
+
+    /**
+     * @return the recorded image of the given frame, valid until the next
+     *         call, or 0 if the recording has no images.
+     */
+    const Image* getImage( const std::string& filenameTemplate,
+                           uint32_t frameNumber );
+
+private:
+    friend class ImageLoaderThread;
+
+    struct Task
+    {
+        Task() : frameNumber( 0 ), image( 0 ) {}
+
+        uint32_t frameNumber;
+        Image* image; //!< the loaded image, 0 if not recorded
+    };
+
+    std::string _template;
+    ImageLoaderThread* _thread;
+    lunchbox::MTQueue< uint32_t > _requests; //!< frames to load, 0 stops
+    lunchbox::MTQueue< Task > _results; //!< loaded frames in request order
+    Image* _image; //!< the image returned by the last getImage()
+    uint32_t _nextRequest;
+    uint32_t _nFrames; //!< frames in the recording, 0 if not known yet
+
+    void _stop();
+    Task _load( uint32_t frameNumber ); // loader thread
+    std::string _getFilename( uint32_t frameNumber,
+                              const std::string& suffix ) const;
+};
+}
+}
+
+#endif // EQ_DETAIL_IMAGEPLAYBACK_H
@@ -0,0 +1,102 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "imagePool.h"
+
+#include "../image.h"
+
+#include <eq/fabric/statistic.h>
+#include <lunchbox/scopedMutex.h>
+
+namespace eq
+{
+namespace detail
+{
+ImagePool::ImagePool()
+    : _bytes( 0 )
+    , _hits( 0 )
+    , _misses( 0 )
+{}
+
+ImagePool::~ImagePool()
+{
+    flush();
+}
+
+Image* ImagePool::alloc( const size_t size )
+{
+    Image* image = 0;
+    {
+        lunchbox::ScopedMutex<> mutex( _lock );
+        if( _images.empty( ))
+        {
+            ++_misses;
+            return new Image;
+        }
+
+        Images::iterator i = _images.lower_bound( size );
+        if( i == _images.end( ))
+        {
+            // reuse the largest image, its buffers will be resized
+            --i;
+            ++_misses;
+        }
+        else
+            ++_hits;
+
+        image = i->second;
+        _bytes -= i->first;
+        _images.erase( i );
+    }
+
+    image->reset();
+    return image;
+}
+
+void ImagePool::release( Image* image )
+{
+    const size_t size = image->getAllocatedSize();
+
+    lunchbox::ScopedMutex<> mutex( _lock );
+    _images.insert( std::make_pair( size, image ));
+    _bytes += size;
+}
+
+void ImagePool::flush()
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    for( Images::const_iterator i = _images.begin(); i != _images.end(); ++i )
+    {
+        Image* image = i->second;
+        image->resetPlugins();
+        image->flush();
+        delete image;
+    }
+    _images.clear();
+    _bytes = 0;
+}
+
+void ImagePool::sample( Statistic& stat )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    stat.poolBytes = _bytes;
+    stat.poolHits = _hits;
+    stat.poolMisses = _misses;
+    _hits = 0;
+    _misses = 0;
+}
+}
+}
@@ -0,0 +1,75 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_IMAGEPOOL_H
+#define EQ_DETAIL_IMAGEPOOL_H
+
+#include <eq/client/types.h>
+#include <lunchbox/lock.h>
+
+#include <map>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * A thread-safe cache of images and their pixel buffers.
+ *
+ * Released images are kept sorted by the size of their main memory buffers,
+ * and reused by all frame datas of a node. An allocation reuses the smallest
+ * image holding at least the requested size.
+ */
+class ImagePool
+{
+public:
+    ImagePool();
+    ~ImagePool();
+
+    /**
+     * Obtain an image.
+     *
+     * @param size the expected size of the pixel data in bytes, 0 if unknown.
+     * @return a reset image, reused or newly allocated.
+     */
+    Image* alloc( size_t size );
+
+    /** Return an image to the pool. */
+    void release( Image* image );
+
+    /** Free all pooled images. */
+    void flush();
+
+    /**
+     * Fill in the pool counters, and reset the hit and miss counters.
+     *
+     * @param stat the NODE_IMAGE_POOL statistic to update.
+     */
+    void sample( Statistic& stat );
+
+private:
+    typedef std::multimap< size_t, Image* > Images;
+    Images _images;
+    lunchbox::Lock _lock;
+
+    uint64_t _bytes; //!< the memory held by pooled images
+    uint32_t _hits; //!< allocations with a large enough pooled image
+    uint32_t _misses; //!< allocations needing new memory
+};
+}
+}
+
+#endif // EQ_DETAIL_IMAGEPOOL_H
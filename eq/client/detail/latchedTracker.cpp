@@ -0,0 +1,114 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "latchedTracker.h"
+
+#include "../log.h"
+
+#include <lunchbox/scopedMutex.h>
+#include <boost/bind.hpp>
+
+namespace eq
+{
+namespace detail
+{
+using boost::asio::ip::udp;
+
+LatchedTracker::LatchedTracker( const uint16_t port )
+    : _port( port )
+    , _socket( _service )
+    , _head( Matrix4f::IDENTITY )
+    , _received( false )
+{}
+
+LatchedTracker::~LatchedTracker()
+{
+    if( !isRunning( ))
+        return;
+
+    _service.stop();
+    join();
+
+    boost::system::error_code error;
+    _socket.close( error );
+}
+
+bool LatchedTracker::open()
+{
+    const udp::endpoint endpoint( udp::v4(), _port );
+    boost::system::error_code error;
+    _socket.open( endpoint.protocol(), error );
+    if( !error ) // allow several render clients per host
+        _socket.set_option( udp::socket::reuse_address( true ), error );
+    if( !error )
+        _socket.bind( endpoint, error );
+    if( error )
+    {
+        LBWARN << "Can't receive head matrices on port " << _port << ": "
+               << error.message() << std::endl;
+        _socket.close( error );
+        return false;
+    }
+
+    _receive();
+    if( start( ))
+        return true;
+
+    _socket.close( error );
+    return false;
+}
+
+bool LatchedTracker::getHeadMatrix( Matrix4f& head ) const
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    if( !_received )
+        return false;
+    head = _head;
+    return true;
+}
+
+void LatchedTracker::run()
+{
+    _service.run();
+}
+
+void LatchedTracker::_receive()
+{
+    namespace ph = boost::asio::placeholders;
+    _socket.async_receive_from( boost::asio::buffer( _data, sizeof( _data )),
+                                _sender,
+                                boost::bind( &LatchedTracker::_onReceive, this,
+                                             ph::error, ph::bytes_transferred ));
+}
+
+void LatchedTracker::_onReceive( const boost::system::error_code& error,
+                                 const size_t size )
+{
+    if( error == boost::asio::error::operation_aborted )
+        return;
+
+    if( !error && size == 16 * sizeof( float ))
+    {
+        lunchbox::ScopedMutex<> mutex( _lock );
+        std::copy( _data, _data + 16, _head.array );
+        _received = true;
+    }
+    _receive();
+}
+
+}
+}
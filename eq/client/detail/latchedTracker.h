@@ -0,0 +1,77 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQ_DETAIL_LATCHEDTRACKER_H
+#define EQ_DETAIL_LATCHEDTRACKER_H
+
+#include <eq/client/types.h>
+#include <lunchbox/lock.h>
+#include <lunchbox/thread.h>
+#include <boost/asio.hpp>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * @internal
+ * Receives head matrices from a UDP stream for late latching.
+ *
+ * The receiving thread keeps only the latest matrix, which the pipe threads
+ * read right before drawing.
+ */
+class LatchedTracker : public lunchbox::Thread
+{
+public:
+    /** Construct a new tracker receiving on the given port. */
+    explicit LatchedTracker( uint16_t port );
+
+    /** Destruct this tracker and stop receiving. */
+    virtual ~LatchedTracker();
+
+    /** Bind the port and start receiving. @return true on success. */
+    bool open();
+
+    /**
+     * Get the latest received head matrix.
+     *
+     * @param head the matrix to set.
+     * @return true if a matrix was received, false otherwise.
+     */
+    bool getHeadMatrix( Matrix4f& head ) const;
+
+protected:
+    bool init() override { setName( "Tracker" ); return true; }
+    void run() override;
+
+private:
+    const uint16_t _port;
+    boost::asio::io_service _service;
+    boost::asio::ip::udp::socket _socket;
+    boost::asio::ip::udp::endpoint _sender;
+    float _data[ 17 ]; //!< one more to detect oversized datagrams
+
+    mutable lunchbox::Lock _lock;
+    Matrix4f _head;
+    bool _received;
+
+    void _receive();
+    void _onReceive( const boost::system::error_code& error, size_t size );
+};
+}
+}
+#endif // EQ_DETAIL_LATCHEDTRACKER_H
@@ -0,0 +1,208 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "multiView.h"
+
+#include "../channel.h"
+#include "../gl.h"
+#include "../log.h"
+
+#include <eq/util/objectManager.h>
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+enum Key
+{
+    KEY_COLOR, //!< color layers, one per eye
+    KEY_DEPTH  //!< depth and stencil layers, one per eye
+};
+}
+
+MultiView::MultiView()
+    : _glewContext( 0 )
+    , _drawFBO( 0 )
+    , _readFBO( 0 )
+    , _size( Vector2i::ZERO )
+    , _previousDrawFBO( 0 )
+    , _previousReadFBO( 0 )
+    , _taskID( 0 )
+    , _bound( false )
+    , _supported( true )
+    , _blitDepth( true )
+{}
+
+MultiView::~MultiView()
+{
+    if( _drawFBO )
+        LBWARN << "Multi view frame buffers not flushed" << std::endl;
+}
+
+const char* MultiView::_getKey( const size_t index ) const
+{
+    return reinterpret_cast< const char* >( this ) + index;
+}
+
+bool MultiView::bind( eq::Channel& channel )
+{
+    _glewContext = channel.glewGetContext();
+    const PixelViewport& pvp = channel.getPixelViewport();
+    if( !_supported || !GLEW_VERSION_3_2 || !pvp.hasArea( ))
+        return false;
+
+    // cover the channel at its window position, so that applyViewport() works
+    const Vector2i size( pvp.x + pvp.w, pvp.y + pvp.h );
+    util::ObjectManager& om = channel.getObjectManager();
+    const bool created =
+        om.getTexture( _getKey( KEY_COLOR )) == util::ObjectManager::INVALID;
+    const unsigned color = om.obtainTexture( _getKey( KEY_COLOR ));
+    const unsigned depth = om.obtainTexture( _getKey( KEY_DEPTH ));
+
+    if( created || size != _size )
+    {
+        EQ_GL_CALL( glBindTexture( GL_TEXTURE_2D_ARRAY, color ));
+        EQ_GL_CALL( glTexImage3D( GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, size.x(),
+                                  size.y(), 2, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                                  0 ));
+        EQ_GL_CALL( glBindTexture( GL_TEXTURE_2D_ARRAY, depth ));
+        EQ_GL_CALL( glTexImage3D( GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH24_STENCIL8,
+                                  size.x(), size.y(), 2, 0, GL_DEPTH_STENCIL,
+                                  GL_UNSIGNED_INT_24_8, 0 ));
+        EQ_GL_CALL( glBindTexture( GL_TEXTURE_2D_ARRAY, 0 ));
+        _size = size;
+    }
+
+    if( !_drawFBO )
+    {
+        EQ_GL_CALL( glGenFramebuffers( 1, &_drawFBO ));
+        EQ_GL_CALL( glGenFramebuffers( 1, &_readFBO ));
+    }
+
+    GLint previous = 0;
+    EQ_GL_CALL( glGetIntegerv( GL_DRAW_FRAMEBUFFER_BINDING, &previous ));
+    _previousDrawFBO = previous;
+    EQ_GL_CALL( glGetIntegerv( GL_READ_FRAMEBUFFER_BINDING, &previous ));
+    _previousReadFBO = previous;
+
+    EQ_GL_CALL( glBindFramebuffer( GL_FRAMEBUFFER, _drawFBO ));
+    EQ_GL_CALL( glFramebufferTexture( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                      color, 0 ));
+    EQ_GL_CALL( glFramebufferTexture( GL_FRAMEBUFFER,
+                                      GL_DEPTH_STENCIL_ATTACHMENT, depth, 0 ));
+    if( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
+    {
+        LBWARN << "Layered frame buffer incomplete, drawing eyes separately"
+               << std::endl;
+        _supported = false;
+        _bound = true;
+        unbind( channel );
+        return false;
+    }
+
+    EQ_GL_CALL( glDrawBuffer( GL_COLOR_ATTACHMENT0 ));
+    EQ_GL_CALL( glReadBuffer( GL_COLOR_ATTACHMENT0 ));
+    EQ_GL_CALL( glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT |
+                         GL_STENCIL_BUFFER_BIT ));
+    _bound = true;
+    return true;
+}
+
+void MultiView::unbind( eq::Channel& channel )
+{
+    if( !_bound )
+        return;
+
+    _glewContext = channel.glewGetContext();
+    EQ_GL_CALL( glBindFramebuffer( GL_DRAW_FRAMEBUFFER, _previousDrawFBO ));
+    EQ_GL_CALL( glBindFramebuffer( GL_READ_FRAMEBUFFER, _previousReadFBO ));
+    _bound = false;
+}
+
+void MultiView::blit( eq::Channel& channel, const Eye eye )
+{
+    _glewContext = channel.glewGetContext();
+    const PixelViewport& pvp = channel.getPixelViewport();
+    if( !_readFBO || pvp.x + pvp.w > _size.x() || pvp.y + pvp.h > _size.y( ))
+        return;
+
+    util::ObjectManager& om = channel.getObjectManager();
+    const unsigned color = om.getTexture( _getKey( KEY_COLOR ));
+    const unsigned depth = om.getTexture( _getKey( KEY_DEPTH ));
+    const GLint layer = eye == EYE_RIGHT ? 1 : 0;
+
+    EQ_GL_CALL( channel.applyBuffer( ));
+    EQ_GL_CALL( channel.applyViewport( ));
+
+    GLint previous = 0;
+    EQ_GL_CALL( glGetIntegerv( GL_READ_FRAMEBUFFER_BINDING, &previous ));
+    EQ_GL_CALL( glBindFramebuffer( GL_READ_FRAMEBUFFER, _readFBO ));
+    EQ_GL_CALL( glFramebufferTextureLayer( GL_READ_FRAMEBUFFER,
+                                           GL_COLOR_ATTACHMENT0, color, 0,
+                                           layer ));
+    EQ_GL_CALL( glFramebufferTextureLayer( GL_READ_FRAMEBUFFER,
+                                           GL_DEPTH_STENCIL_ATTACHMENT, depth,
+                                           0, layer ));
+    EQ_GL_CALL( glReadBuffer( GL_COLOR_ATTACHMENT0 ));
+
+    const GLint x1 = pvp.x + pvp.w;
+    const GLint y1 = pvp.y + pvp.h;
+    if( _blitDepth )
+    {
+        // depth is only copied if the window has the same depth format
+        glGetError();
+        glBlitFramebuffer( pvp.x, pvp.y, x1, y1, pvp.x, pvp.y, x1, y1,
+                           GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT,
+                           GL_NEAREST );
+        if( glGetError() != GL_NO_ERROR )
+        {
+            LBINFO << "Window depth format differs, copying multi view color "
+                   << "only" << std::endl;
+            _blitDepth = false;
+        }
+    }
+    if( !_blitDepth )
+    {
+        EQ_GL_CALL( glBlitFramebuffer( pvp.x, pvp.y, x1, y1, pvp.x, pvp.y,
+                                       x1, y1, GL_COLOR_BUFFER_BIT,
+                                       GL_NEAREST ));
+    }
+
+    EQ_GL_CALL( glBindFramebuffer( GL_READ_FRAMEBUFFER, previous ));
+}
+
+void MultiView::flush( eq::Channel& channel )
+{
+    _glewContext = channel.glewGetContext();
+    util::ObjectManager& om = channel.getObjectManager();
+    om.deleteTexture( _getKey( KEY_COLOR ));
+    om.deleteTexture( _getKey( KEY_DEPTH ));
+
+    if( _drawFBO )
+    {
+        EQ_GL_CALL( glDeleteFramebuffers( 1, &_drawFBO ));
+        EQ_GL_CALL( glDeleteFramebuffers( 1, &_readFBO ));
+    }
+    _drawFBO = 0;
+    _readFBO = 0;
+    _size = Vector2i::ZERO;
+    _frameID = uint128_t();
+    _taskID = 0;
+}
+}
+}
@@ -0,0 +1,95 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_MULTIVIEW_H
+#define EQ_DETAIL_MULTIVIEW_H
+
+#include <eq/client/types.h>
+#include <eq/fabric/renderContext.h>
+#include <boost/noncopyable.hpp>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * @internal
+ * A layered frame buffer with one layer per stereo eye.
+ *
+ * Used to draw both eyes in one pass, see Channel::IATTR_HINT_MULTIVIEW. The
+ * layers are copied to the draw buffers of their eye afterwards. All methods
+ * are called from the pipe thread with the channel's window context current.
+ */
+class MultiView : public boost::noncopyable
+{
+public:
+    MultiView();
+    ~MultiView();
+
+    /**
+     * Bind and clear the layered frame buffer covering the channel's pixel
+     * viewport.
+     *
+     * @return true if the frame buffer is bound, false if it is not supported.
+     */
+    bool bind( eq::Channel& channel );
+
+    /** @return true between bind() and unbind(). */
+    bool isBound() const { return _bound; }
+
+    /** Rebind the frame buffer of the channel's window. */
+    void unbind( eq::Channel& channel );
+
+    /**
+     * Copy the given eye layer of the last bound frame to the channel's
+     * current draw buffer.
+     */
+    void blit( eq::Channel& channel, Eye eye );
+
+    /** Remember the frame and task of the context drawn into the layers. */
+    void setImage( const RenderContext& context )
+        { _frameID = context.frameID; _taskID = context.taskID; }
+
+    /** @return true if the layers hold the image of the context's task. */
+    bool hasImage( const RenderContext& context ) const
+        { return _frameID == context.frameID && _taskID == context.taskID; }
+
+    /** @return true if OpenGL objects have been allocated. */
+    bool hasFrameBuffers() const { return _drawFBO != 0; }
+
+    /** Release all OpenGL objects of the channel's object manager. */
+    void flush( eq::Channel& channel );
+
+private:
+    const GLEWContext* _glewContext;
+    unsigned _drawFBO; //!< layered, for the multi view draw
+    unsigned _readFBO; //!< one layer, for the copies
+    Vector2i _size; //!< of the layered textures
+    unsigned _previousDrawFBO; //!< bound before bind()
+    unsigned _previousReadFBO; //!< bound before bind()
+    uint128_t _frameID; //!< of the layered images
+    uint32_t _taskID; //!< of the layered images
+    bool _bound;
+    bool _supported; //!< unset if the layered frame buffer is incomplete
+    bool _blitDepth; //!< unset if the window depth format differs
+
+    const GLEWContext* glewGetContext() const { return _glewContext; }
+    const char* _getKey( size_t index ) const;
+};
+}
+}
+
+#endif // EQ_DETAIL_MULTIVIEW_H
@@ -0,0 +1,126 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQ_DETAIL_PIXELFORMAT_H
+#define EQ_DETAIL_PIXELFORMAT_H
+
+#include "../half.h"
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * Compile-time traits of the pixel formats supported by the CPU compositor.
+ *
+ * A format defines the storage of one pixel and the conversion of one channel
+ * to and from float. The compositing kernels are instantiated once per format,
+ * which avoids any per-pixel branching on the format.
+ */
+template< class C, size_t N > struct PixelFormat
+{
+    typedef C Channel;
+    static const size_t nChannels = N;
+
+    /** The storage of one pixel. */
+    struct Pixel { Channel c[ N ]; };
+};
+
+/** Four channel 16 bit half float pixels, RGBA16F and BGRA16F. */
+struct RGBA16F : public PixelFormat< uint16_t, 4 >
+{
+    static float toFloat( const uint16_t value )
+        { return half_to_float( value ); }
+    static uint16_t fromFloat( const float value )
+        { return half_from_float( value ); }
+};
+
+/** Four channel 32 bit float pixels, RGBA32F and BGRA32F. */
+struct RGBA32F : public PixelFormat< float, 4 >
+{
+    static float toFloat( const float value ) { return value; }
+    static float fromFloat( const float value ) { return value; }
+};
+
+/** 32 bit unsigned integer depth values. */
+struct DepthUnsignedInt
+{
+    typedef uint32_t Value;
+    static bool isCloser( const uint32_t value, const uint32_t reference )
+        { return value < reference; }
+};
+
+/**
+ * Depth-test one row: for each pixel where the source depth is closer than the
+ * destination depth, copy source color and depth.
+ */
+template< class C, class D >
+void mergeDepth( void* destColor, void* destDepth, const void* color,
+                 const void* depth, const size_t n )
+{
+    typedef typename C::Pixel Pixel;
+    typedef typename D::Value Depth;
+
+    Pixel* dc = static_cast< Pixel* >( destColor );
+    Depth* dd = static_cast< Depth* >( destDepth );
+    const Pixel* sc = static_cast< const Pixel* >( color );
+    const Depth* sd = static_cast< const Depth* >( depth );
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        if( D::isCloser( sd[i], dd[i] ))
+        {
+            dc[i] = sc[i];
+            dd[i] = sd[i];
+        }
+    }
+}
+
+/**
+ * Blend one row of premultiplied pixels into the destination, with
+ * dst = src + srcAlpha * dst for color and dst = srcAlpha * dst for alpha.
+ * The alpha is the last channel of the pixel.
+ */
+template< class C >
+void blend( void* dest, const void* src, const size_t n )
+{
+    typedef typename C::Pixel Pixel;
+    static const size_t alpha = C::nChannels - 1;
+
+    Pixel* d = static_cast< Pixel* >( dest );
+    const Pixel* s = static_cast< const Pixel* >( src );
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        const float a = C::toFloat( s[i].c[ alpha ] );
+        for( size_t j = 0; j < alpha; ++j )
+            d[i].c[j] = C::fromFloat( C::toFloat( s[i].c[j] ) +
+                                      a * C::toFloat( d[i].c[j] ));
+        d[i].c[ alpha ] = C::fromFloat( a * C::toFloat( d[i].c[ alpha ] ));
+    }
+}
+
+/** Half floats are converted row-wise using half_to_float_n() and blended
+    as floats. */
+template<> void blend< RGBA16F >( void* dest, const void* src, size_t n );
+}
+}
+
+#endif // EQ_DETAIL_PIXELFORMAT_H
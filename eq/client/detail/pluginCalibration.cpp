@@ -0,0 +1,409 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "pluginCalibration.h"
+#include "pluginManifest.h"
+
+#include "../gl.h"
+#include "../log.h"
+
+#include <lunchbox/clock.h>
+#include <lunchbox/lock.h>
+#include <lunchbox/rng.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/uint128_t.h>
+#include <pression/compressor.h>
+#include <pression/decompressor.h>
+#include <pression/downloader.h>
+#include <pression/plugin.h>
+#include <pression/pluginRegistry.h>
+#include <pression/pluginVisitor.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "../transferFinder.h"
+
+namespace eq
+{
+namespace detail
+{
+namespace pluginCalibration
+{
+namespace
+{
+typedef std::map< uint64_t, uint32_t > Selections;
+
+lunchbox::Lock _lock;
+Selections _selections; //!< shared by all threads of the process
+uint64_t _pluginsHash = 0; //!< of the installed plugins, 0 if not loaded
+
+const uint64_t _size = 256; //!< edge length of the benchmark image
+const size_t _nRuns = 3; //!< per plugin, the fastest run is used
+const float _linkRate = 125000.f; //!< bytes/ms of the nominal 1 GBit/s link
+
+void _hash( uint64_t& hash, const void* data, const size_t size )
+{
+    // FNV-1a
+    const uint8_t* bytes = reinterpret_cast< const uint8_t* >( data );
+    for( size_t i = 0; i < size; ++i )
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+template< class T > void _hash( uint64_t& hash, const T& value )
+{
+    _hash( hash, &value, sizeof( value ));
+}
+
+void _hashString( uint64_t& hash, const char* string )
+{
+    if( string )
+        _hash( hash, string, ::strlen( string ));
+    _hash( hash, uint8_t( 0xff )); // separate consecutive strings
+}
+
+class CompressorFinder : public pression::ConstPluginVisitor
+{
+public:
+    CompressorFinder( const uint32_t token, const float minQuality,
+                      const bool ignoreAlpha )
+        : token_( token ), minQuality_( minQuality )
+        , ignoreAlpha_( ignoreAlpha )
+    {}
+
+    virtual fabric::VisitorResult visit( const pression::Plugin&,
+                                         const EqCompressorInfo& info )
+    {
+        if( !( info.capabilities & EQ_COMPRESSOR_TRANSFER ) &&
+            info.tokenType == token_ && info.quality >= minQuality_ &&
+            ( ignoreAlpha_ ||
+              !( info.capabilities & EQ_COMPRESSOR_IGNORE_ALPHA )))
+        {
+            result.push_back( info.name );
+        }
+        return fabric::TRAVERSE_CONTINUE;
+    }
+
+    std::vector< uint32_t > result;
+
+private:
+    const uint32_t token_;
+    const float minQuality_;
+    const bool ignoreAlpha_;
+};
+
+std::string _getFilename()
+{
+    const char* env = ::getenv( "EQ_PLUGIN_CALIBRATION" );
+    if( env )
+        return env;
+    const char* home = ::getenv( "HOME" );
+    return home ? std::string( home ) + "/.eqPluginCalibration" :
+                  std::string();
+}
+
+/** Load the stored selections on first use, needs the lock. */
+void _load()
+{
+    if( _pluginsHash != 0 )
+        return;
+
+    // the installed plugins, loaded or not
+    uint64_t hash = 14695981039346656037ull;
+    const EqCompressorInfos& infos = pluginManifest::getInfos();
+    for( EqCompressorInfosCIter i = infos.begin(); i != infos.end(); ++i )
+    {
+        _hash( hash, i->name );
+        _hash( hash, i->version );
+    }
+    _pluginsHash = hash;
+
+    const std::string& filename = _getFilename();
+    if( filename.empty( ))
+        return;
+
+    std::ifstream file( filename.c_str( ));
+    uint64_t key = 0;
+    uint32_t name = 0;
+    while( file >> std::hex >> key >> name )
+        _selections[ key ] = name;
+}
+
+/** Add a selection and rewrite the stored selections, needs the lock. */
+void _store( const uint64_t key, const uint32_t name )
+{
+    _selections[ key ] = name;
+
+    const std::string& filename = _getFilename();
+    if( filename.empty( ))
+        return;
+
+    // write to a temporary file first, concurrent processes may read
+    std::ostringstream tmpName;
+    tmpName << filename << '.' << lunchbox::make_UUID().getShortString();
+    {
+        std::ofstream file( tmpName.str().c_str( ));
+        file << std::hex << std::setfill( '0' );
+        for( Selections::const_iterator i = _selections.begin();
+             i != _selections.end(); ++i )
+        {
+            file << std::setw( 16 ) << i->first << ' ' << std::setw( 8 )
+                 << i->second << std::endl;
+        }
+        if( !file )
+        {
+            LBWARN << "Can't write plugin calibration " << tmpName.str()
+                   << std::endl;
+            return;
+        }
+    }
+    if( ::rename( tmpName.str().c_str(), filename.c_str( )) != 0 )
+        ::remove( tmpName.str().c_str( ));
+}
+
+/** @return true if a selection for the key is known. */
+bool _find( const uint64_t key, uint32_t& name )
+{
+    lunchbox::ScopedWrite mutex( _lock );
+    _load();
+    const Selections::const_iterator i = _selections.find( key );
+    if( i == _selections.end( ))
+        return false;
+    name = i->second;
+    return true;
+}
+
+uint64_t _getKey( const char* type )
+{
+    lunchbox::ScopedWrite mutex( _lock );
+    _load();
+    uint64_t key = _pluginsHash;
+    _hashString( key, type );
+    return key;
+}
+
+/** @return a rendered frame: background, smooth shading and some noise. */
+std::vector< uint8_t > _createImage( const uint32_t pixelSize )
+{
+    std::vector< uint8_t > image( _size * _size * pixelSize, 0 );
+    lunchbox::RNG rng;
+    for( uint64_t y = 0; y < _size; ++y )
+    {
+        for( uint64_t x = _size / 4; x < _size; ++x )
+        {
+            uint8_t* pixel = &image[ ( y * _size + x ) * pixelSize ];
+            for( uint32_t i = 0; i < pixelSize; ++i )
+                pixel[i] = uint8_t(( x + y * ( i + 1 )) >> 1 ) ^
+                           ( rng.get< uint8_t >() & 0x3 );
+        }
+    }
+    return image;
+}
+
+uint32_t _calibrateCompressor( const uint32_t tokenType,
+                               const uint32_t pixelSize,
+                               const float minQuality, const bool ignoreAlpha )
+{
+    ScopedPlugins plugins;
+    plugins.loadTokenType( tokenType );
+    const pression::PluginRegistry& registry = plugins.get();
+    CompressorFinder finder( tokenType, minQuality, ignoreAlpha );
+    registry.accept( finder );
+    if( finder.result.empty( ))
+        return EQ_COMPRESSOR_INVALID;
+
+    std::vector< uint8_t > image = _createImage( pixelSize );
+    std::vector< uint8_t > output( image.size( ));
+    const uint64_t flags = EQ_COMPRESSOR_DATA_2D |
+                           ( ignoreAlpha ? EQ_COMPRESSOR_IGNORE_ALPHA : 0 );
+
+    uint32_t best = EQ_COMPRESSOR_INVALID;
+    float bestCost = std::numeric_limits< float >::max();
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < finder.result.size(); ++i )
+    {
+        const uint32_t name = finder.result[i];
+        pression::Compressor compressor;
+        pression::Decompressor decompressor;
+        if( !compressor.setup( registry, name ) ||
+            !decompressor.setup( registry, name ))
+        {
+            continue;
+        }
+
+        float time = std::numeric_limits< float >::max();
+        uint64_t size = 0;
+        for( size_t j = 0; j < _nRuns; ++j )
+        {
+            uint64_t dims[4] = { 0, _size, 0, _size };
+            clock.reset();
+            compressor.compress( image.data(), dims, flags );
+            const pression::CompressorResult& result = compressor.getResult();
+            decompressor.decompress( result, output.data(), dims, flags );
+            time = std::min( time, clock.getTimef( ));
+
+            size = 0;
+            for( size_t k = 0; k < result.chunks.size(); ++k )
+                size += result.chunks[k].getNumBytes();
+        }
+
+        const float cost = time + float( size ) / _linkRate;
+        LBLOG( LOG_PLUGIN ) << "Compressor 0x" << std::hex << name << std::dec
+                            << " took " << time << " ms, " << size << " of "
+                            << image.size() << " bytes" << std::endl;
+        if( cost < bestCost )
+        {
+            bestCost = cost;
+            best = name;
+        }
+    }
+    return best;
+}
+
+uint32_t _calibrateDownloader( const uint32_t internalFormat,
+                               const float minQuality, const bool ignoreAlpha,
+                               const uint64_t flags,
+                               const GLEWContext* glewContext )
+{
+    ScopedPlugins plugins;
+    plugins.loadTokenType( internalFormat );
+    const pression::PluginRegistry& registry = plugins.get();
+    TransferFinder finder( internalFormat, EQ_COMPRESSOR_DATATYPE_NONE, flags,
+                           minQuality, ignoreAlpha, glewContext );
+    registry.accept( finder );
+    if( finder.result.empty( ))
+        return EQ_COMPRESSOR_INVALID;
+
+    GLint viewport[4];
+    EQ_GL_CALL( glGetIntegerv( GL_VIEWPORT, viewport ));
+    const uint64_t inDims[4] = {
+        uint64_t( viewport[0] ), std::min( uint64_t( viewport[2] ), _size ),
+        uint64_t( viewport[1] ), std::min( uint64_t( viewport[3] ), _size )};
+    if( inDims[1] == 0 || inDims[3] == 0 )
+        return EQ_COMPRESSOR_INVALID;
+
+    const uint64_t runFlags = flags |
+                              ( ignoreAlpha ? EQ_COMPRESSOR_IGNORE_ALPHA : 0 );
+    uint32_t best = EQ_COMPRESSOR_INVALID;
+    float bestTime = std::numeric_limits< float >::max();
+    lunchbox::Clock clock;
+    for( EqCompressorInfosCIter i = finder.result.begin();
+         i != finder.result.end(); ++i )
+    {
+        pression::Downloader downloader;
+        if( !downloader.setup( registry, i->name, glewContext ))
+            continue;
+
+        float time = std::numeric_limits< float >::max();
+        for( size_t j = 0; j < _nRuns; ++j )
+        {
+            void* pixels = 0;
+            uint64_t outDims[4] = { 0 };
+            EQ_GL_CALL( glFinish( ));
+            clock.reset();
+            if( downloader.start( &pixels, inDims, runFlags, outDims, 0,
+                                  glewContext ))
+            {
+                downloader.finish( &pixels, inDims, runFlags, outDims,
+                                   glewContext );
+            }
+            time = std::min( time, clock.getTimef( ));
+        }
+        downloader.clear();
+
+        LBLOG( LOG_PLUGIN ) << "Downloader 0x" << std::hex << i->name
+                            << std::dec << " took " << time << " ms"
+                            << std::endl;
+        if( time < bestTime )
+        {
+            bestTime = time;
+            best = i->name;
+        }
+    }
+    return best;
+}
+}
+
+uint32_t chooseCompressor( const uint32_t tokenType, const uint32_t pixelSize,
+                           const float minQuality, const bool ignoreAlpha )
+{
+    uint64_t key = _getKey( "compressor" );
+    _hash( key, tokenType );
+    _hash( key, pixelSize );
+    _hash( key, minQuality );
+    _hash( key, ignoreAlpha );
+
+    uint32_t name = EQ_COMPRESSOR_INVALID;
+    if( _find( key, name ) || pixelSize == 0 )
+        return name;
+
+    name = _calibrateCompressor( tokenType, pixelSize, minQuality,
+                                 ignoreAlpha );
+    LBLOG( LOG_PLUGIN ) << "Calibrated compressor 0x" << std::hex << name
+                        << " for token type 0x" << tokenType << std::dec
+                        << std::endl;
+
+    lunchbox::ScopedWrite mutex( _lock );
+    _store( key, name );
+    return name;
+}
+
+uint32_t chooseDownloader( const uint32_t internalFormat,
+                           const float minQuality, const bool ignoreAlpha,
+                           const uint64_t flags,
+                           const GLEWContext* glewContext )
+{
+    if( !( flags & EQ_COMPRESSOR_USE_FRAMEBUFFER ) || !glewContext )
+        return EQ_COMPRESSOR_INVALID;
+
+    uint64_t key = _getKey( "downloader" );
+    _hashString( key, (const char*)glGetString( GL_VENDOR ));
+    _hashString( key, (const char*)glGetString( GL_RENDERER ));
+    _hashString( key, (const char*)glGetString( GL_VERSION ));
+    _hash( key, internalFormat );
+    _hash( key, minQuality );
+    _hash( key, ignoreAlpha );
+    _hash( key, flags );
+
+    uint32_t name = EQ_COMPRESSOR_INVALID;
+    if( _find( key, name ))
+        return name;
+
+    name = _calibrateDownloader( internalFormat, minQuality, ignoreAlpha,
+                                 flags, glewContext );
+    LBLOG( LOG_PLUGIN ) << "Calibrated downloader 0x" << std::hex << name
+                        << " for token type 0x" << internalFormat << std::dec
+                        << std::endl;
+
+    lunchbox::ScopedWrite mutex( _lock );
+    _store( key, name );
+    return name;
+}
+}
+}
+}
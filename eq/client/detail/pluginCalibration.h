@@ -0,0 +1,64 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQ_DETAIL_PLUGINCALIBRATION_H
+#define EQ_DETAIL_PLUGINCALIBRATION_H
+
+#include <eq/client/types.h>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * @internal
+ * Measured selection of the automatic compressor and downloader.
+ *
+ * The first request for a parameter combination benchmarks all matching
+ * plugins on a synthetic image and selects the fastest one. Compressors are
+ * ranked by compression and decompression time plus the time to send the
+ * compressed data over a 1 GBit/s link, downloaders by their read back time
+ * from the current frame buffer. Downloaders are keyed by the GL vendor,
+ * renderer and driver version.
+ *
+ * The selections are kept for the process and stored in the file named by
+ * the EQ_PLUGIN_CALIBRATION environment variable, or in
+ * $HOME/.eqPluginCalibration. An empty variable disables the file. Selections
+ * are invalidated when the installed plugins change. Thread safe.
+ */
+namespace pluginCalibration
+{
+/**
+ * @return the measured best compressor for the parameters, or
+ *         EQ_COMPRESSOR_INVALID if no compressor matches.
+ */
+uint32_t chooseCompressor( uint32_t tokenType, uint32_t pixelSize,
+                           float minQuality, bool ignoreAlpha );
+
+/**
+ * @return the measured best frame buffer downloader for the parameters, or
+ *         EQ_COMPRESSOR_INVALID if none matches or the flags do not read the
+ *         frame buffer. Needs the given context to be current.
+ */
+uint32_t chooseDownloader( uint32_t internalFormat, float minQuality,
+                           bool ignoreAlpha, uint64_t flags,
+                           const GLEWContext* glewContext );
+}
+}
+}
+
+#endif // EQ_DETAIL_PLUGINCALIBRATION_H
@@ -0,0 +1,334 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "pluginManifest.h"
+
+#include "../log.h"
+
+#include <co/global.h>
+#include <lunchbox/debug.h>
+#include <lunchbox/lock.h>
+#include <lunchbox/scopedMutex.h>
+#include <pression/plugin.h>
+#include <pression/pluginRegistry.h>
+#include <pression/pluginVisitor.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+/** A plugin file and the engines it implements. */
+struct Entry
+{
+    Entry() : size( 0 ), time( 0 ), loaded( false ) {}
+
+    uint64_t size;
+    int64_t time; //!< last modification
+    EqCompressorInfos infos;
+    bool loaded;
+};
+typedef std::map< std::string, Entry > Entries;
+
+lunchbox::Lock _lock;
+Entries _entries; //!< by file name, empty if the manifest is disabled
+
+class InfoCollector : public pression::ConstPluginVisitor
+{
+public:
+    virtual fabric::VisitorResult visit( const pression::Plugin&,
+                                         const EqCompressorInfo& info )
+    {
+        infos.push_back( info );
+        return fabric::TRAVERSE_CONTINUE;
+    }
+
+    EqCompressorInfos infos;
+};
+
+bool _lessInfo( const EqCompressorInfo& a, const EqCompressorInfo& b )
+{
+    return a.name < b.name || ( a.name == b.name && a.version < b.version );
+}
+
+std::string _getFilename()
+{
+    const char* env = ::getenv( "EQ_PLUGIN_MANIFEST" );
+    if( env )
+        return env;
+    const char* home = ::getenv( "HOME" );
+    return home ? std::string( home ) + "/.eqPluginManifest" : std::string();
+}
+
+/** @return true if the file name matches the plugin naming convention. */
+bool _isPlugin( const std::string& name )
+{
+#ifdef _WIN32
+    const std::string suffix( ".dll" );
+#elif __APPLE__
+    const std::string suffix( ".dylib" );
+#else
+    const std::string suffix( ".so" );
+#endif
+    return name.find( "Compressor" ) != std::string::npos &&
+           name.size() > suffix.size() &&
+           name.compare( name.size() - suffix.size(), suffix.size(),
+                         suffix ) == 0;
+}
+
+/** List the plugin files of the directories with their size and time. */
+Entries _list( const Strings& directories )
+{
+    namespace fs = boost::filesystem;
+    Entries entries;
+    for( StringsCIter i = directories.begin(); i != directories.end(); ++i )
+    {
+        boost::system::error_code error;
+        fs::directory_iterator j( *i, error );
+        for( ; !error && j != fs::directory_iterator(); j.increment( error ))
+        {
+            const fs::path& path = j->path();
+            if( !_isPlugin( path.filename().string( )) ||
+                !fs::is_regular_file( path, error ))
+            {
+                continue;
+            }
+
+            Entry& entry = entries[ path.string() ];
+            entry.size = fs::file_size( path, error );
+            entry.time = int64_t( fs::last_write_time( path, error ));
+        }
+    }
+    return entries;
+}
+
+/** Read the stored entries, keyed by file name. */
+Entries _read( const std::string& filename )
+{
+    Entries entries;
+    std::ifstream file( filename.c_str( ));
+    std::string path;
+    Entry entry;
+    size_t nInfos = 0;
+    while( file >> entry.size >> entry.time >> nInfos &&
+           std::getline( file >> std::ws, path ))
+    {
+        entry.infos.resize( nInfos );
+        for( size_t i = 0; i < nInfos; ++i )
+        {
+            EqCompressorInfo& info = entry.infos[i];
+            file >> std::hex >> info.version >> info.name >> info.tokenType
+                 >> info.capabilities >> info.outputTokenType >> std::dec
+                 >> info.outputTokenSize >> info.quality >> info.ratio
+                 >> info.speed;
+        }
+        if( !file )
+            break;
+        entries[ path ] = entry;
+    }
+    return entries;
+}
+
+/** Rewrite the stored entries atomically. */
+void _write( const std::string& filename, const Entries& entries )
+{
+    std::ostringstream tmpName;
+    tmpName << filename << '.' << ::rand();
+    {
+        std::ofstream file( tmpName.str().c_str( ));
+        for( Entries::const_iterator i = entries.begin(); i != entries.end();
+             ++i )
+        {
+            const Entry& entry = i->second;
+            file << entry.size << ' ' << entry.time << ' '
+                 << entry.infos.size() << ' ' << i->first << std::endl;
+            for( EqCompressorInfosCIter j = entry.infos.begin();
+                 j != entry.infos.end(); ++j )
+            {
+                file << std::hex << j->version << ' ' << j->name << ' '
+                     << j->tokenType << ' ' << j->capabilities << ' '
+                     << j->outputTokenType << std::dec << ' '
+                     << j->outputTokenSize << ' ' << j->quality << ' '
+                     << j->ratio << ' ' << j->speed << std::endl;
+            }
+        }
+        if( !file )
+        {
+            LBWARN << "Can't write plugin manifest " << filename << std::endl;
+            ::remove( tmpName.str().c_str( ));
+            return;
+        }
+    }
+    if( ::rename( tmpName.str().c_str(), filename.c_str( )) != 0 )
+        ::remove( tmpName.str().c_str( ));
+}
+
+/** Open the plugin once in a scratch registry to read its engines. */
+EqCompressorInfos _probe( const std::string& filename )
+{
+    pression::PluginRegistry registry;
+    InfoCollector collector;
+    if( registry.addPlugin( filename ))
+        registry.accept( collector );
+    registry.exit();
+
+    LBLOG( LOG_PLUGIN ) << "Probed " << filename << ": "
+                        << collector.infos.size() << " engines" << std::endl;
+    return collector.infos;
+}
+
+/** Load the plugin into the registry, needs the lock. */
+void _load( const std::string& filename, Entry& entry )
+{
+    if( entry.loaded )
+        return;
+
+    entry.loaded = true;
+    if( co::Global::getPluginRegistry().addPlugin( filename ))
+        LBLOG( LOG_PLUGIN ) << "Loaded " << filename << std::endl;
+    else
+        LBWARN << "Can't load compression plugin " << filename << std::endl;
+}
+}
+
+namespace pluginManifest
+{
+void init( const Strings& directories )
+{
+    pression::PluginRegistry& registry = co::Global::getPluginRegistry();
+    const std::string& filename = _getFilename();
+    if( filename.empty( ))
+    {
+        for( StringsCIter i = directories.begin(); i != directories.end(); ++i )
+            registry.addDirectory( *i );
+        return;
+    }
+
+    _entries = _list( directories );
+    const Entries& stored = _read( filename );
+    bool changed = _entries.size() != stored.size();
+    for( Entries::iterator i = _entries.begin(); i != _entries.end(); ++i )
+    {
+        Entry& entry = i->second;
+        const Entries::const_iterator j = stored.find( i->first );
+        if( j != stored.end() && j->second.size == entry.size &&
+            j->second.time == entry.time )
+        {
+            entry.infos = j->second.infos;
+            continue;
+        }
+
+        entry.infos = _probe( i->first );
+        changed = true;
+    }
+
+    if( changed )
+        _write( filename, _entries );
+    LBLOG( LOG_PLUGIN ) << _entries.size() << " compression plugins found, "
+                        << "loaded on first use" << std::endl;
+}
+
+void exit()
+{
+    _entries.clear();
+}
+
+EqCompressorInfos getInfos()
+{
+    ScopedPlugins plugins;
+    InfoCollector collector;
+    plugins.get().accept( collector );
+
+    for( Entries::const_iterator i = _entries.begin(); i != _entries.end();
+         ++i )
+    {
+        const Entry& entry = i->second;
+        if( !entry.loaded )
+            collector.infos.insert( collector.infos.end(),
+                                    entry.infos.begin(), entry.infos.end( ));
+    }
+
+    // independent of the plugins loaded so far
+    std::sort( collector.infos.begin(), collector.infos.end(), _lessInfo );
+    return collector.infos;
+}
+}
+
+ScopedPlugins::ScopedPlugins()
+{
+    _lock.set();
+}
+
+ScopedPlugins::~ScopedPlugins()
+{
+    _lock.unset();
+}
+
+void ScopedPlugins::loadName( const uint32_t name )
+{
+    for( Entries::iterator i = _entries.begin(); i != _entries.end(); ++i )
+    {
+        const EqCompressorInfos& infos = i->second.infos;
+        for( EqCompressorInfosCIter j = infos.begin(); j != infos.end(); ++j )
+        {
+            if( j->name == name )
+            {
+                _load( i->first, i->second );
+                return;
+            }
+        }
+    }
+}
+
+void ScopedPlugins::loadTokenType( const uint32_t tokenType )
+{
+    for( Entries::iterator i = _entries.begin(); i != _entries.end(); ++i )
+    {
+        const EqCompressorInfos& infos = i->second.infos;
+        for( EqCompressorInfosCIter j = infos.begin(); j != infos.end(); ++j )
+        {
+            if( j->tokenType == tokenType || j->outputTokenType == tokenType )
+            {
+                _load( i->first, i->second );
+                break;
+            }
+        }
+    }
+}
+
+void ScopedPlugins::loadAll()
+{
+    for( Entries::iterator i = _entries.begin(); i != _entries.end(); ++i )
+        _load( i->first, i->second );
+}
+
+pression::PluginRegistry& ScopedPlugins::get()
+{
+    return co::Global::getPluginRegistry();
+}
+}
+}
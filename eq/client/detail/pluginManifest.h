@@ -0,0 +1,84 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQ_DETAIL_PLUGINMANIFEST_H
+#define EQ_DETAIL_PLUGINMANIFEST_H
+
+#include <eq/client/types.h>
+#include <pression/plugins/compressor.h> // EqCompressorInfos
+
+#include <boost/noncopyable.hpp>
+
+namespace pression { class PluginRegistry; }
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * @internal
+ * Lazy loading of the compression plugins found in the plugin directories.
+ *
+ * At startup the plugin directories are listed without opening any plugin.
+ * The names and capabilities of each plugin are read from a manifest stored in
+ * the file named by the EQ_PLUGIN_MANIFEST environment variable, or in
+ * $HOME/.eqPluginManifest. Plugins missing in the manifest or changed since
+ * are probed once and the manifest is rewritten. A plugin is only loaded into
+ * the plugin registry when an image first needs one of its engines. An empty
+ * variable disables the manifest, all plugins are then loaded at startup.
+ */
+namespace pluginManifest
+{
+/** Find the plugins in the given directories. Not thread safe. */
+void init( const Strings& directories );
+
+/** Forget the plugins found by init(). Not thread safe. */
+void exit();
+
+/** @return the infos of all loaded and not yet loaded plugins. */
+EqCompressorInfos getInfos();
+}
+
+/**
+ * Exclusive access to the plugin registry.
+ *
+ * Lazily loaded plugins are added to the registry while other threads use it,
+ * all users of the registry in Equalizer hold an instance while visiting it or
+ * setting up a plugin engine.
+ */
+class ScopedPlugins : public boost::noncopyable
+{
+public:
+    ScopedPlugins();
+    ~ScopedPlugins();
+
+    /** Load the plugin implementing the given engine. */
+    void loadName( uint32_t name );
+
+    /** Load the plugins with an engine reading or writing the token type. */
+    void loadTokenType( uint32_t tokenType );
+
+    /** Load all plugins. */
+    void loadAll();
+
+    /** @return the plugin registry. */
+    pression::PluginRegistry& get();
+};
+}
+}
+
+#endif // EQ_DETAIL_PLUGINMANIFEST_H
@@ -0,0 +1,375 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "reprojector.h"
+
+#include "../channel.h"
+#include "../config.h"
+#include "../gl.h"
+#include "../log.h"
+#include "../window.h"
+
+#include <eq/util/objectManager.h>
+#include <eq/util/shader.h>
+#include <eq/util/texture.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+enum Key
+{
+    KEY_COLOR,       //!< color of the last image
+    KEY_DEPTH,       //!< depth of the last image
+    KEY_SAVED_COLOR, //!< color of the partial frame
+    KEY_SAVED_DEPTH, //!< depth of the partial frame
+    KEY_GRID,        //!< warp program, grid vertex array and buffer
+    KEY_QUAD,        //!< restore program, quad vertex array and buffer
+    KEY_ALL
+};
+
+/** Grid cell size in pixels, trades accuracy at depth edges for speed. */
+const int32_t _cellSize = 8;
+
+Matrix4f _getViewProjection( const eq::Channel& channel )
+{
+    const Matrix4f& projection = channel.useOrtho() ?
+        channel.getOrtho().compute_ortho_matrix() :
+        channel.getPerspective().compute_matrix();
+    return projection * channel.getHeadTransform();
+}
+}
+
+Reprojector::Reprojector()
+    : _glewContext( 0 )
+    , _pvp()
+    , _viewProjection( Matrix4f::IDENTITY )
+    , _time( 0 )
+    , _valid( false )
+    , _gridSize( Vector2i::ZERO )
+    , _nVertices( 0 )
+{}
+
+Reprojector::~Reprojector()
+{}
+
+const char* Reprojector::_getKey( const size_t index ) const
+{
+    return reinterpret_cast< const char* >( this ) + index;
+}
+
+void Reprojector::capture( eq::Channel& channel )
+{
+    _glewContext = channel.glewGetContext();
+    const PixelViewport& pvp = channel.getPixelViewport();
+    const Window* window = channel.getWindow();
+    if( !pvp.hasArea() ||
+        window->getIAttribute( WindowSettings::IATTR_PLANES_DEPTH ) == OFF )
+    {
+        _valid = false;
+        return;
+    }
+
+    _copy( channel, KEY_COLOR, KEY_DEPTH );
+    _pvp = pvp;
+    _viewProjection = _getViewProjection( channel );
+    _time = channel.getConfig()->getTime();
+    _valid = true;
+}
+
+bool Reprojector::draw( eq::Channel& channel )
+{
+    _glewContext = channel.glewGetContext();
+    if( !_valid || channel.getPixelViewport() != _pvp )
+        return false;
+
+    Matrix4f inverse;
+    if( !_viewProjection.inverse( inverse ))
+        return false;
+
+    const Matrix4f& warp = _getViewProjection( channel ) * inverse;
+    _copy( channel, KEY_SAVED_COLOR, KEY_SAVED_DEPTH );
+
+    EQ_GL_CALL( glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT ));
+    EQ_GL_CALL( glEnable( GL_DEPTH_TEST ));
+    EQ_GL_CALL( glDepthFunc( GL_LESS ));
+    _drawGrid( channel, warp );
+    EQ_GL_CALL( glDisable( GL_DEPTH_TEST ));
+    return true;
+}
+
+void Reprojector::restore( eq::Channel& channel )
+{
+    _glewContext = channel.glewGetContext();
+    EQ_GL_CALL( channel.applyBuffer( ));
+    EQ_GL_CALL( channel.applyViewport( ));
+
+    // depth writes need the depth test
+    EQ_GL_CALL( glEnable( GL_DEPTH_TEST ));
+    EQ_GL_CALL( glDepthFunc( GL_ALWAYS ));
+    _drawQuad( channel );
+    EQ_GL_CALL( glDepthFunc( GL_LESS ));
+    EQ_GL_CALL( glDisable( GL_DEPTH_TEST ));
+}
+
+void Reprojector::flush( eq::Channel& channel )
+{
+    util::ObjectManager& om = channel.getObjectManager();
+    for( size_t i = KEY_COLOR; i <= KEY_SAVED_DEPTH; ++i )
+        om.deleteEqTexture( _getKey( i ));
+
+    for( size_t i = KEY_GRID; i < KEY_ALL; ++i )
+    {
+        om.deleteProgram( _getKey( i ));
+        om.deleteVertexArray( _getKey( i ));
+        om.deleteBuffer( _getKey( i ));
+    }
+    _valid = false;
+    _gridSize = Vector2i::ZERO;
+    _nVertices = 0;
+}
+
+void Reprojector::_copy( eq::Channel& channel, const size_t colorKey,
+                         const size_t depthKey )
+{
+    util::ObjectManager& om = channel.getObjectManager();
+    util::Texture* color = om.obtainEqTexture( _getKey( colorKey ),
+                                               GL_TEXTURE_RECTANGLE_ARB );
+    util::Texture* depth = om.obtainEqTexture( _getKey( depthKey ),
+                                               GL_TEXTURE_RECTANGLE_ARB );
+    const PixelViewport& pvp = channel.getPixelViewport();
+
+    EQ_GL_CALL( channel.applyBuffer( ));
+    EQ_GL_CALL( channel.applyViewport( ));
+    color->copyFromFrameBuffer( GL_RGBA, pvp );
+    depth->copyFromFrameBuffer( GL_DEPTH_COMPONENT, pvp );
+}
+
+void Reprojector::_drawGrid( eq::Channel& channel, const Matrix4f& warp )
+{
+    util::ObjectManager& om = channel.getObjectManager();
+    const char* key = _getKey( KEY_GRID );
+    GLuint program = om.getProgram( key );
+    GLuint vertexArray = om.getVertexArray( key );
+    GLuint vertexBuffer = om.getBuffer( key );
+    if( program == util::ObjectManager::INVALID )
+    {
+        vertexBuffer = om.newBuffer( key );
+        vertexArray = om.newVertexArray( key );
+        program = om.newProgram( key );
+
+        // Each vertex is displaced by the depth of the last image at its
+        // position, projected back to world space and into the new frustum.
+        const char* vertexShaderGLSL = {
+            "#version 330 core\n"
+            "#extension GL_ARB_texture_rectangle : enable\n"
+            "layout(location = 0) in vec2 vert;\n"
+            "uniform sampler2DRect depth;\n"
+            "uniform vec2 size;\n"
+            "uniform mat4 warp;\n"
+            "out vec2 fragTexCoord;\n"
+            "void main() {\n"
+            "    fragTexCoord = vert;\n"
+            "    float z = texture2DRect( depth, vert ).x;\n"
+            "    gl_Position = warp * vec4( 2.0 * vert / size - 1.0,\n"
+            "                               2.0 * z - 1.0, 1.0 );\n"
+            "}\n"
+        };
+
+        const char* fragmentShaderGLSL = {
+            "#version 330 core\n"
+            "#extension GL_ARB_texture_rectangle : enable\n"
+            "uniform sampler2DRect color;\n"
+            "in vec2 fragTexCoord;\n"
+            "out vec4 finalColor;\n"
+            "void main() {\n"
+            "    finalColor = texture2DRect( color, fragTexCoord );\n"
+            "}\n"
+        };
+
+        LBCHECK( util::shader::linkProgram( glewGetContext(), program,
+                                            vertexShaderGLSL,
+                                            fragmentShaderGLSL ));
+
+        EQ_GL_CALL( glUseProgram( program ));
+        GLint param = glGetUniformLocation( program, "color" );
+        EQ_GL_CALL( glUniform1i( param, 0 ));
+        param = glGetUniformLocation( program, "depth" );
+        EQ_GL_CALL( glUniform1i( param, 1 ));
+        _gridSize = Vector2i::ZERO;
+    }
+
+    const Vector2i size( _pvp.w, _pvp.h );
+    if( _gridSize != size )
+    {
+        // two triangles per cell, vertices at the pixel centers
+        std::vector< GLfloat > vertices;
+        for( int32_t y = 0; y < size.y() - 1; y += _cellSize )
+        {
+            const float y0 = float( y ) + .5f;
+            const float y1 = float( std::min( y + _cellSize,
+                                              size.y() - 1 )) + .5f;
+            for( int32_t x = 0; x < size.x() - 1; x += _cellSize )
+            {
+                const float x0 = float( x ) + .5f;
+                const float x1 = float( std::min( x + _cellSize,
+                                                  size.x() - 1 )) + .5f;
+                const GLfloat cell[] = { x0, y0, x1, y0, x0, y1,
+                                         x0, y1, x1, y0, x1, y1 };
+                vertices.insert( vertices.end(), cell, cell + 12 );
+            }
+        }
+
+        EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, vertexBuffer ));
+        EQ_GL_CALL( glBufferData( GL_ARRAY_BUFFER,
+                                  vertices.size() * sizeof( GLfloat ),
+                                  vertices.empty() ? 0 : &vertices[0],
+                                  GL_STATIC_DRAW ));
+        EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, 0 ));
+        _gridSize = size;
+        _nVertices = vertices.size() / 2;
+    }
+
+    util::Texture* color = om.getEqTexture( _getKey( KEY_COLOR ));
+    util::Texture* depth = om.getEqTexture( _getKey( KEY_DEPTH ));
+    EQ_GL_CALL( glActiveTexture( GL_TEXTURE1 ));
+    depth->bind();
+    depth->applyZoomFilter( FILTER_NEAREST );
+    EQ_GL_CALL( glActiveTexture( GL_TEXTURE0 ));
+    color->bind();
+    color->applyZoomFilter( FILTER_LINEAR );
+
+    EQ_GL_CALL( glBindVertexArray( vertexArray ));
+    EQ_GL_CALL( glUseProgram( program ));
+
+    const GLint sizeParam = glGetUniformLocation( program, "size" );
+    EQ_GL_CALL( glUniform2f( sizeParam, float( size.x( )),
+                             float( size.y( ))));
+    const GLint warpParam = glGetUniformLocation( program, "warp" );
+    EQ_GL_CALL( glUniformMatrix4fv( warpParam, 1, GL_FALSE, &warp[0] ));
+
+    EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, vertexBuffer ));
+    EQ_GL_CALL( glVertexAttribPointer( 0, 2, GL_FLOAT, GL_FALSE, 0, 0 ));
+    EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, 0 ));
+
+    EQ_GL_CALL( glEnableVertexAttribArray( 0 ));
+    EQ_GL_CALL( glDrawArrays( GL_TRIANGLES, 0, GLsizei( _nVertices )));
+    EQ_GL_CALL( glDisableVertexAttribArray( 0 ));
+
+    EQ_GL_CALL( glBindVertexArray( 0 ));
+    EQ_GL_CALL( glUseProgram( 0 ));
+
+    EQ_GL_CALL( glActiveTexture( GL_TEXTURE1 ));
+    EQ_GL_CALL( glBindTexture( GL_TEXTURE_RECTANGLE_ARB, 0 ));
+    EQ_GL_CALL( glActiveTexture( GL_TEXTURE0 ));
+    EQ_GL_CALL( glBindTexture( GL_TEXTURE_RECTANGLE_ARB, 0 ));
+}
+
+void Reprojector::_drawQuad( eq::Channel& channel )
+{
+    util::ObjectManager& om = channel.getObjectManager();
+    const char* key = _getKey( KEY_QUAD );
+    GLuint program = om.getProgram( key );
+    GLuint vertexArray = om.getVertexArray( key );
+    GLuint vertexBuffer = om.getBuffer( key );
+    if( program == util::ObjectManager::INVALID )
+    {
+        vertexBuffer = om.newBuffer( key );
+        vertexArray = om.newVertexArray( key );
+        program = om.newProgram( key );
+
+        const char* vertexShaderGLSL = {
+            "#version 330 core\n"
+            "layout(location = 0) in vec4 vert;\n"
+            "out vec2 fragTexCoord;\n"
+            "void main() {\n"
+            "    fragTexCoord = vert.zw;\n"
+            "    gl_Position = vec4( vert.xy, 0, 1 );\n"
+            "}\n"
+        };
+
+        const char* fragmentShaderGLSL = {
+            "#version 330 core\n"
+            "#extension GL_ARB_texture_rectangle : enable\n"
+            "uniform sampler2DRect color;\n"
+            "uniform sampler2DRect depth;\n"
+            "in vec2 fragTexCoord;\n"
+            "out vec4 finalColor;\n"
+            "void main() {\n"
+            "    finalColor = texture2DRect( color, fragTexCoord );\n"
+            "    gl_FragDepth = texture2DRect( depth, fragTexCoord ).x;\n"
+            "}\n"
+        };
+
+        LBCHECK( util::shader::linkProgram( glewGetContext(), program,
+                                            vertexShaderGLSL,
+                                            fragmentShaderGLSL ));
+
+        EQ_GL_CALL( glUseProgram( program ));
+        GLint param = glGetUniformLocation( program, "color" );
+        EQ_GL_CALL( glUniform1i( param, 0 ));
+        param = glGetUniformLocation( program, "depth" );
+        EQ_GL_CALL( glUniform1i( param, 1 ));
+    }
+
+    // full-viewport quad in normalized device coordinates
+    const GLfloat w = float( _pvp.w );
+    const GLfloat h = float( _pvp.h );
+    const GLfloat vertices[] = {
+        -1.f, -1.f, 0.f, 0.f,
+         1.f, -1.f, w,   0.f,
+        -1.f,  1.f, 0.f, h,
+         1.f,  1.f, w,   h
+    };
+
+    util::Texture* color = om.getEqTexture( _getKey( KEY_SAVED_COLOR ));
+    util::Texture* depth = om.getEqTexture( _getKey( KEY_SAVED_DEPTH ));
+    EQ_GL_CALL( glActiveTexture( GL_TEXTURE1 ));
+    depth->bind();
+    depth->applyZoomFilter( FILTER_NEAREST );
+    EQ_GL_CALL( glActiveTexture( GL_TEXTURE0 ));
+    color->bind();
+    color->applyZoomFilter( FILTER_NEAREST );
+
+    EQ_GL_CALL( glBindVertexArray( vertexArray ));
+    EQ_GL_CALL( glUseProgram( program ));
+
+    EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, vertexBuffer ));
+    EQ_GL_CALL( glBufferData( GL_ARRAY_BUFFER, sizeof(vertices), vertices,
+                              GL_DYNAMIC_DRAW ));
+    EQ_GL_CALL( glVertexAttribPointer( 0, 4, GL_FLOAT, GL_FALSE, 0, 0 ));
+    EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, 0 ));
+
+    EQ_GL_CALL( glEnableVertexAttribArray( 0 ));
+    EQ_GL_CALL( glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 ));
+    EQ_GL_CALL( glDisableVertexAttribArray( 0 ));
+
+    EQ_GL_CALL( glBindVertexArray( 0 ));
+    EQ_GL_CALL( glUseProgram( 0 ));
+
+    EQ_GL_CALL( glActiveTexture( GL_TEXTURE1 ));
+    EQ_GL_CALL( glBindTexture( GL_TEXTURE_RECTANGLE_ARB, 0 ));
+    EQ_GL_CALL( glActiveTexture( GL_TEXTURE0 ));
+    EQ_GL_CALL( glBindTexture( GL_TEXTURE_RECTANGLE_ARB, 0 ));
+}
+
+}
+}
@@ -0,0 +1,86 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_REPROJECTOR_H
+#define EQ_DETAIL_REPROJECTOR_H
+
+#include <eq/client/types.h>
+#include <boost/noncopyable.hpp>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * @internal
+ * Reprojects the last complete image of a destination channel.
+ *
+ * Used when the next frame misses its deadline, see
+ * Channel::IATTR_HINT_REPROJECTION. The color and depth of the last complete
+ * frame are warped to the current frustum and head transformation using a
+ * grid mesh displaced by the depth buffer. All methods are called from the pipe
+ * thread with the channel's window context current.
+ */
+class Reprojector : public boost::noncopyable
+{
+public:
+    Reprojector();
+    ~Reprojector();
+
+    /** Keep the current frame buffer of the channel as the last image. */
+    void capture( eq::Channel& channel );
+
+    /** @return true if a complete image is available. */
+    bool hasImage() const { return _valid; }
+
+    /** @return the config time when the last image was captured. */
+    int64_t getTime() const { return _time; }
+
+    /**
+     * Draw the last image warped to the current transformation of the channel.
+     *
+     * The current, partially assembled frame buffer content of the channel is
+     * saved and has to be restored using restore() after the swap.
+     *
+     * @return true if the image was drawn, false otherwise.
+     */
+    bool draw( eq::Channel& channel );
+
+    /** Restore the frame buffer content saved by draw(). */
+    void restore( eq::Channel& channel );
+
+    /** Release all OpenGL objects of the channel's object manager. */
+    void flush( eq::Channel& channel );
+
+private:
+    const GLEWContext* _glewContext;
+    PixelViewport _pvp; //!< of the last image
+    Matrix4f _viewProjection; //!< of the last image
+    int64_t _time;
+    bool _valid;
+    Vector2i _gridSize; //!< of the current grid vertex buffer
+    size_t _nVertices; //!< of the current grid vertex buffer
+
+    const GLEWContext* glewGetContext() const { return _glewContext; }
+    const char* _getKey( size_t index ) const;
+    void _copy( eq::Channel& channel, size_t colorKey, size_t depthKey );
+    void _drawGrid( eq::Channel& channel, const Matrix4f& warp );
+    void _drawQuad( eq::Channel& channel );
+};
+}
+}
+
+#endif // EQ_DETAIL_REPROJECTOR_H
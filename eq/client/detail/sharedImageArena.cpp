@@ -0,0 +1,458 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "sharedImageArena.h"
+
+#include <lunchbox/log.h>
+#include <lunchbox/scopedMutex.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <sstream>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+/** The header in front of the pixels of each block. */
+struct BlockHeader
+{
+    std::atomic< uint32_t > readers; //!< receivers which did not release it
+    uint32_t padding;
+    uint64_t size;
+};
+
+static const uint64_t _alignment = 64;
+static const uint64_t _minArenaSize = 64ull << 20;
+static const uint64_t _markerSize = 4096;
+
+uint64_t _align( const uint64_t size )
+{
+    return ( size + _alignment - 1 ) & ~( _alignment - 1 );
+}
+
+uint64_t _getKey( const uint128_t& nodeID )
+{
+    const uint64_t key = nodeID.high() ^ nodeID.low();
+    return key ? key : 1;
+}
+
+/** @return the name of a marker (generation 0) or arena segment. */
+std::string _getName( const uint64_t key, const uint32_t generation )
+{
+    std::ostringstream name;
+#ifndef _WIN32
+    name << '/';
+#endif
+    name << "eq" << std::hex << key;
+    if( generation > 0 )
+        name << '.' << std::dec << generation;
+    return name.str();
+}
+
+bool _create( const std::string& name, const uint64_t size, void*& data,
+              void*& mapping, const bool map )
+{
+#ifdef _WIN32
+    mapping = ::CreateFileMapping( INVALID_HANDLE_VALUE, 0, PAGE_READWRITE,
+                                   DWORD( size >> 32 ),
+                                   DWORD( size & 0xffffffffu ), name.c_str( ));
+    if( !mapping )
+    {
+        LBWARN << "Can't create shared memory " << name << ": "
+               << ::GetLastError() << std::endl;
+        return false;
+    }
+    if( !map )
+        return true;
+
+    data = ::MapViewOfFile( mapping, FILE_MAP_WRITE, 0, 0, size );
+    if( !data )
+    {
+        LBWARN << "Can't map shared memory " << name << ": "
+               << ::GetLastError() << std::endl;
+        ::CloseHandle( mapping );
+        mapping = 0;
+        return false;
+    }
+#else
+    mapping = 0;
+    ::shm_unlink( name.c_str( )); // left over from a crashed process
+    const int fd = ::shm_open( name.c_str(), O_CREAT | O_RDWR, 0600 );
+    if( fd == -1 )
+    {
+        LBWARN << "Can't create shared memory " << name << ": "
+               << ::strerror( errno ) << std::endl;
+        return false;
+    }
+    if( ::ftruncate( fd, off_t( size )) != 0 )
+    {
+        LBWARN << "Can't resize shared memory " << name << ": "
+               << ::strerror( errno ) << std::endl;
+        ::close( fd );
+        ::shm_unlink( name.c_str( ));
+        return false;
+    }
+    if( map )
+    {
+        data = ::mmap( 0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+        if( data == MAP_FAILED )
+        {
+            LBWARN << "Can't map shared memory " << name << ": "
+                   << ::strerror( errno ) << std::endl;
+            data = 0;
+            ::close( fd );
+            ::shm_unlink( name.c_str( ));
+            return false;
+        }
+    }
+    ::close( fd );
+#endif
+    return true;
+}
+
+bool _open( const std::string& name, void*& data, uint64_t& size,
+            void*& mapping )
+{
+#ifdef _WIN32
+    mapping = ::OpenFileMapping( FILE_MAP_WRITE, FALSE, name.c_str( ));
+    if( !mapping )
+        return false;
+    data = ::MapViewOfFile( mapping, FILE_MAP_WRITE, 0, 0, 0 );
+    if( !data )
+    {
+        ::CloseHandle( mapping );
+        mapping = 0;
+        return false;
+    }
+    size = 0;
+#else
+    mapping = 0;
+    const int fd = ::shm_open( name.c_str(), O_RDWR, 0600 );
+    if( fd == -1 )
+        return false;
+
+    struct stat status;
+    if( ::fstat( fd, &status ) != 0 )
+    {
+        ::close( fd );
+        return false;
+    }
+    size = uint64_t( status.st_size );
+    data = ::mmap( 0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if( data == MAP_FAILED )
+    {
+        data = 0;
+        return false;
+    }
+#endif
+    return true;
+}
+
+void _close( const std::string& name, void* data, const uint64_t size,
+             void* mapping, const bool unlink )
+{
+#ifdef _WIN32
+    if( data )
+        ::UnmapViewOfFile( data );
+    if( mapping )
+        ::CloseHandle( mapping );
+    (void)name; (void)size; (void)unlink;
+#else
+    if( data )
+        ::munmap( data, size );
+    if( unlink )
+        ::shm_unlink( name.c_str( ));
+    (void)mapping;
+#endif
+}
+
+bool _exists( const std::string& name )
+{
+#ifdef _WIN32
+    HANDLE mapping = ::OpenFileMapping( FILE_MAP_READ, FALSE, name.c_str( ));
+    if( !mapping )
+        return false;
+    ::CloseHandle( mapping );
+#else
+    const int fd = ::shm_open( name.c_str(), O_RDONLY, 0600 );
+    if( fd == -1 )
+        return false;
+    ::close( fd );
+#endif
+    return true;
+}
+
+BlockHeader* _getHeader( void* segment, const uint64_t offset )
+{
+    return reinterpret_cast< BlockHeader* >(
+        static_cast< uint8_t* >( segment ) + offset );
+}
+}
+
+SharedImageArena::SharedImageArena()
+    : _key( 0 )
+    , _arena( 0 )
+    , _generation( 0 )
+    , _head( 0 )
+{}
+
+SharedImageArena::~SharedImageArena()
+{
+    close();
+}
+
+bool SharedImageArena::open( const uint128_t& nodeID )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    if( _key )
+        return true;
+
+    const uint64_t key = _getKey( nodeID );
+    if( !_create( _getName( key, 0 ), _markerSize, _marker.data,
+                  _marker.mapping, false ))
+    {
+        return false;
+    }
+    _key = key;
+    return true;
+}
+
+void SharedImageArena::close()
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    if( !_key )
+        return;
+
+    for( std::map< uint64_t, Mapping >::iterator i = _mappings.begin();
+         i != _mappings.end(); ++i )
+    {
+        const Segment& segment = i->second.second;
+        _close( _getName( i->first, i->second.first ), segment.data,
+                segment.size, segment.mapping, false );
+    }
+    _mappings.clear();
+    _local.clear();
+
+    // blocks still in use are not released anymore
+    _blocks.clear();
+    _reclaim();
+    if( _arena )
+    {
+        _close( _getName( _key, _generation ), _arena->data, _arena->size,
+                _arena->mapping, true );
+        delete _arena;
+        _arena = 0;
+    }
+
+    _close( _getName( _key, 0 ), 0, 0, _marker.mapping, true );
+    _marker = Segment();
+    _key = 0;
+}
+
+bool SharedImageArena::isLocal( const uint128_t& nodeID )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    const uint64_t key = _getKey( nodeID );
+    if( !_key || key == _key )
+        return false;
+
+    std::map< uint64_t, bool >::const_iterator i = _local.find( key );
+    if( i != _local.end( ))
+        return i->second;
+
+    const bool local = _exists( _getName( key, 0 ));
+    _local[ key ] = local;
+    return local;
+}
+
+void SharedImageArena::_reclaim()
+{
+    while( !_blocks.empty( ))
+    {
+        const Block& block = _blocks.front();
+        const BlockHeader* header = _getHeader( block.segment->data,
+                                                block.offset );
+        if( header->readers.load( std::memory_order_acquire ) > 0 )
+            break;
+        _blocks.pop_front();
+    }
+
+    // retired arenas are older than all blocks of the current arena
+    while( !_retired.empty() &&
+           ( _blocks.empty() || _blocks.front().segment != _retired.front( )))
+    {
+        Segment* segment = _retired.front();
+        const uint32_t generation = _generation - uint32_t( _retired.size( ));
+        _close( _getName( _key, generation ), segment->data, segment->size,
+                segment->mapping, true );
+        delete segment;
+        _retired.pop_front();
+    }
+}
+
+uint64_t SharedImageArena::_allocate( const uint64_t size )
+{
+    const uint64_t invalid = ~0ull;
+    _reclaim();
+
+    std::deque< Block >::const_iterator tail = _blocks.begin();
+    while( tail != _blocks.end() && tail->segment != _arena )
+        ++tail;
+    if( tail == _blocks.end( )) // no block in use in the current arena
+    {
+        _head = 0;
+        return size <= _arena->size ? 0 : invalid;
+    }
+
+    if( _head > tail->offset ) // free: [head, end) and [0, tail)
+    {
+        if( _head + size <= _arena->size )
+            return _head;
+        return size <= tail->offset ? 0 : invalid;
+    }
+    // wrapped, free: [head, tail)
+    return _head + size <= tail->offset ? _head : invalid;
+}
+
+bool SharedImageArena::write( const void* data, const uint64_t size,
+                              const uint32_t nReaders, Handle& handle )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    if( !_key || nReaders == 0 )
+        return false;
+
+    const uint64_t blockSize = _align( sizeof( BlockHeader ) + size );
+    if( !_arena || blockSize > _arena->size )
+    {
+        // grow into a new arena, the old one lives until its blocks are read
+        const uint64_t arenaSize = std::max( _minArenaSize, 4 * blockSize );
+        Segment* arena = new Segment;
+        if( !_create( _getName( _key, _generation + 1 ), arenaSize,
+                      arena->data, arena->mapping, true ))
+        {
+            delete arena;
+            return false;
+        }
+        arena->size = arenaSize;
+        if( _arena )
+            _retired.push_back( _arena );
+        _arena = arena;
+        ++_generation;
+        _head = 0;
+    }
+
+    const uint64_t offset = _allocate( blockSize );
+    if( offset == ~0ull )
+        return false; // full, receivers are behind
+
+    BlockHeader* header = new( _getHeader( _arena->data, offset )) BlockHeader;
+    header->size = size;
+    ::memcpy( reinterpret_cast< uint8_t* >( header + 1 ), data, size );
+    header->readers.store( nReaders, std::memory_order_release );
+
+    const Block block = { _arena, offset };
+    _blocks.push_back( block );
+    _head = offset + blockSize;
+
+    handle.owner = _key;
+    handle.generation = _generation;
+    handle.padding = 0;
+    handle.offset = offset;
+    handle.size = size;
+    return true;
+}
+
+void SharedImageArena::discard( const Handle& handle )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    LBASSERT( handle.owner == _key );
+    if( handle.generation != _generation )
+        return; // only recently written blocks are discarded
+
+    for( std::deque< Block >::reverse_iterator i = _blocks.rbegin();
+         i != _blocks.rend() && i->segment == _arena; ++i )
+    {
+        if( i->offset == handle.offset )
+        {
+            _getHeader( _arena->data, i->offset )->readers.store(
+                0, std::memory_order_release );
+            return;
+        }
+    }
+}
+
+const void* SharedImageArena::map( const Handle& handle )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    const void* segment = _map( handle );
+    if( !segment )
+        return 0;
+
+    const BlockHeader* header = reinterpret_cast< const BlockHeader* >(
+        static_cast< const uint8_t* >( segment ) + handle.offset );
+    LBASSERT( header->size == handle.size );
+    return header + 1;
+}
+
+const void* SharedImageArena::_map( const Handle& handle )
+{
+    Mapping& mapping = _mappings[ handle.owner ];
+    if( mapping.second.data && mapping.first == handle.generation )
+        return mapping.second.data;
+
+    // the sender grew its arena, older blocks have been released already
+    Segment& segment = mapping.second;
+    if( segment.data )
+        _close( _getName( handle.owner, mapping.first ), segment.data,
+                segment.size, segment.mapping, false );
+    segment = Segment();
+
+    const std::string& name = _getName( handle.owner, handle.generation );
+    if( !_open( name, segment.data, segment.size, segment.mapping ))
+    {
+        LBWARN << "Can't map shared image memory " << name << std::endl;
+        _mappings.erase( handle.owner );
+        return 0;
+    }
+    mapping.first = handle.generation;
+    return segment.data;
+}
+
+void SharedImageArena::release( const Handle& handle )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    void* segment = const_cast< void* >( _map( handle ));
+    if( segment )
+        _getHeader( segment, handle.offset )->readers.fetch_sub(
+            1, std::memory_order_acq_rel );
+}
+}
+}
@@ -0,0 +1,122 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_SHAREDIMAGEARENA_H
+#define EQ_DETAIL_SHAREDIMAGEARENA_H
+
+#include <eq/client/types.h>
+#include <lunchbox/lock.h>
+#include <boost/noncopyable.hpp>
+#include <deque>
+#include <map>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * Transports image pixels between the processes of a host in shared memory.
+ *
+ * Each process announces itself with a marker segment named after its node
+ * identifier, so that senders detect receivers on the same host. The sender
+ * copies the pixels of an image once into a block of its arena segment, and
+ * sends only a Handle over the network connection. The receivers map the
+ * arena of the sender, copy the pixels and release the block. Blocks are
+ * allocated round-robin, a block is reused when all its readers released it.
+ * When the arena is full, the images are transmitted over the network.
+ *
+ * Thread safe.
+ */
+class SharedImageArena : public boost::noncopyable
+{
+public:
+    /** The reference to a block, sent instead of the pixels. */
+    struct Handle
+    {
+        uint64_t owner; //!< the key of the writing process
+        uint32_t generation; //!< the arena segment of the owner
+        uint32_t padding;
+        uint64_t offset; //!< the position of the block in the segment
+        uint64_t size; //!< the number of pixel bytes
+    };
+
+    SharedImageArena();
+    ~SharedImageArena();
+
+    /** Announce this process on the host. */
+    bool open( const uint128_t& nodeID );
+
+    /** Retract the announcement and unmap all segments. */
+    void close();
+
+    /** @return true if the given process announced itself on this host. */
+    bool isLocal( const uint128_t& nodeID );
+
+    /**
+     * Copy data into a free block, to be released by nReaders receivers.
+     * @return false if the arena has no room for the data.
+     */
+    bool write( const void* data, uint64_t size, uint32_t nReaders,
+                Handle& handle );
+
+    /** Free a written block which will not be sent to its readers. */
+    void discard( const Handle& handle );
+
+    /** @return the pixels of a block written by another process, or 0. */
+    const void* map( const Handle& handle );
+
+    /** Release a block after its pixels have been copied. */
+    void release( const Handle& handle );
+
+private:
+    struct Segment
+    {
+        Segment() : data( 0 ), size( 0 ), mapping( 0 ) {}
+        void* data;
+        uint64_t size;
+        void* mapping; //!< the file mapping on Windows
+    };
+
+    struct Block
+    {
+        Segment* segment;
+        uint64_t offset;
+    };
+
+    mutable lunchbox::Lock _lock;
+    uint64_t _key; //!< the key of this process, 0 when closed
+    Segment _marker;
+
+    // written blocks
+    Segment* _arena; //!< the current arena segment
+    uint32_t _generation;
+    uint64_t _head; //!< the next free offset of the current arena
+    std::deque< Block > _blocks; //!< blocks with readers, in write order
+    std::deque< Segment* > _retired; //!< old arenas with blocks in use
+
+    // mapped arenas of other processes, by owner
+    typedef std::pair< uint32_t, Segment > Mapping;
+    std::map< uint64_t, Mapping > _mappings;
+    std::map< uint64_t, bool > _local; //!< isLocal() results, by key
+
+    void _reclaim();
+    uint64_t _allocate( uint64_t size );
+    const void* _map( const Handle& handle );
+};
+}
+}
+
+#endif // EQ_DETAIL_SHAREDIMAGEARENA_H
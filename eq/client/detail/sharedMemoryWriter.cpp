@@ -0,0 +1,238 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "sharedMemoryWriter.h"
+
+#include "../channel.h"
+#include "../image.h"
+#include "../pipe.h"
+#include "../pixelData.h"
+#include "../sharedMemoryRing.h"
+
+#include <lunchbox/log.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  ifdef __linux__
+#    include <linux/futex.h>
+#    include <sys/syscall.h>
+#    include <climits>
+#  endif
+#endif
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+typedef SharedMemoryRing::Header Header;
+typedef SharedMemoryRing::Frame Frame;
+
+std::string _getSegmentName( const std::string& name )
+{
+#ifdef _WIN32
+    return name;
+#else
+    return name[0] == '/' ? name : "/" + name;
+#endif
+}
+
+void _wakeConsumers( Header* header )
+{
+#ifdef __linux__
+    ::syscall( SYS_futex, &header->published, FUTEX_WAKE, INT_MAX, 0, 0, 0 );
+#else
+    (void)header;
+#endif
+}
+}
+
+SharedMemoryWriter::SharedMemoryWriter()
+    : ResultImageListener()
+    , _segment( 0 )
+    , _size( 0 )
+    , _handle( 0 )
+{
+}
+
+SharedMemoryWriter::~SharedMemoryWriter()
+{
+    _close();
+}
+
+void SharedMemoryWriter::notifyNewImage( eq::Channel& channel,
+                                         const eq::Image& image )
+{
+    if( !image.hasPixelData( eq::Frame::BUFFER_COLOR ))
+        return;
+
+    const std::string& name =
+        channel.getSAttribute( eq::Channel::SATTR_SHARED_MEMORY );
+    const PixelData& pixels = image.getPixelData( eq::Frame::BUFFER_COLOR );
+    const uint32_t size = image.getPixelDataSize( eq::Frame::BUFFER_COLOR );
+    const uint32_t slotSize = uint32_t( sizeof( Frame )) + size;
+
+    Header* header = static_cast< Header* >( _segment );
+    if( name != _name || !header || slotSize > header->slotSize )
+    {
+        _close();
+        // leave room for growing windows
+        if( !_open( name, slotSize + slotSize / 4 ))
+            return;
+        header = static_cast< Header* >( _segment );
+    }
+
+    const uint64_t sequence = header->sequence + 1;
+    const uint32_t slot = uint32_t(( sequence - 1 ) % header->nSlots );
+    Frame* frame = const_cast< Frame* >(
+        SharedMemoryRing::getFrame( _segment, slot ));
+
+    frame->sequence = 2 * sequence - 1; // odd while writing
+    std::atomic_thread_fence( std::memory_order_release );
+
+    frame->frameNumber = channel.getPipe()->getCurrentFrame();
+    frame->externalFormat = pixels.externalFormat;
+    frame->pixelSize = pixels.pixelSize;
+    frame->size = size;
+    frame->x = pixels.pvp.x;
+    frame->y = pixels.pvp.y;
+    frame->width = pixels.pvp.w;
+    frame->height = pixels.pvp.h;
+    ::memcpy( frame + 1, pixels.pixels, size );
+
+    std::atomic_thread_fence( std::memory_order_release );
+    frame->sequence = 2 * sequence;
+    header->sequence = sequence;
+    std::atomic_thread_fence( std::memory_order_release );
+    ++header->published;
+    _wakeConsumers( header );
+}
+
+bool SharedMemoryWriter::_open( const std::string& name,
+                                const uint32_t slotSize )
+{
+    const std::string& segmentName = _getSegmentName( name );
+    const size_t size = sizeof( Header ) +
+                        SharedMemoryRing::NUM_SLOTS * size_t( slotSize );
+#ifdef _WIN32
+    _handle = ::CreateFileMapping( INVALID_HANDLE_VALUE, 0, PAGE_READWRITE,
+                                   DWORD( uint64_t( size ) >> 32 ),
+                                   DWORD( size & 0xffffffffu ),
+                                   segmentName.c_str( ));
+    if( !_handle )
+    {
+        LBWARN << "Can't create shared memory " << name << ": "
+               << ::GetLastError() << std::endl;
+        return false;
+    }
+    _segment = ::MapViewOfFile( _handle, FILE_MAP_WRITE, 0, 0, size );
+    if( !_segment )
+    {
+        LBWARN << "Can't map shared memory " << name << ": "
+               << ::GetLastError() << std::endl;
+        ::CloseHandle( _handle );
+        _handle = 0;
+        return false;
+    }
+#else
+    // recreate to let consumers of an abandoned segment reopen the new one
+    ::shm_unlink( segmentName.c_str( ));
+    const int fd = ::shm_open( segmentName.c_str(), O_CREAT | O_RDWR, 0644 );
+    if( fd == -1 )
+    {
+        LBWARN << "Can't create shared memory " << name << ": "
+               << ::strerror( errno ) << std::endl;
+        return false;
+    }
+    if( ::ftruncate( fd, off_t( size )) != 0 )
+    {
+        LBWARN << "Can't resize shared memory " << name << ": "
+               << ::strerror( errno ) << std::endl;
+        ::close( fd );
+        ::shm_unlink( segmentName.c_str( ));
+        return false;
+    }
+    void* segment = ::mmap( 0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                            0 );
+    ::close( fd );
+    if( segment == MAP_FAILED )
+    {
+        LBWARN << "Can't map shared memory " << name << ": "
+               << ::strerror( errno ) << std::endl;
+        ::shm_unlink( segmentName.c_str( ));
+        return false;
+    }
+    _segment = segment;
+#endif
+
+    _name = name;
+    _size = size;
+
+    Header* header = static_cast< Header* >( _segment );
+    header->version = SharedMemoryRing::VERSION;
+    header->nSlots = SharedMemoryRing::NUM_SLOTS;
+    header->slotSize = slotSize;
+    header->published = 0;
+    header->padding = 0;
+    header->sequence = 0;
+    for( uint32_t i = 0; i < SharedMemoryRing::NUM_SLOTS; ++i )
+    {
+        Frame* frame = const_cast< Frame* >(
+            SharedMemoryRing::getFrame( _segment, i ));
+        frame->sequence = 0;
+    }
+    std::atomic_thread_fence( std::memory_order_release );
+    header->magic = SharedMemoryRing::MAGIC;
+
+    LBINFO << "Publishing frames to shared memory " << name << std::endl;
+    return true;
+}
+
+void SharedMemoryWriter::_close()
+{
+    if( !_segment )
+        return;
+
+    Header* header = static_cast< Header* >( _segment );
+    header->magic = 0;
+    std::atomic_thread_fence( std::memory_order_release );
+    ++header->published;
+    _wakeConsumers( header );
+
+#ifdef _WIN32
+    ::UnmapViewOfFile( _segment );
+    ::CloseHandle( _handle );
+    _handle = 0;
+#else
+    ::munmap( _segment, _size );
+    ::shm_unlink( _getSegmentName( _name ).c_str( ));
+#endif
+    _segment = 0;
+    _size = 0;
+    _name.clear();
+}
+}
+}
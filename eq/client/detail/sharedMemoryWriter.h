@@ -0,0 +1,54 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_SHAREDMEMORYWRITER_H
+#define EQ_DETAIL_SHAREDMEMORYWRITER_H
+
+#include <eq/client/resultImageListener.h> // base class
+#include <eq/client/types.h>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * Publish the color buffer of a channel to a shared memory segment.
+ *
+ * The segment is named Channel::SATTR_SHARED_MEMORY, and has the layout
+ * described by SharedMemoryRing. Frames are written without waiting for the
+ * consumers, which detect overwritten frames using the slot sequence.
+ */
+class SharedMemoryWriter : public ResultImageListener
+{
+public:
+    SharedMemoryWriter();
+    ~SharedMemoryWriter();
+
+    void notifyNewImage( eq::Channel& channel, const eq::Image& image ) final;
+
+private:
+    std::string _name;
+    void* _segment;
+    size_t _size;
+    void* _handle; //!< the file mapping on Windows
+
+    bool _open( const std::string& name, uint32_t slotSize );
+    void _close();
+};
+}
+}
+
+#endif // EQ_DETAIL_SHAREDMEMORYWRITER_H
@@ -0,0 +1,99 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "spans.h"
+
+#include <cstring>
+
+namespace eq
+{
+namespace detail
+{
+namespace spans
+{
+void compute( const uint32_t* depth, const uint32_t w, const uint32_t h,
+              std::vector< uint32_t >& table )
+{
+    std::vector< uint32_t > pairs;
+    table.resize( h + 1 );
+    for( uint32_t y = 0; y < h; ++y )
+    {
+        table[ y ] = uint32_t( pairs.size( ));
+        const uint32_t* row = depth + size_t( y ) * w;
+        uint32_t x = 0;
+        while( x < w )
+        {
+            while( x < w && row[x] == FAR_PLANE )
+                ++x;
+            if( x == w )
+                break;
+
+            pairs.push_back( x );
+            while( x < w && row[x] != FAR_PLANE )
+                ++x;
+            pairs.push_back( x );
+        }
+    }
+    table[ h ] = uint32_t( pairs.size( ));
+    table.insert( table.end(), pairs.begin(), pairs.end( ));
+}
+
+size_t getNumActivePixels( const std::vector< uint32_t >& table,
+                           const uint32_t h )
+{
+    size_t nPixels = 0;
+    for( size_t i = h + 1; i + 1 < table.size(); i += 2 )
+        nPixels += table[i+1] - table[i];
+    return nPixels;
+}
+
+void pack( const uint8_t* dense, const size_t pixelSize, const uint32_t w,
+           const uint32_t h, const std::vector< uint32_t >& table,
+           uint8_t* packed )
+{
+    for( uint32_t y = 0; y < h; ++y )
+    {
+        const uint8_t* row = dense + size_t( y ) * w * pixelSize;
+        for( const uint32_t* i = getBegin( table, h, y );
+             i != getEnd( table, h, y ); i += 2 )
+        {
+            const size_t size = size_t( i[1] - i[0] ) * pixelSize;
+            ::memcpy( packed, row + i[0] * pixelSize, size );
+            packed += size;
+        }
+    }
+}
+
+void unpack( const uint8_t* packed, const size_t pixelSize, const uint32_t w,
+             const uint32_t h, const std::vector< uint32_t >& table,
+             uint8_t* dense )
+{
+    for( uint32_t y = 0; y < h; ++y )
+    {
+        uint8_t* row = dense + size_t( y ) * w * pixelSize;
+        for( const uint32_t* i = getBegin( table, h, y );
+             i != getEnd( table, h, y ); i += 2 )
+        {
+            const size_t size = size_t( i[1] - i[0] ) * pixelSize;
+            ::memcpy( row + i[0] * pixelSize, packed, size );
+            packed += size;
+        }
+    }
+}
+}
+}
+}
@@ -0,0 +1,73 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQ_DETAIL_SPANS_H
+#define EQ_DETAIL_SPANS_H
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * Span tables of sparse images, see PixelData::spans.
+ *
+ * A table for h rows starts with h+1 offsets, followed by the begin and end
+ * column of each active span. The spans of row y are the pairs from
+ * table[h+1+offset[y]] to table[h+1+offset[y+1]].
+ */
+namespace spans
+{
+/** The depth value of background pixels. */
+static const uint32_t FAR_PLANE = 0xffffffffu;
+
+/** Build the span table of a w*h depth buffer. */
+void compute( const uint32_t* depth, uint32_t w, uint32_t h,
+              std::vector< uint32_t >& table );
+
+/** @return the first pair of row y in the table of h rows. */
+inline const uint32_t* getBegin( const std::vector< uint32_t >& table,
+                                 const uint32_t h, const uint32_t y )
+{
+    return &table[0] + h + 1 + table[ y ];
+}
+
+/** @return the end of the pairs of row y in the table of h rows. */
+inline const uint32_t* getEnd( const std::vector< uint32_t >& table,
+                               const uint32_t h, const uint32_t y )
+{
+    return &table[0] + h + 1 + table[ y+1 ];
+}
+
+/** @return the number of active pixels in a span table. */
+size_t getNumActivePixels( const std::vector< uint32_t >& table, uint32_t h );
+
+/** Copy the active pixels of a w*h dense buffer, packed row by row. */
+void pack( const uint8_t* dense, size_t pixelSize, uint32_t w, uint32_t h,
+           const std::vector< uint32_t >& table, uint8_t* packed );
+
+/** Copy packed active pixels into a w*h dense buffer. */
+void unpack( const uint8_t* packed, size_t pixelSize, uint32_t w, uint32_t h,
+             const std::vector< uint32_t >& table, uint8_t* dense );
+}
+}
+}
+
+#endif // EQ_DETAIL_SPANS_H
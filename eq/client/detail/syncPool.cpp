@@ -0,0 +1,147 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "syncPool.h"
+
+#include "../log.h"
+
+#include <co/object.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/thread.h>
+#include <boost/foreach.hpp>
+
+#include <algorithm>
+#include <map>
+#include <thread>
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+/** The upper limit of synchronization threads per node. */
+const size_t _maxThreads = 8;
+
+void _sync( const Node::SyncObjects& objects )
+{
+    BOOST_FOREACH( const Node::SyncObject& object, objects )
+        object.object->sync( object.version );
+}
+}
+
+class SyncThread : public lunchbox::Thread
+{
+public:
+    explicit SyncThread( SyncPool& pool ) : _pool( pool ) {}
+    virtual ~SyncThread() {}
+
+protected:
+    bool init() override { setName( "Sync" ); return true; }
+
+    void run() override
+    {
+        while( true )
+        {
+            const SyncPool::Task task = _pool._tasks.pop();
+            if( task.objects.empty( ))
+                return;
+
+            _sync( task.objects );
+            --( *task.pending );
+        }
+    }
+
+private:
+    SyncPool& _pool;
+};
+
+SyncPool::SyncPool()
+{}
+
+SyncPool::~SyncPool()
+{
+    for( size_t i = 0; i < _threads.size(); ++i )
+        _tasks.push( Task( )); // stop
+    BOOST_FOREACH( SyncThread* thread, _threads )
+    {
+        thread->join();
+        delete thread;
+    }
+}
+
+void SyncPool::sync( const Node::SyncObjects& objects )
+{
+    // one task per group of dependent objects, and per independent object
+    typedef std::map< uint32_t, Node::SyncObjects > Groups;
+    Groups groups;
+    std::vector< Task > tasks;
+    BOOST_FOREACH( const Node::SyncObject& object, objects )
+    {
+        LBASSERT( object.object );
+        if( object.group == 0 )
+        {
+            tasks.push_back( Task( ));
+            tasks.back().objects.push_back( object );
+        }
+        else
+            groups[ object.group ].push_back( object );
+    }
+    BOOST_FOREACH( Groups::value_type& group, groups )
+    {
+        tasks.push_back( Task( ));
+        tasks.back().objects.swap( group.second );
+    }
+
+    if( tasks.size() < 2 )
+    {
+        _sync( objects );
+        return;
+    }
+
+    _start();
+
+    // keep the last task for the calling thread
+    lunchbox::Monitor< uint32_t > pending( uint32_t( tasks.size() - 1 ));
+    for( size_t i = 0; i < tasks.size() - 1; ++i )
+    {
+        tasks[i].pending = &pending;
+        _tasks.push( tasks[i] );
+    }
+    _sync( tasks.back().objects );
+    pending.waitEQ( 0 );
+}
+
+void SyncPool::_start()
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    if( !_threads.empty( ))
+        return;
+
+    const size_t nThreads = std::min( size_t( std::max( 1u,
+                                      std::thread::hardware_concurrency( ))),
+                                      _maxThreads );
+    for( size_t i = 0; i < nThreads; ++i )
+    {
+        SyncThread* thread = new SyncThread( *this );
+        thread->start();
+        _threads.push_back( thread );
+    }
+    LBLOG( LOG_INIT ) << "Started " << nThreads << " object sync threads"
+                      << std::endl;
+}
+}
+}
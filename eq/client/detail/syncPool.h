@@ -0,0 +1,69 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_SYNCPOOL_H
+#define EQ_DETAIL_SYNCPOOL_H
+
+#include <eq/client/node.h> // Node::SyncObjects
+
+#include <lunchbox/lock.h>
+#include <lunchbox/monitor.h>
+#include <lunchbox/mtQueue.h>
+
+#include <vector>
+
+namespace eq
+{
+namespace detail
+{
+class SyncThread;
+
+/**
+ * A node-wide set of threads synchronizing application objects in parallel.
+ *
+ * Used by eq::Node::syncObjects(). The threads are started on first use.
+ */
+class SyncPool
+{
+public:
+    SyncPool();
+    ~SyncPool();
+
+    /** Synchronize all objects, returns when they are synchronized. */
+    void sync( const Node::SyncObjects& objects );
+
+private:
+    friend class SyncThread;
+
+    /** Objects synchronized in order by one thread. */
+    struct Task
+    {
+        Task() : pending( 0 ) {}
+
+        Node::SyncObjects objects; //!< empty to stop a thread
+        lunchbox::Monitor< uint32_t >* pending; //!< decremented when done
+    };
+
+    lunchbox::MTQueue< Task > _tasks;
+    std::vector< SyncThread* > _threads;
+    lunchbox::Lock _lock;
+
+    void _start();
+};
+}
+}
+
+#endif // EQ_DETAIL_SYNCPOOL_H
@@ -0,0 +1,280 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "temporalUpsampler.h"
+
+#include "../channel.h"
+#include "../gl.h"
+#include "../log.h"
+#include "../window.h"
+
+#include <eq/util/objectManager.h>
+#include <eq/util/shader.h>
+#include <eq/util/texture.h>
+
+#include <algorithm>
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+enum Key
+{
+    KEY_CURRENT, //!< color of the assembled frame
+    KEY_DEPTH,   //!< depth of the assembled frame
+    KEY_HISTORY, //!< color of the accumulated frames
+    KEY_RESOLVE, //!< resolve program, quad vertex array and buffer
+    KEY_ALL
+};
+
+/** Frames after which the history weight stays constant. */
+const uint32_t _maxFrames = 8;
+
+Matrix4f _getViewProjection( const eq::Channel& channel )
+{
+    const Matrix4f& projection = channel.useOrtho() ?
+        channel.getOrtho().compute_ortho_matrix() :
+        channel.getPerspective().compute_matrix();
+    return projection * channel.getHeadTransform();
+}
+}
+
+TemporalUpsampler::TemporalUpsampler()
+    : _glewContext( 0 )
+    , _pvp()
+    , _viewProjection( Matrix4f::IDENTITY )
+    , _nFrames( 0 )
+    , _valid( false )
+{}
+
+TemporalUpsampler::~TemporalUpsampler()
+{}
+
+const char* TemporalUpsampler::_getKey( const size_t index ) const
+{
+    return reinterpret_cast< const char* >( this ) + index;
+}
+
+void TemporalUpsampler::resolve( eq::Channel& channel, const Vector2f& offset )
+{
+    _glewContext = channel.glewGetContext();
+    const PixelViewport& pvp = channel.getPixelViewport();
+    if( !pvp.hasArea( ))
+    {
+        _valid = false;
+        return;
+    }
+
+    util::ObjectManager& om = channel.getObjectManager();
+    const Window* window = channel.getWindow();
+    const bool hasDepth =
+        window->getIAttribute( WindowSettings::IATTR_PLANES_DEPTH ) != OFF;
+
+    EQ_GL_CALL( channel.applyBuffer( ));
+    EQ_GL_CALL( channel.applyViewport( ));
+
+    const Matrix4f viewProjection = _getViewProjection( channel );
+    Matrix4f inverse;
+    if( _valid && pvp == _pvp && viewProjection.inverse( inverse ))
+    {
+        util::Texture* current = om.obtainEqTexture( _getKey( KEY_CURRENT ),
+                                                     GL_TEXTURE_RECTANGLE_ARB );
+        current->copyFromFrameBuffer( GL_RGBA, pvp );
+        if( hasDepth )
+        {
+            util::Texture* depth = om.obtainEqTexture( _getKey( KEY_DEPTH ),
+                                                     GL_TEXTURE_RECTANGLE_ARB );
+            depth->copyFromFrameBuffer( GL_DEPTH_COMPONENT, pvp );
+        }
+
+        _nFrames = std::min( _nFrames + 1, _maxFrames );
+        _drawResolve( channel, _viewProjection * inverse, offset, hasDepth );
+    }
+    else
+        _nFrames = 1;
+
+    util::Texture* history = om.obtainEqTexture( _getKey( KEY_HISTORY ),
+                                                 GL_TEXTURE_RECTANGLE_ARB );
+    history->copyFromFrameBuffer( GL_RGBA, pvp );
+    _pvp = pvp;
+    _viewProjection = viewProjection;
+    _valid = true;
+}
+
+void TemporalUpsampler::flush( eq::Channel& channel )
+{
+    util::ObjectManager& om = channel.getObjectManager();
+    for( size_t i = KEY_CURRENT; i <= KEY_HISTORY; ++i )
+        om.deleteEqTexture( _getKey( i ));
+
+    om.deleteProgram( _getKey( KEY_RESOLVE ));
+    om.deleteVertexArray( _getKey( KEY_RESOLVE ));
+    om.deleteBuffer( _getKey( KEY_RESOLVE ));
+    _valid = false;
+    _nFrames = 0;
+}
+
+void TemporalUpsampler::_drawResolve( eq::Channel& channel,
+                                      const Matrix4f& reproject,
+                                      const Vector2f& offset,
+                                      const bool hasDepth )
+{
+    util::ObjectManager& om = channel.getObjectManager();
+    const char* key = _getKey( KEY_RESOLVE );
+    GLuint program = om.getProgram( key );
+    GLuint vertexArray = om.getVertexArray( key );
+    GLuint vertexBuffer = om.getBuffer( key );
+    if( program == util::ObjectManager::INVALID )
+    {
+        vertexBuffer = om.newBuffer( key );
+        vertexArray = om.newVertexArray( key );
+        program = om.newProgram( key );
+
+        const char* vertexShaderGLSL = {
+            "#version 330 core\n"
+            "layout(location = 0) in vec4 vert;\n"
+            "out vec2 fragTexCoord;\n"
+            "void main() {\n"
+            "    fragTexCoord = vert.zw;\n"
+            "    gl_Position = vec4( vert.xy, 0, 1 );\n"
+            "}\n"
+        };
+
+        // The current frame is sampled at its unjittered position, the
+        // history at the position of the pixel in the last frustum. The
+        // history is clamped to the colors around the current sample, which
+        // rejects it where the scene changed.
+        const char* fragmentShaderGLSL = {
+            "#version 330 core\n"
+            "#extension GL_ARB_texture_rectangle : enable\n"
+            "uniform sampler2DRect current;\n"
+            "uniform sampler2DRect depth;\n"
+            "uniform sampler2DRect history;\n"
+            "uniform mat4 reproject;\n"
+            "uniform vec2 size;\n"
+            "uniform vec2 offset;\n"
+            "uniform float alpha;\n"
+            "uniform bool hasDepth;\n"
+            "in vec2 fragTexCoord;\n"
+            "out vec4 finalColor;\n"
+            "void main() {\n"
+            "    vec2 pos = fragTexCoord - offset;\n"
+            "    vec4 color = texture2DRect( current, pos );\n"
+            "    vec4 minColor = color;\n"
+            "    vec4 maxColor = color;\n"
+            "    for( int y = -1; y <= 1; ++y )\n"
+            "        for( int x = -1; x <= 1; ++x ) {\n"
+            "            vec4 c = texture2DRect( current, pos + vec2( x, y ));\n"
+            "            minColor = min( minColor, c );\n"
+            "            maxColor = max( maxColor, c );\n"
+            "        }\n"
+            "    float z = hasDepth ? texture2DRect( depth, fragTexCoord ).x\n"
+            "                       : 1.0;\n"
+            "    vec4 last = reproject * vec4( 2.0 * fragTexCoord / size - 1.0,\n"
+            "                                  2.0 * z - 1.0, 1.0 );\n"
+            "    vec2 lastCoord = ( last.xy / last.w * 0.5 + 0.5 ) * size;\n"
+            "    if( last.w <= 0.0 || any( lessThan( lastCoord, vec2( 0 ))) ||\n"
+            "        any( greaterThan( lastCoord, size ))) {\n"
+            "        finalColor = color;\n"
+            "        return;\n"
+            "    }\n"
+            "    vec4 previous = clamp( texture2DRect( history, lastCoord ),\n"
+            "                           minColor, maxColor );\n"
+            "    finalColor = mix( previous, color, alpha );\n"
+            "}\n"
+        };
+
+        LBCHECK( util::shader::linkProgram( glewGetContext(), program,
+                                            vertexShaderGLSL,
+                                            fragmentShaderGLSL ));
+
+        EQ_GL_CALL( glUseProgram( program ));
+        GLint param = glGetUniformLocation( program, "current" );
+        EQ_GL_CALL( glUniform1i( param, 0 ));
+        param = glGetUniformLocation( program, "depth" );
+        EQ_GL_CALL( glUniform1i( param, 1 ));
+        param = glGetUniformLocation( program, "history" );
+        EQ_GL_CALL( glUniform1i( param, 2 ));
+    }
+
+    // full-viewport quad in normalized device coordinates
+    const GLfloat w = float( _pvp.w );
+    const GLfloat h = float( _pvp.h );
+    const GLfloat vertices[] = {
+        -1.f, -1.f, 0.f, 0.f,
+         1.f, -1.f, w,   0.f,
+        -1.f,  1.f, 0.f, h,
+         1.f,  1.f, w,   h
+    };
+
+    util::Texture* history = om.getEqTexture( _getKey( KEY_HISTORY ));
+    EQ_GL_CALL( glActiveTexture( GL_TEXTURE2 ));
+    history->bind();
+    history->applyZoomFilter( FILTER_LINEAR );
+    if( hasDepth )
+    {
+        util::Texture* depth = om.getEqTexture( _getKey( KEY_DEPTH ));
+        EQ_GL_CALL( glActiveTexture( GL_TEXTURE1 ));
+        depth->bind();
+        depth->applyZoomFilter( FILTER_NEAREST );
+    }
+    util::Texture* current = om.getEqTexture( _getKey( KEY_CURRENT ));
+    EQ_GL_CALL( glActiveTexture( GL_TEXTURE0 ));
+    current->bind();
+    current->applyZoomFilter( FILTER_LINEAR );
+
+    EQ_GL_CALL( glBindVertexArray( vertexArray ));
+    EQ_GL_CALL( glUseProgram( program ));
+
+    GLint param = glGetUniformLocation( program, "reproject" );
+    EQ_GL_CALL( glUniformMatrix4fv( param, 1, GL_FALSE, &reproject[0] ));
+    param = glGetUniformLocation( program, "size" );
+    EQ_GL_CALL( glUniform2f( param, w, h ));
+    param = glGetUniformLocation( program, "offset" );
+    EQ_GL_CALL( glUniform2f( param, offset.x(), offset.y( )));
+    param = glGetUniformLocation( program, "alpha" );
+    EQ_GL_CALL( glUniform1f( param, 1.f / float( _nFrames )));
+    param = glGetUniformLocation( program, "hasDepth" );
+    EQ_GL_CALL( glUniform1i( param, hasDepth ? 1 : 0 ));
+
+    EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, vertexBuffer ));
+    EQ_GL_CALL( glBufferData( GL_ARRAY_BUFFER, sizeof(vertices), vertices,
+                              GL_DYNAMIC_DRAW ));
+    EQ_GL_CALL( glVertexAttribPointer( 0, 4, GL_FLOAT, GL_FALSE, 0, 0 ));
+    EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, 0 ));
+
+    EQ_GL_CALL( glDisable( GL_DEPTH_TEST ));
+    EQ_GL_CALL( glDisable( GL_BLEND ));
+    EQ_GL_CALL( glEnableVertexAttribArray( 0 ));
+    EQ_GL_CALL( glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 ));
+    EQ_GL_CALL( glDisableVertexAttribArray( 0 ));
+
+    EQ_GL_CALL( glBindVertexArray( 0 ));
+    EQ_GL_CALL( glUseProgram( 0 ));
+
+    EQ_GL_CALL( glActiveTexture( GL_TEXTURE2 ));
+    EQ_GL_CALL( glBindTexture( GL_TEXTURE_RECTANGLE_ARB, 0 ));
+    EQ_GL_CALL( glActiveTexture( GL_TEXTURE1 ));
+    EQ_GL_CALL( glBindTexture( GL_TEXTURE_RECTANGLE_ARB, 0 ));
+    EQ_GL_CALL( glActiveTexture( GL_TEXTURE0 ));
+    EQ_GL_CALL( glBindTexture( GL_TEXTURE_RECTANGLE_ARB, 0 ));
+}
+
+}
+}
@@ -0,0 +1,80 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQ_DETAIL_TEMPORALUPSAMPLER_H
+#define EQ_DETAIL_TEMPORALUPSAMPLER_H
+
+#include <eq/client/types.h>
+#include <boost/noncopyable.hpp>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * @internal
+ * Accumulates upscaled input frames of a destination channel over time.
+ *
+ * Used when the input frames are rendered at a reduced resolution, see
+ * Channel::IATTR_HINT_TEMPORAL_UPSAMPLING. The sources jitter their frustum by
+ * a sub-pixel offset which changes every frame. After the assembly, the
+ * full-resolution history is reprojected to the current frustum and head
+ * transformation using the depth buffer, clamped to the neighborhood of the
+ * current frame to avoid ghosting and blended with the current frame. All
+ * methods are called from the pipe thread with the channel's window context
+ * current.
+ */
+class TemporalUpsampler : public boost::noncopyable
+{
+public:
+    TemporalUpsampler();
+    ~TemporalUpsampler();
+
+    /**
+     * Blend the history into the assembled frame buffer of the channel and
+     * keep the result as the new history.
+     *
+     * @param channel the destination channel.
+     * @param offset the jitter of the current frame in destination pixels.
+     */
+    void resolve( eq::Channel& channel, const Vector2f& offset );
+
+    /** Discard the history, e.g., when the input frames are not upscaled. */
+    void reset() { _valid = false; }
+
+    /** @return true if a history is available. */
+    bool hasHistory() const { return _valid; }
+
+    /** Release all OpenGL objects of the channel's object manager. */
+    void flush( eq::Channel& channel );
+
+private:
+    const GLEWContext* _glewContext;
+    PixelViewport _pvp; //!< of the history
+    Matrix4f _viewProjection; //!< of the history
+    uint32_t _nFrames; //!< accumulated in the history
+    bool _valid;
+
+    const GLEWContext* glewGetContext() const { return _glewContext; }
+    const char* _getKey( size_t index ) const;
+    void _drawResolve( eq::Channel& channel, const Matrix4f& reproject,
+                       const Vector2f& offset, bool hasDepth );
+};
+}
+}
+
+#endif // EQ_DETAIL_TEMPORALUPSAMPLER_H
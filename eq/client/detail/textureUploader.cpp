@@ -0,0 +1,290 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "textureUploader.h"
+
+#include "../image.h"
+#include "../log.h"
+#include "../pixelData.h"
+
+#include <eq/util/texture.h>
+#include <lunchbox/scopedMutex.h>
+#include <pression/plugins/compressor.h>
+#include <cstring>
+
+#define glewGetContext() gl
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+static const UploadFormat _formats[] =
+{
+    { EQ_COMPRESSOR_DATATYPE_RGBA, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE },
+    { EQ_COMPRESSOR_DATATYPE_BGRA, GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE },
+    { EQ_COMPRESSOR_DATATYPE_RGB10_A2, GL_RGB10_A2, GL_RGBA,
+      GL_UNSIGNED_INT_10_10_10_2 },
+    { EQ_COMPRESSOR_DATATYPE_BGR10_A2, GL_RGB10_A2, GL_BGRA,
+      GL_UNSIGNED_INT_10_10_10_2 },
+    { EQ_COMPRESSOR_DATATYPE_RGBA16F, GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT },
+    { EQ_COMPRESSOR_DATATYPE_BGRA16F, GL_RGBA16F, GL_BGRA, GL_HALF_FLOAT },
+    { EQ_COMPRESSOR_DATATYPE_RGBA32F, GL_RGBA32F, GL_RGBA, GL_FLOAT },
+    { EQ_COMPRESSOR_DATATYPE_BGRA32F, GL_RGBA32F, GL_BGRA, GL_FLOAT },
+    { EQ_COMPRESSOR_DATATYPE_DEPTH_UNSIGNED_INT, GL_DEPTH_COMPONENT32,
+      GL_DEPTH_COMPONENT, GL_UNSIGNED_INT }
+};
+
+static void _waitSync( GLsync& sync, const GLEWContext* gl )
+{
+    if( !sync )
+        return;
+    EQ_GL_CALL( glWaitSync( sync, 0, GL_TIMEOUT_IGNORED ));
+    EQ_GL_CALL( glDeleteSync( sync ));
+    sync = 0;
+}
+
+static void _fenceSync( GLsync& sync, const GLEWContext* gl )
+{
+    if( sync )
+        EQ_GL_CALL( glDeleteSync( sync ));
+    sync = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+    EQ_GL_CALL( glFlush( ));
+}
+}
+
+const UploadFormat* getUploadFormat( const uint32_t externalFormat )
+{
+    const size_t nFormats = sizeof( _formats ) / sizeof( UploadFormat );
+    for( size_t i = 0; i < nFormats; ++i )
+        if( _formats[i].externalFormat == externalFormat )
+            return &_formats[i];
+    return 0;
+}
+
+TextureUploader::TextureUploader()
+    : _pbo( 0 )
+    , _uploaded( 0 )
+    , _drawn( 0 )
+    , _assembly( 0 )
+{}
+
+TextureUploader::~TextureUploader()
+{
+    LBASSERTINFO( _textures.empty() && _free.empty() && !_pbo,
+                  "OpenGL objects not flushed" );
+}
+
+void TextureUploader::start( const void* assembly )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    LBASSERT( _textures.empty( ));
+    _assembly = assembly;
+}
+
+bool TextureUploader::upload( const void* assembly, const eq::Frame& frame,
+                              const GLEWContext* gl )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    if( !assembly || assembly != _assembly )
+        return false;
+
+    // the recycled textures might still be drawn by the pipe thread
+    if( GLEW_ARB_sync )
+        _waitSync( _drawn, gl );
+
+    const Images& images = frame.getImages();
+    for( ImagesCIter i = images.begin(); i != images.end(); ++i )
+    {
+        const eq::Image* image = *i;
+        if( image->getStorageType() != Frame::TYPE_MEMORY )
+            continue;
+
+        _upload( image, Frame::BUFFER_COLOR, gl );
+        _upload( image, Frame::BUFFER_DEPTH, gl );
+    }
+
+    if( GLEW_ARB_sync )
+        _fenceSync( _uploaded, gl );
+    else
+        EQ_GL_CALL( glFinish( ));
+    return true;
+}
+
+void TextureUploader::_upload( const eq::Image* image,
+                               const eq::Frame::Buffer buffer,
+                               const GLEWContext* gl )
+{
+    if( !image->hasPixelData( buffer ))
+        return;
+
+    const PixelData& data = image->getPixelData( buffer );
+    const UploadFormat* format = getUploadFormat( data.externalFormat );
+    if( !format || data.pvp != image->getPixelViewport( ))
+        return; // left to the compositor
+
+    const PixelViewport& pvp = data.pvp;
+    util::Texture* texture = _obtainTexture( format->internalFormat, pvp, gl );
+    texture->init( format->internalFormat, pvp.w, pvp.h );
+    texture->setExternalFormat( format->format, format->type );
+
+    const void* pixels = data.pixels;
+    if( GLEW_ARB_pixel_buffer_object )
+    {
+        if( !_pbo )
+            EQ_GL_CALL( glGenBuffersARB( 1, &_pbo ));
+
+        // orphan the buffer, the previous upload may still read from it
+        const size_t size = image->getPixelDataSize( buffer );
+        EQ_GL_CALL( glBindBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB, _pbo ));
+        EQ_GL_CALL( glBufferDataARB( GL_PIXEL_UNPACK_BUFFER_ARB, size, 0,
+                                     GL_STREAM_DRAW_ARB ));
+        void* ptr = glMapBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB,
+                                    GL_WRITE_ONLY_ARB );
+        if( ptr )
+        {
+            ::memcpy( ptr, pixels, size );
+            EQ_GL_CALL( glUnmapBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB ));
+            pixels = 0; // offset into the bound buffer
+        }
+        else
+            EQ_GL_CALL( glBindBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB, 0 ));
+    }
+
+    texture->upload( pvp.w, pvp.h, pixels );
+    if( !pixels )
+        EQ_GL_CALL( glBindBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB, 0 ));
+
+    _textures[ Key( image, buffer )] = texture;
+    LBLOG( LOG_ASSEMBLY ) << "Uploaded " << pvp << " of " << image
+                          << std::endl;
+}
+
+util::Texture* TextureUploader::_obtainTexture( const GLint internalFormat,
+                                                const PixelViewport& pvp,
+                                                const GLEWContext* gl )
+{
+    // Hand out the smallest free texture fitting the image, the storage of
+    // streaming textures is only reallocated if none fits
+    std::vector< util::Texture* >::iterator best = _free.end();
+    for( std::vector< util::Texture* >::iterator i = _free.begin();
+         i != _free.end(); ++i )
+    {
+        const util::Texture* texture = *i;
+        if( texture->getInternalFormat() != GLuint( internalFormat ) ||
+            texture->getWidth() < pvp.w || texture->getHeight() < pvp.h )
+        {
+            continue;
+        }
+        if( best == _free.end() ||
+            texture->getWidth() * texture->getHeight() <
+            (*best)->getWidth() * (*best)->getHeight( ))
+        {
+            best = i;
+        }
+    }
+
+    if( best == _free.end( ))
+    {
+        if( _free.empty( ))
+        {
+            util::Texture* texture =
+                new util::Texture( GL_TEXTURE_RECTANGLE_ARB, gl );
+            texture->setStreaming( true );
+            return texture;
+        }
+        best = _free.end() - 1; // grows the storage
+    }
+
+    util::Texture* texture = *best;
+    _free.erase( best );
+    return texture;
+}
+
+void TextureUploader::stop( const GLEWContext* gl )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    _assembly = 0;
+    if( GLEW_ARB_sync )
+        _waitSync( _uploaded, gl );
+}
+
+void TextureUploader::release( const GLEWContext* gl )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    if( _textures.empty( ))
+        return;
+
+    for( Textures::const_iterator i = _textures.begin();
+         i != _textures.end(); ++i )
+    {
+        _free.push_back( i->second );
+    }
+    _textures.clear();
+    if( GLEW_ARB_sync )
+        _fenceSync( _drawn, gl );
+    else
+        EQ_GL_CALL( glFinish( ));
+}
+
+void TextureUploader::flush( const GLEWContext* gl )
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    LBASSERT( !_assembly );
+    for( Textures::const_iterator i = _textures.begin();
+         i != _textures.end(); ++i )
+    {
+        _free.push_back( i->second );
+    }
+    _textures.clear();
+
+    for( std::vector< util::Texture* >::const_iterator i = _free.begin();
+         i != _free.end(); ++i )
+    {
+        if( gl )
+            (*i)->flush();
+        else
+            (*i)->flushNoDelete();
+        delete *i;
+    }
+    _free.clear();
+
+    if( gl )
+    {
+        if( _pbo )
+            EQ_GL_CALL( glDeleteBuffersARB( 1, &_pbo ));
+        if( _uploaded )
+            EQ_GL_CALL( glDeleteSync( _uploaded ));
+        if( _drawn )
+            EQ_GL_CALL( glDeleteSync( _drawn ));
+    }
+    _pbo = 0;
+    _uploaded = 0;
+    _drawn = 0;
+}
+
+const util::Texture* TextureUploader::getTexture( const eq::Image* image,
+                                       const eq::Frame::Buffer buffer ) const
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    Textures::const_iterator i = _textures.find( Key( image, buffer ));
+    return i == _textures.end() ? 0 : i->second;
+}
+
+}
+}
@@ -0,0 +1,122 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_TEXTUREUPLOADER_H
+#define EQ_DETAIL_TEXTUREUPLOADER_H
+
+#include <eq/client/frame.h> // Frame::Buffer
+#include <eq/client/gl.h>
+#include <eq/util/types.h>
+#include <lunchbox/lock.h>
+#include <boost/noncopyable.hpp>
+#include <map>
+#include <vector>
+
+namespace eq
+{
+namespace detail
+{
+/** The OpenGL upload parameters of a pixel data type. */
+struct UploadFormat
+{
+    uint32_t externalFormat; //!< EQ_COMPRESSOR_DATATYPE_*
+    GLint internalFormat;
+    GLenum format;
+    GLenum type;
+};
+
+/** @return the upload parameters for the data type, or 0 if unsupported. */
+const UploadFormat* getUploadFormat( uint32_t externalFormat );
+
+/**
+ * @internal
+ * Uploads the memory images of input frames to textures as the frames arrive.
+ *
+ * Used by the asynchronous assembly of a destination channel, see
+ * Channel::IATTR_HINT_ASYNC_ASSEMBLY. The transfer thread uploads each ready
+ * frame through a streaming pixel buffer object on the shared transfer
+ * context, while the pipe thread is still waiting for the remaining frames.
+ * The compositor then draws the uploaded textures instead of uploading the
+ * images itself.
+ *
+ * start(), stop() and release() are called from the pipe thread, upload() and
+ * flush() from the transfer thread with its context current.
+ */
+class TextureUploader : public boost::noncopyable
+{
+public:
+    TextureUploader();
+    ~TextureUploader();
+
+    /** Accept uploads for the given assembly. */
+    void start( const void* assembly );
+
+    /**
+     * Upload all memory images of a ready frame.
+     *
+     * @return false if the uploads for the assembly have been stopped.
+     */
+    bool upload( const void* assembly, const eq::Frame& frame,
+                 const GLEWContext* gl );
+
+    /**
+     * Stop accepting uploads and make the finished uploads visible to the
+     * pipe thread's context.
+     */
+    void stop( const GLEWContext* gl );
+
+    /** Recycle all textures once they have been drawn. */
+    void release( const GLEWContext* gl );
+
+    /**
+     * Delete all OpenGL objects.
+     *
+     * @param gl the current transfer context, or 0 if it was destroyed and the
+     *           objects are released with the shared contexts.
+     */
+    void flush( const GLEWContext* gl );
+
+    /** @return true if no OpenGL objects are allocated. */
+    bool isEmpty() const
+        { return _textures.empty() && _free.empty() && !_pbo; }
+
+    /** @return the uploaded texture of an image buffer, or 0. */
+    const util::Texture* getTexture( const eq::Image* image,
+                                     eq::Frame::Buffer buffer ) const;
+
+private:
+    typedef std::pair< const eq::Image*, eq::Frame::Buffer > Key;
+    typedef std::map< Key, util::Texture* > Textures;
+
+    Textures _textures;
+    std::vector< util::Texture* > _free;
+    GLuint _pbo; //!< streaming pixel unpack buffer
+    GLsync _uploaded; //!< signaled when the uploads are complete
+    GLsync _drawn; //!< signaled when the recycled textures have been drawn
+    const void* _assembly; //!< the assembly accepting uploads, or 0
+    mutable lunchbox::Lock _lock;
+
+    void _upload( const eq::Image* image, eq::Frame::Buffer buffer,
+                  const GLEWContext* gl );
+    util::Texture* _obtainTexture( GLint internalFormat,
+                                   const PixelViewport& pvp,
+                                   const GLEWContext* gl );
+};
+}
+}
+
+#endif // EQ_DETAIL_TEXTUREUPLOADER_H
@@ -0,0 +1,113 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "timerQueries.h"
+
+#include "../gl.h"
+
+#include <eq/util/objectManager.h>
+
+#define glewGetContext() objectManager.glewGetContext()
+
+namespace eq
+{
+namespace detail
+{
+bool TimerQueries::isSupported( const util::ObjectManager& objectManager )
+{
+    return objectManager.supportsQueries() && GLEW_ARB_timer_query;
+}
+
+#undef glewGetContext
+#define glewGetContext() _objectManager.glewGetContext()
+
+TimerQueries::TimerQueries( util::ObjectManager& objectManager )
+    : _objectManager( objectManager )
+{}
+
+TimerQueries::~TimerQueries()
+{
+    for( std::deque< char >::const_iterator i = _keys.begin();
+         i != _keys.end(); ++i )
+    {
+        _objectManager.deleteQuery( &(*i) );
+    }
+}
+
+const void* TimerQueries::_newQuery()
+{
+    if( !_free.empty( ))
+    {
+        const void* key = _free.back();
+        _free.pop_back();
+        return key;
+    }
+
+    _keys.push_back( 0 );
+    const void* key = &_keys.back();
+    _objectManager.newQuery( key );
+    return key;
+}
+
+const void* TimerQueries::begin()
+{
+    const void* key = _newQuery();
+    EQ_GL_CALL( glQueryCounter( _objectManager.getQuery( key ),
+                                GL_TIMESTAMP ));
+    return key;
+}
+
+void TimerQueries::end( const Event& event, const void* beginQuery )
+{
+    const Pending pending = { event, beginQuery, _newQuery() };
+    EQ_GL_CALL( glQueryCounter( _objectManager.getQuery( pending.end ),
+                                GL_TIMESTAMP ));
+    _pending.push_back( pending );
+}
+
+bool TimerQueries::pop( Event& event, const int64_t time,
+                        const uint32_t waitFrame )
+{
+    if( _pending.empty( ))
+        return false;
+
+    // queries complete in order, the end query is the last one
+    const Pending& pending = _pending.front();
+    const bool wait = pending.event.statistic.frameNumber <= waitFrame;
+    uint64_t end = 0;
+    if( !_objectManager.getQueryResult( pending.end, end, wait ))
+        return false;
+
+    uint64_t begin = 0;
+    GLint64 now = 0;
+    _objectManager.getQueryResult( pending.begin, begin, true );
+    EQ_GL_CALL( glGetInteger64v( GL_TIMESTAMP, &now ));
+
+    // GPU times are in nanoseconds, move them to the given config time
+    event = pending.event;
+    event.statistic.startTime = time - ( now - GLint64( begin )) / 1000000;
+    event.statistic.endTime = time - ( now - GLint64( end )) / 1000000;
+    if( event.statistic.endTime <= event.statistic.startTime )
+        event.statistic.endTime = event.statistic.startTime + 1;
+
+    _free.push_back( pending.begin );
+    _free.push_back( pending.end );
+    _pending.pop_front();
+    return true;
+}
+
+}
+}
@@ -0,0 +1,95 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_TIMERQUERIES_H
+#define EQ_DETAIL_TIMERQUERIES_H
+
+#include <eq/client/types.h>
+#include <eq/fabric/event.h> // member
+#include <eq/util/types.h>
+#include <boost/noncopyable.hpp>
+#include <deque>
+#include <vector>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * @internal
+ * GPU timestamp queries for the statistics of one channel.
+ *
+ * The query objects are pooled in the object manager of the channel.
+ *
+ * Used by ChannelStatistics instead of Window::finish() for nicest statistics
+ * on contexts supporting ARB_timer_query. The statistic events are kept
+ * until the results of their queries are available, usually one or two frames
+ * later. All methods are called from the pipe thread with the channel's
+ * window context current.
+ */
+class TimerQueries : public boost::noncopyable
+{
+public:
+    explicit TimerQueries( util::ObjectManager& objectManager );
+    ~TimerQueries();
+
+    /** @return true if the context supports timestamp queries. */
+    static bool isSupported( const util::ObjectManager& objectManager );
+
+    /** Issue a timestamp query and return its key. */
+    const void* begin();
+
+    /**
+     * Issue the end timestamp query and queue the statistic event.
+     *
+     * The start and end time of the event are replaced by the GPU times of
+     * the begin and end query.
+     */
+    void end( const Event& event, const void* beginQuery );
+
+    /**
+     * Get the oldest queued event if its results are available.
+     *
+     * @param event the event, with the GPU times in config time.
+     * @param time the current config time.
+     * @param waitFrame wait for the results of events up to this frame, use 0
+     *                  to not wait.
+     * @return true if an event was returned, false otherwise.
+     */
+    bool pop( Event& event, int64_t time, uint32_t waitFrame );
+
+    /** @return true if no events are queued. */
+    bool isEmpty() const { return _pending.empty(); }
+
+private:
+    struct Pending
+    {
+        Event event;
+        const void* begin;
+        const void* end;
+    };
+
+    util::ObjectManager& _objectManager;
+    std::deque< Pending > _pending;
+    std::deque< char > _keys; //!< stable storage for unique query keys
+    std::vector< const void* > _free; //!< keys of unused queries
+
+    const void* _newQuery();
+};
+}
+}
+
+#endif // EQ_DETAIL_TIMERQUERIES_H
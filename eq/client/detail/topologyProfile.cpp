@@ -0,0 +1,83 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "topologyProfile.h"
+
+#include <lunchbox/log.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace eq
+{
+namespace detail
+{
+namespace topologyProfile
+{
+std::string getFilename()
+{
+    const char* env = ::getenv( "EQ_TOPOLOGY_PROFILE" );
+    if( env )
+        return env;
+    const char* home = ::getenv( "HOME" );
+    return home ? std::string( home ) + "/.eqTopologyProfile" : std::string();
+}
+
+int32_t getGPUSocket( const uint32_t port, const uint32_t device )
+{
+    const std::string& filename = getFilename();
+    if( filename.empty( ))
+        return -1;
+
+    std::ifstream file( filename.c_str( ));
+    if( !file.is_open( ))
+        return -1;
+
+    int32_t socket = -1;
+    float best = 0.f;
+    std::string line;
+    while( std::getline( file, line ))
+    {
+        std::istringstream stream( line );
+        std::string type;
+        uint32_t gpuPort = 0, gpuDevice = 0;
+        int32_t gpuSocket = -1;
+        float readback = 0.f, upload = 0.f;
+        if( !( stream >> type ) || type != "gpu" ||
+            !( stream >> gpuPort >> gpuDevice >> gpuSocket >> readback >>
+               upload ) ||
+            gpuPort != port || gpuDevice != device || gpuSocket < 0 )
+        {
+            continue;
+        }
+
+        if( readback + upload > best )
+        {
+            best = readback + upload;
+            socket = gpuSocket;
+        }
+    }
+
+    if( socket >= 0 )
+        LBVERB << "GPU " << port << "." << device << " is fastest from socket "
+               << socket << " in " << filename << std::endl;
+    return socket;
+}
+}
+}
+}
@@ -0,0 +1,55 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+
+#ifndef EQ_DETAIL_TOPOLOGYPROFILE_H
+#define EQ_DETAIL_TOPOLOGYPROFILE_H
+
+#include <eq/client/types.h>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * @internal
+ * Measured transfer bandwidths of the local host, written by the
+ * eqTopologyBenchmark tool.
+ *
+ * The profile is read from the file named by the EQ_TOPOLOGY_PROFILE
+ * environment variable, or from $HOME/.eqTopologyProfile. Each line holds
+ * one measurement in MB/s:
+ * @code
+ * gpu <port> <device> <socket> <readback> <upload>
+ * memcpy <source socket> <destination socket> <bandwidth>
+ * @endcode
+ */
+namespace topologyProfile
+{
+/** @return the file name of the local topology profile, or empty. */
+std::string getFilename();
+
+/**
+ * @return the socket with the fastest measured transfers to and from the
+ *         given GPU, or -1 if the profile has no measurement of the GPU.
+ */
+int32_t getGPUSocket( uint32_t port, uint32_t device );
+}
+}
+}
+
+#endif // EQ_DETAIL_TOPOLOGYPROFILE_H
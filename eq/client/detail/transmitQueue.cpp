@@ -0,0 +1,246 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "transmitQueue.h"
+
+#include "../log.h"
+
+#include <eq/fabric/commands.h>
+
+#include <co/objectICommand.h>
+#include <co/objectVersion.h>
+#include <lunchbox/clock.h>
+#include <lunchbox/thread.h>
+#include <boost/foreach.hpp>
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+/**
+ * @return the lane of a set of destinations. All commands for the same set of
+ *         destinations are executed in order in the same lane.
+ */
+co::NodeID _getLaneID( const co::NodeIDs& netNodes )
+{
+    co::NodeID id;
+    BOOST_FOREACH( const co::NodeID& netNode, netNodes )
+    {
+        id.high() ^= netNode.high();
+        id.low() ^= netNode.low();
+    }
+    return id;
+}
+
+/**
+ * Read the destinations and frame of a lane command from a copy of it.
+ * @return false if the command is not executed in a lane.
+ */
+bool _getLane( const co::ICommand& cmd, co::NodeID& node,
+               uint32_t& frameNumber )
+{
+    switch( cmd.getCommand( ))
+    {
+    case fabric::CMD_CHANNEL_FRAME_TRANSMIT_IMAGE:
+    {
+        co::ObjectICommand command( cmd );
+        command.read< co::ObjectVersion >(); // frame data
+        command.read< std::vector< uint128_t > >(); // receiving node objects
+        node = _getLaneID( command.read< co::NodeIDs >( ));
+        command.read< uint64_t >(); // image index
+        frameNumber = command.read< uint32_t >();
+        return true;
+    }
+
+    case fabric::CMD_CHANNEL_FRAME_SET_READY_NODE:
+    {
+        co::ObjectICommand command( cmd );
+        command.read< co::ObjectVersions >(); // frame datas
+        command.read< std::vector< uint128_t > >(); // receiving node objects
+        node = _getLaneID( command.read< co::NodeIDs >( ));
+        frameNumber = command.read< uint32_t >();
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+}
+
+class TransmitWorker : public lunchbox::Thread
+{
+public:
+    TransmitWorker( TransmitQueue& queue, const int32_t affinity )
+        : _queue( queue ), _affinity( affinity ) {}
+    virtual ~TransmitWorker() {}
+
+protected:
+    bool init() override
+    {
+        setName( "XmitWorker" );
+        if( _affinity != lunchbox::Thread::NONE )
+            lunchbox::Thread::setAffinity( _affinity );
+        return true;
+    }
+
+    void run() override
+    {
+        co::NodeID node;
+        co::ICommand command;
+        while( _queue._pop( node, command ))
+        {
+            lunchbox::Clock clock;
+            LBCHECK( command( ));
+            command = co::ICommand(); // release the data before waiting
+            _queue._finish( node, clock.getTime64( ));
+        }
+    }
+
+private:
+    TransmitQueue& _queue;
+    const int32_t _affinity;
+};
+
+TransmitQueue::TransmitQueue( const size_t maxSize )
+    : co::CommandQueue( maxSize )
+    , _nItems( 0 )
+    , _stopping( false )
+{}
+
+TransmitQueue::~TransmitQueue()
+{
+    stopWorkers();
+}
+
+void TransmitQueue::startWorkers( const size_t nWorkers,
+                                  const int32_t affinity )
+{
+    LBASSERT( _workers.empty( ));
+    _condition.lock();
+    for( size_t i = 0; i < nWorkers; ++i )
+    {
+        TransmitWorker* worker = new TransmitWorker( *this, affinity );
+        worker->start();
+        _workers.push_back( worker );
+    }
+    _condition.unlock();
+    LBLOG( LOG_ASSEMBLY ) << "Started " << nWorkers << " transmit workers"
+                          << std::endl;
+}
+
+void TransmitQueue::stopWorkers()
+{
+    _condition.lock();
+    _stopping = true;
+    _condition.broadcast();
+    _condition.unlock();
+
+    BOOST_FOREACH( TransmitWorker* worker, _workers )
+    {
+        worker->join();
+        delete worker;
+    }
+
+    _condition.lock();
+    _workers.clear();
+    for( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+    {
+        const Lane& lane = i->second;
+        LBLOG( LOG_STATS ) << "Transmit lane " << i->first << ": "
+                           << lane.nCommands << " commands in " << lane.time
+                           << " ms" << std::endl;
+    }
+    _lanes.clear();
+    _stopping = false;
+    _condition.unlock();
+}
+
+void TransmitQueue::push( const co::ICommand& command )
+{
+    co::NodeID node;
+    uint32_t frameNumber = 0;
+    if( command.isValid() && _getLane( command, node, frameNumber ))
+    {
+        _condition.lock();
+        if( !_workers.empty( ))
+        {
+            const Item item = { command, frameNumber };
+            _lanes[ node ].items.push_back( item );
+            ++_nItems;
+            _condition.signal();
+            _condition.unlock();
+            return;
+        }
+        _condition.unlock();
+    }
+    co::CommandQueue::push( command );
+}
+
+bool TransmitQueue::_pop( co::NodeID& node, co::ICommand& command )
+{
+    _condition.lock();
+    while( true )
+    {
+        Lanes::iterator next = _lanes.end();
+        for( Lanes::iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+        {
+            const Lane& lane = i->second;
+            if( lane.busy || lane.items.empty( ))
+                continue;
+            if( next == _lanes.end() ||
+                lane.items.front().frameNumber <
+                    next->second.items.front().frameNumber )
+            {
+                next = i;
+            }
+        }
+
+        if( next != _lanes.end( ))
+        {
+            Lane& lane = next->second;
+            node = next->first;
+            command = lane.items.front().command;
+            lane.items.pop_front();
+            lane.busy = true;
+            --_nItems;
+            _condition.unlock();
+            return true;
+        }
+
+        if( _stopping && _nItems == 0 )
+        {
+            _condition.unlock();
+            return false;
+        }
+        _condition.wait();
+    }
+}
+
+void TransmitQueue::_finish( const co::NodeID& node, const int64_t time )
+{
+    _condition.lock();
+    Lane& lane = _lanes[ node ];
+    lane.busy = false;
+    ++lane.nCommands;
+    lane.time += time;
+    _condition.broadcast(); // the lane may have queued commands
+    _condition.unlock();
+}
+}
+}
@@ -0,0 +1,98 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_TRANSMITQUEUE_H
+#define EQ_DETAIL_TRANSMITQUEUE_H
+
+#include <co/commandQueue.h> // base class
+#include <co/iCommand.h>     // member
+#include <lunchbox/condition.h>
+#include <lunchbox/stdExt.h>
+
+#include <deque>
+#include <vector>
+
+namespace eq
+{
+namespace detail
+{
+class TransmitWorker;
+
+/**
+ * The command queue of the node transmit thread, with per-destination lanes.
+ *
+ * When workers are started, image transmissions and frame ready signals are
+ * routed to one lane per set of destination nodes, so that a slow link does
+ * not delay the transfers to other nodes. Images sent to several nodes are
+ * compressed once and written to all of them from one lane. A lane is
+ * executed by at most one worker at a time to keep the order of its commands.
+ * Idle workers pick the lane whose next command belongs to the oldest frame,
+ * which is the one other nodes are most likely waiting for. All other commands are executed in order by the
+ * thread popping this queue.
+ */
+class TransmitQueue : public co::CommandQueue
+{
+public:
+    explicit TransmitQueue( size_t maxSize );
+    virtual ~TransmitQueue();
+
+    /**
+     * Start the lane workers.
+     *
+     * @param nWorkers the number of workers, 0 to execute all commands in the
+     *                 transmit thread.
+     * @param affinity the thread affinity of the workers.
+     */
+    void startWorkers( size_t nWorkers, int32_t affinity );
+
+    /** Execute all queued lane commands and stop the workers. */
+    void stopWorkers();
+
+    /** @sa co::CommandQueue::push(). */
+    void push( const co::ICommand& command ) override;
+
+private:
+    struct Item
+    {
+        co::ICommand command;
+        uint32_t frameNumber;
+    };
+
+    struct Lane
+    {
+        Lane() : busy( false ), nCommands( 0 ), time( 0 ) {}
+
+        std::deque< Item > items;
+        bool busy; //!< a worker executes a command of this lane
+        size_t nCommands; //!< executed commands, for statistics
+        int64_t time; //!< time spent executing commands, in ms
+    };
+    typedef stde::hash_map< co::NodeID, Lane > Lanes;
+
+    friend class TransmitWorker;
+    std::vector< TransmitWorker* > _workers;
+    lunchbox::Condition _condition;
+    Lanes _lanes;
+    size_t _nItems;
+    bool _stopping;
+
+    bool _pop( co::NodeID& node, co::ICommand& command );
+    void _finish( const co::NodeID& node, int64_t time );
+};
+}
+}
+
+#endif // EQ_DETAIL_TRANSMITQUEUE_H
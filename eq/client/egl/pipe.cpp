@@ -0,0 +1,192 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "pipe.h"
+
+#include "../error.h"
+#include "../gl.h"
+#include "../global.h"
+#include "../log.h"
+#include "../pipe.h"
+
+#define EGL_NO_X11
+#define MESA_EGL_NO_X11_HEADERS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <boost/lexical_cast.hpp>
+
+using boost::lexical_cast;
+
+namespace eq
+{
+namespace egl
+{
+namespace
+{
+static const EGLint _maxDevices = 32;
+}
+
+Pipe::Pipe( eq::Pipe* parent )
+    : SystemPipe( parent )
+    , _eglDisplay( EGL_NO_DISPLAY )
+{
+}
+
+Pipe::~Pipe()
+{
+}
+
+//---------------------------------------------------------------------------
+// EGL init
+//---------------------------------------------------------------------------
+bool Pipe::configInit()
+{
+    EGLDisplay display = _getDeviceDisplay();
+    if( display == EGL_NO_DISPLAY )
+    {
+        sendError( ERROR_EGLPIPE_DEVICE_NOTFOUND )
+            << lexical_cast< std::string >( getPipe()->getDevice( ));
+        return false;
+    }
+
+    EGLint major = 0, minor = 0;
+    if( !eglInitialize( display, &major, &minor ))
+    {
+        sendError( ERROR_EGLPIPE_INIT_FAILED )
+            << lexical_cast< std::string >( eglGetError( ));
+        return false;
+    }
+
+    _eglDisplay = display;
+    LBVERB << "Initialized EGL " << major << "." << minor << " display @"
+           << display << ", device " << getPipe()->getDevice() << std::endl;
+
+    // There is no screen, the pipe viewport only sizes fractional windows
+    const PixelViewport& pvp = getPipe()->getPixelViewport();
+    if( !pvp.isValid( ))
+        getPipe()->setPixelViewport( PixelViewport( 0, 0, 1920, 1080 ));
+
+    return _configInitGL();
+}
+
+void Pipe::configExit()
+{
+    if( _eglDisplay == EGL_NO_DISPLAY )
+        return;
+
+    eglTerminate( _eglDisplay );
+    LBVERB << "Terminated EGL display " << _eglDisplay << std::endl;
+    _eglDisplay = EGL_NO_DISPLAY;
+}
+
+EGLDisplay Pipe::_getDeviceDisplay()
+{
+    PFNEGLQUERYDEVICESEXTPROC queryDevices = (PFNEGLQUERYDEVICESEXTPROC)
+        eglGetProcAddress( "eglQueryDevicesEXT" );
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)
+        eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+    const uint32_t device = getPipe()->getDevice();
+
+    if( !queryDevices || !getPlatformDisplay )
+    {
+        if( device != LB_UNDEFINED_UINT32 && device != 0 )
+        {
+            LBWARN << "EGL device enumeration not supported, can't use device "
+                   << device << std::endl;
+            return EGL_NO_DISPLAY;
+        }
+        return eglGetDisplay( EGL_DEFAULT_DISPLAY );
+    }
+
+    EGLDeviceEXT devices[ _maxDevices ];
+    EGLint nDevices = 0;
+    if( !queryDevices( _maxDevices, devices, &nDevices ) || nDevices == 0 )
+    {
+        LBWARN << "No EGL devices found" << std::endl;
+        return EGL_NO_DISPLAY;
+    }
+
+    const EGLint index = device == LB_UNDEFINED_UINT32 ? 0 : EGLint( device );
+    if( index >= nDevices )
+    {
+        LBWARN << "Device " << device << " not found, have " << nDevices
+               << " EGL devices" << std::endl;
+        return EGL_NO_DISPLAY;
+    }
+    return getPlatformDisplay( EGL_PLATFORM_DEVICE_EXT, devices[ index ], 0 );
+}
+
+bool Pipe::_configInitGL()
+{
+    LBASSERT( _eglDisplay != EGL_NO_DISPLAY );
+
+    //----- Create and make current a temporary GL context
+    if( !eglBindAPI( EGL_OPENGL_API ))
+    {
+        sendError( ERROR_SYSTEMPIPE_CREATECONTEXT_FAILED );
+        return false;
+    }
+
+    const EGLint attributes[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                                  EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                  EGL_NONE };
+    EGLConfig config = 0;
+    EGLint nConfigs = 0;
+    if( !eglChooseConfig( _eglDisplay, attributes, &config, 1, &nConfigs ) ||
+        nConfigs == 0 )
+    {
+        sendError( ERROR_SYSTEMPIPE_PIXELFORMAT_NOTFOUND );
+        return false;
+    }
+
+    EGLContext context = eglCreateContext( _eglDisplay, config,
+                                           EGL_NO_CONTEXT, 0 );
+    if( context == EGL_NO_CONTEXT )
+    {
+        sendError( ERROR_SYSTEMPIPE_CREATECONTEXT_FAILED );
+        return false;
+    }
+
+    const EGLint pbufferAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1,
+                                         EGL_NONE };
+    EGLSurface surface = eglCreatePbufferSurface( _eglDisplay, config,
+                                                  pbufferAttributes );
+    if( surface == EGL_NO_SURFACE )
+    {
+        eglDestroyContext( _eglDisplay, context );
+        sendError( ERROR_SYSTEMPIPE_CREATEWINDOW_FAILED );
+        return false;
+    }
+
+    eglMakeCurrent( _eglDisplay, surface, surface, context );
+
+    const bool success = configInitGL();
+    const char* glVersion = (const char*)glGetString( GL_VERSION );
+    if( success && glVersion )
+        _maxOpenGLVersion = static_cast<float>( atof( glVersion ));
+
+    eglMakeCurrent( _eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                    EGL_NO_CONTEXT );
+    eglDestroySurface( _eglDisplay, surface );
+    eglDestroyContext( _eglDisplay, context );
+    return success;
+}
+
+}
+}
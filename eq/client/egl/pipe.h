@@ -0,0 +1,84 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_EGL_PIPE_H
+#define EQ_EGL_PIPE_H
+
+#include <eq/client/egl/types.h>
+
+#include <eq/client/systemPipe.h> // base class
+
+namespace eq
+{
+namespace egl
+{
+/**
+ * Default implementation of an EGL system pipe.
+ *
+ * The pipe device selects the EGL device, in the order returned by
+ * eglQueryDevicesEXT(). The pipe port is ignored.
+ */
+class Pipe : public SystemPipe
+{
+public:
+    /** Construct a new EGL system pipe. @version 1.8 */
+    Pipe( eq::Pipe* parent );
+
+    /** Destruct this EGL pipe. @version 1.8 */
+    virtual ~Pipe();
+
+    /** @name EGL initialization */
+    //@{
+    /**
+     * Initialize this pipe for the EGL window system.
+     *
+     * @return true if the initialization was successful, false otherwise.
+     * @version 1.8
+     */
+    EQ_API bool configInit() override;
+
+    /**
+     * Deinitialize this pipe for the EGL window system.
+     *
+     * @version 1.8
+     */
+    EQ_API void configExit() override;
+    //@}
+
+    /** @return the EGL display of this pipe's device. @version 1.8 */
+    EQ_API EGLDisplay getEGLDisplay() const { return _eglDisplay; }
+
+protected:
+    /**
+     * Initialize this pipe for OpenGL.
+     *
+     * A temporary GL context is current during this call. The context is
+     * not the one used by the windows of this pipe.
+     *
+     * @version 1.8
+     */
+    virtual bool configInitGL() { return true; }
+
+private:
+    EGLDisplay _eglDisplay;
+
+    EGLDisplay _getDeviceDisplay();
+    bool _configInitGL();
+};
+}
+}
+#endif // EQ_EGL_PIPE_H
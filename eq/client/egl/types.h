@@ -0,0 +1,48 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_EGL_TYPES_H
+#define EQ_EGL_TYPES_H
+
+#include <lunchbox/types.h>
+
+/** @cond INTERNAL */
+typedef void* EGLDisplay;
+typedef void* EGLConfig;
+typedef void* EGLContext;
+typedef void* EGLSurface;
+/** @endcond */
+
+namespace eq
+{
+/**
+ * @namespace eq::egl
+ * @brief The system abstraction layer for headless rendering using EGL.
+ *
+ * EGL pipes open a GPU directly using EGL_EXT_platform_device, and do not
+ * need a running X server. All drawables are offscreen, and no events are
+ * generated.
+ */
+namespace egl
+{
+class Pipe;
+class Window;
+class WindowIF;
+}
+}
+
+#endif // EQ_EGL_TYPES_H
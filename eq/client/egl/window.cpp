@@ -0,0 +1,330 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "window.h"
+
+#include "../error.h"
+#include "../gl.h"
+#include "../global.h"
+
+#define EGL_NO_X11
+#define MESA_EGL_NO_X11_HEADERS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <algorithm>
+
+namespace eq
+{
+namespace egl
+{
+namespace detail
+{
+class Window
+{
+public:
+    explicit Window( EGLDisplay eglDisplay_ )
+        : eglDisplay( eglDisplay_ )
+        , eglSurface( EGL_NO_SURFACE )
+        , eglContext( EGL_NO_CONTEXT )
+    {}
+
+    /** The display (maintained by egl::Pipe) */
+    EGLDisplay eglDisplay;
+    /** The pbuffer surface of the window. */
+    EGLSurface eglSurface;
+    /** The EGL rendering context. */
+    EGLContext eglContext;
+};
+}
+
+Window::Window( NotifierInterface& parent, const WindowSettings& settings,
+                EGLDisplay eglDisplay )
+    : WindowIF( parent, settings )
+    , _impl( new detail::Window( eglDisplay ))
+{
+}
+
+Window::~Window()
+{
+    delete _impl;
+}
+
+EGLContext Window::getEGLContext() const
+{
+    return _impl->eglContext;
+}
+
+EGLSurface Window::getEGLSurface() const
+{
+    return _impl->eglSurface;
+}
+
+EGLDisplay Window::getEGLDisplay() const
+{
+    return _impl->eglDisplay;
+}
+
+//---------------------------------------------------------------------------
+// EGL init
+//---------------------------------------------------------------------------
+bool Window::configInit()
+{
+    if( _impl->eglDisplay == EGL_NO_DISPLAY )
+    {
+        sendError( ERROR_EGLWINDOW_NO_DISPLAY );
+        return false;
+    }
+
+    const int32_t drawableHint =
+        getIAttribute( WindowSettings::IATTR_HINT_DRAWABLE );
+    if( drawableHint == WINDOW )
+        LBINFO << "EGL windows are offscreen, rendering window "
+               << getName() << " into an FBO" << std::endl;
+
+    EGLConfig config = 0;
+    if( !chooseEGLConfig( config ))
+    {
+        sendError( ERROR_SYSTEMWINDOW_PIXELFORMAT_NOTFOUND );
+        return false;
+    }
+
+    _impl->eglContext = createEGLContext( config );
+    if( _impl->eglContext == EGL_NO_CONTEXT )
+        return false;
+
+    if( !configInitEGLSurface( config ))
+        return false;
+
+    makeCurrent();
+    initGLEW();
+    if( drawableHint != PBUFFER && drawableHint != OFF )
+        return configInitFBO();
+    return true;
+}
+
+bool Window::chooseEGLConfig( EGLConfig& config )
+{
+    const int32_t drawableHint =
+        getIAttribute( WindowSettings::IATTR_HINT_DRAWABLE );
+    const bool pbuffer = drawableHint == PBUFFER;
+
+    std::vector< EGLint > attributes;
+    attributes.push_back( EGL_SURFACE_TYPE );
+    attributes.push_back( EGL_PBUFFER_BIT );
+    attributes.push_back( EGL_RENDERABLE_TYPE );
+    attributes.push_back( EGL_OPENGL_BIT );
+
+    int colorSize = getIAttribute( WindowSettings::IATTR_PLANES_COLOR );
+    if( colorSize != OFF )
+    {
+        if( !pbuffer )
+            colorSize = 8; // FBO uses its own color format
+        else switch( colorSize )
+        {
+          case RGBA16F:
+          case RGBA32F:
+            sendError( ERROR_SYSTEMWINDOW_ARB_FLOAT_FB_REQUIRED );
+            return false;
+
+          case AUTO:
+          case ON:
+            colorSize = 8;
+            break;
+          default:
+            break;
+        }
+
+        LBASSERT( colorSize > 0 );
+        attributes.push_back( EGL_RED_SIZE );
+        attributes.push_back( colorSize );
+        attributes.push_back( EGL_GREEN_SIZE );
+        attributes.push_back( colorSize );
+        attributes.push_back( EGL_BLUE_SIZE );
+        attributes.push_back( colorSize );
+
+        const int alphaSize = getIAttribute( WindowSettings::IATTR_PLANES_ALPHA );
+        if( alphaSize != OFF )
+        {
+            attributes.push_back( EGL_ALPHA_SIZE );
+            attributes.push_back( alphaSize > 0 ? alphaSize : colorSize );
+        }
+    }
+    const int depthSize = getIAttribute( WindowSettings::IATTR_PLANES_DEPTH );
+    if( pbuffer && ( depthSize > 0 || depthSize == AUTO ))
+    {
+        attributes.push_back( EGL_DEPTH_SIZE );
+        attributes.push_back( depthSize > 0 ? depthSize : 1 );
+    }
+    const int stencilSize = getIAttribute( WindowSettings::IATTR_PLANES_STENCIL );
+    if( pbuffer && ( stencilSize > 0 || stencilSize == AUTO ))
+    {
+        attributes.push_back( EGL_STENCIL_SIZE );
+        attributes.push_back( stencilSize > 0 ? stencilSize : 1 );
+    }
+    const int samplesSize = getIAttribute( WindowSettings::IATTR_PLANES_SAMPLES );
+    if( pbuffer && samplesSize >= 0 )
+    {
+        attributes.push_back( EGL_SAMPLE_BUFFERS );
+        attributes.push_back( 1 );
+        attributes.push_back( EGL_SAMPLES );
+        attributes.push_back( samplesSize );
+    }
+    attributes.push_back( EGL_NONE );
+
+    EGLint nConfigs = 0;
+    if( eglChooseConfig( _impl->eglDisplay, &attributes[0], &config, 1,
+                         &nConfigs ) && nConfigs > 0 )
+    {
+        return true;
+    }
+    if( !pbuffer || stencilSize != AUTO )
+        return false;
+
+    // backoff: drop the optional stencil buffer
+    std::vector< EGLint >::iterator i = std::find( attributes.begin(),
+                                                   attributes.end(),
+                                                   EGL_STENCIL_SIZE );
+    LBASSERT( i != attributes.end( ));
+    attributes.erase( i, i + 2 );
+    return eglChooseConfig( _impl->eglDisplay, &attributes[0], &config, 1,
+                            &nConfigs ) && nConfigs > 0;
+}
+
+EGLContext Window::createEGLContext( EGLConfig config )
+{
+    if( !eglBindAPI( EGL_OPENGL_API ))
+    {
+        sendError( ERROR_EGLWINDOW_CREATECONTEXT_FAILED );
+        return EGL_NO_CONTEXT;
+    }
+
+    EGLContext shCtx = EGL_NO_CONTEXT;
+    const SystemWindow* shareWindow = getSharedContextWindow();
+    if( shareWindow )
+    {
+        const WindowIF* shareEGLWindow =
+                                 dynamic_cast< const WindowIF* >( shareWindow );
+        if( shareEGLWindow )
+            shCtx = shareEGLWindow->getEGLContext();
+    }
+
+    std::vector< EGLint > attributes;
+    if( getIAttribute( WindowSettings::IATTR_HINT_CORE_PROFILE ) == ON )
+    {
+        attributes.push_back( EGL_CONTEXT_MAJOR_VERSION_KHR );
+        attributes.push_back(
+            getIAttribute( WindowSettings::IATTR_HINT_OPENGL_MAJOR ));
+        attributes.push_back( EGL_CONTEXT_MINOR_VERSION_KHR );
+        attributes.push_back(
+            getIAttribute( WindowSettings::IATTR_HINT_OPENGL_MINOR ));
+        attributes.push_back( EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR );
+        attributes.push_back( EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR );
+    }
+    attributes.push_back( EGL_NONE );
+
+    EGLContext context = eglCreateContext( _impl->eglDisplay, config, shCtx,
+                                           &attributes[0] );
+    if( context == EGL_NO_CONTEXT )
+        sendError( ERROR_EGLWINDOW_CREATECONTEXT_FAILED );
+    return context;
+}
+
+bool Window::configInitEGLSurface( EGLConfig config )
+{
+    const bool pbuffer =
+        getIAttribute( WindowSettings::IATTR_HINT_DRAWABLE ) == PBUFFER;
+    const PixelViewport& pvp = getPixelViewport();
+    if( pbuffer && !pvp.isValid( ))
+    {
+        sendError( ERROR_WINDOW_PVP_INVALID );
+        return false;
+    }
+
+    const EGLint attributes[] = { EGL_WIDTH, pbuffer ? pvp.w : 1,
+                                  EGL_HEIGHT, pbuffer ? pvp.h : 1,
+                                  EGL_LARGEST_PBUFFER, EGL_TRUE,
+                                  EGL_NONE };
+    _impl->eglSurface = eglCreatePbufferSurface( _impl->eglDisplay, config,
+                                                 attributes );
+    if( _impl->eglSurface == EGL_NO_SURFACE )
+    {
+        sendError( ERROR_EGLWINDOW_CREATEPBUFFER_FAILED );
+        return false;
+    }
+
+    LBVERB << "Created EGL PBuffer " << _impl->eglSurface << std::endl;
+    return true;
+}
+
+void Window::configExit()
+{
+    if( _impl->eglDisplay == EGL_NO_DISPLAY )
+        return;
+
+    configExitFBO();
+    exitGLEW();
+
+    eglMakeCurrent( _impl->eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                    EGL_NO_CONTEXT );
+
+    if( _impl->eglContext != EGL_NO_CONTEXT )
+        eglDestroyContext( _impl->eglDisplay, _impl->eglContext );
+    if( _impl->eglSurface != EGL_NO_SURFACE )
+        eglDestroySurface( _impl->eglDisplay, _impl->eglSurface );
+
+    _impl->eglContext = EGL_NO_CONTEXT;
+    _impl->eglSurface = EGL_NO_SURFACE;
+    LBVERB << "Destroyed EGL context and surface" << std::endl;
+}
+
+void Window::makeCurrent( const bool cache ) const
+{
+    LBASSERT( _impl->eglDisplay != EGL_NO_DISPLAY );
+    if( cache && isCurrent( ))
+        return;
+
+    eglMakeCurrent( _impl->eglDisplay, _impl->eglSurface, _impl->eglSurface,
+                    _impl->eglContext );
+    WindowIF::makeCurrent();
+    if( _impl->eglContext != EGL_NO_CONTEXT )
+    {
+        EQ_GL_ERROR( "After eglMakeCurrent" );
+    }
+}
+
+void Window::doneCurrent() const
+{
+    LBASSERT( _impl->eglDisplay != EGL_NO_DISPLAY );
+    eglMakeCurrent( _impl->eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                    EGL_NO_CONTEXT );
+    WindowIF::doneCurrent();
+}
+
+void Window::swapBuffers()
+{
+    // pbuffer surfaces are single-buffered, FBOs have nothing to swap
+}
+
+void Window::joinNVSwapBarrier( const uint32_t group, const uint32_t )
+{
+    if( group != 0 )
+        LBWARN << "NV swap groups not supported by EGL windows" << std::endl;
+}
+
+}
+}
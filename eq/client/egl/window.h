@@ -0,0 +1,147 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_EGL_WINDOW_H
+#define EQ_EGL_WINDOW_H
+
+#include <eq/client/egl/types.h>
+#include <eq/client/glWindow.h>       // base class
+
+namespace eq
+{
+namespace egl
+{
+namespace detail { class Window; }
+
+/** The interface defining the minimum functionality for an EGL window. */
+class WindowIF : public GLWindow
+{
+public:
+    WindowIF( NotifierInterface& parent,
+              const WindowSettings& settings ) : GLWindow( parent, settings ) {}
+    virtual ~WindowIF() {}
+
+    /** @return the EGL rendering context. @version 1.8 */
+    virtual EGLContext getEGLContext() const = 0;
+
+    /** @return the EGL drawable surface. @version 1.8 */
+    virtual EGLSurface getEGLSurface() const = 0;
+
+    /** @return the EGL display of the pipe. @version 1.8 */
+    virtual EGLDisplay getEGLDisplay() const = 0;
+};
+
+/**
+ * Equalizer default implementation of an EGL window.
+ *
+ * EGL windows are offscreen: window drawables are rendered into an FBO, pbuffer
+ * drawables into an EGL pbuffer surface.
+ */
+class Window : public WindowIF
+{
+public:
+    /** Construct a new EGL system window. @version 1.8 */
+    Window( NotifierInterface& parent, const WindowSettings& settings,
+            EGLDisplay eglDisplay );
+
+    /** Destruct this EGL window. @version 1.8 */
+    virtual ~Window();
+
+    /** @name EGL initialization */
+    //@{
+    /**
+     * Initialize this window for the EGL window system.
+     *
+     * This method first calls chooseEGLConfig(), then createEGLContext()
+     * with the chosen config, and finally creates a surface using
+     * configInitEGLSurface().
+     *
+     * @return true if the initialization was successful, false otherwise.
+     * @version 1.8
+     */
+    bool configInit() override;
+
+    /** @version 1.8 */
+    void configExit() override;
+
+    /**
+     * Choose an EGL framebuffer config based on the window's attributes.
+     *
+     * @param config the returned config.
+     * @return true if a config was found, false otherwise.
+     * @version 1.8
+     */
+    virtual bool chooseEGLConfig( EGLConfig& config );
+
+    /**
+     * Create an EGL context.
+     *
+     * This method does not set the window's EGL context.
+     *
+     * @param config the framebuffer config for the context.
+     * @return the context, or 0 if context creation failed.
+     * @version 1.8
+     */
+    virtual EGLContext createEGLContext( EGLConfig config );
+
+    /**
+     * Initialize the window's pbuffer surface.
+     *
+     * The surface has the size of the window for pbuffer drawables, and is a
+     * minimal placeholder for FBO drawables.
+     *
+     * @param config the framebuffer config for the surface.
+     * @return true if the surface was created, false otherwise.
+     * @version 1.8
+     */
+    virtual bool configInitEGLSurface( EGLConfig config );
+    //@}
+
+    /** @name Data Access. */
+    //@{
+    /** @return the EGL rendering context. @version 1.8 */
+    EGLContext getEGLContext() const override;
+
+    /** @return the EGL drawable surface. @version 1.8 */
+    EGLSurface getEGLSurface() const override;
+
+    /** @return the EGL display of the pipe. @version 1.8 */
+    EGLDisplay getEGLDisplay() const override;
+    //@}
+
+    /** @name Operations. */
+    //@{
+    /** @version 1.8 */
+    void makeCurrent( const bool cache = true ) const override;
+
+    /** Release the EGL context from the calling thread. @version 1.9 */
+    void doneCurrent() const override;
+
+    /** @version 1.8 */
+    void swapBuffers() override;
+
+    /** Not supported by EGL windows. @version 1.8 */
+    void joinNVSwapBarrier( const uint32_t group,
+                            const uint32_t barrier ) override;
+    //@}
+
+private:
+    detail::Window* const _impl;
+};
+}
+}
+#endif // EQ_EGL_WINDOW_H
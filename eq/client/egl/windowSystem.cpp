@@ -0,0 +1,70 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "../windowSystem.h"
+
+#include "window.h"
+#include "pipe.h"
+#include "../pipe.h"
+#include "../window.h"
+
+namespace eq
+{
+namespace egl
+{
+
+static class : WindowSystemIF
+{
+    std::string getName() const final { return "EGL"; }
+
+    eq::SystemWindow* createWindow( eq::Window* window,
+                                    const WindowSettings& settings ) final
+    {
+        LBINFO << "Using egl::Window" << std::endl;
+        EGLDisplay eglDisplay = 0;
+        Pipe* eglPipe =
+            dynamic_cast< Pipe* >( window->getPipe()->getSystemPipe( ));
+        if( eglPipe )
+            eglDisplay = eglPipe->getEGLDisplay();
+        return new Window( *window, settings, eglDisplay );
+    }
+
+    eq::SystemPipe* createPipe( eq::Pipe* pipe ) final
+    {
+        LBINFO << "Using egl::Pipe" << std::endl;
+        return new Pipe( pipe );
+    }
+
+    eq::MessagePump* createMessagePump() final
+    {
+        return 0; // offscreen windows have no events
+    }
+
+    bool setupFont( util::ObjectManager&, const void*, const std::string&,
+                    const uint32_t ) const final
+    {
+        LBINFO << "Fonts not supported by EGL window system" << std::endl;
+        return false;
+    }
+
+    // offscreen surfaces without event handling, contexts are per thread
+    bool hasParallelWindowInit() const final { return true; }
+
+} _eglFactory;
+
+}
+}
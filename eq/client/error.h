@@ -53,6 +53,8 @@ namespace eq
     using fabric::ERROR_GLXPIPE_DEVICE_NOTFOUND;
     using fabric::ERROR_GLXPIPE_GLX_NOTFOUND;
     using fabric::ERROR_GLXPIPE_GLXEWINIT_FAILED;
+    using fabric::ERROR_EGLPIPE_DEVICE_NOTFOUND;
+    using fabric::ERROR_EGLPIPE_INIT_FAILED;
     using fabric::ERROR_WGL_CREATEAFFINITYDC_FAILED;
     using fabric::ERROR_WGLPIPE_ENUMDISPLAYS_FAILED;
     using fabric::ERROR_WGLPIPE_CREATEDC_FAILED;
@@ -81,6 +83,9 @@ namespace eq
     using fabric::ERROR_GLXWINDOW_NO_VISUAL;
     using fabric::ERROR_GLXWINDOW_CREATEPBUFFER_FAILED;
     using fabric::ERROR_GLXWINDOW_FBCONFIG_REQUIRED;
+    using fabric::ERROR_EGLWINDOW_NO_DISPLAY;
+    using fabric::ERROR_EGLWINDOW_CREATECONTEXT_FAILED;
+    using fabric::ERROR_EGLWINDOW_CREATEPBUFFER_FAILED;
     using fabric::ERROR_WGLWINDOW_NO_DRAWABLE;
     using fabric::ERROR_WGLWINDOW_SETPIXELFORMAT_FAILED;
     using fabric::ERROR_WGLWINDOW_REGISTERCLASS_FAILED;
@@ -96,6 +101,8 @@ namespace eq
     using fabric::ERROR_PBO_NOT_INITIALIZED;
     using fabric::ERROR_PBO_SIZE_TOO_SMALL;
     using fabric::ERROR_PBO_TYPE_UNSUPPORTED;
+    using fabric::ERROR_QTWINDOW_CREATECONTEXT_FAILED;
+    using fabric::ERROR_QTWINDOW_CREATESURFACE_FAILED;
     using fabric::ERROR_CUSTOM;
 }
 #endif // EQ_ERROR_H
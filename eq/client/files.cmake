@@ -31,6 +31,8 @@ set(GLX_HEADERS
 
 set(GLX_SOURCES
   glx/eventHandler.cpp
+  glx/eventThread.cpp
+  glx/eventThread.h
   glx/messagePump.cpp
   glx/pipe.cpp
   glx/window.cpp
@@ -40,6 +42,29 @@ set(GLX_SOURCES
   x11/window.cpp
 )
 
+set(EGL_HEADERS
+  egl/pipe.h
+  egl/types.h
+  egl/window.h
+)
+
+set(EGL_SOURCES
+  egl/pipe.cpp
+  egl/window.cpp
+  egl/windowSystem.cpp
+)
+
+set(MEMORY_HEADERS
+  memory/pipe.h
+  memory/window.h
+)
+
+set(MEMORY_SOURCES
+  memory/pipe.cpp
+  memory/window.cpp
+  memory/windowSystem.cpp
+)
+
 if(DEFLECT_FOUND)
   set(DEFLECT_SOURCES
     dc/connection.h
@@ -54,6 +79,8 @@ set(QT_HEADERS
   qt/eventHandler.h
   qt/glWidget.h
   qt/messagePump.h
+  qt/renderWindow.h
+  qt/surfaceWindow.h
   qt/types.h
   qt/widgetFactory.h
   qt/window.h
@@ -70,6 +97,8 @@ set(QT_SOURCES
   qt/eventHandler.cpp
   qt/glWidget.cpp
   qt/messagePump.cpp
+  qt/renderWindow.cpp
+  qt/surfaceWindow.cpp
   qt/widgetFactory.cpp
   qt/window.cpp
   qt/windowSystem.cpp
@@ -93,7 +122,8 @@ set(WGL_SOURCES
 )
 
 set(CLIENT_PUBLIC_HEADERS
-  ${AGL_HEADERS} ${GLX_HEADERS} ${QT_HEADERS} ${WGL_HEADERS}
+  ${AGL_HEADERS} ${EGL_HEADERS} ${GLX_HEADERS} ${MEMORY_HEADERS} ${QT_HEADERS}
+  ${WGL_HEADERS}
   api.h
   base.h
   canvas.h
@@ -133,6 +163,7 @@ set(CLIENT_PUBLIC_HEADERS
   resultImageListener.h
   segment.h
   server.h
+  sharedMemoryRing.h
   statisticSampler.h
   system.h
   systemPipe.h
@@ -148,8 +179,30 @@ set(CLIENT_PUBLIC_HEADERS
   )
 
 set(CLIENT_HEADERS
+  detail/compositorKernels.h
+  detail/blocks.h
+  detail/compressionSelector.h
+  detail/decompressPool.h
   detail/fileFrameWriter.h
+  detail/frameCounter.h
+  detail/imagePlayback.h
+  detail/imagePool.h
+  detail/latchedTracker.h
+  detail/multiView.h
+  detail/pluginCalibration.h
+  detail/pluginManifest.h
+  detail/pixelFormat.h
+  detail/reprojector.h
+  detail/sharedImageArena.h
+  detail/sharedMemoryWriter.h
+  detail/spans.h
   detail/statsRenderer.h
+  detail/syncPool.h
+  detail/temporalUpsampler.h
+  detail/textureUploader.h
+  detail/timerQueries.h
+  detail/topologyProfile.h
+  detail/transmitQueue.h
   exitVisitor.h
   half.h
   initVisitor.h
@@ -169,7 +222,28 @@ set(CLIENT_SOURCES
   configStatistics.cpp
   cudaContext.cpp
   detail/channel.ipp
+  detail/compositorKernels.cpp
+  detail/blocks.cpp
+  detail/compressionSelector.cpp
+  detail/decompressPool.cpp
   detail/fileFrameWriter.cpp
+  detail/frameCounter.cpp
+  detail/imagePlayback.cpp
+  detail/imagePool.cpp
+  detail/latchedTracker.cpp
+  detail/multiView.cpp
+  detail/pluginCalibration.cpp
+  detail/pluginManifest.cpp
+  detail/reprojector.cpp
+  detail/sharedImageArena.cpp
+  detail/sharedMemoryWriter.cpp
+  detail/spans.cpp
+  detail/syncPool.cpp
+  detail/temporalUpsampler.cpp
+  detail/textureUploader.cpp
+  detail/timerQueries.cpp
+  detail/topologyProfile.cpp
+  detail/transmitQueue.cpp
   eventHandler.cpp
   eventICommand.cpp
   frame.cpp
@@ -210,12 +284,16 @@ if(NOT EQUALIZER_BUILD_2_0_API)
   list(APPEND CLIENT_SOURCES configEvent.cpp)
 endif()
 
+list(APPEND CLIENT_SOURCES ${MEMORY_SOURCES})
 if(EQ_AGL_USED)
   list(APPEND CLIENT_SOURCES ${AGL_SOURCES})
 endif()
 if(EQ_GLX_USED)
   list(APPEND CLIENT_SOURCES ${GLX_SOURCES})
 endif()
+if(EQ_EGL_USED)
+  list(APPEND CLIENT_SOURCES ${EGL_SOURCES})
+endif()
 if(EQ_QT_USED)
   qt5_wrap_cpp(QT_MOC_OUTFILES ${QT_MOC_HEADERS})
   list(APPEND CLIENT_SOURCES ${QT_SOURCES} ${QT_MOC_OUTFILES})
@@ -167,6 +167,31 @@ Images Frame::startReadback( util::ObjectManager& glObjects,
     return _impl->frameData->startReadback( *this, glObjects, config, regions );
 }
 
+Images Frame::startReadback( util::ObjectManager& glObjects,
+                             const DrawableConfig& config,
+                             const PixelViewports& regions,
+                             const util::FrameBufferObject* drawable )
+{
+    return _impl->frameData->startReadback( *this, glObjects, config, regions,
+                                            drawable );
+}
+
+Images Frame::startPeerReadback( util::ObjectManager& glObjects,
+                                 const DrawableConfig& config,
+                                 const PixelViewports& regions,
+                                 const SystemWindow& window )
+{
+    return _impl->frameData->startPeerReadback( *this, glObjects, config,
+                                                regions, window );
+}
+
+void Frame::referenceFrameBuffer( const DrawableConfig& config,
+                                  const PixelViewports& regions,
+                                  const SystemWindow& window )
+{
+    _impl->frameData->referenceFrameBuffer( *this, config, regions, window );
+}
+
 void Frame::setReady()
 {
     _impl->frameData->setReady();
@@ -121,7 +121,14 @@ namespace detail{ class Frame; }
         /** Set alpha usage for newly allocated images. @version 1.0 */
         EQ_API void setAlphaUsage( const bool useAlpha );
 
-        /** Set the minimum quality after compression. @version 1.0 */
+        /**
+         * Set the minimum quality after compression.
+         *
+         * A depth quality below one allows reading back depth with 16 bit
+         * precision, which is sufficient for the depth test of many sort-last
+         * compounds.
+         * @version 1.0
+         */
         EQ_API void setQuality( const Buffer buffer, const float quality );
 
         /** Sets a compressor for compression for following transmissions. */
@@ -179,6 +186,61 @@ namespace detail{ class Frame; }
                                      const DrawableConfig& config,
                                      const PixelViewports& regions );
 
+        /**
+         * Start reading back a set of images from an FBO drawable.
+         *
+         * Frames of type TYPE_DRAWABLE use the textures of the given FBO
+         * without a copy, all other types are read back as above.
+         *
+         * @param glObjects the GL object manager for the current GL context.
+         * @param config the configuration of the source frame buffer.
+         * @param regions the areas to read back.
+         * @param drawable the FBO of the source drawable, or 0.
+         * @return the new images which need finishReadback.
+         * @version 1.9
+         */
+        EQ_API Images startReadback( util::ObjectManager& glObjects,
+                                     const DrawableConfig& config,
+                                     const PixelViewports& regions,
+                                     const util::FrameBufferObject* drawable );
+
+        /**
+         * Add images referencing a main memory frame buffer.
+         *
+         * Images of full rows of the frame buffer reference its pixels without
+         * a copy, other regions are copied. The images need no finish.
+         *
+         * @param config the configuration of the source frame buffer.
+         * @param regions the areas to read back.
+         * @param window the system window holding the frame buffer.
+         * @sa SystemWindow::getPixelData()
+         * @version 1.9
+         */
+        EQ_API void referenceFrameBuffer( const DrawableConfig& config,
+                                          const PixelViewports& regions,
+                                          const SystemWindow& window );
+
+        /**
+         * Start reading back a set of images for input frames on other GPUs.
+         *
+         * Memory frames are read back into textures of the given window,
+         * which the input frames copy directly into their context. Used by
+         * Channel::frameReadback() for frames without input frames on other
+         * nodes, if the window supports SystemWindow::copyImage().
+         *
+         * @param glObjects the GL object manager for the current GL context.
+         * @param config the configuration of the source frame buffer.
+         * @param regions the areas to read back.
+         * @param window the system window of the current GL context.
+         * @return the new images which need finishReadback.
+         * @sa FrameData::startPeerReadback()
+         * @version 1.9
+         */
+        EQ_API Images startPeerReadback( util::ObjectManager& glObjects,
+                                         const DrawableConfig& config,
+                                         const PixelViewports& regions,
+                                         const SystemWindow& window );
+
         /**
          * Set the frame ready.
          *
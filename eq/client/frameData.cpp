@@ -21,11 +21,17 @@
 
 #include "nodeStatistics.h"
 #include "channelStatistics.h"
+#include "detail/decompressPool.h"
+#include "detail/blocks.h"
+#include "detail/imagePool.h"
+#include "detail/sharedImageArena.h"
+#include "detail/spans.h"
 #include "exception.h"
 #include "image.h"
 #include "log.h"
 #include "pixelData.h"
 #include "roiFinder.h"
+#include "systemWindow.h"
 
 #include <eq/fabric/drawableConfig.h>
 #include <eq/fabric/frameData.h>
@@ -34,6 +40,7 @@
 #include <co/connectionDescription.h>
 #include <co/dataIStream.h>
 #include <co/dataOStream.h>
+#include <co/iCommand.h>
 #include <lunchbox/monitor.h>
 #include <lunchbox/scopedMutex.h>
 #include <pression/plugins/compressor.h>
@@ -47,6 +54,39 @@ namespace eq
 typedef lunchbox::Monitor< uint64_t > Monitor;
 typedef std::vector< FrameData::Listener* > Listeners;
 
+namespace
+{
+/** Set the given area of a main memory frame buffer on the image. */
+void _referencePixels( Image& image, const Frame::Buffer buffer,
+                       const PixelData& source, const PixelViewport& pvp )
+{
+    PixelData pixels;
+    pixels.internalFormat = source.internalFormat;
+    pixels.externalFormat = source.externalFormat;
+    pixels.pixelSize = source.pixelSize;
+    pixels.pvp = PixelViewport( 0, 0, pvp.w, pvp.h );
+
+    const size_t rowSize = size_t( source.pvp.w ) * source.pixelSize;
+    const uint8_t* first = static_cast< const uint8_t* >( source.pixels ) +
+                           size_t( pvp.y - source.pvp.y ) * rowSize +
+                           size_t( pvp.x - source.pvp.x ) * source.pixelSize;
+
+    // full rows are contiguous and referenced without a copy
+    if( pvp.w == source.pvp.w )
+    {
+        pixels.pixels = const_cast< uint8_t* >( first );
+        image.referencePixelData( buffer, pixels );
+        return;
+    }
+
+    image.setPixelData( buffer, pixels ); // allocates the image memory
+    uint8_t* to = image.getPixelPointer( buffer );
+    const size_t size = size_t( pvp.w ) * source.pixelSize;
+    for( int32_t y = 0; y < pvp.h; ++y )
+        memcpy( to + y * size, first + y * rowSize, size );
+}
+}
+
 namespace detail
 {
 class FrameData
@@ -59,6 +99,10 @@ public:
         , depthQuality( 1.f )
         , colorCompressor( EQ_COMPRESSOR_AUTO )
         , depthCompressor( EQ_COMPRESSOR_AUTO )
+        , imagePool( 0 )
+        , decompressPool( 0 )
+        , sharedImageArena( 0 )
+        , pendingDecompressions( 0 )
     {}
 
     fabric::FrameData data;
@@ -71,6 +115,11 @@ public:
 
     Images pendingImages;
 
+    /** Received commands referenced by the uncompressed image data. */
+    typedef std::vector< co::ICommand > Commands;
+    Commands commands;
+    Commands pendingCommands;
+
     uint64_t version; //!< The current version
 
     /** Data ready monitor for output->input synchronization. */
@@ -85,6 +134,39 @@ public:
 
     uint32_t colorCompressor;
     uint32_t depthCompressor;
+
+    /** Node-wide cache for memory images, used instead of imageCache. */
+    ImagePool* imagePool;
+
+    /** Node-wide threads decompressing received images. */
+    DecompressPool* decompressPool;
+
+    /** Node-wide shared memory for images from processes of this host. */
+    SharedImageArena* sharedImageArena;
+
+    /** The number of received images not yet decompressed. */
+    lunchbox::Monitor< uint32_t > pendingDecompressions;
+
+    /** The last received image of a temporally encoded buffer. */
+    struct Reference
+    {
+        Frame::Buffer buffer;
+        PixelViewport pvp;
+        std::vector< uint8_t > pixels;
+    };
+    std::vector< Reference > references;
+
+    Reference& getReference( const Frame::Buffer buffer,
+                             const PixelViewport& pvp )
+    {
+        BOOST_FOREACH( Reference& reference, references )
+            if( reference.buffer == buffer && reference.pvp == pvp )
+                return reference;
+
+        const Reference reference = { buffer, pvp, std::vector< uint8_t >() };
+        references.push_back( reference );
+        return references.back();
+    }
 };
 }
 
@@ -96,6 +178,7 @@ FrameData::FrameData()
 
 FrameData::~FrameData()
 {
+    _impl->pendingDecompressions.waitEQ( 0 );
     clear();
 
     BOOST_FOREACH( Image* image, _impl->imageCache )
@@ -245,10 +328,19 @@ void FrameData::applyInstanceData( co::DataIStream& is )
 void FrameData::clear()
 {
     _impl->imageCacheLock.set();
-    _impl->imageCache.insert( _impl->imageCache.end(), _impl->images.begin(),
-                              _impl->images.end( ));
+    BOOST_FOREACH( Image* image, _impl->images )
+    {
+        if( _impl->imagePool &&
+            image->getStorageType() == Frame::TYPE_MEMORY )
+        {
+            _impl->imagePool->release( image );
+        }
+        else
+            _impl->imageCache.push_back( image );
+    }
     _impl->imageCacheLock.unset();
     _impl->images.clear();
+    _impl->commands.clear();
 }
 
 void FrameData::flush()
@@ -290,14 +382,39 @@ Image* FrameData::newImage( const eq::Frame::Type type,
     return image;
 }
 
+void FrameData::setImagePool( detail::ImagePool* pool )
+{
+    _impl->imagePool = pool;
+}
+
+void FrameData::setDecompressPool( detail::DecompressPool* pool )
+{
+    _impl->decompressPool = pool;
+}
+
+void FrameData::setSharedImageArena( detail::SharedImageArena* arena )
+{
+    _impl->sharedImageArena = arena;
+}
+
+detail::SharedImageArena* FrameData::getSharedImageArena()
+{
+    return _impl->sharedImageArena;
+}
+
 Image* FrameData::_allocImage( const eq::Frame::Type type,
                                const DrawableConfig& config,
-                               const bool setQuality_ )
+                               const bool setQuality_, const size_t size )
 {
     Image* image;
     _impl->imageCacheLock.set();
 
-    if( _impl->imageCache.empty( ))
+    if( _impl->imagePool && type == Frame::TYPE_MEMORY )
+    {
+        _impl->imageCacheLock.unset();
+        image = _impl->imagePool->alloc( size );
+    }
+    else if( _impl->imageCache.empty( ))
     {
         _impl->imageCacheLock.unset();
         image = new Image;
@@ -346,6 +463,55 @@ Image* FrameData::_allocImage( const eq::Frame::Type type,
     return image;
 }
 
+void FrameData::referenceFrameBuffer( const Frame& frame,
+                                      const DrawableConfig& config,
+                                      const PixelViewports& regions,
+                                      const SystemWindow& window )
+{
+    if( _impl->data.buffers == Frame::BUFFER_NONE )
+        return;
+
+    if( getType() != Frame::TYPE_MEMORY || frame.getZoom() != Zoom::NONE )
+    {
+        LBWARN << "Main memory frame buffers support only unzoomed memory "
+               << "frames, skipping frame" << std::endl;
+        return;
+    }
+
+    const PixelData* color = window.getPixelData( Frame::BUFFER_COLOR );
+    if( !color )
+        return;
+
+    const eq::PixelViewport& framePVP = getPixelViewport();
+    PixelViewport absPVP = framePVP + frame.getOffset();
+    absPVP.intersect( color->pvp );
+
+    const eq::Pixel& pixel = getPixel();
+    const Frame::Buffer buffers[] = { Frame::BUFFER_COLOR,
+                                      Frame::BUFFER_DEPTH };
+
+    for( size_t i = 0; i < regions.size(); ++i )
+    {
+        PixelViewport pvp = regions[ i ] + frame.getOffset();
+        pvp.intersect( absPVP );
+        if( !pvp.hasArea( ))
+            continue;
+
+        Image* image = newImage( getType(), config );
+        image->setPixelViewport( PixelViewport( 0, 0, pvp.w, pvp.h ));
+        for( size_t j = 0; j < 2; ++j )
+        {
+            const PixelData* source = window.getPixelData( buffers[j] );
+            if( source && ( getBuffers() & buffers[j] ))
+                _referencePixels( *image, buffers[j], *source, pvp );
+        }
+
+        pvp -= frame.getOffset();
+        image->setOffset( (pvp.x - framePVP.x) * pixel.w,
+                          (pvp.y - framePVP.y) * pixel.h );
+    }
+}
+
 #ifndef EQ_2_0_API
 void FrameData::readback( const Frame& frame,
                           util::ObjectManager& glObjects,
@@ -362,7 +528,8 @@ void FrameData::readback( const Frame& frame,
 Images FrameData::startReadback( const Frame& frame,
                                  util::ObjectManager& glObjects,
                                  const DrawableConfig& config,
-                                 const PixelViewports& regions )
+                                 const PixelViewports& regions,
+                                 const util::FrameBufferObject* drawable )
 {
     if( _impl->data.buffers == Frame::BUFFER_NONE )
         return Images();
@@ -382,25 +549,39 @@ Images FrameData::startReadback( const Frame& frame,
     Images images;
 
     // readback the whole screen when using textures
-    if( getType() == eq::Frame::TYPE_TEXTURE )
+    if( getType() == eq::Frame::TYPE_TEXTURE ||
+        getType() == eq::Frame::TYPE_DRAWABLE )
     {
         Image* image = newImage( getType(), config );
+        image->setOffset( 0, 0 );
+
+        // use the source FBO textures directly if possible
+        if( getType() == eq::Frame::TYPE_DRAWABLE && drawable &&
+            image->setDrawable( getBuffers(), absPVP, *drawable ))
+        {
+            return images;
+        }
+
         if( image->startReadback( getBuffers(), absPVP, zoom, glObjects ))
             images.push_back( image );
-        image->setOffset( 0, 0 );
         return images;
     }
     //else read only required regions
 
 #if 0
     // TODO: issue #85: move automatic ROI detection to eq::Channel
-    PixelViewports regions;
+    PixelViewport declared;
+    for( PixelViewportsCIter i = regions.begin(); i != regions.end(); ++i )
+        declared.merge( *i + frame.getOffset( ));
+
+    PixelViewports found;
     if( _impl->data.buffers & Frame::BUFFER_DEPTH && zoom == Zoom::NONE )
-        regions = _impl->roiFinder->findRegions( _impl->data.buffers, absPVP,
-                                                 zoom, frame.getAssemblyStage(),
-                                                 frame.getFrameID(), glObjects);
+        found = _impl->roiFinder->findRegions( _impl->data.buffers, absPVP,
+                                               zoom, frame.getAssemblyStage(),
+                                               frame.getFrameID(), declared,
+                                               glObjects );
     else
-        regions.push_back( absPVP );
+        found.push_back( absPVP );
 #endif
 
     LBASSERT( getType() == eq::Frame::TYPE_MEMORY );
@@ -425,6 +606,43 @@ Images FrameData::startReadback( const Frame& frame,
     return images;
 }
 
+Images FrameData::startPeerReadback( const Frame& frame,
+                                     util::ObjectManager& glObjects,
+                                     const DrawableConfig& config,
+                                     const PixelViewports& regions,
+                                     const SystemWindow& window )
+{
+    if( _impl->data.buffers == Frame::BUFFER_NONE )
+        return Images();
+
+    // texture readback does not zoom, the input frames do
+    if( getType() != Frame::TYPE_MEMORY || frame.getZoom() != Zoom::NONE )
+        return startReadback( frame, glObjects, config, regions );
+
+    const eq::PixelViewport& framePVP = getPixelViewport();
+    const PixelViewport      absPVP   = framePVP + frame.getOffset();
+    if( !absPVP.isValid( ))
+        return Images();
+
+    const eq::Pixel& pixel = getPixel();
+    for( uint32_t i = 0; i < regions.size(); ++i )
+    {
+        PixelViewport pvp = regions[ i ] + frame.getOffset();
+        pvp.intersect( absPVP );
+        if( !pvp.hasArea( ))
+            continue;
+
+        Image* image = newImage( Frame::TYPE_TEXTURE, config );
+        image->setSourceWindow( &window );
+        image->startReadback( getBuffers(), pvp, Zoom::NONE, glObjects );
+
+        pvp -= frame.getOffset();
+        image->setOffset( (pvp.x - framePVP.x) * pixel.w,
+                          (pvp.y - framePVP.y) * pixel.h );
+    }
+    return Images();
+}
+
 void FrameData::setVersion( const uint64_t version )
 {
     LBASSERTINFO( _impl->version <= version, _impl->version << " > "
@@ -454,7 +672,10 @@ void FrameData::setReady( const co::ObjectVersion& frameData,
               _impl->readyVersion + 1 == frameData.version.low( ));
     LBASSERT( _impl->version == frameData.version.low( ));
 
+    // images are usable only after their decompression finished
+    _impl->pendingDecompressions.waitEQ( 0 );
     _impl->images.swap( _impl->pendingImages );
+    _impl->commands.swap( _impl->pendingCommands );
     _impl->data = data;
     _setReady( frameData.version.low());
 
@@ -502,18 +723,24 @@ void FrameData::removeListener( Listener& listener )
 bool FrameData::addImage( const co::ObjectVersion& frameDataVersion,
                           const PixelViewport& pvp, const Zoom& zoom,
                           const uint32_t buffers_, const bool useAlpha,
-                          uint8_t* data )
+                          uint8_t* data, const co::ICommand& command,
+                          const uint32_t frameNumber )
 {
     LBASSERT( _impl->readyVersion < frameDataVersion.version.low( ));
     if( _impl->readyVersion >= frameDataVersion.version.low( ))
         return false;
 
+    const size_t nBuffers = ( buffers_ & Frame::BUFFER_COLOR ? 1 : 0 ) +
+                            ( buffers_ & Frame::BUFFER_DEPTH ? 1 : 0 );
     Image* image = _allocImage( Frame::TYPE_MEMORY, DrawableConfig(),
-                                false /* set quality */ );
+                                false /* set quality */,
+                                pvp.getArea() * 4 * nBuffers );
 
     image->setPixelViewport( pvp );
     image->setAlphaUsage( useAlpha );
 
+    bool referenced = false;
+    detail::DecompressPool::Task task;
     Frame::Buffer buffers[] = { Frame::BUFFER_COLOR, Frame::BUFFER_DEPTH };
     for( unsigned i = 0; i < 2; ++i )
     {
@@ -531,6 +758,34 @@ bool FrameData::addImage( const co::ObjectVersion& frameDataVersion,
             pixelData.pvp             = header->pvp;
             pixelData.compressorFlags = header->compressorFlags;
 
+            if( header->shared )
+            {
+                typedef detail::SharedImageArena::Handle Handle;
+                LBASSERT( header->nChunks == 1 );
+                const uint64_t size = *reinterpret_cast< uint64_t*>( data );
+                data += sizeof( uint64_t );
+                LBASSERT( size == sizeof( Handle ));
+                const Handle handle = *reinterpret_cast< Handle* >( data );
+                data += size;
+
+                detail::SharedImageArena* arena = _impl->sharedImageArena;
+                const void* pixels = arena ? arena->map( handle ) : 0;
+                image->setZoom( zoom );
+                image->setQuality( buffer, header->quality );
+                if( !pixels )
+                {
+                    LBWARN << "Can't access shared memory image "
+                           << pixelData.pvp << std::endl;
+                    continue;
+                }
+
+                // copied, the block is reused by the sender once released
+                pixelData.pixels = const_cast< void* >( pixels );
+                image->setPixelData( buffer, pixelData );
+                arena->release( handle );
+                continue;
+            }
+
             const uint32_t compressor = header->compressorName;
             if( compressor > EQ_COMPRESSOR_NONE )
             {
@@ -548,6 +803,91 @@ bool FrameData::addImage( const co::ObjectVersion& frameDataVersion,
                 }
                 pixelData.compressedData =
                     pression::CompressorResult( compressor, chunks );
+
+                if( _impl->decompressPool )
+                {
+                    const detail::DecompressPool::Buffer entry =
+                        { buffer, pixelData.internalFormat,
+                          pixelData.externalFormat, pixelData.pixelSize,
+                          pixelData.pvp, pixelData.compressorFlags,
+                          pixelData.compressedData };
+                    task.buffers.push_back( entry );
+                    image->setZoom( zoom );
+                    image->setQuality( buffer, header->quality );
+                    continue;
+                }
+            }
+            else if( header->sparse )
+            {
+                LBASSERT( header->nChunks == 2 );
+                uint64_t size = *reinterpret_cast< uint64_t*>( data );
+                data += sizeof( uint64_t );
+
+                pixelData.spans.resize( size / sizeof( uint32_t ));
+                ::memcpy( &pixelData.spans[0], data, size );
+                data += size;
+
+                size = *reinterpret_cast< uint64_t*>( data );
+                data += sizeof( uint64_t );
+                const uint8_t* activePixels = data;
+                data += size;
+
+                // clear the background and copy the active pixels
+                image->setZoom( zoom );
+                image->setQuality( buffer, header->quality );
+                image->setPixelData( buffer, pixelData );
+                if( size > 0 )
+                    detail::spans::unpack( activePixels, pixelData.pixelSize,
+                                           pixelData.pvp.w, pixelData.pvp.h,
+                                           pixelData.spans,
+                                           image->getPixelPointer( buffer ));
+                continue;
+            }
+            else if( header->temporal != TEMPORAL_NONE )
+            {
+                detail::FrameData::Reference& reference =
+                    _impl->getReference( buffer, pixelData.pvp );
+                const size_t imageSize = size_t( pixelData.pvp.getArea( )) *
+                                         pixelData.pixelSize;
+                if( header->temporal == TEMPORAL_KEY )
+                {
+                    LBASSERT( header->nChunks == 1 );
+                    const uint64_t size = *reinterpret_cast< uint64_t*>( data );
+                    data += sizeof( uint64_t );
+                    LBASSERT( size == imageSize );
+                    reference.pixels.assign( data, data + size );
+                    data += size;
+                }
+                else
+                {
+                    LBASSERT( header->nChunks == 2 );
+                    uint64_t size = *reinterpret_cast< uint64_t*>( data );
+                    data += sizeof( uint64_t );
+                    const std::vector< uint8_t > mask( data, data + size );
+                    data += size;
+
+                    size = *reinterpret_cast< uint64_t*>( data );
+                    data += sizeof( uint64_t );
+                    const uint8_t* blocks = data;
+                    data += size;
+
+                    if( reference.pixels.size() != imageSize )
+                    {
+                        LBWARN << "Missing reference image for temporal delta "
+                               << pixelData.pvp << std::endl;
+                        reference.pixels.assign( imageSize, 0 );
+                    }
+                    detail::blocks::unpack( blocks, pixelData.pixelSize,
+                                            pixelData.pvp.w, pixelData.pvp.h,
+                                            mask, &reference.pixels[0] );
+                }
+
+                // copied, the reference is updated by the next frame
+                pixelData.pixels = &reference.pixels[0];
+                image->setZoom( zoom );
+                image->setQuality( buffer, header->quality );
+                image->setPixelData( buffer, pixelData );
+                continue;
             }
             else
             {
@@ -561,10 +901,31 @@ bool FrameData::addImage( const co::ObjectVersion& frameDataVersion,
 
             image->setZoom( zoom );
             image->setQuality( buffer, header->quality );
-            image->setPixelData( buffer, pixelData );
+
+            // uncompressed pixels are used in place from the command buffer
+            if( compressor > EQ_COMPRESSOR_NONE )
+                image->setPixelData( buffer, pixelData );
+            else
+            {
+                image->referencePixelData( buffer, pixelData );
+                referenced = true;
+            }
         }
     }
 
+    if( !task.buffers.empty( ))
+    {
+        // compressed chunks are decompressed from the command buffer
+        task.image = image;
+        task.pending = &_impl->pendingDecompressions;
+        task.frameNumber = frameNumber;
+        ++_impl->pendingDecompressions;
+        _impl->decompressPool->push( task );
+        referenced = true;
+    }
+
+    if( referenced )
+        _impl->pendingCommands.push_back( command );
     _impl->pendingImages.push_back( image );
     return true;
 }
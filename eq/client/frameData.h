@@ -33,7 +33,8 @@
 
 namespace eq
 {
-namespace detail { class FrameData; }
+namespace detail { class DecompressPool; class FrameData; class ImagePool;
+                   class SharedImageArena; }
 
 /**
  * A holder for multiple images.
@@ -64,6 +65,20 @@ public:
         uint32_t                compressorFlags;
         uint32_t                nChunks;
         float                   quality;
+        uint32_t                sparse; //!< chunks are spans, active pixels
+        uint32_t                temporal; //!< Temporal encoding of the chunks
+        uint32_t                shared; //!< pixels are in a shared memory arena
+    };
+
+    /**
+     * @internal Encodings of consecutive images from the same output frame.
+     * @sa Channel::IATTR_HINT_TEMPORAL_TRANSMIT
+     */
+    enum Temporal
+    {
+        TEMPORAL_NONE, //!< independent image
+        TEMPORAL_KEY, //!< full image, kept as reference
+        TEMPORAL_DELTA //!< block mask and changed blocks of the reference
     };
 
     /** Construct a new frame data holder. @version 1.0 */
@@ -239,13 +254,55 @@ public:
      * @param glObjects the GL object manager for the current GL context.
      * @param config the configuration of the source frame buffer.
      * @param regions the areas to read back.
+     * @param drawable the FBO of the source drawable, or 0.
      * @return the new images which need finishReadback.
      * @version 1.3.0
      */
     Images startReadback( const Frame& frame,
                           util::ObjectManager& glObjects,
                           const DrawableConfig& config,
-                          const PixelViewports& regions );
+                          const PixelViewports& regions,
+                          const util::FrameBufferObject* drawable = 0 );
+
+    /**
+     * Add images referencing the main memory frame buffer of a window.
+     *
+     * The new images are added to the data using newImage(). Images of full
+     * frame buffer rows reference the pixels without a copy.
+     *
+     * @param frame the corresponding output frame holder.
+     * @param config the configuration of the source frame buffer.
+     * @param regions the areas to read back.
+     * @param window the system window holding the frame buffer.
+     * @version 1.9
+     */
+    void referenceFrameBuffer( const Frame& frame,
+                               const DrawableConfig& config,
+                               const PixelViewports& regions,
+                               const SystemWindow& window );
+
+    /**
+     * Read back a set of images for input frames on other GPUs of this node.
+     *
+     * Memory frames are read back into textures owned by the given window
+     * instead of main memory, and are copied by the input frames using
+     * SystemWindow::copyImage(). Zoomed frames and other frame types are read
+     * back as in startReadback(). The new images need no finish, but the
+     * caller has to finish the source context before the frame is ready.
+     *
+     * @param frame the corresponding output frame holder.
+     * @param glObjects the GL object manager for the current GL context.
+     * @param config the configuration of the source frame buffer.
+     * @param regions the areas to read back.
+     * @param window the system window of the current GL context.
+     * @return the new images which need finishReadback.
+     * @version 1.9
+     */
+    Images startPeerReadback( const Frame& frame,
+                              util::ObjectManager& glObjects,
+                              const DrawableConfig& config,
+                              const PixelViewports& regions,
+                              const SystemWindow& window );
 
     /**
      * Set the frame data ready.
@@ -298,11 +355,24 @@ public:
 
     const fabric::FrameData& getData() const; //!< @internal
 
+    /** @internal Share memory images with other frame datas using the pool. */
+    void setImagePool( detail::ImagePool* pool );
+
+    /** @internal Decompress received images asynchronously using the pool. */
+    void setDecompressPool( detail::DecompressPool* pool );
+
+    /** @internal Exchange images with local processes using the arena. */
+    void setSharedImageArena( detail::SharedImageArena* arena );
+
+    /** @internal @return the shared memory arena of the node, or 0. */
+    detail::SharedImageArena* getSharedImageArena();
+
     /** @internal */
     bool addImage( const co::ObjectVersion& frameDataVersion,
                    const PixelViewport& pvp, const Zoom& zoom,
                    const uint32_t buffers, const bool useAlpha,
-                   uint8_t* data );
+                   uint8_t* data, const co::ICommand& command,
+                   const uint32_t frameNumber );
     void setReady( const co::ObjectVersion& frameData,
                    const fabric::FrameData& data ); //!< @internal
 
@@ -317,7 +387,7 @@ private:
     /** Allocate or reuse an image. */
     Image* _allocImage( const Frame::Type type,
                         const DrawableConfig& config,
-                        const bool setQuality );
+                        const bool setQuality, const size_t size = 0 );
 
     /** Apply all received images of the given version. */
     void _applyVersion( const uint128_t& version );
@@ -47,6 +47,7 @@ public:
         : glewInitialized( false )
         , fbo( 0 )
         , fboMultiSample( 0 )
+        , fence( 0 )
     {
         lunchbox::setZero( &glewContext, sizeof( GLEWContext ));
     }
@@ -68,6 +69,9 @@ public:
     util::FrameBufferObject* fbo;
 
     util::FrameBufferObject* fboMultiSample;
+
+    /** Signaled when the commands before the last insertFence() are done. */
+    GLsync fence;
 };
 }
 
@@ -93,6 +97,12 @@ void GLWindow::makeCurrent( const bool useCache ) const
     _current = this;
 }
 
+void GLWindow::doneCurrent() const
+{
+    if( _current == this )
+        _current = 0;
+}
+
 bool GLWindow::isCurrent() const
 {
     return _current == this;
@@ -116,6 +126,11 @@ void GLWindow::initGLEW()
 
 void GLWindow::exitGLEW()
 {
+    if( _impl->fence )
+    {
+        glDeleteSync( _impl->fence );
+        _impl->fence = 0;
+    }
     _impl->glewInitialized = false;
 }
 
@@ -224,17 +239,17 @@ void GLWindow::bindDrawFrameBuffer() const
 }
 
 void GLWindow::updateFrameBuffer() const
+{
+    const PixelViewport& pvp = getPixelViewport();
+    updateFrameBuffer( PixelViewport( 0, 0, pvp.w, pvp.h ));
+}
+
+void GLWindow::updateFrameBuffer( const PixelViewport& pvp ) const
 {
     if( !_impl->glewInitialized || !_impl->fboMultiSample )
         return;
 
-    _impl->fboMultiSample->bind( GL_READ_FRAMEBUFFER_EXT );
-    _impl->fbo->bind( GL_DRAW_FRAMEBUFFER_EXT );
-    const PixelViewport& pvp = getPixelViewport();
-    EQ_GL_CALL( glBlitFramebuffer( 0, 0, pvp.w, pvp.h,
-                                   0, 0, pvp.w, pvp.h,
-                                   GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT |
-                                   GL_STENCIL_BUFFER_BIT, GL_NEAREST ));
+    _impl->fboMultiSample->resolve( *_impl->fbo, pvp );
 }
 
 void GLWindow::flush()
@@ -247,6 +262,35 @@ void GLWindow::finish()
     glFinish();
 }
 
+void GLWindow::insertFence()
+{
+    if( !GLEW_ARB_sync )
+    {
+        finish();
+        return;
+    }
+
+    if( _impl->fence )
+        glDeleteSync( _impl->fence );
+    _impl->fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+    glFlush();
+}
+
+bool GLWindow::waitFence( const uint32_t timeout )
+{
+    if( !_impl->fence )
+        return true;
+
+    const GLenum result = glClientWaitSync( _impl->fence,
+                                            GL_SYNC_FLUSH_COMMANDS_BIT,
+                                            GLuint64( timeout ) * 1000000ull );
+    glDeleteSync( _impl->fence );
+    _impl->fence = 0;
+    if( result == GL_WAIT_FAILED )
+        EQ_GL_ERROR( "glClientWaitSync" );
+    return result != GL_TIMEOUT_EXPIRED;
+}
+
 void GLWindow::queryDrawableConfig( DrawableConfig& drawableConfig )
 {
     // GL version
@@ -46,6 +46,9 @@ public:
     /** Bind the FBO and update the current cache. @version 1.0 */
     EQ_API void makeCurrent( const bool cache = true ) const override;
 
+    /** Clear the make current cache of the calling thread. @version 1.9 */
+    EQ_API void doneCurrent() const override;
+
     /**
      * @return true if this window was last made current in this thread.
      * @version 1.3.2
@@ -63,12 +66,21 @@ public:
     /** Update the window's FBO from the multisampled FBO. @version 1.9 */
     EQ_API void updateFrameBuffer() const override;
 
+    /** Update an area of the window's FBO. @version 1.9 */
+    EQ_API void updateFrameBuffer( const PixelViewport& pvp ) const override;
+
     /** Flush all command buffers. @version 1.5.2 */
     EQ_API void flush() override;
 
     /** Finish execution of  all commands. @version 1.5.2 */
     EQ_API void finish() override;
 
+    /** Insert a fence sync object, if supported. @version 1.9 */
+    EQ_API void insertFence() override;
+
+    /** Wait on the fence sync object. @version 1.9 */
+    EQ_API bool waitFence( uint32_t timeout ) override;
+
     /** Build and initialize the FBO. @version 1.0 */
     EQ_API virtual bool configInitFBO();
 
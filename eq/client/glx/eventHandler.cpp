@@ -63,6 +63,7 @@ static lunchbox::Lockable< MagellanData, lunchbox::SpinLock > _magellan;
 
 EventHandler::EventHandler( WindowIF* window )
         : _window( window )
+        , _display( window->getXDisplay( ))
         , _magellanUsed( false )
 {
     LBASSERT( window );
@@ -102,6 +103,19 @@ EventHandler::EventHandler( WindowIF* window )
 #endif
 }
 
+EventHandler::EventHandler( WindowIF* window, Display* display )
+        : _window( window )
+        , _display( display )
+        , _magellanUsed( false )
+{
+    LBASSERT( window );
+    LBASSERT( display );
+
+    if( !_eventHandlers )
+        _eventHandlers = new EventHandlers;
+    _eventHandlers->push_back( this );
+}
+
 EventHandler::~EventHandler()
 {
     if( _magellanUsed )
@@ -145,17 +159,16 @@ void EventHandler::dispatch()
 
 void EventHandler::_dispatch()
 {
-    Display* display = _window->getXDisplay();
-    LBASSERT( display );
-    if( !display )
+    LBASSERT( _display );
+    if( !_display )
         return;
 
-    while( XPending( display ))
+    while( XPending( _display ))
     {
         WindowEvent event;
         XEvent& xEvent = event.xEvent;
 
-        XNextEvent( display, &xEvent );
+        XNextEvent( _display, &xEvent );
 
         for( EventHandlers::const_iterator i = _eventHandlers->begin();
              i != _eventHandlers->end(); ++i )
@@ -36,6 +36,13 @@ namespace glx
         /** Construct a new glX event handler. @version 1.0 */
         EventHandler( WindowIF* window );
 
+        /**
+         * Construct a new glX event handler for the input events of the window
+         * received on the given display connection.
+         * @version 1.8
+         */
+        EventHandler( WindowIF* window, Display* display );
+
         /** Destruct the glX event handler. @version 1.0 */
         virtual ~EventHandler();
 
@@ -50,6 +57,7 @@ namespace glx
 
     private:
         WindowIF* const _window;
+        Display* const _display;
 
         bool _magellanUsed; //!< Window registered with spnav
 
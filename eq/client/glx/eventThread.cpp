@@ -0,0 +1,103 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "eventThread.h"
+
+#include "eventHandler.h"
+#include "window.h"
+
+#include <lunchbox/log.h>
+
+#include <cstdlib>
+
+namespace eq
+{
+namespace glx
+{
+const long EventThread::inputEventMask = KeyPressMask | KeyReleaseMask |
+                                         PointerMotionMask | ButtonPressMask |
+                                         ButtonReleaseMask;
+
+bool EventThread::isEnabled()
+{
+    return getenv( "EQ_WINDOW_EVENT_THREAD" ) != 0;
+}
+
+EventThread::EventThread( WindowIF* window )
+    : _window( window )
+    , _display( 0 )
+    , _running( false )
+{
+    LBASSERT( window->getXDisplay( ));
+    _displayName = DisplayString( window->getXDisplay( ));
+}
+
+EventThread::~EventThread()
+{
+    LBASSERT( !_display );
+}
+
+bool EventThread::configInit()
+{
+    // X11 connections are not shared between threads
+    _display = XOpenDisplay( _displayName.c_str( ));
+    if( !_display )
+    {
+        LBWARN << "Can't open display " << _displayName << " for event thread"
+               << std::endl;
+        return false;
+    }
+
+    XSelectInput( _display, _window->getXDrawable(), inputEventMask );
+    XFlush( _display );
+    _running = true;
+    return start();
+}
+
+void EventThread::configExit()
+{
+    if( !_display )
+        return;
+
+    _running = false;
+    _messagePump.postWakeup();
+    join();
+
+    XCloseDisplay( _display );
+    _display = 0;
+}
+
+bool EventThread::init()
+{
+    setName( "Event" );
+    return true;
+}
+
+void EventThread::run()
+{
+    // event handlers are per-thread, dispatched by our message pump
+    EventHandler handler( _window, _display );
+    _messagePump.register_( _display );
+
+    while( _running.get( ))
+        _messagePump.dispatchOne();
+
+    _messagePump.deregister( _display );
+}
+
+}
+}
@@ -0,0 +1,75 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_GLX_EVENTTHREAD_H
+#define EQ_GLX_EVENTTHREAD_H
+
+#include "messagePump.h" // member
+
+#include <eq/client/glx/types.h>
+#include <lunchbox/monitor.h> // member
+#include <lunchbox/thread.h> // base class
+
+namespace eq
+{
+namespace glx
+{
+    /**
+     * @internal
+     * A thread dispatching the input events of one window.
+     *
+     * The thread opens its own connection to the window's display and selects
+     * the pointer and key events of the window on it. The input events are
+     * processed and sent to the config by this thread, independent of the
+     * rendering of the window's pipe thread. All other events are dispatched
+     * by the pipe thread as usual.
+     *
+     * Used for windows with an on-screen drawable when EQ_WINDOW_EVENT_THREAD
+     * is set in the environment.
+     */
+    class EventThread : public lunchbox::Thread
+    {
+    public:
+        /** The events of a window dispatched by the event thread. */
+        static const long inputEventMask;
+
+        /** @return true if input events use an event thread. */
+        static bool isEnabled();
+
+        explicit EventThread( WindowIF* window );
+        virtual ~EventThread();
+
+        /** Start the thread, @return false if the display can't be opened. */
+        bool configInit();
+
+        /** Stop the thread and wait for its termination. */
+        void configExit();
+
+    protected:
+        bool init() override;
+        void run() override;
+
+    private:
+        WindowIF* const _window;
+        std::string _displayName;
+        Display* _display;
+        MessagePump _messagePump;
+        lunchbox::Monitorb _running;
+    };
+}
+}
+#endif // EQ_GLX_EVENTTHREAD_H
@@ -20,12 +20,14 @@
 #include "window.h"
 
 #include "eventHandler.h"
+#include "eventThread.h"
 #include "messagePump.h"
 #include "windowEvent.h"
 
 #include "../error.h"
 #include "../global.h"
 
+#include <eq/util/texture.h>
 #include <co/objectOCommand.h>
 
 #ifdef EQUALIZER_USE_QT5WIDGETS
@@ -49,6 +51,7 @@ public:
         , glXContext( 0 )
         , glXNVSwapGroup( 0 )
         , glXEventHandler( 0 )
+        , eventThread( 0 )
         , glxewContext( glxewContext_ )
         , messagePump( messagePump_ )
     {}
@@ -65,6 +68,9 @@ public:
     /** The event handler. */
     EventHandler* glXEventHandler;
 
+    /** The input event thread, if used. */
+    EventThread* eventThread;
+
     /** The glX extension pointer table. */
     const GLXEWContext* glxewContext;
 
@@ -537,9 +543,9 @@ XID Window::_createGLXWindow( GLXFBConfig* fbConfig, const PixelViewport& pvp )
                                    AllocNone );
     wa.background_pixmap = None;
     wa.border_pixel = 0;
-    wa.event_mask = StructureNotifyMask | VisibilityChangeMask | ExposureMask |
-                    KeyPressMask | KeyReleaseMask | PointerMotionMask |
-                    ButtonPressMask | ButtonReleaseMask;
+    wa.event_mask = StructureNotifyMask | VisibilityChangeMask | ExposureMask;
+    if( !EventThread::isEnabled( )) // else selected by the event thread
+        wa.event_mask |= EventThread::inputEventMask;
 
     switch( getIAttribute( WindowSettings::IATTR_HINT_DECORATION ))
     {
@@ -793,6 +799,13 @@ void Window::makeCurrent( const bool cache ) const
     }
 }
 
+void Window::doneCurrent() const
+{
+    LBASSERT( _impl->xDisplay );
+    glXMakeCurrent( _impl->xDisplay, None, 0 );
+    WindowIF::doneCurrent();
+}
+
 void Window::swapBuffers()
 {
     LBASSERT( _impl->xDisplay );
@@ -804,10 +817,6 @@ void Window::joinNVSwapBarrier( const uint32_t group, const uint32_t barrier)
     if( group == 0 )
         return;
 
-#if 1
-    LBWARN << "Entering untested function GLXWindow::joinNVSwapBarrier"
-           << std::endl;
-
     if ( !GLXEW_NV_swap_group )
     {
         LBWARN << "NV Swap group extension not supported" << std::endl;
@@ -852,9 +861,37 @@ void Window::joinNVSwapBarrier( const uint32_t group, const uint32_t barrier)
 
     LBVERB << "Joined swap group " << group << " and barrier " << barrier
            << std::endl;
-#else
-    LBUNIMPLEMENTED;
-#endif
+}
+
+uint32_t Window::getMaxNVSwapBarriers()
+{
+    if( !_impl->xDisplay || !GLXEW_NV_swap_group )
+        return 0;
+
+    const int screen = DefaultScreen( _impl->xDisplay );
+    uint32_t maxBarrier = 0;
+    uint32_t maxGroup = 0;
+    glXQueryMaxSwapGroupsNV( _impl->xDisplay, screen, &maxGroup, &maxBarrier );
+    return maxGroup > 0 ? maxBarrier : 0;
+}
+
+bool Window::hasCopyImage() const
+{
+    return _impl->xDisplay && GLXEW_NV_copy_image;
+}
+
+bool Window::copyImage( const SystemWindow& source, const util::Texture& from,
+                        const util::Texture& to, const Vector2i& size ) const
+{
+    const WindowIF* sourceWindow = dynamic_cast< const WindowIF* >( &source );
+    if( !sourceWindow || !hasCopyImage( ))
+        return false;
+
+    glXCopyImageSubDataNV( _impl->xDisplay, sourceWindow->getGLXContext(),
+                           from.getName(), from.getTarget(), 0, 0, 0, 0,
+                           _impl->glXContext, to.getName(), to.getTarget(), 0,
+                           0, 0, 0, size.x(), size.y(), 1 );
+    return true;
 }
 
 void Window::leaveNVSwapBarrier()
@@ -880,7 +917,9 @@ bool Window::processEvent( const WindowEvent& event )
         {
             const unsigned int eventMask = ButtonPressMask | ButtonReleaseMask |
                                            ButtonMotionMask;
-            const int result = XGrabPointer( getXDisplay(), getXDrawable(),
+            // the display of the event, which may be owned by an EventThread
+            const int result = XGrabPointer( event.xEvent.xany.display,
+                                             getXDrawable(),
                                              False, eventMask, GrabModeAsync,
                                              GrabModeAsync, None, None,
                                              CurrentTime );
@@ -910,7 +949,7 @@ bool Window::processEvent( const WindowEvent& event )
             WindowEvent ungrabEvent = event;
             ungrabEvent.type = Event::WINDOW_POINTER_UNGRAB;
             processEvent( ungrabEvent );
-            XUngrabPointer( getXDisplay(), CurrentTime );
+            XUngrabPointer( event.xEvent.xany.display, CurrentTime );
             return result;
         }
         break;
@@ -930,10 +969,32 @@ void Window::initEventHandler()
     else
         LBINFO << "Using glx::EventHandler without glx::MessagePump, external "
                << "event dispatch assumed" << std::endl;
+
+    if( EventThread::isEnabled() &&
+        getIAttribute( WindowSettings::IATTR_HINT_DRAWABLE ) == WINDOW )
+    {
+        _impl->eventThread = new EventThread( this );
+        if( !_impl->eventThread->configInit( ))
+        {
+            // fall back to input events dispatched by the pipe thread
+            delete _impl->eventThread;
+            _impl->eventThread = 0;
+            XSelectInput( display, getXDrawable(),
+                          StructureNotifyMask | VisibilityChangeMask |
+                          ExposureMask | EventThread::inputEventMask );
+        }
+    }
 }
 
 void Window::exitEventHandler()
 {
+    if( _impl->eventThread )
+    {
+        _impl->eventThread->configExit();
+        delete _impl->eventThread;
+        _impl->eventThread = 0;
+    }
+
     if( _impl->messagePump )
     {
         Display* display = getXDisplay();
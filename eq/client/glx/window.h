@@ -196,16 +196,30 @@ public:
     /** @version 1.0 */
     void makeCurrent( const bool cache = true ) const override;
 
+    /** Release the glX context from the calling thread. @version 1.9 */
+    void doneCurrent() const override;
+
     /** @version 1.0 */
     void swapBuffers() override;
 
-    /** Implementation untested for glX. @version 1.0 */
+    /** Join the GLX_NV_swap_group. @version 1.0 */
     void joinNVSwapBarrier( const uint32_t group,
                             const uint32_t barrier ) override;
 
+    /** @return the GLX_NV_swap_group barriers of the screen. @version 1.8 */
+    uint32_t getMaxNVSwapBarriers() override;
+
     /** Unbind a GLX_NV_swap_barrier. @version 1.0 */
     void leaveNVSwapBarrier();
 
+    /** @return true if GLX_NV_copy_image is supported. @version 1.9 */
+    bool hasCopyImage() const override;
+
+    /** Copy a texture of another GLX context, see GLX_NV_copy_image. */
+    bool copyImage( const SystemWindow& source, const util::Texture& from,
+                    const util::Texture& to,
+                    const Vector2i& size ) const override;
+
     /** @version 1.5.1 */
     EQ_API bool processEvent( const WindowEvent& event ) override;
     //@}
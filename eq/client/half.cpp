@@ -43,6 +43,21 @@
 
 #include "half.h"
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+#  define HALF_F16C
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#    define HALF_TARGET_F16C
+#  else
+#    define HALF_TARGET_F16C __attribute__(( target( "avx,f16c" )))
+#  endif
+#  include <immintrin.h>
+#elif defined(__aarch64__)
+#  define HALF_NEON
+#  include <arm_neon.h>
+#endif
+
 // Load immediate
 static inline uint32_t _uint32_li( uint32_t a )
 {
@@ -719,3 +734,124 @@ half_mul( uint16_t x, uint16_t y )
 
   return (uint16_t)(c_result);
 }
+
+// Batch conversion
+// ----------------
+//
+//  F16C converts eight and NEON four values per instruction. The scalar
+//  functions above handle the remainder and CPUs without these extensions.
+
+static void _half_to_float_n_scalar( const uint16_t* h, float* f, size_t n )
+{
+  for( size_t i = 0; i < n; ++i )
+    f[i] = half_to_float( h[i] );
+}
+
+static void _half_from_float_n_scalar( const float* f, uint16_t* h, size_t n )
+{
+  for( size_t i = 0; i < n; ++i )
+    h[i] = half_from_float( f[i] );
+}
+
+#ifdef HALF_F16C
+HALF_TARGET_F16C
+static void _half_to_float_n_f16c( const uint16_t* h, float* f, size_t n )
+{
+  size_t i = 0;
+  for( ; i + 8 <= n; i += 8 )
+  {
+    const __m128i in = _mm_loadu_si128( (const __m128i*)( h + i ));
+    _mm256_storeu_ps( f + i, _mm256_cvtph_ps( in ));
+  }
+  _half_to_float_n_scalar( h + i, f + i, n - i );
+}
+
+HALF_TARGET_F16C
+static void _half_from_float_n_f16c( const float* f, uint16_t* h, size_t n )
+{
+  size_t i = 0;
+  for( ; i + 8 <= n; i += 8 )
+  {
+    const __m256 in = _mm256_loadu_ps( f + i );
+    _mm_storeu_si128( (__m128i*)( h + i ),
+                      _mm256_cvtps_ph( in, _MM_FROUND_TO_NEAREST_INT ));
+  }
+  _half_from_float_n_scalar( f + i, h + i, n - i );
+}
+
+static bool _has_f16c()
+{
+#  ifdef _MSC_VER
+  int info[4];
+  __cpuid( info, 1 );
+  const bool osxsave = ( info[2] & ( 1 << 27 )) != 0;
+  const bool avx     = ( info[2] & ( 1 << 28 )) != 0;
+  const bool f16c    = ( info[2] & ( 1 << 29 )) != 0;
+  return osxsave && avx && f16c && ( _xgetbv( 0 ) & 0x6 ) == 0x6;
+#  else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports( "avx" ) && __builtin_cpu_supports( "f16c" );
+#  endif
+}
+#endif
+
+#ifdef HALF_NEON
+static void _half_to_float_n_neon( const uint16_t* h, float* f, size_t n )
+{
+  size_t i = 0;
+  for( ; i + 4 <= n; i += 4 )
+  {
+    const float16x4_t in = vreinterpret_f16_u16( vld1_u16( h + i ));
+    vst1q_f32( f + i, vcvt_f32_f16( in ));
+  }
+  _half_to_float_n_scalar( h + i, f + i, n - i );
+}
+
+static void _half_from_float_n_neon( const float* f, uint16_t* h, size_t n )
+{
+  size_t i = 0;
+  for( ; i + 4 <= n; i += 4 )
+  {
+    const float16x4_t out = vcvt_f16_f32( vld1q_f32( f + i ));
+    vst1_u16( h + i, vreinterpret_u16_f16( out ));
+  }
+  _half_from_float_n_scalar( f + i, h + i, n - i );
+}
+#endif
+
+typedef void (*half_to_float_n_t)( const uint16_t*, float*, size_t );
+typedef void (*half_from_float_n_t)( const float*, uint16_t*, size_t );
+
+static half_to_float_n_t _select_half_to_float_n()
+{
+#if defined( HALF_F16C )
+  if( _has_f16c( ))
+    return _half_to_float_n_f16c;
+#elif defined( HALF_NEON )
+  return _half_to_float_n_neon;
+#endif
+  return _half_to_float_n_scalar;
+}
+
+static half_from_float_n_t _select_half_from_float_n()
+{
+#if defined( HALF_F16C )
+  if( _has_f16c( ))
+    return _half_from_float_n_f16c;
+#elif defined( HALF_NEON )
+  return _half_from_float_n_neon;
+#endif
+  return _half_from_float_n_scalar;
+}
+
+void half_to_float_n( const uint16_t* h, float* f, size_t n )
+{
+  static const half_to_float_n_t convert = _select_half_to_float_n();
+  convert( h, f, n );
+}
+
+void half_from_float_n( const float* f, uint16_t* h, size_t n )
+{
+  static const half_from_float_n_t convert = _select_half_from_float_n();
+  convert( f, h, n );
+}
@@ -2,9 +2,14 @@
 #define HALF_H
 
 #include <lunchbox/types.h>
+#include <cstddef>
 
 float half_to_float( uint16_t h );
 uint16_t half_from_float( float f );
+
+// Convert n values at once, using F16C or NEON when available
+void half_to_float_n( const uint16_t* h, float* f, size_t n );
+void half_from_float_n( const float* f, uint16_t* h, size_t n );
 uint16_t half_add( uint16_t arg0, uint16_t arg1 );
 uint16_t half_mul( uint16_t arg0, uint16_t arg1 );
 
@@ -19,6 +19,9 @@
 
 #include "image.h"
 
+#include "detail/pluginCalibration.h"
+#include "detail/pluginManifest.h"
+#include "detail/spans.h"
 #include "gl.h"
 #include "half.h"
 #include "log.h"
@@ -27,9 +30,9 @@
 
 #include <eq/util/frameBufferObject.h>
 #include <eq/util/objectManager.h>
+#include <eq/util/shader.h>
 #include <eq/fabric/colorMask.h>
 
-#include <co/global.h>
 
 #include <lunchbox/buffer.h>
 #include <lunchbox/memoryMap.h>
@@ -100,6 +103,197 @@ public:
     bool hasAlpha; //!< The uncompressed pixels contain alpha
 };
 
+#define glewGetContext() glewContext
+#ifdef GL_EXT_memory_object
+/** @return the memory object for the given external memory, or 0. */
+GLuint _importMemory( const Image::ExternalMemory& memory,
+                      const GLEWContext* glewContext )
+{
+    if( !GLEW_EXT_memory_object )
+    {
+        LBWARN << "GL_EXT_memory_object not supported" << std::endl;
+        return 0;
+    }
+
+    GLuint object = 0;
+    glCreateMemoryObjectsEXT( 1, &object );
+    if( memory.dedicated )
+    {
+        const GLint dedicated = GL_TRUE;
+        glMemoryObjectParameterivEXT( object, GL_DEDICATED_MEMORY_OBJECT_EXT,
+                                      &dedicated );
+    }
+
+    bool imported = false;
+#  ifdef GL_EXT_memory_object_fd
+    if( memory.fd >= 0 && GLEW_EXT_memory_object_fd )
+    {
+        glImportMemoryFdEXT( object, memory.size, GL_HANDLE_TYPE_OPAQUE_FD_EXT,
+                             memory.fd );
+        imported = true;
+    }
+#  endif
+#  ifdef GL_EXT_memory_object_win32
+    if( !imported && memory.handle && GLEW_EXT_memory_object_win32 )
+    {
+        glImportMemoryWin32HandleEXT( object, memory.size,
+                                      GL_HANDLE_TYPE_OPAQUE_WIN32_EXT,
+                                      memory.handle );
+        imported = true;
+    }
+#  endif
+
+    if( imported && glGetError() == GL_NO_ERROR )
+        return object;
+
+    LBWARN << "Can't import external memory of " << memory.size << " bytes"
+           << std::endl;
+    glDeleteMemoryObjectsEXT( 1, &object );
+    return 0;
+}
+
+/** @return the texture using the memory object as storage, or 0. */
+GLuint _createTexture( const GLuint object, const GLenum target,
+                       const Image::ExternalMemory& memory,
+                       const PixelViewport& pvp,
+                       const GLEWContext* glewContext )
+{
+    GLuint name = 0;
+    glGenTextures( 1, &name );
+    glBindTexture( target, name );
+    glTexStorageMem2DEXT( target, 1, memory.internalFormat, pvp.w, pvp.h,
+                          object, memory.offset );
+    glBindTexture( target, 0 );
+    if( glGetError() == GL_NO_ERROR )
+        return name;
+
+    LBWARN << "Can't create " << pvp << " texture from external memory"
+           << std::endl;
+    glDeleteTextures( 1, &name );
+    return 0;
+}
+
+void _deleteMemory( GLuint object, const GLEWContext* glewContext )
+{
+    glDeleteMemoryObjectsEXT( 1, &object );
+}
+#else
+GLuint _importMemory( const Image::ExternalMemory& memory, const GLEWContext* )
+{
+    LBWARN << "GL_EXT_memory_object not supported by GLEW, can't import "
+           << memory.size << " bytes of external memory" << std::endl;
+    return 0;
+}
+
+GLuint _createTexture( const GLuint, const GLenum,
+                       const Image::ExternalMemory&, const PixelViewport&,
+                       const GLEWContext* )
+{
+    LBUNREACHABLE;
+    return 0;
+}
+
+void _deleteMemory( GLuint, const GLEWContext* ) { LBUNREACHABLE; }
+#endif
+
+bool _copyTexture( const util::Texture& source, util::Texture& dest,
+                   const Vector2i& position, const GLEWContext* glewContext )
+{
+    if( !GLEW_ARB_copy_image )
+    {
+        LBWARN << "GL_ARB_copy_image not supported" << std::endl;
+        return false;
+    }
+
+    EQ_GL_CALL( glCopyImageSubData( source.getName(), source.getTarget(), 0,
+                                    0, 0, 0,
+                                    dest.getName(), dest.getTarget(), 0,
+                                    position.x(), position.y(), 0,
+                                    source.getWidth(), source.getHeight(),
+                                    1 ));
+    return true;
+}
+
+// Key of the box filter program used for zoomed readback
+static const char _boxFilterKey = 0;
+
+// Zoomed readback FBOs are sized in steps of this many pixels
+static const int32_t _zoomFBOStep = 128;
+
+/** @return the program averaging all source texels of a destination pixel. */
+GLuint _getBoxFilterProgram( util::ObjectManager& om )
+{
+    const GLEWContext* const glewContext = om.glewGetContext();
+    GLuint program = om.getProgram( &_boxFilterKey );
+    if( program != util::ObjectManager::INVALID )
+    {
+        GLint linked = GL_FALSE; // a failed link is not retried
+        EQ_GL_CALL( glGetProgramiv( program, GL_LINK_STATUS, &linked ));
+        return linked ? program : 0;
+    }
+
+    if( !GLEW_VERSION_2_0 )
+        return 0;
+
+    const char* vertexShader =
+        "void main()\n"
+        "{\n"
+        "    gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+        "    gl_Position = ftransform();\n"
+        "}\n";
+
+    // up to 8x8 bilinear samples, covering 16x16 texels
+    const char* fragmentShader =
+        "#extension GL_ARB_texture_rectangle : enable\n"
+        "uniform sampler2DRect color;\n"
+        "uniform vec2 scale;\n"
+        "void main()\n"
+        "{\n"
+        "    const vec2 maxSamples = vec2( 8.0 );\n"
+        "    vec2 n = min( ceil( scale * 0.5 ), maxSamples );\n"
+        "    vec2 step = scale / n;\n"
+        "    vec2 base = gl_TexCoord[0].st - 0.5 * scale + 0.5 * step;\n"
+        "    vec4 sum = vec4( 0.0 );\n"
+        "    for( float y = 0.0; y < n.y; ++y )\n"
+        "        for( float x = 0.0; x < n.x; ++x )\n"
+        "            sum += texture2DRect( color, base + vec2( x, y ) * step );\n"
+        "    gl_FragColor = sum / ( n.x * n.y );\n"
+        "}\n";
+
+    program = om.newProgram( &_boxFilterKey );
+    if( !util::shader::linkProgram( glewContext, program, vertexShader,
+                                    fragmentShader ))
+    {
+        LBWARN << "Can't link box filter for zoomed readback" << std::endl;
+        return 0;
+    }
+
+    EQ_GL_CALL( glUseProgram( program ));
+    EQ_GL_CALL( glUniform1i( glGetUniformLocation( program, "color" ), 0 ));
+    EQ_GL_CALL( glUseProgram( 0 ));
+    return program;
+}
+
+/** Use the box filter for the given texels per pixel, if supported. */
+bool _bindBoxFilter( util::ObjectManager& om, const Vector2f& scale )
+{
+    const GLuint program = _getBoxFilterProgram( om );
+    if( !program )
+        return false;
+
+    const GLEWContext* const glewContext = om.glewGetContext();
+    EQ_GL_CALL( glUseProgram( program ));
+    EQ_GL_CALL( glUniform2f( glGetUniformLocation( program, "scale" ),
+                             scale.x(), scale.y( )));
+    return true;
+}
+
+void _unbindBoxFilter( const GLEWContext* glewContext )
+{
+    EQ_GL_CALL( glUseProgram( 0 ));
+}
+#undef glewGetContext
+
 enum ActivePlugin
 {
     PLUGIN_FULL,
@@ -120,15 +314,30 @@ struct Attachment
     /** The texture name for this image component (texture images). */
     util::Texture texture;
 
+    /** The storage of the texture (external images). */
+    GLuint memoryObject;
+
+    /** The context used to import the memory object. */
+    const GLEWContext* memoryContext;
+
+    /** The texture is owned by a drawable FBO (drawable images). */
+    bool shared;
+
     /** Current pixel data (memory images). */
     Memory memory;
 
+    /** The last compressed band of rows, see Image::compressPixelRows(). */
+    pression::CompressorResult rowData;
+
     Zoom zoom; //!< zoom factor of pending readback
 
     Attachment()
         : active( PLUGIN_FULL )
         , quality( 1.f )
         , texture( GL_TEXTURE_RECTANGLE_ARB )
+        , memoryObject( 0 )
+        , memoryContext( 0 )
+        , shared( false )
         {}
 
     ~Attachment()
@@ -144,10 +353,32 @@ struct Attachment
     void flush()
     {
         memory.flush();
+        flushExternal();
+        flushShared();
         texture.flush();
         resetPlugins();
     }
 
+    void flushShared()
+    {
+        if( !shared )
+            return;
+
+        texture.flushNoDelete();
+        shared = false;
+    }
+
+    void flushExternal()
+    {
+        if( memoryObject == 0 )
+            return;
+
+        texture.flush();
+        _deleteMemory( memoryObject, memoryContext );
+        memoryObject = 0;
+        memoryContext = 0;
+    }
+
     void resetPlugins()
     {
         compressor[ PLUGIN_FULL ].clear();
@@ -165,7 +396,11 @@ namespace detail
 class Image
 {
 public:
-    Image() : type( eq::Frame::TYPE_MEMORY ), ignoreAlpha( false ) {}
+    Image()
+        : type( eq::Frame::TYPE_MEMORY )
+        , ignoreAlpha( false )
+        , sourceWindow( 0 )
+    {}
 
     /** The rectangle of the current pixel data. */
     PixelViewport pvp;
@@ -182,6 +417,9 @@ public:
     /** Alpha channel significance. */
     bool ignoreAlpha;
 
+    /** The window owning the textures, for copies to other GPUs. */
+    const SystemWindow* sourceWindow;
+
     Attachment& getAttachment( const eq::Frame::Buffer buffer )
     {
         switch( buffer )
@@ -222,7 +460,9 @@ public:
         const Memory& memory = attachment.memory;
         TransferFinder finder( memory.internalFormat, memory.externalFormat, 0,
                                attachment.quality, ignoreAlpha, gl );
-        co::Global::getPluginRegistry().accept( finder );
+        ScopedPlugins plugins;
+        plugins.loadTokenType( memory.internalFormat );
+        plugins.get().accept( finder );
         return finder.result;
     }
 };
@@ -242,6 +482,7 @@ Image::~Image()
 void Image::reset()
 {
     _impl->ignoreAlpha = false;
+    _impl->sourceWindow = 0;
     setPixelViewport( PixelViewport( ));
 }
 
@@ -309,6 +550,12 @@ uint32_t Image::getPixelDataSize( const Frame::Buffer buffer ) const
     return memory.pvp.getArea() * memory.pixelSize;
 }
 
+size_t Image::getAllocatedSize() const
+{
+    return _impl->color.memory.localBuffer.getMaxSize() +
+           _impl->depth.memory.localBuffer.getMaxSize();
+}
+
 
 void Image::_setExternalFormat( const Frame::Buffer buffer,
                                 const uint32_t externalFormat,
@@ -372,9 +619,10 @@ private:
 std::vector< uint32_t > Image::findCompressors( const Frame::Buffer buffer )
     const
 {
-    const pression::PluginRegistry& registry = co::Global::getPluginRegistry();
+    detail::ScopedPlugins plugins;
+    plugins.loadTokenType( getExternalFormat( buffer ));
     CompressorFinder finder( getExternalFormat( buffer ));
-    registry.accept( finder );
+    plugins.get().accept( finder );
 
     LBLOG( LOG_PLUGIN )
         << "Found " << finder.result.size() << " compressors for token type 0x"
@@ -441,6 +689,88 @@ const util::Texture& Image::getTexture( const Frame::Buffer buffer ) const
     return _impl->getAttachment( buffer ).texture;
 }
 
+bool Image::setExternalMemory( const Frame::Buffer buffer,
+                               const ExternalMemory& memory,
+                               util::ObjectManager& glObjects )
+{
+    Attachment& attachment = _impl->getAttachment( buffer );
+    attachment.flushExternal();
+    attachment.memory.state = Memory::INVALID;
+
+    const PixelViewport& pvp = _impl->pvp;
+    if( !pvp.hasArea( ))
+    {
+        LBWARN << "Can't use external memory for empty image " << pvp
+               << std::endl;
+        return false;
+    }
+
+    const GLEWContext* glewContext = glObjects.glewGetContext();
+    const GLuint object = _importMemory( memory, glewContext );
+    if( object == 0 )
+        return false;
+
+    util::Texture& texture = attachment.texture;
+    const GLuint name = _createTexture( object, texture.getTarget(), memory,
+                                        pvp, glewContext );
+    if( name == 0 )
+    {
+        _deleteMemory( object, glewContext );
+        return false;
+    }
+
+    texture.setGLEWContext( glewContext );
+    texture.setGLData( name, memory.internalFormat, pvp.w, pvp.h );
+    texture.setGLEWContext( 0 );
+    attachment.memoryObject = object;
+    attachment.memoryContext = glewContext;
+    _impl->type = Frame::TYPE_EXTERNAL;
+    return true;
+}
+
+bool Image::setDrawable( const uint32_t buffers, const PixelViewport& pvp,
+                         const util::FrameBufferObject& fbo )
+{
+    if( !fbo.isValid() || pvp.x != 0 || pvp.y != 0 || !pvp.hasArea() ||
+        pvp.w > fbo.getWidth() || pvp.h > fbo.getHeight( ))
+    {
+        return false;
+    }
+
+    const util::Texture& color = *fbo.getColorTextures().front();
+    const util::Texture& depth = fbo.getDepthTexture();
+    const unsigned target = _impl->color.texture.getTarget();
+    if( color.getTarget() != target ||
+        (( buffers & Frame::BUFFER_DEPTH ) &&
+         ( !depth.isValid() || depth.getTarget() != target )))
+    {
+        return false;
+    }
+
+    setStorageType( Frame::TYPE_DRAWABLE );
+    _impl->pvp = pvp;
+
+    for( size_t i = 0; i < 2; ++i )
+    {
+        const Frame::Buffer buffer = i == 0 ? Frame::BUFFER_COLOR :
+                                              Frame::BUFFER_DEPTH;
+        if( !( buffers & buffer ))
+            continue;
+
+        const util::Texture& source = i == 0 ? color : depth;
+        Attachment& attachment = _impl->getAttachment( buffer );
+        attachment.memory.state = Memory::INVALID;
+        attachment.flushShared();
+        attachment.texture.setGLEWContext( fbo.glewGetContext( ));
+        attachment.texture.setGLData( source.getName(),
+                                      source.getInternalFormat(),
+                                      pvp.w, pvp.h );
+        attachment.texture.setGLEWContext( 0 );
+        attachment.shared = true;
+    }
+    return true;
+}
+
 const uint8_t* Image::getPixelPointer( const Frame::Buffer buffer ) const
 {
     LBASSERT( hasPixelData( buffer ));
@@ -462,6 +792,9 @@ const PixelData& Image::getPixelData( const Frame::Buffer buffer ) const
 bool Image::upload( const Frame::Buffer buffer, util::Texture* texture,
                     const Vector2i& position, util::ObjectManager& om ) const
 {
+    if( _impl->type == Frame::TYPE_EXTERNAL )
+        return _uploadExternal( buffer, texture, position, om );
+
     // freed by deleteGLObjects, e.g., called from Pipe::flushFrames()
     pression::Uploader* uploader = om.obtainEqUploader(
                                         _getCompressorKey( buffer ));
@@ -474,8 +807,12 @@ bool Image::upload( const Frame::Buffer buffer, util::Texture* texture,
     const GLEWContext* const gl = om.glewGetContext();
 
     if( !uploader->supports( externalFormat, internalFormat, flags, gl ))
-        uploader->setup( co::Global::getPluginRegistry(), externalFormat,
-                         internalFormat, flags, gl );
+    {
+        detail::ScopedPlugins plugins;
+        plugins.loadTokenType( externalFormat );
+        uploader->setup( plugins.get(), externalFormat, internalFormat, flags,
+                         gl );
+    }
 
     if( !uploader->isGood( gl ))
     {
@@ -498,6 +835,27 @@ bool Image::upload( const Frame::Buffer buffer, util::Texture* texture,
     return true;
 }
 
+bool Image::_uploadExternal( const Frame::Buffer buffer,
+                             util::Texture* texture, const Vector2i& position,
+                             util::ObjectManager& om ) const
+{
+    const util::Texture& source = getTexture( buffer );
+    if( !source.isValid( ))
+        return false;
+    if( !texture )
+    {
+        LBWARN << "Frame buffer upload of external images not implemented, "
+               << "use the image texture" << std::endl;
+        return false;
+    }
+
+    const PixelViewport& pvp = getPixelViewport();
+    texture->init( source.getInternalFormat(), pvp.w, pvp.h );
+    return _copyTexture( source, *texture,
+                         Vector2i( position.x() + pvp.x, position.y() + pvp.y ),
+                         om.glewGetContext( ));
+}
+
 //---------------------------------------------------------------------------
 // asynchronous readback
 //---------------------------------------------------------------------------
@@ -546,11 +904,19 @@ bool Image::_startReadback( const Frame::Buffer buffer, const Zoom& zoom,
 {
     Attachment& attachment = _impl->getAttachment( buffer );
     attachment.memory.compressedData = pression::CompressorResult();
+    attachment.memory.spans.clear();
 
-    if( _impl->type == Frame::TYPE_TEXTURE )
+    if( _impl->type == Frame::TYPE_EXTERNAL )
+    {
+        LBWARN << "Can't read back into external memory" << std::endl;
+        return false;
+    }
+    if( _impl->type == Frame::TYPE_TEXTURE ||
+        _impl->type == Frame::TYPE_DRAWABLE ) // drawable not shared: copy
     {
         LBASSERTINFO( zoom == Zoom::NONE, "Texture readback zoom not " <<
                       "implemented, zoom happens during compositing" );
+        attachment.flushShared();
         util::Texture& texture = attachment.texture;
         texture.setGLEWContext( glObjects.glewGetContext( ));
         texture.copyFromFrameBuffer( getInternalFormat( buffer ), _impl->pvp );
@@ -573,6 +939,7 @@ bool Image::startReadback( const Frame::Buffer buffer,
     pression::Downloader& downloader = attachment.downloader[attachment.active];
     Memory& memory = attachment.memory;
     const uint32_t inputToken = memory.internalFormat;
+    memory.spans.clear();
 
     uint32_t flags = EQ_COMPRESSOR_TRANSFER | EQ_COMPRESSOR_DATA_2D |
                      ( texture ? texture->getCompressorTarget() :
@@ -580,8 +947,18 @@ bool Image::startReadback( const Frame::Buffer buffer,
     const bool noAlpha = _impl->ignoreAlpha && buffer == Frame::BUFFER_COLOR;
 
     if( !downloader.supports( inputToken, noAlpha, flags ))
-        downloader.setup( co::Global::getPluginRegistry(), inputToken,
-                           attachment.quality, noAlpha, flags, gl );
+    {
+        const uint32_t name = detail::pluginCalibration::chooseDownloader(
+            inputToken, attachment.quality, noAlpha, flags, gl );
+        detail::ScopedPlugins plugins;
+        plugins.loadTokenType( inputToken );
+        if( name <= EQ_COMPRESSOR_NONE ||
+            !downloader.setup( plugins.get(), name, gl ))
+        {
+            downloader.setup( plugins.get(), inputToken, attachment.quality,
+                              noAlpha, flags, gl );
+        }
+    }
 
     if( !downloader.isGood( ))
     {
@@ -649,7 +1026,7 @@ void Image::finishReadback( const GLEWContext* context )
 void Image::_finishReadback( const Frame::Buffer buffer,
                              const GLEWContext* context )
 {
-    if( _impl->type == Frame::TYPE_TEXTURE )
+    if( _impl->type != Frame::TYPE_MEMORY )
         return;
 
     Attachment& attachment = _impl->getAttachment( buffer );
@@ -660,9 +1037,9 @@ void Image::_finishReadback( const Frame::Buffer buffer,
     pression::Downloader& downloader = attachment.downloader[attachment.active];
     const uint32_t inputToken = memory.internalFormat;
     const bool alpha = _impl->ignoreAlpha && buffer == Frame::BUFFER_COLOR;
+    // zoomed images are read from the frame buffer of the zoom FBO
     uint32_t flags = EQ_COMPRESSOR_TRANSFER | EQ_COMPRESSOR_DATA_2D |
-        ( attachment.zoom == Zoom::NONE ? EQ_COMPRESSOR_USE_FRAMEBUFFER :
-                                          EQ_COMPRESSOR_USE_TEXTURE_RECT );
+                     EQ_COMPRESSOR_USE_FRAMEBUFFER;
 
     if( !downloader.supports( inputToken, alpha, flags ))
     {
@@ -675,13 +1052,6 @@ void Image::_finishReadback( const Frame::Buffer buffer,
 
     uint64_t outDims[4] = {0};
     uint64_t inDims[4];
-    PixelViewport pvp = _impl->pvp;
-    if( attachment.zoom != Zoom::NONE )
-    {
-        pvp.apply( attachment.zoom );
-        pvp.x = 0;
-        pvp.y = 0;
-    }
     _impl->pvp.convertToPlugin( inDims );
 
     downloader.finish( &memory.pixels, inDims, flags, outDims, context );
@@ -708,18 +1078,28 @@ bool Image::_readbackZoom( const Frame::Buffer buffer, util::ObjectManager& om )
     texture->copyFromFrameBuffer( inputToken, _impl->pvp );
 
     // draw zoomed quad into FBO
-    //  uses the same FBO for color and depth, with masking.
+    //  uses the same FBO for color and depth, with masking. The FBO is sized
+    //  in steps and only shrunk when much too large, so that the changing zoom
+    //  of dynamic frame resizing does not reallocate it every frame.
     const void* fboKey = _getBufferKey( Frame::BUFFER_COLOR );
     util::FrameBufferObject* fbo = om.getEqFrameBufferObject( fboKey );
+    const int32_t width = ( pvp.w + _zoomFBOStep - 1 ) / _zoomFBOStep *
+                          _zoomFBOStep;
+    const int32_t height = ( pvp.h + _zoomFBOStep - 1 ) / _zoomFBOStep *
+                           _zoomFBOStep;
 
     if( fbo )
     {
-        LBCHECK( fbo->resize( pvp.w, pvp.h ));
+        if( fbo->getWidth() < pvp.w || fbo->getHeight() < pvp.h ||
+            fbo->getWidth() > 2 * width || fbo->getHeight() > 2 * height )
+        {
+            LBCHECK( fbo->resize( width, height ));
+        }
     }
     else
     {
         fbo = om.newEqFrameBufferObject( fboKey );
-        LBCHECK( fbo->init( pvp.w, pvp.h, inputToken, 24, 0 ));
+        LBCHECK( fbo->init( width, height, inputToken, 24, 0 ));
     }
     fbo->bind();
     texture->bind();
@@ -732,9 +1112,18 @@ bool Image::_readbackZoom( const Frame::Buffer buffer, util::ObjectManager& om )
         glColorMask( false, false, false, false );
     }
 
+    // Depth values are not filtered. Downscaled colors are averaged over all
+    // covered texels, since bilinear sampling skips texels below 0.5 zoom.
+    const Vector2f scale( float( _impl->pvp.w ) / float( pvp.w ),
+                          float( _impl->pvp.h ) / float( pvp.h ));
+    const bool boxFilter = buffer == Frame::BUFFER_COLOR &&
+                           ( scale.x() > 2.f || scale.y() > 2.f ) &&
+                           _bindBoxFilter( om, scale );
+
     glDisable( GL_LIGHTING );
     glEnable( GL_TEXTURE_RECTANGLE_ARB );
-    texture->applyZoomFilter( FILTER_LINEAR );
+    texture->applyZoomFilter( buffer == Frame::BUFFER_COLOR ? FILTER_LINEAR :
+                                                              FILTER_NEAREST );
     glColor3f( 1.0f, 1.0f, 1.0f );
 
     glBegin( GL_QUADS );
@@ -754,24 +1143,18 @@ bool Image::_readbackZoom( const Frame::Buffer buffer, util::ObjectManager& om )
     glEnd();
 
     // restore state
+    if( boxFilter )
+        _unbindBoxFilter( om.glewGetContext( ));
     glDisable( GL_TEXTURE_RECTANGLE_ARB );
-    // TODO channel->bindFramebuffer()
     glBindTexture( GL_TEXTURE_RECTANGLE_ARB, 0 );
-    fbo->unbind();
 
-    const util::Texture* zoomedTexture = 0;
     if( buffer == Frame::BUFFER_COLOR )
-    {
         glDepthMask( true );
-        zoomedTexture = fbo->getColorTextures().front();
-    }
     else
     {
         const ColorMask colorMask; // TODO = channel->getDrawBufferMask();
         glColorMask( colorMask.red, colorMask.green, colorMask.blue, true );
-        zoomedTexture = &fbo->getDepthTexture();
     }
-    LBASSERT( zoomedTexture->isValid( ));
     LBLOG( LOG_ASSEMBLY ) << "Scale " << _impl->pvp << " -> " << pvp << std::endl;
 
     // BUG TODO: this is a bug in case of color and depth buffers read-back, as
@@ -779,10 +1162,17 @@ bool Image::_readbackZoom( const Frame::Buffer buffer, util::ObjectManager& om )
     //
     // This should be done separately for color an depth buffers!
     _impl->pvp = pvp;
+    _impl->pvp.x = 0;
+    _impl->pvp.y = 0;
 
-    LBLOG( LOG_ASSEMBLY ) << "Read texture " << getPixelDataSize( buffer )
-                          << std::endl;
-    return startReadback( buffer, zoomedTexture, om.glewGetContext( ));
+    // read the zoomed area from the FBO like a frame buffer, which uses the
+    // asynchronous download of the plugins, e.g., into a PBO
+    LBLOG( LOG_ASSEMBLY ) << "Read zoomed frame buffer "
+                          << getPixelDataSize( buffer ) << std::endl;
+    const bool needFinish = startReadback( buffer, 0, om.glewGetContext( ));
+    // TODO channel->bindFramebuffer()
+    fbo->unbind();
+    return needFinish;
 }
 
 void Image::setPixelViewport( const PixelViewport& pvp )
@@ -842,12 +1232,25 @@ void Image::validatePixelData( const Frame::Buffer buffer )
 }
 
 void Image::setPixelData( const Frame::Buffer buffer, const PixelData& pixels )
+{
+    _setPixelData( buffer, pixels, true );
+}
+
+void Image::referencePixelData( const Frame::Buffer buffer,
+                                const PixelData& pixels )
+{
+    _setPixelData( buffer, pixels, false );
+}
+
+void Image::_setPixelData( const Frame::Buffer buffer, const PixelData& pixels,
+                           const bool copy )
 {
     Memory& memory = _impl->getMemory( buffer );
     memory.externalFormat = pixels.externalFormat;
     memory.internalFormat = pixels.internalFormat;
     memory.pixelSize = pixels.pixelSize;
     memory.pvp       = pixels.pvp;
+    memory.spans     = pixels.spans;
     memory.state     = Memory::INVALID;
     memory.compressedData = pression::CompressorResult();
     memory.hasAlpha = false;
@@ -879,6 +1282,13 @@ void Image::setPixelData( const Frame::Buffer buffer, const PixelData& pixels )
 
     if( pixels.compressedData.compressor <= EQ_COMPRESSOR_NONE )
     {
+        if( pixels.pixels && !copy )
+        {
+            memory.pixels = pixels.pixels;
+            memory.state = Memory::VALID;
+            return;
+        }
+
         validatePixelData( buffer ); // alloc memory for pixels
 
         if( pixels.pixels )
@@ -897,7 +1307,9 @@ void Image::setPixelData( const Frame::Buffer buffer, const PixelData& pixels )
     LBASSERT( pixels.compressedData.compressor != EQ_COMPRESSOR_AUTO );
 
     Attachment& attachment = _impl->getAttachment( buffer );
-    if( !attachment.decompressor->setup( co::Global::getPluginRegistry(),
+    detail::ScopedPlugins plugins;
+    plugins.loadName( pixels.compressedData.compressor );
+    if( !attachment.decompressor->setup( plugins.get(),
                                          pixels.compressedData.compressor ))
     {
         LBASSERTINFO( false,
@@ -941,7 +1353,9 @@ bool Image::allocCompressor( const Frame::Buffer buffer, const uint32_t name )
         return true;
 
     attachment.memory.compressedData = pression::CompressorResult();
-    compressor.setup( co::Global::getPluginRegistry(), name );
+    detail::ScopedPlugins plugins;
+    plugins.loadName( name );
+    compressor.setup( plugins.get(), name );
     LBLOG( LOG_PLUGIN ) << "Instantiated compressor of type 0x" << std::hex
                         << name << std::dec << std::endl;
     return compressor.isGood();
@@ -968,8 +1382,12 @@ bool Image::allocDownloader( const Frame::Buffer buffer, const uint32_t name,
     if( downloader.uses( name ))
         return true;
 
-    if( !downloader.setup( co::Global::getPluginRegistry(), name, gl ))
-        return false;
+    {
+        detail::ScopedPlugins plugins;
+        plugins.loadName( name );
+        if( !downloader.setup( plugins.get(), name, gl ))
+            return false;
+    }
 
     const EqCompressorInfo& info = downloader.getInfo();
     attachment.memory.internalFormat = info.tokenType;
@@ -1006,6 +1424,77 @@ const PixelData& Image::compressPixelData( const Frame::Buffer buffer )
         return memory;
     }
 
+    if( !_setupCompressor( buffer ))
+        return memory;
+
+    pression::Compressor& compressor = attachment.compressor[attachment.active];
+    uint64_t inDims[4];
+    memory.pvp.convertToPlugin( inDims );
+    compressor.compress( memory.pixels, inDims, memory.compressorFlags );
+    memory.compressedData = compressor.getResult();
+    return memory;
+}
+
+const pression::CompressorResult&
+Image::compressPixelRows( const Frame::Buffer buffer, const uint32_t startRow,
+                          const uint32_t nRows )
+{
+    LBASSERT( getPixelDataSize( buffer ) > 0 );
+
+    Attachment& attachment = _impl->getAttachment( buffer );
+    Memory& memory = attachment.memory;
+    LBASSERT( !memory.compressedData.isCompressed( ));
+    LBASSERT( startRow + nRows <= uint32_t( memory.pvp.h ));
+
+    attachment.rowData = pression::CompressorResult();
+    if( memory.compressorName == EQ_COMPRESSOR_NONE ||
+        !_setupCompressor( buffer ))
+    {
+        return attachment.rowData;
+    }
+
+    PixelViewport rows( memory.pvp );
+    rows.y += startRow;
+    rows.h = nRows;
+
+    const size_t offset = size_t( startRow ) * memory.pvp.w * memory.pixelSize;
+    pression::Compressor& compressor = attachment.compressor[attachment.active];
+    uint64_t inDims[4];
+    rows.convertToPlugin( inDims );
+    compressor.compress( memory.pixels + offset, inDims,
+                         memory.compressorFlags );
+    attachment.rowData = compressor.getResult();
+    return attachment.rowData;
+}
+
+bool Image::computeSpans()
+{
+    if( !hasPixelData( Frame::BUFFER_DEPTH ))
+        return false;
+
+    Memory& depth = _impl->depth.memory;
+    if( depth.externalFormat != EQ_COMPRESSOR_DATATYPE_DEPTH_UNSIGNED_INT ||
+        depth.compressedData.isCompressed() || !depth.pixels )
+    {
+        return false;
+    }
+
+    detail::spans::compute( reinterpret_cast< const uint32_t* >( depth.pixels ),
+                            depth.pvp.w, depth.pvp.h, depth.spans );
+
+    Memory& color = _impl->color.memory;
+    if( hasPixelData( Frame::BUFFER_COLOR ))
+    {
+        LBASSERT( color.pvp == depth.pvp );
+        color.spans = depth.spans;
+    }
+    return true;
+}
+
+bool Image::_setupCompressor( const Frame::Buffer buffer )
+{
+    Attachment& attachment = _impl->getAttachment( buffer );
+    Memory& memory = attachment.memory;
     pression::Compressor& compressor = attachment.compressor[attachment.active];
 
     if( !compressor.isGood() ||
@@ -1018,13 +1507,26 @@ const PixelData& Image::compressPixelData( const Frame::Buffer buffer )
             const float downloadQuality =
                 attachment.downloader[ attachment.active ].getInfo().quality;
             const float quality = attachment.quality / downloadQuality;
+            const uint32_t name = detail::pluginCalibration::chooseCompressor(
+                tokenType, memory.pixelSize, quality, _impl->ignoreAlpha );
 
-            compressor.setup( co::Global::getPluginRegistry(), tokenType,
-                               quality, _impl->ignoreAlpha );
+            detail::ScopedPlugins plugins;
+            plugins.loadTokenType( tokenType );
+            if( name > EQ_COMPRESSOR_NONE )
+            {
+                if( !compressor.uses( name ))
+                    compressor.setup( plugins.get(), name );
+            }
+            else
+                compressor.setup( plugins.get(), tokenType, quality,
+                                  _impl->ignoreAlpha );
         }
         else
-            compressor.setup( co::Global::getPluginRegistry(),
-                              memory.compressorName );
+        {
+            detail::ScopedPlugins plugins;
+            plugins.loadName( memory.compressorName );
+            compressor.setup( plugins.get(), memory.compressorName );
+        }
 
         if( !compressor.isGood( ))
         {
@@ -1038,7 +1540,7 @@ const PixelData& Image::compressPixelData( const Frame::Buffer buffer )
     LBASSERT( memory.compressedData.compressor != EQ_COMPRESSOR_AUTO );
     LBASSERT( memory.compressedData.compressor != EQ_COMPRESSOR_INVALID );
     if( memory.compressedData.compressor == EQ_COMPRESSOR_NONE )
-        return memory;
+        return false;
 
     memory.compressorFlags = EQ_COMPRESSOR_DATA_2D;
     if( _impl->ignoreAlpha && memory.hasAlpha )
@@ -1046,12 +1548,7 @@ const PixelData& Image::compressPixelData( const Frame::Buffer buffer )
         LBASSERT( buffer == Frame::BUFFER_COLOR );
         memory.compressorFlags |= EQ_COMPRESSOR_IGNORE_ALPHA;
     }
-
-    uint64_t inDims[4];
-    memory.pvp.convertToPlugin( inDims );
-    compressor.compress( memory.pixels, inDims, memory.compressorFlags );
-    memory.compressedData = compressor.getResult();
-    return memory;
+    return true;
 }
 
 
@@ -1131,12 +1628,6 @@ void put32f( std::ostream& os, const char* ptr )
     const uint8_t byte = uint8_t( value * 255.f );
     os.write( (const char*)&byte, 1 );
 }
-void put16f( std::ostream& os, const char* ptr )
-{
-    const uint16_t& value = *reinterpret_cast< const uint16_t* >(ptr);
-    const float f = half_to_float( value );
-    put32f( os, (const char*)&f );
-}
 }
 
 bool Image::writeImage( const std::string& filename,
@@ -1307,40 +1798,53 @@ bool Image::writeImage( const std::string& filename,
     header.convert();
 
     LBASSERTINFO( bpc == 2 || bpc == 4, bpc );
-    const bool twoBPC = bpc == 2;
+
+    // convert half floats once for all channels
+    std::vector< float > floats;
+    const char* values = data;
+    if( bpc == 2 )
+    {
+        floats.resize( nPixels * nChannels );
+        half_to_float_n( reinterpret_cast< const uint16_t* >( data ),
+                         &floats[0], floats.size( ));
+        values = reinterpret_cast< const char* >( &floats[0] );
+    }
+    const size_t fDepth = nChannels * sizeof( float );
+    const size_t fBytes = nPixels * fDepth;
+    const size_t fBPC = sizeof( float );
 
     if( nChannels == 3 || nChannels == 4 )
     {
         // channel one is R or B
         if ( swapRB )
-            for( size_t j = 0 * bpc; j < nBytes; j += depth )
-                twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
+            for( size_t j = 0 * fBPC; j < fBytes; j += fDepth )
+                put32f( image, &values[j] );
         else
-            for( size_t j = 2 * bpc; j < nBytes; j += depth )
-                twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
+            for( size_t j = 2 * fBPC; j < fBytes; j += fDepth )
+                put32f( image, &values[j] );
 
         // channel two is G
-        for( size_t j = 1 * bpc; j < nBytes; j += depth )
-                twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
+        for( size_t j = 1 * fBPC; j < fBytes; j += fDepth )
+            put32f( image, &values[j] );
 
         // channel three is B or G
         if ( swapRB )
-            for( size_t j = 2 * bpc; j < nBytes; j += depth )
-                twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
+            for( size_t j = 2 * fBPC; j < fBytes; j += fDepth )
+                put32f( image, &values[j] );
         else
-            for( size_t j = 0; j < nBytes; j += depth )
-                twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
+            for( size_t j = 0; j < fBytes; j += fDepth )
+                put32f( image, &values[j] );
 
          // channel four is Alpha
         if( nChannels == 4 )
-            for( size_t j = 3 * bpc; j < nBytes; j += depth )
-                twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
+            for( size_t j = 3 * fBPC; j < fBytes; j += fDepth )
+                put32f( image, &values[j] );
     }
     else
     {
-        for( size_t i = 0; i < nChannels; i += bpc )
-           for( size_t j = i * bpc; j < nBytes; j += depth )
-               twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
+        for( size_t i = 0; i < nChannels; ++i )
+           for( size_t j = i * fBPC; j < fBytes; j += fDepth )
+               put32f( image, &values[j] );
     }
     image.close();
 
@@ -1586,6 +2090,16 @@ uint32_t Image::getPixelSize( const Frame::Buffer buffer ) const
 
 void Image::setStorageType( const Frame::Type type )
 {
+    if( _impl->type == Frame::TYPE_EXTERNAL && type != Frame::TYPE_EXTERNAL )
+    {
+        _impl->color.flushExternal();
+        _impl->depth.flushExternal();
+    }
+    if( _impl->type == Frame::TYPE_DRAWABLE && type != Frame::TYPE_DRAWABLE )
+    {
+        _impl->color.flushShared();
+        _impl->depth.flushShared();
+    }
     _impl->type = type;
 }
 
@@ -1594,6 +2108,16 @@ Frame::Type Image::getStorageType() const
     return _impl->type;
 }
 
+void Image::setSourceWindow( const SystemWindow* window )
+{
+    _impl->sourceWindow = window;
+}
+
+const SystemWindow* Image::getSourceWindow() const
+{
+    return _impl->sourceWindow;
+}
+
 const PixelViewport& Image::getPixelViewport() const
 {
     return _impl->pvp;
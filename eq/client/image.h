@@ -23,6 +23,8 @@
 #include <eq/client/frame.h>         // for Frame::Buffer enum
 #include <eq/client/types.h>
 
+namespace pression { class CompressorResult; }
+
 namespace eq
 {
 namespace detail { class Image; }
@@ -41,6 +43,26 @@ public:
     /** Destruct the Image. @version 1.0 */
     EQ_API virtual ~Image();
 
+    /**
+     * GPU memory exported by another API, e.g., CUDA or Vulkan.
+     *
+     * The memory holds the pixels in the layout of a single-level texture of
+     * the image pixel viewport size and the given internal format.
+     * @version 1.8
+     */
+    struct ExternalMemory
+    {
+        ExternalMemory() : fd( -1 ), handle( 0 ), size( 0 ), offset( 0 )
+                         , internalFormat( 0 ), dedicated( false ) {}
+
+        int fd; //!< POSIX handle, owned by OpenGL after a successful import
+        void* handle; //!< Win32 handle, used if fd is not set
+        uint64_t size; //!< The size of the allocation in bytes
+        uint64_t offset; //!< The start of the pixels in the allocation
+        uint32_t internalFormat; //!< The sized GL format, e.g., GL_RGBA8
+        bool dedicated; //!< The allocation is dedicated to this buffer
+    };
+
     /** @name Image parameters */
     //@{
     /**
@@ -98,6 +120,13 @@ public:
      *
      * Image of storage type TYPE_TEXTURE read frame buffer data into a texture,
      * which can be accessed using getTexture().
+     *
+     * Images of storage type TYPE_EXTERNAL are not read back. Their texture
+     * is imported from the memory of another API using setExternalMemory().
+     *
+     * Images of storage type TYPE_DRAWABLE use the textures of the source
+     * FBO directly, see setDrawable(). They fall back to a texture copy if the
+     * FBO can't be used.
      * @version 1.0
      */
     EQ_API void setStorageType( const Frame::Type type );
@@ -132,6 +161,8 @@ public:
      *
      * The default compressor is EQ_COMPRESSOR_AUTO which selects the most
      * suitable compressor based on the current image and buffer parameters.
+     * The automatic selection is measured once per host and parameter set,
+     * see the EQ_PLUGIN_CALIBRATION environment variable.
      *
      * @param buffer the frame buffer attachment.
      * @param name the compressor name
@@ -182,12 +213,50 @@ public:
     /** @return the total size of the pixel data in bytes. @version 1.0 */
     EQ_API uint32_t getPixelDataSize( const Frame::Buffer buffer ) const;
 
+    /**
+     * @return the size of the main memory buffers allocated by the image, in
+     *         bytes.
+     * @version 1.8
+     */
+    EQ_API size_t getAllocatedSize() const;
+
     /** @return the pixel data. @version 1.0 */
     EQ_API const PixelData& getPixelData( const Frame::Buffer ) const;
 
     /** @return the pixel data, compressing it if needed. @version 1.0 */
     EQ_API const PixelData& compressPixelData( const Frame::Buffer );
 
+    /**
+     * Compress a band of rows of the uncompressed pixel data.
+     *
+     * The band spans the full width of the pixel data and starts at the given
+     * row relative to the pixel data viewport. The result is valid until the
+     * next call to this method for the buffer, and is empty if the pixel data
+     * is not compressed for transmission.
+     *
+     * @param buffer the buffer to compress.
+     * @param startRow the first row of the band.
+     * @param nRows the number of rows in the band.
+     * @return the compressed rows.
+     * @version 1.8
+     */
+    EQ_API const pression::CompressorResult&
+    compressPixelRows( const Frame::Buffer buffer, uint32_t startRow,
+                       uint32_t nRows );
+
+    /**
+     * Compute the active spans of a depth image.
+     *
+     * Pixels with the far plane depth are background. The span table is set
+     * on the color and depth pixel data, see PixelData::spans. Requires
+     * uncompressed, unsigned int depth pixel data in main memory. The spans
+     * are reset when new pixel data is read back or set.
+     *
+     * @return true if the spans were computed.
+     * @version 1.8
+     */
+    EQ_API bool computeSpans();
+
     /**
      * @return true if the image has valid pixel data for the buffer.
      * @version 1.0
@@ -235,6 +304,20 @@ public:
     EQ_API void setPixelData( const Frame::Buffer buffer,
                               const PixelData& data );
 
+    /**
+     * Set the pixel data of the given image buffer without copying it.
+     *
+     * Uncompressed pixels are referenced, and have to stay valid until the
+     * pixel data of the buffer is changed or the image is reset. Compressed
+     * pixel data is decompressed as in setPixelData().
+     *
+     * @param buffer the image buffer to set.
+     * @param data the pixel data.
+     * @version 1.8
+     */
+    EQ_API void referencePixelData( const Frame::Buffer buffer,
+                                    const PixelData& data );
+
     /**
      * Set alpha data preservation during download and compression.
      * @version 1.0
@@ -274,6 +357,63 @@ public:
      * @version 1.0
      */
     EQ_API bool hasTextureData( const Frame::Buffer buffer ) const;
+
+    /**
+     * Use external GPU memory as the texture of the given buffer.
+     *
+     * The memory is imported using GL_EXT_memory_object, which avoids copying
+     * pixels produced by CUDA or Vulkan into OpenGL. Sets the storage type to
+     * TYPE_EXTERNAL, so that the Compositor draws the texture directly. The
+     * pixel viewport has to be set before, and the producer has to finish
+     * writing the memory before the image is assembled. External images are
+     * local to the GPU and can not be transmitted.
+     *
+     * Requires the OpenGL context of the object manager to be current until
+     * the image is flushed or re-imported.
+     *
+     * @param buffer the image buffer to set.
+     * @param memory the exported memory.
+     * @param glObjects the GL object manager for the current GL context.
+     * @return true on success, false if the import failed or is unsupported.
+     * @version 1.8
+     */
+    EQ_API bool setExternalMemory( const Frame::Buffer buffer,
+                                   const ExternalMemory& memory,
+                                   util::ObjectManager& glObjects );
+
+    /**
+     * Use the textures of an FBO drawable as the image data.
+     *
+     * The image references the color and depth textures of the FBO instead of
+     * reading them back, so that an input frame on the same GPU is assembled
+     * without any copy. Sets the storage type to TYPE_DRAWABLE. The FBO has to
+     * be texture-backed, the area has to start at its origin, and it must not
+     * be rendered to until the image is assembled.
+     *
+     * @param buffers bit-wise combination of the Frame::Buffer components.
+     * @param pvp the area of the FBO used by the image.
+     * @param fbo the FBO of the source drawable.
+     * @return true on success, false if the FBO can't be used.
+     * @version 1.9
+     */
+    EQ_API bool setDrawable( const uint32_t buffers, const PixelViewport& pvp,
+                             const util::FrameBufferObject& fbo );
+
+    /**
+     * Set the window owning the textures of this image.
+     *
+     * Set for texture images read back for input frames on other GPUs of the
+     * same process. Their compositor copies the textures into its own context
+     * using SystemWindow::copyImage(), without a readback to main memory.
+     * Reset by reset().
+     *
+     * @param window the system window of the source context, or 0.
+     * @version 1.9
+     */
+    EQ_API void setSourceWindow( const SystemWindow* window );
+
+    /** @return the window owning the textures, or 0. @version 1.9 */
+    EQ_API const SystemWindow* getSourceWindow() const;
     //@}
 
     /** @name Operations */
@@ -330,6 +470,7 @@ public:
      * If a texture is given, the upload is performed to it. Otherwise the pixel
      * data is uploaded to the frame buffer. The texture will be initialized
      * using the parameters corresponding to the requested buffer.
+     * External images are copied on the GPU, and only to a texture.
      *
      * @param buffer the buffer type.
      * @param texture the target texture, or 0 for frame buffer upload.
@@ -411,6 +552,12 @@ private:
                              const uint32_t pixelSize,
                              const bool hasAlpha );
 
+    void _setPixelData( const Frame::Buffer buffer, const PixelData& data,
+                        const bool copy );
+
+    /** @return true if the buffer is compressed, setting up the plugin. */
+    bool _setupCompressor( const Frame::Buffer buffer );
+
     bool _readback( const Frame::Buffer buffer, const Zoom& zoom,
                     util::ObjectManager& glObjects );
 
@@ -419,6 +566,9 @@ private:
 
     void _finishReadback( const Frame::Buffer buffer, const GLEWContext* );
     bool _readbackZoom( const Frame::Buffer buffer, util::ObjectManager& om );
+    bool _uploadExternal( const Frame::Buffer buffer, util::Texture* texture,
+                          const Vector2i& position,
+                          util::ObjectManager& glObjects ) const;
 };
 };
 #endif // EQ_IMAGE_H
@@ -26,6 +26,7 @@
 
 #include "client.h"
 #include "config.h"
+#include "detail/pluginManifest.h"
 #include "global.h"
 #include "nodeFactory.h"
 #include "os.h"
@@ -318,20 +319,23 @@ bool _parseArguments( const int argc, char** argv )
 
 void _initPlugins()
 {
-    pression::PluginRegistry& plugins = co::Global::getPluginRegistry();
-
-    plugins.addDirectory( lunchbox::getExecutablePath() +
-                          "/../share/Equalizer/plugins" ); // install dir
-    plugins.addDirectory( "/usr/share/Equalizer/plugins" );
-    plugins.addDirectory( "/usr/local/share/Equalizer/plugins" );
-    plugins.addDirectory( ".eqPlugins" );
-    plugins.addDirectory( "/opt/local/lib" ); // MacPorts
+    Strings directories;
+    directories.push_back( lunchbox::getExecutablePath() +
+                           "/../share/Equalizer/plugins" ); // install dir
+    directories.push_back( "/usr/share/Equalizer/plugins" );
+    directories.push_back( "/usr/local/share/Equalizer/plugins" );
+    directories.push_back( ".eqPlugins" );
+    directories.push_back( "/opt/local/lib" ); // MacPorts
 
     const char* home = getenv( "HOME" );
     if( home )
-        plugins.addDirectory( std::string( home ) + "/.eqPlugins" );
+        directories.push_back( std::string( home ) + "/.eqPlugins" );
+
+    // the directory plugins are loaded on first use
+    detail::pluginManifest::init( directories );
 
 #ifdef EQUALIZER_DSO_NAME
+    pression::PluginRegistry& plugins = co::Global::getPluginRegistry();
     if( plugins.addPlugin( EQUALIZER_DSO_NAME )) // Found by LDD
         return;
 
@@ -364,6 +368,7 @@ void _initPlugins()
 
 void _exitPlugins()
 {
+    detail::pluginManifest::exit();
     pression::PluginRegistry& plugins = co::Global::getPluginRegistry();
 
     plugins.removeDirectory( lunchbox::getExecutablePath() +
@@ -40,6 +40,30 @@
 
 namespace eq
 {
+namespace
+{
+float _getRadicalInverse( uint32_t index, const uint32_t base )
+{
+    const float invBase = 1.f / float( base );
+    float factor = invBase;
+    float value = 0.f;
+    while( index > 0 )
+    {
+        value += factor * float( index % base );
+        index /= base;
+        factor *= invBase;
+    }
+    return value;
+}
+}
+
+Vector2f Jitter::getHalton( const uint32_t index )
+{
+    // skip the first sample (0,0) of the sequence, it lies on the pixel corner
+    return Vector2f( _getRadicalInverse( index + 1, 2 ) - .5f,
+                     _getRadicalInverse( index + 1, 3 ) - .5f );
+}
+
 Vector2f Jitter::j2[2] = { Vector2f( 0.246490f,  0.249999f ),
                            Vector2f( -0.246490f, -0.249999f ) };
 
@@ -39,6 +39,7 @@
 #ifndef JITTER_H_
 #define JITTER_H_
 
+#include <eq/client/api.h>
 #include <eq/client/types.h>
 #include <lunchbox/os.h>
 
@@ -54,6 +55,17 @@ namespace eq
         static Vector2f j15[15]; //!< Jitter values for 15 samples
         static Vector2f j24[24]; //!< Jitter values for 24 samples
         static Vector2f j66[66]; //!< Jitter values for 66 samples
+
+        /**
+         * @return the sample of the (2,3) Halton sequence at the given index,
+         *         in [-.5, .5[ pixels.
+         *
+         * Any prefix of the sequence covers the pixel evenly. Consecutive
+         * samples are handed out to the channels of a sub-pixel compound, so
+         * that the samples accumulated after each step approach the final
+         * image progressively.
+         */
+        EQ_API static Vector2f getHalton( uint32_t index );
     };
 }
 
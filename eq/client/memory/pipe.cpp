@@ -0,0 +1,37 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "pipe.h"
+
+#include "../pipe.h"
+
+namespace eq
+{
+namespace memory
+{
+
+bool Pipe::configInit()
+{
+    // There is no screen, the pipe viewport only sizes fractional windows
+    const PixelViewport& pvp = getPipe()->getPixelViewport();
+    if( !pvp.isValid( ))
+        getPipe()->setPixelViewport( PixelViewport( 0, 0, 1920, 1080 ));
+    return true;
+}
+
+}
+}
@@ -0,0 +1,50 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_MEMORY_PIPE_H
+#define EQ_MEMORY_PIPE_H
+
+#include <eq/client/systemPipe.h> // base class
+
+namespace eq
+{
+namespace memory
+{
+/**
+ * A system pipe for CPU rendering into main memory.
+ *
+ * The pipe uses no GPU and no display connection. The pipe device and port
+ * are ignored.
+ */
+class Pipe : public SystemPipe
+{
+public:
+    /** Construct a new main memory system pipe. @version 1.9 */
+    Pipe( eq::Pipe* parent ) : SystemPipe( parent ) {}
+
+    /** Destruct this main memory pipe. @version 1.9 */
+    virtual ~Pipe() {}
+
+    /** Initialize this pipe, always succeeds. @version 1.9 */
+    EQ_API bool configInit() override;
+
+    /** Deinitialize this pipe. @version 1.9 */
+    void configExit() override {}
+};
+}
+}
+#endif // EQ_MEMORY_PIPE_H
@@ -0,0 +1,138 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "window.h"
+
+#include "../error.h"
+
+#include <eq/fabric/drawableConfig.h>
+#include <pression/plugins/compressor.h>
+
+#include <cstring>
+
+namespace eq
+{
+namespace memory
+{
+namespace
+{
+enum Attachment
+{
+    COLOR,
+    DEPTH
+};
+}
+
+Window::Window( NotifierInterface& parent, const WindowSettings& settings )
+    : SystemWindow( parent, settings )
+    , _backBuffer( 0 )
+{
+    _pixels[ COLOR ].internalFormat = EQ_COMPRESSOR_DATATYPE_RGBA;
+    _pixels[ COLOR ].externalFormat = EQ_COMPRESSOR_DATATYPE_RGBA;
+    _pixels[ COLOR ].pixelSize = 4;
+    _pixels[ DEPTH ].internalFormat = EQ_COMPRESSOR_DATATYPE_DEPTH;
+    _pixels[ DEPTH ].externalFormat = EQ_COMPRESSOR_DATATYPE_DEPTH_UNSIGNED_INT;
+    _pixels[ DEPTH ].pixelSize = 4;
+}
+
+Window::~Window()
+{
+}
+
+bool Window::configInit()
+{
+    const PixelViewport& pvp = getPixelViewport();
+    if( !pvp.hasArea( ))
+    {
+        sendError( ERROR_WINDOW_PVP_INVALID );
+        return false;
+    }
+
+    const bool hasDepth =
+        getIAttribute( WindowSettings::IATTR_PLANES_DEPTH ) != OFF;
+    const size_t area = size_t( pvp.w ) * size_t( pvp.h );
+    for( unsigned i = 0; i < 2; ++i )
+    {
+        _memory[i][ COLOR ].resize( area * _pixels[ COLOR ].pixelSize );
+        _memory[i][ COLOR ].setZero();
+        if( !hasDepth )
+            continue;
+        _memory[i][ DEPTH ].resize( area * _pixels[ DEPTH ].pixelSize );
+        memset( _memory[i][ DEPTH ].getData(), 0xFF,
+                _memory[i][ DEPTH ].getSize( ));
+    }
+
+    _pixels[ COLOR ].pvp = PixelViewport( 0, 0, pvp.w, pvp.h );
+    _pixels[ DEPTH ].pvp = _pixels[ COLOR ].pvp;
+    _backBuffer = 0;
+    _updatePixels();
+    return true;
+}
+
+void Window::configExit()
+{
+    for( unsigned i = 0; i < 2; ++i )
+    {
+        _memory[i][ COLOR ].clear();
+        _memory[i][ DEPTH ].clear();
+    }
+    _pixels[ COLOR ].pixels = 0;
+    _pixels[ DEPTH ].pixels = 0;
+}
+
+void Window::swapBuffers()
+{
+    _backBuffer = 1 - _backBuffer;
+    _updatePixels();
+}
+
+void Window::_updatePixels()
+{
+    for( unsigned i = 0; i < 2; ++i )
+    {
+        lunchbox::Bufferb& memory = _memory[ _backBuffer ][i];
+        _pixels[i].pixels = memory.isEmpty() ? 0 : memory.getData();
+    }
+}
+
+void Window::queryDrawableConfig( DrawableConfig& drawableConfig )
+{
+    drawableConfig.stencilBits = 0;
+    drawableConfig.colorBits = 8;
+    drawableConfig.alphaBits = 8;
+    drawableConfig.accumBits = 0;
+    drawableConfig.glVersion = 0.f;
+    drawableConfig.stereo = false;
+    drawableConfig.doublebuffered = true;
+    drawableConfig.coreProfile = false;
+}
+
+PixelData* Window::getPixelData( const Frame::Buffer buffer )
+{
+    PixelData& pixels = _pixels[ buffer == Frame::BUFFER_DEPTH ? DEPTH : COLOR];
+    return pixels.pixels ? &pixels : 0;
+}
+
+const PixelData* Window::getPixelData( const Frame::Buffer buffer ) const
+{
+    const PixelData& pixels =
+        _pixels[ buffer == Frame::BUFFER_DEPTH ? DEPTH : COLOR ];
+    return pixels.pixels ? &pixels : 0;
+}
+
+}
+}
@@ -0,0 +1,82 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_MEMORY_WINDOW_H
+#define EQ_MEMORY_WINDOW_H
+
+#include <eq/client/pixelData.h>    // member
+#include <eq/client/systemWindow.h> // base class
+#include <lunchbox/buffer.h>        // member
+
+namespace eq
+{
+/**
+ * @namespace eq::memory
+ * @brief A window system for CPU rendering into main memory.
+ */
+namespace memory
+{
+/**
+ * A system window rendering into main memory.
+ *
+ * The window has no OpenGL context and no drawable. Its frame buffer is an
+ * RGBA color buffer with eight bits per channel and, unless depth planes are
+ * disabled, a 32 bit unsigned integer depth buffer. Rows are stored bottom to
+ * top, like OpenGL. CPU renderers draw the channel's pixel viewport into
+ * Channel::getPixelData().
+ *
+ * The default channel tasks clear, read back and assemble on the CPU. Read
+ * back images covering full rows of the window reference the frame buffer
+ * without a copy, and are compressed and transmitted like any other image. The
+ * frame buffer is double buffered, swapBuffers() renders the next frame into
+ * the other buffer while the images of the last frame are transmitted.
+ */
+class Window : public SystemWindow, public boost::noncopyable
+{
+public:
+    /** Construct a new main memory window. @version 1.9 */
+    EQ_API Window( NotifierInterface& parent, const WindowSettings& settings );
+
+    /** Destruct this main memory window. @version 1.9 */
+    EQ_API virtual ~Window();
+
+    EQ_API bool configInit() override;
+    EQ_API void configExit() override;
+    void makeCurrent( const bool /*cache*/ ) const override {}
+    void bindFrameBuffer() const override {}
+    void bindDrawFrameBuffer() const override {}
+    void updateFrameBuffer() const override {}
+    EQ_API void swapBuffers() override;
+    void joinNVSwapBarrier( const uint32_t, const uint32_t ) override {}
+    void flush() override {}
+    void finish() override {}
+    EQ_API void queryDrawableConfig( DrawableConfig& dc ) override;
+
+    EQ_API PixelData* getPixelData( const Frame::Buffer buffer ) override;
+    EQ_API const PixelData* getPixelData( const Frame::Buffer buffer )
+        const override;
+
+private:
+    lunchbox::Bufferb _memory[2][2]; //!< [back buffer][color, depth]
+    PixelData _pixels[2];            //!< color and depth of the back buffer
+    unsigned _backBuffer;
+
+    void _updatePixels();
+};
+}
+}
+#endif // EQ_MEMORY_WINDOW_H
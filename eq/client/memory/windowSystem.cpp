@@ -0,0 +1,60 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "../windowSystem.h"
+
+#include "window.h"
+#include "pipe.h"
+
+namespace eq
+{
+namespace memory
+{
+
+static class : WindowSystemIF
+{
+    std::string getName() const final { return "Memory"; }
+
+    eq::SystemWindow* createWindow( eq::Window* window,
+                                    const WindowSettings& settings ) final
+    {
+        LBINFO << "Using memory::Window" << std::endl;
+        return new Window( *window, settings );
+    }
+
+    eq::SystemPipe* createPipe( eq::Pipe* pipe ) final
+    {
+        LBINFO << "Using memory::Pipe" << std::endl;
+        return new Pipe( pipe );
+    }
+
+    eq::MessagePump* createMessagePump() final
+    {
+        return 0; // main memory windows have no events
+    }
+
+    bool setupFont( util::ObjectManager&, const void*, const std::string&,
+                    const uint32_t ) const final
+    {
+        LBINFO << "Fonts not supported by memory window system" << std::endl;
+        return false;
+    }
+
+} _memoryFactory;
+
+}
+}
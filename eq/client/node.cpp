@@ -21,6 +21,12 @@
 
 #include "client.h"
 #include "config.h"
+#include "detail/decompressPool.h"
+#include "detail/frameCounter.h"
+#include "detail/imagePool.h"
+#include "detail/sharedImageArena.h"
+#include "detail/syncPool.h"
+#include "detail/transmitQueue.h"
 #include "error.h"
 #include "exception.h"
 #include "frameData.h"
@@ -42,6 +48,10 @@
 #include <co/objectICommand.h>
 #include <lunchbox/scopedMutex.h>
 
+#ifdef EQUALIZER_USE_HWLOC
+#  include <hwloc.h>
+#endif
+
 namespace eq
 {
 namespace
@@ -49,7 +59,7 @@ namespace
 typedef stde::hash_map< uint128_t, co::Barrier* > BarrierHash;
 typedef stde::hash_map< uint128_t, FrameDataPtr > FrameDataHash;
 typedef FrameDataHash::const_iterator FrameDataHashCIter;
-typedef FrameDataHash::iterator FrameDataHashIter;
+typedef std::vector< FrameDataPtr > FrameDataVector;
 
 enum State
 {
@@ -63,6 +73,72 @@ enum State
 
 namespace detail
 {
+/**
+ * The frame datas of a node, by identifier.
+ *
+ * Pipe, transmit and command threads look up frame datas for each image. The
+ * table is split into shards with their own read-write spin lock, so that
+ * concurrent lookups rarely contend. Returned frame datas are reference
+ * counted and stay valid after they are removed from the table.
+ */
+class FrameDataTable
+{
+public:
+    /** @return the frame data with the given identifier, or 0. */
+    FrameDataPtr find( const uint128_t& id ) const
+    {
+        const Shard& shard = _getShard( id );
+        lunchbox::ScopedFastRead mutex( shard );
+        FrameDataHashCIter i = shard->find( id );
+        return i == shard->end() ? FrameDataPtr() : i->second;
+    }
+
+    /**
+     * Add a frame data unless one with the same identifier exists.
+     * @return the frame data in the table.
+     */
+    FrameDataPtr insert( FrameDataPtr data )
+    {
+        Shard& shard = _getShard( data->getID( ));
+        lunchbox::ScopedFastWrite mutex( shard );
+        FrameDataPtr& entry = shard.data[ data->getID( )];
+        if( !entry )
+            entry = data;
+        return entry;
+    }
+
+    /** @return true if the frame data was found and removed. */
+    bool erase( const uint128_t& id )
+    {
+        Shard& shard = _getShard( id );
+        lunchbox::ScopedFastWrite mutex( shard );
+        return shard->erase( id ) > 0;
+    }
+
+    /** Remove all frame datas and append them to the given vector. */
+    void clear( FrameDataVector& datas )
+    {
+        for( size_t i = 0; i < NUM_SHARDS; ++i )
+        {
+            Shard& shard = _shards[ i ];
+            lunchbox::ScopedFastWrite mutex( shard );
+            for( FrameDataHashCIter j = shard->begin(); j != shard->end(); ++j )
+                datas.push_back( j->second );
+            shard->clear();
+        }
+    }
+
+private:
+    typedef lunchbox::Lockable< FrameDataHash, lunchbox::SpinLock > Shard;
+    enum { NUM_SHARDS = 16 };
+    Shard _shards[ NUM_SHARDS ];
+
+    Shard& _getShard( const uint128_t& id )
+        { return _shards[ id.low() % NUM_SHARDS ]; }
+    const Shard& _getShard( const uint128_t& id ) const
+        { return _shards[ id.low() % NUM_SHARDS ]; }
+};
+
 class TransmitThread : public lunchbox::Thread
 {
 public:
@@ -71,30 +147,32 @@ public:
     {}
     virtual ~TransmitThread() {}
 
-    co::CommandQueue& getQueue() { return _queue; }
+    TransmitQueue& getQueue() { return _queue; }
 
 protected:
     bool init() override { setName( "Xmit" ); return true; }
     void run() override;
 
 private:
-    co::CommandQueue _queue;
+    TransmitQueue _queue;
 };
 
 class Node
 {
 public:
-    Node()
+    explicit Node( eq::Node* node )
         : state( STATE_STOPPED )
         , finishedFrame( 0 )
         , unlockedFrame( 0 )
+        , decompressPool( node )
+        , affinity( lunchbox::Thread::NONE )
     {}
 
     /** The configInit/configExit state. */
     lunchbox::Monitor< State > state;
 
     /** The number of the last started frame. */
-    lunchbox::Monitor< uint32_t > currentFrame;
+    FrameCounter currentFrame;
 
     /** The number of the last finished frame. */
     uint32_t finishedFrame;
@@ -106,9 +184,24 @@ public:
     lunchbox::Lockable< BarrierHash > barriers;
 
     /** All frame datas used by the node during rendering. */
-    lunchbox::Lockable< FrameDataHash > frameDatas;
+    FrameDataTable frameDatas;
+
+    /** Memory images shared by all frame datas. */
+    ImagePool imagePool;
+
+    /** Decompresses received images for all frame datas. */
+    DecompressPool decompressPool;
+
+    /** Exchanges images with the other processes of this host. */
+    SharedImageArena sharedImageArena;
+
+    /** Synchronizes application objects, see eq::Node::syncObjects(). */
+    SyncPool syncPool;
 
     TransmitThread transmitter;
+
+    /** The affinity of the node, network and transmit threads. */
+    int32_t affinity;
 };
 
 }
@@ -120,7 +213,7 @@ typedef fabric::Node< Config, Node, Pipe, NodeVisitor > Super;
 
 Node::Node( Config* parent )
     : Super( parent )
-    , _impl( new detail::Node )
+    , _impl( new detail::Node( this ))
 {
 }
 
@@ -235,14 +328,15 @@ co::Barrier* Node::getBarrier( const co::ObjectVersion& barrier )
 
 FrameDataPtr Node::getFrameData( const co::ObjectVersion& frameDataVersion )
 {
-    lunchbox::ScopedWrite mutex( _impl->frameDatas );
-    FrameDataPtr data = _impl->frameDatas.data[ frameDataVersion.identifier ];
-
+    FrameDataPtr data = _impl->frameDatas.find( frameDataVersion.identifier );
     if( !data )
     {
         data = new FrameData;
         data->setID( frameDataVersion.identifier );
-        _impl->frameDatas.data[ frameDataVersion.identifier ] = data;
+        data->setImagePool( &_impl->imagePool );
+        data->setDecompressPool( &_impl->decompressPool );
+        data->setSharedImageArena( &_impl->sharedImageArena );
+        data = _impl->frameDatas.insert( data ); // may have lost a race
     }
 
     LBASSERT( frameDataVersion.version.high() == 0 );
@@ -252,13 +346,7 @@ FrameDataPtr Node::getFrameData( const co::ObjectVersion& frameDataVersion )
 
 void Node::releaseFrameData( FrameDataPtr data )
 {
-    lunchbox::ScopedWrite mutex( _impl->frameDatas );
-    FrameDataHashIter i = _impl->frameDatas->find( data->getID( ));
-    LBASSERT( i != _impl->frameDatas->end( ));
-    if( i == _impl->frameDatas->end( ))
-        return;
-
-    _impl->frameDatas->erase( i );
+    LBCHECK( _impl->frameDatas.erase( data->getID( )));
 }
 
 void Node::waitInitialized() const
@@ -288,27 +376,102 @@ bool Node::configExit()
     return true;
 }
 
+void Node::_startTransmitWorkers()
+{
+    // AUTO: enough for the destinations of a typical multi-GPU node, idle
+    // workers don't cost anything
+    size_t nWorkers = 4;
+    const int32_t threads = getIAttribute( IATTR_HINT_TRANSMIT_THREADS );
+    if( threads == OFF )
+        nWorkers = 0;
+    else if( threads > 0 )
+        nWorkers = threads;
+
+    _impl->transmitter.getQueue().startWorkers( nWorkers, _impl->affinity );
+}
+
 void Node::_setAffinity()
 {
-    const int32_t affinity = getIAttribute( IATTR_HINT_AFFINITY );
-    switch( affinity )
+    int32_t affinity = getIAttribute( IATTR_HINT_AFFINITY );
+    if( affinity == AUTO )
+        affinity = _getAutoAffinity();
+
+    _impl->affinity = affinity;
+    if( affinity == lunchbox::Thread::NONE )
+        return;
+
+    co::LocalNodePtr node = getLocalNode();
+    send( node, fabric::CMD_NODE_SET_AFFINITY ) << affinity;
+
+    node->setAffinity( affinity );
+}
+
+int32_t Node::_getAutoAffinity() const
+{
+#ifdef EQUALIZER_USE_HWLOC
+    hwloc_topology_t topology;
+    if( hwloc_topology_init( &topology ) < 0 )
     {
-        case OFF:
-            break;
+        LBINFO << "Automatic node thread placement failed: "
+               << "hwloc_topology_init() failed" << std::endl;
+        return lunchbox::Thread::NONE;
+    }
 
-        case AUTO:
-            // TODO
-            LBVERB << "No automatic thread placement for node threads "
-                   << std::endl;
-            break;
+    const unsigned long loading_flags = HWLOC_TOPOLOGY_FLAG_IO_BRIDGES |
+                                        HWLOC_TOPOLOGY_FLAG_IO_DEVICES;
+    if( hwloc_topology_set_flags( topology, loading_flags ) < 0 ||
+        hwloc_topology_load( topology ) < 0 )
+    {
+        LBINFO << "Automatic node thread placement failed: "
+               << "hwloc topology not loaded" << std::endl;
+        hwloc_topology_destroy( topology );
+        return lunchbox::Thread::NONE;
+    }
 
-        default:
-            co::LocalNodePtr node = getLocalNode();
-            send( node, fabric::CMD_NODE_SET_AFFINITY ) << affinity;
+    // Place on the socket of the first NIC attached to a single socket,
+    // preferring InfiniBand HCAs over ethernet devices
+    hwloc_obj_t nic = 0;
+    for( hwloc_obj_t osdev = hwloc_get_next_osdev( topology, 0 ); osdev;
+         osdev = hwloc_get_next_osdev( topology, osdev ))
+    {
+        const hwloc_obj_osdev_type_t type = osdev->attr->osdev.type;
+        if( type != HWLOC_OBJ_OSDEV_OPENFABRICS &&
+            type != HWLOC_OBJ_OSDEV_NETWORK )
+        {
+            continue;
+        }
+
+        const hwloc_obj_t parent =
+            hwloc_get_non_io_ancestor_obj( topology, osdev );
+        if( hwloc_get_nbobjs_inside_cpuset_by_type( topology, parent->cpuset,
+                                                    HWLOC_OBJ_SOCKET ) != 1 )
+        {
+            continue;
+        }
 
-            node->setAffinity( affinity );
+        if( !nic || type == HWLOC_OBJ_OSDEV_OPENFABRICS )
+            nic = parent;
+        if( type == HWLOC_OBJ_OSDEV_OPENFABRICS )
             break;
     }
+
+    int32_t affinity = lunchbox::Thread::NONE;
+    const hwloc_obj_t cpuObj = nic ?
+        hwloc_get_obj_inside_cpuset_by_type( topology, nic->cpuset,
+                                             HWLOC_OBJ_SOCKET, 0 ) : 0;
+    if( cpuObj )
+        affinity = cpuObj->logical_index + lunchbox::Thread::SOCKET;
+    else
+        LBINFO << "Automatic node thread placement failed: no NIC found"
+               << std::endl;
+
+    hwloc_topology_destroy( topology );
+    return affinity;
+#else
+    LBVERB << "No automatic thread placement for node threads, no hwloc "
+           << "support" << std::endl;
+    return lunchbox::Thread::NONE;
+#endif
 }
 
 void Node::waitFrameStarted( const uint32_t frameNumber ) const
@@ -391,6 +554,11 @@ void Node::releaseFrameLocal( const uint32_t frameNumber )
                        << std::endl;
 }
 
+void Node::syncObjects( const SyncObjects& objects )
+{
+    _impl->syncPool.sync( objects );
+}
+
 void Node::frameStart( const uint128_t&, const uint32_t frameNumber )
 {
     startFrame( frameNumber ); // unlock pipe threads
@@ -490,15 +658,16 @@ void Node::_flushObjects()
         _impl->barriers->clear();
     }
 
-    lunchbox::ScopedMutex<> mutex( _impl->frameDatas );
-    for( FrameDataHashCIter i = _impl->frameDatas->begin();
-         i != _impl->frameDatas->end(); ++i )
+    FrameDataVector frameDatas;
+    _impl->frameDatas.clear( frameDatas );
+    for( FrameDataVector::const_iterator i = frameDatas.begin();
+         i != frameDatas.end(); ++i )
     {
-        FrameDataPtr frameData = i->second;
+        FrameDataPtr frameData = *i;
         frameData->resetPlugins();
         client->unmapObject( frameData.get( ));
     }
-    _impl->frameDatas->clear();
+    _impl->imagePool.flush();
 }
 
 void detail::TransmitThread::run()
@@ -523,6 +692,7 @@ void Node::dirtyClientExit()
     }
     getTransmitterQueue()->push( co::ICommand( )); // wake up to exit
     _impl->transmitter.join();
+    _impl->transmitter.getQueue().stopWorkers();
 }
 
 //---------------------------------------------------------------------------
@@ -590,6 +760,9 @@ bool Node::_cmdConfigInit( co::ICommand& cmd )
     _setAffinity();
 
     _impl->transmitter.start();
+    _startTransmitWorkers();
+    if( !_impl->sharedImageArena.open( getLocalNode()->getNodeID( )))
+        LBINFO << "Transmitting all images over the network" << std::endl;
     const uint64_t result = configInit( initID );
 
     if( getIAttribute( IATTR_THREAD_MODEL ) == eq::UNDEFINED )
@@ -620,6 +793,8 @@ bool Node::_cmdConfigExit( co::ICommand& cmd )
     _impl->state = configExit() ? STATE_STOPPED : STATE_FAILED;
     getTransmitterQueue()->push( co::ICommand( )); // wake up to exit
     _impl->transmitter.join();
+    _impl->transmitter.getQueue().stopWorkers();
+    _impl->sharedImageArena.close();
     _flushObjects();
 
     getConfig()->send( getLocalNode(),
@@ -673,6 +848,10 @@ bool Node::_cmdFrameFinish( co::ICommand& cmd )
 
     _finishFrame( frameNumber );
     _frameFinish( frameID, frameNumber );
+    {
+        NodeStatistics event( Statistic::NODE_IMAGE_POOL, this, frameNumber );
+        _impl->imagePool.sample( event.event.data.statistic );
+    }
 
     const uint128_t version = commit();
     if( version != co::VERSION_NONE )
@@ -730,14 +909,12 @@ bool Node::_cmdFrameDataTransmit( co::ICommand& cmd )
     FrameDataPtr frameData = getFrameData( frameDataVersion );
     LBASSERT( !frameData->isReady() );
 
-    NodeStatistics event( Statistic::NODE_FRAME_DECOMPRESS, this,
-                          frameNumber );
-
     // Note on the const_cast: since the PixelData structure stores non-const
     // pointers, we have to go non-const at some point, even though we do not
     // modify the data.
     LBCHECK( frameData->addImage( frameDataVersion, pvp, zoom, buffers,
-                                  useAlpha, const_cast< uint8_t* >( data )));
+                                  useAlpha, const_cast< uint8_t* >( data ),
+                                  cmd, frameNumber ));
     return true;
 }
 
@@ -745,17 +922,22 @@ bool Node::_cmdFrameDataReady( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
 
-    const co::ObjectVersion& frameDataVersion =
-                                            command.read< co::ObjectVersion >();
-    const fabric::FrameData& data = command.read< fabric::FrameData >();
-
-    LBLOG( LOG_ASSEMBLY ) << "received ready for " << frameDataVersion
-                          << std::endl;
-    FrameDataPtr frameData = getFrameData( frameDataVersion );
-    LBASSERT( frameData );
-    LBASSERT( !frameData->isReady() );
-    frameData->setReady( frameDataVersion, data );
-    LBASSERT( frameData->isReady() );
+    // all frame datas set ready by one readback for this node
+    const uint32_t nFrames = command.read< uint32_t >();
+    for( uint32_t i = 0; i < nFrames; ++i )
+    {
+        const co::ObjectVersion& frameDataVersion =
+            command.read< co::ObjectVersion >();
+        const fabric::FrameData& data = command.read< fabric::FrameData >();
+
+        LBLOG( LOG_ASSEMBLY ) << "received ready for " << frameDataVersion
+                              << std::endl;
+        FrameDataPtr frameData = getFrameData( frameDataVersion );
+        LBASSERT( frameData );
+        LBASSERT( !frameData->isReady() );
+        frameData->setReady( frameDataVersion, data );
+        LBASSERT( frameData->isReady() );
+    }
     return true;
 }
 
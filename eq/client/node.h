@@ -142,6 +142,24 @@ public:
     /** @internal @sa Serializable::setDirty() */
     EQ_API virtual void setDirty( const uint64_t bits );
 
+    /** An object synchronized by syncObjects(). @version 1.8 */
+    struct SyncObject
+    {
+        SyncObject( co::Object* object_, const uint128_t& version_,
+                    const uint32_t group_ = 0 )
+            : object( object_ ), version( version_ ), group( group_ ) {}
+
+        co::Object* object; //!< the mapped slave object
+        uint128_t version; //!< the version to synchronize to
+
+        /**
+         * Objects of the same non-zero group are synchronized in order, for
+         * objects which depend on each other when applying their changes.
+         */
+        uint32_t group;
+    };
+    typedef std::vector< SyncObject > SyncObjects;
+
     /** @internal */
     EQ_API void dirtyClientExit();
 
@@ -174,6 +192,21 @@ protected:
      * @version 1.0
      */
     EQ_API void releaseFrameLocal( const uint32_t frameNumber );
+
+    /**
+     * Synchronize a set of objects in parallel.
+     *
+     * The objects are synchronized by a node-wide pool of threads, groups of
+     * dependent objects in order by one thread. Returns after all objects are
+     * synchronized. Typically called from frameStart() with the application
+     * objects and versions of the frame, so that the frame start does not
+     * scale with the number of objects. The objects must not be used by
+     * other threads during this call.
+     *
+     * @param objects the objects and versions to synchronize.
+     * @version 1.8
+     */
+    EQ_API void syncObjects( const SyncObjects& objects );
     //@}
 
     /**
@@ -264,6 +297,8 @@ private:
     detail::Node* const _impl;
 
     void _setAffinity();
+    int32_t _getAutoAffinity() const;
+    void _startTransmitWorkers();
 
     void _finishFrame( const uint32_t frameNumber ) const;
     void _frameFinish( const uint128_t& frameID,
@@ -36,6 +36,9 @@ NodeStatistics::NodeStatistics( const Statistic::Type type, Node* node,
                                 const uint32_t frameNumber )
         : StatisticSampler< Node >( type, node, frameNumber )
 {
+    if( !isEnabled( ))
+        return;
+
     const std::string& name = node->getName();
     if( name.empty( ))
         snprintf( event.data.statistic.resourceName, 32, "Node %s",
@@ -63,6 +66,9 @@ NodeStatistics::NodeStatistics( const Statistic::Type type, Node* node,
 
 NodeStatistics::~NodeStatistics()
 {
+    if( !isEnabled( ))
+        return;
+
     if( event.data.statistic.frameNumber == 0 ) // does not belong to a frame
         return;
 
@@ -21,11 +21,14 @@
 #include "client.h"
 #include "eventICommand.h"
 #include "server.h"
+#include "detail/latchedTracker.h"
 
 #include <eq/fabric/event.h>
 #include <eq/fabric/paths.h>
 #include <eq/fabric/commands.h>
 #include <co/bufferConnection.h>
+#include <lunchbox/lock.h>
+#include <lunchbox/scopedMutex.h>
 
 #ifdef EQUALIZER_USE_OPENCV
 #  include "detail/cvTracker.h"
@@ -50,10 +53,18 @@ public:
     Observer()
         : vrpnTracker( 0 )
         , cvTracker( 0 )
+        , latchedTracker( 0 )
+        , latchedPort( 0 )
     {}
 
+    ~Observer() { delete latchedTracker; }
+
     vrpn_Tracker_Remote *vrpnTracker;
     CVTracker* cvTracker;
+
+    lunchbox::Lock latchedLock;
+    LatchedTracker* latchedTracker;
+    int32_t latchedPort; //!< the port of the last latchedTracker opened
 };
 }
 
@@ -69,6 +80,27 @@ Observer::~Observer()
     delete _impl;
 }
 
+bool Observer::getLatchedHeadMatrix( Matrix4f& head ) const
+{
+    const int32_t port = getLatchPort();
+    if( port <= 0 || port > 0xffff )
+        return false;
+
+    lunchbox::ScopedMutex<> mutex( _impl->latchedLock );
+    if( _impl->latchedPort != port )
+    {
+        delete _impl->latchedTracker;
+        _impl->latchedTracker = new detail::LatchedTracker( uint16_t( port ));
+        _impl->latchedPort = port;
+        if( !_impl->latchedTracker->open( ))
+        {
+            delete _impl->latchedTracker;
+            _impl->latchedTracker = 0;
+        }
+    }
+    return _impl->latchedTracker && _impl->latchedTracker->getHeadMatrix(head);
+}
+
 ServerPtr Observer::getServer()
 {
     Config* config = getConfig();
@@ -61,6 +61,16 @@ namespace detail { class Observer; }
         //@{
         /** @return the Server of this observer. @version 1.0 */
         EQ_API ServerPtr getServer();
+
+        /**
+         * @internal
+         * Get the latest head matrix of the late-latched tracker.
+         *
+         * The tracker is started on first use if a latch port is set.
+         * Thread safe.
+         * @return true if a head matrix was received, false otherwise.
+         */
+        bool getLatchedHeadMatrix( Matrix4f& head ) const;
         //@}
 
         void addView( View* ) { /* nop */ } //!< @internal
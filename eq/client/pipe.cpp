@@ -36,6 +36,8 @@
 
 #include "messagePump.h"
 #include "systemPipe.h"
+#include "detail/frameCounter.h"
+#include "detail/topologyProfile.h"
 
 #include "computeContext.h"
 #ifdef EQUALIZER_USE_CUDA
@@ -46,12 +48,18 @@
 #include <eq/fabric/elementVisitor.h>
 #include <eq/fabric/leafVisitor.h>
 #include <eq/fabric/task.h>
+#include <eq/util/asyncLoader.h>
+#include <eq/util/objectManager.h>
 
 #include <co/global.h>
 #include <co/objectICommand.h>
 #include <co/queueSlave.h>
 #include <co/worker.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/spinLock.h>
+#include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
+#include <cmath>
 #include <sstream>
 
 #ifdef EQUALIZER_USE_HWLOC_GL
@@ -81,12 +89,25 @@ enum State
 typedef stde::hash_map< uint128_t, Frame* > FrameHash;
 typedef stde::hash_map< uint128_t, FrameDataPtr > FrameDataHash;
 typedef stde::hash_map< uint128_t, View* > ViewHash;
-typedef stde::hash_map< uint128_t, co::QueueSlave* > QueueHash;
+/** A mapped tile queue and the prefetch mark it was created with. */
+struct Queue
+{
+    Queue() : slave( 0 ), mark( 0 ) {}
+    co::QueueSlave* slave;
+    uint32_t mark;
+};
+
+typedef stde::hash_map< uint128_t, Queue > QueueHash;
+typedef stde::hash_map< uint128_t, uint32_t > MapRequestHash;
 typedef FrameHash::const_iterator FrameHashCIter;
 typedef FrameDataHash::const_iterator FrameDataHashCIter;
 typedef ViewHash::const_iterator ViewHashCIter;
 typedef ViewHash::iterator ViewHashIter;
 typedef QueueHash::const_iterator QueueHashCIter;
+typedef MapRequestHash::iterator MapRequestHashIter;
+
+/** The upper bound of the tuned tile prefetch, limits tile stealing. */
+const uint32_t _maxPrefetchMark = 16;
 }
 
 namespace detail
@@ -124,6 +145,7 @@ public:
     explicit TransferThread( const uint32_t index )
         : co::Worker( co::Global::getCommandQueueLimit( ))
         , _index( index )
+        , _affinity( lunchbox::Thread::NONE )
         , _stop( false )
     {}
 
@@ -133,14 +155,20 @@ public:
             return false;
         setName( std::string( "Tfer" ) +
                  boost::lexical_cast< std::string >( _index ));
+        if( _affinity != lunchbox::Thread::NONE )
+            lunchbox::Thread::setAffinity( _affinity );
         return true;
     }
 
     bool stopRunning() override { return _stop; }
     void postStop() { _stop = true; }
 
+    /** Set the affinity applied when the thread starts. */
+    void setThreadAffinity( const int32_t affinity ) { _affinity = affinity; }
+
 private:
     uint32_t _index;
+    int32_t _affinity;
     bool _stop; // thread will exit if this is true
 };
 
@@ -159,15 +187,23 @@ public:
         , state( STATE_STOPPED )
         , currentFrame( 0 )
         , frameTime( 0 )
+        , tileTime( 0.f )
+        , queueRTT( 0.f )
+        , prefetchMark( 0 )
+        , statisticsBudgetStart( 0 )
+        , statisticsBudgetUsed( 0 )
         , thread( 0 )
         , transferThread( index )
+        , affinity( lunchbox::Thread::NONE )
         , computeContext( 0 )
+        , asyncLoader( 0 )
     {}
 
     ~Pipe()
     {
         delete thread;
         thread = 0;
+        delete asyncLoader;
     }
 
     /** Window-system specific functions class */
@@ -183,10 +219,10 @@ public:
     uint32_t currentFrame;
 
     /** The number of the last finished frame. */
-    lunchbox::Monitor< uint32_t > finishedFrame;
+    FrameCounter finishedFrame;
 
     /** The number of the last locally unlocked frame. */
-    lunchbox::Monitor<uint32_t> unlockedFrame;
+    FrameCounter unlockedFrame;
 
     /** The running per-frame statistic clocks. */
     std::deque< int64_t > frameTimes;
@@ -210,13 +246,38 @@ public:
     /** All queues used by the pipe's channels during rendering. */
     QueueHash queues;
 
+    /** The smoothed tile render and queue round trip times, in ms. */
+    float tileTime;
+    float queueRTT;
+
+    /** The tuned prefetch mark of the queues, 0 for the Collage default. */
+    uint32_t prefetchMark;
+
+    /** Pending map requests of prefetched frames and views, by object ID. */
+    MapRequestHash mapRequests;
+
+    /** Statistics queued for the application, with originator serials. */
+    Statistics statistics;
+    std::vector< uint32_t > statisticSerials;
+    lunchbox::SpinLock statisticsLock;
+
+    /** Start time and number of statistics sent of the current second. */
+    int64_t statisticsBudgetStart;
+    size_t statisticsBudgetUsed;
+
     /** The pipe thread. */
     RenderThread* thread;
 
     detail::TransferThread transferThread;
 
+    /** The affinity of the pipe thread, also used by the transfer thread. */
+    int32_t affinity;
+
     /** GPU Computing context */
     ComputeContext *computeContext;
+
+    /** The resource loader, created by getAsyncLoader(). */
+    util::AsyncLoader* asyncLoader;
 };
 
 void RenderThread::run()
@@ -320,6 +381,10 @@ WindowSystem Pipe::selectWindowSystem() const
 #ifdef AGL
     return WindowSystem( "AGL" ); // prefer over GLX
 #elif GLX
+#  ifdef EQ_EGL_USED
+    if( !getenv( "DISPLAY" ))
+        return WindowSystem( "EGL" ); // headless, no X server
+#  endif
     return WindowSystem( "GLX" );
 #elif WGL
     return WindowSystem( "WGL" );
@@ -352,7 +417,6 @@ void Pipe::_setupCommandQueue()
 
 int32_t Pipe::_getAutoAffinity() const
 {
-#ifdef EQUALIZER_USE_HWLOC_GL
     uint32_t port = getPort();
     uint32_t device = getDevice();
 
@@ -364,6 +428,12 @@ int32_t Pipe::_getAutoAffinity() const
     if( device == LB_UNDEFINED_UINT32 )
         device = 0;
 
+    // measured bandwidths take precedence over the hwloc topology
+    const int32_t socket = detail::topologyProfile::getGPUSocket( port, device);
+    if( socket >= 0 )
+        return socket + lunchbox::Thread::SOCKET;
+
+#ifdef EQUALIZER_USE_HWLOC_GL
     hwloc_topology_t topology;
     if( hwloc_topology_init( &topology ) < 0 )
     {
@@ -438,18 +508,14 @@ int32_t Pipe::_getAutoAffinity() const
 
 void Pipe::_setupAffinity()
 {
-    const int32_t affinity = getIAttribute( IATTR_HINT_AFFINITY );
-    switch( affinity )
-    {
-        case AUTO:
-            lunchbox::Thread::setAffinity( _getAutoAffinity( ));
-            break;
+    // OpenMP threads created later by this thread inherit its affinity, and
+    // buffers first touched by the pinned threads are allocated NUMA-local.
+    int32_t affinity = getIAttribute( IATTR_HINT_AFFINITY );
+    if( affinity == AUTO )
+        affinity = _getAutoAffinity();
 
-        case OFF:
-        default:
-            lunchbox::Thread::setAffinity( affinity );
-            break;
-    }
+    _impl->affinity = affinity;
+    lunchbox::Thread::setAffinity( affinity );
 }
 
 void Pipe::_exitCommandQueue()
@@ -519,11 +585,17 @@ Frame* Pipe::getFrame( const co::ObjectVersion& frameVersion, const Eye eye,
         _impl->frames[ frameVersion.identifier ] = frame;
     }
     else
+    {
+        _syncPrefetch( frameVersion.identifier );
         frame->sync( frameVersion.version );
+    }
 
     const co::ObjectVersion& dataVersion = frame->getDataVersion( eye );
     LBLOG( LOG_ASSEMBLY ) << "Use " << dataVersion << std::endl;
 
+    // Deferred assemblies still read the previous version of the frame data
+    _flushAssemblies( dataVersion.identifier );
+
     FrameDataPtr frameData = getNode()->getFrameData( dataVersion );
     LBASSERT( frameData );
 
@@ -549,6 +621,8 @@ Frame* Pipe::getFrame( const co::ObjectVersion& frameVersion, const Eye eye,
 void Pipe::flushFrames( util::ObjectManager& om )
 {
     LB_TS_THREAD( _pipeThread );
+    _syncPrefetches();
+
     ClientPtr client = getClient();
     for( FrameHashCIter i = _impl->frames.begin(); i !=_impl->frames.end(); ++i)
     {
@@ -585,17 +659,70 @@ co::QueueSlave* Pipe::getQueue( const uint128_t& queueID )
     if( queueID == 0 )
         return 0;
 
-    co::QueueSlave* queue = _impl->queues[ queueID ];
-    if( !queue )
+    ClientPtr client = getClient();
+    detail::Queue& queue = _impl->queues[ queueID ];
+    if( queue.slave && queue.mark != _impl->prefetchMark )
     {
-        queue = new co::QueueSlave;
-        ClientPtr client = getClient();
-        LBCHECK( client->mapObject( queue, queueID ));
+        // Channels drain their queues completely, no tiles are lost
+        client->unmapObject( queue.slave );
+        delete queue.slave;
+        queue.slave = 0;
+    }
+
+    if( !queue.slave )
+    {
+        const uint32_t mark = _impl->prefetchMark;
+        if( mark == 0 )
+            queue.slave = new co::QueueSlave;
+        else
+        {
+            const uint32_t refill = co::Global::getIAttribute(
+                co::Global::IATTR_QUEUE_REFILL );
+            queue.slave = new co::QueueSlave( mark,
+                                              LB_MAX( mark * 2, refill ));
+        }
+        queue.mark = mark;
+        LBCHECK( client->mapObject( queue.slave, queueID ));
+    }
+
+    return queue.slave;
+}
+
+void Pipe::updateTilePrefetch( const float tileTime, const float queueRTT )
+{
+    LB_TS_THREAD( _pipeThread );
+    if( tileTime <= 0.f )
+        return;
 
-        _impl->queues[ queueID ] = queue;
+    if( _impl->tileTime == 0.f )
+    {
+        _impl->tileTime = tileTime;
+        _impl->queueRTT = queueRTT;
+    }
+    else
+    {
+        _impl->tileTime = .8f * _impl->tileTime + .2f * tileTime;
+        _impl->queueRTT = .8f * _impl->queueRTT + .2f * queueRTT;
     }
 
-    return queue;
+    // Keep enough tiles prefetched to render while a refill is in flight
+    const uint32_t minMark = co::Global::getIAttribute(
+        co::Global::IATTR_QUEUE_MIN_SIZE );
+    uint32_t mark = uint32_t( std::ceil( _impl->queueRTT /
+                                         _impl->tileTime )) + 1;
+    mark = LB_MIN( LB_MAX( mark, minMark ), _maxPrefetchMark );
+
+    // Hysteresis: each change re-maps the queues
+    const uint32_t current = _impl->prefetchMark;
+    if( current == 0 || mark > current + current / 4 ||
+        mark + mark / 4 < current )
+    {
+        LBLOG( LOG_TASKS ) << "Tile prefetch mark " << current << " -> "
+                           << mark << ", tile " << _impl->tileTime
+                           << " ms, round trip " << _impl->queueRTT << " ms"
+                           << std::endl;
+        _impl->prefetchMark = mark;
+    }
 }
 
 void Pipe::_flushQueues()
@@ -605,7 +732,7 @@ void Pipe::_flushQueues()
 
     for( QueueHashCIter i = _impl->queues.begin(); i !=_impl->queues.end(); ++i)
     {
-        co::QueueSlave* queue = i->second;
+        co::QueueSlave* queue = i->second.slave;
         client->unmapObject( queue );
         delete queue;
     }
@@ -637,14 +764,77 @@ View* Pipe::getView( const co::ObjectVersion& viewVersion )
 
         _impl->views[ viewVersion.identifier ] = view;
     }
+    else
+        _syncPrefetch( viewVersion.identifier );
 
     view->sync( viewVersion.version );
     return view;
 }
 
+void Pipe::_prefetch( const co::ObjectVersions& frames,
+                      const co::ObjectVersions& views )
+{
+    LB_TS_THREAD( _pipeThread );
+    ClientPtr client = getClient();
+
+    // Issue all map requests at once and finish them on first use, so that
+    // the round trips overlap with each other and with the frame's tasks.
+    BOOST_FOREACH( const co::ObjectVersion& frameVersion, frames )
+    {
+        Frame*& frame = _impl->frames[ frameVersion.identifier ];
+        if( frame )
+            continue;
+
+        frame = new Frame();
+        _impl->mapRequests[ frameVersion.identifier ] =
+            client->mapObjectNB( frame, frameVersion.identifier,
+                                 frameVersion.version );
+    }
+
+    NodeFactory* nodeFactory = Global::getNodeFactory();
+    BOOST_FOREACH( const co::ObjectVersion& viewVersion, views )
+    {
+        View*& view = _impl->views[ viewVersion.identifier ];
+        if( view )
+            continue;
+
+        view = nodeFactory->createView( 0 );
+        LBASSERT( view );
+        view->_pipe = this;
+        _impl->mapRequests[ viewVersion.identifier ] =
+            client->mapObjectNB( view, viewVersion.identifier,
+                                 viewVersion.version );
+    }
+}
+
+void Pipe::_syncPrefetch( const uint128_t& id )
+{
+    LB_TS_THREAD( _pipeThread );
+    MapRequestHashIter i = _impl->mapRequests.find( id );
+    if( i == _impl->mapRequests.end( ))
+        return;
+
+    ClientPtr client = getClient();
+    LBCHECK( client->mapObjectSync( i->second ));
+    _impl->mapRequests.erase( i );
+}
+
+void Pipe::_syncPrefetches()
+{
+    LB_TS_THREAD( _pipeThread );
+    ClientPtr client = getClient();
+    for( MapRequestHashIter i = _impl->mapRequests.begin();
+         i != _impl->mapRequests.end(); ++i )
+    {
+        LBCHECK( client->mapObjectSync( i->second ));
+    }
+    _impl->mapRequests.clear();
+}
+
 void Pipe::_releaseViews()
 {
     LB_TS_THREAD( _pipeThread );
+    _syncPrefetches();
     for( bool changed = true; changed; )
     {
         changed = false;
@@ -674,6 +864,7 @@ void Pipe::_releaseViews()
 void Pipe::_flushViews()
 {
     LB_TS_THREAD( _pipeThread );
+    _syncPrefetches();
     NodeFactory* nodeFactory = Global::getNodeFactory();
     ClientPtr client = getClient();
 
@@ -794,11 +985,114 @@ EventOCommand Pipe::sendError( const uint32_t error )
 
 bool Pipe::processEvent( const Event& event )
 {
+    if( event.type == Event::STATISTIC )
+    {
+        addStatistic( event );
+        return true;
+    }
+
     ConfigEvent configEvent( event );
     getConfig()->sendEvent( configEvent );
     return true;
 }
 
+void Pipe::addStatistic( const Event& event )
+{
+    LBASSERT( event.type == Event::STATISTIC );
+    lunchbox::ScopedFastWrite mutex( _impl->statisticsLock );
+    _impl->statistics.push_back( event.statistic );
+    _impl->statisticSerials.push_back( event.serial );
+}
+
+void Pipe::_updateGPUMemory()
+{
+    std::vector< const util::ObjectManager* > objectManagers;
+    uint64_t usedBytes = 0;
+    uint64_t freeBytes = 0;
+
+    const Windows& windows = getWindows();
+    for( Windows::const_iterator i = windows.begin(); i != windows.end(); ++i )
+    {
+        Window* window = *i;
+        if( !window->isRunning() || !window->getSystemWindow( ))
+            continue;
+
+        util::ObjectManager& objectManager = window->getObjectManager();
+        bool shared = false;
+        for( size_t j = 0; j < objectManagers.size() && !shared; ++j )
+            shared = objectManager.isSharedWith( *objectManagers[j] );
+        if( shared )
+            continue;
+        objectManagers.push_back( &objectManager );
+
+        window->makeCurrent();
+        objectManager.enforceMemoryBudget();
+        usedBytes += objectManager.getUsedMemory();
+        if( freeBytes == 0 ) // all windows of a pipe share one GPU
+            freeBytes = objectManager.getFreeMemory();
+    }
+
+    if( objectManagers.empty( ))
+        return;
+
+    PipeStatistics event( Statistic::PIPE_GPU_MEMORY, this );
+    event.event.data.statistic.gpuUsedBytes = usedBytes;
+    event.event.data.statistic.gpuFreeBytes = freeBytes;
+}
+
+void Pipe::_flushStatistics()
+{
+    Statistics statistics;
+    std::vector< uint32_t > serials;
+    {
+        lunchbox::ScopedFastWrite mutex( _impl->statisticsLock );
+        statistics.swap( _impl->statistics );
+        serials.swap( _impl->statisticSerials );
+    }
+
+    Config* config = getConfig();
+    const int32_t interval =
+        config->getIAttribute( Config::IATTR_STATISTICS_INTERVAL );
+    if( statistics.empty() || interval == OFF )
+        return;
+
+    // Sample complete frames, so that all pipes send the same frames
+    if( interval > 1 )
+    {
+        size_t used = 0;
+        for( size_t i = 0; i < statistics.size(); ++i )
+        {
+            if( statistics[i].frameNumber % uint32_t( interval ) != 0 )
+                continue;
+            statistics[ used ] = statistics[i];
+            serials[ used ] = serials[i];
+            ++used;
+        }
+        if( used == 0 )
+            return;
+        statistics.resize( used );
+        serials.resize( used );
+    }
+
+    // Drop whole batches once the budget of the current second is used up
+    const int32_t budget =
+        config->getIAttribute( Config::IATTR_STATISTICS_BUDGET );
+    if( budget > 0 )
+    {
+        const int64_t time = config->getTime();
+        if( time - _impl->statisticsBudgetStart >= 1000 )
+        {
+            _impl->statisticsBudgetStart = time;
+            _impl->statisticsBudgetUsed = 0;
+        }
+        if( _impl->statisticsBudgetUsed + statistics.size() > size_t( budget ))
+            return;
+        _impl->statisticsBudgetUsed += statistics.size();
+    }
+
+    config->sendEvent( Event::STATISTIC ) << serials << statistics;
+}
+
 //---------------------------------------------------------------------------
 // pipe-thread methods
 //---------------------------------------------------------------------------
@@ -968,6 +1262,7 @@ bool Pipe::startTransferThread()
     if( _impl->transferThread.isRunning( ))
         return true;
 
+    _impl->transferThread.setThreadAffinity( _impl->affinity );
     return _impl->transferThread.start();
 }
 
@@ -976,6 +1271,17 @@ bool Pipe::hasTransferThread() const
     return _impl->transferThread.isRunning();
 }
 
+void Pipe::_flushAssemblies( const uint128_t& frameDataID )
+{
+    const Windows& windows = getWindows();
+    for( WindowsCIter i = windows.begin(); i != windows.end(); ++i )
+    {
+        const Channels& channels = (*i)->getChannels();
+        for( ChannelsCIter j = channels.begin(); j != channels.end(); ++j )
+            (*j)->flushAssembly( frameDataID );
+    }
+}
+
 void Pipe::_stopTransferThread()
 {
     if( _impl->transferThread.isStopped( ))
@@ -1015,6 +1321,42 @@ ComputeContext* Pipe::getComputeContext()
     return _impl->computeContext;
 }
 
+util::AsyncLoader* Pipe::getAsyncLoader()
+{
+    LB_TS_THREAD( _pipeThread );
+    if( _impl->asyncLoader )
+        return _impl->asyncLoader;
+
+    const Windows& windows = getWindows();
+    for( Windows::const_iterator i = windows.begin(); i != windows.end(); ++i )
+    {
+        Window* window = *i;
+        if( !window->getSystemWindow( ))
+            continue;
+
+        util::AsyncLoader* loader = new util::AsyncLoader;
+        if( loader->start( window ))
+        {
+            _impl->asyncLoader = loader;
+            return loader;
+        }
+        delete loader;
+        return 0;
+    }
+    return 0;
+}
+
+void Pipe::exitAsyncLoader( const Window* window )
+{
+    util::AsyncLoader* loader = _impl->asyncLoader;
+    if( !loader || loader->getWindow() != window )
+        return;
+
+    loader->stop();
+    delete loader;
+    _impl->asyncLoader = 0;
+}
+
 //---------------------------------------------------------------------------
 // command handlers
 //---------------------------------------------------------------------------
@@ -1142,6 +1484,7 @@ bool Pipe::_cmdConfigExit( co::ICommand& cmd )
     // - configExit can't access views since all channels are gone already
     _flushViews();
     _flushQueues();
+    _flushStatistics();
     _impl->state = configExit() ? STATE_STOPPED : STATE_FAILED;
     return true;
 }
@@ -1176,6 +1519,8 @@ bool Pipe::_cmdFrameStart( co::ICommand& cmd )
     const uint128_t& version = command.read< uint128_t >();
     const uint128_t& frameID = command.read< uint128_t >();
     const uint32_t frameNumber = command.read< uint32_t >();
+    const co::ObjectVersions& frames = command.read< co::ObjectVersions >();
+    const co::ObjectVersions& views = command.read< co::ObjectVersions >();
 
     LBVERB << "handle pipe frame start " << command << " frame " << frameNumber
            << " id " << frameID << std::endl;
@@ -1183,6 +1528,7 @@ bool Pipe::_cmdFrameStart( co::ICommand& cmd )
     LBLOG( LOG_TASKS ) << "---- TASK start frame ---- frame " << frameNumber
                        << " id " << frameID << std::endl;
     sync( version );
+    _prefetch( frames, views );
     const int64_t lastFrameTime = _impl->frameTime;
 
     _impl->frameTimeMutex.set();
@@ -1243,6 +1589,8 @@ bool Pipe::_cmdFrameFinish( co::ICommand& cmd )
     }
 
     _releaseViews();
+    _updateGPUMemory();
+    _flushStatistics();
 
     const uint128_t version = commit();
     if( version != co::VERSION_NONE )
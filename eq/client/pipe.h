@@ -127,6 +127,14 @@ public:
     /** @internal @return the queue for the given identifier and version. */
     co::QueueSlave* getQueue( const uint128_t& queueID );
 
+    /**
+     * @internal Tune the prefetch of the tile queues.
+     *
+     * @param tileTime the average render time of one tile, in ms.
+     * @param queueRTT the average round trip time to a queue master, in ms.
+     */
+    void updateTilePrefetch( float tileTime, float queueRTT );
+
     /** @internal Clear the frame cache and delete all frames. */
     void flushFrames( util::ObjectManager& om );
 
@@ -179,6 +187,16 @@ public:
      */
     EQ_API virtual bool processEvent( const Event& event );
 
+    /**
+     * @internal
+     * Queue a statistic event of this pipe, its windows or channels.
+     *
+     * The queued statistics are sent to the application in one event per
+     * frame, sampled according to the config statistics attributes. Thread
+     * safe.
+     */
+    void addStatistic( const Event& event );
+
     /** @internal Start the pipe thread. */
     void startThread();
 
@@ -229,6 +247,21 @@ public:
     EQ_API ComputeContext* getComputeContext();
     //@}
 
+    /**
+     * Get the asynchronous resource loader of this pipe.
+     *
+     * The loader is started on first use, with an upload context shared with
+     * the first initialized window of this pipe, and stopped when this window
+     * exits. To be called from the pipe thread.
+     *
+     * @return the loader, or 0 if it can't be started.
+     * @version 1.8
+     */
+    EQ_API util::AsyncLoader* getAsyncLoader();
+
+    /** @internal Stop the async loader if it shares the window's context. */
+    void exitAsyncLoader( const Window* window );
+
     /** @name Configuration. */
     //@{
     /**
@@ -389,9 +422,28 @@ private:
 
     void _stopTransferThread();
 
+    /** @internal Run the deferred assemblies reading the given frame data. */
+    void _flushAssemblies( const uint128_t& frameDataID );
+
+    /** @internal Start mapping the given frames and views, if needed. */
+    void _prefetch( const co::ObjectVersions& frames,
+                    const co::ObjectVersions& views );
+
+    /** @internal Finish the pending prefetch of the given object. */
+    void _syncPrefetch( const uint128_t& id );
+
+    /** @internal Finish all pending prefetches. */
+    void _syncPrefetches();
+
     /** @internal Release the views not used for some revisions. */
     void _releaseViews();
 
+    /** Send the queued statistics to the application. */
+    void _flushStatistics();
+
+    /** Enforce the memory budgets and sample the GPU memory of the windows. */
+    void _updateGPUMemory();
+
     /** @internal Clear the view cache and release all views. */
     void _flushViews();
 
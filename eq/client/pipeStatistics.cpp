@@ -34,6 +34,9 @@ namespace eq
 PipeStatistics::PipeStatistics( const Statistic::Type type, Pipe* pipe )
         : StatisticSampler< Pipe >( type, pipe )
 {
+    if( !isEnabled( ))
+        return;
+
     const std::string& name = pipe->getName();
     if( name.empty( ))
         snprintf( event.data.statistic.resourceName, 32, "Pipe %s",
@@ -48,11 +51,8 @@ PipeStatistics::PipeStatistics( const Statistic::Type type, Pipe* pipe )
 
 PipeStatistics::~PipeStatistics()
 {
-#if 0
-    const int32_t hint = _owner->getIAttribute( Pipe::IATTR_HINT_STATISTICS);
-    if( hint == OFF )
+    if( !isEnabled( ))
         return;
-#endif
 
     if( event.data.statistic.frameNumber == 0 ) // does not belong to a frame
         return;
@@ -42,6 +42,7 @@ void PixelData::reset()
     compressedData = pression::CompressorResult();
     compressorName = EQ_COMPRESSOR_INVALID;
     compressorFlags = 0;
+    spans.clear();
 }
 
 }
@@ -27,6 +27,8 @@
 
 #include <pression/compressorResult.h>          // member
 
+#include <vector>                               // member
+
 namespace eq
 {
 /** The pixel data structure manages the pixel information for images. */
@@ -91,6 +93,19 @@ struct PixelData : public boost::noncopyable
     uint32_t compressorName;
 
     uint32_t compressorFlags; //!< Flags used for compression. @version 1.0
+
+    /**
+     * The optional table of active spans of sparse pixel data.
+     *
+     * Empty if all pixels are active. Otherwise pixels outside the spans are
+     * background, and only the active pixels are transmitted and composited.
+     * For pvp.h rows, the table starts with pvp.h+1 offsets, followed by the
+     * begin and end column of each span. The spans of row y are the pairs
+     * starting at index pvp.h+1+spans[y] up to pvp.h+1+spans[y+1].
+     * @sa Image::computeSpans()
+     * @version 1.8
+     */
+    std::vector< uint32_t > spans;
 };
 };
 #endif // EQ_PIXELDATA_H
@@ -20,11 +20,94 @@
 #include "window.h"
 #include "windowEvent.h"
 
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QResizeEvent>
+#include <QWheelEvent>
 
 namespace eq
 {
 namespace qt
 {
+namespace
+{
+uint32_t _getKey( const QKeyEvent& keyEvent )
+{
+    switch( keyEvent.key( ))
+    {
+    case Qt::Key_Escape:    return KC_ESCAPE;
+    case Qt::Key_Backspace: return KC_BACKSPACE;
+    case Qt::Key_Return:    return KC_RETURN;
+    case Qt::Key_Tab:       return KC_TAB;
+    case Qt::Key_Home:      return KC_HOME;
+    case Qt::Key_Left:      return KC_LEFT;
+    case Qt::Key_Up:        return KC_UP;
+    case Qt::Key_Right:     return KC_RIGHT;
+    case Qt::Key_Down:      return KC_DOWN;
+    case Qt::Key_PageUp:    return KC_PAGE_UP;
+    case Qt::Key_PageDown:  return KC_PAGE_DOWN;
+    case Qt::Key_End:       return KC_END;
+    case Qt::Key_F1:        return KC_F1;
+    case Qt::Key_F2:        return KC_F2;
+    case Qt::Key_F3:        return KC_F3;
+    case Qt::Key_F4:        return KC_F4;
+    case Qt::Key_F5:        return KC_F5;
+    case Qt::Key_F6:        return KC_F6;
+    case Qt::Key_F7:        return KC_F7;
+    case Qt::Key_F8:        return KC_F8;
+    case Qt::Key_F9:        return KC_F9;
+    case Qt::Key_F10:       return KC_F10;
+    case Qt::Key_F11:       return KC_F11;
+    case Qt::Key_F12:       return KC_F12;
+    case Qt::Key_F13:       return KC_F13;
+    case Qt::Key_F14:       return KC_F14;
+    case Qt::Key_F15:       return KC_F15;
+    case Qt::Key_F16:       return KC_F16;
+    case Qt::Key_F17:       return KC_F17;
+    case Qt::Key_F18:       return KC_F18;
+    case Qt::Key_F19:       return KC_F19;
+    case Qt::Key_F20:       return KC_F20;
+    case Qt::Key_F21:       return KC_F21;
+    case Qt::Key_F22:       return KC_F22;
+    case Qt::Key_F23:       return KC_F23;
+    case Qt::Key_F24:       return KC_F24;
+    case Qt::Key_Shift:     return KC_SHIFT_L;
+    case Qt::Key_Control:   return KC_CONTROL_L;
+    case Qt::Key_Alt:       return KC_ALT_L;
+    case Qt::Key_AltGr:     return KC_ALT_R;
+    case Qt::Key_unknown:   return KC_VOID;
+    default:
+        if( keyEvent.text().isEmpty( ))
+            return KC_VOID;
+        return keyEvent.text().at( 0 ).unicode();
+    }
+}
+
+// Qt buttons 2 & 3 are inversed with EQ (X11/AGL/WGL)
+uint32_t _getButtons( const Qt::MouseButtons& eventButtons )
+{
+    if( (eventButtons & (Qt::MidButton | Qt::RightButton)) ==
+                                             (Qt::MidButton | Qt::RightButton) )
+    {
+        return eventButtons;
+    }
+
+    uint32_t buttons = eventButtons;
+    if( eventButtons & Qt::MidButton || eventButtons & Qt::RightButton )
+        buttons ^= PTR_BUTTON2 | PTR_BUTTON3;
+    return buttons;
+}
+
+uint32_t _getButton( const Qt::MouseButton button )
+{
+    if( button == Qt::RightButton )
+        return PTR_BUTTON2;
+    if( button == Qt::MidButton )
+        return PTR_BUTTON3;
+    return button;
+}
+}
+
 
 EventHandler::EventHandler( WindowIF& window )
     : _window( window )
@@ -35,6 +118,115 @@ EventHandler::~EventHandler()
 {
 }
 
+WindowEvent* EventHandler::translateEvent( QEvent* qevent )
+{
+    WindowEvent* windowEvent = 0;
+    switch( qevent->type( ))
+    {
+    case QEvent::Resize:
+    {
+        const QResizeEvent* resizeEvent =
+            static_cast< QResizeEvent* >( qevent );
+        windowEvent = new WindowEvent;
+        windowEvent->eq::Event::type = Event::WINDOW_RESIZE;
+        windowEvent->resize.w = resizeEvent->size().width();
+        windowEvent->resize.h = resizeEvent->size().height();
+        return windowEvent;
+    }
+
+    case QEvent::Close:
+        windowEvent = new WindowEvent;
+        windowEvent->eq::Event::type = Event::WINDOW_CLOSE;
+        return windowEvent;
+
+    case QEvent::Expose:
+    case QEvent::Paint:
+        windowEvent = new WindowEvent;
+        windowEvent->eq::Event::type = Event::WINDOW_EXPOSE;
+        return windowEvent;
+
+    case QEvent::MouseButtonPress:
+    {
+        const QMouseEvent* mouseEvent = static_cast< QMouseEvent* >( qevent );
+        windowEvent = new WindowEvent;
+        windowEvent->eq::Event::type = Event::WINDOW_POINTER_BUTTON_PRESS;
+        windowEvent->pointerButtonPress.x = mouseEvent->x();
+        windowEvent->pointerButtonPress.y = mouseEvent->y();
+        windowEvent->pointerButtonPress.buttons =
+            _getButtons( mouseEvent->buttons( ));
+        windowEvent->pointerButtonPress.button =
+            _getButton( mouseEvent->button( ));
+        return windowEvent;
+    }
+
+    case QEvent::MouseButtonRelease:
+    {
+        const QMouseEvent* mouseEvent = static_cast< QMouseEvent* >( qevent );
+        windowEvent = new WindowEvent;
+        windowEvent->eq::Event::type = Event::WINDOW_POINTER_BUTTON_RELEASE;
+        windowEvent->pointerButtonRelease.x = mouseEvent->x();
+        windowEvent->pointerButtonRelease.y = mouseEvent->y();
+        windowEvent->pointerButtonRelease.buttons =
+            _getButtons( mouseEvent->buttons( ));
+        windowEvent->pointerButtonRelease.button =
+            _getButton( mouseEvent->button( ));
+        return windowEvent;
+    }
+
+    case QEvent::MouseMove:
+    {
+        const QMouseEvent* mouseEvent = static_cast< QMouseEvent* >( qevent );
+        windowEvent = new WindowEvent;
+        windowEvent->eq::Event::type = Event::WINDOW_POINTER_MOTION;
+        windowEvent->pointerMotion.x = mouseEvent->x();
+        windowEvent->pointerMotion.y = mouseEvent->y();
+        windowEvent->pointerMotion.buttons =
+            _getButtons( mouseEvent->buttons( ));
+        windowEvent->pointerMotion.button = _getButton( mouseEvent->button( ));
+        return windowEvent;
+    }
+
+#ifndef QT_NO_WHEELEVENT
+    case QEvent::Wheel:
+    {
+        const QWheelEvent* wheelEvent = static_cast< QWheelEvent* >( qevent );
+        windowEvent = new WindowEvent;
+        windowEvent->eq::Event::type = Event::WINDOW_POINTER_WHEEL;
+        switch( wheelEvent->orientation( ))
+        {
+        case Qt::Horizontal:
+            windowEvent->pointerWheel.xAxis = wheelEvent->delta() > 0 ? 1 : -1;
+            break;
+        case Qt::Vertical:
+            windowEvent->pointerWheel.yAxis = wheelEvent->delta() > 0 ? 1 : -1;
+            break;
+        }
+        windowEvent->pointerWheel.buttons =
+            _getButtons( wheelEvent->buttons( ));
+        windowEvent->pointerWheel.button = PTR_BUTTON_NONE;
+        return windowEvent;
+    }
+#endif
+
+    case QEvent::KeyPress:
+        windowEvent = new WindowEvent;
+        windowEvent->eq::Event::type = Event::KEY_PRESS;
+        windowEvent->keyPress.key =
+            _getKey( *static_cast< QKeyEvent* >( qevent ));
+        return windowEvent;
+
+    case QEvent::KeyRelease:
+        windowEvent = new WindowEvent;
+        windowEvent->eq::Event::type = Event::KEY_RELEASE;
+        windowEvent->keyRelease.key =
+            _getKey( *static_cast< QKeyEvent* >( qevent ));
+        return windowEvent;
+
+    default:
+        return 0;
+    }
+}
+
 bool EventHandler::event( QEvent* evt )
 {
     if( evt->type() != QEvent::User )
@@ -38,6 +38,13 @@ public:
     /** Destruct the Qt event handler. @version  1.7.3 */
     ~EventHandler() final;
 
+    /**
+     * @return a new window event for the given Qt event, or 0 if the event
+     *         type is not handled.
+     * @version 1.9
+     */
+    static WindowEvent* translateEvent( QEvent* qevent );
+
 private:
     bool event( QEvent* evt ) override;
 
@@ -23,7 +23,9 @@
 #include "windowEvent.h"
 
 #include <QApplication>
-#include <QKeyEvent>
+#include <QThread>
+
+#include <cstdlib>
 
 
 namespace eq
@@ -31,89 +33,12 @@ namespace eq
 namespace qt
 {
 
-namespace
-{
-uint32_t _getKey( const QKeyEvent& keyEvent )
-{
-    switch( keyEvent.key( ))
-    {
-    case Qt::Key_Escape:    return KC_ESCAPE;
-    case Qt::Key_Backspace: return KC_BACKSPACE;
-    case Qt::Key_Return:    return KC_RETURN;
-    case Qt::Key_Tab:       return KC_TAB;
-    case Qt::Key_Home:      return KC_HOME;
-    case Qt::Key_Left:      return KC_LEFT;
-    case Qt::Key_Up:        return KC_UP;
-    case Qt::Key_Right:     return KC_RIGHT;
-    case Qt::Key_Down:      return KC_DOWN;
-    case Qt::Key_PageUp:    return KC_PAGE_UP;
-    case Qt::Key_PageDown:  return KC_PAGE_DOWN;
-    case Qt::Key_End:       return KC_END;
-    case Qt::Key_F1:        return KC_F1;
-    case Qt::Key_F2:        return KC_F2;
-    case Qt::Key_F3:        return KC_F3;
-    case Qt::Key_F4:        return KC_F4;
-    case Qt::Key_F5:        return KC_F5;
-    case Qt::Key_F6:        return KC_F6;
-    case Qt::Key_F7:        return KC_F7;
-    case Qt::Key_F8:        return KC_F8;
-    case Qt::Key_F9:        return KC_F9;
-    case Qt::Key_F10:       return KC_F10;
-    case Qt::Key_F11:       return KC_F11;
-    case Qt::Key_F12:       return KC_F12;
-    case Qt::Key_F13:       return KC_F13;
-    case Qt::Key_F14:       return KC_F14;
-    case Qt::Key_F15:       return KC_F15;
-    case Qt::Key_F16:       return KC_F16;
-    case Qt::Key_F17:       return KC_F17;
-    case Qt::Key_F18:       return KC_F18;
-    case Qt::Key_F19:       return KC_F19;
-    case Qt::Key_F20:       return KC_F20;
-    case Qt::Key_F21:       return KC_F21;
-    case Qt::Key_F22:       return KC_F22;
-    case Qt::Key_F23:       return KC_F23;
-    case Qt::Key_F24:       return KC_F24;
-    case Qt::Key_Shift:     return KC_SHIFT_L;
-    case Qt::Key_Control:   return KC_CONTROL_L;
-    case Qt::Key_Alt:       return KC_ALT_L;
-    case Qt::Key_AltGr:     return KC_ALT_R;
-    case Qt::Key_unknown:   return KC_VOID;
-    default:
-        if( keyEvent.text().isEmpty( ))
-            return KC_VOID;
-        return keyEvent.text().at( 0 ).unicode();
-    }
-}
-
-// Qt buttons 2 & 3 are inversed with EQ (X11/AGL/WGL)
-uint32_t _getButtons( const Qt::MouseButtons& eventButtons )
-{
-    if( (eventButtons & (Qt::MidButton | Qt::RightButton)) ==
-                                             (Qt::MidButton | Qt::RightButton) )
-    {
-        return eventButtons;
-    }
-
-    uint32_t buttons = eventButtons;
-    if( eventButtons & Qt::MidButton || eventButtons & Qt::RightButton )
-        buttons ^= PTR_BUTTON2 | PTR_BUTTON3;
-    return buttons;
-}
-
-uint32_t _getButton( const Qt::MouseButton button )
-{
-    if( button == Qt::RightButton )
-        return PTR_BUTTON2;
-    if( button == Qt::MidButton )
-        return PTR_BUTTON3;
-    return button;
-}
-}
-
 GLWidget::GLWidget( const QGLFormat& format_, const QGLWidget* shareWidget )
     : QGLWidget( format_, 0, shareWidget )
     , _parent( 0 )
     , _eventHandler( 0 )
+    , _inputHandler( 0 )
+    , _eventThread( 0 )
 {
     setAutoBufferSwap( false );
 }
@@ -131,124 +56,96 @@ void GLWidget::setParent( qt::Window* parent_ )
 
 void GLWidget::initEventHandler()
 {
-    if( _parent )
-        _eventHandler = new EventHandler( *_parent );
+    if( !_parent )
+        return;
+
+    _eventHandler = new EventHandler( *_parent );
+    if( !getenv( "EQ_WINDOW_EVENT_THREAD" ))
+        return;
+
+    // input events are processed by the event loop of a dedicated thread,
+    // independent of the rendering of the pipe thread
+    _eventThread = new QThread;
+    _inputHandler = new EventHandler( *_parent );
+    _inputHandler->moveToThread( _eventThread );
+    _eventThread->start();
 }
 
 void GLWidget::exitEventHandler()
 {
+    if( _eventThread )
+    {
+        _eventThread->quit();
+        _eventThread->wait();
+        delete _eventThread;
+        _eventThread = 0;
+    }
+    delete _inputHandler;
+    _inputHandler = 0;
+
     delete _eventHandler;
     _eventHandler = 0;
 }
 
-void GLWidget::resizeEvent( QResizeEvent* qevent )
+EventHandler* GLWidget::_getInputHandler()
 {
-    if( !_eventHandler )
-        return;
-    WindowEvent* windowEvent = new WindowEvent;
-    windowEvent->eq::Event::type = Event::WINDOW_RESIZE;
-    windowEvent->resize.w = qevent->size().width();
-    windowEvent->resize.h = qevent->size().height();
-    QApplication::postEvent( _eventHandler, windowEvent );
+    return _inputHandler ? _inputHandler : _eventHandler;
 }
 
-void GLWidget::closeEvent( QCloseEvent* )
+void GLWidget::_post( QEvent* qevent, EventHandler* handler )
 {
     if( !_eventHandler )
         return;
-    WindowEvent* windowEvent = new WindowEvent;
-    windowEvent->eq::Event::type = Event::WINDOW_CLOSE;
-    QApplication::postEvent( _eventHandler, windowEvent );
+    WindowEvent* windowEvent = EventHandler::translateEvent( qevent );
+    if( windowEvent )
+        QApplication::postEvent( handler, windowEvent );
 }
 
-void GLWidget::paintEvent( QPaintEvent* )
+void GLWidget::resizeEvent( QResizeEvent* qevent )
 {
-    if( !_eventHandler )
-        return;
-    WindowEvent* windowEvent = new WindowEvent;
-    windowEvent->eq::Event::type = Event::WINDOW_EXPOSE;
-    QApplication::postEvent( _eventHandler, windowEvent );
+    _post( qevent, _eventHandler );
+}
+
+void GLWidget::closeEvent( QCloseEvent* qevent )
+{
+    _post( qevent, _eventHandler );
+}
+
+void GLWidget::paintEvent( QPaintEvent* qevent )
+{
+    _post( qevent, _eventHandler );
 }
 
 void GLWidget::mousePressEvent( QMouseEvent* qevent )
 {
-    if( !_eventHandler )
-        return;
-    WindowEvent* windowEvent = new WindowEvent;
-    windowEvent->eq::Event::type = Event::WINDOW_POINTER_BUTTON_PRESS;
-    windowEvent->pointerButtonPress.x = qevent->x();
-    windowEvent->pointerButtonPress.y = qevent->y();
-    windowEvent->pointerButtonPress.buttons = _getButtons( qevent->buttons( ));
-    windowEvent->pointerButtonPress.button  = _getButton( qevent->button( ));
-    QApplication::postEvent( _eventHandler, windowEvent );
+    _post( qevent, _getInputHandler( ));
 }
 
 void GLWidget::mouseReleaseEvent( QMouseEvent* qevent )
 {
-    if( !_eventHandler )
-        return;
-    WindowEvent* windowEvent = new WindowEvent;
-    windowEvent->eq::Event::type = Event::WINDOW_POINTER_BUTTON_RELEASE;
-    windowEvent->pointerButtonRelease.x = qevent->x();
-    windowEvent->pointerButtonRelease.y = qevent->y();
-    windowEvent->pointerButtonRelease.buttons = _getButtons( qevent->buttons());
-    windowEvent->pointerButtonRelease.button  = _getButton( qevent->button( ));
-    QApplication::postEvent( _eventHandler, windowEvent );
+    _post( qevent, _getInputHandler( ));
 }
 
 void GLWidget::mouseMoveEvent( QMouseEvent* qevent )
 {
-    if( !_eventHandler )
-        return;
-    WindowEvent* windowEvent = new WindowEvent;
-    windowEvent->eq::Event::type = Event::WINDOW_POINTER_MOTION;
-    windowEvent->pointerMotion.x = qevent->x();
-    windowEvent->pointerMotion.y = qevent->y();
-    windowEvent->pointerMotion.buttons = _getButtons( qevent->buttons( ));
-    windowEvent->pointerMotion.button  = _getButton( qevent->button( ));
-    QApplication::postEvent( _eventHandler, windowEvent );
+    _post( qevent, _getInputHandler( ));
 }
 
 #ifndef QT_NO_WHEELEVENT
 void GLWidget::wheelEvent( QWheelEvent* qevent )
 {
-    if( !_eventHandler )
-        return;
-    WindowEvent* windowEvent = new WindowEvent;
-    windowEvent->eq::Event::type = Event::WINDOW_POINTER_WHEEL;
-    switch( qevent->orientation( ))
-    {
-    case Qt::Horizontal:
-        windowEvent->pointerWheel.xAxis = qevent->delta() > 0 ? 1 : -1;
-        break;
-    case Qt::Vertical:
-        windowEvent->pointerWheel.yAxis = qevent->delta() > 0 ? 1 : -1;
-        break;
-    }
-    windowEvent->pointerWheel.buttons = _getButtons( qevent->buttons( ));
-    windowEvent->pointerWheel.button  = PTR_BUTTON_NONE;
-    QApplication::postEvent( _eventHandler, windowEvent );
+    _post( qevent, _getInputHandler( ));
 }
 #endif
 
 void GLWidget::keyPressEvent( QKeyEvent* qevent )
 {
-    if( !_eventHandler )
-        return;
-    WindowEvent* windowEvent = new WindowEvent;
-    windowEvent->eq::Event::type = Event::KEY_PRESS;
-    windowEvent->keyPress.key = _getKey( *qevent );
-    QApplication::postEvent( _eventHandler, windowEvent );
+    _post( qevent, _getInputHandler( ));
 }
 
 void GLWidget::keyReleaseEvent( QKeyEvent* qevent )
 {
-    if( !_eventHandler )
-        return;
-    WindowEvent* windowEvent = new WindowEvent;
-    windowEvent->eq::Event::type = Event::KEY_RELEASE;
-    windowEvent->keyRelease.key = _getKey( *qevent );
-    QApplication::postEvent( _eventHandler, windowEvent );
+    _post( qevent, _getInputHandler( ));
 }
 
 }
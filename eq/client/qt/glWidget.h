@@ -22,6 +22,8 @@
 #include <lunchbox/compiler.h> // override, final
 #include <QGLWidget> // base class
 
+class QThread;
+
 namespace eq
 {
 namespace qt
@@ -54,6 +56,11 @@ public:
 private:
     qt::Window* _parent;
     EventHandler* _eventHandler;
+    EventHandler* _inputHandler; //!< on _eventThread, if used
+    QThread* _eventThread;
+
+    EventHandler* _getInputHandler();
+    void _post( QEvent* qevent, EventHandler* handler );
 };
 
 }
@@ -0,0 +1,113 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "eventHandler.h" // be first to avoid max/min name clashes on Win32...
+
+#include "renderWindow.h"
+
+#include "windowEvent.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <cstdlib>
+
+namespace eq
+{
+namespace qt
+{
+
+RenderWindow::RenderWindow( const QSurfaceFormat& format_ )
+    : _eventHandler( 0 )
+    , _inputHandler( 0 )
+    , _eventThread( 0 )
+{
+    setSurfaceType( QSurface::OpenGLSurface );
+    setFormat( format_ );
+}
+
+RenderWindow::~RenderWindow()
+{
+    LBASSERT( !_eventHandler );
+}
+
+void RenderWindow::initEventHandler( WindowIF& parent )
+{
+    _eventHandler = new EventHandler( parent );
+    if( !getenv( "EQ_WINDOW_EVENT_THREAD" ))
+        return;
+
+    // input events are processed by the event loop of a dedicated thread,
+    // independent of the rendering of the pipe thread
+    _eventThread = new QThread;
+    _inputHandler = new EventHandler( parent );
+    _inputHandler->moveToThread( _eventThread );
+    _eventThread->start();
+}
+
+void RenderWindow::exitEventHandler()
+{
+    if( _eventThread )
+    {
+        _eventThread->quit();
+        _eventThread->wait();
+        delete _eventThread;
+        _eventThread = 0;
+    }
+    delete _inputHandler;
+    _inputHandler = 0;
+
+    delete _eventHandler;
+    _eventHandler = 0;
+}
+
+bool RenderWindow::event( QEvent* qevent )
+{
+    if( qevent->type() == QEvent::Close )
+    {
+        // keep the surface, the config exit destroys the window
+        WindowEvent* windowEvent = EventHandler::translateEvent( qevent );
+        if( _eventHandler && windowEvent )
+            QCoreApplication::postEvent( _eventHandler, windowEvent );
+        else
+            delete windowEvent;
+        return true;
+    }
+
+    if( _eventHandler )
+    {
+        WindowEvent* windowEvent = EventHandler::translateEvent( qevent );
+        if( windowEvent )
+        {
+            switch( windowEvent->eq::Event::type )
+            {
+            case Event::WINDOW_RESIZE:
+            case Event::WINDOW_EXPOSE:
+                QCoreApplication::postEvent( _eventHandler, windowEvent );
+                break;
+            default:
+                QCoreApplication::postEvent( _inputHandler ? _inputHandler :
+                                                             _eventHandler,
+                                             windowEvent );
+            }
+        }
+    }
+    return QWindow::event( qevent );
+}
+
+}
+}
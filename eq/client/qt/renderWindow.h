@@ -0,0 +1,58 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_QT_RENDERWINDOW_H
+#define EQ_QT_RENDERWINDOW_H
+
+#include <eq/client/qt/types.h>
+#include <lunchbox/compiler.h> // override, final
+#include <QWindow> // base class
+
+class QThread;
+
+namespace eq
+{
+namespace qt
+{
+/**
+ * The OpenGL surface of a qt::SurfaceWindow.
+ *
+ * Created and destroyed in the QApplication thread. Forwards the window and
+ * input events to the event handlers of the system window, without a widget
+ * repaint pipeline.
+ */
+class RenderWindow : public QWindow
+{
+public:
+    explicit RenderWindow( const QSurfaceFormat& format );
+    ~RenderWindow() final;
+
+    void initEventHandler( WindowIF& parent );
+    void exitEventHandler();
+
+protected:
+    bool event( QEvent* qevent ) override;
+
+private:
+    EventHandler* _eventHandler;
+    EventHandler* _inputHandler; //!< on _eventThread, if used
+    QThread* _eventThread;
+};
+
+}
+}
+#endif // EQ_QT_RENDERWINDOW_H
@@ -0,0 +1,178 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "surfaceWindow.h"
+
+#include "renderWindow.h"
+#include "windowEvent.h"
+
+#include <QOpenGLContext>
+#include <QSurface>
+
+namespace eq
+{
+namespace qt
+{
+namespace detail
+{
+class SurfaceWindow
+{
+public:
+    SurfaceWindow( QSurface* surface_,
+                   eq::qt::SurfaceWindow::DeleteSurfaceFunc deleteSurface_ )
+        : surface( surface_ )
+        , renderWindow( dynamic_cast< RenderWindow* >( surface_ ))
+        , deleteSurface( deleteSurface_ )
+        , context( 0 )
+    {}
+
+    ~SurfaceWindow()
+    {
+        LBASSERT( !context );
+        if( deleteSurface )
+            deleteSurface( surface );
+        else
+            delete surface;
+    }
+
+    QSurface* const surface;
+    RenderWindow* const renderWindow; //!< the surface, if onscreen
+    const eq::qt::SurfaceWindow::DeleteSurfaceFunc deleteSurface;
+    QOpenGLContext* context; //!< created and used in the pipe thread
+};
+}
+
+SurfaceWindow::SurfaceWindow( NotifierInterface& parent,
+                              const WindowSettings& settings,
+                              QSurface* surface,
+                              DeleteSurfaceFunc deleteSurface )
+    : WindowIF( parent, settings )
+    , _impl( new detail::SurfaceWindow( surface, deleteSurface ))
+{
+}
+
+SurfaceWindow::~SurfaceWindow()
+{
+    delete _impl;
+}
+
+bool SurfaceWindow::configInit()
+{
+    if( !_impl->surface )
+    {
+        sendError( ERROR_QTWINDOW_CREATESURFACE_FAILED );
+        return false;
+    }
+
+    QOpenGLContext* context = new QOpenGLContext;
+    context->setFormat( _impl->surface->format( ));
+
+    const SurfaceWindow* shareWindow =
+        dynamic_cast< const SurfaceWindow* >( getSharedContextWindow( ));
+    if( shareWindow && shareWindow->getContext( ))
+        context->setShareContext( shareWindow->getContext( ));
+
+    if( !context->create( ))
+    {
+        delete context;
+        sendError( ERROR_QTWINDOW_CREATECONTEXT_FAILED );
+        return false;
+    }
+    _impl->context = context;
+
+    if( _impl->renderWindow )
+    {
+        const QRect& geometry = _impl->renderWindow->geometry();
+        setPixelViewport( PixelViewport( geometry.x(), geometry.y(),
+                                         geometry.width(),
+                                         geometry.height( )));
+        initEventHandler();
+    }
+
+    makeCurrent( false );
+    initGLEW();
+
+    if( getIAttribute( WindowSettings::IATTR_HINT_DRAWABLE ) == FBO )
+        return configInitFBO();
+    return true;
+}
+
+void SurfaceWindow::configExit()
+{
+    if( !_impl->context )
+        return;
+
+    configExitFBO();
+    makeCurrent();
+    exitGLEW();
+
+    exitEventHandler();
+    _impl->context->doneCurrent();
+    delete _impl->context;
+    _impl->context = 0;
+}
+
+void SurfaceWindow::makeCurrent( const bool cache ) const
+{
+    if( cache && isCurrent( ))
+        return;
+
+    _impl->context->makeCurrent( _impl->surface );
+    WindowIF::makeCurrent();
+}
+
+void SurfaceWindow::swapBuffers()
+{
+    if( _impl->renderWindow )
+        _impl->context->swapBuffers( _impl->surface );
+}
+
+void SurfaceWindow::joinNVSwapBarrier( const uint32_t /*group*/,
+                                       const uint32_t /*barrier*/ )
+{
+    LBWARN << "NV_swap_group not supported by Qt windows" << std::endl;
+}
+
+QOpenGLContext* SurfaceWindow::getContext() const
+{
+    return _impl->context;
+}
+
+QSurface* SurfaceWindow::getSurface() const
+{
+    return _impl->surface;
+}
+
+bool SurfaceWindow::processEvent( const WindowEvent& event )
+{
+    return SystemWindow::processEvent( event );
+}
+
+void SurfaceWindow::initEventHandler()
+{
+    if( _impl->renderWindow )
+        _impl->renderWindow->initEventHandler( *this );
+}
+
+void SurfaceWindow::exitEventHandler()
+{
+    if( _impl->renderWindow )
+        _impl->renderWindow->exitEventHandler();
+}
+
+}
+}
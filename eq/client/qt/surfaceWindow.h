@@ -0,0 +1,110 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_QT_SURFACEWINDOW_H
+#define EQ_QT_SURFACEWINDOW_H
+
+#include <eq/client/qt/window.h> // base class
+
+class QOpenGLContext;
+class QSurface;
+
+namespace eq
+{
+namespace qt
+{
+namespace detail { class SurfaceWindow; }
+
+/**
+ * A Qt window rendering with a QOpenGLContext owned by the pipe thread.
+ *
+ * Renders into a RenderWindow for window drawables, and into a
+ * QOffscreenSurface for FBO and OFF drawables. Unlike qt::Window, no widget is
+ * involved: the context is created and made current only in the pipe thread,
+ * and swapBuffers() swaps the surface directly.
+ * @version 1.9
+ */
+class SurfaceWindow : public WindowIF
+{
+public:
+    /**
+     * Function invoked to delete the surface from the destructor.
+     * @version 1.9
+     */
+    typedef boost::function< void( QSurface* ) > DeleteSurfaceFunc;
+
+    /**
+     * Construct a new Qt surface window.
+     *
+     * The surface has to be a RenderWindow or a QOffscreenSurface. If no
+     * DeleteSurfaceFunc is given, the surface is destroyed using delete.
+     * @version 1.9
+     */
+    SurfaceWindow( NotifierInterface& parent, const WindowSettings& settings,
+                   QSurface* surface, DeleteSurfaceFunc deleteSurface = 0 );
+
+    /** Destruct this Qt surface window. @version 1.9 */
+    ~SurfaceWindow() final;
+
+    /** @name Qt initialization */
+    //@{
+    /**
+     * Create the OpenGL context in the calling pipe thread.
+     *
+     * @return true if the initialization was successful, false otherwise.
+     * @version 1.9
+     */
+    bool configInit() override;
+
+    /** @version 1.9 */
+    void configExit() override;
+
+    /** @version 1.9 */
+    EQ_API virtual void initEventHandler();
+
+    /** @version 1.9 */
+    EQ_API virtual void exitEventHandler();
+    //@}
+
+    /** @name Operations. */
+    //@{
+    /** @version 1.9 */
+    void makeCurrent( const bool cache = true ) const override;
+
+    /** @version 1.9 */
+    void swapBuffers() override;
+
+    /** Not supported for Qt. @version 1.9 */
+    void joinNVSwapBarrier( const uint32_t group,
+                            const uint32_t barrier ) override;
+
+    /** @return the OpenGL context, or 0 if not initialized. @version 1.9 */
+    QOpenGLContext* getContext() const;
+
+    /** @return the render surface. @version 1.9 */
+    QSurface* getSurface() const;
+
+    /** @version 1.9 */
+    EQ_API bool processEvent( const WindowEvent& event ) override;
+    //@}
+
+private:
+    detail::SurfaceWindow* const _impl;
+};
+}
+}
+#endif // EQ_QT_SURFACEWINDOW_H
@@ -32,6 +32,8 @@ namespace qt
 class EventHandler;
 class GLWidget;
 class Pipe;
+class RenderWindow;
+class SurfaceWindow;
 class WidgetFactory;
 class Window;
 class WindowIF;
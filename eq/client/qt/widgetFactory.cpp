@@ -22,8 +22,10 @@
 #include "widgetFactory.h"
 
 #include "glWidget.h"
+#include "renderWindow.h"
 #include <eq/client/window.h>
 #include <QGLFormat>
+#include <QOffscreenSurface>
 #undef max
 
 namespace eq
@@ -170,5 +172,51 @@ void WidgetFactory::onDestroyWidget( QGLWidget* widget )
     delete widget;
 }
 
+RenderWindow* WidgetFactory::onCreateRenderWindow(
+    eq::Window* window, const WindowSettings& settings )
+{
+    // accumulation buffers are dropped, QSurfaceFormat has no equivalent
+    const QSurfaceFormat& format =
+        QGLFormat::toSurfaceFormat( _createQGLFormat( settings ));
+    RenderWindow* renderWindow = new RenderWindow( format );
+
+    const QString& title = QString::fromStdString( settings.getName( ));
+    renderWindow->setTitle( title.isEmpty() ? "Equalizer" : title );
+
+    if( settings.getIAttribute(
+            WindowSettings::IATTR_HINT_FULLSCREEN ) == eq::ON )
+    {
+        const PixelViewport& pvp = window->getPipe()->getPixelViewport();
+        renderWindow->setGeometry( pvp.x, pvp.y, pvp.w, pvp.h );
+        renderWindow->showFullScreen();
+    }
+    else
+    {
+        const PixelViewport& pvp = settings.getPixelViewport();
+        renderWindow->setGeometry( pvp.x, pvp.y, pvp.w, pvp.h );
+        renderWindow->show();
+    }
+    return renderWindow;
+}
+
+QOffscreenSurface* WidgetFactory::onCreateOffscreenSurface(
+    const WindowSettings& settings )
+{
+    QOffscreenSurface* surface = new QOffscreenSurface;
+    surface->setFormat( QGLFormat::toSurfaceFormat(
+                            _createQGLFormat( settings )));
+    surface->create();
+    if( surface->isValid( ))
+        return surface;
+
+    delete surface;
+    return 0;
+}
+
+void WidgetFactory::onDestroySurface( QObject* surface )
+{
+    delete surface;
+}
+
 }
 }
@@ -23,12 +23,17 @@
 #include <eq/client/types.h>
 #include "types.h"
 
+class QOffscreenSurface;
+
 namespace eq
 {
 namespace qt
 {
 
-/** Creates and destroys the eq::qt::GLWidget in the QApplication thread. */
+/**
+ * Creates and destroys the eq::qt::GLWidget and the surfaces of
+ * eq::qt::SurfaceWindow in the QApplication thread.
+ */
 class WidgetFactory : public QObject
 {
     Q_OBJECT
@@ -36,6 +41,10 @@ class WidgetFactory : public QObject
 public slots:
     GLWidget* onCreateWidget( eq::Window*, const WindowSettings&, QThread* );
     void onDestroyWidget( QGLWidget* );
+
+    RenderWindow* onCreateRenderWindow( eq::Window*, const WindowSettings& );
+    QOffscreenSurface* onCreateOffscreenSurface( const WindowSettings& );
+    void onDestroySurface( QObject* );
 };
 }
 }
@@ -23,14 +23,19 @@
 
 #include "glWidget.h"
 #include "messagePump.h"
+#include "renderWindow.h"
+#include "surfaceWindow.h"
 #include "widgetFactory.h"
 #include "window.h"
 
 #include <boost/bind.hpp>
 #include <eq/client/client.h>
 #include <QApplication>
+#include <QOffscreenSurface>
 #include <QThread>
 
+#include <cstdlib>
+
 
 namespace eq
 {
@@ -71,12 +76,27 @@ eq::SystemWindow* WindowSystem::createWindow( eq::Window* window,
     if( _useSystemWindowSystem( settings, window->getSharedContextWindow()))
         return getSystemWindowSystem().createWindow( window, settings );
 
-    LBINFO << "Using qt::Window" << std::endl;
-
     if( !_factory )
         _setupFactory();
 
     window->getClient()->interruptMainThread();
+    if( !_useGLWidget( ))
+    {
+        LBINFO << "Using qt::SurfaceWindow" << std::endl;
+
+        // the context is created in SurfaceWindow::configInit() in this thread
+        QSurface* surface = 0;
+        if( getAttribute( IATTR_HINT_DRAWABLE ) == eq::WINDOW )
+            surface = createRenderWindow( window, settings );
+        else
+            surface = createOffscreenSurface( settings );
+
+        return new SurfaceWindow( *window, settings, surface,
+                                  boost::bind( &WindowSystem::_deleteSurface,
+                                               this, _1 ));
+    }
+
+    LBINFO << "Using qt::Window" << std::endl;
     GLWidget* widget = createWidget( window, settings,
                                      QThread::currentThread( ));
 
@@ -112,17 +132,29 @@ bool WindowSystem::_useSystemWindowSystem( const WindowSettings& settings,
                                            const eq::Window* sharedWindow )
 {
     // pbuffer is not (yet) supported; OFF is used for transfer window
-    // which can also not be emulated yet (maybe with QGLContext only)
+    // which is only emulated by qt::SurfaceWindow using a QOffscreenSurface
+    const bool offSupported = !_useGLWidget();
     const int32_t settingsDrawable = getAttribute( IATTR_HINT_DRAWABLE );
-    if( settingsDrawable == eq::PBUFFER || settingsDrawable == eq::OFF )
+    if( settingsDrawable == eq::PBUFFER ||
+        ( settingsDrawable == eq::OFF && !offSupported ))
+    {
         return true;
+    }
 
     if( !sharedWindow )
         return false;
 
     const int32_t windowDrawable = sharedWindow->getSettings().getIAttribute(
                                           WindowSettings::IATTR_HINT_DRAWABLE );
-    return windowDrawable == eq::PBUFFER || windowDrawable == eq::OFF;
+    return windowDrawable == eq::PBUFFER ||
+           ( windowDrawable == eq::OFF && !offSupported );
+}
+
+bool WindowSystem::_useGLWidget()
+{
+    // legacy QGLWidget path, e.g. for applications using the widget directly
+    static const bool useGLWidget = getenv( "EQ_QT_GLWIDGET" ) != 0;
+    return useGLWidget;
 }
 
 void WindowSystem::_setupFactory()
@@ -140,6 +172,20 @@ void WindowSystem::_setupFactory()
 
     app->connect( this, SIGNAL(destroyWidget( QGLWidget* )),
                   _factory, SLOT(onDestroyWidget( QGLWidget* )));
+
+    app->connect( this, SIGNAL(createRenderWindow( eq::Window*,
+                                                   const WindowSettings& )),
+                  _factory, SLOT(onCreateRenderWindow( eq::Window*,
+                                                       const WindowSettings& )),
+                  Qt::BlockingQueuedConnection );
+
+    app->connect( this, SIGNAL(createOffscreenSurface( const WindowSettings& )),
+                  _factory,
+                  SLOT(onCreateOffscreenSurface( const WindowSettings& )),
+                  Qt::BlockingQueuedConnection );
+
+    app->connect( this, SIGNAL(destroySurface( QObject* )),
+                  _factory, SLOT(onDestroySurface( QObject* )));
 }
 
 void WindowSystem::_deleteGLWidget( QGLWidget* widget )
@@ -147,5 +193,11 @@ void WindowSystem::_deleteGLWidget( QGLWidget* widget )
     destroyWidget( widget );
 }
 
+void WindowSystem::_deleteSurface( QSurface* surface )
+{
+    // QWindow and QOffscreenSurface are QObjects, to be deleted in their thread
+    destroySurface( dynamic_cast< QObject* >( surface ));
+}
+
 }
 }
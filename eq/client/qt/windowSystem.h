@@ -19,6 +19,9 @@
 #include <eq/client/windowSystem.h>
 #include "types.h"
 
+class QOffscreenSurface;
+class QSurface;
+
 namespace eq
 {
 namespace qt
@@ -36,6 +39,10 @@ signals:
     eq::qt::GLWidget* createWidget( eq::Window*, const WindowSettings&,
                                     QThread* );
     void destroyWidget( QGLWidget* );
+    eq::qt::RenderWindow* createRenderWindow( eq::Window*,
+                                              const WindowSettings& );
+    QOffscreenSurface* createOffscreenSurface( const WindowSettings& );
+    void destroySurface( QObject* );
 
 private:
     std::string getName() const final;
@@ -50,8 +57,10 @@ private:
 
     bool _useSystemWindowSystem( const WindowSettings& settings,
                                  const eq::Window* sharedWindow );
+    static bool _useGLWidget();
     void _setupFactory();
     void _deleteGLWidget( QGLWidget* widget );
+    void _deleteSurface( QSurface* surface );
 
     WidgetFactory* _factory;
 };
@@ -44,29 +44,28 @@ void ROIEmptySpaceFinder::update( const uint8_t* mask,
     _resize( w, h );
 
     _mask = mask;
-    const uint8_t*  s = mask + _w*(_h-1);
-          uint16_t* d = &_data[_w*(_h-1)];
 
-    // First element
-    d[_w-1] = s[_w-1] > 0 ? 1 : 0;
-
-    // First raw
-    for( int32_t x = _w-2; x >= 0; x-- )
-        d[x] = d[x+1] + ( s[x] > 0 ? 1 : 0 );
-
-    // All other raws
-    for( int32_t y = 1; y < _h; y++ )
+    // Count the occupied blocks right of each block, row by row
+    for( int32_t y = 0; y < _h; y++ )
     {
-        const uint16_t* dp = d; // previous calculated raw
-        s -= _w;
-        d -= _w;
+        const uint8_t*  s = mask + y*_w;
+              uint16_t* d = &_data[y*_w];
         uint16_t rawSum = 0;
         for( int32_t x = _w-1; x >= 0; x-- )
         {
-            rawSum += s[x] > 0 ? 1 : 0;
-            d[x] = dp[x] + rawSum;
+            rawSum += uint16_t( s[x] != 0 );
+            d[x] = rawSum;
         }
     }
+
+    // Add the rows above, independent for all columns and thus vectorized
+    for( int32_t y = _h-2; y >= 0; y-- )
+    {
+              uint16_t* d  = &_data[y*_w];
+        const uint16_t* dp = d + _w; // previous calculated raw
+        for( int32_t x = 0; x < _w; x++ )
+            d[x] += dp[x];
+    }
 }
 
 
@@ -166,6 +165,36 @@ bool ROIEmptySpaceFinder::_updateMaximalEmptyRegion(
     return updated;
 }
 
+PixelViewport ROIEmptySpaceFinder::getObjectArea( const PixelViewport& pvp )
+const
+{
+    LBASSERT(   pvp.x >= 0    && pvp.w > 0 &&
+                pvp.y >= 0    && pvp.h > 0 &&
+                pvp.x + pvp.w < _w &&
+                pvp.y + pvp.h < _h );
+
+    if( _getArea( pvp.x, pvp.y, pvp.w, pvp.h ) == 0 )
+        return PixelViewport( pvp.x, pvp.y, 0, 0 );
+
+    // shrink to the first and last occupied column, then row
+    int32_t xMin = pvp.x;
+    int32_t xMax = pvp.x + pvp.w - 1;
+    while( _getArea( xMin, pvp.y, 1, pvp.h ) == 0 )
+        xMin++;
+    while( _getArea( xMax, pvp.y, 1, pvp.h ) == 0 )
+        xMax--;
+
+    const int32_t w = xMax - xMin + 1;
+    int32_t yMin = pvp.y;
+    int32_t yMax = pvp.y + pvp.h - 1;
+    while( _getArea( xMin, yMin, w, 1 ) == 0 )
+        yMin++;
+    while( _getArea( xMin, yMax, w, 1 ) == 0 )
+        yMax--;
+
+    return PixelViewport( xMin, yMin, w, yMax - yMin + 1 );
+}
+
 PixelViewport ROIEmptySpaceFinder::getLargestEmptyArea(const PixelViewport& pvp)
 const
 {
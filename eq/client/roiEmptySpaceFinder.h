@@ -42,6 +42,10 @@ public:
         re-initialized after calling this function */
     void update( const uint8_t* mask, const int32_t w, const int32_t h );
 
+    /** Returns the bounding box of the occupied blocks within a given pvp,
+        using the data from update instead of scanning the mask. */
+    PixelViewport getObjectArea( const PixelViewport& pvp ) const;
+
     /** Returns maximal empty pvp within a given pvp.
         Uses mask data from update to check if single block is empty! */
     PixelViewport getLargestEmptyArea( const PixelViewport& pvp ) const;
@@ -17,6 +17,7 @@
  */
 
 #define EQ_ROI_USE_TRACKER        // disable ROI in case it can't help
+#define EQ_ROI_REUSE_FRAMES 8     // reuse regions of previous frames
 //#define EQ_ROI_USE_DEPTH_TEXTURE  // use depth texture instead of color
 
 #include "roiFinder.h"
@@ -57,12 +58,13 @@ ROIFinder::ROIFinder()
     , _wb( 0 )
     , _hb( 0 )
     , _wbhb( 0 )
-    , _histX()
-    , _histY()
 {
     _tmpAreas[0].pvp       = PixelViewport( 0, 0, 0, 0 );
     _tmpAreas[0].hole      = PixelViewport( 0, 0, 0, 0 );
     _tmpAreas[0].emptySize = 0;
+#ifdef EQ_ROI_REUSE_FRAMES
+    _roiTracker.setRefreshInterval( EQ_ROI_REUSE_FRAMES );
+#endif
 }
 
 void ROIFinder::_dumpDebug( const GLEWContext* gl, const uint32_t stage )
@@ -98,71 +100,6 @@ void ROIFinder::_dumpDebug( const GLEWContext* gl, const uint32_t stage )
     _tmpImg.writeImages( ss.str( ));
 }
 
-PixelViewport ROIFinder::_getObjectPVP( const PixelViewport& pvp,
-                                        const uint8_t*       src )
-{
-    LBASSERT( pvp.x >= 0 && pvp.x+pvp.w <= _wb &&
-              pvp.y >= 0 && pvp.y+pvp.h <= _hb );
-
-    // Calculate per-pixel histograms
-    const uint8_t* s = src + pvp.y*_wb + pvp.x;
-
-    memset( _histX, 0, pvp.w );
-    memset( _histY, 0, pvp.h );
-    for( int32_t y = 0; y < pvp.h; y++ )
-    {
-        for( int32_t x = 0; x < pvp.w; x++ )
-        {
-            const uint8_t val = s[ x ] & 1;
-            _histX[ x ] += val;
-            _histY[ y ] += val;
-        }
-        s += _wb;
-    }
-
-    // Find AABB based on X and Y axis historgams
-    int32_t xMin = pvp.w;
-    for( int32_t x = 0; x < pvp.w; x++ )
-        if( _histX[x] != 0 )
-        {
-            xMin = x;
-            break;
-        }
-
-    int32_t xMax = 0;
-    for( int32_t x = pvp.w-1; x >= 0; x-- )
-        if( _histX[x] != 0 )
-        {
-            xMax = x;
-            break;
-        }
-
-    if( xMax < xMin )
-        return PixelViewport( pvp.x, pvp.y, 0, 0 );
-
-    int32_t yMin = pvp.h;
-    for( int32_t y = 0; y < pvp.h; y++ )
-        if( _histY[y] != 0 )
-        {
-            yMin = y;
-            break;
-        }
-
-    int32_t yMax = 0;
-    for( int32_t y = pvp.h-1; y >= 0; y-- )
-        if( _histY[y] != 0 )
-        {
-            yMax = y;
-            break;
-        }
-
-    if( yMax < yMin )
-        return PixelViewport( pvp.x, pvp.y, 0, 0 );
-
-    return PixelViewport( pvp.x+xMin, pvp.y+yMin, xMax-xMin+1, yMax-yMin+1 );
-}
-
-
 void ROIFinder::_resize( const PixelViewport& pvp )
 {
     _pvp = pvp;
@@ -178,9 +115,6 @@ void ROIFinder::_resize( const PixelViewport& pvp )
     {
         _mask.resize( _wbhb );
         _tmpMask.resize( _wbhb );
-
-        // w * h * sizeof( GL_FLOAT ) * RGBA
-        _perBlockInfo.resize( _wh * 4 );
     }
 }
 
@@ -188,25 +122,7 @@ void ROIFinder::_resize( const PixelViewport& pvp )
 void ROIFinder::_init( )
 {
     _areasToCheck.clear();
-    memset( &_mask[0]   , 0, _mask.size( ));
     memset( &_tmpMask[0], 0, _tmpMask.size( ));
-
-    LBASSERT( static_cast<int32_t>(_perBlockInfo.size()) >= _w*_h*4 );
-    LBASSERT( static_cast<int32_t>(_mask.size())         >= _wb*_h  );
-
-    const float*    src = &_perBlockInfo[0];
-          uint8_t*  dst = &_mask[0];
-
-    for( int32_t y = 0; y < _h; y++ )
-    {
-        for( int32_t x = 0; x < _w; x++ )
-        {
-            if( src[x*4] < 1.0 )
-                dst[x] = 255;
-        }
-        src += _w*4;
-        dst += _wb;
-    }
 }
 
 
@@ -259,7 +175,7 @@ void ROIFinder::_updateSubArea( const uint8_t type )
 
     Area& a = _tmpAreas[type];
 
-    a.pvp = _getObjectPVP( pvp, &_mask[0] );
+    a.pvp = _emptyFinder.getObjectArea( pvp );
 
     a.hole = _emptyFinder.getLargestEmptyArea( a.pvp );
 
@@ -482,7 +398,7 @@ void ROIFinder::_findAreas( PixelViewports& resultPVPs )
     LBASSERT( _areasToCheck.empty() );
 
     Area area( PixelViewport( 0, 0, _w, _h ));
-    area.pvp  = _getObjectPVP( area.pvp, &_mask[0] );
+    area.pvp  = _emptyFinder.getObjectArea( area.pvp );
 
     if( area.pvp.w <= 0 || area.pvp.h <= 0 )
         return;
@@ -574,7 +490,7 @@ void ROIFinder::_readbackInfo( util::ObjectManager& glObjects )
     else
     {
         fbo = glObjects.newEqFrameBufferObject( fboKey );
-        LBCHECK( fbo->init( _pvp.w, _pvp.h, GL_RGBA32F, 0, 0 ));
+        LBCHECK( fbo->init( _pvp.w, _pvp.h, GL_RGBA8, 0, 0 ));
     }
     fbo->bind();
 
@@ -643,15 +559,19 @@ void ROIFinder::_readbackInfo( util::ObjectManager& glObjects )
     glDisable( GL_TEXTURE_RECTANGLE_ARB );
     EQ_GL_CALL( glUseProgram( 0 ));
 
-    fbo->unbind();
+    // finish readback of info: the shader writes 255 for occupied blocks, read
+    // one byte per block straight into the bordered _mask
+    LBASSERT( static_cast<int32_t>(_mask.size()) >= _wb*_h );
+    memset( &_mask[0], 0, _mask.size( ));
 
-    // finish readback of info
-    LBASSERT( static_cast<int32_t>(_perBlockInfo.size()) >= _pvp.w*_pvp.h*4 );
+    glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+    glPixelStorei( GL_PACK_ROW_LENGTH, _wb );
+    EQ_GL_CALL( glReadPixels( 0, 0, _pvp.w, _pvp.h, GL_RED, GL_UNSIGNED_BYTE,
+                              &_mask[0] ));
+    glPixelStorei( GL_PACK_ROW_LENGTH, 0 );
+    glPixelStorei( GL_PACK_ALIGNMENT, 4 );
 
-    texture = fbo->getColorTextures()[0];
-    LBASSERT( texture->getFormat() == GL_RGBA );
-    LBASSERT( texture->getType() == GL_FLOAT );
-    texture->download( &_perBlockInfo[0] );
+    fbo->unbind();
 }
 
 
@@ -674,6 +594,7 @@ PixelViewports ROIFinder::findRegions( const uint32_t         buffers,
                                        const Zoom&            zoom,
                                        const uint32_t         stage,
                                        const uint128_t&       frameID,
+                                       const PixelViewport&   declared,
                                        util::ObjectManager&   glObjects )
 {
     PixelViewports result;
@@ -693,6 +614,9 @@ PixelViewports ROIFinder::findRegions( const uint32_t         buffers,
     uint8_t* ticket;
     if( !_roiTracker.useROIFinder( pvp, stage, frameID, ticket ))
         return result;
+
+    if( _roiTracker.reuseRegions( declared, result ))
+        return result;
 #endif
 
     _pvpOriginal = pvp;
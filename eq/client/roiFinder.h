@@ -45,6 +45,7 @@ public:
      * @param zoom      current zoom
      * @param stage     compositing stage (to track separate statistics).
      * @param frameID   ID of current frame (to track separate statistics).
+     * @param declared  bounding box of the regions declared by the channel.
      * @param glObjects object manager.
      *
      * @return Areas for readback
@@ -54,21 +55,22 @@ public:
                                 const Zoom&            zoom,
                                 const uint32_t         stage,
                                 const uint128_t&       frameID,
+                                const PixelViewport&   declared,
                                 util::ObjectManager&   glObjects );
 private:
     struct Area;
 
     const void* _getInfoKey( ) const;
 
-    /** Called from getReadbackInfo. Calculates per-block statistic before
-        actuall read-back */
+    /** Called from getReadbackInfo. Calculates per-block occupancy on the GPU
+        and reads it back into _mask */
     void _readbackInfo( util::ObjectManager& glObjects );
 
     /** Dumpes image that contain _mask and found regions */
     void _dumpDebug( const GLEWContext* gl, const uint32_t stage = 0 );
 
-    /** Clears masks, filles per-block occupancy _mask from _perBlockInfo,
-        that was previously read-back from GPU in _readbackInfo */
+    /** Clears the areas and debug mask before searching the _mask that
+        was read back from the GPU in _readbackInfo */
     void _init( );
 
     /** For debugging purposes */
@@ -78,10 +80,6 @@ private:
     /** Updates dimensions and resizes arrays */
     void _resize( const PixelViewport& pvp );
 
-    /** Histogram based based AABB calculation of a region. */
-    PixelViewport _getObjectPVP( const PixelViewport& pvp,
-                                 const uint8_t* src );
-
     /** Result is returned via _finalAreas array */
     uint8_t _splitArea( Area& area );
 
@@ -141,11 +139,6 @@ private:
     Vectorub _tmpMask; //!< used only to dump found areas in _dumpDebug
     Vectorub _mask;    //!< mask of occupied blocks (main data)
 
-    std::vector<float> _perBlockInfo; //!< buffer for data from GPU
-
-    uint8_t _histX[256]; //!< histogram to find BB along X axis
-    uint8_t _histY[256]; //!< histogram to find BB along Y axis
-
     Image _tmpImg;   //!< used for dumping debug info
 
     ROITracker _roiTracker; //!< disables ROI when ROI is inefficient
@@ -83,5 +83,5 @@ void main(void)
         }
     }
 
-    gl_FragColor = vec4( bg, .0, .0, .0 );
+    gl_FragColor = vec4( 1.0 - bg, .0, .0, .0 );
 }
@@ -16,6 +16,8 @@
 
 #include "roiTracker.h"
 
+#include <cstdlib>
+
 namespace eq
 {
 
@@ -25,6 +27,8 @@ ROITracker::Area::Area( const PixelViewport& pvp_,
     :pvp(      pvp_      )
     ,lastSkip( lastSkip_ )
     ,skip(     skip_     )
+    ,motion( 0 )
+    ,age( 0 )
 {
 }
 
@@ -32,6 +36,7 @@ ROITracker::Area::Area( const PixelViewport& pvp_,
 ROITracker::ROITracker()
     : _needsUpdate( false )
     , _lastStage( 0 )
+    , _refresh( 0 )
 {
     _ticket   = reinterpret_cast< uint8_t* >( this );
     _prvFrame = new stde::hash_map< uint32_t, Stage >;
@@ -112,18 +117,77 @@ bool ROITracker::useROIFinder( const PixelViewport& pvp,
     }
     // else good match
 
+    Area area( pvp, match->lastSkip, match->skip == 0 ? 0 : match->skip-1 );
+    area.regions  = match->regions;
+    area.declared = match->declared;
+    area.motion   = match->motion;
+    area.age      = match->age + 1;
+    curStage.areas.push_back( area );
+
     if( match->skip == 0 ) // don't skip frame
-    {
-        curStage.areas.push_back( Area( pvp, match->lastSkip ));
         return _returnPositive( ticket );
-    }
     //else skip frame
-
-    curStage.areas.push_back( Area( pvp, match->lastSkip, match->skip-1 ));
     return false;
 }
 
 
+bool ROITracker::reuseRegions( const PixelViewport& declared,
+                               PixelViewports& regions )
+{
+    LBASSERT( _needsUpdate );
+
+    Area& area = (*_curFrame)[ _lastStage ].areas.back();
+    const PixelViewport previous = area.declared;
+    area.declared = declared;
+
+    if( _refresh == 0 || area.regions.empty() || area.age > _refresh ||
+        !previous.hasArea() || !declared.hasArea( ))
+    {
+        return false;
+    }
+
+    // bound the motion by the largest displacement of a declared edge
+    area.motion += LB_MAX( LB_MAX( std::abs( declared.x - previous.x ),
+                                   std::abs( declared.y - previous.y )),
+                           LB_MAX( std::abs( declared.getXEnd() -
+                                             previous.getXEnd( )),
+                                   std::abs( declared.getYEnd() -
+                                             previous.getYEnd( ))));
+    const int32_t motion = area.motion;
+
+    PixelViewports dilated;
+    PixelViewport bounds;
+    uint32_t totalArea = 0;
+    for( uint32_t i = 0; i < area.regions.size(); ++i )
+    {
+        const PixelViewport& region = area.regions[i];
+        PixelViewport pvp( region.x - motion, region.y - motion,
+                           region.w + 2 * motion, region.h + 2 * motion );
+        pvp.intersect( area.pvp );
+        if( !pvp.hasArea( ))
+            continue;
+
+        dilated.push_back( pvp );
+        bounds.merge( pvp );
+        totalArea += pvp.getArea();
+    }
+
+    PixelViewport content = declared;
+    content.intersect( area.pvp );
+    if( !content.hasArea( ))
+        return false;
+
+    PixelViewport covered = content;
+    covered.intersect( bounds );
+    if( covered != content || totalArea >= area.pvp.getArea()*4/5 )
+        return false;
+
+    regions.swap( dilated );
+    _needsUpdate = false;
+    return true;
+}
+
+
 void ROITracker::updateDelay( const PixelViewports& pvps,
                               const uint8_t* ticket )
 {
@@ -145,13 +209,17 @@ void ROITracker::updateDelay( const PixelViewports& pvps,
     {
         // ROI cutted enough, reset failure statistics
         area.lastSkip = 0;
+        area.regions  = pvps;
     }else
     {
         // disable ROI for next frames, if it was failing before, 
         // increase number of frames to skip
         area.lastSkip = LB_MIN( area.lastSkip*2 + 1, 64 );
         area.skip     = area.lastSkip;
+        area.regions.clear();
     }
+    area.motion = 0;
+    area.age = 0;
     _needsUpdate = false;
 }
 
@@ -74,6 +74,30 @@ public:
      */
     void updateDelay( const PixelViewports& pvps, const uint8_t* ticket );
 
+    /**
+     * Try to reuse the regions found in a previous frame instead of running
+     * the ROIFinder.
+     *
+     * May be called once after a positive result from useROIFinder. The
+     * regions last found for the matching area are dilated by the motion of
+     * the declared region since they were found. Reuse fails when the regions
+     * are older than the refresh interval, when the dilated regions do not
+     * contain the declared region or when they no longer cut off enough of
+     * the area. On success, updateDelay must not be called for this ticket.
+     *
+     * @param declared the bounding box of the regions declared this frame.
+     * @param regions  returns the reused regions on success.
+     * @return true if the regions can be reused, false if the ROIFinder has
+     *         to be run.
+     */
+    bool reuseRegions( const PixelViewport& declared, PixelViewports& regions );
+
+    /**
+     * Set the maximum number of frames found regions are reused, 0 disables
+     * reuse.
+     */
+    void setRefreshInterval( const uint32_t frames ) { _refresh = frames; }
+
 private:
     /** Area of readback */
     struct Area
@@ -85,6 +109,11 @@ private:
         PixelViewport pvp;
         uint32_t      lastSkip; //!< Previousely skiped number of frames
         uint32_t      skip;     //!< Number of frames to skip ROIFinder
+
+        PixelViewports regions;  //!< Last regions found by the ROIFinder
+        PixelViewport  declared; //!< Last declared region bounding box
+        int32_t        motion;   //!< Declared motion since regions were found
+        uint32_t       age;      //!< Number of frames since regions were found
     };
     /** Set of readback areas per compositiong stage */
     struct Stage
@@ -103,6 +132,7 @@ private:
     bool     _needsUpdate;//!< true after getDelay, false after updateDelay
     uint128_t _lastFrameID;//!< used to determine new frames
     uint32_t _lastStage;  //!< used in updateDelay to find last added area
+    uint32_t _refresh;    //!< max number of frames regions are reused
 
     bool _returnPositive( uint8_t*& ticket );
 };
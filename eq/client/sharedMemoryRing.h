@@ -0,0 +1,98 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_SHAREDMEMORYRING_H
+#define EQ_SHAREDMEMORYRING_H
+
+#include <lunchbox/types.h>
+
+namespace eq
+{
+/**
+ * The layout of the shared memory segment written for
+ * Channel::SATTR_SHARED_MEMORY.
+ *
+ * The segment starts with a Header, followed by nSlots slots of slotSize
+ * bytes. Each slot starts with a Frame header, followed by the pixels of the
+ * frame. The channel writes the frames round-robin into the slots. Consumers
+ * map the segment read-only:
+ *
+ * - Read Header::sequence. The last frame is in slot (sequence-1) % nSlots.
+ * - The frame is valid while Frame::sequence is 2*sequence. An odd value
+ *   means the slot is being written. Check Frame::sequence again after using
+ *   the pixels to detect an overwrite.
+ * - On Linux, wait for new frames with a futex on Header::published.
+ *   Otherwise poll Header::sequence.
+ * - A magic of 0 means the segment was abandoned, e.g., because the frames
+ *   grew larger than slotSize. Close and reopen it by name.
+ *
+ * All values are in the byte order of the rendering host.
+ * @version 1.8
+ */
+struct SharedMemoryRing
+{
+    enum
+    {
+        MAGIC = 0x45515348, //!< "EQSH"
+        VERSION = 1,
+        NUM_SLOTS = 3 //!< The number of slots written by the channel
+    };
+
+    /** The header at the start of the segment. @version 1.8 */
+    struct Header
+    {
+        uint32_t magic; //!< MAGIC, or 0 if the segment was abandoned
+        uint32_t version; //!< VERSION
+        uint32_t nSlots; //!< The number of frame slots
+        uint32_t slotSize; //!< The size of one slot in bytes
+        uint32_t published; //!< futex word, incremented for each frame
+        uint32_t padding;
+        uint64_t sequence; //!< The number of published frames
+    };
+
+    /** The header at the start of each slot. @version 1.8 */
+    struct Frame
+    {
+        uint64_t sequence; //!< 2*Header::sequence, odd while writing
+        uint32_t frameNumber; //!< The frame number of the channel
+        uint32_t externalFormat; //!< EQ_COMPRESSOR_DATATYPE_* of the pixels
+        uint32_t pixelSize; //!< The size of one pixel in bytes
+        uint32_t size; //!< The size of the pixel data in bytes
+        int32_t x; //!< The pixel viewport of the image
+        int32_t y;
+        int32_t width;
+        int32_t height;
+    };
+
+    /** @return the frame header of a slot. @version 1.8 */
+    static const Frame* getFrame( const void* segment, const uint32_t slot )
+    {
+        const Header* header = static_cast< const Header* >( segment );
+        const uint8_t* data = static_cast< const uint8_t* >( segment );
+        return reinterpret_cast< const Frame* >(
+            data + sizeof( Header ) + size_t( slot ) * header->slotSize );
+    }
+
+    /** @return the pixels of a slot. @version 1.8 */
+    static const uint8_t* getPixels( const void* segment, const uint32_t slot )
+    {
+        return reinterpret_cast< const uint8_t* >(
+            getFrame( segment, slot ) + 1 );
+    }
+};
+}
+
+#endif // EQ_SHAREDMEMORYRING_H
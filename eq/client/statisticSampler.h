@@ -23,14 +23,33 @@
 
 namespace eq
 {
+    /** Policy sampling statistics as configured at runtime. @version 1.9 */
+    struct SampleStatistics { enum { enabled = true }; };
+
+    /** Policy compiling out statistics sampling. @version 1.9 */
+    struct SkipStatistics { enum { enabled = false }; };
+
+#ifdef EQ_DISABLE_STATISTICS
+    typedef SkipStatistics DefaultStatisticsPolicy;
+#else
+    typedef SampleStatistics DefaultStatisticsPolicy; //!< @version 1.9
+#endif
+
     /**
      * Utility to sample an statistics event.
      *
      * Holds a ConfigEvent, which is initialized from the owner's data during
      * initialization. Subclasses implement the constructor and destructor to
      * sample the times and process the gathered statistics.
+     *
+     * The Policy disables sampling at compile time, and the statistics hint
+     * at runtime. A disabled sampler only sets the type and frame number of
+     * the event, so that subclasses and callers check isEnabled() once. In
+     * HISTOGRAM mode, subclasses aggregate the sample into the local metrics
+     * of the config instead of sending it, see Config::addLocalStatistic().
      */
-    template< typename Owner > class StatisticSampler
+    template< typename Owner, typename Policy = DefaultStatisticsPolicy >
+    class StatisticSampler
     {
     public:
         /**
@@ -39,39 +58,55 @@ namespace eq
          * @param type The statistics type.
          * @param owner The originator of the statistics event.
          * @param frameNumber The current frame.
+         * @param hint The statistics hint, OFF disables sampling.
          * @version 1.0
          */
         StatisticSampler( const Statistic::Type type, Owner* owner,
-                          const uint32_t frameNumber = LB_UNDEFINED_UINT32 )
+                          const uint32_t frameNumber = LB_UNDEFINED_UINT32,
+                          const int32_t hint = AUTO )
             : _owner( owner )
+            , _hint( Policy::enabled ? hint : int32_t( OFF ))
         {
             LBASSERT( owner );
+            event.data.statistic.type        = type;
+            event.data.statistic.frameNumber = frameNumber;
+            if( event.data.statistic.frameNumber == LB_UNDEFINED_UINT32 )
+                event.data.statistic.frameNumber = owner->getCurrentFrame();
+            if( !isEnabled( ))
+                return;
+
             LBASSERT( owner->getID() != 0 );
             LBASSERT( owner->getSerial() != CO_INSTANCE_INVALID );
             event.data.type                  = Event::STATISTIC;
             event.data.serial                = owner->getSerial();
             event.data.originator            = owner->getID();
-            event.data.statistic.type        = type;
-            event.data.statistic.frameNumber = frameNumber;
             event.data.statistic.resourceName[0] = '\0';
             event.data.statistic.startTime   = 0;
             event.data.statistic.endTime     = 0;
-
-            if( event.data.statistic.frameNumber == LB_UNDEFINED_UINT32 )
-                event.data.statistic.frameNumber = owner->getCurrentFrame();
         }
 
         /** Destruct and finish statistics sampling. @version 1.0 */
         virtual ~StatisticSampler()
         {
-            LBASSERTINFO( event.data.statistic.startTime <=
+            LBASSERTINFO( !isEnabled() ||
+                          event.data.statistic.startTime <=
                           event.data.statistic.endTime, event.data.statistic );
         }
 
+        /** @return true if the statistic is sampled. @version 1.9 */
+        bool isEnabled() const { return Policy::enabled && _hint != OFF; }
+
+        /**
+         * @return true if the statistic is only aggregated locally.
+         * @version 1.9
+         */
+        bool isLocal() const { return Policy::enabled && _hint == HISTOGRAM; }
+
         ConfigEvent event; //!< The statistics event.
 
     protected:
         Owner* const _owner;
+        int32_t _hint; //!< The statistics hint, OFF when disabled
     };
 
 }
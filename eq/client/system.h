@@ -31,6 +31,13 @@
 #  include <eq/client/glx/types.h>
 #  include <eq/client/glx/window.h>
 #endif
+#ifdef EQ_EGL_USED
+#  include <eq/client/egl/pipe.h>
+#  include <eq/client/egl/types.h>
+#  include <eq/client/egl/window.h>
+#endif
+#include <eq/client/memory/pipe.h>
+#include <eq/client/memory/window.h>
 #ifdef WGL
 #  include <eq/client/wgl/eventHandler.h>
 #  include <eq/client/wgl/pipe.h>
@@ -20,6 +20,7 @@
 #ifndef EQ_SYSTEM_WINDOW_H
 #define EQ_SYSTEM_WINDOW_H
 
+#include <eq/client/frame.h>          // Frame::Buffer enum
 #include <eq/client/types.h>
 #include <eq/client/windowSettings.h> // WindowSettings::IAttribute enum
 
@@ -74,6 +75,14 @@ public:
      */
     EQ_API virtual void makeCurrent( const bool cache = true ) const = 0;
 
+    /**
+     * Release the rendering context from the calling thread.
+     *
+     * Has to be called before the context is made current in another thread.
+     * @version 1.9
+     */
+    EQ_API virtual void doneCurrent() const {}
+
     /** Bind the window's FBO, if it uses an FBO drawable. @version 1.0 */
     EQ_API virtual void bindFrameBuffer() const = 0;
 
@@ -83,6 +92,15 @@ public:
     /** Update the window's FBO from the multisampled FBO. @version 1.9 */
     EQ_API virtual void updateFrameBuffer() const = 0;
 
+    /**
+     * Update an area of the window's FBO from the multisampled FBO.
+     *
+     * The default implementation updates the full FBO.
+     * @version 1.9
+     */
+    EQ_API virtual void updateFrameBuffer( const PixelViewport& /*pvp*/ ) const
+        { updateFrameBuffer(); }
+
     /** Swap the front and back buffer. @version 1.0 */
     EQ_API virtual void swapBuffers() = 0;
 
@@ -92,6 +110,24 @@ public:
     /** Finish execution of  all commands. @version 1.5.2 */
     EQ_API virtual void finish() = 0;
 
+    /**
+     * Insert a fence after all submitted commands, see waitFence().
+     *
+     * The default implementation finishes all commands.
+     * @version 1.9
+     */
+    EQ_API virtual void insertFence() { finish(); }
+
+    /**
+     * Wait until the commands before the last fence are executed.
+     *
+     * @param timeout the maximum time to wait in milliseconds.
+     * @return false if the commands were not executed in time.
+     * @version 1.9
+     */
+    EQ_API virtual bool waitFence( const uint32_t /*timeout*/ )
+        { return true; }
+
     /**
      * Join a NV_swap_group.
      *
@@ -104,6 +140,43 @@ public:
      */
     EQ_API virtual void joinNVSwapBarrier( const uint32_t group,
                                            const uint32_t barrier ) = 0;
+
+    /**
+     * @return the number of NV_swap_group barriers of this window's GPU,
+     *         which is 0 without a frame lock device.
+     * @version 1.8
+     */
+    EQ_API virtual uint32_t getMaxNVSwapBarriers() { return 0; }
+    //@}
+
+    /** @name GPU to GPU copies. */
+    //@{
+    /**
+     * @return true if copyImage() is supported by this window.
+     * @version 1.9
+     */
+    virtual bool hasCopyImage() const { return false; }
+
+    /**
+     * Copy a texture of another window's context into this window's context.
+     *
+     * The textures are copied directly between the GPUs of both contexts,
+     * e.g., using NV_copy_image, without a readback to main memory. The
+     * source context has to have finished writing the source texture, and
+     * the destination texture has to be allocated.
+     *
+     * @param source the window owning the source texture.
+     * @param from the source texture.
+     * @param to the destination texture of this window's context.
+     * @param size the size of the copied area, starting at the origin.
+     * @return true if the texture was copied, false if unsupported.
+     * @version 1.9
+     */
+    virtual bool copyImage( const SystemWindow& /*source*/,
+                            const util::Texture& /*from*/,
+                            const util::Texture& /*to*/,
+                            const Vector2i& /*size*/ ) const
+        { return false; }
     //@}
 
     /** @name Frame Buffer Object support. */
@@ -113,6 +186,24 @@ public:
         const { return 0; }
     //@}
 
+    /** @name Main memory frame buffer support. */
+    //@{
+    /**
+     * @return the main memory frame buffer of the given buffer, or 0 if the
+     *         window renders using OpenGL.
+     * @version 1.9
+     */
+    virtual PixelData* getPixelData( const Frame::Buffer ) { return 0; }
+
+    /**
+     * @return the main memory frame buffer of the given buffer, or 0 if the
+     *         window renders using OpenGL.
+     * @version 1.9
+     */
+    virtual const PixelData* getPixelData( const Frame::Buffer ) const
+        { return 0; }
+    //@}
+
     /**
      * Set up the given drawable based on the current context.
      * @version 1.0
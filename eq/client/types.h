@@ -73,6 +73,7 @@ using fabric::FBO;
 using fabric::HORIZONTAL;
 using fabric::LOCAL_SYNC;
 using fabric::NICEST;
+using fabric::HISTOGRAM;
 using fabric::OFF;
 using fabric::ON;
 using fabric::PBUFFER;
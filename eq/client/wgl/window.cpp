@@ -26,6 +26,7 @@
 
 #include <eq/client/global.h>
 #include <eq/client/pipe.h>
+#include <eq/util/texture.h>
 
 #include <lunchbox/log.h>
 
@@ -66,6 +67,18 @@ public:
         return _wglPipe.wglewGetContext();
     }
 
+    bool hasCopyImage() { return _wglContext && WGLEW_NV_copy_image; }
+
+    bool copyImage( HGLRC source, const util::Texture& from,
+                    const util::Texture& to, const Vector2i& size )
+    {
+        return wglCopyImageSubDataNV( source, from.getName(),
+                                      from.getTarget(), 0, 0, 0, 0,
+                                      _wglContext, to.getName(),
+                                      to.getTarget(), 0, 0, 0, 0,
+                                      size.x(), size.y(), 1 ) == TRUE;
+    }
+
     /**
      * Set new device context and release the old DC.
      *
@@ -1051,6 +1064,37 @@ void Window::joinNVSwapBarrier( const uint32_t group, const uint32_t barrier)
            << std::endl;
 }
 
+uint32_t Window::getMaxNVSwapBarriers()
+{
+    if( !_impl->_wglDC || !WGLEW_NV_swap_group )
+        return 0;
+
+    uint32_t maxBarrier = 0;
+    uint32_t maxGroup = 0;
+    wglQueryMaxSwapGroupsNV( _impl->_wglDC, &maxGroup, &maxBarrier );
+    return maxGroup > 0 ? maxBarrier : 0;
+}
+
+bool Window::hasCopyImage() const
+{
+    return _impl->hasCopyImage();
+}
+
+bool Window::copyImage( const SystemWindow& source, const util::Texture& from,
+                        const util::Texture& to, const Vector2i& size ) const
+{
+    const WindowIF* sourceWindow = dynamic_cast< const WindowIF* >( &source );
+    if( !sourceWindow || !hasCopyImage( ))
+        return false;
+
+    if( _impl->copyImage( sourceWindow->getWGLContext(), from, to, size ))
+        return true;
+
+    LBWARN << "wglCopyImageSubDataNV failed: " << lunchbox::sysError
+           << std::endl;
+    return false;
+}
+
 void Window::leaveNVSwapBarrier()
 {
     if( _impl->_wglNVSwapGroup == 0 )
@@ -258,9 +258,21 @@ public:
                                            const uint32_t barrier );
 
 
+    /** @return the WGL_NV_swap_group barriers of the GPU. @version 1.8 */
+    EQ_API virtual uint32_t getMaxNVSwapBarriers();
+
     /** Unbind a WGL_NV_swap_barrier. @version 1.0 */
     void leaveNVSwapBarrier();
 
+    /** @return true if WGL_NV_copy_image is supported. @version 1.9 */
+    EQ_API virtual bool hasCopyImage() const;
+
+    /** Copy a texture of another WGL context, see WGL_NV_copy_image. */
+    EQ_API virtual bool copyImage( const SystemWindow& source,
+                                   const util::Texture& from,
+                                   const util::Texture& to,
+                                   const Vector2i& size ) const;
+
     /** @version 1.0 */
     EQ_API virtual bool processEvent( const WindowEvent& event );
     //@}
@@ -45,6 +45,7 @@
 #include <co/exception.h>
 #include <co/objectICommand.h>
 #include <lunchbox/sleep.h>
+#include <lunchbox/thread.h>
 
 namespace eq
 {
@@ -61,6 +62,33 @@ const char* _smallFontKey  = "eq_small_font";
 const char* _mediumFontKey = "eq_medium_font";
 }
 
+namespace detail
+{
+class WindowInitThread : public lunchbox::Thread
+{
+public:
+    WindowInitThread( eq::Window& window, const uint128_t& initID,
+                      co::NodePtr node )
+        : _window( window ), _initID( initID ), _node( node ) {}
+
+    void run() override
+    {
+        setName( std::string( "Init " ) + _window.getName( ));
+        const bool result = _window.configInit( _initID );
+
+        // hand the context over to the pipe thread
+        if( _window.getSystemWindow( ))
+            _window.getSystemWindow()->doneCurrent();
+        _window._configInitReply( _node, result );
+    }
+
+private:
+    eq::Window& _window;
+    const uint128_t _initID;
+    co::NodePtr _node;
+};
+}
+
 Window::Window( Pipe* parent )
         : Super( parent )
         , _sharedContextWindow( 0 ) // default set below
@@ -71,6 +99,12 @@ Window::Window( Pipe* parent )
         , _lastTime ( 0.0f )
         , _avgFPS ( 0.0f )
         , _lastSwapTime( 0 )
+        , _nvSwapGroup( 0 )
+        , _finishPending( false )
+        , _statsVersion( 0 )
+        , _statsWidth( 0 )
+        , _statsHeight( 0 )
+        , _initThread( 0 )
 {
     const Windows& windows = parent->getWindows();
     if( windows.empty( ))
@@ -82,6 +116,8 @@ Window::Window( Pipe* parent )
 Window::~Window()
 {
     LBASSERT( getChannels().empty( ));
+    _waitConfigInit();
+    delete _initThread;
 }
 
 void Window::attach( const uint128_t& id, const uint32_t instanceID )
@@ -113,6 +149,8 @@ void Window::attach( const uint128_t& id, const uint32_t instanceID )
                      WindowFunc( this, &Window::_cmdBarrier ), queue );
     registerCommand( fabric::CMD_WINDOW_NV_BARRIER,
                      WindowFunc( this, &Window::_cmdNVBarrier ), queue );
+    registerCommand( fabric::CMD_WINDOW_TIMED_BARRIER,
+                     WindowFunc( this, &Window::_cmdTimedBarrier ), queue );
     registerCommand( fabric::CMD_WINDOW_SWAP,
                      WindowFunc( this, &Window::_cmdSwap), queue );
     registerCommand( fabric::CMD_WINDOW_FRAME_DRAW_FINISH,
@@ -473,6 +511,9 @@ const util::BitmapFont* Window::getMediumFont()
 
 bool Window::configInitGL( const uint128_t& )
 {
+    if( !glewGetContext( ))
+        return true; // no OpenGL context, e.g., a memory::Window
+
     const bool coreProfile = getIAttribute(
                 WindowSettings::IATTR_HINT_CORE_PROFILE ) == ON;
     if( !coreProfile )
@@ -578,6 +619,7 @@ bool Window::configExitSystemWindow()
     // initialized
     LBASSERT( !_transferWindow );
 
+    getPipe()->exitAsyncLoader( this );
     _releaseObjectManager();
 
     if( _systemWindow )
@@ -619,6 +661,13 @@ void Window::updateFrameBuffer() const
         _systemWindow->updateFrameBuffer();
 }
 
+void Window::updateFrameBuffer( const PixelViewport& pvp ) const
+{
+    LBASSERT( _systemWindow );
+    if( _systemWindow )
+        _systemWindow->updateFrameBuffer( pvp );
+}
+
 void Window::swapBuffers()
 {
     _systemWindow->swapBuffers();
@@ -630,10 +679,31 @@ const GLEWContext* Window::glewGetContext() const
     return _systemWindow ? _systemWindow->glewGetContext() : 0;
 }
 
+void Window::_flushAssemblies()
+{
+    const Channels& channels = getChannels();
+    for( ChannelsCIter i = channels.begin(); i != channels.end(); ++i )
+        (*i)->flushAssembly();
+}
+
+void Window::_waitFinish()
+{
+    if( !_finishPending )
+        return;
+
+    _finishPending = false;
+    WindowStatistics stat( Statistic::WINDOW_FINISH, this );
+    makeCurrent();
+    if( !_systemWindow->waitFence( getConfig()->getTimeout() / 2 ))
+        LBWARN << "Timeout waiting for the rendering of " << getName()
+               << " to finish" << std::endl;
+}
+
 void Window::_enterBarrier( co::ObjectVersion barrier )
 {
     LBLOG( co::LOG_BARRIER ) << "swap barrier " << barrier << " " << getName()
                              << std::endl;
+    _waitFinish();
     Node* node = getNode();
     co::Barrier* netBarrier = node->getBarrier( barrier );
     if( !netBarrier )
@@ -703,6 +773,10 @@ bool Window::processEvent( const Event& event )
                                              event.resize.w, event.resize.h ));
             break;
 
+        case Event::STATISTIC:
+            getPipe()->addStatistic( event );
+            return true;
+
         case Event::KEY_PRESS:
         case Event::KEY_RELEASE:
             if( event.key.key == KC_VOID )
@@ -710,7 +784,6 @@ bool Window::processEvent( const Event& event )
             // else fall through
         case Event::WINDOW_EXPOSE:
         case Event::WINDOW_CLOSE:
-        case Event::STATISTIC:
         case Event::MAGELLAN_AXIS:
         case Event::MAGELLAN_BUTTON:
             break;
@@ -865,27 +938,68 @@ bool Window::_cmdDestroyChannel( co::ICommand& cmd )
     return true;
 }
 
+bool Window::_hasParallelInit() const
+{
+    const Pipe* pipe = getPipe();
+    return pipe->getIAttribute( Pipe::IATTR_HINT_PARALLEL_INIT ) == ON &&
+           pipe->getWindowSystem().hasParallelWindowInit();
+}
+
+void Window::_waitConfigInit() const
+{
+    if( _initThread )
+        _initThread->join();
+}
+
+void Window::_configInitReply( co::NodePtr node, const bool result )
+{
+    if( result )
+        _state = STATE_RUNNING;
+
+    LBLOG( LOG_INIT ) << "TASK window config init reply " << std::endl;
+
+    const uint32_t nvSwapBarriers =
+        result && _systemWindow ? _systemWindow->getMaxNVSwapBarriers() : 0;
+
+    commit();
+    send( node, fabric::CMD_WINDOW_CONFIG_INIT_REPLY )
+        << result << nvSwapBarriers;
+}
+
 bool Window::_cmdConfigInit( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
 
     LBLOG( LOG_INIT ) << "TASK window config init " << command << std::endl;
 
-    bool result = false;
-    if( getPipe()->isRunning( ))
+    if( !getPipe()->isRunning( ))
     {
-        _state = STATE_INITIALIZING;
-        result = configInit( command.read< uint128_t >( ));
-        if( result )
-            _state = STATE_RUNNING;
-    }
-    else
         sendError( ERROR_WINDOW_PIPE_NOTRUNNING );
+        _configInitReply( command.getRemoteNode(), false );
+        return true;
+    }
 
-    LBLOG( LOG_INIT ) << "TASK window config init reply " << std::endl;
+    // contexts are created sharing the context of the first window
+    if( _sharedContextWindow && _sharedContextWindow != this )
+        _sharedContextWindow->_waitConfigInit();
 
-    commit();
-    send( command.getRemoteNode(), fabric::CMD_WINDOW_CONFIG_INIT_REPLY ) << result;
+    _state = STATE_INITIALIZING;
+    const uint128_t initID = command.read< uint128_t >();
+    if( _hasParallelInit( ))
+    {
+        LBASSERT( !_initThread );
+        _initThread = new detail::WindowInitThread( *this, initID,
+                                                    command.getRemoteNode( ));
+        if( _initThread->start( ))
+            return true; // the init thread replies
+
+        LBWARN << "Window init thread start failed, initializing serially"
+               << std::endl;
+        delete _initThread;
+        _initThread = 0;
+    }
+
+    _configInitReply( command.getRemoteNode(), configInit( initID ));
     return true;
 }
 
@@ -895,6 +1009,11 @@ bool Window::_cmdConfigExit( co::ICommand& cmd )
 
     LBLOG( LOG_INIT ) << "TASK window config exit " << command << std::endl;
 
+    _waitConfigInit();
+    delete _initThread;
+    _initThread = 0;
+    _flushAssemblies();
+
     if( _state != STATE_STOPPED )
     {
         if( getPipe()->isRunning( ) && _systemWindow )
@@ -905,6 +1024,7 @@ bool Window::_cmdConfigExit( co::ICommand& cmd )
         // else emergency exit, no context available.
 
         _state = configExit() ? STATE_STOPPED : STATE_FAILED;
+        _nvSwapGroup = 0;
     }
 
     getPipe()->send( getLocalNode(),
@@ -928,6 +1048,7 @@ bool Window::_cmdFrameStart( co::ICommand& cmd )
 
     //_grabFrame( frameNumber ); single-threaded
     sync( version );
+    _flushAssemblies();
 
     const DrawableConfig& drawableConfig = getDrawableConfig();
     if( drawableConfig.doublebuffered )
@@ -948,6 +1069,7 @@ bool Window::_cmdFrameFinish( co::ICommand& cmd )
     const uint128_t& frameID = command.read< uint128_t >();
     const uint32_t frameNumber = command.read< uint32_t >();
 
+    _flushAssemblies();
     makeCurrent();
     frameFinish( frameID, frameNumber );
     return true;
@@ -955,15 +1077,19 @@ bool Window::_cmdFrameFinish( co::ICommand& cmd )
 
 bool Window::_cmdFlush( co::ICommand& )
 {
+    _flushAssemblies();
     flush();
     return true;
 }
 
 bool Window::_cmdFinish( co::ICommand& )
 {
-    WindowStatistics stat( Statistic::WINDOW_FINISH, this );
+    // Only fence the commands here, the wait happens right before the swap
+    // barrier. The window thread stays free for the tasks queued in between.
+    _flushAssemblies();
     makeCurrent();
-    finish();
+    _systemWindow->insertFence();
+    _finishPending = true;
     return true;
 }
 
@@ -974,9 +1100,28 @@ bool  Window::_cmdThrottleFramerate( co::ICommand& cmd )
     LBLOG( LOG_TASKS ) << "TASK throttle framerate " << getName() << " "
                        << command << std::endl;
 
+    const float minFrameTime = command.read< float >();
+    const bool pacing = command.read< bool >();
+    if( pacing )
+    {
+        // keep the swaps on an evenly spaced grid on the synchronized clock,
+        // restart the grid when more than one frame late
+        const int64_t now = getConfig()->getTime();
+        int64_t target = _lastSwapTime + int64_t( minFrameTime + .5f );
+        if( now > target + int64_t( minFrameTime ))
+            target = now;
+
+        if( target - now >= 1 )
+        {
+            WindowStatistics stat( Statistic::WINDOW_THROTTLE_FRAMERATE, this );
+            lunchbox::sleep( static_cast< uint32_t >( target - now ));
+        }
+        _lastSwapTime = target;
+        return true;
+    }
+
     // throttle to given framerate
     const int64_t elapsed  = getConfig()->getTime() - _lastSwapTime;
-    const float minFrameTime = command.read< float >();
     const float timeLeft = minFrameTime - static_cast<float>( elapsed );
 
     if( timeLeft >= 1.f )
@@ -997,6 +1142,7 @@ bool Window::_cmdBarrier( co::ICommand& cmd )
     LBVERB << "handle barrier " << command << " barrier " << barrier << std::endl;
     LBLOG( LOG_TASKS ) << "TASK swap barrier  " << getName() << std::endl;
 
+    _flushAssemblies();
     _enterBarrier( barrier );
     return true;
 }
@@ -1012,9 +1158,50 @@ bool Window::_cmdNVBarrier( co::ICommand& cmd )
     const uint32_t group = command.read< uint32_t >();
     const uint32_t barrier = command.read< uint32_t >();
 
+    _flushAssemblies();
     makeCurrent();
     _systemWindow->joinNVSwapBarrier( group, barrier );
-    _enterBarrier( netBarrier );
+    _nvSwapGroup = group;
+
+    // automatic hardware barriers join once and need no network barrier
+    if( netBarrier.version != co::VERSION_NONE )
+        _enterBarrier( netBarrier );
+    return true;
+}
+
+bool Window::_cmdTimedBarrier( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    const co::ObjectVersion& barrier = command.read< co::ObjectVersion >();
+    const uint32_t frameNumber = command.read< uint32_t >();
+    const int64_t startTime = command.read< int64_t >();
+    const int64_t deadline = command.read< int64_t >();
+
+    LBLOG( LOG_TASKS ) << "TASK timed swap barrier  " << getName()
+                       << " deadline " << deadline << std::endl;
+
+    _flushAssemblies();
+    _waitFinish();
+
+    // The config clock is synchronized with the server clock on each frame
+    // start. Report when this window is ready, the server predicts the next
+    // deadlines from the slowest window.
+    const int64_t time = getConfig()->getTime();
+    const bool late = deadline > 0 && time > deadline;
+    send( command.getRemoteNode(), fabric::CMD_WINDOW_BARRIER_ARRIVAL )
+        << frameNumber << time - startTime << late;
+
+    if( deadline == 0 ) // no prediction or a window was late
+    {
+        _enterBarrier( barrier );
+        return true;
+    }
+
+    if( !late )
+    {
+        WindowStatistics stat( Statistic::WINDOW_SWAP_BARRIER, this );
+        lunchbox::sleep( uint32_t( deadline - time ));
+    }
     return true;
 }
 
@@ -1025,11 +1212,23 @@ bool Window::_cmdSwap( co::ICommand& cmd )
     LBLOG( LOG_TASKS ) << "TASK swap buffers " << getName() << " " << command
                        << std::endl;
 
-    if( getDrawableConfig().doublebuffered )
+    _flushAssemblies();
+    if( !getDrawableConfig().doublebuffered )
+        return true;
+
+    makeCurrent();
+    _waitFinish();
+    if( _nvSwapGroup )
+    {
+        // The swap blocks in the hardware barrier, finish to include the
+        // wait in the statistic.
+        WindowStatistics stat( Statistic::WINDOW_SWAP_BARRIER, this );
+        swapBuffers();
+        finish();
+    }
+    else
     {
-        // swap
         WindowStatistics stat( Statistic::WINDOW_SWAP, this );
-        makeCurrent();
         swapBuffers();
     }
     return true;
@@ -1045,6 +1244,7 @@ bool Window::_cmdFrameDrawFinish( co::ICommand& cmd )
                        << " frame " << frameNumber << " id " << frameID
                        << std::endl;
 
+    _flushAssemblies();
     frameDrawFinish( frameID, frameNumber );
     return true;
 }
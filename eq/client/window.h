@@ -35,6 +35,8 @@
 
 namespace eq
 {
+namespace detail { class WindowInitThread; }
+
 /**
  * A Window represents an on-screen or off-screen drawable.
  *
@@ -247,6 +249,9 @@ public:
     /** @internal Blit from multisampled FBO to window FBO */
     EQ_API virtual void updateFrameBuffer() const;
 
+    /** @internal Blit an area from multisampled FBO to window FBO */
+    EQ_API virtual void updateFrameBuffer( const PixelViewport& pvp ) const;
+
     /** @internal Notify this window that the viewport has changed. */
     EQ_API virtual void notifyViewportChanged();
     //@}
@@ -279,6 +284,9 @@ public:
     /** @internal Create shared context window for asynchronuous usage. */
     bool createTransferWindow();
 
+    /** @internal @return true if the shared context window exists. */
+    bool hasTransferWindow() const { return _transferWindow != 0; }
+
     /** @internal delete the shared context window. */
     void deleteTransferSystemWindow();
     //@}
@@ -350,6 +358,11 @@ protected:
     /**
      * Initialize this window.
      *
+     * If the pipe has the parallel init hint set and the window system
+     * supports it, this method is called from a separate thread, concurrently
+     * with the initialization of the other windows of the pipe. The windows
+     * wait for the window sharing their context to be initialized first.
+     *
      * @param initID the init identifier.
      * @version 1.0
      */
@@ -463,12 +476,27 @@ private:
         BACK  = 1
     };
 
-    /** The time of the last swap command. */
+    /** The time of the last swap command, or its target time when pacing. */
     int64_t _lastSwapTime;
 
+    /** The joined NV_swap_group, or 0. */
+    uint32_t _nvSwapGroup;
+
+    /** A fence was inserted by the finish task and not yet waited on. */
+    bool _finishPending;
+
     /** List of channels that have grabbed the mouse. */
     Channels _grabbedChannels;
 
+    /** The statistics version and size of the cached statistics overlay. */
+    uint64_t _statsVersion;
+    uint32_t _statsWidth;
+    uint32_t _statsHeight;
+
+    /** Runs configInit() concurrently to the other windows of the pipe. */
+    detail::WindowInitThread* _initThread;
+    friend class detail::WindowInitThread;
+
     struct Private;
     Private* _private; // placeholder for binary-compatible changes
 
@@ -487,11 +515,26 @@ private:
     /** Calculates per-window frame rate */
     void _updateFPS();
 
+    /** Wait for the fence of the last finish task. */
+    void _waitFinish();
+
     /** Enter the given barrier. */
     void _enterBarrier( co::ObjectVersion barrier );
 
+    /** Run the deferred assemblies of all channels. */
+    void _flushAssemblies();
+
     void _updateEvent( Event& event );
 
+    /** @return true if configInit() may run outside of the pipe thread. */
+    bool _hasParallelInit() const;
+
+    /** Wait for a concurrent configInit() to finish. */
+    void _waitConfigInit() const;
+
+    /** Finish the initialization and reply to the server. */
+    void _configInitReply( co::NodePtr node, bool result );
+
     /* The command functions. */
     bool _cmdCreateChannel( co::ICommand& command );
     bool _cmdDestroyChannel(co::ICommand& command );
@@ -504,6 +547,7 @@ private:
     bool _cmdFinish( co::ICommand& command );
     bool _cmdBarrier( co::ICommand& command );
     bool _cmdNVBarrier( co::ICommand& command );
+    bool _cmdTimedBarrier( co::ICommand& command );
     bool _cmdSwap( co::ICommand& command );
     bool _cmdFrameDrawFinish( co::ICommand& command );
 
@@ -34,10 +34,10 @@ namespace eq
 
 WindowStatistics::WindowStatistics( const Statistic::Type type,
                                     Window* window )
-        : StatisticSampler< Window >( type, window )
+        : StatisticSampler< Window >( type, window, LB_UNDEFINED_UINT32,
+                  window->getIAttribute( WindowSettings::IATTR_HINT_STATISTICS ))
 {
-    const int32_t hint = _owner->getIAttribute( WindowSettings::IATTR_HINT_STATISTICS );
-    if( hint == OFF )
+    if( !isEnabled( ))
         return;
 
     const std::string& name = window->getName();
@@ -48,7 +48,7 @@ WindowStatistics::WindowStatistics( const Statistic::Type type,
         snprintf( event.data.statistic.resourceName, 32, "%s", name.c_str());
     event.data.statistic.resourceName[31] = 0;
 
-    if( type != Statistic::WINDOW_FPS && hint == NICEST )
+    if( type != Statistic::WINDOW_FPS && _hint == NICEST )
         window->finish();
 
     event.data.statistic.startTime  = window->getConfig()->getTime();
@@ -57,20 +57,22 @@ WindowStatistics::WindowStatistics( const Statistic::Type type,
 
 WindowStatistics::~WindowStatistics()
 {
-    const int32_t hint = _owner->getIAttribute( WindowSettings::IATTR_HINT_STATISTICS );
-    if( hint == OFF )
+    if( !isEnabled( ))
         return;
 
     if( event.data.statistic.frameNumber == 0 ) // does not belong to a frame
         return;
 
-    if( event.data.statistic.type != Statistic::WINDOW_FPS && hint == NICEST )
+    if( event.data.statistic.type != Statistic::WINDOW_FPS && _hint == NICEST )
         _owner->finish();
 
     event.data.statistic.endTime = _owner->getConfig()->getTime();
     if( event.data.statistic.endTime <= event.data.statistic.startTime )
         event.data.statistic.endTime = event.data.statistic.startTime + 1;
-    _owner->processEvent( event.data );
+    if( isLocal( ))
+        _owner->getConfig()->addLocalStatistic( event.data.statistic );
+    else
+        _owner->processEvent( event.data );
 }
 
 }
@@ -141,6 +141,12 @@ bool WindowSystem::hasMainThreadEvents() const
     return _impl->hasMainThreadEvents();
 }
 
+bool WindowSystem::hasParallelWindowInit() const
+{
+    LBASSERT( _impl );
+    return _impl->hasParallelWindowInit();
+}
+
 bool WindowSystem::operator == ( const WindowSystem& other) const
 {
     return _impl == other._impl;
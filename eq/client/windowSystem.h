@@ -94,6 +94,13 @@ protected:
      */
     virtual bool hasMainThreadEvents() const { return false; }
 
+    /**
+     * @return true if the windows of a pipe can be initialized by several
+     *         threads concurrently.
+     * @version 1.9
+     */
+    virtual bool hasParallelWindowInit() const { return false; }
+
 private:
     WindowSystemIF* _next;
     friend class WindowSystem;
@@ -122,6 +129,7 @@ public:
     EQ_API bool setupFont( util::ObjectManager& gl, const void* key,
                            const std::string& name, const uint32_t size ) const;
     EQ_API bool hasMainThreadEvents() const;
+    EQ_API bool hasParallelWindowInit() const;
 
     EQ_API bool operator == ( const WindowSystem& other ) const;
     EQ_API bool operator != ( const WindowSystem& other ) const;
@@ -290,16 +290,36 @@ public:
         IATTR_HINT_STATISTICS,
         /** Use a send token for output frames (OFF, ON) */
         IATTR_HINT_SENDTOKEN,
+        /** Rows per transmitted output frame band (OFF, AUTO, rows) */
+        IATTR_HINT_TRANSMIT_ROWS,
+        /** Defer assembly until the input frames are ready (OFF, ON) */
+        IATTR_HINT_ASYNC_ASSEMBLY,
+        /** Reproject late frames (OFF, ON, AUTO, display interval in ms) */
+        IATTR_HINT_REPROJECTION,
+        /** Draw both stereo eyes in one pass (OFF, ON) */
+        IATTR_HINT_MULTIVIEW,
+        /** Read back remote tiles in batches (OFF, ON, tiles per batch) */
+        IATTR_HINT_TILE_ATLAS,
+        /** Accumulate jittered, upscaled input frames over time (OFF, ON) */
+        IATTR_HINT_TEMPORAL_UPSAMPLING,
+        /** Send unchanged blocks of output frames only once (OFF, ON) */
+        IATTR_HINT_TEMPORAL_TRANSMIT,
+        /** Repeat output frames not sent within this time (OFF, ms) */
+        IATTR_HINT_TRANSMIT_DEADLINE,
         IATTR_LAST,
-        IATTR_ALL = IATTR_LAST + 5
+        IATTR_ALL = IATTR_LAST + 1
     };
 
     /** String attributes. */
     enum SAttribute
     {
         SATTR_DUMP_IMAGE,
+        /** Publish the result images to the named shared memory segment */
+        SATTR_SHARED_MEMORY,
+        /** Replace rendering by recorded images from this file template */
+        SATTR_PLAYBACK_IMAGES,
         SATTR_LAST,
-        SATTR_ALL = SATTR_LAST + 5
+        SATTR_ALL = SATTR_LAST + 3
     };
 
     /** @return the value of an integer attribute. @version 1.0 */
@@ -358,12 +378,12 @@ protected:
     //@}
 
     /** @internal */
-    void setIAttribute( const IAttribute attr, const int32_t value )
-        { _iAttributes[attr] = value; setDirty( DIRTY_ATTRIBUTES ); }
+    EQFABRIC_INL void setIAttribute( const IAttribute attr,
+                                     const int32_t value );
 
     /** @internal */
-    void setSAttribute( const SAttribute attr, const std::string& value )
-        { _sAttributes[attr] = value; setDirty( DIRTY_ATTRIBUTES ); }
+    EQFABRIC_INL void setSAttribute( const SAttribute attr,
+                                     const std::string& value );
 
     /** @internal */
     virtual ChangeType getChangeType() const { return UNBUFFERED; }
@@ -414,6 +434,10 @@ private:
     /** String attributes. */
     std::string _sAttributes[SATTR_ALL];
 
+    /** Changed integer and string attributes, see DIRTY_ATTRIBUTES. */
+    uint64_t _dirtyIAttributes;
+    uint64_t _dirtySAttributes;
+
     /** Overdraw limiter */
     Vector2i    _maxSize;
 
@@ -19,6 +19,7 @@
 
 #include "channel.h"
 
+#include "fieldMask.h"
 #include "leafVisitor.h"
 #include "log.h"
 #include "task.h"
@@ -35,11 +36,21 @@ namespace
 #define MAKE_ATTR_STRING( attr ) ( std::string("EQ_CHANNEL_") + #attr )
 static std::string _iAttributeStrings[] = {
     MAKE_ATTR_STRING( IATTR_HINT_STATISTICS ),
-    MAKE_ATTR_STRING( IATTR_HINT_SENDTOKEN )
+    MAKE_ATTR_STRING( IATTR_HINT_SENDTOKEN ),
+    MAKE_ATTR_STRING( IATTR_HINT_TRANSMIT_ROWS ),
+    MAKE_ATTR_STRING( IATTR_HINT_ASYNC_ASSEMBLY ),
+    MAKE_ATTR_STRING( IATTR_HINT_REPROJECTION ),
+    MAKE_ATTR_STRING( IATTR_HINT_MULTIVIEW ),
+    MAKE_ATTR_STRING( IATTR_HINT_TILE_ATLAS ),
+    MAKE_ATTR_STRING( IATTR_HINT_TEMPORAL_UPSAMPLING ),
+    MAKE_ATTR_STRING( IATTR_HINT_TEMPORAL_TRANSMIT ),
+    MAKE_ATTR_STRING( IATTR_HINT_TRANSMIT_DEADLINE )
 };
 
 static std::string _sAttributeStrings[] = {
-    MAKE_ATTR_STRING( SATTR_DUMP_IMAGE )
+    MAKE_ATTR_STRING( SATTR_DUMP_IMAGE ),
+    MAKE_ATTR_STRING( SATTR_SHARED_MEMORY ),
+    MAKE_ATTR_STRING( SATTR_PLAYBACK_IMAGES )
 };
 }
 
@@ -47,6 +58,8 @@ template< class W, class C >
 Channel< W, C >::Channel( W* parent )
         : _window( parent )
         , _context( &_data.nativeContext )
+        , _dirtyIAttributes( 0 )
+        , _dirtySAttributes( 0 )
         , _maxSize( Vector2i::ZERO )
 {
     memset( _iAttributes, 0xff, IATTR_ALL * sizeof( int32_t ));
@@ -60,6 +73,8 @@ Channel< W, C >::Channel( const Channel& from )
         , _window( from._window )
         , _data( from._data )
         , _context( &_data.nativeContext )
+        , _dirtyIAttributes( 0 )
+        , _dirtySAttributes( 0 )
         , _maxSize( from._maxSize )
 {
     _window->_addChannel( static_cast< C* >( this ));
@@ -119,8 +134,18 @@ void Channel< W, C >::serialize( co::DataOStream& os, const uint64_t dirtyBits )
               getWindow()->Serializable::isDirty( W::DIRTY_CHANNELS ));
     Object::serialize( os, dirtyBits );
     if( dirtyBits & DIRTY_ATTRIBUTES )
-        os << co::Array< int32_t >( _iAttributes, IATTR_ALL )
-           << co::Array< std::string >( _sAttributes, SATTR_ALL );
+    {
+        // instance data is complete, deltas only contain the changed values
+        const bool all = ( dirtyBits == DIRTY_ALL );
+        fieldMask::serialize( os, _iAttributes, IATTR_ALL,
+                              all ? fieldMask::all( IATTR_ALL ) :
+                                    _dirtyIAttributes );
+        fieldMask::serialize( os, _sAttributes, SATTR_ALL,
+                              all ? fieldMask::all( SATTR_ALL ) :
+                                    _dirtySAttributes );
+        if( !all )
+            _dirtyIAttributes = _dirtySAttributes = 0;
+    }
     if( dirtyBits & DIRTY_VIEWPORT )
         os << _data.nativeContext.vp << _data.nativeContext.pvp
            << _data.fixedVP << _maxSize;
@@ -138,8 +163,17 @@ void Channel< W, C >::deserialize( co::DataIStream& is,
 {
     Object::deserialize( is, dirtyBits );
     if( dirtyBits & DIRTY_ATTRIBUTES )
-        is >> co::Array< int32_t >( _iAttributes, IATTR_ALL )
-           >> co::Array< std::string >( _sAttributes, SATTR_ALL );
+    {
+        const uint64_t iMask = fieldMask::deserialize( is, _iAttributes,
+                                                       IATTR_ALL );
+        const uint64_t sMask = fieldMask::deserialize( is, _sAttributes,
+                                                       SATTR_ALL );
+        if( isMaster( )) // redistribute changes
+        {
+            _dirtyIAttributes |= iMask;
+            _dirtySAttributes |= sMask;
+        }
+    }
     if( dirtyBits & DIRTY_VIEWPORT )
     {
         // Ignore data from master (server) if we have local changes
@@ -333,6 +367,30 @@ ChannelPath Channel< W, C >::getPath() const
 }
 
 
+template< class W, class C >
+void Channel< W, C >::setIAttribute( const IAttribute attr,
+                                     const int32_t value )
+{
+    if( _iAttributes[ attr ] == value )
+        return;
+
+    _iAttributes[ attr ] = value;
+    _dirtyIAttributes |= uint64_t( 1 ) << attr;
+    setDirty( DIRTY_ATTRIBUTES );
+}
+
+template< class W, class C >
+void Channel< W, C >::setSAttribute( const SAttribute attr,
+                                     const std::string& value )
+{
+    if( _sAttributes[ attr ] == value )
+        return;
+
+    _sAttributes[ attr ] = value;
+    _dirtySAttributes |= uint64_t( 1 ) << attr;
+    setDirty( DIRTY_ATTRIBUTES );
+}
+
 template< class W, class C >
 int32_t Channel< W, C >::getIAttribute( const IAttribute attr ) const
 {
@@ -89,6 +89,10 @@ namespace fabric
         CMD_CONFIG_SYNC_CLOCK,
         CMD_CONFIG_SWAP_OBJECT,
         CMD_CONFIG_CHECK_FRAME,
+        CMD_CONFIG_DUMP_TRACE,
+        CMD_CONFIG_EXCHANGE,
+        CMD_CONFIG_GET_METRICS,
+        CMD_CONFIG_GET_METRICS_REPLY,
         CMD_CONFIG_CUSTOM = CMD_OBJECT_CUSTOM + 30
     };
 
@@ -152,6 +156,8 @@ namespace fabric
         CMD_WINDOW_FRAME_DRAW_FINISH,
         CMD_WINDOW_CREATE_QGL_WIDGET,
         CMD_WINDOW_DESTROY_QGL_WIDGET,
+        CMD_WINDOW_TIMED_BARRIER,
+        CMD_WINDOW_BARRIER_ARRIVAL,
         CMD_WINDOW_CUSTOM = CMD_OBJECT_CUSTOM + 20
     };
 
@@ -178,6 +184,10 @@ namespace fabric
         CMD_CHANNEL_FRAME_TILES,
         CMD_CHANNEL_FINISH_READBACK,
         CMD_CHANNEL_DELETE_TRANSFER_CONTEXT,
+        CMD_CHANNEL_WAIT_ASSEMBLY,
+        CMD_CHANNEL_FINISH_ASSEMBLY,
+        CMD_CHANNEL_REPROJECT,
+        CMD_CHANNEL_FRAME_DRAW_MULTIVIEW,
         CMD_CHANNEL_CUSTOM = CMD_OBJECT_CUSTOM + 30
     };
 
@@ -137,8 +137,23 @@ namespace fabric
         enum IAttribute
         {
             IATTR_ROBUSTNESS, //!< Tolerate resource failures
+            IATTR_TRACE_EVENTS, //!< Size of the server's statistics trace
+            /** Send the statistics of every Nth frame to the application */
+            IATTR_STATISTICS_INTERVAL,
+            /** Statistics sent per second and pipe to the application */
+            IATTR_STATISTICS_BUDGET,
+            /** TCP port of the application's metrics endpoint */
+            IATTR_METRICS_PORT,
+            /** Keep the inactive layouts of all canvases initialized */
+            IATTR_DORMANT_LAYOUTS,
+            /** Skip rendering frames where nothing changed */
+            IATTR_STATIC_FRAMES,
+            /** Priority of the config on GPUs shared with other configs */
+            IATTR_GPU_PRIORITY,
+            /** Share of the config on GPUs shared within its priority */
+            IATTR_GPU_WEIGHT,
             IATTR_LAST,
-            IATTR_ALL = IATTR_LAST + 5
+            IATTR_ALL = IATTR_LAST + 1
         };
 
         /** @internal */
@@ -45,6 +45,14 @@ std::string _fAttributeStrings[] =
 std::string _iAttributeStrings[] =
 {
     MAKE_ATTR_STRING( IATTR_ROBUSTNESS ),
+    MAKE_ATTR_STRING( IATTR_TRACE_EVENTS ),
+    MAKE_ATTR_STRING( IATTR_STATISTICS_INTERVAL ),
+    MAKE_ATTR_STRING( IATTR_STATISTICS_BUDGET ),
+    MAKE_ATTR_STRING( IATTR_METRICS_PORT ),
+    MAKE_ATTR_STRING( IATTR_DORMANT_LAYOUTS ),
+    MAKE_ATTR_STRING( IATTR_STATIC_FRAMES ),
+    MAKE_ATTR_STRING( IATTR_GPU_PRIORITY ),
+    MAKE_ATTR_STRING( IATTR_GPU_WEIGHT ),
 };
 }
 
@@ -910,8 +918,40 @@ std::ostream& operator << ( std::ostream& os,
 
     os << "attributes" << std::endl << "{" << std::endl << lunchbox::indent
        << "robustness "
-       << IAttribute( config.getIAttribute( C::IATTR_ROBUSTNESS )) << std::endl
-       << "eye_base   " << config.getFAttribute( C::FATTR_EYE_BASE )
+       << IAttribute( config.getIAttribute( C::IATTR_ROBUSTNESS )) << std::endl;
+    if( config.getIAttribute( C::IATTR_TRACE_EVENTS ) != OFF )
+        os << "trace_events "
+           << IAttribute( config.getIAttribute( C::IATTR_TRACE_EVENTS ))
+           << std::endl;
+    if( config.getIAttribute( C::IATTR_STATISTICS_INTERVAL ) != AUTO )
+        os << "statistics_interval " << IAttribute(
+                  config.getIAttribute( C::IATTR_STATISTICS_INTERVAL ))
+           << std::endl;
+    if( config.getIAttribute( C::IATTR_STATISTICS_BUDGET ) != OFF )
+        os << "statistics_budget " << IAttribute(
+                  config.getIAttribute( C::IATTR_STATISTICS_BUDGET ))
+           << std::endl;
+    if( config.getIAttribute( C::IATTR_METRICS_PORT ) != OFF )
+        os << "metrics_port " << IAttribute(
+                  config.getIAttribute( C::IATTR_METRICS_PORT ))
+           << std::endl;
+    if( config.getIAttribute( C::IATTR_DORMANT_LAYOUTS ) != OFF )
+        os << "dormant_layouts " << IAttribute(
+                  config.getIAttribute( C::IATTR_DORMANT_LAYOUTS ))
+           << std::endl;
+    if( config.getIAttribute( C::IATTR_STATIC_FRAMES ) != OFF )
+        os << "static_frames " << IAttribute(
+                  config.getIAttribute( C::IATTR_STATIC_FRAMES ))
+           << std::endl;
+    if( config.getIAttribute( C::IATTR_GPU_PRIORITY ) != OFF )
+        os << "gpu_priority " << IAttribute(
+                  config.getIAttribute( C::IATTR_GPU_PRIORITY ))
+           << std::endl;
+    if( config.getIAttribute( C::IATTR_GPU_WEIGHT ) != AUTO )
+        os << "gpu_weight " << IAttribute(
+                  config.getIAttribute( C::IATTR_GPU_WEIGHT ))
+           << std::endl;
+    os << "eye_base   " << config.getFAttribute( C::FATTR_EYE_BASE )
        << std::endl
        << lunchbox::exdent << "}" << std::endl;
 
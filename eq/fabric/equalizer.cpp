@@ -45,6 +45,13 @@ public:
         , tilesize( 64, 64 )
         , mode( fabric::Equalizer::MODE_2D )
         , frozen( false )
+        , predictive( false )
+        , nodeDamping( -1.f )
+        , nodeBoundaryf( 0.f )
+        , nodeResistancef( -1.f )
+        , nodeBoundary2i( 0, 0 )
+        , nodeResistance2i( -1, -1 )
+        , nodeAligned( false )
     {
         const uint32_t flags = eq::fabric::Global::getFlags();
         switch( flags & fabric::ConfigParams::FLAG_LOAD_EQ_ALL )
@@ -76,6 +83,13 @@ public:
         , tilesize( rhs.tilesize )
         , mode( rhs.mode )
         , frozen( rhs.frozen )
+        , predictive( rhs.predictive )
+        , nodeDamping( rhs.nodeDamping )
+        , nodeBoundaryf( rhs.nodeBoundaryf )
+        , nodeResistancef( rhs.nodeResistancef )
+        , nodeBoundary2i( rhs.nodeBoundary2i )
+        , nodeResistance2i( rhs.nodeResistance2i )
+        , nodeAligned( rhs.nodeAligned )
     {}
 
     float damping;
@@ -88,6 +102,13 @@ public:
     Vector2i tilesize;
     fabric::Equalizer::Mode mode;
     bool frozen;
+    bool predictive;
+    float nodeDamping;       // < 0: use damping
+    float nodeBoundaryf;     // <= 0: use boundaryf
+    float nodeResistancef;   // < 0: use resistancef
+    Vector2i nodeBoundary2i; // x <= 0: use boundary2i
+    Vector2i nodeResistance2i; // x < 0: use resistance2i
+    bool nodeAligned;
 };
 }
 
@@ -218,12 +239,91 @@ const Vector2i& Equalizer::getTileSize() const
     return _data->tilesize;
 }
 
+void Equalizer::setPredictive( const bool onOff )
+{
+    _data->predictive = onOff;
+}
+
+bool Equalizer::isPredictive() const
+{
+    return _data->predictive;
+}
+
+void Equalizer::setNodeDamping( const float damping )
+{
+    _data->nodeDamping = damping;
+}
+
+float Equalizer::getNodeDamping() const
+{
+    return _data->nodeDamping < 0.f ? _data->damping : _data->nodeDamping;
+}
+
+void Equalizer::setNodeBoundary( const Vector2i& boundary )
+{
+    LBASSERT( boundary.x() > 0 && boundary.y() > 0 );
+    _data->nodeBoundary2i = boundary;
+}
+
+void Equalizer::setNodeBoundary( const float boundary )
+{
+    LBASSERT( boundary > 0.0f );
+    _data->nodeBoundaryf = boundary;
+}
+
+const Vector2i& Equalizer::getNodeBoundary2i() const
+{
+    return _data->nodeBoundary2i.x() <= 0 ? _data->boundary2i :
+                                            _data->nodeBoundary2i;
+}
+
+float Equalizer::getNodeBoundaryf() const
+{
+    return _data->nodeBoundaryf <= 0.f ? _data->boundaryf :
+                                         _data->nodeBoundaryf;
+}
+
+void Equalizer::setNodeResistance( const Vector2i& resistance )
+{
+    _data->nodeResistance2i = resistance;
+}
+
+void Equalizer::setNodeResistance( const float resistance )
+{
+    _data->nodeResistancef = resistance;
+}
+
+const Vector2i& Equalizer::getNodeResistance2i() const
+{
+    return _data->nodeResistance2i.x() < 0 ? _data->resistance2i :
+                                             _data->nodeResistance2i;
+}
+
+float Equalizer::getNodeResistancef() const
+{
+    return _data->nodeResistancef < 0.f ? _data->resistancef :
+                                          _data->nodeResistancef;
+}
+
+void Equalizer::setNodeAligned( const bool onOff )
+{
+    _data->nodeAligned = onOff;
+}
+
+bool Equalizer::isNodeAligned() const
+{
+    return _data->nodeAligned;
+}
+
 void Equalizer::serialize( co::DataOStream& os ) const
 {
     os << _data->damping << _data->boundaryf << _data->resistancef
        << _data->assembleOnlyLimit << _data->frameRate << _data->boundary2i
        << _data->resistance2i << _data->tilesize << _data->mode
-       << _data->frozen;
+       << _data->frozen << _data->predictive << _data->nodeDamping
+       << _data->nodeBoundaryf << _data->nodeResistancef
+       << _data->nodeBoundary2i << _data->nodeResistance2i
+       << _data->nodeAligned;
 }
 
 void Equalizer::deserialize( co::DataIStream& is )
@@ -231,7 +331,10 @@ void Equalizer::deserialize( co::DataIStream& is )
     is >> _data->damping >> _data->boundaryf >> _data->resistancef
        >> _data->assembleOnlyLimit >> _data->frameRate >> _data->boundary2i
        >> _data->resistance2i >> _data->tilesize >> _data->mode
-       >> _data->frozen;
+       >> _data->frozen >> _data->predictive >> _data->nodeDamping
+       >> _data->nodeBoundaryf >> _data->nodeResistancef
+       >> _data->nodeBoundary2i >> _data->nodeResistance2i
+       >> _data->nodeAligned;
 }
 
 void Equalizer::backup()
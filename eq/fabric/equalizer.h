@@ -119,6 +119,68 @@ public:
 
     /** @return the tile size for the TileEqualizer. */
     EQFABRIC_API const Vector2i& getTileSize() const;
+
+    /**
+     * Enable predictive load balancing in the LoadEqualizer.
+     *
+     * When enabled, splits are computed from a screen-space cost grid learned
+     * from past frames and extrapolated to the current frame, instead of the
+     * raw timings of the last finished frame.
+     * @version 1.8
+     */
+    EQFABRIC_API void setPredictive( const bool onOff );
+
+    /** @return true if predictive load balancing is enabled. @version 1.8 */
+    EQFABRIC_API bool isPredictive() const;
+
+    /**
+     * Set the damping factor for splits between different nodes.
+     *
+     * Splits separating channels on different nodes move image data over the
+     * network and typically adapt slower than splits within one node. If not
+     * set, the normal damping factor is used.
+     * @version 1.8
+     */
+    EQFABRIC_API void setNodeDamping( const float damping );
+
+    /** @return the damping factor for splits between nodes. @version 1.8 */
+    EQFABRIC_API float getNodeDamping() const;
+
+    /** Set a boundary for 2D tiles between nodes. @version 1.8 */
+    EQFABRIC_API void setNodeBoundary( const Vector2i& boundary );
+
+    /** Set a boundary for DB ranges between nodes. @version 1.8 */
+    EQFABRIC_API void setNodeBoundary( const float boundary );
+
+    /** @return the boundary for 2D tiles between nodes. @version 1.8 */
+    EQFABRIC_API const Vector2i& getNodeBoundary2i() const;
+
+    /** @return the boundary for DB ranges between nodes. @version 1.8 */
+    EQFABRIC_API float getNodeBoundaryf() const;
+
+    /** Set a resistance for 2D tiles between nodes. @version 1.8 */
+    EQFABRIC_API void setNodeResistance( const Vector2i& resistance );
+
+    /** Set a resistance for DB ranges between nodes. @version 1.8 */
+    EQFABRIC_API void setNodeResistance( const float resistance );
+
+    /** @return the resistance for 2D tiles between nodes. @version 1.8 */
+    EQFABRIC_API const Vector2i& getNodeResistance2i() const;
+
+    /** @return the resistance for DB ranges between nodes. @version 1.8 */
+    EQFABRIC_API float getNodeResistancef() const;
+
+    /**
+     * Align the LoadEqualizer splits to node boundaries.
+     *
+     * When enabled, the children are grouped by node, and the top-most splits
+     * only separate groups, so that each node renders one contiguous region.
+     * @version 1.8
+     */
+    EQFABRIC_API void setNodeAligned( const bool onOff );
+
+    /** @return true if splits are aligned to node boundaries. @version 1.8 */
+    EQFABRIC_API bool isNodeAligned() const;
     //@}
 
     EQFABRIC_API void serialize( co::DataOStream& os ) const; //!< @internal
@@ -83,6 +83,9 @@ ErrorData _errors[] = {
     { ERROR_GLXPIPE_GLX_NOTFOUND, "Display does not support GLX" },
     { ERROR_GLXPIPE_GLXEWINIT_FAILED, "Pipe GLXEW initialization failed" },
 
+    { ERROR_EGLPIPE_DEVICE_NOTFOUND, "Can't find EGL device" },
+    { ERROR_EGLPIPE_INIT_FAILED, "Can't initialize EGL display" },
+
     { ERROR_WGL_CREATEAFFINITYDC_FAILED, "Can't create affinity DC" },
     { ERROR_WGLPIPE_ENUMDISPLAYS_FAILED, "Can't enumerate display devices" },
     { ERROR_WGLPIPE_CREATEDC_FAILED, "Can't create device context" },
@@ -120,6 +123,10 @@ ErrorData _errors[] = {
     { ERROR_GLXWINDOW_FBCONFIG_REQUIRED,
       "Can't find FBConfig functions (GLX 1.3 or GLX_SGIX_fbconfig" },
 
+    { ERROR_EGLWINDOW_NO_DISPLAY, "Missing EGL display" },
+    { ERROR_EGLWINDOW_CREATECONTEXT_FAILED, "Can't create EGL context" },
+    { ERROR_EGLWINDOW_CREATEPBUFFER_FAILED, "Can't create EGL PBuffer" },
+
     { ERROR_WGLWINDOW_NO_DRAWABLE, "Missing WGL drawable" },
     { ERROR_WGLWINDOW_SETPIXELFORMAT_FAILED, "Can't set window pixel format" },
     { ERROR_WGLWINDOW_REGISTERCLASS_FAILED, "Can't register window class" },
@@ -139,6 +146,9 @@ ErrorData _errors[] = {
     { ERROR_PBO_SIZE_TOO_SMALL, "PBO size is too small, it has to be > 0" },
     { ERROR_PBO_TYPE_UNSUPPORTED, "Unsupported PBO type" },
 
+    { ERROR_QTWINDOW_CREATECONTEXT_FAILED, "Can't create Qt OpenGL context" },
+    { ERROR_QTWINDOW_CREATESURFACE_FAILED, "Can't create Qt surface" },
+
     { 0, "" } // last!
 };
 }
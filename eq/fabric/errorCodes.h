@@ -56,6 +56,8 @@ enum ErrorCode
     ERROR_GLXPIPE_DEVICE_NOTFOUND,
     ERROR_GLXPIPE_GLX_NOTFOUND,
     ERROR_GLXPIPE_GLXEWINIT_FAILED,
+    ERROR_EGLPIPE_DEVICE_NOTFOUND,
+    ERROR_EGLPIPE_INIT_FAILED,
     ERROR_WGL_CREATEAFFINITYDC_FAILED,
     ERROR_WGLPIPE_ENUMDISPLAYS_FAILED,
     ERROR_WGLPIPE_CREATEDC_FAILED,
@@ -84,6 +86,9 @@ enum ErrorCode
     ERROR_GLXWINDOW_NO_VISUAL,
     ERROR_GLXWINDOW_CREATEPBUFFER_FAILED,
     ERROR_GLXWINDOW_FBCONFIG_REQUIRED,
+    ERROR_EGLWINDOW_NO_DISPLAY,
+    ERROR_EGLWINDOW_CREATECONTEXT_FAILED,
+    ERROR_EGLWINDOW_CREATEPBUFFER_FAILED,
     ERROR_WGLWINDOW_NO_DRAWABLE,
     ERROR_WGLWINDOW_SETPIXELFORMAT_FAILED,
     ERROR_WGLWINDOW_REGISTERCLASS_FAILED,
@@ -99,6 +104,8 @@ enum ErrorCode
     ERROR_PBO_NOT_INITIALIZED,
     ERROR_PBO_SIZE_TOO_SMALL,
     ERROR_PBO_TYPE_UNSUPPORTED,
+    ERROR_QTWINDOW_CREATECONTEXT_FAILED,
+    ERROR_QTWINDOW_CREATESURFACE_FAILED,
 
     ERROR_CUSTOM = LB_64KB, // 0x10000
 };
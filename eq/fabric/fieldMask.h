@@ -0,0 +1,113 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQFABRIC_FIELDMASK_H
+#define EQFABRIC_FIELDMASK_H
+
+#include <co/dataIStream.h>
+#include <co/dataOStream.h>
+#include <lunchbox/debug.h>
+
+namespace eq
+{
+namespace fabric
+{
+/**
+ * @internal Field-level delta encoding of array members.
+ *
+ * The setters of an object record the changed elements of an array in a field
+ * mask. serialize() writes the mask as a variable-length integer followed by
+ * the changed elements, and deserialize() applies them. The instance data of
+ * an object is written with all bits set.
+ */
+namespace fieldMask
+{
+/** @return the mask with the lowest n bits set. */
+inline uint64_t all( const size_t n )
+{
+    LBASSERT( n <= 64 );
+    return n >= 64 ? ~uint64_t( 0 ) : ( uint64_t( 1 ) << n ) - 1;
+}
+
+/** @return the mask of the elements differing between a and b. */
+template< class T >
+uint64_t getChanged( const T* a, const T* b, const size_t n )
+{
+    LBASSERT( n <= 64 );
+    uint64_t mask = 0;
+    for( size_t i = 0; i < n; ++i )
+        if( a[i] != b[i] )
+            mask |= uint64_t( 1 ) << i;
+    return mask;
+}
+
+/** Write an unsigned integer using seven bits per byte. */
+inline void writeVarint( co::DataOStream& os, uint64_t value )
+{
+    do
+    {
+        uint8_t byte = uint8_t( value & 0x7fu );
+        value >>= 7;
+        if( value )
+            byte |= 0x80u;
+        os << byte;
+    }
+    while( value );
+}
+
+/** @return an unsigned integer written by writeVarint(). */
+inline uint64_t readVarint( co::DataIStream& is )
+{
+    uint64_t value = 0;
+    for( unsigned shift = 0; shift < 64; shift += 7 )
+    {
+        uint8_t byte = 0;
+        is >> byte;
+        value |= uint64_t( byte & 0x7fu ) << shift;
+        if( !( byte & 0x80u ))
+            break;
+    }
+    return value;
+}
+
+/** Write the mask and the elements selected by it. */
+template< class T >
+void serialize( co::DataOStream& os, const T* values, const size_t n,
+                const uint64_t mask )
+{
+    writeVarint( os, mask );
+    for( size_t i = 0; i < n; ++i )
+        if( mask & ( uint64_t( 1 ) << i ))
+            os << values[i];
+}
+
+/** Read the elements written by serialize(). @return the mask. */
+template< class T >
+uint64_t deserialize( co::DataIStream& is, T* values, const size_t n )
+{
+    const uint64_t mask = readVarint( is );
+    LBASSERT( ( mask & ~all( n )) == 0 );
+    for( size_t i = 0; i < n; ++i )
+        if( mask & ( uint64_t( 1 ) << i ))
+            is >> values[i];
+    return mask;
+}
+}
+}
+}
+
+#endif // EQFABRIC_FIELDMASK_H
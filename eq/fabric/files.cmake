@@ -63,6 +63,8 @@ set(EQ_FABRIC_PUBLIC_HEADERS
   )
 
 set(EQ_FABRIC_HEADERS
+  fieldMask.h
+  metricsExporter.h
   nameFinder.h
   canvas.ipp
   channel.ipp
@@ -92,6 +94,7 @@ set(EQ_FABRIC_SOURCES
   global.cpp
   iAttribute.cpp
   init.cpp
+  metricsExporter.cpp
   object.cpp
   pixel.cpp
   projection.cpp
@@ -163,6 +163,10 @@ std::ostream& operator << ( std::ostream& os, const Frame::Type type )
         os << " texture" << std::endl;
     else if ( type == Frame::TYPE_MEMORY )
         os << " memory" << std::endl;
+    else if ( type == Frame::TYPE_EXTERNAL )
+        os << " external" << std::endl;
+    else if ( type == Frame::TYPE_DRAWABLE )
+        os << " drawable" << std::endl;
 
     return os;
 }
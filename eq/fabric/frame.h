@@ -50,7 +50,11 @@ namespace detail { class Frame; }
         enum Type
         {
             TYPE_MEMORY,    //!< use main memory to store pixel data
-            TYPE_TEXTURE    //!< use a GL texture to store pixel data
+            TYPE_TEXTURE,   //!< use a GL texture to store pixel data
+            /** GPU memory of another API, see Image::setExternalMemory() */
+            TYPE_EXTERNAL,
+            /** The textures of the source FBO, see Image::setDrawable() */
+            TYPE_DRAWABLE
         };
 
         /** Construct a new frame. @version 1.0 */
@@ -35,6 +35,7 @@ std::ostream& operator << ( std::ostream& os, const IAttribute value )
         case OFF:           os << "OFF"; break;
         case AUTO:          os << "AUTO"; break;
         case NICEST:        os << "NICEST"; break;
+        case HISTOGRAM:     os << "HISTOGRAM"; break;
         case PASSIVE:       os << "PASSIVE"; break;
         case ANAGLYPH:      os << "ANAGLYPH"; break;
         case QUAD:          os << "QUAD"; break;
@@ -33,6 +33,12 @@ enum IAttribute
     SOCKET = lunchbox::Thread::SOCKET, //!< CPU thread affinity: -64k..-1024
     CORE = lunchbox::Thread::CORE, //!< Core thread affinity: 1..oo
     SOCKET_MAX = lunchbox::Thread::SOCKET_MAX, //!< Highes bindable CPU
+    /**
+     * Statistics only aggregated into local histograms, see
+     * Config::getLocalMetrics() (WindowSettings::IATTR_HINT_STATISTICS,
+     * Channel::IATTR_HINT_STATISTICS)
+     */
+    HISTOGRAM  = -18,
     RELATIVE_TO_OBSERVER = -17, //!< focal convergence relative to observer
     RELATIVE_TO_ORIGIN   = -16, //!< focal convergence relative to origin
     FIXED      = -15, //!< config or observer focus fixed on wall/projection
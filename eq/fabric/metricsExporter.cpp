@@ -0,0 +1,418 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "metricsExporter.h"
+
+#include "log.h"
+#include "statistic.h"
+
+#include <lunchbox/lock.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/thread.h>
+#include <boost/asio.hpp>
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+namespace eq
+{
+namespace fabric
+{
+namespace detail
+{
+namespace
+{
+using boost::asio::ip::tcp;
+
+/** Upper bounds of the duration histogram buckets in seconds. */
+const double _buckets[] = { .001, .002, .005, .01, .02, .05, .1, .2, .5, 1. };
+const size_t _nBuckets = sizeof( _buckets ) / sizeof( double );
+
+/** Maximum size of a received HTTP request header. */
+const size_t _maxRequestSize = 8192;
+
+struct Histogram
+{
+    Histogram() : count( 0 ), sum( 0. )
+        { std::fill( buckets, buckets + _nBuckets, 0 ); }
+
+    void add( const double value )
+    {
+        for( size_t i = 0; i < _nBuckets; ++i )
+            if( value <= _buckets[i] )
+                ++buckets[i];
+        ++count;
+        sum += value;
+    }
+
+    uint64_t buckets[ _nBuckets ]; //!< cumulative bucket counts
+    uint64_t count;
+    double sum;
+};
+
+/** The type and resource of an operation. */
+typedef std::pair< std::string, std::string > Operation;
+typedef std::map< Operation, Histogram > Histograms;
+typedef std::map< std::string, double > Gauges;
+typedef std::map< std::string, std::pair< uint64_t, double > > Summaries;
+
+std::string _escape( const std::string& value )
+{
+    std::string escaped;
+    escaped.reserve( value.size( ));
+    for( std::string::const_iterator i = value.begin(); i != value.end(); ++i )
+    {
+        switch( *i )
+        {
+        case '\\': escaped += "\\\\"; break;
+        case '"':  escaped += "\\\""; break;
+        case '\n': escaped += "\\n"; break;
+        default:   escaped += *i;
+        }
+    }
+    return escaped;
+}
+
+void _writeHeader( std::ostream& os, const char* name, const char* type,
+                   const char* help )
+{
+    os << "# HELP equalizer_" << name << " " << help << "\n"
+       << "# TYPE equalizer_" << name << " " << type << "\n";
+}
+
+void _writeHistogram( std::ostream& os, const char* name,
+                      const std::string& labels, const Histogram& histogram )
+{
+    const std::string separator = labels.empty() ? "" : ",";
+    for( size_t i = 0; i < _nBuckets; ++i )
+        os << "equalizer_" << name << "_bucket{" << labels << separator
+           << "le=\"" << _buckets[i] << "\"} " << histogram.buckets[i] << "\n";
+    os << "equalizer_" << name << "_bucket{" << labels << separator
+       << "le=\"+Inf\"} " << histogram.count << "\n"
+       << "equalizer_" << name << "_sum{" << labels << "} " << histogram.sum
+       << "\n"
+       << "equalizer_" << name << "_count{" << labels << "} "
+       << histogram.count << "\n";
+}
+
+void _writeGauges( std::ostream& os, const char* name, const char* help,
+                   const Gauges& gauges )
+{
+    if( gauges.empty( ))
+        return;
+
+    _writeHeader( os, name, "gauge", help );
+    for( Gauges::const_iterator i = gauges.begin(); i != gauges.end(); ++i )
+        os << "equalizer_" << name << "{resource=\"" << _escape( i->first )
+           << "\"} " << i->second << "\n";
+}
+}
+
+class MetricsExporter : public lunchbox::Thread
+{
+public:
+    MetricsExporter()
+        : frames( 0 )
+        , lastFrame( -1 )
+        , acceptor( service )
+        , port( 0 )
+        , running( false )
+    {}
+
+    bool init() override { setName( "Metrics" ); return true; }
+
+    void run() override
+    {
+        for( ;; )
+        {
+            tcp::socket socket( service );
+            boost::system::error_code error;
+            acceptor.accept( socket, error );
+            {
+                lunchbox::ScopedMutex<> mutex( lock );
+                if( !running )
+                    return;
+            }
+            if( !error )
+                _serve( socket );
+        }
+    }
+
+    std::string getText() const;
+
+    mutable lunchbox::Lock lock;
+    Histograms operations;
+    Histogram frameTime;
+    uint64_t frames;
+    int64_t lastFrame;
+    Summaries compression;
+    Gauges fps;
+    Gauges idle;
+    Gauges poolBytes;
+    Gauges gpuUsedBytes;
+    Gauges gpuFreeBytes;
+    Gauges custom;
+    std::map< std::string, Gauges > customResources;
+
+    boost::asio::io_service service;
+    tcp::acceptor acceptor;
+    uint16_t port;
+    bool running;
+
+private:
+    void _serve( tcp::socket& socket )
+    {
+        boost::system::error_code error;
+        boost::asio::streambuf request( _maxRequestSize );
+        boost::asio::read_until( socket, request, "\r\n\r\n", error );
+        if( error )
+            return;
+
+        std::istream is( &request );
+        std::string method, path;
+        is >> method >> path;
+
+        std::string status = "200 OK";
+        std::string body;
+        if( method != "GET" )
+            status = "405 Method Not Allowed";
+        else if( path == "/metrics" || path == "/" )
+            body = getText();
+        else
+            status = "404 Not Found";
+
+        std::ostringstream response;
+        response << "HTTP/1.0 " << status << "\r\n"
+                 << "Content-Type: text/plain; version=0.0.4\r\n"
+                 << "Content-Length: " << body.size() << "\r\n"
+                 << "Connection: close\r\n\r\n" << body;
+        boost::asio::write( socket, boost::asio::buffer( response.str( )),
+                            error );
+        socket.shutdown( tcp::socket::shutdown_both, error );
+    }
+};
+
+std::string MetricsExporter::getText() const
+{
+    std::ostringstream os;
+    lunchbox::ScopedMutex<> mutex( lock );
+
+    _writeHeader( os, "frames_total", "counter", "Number of started frames" );
+    os << "equalizer_frames_total " << frames << "\n";
+    _writeHeader( os, "frame_time_seconds", "histogram",
+                  "Time between two frame starts" );
+    _writeHistogram( os, "frame_time_seconds", std::string(), frameTime );
+
+    if( !operations.empty( ))
+        _writeHeader( os, "operation_seconds", "histogram",
+                      "Duration of the sampled operations" );
+    for( Histograms::const_iterator i = operations.begin();
+         i != operations.end(); ++i )
+    {
+        const std::string labels = "type=\"" + _escape( i->first.first ) +
+                                   "\",resource=\"" +
+                                   _escape( i->first.second ) + "\"";
+        _writeHistogram( os, "operation_seconds", labels, i->second );
+    }
+
+    if( !compression.empty( ))
+        _writeHeader( os, "compression_ratio", "summary",
+                      "Compressed to uncompressed size of transmitted images" );
+    for( Summaries::const_iterator i = compression.begin();
+         i != compression.end(); ++i )
+    {
+        const std::string resource = _escape( i->first );
+        os << "equalizer_compression_ratio_sum{resource=\"" << resource
+           << "\"} " << i->second.second << "\n"
+           << "equalizer_compression_ratio_count{resource=\"" << resource
+           << "\"} " << i->second.first << "\n";
+    }
+
+    _writeGauges( os, "fps", "Current framerate of a window", fps );
+    _writeGauges( os, "pipe_idle_ratio", "Idle time ratio of the last frame",
+                  idle );
+    _writeGauges( os, "image_pool_bytes", "Memory held by the image pool",
+                  poolBytes );
+    _writeGauges( os, "gpu_used_bytes",
+                  "GPU memory accounted by the object managers of a pipe",
+                  gpuUsedBytes );
+    _writeGauges( os, "gpu_free_bytes", "Free GPU memory reported by a pipe",
+                  gpuFreeBytes );
+    for( Gauges::const_iterator i = custom.begin(); i != custom.end(); ++i )
+    {
+        const std::string& name = i->first;
+        _writeHeader( os, name.c_str(), "gauge", name.c_str( ));
+        os << "equalizer_" << name << " " << i->second << "\n";
+    }
+    for( std::map< std::string, Gauges >::const_iterator i =
+             customResources.begin(); i != customResources.end(); ++i )
+    {
+        _writeGauges( os, i->first.c_str(), i->first.c_str(), i->second );
+    }
+    return os.str();
+}
+}
+
+MetricsExporter::MetricsExporter()
+    : _impl( new detail::MetricsExporter )
+{}
+
+MetricsExporter::~MetricsExporter()
+{
+    stop();
+    delete _impl;
+}
+
+bool MetricsExporter::start( const uint16_t port )
+{
+    if( _impl->isRunning( ))
+    {
+        LBWARN << "Metrics already served on port " << _impl->port
+               << std::endl;
+        return false;
+    }
+
+    using detail::tcp;
+    const tcp::endpoint endpoint( tcp::v4(), port );
+    boost::system::error_code error;
+    _impl->acceptor.open( endpoint.protocol(), error );
+    if( !error )
+        _impl->acceptor.set_option( tcp::acceptor::reuse_address( true ),
+                                    error );
+    if( !error )
+        _impl->acceptor.bind( endpoint, error );
+    if( !error )
+        _impl->acceptor.listen( boost::asio::socket_base::max_connections,
+                                error );
+    if( error )
+    {
+        LBWARN << "Can't serve metrics on port " << port << ": "
+               << error.message() << std::endl;
+        _impl->acceptor.close( error );
+        return false;
+    }
+
+    _impl->port = port;
+    _impl->running = true;
+    if( _impl->start( ))
+    {
+        LBINFO << "Serving metrics on port " << port << std::endl;
+        return true;
+    }
+
+    _impl->running = false;
+    _impl->acceptor.close( error );
+    return false;
+}
+
+void MetricsExporter::stop()
+{
+    {
+        lunchbox::ScopedMutex<> mutex( _impl->lock );
+        if( !_impl->running )
+            return;
+        _impl->running = false;
+    }
+
+    // wake up the blocking accept
+    using detail::tcp;
+    boost::system::error_code error;
+    tcp::socket socket( _impl->service );
+    socket.connect( tcp::endpoint( boost::asio::ip::address_v4::loopback(),
+                                   _impl->port ), error );
+    _impl->join();
+    _impl->acceptor.close( error );
+}
+
+void MetricsExporter::add( const Statistic& statistic )
+{
+    const std::string resource( statistic.resourceName );
+    const double duration = double( statistic.endTime -
+                                    statistic.startTime ) / 1000.;
+    lunchbox::ScopedMutex<> mutex( _impl->lock );
+
+    switch( statistic.type )
+    {
+    case Statistic::WINDOW_FPS:
+        _impl->fps[ resource ] = statistic.currentFPS;
+        return;
+
+    case Statistic::PIPE_IDLE:
+        if( statistic.totalTime > 0 )
+            _impl->idle[ resource ] = double( statistic.idleTime ) /
+                                      double( statistic.totalTime );
+        return;
+
+    case Statistic::NODE_IMAGE_POOL:
+        _impl->poolBytes[ resource ] = double( statistic.poolBytes );
+        return;
+
+    case Statistic::PIPE_GPU_MEMORY:
+        _impl->gpuUsedBytes[ resource ] = double( statistic.gpuUsedBytes );
+        if( statistic.gpuFreeBytes > 0 )
+            _impl->gpuFreeBytes[ resource ] = double( statistic.gpuFreeBytes );
+        return;
+
+    case Statistic::CONFIG_START_FRAME:
+        ++_impl->frames;
+        if( _impl->lastFrame >= 0 &&
+            statistic.startTime >= _impl->lastFrame )
+        {
+            _impl->frameTime.add( double( statistic.startTime -
+                                          _impl->lastFrame ) / 1000. );
+        }
+        _impl->lastFrame = statistic.startTime;
+        break;
+
+    case Statistic::CHANNEL_FRAME_COMPRESS:
+    {
+        std::pair< uint64_t, double >& summary = _impl->compression[resource];
+        ++summary.first;
+        summary.second += statistic.ratio;
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    const Operation operation( Statistic::getName( statistic.type ),
+                               resource );
+    _impl->operations[ operation ].add( duration );
+}
+
+void MetricsExporter::setGauge( const std::string& name, const double value )
+{
+    lunchbox::ScopedMutex<> mutex( _impl->lock );
+    _impl->custom[ name ] = value;
+}
+
+void MetricsExporter::setGauge( const std::string& name,
+                                const std::string& resource,
+                                const double value )
+{
+    lunchbox::ScopedMutex<> mutex( _impl->lock );
+    _impl->customResources[ name ][ resource ] = value;
+}
+
+std::string MetricsExporter::getText() const
+{
+    return _impl->getText();
+}
+
+}
+}
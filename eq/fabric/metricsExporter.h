@@ -0,0 +1,82 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQFABRIC_METRICSEXPORTER_H
+#define EQFABRIC_METRICSEXPORTER_H
+
+#include <eq/fabric/api.h>
+#include <eq/fabric/types.h>
+#include <boost/noncopyable.hpp>
+
+namespace eq
+{
+namespace fabric
+{
+namespace detail { class MetricsExporter; }
+
+/**
+ * Aggregates statistics into metrics and serves them over HTTP.
+ *
+ * The durations of all statistics are aggregated into histograms per type and
+ * resource, and the intervals between CONFIG_START_FRAME statistics into the
+ * frame time histogram. Compression ratios, framerates, pipe idle ratios and
+ * image pool sizes are exported as gauges. The metrics are served in the
+ * Prometheus text format, compatible with OpenMetrics scrapers, by a thread
+ * accepting one request at a time.
+ *
+ * All methods are thread safe.
+ */
+class MetricsExporter : public boost::noncopyable
+{
+public:
+    /** Construct a new, stopped metrics exporter. */
+    EQFABRIC_API MetricsExporter();
+
+    /** Destruct this exporter and stop serving metrics. */
+    EQFABRIC_API ~MetricsExporter();
+
+    /**
+     * Start serving the metrics on the given TCP port.
+     *
+     * @param port the port to listen on all interfaces.
+     * @return true if the endpoint was started, false on error.
+     */
+    EQFABRIC_API bool start( uint16_t port );
+
+    /** Stop serving the metrics. */
+    EQFABRIC_API void stop();
+
+    /** Aggregate the given statistic. */
+    EQFABRIC_API void add( const Statistic& statistic );
+
+    /** Set a custom gauge, exported as equalizer_<name>. */
+    EQFABRIC_API void setGauge( const std::string& name, double value );
+
+    /** Set a custom gauge of a resource, exported as equalizer_<name>. */
+    EQFABRIC_API void setGauge( const std::string& name,
+                                const std::string& resource, double value );
+
+    /** @return the current metrics in the Prometheus text format. */
+    EQFABRIC_API std::string getText() const;
+
+private:
+    detail::MetricsExporter* const _impl;
+};
+}
+}
+
+#endif // EQFABRIC_METRICSEXPORTER_H
@@ -80,9 +80,14 @@ public:
         /** <a href="http://www.equalizergraphics.com/documents/design/threads.html#sync">Threading model</a> */
         IATTR_THREAD_MODEL,
         IATTR_LAUNCH_TIMEOUT, //!< Timeout when auto-launching the node
+        /** Bind node, network and transmit threads to cores. */
         IATTR_HINT_AFFINITY,
+        /** Number of threads transmitting output images. @version 1.8 */
+        IATTR_HINT_TRANSMIT_THREADS,
+        /** Keep the node as a replacement for failed nodes. @version 1.8 */
+        IATTR_HINT_STANDBY,
         IATTR_LAST,
-        IATTR_ALL = IATTR_LAST + 5
+        IATTR_ALL = IATTR_LAST + 3
     };
 
     /** @internal Set a node integer attribute. */
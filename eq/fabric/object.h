@@ -201,6 +201,10 @@ protected:
 
 private:
     detail::Object* const _impl;
+
+    /** Register an unattached child slave instance with the server. */
+    template< class C, class S >
+    void _mapChild( C* child, S* sender, uint32_t cmd );
 };
 
 // Template Implementation
@@ -208,43 +212,49 @@ template< class C, class S > inline void
 Object::commitChild( C* child, S* sender, uint32_t cmd,
                      const uint32_t incarnation )
 {
-    if( !child->isAttached( ))
-    {
-        LBASSERT( !isMaster( ));
-        co::LocalNodePtr localNode = child->getConfig()->getLocalNode();
-        lunchbox::Request< uint128_t > request =
-            localNode->registerRequest< uint128_t >();
-        co::NodePtr node = child->getServer().get();
-        sender->send( node, cmd ) << request;
-
-        LBCHECK( localNode->mapObject( child, request.wait(),
-                                       co::VERSION_NONE ));
-    }
+    _mapChild< C, S >( child, sender, cmd );
     child->commit( incarnation );
 }
 
+template< class C, class S > inline void
+Object::_mapChild( C* child, S* sender, uint32_t cmd )
+{
+    if( child->isAttached( ))
+        return;
+
+    LBASSERT( !isMaster( ));
+    co::LocalNodePtr localNode = child->getConfig()->getLocalNode();
+    lunchbox::Request< uint128_t > request =
+        localNode->registerRequest< uint128_t >();
+    co::NodePtr node = child->getServer().get();
+    sender->send( node, cmd ) << request;
+
+    LBCHECK( localNode->mapObject( child, request.wait(), co::VERSION_NONE ));
+}
+
 template< class C, class S > inline void
 Object::commitChildren( const std::vector< C* >& children, S* sender,
                         uint32_t cmd, const uint32_t incarnation )
 {
-    // TODO Opt: async register and commit
+    // register new children in order, then serialize all concurrently
     for( typename std::vector< C* >::const_iterator i = children.begin();
          i != children.end(); ++i )
     {
-        C* child = *i;
-        commitChild< C, S >( child, sender, cmd, incarnation );
+        _mapChild< C, S >( *i, sender, cmd );
     }
+    commitChildren< C >( children, incarnation );
 }
 
 template< class C >
 inline void Object::commitChildren( const std::vector< C* >& children,
                                     const uint32_t incarnation )
 {
-    // TODO Opt: async commit
-    for( typename std::vector< C* >::const_iterator i = children.begin();
-         i != children.end(); ++i )
+    // Children are independent objects, their commits do not share state
+    const int nChildren = int( children.size( ));
+#pragma omp parallel for if( nChildren > 3 )
+    for( int i = 0; i < nChildren; ++i )
     {
-        C* child = *i;
+        C* child = children[i];
         LBASSERT( child->isAttached( ));
         child->commit( incarnation );
     }
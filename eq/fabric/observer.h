@@ -102,6 +102,35 @@ namespace fabric
         /** @return the current VRPN tracker device name. @version 1.5.2 */
         const std::string& getVRPNTracker() const { return _data.vrpnTracker; }
 
+        /**
+         * Set the UDP port of the late-latched head tracker.
+         *
+         * When set, the render clients receive head matrices on this port and
+         * update the frustum of each channel with the latest matrix right
+         * before Channel::frameDraw(). Each datagram contains the 16 floats of
+         * a head matrix in the layout of Matrix4f::array and in little endian
+         * byte order.
+         *
+         * @param port the UDP port, or OFF to disable late latching.
+         * @version 1.8
+         */
+        EQFABRIC_INL void setLatchPort( const int32_t port );
+
+        /** @return the UDP port of the late-latched tracker. @version 1.8 */
+        int32_t getLatchPort() const { return _data.latchPort; }
+
+        /**
+         * Set the gaze position reported by an eye tracker.
+         *
+         * The position is in normalized view coordinates, with (0, 0) at the
+         * bottom left of the view. It drives foveated decompositions.
+         * @version 1.8
+         */
+        EQFABRIC_INL void setGazePosition( const Vector2f& position );
+
+        /** @return the gaze position, the view center by default. @version 1.8*/
+        const Vector2f& getGazePosition() const { return _data.gazePosition; }
+
         /** @return the parent config of this observer. @version 1.0 */
         const C* getConfig() const { return _config; }
 
@@ -152,9 +181,10 @@ namespace fabric
             DIRTY_HEAD         = Object::DIRTY_CUSTOM << 1,
             DIRTY_FOCUS        = Object::DIRTY_CUSTOM << 2,
             DIRTY_TRACKER      = Object::DIRTY_CUSTOM << 3,
+            DIRTY_GAZE         = Object::DIRTY_CUSTOM << 4,
             DIRTY_OBSERVER_BITS =
                 DIRTY_EYE_POSITION | DIRTY_HEAD | DIRTY_FOCUS | DIRTY_TRACKER |
-                DIRTY_OBJECT_BITS
+                DIRTY_GAZE | DIRTY_OBJECT_BITS
         };
 
         /** @internal @return the bits to be re-committed by the master. */
@@ -175,9 +205,15 @@ namespace fabric
             FocusMode focusMode; //!< The current focal distance mode
             int32_t camera; //!< The OpenCV camera used for head tracking
             std::string vrpnTracker; //!< VRPN tracking device
+            int32_t latchPort; //!< UDP port of the late-latched tracker
+            Vector2f gazePosition; //!< Normalized gaze position in the view
         }
             _data, _backup;
 
+        /** Changed elements of the head matrix and eye positions. */
+        uint64_t _dirtyHead;
+        uint64_t _dirtyEyes;
+
         struct Private;
         Private* _private; // placeholder for binary-compatible changes
     };
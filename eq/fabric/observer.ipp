@@ -18,6 +18,7 @@
 
 #include "observer.h"
 
+#include "fieldMask.h"
 #include "leafVisitor.h"
 #include "log.h"
 #include "paths.h"
@@ -33,6 +34,8 @@ namespace fabric
 template< typename C, typename O >
 Observer< C, O >::Observer( C* config )
         : _config( config )
+        , _dirtyHead( 0 )
+        , _dirtyEyes( 0 )
 {
     LBASSERT( config );
     config->_addObserver( static_cast< O* >( this ));
@@ -57,6 +60,8 @@ Observer< C, O >::BackupData::BackupData()
     , focusDistance( 1.f )
     , focusMode( FOCUSMODE_FIXED )
     , camera( OFF )
+    , latchPort( OFF )
+    , gazePosition( .5f, .5f )
 {
     for( size_t i = 0; i < NUM_EYES; ++i )
         eyePosition[ i ] = Vector3f::ZERO;
@@ -76,7 +81,9 @@ void Observer< C, O >::restore()
 {
     _data = _backup;
     Object::restore();
-    setDirty( DIRTY_EYE_POSITION | DIRTY_HEAD | DIRTY_FOCUS );
+    _dirtyHead = fieldMask::all( 16 );
+    _dirtyEyes = fieldMask::all( NUM_EYES * 3 );
+    setDirty( DIRTY_EYE_POSITION | DIRTY_HEAD | DIRTY_FOCUS | DIRTY_GAZE );
 }
 
 template< typename C, typename O >
@@ -85,15 +92,29 @@ void Observer< C, O >::serialize( co::DataOStream& os,
 {
     Object::serialize( os, dirtyBits );
 
+    // instance data is complete, deltas only contain the changed elements
+    const bool all = ( dirtyBits == DIRTY_ALL );
     if( dirtyBits & DIRTY_HEAD )
-        os << _data.headMatrix;
+    {
+        fieldMask::serialize( os, _data.headMatrix.array, 16,
+                              all ? fieldMask::all( 16 ) : _dirtyHead );
+        if( !all )
+            _dirtyHead = 0;
+    }
     if( dirtyBits & DIRTY_EYE_POSITION )
-        for( size_t i = 0; i < NUM_EYES; ++i )
-            os << _data.eyePosition[i];
+    {
+        fieldMask::serialize( os, _data.eyePosition[0].array, NUM_EYES * 3,
+                              all ? fieldMask::all( NUM_EYES * 3 ) :
+                                    _dirtyEyes );
+        if( !all )
+            _dirtyEyes = 0;
+    }
     if( dirtyBits & DIRTY_FOCUS )
         os << _data.focusDistance << _data.focusMode;
     if( dirtyBits & DIRTY_TRACKER )
-        os << _data.camera << _data.vrpnTracker;
+        os << _data.camera << _data.vrpnTracker << _data.latchPort;
+    if( dirtyBits & DIRTY_GAZE )
+        os << _data.gazePosition;
 }
 
 template< typename C, typename O >
@@ -103,14 +124,27 @@ void Observer< C, O >::deserialize( co::DataIStream& is,
     Object::deserialize( is, dirtyBits );
 
     if( dirtyBits & DIRTY_HEAD )
-        is >> _data.headMatrix;
+    {
+        const uint64_t mask = fieldMask::deserialize( is,
+                                                      _data.headMatrix.array,
+                                                      16 );
+        if( isMaster( )) // redistribute changes
+            _dirtyHead |= mask;
+    }
     if( dirtyBits & DIRTY_EYE_POSITION )
-        for( size_t i = 0; i < NUM_EYES; ++i )
-            is >> _data.eyePosition[i];
+    {
+        const uint64_t mask =
+            fieldMask::deserialize( is, _data.eyePosition[0].array,
+                                    NUM_EYES * 3 );
+        if( isMaster( ))
+            _dirtyEyes |= mask;
+    }
     if( dirtyBits & DIRTY_FOCUS )
         is >> _data.focusDistance >> _data.focusMode;
     if( dirtyBits & DIRTY_TRACKER )
-        is >> _data.camera >> _data.vrpnTracker;
+        is >> _data.camera >> _data.vrpnTracker >> _data.latchPort;
+    if( dirtyBits & DIRTY_GAZE )
+        is >> _data.gazePosition;
 }
 
 template< typename C, typename O >
@@ -167,11 +201,14 @@ template< typename C, typename O >
 void Observer< C, O >::setEyePosition( const Eye eye, const Vector3f& pos )
 {
     LBASSERT( lunchbox::getIndexOfLastBit( eye ) <= EYE_LAST );
-    Vector3f& position = _data.eyePosition[ lunchbox::getIndexOfLastBit( eye )];
-    if( position == pos )
+    const size_t index = lunchbox::getIndexOfLastBit( eye );
+    Vector3f& position = _data.eyePosition[ index ];
+    const uint64_t mask = fieldMask::getChanged( pos.array, position.array, 3 );
+    if( mask == 0 )
         return;
 
     position = pos;
+    _dirtyEyes |= mask << ( index * 3 );
     setDirty( DIRTY_EYE_POSITION );
 }
 
@@ -222,13 +259,36 @@ void Observer< C, O >::setVRPNTracker( const std::string& tracker )
     setDirty( DIRTY_TRACKER );
 }
 
+template< typename C, typename O >
+void Observer< C, O >::setLatchPort( const int32_t port )
+{
+    if( _data.latchPort == port )
+        return;
+
+    _data.latchPort = port;
+    setDirty( DIRTY_TRACKER );
+}
+
+template< typename C, typename O >
+void Observer< C, O >::setGazePosition( const Vector2f& position )
+{
+    if( _data.gazePosition == position )
+        return;
+
+    _data.gazePosition = position;
+    setDirty( DIRTY_GAZE );
+}
+
 template< typename C, typename O >
 bool Observer< C, O >::setHeadMatrix( const Matrix4f& matrix )
 {
-    if( _data.headMatrix == matrix )
+    const uint64_t mask = fieldMask::getChanged( matrix.array,
+                                                 _data.headMatrix.array, 16 );
+    if( mask == 0 )
         return false;
 
     _data.headMatrix = matrix;
+    _dirtyHead |= mask;
     setDirty( DIRTY_HEAD );
     return true;
 }
@@ -254,6 +314,9 @@ std::ostream& operator << ( std::ostream& os, const Observer< C, O >& observer )
     if( !observer.getVRPNTracker().empty( ))
         os << "vrpn_tracker   \"" << observer.getVRPNTracker() << "\""
            << std::endl;
+    if( observer.getLatchPort() != OFF )
+        os << "latch_port     " << IAttribute( observer.getLatchPort( ))
+           << std::endl;
     os << lunchbox::exdent << "}" << std::endl << lunchbox::enableHeader
        << lunchbox::enableFlush;
     return os;
@@ -114,10 +114,11 @@ namespace fabric
         {
             // Note: also update string array initialization in pipe.cpp
             IATTR_HINT_THREAD,   //!< Execute tasks in separate thread (default)
-            IATTR_HINT_AFFINITY, //!< Bind render thread to subset of cores
+            IATTR_HINT_AFFINITY, //!< Bind render & transfer thread to cores
             IATTR_HINT_CUDA_GL_INTEROP, //!< Configure CUDA context
+            IATTR_HINT_PARALLEL_INIT, //!< Initialize windows concurrently
             IATTR_LAST,
-            IATTR_ALL = IATTR_LAST + 5
+            IATTR_ALL = IATTR_LAST + 4
         };
 
         /** @internal Set a pipe attribute. */
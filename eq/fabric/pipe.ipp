@@ -41,6 +41,7 @@ std::string _iPipeAttributeStrings[] = {
     MAKE_PIPE_ATTR_STRING( IATTR_HINT_THREAD ),
     MAKE_PIPE_ATTR_STRING( IATTR_HINT_AFFINITY ),
     MAKE_PIPE_ATTR_STRING( IATTR_HINT_CUDA_GL_INTEROP ),
+    MAKE_PIPE_ATTR_STRING( IATTR_HINT_PARALLEL_INIT ),
 };
 
 }
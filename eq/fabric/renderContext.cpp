@@ -18,10 +18,53 @@
 #include "renderContext.h"
 #include "tile.h"
 
+#include <co/dataIStream.h>
+#include <co/dataOStream.h>
+
 namespace eq
 {
 namespace fabric
 {
+namespace
+{
+enum DirtyBits
+{
+    DIRTY_FRUSTUM         = 1u << 0,
+    DIRTY_ORTHO           = 1u << 1,
+    DIRTY_HEADTRANSFORM   = 1u << 2,
+    DIRTY_ORTHOTRANSFORM  = 1u << 3,
+    DIRTY_VIEW            = 1u << 4,
+    DIRTY_FRAMEID         = 1u << 5,
+    DIRTY_PVP             = 1u << 6,
+    DIRTY_PIXEL           = 1u << 7,
+    DIRTY_OVERDRAW        = 1u << 8,
+    DIRTY_VP              = 1u << 9,
+    DIRTY_OFFSET          = 1u << 10,
+    DIRTY_RANGE           = 1u << 11,
+    DIRTY_SUBPIXEL        = 1u << 12,
+    DIRTY_ZOOM            = 1u << 13,
+    DIRTY_BUFFER          = 1u << 14,
+    DIRTY_TASKID          = 1u << 15,
+    DIRTY_PERIOD          = 1u << 16,
+    DIRTY_PHASE           = 1u << 17,
+    DIRTY_EYE             = 1u << 18,
+    DIRTY_BUFFERMASK      = 1u << 19,
+    DIRTY_HEADMATRIX      = 1u << 20,
+    DIRTY_EYEWALL         = 1u << 21,
+    DIRTY_WALLTYPE        = 1u << 22
+};
+
+template< class T > bool _changed( const T& value, const T& previous )
+{
+    return !( value == previous );
+}
+
+bool _changed( const ColorMask& value, const ColorMask& previous )
+{
+    return value.red != previous.red || value.green != previous.green ||
+           value.blue != previous.blue || value.alpha != previous.alpha;
+}
+}
 
 // cppcheck-suppress uninitMemberVar
 RenderContext::RenderContext()
@@ -29,6 +72,9 @@ RenderContext::RenderContext()
         , ortho( Frustumf::DEFAULT )
         , headTransform( Matrix4f::IDENTITY )
         , orthoTransform( Matrix4f::IDENTITY )
+        , headMatrix( Matrix4f::IDENTITY )
+        , eyeWall( Vector3f::ZERO )
+        , wallType( 0 )
         , frameID( 0 )
         , overdraw( Vector4i::ZERO )
         , offset( Vector2i::ZERO )
@@ -48,6 +94,161 @@ void RenderContext::apply( const Tile& tile )
     vp = tile.vp;
 }
 
+void RenderContext::serialize( co::DataOStream& os,
+                               RenderContext& previous ) const
+{
+    uint32_t dirty = 0;
+    if( _changed( frustum, previous.frustum ))
+        dirty |= DIRTY_FRUSTUM;
+    if( _changed( ortho, previous.ortho ))
+        dirty |= DIRTY_ORTHO;
+    if( _changed( headTransform, previous.headTransform ))
+        dirty |= DIRTY_HEADTRANSFORM;
+    if( _changed( orthoTransform, previous.orthoTransform ))
+        dirty |= DIRTY_ORTHOTRANSFORM;
+    if( _changed( headMatrix, previous.headMatrix ))
+        dirty |= DIRTY_HEADMATRIX;
+    if( _changed( eyeWall, previous.eyeWall ))
+        dirty |= DIRTY_EYEWALL;
+    if( _changed( wallType, previous.wallType ))
+        dirty |= DIRTY_WALLTYPE;
+    if( _changed( view, previous.view ))
+        dirty |= DIRTY_VIEW;
+    if( _changed( frameID, previous.frameID ))
+        dirty |= DIRTY_FRAMEID;
+    if( _changed( pvp, previous.pvp ))
+        dirty |= DIRTY_PVP;
+    if( _changed( pixel, previous.pixel ))
+        dirty |= DIRTY_PIXEL;
+    if( _changed( overdraw, previous.overdraw ))
+        dirty |= DIRTY_OVERDRAW;
+    if( _changed( vp, previous.vp ))
+        dirty |= DIRTY_VP;
+    if( _changed( offset, previous.offset ))
+        dirty |= DIRTY_OFFSET;
+    if( _changed( range, previous.range ))
+        dirty |= DIRTY_RANGE;
+    if( _changed( subpixel, previous.subpixel ))
+        dirty |= DIRTY_SUBPIXEL;
+    if( _changed( zoom, previous.zoom ))
+        dirty |= DIRTY_ZOOM;
+    if( _changed( buffer, previous.buffer ))
+        dirty |= DIRTY_BUFFER;
+    if( _changed( taskID, previous.taskID ))
+        dirty |= DIRTY_TASKID;
+    if( _changed( period, previous.period ))
+        dirty |= DIRTY_PERIOD;
+    if( _changed( phase, previous.phase ))
+        dirty |= DIRTY_PHASE;
+    if( _changed( eye, previous.eye ))
+        dirty |= DIRTY_EYE;
+    if( _changed( bufferMask, previous.bufferMask ))
+        dirty |= DIRTY_BUFFERMASK;
+
+    os << dirty;
+    if( dirty & DIRTY_FRUSTUM )
+        os << frustum;
+    if( dirty & DIRTY_ORTHO )
+        os << ortho;
+    if( dirty & DIRTY_HEADTRANSFORM )
+        os << headTransform;
+    if( dirty & DIRTY_ORTHOTRANSFORM )
+        os << orthoTransform;
+    if( dirty & DIRTY_HEADMATRIX )
+        os << headMatrix;
+    if( dirty & DIRTY_EYEWALL )
+        os << eyeWall;
+    if( dirty & DIRTY_WALLTYPE )
+        os << wallType;
+    if( dirty & DIRTY_VIEW )
+        os << view;
+    if( dirty & DIRTY_FRAMEID )
+        os << frameID;
+    if( dirty & DIRTY_PVP )
+        os << pvp;
+    if( dirty & DIRTY_PIXEL )
+        os << pixel;
+    if( dirty & DIRTY_OVERDRAW )
+        os << overdraw;
+    if( dirty & DIRTY_VP )
+        os << vp;
+    if( dirty & DIRTY_OFFSET )
+        os << offset;
+    if( dirty & DIRTY_RANGE )
+        os << range;
+    if( dirty & DIRTY_SUBPIXEL )
+        os << subpixel;
+    if( dirty & DIRTY_ZOOM )
+        os << zoom;
+    if( dirty & DIRTY_BUFFER )
+        os << buffer;
+    if( dirty & DIRTY_TASKID )
+        os << taskID;
+    if( dirty & DIRTY_PERIOD )
+        os << period;
+    if( dirty & DIRTY_PHASE )
+        os << phase;
+    if( dirty & DIRTY_EYE )
+        os << eye;
+    if( dirty & DIRTY_BUFFERMASK )
+        os << bufferMask;
+
+    previous = *this;
+}
+
+void RenderContext::deserialize( co::DataIStream& is )
+{
+    uint32_t dirty = 0;
+    is >> dirty;
+
+    if( dirty & DIRTY_FRUSTUM )
+        is >> frustum;
+    if( dirty & DIRTY_ORTHO )
+        is >> ortho;
+    if( dirty & DIRTY_HEADTRANSFORM )
+        is >> headTransform;
+    if( dirty & DIRTY_ORTHOTRANSFORM )
+        is >> orthoTransform;
+    if( dirty & DIRTY_HEADMATRIX )
+        is >> headMatrix;
+    if( dirty & DIRTY_EYEWALL )
+        is >> eyeWall;
+    if( dirty & DIRTY_WALLTYPE )
+        is >> wallType;
+    if( dirty & DIRTY_VIEW )
+        is >> view;
+    if( dirty & DIRTY_FRAMEID )
+        is >> frameID;
+    if( dirty & DIRTY_PVP )
+        is >> pvp;
+    if( dirty & DIRTY_PIXEL )
+        is >> pixel;
+    if( dirty & DIRTY_OVERDRAW )
+        is >> overdraw;
+    if( dirty & DIRTY_VP )
+        is >> vp;
+    if( dirty & DIRTY_OFFSET )
+        is >> offset;
+    if( dirty & DIRTY_RANGE )
+        is >> range;
+    if( dirty & DIRTY_SUBPIXEL )
+        is >> subpixel;
+    if( dirty & DIRTY_ZOOM )
+        is >> zoom;
+    if( dirty & DIRTY_BUFFER )
+        is >> buffer;
+    if( dirty & DIRTY_TASKID )
+        is >> taskID;
+    if( dirty & DIRTY_PERIOD )
+        is >> period;
+    if( dirty & DIRTY_PHASE )
+        is >> phase;
+    if( dirty & DIRTY_EYE )
+        is >> eye;
+    if( dirty & DIRTY_BUFFERMASK )
+        is >> bufferMask;
+}
+
 std::ostream& operator << ( std::ostream& os, const RenderContext& ctx )
 {
     return os << "ID " << ctx.frameID << " pvp " << ctx.pvp << " vp " << ctx.vp
@@ -41,11 +41,25 @@ namespace fabric
         EQFABRIC_API RenderContext();
         EQFABRIC_API void apply( const Tile& tile ); //!< @internal
 
+        /**
+         * @internal Write the fields which differ from the previous context.
+         *
+         * The previous context is updated to this context afterwards.
+         */
+        EQFABRIC_API void serialize( co::DataOStream& os,
+                                     RenderContext& previous ) const;
+
+        /** @internal Apply the fields written by serialize() to this. */
+        EQFABRIC_API void deserialize( co::DataIStream& is );
+
         Frustumf       frustum;        //!< frustum for projection matrix
         Frustumf       ortho;          //!< ortho frustum for projection matrix
 
         Matrix4f       headTransform;  //!< frustum transform for modelview
         Matrix4f       orthoTransform; //!< orthographic frustum transform
+        Matrix4f       headMatrix;     //!< @internal observer head of frustum
+        Vector3f       eyeWall;        //!< @internal eye position wrt wall
+        uint32_t       wallType;       //!< @internal Wall::Type of frustum
 
         co::ObjectVersion view;        //!< destination view id and version
         uint128_t      frameID;        //!< identifier from Config::beginFrame
@@ -84,6 +98,9 @@ template<> inline void byteswap( eq::fabric::RenderContext& value )
 
     byteswap( value.headTransform );
     byteswap( value.orthoTransform );
+    byteswap( value.headMatrix );
+    byteswap( value.eyeWall );
+    byteswap( value.wallType );
 
     byteswap( value.view );
     byteswap( value.frameID );
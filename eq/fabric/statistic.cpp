@@ -63,6 +63,8 @@ static StatisticData _statisticData[] =
    "compress",     Vector3f( 0.f, .7f, 1.f ) },
  { Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN,
    "wait send token", Vector3f( 1.f, 0.f, 0.f ) },
+ { Statistic::CHANNEL_TILE,
+   "tile",         Vector3f( 0.f, .9f, 0.f ) },
  { Statistic::WINDOW_FINISH,
    "finish",       Vector3f( 1.0f, 1.0f, 0.f ) },
  { Statistic::WINDOW_THROTTLE_FRAMERATE,
@@ -75,14 +77,20 @@ static StatisticData _statisticData[] =
    "FPS",          Vector3f( 1.f, 1.f, 1.f ) },
  { Statistic::PIPE_IDLE,
    "pipe idle",    Vector3f( 1.f, 1.f, 1.f ) },
+ { Statistic::PIPE_GPU_MEMORY,
+   "GPU memory",   Vector3f( 1.f, .5f, 0.f ) },
  { Statistic::NODE_FRAME_DECOMPRESS,
    "decompress",   Vector3f( 0.f, .7f, 1.f ) },
+ { Statistic::NODE_IMAGE_POOL,
+   "image pool",   Vector3f( .5f, .5f, 1.f ) },
  { Statistic::CONFIG_START_FRAME,
    "start frame",  Vector3f( .5f, 1.0f, .5f ) },
  { Statistic::CONFIG_FINISH_FRAME,
    "finish frame", Vector3f( .5f, .5f, .5f ) },
  { Statistic::CONFIG_WAIT_FINISH_FRAME,
    "wait finish",  Vector3f( 1.0f, 0.f, 0.f ) },
+ { Statistic::CONFIG_INPUT_LATENCY,
+   "input latency", Vector3f( 0.f, 1.f, 1.f ) },
  { Statistic::ALL,
    "ALL EVENTS",   Vector3f( 0.0f, 0.f, 0.f ) }} ;
 }
@@ -54,6 +54,7 @@ struct Statistic
         CHANNEL_FRAME_COMPRESS, //!< Sampling of frame compression
         /** Sampling of waiting for a send token from the receiver */
         CHANNEL_FRAME_WAIT_SENDTOKEN,
+        CHANNEL_TILE, //!< Sampling of rendering one tile of a tile queue
         WINDOW_FINISH, //!< Sampling of Window::finish before a swap barrier
         /** Sampling of throttling of framerate_equalizer */
         WINDOW_THROTTLE_FRAMERATE,
@@ -61,11 +62,15 @@ struct Statistic
         WINDOW_SWAP, //!< Sampling of Window::swapBuffers
         WINDOW_FPS, //!< Framerate sampling
         PIPE_IDLE, //!< Pipe thread idle ratio
+        PIPE_GPU_MEMORY, //!< GPU memory of the pipe's object managers
         NODE_FRAME_DECOMPRESS, //!< Sampling of frame decompression
+        NODE_IMAGE_POOL, //!< Image pool usage during one frame
         CONFIG_START_FRAME, //!< Sampling of Config::startFrame
         CONFIG_FINISH_FRAME, //!< Sampling of Config::finishFrame
         /** Sampling of synchronization time during Config::finishFrame */
         CONFIG_WAIT_FINISH_FRAME,
+        /** Time from an input event to the swap of the frame applying it */
+        CONFIG_INPUT_LATENCY,
         ALL          // must be last
     };
 
@@ -84,6 +89,14 @@ struct Statistic
     float    averageFPS; //!< Weighted sum averaging of FPS (WINDOW_FPS)
     float    pad; //!< @internal
 
+    uint64_t poolBytes; //!< Bytes held by the image pool (NODE_IMAGE_POOL)
+    uint32_t poolHits; //!< Image pool reuses (NODE_IMAGE_POOL)
+    uint32_t poolMisses; //!< Image pool allocations (NODE_IMAGE_POOL)
+    int32_t  tileX; //!< Horizontal tile position in pixels (CHANNEL_TILE)
+    int32_t  tileY; //!< Vertical tile position in pixels (CHANNEL_TILE)
+    uint64_t gpuUsedBytes; //!< Accounted GPU memory (PIPE_GPU_MEMORY)
+    uint64_t gpuFreeBytes; //!< Free GPU memory, 0 if unknown (PIPE_GPU_MEMORY)
+
     char resourceName[32]; //!< A non-unique name of the originator
 
     /** Translate the Type to a string representation. @version 1.0 */
@@ -122,6 +135,14 @@ template<> inline void byteswap( eq::fabric::Statistic& value )
     byteswap( value.ratio );
     byteswap( value.currentFPS );
     byteswap( value.averageFPS );
+
+    byteswap( value.poolBytes );
+    byteswap( value.poolHits );
+    byteswap( value.poolMisses );
+    byteswap( value.tileX );
+    byteswap( value.tileY );
+    byteswap( value.gpuUsedBytes );
+    byteswap( value.gpuFreeBytes );
 }
 }
 
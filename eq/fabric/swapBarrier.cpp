@@ -33,9 +33,11 @@ std::ostream& operator << ( std::ostream& os, const SwapBarrier& swapBarrier )
                   << std::endl
                   << "}"  << lunchbox::enableFlush << std::endl; 
 
-    return os << lunchbox::disableFlush << "swapbarrier { name \"" 
-              << swapBarrier.getName() << "\" }" << lunchbox::enableFlush
-              << std::endl;
+    return os << lunchbox::disableFlush << "swapbarrier { name \""
+              << swapBarrier.getName() << "\""
+              << ( swapBarrier.isTimed() ? " timed ON" : "" )
+              << ( swapBarrier.isHardware() ? " hardware AUTO" : "" ) << " }"
+              << lunchbox::enableFlush << std::endl;
 }
 
 }
@@ -40,7 +40,9 @@ namespace fabric
         /** 
          * Constructs a new SwapBarrier.
          */
-        SwapBarrier() : _nvSwapGroup( 0 ), _nvSwapBarrier( 0 ) {}
+        SwapBarrier()
+            : _nvSwapGroup( 0 ), _nvSwapBarrier( 0 ), _timed( false )
+            , _hardware( false ) {}
 
         /** @name Data Access. */
         //@{
@@ -56,6 +58,32 @@ namespace fabric
 
         bool isNvSwapBarrier() const
             { return ( _nvSwapBarrier || _nvSwapGroup ); }
+
+        /**
+         * Release the windows at a predicted, common deadline.
+         *
+         * Timed barriers use the synchronized clocks instead of a network
+         * round trip, and fall back to the network barrier when a window is
+         * late. Not applicable to NV_swap_group barriers.
+         * @version 1.8
+         */
+        void setTimed( const bool timed ) { _timed = timed; }
+
+        /** @return true if the barrier uses a deadline. @version 1.8 */
+        bool isTimed() const { return _timed; }
+
+        /**
+         * Use the NV_swap_group of frame-locked GPUs when available.
+         *
+         * Windows on GPUs with a frame lock device join a hardware swap
+         * barrier. The network barrier only synchronizes the remaining
+         * windows with one window of the hardware group.
+         * @version 1.8
+         */
+        void setHardware( const bool hardware ) { _hardware = hardware; }
+
+        /** @return true if hardware barriers are negotiated. @version 1.8 */
+        bool isHardware() const { return _hardware; }
         //@}
 
     private:
@@ -63,6 +91,8 @@ namespace fabric
 
         uint32_t _nvSwapGroup;
         uint32_t _nvSwapBarrier;
+        bool _timed;
+        bool _hardware;
     };
 
     EQFABRIC_API std::ostream& operator << ( std::ostream&, const SwapBarrier& );
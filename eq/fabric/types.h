@@ -48,6 +48,7 @@ class Equalizer;
 class Error;
 class ErrorRegistry;
 class Frustum;
+class MetricsExporter;
 class Pixel;
 class PixelViewport;
 class Projection;
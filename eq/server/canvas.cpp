@@ -45,6 +45,7 @@ typedef fabric::Canvas< Config, Canvas, Segment, Layout > Super;
 Canvas::Canvas( Config* parent )
         : Super( parent )
         , _state( STATE_STOPPED )
+        , _warm( false )
         , _private( 0 )
 {}
 
@@ -82,6 +83,19 @@ void Canvas::activateLayout( const uint32_t index )
 void Canvas::init()
 {
     LBASSERT( _state == STATE_STOPPED );
+    LBASSERT( !_warm );
+
+    // Dormant layouts keep their channels initialized for fast switches
+    if( getConfig()->getIAttribute( Config::IATTR_DORMANT_LAYOUTS ) ==
+        fabric::ON )
+    {
+        _warm = true;
+        const Layouts& layouts = getLayouts();
+        for( LayoutsCIter i = layouts.begin(); i != layouts.end(); ++i )
+            if( *i )
+                (*i)->warm( this, true );
+    }
+
     _switchLayout( LB_UNDEFINED_UINT32, getActiveLayoutIndex( ));
     _state = STATE_RUNNING;
 }
@@ -90,6 +104,15 @@ void Canvas::exit()
 {
     LBASSERT( _state == STATE_RUNNING || _state == STATE_DELETE );
     _switchLayout( getActiveLayoutIndex(), LB_UNDEFINED_UINT32 );
+    if( _warm )
+    {
+        const Layouts& layouts = getLayouts();
+        for( LayoutsCIter i = layouts.begin(); i != layouts.end(); ++i )
+            if( *i )
+                (*i)->warm( this, false );
+        _warm = false;
+    }
+
     if( _state == STATE_RUNNING )
         _state = STATE_STOPPED;
 }
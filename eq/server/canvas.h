@@ -60,6 +60,9 @@ namespace server
 
         /** @return true if this canvas should be deleted. */
         bool needsDelete() const { return _state == STATE_DELETE; }
+
+        /** @return true if all layouts of this canvas are kept initialized. */
+        bool isWarm() const { return _warm; }
         //@}
 
         /**
@@ -85,6 +88,8 @@ namespace server
         }
             _state;
 
+        bool _warm; //!< all layouts are initialized, see IATTR_DORMANT_LAYOUTS
+
         struct Private;
         Private* _private; // placeholder for binary-compatible changes
 
@@ -83,10 +83,12 @@ namespace
 Channel::Channel( Window* parent )
         : Super( parent )
         , _active( 0 )
+        , _warm( 0 )
         , _view( 0 )
         , _segment( 0 )
         , _state( STATE_STOPPED )
         , _lastDrawCompound( 0 )
+        , _drawTime( 0 )
         , _private( 0 )
 {
     const Global* global = Global::instance();
@@ -105,10 +107,12 @@ Channel::Channel( Window* parent )
 Channel::Channel( const Channel& from )
         : Super( from )
         , _active( 0 )
+        , _warm( 0 )
         , _view( 0 )
         , _segment( 0 )
         , _state( STATE_STOPPED )
         , _lastDrawCompound( 0 )
+        , _drawTime( 0 )
         , _private( 0 )
 {
     // Don't copy view and segment. Will be re-set by segment copy ctor
@@ -251,6 +255,31 @@ void Channel::deactivate()
                       << std::endl;
 }
 
+void Channel::warmUp()
+{
+    Window* window = getWindow();
+    LBASSERT( window );
+
+    ++_warm;
+    window->activate();
+
+    LBLOG( LOG_VIEW ) << "warm up: " << _warm << " " << (void*)this
+                      << std::endl;
+}
+
+void Channel::coolDown()
+{
+    Window* window = getWindow();
+    LBASSERT( _warm != 0 );
+    LBASSERT( window );
+
+    --_warm;
+    window->deactivate();
+
+    LBLOG( LOG_VIEW ) << "cool down: " << _warm << " " << (void*)this
+                      << std::endl;
+}
+
 void Channel::setOutput( View* view, Segment* segment )
 {
     if( _view == view && _segment == segment )
@@ -312,6 +341,7 @@ void Channel::configInit( const uint128_t& initID, const uint32_t /*frame*/ )
     LBLOG( LOG_INIT ) << "Init channel" << std::endl;
     getWindow()->send( fabric::CMD_WINDOW_CREATE_CHANNEL ) << getID();
     send( fabric::CMD_CHANNEL_CONFIG_INIT ) << initID;
+    _lastContext = RenderContext(); // reset by the client channel on init
 }
 
 bool Channel::syncConfigInit()
@@ -373,23 +403,23 @@ void Channel::_setupRenderContext( const uint128_t& frameID,
 
 bool Channel::update( const uint128_t& frameID, const uint32_t frameNumber )
 {
-    if( !isRunning( ))
-        return false; // not updated
+    if( !isRunning() || !isActive( ))
+        return false; // not updated or kept warm only
 
-    LBASSERT( isActive( ))
     LBASSERT( getWindow()->isActive( ));
 
     RenderContext context;
     _setupRenderContext( frameID, context );
-    send( fabric::CMD_CHANNEL_FRAME_START )
-            << context << getVersion() << frameNumber;
+    send( fabric::CMD_CHANNEL_FRAME_START, context )
+            << getVersion() << frameNumber;
     LBLOG( LOG_TASKS ) << "TASK channel " << getName() << " start frame  "
                        << frameNumber << std::endl;
 
     bool updated = false;
     const Compounds& compounds = getCompounds();
+    const bool isStatic = getConfig()->isStaticFrame();
     for( Compounds::const_iterator i = compounds.begin();
-         i != compounds.end(); ++i )
+         i != compounds.end() && !isStatic; ++i )
     {
         const Compound* compound = *i;
         ChannelUpdateVisitor visitor( this, frameID, frameNumber );
@@ -406,7 +436,7 @@ bool Channel::update( const uint128_t& frameID, const uint32_t frameNumber )
         updated |= visitor.isUpdated();
     }
 
-    send( fabric::CMD_CHANNEL_FRAME_FINISH ) << context << frameNumber;
+    send( fabric::CMD_CHANNEL_FRAME_FINISH, context ) << frameNumber;
     LBLOG( LOG_TASKS ) << "TASK channel " << getName() << " finish frame  "
                            << frameNumber << std::endl;
     _lastDrawCompound = 0;
@@ -419,6 +449,23 @@ co::ObjectOCommand Channel::send( const uint32_t cmd )
     return getNode()->send( cmd, getID( ));
 }
 
+co::ObjectOCommand Channel::send( const uint32_t cmd,
+                                  const RenderContext& context )
+{
+    co::ObjectOCommand command = send( cmd );
+    context.serialize( command, _lastContext );
+    return command;
+}
+
+co::ObjectOCommand Channel::send( const uint32_t cmd, const RenderContext& left,
+                                  const RenderContext& right )
+{
+    co::ObjectOCommand command = send( cmd );
+    left.serialize( command, _lastContext );
+    right.serialize( command, _lastContext );
+    return command;
+}
+
 //---------------------------------------------------------------------------
 // Listener interface
 //---------------------------------------------------------------------------
@@ -439,9 +486,9 @@ void Channel::removeListener(  ChannelListener* listener )
         _listeners.erase( i );
 }
 
-void Channel::_fireLoadData( const uint32_t frameNumber,
-                             const fabric::Statistics& statistics,
-                             const Viewport& region )
+void Channel::fireLoadData( const uint32_t frameNumber,
+                            const fabric::Statistics& statistics,
+                            const Viewport& region )
 {
     LB_TS_SCOPED( _serverThread );
 
@@ -484,7 +531,16 @@ bool Channel::_cmdFrameFinishReply( co::ICommand& cmd )
     const uint32_t frameNumber = command.read< uint32_t >();
     const Statistics& statistics = command.read< Statistics >();
 
-    _fireLoadData( frameNumber, statistics, region );
+    _drawTime = 0;
+    for( Statistics::const_iterator i = statistics.begin();
+         i != statistics.end(); ++i )
+    {
+        if( i->type == Statistic::CHANNEL_DRAW )
+            _drawTime += i->endTime - i->startTime;
+    }
+
+    getConfig()->addStatistics( *this, frameNumber, statistics, region );
+    fireLoadData( frameNumber, statistics, region );
     return true;
 }
 
@@ -515,6 +571,15 @@ void Channel::output( std::ostream& os ) const
 
         os << ( i==IATTR_HINT_STATISTICS ? "hint_statistics   " :
                 i==IATTR_HINT_SENDTOKEN ?  "hint_sendtoken    " :
+                i==IATTR_HINT_TRANSMIT_ROWS ? "hint_transmit_rows " :
+                i==IATTR_HINT_ASYNC_ASSEMBLY ? "hint_async_assembly " :
+                i==IATTR_HINT_REPROJECTION ? "hint_reprojection " :
+                i==IATTR_HINT_MULTIVIEW ? "hint_multiview    " :
+                i==IATTR_HINT_TILE_ATLAS ? "hint_tile_atlas   " :
+                i==IATTR_HINT_TEMPORAL_UPSAMPLING ?
+                                           "hint_temporal_upsampling " :
+                i==IATTR_HINT_TEMPORAL_TRANSMIT ? "hint_temporal_transmit " :
+                i==IATTR_HINT_TRANSMIT_DEADLINE ? "hint_transmit_deadline " :
                                            "ERROR " )
            << static_cast< fabric::IAttribute >( value ) << std::endl;
     }
@@ -533,7 +598,9 @@ void Channel::output( std::ostream& os ) const
             attrPrinted = true;
         }
 
-        os << ( i == SATTR_DUMP_IMAGE ? "dump_image        " : "ERROR " )
+        os << ( i == SATTR_DUMP_IMAGE      ? "dump_image        " :
+                i == SATTR_SHARED_MEMORY   ? "shared_memory     " :
+                i == SATTR_PLAYBACK_IMAGES ? "playback_images   " : "ERROR " )
            << "\"" << value << "\"" << std::endl;
     }
 
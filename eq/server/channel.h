@@ -25,6 +25,7 @@
 
 #include <eq/fabric/channel.h>       // base class
 #include <eq/fabric/pixelViewport.h> // member
+#include <eq/fabric/renderContext.h> // member
 #include <eq/fabric/viewport.h>      // member
 #include <lunchbox/monitor.h> // member
 
@@ -85,6 +86,20 @@ public:
     /** @return if this channel is actively used for rendering. */
     bool isActive() const { return (_active != 0); }
 
+    /**
+     * Increase the count of dormant uses keeping this channel initialized.
+     *
+     * A warm channel and its parents are initialized and kept running, but
+     * the channel is not rendering unless it is also active.
+     */
+    void warmUp();
+
+    /** Decrease the count of dormant uses. */
+    void coolDown();
+
+    /** @return if this channel is kept initialized for a dormant use. */
+    bool isWarm() const { return (_warm != 0); }
+
     /** @return if this window is running. */
     bool isRunning() const { return _state == STATE_RUNNING; }
 
@@ -132,6 +147,9 @@ public:
         { _lastDrawCompound = compound; }
     const Compound* getLastDrawCompound() const { return _lastDrawCompound;}
 
+    /** @return the draw time of the last finished frame in ms. */
+    int64_t getDrawTime() const { return _drawTime; }
+
     void setIAttribute( const IAttribute attr, const int32_t value )
         { fabric::Channel< Window, Channel >::setIAttribute( attr, value );}
     void setSAttribute( const SAttribute attr, const std::string& value )
@@ -165,6 +183,18 @@ public:
     bool update( const uint128_t& frameID, const uint32_t frameNumber );
 
     co::ObjectOCommand send( const uint32_t cmd );
+
+    /**
+     * Send a task command starting with the given render context.
+     *
+     * Only the fields of the context which changed since the last task sent
+     * to this channel are transmitted.
+     */
+    co::ObjectOCommand send( const uint32_t cmd, const RenderContext& context );
+
+    /** Send a task command starting with the render contexts of two eyes. */
+    co::ObjectOCommand send( const uint32_t cmd, const RenderContext& left,
+                             const RenderContext& right );
     //@}
 
     /** @name Channel listener interface. */
@@ -175,6 +205,10 @@ public:
     void removeListener( ChannelListener* listener );
     /** @return true if the channel has listeners */
     bool hasListeners() const { return !_listeners.empty(); }
+
+    /** @internal Pass the load data of a frame to all channel listeners. */
+    void fireLoadData( const uint32_t frameNumber,
+                       const Statistics& statistics, const Viewport& region );
     //@}
 
     bool omitOutput() const; //!< @internal
@@ -189,6 +223,9 @@ private:
     /** Number of activations for this channel. */
     uint32_t _active;
 
+    /** Number of dormant uses keeping this channel initialized. */
+    uint32_t _warm;
+
     /** The view used by this channel. */
     View* _view;
 
@@ -203,6 +240,12 @@ private:
     /** The last draw compound for this entity */
     const Compound* _lastDrawCompound;
 
+    /** The draw time of the last finished frame */
+    int64_t _drawTime;
+
+    /** The render context of the last task, for delta encoding */
+    RenderContext _lastContext;
+
     typedef std::vector< ChannelListener* > ChannelListeners;
     ChannelListeners _listeners;
 
@@ -217,10 +260,6 @@ private:
     void _setupRenderContext( const uint128_t& frameID,
                               RenderContext& context );
 
-    void _fireLoadData( const uint32_t frameNumber,
-                        const Statistics& statistics,
-                        const Viewport& region );
-
     /* command handler functions. */
     bool _cmdConfigInitReply( co::ICommand& command );
     bool _cmdConfigExitReply( co::ICommand& command );
@@ -108,6 +108,9 @@ VisitorResult ChannelUpdateVisitor::visitPre( const Compound* compound )
 
     _updateDrawFinish( compound );
 
+    if( !compound->usesChannel( _channel )) // no tasks for us in this subtree
+        return TRAVERSE_PRUNE;
+
     if( _skipCompound( compound ))
         return TRAVERSE_CONTINUE;
 
@@ -133,7 +136,6 @@ VisitorResult ChannelUpdateVisitor::visitLeaf( const Compound* compound )
         return TRAVERSE_CONTINUE;
     }
 
-    // OPT: Send render context once before task commands?
     RenderContext context;
     _setupRenderContext( compound, context );
     _updateFrameRate( compound );
@@ -157,7 +159,8 @@ VisitorResult ChannelUpdateVisitor::visitPost( const Compound* compound )
 }
 
 void ChannelUpdateVisitor::_setupRenderContext( const Compound* compound,
-                                                RenderContext& context )
+                                                RenderContext& context,
+                                                const fabric::Eye eye )
 {
     const Channel* destChannel = compound->getInheritChannel();
     LBASSERT( destChannel );
@@ -174,9 +177,9 @@ void ChannelUpdateVisitor::_setupRenderContext( const Compound* compound,
     context.phase         = compound->getInheritPhase();
     context.offset.x()    = context.pvp.x;
     context.offset.y()    = context.pvp.y;
-    context.eye           = _eye;
-    context.buffer        = _getDrawBuffer( compound );
-    context.bufferMask    = _getDrawBufferMask( compound );
+    context.eye           = eye;
+    context.buffer        = _getDrawBuffer( compound, eye );
+    context.bufferMask    = _getDrawBufferMask( compound, eye );
     context.view          = destChannel->getViewVersion();
     context.taskID        = compound->getTaskID();
 
@@ -203,7 +206,7 @@ void ChannelUpdateVisitor::_setupRenderContext( const Compound* compound,
     }
     // TODO: pvp size overcommit check?
 
-    compound->computeFrustum( context, _eye );
+    compound->computeFrustum( context, eye );
 }
 
 void ChannelUpdateVisitor::_updateDraw( const Compound* compound,
@@ -221,7 +224,20 @@ void ChannelUpdateVisitor::_updateDraw( const Compound* compound,
     if( compound->testInheritTask( fabric::TASK_DRAW ))
     {
         const bool finish = _channel->hasListeners(); // finish for eq stats
-        _channel->send( fabric::CMD_CHANNEL_FRAME_DRAW ) << context << finish;
+        if( _useMultiView( compound ))
+        {
+            // render both eyes now, the right eye draw task of this compound
+            // only copies the image of the right eye
+            RenderContext right;
+            _setupRenderContext( compound, right, fabric::EYE_RIGHT );
+            _channel->send( fabric::CMD_CHANNEL_FRAME_DRAW_MULTIVIEW, context,
+                            right ) << finish;
+            _updated = true;
+            LBLOG( LOG_TASKS ) << "TASK draw multiview " << _channel->getName()
+                               << " " << finish << std::endl;
+            return;
+        }
+        _channel->send( fabric::CMD_CHANNEL_FRAME_DRAW, context ) << finish;
         _updated = true;
         LBLOG( LOG_TASKS ) << "TASK draw " << _channel->getName() <<  " "
                            << finish << std::endl;
@@ -251,16 +267,31 @@ void ChannelUpdateVisitor::_updateDrawTiles( const Compound* compound,
     {
         const TileQueue* inputQueue = *i;
         const TileQueue* outputQueue = inputQueue->getOutputQueue( context.eye);
-        const uint128_t& id = outputQueue->getQueueMasterID( context.eye );
-        LBASSERT( id != 0 );
+        const size_t nLanes = outputQueue->getNumLanes();
+        const size_t lane = inputQueue->getLane() < nLanes ?
+                            inputQueue->getLane() : 0;
+
+        // own lane first, then steal from the nearest neighbors
+        std::vector< uint128_t > ids;
+        ids.push_back( outputQueue->getQueueMasterID( context.eye, lane ));
+        for( size_t j = 1; j < nLanes; ++j )
+        {
+            if( lane + j < nLanes )
+                ids.push_back( outputQueue->getQueueMasterID( context.eye,
+                                                              lane + j ));
+            if( lane >= j )
+                ids.push_back( outputQueue->getQueueMasterID( context.eye,
+                                                              lane - j ));
+        }
+        LBASSERT( ids.front() != 0 );
 
         const bool isLocal = (_channel == destChannel);
         const uint32_t tasks = compound->getInheritTasks() &
                             ( eq::fabric::TASK_CLEAR | eq::fabric::TASK_DRAW |
                               eq::fabric::TASK_READBACK );
 
-        _channel->send( fabric::CMD_CHANNEL_FRAME_TILES )
-                << context << isLocal << id << tasks << frameIDs;
+        _channel->send( fabric::CMD_CHANNEL_FRAME_TILES, context )
+                << isLocal << ids << tasks << frameIDs;
         _updated = true;
         LBLOG( LOG_TASKS ) << "TASK tiles " << _channel->getName() <<  " "
                            << std::endl;
@@ -333,7 +364,7 @@ void ChannelUpdateVisitor::_updateDrawFinish( const Compound* compound ) const
 
 void ChannelUpdateVisitor::_sendClear( const RenderContext& context )
 {
-    _channel->send( fabric::CMD_CHANNEL_FRAME_CLEAR ) << context;
+    _channel->send( fabric::CMD_CHANNEL_FRAME_CLEAR, context );
     _updated = true;
     LBLOG( LOG_TASKS ) << "TASK clear " << _channel->getName() <<  " "
                        << std::endl;
@@ -345,21 +376,35 @@ void ChannelUpdateVisitor::_updateFrameRate( const Compound* compound ) const
     Window*     window = _channel->getWindow();
 
     if( maxFPS < window->getMaxFPS())
+    {
         window->setMaxFPS( maxFPS );
+        window->setPacing( compound->isInheritPacing( ));
+    }
+}
+
+bool ChannelUpdateVisitor::_useMultiView( const Compound* compound ) const
+{
+    // blitting the right eye image bypasses the anaglyph color mask
+    return _eye == EYE_LEFT && compound->isInheritActive( EYE_RIGHT ) &&
+           _channel->getIAttribute( Channel::IATTR_HINT_MULTIVIEW ) == fabric::ON &&
+           compound->getInheritIAttribute( Compound::IATTR_STEREO_MODE ) !=
+               fabric::ANAGLYPH;
 }
 
-uint32_t ChannelUpdateVisitor::_getDrawBuffer( const Compound* compound ) const
+uint32_t ChannelUpdateVisitor::_getDrawBuffer( const Compound* compound,
+                                               const fabric::Eye eye ) const
 {
     const DrawableConfig& dc = _channel->getWindow()->getDrawableConfig();
-    const int32_t eye = lunchbox::getIndexOfLastBit( _eye );
+    const int32_t index = lunchbox::getIndexOfLastBit( eye );
 
     if( compound->getInheritIAttribute(Compound::IATTR_STEREO_MODE) == QUAD )
-        return _drawBuffer[ dc.stereo ][ dc.doublebuffered ][ eye ];
-    return _drawBuffer[ 0 ][ dc.doublebuffered ][ eye ];
+        return _drawBuffer[ dc.stereo ][ dc.doublebuffered ][ index ];
+    return _drawBuffer[ 0 ][ dc.doublebuffered ][ index ];
 }
 
 fabric::ColorMask
-ChannelUpdateVisitor::_getDrawBufferMask(const Compound* compound) const
+ChannelUpdateVisitor::_getDrawBufferMask( const Compound* compound,
+                                          const fabric::Eye eye ) const
 {
     if( compound->getInheritIAttribute( Compound::IATTR_STEREO_MODE ) !=
         fabric::ANAGLYPH )
@@ -367,7 +412,7 @@ ChannelUpdateVisitor::_getDrawBufferMask(const Compound* compound) const
         return ColorMask::ALL;
     }
 
-    switch( _eye )
+    switch( eye )
     {
         case EYE_LEFT:
             return ColorMask(
@@ -419,8 +464,7 @@ void ChannelUpdateVisitor::_updateAssemble( const Compound* compound,
     LBLOG( LOG_ASSEMBLY | LOG_TASKS )
         << "TASK assemble " << _channel->getName()
         << " nFrames " << frames.size() << std::endl;
-    _channel->send( fabric::CMD_CHANNEL_FRAME_ASSEMBLE )
-            << context << frames;
+    _channel->send( fabric::CMD_CHANNEL_FRAME_ASSEMBLE, context ) << frames;
     _updated = true;
 }
 
@@ -452,8 +496,7 @@ void ChannelUpdateVisitor::_updateReadback( const Compound* compound,
         return;
 
     // readback task
-    _channel->send( fabric::CMD_CHANNEL_FRAME_READBACK )
-            << context << frames;
+    _channel->send( fabric::CMD_CHANNEL_FRAME_READBACK, context ) << frames;
     _updated = true;
     LBLOG( LOG_ASSEMBLY | LOG_TASKS )
         << "TASK readback " << _channel->getName()
@@ -470,7 +513,7 @@ void ChannelUpdateVisitor::_updateViewStart( const Compound* compound,
     // view start task
     LBLOG( LOG_TASKS ) << "TASK view start " << _channel->getName()
                        << std::endl;
-    _channel->send( fabric::CMD_CHANNEL_FRAME_VIEW_START ) << context;
+    _channel->send( fabric::CMD_CHANNEL_FRAME_VIEW_START, context );
 }
 
 void ChannelUpdateVisitor::_updateViewFinish( const Compound* compound,
@@ -483,7 +526,7 @@ void ChannelUpdateVisitor::_updateViewFinish( const Compound* compound,
     // view finish task
     LBLOG( LOG_TASKS ) << "TASK view finish " << _channel->getName() <<  " "
                        << std::endl;
-    _channel->send( fabric::CMD_CHANNEL_FRAME_VIEW_FINISH ) << context;
+    _channel->send( fabric::CMD_CHANNEL_FRAME_VIEW_FINISH, context );
 }
 
 }
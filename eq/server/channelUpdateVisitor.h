@@ -72,11 +72,18 @@ namespace server
         void _updateDrawFinish( const Compound* compound ) const;
         void _updateFrameRate( const Compound* compound ) const;
 
-        uint32_t _getDrawBuffer( const Compound* compound ) const;
-        fabric::ColorMask _getDrawBufferMask( const Compound* compound ) const;
+        bool _useMultiView( const Compound* compound ) const;
+        uint32_t _getDrawBuffer( const Compound* compound,
+                                 const fabric::Eye eye ) const;
+        fabric::ColorMask _getDrawBufferMask( const Compound* compound,
+                                              const fabric::Eye eye ) const;
 
         void _setupRenderContext( const Compound* compound,
-                                  RenderContext& context );
+                                  RenderContext& context )
+            { _setupRenderContext( compound, context, _eye ); }
+        void _setupRenderContext( const Compound* compound,
+                                  RenderContext& context,
+                                  const fabric::Eye eye );
 
         void _updatePostDraw( const Compound* compound, 
                               const fabric::RenderContext& context );
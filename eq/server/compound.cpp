@@ -64,6 +64,7 @@ Compound::Compound( Config* parent )
         , _parent( 0 )
         , _usage( 1.0f )
         , _taskID( 0 )
+        , _subtreeChannelsDirty( true )
         , _frustum( _data.frustumData )
 {
     LBASSERT( parent );
@@ -76,6 +77,7 @@ Compound::Compound( Compound* parent )
         , _parent( parent )
         , _usage( 1.0f )
         , _taskID( 0 )
+        , _subtreeChannelsDirty( true )
         , _frustum( _data.frustumData )
 {
     LBASSERT( parent );
@@ -143,6 +145,7 @@ Compound::Data::Data()
         , period( LB_UNDEFINED_UINT32 )
         , phase( LB_UNDEFINED_UINT32 )
         , maxFPS( std::numeric_limits< float >::max( ))
+        , pacing( false )
 {
     const Global* global = Global::instance();
     for( int i=0; i<IATTR_ALL; ++i )
@@ -156,6 +159,7 @@ void Compound::_addChild( Compound* child )
 {
     LBASSERT( child->_parent == this );
     _children.push_back( child );
+    _invalidateSubtreeChannels();
     _fireChildAdded( child );
 }
 
@@ -167,9 +171,55 @@ bool Compound::_removeChild( Compound* child )
 
     _fireChildRemove( child );
     _children.erase( i );
+    _invalidateSubtreeChannels();
     return true;
 }
 
+void Compound::_invalidateSubtreeChannels()
+{
+    // a dirty compound has only dirty parents
+    for( Compound* compound = this;
+         compound && !compound->_subtreeChannelsDirty;
+         compound = compound->_parent )
+    {
+        compound->_subtreeChannelsDirty = true;
+    }
+}
+
+void Compound::_updateSubtreeChannels()
+{
+    if( !_subtreeChannelsDirty )
+        return;
+
+    _subtreeChannels.clear();
+    if( _data.channel )
+        _subtreeChannels.push_back( _data.channel );
+
+    for( CompoundsCIter i = _children.begin(); i != _children.end(); ++i )
+    {
+        Compound* child = *i;
+        child->_updateSubtreeChannels();
+        _subtreeChannels.insert( _subtreeChannels.end(),
+                                 child->_subtreeChannels.begin(),
+                                 child->_subtreeChannels.end( ));
+    }
+
+    std::sort( _subtreeChannels.begin(), _subtreeChannels.end( ));
+    _subtreeChannels.erase( std::unique( _subtreeChannels.begin(),
+                                         _subtreeChannels.end( )),
+                            _subtreeChannels.end( ));
+    _subtreeChannelsDirty = false;
+}
+
+bool Compound::usesChannel( const Channel* channel ) const
+{
+    if( _subtreeChannelsDirty || getChannel() == channel )
+        return true;
+    return std::binary_search( _subtreeChannels.begin(),
+                               _subtreeChannels.end(),
+                               const_cast< Channel* >( channel ));
+}
+
 Compound* Compound::getNext() const
 {
     if( !_parent )
@@ -201,6 +251,7 @@ ServerPtr Compound::getServer()
 void Compound::setChannel( Channel* channel )
 {
     _data.channel = channel;
+    _invalidateSubtreeChannels();
 
     // Update swap barrier
     if( !isDestination( ))
@@ -305,7 +356,7 @@ bool Compound::isActive() const
     if( !channel )
         return true;
 
-    if( !channel->isRunning( ))
+    if( !channel->isRunning() || channel->getNode()->isStandby( ))
         return false;
 
     LBASSERT( _inherit.channel );
@@ -626,16 +677,44 @@ void Compound::updateFrustum( const Vector3f& eye, const float ratio )
 
 void Compound::computeFrustum( RenderContext& context, const Eye eye ) const
 {
-    // compute eye position in screen space
-    const Vector3f& eyeWorld = _getEyePosition( eye );
     const FrustumData& frustumData = getInheritFrustumData();
-    const Matrix4f& xfm = frustumData.getTransform();
-    const Vector3f eyeWall = xfm * eyeWorld;
+    const FrustumKey key = _getFrustumKey();
+    FrustumCache& cache = _frustumCache[ lunchbox::getIndexOfLastBit( eye )];
 
-    LBVERB << "Eye position world: " << eyeWorld << " wall " << eyeWall
-        << std::endl;
-    _computePerspective( context, eyeWall );
-    _computeOrtho( context, eyeWall );
+    if( cache.valid && cache.key == key )
+    {
+        context.frustum = cache.frustum;
+        context.ortho = cache.ortho;
+        context.headTransform = cache.headTransform;
+        context.orthoTransform = cache.orthoTransform;
+        context.eyeWall = cache.eyeWall;
+    }
+    else
+    {
+        // compute eye position in screen space
+        const Vector3f& eyeWorld = _getEyePosition( eye );
+        const Matrix4f& xfm = frustumData.getTransform();
+        const Vector3f eyeWall = xfm * eyeWorld;
+
+        LBVERB << "Eye position world: " << eyeWorld << " wall " << eyeWall
+               << std::endl;
+        _computePerspective( context, eyeWall );
+        _computeOrtho( context, eyeWall );
+        context.eyeWall = eyeWall;
+
+        cache.key = key;
+        cache.frustum = context.frustum;
+        cache.ortho = context.ortho;
+        cache.headTransform = context.headTransform;
+        cache.orthoTransform = context.orthoTransform;
+        cache.eyeWall = eyeWall;
+        cache.valid = true;
+    }
+
+    // for late latching of the head position on the render clients
+    context.headMatrix = key.observer ? key.observer->getHeadMatrix() :
+                                        Matrix4f::IDENTITY;
+    context.wallType = frustumData.getType();
 }
 
 void Compound::computeTileFrustum( Frustumf& frustum, const Eye eye,
@@ -699,6 +778,27 @@ void Compound::_computeOrtho( RenderContext& context, const Vector3f& eye) const
         context.orthoTransform *= _getInverseHeadMatrix();
 }
 
+Compound::FrustumKey Compound::_getFrustumKey() const
+{
+    const Channel* destChannel = getInheritChannel();
+    const View* view = destChannel->getView();
+    const Frustumf& frustum = destChannel->getFrustum();
+
+    FrustumKey key;
+    key.frustumRevision = getInheritFrustumData().getRevision();
+    key.observer = view ? view->getObserver() : 0;
+    if( key.observer )
+        key.eyeRevision = key.observer->getEyeRevision();
+    else
+        key.eyeBase = getConfig()->getFAttribute( Config::FATTR_EYE_BASE );
+    key.modelUnit = view ? view->getModelUnit() : 1.f;
+    key.nearFar = Vector2f( frustum.near_plane(), frustum.far_plane( ));
+    key.pixel = getInheritPixel();
+    key.vp = getInheritViewport();
+    key.destPVP = destChannel->getPixelViewport();
+    return key;
+}
+
 Vector3f Compound::_getEyePosition( const Eye eye ) const
 {
     const FrustumData& frustumData = getInheritFrustumData();
@@ -1061,6 +1161,18 @@ void Compound::deactivate( const uint32_t eyes )
     }
 }
 
+void Compound::warmUp()
+{
+    CompoundWarmVisitor channelWarm( true );
+    accept( channelWarm );
+}
+
+void Compound::coolDown()
+{
+    CompoundWarmVisitor channelCool( false );
+    accept( channelCool );
+}
+
 void Compound::init()
 {
     CompoundInitVisitor initVisitor;
@@ -1175,6 +1287,8 @@ void Compound::restore()
 //---------------------------------------------------------------------------
 void Compound::update( const uint32_t frameNumber )
 {
+    _updateSubtreeChannels();
+
     // https://github.com/Eyescale/Equalizer/issues/76
     CompoundUpdateActivateVisitor updateActivateVisitor( frameNumber );
     accept( updateActivateVisitor );
@@ -1342,6 +1456,7 @@ void Compound::_updateInheritNode()
         _inherit.phase = _data.phase;
 
     _inherit.maxFPS = _data.maxFPS;
+    _inherit.pacing = _data.pacing;
 
     if( _data.buffers != Frame::BUFFER_UNDEFINED )
         _inherit.buffers = _data.buffers;
@@ -148,6 +148,12 @@ public:
     EQSERVER_API Channel* getChannel();
     EQSERVER_API const Channel* getChannel() const;
 
+    /**
+     * @return true if this compound or one of its children uses the channel.
+     *         Valid after the first update(), conservatively true before.
+     */
+    bool usesChannel( const Channel* channel ) const;
+
     Window* getWindow();
     const Window* getWindow() const;
 
@@ -227,6 +233,10 @@ public:
     void setMaxFPS( const float fps )          { _data.maxFPS = fps; }
     float getMaxFPS() const                    { return _data.maxFPS; }
 
+    /** Pace the swaps to the max FPS instead of throttling them. */
+    void setPacing( const bool pacing )        { _data.pacing = pacing; }
+    bool isPacing() const                      { return _data.pacing; }
+
     void setUsage( const float usage )
         { LBASSERT( usage >= 0.f ); _usage = usage; }
     float getUsage() const                     { return _usage; }
@@ -333,6 +343,7 @@ public:
     uint32_t getInheritPeriod()          const { return _inherit.period; }
     uint32_t getInheritPhase()           const { return _inherit.phase; }
     float getInheritMaxFPS()             const { return _inherit.maxFPS; }
+    bool isInheritPacing()               const { return _inherit.pacing; }
     int32_t getInheritIAttribute( const IAttribute attr ) const
     { return _inherit.iAttributes[attr]; }
     const FrustumData& getInheritFrustumData() const
@@ -391,7 +402,12 @@ public:
     /** Update the frustum from the view or segment. */
     void updateFrustum( const Vector3f& eye, const float ratio );
 
-    /** compute the frustum of the given context */
+    /**
+     * Compute the frustum of the given context.
+     *
+     * The results are cached per eye until the frustum data, the observer's
+     * head or the destination channel's frustum change.
+     */
     void computeFrustum( RenderContext& context,
                          const fabric::Eye eye ) const;
 
@@ -439,6 +455,15 @@ public:
     /** @internal Deactivate the given eyes for the the compound tree. */
     void deactivate( const uint32_t eyes );
 
+    /**
+     * @internal Keep the channels of the compound tree initialized while the
+     * compound is inactive.
+     */
+    void warmUp();
+
+    /** @internal Undo warmUp(). */
+    void coolDown();
+
     /**
      * @return if the compound is activated for selected eye
      and current (DPlex).
@@ -538,6 +563,10 @@ private:
     /** Unique identifier for channel tasks. */
     uint32_t _taskID;
 
+    /** The channels set on this compound and its children, sorted. */
+    Channels _subtreeChannels;
+    bool _subtreeChannelsDirty;
+
     struct Data
     {
         Data();
@@ -558,6 +587,7 @@ private:
         uint32_t          phase;
         int32_t           iAttributes[IATTR_ALL];
         float             maxFPS;
+        bool              pacing;
 
         // compound activation per eye
         uint32_t active[ fabric::NUM_EYES ];
@@ -588,6 +618,48 @@ private:
     TileQueues _inputTileQueues;
     TileQueues _outputTileQueues;
 
+    /** The inputs of computeFrustum() besides the eye. */
+    struct FrustumKey
+    {
+        FrustumKey() : frustumRevision( 0 ), observer( 0 ), eyeRevision( 0 ),
+                       modelUnit( 0.f ), eyeBase( 0.f ) {}
+
+        bool operator == ( const FrustumKey& rhs ) const
+        {
+            return frustumRevision == rhs.frustumRevision &&
+                   observer == rhs.observer &&
+                   eyeRevision == rhs.eyeRevision &&
+                   modelUnit == rhs.modelUnit && eyeBase == rhs.eyeBase &&
+                   nearFar == rhs.nearFar && pixel == rhs.pixel &&
+                   vp == rhs.vp && destPVP == rhs.destPVP;
+        }
+
+        uint32_t frustumRevision;
+        const Observer* observer;
+        uint32_t eyeRevision;
+        float modelUnit;
+        float eyeBase;
+        Vector2f nearFar;
+        Pixel pixel;
+        Viewport vp;
+        PixelViewport destPVP;
+    };
+
+    /** The results of computeFrustum() for one eye. */
+    struct FrustumCache
+    {
+        FrustumCache() : valid( false ) {}
+
+        FrustumKey key;
+        Frustumf frustum;
+        Frustumf ortho;
+        Matrix4f headTransform;
+        Matrix4f orthoTransform;
+        Vector3f eyeWall;
+        bool valid;
+    };
+    mutable FrustumCache _frustumCache[ fabric::NUM_EYES ];
+
     struct Private;
     Private* _private; // placeholder for binary-compatible changes
 
@@ -597,6 +669,9 @@ private:
     void _addChild( Compound* child );
     bool _removeChild( Compound* child );
 
+    void _invalidateSubtreeChannels();
+    void _updateSubtreeChannels();
+
     void _updateOverdraw( Wall& wall );
     void _updateInheritRoot();
     void _updateInheritNode();
@@ -614,6 +689,7 @@ private:
     void _computePerspective( RenderContext& context,
                               const Vector3f& eye ) const;
     void _computeOrtho( RenderContext& context, const Vector3f& eye ) const;
+    FrustumKey _getFrustumKey() const;
     Vector3f _getEyePosition( const fabric::Eye eye ) const;
     const Matrix4f& _getInverseHeadMatrix() const;
     void _computeFrustumCorners( Frustumf& frustum,
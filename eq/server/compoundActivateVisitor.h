@@ -58,6 +58,35 @@ private:
     const Eye _eye;
 };
 
+/** The compound visitor warming up or cooling down all channels of a tree. */
+class CompoundWarmVisitor : public CompoundVisitor
+{
+public:
+    explicit CompoundWarmVisitor( const bool warm ) : _warm( warm ) {}
+    virtual ~CompoundWarmVisitor() {}
+
+    /** Visit all compounds. */
+    virtual VisitorResult visit( Compound* compound )
+    {
+        Channel* channel = compound->getChannel();
+        if( !channel )
+            return TRAVERSE_CONTINUE;
+
+        if( _warm )
+        {
+            channel->warmUp();
+            compound->updateInheritTasks();
+            channel->addTasks( compound->getInheritTasks( ));
+        }
+        else
+            channel->coolDown();
+        return TRAVERSE_CONTINUE;
+    }
+
+private:
+    const bool _warm;
+};
+
 }
 }
 #endif // EQSERVER_COMPOUNDACTIVATEVISITOR_H
@@ -31,10 +31,83 @@
 #include <eq/fabric/iAttribute.h>
 #include <eq/fabric/tile.h>
 
+#include <algorithm>
+
 namespace eq
 {
 namespace server
 {
+namespace
+{
+/** Collects the active input queues of the given name. */
+class InputQueueFinder : public CompoundVisitor
+{
+public:
+    explicit InputQueueFinder( const std::string& name ) : _name( name ) {}
+
+    virtual VisitorResult visit( Compound* compound )
+    {
+        if( !compound->isActive( ))
+            return TRAVERSE_PRUNE;
+
+        const TileQueues& queues = compound->getInputTileQueues();
+        for( TileQueuesCIter i = queues.begin(); i != queues.end(); ++i )
+            if( (*i)->getName() == _name )
+                inputQueues.push_back( *i );
+        return TRAVERSE_CONTINUE;
+    }
+
+    TileQueues inputQueues;
+
+private:
+    const std::string& _name;
+};
+
+/** Finds an active compound assembling an input frame of the given name. */
+class InputFrameFinder : public CompoundVisitor
+{
+public:
+    explicit InputFrameFinder( const std::string& name )
+        : _name( name ), _found( false ) {}
+
+    virtual VisitorResult visit( const Compound* compound )
+    {
+        if( !compound->isActive( ))
+            return TRAVERSE_PRUNE;
+        if( !compound->testInheritTask( fabric::TASK_ASSEMBLE ))
+            return TRAVERSE_CONTINUE;
+
+        const Frames& frames = compound->getInputFrames();
+        for( FramesCIter i = frames.begin(); i != frames.end(); ++i )
+        {
+            if( (*i)->getName() == _name )
+            {
+                _found = true;
+                return TRAVERSE_TERMINATE;
+            }
+        }
+        return TRAVERSE_CONTINUE;
+    }
+
+    bool isFound() const { return _found; }
+
+private:
+    const std::string& _name;
+    bool _found;
+};
+
+struct TileCost
+{
+    Vector2i tile;
+    float cost;
+    size_t lane;
+
+    /** Order by lane, and by descending cost within a lane. */
+    bool operator < ( const TileCost& rhs ) const
+        { return lane < rhs.lane || ( lane == rhs.lane && cost > rhs.cost ); }
+};
+}
+
 CompoundUpdateOutputVisitor::CompoundUpdateOutputVisitor(
     const uint32_t frameNumber )
         : _frameNumber( frameNumber )
@@ -69,7 +142,15 @@ void CompoundUpdateOutputVisitor::_updateQueues( Compound* compound )
             continue;
         }
 
-        queue->cycleData( _frameNumber, compound );
+        // one lane per input queue, each channel starts on its own block
+        InputQueueFinder finder( name );
+        compound->accept( finder );
+        const TileQueues& inputQueues = finder.inputQueues;
+        for( size_t j = 0; j < inputQueues.size(); ++j )
+            inputQueues[j]->setLane( j );
+
+        queue->cycleData( _frameNumber, compound,
+                          LB_MAX( inputQueues.size(), size_t( 1 )));
 
         //----- Generate tile task commands
         _generateTiles( queue, compound );
@@ -115,6 +196,18 @@ void CompoundUpdateOutputVisitor::_updateFrames( Compound* compound )
             continue;
         }
 
+        // skip readback and transmission if no destination uses the frame,
+        // e.g., a monitor updated at a lower rate
+        InputFrameFinder finder( name );
+        compound->getRoot()->accept( finder );
+        if( !finder.isFound( ))
+        {
+            LBLOG( LOG_ASSEMBLY ) << "Skipping output frame " << name
+                                  << ", no active input frame" << std::endl;
+            frame->unsetData();
+            continue;
+        }
+
         //----- Create new frame datas
         // * one frame data used for each eye pass
         // * data is set only on master frame data (will copy to all others)
@@ -194,12 +287,76 @@ void CompoundUpdateOutputVisitor::_generateTiles( TileQueue* queue,
     tiles.reserve( dim.x() * dim.y() );
 
     tiles::generateZigzag( tiles, dim );
-    _addTilesToQueue( queue, compound, tiles );
+
+    std::vector< size_t > lanes;
+    _assignLanes( queue, tiles, lanes );
+    _addTilesToQueue( queue, compound, tiles, lanes );
+}
+
+void CompoundUpdateOutputVisitor::_assignLanes( const TileQueue* queue,
+                                                std::vector< Vector2i >& tiles,
+                                                std::vector< size_t >& lanes )
+{
+    // Split the tiles into contiguous blocks, one per lane, to keep
+    // neighboring tiles on the same channel.
+    const size_t nTiles = tiles.size();
+    const size_t nLanes = queue->getNumLanes();
+    lanes.resize( nTiles );
+
+    if( !queue->hasTileCosts( ))
+    {
+        for( size_t i = 0; i < nTiles; ++i )
+            lanes[i] = i * nLanes / nTiles;
+        return;
+    }
+
+    // Use blocks of equal measured cost instead of equal size. Tiles without
+    // measurement use the average cost.
+    std::vector< TileCost > costs( nTiles );
+    float knownCost = 0.f;
+    size_t nKnown = 0;
+    for( size_t i = 0; i < nTiles; ++i )
+    {
+        costs[i].tile = tiles[i];
+        costs[i].cost = queue->getTileCost( tiles[i] );
+        if( costs[i].cost > 0.f )
+        {
+            knownCost += costs[i].cost;
+            ++nKnown;
+        }
+    }
+
+    const float average = nKnown > 0 ? knownCost / float( nKnown ) : 1.f;
+    float totalCost = 0.f;
+    for( size_t i = 0; i < nTiles; ++i )
+    {
+        if( costs[i].cost <= 0.f )
+            costs[i].cost = average;
+        totalCost += costs[i].cost;
+    }
+
+    float cost = 0.f;
+    for( size_t i = 0; i < nTiles; ++i )
+    {
+        const float center = cost + .5f * costs[i].cost;
+        costs[i].lane = LB_MIN( size_t( center * nLanes / totalCost ),
+                                nLanes - 1 );
+        cost += costs[i].cost;
+    }
+
+    // hand out the most expensive tiles of each block first
+    std::stable_sort( costs.begin(), costs.end( ));
+    for( size_t i = 0; i < nTiles; ++i )
+    {
+        tiles[i] = costs[i].tile;
+        lanes[i] = costs[i].lane;
+    }
 }
 
 void CompoundUpdateOutputVisitor::_addTilesToQueue( TileQueue* queue,
                                                     Compound* compound,
-                                         const std::vector< Vector2i >& tiles )
+                                         const std::vector< Vector2i >& tiles,
+                                         const std::vector< size_t >& lanes )
 {
 
     const Vector2i& tileSize = queue->getTileSize();
@@ -207,10 +364,10 @@ void CompoundUpdateOutputVisitor::_addTilesToQueue( TileQueue* queue,
     const double xFraction = 1.0 / pvp.w;
     const double yFraction = 1.0 / pvp.h;
 
-    for( std::vector< Vector2i >::const_iterator i = tiles.begin();
-         i != tiles.end(); ++i )
+    for( size_t i = 0; i < tiles.size(); ++i )
     {
-        const Vector2i& tile = *i;
+        const Vector2i& tile = tiles[i];
+        const size_t lane = lanes[i];
         PixelViewport tilePVP( tile.x() * tileSize.x(), tile.y() * tileSize.y(),
                                tileSize.x(), tileSize.y( ));
 
@@ -237,7 +394,7 @@ void CompoundUpdateOutputVisitor::_addTilesToQueue( TileQueue* queue,
                                           false );
             compound->computeTileFrustum( tileItem.ortho, eye, tileItem.vp,
                                           true );
-            queue->addTile( tileItem, eye );
+            queue->addTile( tileItem, eye, lane );
         }
     }
 }
@@ -261,7 +418,8 @@ void CompoundUpdateOutputVisitor::_updateZoom( const Compound* compound,
         zoom_1.y() = 1.0f / zoom.y();
     }
 
-    if( frame->getType( ) == Frame::TYPE_TEXTURE )
+    if( frame->getType( ) == Frame::TYPE_TEXTURE ||
+        frame->getType( ) == Frame::TYPE_DRAWABLE )
     {
         FrameData* frameData = frame->getMasterData();
         frameData->setZoom( zoom_1 ); // textures are zoomed by input frame
@@ -309,10 +467,22 @@ void CompoundUpdateOutputVisitor::_updateSwapBarriers( Compound* compound )
                 window->joinNVSwapBarrier( swapBarrier, _swapBarriers[name] );
         }
     }
+    else if( swapBarrier->isHardware() && window->getMaxNVSwapBarriers( ))
+    {
+        // The hardware barrier synchronizes all frame-locked windows, the
+        // first of them also enters the network barrier with the others.
+        window->joinHardwareSwapBarrier();
+
+        const std::string& name = swapBarrier->getName();
+        if( _hardwareBarriers.insert( name ).second )
+            _swapBarriers[name] = window->joinSwapBarrier( _swapBarriers[name],
+                                                     swapBarrier->isTimed( ));
+    }
     else
     {
         const std::string& name = swapBarrier->getName();
-        _swapBarriers[name] = window->joinSwapBarrier( _swapBarriers[name] );
+        _swapBarriers[name] = window->joinSwapBarrier( _swapBarriers[name],
+                                                     swapBarrier->isTimed( ));
     }
 }
 
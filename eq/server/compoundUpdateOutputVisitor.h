@@ -22,6 +22,8 @@
 #include "compoundVisitor.h" // base class
 #include "compound.h"        // nested type
 
+#include <set>
+
 namespace eq
 {
 namespace server
@@ -50,6 +52,7 @@ namespace server
         const uint32_t _frameNumber;
  
         Compound::BarrierMap   _swapBarriers;
+        std::set< std::string > _hardwareBarriers; //!< with a hardware window
         Compound::FrameMap     _outputFrames;
         Compound::TileQueueMap _outputTileQueues;
 
@@ -59,8 +62,12 @@ namespace server
         void _updateZoom( const Compound* compound, Frame* frame );
 
         void _generateTiles( TileQueue* queue, Compound* compound );
-        void _addTilesToQueue( TileQueue* queue, Compound* compound, 
-                               const std::vector< Vector2i >& tiles );
+        void _assignLanes( const TileQueue* queue,
+                           std::vector< Vector2i >& tiles,
+                           std::vector< size_t >& lanes );
+        void _addTilesToQueue( TileQueue* queue, Compound* compound,
+                               const std::vector< Vector2i >& tiles,
+                               const std::vector< size_t >& lanes );
     };
 }
 }
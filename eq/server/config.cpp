@@ -26,18 +26,24 @@
 #include "configUpdateDataVisitor.h"
 #include "equalizers/equalizer.h"
 #include "global.h"
+#include "gpuScheduler.h"
 #include "layout.h"
+#include "loadTrace.h"
 #include "log.h"
 #include "node.h"
 #include "observer.h"
+#include "pipe.h"
 #include "segment.h"
 #include "server.h"
+#include "swapScheduler.h"
+#include "tracer.h"
 #include "view.h"
 #include "window.h"
 
 #include <eq/fabric/commands.h>
 #include <eq/fabric/event.h>
 #include <eq/fabric/iAttribute.h>
+#include <eq/fabric/metricsExporter.h>
 #include <eq/fabric/paths.h>
 
 #include <co/objectICommand.h>
@@ -45,7 +51,12 @@
 #include <lunchbox/sleep.h>
 #include <boost/foreach.hpp>
 
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
 #include "channelStopFrameVisitor.h"
+#include "configChangeVisitor.h"
 #include "configDeregistrator.h"
 #include "configRegistrator.h"
 #include "configUpdateVisitor.h"
@@ -57,9 +68,46 @@ namespace eq
 namespace server
 {
 typedef co::CommandFunc<Config> ConfigFunc;
+using fabric::AUTO;
 using fabric::ON;
 using fabric::OFF;
 
+namespace
+{
+/** Below this number of nodes tasks are generated serially. */
+static const int _minParallelNodes = 4;
+
+/** The maximum number of nodes connected or launched concurrently. */
+static const int _maxParallelLaunches = 32;
+
+/** The number of trace events recorded for IATTR_TRACE_EVENTS ON or AUTO. */
+static const size_t _defaultTraceEvents = 65536;
+
+/** @return the nodes ordered by their last draw time, longest first. */
+Nodes _sortByDrawTime( const Nodes& nodes )
+{
+    typedef std::pair< int64_t, size_t > DrawTime;
+    std::vector< DrawTime > drawTimes;
+    drawTimes.reserve( nodes.size( ));
+    for( size_t i = 0; i < nodes.size(); ++i )
+        drawTimes.push_back( DrawTime( -nodes[i]->getDrawTime(), i ));
+    std::sort( drawTimes.begin(), drawTimes.end( )); // index keeps ties stable
+
+    Nodes sorted;
+    sorted.reserve( nodes.size( ));
+    BOOST_FOREACH( const DrawTime& drawTime, drawTimes )
+        sorted.push_back( nodes[ drawTime.second ] );
+    return sorted;
+}
+
+/** @return the file written by the trace on config exit. */
+std::string _getTraceFilename()
+{
+    const char* env = getenv( "EQ_TRACE_FILE" );
+    return env ? env : "eqTrace.json";
+}
+}
+
 Config::Config( ServerPtr parent )
         : Super( parent )
         , _currentFrame( 0 )
@@ -67,7 +115,15 @@ Config::Config( ServerPtr parent )
         , _finishedFrame( 0 )
         , _state( STATE_UNUSED )
         , _needsFinish( false )
+        , _changed( true )
+        , _staticFrame( false )
         , _lastCheck( 0 )
+        , _tracer( 0 )
+        , _loadTrace( 0 )
+        , _swapScheduler( new SwapScheduler )
+        , _frameStartTime( 0 )
+        , _swapDeadline( 0 )
+        , _frameRateLimit( std::numeric_limits< float >::max( ))
         , _private( 0 )
 {
     const Global* global = Global::instance();
@@ -91,6 +147,9 @@ Config::~Config()
         removeCompound( compound );
         delete compound;
     }
+    delete _tracer;
+    delete _loadTrace;
+    delete _swapScheduler;
 }
 
 void Config::attach( const uint128_t& id, const uint32_t instanceID )
@@ -116,6 +175,10 @@ void Config::attach( const uint128_t& id, const uint32_t instanceID )
                      ConfigFunc( this, &Config::_cmdFinishAllFrames ), mainQ );
     registerCommand( fabric::CMD_CONFIG_CHECK_FRAME,
                      ConfigFunc( this, &Config::_cmdCheckFrame ), mainQ );
+    registerCommand( fabric::CMD_CONFIG_DUMP_TRACE,
+                     ConfigFunc( this, &Config::_cmdDumpTrace ), mainQ );
+    registerCommand( fabric::CMD_CONFIG_GET_METRICS,
+                     ConfigFunc( this, &Config::_cmdGetMetrics ), mainQ );
 }
 
 namespace
@@ -173,6 +236,68 @@ public:
         return TRAVERSE_CONTINUE;
     }
 };
+
+std::string _getResourceName( const Channel* channel )
+{
+    if( !channel->getName().empty( ))
+        return channel->getName();
+
+    std::ostringstream os;
+    os << channel->getPath();
+    return os.str();
+}
+
+/** Exports the current parameters and splits of all equalizers. */
+class EqualizerMetricsVisitor : public CompoundVisitor
+{
+public:
+    explicit EqualizerMetricsVisitor( fabric::MetricsExporter& metrics )
+        : _metrics( metrics ) {}
+
+    VisitorResult visit( const Compound* compound ) override
+    {
+        const Equalizers& equalizers = compound->getEqualizers();
+        const Channel* channel = compound->getChannel();
+        if( equalizers.empty() || !channel )
+            return TRAVERSE_CONTINUE;
+
+        const std::string& name = _getResourceName( channel );
+        BOOST_FOREACH( const Equalizer* equalizer, equalizers )
+        {
+            _metrics.setGauge( "equalizer_active", name,
+                               equalizer->isActive() && !equalizer->isFrozen()
+                               ? 1. : 0. );
+            _metrics.setGauge( "equalizer_damping", name,
+                               equalizer->getDamping( ));
+            if( equalizer->getType() == fabric::DFR_EQUALIZER )
+            {
+                _metrics.setGauge( "equalizer_target_fps", name,
+                                   equalizer->getFrameRate( ));
+                _metrics.setGauge( "equalizer_zoom", name,
+                                   compound->getZoom().x( ));
+            }
+        }
+
+        // the share of each child, set by the load and tree equalizers
+        const Compounds& children = compound->getChildren();
+        BOOST_FOREACH( const Compound* child, children )
+        {
+            const Channel* childChannel = child->getChannel();
+            if( !childChannel || childChannel == channel )
+                continue;
+
+            const Range& range = child->getRange();
+            _metrics.setGauge( "equalizer_split",
+                               _getResourceName( childChannel ),
+                               child->getViewport().getArea() *
+                               ( range.end - range.start ));
+        }
+        return TRAVERSE_CONTINUE;
+    }
+
+private:
+    fabric::MetricsExporter& _metrics;
+};
 }
 
 const Channel* Config::findChannel( const std::string& name ) const
@@ -553,13 +678,18 @@ bool Config::_updateRunning( const bool canFail )
 
     LBASSERT( _state == STATE_RUNNING || _state == STATE_INITIALIZING ||
               _state == STATE_EXITING );
+    _changed = true;
 
     if( !_connectNodes() && !canFail )
         return false;
 
+    lunchbox::Clock clock;
     _startNodes();
+    const int64_t startTime = clock.getTime64();
     _updateCanvases();
     const bool result = _updateNodes( canFail );
+    LBLOG( LOG_INIT ) << "Node start " << startTime << " ms, update "
+                      << clock.getTime64() - startTime << " ms" << std::endl;
     _stopNodes();
 
     // Don't use visitor, it would get confused with modified child vectors
@@ -582,27 +712,34 @@ bool Config::_updateRunning( const bool canFail )
 
 bool Config::_connectNodes()
 {
-    bool success = true;
     lunchbox::Clock clock;
-    const Nodes& nodes = getNodes();
-    for( Nodes::const_iterator i = nodes.begin(); i != nodes.end(); ++i )
-    {
-        Node* node = *i;
-        if( !node->isActive( ))
-            continue;
-
-        if( !node->connect( ))
-            success = false;
-    }
-
-    for( Nodes::const_iterator i = nodes.begin(); i != nodes.end(); ++i )
-    {
-        Node* node = *i;
-        if( node->isActive() && !node->syncLaunch( clock ))
-            success = false;
-    }
-
-    return success;
+    Nodes nodes;
+    BOOST_FOREACH( Node* node, getNodes( ))
+        if( node->isActive( ))
+            nodes.push_back( node );
+
+    // Connects and launches block on remote hosts, do them concurrently
+    const int nNodes = int( nodes.size( ));
+    int failures = 0;
+#pragma omp parallel for num_threads( _maxParallelLaunches ) \
+    schedule( dynamic, 1 ) reduction( +: failures ) \
+    if( nNodes >= _minParallelNodes )
+    for( int i = 0; i < nNodes; ++i )
+        if( !nodes[ i ]->connect( ))
+            ++failures;
+
+    const int64_t connectTime = clock.getTime64();
+    BOOST_FOREACH( Node* node, nodes )
+        if( !node->syncLaunch( clock ))
+            ++failures;
+
+    if( nNodes > 0 )
+        LBLOG( LOG_INIT ) << "Connected " << nNodes - failures << "/" << nNodes
+                          << " nodes: connect/launch " << connectTime
+                          << " ms, wait for launch "
+                          << clock.getTime64() - connectTime << " ms"
+                          << std::endl;
+    return failures == 0;
 }
 
 void Config::_startNodes()
@@ -784,6 +921,29 @@ bool Config::_init( const uint128_t& initID )
     _currentFrame  = 0;
     _finishedFrame = 0;
     _initID = initID;
+    _swapScheduler->reset();
+    _swapDeadline = 0;
+
+    delete _tracer;
+    _tracer = 0;
+    const int32_t traceEvents = getIAttribute( IATTR_TRACE_EVENTS );
+    if( traceEvents == ON || traceEvents == fabric::AUTO )
+        _tracer = new Tracer( _defaultTraceEvents );
+    else if( traceEvents > 0 )
+        _tracer = new Tracer( traceEvents );
+
+    delete _loadTrace;
+    _loadTrace = 0;
+    const char* loadTraceFile = getenv( "EQ_LOAD_TRACE_FILE" );
+    if( loadTraceFile )
+    {
+        _loadTrace = new LoadTrace;
+        if( !_loadTrace->open( loadTraceFile ))
+        {
+            delete _loadTrace;
+            _loadTrace = 0;
+        }
+    }
 
     for( CompoundsCIter i = _compounds.begin(); i != _compounds.end(); ++i )
         (*i)->init();
@@ -839,6 +999,10 @@ bool Config::exit()
     }
 
     const bool success = _updateRunning( true );
+    if( _tracer )
+        dumpTrace( _getTraceFilename( ));
+    delete _loadTrace;
+    _loadTrace = 0;
 
     // TODO: is this needed? sender of CMD_CONFIG_EXIT is the appNode itself
     // which sets the running state to false anyway. Besides, this event is
@@ -847,6 +1011,8 @@ bool Config::exit()
     // eile: May be needed for reliability?
     send( findApplicationNetNode(), fabric::CMD_CONFIG_EVENT ) << Event::EXIT;
 
+    getServer()->getGPUScheduler().remove( this );
+    _frameRateLimit = std::numeric_limits< float >::max();
     _needsFinish = false;
     _state = STATE_STOPPED;
     return success;
@@ -866,22 +1032,73 @@ void Config::_startFrame( const uint128_t& frameID )
     LBLOG( LOG_TASKS ) << "----- Start Frame ----- " << _currentFrame
                        << std::endl;
 
+    // Nothing changed since the last rendered frame: no tasks are generated,
+    // the windows don't swap and keep showing the last image.
+    _staticFrame = getIAttribute( IATTR_STATIC_FRAMES ) == ON && !_changed &&
+                   !_needsFinish && frameID == _lastFrameID;
+    _changed = false;
+    _lastFrameID = frameID;
+    if( _staticFrame )
+        LBLOG( LOG_TASKS ) << "Static frame " << _currentFrame << std::endl;
+
+    _frameStartTime = getServer()->getTime();
+    _swapDeadline = _swapScheduler->startFrame( _finishedFrame.get(),
+                                                _frameStartTime );
+    if( _tracer )
+        _tracer->addFrame( _currentFrame, _frameStartTime );
+    _updateFrameRateLimit();
+
+    fabric::MetricsExporter* metrics = getServer()->getMetrics();
+    if( metrics )
+    {
+        Statistic statistic = Statistic();
+        statistic.type = Statistic::CONFIG_START_FRAME;
+        statistic.frameNumber = _currentFrame;
+        statistic.startTime = _frameStartTime;
+        statistic.endTime = statistic.startTime;
+        snprintf( statistic.resourceName, 32, "%s", getName().c_str( ));
+        statistic.resourceName[31] = 0;
+        metrics->add( statistic );
+        metrics->setGauge( "pending_frames",
+                           double( _currentFrame - _finishedFrame.get( )));
+    }
+
     for( Compounds::const_iterator i = _compounds.begin();
-         i != _compounds.end(); ++i )
+         i != _compounds.end() && !_staticFrame; ++i )
     {
         Compound* compound = *i;
         compound->update( _currentFrame );
     }
+    if( metrics )
+    {
+        EqualizerMetricsVisitor visitor( *metrics );
+        for( Compounds::const_iterator i = _compounds.begin();
+             i != _compounds.end(); ++i )
+        {
+            (*i)->accept( visitor );
+        }
+    }
+    if( _loadTrace )
+        _loadTrace->addFrame( _currentFrame, _compounds );
 
     ConfigUpdateDataVisitor configDataVisitor;
     accept( configDataVisitor );
 
-    const Nodes& nodes = getNodes();
+    // Task generation for one node only writes state owned by that node and
+    // its children, and sends to the node's own buffered connection. Shared
+    // compounds, frames and barriers are only read, so nodes can be updated
+    // concurrently. Each node's tasks are sent as soon as they are generated,
+    // the nodes with the longest draw time in the last frame go first.
+    const Nodes& nodes = _sortByDrawTime( getNodes( ));
+    const int nNodes = int( nodes.size( ));
+#pragma omp parallel for schedule( dynamic ) if( nNodes >= _minParallelNodes )
+    for( int i = 0; i < nNodes; ++i )
+        nodes[ i ]->update( frameID, _currentFrame );
+
     co::NodePtr appNode = findApplicationNetNode();
     for( Nodes::const_iterator i = nodes.begin(); i != nodes.end(); ++i )
     {
-        Node* node = *i;
-        node->update( frameID, _currentFrame );
+        const Node* node = *i;
         if( node->isRunning() && node->isApplicationNode( ))
             appNode = 0; // release sent (see below)
     }
@@ -894,6 +1111,51 @@ void Config::_startFrame( const uint128_t& frameID )
     notifyNodeFrameFinished( _currentFrame );
 }
 
+void Config::_updateFrameRateLimit()
+{
+    // the draw time of the last finished frame on each used GPU
+    GPUScheduler::DrawTimes drawTimes;
+    const Nodes& nodes = getNodes();
+    for( Nodes::const_iterator i = nodes.begin(); i != nodes.end(); ++i )
+    {
+        const Node* node = *i;
+        if( !node->isRunning( ))
+            continue;
+
+        const Pipes& pipes = node->getPipes();
+        for( Pipes::const_iterator j = pipes.begin(); j != pipes.end(); ++j )
+        {
+            const Pipe* pipe = *j;
+            if( !pipe->isRunning( ))
+                continue;
+
+            std::ostringstream gpu;
+            gpu << node->getHost() << ':' << pipe->getPort() << '.'
+                << pipe->getDevice();
+            drawTimes[ gpu.str() ] += pipe->getDrawTime();
+        }
+    }
+
+    const int32_t priority = getIAttribute( IATTR_GPU_PRIORITY );
+    const int32_t weight = getIAttribute( IATTR_GPU_WEIGHT );
+    GPUScheduler& scheduler = getServer()->getGPUScheduler();
+    _frameRateLimit = scheduler.startFrame( this, drawTimes,
+                                            priority == AUTO ? 0 : priority,
+                                            weight == AUTO ? 1.f :
+                                                             float( weight ),
+                                            _frameStartTime );
+
+    fabric::MetricsExporter* metrics = getServer()->getMetrics();
+    if( !metrics )
+        return;
+
+    metrics->setGauge( "gpu_time", getName(),
+                       double( scheduler.getGPUTime( this )));
+    if( _frameRateLimit < std::numeric_limits< float >::max( ))
+        metrics->setGauge( "frame_rate_limit", getName(),
+                           double( _frameRateLimit ));
+}
+
 void Config::_verifyFrameFinished( const uint32_t frameNumber )
 {
     const Nodes& nodes = getNodes();
@@ -905,10 +1167,27 @@ void Config::_verifyFrameFinished( const uint32_t frameNumber )
         {
             NodeFailedVisitor nodeFailedVisitor;
             node->accept( nodeFailedVisitor );
+            _activateStandby( node );
         }
     }
 }
 
+void Config::_activateStandby( const Node* failed )
+{
+    const Nodes& nodes = getNodes();
+    for( Nodes::const_iterator i = nodes.begin(); i != nodes.end(); ++i )
+    {
+        Node* node = *i;
+        if( !node->isRunning() || !node->isStandby( ))
+            continue;
+
+        LBWARN << "Replacing failed node " << failed->getName()
+               << " with standby node " << node->getName() << std::endl;
+        node->setIAttribute( Node::IATTR_HINT_STANDBY, fabric::OFF );
+        return;
+    }
+}
+
 void Config::notifyNodeFrameFinished( const uint32_t frameNumber )
 {
     if( _finishedFrame >= frameNumber ) // node finish already done
@@ -937,6 +1216,44 @@ void Config::notifyNodeFrameFinished( const uint32_t frameNumber )
                        << frameNumber << std::endl;
 }
 
+void Config::addStatistics( const Channel& channel,
+                            const uint32_t frameNumber,
+                            const Statistics& statistics,
+                            const Viewport& region )
+{
+    if( _tracer )
+        _tracer->addStatistics( channel, statistics );
+    if( _loadTrace )
+        _loadTrace->add( channel, frameNumber, statistics, region );
+
+    fabric::MetricsExporter* metrics = getServer()->getMetrics();
+    if( !metrics )
+        return;
+
+    for( Statistics::const_iterator i = statistics.begin();
+         i != statistics.end(); ++i )
+    {
+        metrics->add( *i );
+    }
+}
+
+void Config::addSwapArrival( const uint32_t frameNumber, const int64_t offset,
+                             const bool late )
+{
+    _swapScheduler->addArrival( frameNumber, offset, late );
+}
+
+bool Config::dumpTrace( const std::string& filename ) const
+{
+    if( !_tracer )
+    {
+        LBWARN << "Statistics trace not enabled, set "
+               << getIAttributeString( IATTR_TRACE_EVENTS ) << std::endl;
+        return false;
+    }
+    return _tracer->write( filename );
+}
+
 void Config::_flushAllFrames()
 {
     if( _currentFrame == 0 )
@@ -1025,6 +1342,10 @@ bool Config::_cmdUpdate( co::ICommand& cmd )
     const uint32_t finishID = command.read< uint32_t >();
 
     sync();
+    ConfigChangeVisitor changes;
+    accept( changes );
+    if( changes.isChanged( ))
+        _changed = true;
     commit();
 
     co::NodePtr node = command.getRemoteNode();
@@ -1166,6 +1487,26 @@ bool Config::_cmdCheckFrame( co::ICommand& cmd )
     return true;
 }
 
+bool Config::_cmdDumpTrace( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    const std::string& filename = command.read< std::string >();
+    dumpTrace( filename.empty() ? _getTraceFilename() : filename );
+    return true;
+}
+
+bool Config::_cmdGetMetrics( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    const uint32_t requestID = command.read< uint32_t >();
+
+    // collected from the first request on if the endpoint is not running
+    const fabric::MetricsExporter* metrics = getServer()->collectMetrics();
+    send( command.getRemoteNode(), fabric::CMD_CONFIG_GET_METRICS_REPLY )
+        << requestID << metrics->getText();
+    return true;
+}
+
 void Config::output( std::ostream& os ) const
 {
     os << std::endl << lunchbox::disableFlush << lunchbox::disableHeader;
@@ -183,6 +183,53 @@ public:
     /** @internal @return the last finished frame */
     uint32_t getFinishedFrame() const { return _finishedFrame.get(); }
 
+    /** @internal @return the server time of the current frame start. */
+    int64_t getFrameStartTime() const { return _frameStartTime; }
+
+    /**
+     * @internal
+     * @return the predicted swap time of timed swap barriers for the current
+     *         frame, or 0 if the windows have to use the network barrier.
+     */
+    int64_t getSwapDeadline() const { return _swapDeadline; }
+
+    /**
+     * @internal
+     * @return true if nothing changed since the last rendered frame, and the
+     *         current frame is not rendered, see IATTR_STATIC_FRAMES.
+     */
+    bool isStaticFrame() const { return _staticFrame; }
+
+    /**
+     * @internal
+     * @return the maximum frame rate of the current frame on the GPUs shared
+     *         with other configs, see GPUScheduler.
+     */
+    float getFrameRateLimit() const { return _frameRateLimit; }
+
+    /** @internal Record a window ready to swap on a timed swap barrier. */
+    void addSwapArrival( uint32_t frameNumber, int64_t offset, bool late );
+
+    /**
+     * @internal
+     * Record the statistics of a channel in the traces and metrics.
+     *
+     * @param channel the channel which sent the statistics.
+     * @param frameNumber the frame of the statistics.
+     * @param statistics the statistics.
+     * @param region the region of interest of the channel's last task.
+     */
+    void addStatistics( const Channel& channel, uint32_t frameNumber,
+                        const Statistics& statistics, const Viewport& region );
+
+    /**
+     * Write the statistics trace recorded while IATTR_TRACE_EVENTS is set.
+     *
+     * @param filename the name of the Chrome trace file to write.
+     * @return true if the trace was written, false otherwise.
+     */
+    EQSERVER_API bool dumpTrace( const std::string& filename ) const;
+
     /** @internal */
     virtual VisitorResult _acceptCompounds( ConfigVisitor& visitor );
     /** @internal */
@@ -230,8 +277,24 @@ private:
 
     bool _needsFinish; //!< true after runtime changes
 
+    bool _changed; //!< entities changed since the last frame start
+    bool _staticFrame; //!< the current frame is not rendered
+    uint128_t _lastFrameID; //!< the frame identifier of the last frame
+
     int64_t _lastCheck;
 
+    /** The statistics trace, or 0 if tracing is disabled. */
+    Tracer* _tracer;
+
+    /** The load data trace, or 0 if EQ_LOAD_TRACE_FILE is not set. */
+    LoadTrace* _loadTrace;
+
+    /** Predicts the deadline of timed swap barriers. */
+    SwapScheduler* const _swapScheduler;
+    int64_t _frameStartTime; //!< server time of the current frame start
+    int64_t _swapDeadline; //!< swap time of the current frame, or 0
+    float _frameRateLimit; //!< frame rate share on shared GPUs
+
     struct Private;
     Private* _private; // placeholder for binary-compatible changes
 
@@ -243,6 +306,7 @@ private:
     bool _updateRunning( const bool canFail );
 
     void _updateCanvases();
+    void _updateFrameRateLimit();
     bool _connectNodes();
     bool _connectNode( Node* node );
     bool _syncConnectNode( Node* node, const lunchbox::Clock& clock );
@@ -254,6 +318,9 @@ private:
     void _deleteEntities( const std::vector< T* >& entities );
     void _syncClock();
     void _verifyFrameFinished( const uint32_t frameNumber );
+
+    /** Let a running standby node render in place of a failed node. */
+    void _activateStandby( const Node* failed );
     bool _init( const uint128_t& initID );
 
     void _startFrame( const uint128_t& frameID );
@@ -280,6 +347,8 @@ private:
     bool _cmdCreateReply( co::ICommand& command );
     bool _cmdFreezeLoadBalancing( co::ICommand& command );
     bool _cmdCheckFrame( co::ICommand& command );
+    bool _cmdDumpTrace( co::ICommand& command );
+    bool _cmdGetMetrics( co::ICommand& command );
 
     LB_TS_VAR( _cmdThread );
     LB_TS_VAR( _mainThread );
@@ -142,6 +142,9 @@ void Display::discoverLocal( Config* config, const uint32_t flags )
     if( scalability )
     {
         names.push_back( EQ_SERVER_CONFIG_LAYOUT_DB_DS );
+        names.push_back( EQ_SERVER_CONFIG_LAYOUT_DB_BS );
+        names.push_back( EQ_SERVER_CONFIG_LAYOUT_DB_RK );
+        names.push_back( EQ_SERVER_CONFIG_LAYOUT_DB_23 );
         names.push_back( EQ_SERVER_CONFIG_LAYOUT_DB_STATIC );
         names.push_back( EQ_SERVER_CONFIG_LAYOUT_DB_DYNAMIC );
         names.push_back( EQ_SERVER_CONFIG_LAYOUT_2D_STATIC );
@@ -55,6 +55,15 @@
 #  include <hwsd/net/dns_sd/module.h>
 #endif
 
+#include <lunchbox/clock.h>
+#include <lunchbox/lock.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/thread.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+
 #ifdef _MSC_VER
 #  include <eq/client/os.h>
 #  define setenv( name, value, overwrite ) \
@@ -200,23 +209,253 @@ void _disposeHwsdModules()
 #endif
 }
 
-} // unnamed namespace
+/** Discovered resources are reused for this long before rediscovery. */
+static const int64_t _discoveryTTL = 300000; // ms
 
-static lunchbox::a_int32_t _frameCounter;
+struct Discovery
+{
+    hwsd::GPUInfos gpuInfos;
+    hwsd::NetInfos netInfos;
+    int64_t time; //!< of the discovery on _discoveryClock
+};
+typedef std::map< std::string, Discovery > Discoveries;
 
-bool Resources::discover( ServerPtr server, Config* config,
-                          const std::string& session,
-                          const fabric::ConfigParams& params )
+lunchbox::Lock _discoveryLock; //!< serializes hwsd queries
+lunchbox::Lock _discoveriesLock;
+Discoveries _discoveries; //!< by session and discovery parameters
+lunchbox::Clock _discoveryClock;
+
+std::string _getDiscoveryKey( const std::string& session,
+                              const fabric::ConfigParams& params )
 {
+    std::ostringstream key;
+    key << session << '\n' << params.getGPUFilter() << '\n'
+        << _configureNetworkTypes( params );
+    const Strings& prefixes = params.getPrefixes();
+    for( StringsCIter i = prefixes.begin(); i != prefixes.end(); ++i )
+        key << '\n' << *i;
+    return key.str();
+}
+
+Discovery _discover( const std::string& session,
+                     const fabric::ConfigParams& params )
+{
+    lunchbox::ScopedWrite mutex( _discoveryLock );
     _configureHwsdModules();
 
     hwsd::FilterPtr filter = hwsd::FilterPtr( new hwsd::DuplicateFilter ) |
                              new hwsd::SessionFilter( session );
 
-    hwsd::GPUInfos gpuInfos = _discoverGPUs( params, filter );
-    const hwsd::NetInfos& netInfos = _discoverNetworks( params, filter );
+    Discovery discovery;
+    discovery.gpuInfos = _discoverGPUs( params, filter );
+    discovery.netInfos = _discoverNetworks( params, filter );
+    discovery.time = _discoveryClock.getTime64();
 
     _disposeHwsdModules();
+    return discovery;
+}
+
+/** @return true if the resources used for configuration are the same. */
+bool _isSameTopology( const Discovery& a, const Discovery& b )
+{
+    if( a.gpuInfos.size() != b.gpuInfos.size() ||
+        a.netInfos.size() != b.netInfos.size( ))
+    {
+        return false;
+    }
+
+    for( size_t i = 0; i < a.gpuInfos.size(); ++i )
+    {
+        const hwsd::GPUInfo& x = a.gpuInfos[ i ];
+        const hwsd::GPUInfo& y = b.gpuInfos[ i ];
+        if( x.id != y.id || x.nodeName != y.nodeName || x.port != y.port ||
+            x.device != y.device || x.flags != y.flags )
+        {
+            return false;
+        }
+    }
+    for( size_t i = 0; i < a.netInfos.size(); ++i )
+    {
+        const hwsd::NetInfo& x = a.netInfos[ i ];
+        const hwsd::NetInfo& y = b.netInfos[ i ];
+        if( x.id != y.id || x.type != y.type || x.up != y.up ||
+            x.inetAddress != y.inetAddress || x.linkspeed != y.linkspeed )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Rediscovers the resources of a cached session in the background. */
+class Revalidator : public lunchbox::Thread
+{
+public:
+    bool start( const std::string& session, const fabric::ConfigParams& params,
+                const std::string& key )
+    {
+        if( isRunning( ))
+            return false;
+        join(); // previous, finished run
+        _session = session;
+        _params = params;
+        _key = key;
+        return Thread::start();
+    }
+
+protected:
+    void run() final
+    {
+        const Discovery& discovery = _discover( _session, _params );
+
+        lunchbox::ScopedWrite mutex( _discoveriesLock );
+        Discovery& cached = _discoveries[ _key ];
+        if( !_isSameTopology( cached, discovery ))
+            LBINFO << "Resources of session " << _session << " changed, "
+                   << "using them from the next configuration" << std::endl;
+        cached = discovery;
+    }
+
+private:
+    std::string _session;
+    fabric::ConfigParams _params;
+    std::string _key;
+};
+Revalidator _revalidator;
+
+/** Radix used by the radix-k compositing schedule. */
+static const size_t _radixK = 4;
+
+typedef std::vector< size_t > Factors;
+
+Factors _primeFactors( size_t n )
+{
+    Factors factors;
+    for( size_t p = 2; p * p <= n; ++p )
+    {
+        while( n % p == 0 )
+        {
+            factors.push_back( p );
+            n /= p;
+        }
+    }
+    if( n > 1 )
+        factors.push_back( n );
+    return factors;
+}
+
+/**
+ * Compute the group size of each round of a swap compositing schedule.
+ *
+ * Participants beyond the returned number of swapping participants are folded
+ * into a partner before the first round.
+ *
+ * @return the number of participants taking part in the swap rounds
+ */
+size_t _getSwapFactors( const std::string& schedule, const size_t n,
+                        Factors& factors )
+{
+    factors.clear();
+    if( schedule == EQ_SERVER_CONFIG_LAYOUT_DB_BS )
+    {
+        size_t m = 1;
+        for( ; m * 2 <= n; m *= 2 )
+            factors.push_back( 2 );
+        return m;
+    }
+
+    if( schedule == EQ_SERVER_CONFIG_LAYOUT_DB_23 )
+    {
+        // largest 2^a * 3^b <= n, using as many 3-groups as possible
+        size_t best = 1;
+        size_t bestThrees = 0;
+        size_t three = 1;
+        for( size_t b = 0; three <= n; ++b, three *= 3 )
+        {
+            size_t m = three;
+            while( m * 2 <= n )
+                m *= 2;
+            if( m > best || ( m == best && b > bestThrees ))
+            {
+                best = m;
+                bestThrees = b;
+            }
+        }
+        for( size_t m = best; m > 1; )
+        {
+            const size_t factor = ( m % 3 == 0 ) ? 3 : 2;
+            factors.push_back( factor );
+            m /= factor;
+        }
+        return best;
+    }
+
+    LBASSERT( schedule == EQ_SERVER_CONFIG_LAYOUT_DB_RK );
+    // greedily combine the prime factors of n into groups of at most k
+    Factors primes = _primeFactors( n );
+    std::sort( primes.begin(), primes.end(), std::greater< size_t >( ));
+    for( Factors::const_iterator i = primes.begin(); i != primes.end(); ++i )
+    {
+        bool merged = false;
+        for( Factors::iterator j = factors.begin(); j != factors.end(); ++j )
+        {
+            if( *j * *i <= _radixK )
+            {
+                *j *= *i;
+                merged = true;
+                break;
+            }
+        }
+        if( !merged )
+            factors.push_back( *i );
+    }
+    return n;
+}
+
+Viewport _getStripe( const float start, const float end )
+{
+    return Viewport( 0.f, start, 1.f, end - start );
+}
+
+} // unnamed namespace
+
+static lunchbox::a_int32_t _frameCounter;
+
+bool Resources::discover( ServerPtr server, Config* config,
+                          const std::string& session,
+                          const fabric::ConfigParams& params )
+{
+    // Start from a recent discovery, it takes seconds for remote resources
+    const std::string& key = _getDiscoveryKey( session, params );
+    Discovery discovery;
+    bool cached = false;
+    {
+        lunchbox::ScopedWrite mutex( _discoveriesLock );
+        Discoveries::const_iterator i = _discoveries.find( key );
+        if( i != _discoveries.end() &&
+            _discoveryClock.getTime64() - i->second.time < _discoveryTTL )
+        {
+            discovery = i->second;
+            cached = true;
+        }
+    }
+
+    if( cached )
+    {
+        LBINFO << "Using resources discovered " << _discoveryClock.getTime64()-
+                  discovery.time << " ms ago for session " << session
+               << std::endl;
+        _revalidator.start( session, params, key );
+    }
+    else
+    {
+        discovery = _discover( session, params );
+        lunchbox::ScopedWrite mutex( _discoveriesLock );
+        _discoveries[ key ] = discovery;
+    }
+
+    hwsd::GPUInfos& gpuInfos = discovery.gpuInfos;
+    const hwsd::NetInfos& netInfos = discovery.netInfos;
 
     if( gpuInfos.empty( ))
     {
@@ -511,6 +750,47 @@ static Channels _filter( const Channels& input, const std::string& filter )
     return result;
 }
 
+/**
+ * @return the channels grouped by node, in the order of each node's first
+ *         channel. Neighboring sources then share a node, so that the first
+ *         compositing steps and load balancing splits stay within a node.
+ */
+static Channels _groupByNode( const Channels& input )
+{
+    Channels result;
+    result.reserve( input.size( ));
+
+    for( ChannelsCIter i = input.begin(); i != input.end(); ++i )
+    {
+        const Node* node = (*i)->getNode();
+        if( std::find( result.begin(), result.end(), *i ) != result.end( ))
+            continue;
+        for( ChannelsCIter j = i; j != input.end(); ++j )
+            if( (*j)->getNode() == node )
+                result.push_back( *j );
+    }
+    return result;
+}
+
+static bool _isMultiNode( const Channels& channels )
+{
+    for( ChannelsCIter i = channels.begin(); i != channels.end(); ++i )
+        if( (*i)->getNode() != channels.front()->getNode( ))
+            return true;
+    return false;
+}
+
+/** Split load between nodes first, and adapt cross-node splits slower. */
+static void _setNodeTopology( LoadEqualizer* lb, const Channels& channels )
+{
+    if( !_isMultiNode( channels ))
+        return;
+
+    lb->setNodeAligned( true );
+    if( lb->getNodeDamping() == lb->getDamping( ))
+        lb->setNodeDamping( .5f * ( 1.f + lb->getDamping( )));
+}
+
 Compound* Resources::_addMonoCompound( Compound* root, const Channels& channels,
                                        const fabric::ConfigParams& params )
 {
@@ -523,10 +803,10 @@ Compound* Resources::_addMonoCompound( Compound* root, const Channels& channels,
                     params.getFlags() & fabric::ConfigParams::FLAG_MULTIPROCESS;
     const bool multiProcessDB = multiProcess ||
              ( params.getFlags() & fabric::ConfigParams::FLAG_MULTIPROCESS_DB );
-    const Channels& activeChannels = _filter( channels,
-                                              multiProcess ? " mp " : " mt " );
-    const Channels& activeDBChannels = _filter( channels,
-                                                multiProcessDB ? " mp ":" mt ");
+    const Channels& activeChannels = _groupByNode( _filter( channels,
+                                           multiProcess ? " mp " : " mt " ));
+    const Channels& activeDBChannels = _groupByNode( _filter( channels,
+                                           multiProcessDB ? " mp " : " mt " ));
 
     if( name == EQ_SERVER_CONFIG_LAYOUT_SIMPLE )
         /* nop */;
@@ -542,6 +822,12 @@ Compound* Resources::_addMonoCompound( Compound* root, const Channels& channels,
     }
     else if( name == EQ_SERVER_CONFIG_LAYOUT_DB_DS )
         compound = _addDSCompound( root, activeDBChannels );
+    else if( name == EQ_SERVER_CONFIG_LAYOUT_DB_BS ||
+             name == EQ_SERVER_CONFIG_LAYOUT_DB_RK ||
+             name == EQ_SERVER_CONFIG_LAYOUT_DB_23 )
+    {
+        compound = _addSwapCompound( root, activeDBChannels );
+    }
     else if( name == EQ_SERVER_CONFIG_LAYOUT_DB_2D )
     {
         LBASSERT( !multiProcess );
@@ -630,6 +916,7 @@ Compound* Resources::_add2DCompound( Compound* root, const Channels& channels,
     LoadEqualizer* lb = new LoadEqualizer( params.getEqualizer( ));
     if( name == EQ_SERVER_CONFIG_LAYOUT_2D_STATIC )
         lb->setDamping( 1.f );
+    _setNodeTopology( lb, channels );
     compound->addEqualizer( lb );
 
     _fill2DCompound( compound, channels );
@@ -670,10 +957,15 @@ Compound* Resources::_addDBCompound( Compound* root, const Channels& channels,
     {
         if( params.getEqualizer().getMode() != LoadEqualizer::MODE_DB )
             params.getEqualizer().setMode( LoadEqualizer::MODE_DB );
-        compound->addEqualizer( new LoadEqualizer( params.getEqualizer( )));
+        LoadEqualizer* lb = new LoadEqualizer( params.getEqualizer( ));
+        _setNodeTopology( lb, channels );
+        compound->addEqualizer( lb );
     }
 
-    const Compounds& children = _addSources( compound, channels );
+    // composite the images of each node before sending them to the
+    // destination, cuts the network traffic by the number of GPUs per node
+    const Compounds& children = _addSources( compound, channels, false,
+                                             _isMultiNode( channels ));
     const size_t step = size_t( 100000.0f / float( children.size( )));
     size_t start = 0;
     for( CompoundsCIter i = children.begin(); i != children.end(); ++i )
@@ -782,6 +1074,157 @@ Compound* Resources::_addDSCompound( Compound* root, const Channels& channels )
     return compound;
 }
 
+Compound* Resources::_addSwapCompound( Compound* root,
+                                       const Channels& channels )
+{
+    const Channel* channel = root->getChannel();
+    const Layout* layout = channel->getLayout();
+    const std::string& name = layout->getName();
+
+    Factors factors;
+    const size_t nChannels = channels.size();
+    const size_t nSwap = _getSwapFactors( name, nChannels, factors );
+    if( nSwap < 2 )
+        return _addDSCompound( root, channels );
+
+    Compound* compound = new Compound( root );
+    compound->setName( name );
+    compound->setBuffers( Frame::BUFFER_COLOR | Frame::BUFFER_DEPTH );
+
+    const Segment* segment = channel->getSegment();
+    const Channel* outputChannel = segment ? segment->getChannel() : 0;
+    const size_t nRounds = factors.size();
+
+    // Per participant: stage r reads back the parts sent in round r, stage
+    // r+1 assembles the parts received in round r. The last stage is the
+    // channel compound itself, which sends the final tile.
+    std::vector< Compounds > stages( nChannels );
+    std::vector< float > start( nSwap, 0.f );
+    std::vector< float > end( nSwap, 1.f );
+
+    for( size_t i = 0; i < nChannels; ++i )
+    {
+        Channel* source = channels[i];
+        Compound* child = new Compound( compound );
+        if( source != outputChannel )
+            child->setChannel( source );
+
+        Compound* drawChild = new Compound( child );
+        drawChild->setRange( Range( float( i ) / float( nChannels ),
+                                    i + 1 == nChannels ?
+                                    1.f : float( i + 1 ) / float( nChannels )));
+
+        // a folded participant's image is assembled before the first round
+        const bool hasFoldInput = i + nSwap < nChannels;
+        if( i >= nSwap || !hasFoldInput )
+            stages[i].push_back( drawChild );
+
+        if( i >= nSwap ) // folded: sends everything to its partner
+            continue;
+
+        for( size_t j = hasFoldInput ? 0 : 1; j < nRounds; ++j )
+        {
+            Compound* exchange = new Compound( child );
+            exchange->setTasks( fabric::TASK_ASSEMBLE | fabric::TASK_READBACK );
+            stages[i].push_back( exchange );
+        }
+        stages[i].push_back( child );
+    }
+
+    std::ostringstream prefix;
+    prefix << "Frame." << name << '.' << ++_frameCounter;
+
+    // fold participants which do not fit the schedule into their partner
+    for( size_t i = nSwap; i < nChannels; ++i )
+    {
+        const size_t partner = i - nSwap;
+        std::ostringstream frameName;
+        frameName << prefix.str() << ".fold" << i;
+
+        Frame* output = new Frame;
+        output->setName( frameName.str( ));
+        output->setBuffers( Frame::BUFFER_COLOR | Frame::BUFFER_DEPTH );
+        stages[i].front()->addOutputFrame( output );
+
+        Frame* input = new Frame;
+        input->setName( frameName.str( ));
+        stages[partner].front()->addInputFrame( input );
+    }
+
+    // swap rounds: in each round a participant exchanges disjoint parts of its
+    // current region with the other members of its group
+    size_t stride = 1;
+    for( size_t round = 0; round < nRounds; ++round )
+    {
+        const size_t groupSize = factors[ round ];
+        std::vector< float > newStart( nSwap );
+        std::vector< float > newEnd( nSwap );
+
+        for( size_t i = 0; i < nSwap; ++i )
+        {
+            const size_t digit = ( i / stride ) % groupSize;
+            const size_t first = i - digit * stride;
+            const float size = end[i] - start[i];
+
+            for( size_t k = 0; k < groupSize; ++k )
+            {
+                const float partStart = start[i] + size * float( k ) /
+                                                   float( groupSize );
+                const float partEnd = k + 1 == groupSize ? end[i] :
+                       start[i] + size * float( k + 1 ) / float( groupSize );
+                if( k == digit )
+                {
+                    newStart[i] = partStart;
+                    newEnd[i] = partEnd;
+                    continue;
+                }
+
+                const size_t partner = first + k * stride;
+                std::ostringstream frameName;
+                frameName << prefix.str() << ".r" << round << '.' << i << '.'
+                          << partner;
+
+                Frame* output = new Frame;
+                output->setName( frameName.str( ));
+                output->setViewport( _getStripe( partStart, partEnd ));
+                output->setBuffers( Frame::BUFFER_COLOR | Frame::BUFFER_DEPTH );
+                stages[i][ round ]->addOutputFrame( output );
+
+                Frame* input = new Frame;
+                input->setName( frameName.str( ));
+                stages[partner][ round + 1 ]->addInputFrame( input );
+            }
+        }
+        start.swap( newStart );
+        end.swap( newEnd );
+        stride *= groupSize;
+    }
+
+    // final, fully composited color tiles to the destination
+    const Compounds& children = compound->getChildren();
+    for( size_t i = 0; i < nSwap; ++i )
+    {
+        Compound* child = children[i];
+        if( channels[i] == outputChannel )
+            continue; // in place
+
+        std::ostringstream frameName;
+        frameName << prefix.str() << ".tile" << i;
+
+        Frame* output = new Frame;
+        output->setName( frameName.str( ));
+        output->setViewport( _getStripe( start[i], end[i] ));
+        output->setBuffers( Frame::BUFFER_COLOR );
+        child->addOutputFrame( output );
+
+        Frame* input = new Frame;
+        input->setName( frameName.str( ));
+        compound->addInputFrame( input );
+    }
+
+    return compound;
+}
+
 static Channels _filterLocalChannels( const Channels& input,
                                       const Compound& filter )
 {
@@ -835,13 +1278,25 @@ Compound* Resources::_addSubpixelCompound( Compound* root,
     return compound;
 }
 
+/**
+ * Add one source compound per channel, each sending an output frame to the
+ * given compound.
+ *
+ * With node compositing, the sources of a node other than the destination's
+ * node send their frames to the first source of their node instead, which
+ * assembles them after drawing. Only the node's composited frame is then
+ * transmitted over the network.
+ */
 const Compounds& Resources::_addSources( Compound* compound,
                                          const Channels& channels,
-                                         const bool destChannelFrame )
+                                         const bool destChannelFrame,
+                                         const bool nodeCompositing )
 {
     const Channel* rootChannel = compound->getChannel();
     const Segment* segment = rootChannel->getSegment();
     const Channel* outputChannel = segment ? segment->getChannel() : 0;
+    const Node* outputNode = outputChannel ? outputChannel->getNode() : 0;
+    std::map< const Node*, Compound* > nodeSources;
 
     for( ChannelsCIter i = channels.begin(); i != channels.end(); ++i )
     {
@@ -854,6 +1309,16 @@ const Compounds& Resources::_addSources( Compound* compound,
         if( !isDestChannel )
             child->setChannel( channel );
 
+        Compound* receiver = compound;
+        if( nodeCompositing && channel->getNode() != outputNode )
+        {
+            Compound*& nodeSource = nodeSources[ channel->getNode() ];
+            if( nodeSource )
+                receiver = nodeSource;
+            else
+                nodeSource = child;
+        }
+
         Frame* outFrame = new Frame;
         std::stringstream frameName;
         frameName << "Frame." << compound->getName() << '.' << ++_frameCounter;
@@ -864,7 +1329,7 @@ const Compounds& Resources::_addSources( Compound* compound,
 
         Frame* inFrame = new Frame;
         inFrame->setName( frameName.str( ));
-        compound->addInputFrame( inFrame );
+        receiver->addInputFrame( inFrame );
     }
 
     return compound->getChildren();
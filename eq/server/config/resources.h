@@ -27,6 +27,9 @@
 #define EQ_SERVER_CONFIG_LAYOUT_DB_STATIC   "StaticDB"
 #define EQ_SERVER_CONFIG_LAYOUT_DB_DYNAMIC  "DynamicDB"
 #define EQ_SERVER_CONFIG_LAYOUT_DB_DS       "DBDirectSend"
+#define EQ_SERVER_CONFIG_LAYOUT_DB_BS       "DBBinarySwap"
+#define EQ_SERVER_CONFIG_LAYOUT_DB_RK       "DBRadixK"
+#define EQ_SERVER_CONFIG_LAYOUT_DB_23       "DB23Swap"
 #define EQ_SERVER_CONFIG_LAYOUT_DB_2D       "DB_2D"
 #define EQ_SERVER_CONFIG_LAYOUT_SUBPIXEL    "Subpixel"
 
@@ -58,11 +61,14 @@ private:
     static Compound* _addDBCompound( Compound* root, const Channels& channels,
                                      fabric::ConfigParams params );
     static Compound* _addDSCompound( Compound* root, const Channels& channels );
+    static Compound* _addSwapCompound( Compound* root,
+                                       const Channels& channels );
     static Compound* _addDB2DCompound( Compound* root, const Channels& channels,
                                        fabric::ConfigParams params );
     static Compound* _addSubpixelCompound( Compound* root, const Channels& );
     static const Compounds& _addSources( Compound* compound, const Channels&,
-                                         const bool destChannelFrame = false );
+                                         const bool destChannelFrame = false,
+                                         const bool nodeCompositing = false );
     static void _fill2DCompound( Compound* compound, const Channels& channels );
 };
 
@@ -0,0 +1,82 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQSERVER_CONFIGCHANGEVISITOR_H
+#define EQSERVER_CONFIGCHANGEVISITOR_H
+
+#include "configVisitor.h" // base class
+
+#include "canvas.h"
+#include "channel.h"
+#include "layout.h"
+#include "node.h"
+#include "observer.h"
+#include "pipe.h"
+#include "segment.h"
+#include "view.h"
+#include "window.h"
+
+namespace eq
+{
+namespace server
+{
+namespace
+{
+/** Detects entities with changes not yet committed by the server. */
+class ConfigChangeVisitor : public ConfigVisitor
+{
+public:
+    ConfigChangeVisitor() : _changed( false ) {}
+    virtual ~ConfigChangeVisitor() {}
+
+    /** @return true if any entity has uncommitted changes. */
+    bool isChanged() const { return _changed; }
+
+    VisitorResult visit( Observer* observer ) override
+        { return _check( observer ); }
+    VisitorResult visitPre( Layout* layout ) override
+        { return _check( layout ); }
+    VisitorResult visit( View* view ) override { return _check( view ); }
+    VisitorResult visitPre( Canvas* canvas ) override
+        { return _check( canvas ); }
+    VisitorResult visit( Segment* segment ) override
+        { return _check( segment ); }
+    VisitorResult visitPre( Node* node ) override { return _check( node ); }
+    VisitorResult visitPre( Pipe* pipe ) override { return _check( pipe ); }
+    VisitorResult visitPre( Window* window ) override
+        { return _check( window ); }
+    VisitorResult visit( Channel* channel ) override
+        { return _check( channel ); }
+
+    // Compounds are not distributed
+    VisitorResult visitPre( Compound* ) override { return TRAVERSE_PRUNE; }
+
+private:
+    bool _changed;
+
+    VisitorResult _check( const fabric::Object* object )
+    {
+        if( !object->isDirty( ))
+            return TRAVERSE_CONTINUE;
+        _changed = true;
+        return TRAVERSE_TERMINATE;
+    }
+};
+}
+}
+}
+#endif // EQSERVER_CONFIGCHANGEVISITOR_H
@@ -65,6 +65,12 @@ private:
     const uint128_t _initID;
     const uint32_t  _frameNumber;
 
+    /** @return true if the entity needs to be initialized. */
+    template< class T > static bool _isUsed( const T* entity )
+        { return entity->isActive(); }
+    static bool _isUsed( const Channel* channel )
+        { return channel->isActive() || channel->isWarm(); }
+
     template< class T > VisitorResult _updateDown( T* entity ) const
         {
             const uint32_t state = entity->getState() & ~STATE_DELETE;
@@ -72,7 +78,7 @@ private:
             switch( state )
             {
                 case STATE_STOPPED:
-                    if( entity->isActive( ))
+                    if( _isUsed( entity ))
                     {
                         entity->configInit( _initID, _frameNumber );
                         return TRAVERSE_CONTINUE;
@@ -101,7 +107,7 @@ private:
                     return TRAVERSE_CONTINUE;
 
                 case STATE_RUNNING:
-                    if( !entity->isActive( ))
+                    if( !_isUsed( entity ))
                         entity->configExit();
                     return TRAVERSE_CONTINUE;
 
@@ -26,13 +26,29 @@
 #include <eq/fabric/zoom.h>
 #include <lunchbox/debug.h>
 
+#include <algorithm>
+
 namespace eq
 {
 namespace server
 {
+namespace
+{
+const float INTEGRAL_GAIN = .1f;   // relative to the proportional gain
+const float DERIVATIVE_GAIN = .3f; // relative to the proportional gain
+}
 
 DFREqualizer::DFREqualizer()
-        : _current ( getFrameRate( ))
+        : _minZoom( 0.f )
+        , _maxZoom( 0.f )
+        , _zoomRate( 0.f )
+        , _loadBalanced( false )
+        , _frameTime( 0.f )
+        , _drawTime( 0.f )
+        , _frameZoom( 1.f )
+        , _error( 0.f )
+        , _integral( 0.f )
+        , _measured( false )
         , _lastTime( 0 )
 {
     LBINFO << "New DFREqualizer @" << (void*)this << std::endl;
@@ -54,6 +70,9 @@ void DFREqualizer::attach( Compound* compound )
 
         // Unsubscribe to channel load notification
         channel->removeListener( this );
+        for( ChannelsCIter i = _channels.begin(); i != _channels.end(); ++i )
+            (*i)->removeListener( this );
+        _channels.clear();
     }
 
     Equalizer::attach( compound );
@@ -65,11 +84,35 @@ void DFREqualizer::attach( Compound* compound )
 
         // Subscribe to channel load notification
         if( compound->getParent() && channel )
+        {
             channel->addListener( this );
+            if( _loadBalanced )
+                _addSources( compound );
+        }
     }
 }
 
-void DFREqualizer::notifyUpdatePre( Compound* compound, const uint32_t/*frame*/)
+void DFREqualizer::_addSources( const Compound* compound )
+{
+    const Compounds& children = compound->getChildren();
+    for( CompoundsCIter i = children.begin(); i != children.end(); ++i )
+    {
+        const Compound* child = *i;
+        Channel* channel = child->getChannel();
+
+        if( channel && channel != getCompound()->getChannel() &&
+            std::find( _channels.begin(), _channels.end(), channel ) ==
+                _channels.end( ))
+        {
+            channel->addListener( this );
+            _channels.push_back( channel );
+        }
+        _addSources( child );
+    }
+}
+
+void DFREqualizer::notifyUpdatePre( Compound* compound,
+                                    const uint32_t frameNumber )
 {
     LBASSERT( compound == getCompound( ));
 
@@ -82,13 +125,42 @@ void DFREqualizer::notifyUpdatePre( Compound* compound, const uint32_t/*frame*/)
     LBASSERT( getDamping() >= 0.f );
     LBASSERT( getDamping() <= 1.f );
 
-    const float factor = ( sqrtf( _current / getFrameRate( )) - 1.f ) *
-                         getDamping() + 1.f;
-
     Zoom newZoom( compound->getZoom( ));
-    newZoom *= factor;
+    if( _frameTime > 0.f )
+    {
+        // Predict the frame time at the current zoom, since the zoom might
+        // have changed after the last finished frame. Only the draw time
+        // scales with the number of pixels.
+        const float target = 1000.f / getFrameRate();
+        const float scale = newZoom.x() / _frameZoom;
+        const float drawTime = _drawTime * scale * scale;
+        const float predicted = LB_MAX( _frameTime - _drawTime + drawTime,
+                                        1.f );
+        const float error = sqrtf( target / predicted ) - 1.f;
+
+        float derivative = 0.f;
+        if( _measured )
+        {
+            _integral = LB_MAX( LB_MIN( _integral + error, 1.f ), -1.f );
+            derivative = error - _error;
+            _error = error;
+            _measured = false;
+        }
+
+        float factor = 1.f + getDamping() * ( error +
+                                              INTEGRAL_GAIN * _integral +
+                                              DERIVATIVE_GAIN * derivative );
+        if( _zoomRate > 0.f )
+        {
+            factor = LB_MAX( factor, 1.f - _zoomRate );
+            factor = LB_MIN( factor, 1.f + _zoomRate );
+        }
+        newZoom *= LB_MAX( factor, .1f );
 
-    //LBINFO << _current << ": " << factor << " = " << newZoom << std::endl;
+        LBLOG( LOG_LB1 ) << "Predicted " << predicted << "ms, target "
+                         << target << "ms: " << factor << " = " << newZoom
+                         << std::endl;
+    }
 
     // clip zoom factor to min( 128px ), max( channel pvp )
     const Compound*      parent = compound->getParent();
@@ -97,18 +169,23 @@ void DFREqualizer::notifyUpdatePre( Compound* compound, const uint32_t/*frame*/)
     const Channel*       channel    = compound->getChannel();
     const PixelViewport& channelPVP = channel->getPixelViewport();
 
-    const float minZoom = 128.f / LB_MIN( static_cast< float >( pvp.h ),
-                                          static_cast< float >( pvp.w ));
-    const float maxZoom = LB_MIN( static_cast< float >( channelPVP.w ) /
-                                  static_cast< float >( pvp.w ),
-                                  static_cast< float >( channelPVP.h ) /
-                                  static_cast< float >( pvp.h ));
+    float minZoom = 128.f / LB_MIN( static_cast< float >( pvp.h ),
+                                    static_cast< float >( pvp.w ));
+    float maxZoom = LB_MIN( static_cast< float >( channelPVP.w ) /
+                            static_cast< float >( pvp.w ),
+                            static_cast< float >( channelPVP.h ) /
+                            static_cast< float >( pvp.h ));
+    if( _minZoom > 0.f )
+        minZoom = LB_MAX( minZoom, _minZoom );
+    if( _maxZoom > 0.f )
+        maxZoom = LB_MIN( maxZoom, _maxZoom );
 
     newZoom.x() = LB_MAX( newZoom.x(), minZoom );
     newZoom.x() = LB_MIN( newZoom.x(), maxZoom );
     newZoom.y() = newZoom.x();
 
     compound->setZoom( newZoom );
+    _zooms.push_back( FrameZoom( frameNumber, newZoom.x( )));
 }
 
 void DFREqualizer::notifyLoadData( Channel* channel, const uint32_t frameNumber,
@@ -117,13 +194,16 @@ void DFREqualizer::notifyLoadData( Channel* channel, const uint32_t frameNumber,
 {
     // gather and notify load data
     int64_t endTime = 0;
+    int64_t drawTime = 0;
     for( size_t i = 0; i < statistics.size(); ++i )
     {
         const Statistic& data = statistics[i];
         switch( data.type )
         {
-            case Statistic::CHANNEL_CLEAR:
             case Statistic::CHANNEL_DRAW:
+                drawTime += data.endTime - data.startTime;
+                // no break;
+            case Statistic::CHANNEL_CLEAR:
             case Statistic::CHANNEL_ASSEMBLE:
             case Statistic::CHANNEL_READBACK:
                 endTime = LB_MAX( endTime, data.endTime );
@@ -134,6 +214,12 @@ void DFREqualizer::notifyLoadData( Channel* channel, const uint32_t frameNumber,
         }
     }
 
+    if( _loadBalanced && drawTime > 0 )
+        _drawTimes[ frameNumber ].push_back( drawTime );
+
+    if( channel != getCompound()->getChannel( )) // source channel
+        return;
+
     if( endTime == 0 )
         return;
 
@@ -143,9 +229,43 @@ void DFREqualizer::notifyLoadData( Channel* channel, const uint32_t frameNumber,
     if( _lastTime <= 0 || time <= 0 )
         return;
 
-    _current = 1000.0f / static_cast< float >( time );
+    while( !_zooms.empty() && _zooms.front().first < frameNumber )
+        _zooms.pop_front();
+    if( !_zooms.empty() && _zooms.front().first == frameNumber )
+        _frameZoom = _zooms.front().second;
+
+    _frameTime = static_cast< float >( time );
+    _drawTime = static_cast< float >( drawTime );
+    _measured = true;
+
+    DrawTimes::iterator i = _drawTimes.find( frameNumber );
+    if( i != _drawTimes.end( ))
+    {
+        // The frame time above the mean draw time of all sources can be
+        // recovered by rebalancing. Do not reduce the zoom for it.
+        const std::vector< int64_t >& times = i->second;
+        int64_t maxTime = 0;
+        int64_t sumTime = 0;
+        for( size_t j = 0; j < times.size(); ++j )
+        {
+            maxTime = LB_MAX( maxTime, times[j] );
+            sumTime += times[j];
+        }
+        const float slack = static_cast< float >( maxTime ) -
+                            static_cast< float >( sumTime ) /
+                            static_cast< float >( times.size( ));
+        const float target = 1000.f / getFrameRate();
+
+        if( _frameTime > target )
+            _frameTime = LB_MAX( _frameTime - slack, target );
+        _drawTime = LB_MIN( static_cast< float >( maxTime ), _frameTime );
+    }
+    _drawTimes.erase( _drawTimes.begin(),
+                      _drawTimes.upper_bound( frameNumber ));
+
     LBLOG( LOG_LB1 ) << "Frame " << frameNumber << " channel "
-                     << channel->getName() << " time " << time << std::endl;
+                     << channel->getName() << " time " << time << " draw "
+                     << drawTime << std::endl;
 }
 
 std::ostream& operator << ( std::ostream& os, const DFREqualizer* lb )
@@ -161,6 +281,18 @@ std::ostream& operator << ( std::ostream& os, const DFREqualizer* lb )
     if( lb->getDamping() != 0.5f )
         os << "    damping " << lb->getDamping() << std::endl;
 
+    if( lb->getMinZoom() > 0.f )
+        os << "    min_zoom " << lb->getMinZoom() << std::endl;
+
+    if( lb->getMaxZoom() > 0.f )
+        os << "    max_zoom " << lb->getMaxZoom() << std::endl;
+
+    if( lb->getZoomRate() > 0.f )
+        os << "    zoom_rate " << lb->getZoomRate() << std::endl;
+
+    if( lb->isLoadBalanced( ))
+        os << "    load_balanced ON" << std::endl;
+
     os << '}' << std::endl << lunchbox::enableFlush;
     return os;
 }
@@ -23,6 +23,7 @@
 
 #include <deque>
 #include <map>
+#include <vector>
 
 namespace eq
 {
@@ -53,13 +54,66 @@ namespace server
 
         virtual uint32_t getType() const { return fabric::DFR_EQUALIZER; }
 
+        /** Set the minimum zoom, 0 for automatic. @version 1.8 */
+        void setMinZoom( const float zoom ) { _minZoom = zoom; }
+
+        /** @return the minimum zoom, 0 for automatic. @version 1.8 */
+        float getMinZoom() const { return _minZoom; }
+
+        /** Set the maximum zoom, 0 for automatic. @version 1.8 */
+        void setMaxZoom( const float zoom ) { _maxZoom = zoom; }
+
+        /** @return the maximum zoom, 0 for automatic. @version 1.8 */
+        float getMaxZoom() const { return _maxZoom; }
+
+        /**
+         * Set the maximum relative zoom change per frame, 0 for unlimited.
+         * @version 1.8
+         */
+        void setZoomRate( const float rate ) { _zoomRate = rate; }
+
+        /** @return the maximum relative zoom change per frame. @version 1.8 */
+        float getZoomRate() const { return _zoomRate; }
+
+        /**
+         * Combine with a load equalizer on the attached compound's subtree.
+         *
+         * When enabled, the frame time which can be recovered by rebalancing
+         * the source channels is not used to reduce the zoom. Has to be set
+         * before the equalizer is attached.
+         * @version 1.8
+         */
+        void setLoadBalanced( const bool onOff ) { _loadBalanced = onOff; }
+
+        /** @return true if combined with a load equalizer. @version 1.8 */
+        bool isLoadBalanced() const { return _loadBalanced; }
+
     protected:
         void notifyChildAdded( Compound*, Compound* ) override {}
         void notifyChildRemove( Compound*, Compound* ) override {}
 
     private:
-        float _current; //!< Framerate of the last finished frame
+        float _minZoom;    //!< Minimum zoom, 0 for automatic
+        float _maxZoom;    //!< Maximum zoom, 0 for automatic
+        float _zoomRate;   //!< Maximum zoom change per frame, 0 for unlimited
+        bool _loadBalanced; //!< Ignore the time recoverable by rebalancing
+
+        float _frameTime;  //!< Frame time of the last finished frame
+        float _drawTime;   //!< Draw time of the last finished frame
+        float _frameZoom;  //!< Zoom used for the last finished frame
+        float _error;      //!< Last control error
+        float _integral;   //!< Accumulated control error
+        bool _measured;    //!< A new frame finished since the last update
         int64_t _lastTime; //!< Last frames' timestamp
+
+        typedef std::pair< uint32_t, float > FrameZoom;
+        std::deque< FrameZoom > _zooms; //!< Zoom used for the pending frames
+
+        typedef std::map< uint32_t, std::vector< int64_t > > DrawTimes;
+        DrawTimes _drawTimes; //!< Source channel draw times per frame
+        Channels _channels;   //!< Source channels subscribed to
+
+        void _addSources( const Compound* compound );
     };
 
 }
@@ -0,0 +1,203 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "foveatedEqualizer.h"
+
+#include "../channel.h"
+#include "../compound.h"
+#include "../log.h"
+#include "../observer.h"
+#include "../segment.h"
+#include "../view.h"
+
+#include <eq/fabric/viewport.h>
+#include <eq/fabric/zoom.h>
+#include <lunchbox/debug.h>
+
+#include <cmath>
+#include <vector>
+
+namespace eq
+{
+namespace server
+{
+
+FoveatedEqualizer::FoveatedEqualizer()
+        : _foveaSize( .25f )
+        , _ringZoom( .5f )
+        , _rings( 0 )
+{
+    LBINFO << "New FoveatedEqualizer @" << (void*)this << std::endl;
+}
+
+FoveatedEqualizer::~FoveatedEqualizer()
+{
+    attach( 0 );
+    LBINFO << "Delete FoveatedEqualizer @" << (void*)this << std::endl;
+}
+
+void FoveatedEqualizer::attach( Compound* compound )
+{
+    Equalizer::attach( compound );
+    _updateRings();
+}
+
+void FoveatedEqualizer::notifyChildAdded( Compound*, Compound* )
+{
+    _updateRings();
+}
+
+void FoveatedEqualizer::notifyChildRemove( Compound*, Compound* )
+{
+    _updateRings();
+}
+
+void FoveatedEqualizer::_updateRings()
+{
+    _rings = 0;
+    const Compound* compound = getCompound();
+    if( !compound )
+        return;
+
+    const size_t nChildren = compound->getChildren().size();
+    const size_t size = size_t( std::sqrt( float( nChildren )) + .5f );
+    if( size * size == nChildren && size % 2 == 1 && size > 1 )
+    {
+        _rings = size / 2;
+        return;
+    }
+
+    LBWARN << "Foveated equalizer needs (2n+1)^2 children, got " << nChildren
+           << std::endl;
+}
+
+void FoveatedEqualizer::_reset( Compound* compound )
+{
+    const Compounds& children = compound->getChildren();
+    for( size_t i = 0; i < children.size(); ++i )
+    {
+        Compound* child = children[i];
+        child->setViewport( i == children.size() / 2 ? Viewport::FULL :
+                                                       Viewport( 0.f, 0.f,
+                                                                 0.f, 0.f ));
+        child->setZoom( Zoom::NONE );
+    }
+}
+
+Vector2f FoveatedEqualizer::_getGaze( const Compound* compound ) const
+{
+    const Channel* channel = compound->getInheritChannel();
+    const View* view = channel ? channel->getView() : 0;
+    const Observer* observer = view ? view->getObserver() : 0;
+    if( !observer )
+        return Vector2f( .5f, .5f );
+
+    // transform from view to destination channel coordinates
+    const Vector2f& gaze = observer->getGazePosition();
+    const Segment* segment = channel->getSegment();
+    const PixelViewport& pvp = channel->getPixelViewport();
+    if( !segment || !pvp.hasArea( ))
+        return gaze;
+
+    Viewport vp;
+    vp.applyView( segment->getViewport(), view->getViewport(), pvp,
+                  channel->getOverdraw( ));
+    if( !vp.hasArea( ))
+        return gaze;
+    return Vector2f(( gaze.x() - vp.x ) / vp.w, ( gaze.y() - vp.y ) / vp.h );
+}
+
+void FoveatedEqualizer::notifyUpdatePre( Compound* compound,
+                                         const uint32_t )
+{
+    LBASSERT( compound == getCompound( ));
+    if( _rings == 0 )
+        return;
+
+    if( isFrozen() || !compound->isActive() || !isActive( ))
+    {
+        _reset( compound );
+        return;
+    }
+
+    const Vector2f gaze = _getGaze( compound );
+    const PixelViewport& pvp = compound->getInheritPixelViewport();
+    const float aspect = pvp.hasArea() ? float( pvp.h ) / float( pvp.w ) : 1.f;
+
+    // grid lines around the gaze, each ring doubles the size
+    const size_t size = 2 * _rings + 1;
+    std::vector< float > xs( size + 1 );
+    std::vector< float > ys( size + 1 );
+    xs.front() = ys.front() = 0.f;
+    xs.back() = ys.back() = 1.f;
+
+    float extent = _foveaSize * .5f;
+    for( size_t i = 0; i < _rings; ++i, extent *= 2.f )
+    {
+        const float extentX = extent * aspect;
+        xs[ _rings - i ] = LB_MIN( LB_MAX( gaze.x() - extentX, 0.f ), 1.f );
+        xs[ _rings + i + 1 ] = LB_MIN( LB_MAX( gaze.x() + extentX, 0.f ), 1.f);
+        ys[ _rings - i ] = LB_MIN( LB_MAX( gaze.y() - extent, 0.f ), 1.f );
+        ys[ _rings + i + 1 ] = LB_MIN( LB_MAX( gaze.y() + extent, 0.f ), 1.f );
+    }
+
+    const Compounds& children = compound->getChildren();
+    LBASSERT( children.size() == size * size );
+    for( size_t row = 0; row < size; ++row )
+    {
+        for( size_t column = 0; column < size; ++column )
+        {
+            Compound* child = children[ row * size + column ];
+            const Viewport vp( xs[ column ], ys[ row ],
+                               xs[ column + 1 ] - xs[ column ],
+                               ys[ row + 1 ] - ys[ row ] );
+
+            const size_t ring = LB_MAX( column > _rings ? column - _rings :
+                                                          _rings - column,
+                                        row > _rings ? row - _rings :
+                                                       _rings - row );
+            const float zoom = std::pow( _ringZoom, float( ring ));
+
+            child->setViewport( vp );
+            child->setZoom( Zoom( zoom, zoom ));
+        }
+    }
+    LBLOG( LOG_LB2 ) << "Fovea at " << gaze << " in " << _rings << " rings"
+                     << std::endl;
+}
+
+std::ostream& operator << ( std::ostream& os, const FoveatedEqualizer* lb )
+{
+    if( !lb )
+        return os;
+
+    os << lunchbox::disableFlush
+       << "foveated_equalizer " << std::endl
+       << '{' << std::endl;
+
+    if( lb->getFoveaSize() != .25f )
+        os << "    fovea " << lb->getFoveaSize() << std::endl;
+
+    if( lb->getRingZoom() != .5f )
+        os << "    ring_zoom " << lb->getRingZoom() << std::endl;
+
+    os << '}' << std::endl << lunchbox::enableFlush;
+    return os;
+}
+
+}
+}
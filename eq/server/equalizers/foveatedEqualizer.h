@@ -0,0 +1,89 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQS_FOVEATEDEQUALIZER_H
+#define EQS_FOVEATEDEQUALIZER_H
+
+#include "equalizer.h"       // base class
+
+namespace eq
+{
+namespace server
+{
+    std::ostream& operator << ( std::ostream& os, const FoveatedEqualizer* );
+
+    /**
+     * Renders the region around the observer's gaze at full resolution and
+     * the surrounding rings at decreasing resolution.
+     *
+     * The attached compound has (2n+1)^2 children forming a grid of n rings
+     * around the fovea, listed row by row starting at the bottom left. Each
+     * frame, the grid lines are moved so that the center child covers the
+     * fovea around the gaze position of the view's observer. Each ring is twice
+     * the size of the next inner one, the outermost ring extends to the
+     * channel borders. The children of ring i are zoomed by ringZoom^i, their
+     * output frames are upscaled during assembly. The children do not overlap,
+     * and the rings can be assigned to different GPUs by the configuration.
+     */
+    class FoveatedEqualizer : public Equalizer
+    {
+    public:
+        FoveatedEqualizer();
+        virtual ~FoveatedEqualizer();
+        virtual void toStream( std::ostream& os ) const { os << this; }
+
+        /** @sa Equalizer::attach */
+        virtual void attach( Compound* compound );
+
+        /** @sa CompoundListener::notifyUpdatePre */
+        virtual void notifyUpdatePre( Compound* compound,
+                                      const uint32_t frameNumber );
+
+        virtual uint32_t getType() const { return fabric::FOVEATED_EQUALIZER; }
+
+        /**
+         * Set the size of the fovea relative to the channel height.
+         * @version 1.8
+         */
+        void setFoveaSize( const float size ) { _foveaSize = size; }
+
+        /** @return the size of the fovea. @version 1.8 */
+        float getFoveaSize() const { return _foveaSize; }
+
+        /** Set the zoom applied per ring, in (0,1]. @version 1.8 */
+        void setRingZoom( const float zoom ) { _ringZoom = zoom; }
+
+        /** @return the zoom applied per ring. @version 1.8 */
+        float getRingZoom() const { return _ringZoom; }
+
+    protected:
+        void notifyChildAdded( Compound*, Compound* ) override;
+        void notifyChildRemove( Compound*, Compound* ) override;
+
+    private:
+        float _foveaSize;
+        float _ringZoom;
+        size_t _rings; //!< number of rings, 0 if the children don't fit
+
+        void _updateRings();
+        Vector2f _getGaze( const Compound* compound ) const;
+        void _reset( Compound* compound );
+    };
+}
+}
+
+#endif // EQS_FOVEATEDEQUALIZER_H
@@ -79,6 +79,7 @@ private:
 
 FramerateEqualizer::FramerateEqualizer()
         : _nSamples( 0 )
+        , _pacing( false )
 {
     LBINFO << "New FramerateEqualizer @" << (void*)this << std::endl;
 }
@@ -86,6 +87,7 @@ FramerateEqualizer::FramerateEqualizer()
 FramerateEqualizer::FramerateEqualizer( const FramerateEqualizer& from )
         : Equalizer( from )
         , _nSamples( 0 )
+        , _pacing( from._pacing )
 {
 }
 
@@ -210,7 +212,7 @@ void FramerateEqualizer::notifyUpdatePre( Compound* compound,
 
     if( isFrozen() || !compound->isActive() || !isActive( ))
     {
-        compound->setMaxFPS( std::numeric_limits< float >::max( ));
+        _setMaxFPS( compound, std::numeric_limits< float >::max( ));
         return;
     }
 
@@ -226,10 +228,10 @@ void FramerateEqualizer::notifyUpdatePre( Compound* compound,
         const float fps = 1000.f / time;
 #ifdef VSYNC_CAP
         if( fps > VSYNC_CAP )
-            compound->setMaxFPS( std::numeric_limits< float >::max( ));
+            _setMaxFPS( compound, std::numeric_limits< float >::max( ));
         else
 #endif
-            compound->setMaxFPS( fps );
+            _setMaxFPS( compound, fps );
 
         LBLOG( LOG_LB2 ) << fps << " Hz from " << nSamples << "/"
                          << _times.size() << " samples, " << time << "ms"
@@ -241,6 +243,28 @@ void FramerateEqualizer::notifyUpdatePre( Compound* compound,
     LBASSERT( _times.size() < 10 );
 }
 
+void FramerateEqualizer::_setMaxFPS( Compound* compound, const float fps )
+{
+    compound->setMaxFPS( fps );
+    compound->setPacing( _pacing );
+    if( !_pacing )
+        return;
+
+    // pace each DPlex source to its share of the output frames
+    const Compounds& children = compound->getChildren();
+    for( size_t i = 0; i < children.size(); ++i )
+    {
+        Compound* child = children[i];
+        const uint32_t period = child->getInheritPeriod();
+        if( period <= 1 )
+            continue;
+
+        child->setMaxFPS( fps < std::numeric_limits< float >::max() ?
+                          fps / float( period ) : fps );
+        child->setPacing( true );
+    }
+}
+
 void FramerateEqualizer::LoadListener::notifyLoadData(
     Channel* channel, const uint32_t frameNumber, const Statistics& statistics,
     const Viewport& /*region*/  )
@@ -289,7 +313,12 @@ void FramerateEqualizer::LoadListener::notifyLoadData(
 
 std::ostream& operator << ( std::ostream& os, const FramerateEqualizer* lb )
 {
-    if( lb )
+    if( !lb )
+        return os;
+
+    if( lb->isPacing( ))
+        os << "framerate_equalizer { pacing ON }" << std::endl;
+    else
         os << "framerate_equalizer {}" << std::endl;
     return os;
 }
@@ -35,6 +35,11 @@ namespace server
      *
      * Does not support period settings underneath a child. One channel should
      * not be used in compounds with a different inherit period.
+     *
+     * With pacing enabled, the swaps are not only throttled but kept on an
+     * evenly spaced grid of the predicted frame time, and each DPlex child is
+     * paced to the frame rate divided by its period. Successive output frames
+     * are delivered at a steady rate instead of in bursts.
      */
     class FramerateEqualizer : public Equalizer
     {
@@ -53,6 +58,12 @@ namespace server
 
         virtual uint32_t getType() const { return fabric::FRAMERATE_EQUALIZER; }
 
+        /** Enable evenly spaced frame pacing. @version 1.8 */
+        void setPacing( const bool pacing ) { _pacing = pacing; }
+
+        /** @return true if frame pacing is enabled. @version 1.8 */
+        bool isPacing() const { return _pacing; }
+
     protected:
         void notifyChildAdded( Compound*, Compound* ) override
             { LBASSERT( _nSamples == 0 ); }
@@ -87,6 +98,11 @@ namespace server
         /** The number of samples to use from _times. */
         uint32_t _nSamples;
 
+        bool _pacing;
+
+        /** Set the frame rate of the compound and its DPlex children. */
+        void _setMaxFPS( Compound* compound, const float fps );
+
         void _init();
         void _exit();
     };
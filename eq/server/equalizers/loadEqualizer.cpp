@@ -29,6 +29,12 @@ namespace eq
 {
 namespace server
 {
+namespace
+{
+const size_t GRID_SIZE = 16;     // cells per dimension of the cost grid
+const float COST_WEIGHT = .5f;   // weight of a new measurement in the grid
+const float TREND_WEIGHT = .25f; // weight of a new cost change in the grid
+}
 
 std::ostream& operator << ( std::ostream& os, const LoadEqualizer::Node* );
 
@@ -38,6 +44,9 @@ std::ostream& operator << ( std::ostream& os, const LoadEqualizer::Node* );
 
 LoadEqualizer::LoadEqualizer()
         : _tree( 0 )
+        , _treeMode( MODE_2D )
+        , _treeNodeAligned( false )
+        , _costFrame( 0 )
 {
     LBVERB << "New LoadEqualizer @" << (void*)this << std::endl;
 }
@@ -45,6 +54,9 @@ LoadEqualizer::LoadEqualizer()
 LoadEqualizer::LoadEqualizer( const fabric::Equalizer& from )
         : Equalizer( from )
         , _tree( 0 )
+        , _treeMode( MODE_2D )
+        , _treeNodeAligned( false )
+        , _costFrame( 0 )
 {}
 
 LoadEqualizer::~LoadEqualizer()
@@ -63,6 +75,32 @@ void LoadEqualizer::notifyUpdatePre( Compound* compound,
     if( isFrozen() || !compound->isActive() || !isActive( ))
         return;
 
+    // mode changed at runtime, e.g., through the view's equalizer settings
+    if( _tree && ( getMode() != _treeMode ||
+                   isNodeAligned() != _treeNodeAligned ))
+    {
+        LBINFO << "Rebuilding load equalizer for mode " << getMode()
+               << std::endl;
+        const bool isDB = getMode() == MODE_DB;
+        if( isDB != ( _treeMode == MODE_DB ))
+        {
+            const Compounds& children = compound->getChildren();
+            for( CompoundsCIter i = children.begin(); i != children.end(); ++i)
+            {
+                // reset the decomposition of the previous mode
+                (*i)->setViewport( Viewport( ));
+                (*i)->setRange( Range( ));
+            }
+            if( isDB &&
+                compound->getBuffers() == fabric::Frame::BUFFER_UNDEFINED )
+            {
+                compound->setBuffers( fabric::Frame::BUFFER_COLOR |
+                                      fabric::Frame::BUFFER_DEPTH );
+            }
+        }
+        _reset();
+    }
+
     if( !_tree )
     {
         LBASSERT( compound == getCompound( ));
@@ -79,6 +117,8 @@ void LoadEqualizer::notifyUpdatePre( Compound* compound,
 
           default:
               _tree = _buildTree( children );
+              _treeMode = getMode();
+              _treeNodeAligned = isNodeAligned();
               break;
         }
     }
@@ -96,11 +136,31 @@ void LoadEqualizer::notifyUpdatePre( Compound* compound,
 
 LoadEqualizer::Node* LoadEqualizer::_buildTree( const Compounds& compounds )
 {
-    Node* node = new Node;
-
     const size_t size = compounds.size();
+    if( isNodeAligned() && size > 1 )
+    {
+        // group children by node, in the order of their first appearance
+        std::vector< Compounds > groups;
+        for( CompoundsCIter i = compounds.begin(); i != compounds.end(); ++i)
+        {
+            const server::Node* serverNode = (*i)->getChannel()->getNode();
+            std::vector< Compounds >::iterator j = groups.begin();
+            for( ; j != groups.end(); ++j )
+                if( j->front()->getChannel()->getNode() == serverNode )
+                    break;
+
+            if( j == groups.end( ))
+                groups.push_back( Compounds( 1, *i ));
+            else
+                j->push_back( *i );
+        }
+        if( groups.size() > 1 )
+            return _buildTree( groups );
+    }
+
     if( size == 1 )
     {
+        Node* node = new Node;
         Compound* compound = compounds.front();
 
         node->compound = compound;
@@ -121,12 +181,53 @@ LoadEqualizer::Node* LoadEqualizer::_buildTree( const Compounds& compounds )
     for( size_t i = middle; i < size; ++i )
         right.push_back( compounds[i] );
 
-    node->left  = _buildTree( left );
-    node->right = _buildTree( right );
+    return _joinTree( _buildTree( left ), _buildTree( right ));
+}
+
+LoadEqualizer::Node* LoadEqualizer::_buildTree(
+    const std::vector< Compounds >& groups )
+{
+    const size_t size = groups.size();
+    if( size == 1 )
+        return _buildTree( groups.front( ));
+
+    const size_t middle = size >> 1;
+    const std::vector< Compounds > left( groups.begin(),
+                                         groups.begin() + middle );
+    const std::vector< Compounds > right( groups.begin() + middle,
+                                          groups.end( ));
+    return _joinTree( _buildTree( left ), _buildTree( right ));
+}
 
+LoadEqualizer::Node* LoadEqualizer::_joinTree( Node* left, Node* right )
+{
+    Node* node = new Node;
+    node->left  = left;
+    node->right = right;
+    node->crossNode = left->crossNode || right->crossNode ||
+                      _getServerNode( left ) != _getServerNode( right );
     return node;
 }
 
+const server::Node* LoadEqualizer::_getServerNode( const Node* node )
+{
+    while( !node->compound )
+        node = node->left;
+    return node->compound->getChannel()->getNode();
+}
+
+void LoadEqualizer::_reset()
+{
+    _clearTree( _tree );
+    delete _tree;
+    _tree = 0;
+
+    _history.clear();
+    _costs.clear();
+    _trends.clear();
+    _costFrame = 0;
+}
+
 void LoadEqualizer::_clearTree( Node* node )
 {
     if( !node )
@@ -484,6 +585,21 @@ void LoadEqualizer::_updateNode( Node* node, const Viewport& vp,
             LBUNIMPLEMENTED;
         }
     }
+
+    if( !node->crossNode )
+        return;
+
+    // splits between nodes use the node-level constraints, if coarser
+    const Vector2i& boundary2i = getNodeBoundary2i();
+    const Vector2i& resistance2i = getNodeResistance2i();
+    node->boundary2i.x() = LB_MAX( node->boundary2i.x(), boundary2i.x( ));
+    node->boundary2i.y() = LB_MAX( node->boundary2i.y(), boundary2i.y( ));
+    node->boundaryf = LB_MAX( node->boundaryf, getNodeBoundaryf( ));
+    node->resistance2i.x() = LB_MAX( node->resistance2i.x(),
+                                     resistance2i.x( ));
+    node->resistance2i.y() = LB_MAX( node->resistance2i.y(),
+                                     resistance2i.y( ));
+    node->resistancef = LB_MAX( node->resistancef, getNodeResistancef( ));
 }
 
 int64_t LoadEqualizer::_getTotalTime()
@@ -533,6 +649,25 @@ void LoadEqualizer::_computeSplit()
     LBDatas items( frameData.second );
     _removeEmpty( items );
 
+    // In predictive mode, balance the extrapolated cost grid instead of the
+    // last measurement, which lags behind the current frame.
+    if( isPredictive() && getMode() != MODE_DB && getDamping() < 1.f )
+    {
+        _updateCosts( frameData );
+        if( _costFrame > 0 )
+        {
+            const LBDatas predicted = _predictCosts( _history.back().first );
+            int64_t predictedTime = 0;
+            for( LBDatas::const_iterator i = predicted.begin();
+                 i != predicted.end(); ++i )
+            {
+                predictedTime += i->time;
+            }
+            if( predictedTime > 0 )
+                items = predicted;
+        }
+    }
+
     LBDatas sortedData[3] = { items, items, items };
 
     if( getMode() == MODE_DB )
@@ -559,13 +694,101 @@ void LoadEqualizer::_computeSplit()
 #endif
     }
 
-    const float time = float( _getTotalTime( ));
+    int64_t totalTime = 0;
+    for( LBDatas::const_iterator i = items.begin(); i != items.end(); ++i )
+        totalTime += i->time;
+
+    const float time = float( totalTime );
     LBLOG( LOG_LB2 ) << "Render time " << time << " for "
                      << _tree->resources << " resources" << std::endl;
     if( _tree->resources > 0.f )
         _computeSplit( _tree, time, sortedData, Viewport(), Range( ));
 }
 
+void LoadEqualizer::_updateCosts( const LBFrameData& frameData )
+{
+    const uint32_t frameNumber = frameData.first;
+    if( frameNumber == 0 || frameNumber <= _costFrame ) // fake or known set
+        return;
+
+    LBDatas items( frameData.second );
+    _removeEmpty( items );
+    if( items.empty( ))
+        return;
+
+    // distribute the time of each item evenly over its region
+    const float cellSize = 1.f / float( GRID_SIZE );
+    std::vector< float > costs( GRID_SIZE * GRID_SIZE, 0.f );
+    for( LBDatas::const_iterator i = items.begin(); i != items.end(); ++i )
+    {
+        const Data& data = *i;
+        const float density = float( data.time ) / data.vp.getArea();
+
+        for( size_t y = 0; y < GRID_SIZE; ++y )
+        {
+            for( size_t x = 0; x < GRID_SIZE; ++x )
+            {
+                Viewport cell( float( x ) * cellSize, float( y ) * cellSize,
+                               cellSize, cellSize );
+                cell.intersect( data.vp );
+                if( cell.hasArea( ))
+                    costs[ y * GRID_SIZE + x ] += density * cell.getArea();
+            }
+        }
+    }
+
+    if( _costFrame == 0 )
+    {
+        _costs.swap( costs );
+        _trends.assign( _costs.size(), 0.f );
+        _costFrame = frameNumber;
+        return;
+    }
+
+    // double exponential smoothing: track cost and cost change of each cell
+    const float frames = float( frameNumber - _costFrame );
+    for( size_t i = 0; i < costs.size(); ++i )
+    {
+        const float expected = _costs[i] + _trends[i] * frames;
+        const float cost = COST_WEIGHT * costs[i] +
+                           ( 1.f - COST_WEIGHT ) * expected;
+        const float trend = ( cost - _costs[i] ) / frames;
+
+        _trends[i] = TREND_WEIGHT * trend + ( 1.f - TREND_WEIGHT ) * _trends[i];
+        _costs[i] = LB_MAX( cost, 0.f );
+    }
+    _costFrame = frameNumber;
+    LBLOG( LOG_LB2 ) << "Updated cost grid using frame " << frameNumber
+                     << std::endl;
+}
+
+LoadEqualizer::LBDatas LoadEqualizer::_predictCosts(
+    const uint32_t frameNumber ) const
+{
+    const float frames = frameNumber > _costFrame ?
+                         float( frameNumber - _costFrame ) : 0.f;
+    const float cellSize = 1.f / float( GRID_SIZE );
+
+    LBDatas items;
+    items.reserve( _costs.size( ));
+    for( size_t y = 0; y < GRID_SIZE; ++y )
+    {
+        for( size_t x = 0; x < GRID_SIZE; ++x )
+        {
+            const size_t i = y * GRID_SIZE + x;
+            const float cost = _costs[i] + _trends[i] * frames;
+
+            Data data;
+            data.vp = Viewport( float( x ) * cellSize, float( y ) * cellSize,
+                                cellSize, cellSize );
+            // use microseconds, only the relative cost matters for the split
+            data.time = int64_t( LB_MAX( cost, 0.f ) * 1000.f + .5f );
+            items.push_back( data );
+        }
+    }
+    return items;
+}
+
 void LoadEqualizer::_removeEmpty( LBDatas& items )
 {
     for( LBDatas::iterator i = items.begin(); i != items.end(); )
@@ -601,6 +824,7 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
     LBASSERT( node->left && node->right );
 
     LBDatas workingSet = datas[ node->mode ];
+    const float damping = node->crossNode ? getNodeDamping() : getDamping();
     const float leftTime = node->resources > 0 ?
                            time * node->left->resources / node->resources : 0.f;
     float timeLeft = LB_MIN( leftTime, time ); // correct for fp rounding error
@@ -705,9 +929,8 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
             }
 
             LBLOG( LOG_LB2 ) << "Should split at X " << splitPos << std::endl;
-            if( getDamping() < 1.f )
-                splitPos = (1.f - getDamping()) * splitPos +
-                            getDamping() * node->split;
+            if( damping < 1.f )
+                splitPos = (1.f - damping) * splitPos + damping * node->split;
             LBLOG( LOG_LB2 ) << "Dampened split at X " << splitPos << std::endl;
 
             // There might be more time left due to MIN_PIXEL rounding by parent
@@ -873,9 +1096,8 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
             }
 
             LBLOG( LOG_LB2 ) << "Should split at Y " << splitPos << std::endl;
-            if( getDamping() < 1.f )
-                splitPos = (1.f - getDamping( )) * splitPos +
-                            getDamping() * node->split;
+            if( damping < 1.f )
+                splitPos = (1.f - damping) * splitPos + damping * node->split;
             LBLOG( LOG_LB2 ) << "Dampened split at Y " << splitPos << std::endl;
 
             const Compound* root = getCompound();
@@ -1013,9 +1235,8 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
                 }
             }
             LBLOG( LOG_LB2 ) << "Should split at " << splitPos << std::endl;
-            if( getDamping() < 1.f )
-                splitPos = (1.f - getDamping( )) * splitPos +
-                            getDamping() * node->split;
+            if( damping < 1.f )
+                splitPos = (1.f - damping) * splitPos + damping * node->split;
             LBLOG( LOG_LB2 ) << "Dampened split at " << splitPos << std::endl;
 
             const float boundary( node->boundaryf );
@@ -1137,6 +1358,29 @@ std::ostream& operator << ( std::ostream& os, const LoadEqualizer* lb )
     if( lb->getResistancef() != .0f )
         os << "    resistance " << lb->getResistancef() << std::endl;
 
+    if( lb->isPredictive( ))
+        os << "    predictive ON" << std::endl;
+
+    if( lb->getNodeDamping() != lb->getDamping( ))
+        os << "    node_damping " << lb->getNodeDamping() << std::endl;
+
+    if( lb->getNodeBoundary2i() != lb->getBoundary2i( ))
+        os << "    node_boundary [ " << lb->getNodeBoundary2i().x() << " "
+           << lb->getNodeBoundary2i().y() << " ]" << std::endl;
+
+    if( lb->getNodeBoundaryf() != lb->getBoundaryf( ))
+        os << "    node_boundary " << lb->getNodeBoundaryf() << std::endl;
+
+    if( lb->getNodeResistance2i() != lb->getResistance2i( ))
+        os << "    node_resistance [ " << lb->getNodeResistance2i().x() << " "
+           << lb->getNodeResistance2i().y() << " ]" << std::endl;
+
+    if( lb->getNodeResistancef() != lb->getResistancef( ))
+        os << "    node_resistance " << lb->getNodeResistancef() << std::endl;
+
+    if( lb->isNodeAligned( ))
+        os << "    node_aligned ON" << std::endl;
+
     os << '}' << std::endl << lunchbox::enableFlush;
     return os;
 }
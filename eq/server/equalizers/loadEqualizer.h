@@ -56,17 +56,15 @@ namespace server
         virtual uint32_t getType() const { return fabric::LOAD_EQUALIZER; }
 
     protected:
-        void notifyChildAdded( Compound*, Compound* ) override
-            { LBASSERT( !_tree ); }
-        void notifyChildRemove( Compound*, Compound* ) override
-            { LBASSERT( !_tree ); }
+        void notifyChildAdded( Compound*, Compound* ) override { _reset(); }
+        void notifyChildRemove( Compound*, Compound* ) override { _reset(); }
 
     private:
         struct Node
         {
             Node() : left(0), right(0), compound(0), mode( MODE_VERTICAL )
                    , resources( 0.0f ), split( 0.5f ), boundaryf( 0.0f )
-                   , resistancef( 0.0f ) {}
+                   , resistancef( 0.0f ), crossNode( false ) {}
             ~Node() { delete left; delete right; }
 
             Node*     left;      //<! Left child (only on non-leafs)
@@ -80,11 +78,14 @@ namespace server
             float     resistancef;
             Vector2i  resistance2i;
             Vector2i  maxSize;
+            bool      crossNode; //<! Children render on different nodes
         };
         friend std::ostream& operator << ( std::ostream& os, const Node* node );
         typedef std::vector< Node* > LBNodes;
 
         Node* _tree; // <! The binary split tree of all children
+        Mode _treeMode; // <! The mode _tree was built for
+        bool _treeNodeAligned; // <! The node alignment _tree was built for
 
         struct Data
         {
@@ -104,16 +105,35 @@ namespace server
 
         std::deque< LBFrameData > _history;
 
+        std::vector< float > _costs;  // <! Smoothed cost of each grid cell
+        std::vector< float > _trends; // <! Cost change per frame of each cell
+        uint32_t _costFrame;          // <! Frame of the last cost grid update
+
         //-------------------- Methods --------------------
         /** @return true if we have a valid LB tree */
         Node* _buildTree( const Compounds& children );
 
+        /** @return a tree whose top-most splits separate the given groups. */
+        Node* _buildTree( const std::vector< Compounds >& groups );
+
+        /** @return the node rendering the first leaf of the given tree. */
+        static const server::Node* _getServerNode( const Node* node );
+
+        /** Connect the given children and update the cross-node flag. */
+        Node* _joinTree( Node* left, Node* right );
+
         /** Setup assembly with the compound dest value */
         void _updateAssembleTime( Data& data, const Statistic& stat );
 
         /** Clear the tree, does not delete the nodes. */
         void _clearTree( Node* node );
 
+        /**
+         * Drop the tree and all load data, e.g., after the children or the
+         * mode changed at runtime. The next update rebuilds the tree.
+         */
+        void _reset();
+
         /** get the total time used by the rendering. */
         int64_t _getTotalTime();
 
@@ -138,6 +158,12 @@ namespace server
         void _assign( Compound* compound, const Viewport& vp,
                       const Range& range );
 
+        /** Update the predictive cost grid from a complete frame data set. */
+        void _updateCosts( const LBFrameData& frameData );
+
+        /** @return the cost grid cells extrapolated to the given frame. */
+        LBDatas _predictCosts( const uint32_t frameNumber ) const;
+
         /** Get the resource for all children compound. */
         float _getTotalResources( ) const;
 
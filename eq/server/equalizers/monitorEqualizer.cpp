@@ -68,15 +68,47 @@ private:
     Frame* _frame;
     const std::string& _name;
 };
+
+/** Counts the input frames of the given name outside of a compound. */
+class InputFrameCounter : public CompoundVisitor
+{
+public:
+    InputFrameCounter( const std::string& name, const Compound* self )
+        : _name( name ), _self( self ), _count( 0 ) {}
+
+    virtual VisitorResult visit( const Compound* compound )
+        {
+            if( compound == _self )
+                return TRAVERSE_CONTINUE;
+
+            const Frames& inputFrames = compound->getInputFrames();
+            for( Frames::const_iterator i = inputFrames.begin();
+                 i != inputFrames.end(); ++i )
+            {
+                if( (*i)->getName() == _name )
+                    ++_count;
+            }
+            return TRAVERSE_CONTINUE;
+        }
+
+    size_t getCount() const { return _count; }
+
+private:
+    const std::string& _name;
+    const Compound* const _self;
+    size_t _count;
+};
 }
 
 MonitorEqualizer::MonitorEqualizer()
+        : _period( 1 )
 {
     LBINFO << "New monitor equalizer @" << (void*)this << std::endl;
 }
 
 MonitorEqualizer::MonitorEqualizer( const MonitorEqualizer& from )
         : Equalizer( from )
+        , _period( from._period )
 {}
 
 MonitorEqualizer::~MonitorEqualizer()
@@ -89,11 +121,19 @@ void MonitorEqualizer::attach( Compound* compound )
 {
     _outputFrames.clear();
     _viewports.clear();
+    _shared.clear();
     Equalizer::attach( compound );
 }
 
-void MonitorEqualizer::notifyUpdatePre( Compound*, const uint32_t )
+void MonitorEqualizer::notifyUpdatePre( Compound* compound, const uint32_t )
 {
+    if( _period > 1 )
+    {
+        // sources skip the readback for the monitor in the other frames
+        compound->setPeriod( _period );
+        compound->setPhase( 0 );
+    }
+
     _updateViewports();
     _updateZoomAndOffset();
 }
@@ -122,6 +162,11 @@ void MonitorEqualizer::_updateViewports()
         _outputFrames.push_back( outputFrame );
         _viewports.push_back( Viewport::FULL );
 
+        // reuse frames transmitted to other destinations as they are
+        InputFrameCounter counter( frame->getName(), compound );
+        root->accept( counter );
+        _shared.push_back( counter.getCount() > 0 );
+
         if( outputFrame )
         {
             const Channel* channel = outputFrame->getChannel();
@@ -149,6 +194,7 @@ void MonitorEqualizer::_updateZoomAndOffset()
     LBASSERTINFO( size == _outputFrames.size(),
                   size << " != " << _outputFrames.size( ));
     LBASSERT( size == _viewports.size( ));
+    LBASSERT( size == _shared.size( ));
 
     for( size_t i = 0; i < size; ++i )
     {
@@ -165,19 +211,28 @@ void MonitorEqualizer::_updateZoomAndOffset()
         const int32_t offsetY = int32_t( float( pvp.h ) * viewport.y );
         frame->setNativeOffset( Vector2i( offsetX, offsetY ));
 
-        // compute and apply output frame zoom
+        // compute and apply output frame zoom, downscaling during readback
         const int32_t width   = int32_t( float( pvp.w ) * viewport.w );
         const int32_t height  = int32_t( float( pvp.h ) * viewport.h ) ;
         const PixelViewport& srcPVP( srcCompound->getInheritPixelViewport( ));
         const Zoom zoom( float( width ) / float( srcPVP.w ),
                          float( height ) / float( srcPVP.h ));
-        outputFrame->setNativeZoom( zoom );
+        if( _shared[ i ] ) // don't degrade the frame, scale during assembly
+            frame->setNativeZoom( zoom );
+        else
+            outputFrame->setNativeZoom( zoom );
     }
 }
 
 std::ostream& operator << ( std::ostream& os, const MonitorEqualizer* equalizer)
 {
-    if( equalizer )
+    if( !equalizer )
+        return os;
+
+    if( equalizer->getPeriod() > 1 )
+        os << "monitor_equalizer { period " << equalizer->getPeriod() << " }"
+           << std::endl;
+    else
         os << "monitor_equalizer {}" << std::endl;
     return os;
 }
@@ -29,7 +29,15 @@ namespace server
 {
     std::ostream& operator << ( std::ostream& os, const MonitorEqualizer* );
 
-    /** Destination-driven scaling.*/
+    /**
+     * Destination-driven scaling.
+     *
+     * The source channels read back their output frames for the monitor at the
+     * monitor's resolution, downscaled on the GPU. Output frames which are also
+     * used by other destinations are not scaled, the monitor reuses them and
+     * scales during assembly. With a period, the monitor is only updated every
+     * n-th frame, and the sources skip the readback for it in between.
+     */
     class MonitorEqualizer : public Equalizer
     {
     public:
@@ -47,6 +55,12 @@ namespace server
 
         virtual uint32_t getType() const { return fabric::MONITOR_EQUALIZER; }
 
+        /** Update the monitor every n-th frame only. @version 1.8 */
+        void setPeriod( const uint32_t period ) { _period = period; }
+
+        /** @return the update period of the monitor. @version 1.8 */
+        uint32_t getPeriod() const { return _period; }
+
     protected:
         void notifyChildAdded( Compound*, Compound* ) override {}
         void notifyChildRemove( Compound*, Compound* ) override {}
@@ -61,6 +75,8 @@ namespace server
 
         Viewports _viewports;
         Frames _outputFrames;
+        std::vector< bool > _shared; //!< output frame used by other inputs
+        uint32_t _period;
     };
 }
 }
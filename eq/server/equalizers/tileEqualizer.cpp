@@ -22,10 +22,15 @@
 #include "../compound.h"
 #include "../compoundVisitor.h"
 #include "../config.h"
+#include "../log.h"
 #include "../server.h"
 #include "../tileQueue.h"
 #include "../view.h"
 
+#include <eq/fabric/statistic.h>
+
+#include <algorithm>
+
 namespace eq
 {
 namespace server
@@ -71,9 +76,18 @@ public:
         input->setAutoObsolete( compound->getConfig()->getLatency( ));
 
         compound->addInputTileQueue( input );
+
+        Channel* channel = compound->getChannel();
+        if( channel && std::find( channels.begin(), channels.end(),
+                                  channel ) == channels.end( ))
+        {
+            channels.push_back( channel );
+        }
         return TRAVERSE_CONTINUE;
     }
 
+    Channels channels;
+
 private:
     const eq::fabric::Vector2i& _tileSize;
     const std::string& _name;
@@ -107,6 +121,22 @@ private:
     const std::string& _name;
 };
 
+/**
+ * @return true if the children of the compound decompose the database range.
+ *         Each child then forms a range group with its own tile queue.
+ */
+bool _hasRangeGroups( const Compound* compound )
+{
+    const Compounds& children = compound->getChildren();
+    if( children.size() < 2 )
+        return false;
+
+    for( CompoundsCIter i = children.begin(); i != children.end(); ++i )
+        if( (*i)->getRange() != Range::ALL )
+            return true;
+    return false;
+}
+
 }
 
 TileEqualizer::TileEqualizer()
@@ -123,49 +153,109 @@ TileEqualizer::TileEqualizer( const TileEqualizer& from )
 {
 }
 
-std::string TileEqualizer::_getQueueName() const
+std::string TileEqualizer::_getQueueName( const Compound* group ) const
 {
     std::ostringstream name;
     name << "queue." << _name << (void*)this;
+    if( group )
+        name << "." << (const void*)group;
     return name.str();
 }
 
 void TileEqualizer::_createQueues( Compound* compound )
 {
     _created = true;
-    const std::string& name = _getQueueName();
-    if( !_findQueue( name, compound->getOutputTileQueues( )))
+    if( !_hasRangeGroups( compound ))
     {
-        TileQueue* output = new TileQueue;
-        ServerPtr server = compound->getServer();
+        _createQueue( compound, _getQueueName( 0 ));
+        return;
+    }
+
+    // Sort-last hybrid: each range group renders all tiles of its range from
+    // its own queue, and the destination composites the tile images of all
+    // ranges. Tiles without pixels of a range produce no image to composite.
+    const Compounds& children = compound->getChildren();
+    for( size_t i = 0; i < children.size(); ++i )
+        _createQueue( children[i], _getQueueName( children[i] ));
+
+    LBLOG( LOG_LB1 ) << "Tile queues for " << children.size()
+                     << " range groups of " << compound->getName()
+                     << std::endl;
+}
+
+void TileEqualizer::_createQueue( Compound* group, const std::string& name )
+{
+    TileQueue* output = _findQueue( name, group->getOutputTileQueues( ));
+    if( !output )
+    {
+        output = new TileQueue;
+        ServerPtr server = group->getServer();
         server->registerObject( output );
         output->setTileSize( getTileSize( ));
         output->setName( name );
-        output->setAutoObsolete( compound->getConfig()->getLatency( ));
+        output->setAutoObsolete( group->getConfig()->getLatency( ));
 
-        compound->addOutputTileQueue( output );
+        group->addOutputTileQueue( output );
     }
 
     InputQueueCreator creator( getTileSize(), name );
-    compound->accept( creator );
+    group->accept( creator );
+
+    for( ChannelsCIter i = creator.channels.begin();
+         i != creator.channels.end(); ++i )
+    {
+        Channel* channel = *i;
+        if( std::find( _channels.begin(), _channels.end(), channel ) ==
+            _channels.end( ))
+        {
+            _channels.push_back( channel );
+            channel->addListener( this );
+        }
+        _channelQueues[ channel ] = output;
+    }
 }
 
 void TileEqualizer::_destroyQueues( Compound* compound )
 {
-    const std::string& name = _getQueueName();
-    TileQueue* q = _findQueue( name, compound->getOutputTileQueues() );
+    _destroyQueue( compound, _getQueueName( 0 ));
+
+    const Compounds& children = compound->getChildren();
+    for( size_t i = 0; i < children.size(); ++i )
+        _destroyQueue( children[i], _getQueueName( children[i] ));
+    _created = false;
+
+    for( ChannelsCIter i = _channels.begin(); i != _channels.end(); ++i )
+        (*i)->removeListener( this );
+    _channels.clear();
+    _channelQueues.clear();
+}
+
+void TileEqualizer::_destroyQueue( Compound* group, const std::string& name )
+{
+    TileQueue* q = _findQueue( name, group->getOutputTileQueues() );
     if ( q )
     {
-        compound->removeOutputTileQueue( q );
-        ServerPtr server = compound->getServer();
+        group->removeOutputTileQueue( q );
+        ServerPtr server = group->getServer();
         q->flush();
         server->deregisterObject( q );
         delete q;
     }
 
     InputQueueDestroyer destroyer( name );
-    compound->accept( destroyer );
-    _created = false;
+    group->accept( destroyer );
+}
+
+void TileEqualizer::notifyChildAdded( Compound* compound, Compound* )
+{
+    if( _created )
+        _destroyQueues( compound );
+}
+
+void TileEqualizer::notifyChildRemove( Compound* compound, Compound* )
+{
+    if( _created )
+        _destroyQueues( compound );
 }
 
 void TileEqualizer::notifyUpdatePre( Compound* compound,
@@ -178,6 +268,33 @@ void TileEqualizer::notifyUpdatePre( Compound* compound,
         _destroyQueues( compound );
 }
 
+void TileEqualizer::notifyLoadData( Channel* channel, const uint32_t,
+                                    const Statistics& statistics,
+                                    const Viewport& )
+{
+    // tile costs are per range group, each range has its own screen cost
+    ChannelQueues::const_iterator i = _channelQueues.find( channel );
+    if( i == _channelQueues.end( ))
+        return;
+
+    TileQueue* queue = i->second;
+
+    const Vector2i& tileSize = queue->getTileSize();
+    if( tileSize.x() <= 0 || tileSize.y() <= 0 )
+        return;
+
+    for( size_t j = 0; j < statistics.size(); ++j )
+    {
+        const Statistic& stat = statistics[j];
+        if( stat.type != Statistic::CHANNEL_TILE )
+            continue;
+
+        const Vector2i tile( stat.tileX / tileSize.x(),
+                             stat.tileY / tileSize.y( ));
+        queue->setTileCost( tile, float( stat.endTime - stat.startTime ));
+    }
+}
+
 std::ostream& operator << ( std::ostream& os, const TileEqualizer* lb )
 {
     if( lb )
@@ -19,7 +19,10 @@
 #ifndef EQS_TILEEQUALIZER_H
 #define EQS_TILEEQUALIZER_H
 
-#include "equalizer.h"
+#include "../channelListener.h" // base class
+#include "equalizer.h"          // base class
+
+#include <map>
 
 namespace eq
 {
@@ -28,7 +31,15 @@ namespace server
 
 std::ostream& operator << ( std::ostream& os, const TileEqualizer* );
 
-class TileEqualizer : public Equalizer
+/**
+ * Creates tile queues for the attached compound and orders the tiles using
+ * the per-tile cost measured in the previous frames.
+ *
+ * If the children of the compound have database ranges, each child is a range
+ * group with its own tile queue, drained by the channels of the group. All
+ * tiles are then rendered once per range and composited by the destination.
+ */
+class TileEqualizer : public Equalizer, protected ChannelListener
 {
 public:
     EQSERVER_API TileEqualizer();
@@ -39,6 +50,11 @@ public:
     virtual void notifyUpdatePre( Compound* compound,
                                   const uint32_t frameNumber );
 
+    /** @sa ChannelListener::notifyLoadData */
+    virtual void notifyLoadData( Channel* channel, const uint32_t frameNumber,
+                                 const Statistics& statistics,
+                                 const Viewport& region );
+
     virtual void toStream( std::ostream& os ) const { os << this; }
     void setName( const std::string& name ) { _name = name; }
 
@@ -47,16 +63,23 @@ public:
     virtual uint32_t getType() const { return fabric::TILE_EQUALIZER; }
 
 protected:
-    void notifyChildAdded( Compound*, Compound* ) override {}
-    void notifyChildRemove( Compound*, Compound* ) override {}
+    void notifyChildAdded( Compound* compound, Compound* ) override;
+    void notifyChildRemove( Compound* compound, Compound* ) override;
 
 private:
-    std::string _getQueueName() const;
+    std::string _getQueueName( const Compound* group ) const;
     void _destroyQueues( Compound* compound );
     void _createQueues( Compound* compound );
+    void _createQueue( Compound* group, const std::string& name );
+    void _destroyQueue( Compound* group, const std::string& name );
 
     bool _created;
     std::string _name;
+    Channels _channels; //!< The channels rendering the tiles
+
+    /** The output queue drained by each channel. */
+    typedef std::map< const Channel*, TileQueue* > ChannelQueues;
+    ChannelQueues _channelQueues;
 };
 
 } //server
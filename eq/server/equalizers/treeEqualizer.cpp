@@ -24,6 +24,12 @@
 #include <eq/fabric/statistic.h>
 #include <lunchbox/debug.h>
 
+#include <algorithm>
+#include <cmath>
+
+#define MAX_SAMPLES 4  // cost model points per node
+#define MAX_HISTORY 32 // per-frame splits and times kept per node
+
 namespace eq
 {
 namespace server
@@ -37,6 +43,7 @@ std::ostream& operator << ( std::ostream& os, const TreeEqualizer::Node* );
 
 TreeEqualizer::TreeEqualizer()
         : _tree( 0 )
+        , _costModel( false )
 {
     LBINFO << "New TreeEqualizer @" << (void*)this << std::endl;
 }
@@ -45,6 +52,7 @@ TreeEqualizer::TreeEqualizer( const TreeEqualizer& from )
         : Equalizer( from )
         , ChannelListener( from )
         , _tree( 0 )
+        , _costModel( from._costModel )
 {}
 
 TreeEqualizer::~TreeEqualizer()
@@ -55,7 +63,7 @@ TreeEqualizer::~TreeEqualizer()
 }
 
 void TreeEqualizer::notifyUpdatePre( Compound* compound,
-                                     const uint32_t /*frame*/ )
+                                     const uint32_t frame )
 {
     if( isFrozen() || !compound->isActive( ) || !isActive( ))
         return;
@@ -80,8 +88,12 @@ void TreeEqualizer::notifyUpdatePre( Compound* compound,
 
     // compute new data
     _update( _tree );
+    if( _costModel )
+        _fit( _tree );
     _split( _tree );
     _assign( _tree, Viewport(), Range( ));
+    if( _costModel )
+        _record( _tree, frame );
     LBLOG( LOG_LB2 ) << "LB tree: " << _tree;
 }
 
@@ -136,21 +148,22 @@ void TreeEqualizer::_clearTree( Node* node )
 }
 
 void TreeEqualizer::notifyLoadData( Channel* channel,
-                                    const uint32_t /*frame*/,
+                                    const uint32_t frame,
                                     const Statistics& statistics,
                                     const Viewport& /*region*/ )
 {
-    _notifyLoadData( _tree, channel, statistics );
+    _notifyLoadData( _tree, channel, frame, statistics );
 }
 
 void TreeEqualizer::_notifyLoadData( Node* node, Channel* channel,
+                                     const uint32_t frame,
                                      const Statistics& statistics )
 {
     if( !node )
         return;
 
-    _notifyLoadData( node->left, channel, statistics );
-    _notifyLoadData( node->right, channel, statistics );
+    _notifyLoadData( node->left, channel, frame, statistics );
+    _notifyLoadData( node->right, channel, frame, statistics );
 
     if( !node->compound || node->compound->getChannel() != channel )
         return;
@@ -197,6 +210,12 @@ void TreeEqualizer::_notifyLoadData( Node* node, Channel* channel,
     node->time = endTime - startTime;
     node->time = LB_MAX( node->time, 1 );
     node->time = LB_MAX( node->time, timeTransmit );
+
+    if( !_costModel )
+        return;
+    node->times.push_front( std::make_pair( frame, node->time ));
+    if( node->times.size() > MAX_HISTORY )
+        node->times.pop_back();
 }
 
 void TreeEqualizer::_update( Node* node )
@@ -344,6 +363,17 @@ void TreeEqualizer::_split( Node* node )
         return;
     }
 
+    if( _costModel && !node->samples.empty( ))
+    {
+        node->split = _solve( node );
+        LBLOG( LOG_LB2 ) << "Cost model split at " << node->split
+                         << " using " << node->samples.size() << " samples"
+                         << std::endl;
+        _split( left );
+        _split( right );
+        return;
+    }
+
     // new split
     const float target = node->time * left->resources / node->resources;
     const float leftTime = float(left->time);
@@ -424,8 +454,8 @@ void TreeEqualizer::_assign( Node* node, const Viewport& vp,
             if( (end - absoluteSplit) < boundary )
                 absoluteSplit = end - boundary;
 
-            const uint32_t ratio = uint32_t( absoluteSplit / boundary + .5f );
-            absoluteSplit = ratio * boundary;
+            absoluteSplit = _align( node, absoluteSplit, boundary, vp.x,
+                                    vp.w );
         }
 
         absoluteSplit = LB_MAX( absoluteSplit, vp.x );
@@ -495,8 +525,8 @@ void TreeEqualizer::_assign( Node* node, const Viewport& vp,
             if( (end - absoluteSplit) < boundary )
                 absoluteSplit = end - boundary;
 
-            const uint32_t ratio = uint32_t( absoluteSplit / boundary + .5f );
-            absoluteSplit = ratio * boundary;
+            absoluteSplit = _align( node, absoluteSplit, boundary, vp.y,
+                                    vp.h );
         }
 
         absoluteSplit = LB_MAX( absoluteSplit, vp.y );
@@ -548,8 +578,8 @@ void TreeEqualizer::_assign( Node* node, const Viewport& vp,
         else if( node->right->resources == 0.f )
             absoluteSplit = end;
 
-        const uint32_t ratio = uint32_t( absoluteSplit / boundary + .5f );
-        absoluteSplit = ratio * boundary;
+        absoluteSplit = _align( node, absoluteSplit, boundary, range.start,
+                                range.end - range.start );
         if( (absoluteSplit - range.start) < boundary )
             absoluteSplit = range.start;
         if( (end - absoluteSplit) < boundary )
@@ -586,6 +616,191 @@ void TreeEqualizer::_assign( Node* node, const Viewport& vp,
     }
 }
 
+void TreeEqualizer::_record( Node* node, const uint32_t frame )
+{
+    if( node->compound )
+        return;
+
+    if( node->left->resources > 0.f && node->right->resources > 0.f )
+    {
+        node->splits.push_front( std::make_pair( frame, node->split ));
+        if( node->splits.size() > MAX_HISTORY )
+            node->splits.pop_back();
+    }
+    _record( node->left, frame );
+    _record( node->right, frame );
+}
+
+void TreeEqualizer::_fit( Node* node )
+{
+    if( node->compound )
+        return;
+
+    // oldest first, so that newer samples replace contradicting older ones
+    while( !node->splits.empty( ))
+    {
+        bool found = false;
+        for( size_t i = node->splits.size(); i > 0 && !found; --i )
+        {
+            const uint32_t frame = node->splits[ i - 1 ].first;
+            const int64_t left = _getTime( node->left, frame );
+            const int64_t right = _getTime( node->right, frame );
+            if( left < 0 || right < 0 )
+                continue;
+
+            const Sample sample = { frame, node->splits[ i - 1 ].second,
+                                    float( left ), float( right ) };
+            _addSample( node, sample );
+            node->splits.erase( node->splits.begin() + ( i - 1 ),
+                                node->splits.end( ));
+            found = true;
+        }
+        if( !found )
+            break;
+    }
+
+    _fit( node->left );
+    _fit( node->right );
+}
+
+void TreeEqualizer::_addSample( Node* node, const Sample& sample )
+{
+    // The left time grows and the right time shrinks with the split. Drop
+    // samples close to or contradicting the new one, the load has changed.
+    Samples& samples = node->samples;
+    for( Samples::iterator i = samples.begin(); i != samples.end(); )
+    {
+        const Sample& old = *i;
+        const bool close = std::abs( old.split - sample.split ) < .01f;
+        const bool stale = old.split < sample.split ?
+            ( old.left > sample.left || old.right < sample.right ) :
+            ( old.left < sample.left || old.right > sample.right );
+
+        if( close || stale )
+            i = samples.erase( i );
+        else
+            ++i;
+    }
+
+    if( samples.size() >= MAX_SAMPLES )
+    {
+        Samples::iterator oldest = samples.begin();
+        for( Samples::iterator i = samples.begin(); i != samples.end(); ++i )
+            if( i->frame < oldest->frame )
+                oldest = i;
+        samples.erase( oldest );
+    }
+
+    Samples::iterator i = samples.begin();
+    while( i != samples.end() && i->split < sample.split )
+        ++i;
+    samples.insert( i, sample );
+}
+
+int64_t TreeEqualizer::_getTime( const Node* node, const uint32_t frame )
+{
+    if( node->resources == 0.f ) // unused subtree
+        return 0;
+
+    if( node->compound )
+    {
+        for( size_t i = 0; i < node->times.size(); ++i )
+            if( node->times[i].first == frame )
+                return node->times[i].second;
+        return -1;
+    }
+
+    const int64_t left = _getTime( node->left, frame );
+    const int64_t right = _getTime( node->right, frame );
+    return ( left < 0 || right < 0 ) ? -1 : left + right;
+}
+
+namespace
+{
+typedef std::vector< std::pair< float, float > > Points;
+
+/** @return the linear interpolation of the sorted points, extrapolated. */
+float _interpolate( const Points& points, const float x )
+{
+    LBASSERT( points.size() >= 2 );
+    size_t i = 1;
+    while( i < points.size() - 1 && points[i].first < x )
+        ++i;
+
+    const std::pair< float, float >& a = points[ i - 1 ];
+    const std::pair< float, float >& b = points[ i ];
+    const float dx = b.first - a.first;
+    if( dx <= 0.f )
+        return LB_MAX( b.second, 0.f );
+    return LB_MAX( a.second + ( x - a.first ) / dx * ( b.second - a.second ),
+                   0.f );
+}
+}
+
+float TreeEqualizer::_predict( const Node* node, const float split )
+{
+    // piecewise-linear times over the split, no work at the borders
+    Points left( 1, std::make_pair( 0.f, 0.f ));
+    Points right;
+    for( Samples::const_iterator i = node->samples.begin();
+         i != node->samples.end(); ++i )
+    {
+        left.push_back( std::make_pair( i->split, i->left ));
+        right.push_back( std::make_pair( i->split, i->right ));
+    }
+    right.push_back( std::make_pair( 1.f, 0.f ));
+
+    return LB_MAX( _interpolate( left, split ) / node->left->resources,
+                   _interpolate( right, split ) / node->right->resources );
+}
+
+float TreeEqualizer::_solve( const Node* node )
+{
+    Points left( 1, std::make_pair( 0.f, 0.f ));
+    Points right;
+    for( Samples::const_iterator i = node->samples.begin();
+         i != node->samples.end(); ++i )
+    {
+        left.push_back( std::make_pair( i->split, i->left ));
+        right.push_back( std::make_pair( i->split, i->right ));
+    }
+    right.push_back( std::make_pair( 1.f, 0.f ));
+
+    // the left time grows, the right time shrinks: bisect for the crossing
+    float low = 0.f;
+    float high = 1.f;
+    for( size_t i = 0; i < 20; ++i )
+    {
+        const float split = ( low + high ) * .5f;
+        if( _interpolate( left, split ) / node->left->resources <
+            _interpolate( right, split ) / node->right->resources )
+        {
+            low = split;
+        }
+        else
+            high = split;
+    }
+    return ( low + high ) * .5f;
+}
+
+float TreeEqualizer::_align( const Node* node, const float split,
+                             const float boundary, const float start,
+                             const float size ) const
+{
+    const float nearest = float( uint32_t( split / boundary + .5f )) * boundary;
+    if( !_costModel || node->samples.empty() || size <= 0.f ||
+        node->left->resources == 0.f || node->right->resources == 0.f )
+    {
+        return nearest;
+    }
+
+    // use the aligned neighbor with the smaller predicted time
+    const float lower = float( uint32_t( split / boundary )) * boundary;
+    const float upper = lower + boundary;
+    return _predict( node, ( lower - start ) / size ) <=
+           _predict( node, ( upper - start ) / size ) ? lower : upper;
+}
+
 std::ostream& operator << ( std::ostream& os, const TreeEqualizer::Node* node )
 {
     if( !node )
@@ -632,6 +847,9 @@ std::ostream& operator << ( std::ostream& os, const TreeEqualizer* lb )
     if( lb->getResistancef() != .0f )
         os << "    resistance " << lb->getResistancef() << std::endl;
 
+    if( lb->useCostModel( ))
+        os << "    cost_model ON" << std::endl;
+
     os << '}' << std::endl << lunchbox::enableFlush;
     return os;
 }
@@ -34,7 +34,15 @@ namespace server
 {
     std::ostream& operator << ( std::ostream& os, const TreeEqualizer* );
 
-    /** Adapts the 2D tiling or DB range of the attached compound's children. */
+    /**
+     * Adapts the 2D tiling or DB range of the attached compound's children.
+     *
+     * By default, each split moves towards the time ratio of its subtrees.
+     * With the cost model enabled, the times measured for past splits form a
+     * piecewise-linear cost function for each subtree, and the split is solved
+     * directly for equal times per resource. Boundary alignment then picks the
+     * aligned position with the smaller predicted time.
+     */
     class TreeEqualizer : public Equalizer, protected ChannelListener
     {
     public:
@@ -55,6 +63,12 @@ namespace server
 
         virtual uint32_t getType() const { return fabric::TREE_EQUALIZER; }
 
+        /** Solve the splits using a fitted cost model. @version 1.8 */
+        void setCostModel( const bool enable ) { _costModel = enable; }
+
+        /** @return true if the cost model is used. @version 1.8 */
+        bool useCostModel() const { return _costModel; }
+
     protected:
         void notifyChildAdded( Compound*, Compound* ) override
             { LBASSERT( !_tree ); }
@@ -62,6 +76,16 @@ namespace server
             { LBASSERT( !_tree ); }
 
     private:
+        /** The subtree times measured for one split. */
+        struct Sample
+        {
+            uint32_t frame;
+            float    split;
+            float    left;
+            float    right;
+        };
+        typedef std::vector< Sample > Samples;
+
         struct Node
         {
             Node() : left(0), right(0), compound(0), mode( MODE_VERTICAL )
@@ -82,11 +106,18 @@ namespace server
             Vector2i  resistance2i;
             Vector2i  maxSize;
             int64_t   time;
+
+            /** Splits assigned per frame (only on non-leafs) */
+            std::deque< std::pair< uint32_t, float > > splits;
+            /** Times measured per frame (only on leafs) */
+            std::deque< std::pair< uint32_t, int64_t > > times;
+            Samples   samples;   //<! Cost model, sorted by split
         };
         friend std::ostream& operator << ( std::ostream& os, const Node* node );
         typedef std::vector< Node* > LBNodes;
 
         Node* _tree; // <! The binary split tree of all children
+        bool _costModel;
 
         //-------------------- Methods --------------------
         /** @return true if we have a valid LB tree */
@@ -96,6 +127,7 @@ namespace server
         void _clearTree( Node* node );
 
         void _notifyLoadData( Node* node, Channel* channel,
+                              const uint32_t frame,
                               const Statistics& statistics );
 
         /** Update all node fields influencing the split */
@@ -104,6 +136,27 @@ namespace server
         /** Adjust the split of each node based on the front-most _history. */
         void _split( Node* node );
         void _assign( Node* node, const Viewport& vp, const Range& range );
+
+        /** Remember the splits used for the given frame. */
+        void _record( Node* node, const uint32_t frame );
+
+        /** Add the completely measured splits to the cost models. */
+        void _fit( Node* node );
+        void _addSample( Node* node, const Sample& sample );
+
+        /** @return the time of a subtree in the given frame, or -1. */
+        static int64_t _getTime( const Node* node, const uint32_t frame );
+
+        /** @return the predicted time per resource for the given split. */
+        static float _predict( const Node* node, const float split );
+
+        /** @return the split with equal predicted times per resource. */
+        static float _solve( const Node* node );
+
+        /** @return the absolute split aligned to the boundary. */
+        float _align( const Node* node, const float split,
+                      const float boundary, const float start,
+                      const float size ) const;
     };
 }
 }
@@ -25,9 +25,12 @@
 
 #include <eq/fabric/statistic.h>
 
+#include <algorithm>
 #include <set>
 
 #define MIN_USAGE .1f // 10%
+#define RESIDENT_FRAMES 100 // caches of recently used resources are warm
+#define FLOW_EPSILON 1e-5f
 
 namespace eq
 {
@@ -36,6 +39,10 @@ namespace server
 
 ViewEqualizer::ViewEqualizer()
         : _nPipes( 0 )
+        , _dwellTime( 10 )
+        , _warmup( 5 )
+        , _hysteresis( .1f )
+        , _joint( false )
 {
     LBINFO << "New view equalizer @" << (void*)this << std::endl;
 }
@@ -43,6 +50,10 @@ ViewEqualizer::ViewEqualizer()
 ViewEqualizer::ViewEqualizer( const ViewEqualizer& from )
         : Equalizer( from )
         , _nPipes( 0 )
+        , _dwellTime( from._dwellTime )
+        , _warmup( from._warmup )
+        , _hysteresis( from._hysteresis )
+        , _joint( from._joint )
 {}
 
 ViewEqualizer::~ViewEqualizer()
@@ -65,6 +76,7 @@ void ViewEqualizer::attach( Compound* compound )
         (*i).clear();
 
     _listeners.clear();
+    _assignments.clear();
     Equalizer::attach( compound );
 }
 
@@ -291,6 +303,100 @@ private:
     Compound* _fallback;
 };
 
+class LeafGatherer : public CompoundVisitor
+{
+public:
+    virtual VisitorResult visitLeaf( Compound* compound )
+        {
+            _leaves.push_back( compound );
+            return TRAVERSE_CONTINUE;
+        }
+
+    const Compounds& getLeaves() const { return _leaves; }
+
+private:
+    Compounds _leaves;
+};
+
+Compounds _getLeaves( Compound* compound )
+{
+    LeafGatherer gatherer;
+    compound->accept( gatherer );
+    return gatherer.getLeaves();
+}
+
+/** Maximum flow through a small, dense graph using shortest augmenting paths.*/
+class FlowGraph
+{
+public:
+    explicit FlowGraph( const size_t nNodes )
+        : _nNodes( nNodes )
+        , _capacities( nNodes * nNodes, 0.f )
+        , _flows( nNodes * nNodes, 0.f )
+    {}
+
+    void setCapacity( const size_t from, const size_t to, const float value )
+        { _capacities[ from * _nNodes + to ] = value; }
+
+    float getFlow( const size_t from, const size_t to ) const
+        { return _flows[ from * _nNodes + to ]; }
+
+    /** @return the maximum flow from source to sink. */
+    float solve( const size_t source, const size_t sink )
+    {
+        std::fill( _flows.begin(), _flows.end(), 0.f );
+        std::vector< size_t > parents( _nNodes );
+        float total = 0.f;
+
+        for( ;; )
+        {
+            std::fill( parents.begin(), parents.end(), _nNodes );
+            parents[ source ] = source;
+            std::deque< size_t > queue( 1, source );
+            while( !queue.empty() && parents[ sink ] == _nNodes )
+            {
+                const size_t node = queue.front();
+                queue.pop_front();
+                for( size_t next = 0; next < _nNodes; ++next )
+                {
+                    if( parents[ next ] == _nNodes &&
+                        _getResidual( node, next ) > FLOW_EPSILON )
+                    {
+                        parents[ next ] = node;
+                        queue.push_back( next );
+                    }
+                }
+            }
+            if( parents[ sink ] == _nNodes ) // no augmenting path left
+                return total;
+
+            float amount = std::numeric_limits< float >::max();
+            for( size_t node = sink; node != source; node = parents[ node ] )
+                amount = LB_MIN( amount,
+                                 _getResidual( parents[ node ], node ));
+
+            for( size_t node = sink; node != source; node = parents[ node ] )
+            {
+                const size_t parent = parents[ node ];
+                _flows[ parent * _nNodes + node ] += amount;
+                _flows[ node * _nNodes + parent ] -= amount;
+            }
+            total += amount;
+        }
+    }
+
+private:
+    const size_t _nNodes;
+    std::vector< float > _capacities;
+    std::vector< float > _flows;
+
+    float _getResidual( const size_t from, const size_t to ) const
+    {
+        const size_t index = from * _nNodes + to;
+        return _capacities[ index ] - _flows[ index ];
+    }
+};
+
 }
 
 void ViewEqualizer::_update( const uint32_t frameNumber )
@@ -328,6 +434,56 @@ void ViewEqualizer::_update( const uint32_t frameNumber )
     const Compounds& children = compound->getChildren();
     const size_t size( _listeners.size( ));
     LBASSERT( children.size() == size );
+    std::vector< float > oldUsages;
+    for( size_t i = 0; i < size; ++i )
+    {
+        const Compounds& leaves = _getLeaves( children[ i ] );
+        for( size_t j = 0; j < leaves.size(); ++j )
+            oldUsages.push_back( leaves[ j ]->getUsage( ));
+    }
+
+    if( _joint )
+        _assignJoint( loads );
+    else
+        _assignGreedy( loads, resourceTime );
+
+    // keep previous resources if the migration does not pay off
+    if( !_useNewAssignment( frameNumber, loads, oldUsages, resourceTime ))
+    {
+        LBLOG( LOG_LB1 ) << "----- keep previous assignment" << std::endl;
+        size_t index = 0;
+        for( size_t i = 0; i < size; ++i )
+        {
+            Listener::Load& load = loads[ i ];
+            const Compounds& leaves = _getLeaves( children[ i ] );
+
+            load.missing = 0;
+            for( size_t j = 0; j < leaves.size(); ++j, ++index )
+            {
+                Compound* leaf = leaves[ j ];
+                leaf->setUsage( oldUsages[ index ] );
+                if( leaf->isActive() && leaf->getUsage() > 0.f )
+                    ++load.missing;
+            }
+        }
+    }
+    _updateAssignments( frameNumber );
+
+    for( size_t i = 0; i < size; ++i )
+    {
+        Listener& listener = _listeners[ i ];
+        LBASSERTINFO( listener.getNLoads() <= getConfig()->getLatency() + 3,
+                      listener );
+
+        if( children[ i ]->isActive( ))
+            listener.newLoad( frameNumber, loads[ i ].missing );
+    }
+}
+
+void ViewEqualizer::_assignGreedy( Loads& loads, const float resourceTime )
+{
+    const Compounds& children = getCompound()->getChildren();
+    const size_t size( _listeners.size( ));
     lunchbox::PtrHash< Pipe*, float > pipeUsage;
     float* leftOvers = static_cast< float* >( alloca( size * sizeof( float )));
 
@@ -376,10 +532,6 @@ void ViewEqualizer::_update( const uint32_t frameNumber )
     // satisfy left-overs
     for( size_t i = 0; i < size; ++i )
     {
-        Listener& listener = _listeners[ i ];
-        LBASSERTINFO( listener.getNLoads() <= getConfig()->getLatency() + 3,
-                      listener );
-
         float& leftOver = leftOvers[i];
         Listener::Load& load = loads[ i ];
         Compound* child = children[ i ];
@@ -412,8 +564,248 @@ void ViewEqualizer::_update( const uint32_t frameNumber )
                                 << std::endl;
             }
         }
+    }
+}
+
+void ViewEqualizer::_assignJoint( Loads& loads )
+{
+    // Bipartite graph from the source over the views and the pipes used by
+    // them to the sink. The views demand resources proportional to their load,
+    // each pipe provides one resource. The largest feasible demand scale
+    // minimizes the frame time of the slowest view.
+    struct Edge
+    {
+        size_t view;
+        size_t pipe;
+        Compound* leaf;
+    };
+    std::vector< Edge > edges;
+    std::vector< const Pipe* > pipes;
+    const Compounds& children = getCompound()->getChildren();
+    const size_t nViews = children.size();
+    float totalTime = 0.f;
+
+    for( size_t i = 0; i < nViews; ++i )
+    {
+        Compound* child = children[ i ];
+        if( !child->isActive( ))
+            continue;
+
+        totalTime += float( loads[ i ].time );
+        const Compounds& leaves = _getLeaves( child );
+        for( size_t j = 0; j < leaves.size(); ++j )
+        {
+            Compound* leaf = leaves[ j ];
+            if( !leaf->isActive( ))
+                continue;
+
+            const Pipe* pipe = leaf->getPipe();
+            LBASSERT( pipe );
+            const size_t index = std::find( pipes.begin(), pipes.end(), pipe ) -
+                                 pipes.begin();
+            if( index == pipes.size( ))
+                pipes.push_back( pipe );
+
+            bool duplicate = false;
+            for( size_t k = 0; k < edges.size() && !duplicate; ++k )
+                duplicate = edges[k].view == i && edges[k].pipe == index;
+
+            leaf->setUsage( 0.f );
+            if( !duplicate ) // use one channel per pipe and view
+            {
+                const Edge edge = { i, index, leaf };
+                edges.push_back( edge );
+            }
+        }
+    }
+
+    const size_t nPipes = pipes.size();
+    const size_t source = 0;
+    const size_t sink = 1 + nViews + nPipes;
+    FlowGraph graph( sink + 1 );
+    for( size_t i = 0; i < edges.size(); ++i )
+        graph.setCapacity( 1 + edges[i].view, 1 + nViews + edges[i].pipe, 1.f );
+    for( size_t i = 0; i < nPipes; ++i )
+        graph.setCapacity( 1 + nViews + i, sink, 1.f );
+
+    float low = 0.f;
+    float high = float( nPipes ) / LB_MAX( totalTime, 1.f );
+    for( size_t step = 0; step < 16; ++step )
+    {
+        const float scale = ( low + high ) * .5f;
+        for( size_t i = 0; i < nViews; ++i )
+            if( children[ i ]->isActive( ))
+                graph.setCapacity( source, 1 + i, scale * loads[i].time );
+
+        if( graph.solve( source, sink ) >= scale * totalTime * .999f )
+            low = scale;
+        else
+            high = scale;
+    }
+    for( size_t i = 0; i < nViews; ++i )
+        if( children[ i ]->isActive( ))
+            graph.setCapacity( source, 1 + i, low * loads[i].time );
+    graph.solve( source, sink );
+
+    // spend the slack of each pipe on its slowest view
+    std::vector< float > usages( edges.size( ));
+    std::vector< float > resources( nViews, 0.f );
+    std::vector< float > slacks( nPipes, 1.f );
+    for( size_t i = 0; i < edges.size(); ++i )
+    {
+        const Edge& edge = edges[i];
+        usages[i] = graph.getFlow( 1 + edge.view, 1 + nViews + edge.pipe );
+        resources[ edge.view ] += usages[i];
+        slacks[ edge.pipe ] -= usages[i];
+    }
+    for( size_t i = 0; i < nPipes; ++i )
+    {
+        if( slacks[i] < MIN_USAGE )
+            continue;
+
+        size_t slowest = edges.size();
+        float slowestTime = 0.f;
+        for( size_t j = 0; j < edges.size(); ++j )
+        {
+            if( edges[j].pipe != i )
+                continue;
+            const size_t view = edges[j].view;
+            const float time = loads[ view ].time /
+                               LB_MAX( resources[ view ], FLOW_EPSILON );
+            if( slowest == edges.size() || time > slowestTime )
+            {
+                slowest = j;
+                slowestTime = time;
+            }
+        }
+        if( slowest == edges.size( ))
+            continue;
+
+        usages[ slowest ] += slacks[i];
+        resources[ edges[ slowest ].view ] += slacks[i];
+    }
+
+    // apply, drop tiny shares but keep at least one channel per view
+    for( size_t i = 0; i < nViews; ++i )
+        loads[i].missing = 0;
+    for( size_t i = 0; i < edges.size(); ++i )
+    {
+        const Edge& edge = edges[i];
+        if( usages[i] < MIN_USAGE && ( loads[ edge.view ].missing > 0 ||
+                                       resources[ edge.view ] > usages[i] ))
+        {
+            resources[ edge.view ] -= usages[i];
+            continue;
+        }
+
+        const float use = LB_MAX( usages[i], MIN_USAGE );
+        edge.leaf->setUsage( use );
+        ++loads[ edge.view ].missing;
+        LBLOG( LOG_LB1 ) << "  Use "
+                         << static_cast< unsigned >( use * 100.f + .5f )
+                         << "% of " << edge.leaf->getPipe()->getName()
+                         << " task " << edge.leaf->getTaskID() << " for view "
+                         << edge.view << std::endl;
+    }
+}
+
+bool ViewEqualizer::_useNewAssignment( const uint32_t frameNumber,
+                                       const Loads& loads,
+                                       const std::vector< float >& oldUsages,
+                                       const float resourceTime ) const
+{
+    if( _assignments.empty( )) // initial assignment
+        return true;
+
+    const Compounds& children = getCompound()->getChildren();
+    float oldTime = 0.f;
+    float newTime = 0.f;
+    float cost = 0.f; // extra time of the warm-up frames of cold resources
+    bool changed = false;
+    bool dwelling = false;
+    size_t index = 0;
+
+    for( size_t i = 0; i < children.size(); ++i )
+    {
+        Compound* child = children[ i ];
+        const Compounds& leaves = _getLeaves( child );
+        float oldResources = 0.f;
+        float newResources = 0.f;
+
+        for( size_t j = 0; j < leaves.size(); ++j, ++index )
+        {
+            const Compound* leaf = leaves[ j ];
+            if( !child->isActive() || !leaf->isActive( ))
+                continue;
+
+            const float oldUsage = oldUsages[ index ];
+            const float newUsage = leaf->getUsage();
+            oldResources += oldUsage;
+            newResources += newUsage;
+
+            if(( oldUsage > 0.f ) == ( newUsage > 0.f ))
+                continue;
+
+            changed = true;
+            Assignments::const_iterator k = _assignments.find( leaf );
+            if( newUsage == 0.f ) // released resource
+            {
+                if( k != _assignments.end() &&
+                    frameNumber - k->second.start < _dwellTime )
+                {
+                    dwelling = true;
+                }
+            }
+            else if( k == _assignments.end() ||
+                     frameNumber - k->second.lastUsed > RESIDENT_FRAMES )
+            {
+                cost += float( _warmup ) * resourceTime * newUsage;
+            }
+        }
+
+        if( !child->isActive( ))
+            continue;
+        if( oldResources <= 0.f ) // previous assignment misses this view
+            return true;
+
+        const float time = float( loads[ i ].time );
+        oldTime = LB_MAX( oldTime, time / oldResources );
+        newTime = LB_MAX( newTime, time / LB_MAX( newResources, MIN_USAGE ));
+    }
+
+    if( !changed ) // same resources, only their share changes
+        return true;
+    if( dwelling )
+        return false;
+
+    const float gain = oldTime - newTime;
+    LBLOG( LOG_LB1 ) << "Reassignment gains " << gain << "ms/frame of "
+                     << oldTime << "ms, costs " << cost << "ms" << std::endl;
+    if( gain <= _hysteresis * oldTime )
+        return false;
+    return gain * float( LB_MAX( _dwellTime, 1u )) > cost;
+}
 
-        listener.newLoad( frameNumber, load.missing );
+void ViewEqualizer::_updateAssignments( const uint32_t frameNumber )
+{
+    const Compounds& children = getCompound()->getChildren();
+    for( size_t i = 0; i < children.size(); ++i )
+    {
+        const Compounds& leaves = _getLeaves( children[ i ] );
+        for( size_t j = 0; j < leaves.size(); ++j )
+        {
+            const Compound* leaf = leaves[ j ];
+            if( !leaf->isActive() || leaf->getUsage() == 0.f )
+                continue;
+
+            Assignment& assignment = _assignments[ leaf ];
+            if( assignment.lastUsed == 0 ||
+                assignment.lastUsed + 1 < frameNumber )
+            {
+                assignment.start = frameNumber; // (re)activated
+            }
+            assignment.lastUsed = frameNumber;
+        }
     }
 }
 
@@ -703,8 +1095,22 @@ void ViewEqualizer::Listener::newLoad( const uint32_t frameNumber,
 
 std::ostream& operator << ( std::ostream& os, const ViewEqualizer* equalizer )
 {
-    if( equalizer )
-        os << "view_equalizer {}" << std::endl;
+    if( !equalizer )
+        return os;
+
+    os << lunchbox::disableFlush << "view_equalizer" << std::endl
+       << '{' << std::endl;
+
+    if( equalizer->getDwellTime() != 10 )
+        os << "    dwell " << equalizer->getDwellTime() << std::endl;
+    if( equalizer->getWarmup() != 5 )
+        os << "    warmup " << equalizer->getWarmup() << std::endl;
+    if( equalizer->getHysteresis() != .1f )
+        os << "    hysteresis " << equalizer->getHysteresis() << std::endl;
+    if( equalizer->isJoint( ))
+        os << "    joint ON" << std::endl;
+
+    os << '}' << std::endl << lunchbox::enableFlush;
     return os;
 }
 
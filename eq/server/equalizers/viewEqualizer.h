@@ -34,6 +34,19 @@ namespace server
     /**
      * An Equalizer allocating resources to multiple destination channels of a
      * single view.
+     *
+     * Moving a resource to another view invalidates the caches of its GPU, and
+     * the resource renders slower for a few warm-up frames. A new assignment
+     * which activates resources is only used if the frame time gained over the
+     * dwell time outweighs this migration cost, and if the gain exceeds the
+     * hysteresis. Resources recently used by a view are still warm and free to
+     * reactivate, and a resource stays with its view for at least the dwell
+     * time.
+     *
+     * In joint mode, the shares of all pipes are solved in one step for all
+     * views, minimizing the frame time of the slowest view. A pipe may then
+     * contribute to any number of views, and the load equalizers of the views
+     * distribute the work using the resulting compound usage.
      */
     class ViewEqualizer : public Equalizer
     {
@@ -52,6 +65,44 @@ namespace server
 
         virtual uint32_t getType() const { return fabric::VIEW_EQUALIZER; }
 
+        /**
+         * Set the minimum number of frames a resource stays with a view.
+         * @version 1.8
+         */
+        void setDwellTime( const uint32_t frames ) { _dwellTime = frames; }
+
+        /** @return the minimum number of frames of an assignment. @version 1.8*/
+        uint32_t getDwellTime() const { return _dwellTime; }
+
+        /**
+         * Set the number of frames a moved resource needs to warm up its
+         * caches.
+         * @version 1.8
+         */
+        void setWarmup( const uint32_t frames ) { _warmup = frames; }
+
+        /** @return the number of warm-up frames. @version 1.8 */
+        uint32_t getWarmup() const { return _warmup; }
+
+        /**
+         * Set the minimum relative frame time gain of a reassignment.
+         * @version 1.8
+         */
+        void setHysteresis( const float hysteresis )
+            { _hysteresis = hysteresis; }
+
+        /** @return the minimum relative gain of a reassignment. @version 1.8 */
+        float getHysteresis() const { return _hysteresis; }
+
+        /**
+         * Enable the joint assignment of fractional pipes to all views.
+         * @version 1.8
+         */
+        void setJoint( const bool joint ) { _joint = joint; }
+
+        /** @return true if the joint assignment is used. @version 1.8 */
+        bool isJoint() const { return _joint; }
+
     protected:
         void notifyChildAdded( Compound*, Compound* ) override
             { LBASSERT( _listeners.empty( )); }
@@ -119,14 +170,39 @@ namespace server
         /** The total number of available resources. */
         size_t _nPipes;
 
+        uint32_t _dwellTime;
+        uint32_t _warmup;
+        float _hysteresis;
+        bool _joint;
+
+        struct Assignment
+        {
+            Assignment() : start( 0 ), lastUsed( 0 ) {}
+            uint32_t start;    //!< frame the resource was activated
+            uint32_t lastUsed; //!< last frame the resource was used
+        };
+        typedef lunchbox::PtrHash< const Compound*, Assignment > Assignments;
+        /** Per-leaf usage history, for the migration cost. */
+        Assignments _assignments;
+
         /** Update channel load subscription. */
         void _updateListeners();
         /** Update resource count. */
         void _updateResources();
         /** Assign resources to children. */
         void _update( const uint32_t frameNumber );
+        /** Assign self, previous and new resources to each view in turn. */
+        void _assignGreedy( Loads& loads, const float resourceTime );
+        /** Assign fractional resources to all views at once. */
+        void _assignJoint( Loads& loads );
         /** Find the frame number to use for update. */
         uint32_t _findInputFrameNumber() const;
+        /** @return true if the gain of the new usage outweighs migration. */
+        bool _useNewAssignment( const uint32_t frameNumber, const Loads& loads,
+                                const std::vector< float >& oldUsages,
+                                const float resourceTime ) const;
+        /** Update the usage history after an assignment. */
+        void _updateAssignments( const uint32_t frameNumber );
     };
     std::ostream& operator << ( std::ostream& os,
                                 const ViewEqualizer::Listener& listener );
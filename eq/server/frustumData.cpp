@@ -19,6 +19,7 @@
 
 #include <eq/fabric/projection.h>
 #include <eq/fabric/wall.h>
+#include <lunchbox/atomic.h>
 
 #ifndef M_PI
 #  define M_PI 3.14159265358979323846264338327
@@ -29,16 +30,30 @@ namespace eq
 {
 namespace server
 {
+namespace
+{
+static lunchbox::a_int32_t _revisions;
+}
 
 FrustumData::FrustumData()
         : _width(0.f)
         , _height(0.f)
         , _type( Wall::TYPE_FIXED )
+        , _revision( 0 )
+{
+}
+
+void FrustumData::invalidate()
 {
+    _width = 0.f;
+    _height = 0.f;
+    _revision = ++_revisions;
 }
 
 void FrustumData::applyWall( const fabric::Wall& wall )
 {
+    _revision = ++_revisions;
+
     Vector3f u = wall.bottomRight - wall.bottomLeft;
     Vector3f v = wall.topLeft - wall.bottomLeft;
     Vector3f w = u.cross( v );
@@ -72,6 +87,7 @@ void FrustumData::applyWall( const fabric::Wall& wall )
 
 void FrustumData::applyProjection( const fabric::Projection& projection )
 {
+    _revision = ++_revisions;
     const float cosH = cosf( DEG2RAD( projection.hpr[0] ));
     const float sinH = sinf( DEG2RAD( projection.hpr[0] ));
     const float cosP = cosf( DEG2RAD( projection.hpr[1] ));
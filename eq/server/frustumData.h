@@ -39,7 +39,7 @@ namespace server
         EQSERVER_API FrustumData();
 
         bool isValid() const { return (_width!=0.f && _height!=0.f); }
-        void invalidate()    { _width = 0.f; _height = 0.f; }
+        EQSERVER_API void invalidate();
 
         /** @name Data Update. */
         //@{
@@ -63,6 +63,12 @@ namespace server
 
         /** @return the projection type. */
         fabric::Wall::Type getType() const { return _type; }
+
+        /**
+         * @return a number identifying the current data, unique for all
+         *         frustum data instances and updated on each change.
+         */
+        uint32_t getRevision() const { return _revision; }
         //@}
 
     private:
@@ -70,6 +76,7 @@ namespace server
         float _height;
         Matrix4f _xfm;
         fabric::Wall::Type _type;
+        uint32_t _revision;
     };
 
     std::ostream& operator << ( std::ostream& os, const FrustumData& ); 
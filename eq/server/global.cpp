@@ -67,6 +67,14 @@ void Global::_setupDefaults()
 
     _configFAttributes[Config::FATTR_EYE_BASE]         = 0.05f;
     _configIAttributes[Config::IATTR_ROBUSTNESS]       = fabric::AUTO;
+    _configIAttributes[Config::IATTR_TRACE_EVENTS]     = fabric::OFF;
+    _configIAttributes[Config::IATTR_STATISTICS_INTERVAL] = fabric::AUTO;
+    _configIAttributes[Config::IATTR_STATISTICS_BUDGET] = fabric::OFF;
+    _configIAttributes[Config::IATTR_METRICS_PORT] = fabric::OFF;
+    _configIAttributes[Config::IATTR_DORMANT_LAYOUTS] = fabric::OFF;
+    _configIAttributes[Config::IATTR_STATIC_FRAMES] = fabric::OFF;
+    _configIAttributes[Config::IATTR_GPU_PRIORITY] = 0;
+    _configIAttributes[Config::IATTR_GPU_WEIGHT] = fabric::AUTO;
 
     // node
     for( uint32_t i=0; i < Node::CATTR_ALL; ++i )
@@ -76,6 +84,8 @@ void Global::_setupDefaults()
 
     _nodeIAttributes[Node::IATTR_LAUNCH_TIMEOUT] = 60000; // ms
     _nodeIAttributes[Node::IATTR_HINT_AFFINITY] = fabric::AUTO;
+    _nodeIAttributes[Node::IATTR_HINT_TRANSMIT_THREADS] = fabric::AUTO;
+    _nodeIAttributes[Node::IATTR_HINT_STANDBY] = fabric::OFF;
     _nodeSAttributes[Node::SATTR_LAUNCH_COMMAND] =
         "ssh -n %h %c --eq-logfile %q%d/%h.%n.log%q";
 #ifdef WIN32
@@ -91,6 +101,7 @@ void Global::_setupDefaults()
     _pipeIAttributes[Pipe::IATTR_HINT_THREAD] = fabric::ON;
     _pipeIAttributes[Pipe::IATTR_HINT_CUDA_GL_INTEROP] = fabric::OFF;
     _pipeIAttributes[Pipe::IATTR_HINT_AFFINITY] = fabric::AUTO;
+    _pipeIAttributes[Pipe::IATTR_HINT_PARALLEL_INIT] = fabric::OFF;
 
     // window
     for( uint32_t i=0; i<WindowSettings::IATTR_ALL; ++i )
@@ -126,6 +137,14 @@ void Global::_setupDefaults()
     _channelIAttributes[Channel::IATTR_HINT_STATISTICS] = fabric::NICEST;
 #endif
     _channelIAttributes[Channel::IATTR_HINT_SENDTOKEN] = fabric::OFF;
+    _channelIAttributes[Channel::IATTR_HINT_TRANSMIT_ROWS] = fabric::AUTO;
+    _channelIAttributes[Channel::IATTR_HINT_ASYNC_ASSEMBLY] = fabric::OFF;
+    _channelIAttributes[Channel::IATTR_HINT_REPROJECTION] = fabric::OFF;
+    _channelIAttributes[Channel::IATTR_HINT_MULTIVIEW] = fabric::OFF;
+    _channelIAttributes[Channel::IATTR_HINT_TILE_ATLAS] = fabric::OFF;
+    _channelIAttributes[Channel::IATTR_HINT_TEMPORAL_UPSAMPLING] = fabric::OFF;
+    _channelIAttributes[Channel::IATTR_HINT_TEMPORAL_TRANSMIT] = fabric::OFF;
+    _channelIAttributes[Channel::IATTR_HINT_TRANSMIT_DEADLINE] = fabric::OFF;
 
     // compound
     for( uint32_t i=0; i<Compound::IATTR_ALL; ++i )
@@ -0,0 +1,156 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "gpuScheduler.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace eq
+{
+namespace server
+{
+namespace
+{
+/** The period of the shared GPU time, in ms. */
+const int64_t _period = 1000;
+
+/** Configs without a frame start in this time don't compete, in ms. */
+const int64_t _idleTime = 1000;
+
+/** The growth of a config's demand over its measured use. */
+const float _headroom = 1.25f;
+
+struct Demand
+{
+    const Config* config;
+    int32_t priority;
+    float weight;
+    float demand; //!< ms per period
+};
+
+/** Highest priority first, then the smallest demand per weight. */
+bool _lessDemand( const Demand& a, const Demand& b )
+{
+    if( a.priority != b.priority )
+        return a.priority > b.priority;
+    return a.demand * b.weight < b.demand * a.weight;
+}
+}
+
+float GPUScheduler::startFrame( const Config* config,
+                                const DrawTimes& drawTimes,
+                                const int32_t priority, const float weight,
+                                const int64_t time )
+{
+    Usage& usage = _usages[ config ];
+    usage.starts.push_back( time );
+    while( usage.starts.front() <= time - _period )
+        usage.starts.pop_front();
+    usage.drawTimes = drawTimes;
+    usage.priority = priority;
+    usage.weight = std::max( weight, std::numeric_limits< float >::epsilon( ));
+
+    float limit = std::numeric_limits< float >::max();
+    for( DrawTimes::const_iterator i = drawTimes.begin();
+         i != drawTimes.end(); ++i )
+    {
+        if( i->second <= 0 )
+            continue;
+
+        const float share = _getShare( config, i->first, time );
+        if( share < std::numeric_limits< float >::max( ))
+            limit = std::min( limit, share / float( i->second ) *
+                                     1000.f / float( _period ));
+    }
+    return limit;
+}
+
+float GPUScheduler::getGPUTime( const Config* config ) const
+{
+    Usages::const_iterator i = _usages.find( config );
+    if( i == _usages.end( ))
+        return 0.f;
+
+    const Usage& usage = i->second;
+    int64_t drawTime = 0;
+    for( DrawTimes::const_iterator j = usage.drawTimes.begin();
+         j != usage.drawTimes.end(); ++j )
+    {
+        drawTime += j->second;
+    }
+    return float( drawTime * int64_t( usage.starts.size( ))) * 1000.f /
+           float( _period );
+}
+
+void GPUScheduler::remove( const Config* config )
+{
+    _usages.erase( config );
+}
+
+float GPUScheduler::_getShare( const Config* config, const std::string& gpu,
+                               const int64_t time ) const
+{
+    std::vector< Demand > demands;
+    for( Usages::const_iterator i = _usages.begin(); i != _usages.end(); ++i )
+    {
+        const Usage& usage = i->second;
+        DrawTimes::const_iterator j = usage.drawTimes.find( gpu );
+        if( j == usage.drawTimes.end() || j->second <= 0 ||
+            usage.starts.back() <= time - _idleTime )
+        {
+            continue;
+        }
+
+        const float drawTime = float( j->second );
+        const float used = drawTime * float( usage.starts.size( ));
+        const Demand demand = { i->first, usage.priority, usage.weight,
+                                std::max( used * _headroom, drawTime ) };
+        demands.push_back( demand );
+    }
+
+    if( demands.size() < 2 ) // not shared
+        return std::numeric_limits< float >::max();
+
+    std::sort( demands.begin(), demands.end(), _lessDemand );
+
+    float remaining = float( _period );
+    std::vector< Demand >::const_iterator i = demands.begin();
+    while( i != demands.end( ))
+    {
+        // configs of one priority, the lower priorities get the rest
+        std::vector< Demand >::const_iterator end = i;
+        float weights = 0.f;
+        for( ; end != demands.end() && end->priority == i->priority; ++end )
+            weights += end->weight;
+
+        for( ; i != end; ++i )
+        {
+            const float share = remaining * i->weight / weights;
+            if( i->config == config )
+                return share;
+
+            const float used = std::min( i->demand, share );
+            remaining -= used;
+            weights -= i->weight;
+        }
+    }
+    return 0.f;
+}
+
+}
+}
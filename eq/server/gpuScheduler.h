@@ -0,0 +1,88 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQSERVER_GPUSCHEDULER_H
+#define EQSERVER_GPUSCHEDULER_H
+
+#include "types.h"
+
+#include <boost/noncopyable.hpp>
+#include <deque>
+#include <map>
+#include <string>
+
+namespace eq
+{
+namespace server
+{
+/**
+ * Shares the GPUs used by several running configs of a server.
+ *
+ * Configs using the same GPU, identified by the host, port and device of a
+ * pipe, compete for its time when they started a frame recently. Each config
+ * needs the draw time of its last finished frame per frame. The GPU time of a
+ * period is distributed by descending config priority, and within the same
+ * priority in weighted max-min fair shares: configs using less than their
+ * share keep their use, the others split the remaining time. The share of a
+ * config on its most contended GPU limits its frame rate. A config which stops
+ * starting frames no longer competes, and its time is given to the others.
+ * Not thread safe, all methods are called from the server thread.
+ */
+class GPUScheduler : public boost::noncopyable
+{
+public:
+    /** The draw time of a frame per GPU in ms. */
+    typedef std::map< std::string, int64_t > DrawTimes;
+
+    GPUScheduler() {}
+
+    /**
+     * Record the start of a frame and compute the frame rate limit.
+     *
+     * @param config the config starting the frame.
+     * @param drawTimes the draw times of the last finished frame.
+     * @param priority the priority of the config, higher is served first.
+     * @param weight the share of the config within its priority.
+     * @param time the server time of the frame start.
+     * @return the maximum frame rate of the config.
+     */
+    float startFrame( const Config* config, const DrawTimes& drawTimes,
+                      int32_t priority, float weight, int64_t time );
+
+    /** @return the GPU time used by the config in ms per second. */
+    float getGPUTime( const Config* config ) const;
+
+    /** Forget a config which stopped rendering. */
+    void remove( const Config* config );
+
+private:
+    struct Usage
+    {
+        std::deque< int64_t > starts; //!< frame starts of the last period
+        DrawTimes drawTimes;
+        int32_t priority;
+        float weight;
+    };
+    typedef std::map< const Config*, Usage > Usages;
+    Usages _usages;
+
+    float _getShare( const Config* config, const std::string& gpu,
+                     int64_t time ) const;
+};
+}
+}
+
+#endif // EQSERVER_GPUSCHEDULER_H
@@ -53,7 +53,8 @@ void Layout::postDelete()
 void Layout::trigger( const Canvas* canvas, const bool active )
 {
     LBASSERT( canvas );
-    getConfig()->postNeedsFinish();
+    if( !canvas->isWarm( )) // resources of warm canvases are kept running
+        getConfig()->postNeedsFinish();
 
     const Views& views = getViews();
     for( Views::const_iterator i = views.begin(); i != views.end(); ++i )
@@ -63,6 +64,17 @@ void Layout::trigger( const Canvas* canvas, const bool active )
     }
 }
 
+void Layout::warm( const Canvas* canvas, const bool warm )
+{
+    LBASSERT( canvas );
+    const Views& views = getViews();
+    for( Views::const_iterator i = views.begin(); i != views.end(); ++i )
+    {
+        View* view = *i;
+        view->warm( canvas, warm );
+    }
+}
+
 }
 }
 
@@ -62,6 +62,14 @@ public:
      */
     void trigger( const Canvas* canvas, const bool active );
 
+    /**
+     * Keep the layout initialized while it is not active on the canvas.
+     *
+     * @param canvas The canvas using this layout.
+     * @param warm true to warm up, false to cool down.
+     */
+    void warm( const Canvas* canvas, const bool warm );
+
     /** Schedule deletion of this layout. */
     void postDelete();
     //@}
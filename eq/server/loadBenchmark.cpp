@@ -0,0 +1,512 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "loadBenchmark.h"
+
+#include "canvas.h"
+#include "channel.h"
+#include "compound.h"
+#include "compoundUpdateActivateVisitor.h"
+#include "compoundUpdateDataVisitor.h"
+#include "compoundVisitor.h"
+#include "config.h"
+#include "log.h"
+#include "node.h"
+#include "observer.h"
+#include "pipe.h"
+#include "window.h"
+
+#include <lunchbox/clock.h>
+#include <cmath>
+
+namespace eq
+{
+namespace server
+{
+namespace
+{
+/** Base time of a frame, frames never overlap in the synthetic timeline. */
+static const int64_t _frameTime = 1000000;
+
+class TaskVisitor : public CompoundVisitor
+{
+public:
+    TaskVisitor() {}
+
+    VisitorResult visitLeaf( Compound* compound ) override
+    {
+        Channel* channel = compound->getChannel();
+        if( channel && compound->isActive() &&
+            compound->testInheritTask( fabric::TASK_DRAW ))
+        {
+            compounds.push_back( compound );
+        }
+        return TRAVERSE_CONTINUE;
+    }
+
+    Compounds compounds;
+};
+
+/** @return the part of a normal distribution within [begin, end]. */
+float _getNormal( const float begin, const float end, const float center,
+                  const float sigma )
+{
+    const float scale = 1.f / ( sigma * std::sqrt( 2.f ));
+    return .5f * ( std::erf(( end - center ) * scale ) -
+                   std::erf(( begin - center ) * scale ));
+}
+
+/** @return the time spent rendering in the given statistics. */
+int64_t _getTime( const Statistics& statistics )
+{
+    int64_t time = 0;
+    for( Statistics::const_iterator i = statistics.begin();
+         i != statistics.end(); ++i )
+    {
+        switch( i->type )
+        {
+        case Statistic::CHANNEL_CLEAR:
+        case Statistic::CHANNEL_DRAW:
+        case Statistic::CHANNEL_READBACK:
+        case Statistic::CHANNEL_ASSEMBLE:
+            time += i->endTime - i->startTime;
+            break;
+        default:
+            break;
+        }
+    }
+    return time;
+}
+
+/** @return the slowest time over the mean time of all samples. */
+float _getImbalance( const LoadTrace::Samples& samples )
+{
+    int64_t sum = 0;
+    int64_t max = 0;
+    size_t nTimes = 0;
+    for( LoadTrace::Samples::const_iterator i = samples.begin();
+         i != samples.end(); ++i )
+    {
+        const int64_t time = _getTime( i->statistics );
+        if( time <= 0 )
+            continue;
+        sum += time;
+        max = LB_MAX( max, time );
+        ++nTimes;
+    }
+    if( sum == 0 )
+        return 1.f;
+    return float( max ) * float( nTimes ) / float( sum );
+}
+}
+
+LoadBenchmark::LoadBenchmark( Config* config )
+    : _config( config )
+    , _replayPos( 0 )
+    , _latency( LB_UNDEFINED_UINT32 )
+    , _recorder( 0 )
+    , _running( false )
+    , _frameNumber( 0 )
+    , _seed( 42 )
+{
+    LBASSERT( config );
+}
+
+LoadBenchmark::~LoadBenchmark()
+{
+    if( _running )
+        exit();
+}
+
+void LoadBenchmark::setModel( const Model& model )
+{
+    _model = model;
+}
+
+void LoadBenchmark::setReplay( const LoadTrace::Frames& frames )
+{
+    _replay = frames;
+    _replayPos = 0;
+}
+
+void LoadBenchmark::setLatency( const uint32_t latency )
+{
+    _latency = latency;
+}
+
+void LoadBenchmark::setRecorder( LoadTrace* recorder )
+{
+    _recorder = recorder;
+}
+
+bool LoadBenchmark::init()
+{
+    LBASSERT( !_running );
+    if( _config->getCompounds().empty( ))
+    {
+        LBWARN << "Config has no compounds" << std::endl;
+        return false;
+    }
+
+    if( _latency == LB_UNDEFINED_UINT32 )
+        _latency = _config->getLatency();
+
+    _channels.clear();
+    const Nodes& nodes = _config->getNodes();
+    for( NodesCIter i = nodes.begin(); i != nodes.end(); ++i )
+    {
+        const Pipes& pipes = (*i)->getPipes();
+        for( PipesCIter j = pipes.begin(); j != pipes.end(); ++j )
+        {
+            const Windows& windows = (*j)->getWindows();
+            for( WindowsCIter k = windows.begin(); k != windows.end(); ++k )
+            {
+                const Channels& channels = (*k)->getChannels();
+                _channels.insert( _channels.end(), channels.begin(),
+                                  channels.end( ));
+            }
+        }
+    }
+
+    // same sequence as Config::_init, without render clients
+    const Compounds& compounds = _config->getCompounds();
+    for( CompoundsCIter i = compounds.begin(); i != compounds.end(); ++i )
+        (*i)->init();
+
+    const Observers& observers = _config->getObservers();
+    for( ObserversCIter i = observers.begin(); i != observers.end(); ++i )
+        (*i)->init();
+
+    const Canvases& canvases = _config->getCanvases();
+    for( CanvasesCIter i = canvases.begin(); i != canvases.end(); ++i )
+        (*i)->init();
+
+    for( ChannelsCIter i = _channels.begin(); i != _channels.end(); ++i )
+        (*i)->setState( STATE_RUNNING );
+
+    for( CompoundsCIter i = compounds.begin(); i != compounds.end(); ++i )
+    {
+        CompoundUpdateActivateVisitor activateVisitor( 0 );
+        (*i)->accept( activateVisitor );
+    }
+
+    _frameNumber = 0;
+    _replayPos = 0;
+    _lastTasks.clear();
+    _pending.clear();
+    _running = true;
+    return true;
+}
+
+void LoadBenchmark::exit()
+{
+    LBASSERT( _running );
+    const Canvases& canvases = _config->getCanvases();
+    for( CanvasesCIter i = canvases.begin(); i != canvases.end(); ++i )
+        (*i)->exit();
+
+    const Compounds& compounds = _config->getCompounds();
+    for( CompoundsCIter i = compounds.begin(); i != compounds.end(); ++i )
+        (*i)->exit();
+
+    for( ChannelsCIter i = _channels.begin(); i != _channels.end(); ++i )
+        (*i)->setState( STATE_STOPPED );
+
+    _pending.clear();
+    _running = false;
+}
+
+LoadBenchmark::Result LoadBenchmark::step()
+{
+    LBASSERT( _running );
+    const LoadTrace::Frame* replay = 0;
+    while( _replayPos < _replay.size() && !replay )
+    {
+        replay = &_replay[ _replayPos++ ];
+        if( replay->frameNumber == 0 ) // load data before the first frame
+        {
+            _deliver( replay->samples );
+            replay = 0;
+        }
+    }
+
+    Result result;
+    _frameNumber = replay ? replay->frameNumber : _frameNumber + 1;
+    result.frameNumber = _frameNumber;
+
+    // update: activation and data visitors of Compound::update, the output
+    // and input frames need registered objects and are not benchmarked
+    lunchbox::Clock clock;
+    const Compounds& compounds = _config->getCompounds();
+    for( CompoundsCIter i = compounds.begin(); i != compounds.end(); ++i )
+    {
+        CompoundUpdateActivateVisitor activateVisitor( _frameNumber );
+        (*i)->accept( activateVisitor );
+
+        CompoundUpdateDataVisitor dataVisitor( _frameNumber );
+        (*i)->accept( dataVisitor );
+    }
+    result.updateTime = clock.getTimef();
+
+    const Tasks tasks = _getTasks();
+    result.nTasks = tasks.size();
+    if( _recorder || replay )
+    {
+        const LoadTrace::Tasks assignment = LoadTrace::getTasks( compounds );
+        if( _recorder )
+            _recorder->addFrame( _frameNumber, assignment );
+        if( replay )
+            result.assignmentError = _getAssignmentError( assignment,
+                                                          replay->tasks );
+    }
+
+    // split change against the last frame
+    TaskMap taskMap;
+    for( Tasks::const_iterator i = tasks.begin(); i != tasks.end(); ++i )
+    {
+        const Task& task = *i;
+        taskMap[ task.compound ] = task;
+
+        TaskMap::const_iterator j = _lastTasks.find( task.compound );
+        if( j == _lastTasks.end( ))
+            continue;
+
+        const Task& last = j->second;
+        result.splitChange += std::abs( task.vp.x - last.vp.x ) +
+                              std::abs( task.vp.y - last.vp.y ) +
+                              std::abs( task.vp.w - last.vp.w ) +
+                              std::abs( task.vp.h - last.vp.h ) +
+                              std::abs( task.range.start - last.range.start ) +
+                              std::abs( task.range.end - last.range.end );
+    }
+    _lastTasks.swap( taskMap );
+
+    if( replay )
+    {
+        // recorded order, the latency is part of the recording
+        result.imbalance = _getImbalance( replay->samples );
+        clock.reset();
+        _deliver( replay->samples );
+    }
+    else
+    {
+        // load data of this frame, delivered after the config latency
+        _pending.push_back( FrameSamples( _frameNumber,
+                                          LoadTrace::Samples( )));
+        result.imbalance = _generate( tasks, _pending.back().second );
+
+        clock.reset();
+        while( !_pending.empty() &&
+               _pending.front().first + _latency <= _frameNumber )
+        {
+            _deliver( _pending.front().second );
+            _pending.pop_front();
+        }
+    }
+    result.loadTime = clock.getTimef();
+    return result;
+}
+
+bool LoadBenchmark::isReplayDone() const
+{
+    return _replayPos >= _replay.size();
+}
+
+LoadBenchmark::Tasks LoadBenchmark::_getTasks()
+{
+    TaskVisitor visitor;
+    const Compounds& compounds = _config->getCompounds();
+    for( CompoundsCIter i = compounds.begin(); i != compounds.end(); ++i )
+        (*i)->accept( visitor );
+
+    Tasks tasks;
+    for( CompoundsCIter i = visitor.compounds.begin();
+         i != visitor.compounds.end(); ++i )
+    {
+        Compound* compound = *i;
+        Task task;
+        task.channel = compound->getChannel();
+        task.compound = compound;
+        task.vp = compound->getInheritViewport();
+        task.range = compound->getInheritRange();
+        tasks.push_back( task );
+    }
+    return tasks;
+}
+
+float LoadBenchmark::_getCost( const Task& task ) const
+{
+    const Viewport& vp = task.vp;
+    float fraction = vp.w * vp.h;
+
+    if( _model.hotspot > 0.f )
+    {
+        // gaussian hotspot circling around the center of the destination
+        const float angle = _model.hotspotSpeed * float( _frameNumber );
+        const float x = .5f + .25f * std::cos( angle );
+        const float y = .5f + .25f * std::sin( angle );
+        const float sigma = LB_MAX( _model.hotspotRadius, .01f );
+        const float total = _getNormal( 0.f, 1.f, x, sigma ) *
+                            _getNormal( 0.f, 1.f, y, sigma );
+        const float part = _getNormal( vp.x, vp.x + vp.w, x, sigma ) *
+                           _getNormal( vp.y, vp.y + vp.h, y, sigma );
+
+        fraction = ( 1.f - _model.hotspot ) * fraction +
+                   _model.hotspot * part / total;
+    }
+
+    fraction *= task.range.end - task.range.start;
+    return _model.frameTime * fraction / _getSpeed( task.channel );
+}
+
+float LoadBenchmark::_getSpeed( const Channel* channel ) const
+{
+    for( size_t i = 0; i < _channels.size() && i < _model.speeds.size(); ++i )
+    {
+        if( _channels[i] == channel )
+            return LB_MAX( _model.speeds[i], .001f );
+    }
+    return 1.f;
+}
+
+float LoadBenchmark::_random()
+{
+    _seed = _seed * 1103515245u + 12345u; // deterministic between runs
+    return float(( _seed >> 8 ) & 0xffffu ) / float( 0xffffu );
+}
+
+float LoadBenchmark::_generate( const Tasks& tasks,
+                                LoadTrace::Samples& samples )
+{
+    typedef std::map< Channel*, Statistics > StatisticsMap;
+    typedef std::map< Channel*, int64_t > TimeMap;
+    StatisticsMap statistics;
+    TimeMap times;
+    const int64_t base = int64_t( _frameNumber ) * _frameTime;
+
+    for( Tasks::const_iterator i = tasks.begin(); i != tasks.end(); ++i )
+    {
+        const Task& task = *i;
+        float cost = _getCost( task );
+        if( _model.noise > 0.f )
+            cost *= 1.f + _model.noise * ( 2.f * _random() - 1.f );
+
+        int64_t& time = times[ task.channel ];
+        Statistic stat = Statistic();
+        stat.type = Statistic::CHANNEL_DRAW;
+        stat.frameNumber = _frameNumber;
+        stat.task = task.compound->getTaskID();
+        stat.startTime = base + time;
+        stat.endTime = stat.startTime + LB_MAX( int64_t( cost + .5f ), 1 );
+        time += stat.endTime - stat.startTime;
+        statistics[ task.channel ].push_back( stat );
+    }
+
+    if( _model.assembleTime > 0.f )
+    {
+        for( Tasks::const_iterator i = tasks.begin(); i != tasks.end(); ++i )
+        {
+            const Compound* dest = i->compound->getParent();
+            if( !dest || !dest->getChannel() ||
+                dest->getChannel() == i->channel )
+            {
+                continue;
+            }
+
+            Channel* channel = dest->getChannel();
+            int64_t& time = times[ channel ];
+            Statistic stat = Statistic();
+            stat.type = Statistic::CHANNEL_ASSEMBLE;
+            stat.frameNumber = _frameNumber;
+            stat.task = dest->getTaskID();
+            stat.startTime = base + time;
+            stat.endTime = stat.startTime +
+                           LB_MAX( int64_t( _model.assembleTime + .5f ), 1 );
+            time += stat.endTime - stat.startTime;
+            statistics[ channel ].push_back( stat );
+        }
+    }
+
+    for( StatisticsMap::const_iterator i = statistics.begin();
+         i != statistics.end(); ++i )
+    {
+        LoadTrace::Sample sample;
+        sample.frameNumber = _frameNumber;
+        sample.channel = i->first->getName();
+        sample.region = Viewport::FULL;
+        sample.statistics = i->second;
+        samples.push_back( sample );
+    }
+    return _getImbalance( samples );
+}
+
+float LoadBenchmark::_getAssignmentError( const LoadTrace::Tasks& tasks,
+                                          const LoadTrace::Tasks& recorded )
+{
+    float error = 0.f;
+    for( LoadTrace::Tasks::const_iterator i = recorded.begin();
+         i != recorded.end(); ++i )
+    {
+        LoadTrace::Tasks::const_iterator j = tasks.begin();
+        for( ; j != tasks.end(); ++j )
+            if( j->taskID == i->taskID && j->channel == i->channel )
+                break;
+
+        if( j == tasks.end( )) // task missing, count its full size
+        {
+            error += i->vp.w + i->vp.h + i->range.getSize();
+            continue;
+        }
+
+        error += std::abs( j->vp.x - i->vp.x ) + std::abs( j->vp.y - i->vp.y ) +
+                 std::abs( j->vp.w - i->vp.w ) + std::abs( j->vp.h - i->vp.h ) +
+                 std::abs( j->range.start - i->range.start ) +
+                 std::abs( j->range.end - i->range.end );
+    }
+    if( tasks.size() > recorded.size( ))
+        error += float( tasks.size() - recorded.size( ));
+    return error;
+}
+
+void LoadBenchmark::_deliver( const LoadTrace::Samples& samples )
+{
+    for( LoadTrace::Samples::const_iterator i = samples.begin();
+         i != samples.end(); ++i )
+    {
+        Channel* channel = _findChannel( i->channel );
+        if( !channel )
+            continue;
+
+        channel->fireLoadData( i->frameNumber, i->statistics, i->region );
+        if( _recorder )
+            _recorder->add( *i );
+    }
+}
+
+Channel* LoadBenchmark::_findChannel( const std::string& name )
+{
+    for( ChannelsCIter i = _channels.begin(); i != _channels.end(); ++i )
+    {
+        if( (*i)->getName() == name )
+            return *i;
+    }
+    LBWARN << "Unknown channel " << name << " in load data" << std::endl;
+    return 0;
+}
+
+}
+}
@@ -0,0 +1,159 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQSERVER_LOADBENCHMARK_H
+#define EQSERVER_LOADBENCHMARK_H
+
+#include <eq/server/api.h>
+#include <eq/server/loadTrace.h> // Samples member
+#include <eq/server/types.h>
+
+#include <boost/noncopyable.hpp>
+#include <deque>
+#include <map>
+
+namespace eq
+{
+namespace server
+{
+/**
+ * Runs the equalizers of a loaded config without render clients.
+ *
+ * The benchmark initializes the compounds of the config as Config::init does
+ * and marks all channels running. Each step() updates the compounds of one
+ * frame, which runs the equalizers, and feeds load data to the channel
+ * listeners. The load data is either generated by a cost model from the
+ * current task decomposition, or replayed from a LoadTrace recorded with the
+ * same config.
+ *
+ * The synthetic cost model distributes a fixed frame time over the viewport
+ * and range of the destination. A hotspot concentrates part of the cost on a
+ * moving region, and each channel renders at its own speed. Load data is
+ * delivered with the latency of the config.
+ *
+ * A replay runs the recorded frames and delivers the recorded load data in
+ * the recorded order, independent of the latency. It compares the resulting
+ * task assignments with the recorded ones, which are identical unless the
+ * equalizers changed.
+ *
+ * Not thread safe, the config must not be running.
+ */
+class LoadBenchmark : public boost::noncopyable
+{
+public:
+    /** The synthetic cost model. */
+    struct Model
+    {
+        Model() : frameTime( 100.f ), assembleTime( 0.f ), hotspot( 0.f )
+                , hotspotRadius( .2f ), hotspotSpeed( 0.f ), noise( 0.f ) {}
+
+        float frameTime; //!< the time to render everything at speed 1 (ms)
+        float assembleTime; //!< the time to assemble one input frame (ms)
+        float hotspot; //!< the fraction of the cost in the hotspot [0,1]
+        float hotspotRadius; //!< the radius of the hotspot (normalized)
+        float hotspotSpeed; //!< the hotspot movement in radians per frame
+        float noise; //!< the relative random variation of each task time
+        std::vector< float > speeds; //!< per-channel speed, in config order
+    };
+
+    /** The measurements of one frame. */
+    struct Result
+    {
+        Result() : frameNumber( 0 ), updateTime( 0.f ), loadTime( 0.f )
+                 , imbalance( 1.f ), splitChange( 0.f )
+                 , assignmentError( 0.f ), nTasks( 0 ) {}
+
+        uint32_t frameNumber;
+        float updateTime; //!< CPU time of the compound update (ms)
+        float loadTime; //!< CPU time of the load data notification (ms)
+        float imbalance; //!< slowest channel time over mean channel time
+        float splitChange; //!< sum of the task viewport and range changes
+        /** sum of the differences to the recorded tasks of a replay */
+        float assignmentError;
+        size_t nTasks; //!< the number of draw tasks
+    };
+
+    /** Construct a new benchmark for the given, not running config. */
+    EQSERVER_API explicit LoadBenchmark( Config* config );
+
+    /** Destruct the benchmark, exiting it if needed. */
+    EQSERVER_API ~LoadBenchmark();
+
+    /** Set the cost model for synthetic load data. */
+    EQSERVER_API void setModel( const Model& model );
+
+    /** Replay the given frames instead of using the cost model. */
+    EQSERVER_API void setReplay( const LoadTrace::Frames& frames );
+
+    /** Override the latency of the config for delivering load data. */
+    EQSERVER_API void setLatency( uint32_t latency );
+
+    /** Record the load data passed to the equalizers, may be 0. */
+    EQSERVER_API void setRecorder( LoadTrace* recorder );
+
+    /** Initialize the compounds and channels. @return true on success. */
+    EQSERVER_API bool init();
+
+    /** Run one frame. @return the measurements of the frame. */
+    EQSERVER_API Result step();
+
+    /** @return true if all frames of the replay have been run. */
+    EQSERVER_API bool isReplayDone() const;
+
+    /** De-initialize the compounds and channels. */
+    EQSERVER_API void exit();
+
+private:
+    struct Task
+    {
+        Channel* channel;
+        Compound* compound;
+        Viewport vp;
+        Range range;
+    };
+    typedef std::vector< Task > Tasks;
+    typedef std::map< const Compound*, Task > TaskMap;
+    typedef std::pair< uint32_t, LoadTrace::Samples > FrameSamples;
+
+    Config* const _config;
+    Model _model;
+    LoadTrace::Frames _replay;
+    size_t _replayPos; //!< the next frame of the replay
+    uint32_t _latency;
+    LoadTrace* _recorder;
+    bool _running;
+
+    uint32_t _frameNumber;
+    uint32_t _seed;
+    Channels _channels;
+    TaskMap _lastTasks;
+    std::deque< FrameSamples > _pending;
+
+    Tasks _getTasks();
+    float _getCost( const Task& task ) const;
+    float _getSpeed( const Channel* channel ) const;
+    float _random();
+    float _generate( const Tasks& tasks, LoadTrace::Samples& samples );
+    static float _getAssignmentError( const LoadTrace::Tasks& tasks,
+                                      const LoadTrace::Tasks& recorded );
+    void _deliver( const LoadTrace::Samples& samples );
+    Channel* _findChannel( const std::string& name );
+};
+}
+}
+
+#endif // EQSERVER_LOADBENCHMARK_H
@@ -0,0 +1,353 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "loadTrace.h"
+
+#include "channel.h"
+#include "compound.h"
+#include "compoundVisitor.h"
+#include "log.h"
+
+#include <cstring>
+
+namespace eq
+{
+namespace server
+{
+namespace
+{
+static const char _magic[4] = { 'E', 'Q', 'L', 'T' };
+static const uint32_t _version = 1;
+
+/** The record types, each followed by its fields in native byte order. */
+enum RecordType
+{
+    RECORD_CHANNEL = 'C', //!< index, name
+    RECORD_FRAME = 'F', //!< frame, #tasks, { channel, task, vp, range }
+    RECORD_LOAD = 'L' //!< frame, channel, region, #stats, { type, task, time }
+};
+
+template< class T > void _write( std::ostream& os, const T& value )
+{
+    os.write( reinterpret_cast< const char* >( &value ), sizeof( T ));
+}
+
+template< class T > bool _read( std::istream& is, T& value )
+{
+    is.read( reinterpret_cast< char* >( &value ), sizeof( T ));
+    return is.good();
+}
+
+void _write( std::ostream& os, const std::string& value )
+{
+    _write( os, uint32_t( value.length( )));
+    os.write( value.data(), value.length( ));
+}
+
+bool _read( std::istream& is, std::string& value )
+{
+    uint32_t length = 0;
+    if( !_read( is, length ))
+        return false;
+    value.resize( length );
+    if( length > 0 )
+        is.read( &value[0], length );
+    return is.good();
+}
+
+void _write( std::ostream& os, const Viewport& vp )
+{
+    _write( os, vp.x );
+    _write( os, vp.y );
+    _write( os, vp.w );
+    _write( os, vp.h );
+}
+
+bool _read( std::istream& is, Viewport& vp )
+{
+    return _read( is, vp.x ) && _read( is, vp.y ) && _read( is, vp.w ) &&
+           _read( is, vp.h );
+}
+
+class TaskVisitor : public CompoundVisitor
+{
+public:
+    TaskVisitor() {}
+
+    VisitorResult visitLeaf( const Compound* compound ) override
+    {
+        const Channel* channel = compound->getChannel();
+        if( !channel || !compound->isActive() ||
+            !compound->testInheritTask( fabric::TASK_DRAW ))
+        {
+            return TRAVERSE_CONTINUE;
+        }
+
+        LoadTrace::Task task;
+        task.channel = channel->getName();
+        task.taskID = compound->getTaskID();
+        task.vp = compound->getInheritViewport();
+        task.range = compound->getInheritRange();
+        tasks.push_back( task );
+        return TRAVERSE_CONTINUE;
+    }
+
+    LoadTrace::Tasks tasks;
+};
+}
+
+LoadTrace::LoadTrace()
+{
+}
+
+LoadTrace::~LoadTrace()
+{
+    if( _file.is_open( ))
+        _file.close();
+}
+
+bool LoadTrace::open( const std::string& filename )
+{
+    _channels.clear();
+    _file.open( filename.c_str(), std::ios::out | std::ios::binary );
+    if( !_file.is_open( ))
+    {
+        LBWARN << "Can't open load trace " << filename << std::endl;
+        return false;
+    }
+    _file.write( _magic, sizeof( _magic ));
+    _write( _file, _version );
+    return true;
+}
+
+void LoadTrace::addFrame( const uint32_t frameNumber,
+                          const Compounds& compounds )
+{
+    if( _file.is_open( ))
+        addFrame( frameNumber, getTasks( compounds ));
+}
+
+void LoadTrace::addFrame( const uint32_t frameNumber, const Tasks& tasks )
+{
+    if( !_file.is_open( ))
+        return;
+
+    std::vector< uint32_t > channels( tasks.size( ));
+    for( size_t i = 0; i < tasks.size(); ++i )
+        channels[i] = _getChannel( tasks[i].channel );
+
+    _write( _file, uint8_t( RECORD_FRAME ));
+    _write( _file, frameNumber );
+    _write( _file, uint32_t( tasks.size( )));
+    for( size_t i = 0; i < tasks.size(); ++i )
+    {
+        const Task& task = tasks[i];
+        _write( _file, channels[i] );
+        _write( _file, task.taskID );
+        _write( _file, task.vp );
+        _write( _file, task.range.start );
+        _write( _file, task.range.end );
+    }
+}
+
+void LoadTrace::add( const Channel& channel, const uint32_t frameNumber,
+                     const Statistics& statistics, const Viewport& region )
+{
+    Sample sample;
+    sample.frameNumber = frameNumber;
+    sample.channel = channel.getName();
+    sample.region = region;
+    sample.statistics = statistics;
+    add( sample );
+}
+
+void LoadTrace::add( const Sample& sample )
+{
+    if( !_file.is_open( ))
+        return;
+
+    const uint32_t channel = _getChannel( sample.channel );
+    _write( _file, uint8_t( RECORD_LOAD ));
+    _write( _file, sample.frameNumber );
+    _write( _file, channel );
+    _write( _file, sample.region );
+    _write( _file, uint32_t( sample.statistics.size( )));
+
+    for( Statistics::const_iterator i = sample.statistics.begin();
+         i != sample.statistics.end(); ++i )
+    {
+        const Statistic& stat = *i;
+        _write( _file, uint8_t( stat.type ));
+        _write( _file, stat.task );
+        _write( _file, stat.startTime );
+        _write( _file, stat.endTime );
+    }
+}
+
+uint32_t LoadTrace::_getChannel( const std::string& name )
+{
+    ChannelMap::const_iterator i = _channels.find( name );
+    if( i != _channels.end( ))
+        return i->second;
+
+    const uint32_t index = uint32_t( _channels.size( ));
+    _channels[ name ] = index;
+    _write( _file, uint8_t( RECORD_CHANNEL ));
+    _write( _file, index );
+    _write( _file, name );
+    return index;
+}
+
+LoadTrace::Tasks LoadTrace::getTasks( const Compounds& compounds )
+{
+    TaskVisitor visitor;
+    for( CompoundsCIter i = compounds.begin(); i != compounds.end(); ++i )
+        static_cast< const Compound* >( *i )->accept( visitor );
+    return visitor.tasks;
+}
+
+bool LoadTrace::read( const std::string& filename, Frames& frames )
+{
+    std::ifstream file( filename.c_str(), std::ios::in | std::ios::binary );
+    if( !file.is_open( ))
+    {
+        LBWARN << "Can't open load trace " << filename << std::endl;
+        return false;
+    }
+
+    char magic[ sizeof( _magic ) ];
+    uint32_t version = 0;
+    file.read( magic, sizeof( magic ));
+    if( !file.good() || ::memcmp( magic, _magic, sizeof( magic )) != 0 ||
+        !_read( file, version ) || version != _version )
+    {
+        LBWARN << filename << " is not a load trace of version " << _version
+               << std::endl;
+        return false;
+    }
+
+    Strings channels;
+    uint8_t type = 0;
+    while( _read( file, type ))
+    {
+        bool ok = true;
+        switch( type )
+        {
+        case RECORD_CHANNEL:
+        {
+            uint32_t index = 0;
+            std::string name;
+            ok = _read( file, index ) && _read( file, name ) &&
+                 index == channels.size();
+            channels.push_back( name );
+            break;
+        }
+
+        case RECORD_FRAME:
+        {
+            frames.push_back( Frame( ));
+            Frame& frame = frames.back();
+            uint32_t nTasks = 0;
+            ok = _read( file, frame.frameNumber ) && _read( file, nTasks );
+            for( uint32_t i = 0; ok && i < nTasks; ++i )
+            {
+                Task task;
+                uint32_t channel = 0;
+                ok = _read( file, channel ) && channel < channels.size() &&
+                     _read( file, task.taskID ) && _read( file, task.vp ) &&
+                     _read( file, task.range.start ) &&
+                     _read( file, task.range.end );
+                if( ok )
+                    task.channel = channels[ channel ];
+                frame.tasks.push_back( task );
+            }
+            break;
+        }
+
+        case RECORD_LOAD:
+        {
+            if( frames.empty( )) // load data before the first recorded frame
+                frames.push_back( Frame( ));
+
+            Sample sample;
+            uint32_t channel = 0;
+            uint32_t nStatistics = 0;
+            ok = _read( file, sample.frameNumber ) &&
+                 _read( file, channel ) && channel < channels.size() &&
+                 _read( file, sample.region ) && _read( file, nStatistics );
+            for( uint32_t i = 0; ok && i < nStatistics; ++i )
+            {
+                Statistic stat = Statistic();
+                uint8_t statType = 0;
+                ok = _read( file, statType ) && statType > Statistic::NONE &&
+                     statType < Statistic::ALL && _read( file, stat.task ) &&
+                     _read( file, stat.startTime ) &&
+                     _read( file, stat.endTime );
+
+                stat.type = Statistic::Type( statType );
+                stat.frameNumber = sample.frameNumber;
+                sample.statistics.push_back( stat );
+            }
+            if( ok )
+                sample.channel = channels[ channel ];
+            frames.back().samples.push_back( sample );
+            break;
+        }
+
+        default:
+            ok = false;
+            break;
+        }
+
+        if( !ok )
+        {
+            LBWARN << "Malformed load trace " << filename << " at byte "
+                   << file.tellg() << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void LoadTrace::print( std::ostream& os, const Frames& frames )
+{
+    for( Frames::const_iterator i = frames.begin(); i != frames.end(); ++i )
+    {
+        const Frame& frame = *i;
+        os << "frame " << frame.frameNumber << std::endl;
+        for( Tasks::const_iterator j = frame.tasks.begin();
+             j != frame.tasks.end(); ++j )
+        {
+            os << "  task " << j->taskID << " \"" << j->channel << "\" "
+               << j->vp << " " << j->range << std::endl;
+        }
+        for( Samples::const_iterator j = frame.samples.begin();
+             j != frame.samples.end(); ++j )
+        {
+            os << "  load " << j->frameNumber << " \"" << j->channel << "\" "
+               << j->region << std::endl;
+            for( Statistics::const_iterator k = j->statistics.begin();
+                 k != j->statistics.end(); ++k )
+            {
+                os << "    " << *k << std::endl;
+            }
+        }
+    }
+}
+
+}
+}
@@ -0,0 +1,139 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQSERVER_LOADTRACE_H
+#define EQSERVER_LOADTRACE_H
+
+#include <eq/server/api.h>
+#include <eq/server/types.h>
+
+#include <eq/fabric/range.h>     // member
+#include <eq/fabric/statistic.h> // member
+#include <eq/fabric/viewport.h>  // member
+#include <boost/noncopyable.hpp>
+#include <fstream>               // member
+#include <iosfwd>
+#include <map>                    // member
+#include <vector>
+
+namespace eq
+{
+namespace server
+{
+/**
+ * Records and reads the task assignments and load data of the equalizers.
+ *
+ * A load trace is a compact binary log of the events seen by the equalizers,
+ * in the order the server saw them. A frame record holds the draw tasks
+ * assigned by the compound update of a frame start: the channel, the task
+ * identifier, the viewport and the range. A load record holds the statistics
+ * and region of interest of one channel and frame, as passed to
+ * ChannelListener::notifyLoadData. All load records following a frame record
+ * were received after that frame started, which makes the replay
+ * deterministic.
+ *
+ * The task identifiers are only valid for the config which recorded the trace.
+ * A config records its trace if EQ_LOAD_TRACE_FILE is set, and the
+ * LoadBenchmark replays it.
+ */
+class LoadTrace : public boost::noncopyable
+{
+public:
+    /** The assignment of one draw task. */
+    struct Task
+    {
+        Task() : taskID( 0 ) {}
+
+        std::string channel; //!< the name of the channel
+        uint32_t taskID;
+        Viewport vp;
+        Range range;
+    };
+    typedef std::vector< Task > Tasks;
+
+    /** The load data of one channel and frame. */
+    struct Sample
+    {
+        Sample() : frameNumber( 0 ) {}
+
+        uint32_t frameNumber;
+        std::string channel; //!< the name of the channel
+        Viewport region;
+        Statistics statistics;
+    };
+    typedef std::vector< Sample > Samples;
+
+    /** A frame start and the load data received until the next one. */
+    struct Frame
+    {
+        Frame() : frameNumber( 0 ) {}
+
+        uint32_t frameNumber;
+        Tasks tasks; //!< the draw tasks of the frame
+        Samples samples; //!< the load data received during the frame
+    };
+    typedef std::vector< Frame > Frames;
+
+    EQSERVER_API LoadTrace();
+    EQSERVER_API ~LoadTrace();
+
+    /** Open the given file for writing. @return true on success. */
+    EQSERVER_API bool open( const std::string& filename );
+
+    /** Write the draw tasks of the given compounds after a frame start. */
+    EQSERVER_API void addFrame( uint32_t frameNumber,
+                                const Compounds& compounds );
+
+    /** Write a frame start with the given draw tasks. */
+    EQSERVER_API void addFrame( uint32_t frameNumber, const Tasks& tasks );
+
+    /** Write the load data of one channel and frame. */
+    EQSERVER_API void add( const Channel& channel, uint32_t frameNumber,
+                           const Statistics& statistics,
+                           const Viewport& region );
+
+    /** Write one sample. */
+    EQSERVER_API void add( const Sample& sample );
+
+    /** @return the active draw tasks of the given compounds. */
+    EQSERVER_API static Tasks getTasks( const Compounds& compounds );
+
+    /**
+     * Read a load trace.
+     *
+     * @param filename the name of the trace file.
+     * @param frames returns the frames, in the order of the file.
+     * @return true on success, false if the file is missing or malformed.
+     */
+    EQSERVER_API static bool read( const std::string& filename,
+                                   Frames& frames );
+
+    /** Print the given frames in a human-readable form. */
+    EQSERVER_API static void print( std::ostream& os, const Frames& frames );
+
+private:
+    typedef std::map< std::string, uint32_t > ChannelMap;
+
+    std::ofstream _file;
+    ChannelMap _channels; //!< the indices of the channel names written
+
+    uint32_t _getChannel( const std::string& name );
+};
+}
+}
+
+#endif // EQSERVER_LOADTRACE_H
@@ -32,6 +32,8 @@
 
 #include <eq/fabric/elementVisitor.h>
 
+#include <set>
+
 namespace eq
 {
 namespace server
@@ -44,51 +46,38 @@ namespace
 class UnusedOutputChannelFinder : public ConfigVisitor
 {
 public:
-    UnusedOutputChannelFinder() : _candidate( 0 ) {}
-
     virtual VisitorResult visit( Channel* channel )
         {
-            if( _candidate ) // testing a candidate (see below)
-                return TRAVERSE_CONTINUE;
-
-            const View* view = channel->getView();
-            if( !view )
-                return TRAVERSE_CONTINUE;
-
-            // see if it is used as a destination channel
-            _candidate = channel;
-            Config* config = channel->getConfig();
-            config->accept( *this );
-
-            if( _candidate ) // survived - not a destination channel yet
-                _channels.push_back( _candidate );
-            _candidate = 0;
-
+            if( channel->getView( ))
+                _candidates.push_back( channel );
             return TRAVERSE_CONTINUE;
         };
 
     virtual VisitorResult visit( Compound* compound )
         {
-            if( !_candidate ) // not testing a candidate (see above)
-                return TRAVERSE_PRUNE;
-
-            const Channel* channel = compound->getChannel();
+            Channel* channel = compound->getChannel();
             if( !channel )
                 return TRAVERSE_CONTINUE;
 
-            if( _candidate == channel )
-            {
-                _candidate = 0; // channel already used
-                return TRAVERSE_TERMINATE;
-            }
+            _destinations.insert( channel );
             return TRAVERSE_PRUNE; // only check destination channels
         }
 
-    const Channels& getResult() const { return _channels; }
+    Channels getResult() const
+        {
+            Channels channels;
+            for( Channels::const_iterator i = _candidates.begin();
+                 i != _candidates.end(); ++i )
+            {
+                if( _destinations.find( *i ) == _destinations.end( ))
+                    channels.push_back( *i );
+            }
+            return channels;
+        }
 
 private:
-    Channel* _candidate;
-    Channels _channels;
+    Channels _candidates;
+    std::set< const Channel* > _destinations;
 };
 
 }
@@ -24,6 +24,7 @@
 #include "channel.h"
 #include "compound.h"
 #include "equalizers/dfrEqualizer.h"
+#include "equalizers/foveatedEqualizer.h"
 #include "equalizers/framerateEqualizer.h"
 #include "equalizers/loadEqualizer.h"
 #include "equalizers/treeEqualizer.h"
@@ -47,6 +48,7 @@
 #include <lunchbox/file.h>
 
 #include <locale.h>
+#include <map>
 #include <string>
 
 #pragma warning(disable: 4065)
@@ -71,9 +73,13 @@
         static eq::server::Observer*    observer = 0;
         static eq::server::Compound*    eqCompound = 0; // avoid name clash
         static eq::server::DFREqualizer* dfrEqualizer = 0;
+        static eq::server::FoveatedEqualizer* foveatedEqualizer = 0;
         static eq::server::LoadEqualizer* loadEqualizer = 0;
         static eq::server::TreeEqualizer* treeEqualizer = 0;
         static eq::server::TileEqualizer* tileEqualizer = 0;
+        static eq::server::ViewEqualizer* viewEqualizer = 0;
+        static eq::server::FramerateEqualizer* framerateEqualizer = 0;
+        static eq::server::MonitorEqualizer* monitorEqualizer = 0;
         static eq::server::SwapBarrierPtr swapBarrier;
         static eq::server::Frame*       frame = 0;
         static eq::server::TileQueue*   tileQueue = 0;
@@ -81,6 +87,20 @@
         static eq::fabric::Wall         wall;
         static eq::fabric::Projection   projection;
         static uint32_t                 flags = 0;
+
+        /** Named channels of the current config, first declaration wins. */
+        typedef std::map< std::string, eq::server::Channel* > ChannelMap;
+        static ChannelMap channels;
+
+        /** @return the channel of the given name in the current config. */
+        static eq::server::Channel* findChannel( const std::string& name )
+        {
+            ChannelMap::const_iterator i = channels.find( name );
+            if( i != channels.end( ))
+                return i->second;
+            // e.g., destination channels created by a canvas
+            return config->find< eq::server::Channel >( name );
+        }
     }
     }
 
@@ -102,7 +122,17 @@
 %token EQTOKEN_GLOBAL
 %token EQTOKEN_CHANNEL_IATTR_HINT_STATISTICS
 %token EQTOKEN_CHANNEL_IATTR_HINT_SENDTOKEN
+%token EQTOKEN_CHANNEL_IATTR_HINT_TRANSMIT_ROWS
+%token EQTOKEN_CHANNEL_IATTR_HINT_ASYNC_ASSEMBLY
+%token EQTOKEN_CHANNEL_IATTR_HINT_REPROJECTION
+%token EQTOKEN_CHANNEL_IATTR_HINT_MULTIVIEW
+%token EQTOKEN_CHANNEL_IATTR_HINT_TILE_ATLAS
+%token EQTOKEN_CHANNEL_IATTR_HINT_TEMPORAL_UPSAMPLING
+%token EQTOKEN_CHANNEL_IATTR_HINT_TEMPORAL_TRANSMIT
+%token EQTOKEN_CHANNEL_IATTR_HINT_TRANSMIT_DEADLINE
 %token EQTOKEN_CHANNEL_SATTR_DUMP_IMAGE
+%token EQTOKEN_CHANNEL_SATTR_SHARED_MEMORY
+%token EQTOKEN_CHANNEL_SATTR_PLAYBACK_IMAGES
 %token EQTOKEN_COMPOUND_IATTR_STEREO_MODE
 %token EQTOKEN_COMPOUND_IATTR_STEREO_ANAGLYPH_LEFT_MASK
 %token EQTOKEN_COMPOUND_IATTR_STEREO_ANAGLYPH_RIGHT_MASK
@@ -114,13 +144,24 @@
 %token EQTOKEN_CONNECTION_IATTR_PORT
 %token EQTOKEN_CONFIG_FATTR_EYE_BASE
 %token EQTOKEN_CONFIG_IATTR_ROBUSTNESS
+%token EQTOKEN_CONFIG_IATTR_TRACE_EVENTS
+%token EQTOKEN_CONFIG_IATTR_STATISTICS_INTERVAL
+%token EQTOKEN_CONFIG_IATTR_STATISTICS_BUDGET
+%token EQTOKEN_CONFIG_IATTR_METRICS_PORT
+%token EQTOKEN_CONFIG_IATTR_DORMANT_LAYOUTS
+%token EQTOKEN_CONFIG_IATTR_STATIC_FRAMES
+%token EQTOKEN_CONFIG_IATTR_GPU_PRIORITY
+%token EQTOKEN_CONFIG_IATTR_GPU_WEIGHT
 %token EQTOKEN_NODE_SATTR_LAUNCH_COMMAND
 %token EQTOKEN_NODE_CATTR_LAUNCH_COMMAND_QUOTE
 %token EQTOKEN_NODE_IATTR_THREAD_MODEL
 %token EQTOKEN_NODE_IATTR_HINT_AFFINITY
 %token EQTOKEN_NODE_IATTR_HINT_STATISTICS
 %token EQTOKEN_NODE_IATTR_LAUNCH_TIMEOUT
+%token EQTOKEN_NODE_IATTR_HINT_TRANSMIT_THREADS
+%token EQTOKEN_NODE_IATTR_HINT_STANDBY
 %token EQTOKEN_PIPE_IATTR_HINT_CUDA_GL_INTEROP
+%token EQTOKEN_PIPE_IATTR_HINT_PARALLEL_INIT
 %token EQTOKEN_PIPE_IATTR_HINT_THREAD
 %token EQTOKEN_PIPE_IATTR_HINT_AFFINITY
 %token EQTOKEN_VIEW_SATTR_DISPLAYCLUSTER
@@ -159,11 +200,22 @@
 %token EQTOKEN_HINT_DECORATION
 %token EQTOKEN_HINT_STATISTICS
 %token EQTOKEN_HINT_SENDTOKEN
+%token EQTOKEN_HINT_TRANSMIT_ROWS
+%token EQTOKEN_HINT_TRANSMIT_THREADS
+%token EQTOKEN_HINT_STANDBY
+%token EQTOKEN_HINT_ASYNC_ASSEMBLY
+%token EQTOKEN_HINT_REPROJECTION
+%token EQTOKEN_HINT_MULTIVIEW
+%token EQTOKEN_HINT_TILE_ATLAS
+%token EQTOKEN_HINT_TEMPORAL_UPSAMPLING
+%token EQTOKEN_HINT_TEMPORAL_TRANSMIT
+%token EQTOKEN_HINT_TRANSMIT_DEADLINE
 %token EQTOKEN_HINT_SWAPSYNC
 %token EQTOKEN_HINT_DRAWABLE
 %token EQTOKEN_HINT_THREAD
 %token EQTOKEN_HINT_AFFINITY
 %token EQTOKEN_HINT_CUDA_GL_INTEROP
+%token EQTOKEN_HINT_PARALLEL_INIT
 %token EQTOKEN_HINT_SCREENSAVER
 %token EQTOKEN_HINT_GRAB_POINTER
 %token EQTOKEN_PLANES_COLOR
@@ -178,6 +230,7 @@
 %token EQTOKEN_AUTO
 %token EQTOKEN_FASTEST
 %token EQTOKEN_NICEST
+%token EQTOKEN_HISTOGRAM
 %token EQTOKEN_QUAD
 %token EQTOKEN_ANAGLYPH
 %token EQTOKEN_PASSIVE
@@ -199,6 +252,7 @@
 %token EQTOKEN_COMPOUND
 %token EQTOKEN_LOADBALANCER
 %token EQTOKEN_DFREQUALIZER
+%token EQTOKEN_FOVEATEDEQUALIZER
 %token EQTOKEN_FRAMERATEEQUALIZER
 %token EQTOKEN_LOADEQUALIZER
 %token EQTOKEN_TREEEQUALIZER
@@ -215,6 +269,7 @@
 %token EQTOKEN_RDMA
 %token EQTOKEN_UDT
 %token EQTOKEN_TEXTURE
+%token EQTOKEN_DRAWABLE
 %token EQTOKEN_MEMORY
 %token EQTOKEN_FIXED
 %token EQTOKEN_RELATIVE_TO_ORIGIN
@@ -238,7 +293,16 @@
 %token EQTOKEN_FOCUS_MODE
 %token EQTOKEN_OPENCV_CAMERA
 %token EQTOKEN_VRPN_TRACKER
+%token EQTOKEN_LATCH_PORT
 %token EQTOKEN_ROBUSTNESS
+%token EQTOKEN_TRACE_EVENTS
+%token EQTOKEN_STATISTICS_INTERVAL
+%token EQTOKEN_STATISTICS_BUDGET
+%token EQTOKEN_METRICS_PORT
+%token EQTOKEN_DORMANT_LAYOUTS
+%token EQTOKEN_STATIC_FRAMES
+%token EQTOKEN_GPU_PRIORITY
+%token EQTOKEN_GPU_WEIGHT
 %token EQTOKEN_THREAD_MODEL
 %token EQTOKEN_ASYNC
 %token EQTOKEN_DRAW_SYNC
@@ -272,6 +336,8 @@
 %token EQTOKEN_HPR
 %token EQTOKEN_LATENCY
 %token EQTOKEN_SWAPBARRIER
+%token EQTOKEN_TIMED
+%token EQTOKEN_HARDWARE
 %token EQTOKEN_NVGROUP
 %token EQTOKEN_NVBARRIER
 %token EQTOKEN_OUTPUTFRAME
@@ -289,6 +355,24 @@
 %token EQTOKEN_MODE
 %token EQTOKEN_2D
 %token EQTOKEN_ASSEMBLE_ONLY_LIMIT
+%token EQTOKEN_PREDICTIVE
+%token EQTOKEN_NODE_DAMPING
+%token EQTOKEN_NODE_BOUNDARY
+%token EQTOKEN_NODE_RESISTANCE
+%token EQTOKEN_NODE_ALIGNED
+%token EQTOKEN_FRAME_TIME
+%token EQTOKEN_MIN_ZOOM
+%token EQTOKEN_MAX_ZOOM
+%token EQTOKEN_ZOOM_RATE
+%token EQTOKEN_FOVEA
+%token EQTOKEN_RING_ZOOM
+%token EQTOKEN_DWELL
+%token EQTOKEN_WARMUP
+%token EQTOKEN_HYSTERESIS
+%token EQTOKEN_JOINT
+%token EQTOKEN_PACING
+%token EQTOKEN_COST_MODEL
+%token EQTOKEN_LOAD_BALANCED
 %token EQTOKEN_DB
 %token EQTOKEN_BOUNDARY
 %token EQTOKEN_RESISTANCE
@@ -305,6 +389,8 @@
 %token EQTOKEN_SOCKET
 %token EQTOKEN_DISPLAYCLUSTER
 %token EQTOKEN_DUMP_IMAGE
+%token EQTOKEN_SHARED_MEMORY
+%token EQTOKEN_PLAYBACK_IMAGES
 
 %union{
     const char*             _string;
@@ -380,6 +466,46 @@ global:
          eq::server::Global::instance()->setConfigIAttribute(
              eq::server::Config::IATTR_ROBUSTNESS, $2 );
      }
+     | EQTOKEN_CONFIG_IATTR_TRACE_EVENTS IATTR
+     {
+         eq::server::Global::instance()->setConfigIAttribute(
+             eq::server::Config::IATTR_TRACE_EVENTS, $2 );
+     }
+     | EQTOKEN_CONFIG_IATTR_STATISTICS_INTERVAL IATTR
+     {
+         eq::server::Global::instance()->setConfigIAttribute(
+             eq::server::Config::IATTR_STATISTICS_INTERVAL, $2 );
+     }
+     | EQTOKEN_CONFIG_IATTR_STATISTICS_BUDGET IATTR
+     {
+         eq::server::Global::instance()->setConfigIAttribute(
+             eq::server::Config::IATTR_STATISTICS_BUDGET, $2 );
+     }
+     | EQTOKEN_CONFIG_IATTR_METRICS_PORT IATTR
+     {
+         eq::server::Global::instance()->setConfigIAttribute(
+             eq::server::Config::IATTR_METRICS_PORT, $2 );
+     }
+     | EQTOKEN_CONFIG_IATTR_DORMANT_LAYOUTS IATTR
+     {
+         eq::server::Global::instance()->setConfigIAttribute(
+             eq::server::Config::IATTR_DORMANT_LAYOUTS, $2 );
+     }
+     | EQTOKEN_CONFIG_IATTR_STATIC_FRAMES IATTR
+     {
+         eq::server::Global::instance()->setConfigIAttribute(
+             eq::server::Config::IATTR_STATIC_FRAMES, $2 );
+     }
+     | EQTOKEN_CONFIG_IATTR_GPU_PRIORITY IATTR
+     {
+         eq::server::Global::instance()->setConfigIAttribute(
+             eq::server::Config::IATTR_GPU_PRIORITY, $2 );
+     }
+     | EQTOKEN_CONFIG_IATTR_GPU_WEIGHT IATTR
+     {
+         eq::server::Global::instance()->setConfigIAttribute(
+             eq::server::Config::IATTR_GPU_WEIGHT, $2 );
+     }
      | EQTOKEN_NODE_SATTR_LAUNCH_COMMAND STRING
      {
          eq::server::Global::instance()->setNodeSAttribute(
@@ -410,6 +536,16 @@ global:
          LBWARN << "Ignoring deprecated attribute Node::IATTR_HINT_STATISTICS"
                 << std::endl;
      }
+     | EQTOKEN_NODE_IATTR_HINT_TRANSMIT_THREADS IATTR
+     {
+         eq::server::Global::instance()->setNodeIAttribute(
+             eq::server::Node::IATTR_HINT_TRANSMIT_THREADS, $2 );
+     }
+     | EQTOKEN_NODE_IATTR_HINT_STANDBY IATTR
+     {
+         eq::server::Global::instance()->setNodeIAttribute(
+             eq::server::Node::IATTR_HINT_STANDBY, $2 );
+     }
      | EQTOKEN_PIPE_IATTR_HINT_THREAD IATTR
      {
          eq::server::Global::instance()->setPipeIAttribute(
@@ -425,6 +561,11 @@ global:
          eq::server::Global::instance()->setPipeIAttribute(
              eq::server::Pipe::IATTR_HINT_CUDA_GL_INTEROP, $2 );
      }
+     | EQTOKEN_PIPE_IATTR_HINT_PARALLEL_INIT IATTR
+     {
+         eq::server::Global::instance()->setPipeIAttribute(
+             eq::server::Pipe::IATTR_HINT_PARALLEL_INIT, $2 );
+     }
      | EQTOKEN_WINDOW_IATTR_HINT_CORE_PROFILE IATTR
      {
          eq::server::Global::instance()->setWindowIAttribute(
@@ -530,6 +671,46 @@ global:
          eq::server::Global::instance()->setChannelIAttribute(
              eq::server::Channel::IATTR_HINT_SENDTOKEN, $2 );
      }
+     | EQTOKEN_CHANNEL_IATTR_HINT_TRANSMIT_ROWS IATTR
+     {
+         eq::server::Global::instance()->setChannelIAttribute(
+             eq::server::Channel::IATTR_HINT_TRANSMIT_ROWS, $2 );
+     }
+     | EQTOKEN_CHANNEL_IATTR_HINT_ASYNC_ASSEMBLY IATTR
+     {
+         eq::server::Global::instance()->setChannelIAttribute(
+             eq::server::Channel::IATTR_HINT_ASYNC_ASSEMBLY, $2 );
+     }
+     | EQTOKEN_CHANNEL_IATTR_HINT_REPROJECTION IATTR
+     {
+         eq::server::Global::instance()->setChannelIAttribute(
+             eq::server::Channel::IATTR_HINT_REPROJECTION, $2 );
+     }
+     | EQTOKEN_CHANNEL_IATTR_HINT_MULTIVIEW IATTR
+     {
+         eq::server::Global::instance()->setChannelIAttribute(
+             eq::server::Channel::IATTR_HINT_MULTIVIEW, $2 );
+     }
+     | EQTOKEN_CHANNEL_IATTR_HINT_TILE_ATLAS IATTR
+     {
+         eq::server::Global::instance()->setChannelIAttribute(
+             eq::server::Channel::IATTR_HINT_TILE_ATLAS, $2 );
+     }
+     | EQTOKEN_CHANNEL_IATTR_HINT_TEMPORAL_UPSAMPLING IATTR
+     {
+         eq::server::Global::instance()->setChannelIAttribute(
+             eq::server::Channel::IATTR_HINT_TEMPORAL_UPSAMPLING, $2 );
+     }
+     | EQTOKEN_CHANNEL_IATTR_HINT_TEMPORAL_TRANSMIT IATTR
+     {
+         eq::server::Global::instance()->setChannelIAttribute(
+             eq::server::Channel::IATTR_HINT_TEMPORAL_TRANSMIT, $2 );
+     }
+     | EQTOKEN_CHANNEL_IATTR_HINT_TRANSMIT_DEADLINE IATTR
+     {
+         eq::server::Global::instance()->setChannelIAttribute(
+             eq::server::Channel::IATTR_HINT_TRANSMIT_DEADLINE, $2 );
+     }
      | EQTOKEN_COMPOUND_IATTR_STEREO_MODE IATTR
      {
          eq::server::Global::instance()->setCompoundIAttribute(
@@ -555,6 +736,16 @@ global:
         eq::server::Global::instance()->setChannelSAttribute(
             eq::server::Channel::SATTR_DUMP_IMAGE, $2 );
      }
+     | EQTOKEN_CHANNEL_SATTR_SHARED_MEMORY STRING
+     {
+        eq::server::Global::instance()->setChannelSAttribute(
+            eq::server::Channel::SATTR_SHARED_MEMORY, $2 );
+     }
+     | EQTOKEN_CHANNEL_SATTR_PLAYBACK_IMAGES STRING
+     {
+        eq::server::Global::instance()->setChannelSAttribute(
+            eq::server::Channel::SATTR_PLAYBACK_IMAGES, $2 );
+     }
      | EQTOKEN_VIEW_SATTR_DISPLAYCLUSTER STRING
      {
         eq::server::Global::instance()->setViewSAttribute(
@@ -591,10 +782,11 @@ config: EQTOKEN_CONFIG '{'
             {
                 config = new eq::server::Config( server );
                 config->setName( filename );
+                channels.clear();
                 node = new eq::server::Node( config );
                 node->setApplicationNode( true );
             }
-        configFields '}' { config = 0; }
+        configFields '}' { config = 0; channels.clear(); }
 configFields: /*null*/ | configFields configField
 configField:
     node
@@ -611,6 +803,22 @@ configAttribute:
                              eq::server::Config::FATTR_EYE_BASE, $2 ); }
     | EQTOKEN_ROBUSTNESS IATTR { config->setIAttribute(
                                  eq::server::Config::IATTR_ROBUSTNESS, $2 ); }
+    | EQTOKEN_TRACE_EVENTS IATTR { config->setIAttribute(
+                                 eq::server::Config::IATTR_TRACE_EVENTS, $2 ); }
+    | EQTOKEN_STATISTICS_INTERVAL IATTR { config->setIAttribute(
+                          eq::server::Config::IATTR_STATISTICS_INTERVAL, $2 ); }
+    | EQTOKEN_STATISTICS_BUDGET IATTR { config->setIAttribute(
+                            eq::server::Config::IATTR_STATISTICS_BUDGET, $2 ); }
+    | EQTOKEN_METRICS_PORT IATTR { config->setIAttribute(
+                                 eq::server::Config::IATTR_METRICS_PORT, $2 ); }
+    | EQTOKEN_DORMANT_LAYOUTS IATTR { config->setIAttribute(
+                              eq::server::Config::IATTR_DORMANT_LAYOUTS, $2 ); }
+    | EQTOKEN_STATIC_FRAMES IATTR { config->setIAttribute(
+                                eq::server::Config::IATTR_STATIC_FRAMES, $2 ); }
+    | EQTOKEN_GPU_PRIORITY IATTR { config->setIAttribute(
+                                 eq::server::Config::IATTR_GPU_PRIORITY, $2 ); }
+    | EQTOKEN_GPU_WEIGHT IATTR { config->setIAttribute(
+                                   eq::server::Config::IATTR_GPU_WEIGHT, $2 ); }
 
 node: appNode | renderNode
 renderNode: EQTOKEN_NODE '{' {
@@ -668,6 +876,11 @@ nodeAttribute:
         }
     | EQTOKEN_HINT_AFFINITY IATTR
         { node->setIAttribute( eq::server::Node::IATTR_HINT_AFFINITY, $2 ); }
+    | EQTOKEN_HINT_TRANSMIT_THREADS IATTR
+        { node->setIAttribute( eq::server::Node::IATTR_HINT_TRANSMIT_THREADS,
+                               $2 ); }
+    | EQTOKEN_HINT_STANDBY IATTR
+        { node->setIAttribute( eq::server::Node::IATTR_HINT_STANDBY, $2 ); }
 
 
 pipe: EQTOKEN_PIPE '{'
@@ -697,6 +910,9 @@ pipeAttribute:
     | EQTOKEN_HINT_CUDA_GL_INTEROP IATTR
         { eqPipe->setIAttribute( eq::server::Pipe::IATTR_HINT_CUDA_GL_INTEROP,
                                  $2 ); }
+    | EQTOKEN_HINT_PARALLEL_INIT IATTR
+        { eqPipe->setIAttribute( eq::server::Pipe::IATTR_HINT_PARALLEL_INIT,
+                                 $2 ); }
 
 window: EQTOKEN_WINDOW '{'
             {
@@ -766,7 +982,13 @@ channel: EQTOKEN_CHANNEL '{'
                 channel->init(); // not in ctor, virtual method
             }
          channelFields
-        '}' { channel = 0; }
+        '}'
+            {
+                if( !channel->getName().empty( ))
+                    channels.insert( std::make_pair( channel->getName(),
+                                                     channel ));
+                channel = 0;
+            }
 channelFields: /*null*/ | channelFields channelField
 channelField:
     EQTOKEN_NAME STRING { channel->setName( $2 ); }
@@ -788,9 +1010,39 @@ channelAttribute:
     | EQTOKEN_HINT_SENDTOKEN IATTR
         { channel->setIAttribute( eq::server::Channel::IATTR_HINT_SENDTOKEN,
                                   $2 ); }
+    | EQTOKEN_HINT_TRANSMIT_ROWS IATTR
+        { channel->setIAttribute(
+              eq::server::Channel::IATTR_HINT_TRANSMIT_ROWS, $2 ); }
+    | EQTOKEN_HINT_ASYNC_ASSEMBLY IATTR
+        { channel->setIAttribute(
+              eq::server::Channel::IATTR_HINT_ASYNC_ASSEMBLY, $2 ); }
+    | EQTOKEN_HINT_REPROJECTION IATTR
+        { channel->setIAttribute(
+              eq::server::Channel::IATTR_HINT_REPROJECTION, $2 ); }
+    | EQTOKEN_HINT_MULTIVIEW IATTR
+        { channel->setIAttribute(
+              eq::server::Channel::IATTR_HINT_MULTIVIEW, $2 ); }
+    | EQTOKEN_HINT_TILE_ATLAS IATTR
+        { channel->setIAttribute(
+              eq::server::Channel::IATTR_HINT_TILE_ATLAS, $2 ); }
+    | EQTOKEN_HINT_TEMPORAL_UPSAMPLING IATTR
+        { channel->setIAttribute(
+              eq::server::Channel::IATTR_HINT_TEMPORAL_UPSAMPLING, $2 ); }
+    | EQTOKEN_HINT_TEMPORAL_TRANSMIT IATTR
+        { channel->setIAttribute(
+              eq::server::Channel::IATTR_HINT_TEMPORAL_TRANSMIT, $2 ); }
+    | EQTOKEN_HINT_TRANSMIT_DEADLINE IATTR
+        { channel->setIAttribute(
+              eq::server::Channel::IATTR_HINT_TRANSMIT_DEADLINE, $2 ); }
     | EQTOKEN_DUMP_IMAGE STRING
         { channel->setSAttribute( eq::server::Channel::SATTR_DUMP_IMAGE,
                                   $2 ); }
+    | EQTOKEN_SHARED_MEMORY STRING
+        { channel->setSAttribute( eq::server::Channel::SATTR_SHARED_MEMORY,
+                                  $2 ); }
+    | EQTOKEN_PLAYBACK_IMAGES STRING
+        { channel->setSAttribute( eq::server::Channel::SATTR_PLAYBACK_IMAGES,
+                                  $2 ); }
 observer: EQTOKEN_OBSERVER '{' { observer = new eq::server::Observer( config );}
             observerFields '}' { observer = 0; }
 observerFields: /*null*/ | observerFields observerField
@@ -826,6 +1078,7 @@ observerField:
         { observer->setFocusMode( eq::fabric::FocusMode( $2 )); }
     | EQTOKEN_OPENCV_CAMERA IATTR { observer->setOpenCVCamera( $2 ); }
     | EQTOKEN_VRPN_TRACKER STRING { observer->setVRPNTracker( $2 ); }
+    | EQTOKEN_LATCH_PORT IATTR { observer->setLatchPort( $2 ); }
 
 layout: EQTOKEN_LAYOUT '{' { layout = new eq::server::Layout( config ); }
             layoutFields '}' { layout = 0; }
@@ -930,7 +1183,7 @@ segmentField:
     EQTOKEN_NAME STRING { segment->setName( $2 ); }
     | EQTOKEN_CHANNEL STRING
         {
-            eq::server::Channel* ch = config->find< eq::server::Channel >( $2 );
+            eq::server::Channel* ch = findChannel( $2 );
             if( ch )
                 segment->setChannel( ch );
             else
@@ -970,7 +1223,7 @@ compoundField:
     | EQTOKEN_NAME STRING { eqCompound->setName( $2 ); }
     | EQTOKEN_CHANNEL STRING
       {
-          eq::server::Channel* ch = config->find< eq::server::Channel >( $2 );
+          eq::server::Channel* ch = findChannel( $2 );
           if( ch )
               eqCompound->setChannel( ch );
           else
@@ -1230,7 +1483,7 @@ loadBalancerMode:
     }
 
 equalizer: dfrEqualizer | framerateEqualizer | loadEqualizer | treeEqualizer |
-           monitorEqualizer | viewEqualizer | tileEqualizer
+           monitorEqualizer | viewEqualizer | tileEqualizer | foveatedEqualizer
 
 dfrEqualizer: EQTOKEN_DFREQUALIZER '{'
     { dfrEqualizer = new eq::server::DFREqualizer; }
@@ -1239,9 +1492,19 @@ dfrEqualizer: EQTOKEN_DFREQUALIZER '{'
         eqCompound->addEqualizer( dfrEqualizer );
         dfrEqualizer = 0;
     }
-framerateEqualizer: EQTOKEN_FRAMERATEEQUALIZER '{' '}'
+foveatedEqualizer: EQTOKEN_FOVEATEDEQUALIZER '{'
+    { foveatedEqualizer = new eq::server::FoveatedEqualizer; }
+    foveatedEqualizerFields '}'
     {
-        eqCompound->addEqualizer( new eq::server::FramerateEqualizer );
+        eqCompound->addEqualizer( foveatedEqualizer );
+        foveatedEqualizer = 0;
+    }
+framerateEqualizer: EQTOKEN_FRAMERATEEQUALIZER '{'
+    { framerateEqualizer = new eq::server::FramerateEqualizer; }
+    framerateEqualizerFields '}'
+    {
+        eqCompound->addEqualizer( framerateEqualizer );
+        framerateEqualizer = 0;
     }
 loadEqualizer: EQTOKEN_LOADEQUALIZER '{'
     { loadEqualizer = new eq::server::LoadEqualizer; }
@@ -1257,13 +1520,19 @@ treeEqualizer: EQTOKEN_TREEEQUALIZER '{'
         eqCompound->addEqualizer( treeEqualizer );
         treeEqualizer = 0;
     }
-monitorEqualizer: EQTOKEN_MONITOREQUALIZER '{' '}'
+monitorEqualizer: EQTOKEN_MONITOREQUALIZER '{'
+    { monitorEqualizer = new eq::server::MonitorEqualizer; }
+    monitorEqualizerFields '}'
     {
-        eqCompound->addEqualizer( new eq::server::MonitorEqualizer );
+        eqCompound->addEqualizer( monitorEqualizer );
+        monitorEqualizer = 0;
     }
-viewEqualizer: EQTOKEN_VIEWEQUALIZER '{' '}'
+viewEqualizer: EQTOKEN_VIEWEQUALIZER '{'
+    { viewEqualizer = new eq::server::ViewEqualizer; }
+    viewEqualizerFields '}'
     {
-        eqCompound->addEqualizer( new eq::server::ViewEqualizer );
+        eqCompound->addEqualizer( viewEqualizer );
+        viewEqualizer = 0;
     }
 tileEqualizer: EQTOKEN_TILEEQUALIZER
     '{' { tileEqualizer = new eq::server::TileEqualizer; }
@@ -1277,6 +1546,37 @@ dfrEqualizerFields: /* null */ | dfrEqualizerFields dfrEqualizerField
 dfrEqualizerField:
     EQTOKEN_DAMPING FLOAT      { dfrEqualizer->setDamping( $2 ); }
     | EQTOKEN_FRAMERATE FLOAT  { dfrEqualizer->setFrameRate( $2 ); }
+    | EQTOKEN_FRAME_TIME FLOAT { dfrEqualizer->setFrameRate( 1000.f / $2 ); }
+    | EQTOKEN_MIN_ZOOM FLOAT   { dfrEqualizer->setMinZoom( $2 ); }
+    | EQTOKEN_MAX_ZOOM FLOAT   { dfrEqualizer->setMaxZoom( $2 ); }
+    | EQTOKEN_ZOOM_RATE FLOAT  { dfrEqualizer->setZoomRate( $2 ); }
+    | EQTOKEN_LOAD_BALANCED IATTR
+        { dfrEqualizer->setLoadBalanced( $2 == eq::fabric::ON ); }
+
+foveatedEqualizerFields:
+    /* null */ | foveatedEqualizerFields foveatedEqualizerField
+foveatedEqualizerField:
+    EQTOKEN_FOVEA FLOAT        { foveatedEqualizer->setFoveaSize( $2 ); }
+    | EQTOKEN_RING_ZOOM FLOAT  { foveatedEqualizer->setRingZoom( $2 ); }
+
+framerateEqualizerFields:
+    /* null */ | framerateEqualizerFields framerateEqualizerField
+framerateEqualizerField:
+    EQTOKEN_PACING IATTR
+        { framerateEqualizer->setPacing( $2 == eq::fabric::ON ); }
+
+monitorEqualizerFields:
+    /* null */ | monitorEqualizerFields monitorEqualizerField
+monitorEqualizerField:
+    EQTOKEN_PERIOD UNSIGNED    { monitorEqualizer->setPeriod( $2 ); }
+
+viewEqualizerFields: /* null */ | viewEqualizerFields viewEqualizerField
+viewEqualizerField:
+    EQTOKEN_DWELL UNSIGNED        { viewEqualizer->setDwellTime( $2 ); }
+    | EQTOKEN_WARMUP UNSIGNED     { viewEqualizer->setWarmup( $2 ); }
+    | EQTOKEN_HYSTERESIS FLOAT    { viewEqualizer->setHysteresis( $2 ); }
+    | EQTOKEN_JOINT IATTR
+        { viewEqualizer->setJoint( $2 == eq::fabric::ON ); }
 
 loadEqualizerFields: /* null */ | loadEqualizerFields loadEqualizerField
 loadEqualizerField:
@@ -1290,6 +1590,18 @@ loadEqualizerField:
     | EQTOKEN_RESISTANCE '[' UNSIGNED UNSIGNED ']'
         { loadEqualizer->setResistance( eq::fabric::Vector2i( $3, $4 )); }
     | EQTOKEN_RESISTANCE FLOAT  { loadEqualizer->setResistance( $2 ); }
+    | EQTOKEN_PREDICTIVE IATTR
+        { loadEqualizer->setPredictive( $2 == eq::fabric::ON ); }
+    | EQTOKEN_NODE_DAMPING FLOAT   { loadEqualizer->setNodeDamping( $2 ); }
+    | EQTOKEN_NODE_BOUNDARY '[' UNSIGNED UNSIGNED ']'
+        { loadEqualizer->setNodeBoundary( eq::fabric::Vector2i( $3, $4 )); }
+    | EQTOKEN_NODE_BOUNDARY FLOAT  { loadEqualizer->setNodeBoundary( $2 ); }
+    | EQTOKEN_NODE_RESISTANCE '[' UNSIGNED UNSIGNED ']'
+        { loadEqualizer->setNodeResistance( eq::fabric::Vector2i( $3, $4 )); }
+    | EQTOKEN_NODE_RESISTANCE FLOAT
+        { loadEqualizer->setNodeResistance( $2 ); }
+    | EQTOKEN_NODE_ALIGNED IATTR
+        { loadEqualizer->setNodeAligned( $2 == eq::fabric::ON ); }
 
 loadEqualizerMode:
     EQTOKEN_2D           { $$ = eq::server::LoadEqualizer::MODE_2D; }
@@ -1307,6 +1619,8 @@ treeEqualizerField:
     | EQTOKEN_RESISTANCE '[' UNSIGNED UNSIGNED ']'
         { treeEqualizer->setResistance( eq::fabric::Vector2i( $3, $4 )); }
     | EQTOKEN_RESISTANCE FLOAT  { treeEqualizer->setResistance( $2 ); }
+    | EQTOKEN_COST_MODEL IATTR
+        { treeEqualizer->setCostModel( $2 == eq::fabric::ON ); }
 
 treeEqualizerMode:
     EQTOKEN_2D           { $$ = eq::server::TreeEqualizer::MODE_2D; }
@@ -1328,6 +1642,9 @@ swapBarrierFields: /*null*/ | swapBarrierFields swapBarrierField
 swapBarrierField: EQTOKEN_NAME STRING { swapBarrier->setName( $2 ); }
     | EQTOKEN_NVGROUP IATTR { swapBarrier->setNVSwapGroup( $2 ); }
     | EQTOKEN_NVBARRIER IATTR { swapBarrier->setNVSwapBarrier( $2 ); }
+    | EQTOKEN_TIMED IATTR { swapBarrier->setTimed( $2 == eq::fabric::ON ); }
+    | EQTOKEN_HARDWARE IATTR
+        { swapBarrier->setHardware( $2 != eq::fabric::OFF ); }
 
 
 
@@ -1358,6 +1675,7 @@ frameField:
 frameType:
     EQTOKEN_TEXTURE { frame->setType( eq::fabric::Frame::TYPE_TEXTURE ); }
     | EQTOKEN_MEMORY { frame->setType( eq::fabric::Frame::TYPE_MEMORY ); }
+    | EQTOKEN_DRAWABLE { frame->setType( eq::fabric::Frame::TYPE_DRAWABLE ); }
 
 outputTiles: EQTOKEN_OUTPUTTILES '{' { tileQueue = new eq::server::TileQueue; }
     tileQueueFields '}'
@@ -1415,6 +1733,7 @@ IATTR:
     | EQTOKEN_FASTEST    { $$ = eq::fabric::FASTEST; }
     | EQTOKEN_HORIZONTAL { $$ = eq::fabric::HORIZONTAL; }
     | EQTOKEN_NICEST     { $$ = eq::fabric::NICEST; }
+    | EQTOKEN_HISTOGRAM  { $$ = eq::fabric::HISTOGRAM; }
     | EQTOKEN_QUAD       { $$ = eq::fabric::QUAD; }
     | EQTOKEN_ANAGLYPH   { $$ = eq::fabric::ANAGLYPH; }
     | EQTOKEN_PASSIVE    { $$ = eq::fabric::PASSIVE; }
@@ -1497,6 +1816,7 @@ void Loader::_parse()
 
     loader::server = 0;
     config = 0;
+    channels.clear();
     yylineno = 0;
 
     const std::string oldLocale = setlocale( LC_NUMERIC, "C" );
@@ -45,6 +45,8 @@
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 
+#include <algorithm>
+
 namespace eq
 {
 namespace server
@@ -573,6 +575,16 @@ void Node::update( const uint128_t& frameID, const uint32_t frameNumber )
     flushSendBuffer();
 }
 
+int64_t Node::getDrawTime() const
+{
+    // pipes draw in parallel
+    int64_t drawTime = 0;
+    const Pipes& pipes = getPipes();
+    for( Pipes::const_iterator i = pipes.begin(); i != pipes.end(); ++i )
+        drawTime = std::max( drawTime, (*i)->getDrawTime( ));
+    return drawTime;
+}
+
 uint32_t Node::_getFinishLatency() const
 {
     switch( getIAttribute( Node::IATTR_THREAD_MODEL ))
@@ -836,6 +848,9 @@ void Node::output( std::ostream& os ) const
         os << ( i== Node::IATTR_LAUNCH_TIMEOUT ? "launch_timeout       " :
                 i== Node::IATTR_THREAD_MODEL   ? "thread_model         " :
                 i== Node::IATTR_HINT_AFFINITY  ? "hint_affinity        " :
+                i== Node::IATTR_HINT_TRANSMIT_THREADS ?
+                                                 "hint_transmit_threads" :
+                i== Node::IATTR_HINT_STANDBY   ? "hint_standby         " :
                 "ERROR" )
            << static_cast< fabric::IAttribute >( value ) << std::endl;
     }
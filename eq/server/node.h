@@ -83,6 +83,13 @@ public:
     /** @return if this node is stopped. */
     bool isStopped() const { return _state == STATE_STOPPED; }
 
+    /**
+     * @return true if this node is a standby node, which is initialized but
+     *         does not render until it replaces a failed node.
+     */
+    bool isStandby() const
+        { return getIAttribute( IATTR_HINT_STANDBY ) == fabric::ON; }
+
     /**
      * Add additional tasks this pipe, and all its parents, might
      * potentially execute.
@@ -96,6 +103,12 @@ public:
 
     /** @return the number of the last finished frame. @internal */
     uint32_t getFinishedFrame() const { return _finishedFrame; }
+
+    /**
+     * @return the draw time of the slowest pipe in the last finished frame,
+     *         in ms. @internal
+     */
+    int64_t getDrawTime() const;
     //@}
 
     /**
@@ -24,6 +24,7 @@
 
 #include <co/dataIStream.h>
 #include <co/dataOStream.h>
+#include <lunchbox/atomic.h>
 
 namespace eq
 {
@@ -31,10 +32,15 @@ namespace server
 {
 
 typedef fabric::Observer< Config, Observer > Super;
+namespace
+{
+static lunchbox::a_int32_t _eyeRevisions;
+}
 
 Observer::Observer( Config* parent )
         : Super( parent )
         , _inverseHeadMatrix( Matrix4f::IDENTITY )
+        , _eyeRevision( 0 )
         , _state( STATE_ACTIVE )
 {
     _updateEyes();
@@ -99,6 +105,7 @@ void Observer::_updateEyes()
     const Matrix4f& head = getHeadMatrix();
     for( size_t i = 0; i < NUM_EYES; ++i )
         _eyeWorld[ i ] = head * getEyePosition( Eye( 1 << i ));
+    _eyeRevision = ++_eyeRevisions;
 
     LBVERB << "Eye position: " << _eyeWorld[ fabric::EYE_CYCLOP_BIT ]
            << std::endl;
@@ -57,6 +57,12 @@ namespace server
         const fabric::Matrix4f& getInverseHeadMatrix() const
             { return _inverseHeadMatrix; }
 
+        /**
+         * @return a number identifying the current head matrix and eye
+         *         positions, unique for all observers.
+         */
+        uint32_t getEyeRevision() const { return _eyeRevision; }
+
         /** @return true if this observer should be deleted. */
         bool needsDelete() const { return _state == STATE_DELETE; }
         //@}
@@ -89,6 +95,9 @@ namespace server
         /** The eye positions in world space. */
         fabric::Vector3f _eyeWorld[ eq::fabric::NUM_EYES ];
 
+        /** Updated with the eye positions, see getEyeRevision(). */
+        uint32_t _eyeRevision;
+
         /** Views tracked by this observer. */
         Views _views;
 
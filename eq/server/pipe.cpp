@@ -19,7 +19,10 @@
 #include "pipe.h"
 
 #include "channel.h"
+#include "compound.h"
+#include "compoundVisitor.h"
 #include "config.h"
+#include "frame.h"
 #include "global.h"
 #include "log.h"
 #include "node.h"
@@ -32,6 +35,8 @@
 
 #include <co/objectICommand.h>
 
+#include <algorithm>
+
 namespace eq
 {
 namespace server
@@ -40,6 +45,93 @@ namespace server
 typedef fabric::Pipe< Node, Pipe, Window, PipeVisitor > Super;
 typedef co::CommandFunc<Pipe> PipeFunc;
 
+namespace
+{
+/** Collects the frames and views referenced by the tasks of one pipe. */
+class PrefetchVisitor : public CompoundVisitor
+{
+public:
+    explicit PrefetchVisitor( const Pipe* pipe )
+    {
+        const Windows& windows = pipe->getWindows();
+        for( WindowsCIter i = windows.begin(); i != windows.end(); ++i )
+        {
+            const Channels& channels = (*i)->getChannels();
+            _channels.insert( _channels.end(), channels.begin(),
+                              channels.end( ));
+        }
+    }
+
+    VisitorResult visit( const Compound* compound ) override
+    {
+        if( !_usesPipe( compound ))
+            return TRAVERSE_PRUNE;
+
+        const Channel* channel = compound->getChannel();
+        if( !channel || std::find( _channels.begin(), _channels.end(),
+                                   channel ) == _channels.end( ) ||
+            !compound->isActive() ||
+            compound->getInheritTasks() == fabric::TASK_NONE )
+        {
+            return TRAVERSE_CONTINUE;
+        }
+
+        const co::ObjectVersion& view =
+            compound->getInheritChannel()->getViewVersion();
+        if( view.identifier != 0 )
+            _add( views, view );
+
+        if( compound->testInheritTask( fabric::TASK_ASSEMBLE ))
+            _addFrames( compound, compound->getInputFrames( ));
+        if( compound->testInheritTask( fabric::TASK_READBACK ))
+            _addFrames( compound, compound->getOutputFrames( ));
+        return TRAVERSE_CONTINUE;
+    }
+
+    co::ObjectVersions frames;
+    co::ObjectVersions views;
+
+private:
+    Channels _channels;
+
+    bool _usesPipe( const Compound* compound ) const
+    {
+        for( ChannelsCIter i = _channels.begin(); i != _channels.end(); ++i )
+            if( compound->usesChannel( *i ))
+                return true;
+        return false;
+    }
+
+    void _addFrames( const Compound* compound, const Frames& compoundFrames )
+    {
+        for( FramesCIter i = compoundFrames.begin();
+             i != compoundFrames.end(); ++i )
+        {
+            const Frame* frame = *i;
+            for( fabric::Eye eye = fabric::EYE_CYCLOP;
+                 eye < fabric::EYES_ALL; eye = fabric::Eye( eye << 1 ))
+            {
+                if( compound->isInheritActive( eye ) && frame->hasData( eye ))
+                {
+                    _add( frames, co::ObjectVersion( frame ));
+                    break;
+                }
+            }
+        }
+    }
+
+    static void _add( co::ObjectVersions& objects,
+                      const co::ObjectVersion& object )
+    {
+        if( std::find( objects.begin(), objects.end(), object ) ==
+            objects.end( ))
+        {
+            objects.push_back( object );
+        }
+    }
+};
+}
+
 Pipe::Pipe( Node* parent )
         : Super( parent )
         , _active( 0 )
@@ -244,6 +336,23 @@ bool Pipe::syncConfigExit()
 //---------------------------------------------------------------------------
 // update
 //---------------------------------------------------------------------------
+int64_t Pipe::getDrawTime() const
+{
+    // the channels of a pipe draw one after another
+    int64_t drawTime = 0;
+    const Windows& windows = getWindows();
+    for( Windows::const_iterator i = windows.begin(); i != windows.end(); ++i )
+    {
+        const Channels& channels = (*i)->getChannels();
+        for( Channels::const_iterator j = channels.begin();
+             j != channels.end(); ++j )
+        {
+            drawTime += (*j)->getDrawTime();
+        }
+    }
+    return drawTime;
+}
+
 void Pipe::update( const uint128_t& frameID, const uint32_t frameNumber )
 {
     if( !isRunning( ))
@@ -252,8 +361,15 @@ void Pipe::update( const uint128_t& frameID, const uint32_t frameNumber )
     LBASSERT( isActive( ))
     send( fabric::CMD_PIPE_FRAME_START_CLOCK );
 
+    // Announce the objects used by this frame's tasks to map them early
+    PrefetchVisitor prefetch( this );
+    const Compounds& compounds = getConfig()->getCompounds();
+    for( CompoundsCIter i = compounds.begin(); i != compounds.end(); ++i )
+        (*i)->accept( prefetch );
+
     send( fabric::CMD_PIPE_FRAME_START )
-            << getVersion() << frameID << frameNumber;
+            << getVersion() << frameID << frameNumber << prefetch.frames
+            << prefetch.views;
     LBLOG( LOG_TASKS ) << "TASK pipe start frame " << frameNumber << " id "
                        << frameID << std::endl;
 
@@ -326,6 +442,7 @@ void Pipe::output( std::ostream& os ) const
         os << ( i == IATTR_HINT_THREAD ? "hint_thread "                   :
                 i == IATTR_HINT_CUDA_GL_INTEROP ? "hint_cuda_GL_interop " :
                 i == IATTR_HINT_AFFINITY ? "hint_affinity "               :
+                i == IATTR_HINT_PARALLEL_INIT ? "hint_parallel_init "     :
                     "ERROR" )
            << static_cast< fabric::IAttribute >( value ) << std::endl;
     }
@@ -88,6 +88,9 @@ namespace server
         void setLastDrawWindow( const Window* window )
             { _lastDrawWindow = window; }
         const Window* getLastDrawWindow() const { return _lastDrawWindow; }
+
+        /** @return the draw time of the last finished frame in ms. */
+        int64_t getDrawTime() const;
         //@}
 
         /**
@@ -23,6 +23,7 @@
 #include "compound.h"
 #include "config.h"
 #include "global.h"
+#include "gpuScheduler.h"
 #include "loader.h"
 #include "node.h"
 #include "nodeFactory.h"
@@ -34,6 +35,7 @@
 
 #include <eq/fabric/commands.h>
 #include <eq/fabric/configParams.h>
+#include <eq/fabric/metricsExporter.h>
 
 #include <co/iCommand.h>
 #include <co/connectionDescription.h>
@@ -65,6 +67,8 @@ Server::Server()
         : Super( &_nf )
         , _mainThreadQueue( co::Global::getCommandQueueLimit( ))
         , _running( false )
+        , _metrics( 0 )
+        , _gpuScheduler( new GPUScheduler )
 {
     lunchbox::Log::setClock( &_clock );
     disableInstanceCache();
@@ -91,6 +95,8 @@ Server::~Server()
 {
     LBASSERT( getConfigs().empty( )); // not possible - config RefPtr's myself
     deleteConfigs();
+    delete _metrics;
+    delete _gpuScheduler;
     lunchbox::Log::setClock( 0 );
 }
 
@@ -120,6 +126,21 @@ void Server::exit()
     const Configs& configs = getConfigs();
     for( Configs::const_iterator i = configs.begin(); i != configs.end(); ++i )
         (*i)->deregister();
+
+    if( _metrics )
+        _metrics->stop();
+}
+
+bool Server::startMetrics( const uint16_t port )
+{
+    return collectMetrics()->start( port );
+}
+
+fabric::MetricsExporter* Server::collectMetrics()
+{
+    if( !_metrics )
+        _metrics = new fabric::MetricsExporter;
+    return _metrics;
 }
 
 void Server::run()
@@ -65,6 +65,24 @@ public:
     /** @return the global time in milliseconds. */
     int64_t getTime() const { return _clock.getTime64(); }
 
+    /**
+     * Start serving the metrics of all configs over HTTP.
+     *
+     * @param port the TCP port to listen on.
+     * @return true if the metrics endpoint was started, false on error.
+     * @version 1.8
+     */
+    EQSERVER_API bool startMetrics( uint16_t port );
+
+    /** @return the metrics exporter, or 0 if no metrics are collected. */
+    fabric::MetricsExporter* getMetrics() { return _metrics; }
+
+    /** Collect metrics from now on, without serving them. @version 1.9 */
+    fabric::MetricsExporter* collectMetrics();
+
+    /** @return the scheduler sharing GPUs between the configs. */
+    GPUScheduler& getGPUScheduler() { return *_gpuScheduler; }
+
 protected:
     virtual ~Server();
 
@@ -80,6 +98,12 @@ private:
     /** The current state. */
     bool _running;
 
+    /** The metrics endpoint, started by startMetrics(). */
+    fabric::MetricsExporter* _metrics;
+
+    /** Shares the GPUs used by several running configs. */
+    GPUScheduler* const _gpuScheduler;
+
     struct Private;
     Private* _private; // placeholder for binary-compatible changes
 
@@ -0,0 +1,103 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "swapScheduler.h"
+
+#include "log.h"
+
+#include <algorithm>
+
+namespace eq
+{
+namespace server
+{
+namespace
+{
+/** Number of recent frames used for the prediction. */
+const size_t _history = 16;
+
+/** Frames using the network barrier after a missed deadline. */
+const uint32_t _fallback = 8;
+
+/** Safety margin added to the predicted swap time in ms. */
+const int64_t _margin = 1;
+}
+
+SwapScheduler::SwapScheduler()
+    : _fallbackFrames( 0 )
+{}
+
+void SwapScheduler::reset()
+{
+    _arrivals.clear();
+    _fallbackFrames = 0;
+}
+
+int64_t SwapScheduler::startFrame( const uint32_t finishedFrame,
+                                   const int64_t startTime )
+{
+    while( _arrivals.size() > _history * 2 )
+        _arrivals.erase( _arrivals.begin( ));
+
+    if( _fallbackFrames > 0 )
+    {
+        --_fallbackFrames;
+        return 0;
+    }
+
+    // Arrivals of unfinished frames may still be missing due to the latency,
+    // predict only from a full history of finished frames.
+    size_t nFrames = 0;
+    int64_t latest = 0;
+    for( Arrivals::const_reverse_iterator i = _arrivals.rbegin();
+         i != _arrivals.rend() && nFrames < _history; ++i )
+    {
+        if( i->first > finishedFrame )
+            continue;
+        latest = std::max( latest, i->second );
+        ++nFrames;
+    }
+
+    if( nFrames < _history )
+        return 0;
+    return startTime + latest + _margin;
+}
+
+void SwapScheduler::addArrival( const uint32_t frameNumber,
+                                const int64_t offset, const bool late )
+{
+    if( late && _fallbackFrames == 0 )
+    {
+        LBLOG( LOG_TASKS ) << "Missed swap deadline of frame " << frameNumber
+                           << ", ready after " << offset
+                           << "ms, using swap barrier" << std::endl;
+        _fallbackFrames = _fallback;
+    }
+
+    Arrivals::iterator i = _arrivals.find( frameNumber );
+    if( i == _arrivals.end( ))
+    {
+        if( !_arrivals.empty() && frameNumber < _arrivals.begin()->first )
+            return; // too old
+        _arrivals[ frameNumber ] = offset;
+    }
+    else
+        i->second = std::max( i->second, offset );
+}
+
+}
+}
@@ -0,0 +1,76 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQSERVER_SWAPSCHEDULER_H
+#define EQSERVER_SWAPSCHEDULER_H
+
+#include <boost/noncopyable.hpp>
+#include <lunchbox/types.h>
+#include <map>
+
+namespace eq
+{
+namespace server
+{
+/**
+ * Predicts a common swap deadline for timed swap barriers.
+ *
+ * The windows of a timed swap barrier report the time they are ready to swap
+ * relative to the server start of their frame. The deadline of a new frame is
+ * the latest arrival of the recent frames plus a safety margin. Timed and
+ * synchronized clocks replace the network round trip of the swap barrier.
+ * When a window misses its deadline, the windows use the classic network
+ * barrier for a few frames while the prediction adapts.
+ * Not thread safe, all methods are called from the server thread.
+ */
+class SwapScheduler : public boost::noncopyable
+{
+public:
+    SwapScheduler();
+
+    /**
+     * Compute the swap deadline of a new frame.
+     *
+     * @param finishedFrame the last frame finished by all nodes.
+     * @param startTime the server time of the frame start.
+     * @return the server time of the swap, or 0 to use the network barrier.
+     */
+    int64_t startFrame( uint32_t finishedFrame, int64_t startTime );
+
+    /**
+     * Record that a window is ready to swap.
+     *
+     * @param frameNumber the frame of the window.
+     * @param offset the ready time relative to the frame start in ms.
+     * @param late true if the window missed the frame's deadline.
+     */
+    void addArrival( uint32_t frameNumber, int64_t offset, bool late );
+
+    /** Forget all arrivals, used on config (re-)initialization. */
+    void reset();
+
+private:
+    /** Latest arrival offset of each recent frame. */
+    typedef std::map< uint32_t, int64_t > Arrivals;
+    Arrivals _arrivals;
+
+    uint32_t _fallbackFrames; //!< frames left using the network barrier
+};
+}
+}
+
+#endif // EQSERVER_SWAPSCHEDULER_H
@@ -33,12 +33,11 @@ TileQueue::TileQueue()
         , _compound( 0 )
         , _name()
         , _size( 0, 0 )
+        , _nLanes( 0 )
+        , _lane( 0 )
 {
     for( unsigned i = 0; i < NUM_EYES; ++i )
-    {
-        _queueMaster[i] = 0;
         _outputQueue[i] = 0;
-    }
 }
 
 TileQueue::TileQueue( const TileQueue& from )
@@ -46,12 +45,11 @@ TileQueue::TileQueue( const TileQueue& from )
         , _compound( 0 )
         , _name( from._name )
         , _size( from._size )
+        , _nLanes( 0 )
+        , _lane( 0 )
 {
     for( unsigned i = 0; i < NUM_EYES; ++i )
-    {
-        _queueMaster[i] = 0;
         _outputQueue[i] = 0;
-    }
 }
 
 TileQueue::~TileQueue()
@@ -59,45 +57,53 @@ TileQueue::~TileQueue()
     _compound = 0;
 }
 
-void TileQueue::addTile( const Tile& tile, const fabric::Eye eye )
+void TileQueue::addTile( const Tile& tile, const fabric::Eye eye,
+                         const size_t lane )
 {
     uint32_t index = lunchbox::getIndexOfLastBit(eye);
     LBASSERT( index < NUM_EYES );
-    _queueMaster[index]->_queue.push() << tile;
+    LBASSERT( lane < _queueMaster[index].size( ));
+    _queueMaster[index][lane]->_queue.push() << tile;
 }
 
-void TileQueue::cycleData( const uint32_t frameNumber, const Compound* compound)
+void TileQueue::cycleData( const uint32_t frameNumber, const Compound* compound,
+                           const size_t nLanes )
 {
+    _nLanes = nLanes;
     for( unsigned i = 0; i < NUM_EYES; ++i )
     {
+        _queueMaster[i].clear();
         if( !compound->isInheritActive( Eye( 1<<i )))// eye pass not used
-        {
-            _queueMaster[i] = 0;
             continue;
-        }
 
-        // reuse unused queues
-        LatencyQueue* queue    = _queues.empty() ? 0 : _queues.back();
-        const uint32_t latency = getAutoObsolete();
-        const uint32_t dataAge = queue ? queue->_frameNumber : 0;
+        for( size_t j = 0; j < nLanes; ++j )
+            _queueMaster[i].push_back( _obtainQueue( frameNumber ));
+    }
+}
 
-        if( queue && dataAge < frameNumber-latency && frameNumber > latency )
-            // not used anymore
-            _queues.pop_back();
-        else // still used - allocate new data
-        {
-            queue = new LatencyQueue;
+TileQueue::LatencyQueue* TileQueue::_obtainQueue( const uint32_t frameNumber )
+{
+    // reuse unused queues
+    LatencyQueue* queue    = _queues.empty() ? 0 : _queues.back();
+    const uint32_t latency = getAutoObsolete();
+    const uint32_t dataAge = queue ? queue->_frameNumber : 0;
+
+    if( queue && dataAge < frameNumber-latency && frameNumber > latency )
+        // not used anymore
+        _queues.pop_back();
+    else // still used - allocate new data
+    {
+        queue = new LatencyQueue;
 
-            getLocalNode()->registerObject( &queue->_queue );
-            queue->_queue.setAutoObsolete( 1 ); // current + in use by render nodes
-        }
+        getLocalNode()->registerObject( &queue->_queue );
+        queue->_queue.setAutoObsolete( 1 ); // current + in use by render nodes
+    }
 
-        queue->_queue.clear();
-        queue->_frameNumber = frameNumber;
+    queue->_queue.clear();
+    queue->_frameNumber = frameNumber;
 
-        _queues.push_front( queue );
-        _queueMaster[i] = queue;
-    }
+    _queues.push_front( queue );
+    return queue;
 }
 
 void TileQueue::setOutputQueue( TileQueue* queue, const Compound* compound )
@@ -110,6 +116,23 @@ void TileQueue::setOutputQueue( TileQueue* queue, const Compound* compound )
     }
 }
 
+void TileQueue::setTileCost( const Vector2i& tile, const float cost )
+{
+    const TileCosts::key_type key( tile.x(), tile.y( ));
+    TileCosts::iterator i = _costs.find( key );
+    if( i == _costs.end( ))
+        _costs[ key ] = cost;
+    else
+        i->second = .5f * ( i->second + cost );
+}
+
+float TileQueue::getTileCost( const Vector2i& tile ) const
+{
+    const TileCosts::key_type key( tile.x(), tile.y( ));
+    TileCosts::const_iterator i = _costs.find( key );
+    return i == _costs.end() ? 0.f : i->second;
+}
+
 void TileQueue::getInstanceData( co::DataOStream& )
 {
 }
@@ -121,6 +144,7 @@ void TileQueue::applyInstanceData( co::DataIStream& )
 void TileQueue::flush()
 {
     unsetData();
+    _costs.clear();
 
     while( !_queues.empty( ))
     {
@@ -136,17 +160,17 @@ void TileQueue::unsetData()
 {
     for( unsigned i = 0; i < NUM_EYES; ++i )
     {
-        _queueMaster[i] = 0;
+        _queueMaster[i].clear();
         _outputQueue[i] = 0;
     }
+    _nLanes = 0;
 }
 
-uint128_t TileQueue::getQueueMasterID( const Eye eye ) const
+uint128_t TileQueue::getQueueMasterID( const Eye eye, const size_t lane ) const
 {
     uint32_t index = lunchbox::getIndexOfLastBit(eye);
-    LatencyQueue* queue = _queueMaster[ index ];
-    if ( queue )
-        return queue->_queue.getID();
+    if( lane < _queueMaster[ index ].size( ))
+        return _queueMaster[ index ][ lane ]->_queue.getID();
     return uint128_t();
 }
 
@@ -25,6 +25,8 @@
 #include <lunchbox/bitOperation.h> // function getIndexOfLastBit
 #include <co/queueMaster.h>
 
+#include <map>
+
 namespace eq
 {
 namespace server
@@ -60,18 +62,40 @@ namespace server
         /** @return the tile size. */
         const Vector2i& getTileSize() const { return _size; }
 
-        /** Add a tile to the queue. */
-        void addTile( const Tile& tile, const Eye eye );
+        /** Add a tile to the queue of the given lane. */
+        void addTile( const Tile& tile, const Eye eye, const size_t lane );
 
         /**
          * Cycle the current tile queue.
          *
-         * Used for output tile queues to allocate/recycle queue masters.
+         * Used for output tile queues to allocate/recycle queue masters. Each
+         * lane has its own queue master, which is drained first by the
+         * channel of the input queue using this lane.
          *
          * @param frameNumber the current frame number.
          * @param compound the compound holding the output frame.
+         * @param nLanes the number of lanes.
          */
-        void cycleData( const uint32_t frameNumber, const Compound* compound );
+        void cycleData( const uint32_t frameNumber, const Compound* compound,
+                        const size_t nLanes );
+
+        /** @return the number of lanes of an output queue. */
+        size_t getNumLanes() const { return _nLanes; }
+
+        /** Set the lane of an input queue in its output queue. */
+        void setLane( const size_t lane ) { _lane = lane; }
+
+        /** @return the lane of an input queue in its output queue. */
+        size_t getLane() const { return _lane; }
+
+        /** Update the measured cost of the tile at the given grid position. */
+        void setTileCost( const Vector2i& tile, const float cost );
+
+        /** @return the smoothed cost of the given tile, 0 if unknown. */
+        float getTileCost( const Vector2i& tile ) const;
+
+        /** @return true if tile costs have been measured. */
+        bool hasTileCosts() const { return !_costs.empty(); }
 
         void setOutputQueue( TileQueue* queue, const Compound* compound );
         const TileQueue* getOutputQueue( const Eye eye ) const
@@ -88,7 +112,7 @@ namespace server
         void flush();
         //@}
 
-        uint128_t getQueueMasterID( const Eye eye ) const;
+        uint128_t getQueueMasterID( const Eye eye, const size_t lane ) const;
 
     protected:
         EQSERVER_API virtual ChangeType getChangeType() const
@@ -116,8 +140,20 @@ namespace server
         /** The collage queue pool. */
         std::deque< LatencyQueue* > _queues;
 
-        /** the currently used tile queues */
-        LatencyQueue* _queueMaster[ NUM_EYES ];
+        /** the currently used tile queues, one per lane */
+        std::vector< LatencyQueue* > _queueMaster[ NUM_EYES ];
+
+        /** The number of lanes of an output queue. */
+        size_t _nLanes;
+
+        /** The lane of an input queue. */
+        size_t _lane;
+
+        /** The smoothed cost of each tile of an output queue. */
+        typedef std::map< std::pair< int32_t, int32_t >, float > TileCosts;
+        TileCosts _costs;
+
+        LatencyQueue* _obtainQueue( const uint32_t frameNumber );
 
         /** The current output queue. */
         TileQueue* _outputQueue[ NUM_EYES ];
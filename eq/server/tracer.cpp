@@ -0,0 +1,241 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "tracer.h"
+
+#include "channel.h"
+#include "log.h"
+#include "node.h"
+#include "pipe.h"
+
+#include <fstream>
+#include <limits>
+
+namespace eq
+{
+namespace server
+{
+namespace
+{
+static const uint32_t _serverPipe = std::numeric_limits< uint32_t >::max();
+
+/** The trace threads of a node, see _getThread(). */
+enum Thread
+{
+    THREAD_TRANSMIT, //!< the node transmit thread
+    THREAD_PIPE,     //!< the pipe render thread
+    THREAD_TRANSFER  //!< the pipe transfer thread
+};
+
+Thread _getThread( const Statistic::Type type )
+{
+    switch( type )
+    {
+    case Statistic::CHANNEL_ASYNC_READBACK:
+        return THREAD_TRANSFER;
+
+    case Statistic::CHANNEL_FRAME_TRANSMIT:
+    case Statistic::CHANNEL_FRAME_COMPRESS:
+    case Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN:
+        return THREAD_TRANSMIT;
+
+    default:
+        return THREAD_PIPE;
+    }
+}
+
+/** @return the trace thread identifier of a pipe's thread within its node */
+uint32_t _getThreadID( const uint32_t pipe, const Thread thread )
+{
+    return thread == THREAD_TRANSMIT ? 0 : pipe * 2 + uint32_t( thread );
+}
+
+std::string _escape( const std::string& input )
+{
+    std::string output;
+    output.reserve( input.size( ));
+    for( std::string::const_iterator i = input.begin(); i != input.end(); ++i)
+    {
+        const char c = *i;
+        if( c == '"' || c == '\\' )
+            output += '\\';
+        output += ( static_cast< unsigned char >( c ) < 0x20 ) ? ' ' : c;
+    }
+    return output;
+}
+
+void _writeName( std::ostream& os, const char* type, const uint32_t pid,
+                 const uint32_t tid, const std::string& name )
+{
+    os << ",\n{\"name\":\"" << type << "\",\"ph\":\"M\",\"pid\":" << pid
+       << ",\"tid\":" << tid << ",\"args\":{\"name\":\"" << _escape( name )
+       << "\"}}";
+}
+
+template< class T > std::string _getName( const T& entity, const char* type )
+{
+    const std::string& name = entity.getName();
+    if( !name.empty( ))
+        return name;
+    return std::string( type ) + " " + entity.getID().getShortString();
+}
+}
+
+Tracer::Tracer( const size_t capacity )
+    : _records( std::max( capacity, size_t( 1 )))
+    , _nRecords( 0 )
+{}
+
+Tracer::~Tracer()
+{}
+
+void Tracer::addFrame( const uint32_t frameNumber, const int64_t time )
+{
+    Statistic statistic = Statistic();
+    statistic.type = Statistic::CONFIG_START_FRAME;
+    statistic.frameNumber = frameNumber;
+    statistic.startTime = time;
+    statistic.endTime = time;
+    _add( statistic, _serverPipe );
+}
+
+void Tracer::addStatistics( const Channel& channel,
+                            const Statistics& statistics )
+{
+    if( statistics.empty( ))
+        return;
+
+    const uint32_t pipe = _getPipe( *channel.getPipe( ));
+    for( Statistics::const_iterator i = statistics.begin();
+         i != statistics.end(); ++i )
+        _add( *i, pipe );
+}
+
+void Tracer::_add( const Statistic& statistic, const uint32_t pipe )
+{
+    Record& record = _records[ _nRecords % _records.size() ];
+    record.statistic = statistic;
+    record.pipe = pipe;
+    ++_nRecords;
+}
+
+uint32_t Tracer::_getPipe( const Pipe& pipe )
+{
+    IndexHash::const_iterator i = _pipeIndex.find( pipe.getID( ));
+    if( i != _pipeIndex.end( ))
+        return i->second;
+
+    const uint32_t index = uint32_t( _pipes.size( ));
+    const PipeInfo info = { _getNode( *pipe.getNode( )),
+                            _getName( pipe, "pipe" ) };
+    _pipes.push_back( info );
+    _pipeIndex[ pipe.getID() ] = index;
+    return index;
+}
+
+uint32_t Tracer::_getNode( const Node& node )
+{
+    IndexHash::const_iterator i = _nodeIndex.find( node.getID( ));
+    if( i != _nodeIndex.end( ))
+        return i->second;
+
+    const uint32_t index = uint32_t( _nodes.size( ));
+    _nodes.push_back( _getName( node, "node" ));
+    _nodeIndex[ node.getID() ] = index;
+    return index;
+}
+
+bool Tracer::write( const std::string& filename ) const
+{
+    std::ofstream file( filename.c_str( ));
+    if( !file.is_open( ))
+    {
+        LBWARN << "Can't open " << filename << " to write statistics trace"
+               << std::endl;
+        return false;
+    }
+
+    // process 0 is the server, node processes start at 1
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+         << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,"
+         << "\"args\":{\"name\":\"server\"}}";
+    for( size_t i = 0; i < _nodes.size(); ++i )
+    {
+        const uint32_t pid = uint32_t( i ) + 1;
+        _writeName( file, "process_name", pid, 0, _nodes[i] );
+        _writeName( file, "thread_name", pid, 0, "transmit" );
+    }
+    for( size_t i = 0; i < _pipes.size(); ++i )
+    {
+        const PipeInfo& pipe = _pipes[i];
+        const uint32_t pid = pipe.node + 1;
+        _writeName( file, "thread_name", pid,
+                    _getThreadID( uint32_t( i ), THREAD_PIPE ), pipe.name );
+        _writeName( file, "thread_name", pid,
+                    _getThreadID( uint32_t( i ), THREAD_TRANSFER ),
+                    pipe.name + " transfer" );
+    }
+
+    const size_t capacity = _records.size();
+    const uint64_t first = _nRecords > capacity ? _nRecords - capacity : 0;
+    for( uint64_t i = first; i < _nRecords; ++i )
+        _write( file, _records[ i % capacity ] );
+
+    file << "\n]}" << std::endl;
+    if( !file.good( ))
+    {
+        LBWARN << "Error writing statistics trace to " << filename
+               << std::endl;
+        return false;
+    }
+
+    LBINFO << "Wrote " << _nRecords - first << " trace events to " << filename
+           << std::endl;
+    return true;
+}
+
+void Tracer::_write( std::ostream& os, const Record& record ) const
+{
+    const Statistic& statistic = record.statistic;
+    if( record.pipe == _serverPipe )
+    {
+        os << ",\n{\"name\":\"frame " << statistic.frameNumber
+           << "\",\"cat\":\"server\",\"ph\":\"i\",\"s\":\"g\",\"ts\":"
+           << statistic.startTime * 1000 << ",\"pid\":0,\"tid\":0}";
+        return;
+    }
+
+    const PipeInfo& pipe = _pipes[ record.pipe ];
+    const uint32_t tid = _getThreadID( record.pipe,
+                                       _getThread( statistic.type ));
+    const int64_t duration = std::max( statistic.endTime - statistic.startTime,
+                                       int64_t( 0 ));
+
+    os << ",\n{\"name\":\"" << _escape( Statistic::getName( statistic.type ))
+       << "\",\"cat\":\"channel\",\"ph\":\"X\",\"ts\":"
+       << statistic.startTime * 1000 << ",\"dur\":" << duration * 1000
+       << ",\"pid\":" << pipe.node + 1 << ",\"tid\":" << tid
+       << ",\"args\":{\"frame\":" << statistic.frameNumber
+       << ",\"task\":" << statistic.task << ",\"channel\":\""
+       << _escape( statistic.resourceName ) << "\"";
+    if( statistic.type == Statistic::CHANNEL_FRAME_COMPRESS )
+        os << ",\"ratio\":" << statistic.ratio;
+    os << "}}";
+}
+
+}
+}
@@ -0,0 +1,90 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef EQSERVER_TRACER_H
+#define EQSERVER_TRACER_H
+
+#include "types.h"
+
+#include <eq/fabric/statistic.h> // member
+#include <lunchbox/stdExt.h>     // member
+#include <boost/noncopyable.hpp>
+#include <iosfwd>
+#include <vector>
+
+namespace eq
+{
+namespace server
+{
+/**
+ * Records the statistics of all channels of a config in a ring buffer.
+ *
+ * The statistics carry the config time of the render clients, which is
+ * synchronized with the server time on each frame start. The recorded events
+ * are written in the Chrome trace event format, which can be loaded in
+ * chrome://tracing or the Perfetto UI. Each node is a process and each pipe
+ * thread, transfer thread and node transmit thread is a thread of the trace.
+ * Not thread safe, all methods are called from the server thread.
+ */
+class Tracer : public boost::noncopyable
+{
+public:
+    /** Construct a new tracer holding at most the given number of events. */
+    explicit Tracer( size_t capacity );
+    ~Tracer();
+
+    /** Record the start of a frame on the server. */
+    void addFrame( uint32_t frameNumber, int64_t time );
+
+    /** Record the statistics of one frame of a channel. */
+    void addStatistics( const Channel& channel, const Statistics& statistics );
+
+    /** Write the recorded events, oldest first. @return true on success. */
+    bool write( const std::string& filename ) const;
+
+private:
+    struct Record
+    {
+        Statistic statistic;
+        uint32_t pipe; //!< index in _pipes, or NONE for server events
+    };
+
+    struct PipeInfo
+    {
+        uint32_t node; //!< index in _nodes
+        std::string name;
+    };
+
+    typedef stde::hash_map< uint128_t, uint32_t > IndexHash;
+
+    std::vector< Record > _records;
+    uint64_t _nRecords; //!< number of records added in total
+
+    IndexHash _pipeIndex;
+    std::vector< PipeInfo > _pipes;
+    IndexHash _nodeIndex;
+    Strings _nodes;
+
+    void _add( const Statistic& statistic, uint32_t pipe );
+    void _write( std::ostream& os, const Record& record ) const;
+    uint32_t _getPipe( const Pipe& pipe );
+    uint32_t _getNode( const Node& node );
+};
+}
+}
+
+#endif // EQSERVER_TRACER_H
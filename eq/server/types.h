@@ -38,12 +38,16 @@ class CompoundVisitor;
 class Config;
 class ConfigVisitor;
 class DFREqualizer;
+class FoveatedEqualizer;
 class Equalizer;
 class Frame;
 class FrameData;
 class FramerateEqualizer;
+class GPUScheduler;
 class Layout;
+class LoadBenchmark;
 class LoadEqualizer;
+class LoadTrace;
 class MonitorEqualizer;
 class Node;
 class NodeFactory;
@@ -51,8 +55,10 @@ class Observer;
 class Pipe;
 class Segment;
 class Server;
+class SwapScheduler;
 class TileEqualizer;
 class TileQueue;
+class Tracer;
 class TreeEqualizer;
 class View;
 class ViewEqualizer;
@@ -127,6 +133,7 @@ using fabric::SwapBarrier;
 using fabric::SwapBarrierConstPtr;
 using fabric::SwapBarrierPtr;
 using fabric::Tile;
+using fabric::Vector2f;
 using fabric::Vector2i;
 using fabric::Vector3f;
 using fabric::Vector3ub;
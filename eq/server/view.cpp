@@ -365,6 +365,32 @@ void View::trigger( const Canvas* canvas, const bool active )
     }
 }
 
+void View::warm( const Canvas* canvas, const bool warm )
+{
+    Config* config = getConfig();
+    for( Channels::const_iterator i = _channels.begin();
+         i != _channels.end(); ++i )
+    {
+        Channel* channel = *i;
+        if( channel->getCanvas() != canvas )
+            continue;
+
+        ConfigDestCompoundVisitor visitor( channel, false /*activeOnly*/ );
+        config->accept( visitor );
+
+        const Compounds& compounds = visitor.getResult();
+        for( Compounds::const_iterator j = compounds.begin();
+             j != compounds.end(); ++j )
+        {
+            Compound* compound = *j;
+            if( warm )
+                compound->warmUp();
+            else
+                compound->coolDown();
+        }
+    }
+}
+
 void View::activateMode( const Mode mode )
 {
     if( getMode() == mode )
@@ -81,6 +81,14 @@ namespace server
          */
         void trigger( const Canvas* canvas, const bool active );
 
+        /**
+         * Keep the destination compounds of a canvas initialized.
+         *
+         * @param canvas The canvas using this view's layout.
+         * @param warm true to warm up, false to cool down.
+         */
+        void warm( const Canvas* canvas, const bool warm );
+
         /**
          * Activate the given mode on this view.
          *
@@ -48,8 +48,12 @@ Window::Window( Pipe* parent )
         , _active( 0 )
         , _state( STATE_STOPPED )
         , _maxFPS( std::numeric_limits< float >::max( ))
+        , _pacing( false )
         , _nvSwapBarrier( 0 )
         , _nvNetBarrier( 0 )
+        , _maxNVSwapBarriers( 0 )
+        , _hardwareSwapBarrier( false )
+        , _hardwareSwapJoined( false )
         , _lastDrawChannel( 0 )
         , _swapFinish( false )
         , _swap( false )
@@ -77,6 +81,8 @@ void Window::attach( const uint128_t& id, const uint32_t instanceID )
                      WindowFunc( this, &Window::_cmdConfigInitReply ), cmdQ );
     registerCommand( fabric::CMD_WINDOW_CONFIG_EXIT_REPLY,
                      WindowFunc( this, &Window::_cmdConfigExitReply ), cmdQ );
+    registerCommand( fabric::CMD_WINDOW_BARRIER_ARRIVAL,
+                     WindowFunc( this, &Window::_cmdBarrierArrival ), cmdQ );
 }
 
 void Window::removeChild( const uint128_t& id )
@@ -206,11 +212,13 @@ void Window::_resetSwapBarriers()
     }
 
     _nvNetBarrier = 0;
+    _hardwareSwapBarrier = false;
     _masterBarriers.clear();
     _barriers.clear();
+    _timedBarriers.clear();
 }
 
-co::Barrier* Window::joinSwapBarrier( co::Barrier* barrier )
+co::Barrier* Window::joinSwapBarrier( co::Barrier* barrier, const bool timed )
 {
     _swapFinish = true;
 
@@ -222,9 +230,14 @@ co::Barrier* Window::joinSwapBarrier( co::Barrier* barrier )
 
         _masterBarriers.push_back( barrier );
         _barriers.push_back( barrier );
+        if( timed )
+            _timedBarriers.push_back( barrier );
         return barrier;
     }
 
+    if( timed ) // only used for the barriers this window enters, see below
+        _timedBarriers.push_back( barrier );
+
     co::BarriersCIter i = lunchbox::find( _barriers, barrier );
     if( i != _barriers.end( )) // Issue #39: window already has this barrier
         return barrier;
@@ -425,14 +438,21 @@ void Window::_updateSwap( const uint32_t frameNumber )
         _swapFinish = false;
     }
 
+    // the share of GPUs used by other configs
+    const float limit = getConfig()->getFrameRateLimit();
+    if( limit < _maxFPS )
+        _maxFPS = limit;
+
     if( _maxFPS < std::numeric_limits< float >::max( ))
     {
         const float minFrameTime = 1000.0f / _maxFPS;
-        send( fabric::CMD_WINDOW_THROTTLE_FRAMERATE ) << minFrameTime;
+        send( fabric::CMD_WINDOW_THROTTLE_FRAMERATE ) << minFrameTime
+                                                      << _pacing;
         LBLOG( LOG_TASKS ) << "TASK Throttle framerate  "
                                << minFrameTime << std::endl;
 
         _maxFPS = std::numeric_limits< float >::max();
+        _pacing = false;
     }
 
     for( co::BarriersCIter i = _barriers.begin(); i != _barriers.end(); ++i )
@@ -445,6 +465,18 @@ void Window::_updateSwap( const uint32_t frameNumber )
             continue;
         }
 
+        if( lunchbox::find( _timedBarriers, barrier ) != _timedBarriers.end())
+        {
+            const Config* config = getConfig();
+            send( fabric::CMD_WINDOW_TIMED_BARRIER )
+                << co::ObjectVersion( barrier ) << frameNumber
+                << config->getFrameStartTime() << config->getSwapDeadline();
+            LBLOG( LOG_TASKS ) << "TASK timed barrier  barrier "
+                               << co::ObjectVersion( barrier ) << " deadline "
+                               << config->getSwapDeadline() << std::endl;
+            continue;
+        }
+
         send( fabric::CMD_WINDOW_BARRIER ) << co::ObjectVersion( barrier );
         LBLOG( LOG_TASKS ) << "TASK barrier  barrier "
                            << co::ObjectVersion( barrier ) << std::endl;
@@ -473,6 +505,16 @@ void Window::_updateSwap( const uint32_t frameNumber )
         }
     }
 
+    if( _hardwareSwapBarrier && !_hardwareSwapJoined )
+    {
+        // Join the first group and barrier of the frame lock device. An empty
+        // network barrier tells the window to not enter a network barrier.
+        send( fabric::CMD_WINDOW_NV_BARRIER ) << co::ObjectVersion()
+                                              << uint32_t( 1 ) << uint32_t( 1 );
+        _hardwareSwapJoined = true;
+        LBLOG( LOG_TASKS ) << "TASK join hardware swap barrier" << std::endl;
+    }
+
     _resetSwapBarriers();
 
     if( _swap )
@@ -492,6 +534,8 @@ bool Window::_cmdConfigInitReply( co::ICommand& cmd )
 
     LBASSERT( !needsDelete( ));
     _state = command.read< bool >() ? STATE_INIT_SUCCESS : STATE_INIT_FAILED;
+    _maxNVSwapBarriers = command.read< uint32_t >();
+    _hardwareSwapJoined = false;
     return true;
 }
 
@@ -509,6 +553,17 @@ bool Window::_cmdConfigExitReply( co::ICommand& cmd )
     return true;
 }
 
+bool Window::_cmdBarrierArrival( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    const uint32_t frameNumber = command.read< uint32_t >();
+    const int64_t offset = command.read< int64_t >();
+    const bool late = command.read< bool >();
+
+    getConfig()->addSwapArrival( frameNumber, offset, late );
+    return true;
+}
+
 void Window::output( std::ostream& os ) const
 {
     bool attrPrinted   = false;
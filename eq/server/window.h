@@ -102,9 +102,11 @@ namespace server
          *
          * @param barrier the net::Barrier for the swap barrier group, or 0 if
          *                this is the first window.
+         * @param timed release the barrier at the config's swap deadline.
          * @return the net::Barrier for the swap barrier group.
          */
-        co::Barrier* joinSwapBarrier( co::Barrier* barrier );
+        co::Barrier* joinSwapBarrier( co::Barrier* barrier,
+                                      bool timed = false );
 
         /**
          * Join a NV_swap_group barrier for the next update.
@@ -122,6 +124,16 @@ namespace server
         /** @return true if this window has entered a NV_swap_group. */
         bool hasNVSwapBarrier() const { return (_nvSwapBarrier != 0); }
 
+        /** @return the NV_swap_group barriers of the window's GPU. */
+        uint32_t getMaxNVSwapBarriers() const { return _maxNVSwapBarriers; }
+
+        /**
+         * Use the hardware swap barrier of a frame-locked GPU for the next
+         * update. The window joins the NV_swap_group once and stays in it
+         * until it is exited.
+         */
+        void joinHardwareSwapBarrier() { _hardwareSwapBarrier = true; }
+
         /** The last drawing channel for this entity. @internal */
         void setLastDrawChannel( const Channel* channel )
             { _lastDrawChannel = channel; }
@@ -130,6 +142,9 @@ namespace server
         /** The maximum frame rate for this window. @internal */
         void setMaxFPS( const float fps ) { _maxFPS = fps; }
         float getMaxFPS() const { return _maxFPS; }
+
+        /** Pace the swaps to the maximum frame rate. @internal */
+        void setPacing( const bool pacing ) { _pacing = pacing; }
         //@}
 
         /**
@@ -189,10 +204,15 @@ namespace server
         /** The maximum frame rate allowed for this window. */
         float _maxFPS;
 
+        /** Keep the swaps on an evenly spaced grid of the max frame rate. */
+        bool _pacing;
+
         /** The list of master swap barriers for the current frame. */
         co::Barriers _masterBarriers;
         /** The list of slave swap barriers for the current frame. */
         co::Barriers _barriers;
+        /** The swap barriers released at the swap deadline. */
+        co::Barriers _timedBarriers;
 
         /** The hardware swap barrier to use. */
         SwapBarrierConstPtr _nvSwapBarrier;
@@ -200,6 +220,15 @@ namespace server
         /** The network barrier used to protect hardware barrier entry. */
         co::Barrier* _nvNetBarrier;
 
+        /** The NV_swap_group barriers reported by the render client. */
+        uint32_t _maxNVSwapBarriers;
+
+        /** The automatic hardware swap barrier is used in the next update. */
+        bool _hardwareSwapBarrier;
+
+        /** The window has joined the automatic hardware swap barrier. */
+        bool _hardwareSwapJoined;
+
         /** The last draw channel for this entity */
         const Channel* _lastDrawChannel;
 
@@ -223,6 +252,7 @@ namespace server
         /* command handler functions. */
         bool _cmdConfigInitReply( co::ICommand& command );
         bool _cmdConfigExitReply( co::ICommand& command );
+        bool _cmdBarrierArrival( co::ICommand& command );
 
         // For access to _fixedPVP
         friend std::ostream& operator << ( std::ostream&, const Window*);
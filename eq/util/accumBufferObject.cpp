@@ -70,6 +70,23 @@ void AccumBufferObject::exit()
 void AccumBufferObject::load( const GLfloat value )
 {
     EQ_GL_ERROR( "before AccumBufferObject::load" );
+    if( value == 1.0f && GLEW_EXT_framebuffer_blit )
+    {
+        // Copy the read buffer in one pass, without the intermediate texture
+        GLint drawFBO = 0;
+        EQ_GL_CALL( glGetIntegerv( GL_DRAW_FRAMEBUFFER_BINDING_EXT, &drawFBO ));
+        bind( GL_DRAW_FRAMEBUFFER_EXT );
+        EQ_GL_CALL( glPushAttrib( GL_SCISSOR_BIT ));
+        EQ_GL_CALL( glDisable( GL_SCISSOR_TEST ));
+        EQ_GL_CALL( glBlitFramebufferEXT( _pvp.x, _pvp.y, _pvp.getXEnd(),
+                                          _pvp.getYEnd(), 0, 0, _pvp.w, _pvp.h,
+                                          GL_COLOR_BUFFER_BIT, GL_NEAREST ));
+        EQ_GL_CALL( glPopAttrib( ));
+        EQ_GL_CALL( glBindFramebufferEXT( GL_DRAW_FRAMEBUFFER_EXT, drawFBO ));
+        EQ_GL_ERROR( "after AccumBufferObject::load" );
+        return;
+    }
+
     _texture->copyFromFrameBuffer( _texture->getInternalFormat(), _pvp );
 
     const PixelViewport pvp( 0, 0, getWidth(), getHeight( ));
@@ -0,0 +1,415 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "asyncLoader.h"
+
+#include <eq/client/gl.h>
+#include <eq/client/pipe.h>
+#include <eq/client/systemWindow.h>
+#include <eq/client/window.h>
+#include <eq/client/windowSystem.h>
+#include <lunchbox/condition.h>
+#include <lunchbox/lock.h>
+#include <lunchbox/monitor.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/thread.h>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+#define glewGetContext() gl
+
+namespace eq
+{
+namespace util
+{
+namespace
+{
+enum State
+{
+    STATE_NEW,
+    STATE_QUEUED,
+    STATE_LOADING,
+    STATE_LOADED,
+    STATE_UPLOADING,
+    STATE_UPLOADED, //!< fenced, all later states are final
+    STATE_DONE,
+    STATE_FAILED,
+    STATE_CANCELED
+};
+}
+
+namespace detail
+{
+class AsyncJob
+{
+public:
+    AsyncJob() : state( STATE_NEW ), frameNumber( 0 ), fence( 0 ) {}
+
+    /** Change the state, @return false if the job was not in state from. */
+    bool set( const State from, const State to )
+    {
+        lunchbox::ScopedWrite mutex( lock );
+        if( state.get() != uint32_t( from ))
+            return false;
+        state = to;
+        return true;
+    }
+
+    bool cancel()
+    {
+        lunchbox::ScopedWrite mutex( lock );
+        if( state.get() >= uint32_t( STATE_UPLOADING ))
+            return false;
+        state = STATE_CANCELED;
+        return true;
+    }
+
+    /** Finish an uploaded job once its fence is signaled. */
+    bool finish( const GLuint64 timeout, const GLEWContext* gl )
+    {
+        if( state.get() != uint32_t( STATE_UPLOADED ))
+            return state.get() == uint32_t( STATE_DONE );
+
+        for( ;; )
+        {
+            switch( glClientWaitSync( fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                      timeout ))
+            {
+            case GL_ALREADY_SIGNALED:
+            case GL_CONDITION_SATISFIED:
+                EQ_GL_CALL( glDeleteSync( fence ));
+                fence = 0;
+                state = STATE_DONE;
+                return true;
+            case GL_TIMEOUT_EXPIRED:
+                if( timeout == 0 )
+                    return false;
+                break;
+            default:
+                EQ_GL_ERROR( "glClientWaitSync" );
+                return false;
+            }
+        }
+    }
+
+    lunchbox::Monitor< uint32_t > state;
+    lunchbox::Lock lock; //!< serializes state changes
+    uint32_t frameNumber;
+    GLsync fence; //!< signaled when the upload is complete
+};
+
+class AsyncLoader
+{
+public:
+    typedef util::AsyncLoader::JobPtr JobPtr;
+    typedef std::multimap< uint32_t, JobPtr,
+                           std::greater< uint32_t > > Queue;
+
+    explicit AsyncLoader( const size_t nWorkers_ )
+        : nWorkers( nWorkers_ )
+        , window( 0 )
+        , sharedWindow( 0 )
+        , running( false )
+    {}
+
+    /** @return the next job of the newest frame, or 0 when stopped. */
+    JobPtr pop( Queue& queue )
+    {
+        condition.lock();
+        while( running && queue.empty( ))
+            condition.wait();
+
+        JobPtr job;
+        if( running )
+        {
+            job = queue.begin()->second;
+            queue.erase( queue.begin( ));
+        }
+        condition.unlock();
+        return job;
+    }
+
+    void push( Queue& queue, JobPtr job )
+    {
+        condition.lock();
+        if( running )
+        {
+            queue.insert( std::make_pair( job->_impl->frameNumber, job ));
+            condition.broadcast();
+        }
+        else
+            job->_impl->cancel();
+        condition.unlock();
+    }
+
+    /** Cancel the jobs of frames before the given frame, needs the lock. */
+    size_t cancel( Queue& queue, const uint32_t frameNumber )
+    {
+        size_t nCanceled = 0;
+        const Queue::iterator begin = queue.upper_bound( frameNumber );
+        for( Queue::iterator i = begin; i != queue.end(); ++i )
+            if( i->second->_impl->cancel( ))
+                ++nCanceled;
+        queue.erase( begin, queue.end( ));
+        return nCanceled;
+    }
+
+    /** Cancel all queued jobs, needs the lock. */
+    void cancelAll()
+    {
+        for( Queue::iterator i = loads.begin(); i != loads.end(); ++i )
+            i->second->_impl->cancel();
+        for( Queue::iterator i = uploads.begin(); i != uploads.end(); ++i )
+            i->second->_impl->cancel();
+        loads.clear();
+        uploads.clear();
+    }
+
+    void runLoad()
+    {
+        for( ;; )
+        {
+            JobPtr job = pop( loads );
+            if( !job )
+                return;
+            if( !job->_impl->set( STATE_QUEUED, STATE_LOADING ))
+                continue; // canceled
+
+            if( !job->load( ))
+                job->_impl->set( STATE_LOADING, STATE_FAILED );
+            else if( job->_impl->set( STATE_LOADING, STATE_LOADED ))
+                push( uploads, job );
+        }
+    }
+
+    void runUpload()
+    {
+        sharedWindow->makeCurrent();
+        const GLEWContext* gl = sharedWindow->glewGetContext();
+
+        for( ;; )
+        {
+            JobPtr job = pop( uploads );
+            if( !job )
+                return;
+            if( !job->_impl->set( STATE_LOADED, STATE_UPLOADING ))
+                continue; // canceled
+
+            if( !job->upload( gl ))
+            {
+                job->_impl->set( STATE_UPLOADING, STATE_FAILED );
+                continue;
+            }
+
+            job->_impl->fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+            EQ_GL_CALL( glFlush( ));
+            job->_impl->set( STATE_UPLOADING, STATE_UPLOADED );
+        }
+    }
+
+    const size_t nWorkers;
+    Window* window;
+    SystemWindow* sharedWindow; //!< the context of the upload thread
+    std::vector< lunchbox::Thread* > threads;
+
+    lunchbox::Condition condition; //!< protects the queues and running
+    Queue loads;
+    Queue uploads;
+    bool running;
+};
+
+namespace
+{
+class LoadThread : public lunchbox::Thread
+{
+public:
+    explicit LoadThread( AsyncLoader& loader ) : _loader( loader ) {}
+    void run() override { _loader.runLoad(); }
+
+private:
+    AsyncLoader& _loader;
+};
+
+class UploadThread : public lunchbox::Thread
+{
+public:
+    explicit UploadThread( AsyncLoader& loader ) : _loader( loader ) {}
+    void run() override { _loader.runUpload(); }
+
+private:
+    AsyncLoader& _loader;
+};
+}
+}
+
+AsyncLoader::Job::Job()
+    : _impl( new detail::AsyncJob )
+{}
+
+AsyncLoader::Job::~Job()
+{
+    if( _impl->fence )
+        LBWARN << "Uploaded job deleted before it was finished" << std::endl;
+    delete _impl;
+}
+
+bool AsyncLoader::Job::isReady( const GLEWContext* gl )
+{
+    return _impl->finish( 0, gl );
+}
+
+bool AsyncLoader::Job::wait( const GLEWContext* gl )
+{
+    _impl->state.waitGE( STATE_UPLOADED );
+    return _impl->finish( 1000000000ull /* 1s */, gl );
+}
+
+bool AsyncLoader::Job::isFailed() const
+{
+    return _impl->state.get() >= uint32_t( STATE_FAILED );
+}
+
+void AsyncLoader::Job::cancel()
+{
+    _impl->cancel();
+}
+
+uint32_t AsyncLoader::Job::getFrameNumber() const
+{
+    return _impl->frameNumber;
+}
+
+AsyncLoader::AsyncLoader( const size_t nWorkers )
+    : _impl( new detail::AsyncLoader( nWorkers ))
+{}
+
+AsyncLoader::~AsyncLoader()
+{
+    LBASSERTINFO( !_impl->sharedWindow, "Async loader not stopped" );
+    stop();
+    delete _impl;
+}
+
+bool AsyncLoader::start( Window* window )
+{
+    LBASSERT( window );
+    LBASSERT( !_impl->sharedWindow );
+    if( _impl->sharedWindow )
+        return true;
+
+    // create another (shared) system window with no drawable
+    WindowSettings settings = window->getSettings();
+    settings.setIAttribute( WindowSettings::IATTR_HINT_DRAWABLE, OFF );
+    const Window* sharedContextWindow = window->getSharedContextWindow();
+    settings.setSharedContextWindow( sharedContextWindow ?
+                                     sharedContextWindow->getSystemWindow() :
+                                     window->getSystemWindow( ));
+    const Pipe* pipe = window->getPipe();
+    SystemWindow* sharedWindow =
+        pipe->getWindowSystem().createWindow( window, settings );
+
+    if( sharedWindow && !sharedWindow->configInit( ))
+    {
+        LBWARN << "Async loader window initialization failed" << std::endl;
+        delete sharedWindow;
+        sharedWindow = 0;
+    }
+    window->makeCurrent( false );
+    if( !sharedWindow )
+        return false;
+
+    _impl->window = window;
+    _impl->sharedWindow = sharedWindow;
+    _impl->running = true;
+
+    _impl->threads.push_back( new detail::UploadThread( *_impl ));
+    for( size_t i = 0; i < _impl->nWorkers; ++i )
+        _impl->threads.push_back( new detail::LoadThread( *_impl ));
+
+    for( size_t i = 0; i < _impl->threads.size(); ++i )
+    {
+        if( !_impl->threads[i]->start( ))
+        {
+            LBWARN << "Async loader thread start failed" << std::endl;
+            stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+void AsyncLoader::stop()
+{
+    if( !_impl->sharedWindow )
+        return;
+
+    _impl->condition.lock();
+    _impl->running = false;
+    _impl->cancelAll();
+    _impl->condition.broadcast();
+    _impl->condition.unlock();
+
+    for( size_t i = 0; i < _impl->threads.size(); ++i )
+    {
+        lunchbox::Thread* thread = _impl->threads[i];
+        if( thread->isRunning( ))
+            thread->join();
+        delete thread;
+    }
+    _impl->threads.clear();
+
+    _impl->sharedWindow->configExit();
+    delete _impl->sharedWindow;
+    _impl->sharedWindow = 0;
+
+    if( _impl->window->getSystemWindow( ))
+        _impl->window->makeCurrent( false );
+    _impl->window = 0;
+}
+
+bool AsyncLoader::isRunning() const
+{
+    return _impl->sharedWindow != 0;
+}
+
+const Window* AsyncLoader::getWindow() const
+{
+    return _impl->window;
+}
+
+void AsyncLoader::submit( JobPtr job, const uint32_t frameNumber )
+{
+    LBASSERT( job );
+    job->_impl->frameNumber = frameNumber;
+    if( job->_impl->set( STATE_NEW, STATE_QUEUED ))
+        _impl->push( _impl->loads, job );
+    else
+        LBWARN << "Async loader job submitted twice" << std::endl;
+}
+
+size_t AsyncLoader::cancel( const uint32_t frameNumber )
+{
+    _impl->condition.lock();
+    const size_t nCanceled = _impl->cancel( _impl->loads, frameNumber ) +
+                             _impl->cancel( _impl->uploads, frameNumber );
+    _impl->condition.unlock();
+    return nCanceled;
+}
+}
+}
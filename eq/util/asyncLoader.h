@@ -0,0 +1,167 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQUTIL_ASYNCLOADER_H
+#define EQUTIL_ASYNCLOADER_H
+
+#include <eq/util/types.h>
+#include <eq/client/api.h>
+#include <lunchbox/referenced.h>
+
+namespace eq
+{
+namespace util
+{
+namespace detail { class AsyncLoader; class AsyncJob; }
+
+/**
+ * Loads resources in the background and uploads them on a shared context.
+ *
+ * A pool of worker threads runs Job::load() to read and decode data without
+ * an OpenGL context. One upload thread then runs Job::upload() with a context
+ * shared with the render windows, and fences the created OpenGL objects. The
+ * render thread polls Job::isReady() and uses the objects once the fence is
+ * signaled, without stalling on the loading or the upload.
+ *
+ * Jobs are keyed by the frame they were submitted for. The jobs of the newest
+ * frame are processed first, and the jobs of older frames can be canceled
+ * while they are still queued, e.g., when the data of a previous view is no
+ * longer needed.
+ *
+ * Each Pipe provides one loader, see Pipe::getAsyncLoader().
+ * @version 1.8
+ */
+class AsyncLoader : public boost::noncopyable
+{
+public:
+    /** One resource to load, implemented by the application. @version 1.8 */
+    class Job : public lunchbox::Referenced, public boost::noncopyable
+    {
+    public:
+        EQ_API Job();
+        EQ_API virtual ~Job();
+
+        /**
+         * Load and decode the data, called from a worker thread.
+         *
+         * No OpenGL context is current.
+         * @return false on failure, which skips the upload.
+         * @version 1.8
+         */
+        virtual bool load() { return true; }
+
+        /**
+         * Create the OpenGL objects of the loaded data.
+         *
+         * Called from the upload thread with the shared context current.
+         * @return false on failure.
+         * @version 1.8
+         */
+        virtual bool upload( const GLEWContext* glewContext ) = 0;
+
+        /**
+         * @return true if the uploaded objects can be used, without blocking.
+         * @param glewContext the current context of the calling thread.
+         * @version 1.8
+         */
+        EQ_API bool isReady( const GLEWContext* glewContext );
+
+        /**
+         * Wait until the job is finished.
+         *
+         * @param glewContext the current context of the calling thread.
+         * @return true if the uploaded objects can be used, false if the job
+         *         failed or was canceled.
+         * @version 1.8
+         */
+        EQ_API bool wait( const GLEWContext* glewContext );
+
+        /** @return true if the job failed or was canceled. @version 1.8 */
+        EQ_API bool isFailed() const;
+
+        /** Cancel the job unless its upload was started. @version 1.8 */
+        EQ_API void cancel();
+
+        /** @return the frame the job was submitted for. @version 1.8 */
+        EQ_API uint32_t getFrameNumber() const;
+
+    private:
+        detail::AsyncJob* const _impl;
+        friend class detail::AsyncLoader;
+    };
+    typedef lunchbox::RefPtr< Job > JobPtr; //!< A reference to a Job
+
+    /**
+     * Construct a new, stopped loader.
+     *
+     * @param nWorkers the number of threads loading data.
+     * @version 1.8
+     */
+    EQ_API explicit AsyncLoader( const size_t nWorkers = 2 );
+
+    /** Destruct the loader, it has to be stopped. @version 1.8 */
+    EQ_API ~AsyncLoader();
+
+    /**
+     * Start the worker and upload threads.
+     *
+     * Creates the upload context, shared with the given window's context. To
+     * be called from the thread of the window.
+     * @return true on success, false if the shared context can't be created.
+     * @version 1.8
+     */
+    EQ_API bool start( Window* window );
+
+    /**
+     * Cancel all queued jobs and stop all threads.
+     *
+     * To be called from the thread which started the loader.
+     * @version 1.8
+     */
+    EQ_API void stop();
+
+    /** @return true if the loader was started. @version 1.8 */
+    EQ_API bool isRunning() const;
+
+    /** @return the window sharing the upload context. @version 1.8 */
+    EQ_API const Window* getWindow() const;
+
+    /**
+     * Queue a job for loading and upload. Thread safe.
+     *
+     * @param job the job.
+     * @param frameNumber the frame the job is needed for.
+     * @version 1.8
+     */
+    EQ_API void submit( JobPtr job, const uint32_t frameNumber );
+
+    /**
+     * Cancel all queued jobs submitted for frames before the given frame.
+     *
+     * Jobs being loaded or uploaded are not interrupted. Thread safe.
+     * @return the number of canceled jobs.
+     * @version 1.8
+     */
+    EQ_API size_t cancel( const uint32_t frameNumber );
+
+private:
+    detail::AsyncLoader* const _impl;
+};
+}
+}
+
+#endif // EQUTIL_ASYNCLOADER_H
@@ -29,6 +29,7 @@
 
 #include <eq/util/accum.h>
 #include <eq/util/accumBufferObject.h>
+#include <eq/util/asyncLoader.h>
 #include <eq/util/bitmapFont.h>
 #include <eq/util/frameBufferObject.h>
 #include <eq/util/objectManager.h>
@@ -1,5 +1,5 @@
 
-/* Copyright (c) 2008-2014, Stefan Eilemann <eile@equalizergraphics.com>
+/* Copyright (c) 2008-2015, Stefan Eilemann <eile@equalizergraphics.com>
  *
  * This library is free software; you can redistribute it and/or modify it under
  * the terms of the GNU Lesser General Public License version 2.1 as published
@@ -16,29 +16,372 @@
  */
 
 #include "bitmapFont.h"
+
+#include "frameBufferObject.h"
 #include "objectManager.h"
+#include "shader.h"
 
 #include <eq/client/gl.h>
 #include <eq/client/windowSystem.h>
 
+#include <cmath>
+#include <vector>
+
 namespace eq
 {
 namespace util
 {
+namespace
+{
+const char FIRST_GLYPH = ' ';
+const char LAST_GLYPH = '~';
+const size_t N_GLYPHS = LAST_GLYPH - FIRST_GLYPH + 1;
+const size_t N_COLUMNS = 16;
+const size_t N_ROWS = ( N_GLYPHS + N_COLUMNS - 1 ) / N_COLUMNS;
+const size_t N_FLOATS = 9; //!< per vertex: position, texture coord, color
+
+const char* const _vertexShader =
+    "uniform vec2 viewport;\n"
+    "in vec3 vertex;\n"
+    "in vec2 texCoord;\n"
+    "in vec4 color;\n"
+    "out vec2 glyphCoord;\n"
+    "out vec4 glyphColor;\n"
+    "void main()\n"
+    "{\n"
+    "    glyphCoord = texCoord;\n"
+    "    glyphColor = color;\n"
+    "    gl_Position = vec4( vertex.xy / viewport * 2.0 - 1.0,\n"
+    "                        vertex.z * 2.0 - 1.0, 1.0 );\n"
+    "}\n";
+
+const char* const _fragmentShader =
+    "uniform sampler2D atlas;\n"
+    "in vec2 glyphCoord;\n"
+    "in vec4 glyphColor;\n"
+    "void main()\n"
+    "{\n"
+    "    if( texture( atlas, glyphCoord ).r < 0.5 )\n"
+    "        discard;\n"
+    "    fragColor = glyphColor;\n"
+    "}\n";
+}
+
 namespace detail
 {
 class BitmapFont
 {
 public:
+    enum Key
+    {
+        KEY_TEXTURE,
+        KEY_BUFFER,
+        KEY_PROGRAM,
+        KEY_ALL
+    };
+
     BitmapFont( util::ObjectManager& om_, const void* key_ )
         // We create a new shared object manager. Typically we are exited by
         // the last user, at which point the given OM may have been deleted
         : om( om_ )
         , key( key_ )
+        , texture( 0 )
+        , buffer( 0 )
+        , program( 0 )
+        , viewportUniform( -1 )
+        , cellWidth( 0 )
+        , cellHeight( 0 )
+        , padding( 0 )
+        , descent( 0 )
+        , advances( N_GLYPHS, 0.f )
     {}
 
+    const GLEWContext* glewGetContext() const { return om.glewGetContext(); }
+
+    /** @return a unique key for the given OpenGL object of this font. */
+    const void* getKey( const Key which ) const { return &keys[ which ]; }
+
+    bool hasAtlas() const { return program != 0; }
+
+    /** Render the glyphs of the display lists into the texture atlas. */
+    bool initAtlas( const GLuint lists, const uint32_t size )
+    {
+        if( !GLEW_VERSION_2_0 || !GLEW_EXT_framebuffer_object ||
+            !om.supportsBuffers() || !om.supportsPrograms( ))
+        {
+            return false;
+        }
+
+        GLint oldFBO = 0;
+        GLint oldProgram = 0;
+        EQ_GL_CALL( glGetIntegerv( GL_FRAMEBUFFER_BINDING_EXT, &oldFBO ));
+        EQ_GL_CALL( glGetIntegerv( GL_CURRENT_PROGRAM, &oldProgram ));
+        EQ_GL_CALL( glPushAttrib( GL_ALL_ATTRIB_BITS ));
+        EQ_GL_CALL( glPushClientAttrib( GL_CLIENT_PIXEL_STORE_BIT ));
+        EQ_GL_CALL( glUseProgram( 0 ));
+
+        glDisable( GL_ALPHA_TEST );
+        glDisable( GL_BLEND );
+        glDisable( GL_COLOR_LOGIC_OP );
+        glDisable( GL_DEPTH_TEST );
+        glDisable( GL_FOG );
+        glDisable( GL_LIGHTING );
+        glDisable( GL_SCISSOR_TEST );
+        glDisable( GL_STENCIL_TEST );
+        glDisable( GL_TEXTURE_2D );
+
+        // measure the advance of each glyph without touching the drawable
+        EQ_GL_CALL( glColorMask( GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE ));
+        float maxAdvance = 0.f;
+        for( size_t i = 0; i < N_GLYPHS; ++i )
+        {
+            GLfloat position[4];
+            glWindowPos2i( 0, 0 );
+            glCallList( lists + FIRST_GLYPH + GLuint( i ));
+            glGetFloatv( GL_CURRENT_RASTER_POSITION, position );
+            advances[i] = position[0];
+            maxAdvance = LB_MAX( maxAdvance, position[0] );
+        }
+        EQ_GL_CALL( glColorMask( GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE ));
+
+        // glyph bitmaps may extend beyond their advance and baseline
+        padding = int32_t( size / 4 + 1 );
+        descent = int32_t( size / 3 + 1 );
+        cellWidth = int32_t( std::ceil( maxAdvance )) + 2 * padding;
+        cellHeight = int32_t( size ) + descent + padding;
+        const int32_t width = cellWidth * int32_t( N_COLUMNS );
+        const int32_t height = cellHeight * int32_t( N_ROWS );
+
+        std::vector< uint8_t > pixels( width * height );
+        FrameBufferObject fbo( glewGetContext( ));
+        const bool rendered = !fbo.init( width, height, GL_RGBA8, 0, 0 );
+        if( rendered )
+        {
+            glViewport( 0, 0, width, height );
+            glClearColor( 0.f, 0.f, 0.f, 0.f );
+            glClear( GL_COLOR_BUFFER_BIT );
+            glColor4f( 1.f, 1.f, 1.f, 1.f );
+
+            for( size_t i = 0; i < N_GLYPHS; ++i )
+            {
+                glWindowPos2i( int32_t( i % N_COLUMNS ) * cellWidth + padding,
+                               int32_t( i / N_COLUMNS ) * cellHeight + descent);
+                glCallList( lists + FIRST_GLYPH + GLuint( i ));
+            }
+
+            glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+            EQ_GL_CALL( glReadPixels( 0, 0, width, height, GL_RED,
+                                      GL_UNSIGNED_BYTE, pixels.data( )));
+            fbo.exit();
+        }
+        EQ_GL_CALL( glBindFramebufferEXT( GL_FRAMEBUFFER_EXT, oldFBO ));
+
+        bool ok = rendered && _initObjects( width, height, pixels.data( ));
+        EQ_GL_CALL( glPopClientAttrib( ));
+        EQ_GL_CALL( glPopAttrib( ));
+        EQ_GL_CALL( glUseProgram( oldProgram ));
+
+        if( !ok )
+            exitAtlas();
+        return ok;
+    }
+
+    void exitAtlas()
+    {
+        if( texture )
+            om.deleteTexture( getKey( KEY_TEXTURE ));
+        if( buffer )
+            om.deleteBuffer( getKey( KEY_BUFFER ));
+        if( program )
+            om.deleteProgram( getKey( KEY_PROGRAM ));
+        texture = buffer = program = 0;
+        vertices.clear();
+    }
+
+    /** Queue the quads of the text. @return the advance of the text. */
+    float queue( const std::string& text, const Vector3f& position,
+                 const Vector4f& color )
+    {
+        const float atlasWidth = float( cellWidth * int32_t( N_COLUMNS ));
+        const float atlasHeight = float( cellHeight * int32_t( N_ROWS ));
+        const float x = std::floor( position.x( ) + .5f );
+        const float y = std::floor( position.y( ) + .5f ) - float( descent );
+        float advance = 0.f;
+
+        vertices.reserve( vertices.size() + text.size() * 6 * N_FLOATS );
+        for( size_t i = 0; i < text.size(); ++i )
+        {
+            const char c = text[i];
+            if( c < FIRST_GLYPH || c > LAST_GLYPH )
+            {
+                advance += advances[ 0 ]; // space
+                continue;
+            }
+
+            const size_t glyph = c - FIRST_GLYPH;
+            if( c != ' ' )
+            {
+                const float x0 = x + advance - float( padding );
+                const float x1 = x0 + float( cellWidth );
+                const float y1 = y + float( cellHeight );
+                const float u0 = float( int32_t( glyph % N_COLUMNS ) *
+                                        cellWidth ) / atlasWidth;
+                const float u1 = u0 + float( cellWidth ) / atlasWidth;
+                const float v0 = float( int32_t( glyph / N_COLUMNS ) *
+                                        cellHeight ) / atlasHeight;
+                const float v1 = v0 + float( cellHeight ) / atlasHeight;
+
+                _addVertex( x0, y,  position.z(), u0, v0, color );
+                _addVertex( x1, y,  position.z(), u1, v0, color );
+                _addVertex( x1, y1, position.z(), u1, v1, color );
+                _addVertex( x0, y,  position.z(), u0, v0, color );
+                _addVertex( x1, y1, position.z(), u1, v1, color );
+                _addVertex( x0, y1, position.z(), u0, v1, color );
+            }
+            advance += advances[ glyph ];
+        }
+        return advance;
+    }
+
+    void flush()
+    {
+        if( vertices.empty( ))
+            return;
+        if( !hasAtlas( ))
+        {
+            vertices.clear();
+            return;
+        }
+
+        GLint viewport[4];
+        EQ_GL_CALL( glGetIntegerv( GL_VIEWPORT, viewport ));
+        EQ_GL_CALL( glUseProgram( program ));
+        EQ_GL_CALL( glUniform2f( viewportUniform, float( viewport[2] ),
+                                 float( viewport[3] )));
+        EQ_GL_CALL( glActiveTexture( GL_TEXTURE0 ));
+        EQ_GL_CALL( glBindTexture( GL_TEXTURE_2D, texture ));
+
+        // vertex arrays are not shared between contexts, use a temporary one
+        const bool useVAO = GLEW_VERSION_3_0 || GLEW_ARB_vertex_array_object;
+        GLint oldVAO = 0;
+        GLuint vao = 0;
+        if( useVAO )
+        {
+            EQ_GL_CALL( glGetIntegerv( GL_VERTEX_ARRAY_BINDING, &oldVAO ));
+            EQ_GL_CALL( glGenVertexArrays( 1, &vao ));
+            EQ_GL_CALL( glBindVertexArray( vao ));
+        }
+
+        // orphan and refill the stream buffer with all queued text
+        const GLsizei stride = GLsizei( N_FLOATS * sizeof( float ));
+        const char* offset = 0;
+        EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, buffer ));
+        EQ_GL_CALL( glBufferData( GL_ARRAY_BUFFER,
+                                  vertices.size() * sizeof( float ),
+                                  vertices.data(), GL_STREAM_DRAW ));
+        for( GLuint i = 0; i < 3; ++i )
+            EQ_GL_CALL( glEnableVertexAttribArray( i ));
+        EQ_GL_CALL( glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, stride,
+                                           offset ));
+        EQ_GL_CALL( glVertexAttribPointer( 1, 2, GL_FLOAT, GL_FALSE, stride,
+                                           offset + 3 * sizeof( float )));
+        EQ_GL_CALL( glVertexAttribPointer( 2, 4, GL_FLOAT, GL_FALSE, stride,
+                                           offset + 5 * sizeof( float )));
+
+        EQ_GL_CALL( glDrawArrays( GL_TRIANGLES, 0,
+                                  GLsizei( vertices.size() / N_FLOATS )));
+
+        if( useVAO )
+        {
+            EQ_GL_CALL( glBindVertexArray( oldVAO ));
+            EQ_GL_CALL( glDeleteVertexArrays( 1, &vao ));
+        }
+        else
+            for( GLuint i = 0; i < 3; ++i )
+                EQ_GL_CALL( glDisableVertexAttribArray( i ));
+
+        EQ_GL_CALL( glBindBuffer( GL_ARRAY_BUFFER, 0 ));
+        EQ_GL_CALL( glBindTexture( GL_TEXTURE_2D, 0 ));
+        EQ_GL_CALL( glUseProgram( 0 ));
+        vertices.clear();
+    }
+
     util::ObjectManager om;
     const void* key;
+
+    GLuint texture;
+    GLuint buffer;
+    GLuint program;
+    GLint viewportUniform;
+
+    int32_t cellWidth;
+    int32_t cellHeight;
+    int32_t padding; //!< left of the glyph origin in a cell
+    int32_t descent; //!< below the baseline in a cell
+    std::vector< float > advances;
+    std::vector< float > vertices; //!< queued for the next flush
+
+private:
+    uint8_t keys[ KEY_ALL ];
+
+    bool _initObjects( const int32_t width, const int32_t height,
+                       const uint8_t* pixels )
+    {
+        texture = om.newTexture( getKey( KEY_TEXTURE ));
+        buffer = om.newBuffer( getKey( KEY_BUFFER ));
+        program = om.newProgram( getKey( KEY_PROGRAM ));
+        if( !texture || !buffer || !program )
+            return false;
+
+        const GLint format = GLEW_ARB_texture_rg ? GL_R8 : GL_LUMINANCE8;
+        EQ_GL_CALL( glBindTexture( GL_TEXTURE_2D, texture ));
+        EQ_GL_CALL( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                                     GL_NEAREST ));
+        EQ_GL_CALL( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
+                                     GL_NEAREST ));
+        EQ_GL_CALL( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
+                                     GL_CLAMP_TO_EDGE ));
+        EQ_GL_CALL( glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,
+                                     GL_CLAMP_TO_EDGE ));
+        glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+        EQ_GL_CALL( glTexImage2D( GL_TEXTURE_2D, 0, format, width, height, 0,
+                                  GLEW_ARB_texture_rg ? GL_RED : GL_LUMINANCE,
+                                  GL_UNSIGNED_BYTE, pixels ));
+
+        // GLSL 1.50 for core profiles, 1.20 otherwise
+        const bool glsl150 = GLEW_VERSION_3_2;
+        const std::string vertexShader = std::string( glsl150 ?
+            "#version 150\n" :
+            "#version 120\n#define in attribute\n#define out varying\n" ) +
+            _vertexShader;
+        const std::string fragmentShader = std::string( glsl150 ?
+            "#version 150\nout vec4 fragColor;\n" :
+            "#version 120\n#define in varying\n#define fragColor gl_FragColor\n"
+            "#define texture texture2D\n" ) + _fragmentShader;
+
+        EQ_GL_CALL( glBindAttribLocation( program, 0, "vertex" ));
+        EQ_GL_CALL( glBindAttribLocation( program, 1, "texCoord" ));
+        EQ_GL_CALL( glBindAttribLocation( program, 2, "color" ));
+        if( !shader::linkProgram( glewGetContext(), program,
+                                  vertexShader.c_str(),
+                                  fragmentShader.c_str( )))
+        {
+            return false;
+        }
+
+        EQ_GL_CALL( glUseProgram( program ));
+        EQ_GL_CALL( glUniform1i( glGetUniformLocation( program, "atlas" ), 0));
+        viewportUniform = glGetUniformLocation( program, "viewport" );
+        return true;
+    }
+
+    void _addVertex( const float x, const float y, const float z,
+                     const float u, const float v, const Vector4f& color )
+    {
+        const float vertex[ N_FLOATS ] = { x, y, z, u, v, color.x(),
+                                           color.y(), color.z(), color.w() };
+        vertices.insert( vertices.end(), vertex, vertex + N_FLOATS );
+    }
 };
 }
 
@@ -50,7 +393,7 @@ BitmapFont::BitmapFont( ObjectManager& om, const void* key )
 BitmapFont::~BitmapFont()
 {
     const GLuint lists = _impl->om.getList( _impl->key );
-    if( lists != ObjectManager::INVALID )
+    if( lists != ObjectManager::INVALID || _impl->hasAtlas( ))
         LBWARN << "OpenGL BitmapFont was not freed" << std::endl;
     delete _impl;
 }
@@ -58,11 +401,19 @@ BitmapFont::~BitmapFont()
 bool BitmapFont::init( const WindowSystem& ws, const std::string& name,
                        const uint32_t size )
 {
-    return ws.setupFont( _impl->om, _impl->key, name, size );
+    if( !ws.setupFont( _impl->om, _impl->key, name, size ))
+        return false;
+
+    const GLuint lists = _impl->om.getList( _impl->key );
+    if( lists != ObjectManager::INVALID && !_impl->initAtlas( lists, size ))
+        LBINFO << "Font texture atlas not supported, using display lists"
+               << std::endl;
+    return true;
 }
 
 void BitmapFont::exit()
 {
+    _impl->exitAtlas();
     GLuint lists = _impl->om.getList( _impl->key );
     if( lists != ObjectManager::INVALID )
         _impl->om.deleteList( _impl->key );
@@ -70,13 +421,63 @@ void BitmapFont::exit()
 
 void BitmapFont::draw( const std::string& text ) const
 {
-    const GLuint lists = _impl->om.getList( _impl->key );
-    if( lists != ObjectManager::INVALID )
+    GLint list = 0;
+    if( _impl->hasAtlas( ))
+        glGetIntegerv( GL_LIST_INDEX, &list );
+
+    // queries are not recorded in display lists, use the lists of the font
+    if( !_impl->hasAtlas() || list != 0 )
     {
-        glListBase( lists );
-        glCallLists( GLsizei( text.size( )), GL_UNSIGNED_BYTE, text.c_str( ));
-        glListBase( 0 );
+        const GLuint lists = _impl->om.getList( _impl->key );
+        if( lists != ObjectManager::INVALID )
+        {
+            glListBase( lists );
+            glCallLists( GLsizei( text.size( )), GL_UNSIGNED_BYTE,
+                         text.c_str( ));
+            glListBase( 0 );
+        }
+        return;
     }
+
+    GLint valid = GL_FALSE;
+    glGetIntegerv( GL_CURRENT_RASTER_POSITION_VALID, &valid );
+    if( !valid )
+        return;
+
+    GLfloat position[4];
+    GLfloat color[4];
+    GLint viewport[4];
+    glGetFloatv( GL_CURRENT_RASTER_POSITION, position );
+    glGetFloatv( GL_CURRENT_RASTER_COLOR, color );
+    glGetIntegerv( GL_VIEWPORT, viewport );
+
+    const float advance = _impl->queue( text,
+                                        Vector3f( position[0] - viewport[0],
+                                                  position[1] - viewport[1],
+                                                  position[2] ),
+                                        Vector4f( color[0], color[1],
+                                                  color[2], color[3] ));
+    _impl->flush();
+
+    // advance the raster position like the bitmaps of the display lists
+    glBitmap( 0, 0, 0.f, 0.f, advance, 0.f, 0 );
+}
+
+void BitmapFont::queue( const std::string& text, const Vector3f& position,
+                        const Vector4f& color ) const
+{
+    if( _impl->hasAtlas( ))
+        _impl->queue( text, position, color );
+}
+
+void BitmapFont::flush() const
+{
+    _impl->flush();
+}
+
+bool BitmapFont::hasAtlas() const
+{
+    return _impl->hasAtlas();
 }
 
 }
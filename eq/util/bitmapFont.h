@@ -1,5 +1,5 @@
 
-/* Copyright (c) 2008-2014, Stefan Eilemann <eile@equalizergraphics.com>
+/* Copyright (c) 2008-2015, Stefan Eilemann <eile@equalizergraphics.com>
  *
  * This library is free software; you can redistribute it and/or modify it under
  * the terms of the GNU Lesser General Public License version 2.1 as published
@@ -27,7 +27,15 @@ namespace util
 {
 namespace detail { class BitmapFont; }
 
-/** A wrapper around AGL, WGL and GLX bitmap fonts. */
+/**
+ * A wrapper around AGL, WGL and GLX bitmap fonts.
+ *
+ * During init(), the printable ASCII glyphs of the window system font are
+ * rendered once into a texture atlas. Text is then drawn as textured quads
+ * from a streaming vertex buffer, batching all text queued between flush()
+ * calls into one draw call. If the atlas can't be created, draw() falls back
+ * to the display lists of the window system font.
+ */
 class BitmapFont : public boost::noncopyable
 {
 public:
@@ -76,10 +84,38 @@ public:
 
     /**
      * Draw text on the current raster position.
+     *
+     * Uses the current raster color and advances the raster position like
+     * bitmap drawing. Needs a compatibility profile context.
      * @version 1.0
      */
     EQ_API void draw( const std::string& text ) const;
 
+    /**
+     * Queue text for drawing during the next flush().
+     *
+     * @param text the text to draw.
+     * @param position the start of the text baseline in window coordinates
+     *                 relative to the current viewport, and its window depth.
+     * @param color the color of the text.
+     * @version 1.9
+     */
+    EQ_API void queue( const std::string& text, const Vector3f& position,
+                       const Vector4f& color ) const;
+
+    /**
+     * Draw all queued text using one draw call.
+     *
+     * Only uses OpenGL functions of the core profile. Leaves the current
+     * program, the array buffer and the 2D texture of the active texture unit
+     * unbound. Does nothing if the texture atlas is not available.
+     * @version 1.9
+     */
+    EQ_API void flush() const;
+
+    /** @return true if the texture atlas is used for drawing. @version 1.9 */
+    EQ_API bool hasAtlas() const;
+
 private:
     detail::BitmapFont* const _impl;
 };
@@ -2,11 +2,13 @@
 set(UTIL_HEADERS
   ../util/accum.h
   ../util/accumBufferObject.h
+  ../util/asyncLoader.h
   ../util/base.h
   ../util/bitmapFont.h
   ../util/frameBufferObject.h
   ../util/objectManager.h
   ../util/pixelBufferObject.h
+  ../util/pixelBufferPool.h
   ../util/shader.h
   ../util/texture.h
   ../util/types.h
@@ -15,10 +17,12 @@ set(UTIL_HEADERS
 set(UTIL_SOURCES
   ../util/accum.cpp
   ../util/accumBufferObject.cpp
+  ../util/asyncLoader.cpp
   ../util/bitmapFont.cpp
   ../util/frameBufferObject.cpp
   ../util/objectManager.cpp
   ../util/pixelBufferObject.cpp
+  ../util/pixelBufferPool.cpp
   ../util/shader.cpp
   ../util/texture.cpp
   )
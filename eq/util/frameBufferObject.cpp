@@ -188,6 +188,37 @@ void FrameBufferObject::bind( const uint32_t target )
     EQ_GL_CALL( glBindFramebufferEXT( target, _fboID ));
 }
 
+void FrameBufferObject::resolve( FrameBufferObject& to,
+                                 const PixelViewport& pvp )
+{
+    LB_TS_THREAD( _thread );
+    PixelViewport area( 0, 0, LB_MIN( getWidth(), to.getWidth( )),
+                        LB_MIN( getHeight(), to.getHeight( )));
+    area.intersect( pvp );
+    to.bind();
+    if( !area.hasArea( ))
+        return;
+
+    GLbitfield buffers = GL_COLOR_BUFFER_BIT;
+    if( _depth.isValid() && to._depth.isValid( ))
+    {
+        buffers |= GL_DEPTH_BUFFER_BIT;
+        if( _depth.getInternalFormat() == GL_DEPTH24_STENCIL8 &&
+            to._depth.getInternalFormat() == GL_DEPTH24_STENCIL8 )
+        {
+            buffers |= GL_STENCIL_BUFFER_BIT;
+        }
+    }
+
+    bind( GL_READ_FRAMEBUFFER_EXT );
+    to.bind( GL_DRAW_FRAMEBUFFER_EXT );
+    EQ_GL_CALL( glBlitFramebuffer( area.x, area.y, area.getXEnd(),
+                                   area.getYEnd(), area.x, area.y,
+                                   area.getXEnd(), area.getYEnd(), buffers,
+                                   GL_NEAREST ));
+    to.bind();
+}
+
 void FrameBufferObject::unbind( const uint32_t target )
 {
     EQ_GL_CALL( glBindFramebufferEXT( target, 0 ));
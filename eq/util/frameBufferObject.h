@@ -107,6 +107,20 @@ public:
      */
     EQ_API Error resize( const int32_t width, const int32_t height );
 
+    /**
+     * Resolve an area of this (multisampled) FBO into another FBO.
+     *
+     * Copies the color and, if present, the depth and stencil attachments of
+     * the given area, clipped to the size of both FBOs. Only the area is
+     * resolved, so that the cost of a resolve scales with the area read back
+     * or assembled later, not with the full FBO. Leaves the given FBO bound.
+     *
+     * @param to the single-sampled destination FBO.
+     * @param pvp the area to resolve.
+     * @version 1.9
+     */
+    EQ_API void resolve( FrameBufferObject& to, const PixelViewport& pvp );
+
     /** @return the current width. @version 1.0 */
     int32_t getWidth() const
         { LBASSERT( !_colors.empty( )); return _colors.front()->getWidth();}
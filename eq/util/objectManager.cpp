@@ -30,8 +30,16 @@
 #include <lunchbox/os.h>
 #include <lunchbox/referenced.h>
 #include <pression/uploader.h>
+#include <algorithm>
 #include <string.h>
 
+#ifndef GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX
+#  define GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX 0x9049
+#endif
+#ifndef GL_TEXTURE_FREE_MEMORY_ATI
+#  define GL_TEXTURE_FREE_MEMORY_ATI 0x87FC
+#endif
+
 //#define EQ_OM_TRACE_ALLOCATIONS
 
 namespace eq
@@ -44,9 +52,11 @@ struct Object
 {
     unsigned id;
     unsigned num;
+    size_t size; //!< declared bytes, see setBufferSize()
 };
 
 typedef stde::hash_map< const void*, Object >     ObjectHash;
+typedef stde::hash_map< const void*, GLsync >     SyncHash;
 typedef stde::hash_map< const void*, Texture* >   TextureHash;
 typedef stde::hash_map< const void*, FrameBufferObject* > FBOHash;
 typedef stde::hash_map< const void*, PixelBufferObject* > PBOHash;
@@ -56,6 +66,57 @@ typedef stde::hash_map< const void*, pression::Uploader* > UploaderHash;
 #ifdef EQ_OM_TRACE_ALLOCATIONS
 typedef stde::hash_map< const void*, std::string > UploaderAllocs;
 #endif
+typedef std::vector< ObjectManager::EvictionHandler* > EvictionHandlers;
+
+/** @return the approximate storage of the texture in bytes. */
+size_t _getSize( const Texture& texture )
+{
+    if( !texture.isValid( ))
+        return 0;
+
+    size_t pixelSize = 4;
+    switch( texture.getInternalFormat( ))
+    {
+    case GL_RGBA16F:
+    case GL_RGB16F:
+        pixelSize = 8;
+        break;
+    case GL_RGBA32F:
+    case GL_RGB32F:
+    case GL_RGBA32UI:
+        pixelSize = 16;
+        break;
+    default: // RGB(A)8, RGB10_A2, depth, depth-stencil and 32 bit alpha
+        break;
+    }
+    return size_t( texture.getWidth( )) * size_t( texture.getHeight( )) *
+           pixelSize;
+}
+
+size_t _getSize( const FrameBufferObject& fbo )
+{
+    size_t size = _getSize( fbo.getDepthTexture( ));
+    const Textures& colors = fbo.getColorTextures();
+    for( Textures::const_iterator i = colors.begin(); i != colors.end(); ++i )
+        size += _getSize( **i );
+    return size;
+}
+
+/** Update the declared size of an object. */
+void _setSize( ObjectHash& objects, const void* key, const size_t bytes,
+               size_t& total )
+{
+    ObjectHash::iterator i = objects.find( key );
+    if( i == objects.end( ))
+    {
+        LBWARN << "Size declared for unknown key " << key << std::endl;
+        return;
+    }
+
+    Object& object = i->second;
+    total = total - object.size + bytes;
+    object.size = bytes;
+}
 }
 
 namespace detail
@@ -64,6 +125,8 @@ class ObjectManager : public lunchbox::Referenced
 {
 public:
     ObjectManager( const GLEWContext* gl )
+        : declaredSize( 0 )
+        , budget( 0 )
     {
         if( gl )
             memcpy( &glewContext, gl, sizeof( GLEWContext ));
@@ -109,6 +172,20 @@ public:
         LBASSERT( shaders.empty( ));
         shaders.clear();
 
+        if( !queries.empty( ))
+            LBWARN << queries.size()
+                   << " queries allocated in ObjectManager destructor"
+                   << std::endl;
+        LBASSERT( queries.empty( ));
+        queries.clear();
+
+        if( !syncs.empty( ))
+            LBWARN << syncs.size()
+                   << " syncs allocated in ObjectManager destructor"
+                   << std::endl;
+        LBASSERT( syncs.empty( ));
+        syncs.clear();
+
         if( !eqTextures.empty( ))
             LBWARN << eqTextures.size()
                    << " eq::Texture allocated in ObjectManager destructor"
@@ -151,6 +228,8 @@ public:
     ObjectHash buffers;
     ObjectHash programs;
     ObjectHash shaders;
+    ObjectHash queries;
+    SyncHash syncs;
     ObjectHash uploaderDatas;
     AccumHash  accums;
     TextureHash eqTextures;
@@ -161,6 +240,10 @@ public:
 #ifdef EQ_OM_TRACE_ALLOCATIONS
     UploaderAllocs eqUploaderAllocs;
 #endif
+
+    size_t declaredSize; //!< sum of the declared buffer and texture sizes
+    size_t budget;
+    EvictionHandlers evictionHandlers;
 };
 }
 
@@ -198,6 +281,11 @@ bool ObjectManager::isShared() const
     return _impl->getRefCount() > 1;
 }
 
+bool ObjectManager::isSharedWith( const ObjectManager& other ) const
+{
+    return _impl == other._impl;
+}
+
 const GLEWContext* ObjectManager::glewGetContext() const
 {
     return &_impl->glewContext;
@@ -231,6 +319,7 @@ void ObjectManager::deleteAll()
         EQ_GL_CALL( glDeleteBuffers( 1, &object.id ));
     }
     _impl->buffers.clear();
+    _impl->declaredSize = 0;
 
     for( ObjectHash::const_iterator i = _impl->programs.begin();
          i != _impl->programs.end(); ++i )
@@ -250,6 +339,23 @@ void ObjectManager::deleteAll()
     }
     _impl->shaders.clear();
 
+    for( ObjectHash::const_iterator i = _impl->queries.begin();
+         i != _impl->queries.end(); ++i )
+    {
+        const Object& object = i->second;
+        LBVERB << "Delete query " << object.id << std::endl;
+        EQ_GL_CALL( glDeleteQueries( 1, &object.id ));
+    }
+    _impl->queries.clear();
+
+    for( SyncHash::const_iterator i = _impl->syncs.begin();
+         i != _impl->syncs.end(); ++i )
+    {
+        LBVERB << "Delete sync " << (void*)i->second << std::endl;
+        EQ_GL_CALL( glDeleteSync( i->second ));
+    }
+    _impl->syncs.clear();
+
     for( TextureHash::const_iterator i = _impl->eqTextures.begin();
          i != _impl->eqTextures.end(); ++i )
     {
@@ -431,6 +537,7 @@ GLuint ObjectManager::newTexture( const void* key )
 
     Object& object   = _impl->textures[ key ];
     object.id        = id;
+    object.size      = 0;
     return id;
 }
 
@@ -450,6 +557,7 @@ void ObjectManager::deleteTexture( const void* key )
 
     const Object& object = i->second;
     EQ_GL_CALL( glDeleteTextures( 1, &object.id ));
+    _impl->declaredSize -= object.size;
     _impl->textures.erase( i );
 }
 
@@ -494,6 +602,7 @@ GLuint ObjectManager::newBuffer( const void* key )
 
     Object& object     = _impl->buffers[ key ];
     object.id          = id;
+    object.size        = 0;
     return id;
 }
 
@@ -513,6 +622,7 @@ void ObjectManager::deleteBuffer( const void* key )
 
     const Object& object = i->second;
     EQ_GL_CALL( glDeleteBuffers( 1, &object.id ));
+    _impl->declaredSize -= object.size;
     _impl->buffers.erase( i );
 }
 
@@ -640,6 +750,176 @@ void ObjectManager::deleteShader( const void* key )
     _impl->shaders.erase( i );
 }
 
+// query object functions
+
+bool ObjectManager::supportsQueries() const
+{
+    return ( GLEW_VERSION_1_5 );
+}
+
+GLuint ObjectManager::getQuery( const void* key ) const
+{
+    ObjectHash::const_iterator i = _impl->queries.find( key );
+    if( i == _impl->queries.end() )
+        return INVALID;
+
+    const Object& object = i->second;
+    return object.id;
+}
+
+GLuint ObjectManager::newQuery( const void* key )
+{
+    if( !GLEW_VERSION_1_5 )
+    {
+        LBWARN << "glGenQueries not available" << std::endl;
+        return INVALID;
+    }
+
+    if( _impl->queries.find( key ) != _impl->queries.end() )
+    {
+        LBWARN << "Requested new query for existing key" << std::endl;
+        return INVALID;
+    }
+
+    GLuint id = INVALID;
+    glGenQueries( 1, &id );
+    if( id == INVALID )
+    {
+        LBWARN << "glGenQueries failed: " << glGetError() << std::endl;
+        return INVALID;
+    }
+
+    Object& object     = _impl->queries[ key ];
+    object.id          = id;
+    return id;
+}
+
+GLuint ObjectManager::obtainQuery( const void* key )
+{
+    const GLuint id = getQuery( key );
+    if( id != INVALID )
+        return id;
+    return newQuery( key );
+}
+
+void ObjectManager::deleteQuery( const void* key )
+{
+    ObjectHash::iterator i = _impl->queries.find( key );
+    if( i == _impl->queries.end() )
+        return;
+
+    const Object& object = i->second;
+    EQ_GL_CALL( glDeleteQueries( 1, &object.id ));
+    _impl->queries.erase( i );
+}
+
+bool ObjectManager::getQueryResult( const void* key, uint64_t& result,
+                                    const bool wait ) const
+{
+    const GLuint id = getQuery( key );
+    if( id == INVALID )
+        return false;
+
+    if( !wait )
+    {
+        GLuint available = GL_FALSE;
+        EQ_GL_CALL( glGetQueryObjectuiv( id, GL_QUERY_RESULT_AVAILABLE,
+                                         &available ));
+        if( !available )
+            return false;
+    }
+
+    if( GLEW_ARB_timer_query )
+    {
+        GLuint64 value = 0;
+        EQ_GL_CALL( glGetQueryObjectui64v( id, GL_QUERY_RESULT, &value ));
+        result = value;
+    }
+    else
+    {
+        GLuint value = 0;
+        EQ_GL_CALL( glGetQueryObjectuiv( id, GL_QUERY_RESULT, &value ));
+        result = value;
+    }
+    return true;
+}
+
+// sync object functions
+
+bool ObjectManager::supportsSyncs() const
+{
+    return ( GLEW_ARB_sync );
+}
+
+void* ObjectManager::getSync( const void* key ) const
+{
+    SyncHash::const_iterator i = _impl->syncs.find( key );
+    if( i == _impl->syncs.end() )
+        return 0;
+
+    return i->second;
+}
+
+void* ObjectManager::newSync( const void* key )
+{
+    if( !GLEW_ARB_sync )
+    {
+        LBWARN << "glFenceSync not available" << std::endl;
+        return 0;
+    }
+
+    if( _impl->syncs.find( key ) != _impl->syncs.end() )
+    {
+        LBWARN << "Requested new sync for existing key" << std::endl;
+        return 0;
+    }
+
+    const GLsync sync = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+    if( !sync )
+    {
+        LBWARN << "glFenceSync failed: " << glGetError() << std::endl;
+        return 0;
+    }
+
+    _impl->syncs[ key ] = sync;
+    return sync;
+}
+
+void* ObjectManager::renewSync( const void* key )
+{
+    deleteSync( key );
+    return newSync( key );
+}
+
+void ObjectManager::deleteSync( const void* key )
+{
+    SyncHash::iterator i = _impl->syncs.find( key );
+    if( i == _impl->syncs.end() )
+        return;
+
+    EQ_GL_CALL( glDeleteSync( i->second ));
+    _impl->syncs.erase( i );
+}
+
+bool ObjectManager::isSyncSignaled( const void* key, const bool wait ) const
+{
+    SyncHash::const_iterator i = _impl->syncs.find( key );
+    if( i == _impl->syncs.end() )
+        return false;
+
+    if( !wait )
+    {
+        GLint status = GL_UNSIGNALED;
+        EQ_GL_CALL( glGetSynciv( i->second, GL_SYNC_STATUS, 1, 0, &status ));
+        return status == GL_SIGNALED;
+    }
+
+    const GLenum result = glClientWaitSync( i->second,
+                                            GL_SYNC_FLUSH_COMMANDS_BIT,
+                                            GL_TIMEOUT_IGNORED );
+    return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
 Accum* ObjectManager::getEqAccum( const void* key ) const
 {
     AccumHash::const_iterator i = _impl->accums.find( key );
@@ -943,5 +1223,107 @@ void ObjectManager::deleteEqPixelBufferObject( const void* key )
     delete pixelBufferObject;
 }
 
+// GPU memory accounting
+void ObjectManager::setBufferSize( const void* key, const size_t bytes )
+{
+    _setSize( _impl->buffers, key, bytes, _impl->declaredSize );
+}
+
+void ObjectManager::setTextureSize( const void* key, const size_t bytes )
+{
+    _setSize( _impl->textures, key, bytes, _impl->declaredSize );
+}
+
+size_t ObjectManager::getUsedMemory() const
+{
+    size_t size = _impl->declaredSize;
+
+    for( TextureHash::const_iterator i = _impl->eqTextures.begin();
+         i != _impl->eqTextures.end(); ++i )
+    {
+        size += _getSize( *i->second );
+    }
+    for( FBOHash::const_iterator i = _impl->eqFrameBufferObjects.begin();
+         i != _impl->eqFrameBufferObjects.end(); ++i )
+    {
+        size += _getSize( *i->second );
+    }
+    for( PBOHash::const_iterator i = _impl->eqPixelBufferObjects.begin();
+         i != _impl->eqPixelBufferObjects.end(); ++i )
+    {
+        size += i->second->getSize();
+    }
+    return size;
+}
+
+size_t ObjectManager::getFreeMemory() const
+{
+    GLint kiloBytes[4] = { 0, 0, 0, 0 };
+#ifdef GL_NVX_gpu_memory_info
+    if( GLEW_NVX_gpu_memory_info )
+    {
+        EQ_GL_CALL( glGetIntegerv(
+                        GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX,
+                        kiloBytes ));
+        return size_t( kiloBytes[0] ) * 1024;
+    }
+#endif
+#ifdef GL_ATI_meminfo
+    if( GLEW_ATI_meminfo )
+    {
+        // total free, largest free block, free auxiliary and largest block
+        EQ_GL_CALL( glGetIntegerv( GL_TEXTURE_FREE_MEMORY_ATI, kiloBytes ));
+        return size_t( kiloBytes[0] ) * 1024;
+    }
+#endif
+    return 0;
+}
+
+void ObjectManager::setMemoryBudget( const size_t bytes )
+{
+    _impl->budget = bytes;
+}
+
+size_t ObjectManager::getMemoryBudget() const
+{
+    return _impl->budget;
+}
+
+void ObjectManager::addEvictionHandler( EvictionHandler* handler )
+{
+    _impl->evictionHandlers.push_back( handler );
+}
+
+void ObjectManager::removeEvictionHandler( EvictionHandler* handler )
+{
+    EvictionHandlers& handlers = _impl->evictionHandlers;
+    EvictionHandlers::iterator i = std::find( handlers.begin(), handlers.end(),
+                                              handler );
+    if( i != handlers.end( ))
+        handlers.erase( i );
+}
+
+size_t ObjectManager::enforceMemoryBudget()
+{
+    if( _impl->budget == 0 || _impl->evictionHandlers.empty( ))
+        return 0;
+
+    size_t used = getUsedMemory();
+    size_t released = 0;
+    // copy, handlers may remove themselves
+    const EvictionHandlers handlers = _impl->evictionHandlers;
+    for( EvictionHandlers::const_iterator i = handlers.begin();
+         i != handlers.end() && used > _impl->budget; ++i )
+    {
+        released += (*i)->evict( *this, used - _impl->budget );
+        used = getUsedMemory();
+    }
+
+    if( used > _impl->budget )
+        LBVERB << "GPU memory budget exceeded by " << used - _impl->budget
+               << " bytes after eviction" << std::endl;
+    return released;
+}
+
 }
 }
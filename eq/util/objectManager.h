@@ -47,6 +47,17 @@ namespace detail { class ObjectManager; }
  * - deleteObject: Delete the object of the given key and all associated
  *   OpenGL data
  *
+ * The object manager accounts the GPU memory of the Equalizer objects it
+ * manages, and of buffer and texture objects whose size is declared by the
+ * application. A memory budget can be enforced using eviction handlers
+ * implemented by application caches. Each pipe reports the memory used by its
+ * object managers as a Statistic::PIPE_GPU_MEMORY statistic.
+ *
+ * Query objects and fence syncs deliver their results asynchronously. To
+ * retrieve them N frames later without stalling, use one key per frame in
+ * flight, e.g., key + frameNumber % N, and check for the result before
+ * reusing a key.
+ *
  * @sa http://www.equalizergraphics.com/documents/design/objectManager.html
  */
 class ObjectManager
@@ -71,6 +82,9 @@ public:
     /** @return true if more than one OM is using the same data. */
     EQ_API bool isShared() const;
 
+    /** @return true if this and the given OM use the same data. @version 1.8*/
+    EQ_API bool isSharedWith( const ObjectManager& other ) const;
+
     /** Reset the object manager. deleteAll() should be called beforehand. */
     EQ_API void clear();
 
@@ -113,6 +127,48 @@ public:
     EQ_API unsigned obtainShader( const void* key, const unsigned type );
     EQ_API void     deleteShader( const void* key );
 
+    EQ_API bool     supportsQueries() const;
+    EQ_API unsigned getQuery( const void* key ) const;
+    EQ_API unsigned newQuery( const void* key );
+    EQ_API unsigned obtainQuery( const void* key );
+    EQ_API void     deleteQuery( const void* key );
+
+    /**
+     * Retrieve the result of the query of the given key.
+     *
+     * @param key the query key.
+     * @param result the result, e.g., a timestamp or sample count.
+     * @param wait wait for the result if it is not yet available.
+     * @return true if the result was retrieved, false if it is not yet
+     *         available or the query does not exist.
+     * @version 1.8
+     */
+    EQ_API bool getQueryResult( const void* key, uint64_t& result,
+                                const bool wait = false ) const;
+
+    /** The GLsync objects are returned as opaque pointers. */
+    EQ_API bool  supportsSyncs() const;
+    EQ_API void* getSync( const void* key ) const;
+    EQ_API void* newSync( const void* key );
+    EQ_API void  deleteSync( const void* key );
+
+    /**
+     * Insert a new fence for the given key, replacing the existing one.
+     * @return the new sync, or 0 on failure.
+     * @version 1.8
+     */
+    EQ_API void* renewSync( const void* key );
+
+    /**
+     * @param key the sync key.
+     * @param wait wait for the fence if it is not yet signaled.
+     * @return true if the fence of the given key is signaled, false
+     *         otherwise or if the sync does not exist.
+     * @version 1.8
+     */
+    EQ_API bool isSyncSignaled( const void* key, const bool wait = false )
+        const;
+
     EQ_API Accum* getEqAccum( const void* key ) const;
     EQ_API Accum* newEqAccum( const void* key );
     EQ_API Accum* obtainEqAccum( const void* key );
@@ -152,6 +208,80 @@ public:
     EQ_API util::BitmapFont* obtainEqBitmapFont( const void* key );
     EQ_API void                   deleteEqBitmapFont( const void* key );
 
+    /** @name GPU memory accounting. */
+    //@{
+    /**
+     * Interface of application caches releasing memory on demand.
+     * @sa setMemoryBudget()
+     * @version 1.8
+     */
+    class EvictionHandler
+    {
+    public:
+        virtual ~EvictionHandler() {}
+
+        /**
+         * Release the least important objects of the given object manager.
+         *
+         * Called with an OpenGL context of the object manager current.
+         * @param objectManager the object manager exceeding its budget.
+         * @param bytes the number of bytes to release, if possible.
+         * @return the number of bytes released.
+         * @version 1.8
+         */
+        virtual size_t evict( ObjectManager& objectManager,
+                              const size_t bytes ) = 0;
+    };
+
+    /**
+     * Declare the size of the data stored in the buffer of the given key.
+     *
+     * The size is accounted until the buffer is deleted or redeclared.
+     * @version 1.8
+     */
+    EQ_API void setBufferSize( const void* key, const size_t bytes );
+
+    /** Declare the size of the texture of the given key. @version 1.8 */
+    EQ_API void setTextureSize( const void* key, const size_t bytes );
+
+    /**
+     * @return the bytes used by the declared buffers and textures, and the
+     *         Equalizer textures, FBOs and PBOs.
+     * @version 1.8
+     */
+    EQ_API size_t getUsedMemory() const;
+
+    /**
+     * @return the free GPU memory reported by the driver through
+     *         GL_NVX_gpu_memory_info or GL_ATI_meminfo, or 0 if unknown.
+     *         Needs a current context.
+     * @version 1.8
+     */
+    EQ_API size_t getFreeMemory() const;
+
+    /** Set the memory budget, 0 is unlimited (default). @version 1.8 */
+    EQ_API void setMemoryBudget( const size_t bytes );
+
+    /** @return the memory budget in bytes. @version 1.8 */
+    EQ_API size_t getMemoryBudget() const;
+
+    /** Add a handler called when the budget is exceeded. @version 1.8 */
+    EQ_API void addEvictionHandler( EvictionHandler* handler );
+
+    /** Remove an eviction handler. @version 1.8 */
+    EQ_API void removeEvictionHandler( EvictionHandler* handler );
+
+    /**
+     * Call the eviction handlers in the order they were added, while the used
+     * memory exceeds the budget.
+     *
+     * Called by the pipe once per frame. Needs a current context.
+     * @return the number of bytes released.
+     * @version 1.8
+     */
+    EQ_API size_t enforceMemoryBudget();
+    //@}
+
     EQ_API const GLEWContext* glewGetContext() const;
 
 private:
@@ -0,0 +1,401 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "pixelBufferPool.h"
+
+#include <eq/client/gl.h>
+#include <lunchbox/debug.h>
+#include <lunchbox/hash.h>
+#include <lunchbox/lock.h>
+#include <lunchbox/scopedMutex.h>
+
+#include <deque>
+
+namespace eq
+{
+namespace util
+{
+namespace
+{
+typedef stde::hash_map< const GLEWContext*, PixelBufferPool* > PoolHash;
+lunchbox::Lock _poolsLock;
+PoolHash _pools;
+
+const size_t _alignment = 64; // keeps ranges aligned for any pixel type
+const size_t _minSize = 4 * 1024 * 1024;
+
+/** A set of ranges closed by one fence. */
+struct Segment
+{
+    Segment( const uint64_t id_, const size_t begin_ )
+        : id( id_ ), begin( begin_ ), end( begin_ ), fence( 0 ), refs( 0 ) {}
+
+    uint64_t id;
+    size_t begin;
+    size_t end;
+    GLsync fence; //!< 0 while the segment is open for new ranges
+    size_t refs; //!< the number of unreleased ranges
+};
+typedef std::deque< Segment > Segments;
+
+/** One persistently mapped buffer and its segments, oldest first. */
+struct Buffer
+{
+    Buffer() : name( 0 ), size( 0 ), data( 0 ) {}
+
+    GLuint name;
+    size_t size;
+    uint8_t* data;
+    Segments segments;
+};
+typedef std::deque< Buffer > Buffers;
+}
+
+namespace detail
+{
+class PixelBufferPool
+{
+public:
+    explicit PixelBufferPool( const GLEWContext* gl )
+        : glewContext( gl )
+        , nextSegment( 1 )
+    {}
+
+    ~PixelBufferPool()
+    {
+        while( !buffers.empty( ))
+        {
+            Buffer& buffer = buffers.front();
+            for( Segments::iterator i = buffer.segments.begin();
+                 i != buffer.segments.end(); ++i )
+            {
+                if( i->refs > 0 )
+                    LBWARN << "Pixel buffer range not released" << std::endl;
+                if( i->fence )
+                    glDeleteSync( i->fence );
+            }
+            _delete( buffer );
+            buffers.pop_front();
+        }
+    }
+
+    const GLEWContext* glewGetContext() const { return glewContext; }
+
+    util::PixelBufferPool::Range allocate( size_t size )
+    {
+        util::PixelBufferPool::Range range;
+        if( size == 0 )
+            return range;
+        size = ( size + _alignment - 1 ) & ~( _alignment - 1 );
+
+        if( buffers.empty() || !_recycle( buffers.back(), size ))
+        {
+            size_t newSize = buffers.empty() ? _minSize :
+                                               buffers.back().size * 2;
+            while( newSize < size * 2 )
+                newSize *= 2;
+            if( !_create( newSize ))
+                return range;
+        }
+
+        Buffer& buffer = buffers.back();
+        size_t begin = _getHead( buffer );
+        if( begin + size > buffer.size ) // wrap around
+            begin = 0;
+
+        Segment* segment = buffer.segments.empty() ? 0 :
+                                                     &buffer.segments.back();
+        if( !segment || segment->fence || segment->end != begin )
+        {
+            buffer.segments.push_back( Segment( nextSegment++, begin ));
+            segment = &buffer.segments.back();
+        }
+        segment->end = begin + size;
+        ++segment->refs;
+
+        range.name = buffer.name;
+        range.offset = begin;
+        range.size = size;
+        range.data = buffer.data + begin;
+        range.segment = segment->id;
+        return range;
+    }
+
+    void fence()
+    {
+        for( Buffers::iterator i = buffers.begin(); i != buffers.end(); ++i )
+        {
+            Segments& segments = i->segments;
+            if( !segments.empty() && !segments.back().fence )
+                segments.back().fence =
+                    glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+        }
+    }
+
+    bool wait( const util::PixelBufferPool::Range& range )
+    {
+        Segment* segment = _find( range );
+        if( !segment )
+            return false;
+
+        if( !segment->fence )
+            fence();
+        return _wait( *segment, true );
+    }
+
+    void release( const util::PixelBufferPool::Range& range )
+    {
+        Segment* segment = _find( range );
+        LBASSERT( segment && segment->refs > 0 );
+        if( segment && segment->refs > 0 )
+            --segment->refs;
+
+        // delete retired buffers once all their ranges are recycled
+        while( buffers.size() > 1 )
+        {
+            Buffer& buffer = buffers.front();
+            while( !buffer.segments.empty() &&
+                   _isFree( buffer.segments.front(), false ))
+            {
+                glDeleteSync( buffer.segments.front().fence );
+                buffer.segments.pop_front();
+            }
+            if( !buffer.segments.empty( ))
+                break;
+            _delete( buffer );
+            buffers.pop_front();
+        }
+    }
+
+    size_t getSize() const
+    {
+        size_t size = 0;
+        for( Buffers::const_iterator i = buffers.begin(); i != buffers.end();
+             ++i )
+        {
+            size += i->size;
+        }
+        return size;
+    }
+
+    const GLEWContext* const glewContext;
+    Buffers buffers; //!< retired buffers first, the current one last
+    uint64_t nextSegment;
+
+private:
+    static size_t _getHead( const Buffer& buffer )
+    {
+        return buffer.segments.empty() ? 0 : buffer.segments.back().end;
+    }
+
+    /** @return true if size bytes are free at the head of the ring. */
+    static bool _fits( const Buffer& buffer, const size_t size )
+    {
+        if( buffer.segments.empty( ))
+            return size <= buffer.size;
+
+        const size_t head = buffer.segments.back().end;
+        const size_t tail = buffer.segments.front().begin;
+        if( head > tail ) // free at the end and at the start of the buffer
+            return head + size <= buffer.size || size <= tail;
+        return head + size <= tail; // wrapped around
+    }
+
+    /** Recycle the oldest segments until size bytes are free. */
+    bool _recycle( Buffer& buffer, const size_t size )
+    {
+        while( !_fits( buffer, size ))
+        {
+            if( buffer.segments.empty( ))
+                return false;
+
+            Segment& oldest = buffer.segments.front();
+            if( oldest.refs == 0 && !oldest.fence )
+                fence();
+            if( oldest.refs > 0 || !_wait( oldest, true ))
+                return false; // still in use by the CPU, grow
+            glDeleteSync( oldest.fence );
+            buffer.segments.pop_front();
+        }
+        return true;
+    }
+
+    bool _isFree( Segment& segment, const bool block )
+    {
+        return segment.refs == 0 && segment.fence && _wait( segment, block );
+    }
+
+    bool _wait( Segment& segment, const bool block )
+    {
+        LBASSERT( segment.fence );
+        const GLuint64 timeout = block ? 1000000000ull /* 1s */ : 0;
+        for( ;; )
+        {
+            switch( glClientWaitSync( segment.fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                      timeout ))
+            {
+            case GL_ALREADY_SIGNALED:
+            case GL_CONDITION_SATISFIED:
+                return true;
+            case GL_TIMEOUT_EXPIRED:
+                if( !block )
+                    return false;
+                LBWARN << "Pixel buffer fence not signaled after 1s"
+                       << std::endl;
+                break;
+            default:
+                EQ_GL_ERROR( "glClientWaitSync" );
+                return false;
+            }
+        }
+    }
+
+    Segment* _find( const util::PixelBufferPool::Range& range )
+    {
+        for( Buffers::iterator i = buffers.begin(); i != buffers.end(); ++i )
+        {
+            if( i->name != range.name )
+                continue;
+            for( Segments::iterator j = i->segments.begin();
+                 j != i->segments.end(); ++j )
+            {
+                if( j->id == range.segment )
+                    return &(*j);
+            }
+        }
+        return 0;
+    }
+
+    bool _create( const size_t size LB_UNUSED )
+    {
+#ifdef GL_ARB_buffer_storage
+        const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT |
+                                 GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        Buffer buffer;
+        EQ_GL_CALL( glGenBuffersARB( 1, &buffer.name ));
+        if( !buffer.name )
+            return false;
+
+        EQ_GL_CALL( glBindBufferARB( GL_COPY_WRITE_BUFFER, buffer.name ));
+        EQ_GL_CALL( glBufferStorage( GL_COPY_WRITE_BUFFER, size, 0, flags ));
+        buffer.data = static_cast< uint8_t* >(
+            glMapBufferRange( GL_COPY_WRITE_BUFFER, 0, size, flags ));
+        EQ_GL_CALL( glBindBufferARB( GL_COPY_WRITE_BUFFER, 0 ));
+
+        if( !buffer.data )
+        {
+            LBWARN << "Can't map pixel buffer pool of " << size << " bytes"
+                   << std::endl;
+            EQ_GL_CALL( glDeleteBuffersARB( 1, &buffer.name ));
+            return false;
+        }
+        buffer.size = size;
+        buffers.push_back( buffer );
+        LBVERB << "Allocated pixel buffer pool of " << size << " bytes"
+               << std::endl;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void _delete( Buffer& buffer )
+    {
+        if( buffer.name == 0 )
+            return;
+        EQ_GL_CALL( glBindBufferARB( GL_COPY_WRITE_BUFFER, buffer.name ));
+        EQ_GL_CALL( glUnmapBufferARB( GL_COPY_WRITE_BUFFER ));
+        EQ_GL_CALL( glBindBufferARB( GL_COPY_WRITE_BUFFER, 0 ));
+        EQ_GL_CALL( glDeleteBuffersARB( 1, &buffer.name ));
+        buffer.name = 0;
+        buffer.data = 0;
+    }
+};
+}
+
+PixelBufferPool::PixelBufferPool( const GLEWContext* glewContext )
+    : _impl( new detail::PixelBufferPool( glewContext ))
+{
+}
+
+PixelBufferPool::~PixelBufferPool()
+{
+    {
+        lunchbox::ScopedWrite mutex( _poolsLock );
+        _pools.erase( _impl->glewContext );
+    }
+    delete _impl;
+}
+
+PixelBufferPoolPtr PixelBufferPool::get( const GLEWContext* glewContext )
+{
+    if( !isSupported( glewContext ))
+        return 0;
+
+    lunchbox::ScopedWrite mutex( _poolsLock );
+    PoolHash::const_iterator i = _pools.find( glewContext );
+    if( i != _pools.end( ))
+        return i->second;
+
+    PixelBufferPool* pool = new PixelBufferPool( glewContext );
+    _pools[ glewContext ] = pool;
+    return pool;
+}
+
+bool PixelBufferPool::isSupported( const GLEWContext* glewContext LB_UNUSED )
+{
+#ifdef GL_ARB_buffer_storage
+    LBASSERT( glewContext );
+    return GLEW_ARB_buffer_storage && GLEW_ARB_sync &&
+           GLEW_ARB_pixel_buffer_object;
+#else
+    return false;
+#endif
+}
+
+PixelBufferPool::Range PixelBufferPool::allocate( const size_t size )
+{
+    return _impl->allocate( size );
+}
+
+void PixelBufferPool::fence()
+{
+    _impl->fence();
+}
+
+bool PixelBufferPool::wait( const Range& range )
+{
+    return _impl->wait( range );
+}
+
+void PixelBufferPool::release( const Range& range )
+{
+    _impl->release( range );
+}
+
+size_t PixelBufferPool::getSize() const
+{
+    return _impl->getSize();
+}
+
+const GLEWContext* PixelBufferPool::glewGetContext() const
+{
+    return _impl->glewContext;
+}
+
+}
+}
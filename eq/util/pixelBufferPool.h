@@ -0,0 +1,117 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQUTIL_PIXELBUFFERPOOL_H
+#define EQUTIL_PIXELBUFFERPOOL_H
+
+#include <eq/util/types.h>
+#include <eq/client/api.h>
+#include <lunchbox/referenced.h>
+
+namespace eq
+{
+namespace util
+{
+namespace detail { class PixelBufferPool; }
+
+/**
+ * A per-context arena of persistently mapped pixel buffer memory.
+ *
+ * The pool allocates ranges from one GL buffer, created with
+ * ARB_buffer_storage and mapped persistently and coherently for reading and
+ * writing. Ranges are handed out in a ring. Each call to fence() closes the
+ * ranges allocated since the last fence with a fence sync, and a range is
+ * recycled once its fence is signaled and it has been released. The pool
+ * grows on demand: a new, larger buffer is used for new ranges, and the old
+ * one is deleted once all its ranges are recycled.
+ *
+ * Readback: allocate(), glReadPixels() into the bound pack buffer at the range
+ * offset, fence(), later wait() and read data, then release().
+ *
+ * Upload: allocate(), write data, glTexSubImage2D() from the bound unpack
+ * buffer at the range offset, release() and fence().
+ *
+ * All methods have to be called from the thread of the pool's GL context.
+ * @version 1.8
+ */
+class PixelBufferPool : public lunchbox::Referenced, public boost::noncopyable
+{
+public:
+    /** A range of pool memory. */
+    struct Range
+    {
+        Range() : name( 0 ), offset( 0 ), size( 0 ), data( 0 ), segment( 0 ) {}
+
+        /** @return true if the range is allocated. @version 1.8 */
+        bool isValid() const { return data != 0; }
+
+        unsigned name; //!< the GL buffer name
+        size_t offset; //!< the offset of the range in the buffer
+        size_t size; //!< the size of the range in bytes
+        uint8_t* data; //!< the mapped memory of the range
+        uint64_t segment; //!< @internal the fenced segment of the range
+    };
+
+    /**
+     * @return the pool of the given context, shared by all users of the
+     *         context. 0 if pools are not supported.
+     * @version 1.8
+     */
+    EQ_API static PixelBufferPoolPtr get( const GLEWContext* glewContext );
+
+    /** @return true if the given context supports pools. @version 1.8 */
+    EQ_API static bool isSupported( const GLEWContext* glewContext );
+
+    /**
+     * Allocate a new range.
+     *
+     * @param size the size of the range in bytes.
+     * @return the range, invalid on failure.
+     * @version 1.8
+     */
+    EQ_API Range allocate( const size_t size );
+
+    /** Fence the GL commands issued for the unfenced ranges. @version 1.8 */
+    EQ_API void fence();
+
+    /**
+     * Wait for the GL commands issued for the given range.
+     *
+     * Fences the range first if needed.
+     * @return false if the wait failed.
+     * @version 1.8
+     */
+    EQ_API bool wait( const Range& range );
+
+    /** Release a range which is no longer used by the CPU. @version 1.8 */
+    EQ_API void release( const Range& range );
+
+    /** @return the total size of the buffers of the pool. @version 1.8 */
+    EQ_API size_t getSize() const;
+
+    EQ_API const GLEWContext* glewGetContext() const;
+
+private:
+    explicit PixelBufferPool( const GLEWContext* glewContext );
+    virtual ~PixelBufferPool();
+
+    detail::PixelBufferPool* const _impl;
+};
+}
+}
+
+#endif // EQUTIL_PIXELBUFFERPOOL_H
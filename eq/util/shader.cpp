@@ -19,7 +19,17 @@
 #include "shader.h"
 
 #include <eq/client/gl.h>
+#include <lunchbox/lock.h>
 #include <lunchbox/log.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/uint128_t.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
 
 #undef glewGetContext
 #define glewGetContext() glewContext
@@ -30,6 +40,167 @@ namespace util
 {
 namespace shader
 {
+namespace
+{
+/** A linked program binary as returned by glGetProgramBinary. */
+struct Binary
+{
+    Binary() : format( 0 ) {}
+
+    GLenum format;
+    std::vector< uint8_t > data;
+};
+typedef std::map< uint64_t, Binary > BinaryMap;
+
+lunchbox::Lock _binariesLock;
+BinaryMap _binaries; //!< shared by all contexts of the process
+
+/** @return the directory of the persistent cache, empty if disabled. */
+std::string _getCacheDir()
+{
+    const char* env = ::getenv( "EQ_SHADER_CACHE" );
+    return env ? env : std::string();
+}
+
+void _hash( uint64_t& hash, const char* string )
+{
+    // FNV-1a
+    for( ; string && *string; ++string )
+    {
+        hash ^= uint8_t( *string );
+        hash *= 1099511628211ull;
+    }
+    hash ^= 0xff; // separate consecutive strings
+    hash *= 1099511628211ull;
+}
+
+/** @return the cache key of the sources for the driver of the context. */
+uint64_t _getKey( const GLEWContext* glewContext LB_UNUSED,
+                  const char* vertexShaderSource,
+                  const char* fragmentShaderSource )
+{
+    uint64_t hash = 14695981039346656037ull;
+    _hash( hash, (const char*)glGetString( GL_VENDOR ));
+    _hash( hash, (const char*)glGetString( GL_RENDERER ));
+    _hash( hash, (const char*)glGetString( GL_VERSION ));
+    _hash( hash, vertexShaderSource );
+    _hash( hash, fragmentShaderSource );
+    return hash;
+}
+
+std::string _getFilename( const std::string& dir, const uint64_t key )
+{
+    std::ostringstream name;
+    name << dir << "/eqProgram" << std::hex << std::setfill( '0' )
+         << std::setw( 16 ) << key << ".bin";
+    return name.str();
+}
+
+bool _findBinary( const uint64_t key, Binary& binary )
+{
+    {
+        lunchbox::ScopedWrite mutex( _binariesLock );
+        BinaryMap::const_iterator i = _binaries.find( key );
+        if( i != _binaries.end( ))
+        {
+            binary = i->second;
+            return true;
+        }
+    }
+
+    const std::string& dir = _getCacheDir();
+    if( dir.empty( ))
+        return false;
+
+    std::ifstream file( _getFilename( dir, key ).c_str(), std::ios::binary );
+    uint32_t format = 0;
+    uint64_t size = 0;
+    if( !file.read( (char*)&format, sizeof( format )) ||
+        !file.read( (char*)&size, sizeof( size )) || size == 0 )
+    {
+        return false;
+    }
+
+    binary.format = format;
+    binary.data.resize( size );
+    if( !file.read( (char*)binary.data.data(), size ))
+        return false;
+
+    lunchbox::ScopedWrite mutex( _binariesLock );
+    _binaries[ key ] = binary;
+    return true;
+}
+
+void _storeBinary( const uint64_t key, const Binary& binary )
+{
+    {
+        lunchbox::ScopedWrite mutex( _binariesLock );
+        _binaries[ key ] = binary;
+    }
+
+    const std::string& dir = _getCacheDir();
+    if( dir.empty( ))
+        return;
+
+    // write to a temporary file first, concurrent processes may read
+    const std::string& filename = _getFilename( dir, key );
+    std::ostringstream tmpName;
+    tmpName << filename << '.' << lunchbox::make_UUID().getShortString();
+    {
+        std::ofstream file( tmpName.str().c_str(), std::ios::binary );
+        const uint32_t format = binary.format;
+        const uint64_t size = binary.data.size();
+        file.write( (const char*)&format, sizeof( format ));
+        file.write( (const char*)&size, sizeof( size ));
+        file.write( (const char*)binary.data.data(), size );
+        if( !file )
+        {
+            LBWARN << "Can't write program binary " << tmpName.str()
+                   << std::endl;
+            return;
+        }
+    }
+    if( ::rename( tmpName.str().c_str(), filename.c_str( )) != 0 )
+        ::remove( tmpName.str().c_str( ));
+}
+
+/** @return true if the cached binary of the key was loaded into program. */
+bool _loadProgram( const GLEWContext* glewContext LB_UNUSED,
+                   const unsigned program, const uint64_t key )
+{
+    Binary binary;
+    if( !_findBinary( key, binary ))
+        return false;
+
+    glProgramBinary( program, binary.format, binary.data.data(),
+                     GLsizei( binary.data.size( )));
+    GLint status = GL_FALSE;
+    glGetProgramiv( program, GL_LINK_STATUS, &status );
+    if( status )
+        return true;
+
+    // stale or foreign binary, link from sources
+    glGetError();
+    LBVERB << "Discarding cached program binary " << key << std::endl;
+    return false;
+}
+
+void _saveProgram( const GLEWContext* glewContext LB_UNUSED,
+                   const unsigned program, const uint64_t key )
+{
+    GLint size = 0;
+    EQ_GL_CALL( glGetProgramiv( program, GL_PROGRAM_BINARY_LENGTH, &size ));
+    if( size <= 0 )
+        return;
+
+    Binary binary;
+    binary.data.resize( size );
+    EQ_GL_CALL( glGetProgramBinary( program, size, &size, &binary.format,
+                                    binary.data.data( )));
+    binary.data.resize( size );
+    _storeBinary( key, binary );
+}
+}
 
 bool compile( const GLEWContext* glewContext LB_UNUSED, const unsigned shader,
               const char* source )
@@ -60,6 +231,12 @@ bool linkProgram( const GLEWContext* glewContext LB_UNUSED,
         return false;
     }
 
+    const bool useCache = GLEW_ARB_get_program_binary;
+    const uint64_t key = useCache ? _getKey( glewContext, vertexShaderSource,
+                                             fragmentShaderSource ) : 0;
+    if( useCache && _loadProgram( glewContext, program, key ))
+        return true;
+
     const GLuint vertexShader = glCreateShader( GL_VERTEX_SHADER );
     if( !compile( glewContext, vertexShader, vertexShaderSource ))
     {
@@ -79,6 +256,10 @@ bool linkProgram( const GLEWContext* glewContext LB_UNUSED,
     EQ_GL_CALL( glDeleteShader( vertexShader ));
     EQ_GL_CALL( glDeleteShader( fragmentShader ));
 
+    if( useCache )
+        EQ_GL_CALL( glProgramParameteri( program,
+                                         GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                                         GL_TRUE ));
     EQ_GL_CALL( glLinkProgram( program ));
     GLint status;
     EQ_GL_CALL( glGetProgramiv( program, GL_LINK_STATUS, &status ));
@@ -90,6 +271,9 @@ bool linkProgram( const GLEWContext* glewContext LB_UNUSED,
                << errorLog << std::endl;
         return false;
     }
+
+    if( useCache )
+        _saveProgram( glewContext, program, key );
     return true;
 }
 
@@ -45,6 +45,11 @@ EQ_API bool compile( const GLEWContext* glewContext,
  * Link a shader program from a given vertex and fragment GLSL source and print
  * errors if any.
  *
+ * With ARB_get_program_binary, linked programs are cached by their sources and
+ * the GL driver, and later calls load the cached binary for any context of the
+ * process. If the EQ_SHADER_CACHE environment variable names a directory, the
+ * binaries are also stored there and reused by later processes.
+ *
  * @param glewContext the OpenGL function table.
  * @param program OpenGL shader program
  * @param vertexShaderSource GLSL formatted vertex shader source
@@ -18,6 +18,7 @@
  */
 
 #include "texture.h"
+#include "pixelBufferPool.h"
 
 #include <eq/fabric/pixelViewport.h>
 
@@ -25,6 +26,9 @@
 #include <eq/client/gl.h>
 #include <pression/plugins/compressor.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace eq
 {
 namespace util
@@ -43,6 +47,9 @@ public:
         , width( 0 )
         , height( 0 )
         , defined( false )
+        , streaming( false )
+        , immutable( false )
+        , pbo( 0 )
         , glewContext( gl )
         {}
 
@@ -50,6 +57,8 @@ public:
     {
         if( name != 0 )
             LBWARN << "OpenGL texture " << name << " not freed" << std::endl;
+        if( pbo != 0 )
+            LBWARN << "OpenGL buffer " << pbo << " not freed" << std::endl;
 
         name = 0;
         defined = false;
@@ -63,6 +72,10 @@ public:
     int32_t width;
     int32_t height;
     bool defined;
+    bool streaming; //!< bucketed storage and uploads, see setStreaming()
+    bool immutable; //!< storage allocated using glTexStorage2D
+    GLuint pbo; //!< the staging buffer of streaming uploads
+    PixelBufferPoolPtr pool; //!< the staging memory of uploads, if supported
     const GLEWContext* glewContext;
 };
 }
@@ -82,6 +95,14 @@ bool Texture::isValid() const
 
 void Texture::flush()
 {
+    _impl->pool = 0;
+    if( _impl->pbo != 0 )
+    {
+        LB_TS_THREAD( _thread );
+        EQ_GL_CALL( glDeleteBuffersARB( 1, &_impl->pbo ));
+        _impl->pbo = 0;
+    }
+
     if( _impl->name == 0 )
         return;
 
@@ -89,6 +110,7 @@ void Texture::flush()
     EQ_GL_CALL( glDeleteTextures( 1, &_impl->name ));
     _impl->name = 0;
     _impl->defined = false;
+    _impl->immutable = false;
 }
 
 void Texture::flushNoDelete()
@@ -96,6 +118,7 @@ void Texture::flushNoDelete()
     LB_TS_THREAD( _thread );
     _impl->name = 0;
     _impl->defined = false;
+    _impl->immutable = false;
 }
 
 uint32_t Texture::getCompressorTarget() const
@@ -124,6 +147,8 @@ void Texture::_setInternalFormat( const GLuint internalFormat )
     {
         // depth format
         case GL_DEPTH_COMPONENT:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32:
             setExternalFormat( GL_DEPTH_COMPONENT, GL_UNSIGNED_INT );
             break;
         case GL_RGB10_A2:
@@ -169,6 +194,16 @@ void Texture::_setInternalFormat( const GLuint internalFormat )
     }
 }
 
+void Texture::setStreaming( const bool streaming )
+{
+    _impl->streaming = streaming;
+}
+
+bool Texture::isStreaming() const
+{
+    return _impl->streaming;
+}
+
 void Texture::setExternalFormat( const uint32_t format, const uint32_t type )
 {
      _impl->format = format;
@@ -213,6 +248,88 @@ static bool _isPOT( const uint32_t width, const uint32_t height )
            ( width & ( width - 1 )) == 0 &&
            ( height & ( height - 1 )) == 0 );
 }
+
+/* The storage size of streaming textures: the next power of two up to 512,
+ * and the next multiple of 512 above. Bounds the wasted memory while sizes
+ * varying under load balancing mostly fall into an allocated bucket. */
+static int32_t _getBucketSize( const int32_t size )
+{
+    if( size > 512 )
+        return ( size + 511 ) & ~511;
+
+    int32_t bucket = 16;
+    while( bucket < size )
+        bucket <<= 1;
+    return bucket;
+}
+
+/* @return the sized format for immutable storage, or 0 if unknown. */
+static GLenum _getSizedFormat( const GLuint internalFormat )
+{
+    switch( internalFormat )
+    {
+        case GL_RGBA:
+            return GL_RGBA8;
+        case GL_RGB:
+            return GL_RGB8;
+        case GL_DEPTH_COMPONENT:
+            return GL_DEPTH_COMPONENT24;
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32:
+        case GL_DEPTH24_STENCIL8:
+        case GL_RGB10_A2:
+        case GL_RGBA8:
+        case GL_RGBA16F:
+        case GL_RGBA32F:
+        case GL_RGB8:
+        case GL_RGB16F:
+        case GL_RGB32F:
+        case GL_ALPHA32F_ARB:
+        case GL_RGBA32UI:
+            return internalFormat;
+        default:
+            return 0;
+    }
+}
+
+/* @return the size of one pixel in bytes, or 0 if unknown. */
+static size_t _getPixelSize( const GLuint format, const GLuint type )
+{
+    switch( type )
+    {
+        case GL_UNSIGNED_INT_10_10_10_2:
+        case GL_UNSIGNED_INT_24_8:
+            return 4; // packed
+        default:
+            break;
+    }
+
+    size_t size = 0;
+    switch( type )
+    {
+        case GL_UNSIGNED_BYTE: size = 1; break;
+        case GL_HALF_FLOAT:    size = 2; break;
+        case GL_UNSIGNED_INT:
+        case GL_FLOAT:         size = 4; break;
+        default:               return 0;
+    }
+
+    switch( format )
+    {
+        case GL_DEPTH_COMPONENT:
+        case GL_ALPHA:
+            return size;
+        case GL_RGB:
+        case GL_BGR:
+            return 3 * size;
+        case GL_RGBA:
+        case GL_BGRA:
+        case GL_RGBA_INTEGER_EXT:
+            return 4 * size;
+        default:
+            return 0;
+    }
+}
 }
 
 void Texture::_grow( const int32_t width, const int32_t height )
@@ -277,10 +394,80 @@ void Texture::upload( const int32_t width, const int32_t height,
     else
         resize( _impl->width, _impl->height );
 
+    if( ptr && _uploadStreaming( width, height, ptr ))
+        return;
+
     EQ_GL_CALL( glTexSubImage2D( _impl->target, 0, 0, 0, width, height,
                                  _impl->format, _impl->type, ptr ));
 }
 
+bool Texture::_uploadStreaming( const int32_t width, const int32_t height,
+                                const void* ptr )
+{
+    LB_TS_THREAD( _thread );
+    LBASSERT( _impl->glewContext );
+    if( !GLEW_ARB_pixel_buffer_object )
+        return false;
+
+    // Rows of four-byte pixels are always aligned. A bound unpack buffer or a
+    // row length set by the caller changes the meaning of ptr.
+    const size_t pixelSize = _getPixelSize( _impl->format, _impl->type );
+    if( pixelSize == 0 || pixelSize % 4 != 0 )
+        return false;
+
+    GLint binding = 0, rowLength = 0;
+    EQ_GL_CALL( glGetIntegerv( GL_PIXEL_UNPACK_BUFFER_BINDING_ARB, &binding ));
+    EQ_GL_CALL( glGetIntegerv( GL_UNPACK_ROW_LENGTH, &rowLength ));
+    if( binding != 0 || rowLength != 0 )
+        return false;
+
+    const size_t size = size_t( width ) * size_t( height ) * pixelSize;
+    if( !_impl->pool || _impl->pool->glewGetContext() != _impl->glewContext )
+        _impl->pool = PixelBufferPool::get( _impl->glewContext );
+    if( _impl->pool )
+    {
+        const PixelBufferPool::Range range = _impl->pool->allocate( size );
+        if( range.isValid( ))
+        {
+            ::memcpy( range.data, ptr, size );
+            EQ_GL_CALL( glBindBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB,
+                                         range.name ));
+            EQ_GL_CALL( glTexSubImage2D( _impl->target, 0, 0, 0, width,
+                                         height, _impl->format, _impl->type,
+                                         (const GLvoid*)range.offset ));
+            EQ_GL_CALL( glBindBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB, 0 ));
+            _impl->pool->release( range );
+            _impl->pool->fence();
+            return true;
+        }
+    }
+
+    if( !_impl->streaming )
+        return false;
+
+    if( _impl->pbo == 0 )
+        EQ_GL_CALL( glGenBuffersARB( 1, &_impl->pbo ));
+
+    // orphan the buffer, the previous upload may still read from it
+    EQ_GL_CALL( glBindBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB, _impl->pbo ));
+    EQ_GL_CALL( glBufferDataARB( GL_PIXEL_UNPACK_BUFFER_ARB, size, 0,
+                                 GL_STREAM_DRAW_ARB ));
+    void* data = glMapBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB,
+                                 GL_WRITE_ONLY_ARB );
+    if( !data )
+    {
+        EQ_GL_CALL( glBindBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB, 0 ));
+        return false;
+    }
+
+    ::memcpy( data, ptr, size );
+    EQ_GL_CALL( glUnmapBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB ));
+    EQ_GL_CALL( glTexSubImage2D( _impl->target, 0, 0, 0, width, height,
+                                 _impl->format, _impl->type, 0 ));
+    EQ_GL_CALL( glBindBufferARB( GL_PIXEL_UNPACK_BUFFER_ARB, 0 ));
+    return true;
+}
+
 void Texture::download( void* buffer ) const
 {
     LBASSERT( isValid( ));
@@ -302,11 +489,17 @@ void Texture::bindToFBO( const GLenum target, const int32_t width,
     LBASSERT( _impl->internalFormat );
     LBASSERT( _impl->glewContext );
 
+    if( _impl->immutable )
+        flush(); // can't be respecified
     _generate();
 
+    // Keep textures already defined at this size, e.g., wrapped using
+    // setGLData(), which might have immutable storage.
     EQ_GL_CALL( glBindTexture( _impl->target, _impl->name ));
-    EQ_GL_CALL( glTexImage2D( _impl->target, 0, _impl->internalFormat, width,
-                              height, 0, _impl->format, _impl->type, 0 ));
+    if( !_impl->defined || _impl->width != width || _impl->height != height )
+        EQ_GL_CALL( glTexImage2D( _impl->target, 0, _impl->internalFormat,
+                                  width, height, 0, _impl->format,
+                                  _impl->type, 0 ));
     EQ_GL_CALL( glFramebufferTexture2DEXT( GL_FRAMEBUFFER, target,
                                            _impl->target, _impl->name, 0 ));
 
@@ -332,6 +525,12 @@ void Texture::resize( const int32_t width, const int32_t height )
     if( _impl->width == width && _impl->height == height && _impl->defined )
         return;
 
+    if( _impl->streaming )
+    {
+        _resizeStreaming( width, height );
+        return;
+    }
+
     if( _impl->target == GL_TEXTURE_2D && !_isPOT( width, height ))
     {
         LBASSERT( _impl->glewContext );
@@ -346,6 +545,41 @@ void Texture::resize( const int32_t width, const int32_t height )
     _impl->defined = true;
 }
 
+void Texture::_resizeStreaming( const int32_t width, const int32_t height )
+{
+    if( _impl->defined && width <= _impl->width && height <= _impl->height )
+        return; // fits into the current storage
+
+    // grow to the bucket fitting both the old and the new size
+    const int32_t w = _getBucketSize( std::max( width, _impl->width ));
+    const int32_t h = _getBucketSize( std::max( height, _impl->height ));
+    const GLenum sizedFormat = _getSizedFormat( _impl->internalFormat );
+    LBASSERT( _impl->glewContext );
+
+    if( _impl->immutable ) // immutable storage needs a new texture name
+    {
+        EQ_GL_CALL( glDeleteTextures( 1, &_impl->name ));
+        _impl->name = 0;
+        _generate();
+    }
+
+    EQ_GL_CALL( glBindTexture( _impl->target, _impl->name ));
+    if( sizedFormat && GLEW_ARB_texture_storage )
+    {
+        EQ_GL_CALL( glTexStorage2D( _impl->target, 1, sizedFormat, w, h ));
+        _impl->immutable = true;
+    }
+    else
+        EQ_GL_CALL( glTexImage2D( _impl->target, 0, _impl->internalFormat, w,
+                                  h, 0, _impl->format, _impl->type, 0 ));
+
+    LBVERB << "Allocated " << w << "x" << h << " streaming texture "
+           << _impl->name << std::endl;
+    _impl->width  = w;
+    _impl->height = h;
+    _impl->defined = true;
+}
+
 void Texture::writeRGB( const std::string& filename ) const
 {
     LBASSERT( _impl->defined );
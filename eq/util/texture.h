@@ -104,6 +104,25 @@ public:
 
     /** @return true if the texture can be bound. @version 1.0 */
     EQ_API bool isValid() const;
+
+    /**
+     * Enable streaming for textures uploaded repeatedly with varying sizes.
+     *
+     * A streaming texture allocates its storage in size buckets, using
+     * immutable storage if ARB_texture_storage is supported. It grows to the
+     * smallest bucket fitting the requested size, and keeps the storage for
+     * smaller sizes. Its width and height are the ones of the storage. Uploads
+     * of client memory are staged through the PixelBufferPool of the context,
+     * or an orphaned pixel buffer object if pools are not supported.
+     *
+     * Only useful for textures drawn with texture coordinates in pixels, e.g.,
+     * GL_TEXTURE_RECTANGLE_ARB, or with coordinates computed from the size.
+     * @version 1.8
+     */
+    EQ_API void setStreaming( const bool streaming );
+
+    /** @return true if streaming is enabled. @version 1.8 */
+    EQ_API bool isStreaming() const;
     //@}
 
     /** @name Operations. */
@@ -209,6 +228,16 @@ private:
     /** Set the size of the texture, updating the _defined flag. */
     void _grow( const int32_t width, const int32_t height );
 
+    /** Allocate the bucketed storage of a streaming texture, if needed. */
+    void _resizeStreaming( const int32_t width, const int32_t height );
+
+    /**
+     * Upload through the pixel buffer pool, or the staging buffer of streaming
+     * textures. @return false if not possible.
+     */
+    bool _uploadStreaming( const int32_t width, const int32_t height,
+                           const void* ptr );
+
     LB_TS_VAR( _thread );
 };
 /** Print the texture state to the given output stream. @version 1.7.1 */
@@ -29,8 +29,10 @@ namespace util
 
 class Accum;
 class AccumBufferObject;
+class AsyncLoader;
 class FrameBufferObject;
 class PixelBufferObject;
+class PixelBufferPool;
 class Texture;
 class BitmapFont;
 class ObjectManager;
@@ -40,6 +42,9 @@ namespace shader {}
 /** A vector of pointers to eq::util::Texture */
 typedef std::vector< Texture* >  Textures;
 
+/** A reference pointer to the eq::util::PixelBufferPool of a context */
+typedef lunchbox::RefPtr< PixelBufferPool > PixelBufferPoolPtr;
+
 #ifdef EQ_USE_DEPRECATED
 typedef Textures TextureVector;
 #endif
@@ -0,0 +1,85 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EVOLVE_BRICK_FORMAT_H
+#define EVOLVE_BRICK_FORMAT_H
+
+#include <stdint.h>
+
+namespace eVolve
+{
+/** Bricked, multi-resolution volume file format.
+
+    A bricked volume is written by eVolveConverter next to the raw file as
+    <name>.raw.bricks, the .vhf header still provides scaling and transfer
+    function. The file contains a BrickHeader, followed by one BrickInfo per
+    brick of all levels, followed by the brick data. Level 0 has the full
+    resolution, each further level halves the resolution in all dimensions
+    (rounding up) down to a single brick. Bricks are ordered by level, then by
+    z, y and x. Each brick stores brickSize^3 voxels of 'bytes' bytes, x
+    fastest, border bricks are padded by repeating the last voxel.
+*/
+namespace bricks
+{
+static const uint32_t MAGIC   = 0x52425645; //!< "EVBR"
+static const uint32_t VERSION = 1;
+
+struct Header
+{
+    uint32_t magic;     //!< MAGIC
+    uint32_t version;   //!< VERSION
+    uint32_t width;     //!< level 0 width in voxels
+    uint32_t height;    //!< level 0 height in voxels
+    uint32_t depth;     //!< level 0 depth in voxels
+    uint32_t bytes;     //!< bytes per voxel, 1 (raw) or 4 (raw+derivatives)
+    uint32_t brickSize; //!< edge length of a brick in voxels
+    uint32_t nLevels;   //!< number of resolution levels
+};
+
+struct Info
+{
+    uint64_t offset;    //!< file offset of the brick data
+    uint8_t  minValue;  //!< minimum density in the brick
+    uint8_t  maxValue;  //!< maximum density in the brick
+    uint8_t  padding[6];
+};
+
+/** @return the size of a volume dimension at the given level. */
+inline uint32_t getLevelSize( const uint32_t size, const uint32_t level )
+{
+    return ( size + ( 1u << level ) - 1 ) >> level;
+}
+
+/** @return the number of bricks needed to cover the given size. */
+inline uint32_t getNumBricks( const uint32_t size, const uint32_t brickSize )
+{
+    return ( size + brickSize - 1 ) / brickSize;
+}
+}
+}
+
+#endif // EVOLVE_BRICK_FORMAT_H
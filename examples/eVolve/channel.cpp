@@ -35,7 +35,6 @@
 #include "pipe.h"
 #include "window.h"
 #include "hlp.h"
-#include "framesOrderer.h"
 
 namespace eVolve
 {
@@ -259,24 +258,6 @@ void Channel::clearViewport( const eq::PixelViewport &pvp )
     glScissor( 0, 0, windowPVP.w, windowPVP.h );
 }
 
-void Channel::_orderFrames( eq::Frames& frames )
-{
-    const FrameData&    frameData = _getFrameData();
-    const eq::Matrix4f& rotation  = frameData.getRotation();
-
-    const eq::Matrix4f& modelView = useOrtho() ? eq::Matrix4f::IDENTITY :
-                                                 _computeModelView();
-
-    //calculate modelview inversed transposed matrix
-    eq::Matrix3f modelviewITM;
-    eq::Matrix4f modelviewIM;
-    modelView.inverse( modelviewIM );
-    eq::Matrix3f( modelviewIM ).transpose_to( modelviewITM );
-
-    orderFrames( frames, modelView, modelviewITM, rotation, useOrtho( ));
-}
-
-
 void Channel::frameAssemble( const eq::uint128_t&, const eq::Frames& frames )
 {
     const bool composeOnly = (_drawRange == eq::Range::ALL);
@@ -324,7 +305,8 @@ void Channel::frameAssemble( const eq::uint128_t&, const eq::Frames& frames )
         dbFrames.push_back( &_frame );
     }
 
-    _orderFrames( dbFrames );
+    eq::Compositor::sortFramesByRange( dbFrames, _computeModelView(),
+                                       useOrtho( ));
 
     // Update range
     eq::Range newRange( 1.f, 0.f );
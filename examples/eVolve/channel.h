@@ -66,7 +66,6 @@ namespace eVolve
     private:
         void _startAssemble();
 
-        void _orderFrames( eq::Frames& frames );
 
         eq::Matrix4f _computeModelView() const;
 
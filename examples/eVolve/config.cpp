@@ -49,10 +49,20 @@ bool Config::init()
     LBCHECK( registerObject( &_frameData ));
 
     _frameData.setOrtho( _initData.getOrtho( ));
+    _frameData.setRaycast( _initData.getRaycast( ));
     _initData.setFrameDataID( _frameData.getID( ));
 
     _frameData.setAutoObsolete( getLatency( ));
 
+    // distribute the model files to the render nodes
+    const std::string& filename = _initData.getFilename();
+    eq::Strings filenames;
+    filenames.push_back( filename );
+    filenames.push_back( filename + ".vhf" );
+    filenames.push_back( filename + ".bricks" );
+    LBCHECK( _dataCache.registerFiles( this, filenames ));
+    _initData.setDataCacheID( _dataCache.getID( ));
+
     LBCHECK( registerObject( &_initData ));
 
     // init config
@@ -76,7 +86,8 @@ bool Config::init()
 bool Config::loadInitData( const eq::uint128_t& id )
 {
     LBASSERT( !_initData.isAttached( ));
-    return getClient()->syncObject( &_initData, getApplicationNode(), id );
+    return getClient()->syncObject( &_initData, getApplicationNode(), id ) &&
+           _dataCache.fetch( this, _initData.getDataCacheID( ));
 }
 
 bool Config::exit()
@@ -91,8 +102,10 @@ void Config::_deregisterData()
 {
     deregisterObject( &_initData );
     deregisterObject( &_frameData );
+    _dataCache.deregisterFiles( this );
 
     _initData.setFrameDataID( co::uint128_t( ));
+    _initData.setDataCacheID( co::uint128_t( ));
 }
 
 
@@ -100,6 +113,7 @@ uint32_t Config::startFrame()
 {
     // update database
     _frameData.spinCamera( -0.001f * _spinX, -0.001f * _spinY );
+    _frameData.updateIdle();
     const eq::uint128_t& version = _frameData.commit();
 
     _resetMessage();
@@ -234,6 +248,11 @@ bool Config::_handleKeyEvent( const eq::KeyEvent& event )
             _frameData.toggleOrtho();
             return true;
 
+        case 'g':
+        case 'G':
+            _frameData.toggleRaycast();
+            return true;
+
         case 's':
         case 'S':
         _frameData.toggleStatistics();
@@ -32,6 +32,7 @@
 
 #include <eq/eq.h>
 
+#include "dataCache.h"     // member
 #include "localInitData.h" // member
 #include "frameData.h"     // member
 
@@ -56,6 +57,10 @@ namespace eVolve
         /** Map per-config data to the local node process */
         bool loadInitData( const eq::uint128_t& initDataID );
 
+        /** @return the model file, cached locally on render nodes. */
+        std::string getFilename() const
+            { return _dataCache.getFilename( _initData.getFilename( )); }
+
     protected:
         virtual ~Config();
 
@@ -68,6 +73,7 @@ namespace eVolve
 
         LocalInitData _initData;
         FrameData     _frameData;
+        DataCache     _dataCache;
 
         uint64_t      _messageTime;
 
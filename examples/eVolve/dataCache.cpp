@@ -0,0 +1,341 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dataCache.h"
+
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace eVolve
+{
+namespace
+{
+const uint64_t _chunkSize = 4 * 1024 * 1024;
+const size_t _maxRequests = 8; // chunks mapped concurrently per node
+
+/** 64 bit FNV-1a hash */
+uint64_t _hash( const uint8_t* data, const uint64_t size,
+                uint64_t hash = 14695981039346656037ull )
+{
+    for( uint64_t i = 0; i < size; ++i )
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool _read( std::fstream& file, const uint64_t offset, const uint64_t size,
+            std::vector< uint8_t >& data )
+{
+    data.resize( size );
+    file.clear();
+    file.seekg( offset, std::ios::beg );
+    file.read( reinterpret_cast< char* >( data.data( )), size );
+    return !file.fail();
+}
+
+std::string _getCacheDirectory()
+{
+    const char* env = ::getenv( "EVOLVE_CACHE" );
+    if( env )
+        return env;
+    return ( boost::filesystem::temp_directory_path() /
+             "eVolve-cache" ).string();
+}
+}
+
+/** The files and their chunks, a static object. */
+class DataCache::Manifest : public co::Object
+{
+public:
+    struct File
+    {
+        File() : size( 0 ) {}
+
+        std::string name;
+        uint64_t size;
+        std::vector< uint64_t > hashes;
+        std::vector< eq::uint128_t > chunkIDs;
+
+        /** @return the content hash of the file. */
+        uint64_t getHash() const
+        {
+            const uint8_t* data =
+                reinterpret_cast< const uint8_t* >( hashes.data( ));
+            return _hash( data, hashes.size() * sizeof( uint64_t ),
+                          _hash( reinterpret_cast< const uint8_t* >( &size ),
+                                 sizeof( size )));
+        }
+
+        uint64_t getChunkSize( const size_t i ) const
+            { return std::min( _chunkSize, size - i * _chunkSize ); }
+    };
+    typedef std::vector< File > Files;
+
+    Files files;
+
+protected:
+    void getInstanceData( co::DataOStream& os ) override
+    {
+        os << uint64_t( files.size( ));
+        for( Files::const_iterator i = files.begin(); i != files.end(); ++i )
+            os << i->name << i->size << i->hashes << i->chunkIDs;
+    }
+
+    void applyInstanceData( co::DataIStream& is ) override
+    {
+        uint64_t nFiles = 0;
+        is >> nFiles;
+        files.resize( nFiles );
+        for( Files::iterator i = files.begin(); i != files.end(); ++i )
+            is >> i->name >> i->size >> i->hashes >> i->chunkIDs;
+    }
+};
+
+/** One chunk of a file, read from disk when mapped. */
+class DataCache::Chunk : public co::Object
+{
+public:
+    Chunk() : _offset( 0 ), _size( 0 ) {}
+    Chunk( const std::string& filename, const uint64_t offset,
+           const uint64_t size )
+        : _filename( filename ), _offset( offset ), _size( size ) {}
+
+    const std::vector< uint8_t >& getData() const { return _data; }
+
+protected:
+    void getInstanceData( co::DataOStream& os ) override
+    {
+        std::fstream file( _filename.c_str(), std::ios::in |
+                                              std::ios::binary );
+        if( !_read( file, _offset, _size, _data ))
+        {
+            LBWARN << "Can't read " << _size << " bytes at " << _offset
+                   << " of " << _filename << std::endl;
+            _data.clear();
+        }
+        os << _data;
+        _data.clear();
+    }
+
+    void applyInstanceData( co::DataIStream& is ) override { is >> _data; }
+
+private:
+    std::string _filename;
+    uint64_t _offset;
+    uint64_t _size;
+    std::vector< uint8_t > _data;
+};
+
+DataCache::DataCache()
+    : _manifest( new Manifest )
+{}
+
+DataCache::~DataCache()
+{
+    LBASSERT( _chunks.empty( ));
+    delete _manifest;
+}
+
+bool DataCache::registerFiles( eq::Config* config,
+                               const eq::Strings& filenames )
+{
+    LBASSERT( !_manifest->isAttached( ));
+    std::vector< uint8_t > data;
+
+    for( eq::StringsCIter i = filenames.begin(); i != filenames.end(); ++i )
+    {
+        std::fstream file( i->c_str(), std::ios::in | std::ios::binary |
+                                       std::ios::ate );
+        if( !file.is_open( ))
+            continue;
+
+        Manifest::File entry;
+        entry.name = *i;
+        entry.size = uint64_t( file.tellg( ));
+
+        const size_t nChunks = ( entry.size + _chunkSize - 1 ) / _chunkSize;
+        for( size_t j = 0; j < nChunks; ++j )
+        {
+            const uint64_t size = entry.getChunkSize( j );
+            if( !_read( file, j * _chunkSize, size, data ))
+            {
+                LBWARN << "Can't read " << *i << std::endl;
+                return false;
+            }
+
+            Chunk* chunk = new Chunk( *i, j * _chunkSize, size );
+            _chunks.push_back( chunk );
+            if( !config->registerObject( chunk ))
+                return false;
+
+            entry.hashes.push_back( _hash( data.data(), size ));
+            entry.chunkIDs.push_back( chunk->getID( ));
+        }
+        _manifest->files.push_back( entry );
+    }
+    return config->registerObject( _manifest );
+}
+
+void DataCache::deregisterFiles( eq::Config* config )
+{
+    if( _manifest->isAttached( ))
+        config->deregisterObject( _manifest );
+    _manifest->files.clear();
+
+    for( size_t i = 0; i < _chunks.size(); ++i )
+    {
+        if( _chunks[i]->isAttached( ))
+            config->deregisterObject( _chunks[i] );
+        delete _chunks[i];
+    }
+    _chunks.clear();
+}
+
+eq::uint128_t DataCache::getID() const
+{
+    return _manifest->getID();
+}
+
+bool DataCache::fetch( eq::Config* config, const eq::uint128_t& id )
+{
+    co::NodePtr appNode = config->getApplicationNode();
+    if( !config->getClient()->syncObject( _manifest, appNode, id ))
+        return false;
+
+    // all files share one directory, named by their content, to keep
+    // related files, e.g., a volume and its header, next to each other
+    const Manifest::Files& files = _manifest->files;
+    uint64_t hash = 0;
+    for( Manifest::Files::const_iterator i = files.begin(); i != files.end();
+         ++i )
+    {
+        const uint64_t fileHash = i->getHash();
+        hash = _hash( reinterpret_cast< const uint8_t* >( &fileHash ),
+                      sizeof( fileHash ), hash );
+    }
+    std::ostringstream dirName;
+    dirName << std::hex << std::setfill( '0' ) << std::setw( 16 ) << hash;
+    const boost::filesystem::path directory =
+        boost::filesystem::path( _getCacheDirectory( )) / dirName.str();
+
+    std::vector< uint8_t > data;
+    for( Manifest::Files::const_iterator i = files.begin(); i != files.end();
+         ++i )
+    {
+        const boost::filesystem::path path =
+            directory / boost::filesystem::path( i->name ).filename();
+
+        boost::system::error_code error;
+        boost::filesystem::create_directories( directory, error );
+        if( !boost::filesystem::exists( path ))
+            std::ofstream create( path.string().c_str( ));
+        if( boost::filesystem::file_size( path, error ) != i->size )
+            boost::filesystem::resize_file( path, i->size, error );
+        if( error )
+        {
+            LBWARN << "Can't create " << path << ": " << error.message()
+                   << std::endl;
+            return false;
+        }
+
+        // verify the cached copy, one chunk at a time
+        std::fstream file( path.string().c_str(), std::ios::in |
+                                                  std::ios::out |
+                                                  std::ios::binary );
+        std::vector< size_t > missing;
+        for( size_t j = 0; j < i->hashes.size(); ++j )
+        {
+            if( !_read( file, j * _chunkSize, i->getChunkSize( j ), data ) ||
+                _hash( data.data(), data.size( )) != i->hashes[j] )
+            {
+                missing.push_back( j );
+            }
+        }
+
+        // map the missing chunks from the app node, several at a time
+        for( size_t j = 0; j < missing.size(); j += _maxRequests )
+        {
+            const size_t end = std::min( j + _maxRequests, missing.size( ));
+            std::vector< Chunk > chunks( end - j );
+            std::vector< uint32_t > requests;
+            for( size_t k = j; k < end; ++k )
+                requests.push_back( config->mapObjectNB( &chunks[ k - j ],
+                                            i->chunkIDs[ missing[k] ],
+                                            co::VERSION_OLDEST, appNode ));
+
+            bool success = true;
+            for( size_t k = j; k < end; ++k )
+            {
+                Chunk& chunk = chunks[ k - j ];
+                const size_t index = missing[k];
+                const bool mapped = config->mapObjectSync( requests[ k - j ]);
+                const std::vector< uint8_t >& chunkData = chunk.getData();
+                const bool valid = mapped &&
+                    chunkData.size() == i->getChunkSize( index ) &&
+                    _hash( chunkData.data(), chunkData.size( )) ==
+                        i->hashes[ index ];
+                if( valid )
+                {
+                    file.clear();
+                    file.seekp( index * _chunkSize, std::ios::beg );
+                    file.write( reinterpret_cast< const char* >(
+                                    chunkData.data( )), chunkData.size( ));
+                }
+                if( mapped )
+                    config->unmapObject( &chunk );
+                if( !valid || file.fail( ))
+                {
+                    LBWARN << "Can't fetch chunk " << index << " of "
+                           << i->name << std::endl;
+                    success = false;
+                }
+            }
+            if( !success )
+                return false;
+        }
+
+        LBINFO << "Cached " << i->name << " in " << path << ", fetched "
+               << missing.size() << " of " << i->hashes.size() << " chunks"
+               << std::endl;
+        _cached[ i->name ] = path.string();
+    }
+    return true;
+}
+
+std::string DataCache::getFilename( const std::string& filename ) const
+{
+    std::map< std::string, std::string >::const_iterator i =
+        _cached.find( filename );
+    return i == _cached.end() ? filename : i->second;
+}
+}
@@ -0,0 +1,79 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EVOLVE_DATA_CACHE_H
+#define EVOLVE_DATA_CACHE_H
+
+#include <eq/eq.h>
+
+#include <map>
+
+namespace eVolve
+{
+/**
+ * Distributes the data files of the application to the render nodes.
+ *
+ * The application node registers each file in chunks, identified by the hash
+ * of their content. Render nodes keep a copy of each file in a local cache
+ * directory named after the content hash of the file, verify the chunks of an
+ * existing copy and map only the missing or corrupt chunks from the
+ * application node, several at a time. Later sessions use the cached files
+ * without any transfer. The cache directory is set by the EVOLVE_CACHE
+ * environment variable and defaults to the temporary directory.
+ */
+class DataCache
+{
+public:
+    DataCache();
+    ~DataCache();
+
+    /** Register the existing files of the given list, on the app node. */
+    bool registerFiles( eq::Config* config, const eq::Strings& filenames );
+
+    /** Deregister all files, on the app node. */
+    void deregisterFiles( eq::Config* config );
+
+    /** @return the identifier of the registered file list. */
+    eq::uint128_t getID() const;
+
+    /** Fetch all files into the local cache, on a render node. */
+    bool fetch( eq::Config* config, const eq::uint128_t& id );
+
+    /** @return the cached copy of the given file, or the file itself. */
+    std::string getFilename( const std::string& filename ) const;
+
+private:
+    class Manifest;
+    class Chunk;
+
+    Manifest* const _manifest;
+    std::vector< Chunk* > _chunks; //!< registered chunks on the app node
+    std::map< std::string, std::string > _cached; //!< file -> cached copy
+};
+}
+
+#endif // EVOLVE_DATA_CACHE_H
@@ -49,6 +49,8 @@ static const std::string _help(
     std::string( "\t\tn:                         Toggle normals Quality mode (raw data only)\n" ) +
     std::string( "\t\to:                         Toggle " ) +
     std::string( "perspective/orthographic\n" ) +
+    std::string( "\t\tg:                         Toggle ray casting/slice " ) +
+    std::string( "rendering\n" ) +
     std::string( "\t\ts:                         Toggle statistics " ) +
     std::string( "overlay\n" ) +
     std::string( "\t\tl:                         Switch layout for active canvas\n")+
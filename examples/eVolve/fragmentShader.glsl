@@ -37,6 +37,21 @@ uniform int   normalsQuality;
 uniform vec3  viewVec;
 uniform vec3  sizeVec;
 uniform vec4  taint; // .rgb should be pre-multiplied with .a
+uniform float sampleScale; // slice distance relative to full precision
+
+// Correct a pre-integrated sample for a sample distance of sampleScale times
+// the distance the table was built for. .a is the transmittance.
+vec4 scaleOpacity( vec4 preInt_ )
+{
+    if( sampleScale == 1.0 )
+        return preInt_;
+
+    float transmittance = pow( preInt_.a, sampleScale );
+    float opacity       = 1.0 - preInt_.a;
+    float factor = opacity > 0.001 ? (1.0 - transmittance) / opacity
+                                   : sampleScale;
+    return vec4( preInt_.rgb * factor, transmittance );
+}
 
 void main (void)
 {
@@ -107,7 +122,7 @@ else
     float lookupSF = texture3D(volume, gl_TexCoord[0].xyz).a;
     float lookupSB = texture3D(volume, gl_TexCoord[1].xyz).a;
 
-    vec4 preInt_ = texture2D(preInt, vec2(lookupSF, lookupSB));
+    vec4 preInt_ = scaleOpacity( texture2D(preInt, vec2(lookupSF, lookupSB)));
 
     if( taint.a != 0.0 )
         preInt_ = vec4( preInt_.rgb*(1.0-taint.a) + 
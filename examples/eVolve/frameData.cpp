@@ -38,11 +38,13 @@ namespace eVolve
 
 FrameData::FrameData()
     : _ortho(         false )
+    , _raycast(       false )
     , _colorMode(     COLOR_MODEL )
     , _bgMode(        BG_BLACK )
     , _normalsQuality(NQ_FULL )
     , _statistics(    false )
     , _help(          false )
+    , _idle(          true )
     , _quality( 1.0f )
 {
     reset();
@@ -92,6 +94,18 @@ void FrameData::setOrtho( const bool ortho )
     setDirty( DIRTY_FLAGS );
 }
 
+void FrameData::toggleRaycast()
+{
+    _raycast = !_raycast;
+    setDirty( DIRTY_FLAGS );
+}
+
+void FrameData::setRaycast( const bool raycast )
+{
+    _raycast = raycast;
+    setDirty( DIRTY_FLAGS );
+}
+
 void FrameData::toggleStatistics()
 {
     _statistics = !_statistics;
@@ -142,6 +156,16 @@ void FrameData::setCurrentViewID( const eq::uint128_t& id )
     setDirty( DIRTY_VIEW );
 }
 
+void FrameData::updateIdle()
+{
+    const bool idle = !isDirty( DIRTY_CAMERA );
+    if( idle == _idle )
+        return;
+
+    _idle = idle;
+    setDirty( DIRTY_FLAGS );
+}
+
 void FrameData::adjustQuality( const float delta )
 {
     _quality += delta;
@@ -161,8 +185,8 @@ void FrameData::serialize( co::DataOStream& os, const uint64_t dirtyBits )
         os << _rotation << _translation;
 
     if( dirtyBits & DIRTY_FLAGS )
-        os  << _ortho << _colorMode << _bgMode << _normalsQuality
-            << _statistics << _quality << _help;
+        os  << _ortho << _raycast << _colorMode << _bgMode << _normalsQuality
+            << _statistics << _quality << _help << _idle;
 
     if( dirtyBits & DIRTY_MESSAGE )
         os << _message;
@@ -178,8 +202,8 @@ void FrameData::deserialize( co::DataIStream& is, const uint64_t dirtyBits)
         is >> _rotation >> _translation;
 
     if( dirtyBits & DIRTY_FLAGS )
-        is  >> _ortho >> _colorMode >> _bgMode >> _normalsQuality
-            >> _statistics  >> _quality >> _help;
+        is  >> _ortho >> _raycast >> _colorMode >> _bgMode >> _normalsQuality
+            >> _statistics  >> _quality >> _help >> _idle;
 
     if( dirtyBits & DIRTY_MESSAGE )
         is >> _message;
@@ -47,11 +47,13 @@ namespace eVolve
         /** @name Rendering flags. */
         //*{
         void setOrtho( const bool ortho );
+        void setRaycast( const bool raycast );
         void adjustQuality( const float delta );
         void toggleBackground();
         void toggleNormalsQuality();
         void toggleColorMode();
         void toggleOrtho();
+        void toggleRaycast();
         void toggleHelp();
         void toggleStatistics();
 
@@ -61,9 +63,15 @@ namespace eVolve
         void setTranslation( const eq::Vector3f& translation );
         void setRotation(    const eq::Vector3f& rotation    );
 
+        /** Mark the frame idle if the camera did not change since the last
+            commit. Renderers lower the slice count only for non-idle frames. */
+        void updateIdle();
+
         bool showHelp()      const { return _help;       }
         bool useOrtho( )     const { return _ortho;      }
+        bool useRaycast()    const { return _raycast;    }
         bool useStatistics() const { return _statistics; }
+        bool isIdle()        const { return _idle;       }
 
         const eq::Vector3f& getTranslation() const { return _translation; }
         const eq::Matrix4f& getRotation()    const { return _rotation;    }
@@ -112,11 +120,13 @@ namespace eVolve
         eq::Matrix4f    _rotation;
         eq::Vector3f    _translation;
         bool            _ortho;
+        bool            _raycast;
         ColorMode       _colorMode;
         BackgroundMode  _bgMode;
         NormalsQuality  _normalsQuality;
         bool            _statistics;
         bool            _help;
+        bool            _idle;
         float           _quality;
         eq::uint128_t   _currentViewID;
         std::string     _message;
@@ -41,6 +41,7 @@ namespace eVolve
 
 InitData::InitData()
     : _frameDataID()
+    , _dataCacheID()
 #ifdef AGL
     , _windowSystem( "AGL" )
 #elif GLX
@@ -49,6 +50,7 @@ InitData::InitData()
     , _windowSystem( "WGL" )
 #endif
     , _precision( 2 )
+    , _targetFPS( 25.f )
     , _brightness( 1.0f )
     , _alpha( 1.0f )
     , _filename( lunchbox::getExecutablePath() +
@@ -62,14 +64,14 @@ InitData::~InitData()
 
 void InitData::getInstanceData( co::DataOStream& os )
 {
-    os << _frameDataID << _windowSystem << _precision << _brightness << _alpha
-       << _filename;
+    os << _frameDataID << _dataCacheID << _windowSystem << _precision << _brightness << _alpha
+       << _filename << _targetFPS;
 }
 
 void InitData::applyInstanceData( co::DataIStream& is )
 {
-    is >> _frameDataID >> _windowSystem >> _precision >> _brightness >> _alpha
-       >> _filename;
+    is >> _frameDataID >> _dataCacheID >> _windowSystem >> _precision >> _brightness >> _alpha
+       >> _filename >> _targetFPS;
 
     LBASSERT( _frameDataID != 0 );
 }
@@ -44,9 +44,13 @@ namespace eVolve
 
         void setFrameDataID( const eq::uint128_t& id )   { _frameDataID = id; }
 
+        void setDataCacheID( const eq::uint128_t& id )   { _dataCacheID = id; }
+
         eq::uint128_t      getFrameDataID()  const { return _frameDataID;  }
+        eq::uint128_t      getDataCacheID()  const { return _dataCacheID;  }
         const std::string& getWindowSystem() const { return _windowSystem; }
         uint32_t           getPrecision()    const { return _precision;    }
+        float              getTargetFPS()    const { return _targetFPS;    }
         float              getBrightness()   const { return _brightness;   }
         float              getAlpha()        const { return _alpha;        }
         const std::string& getFilename()     const { return _filename;     }
@@ -58,14 +62,17 @@ namespace eVolve
         void setWindowSystem( const std::string& windowSystem )
             { _windowSystem = windowSystem; }
         void setPrecision( const uint32_t precision ){ _precision = precision; }
+        void setTargetFPS( const float fps )         { _targetFPS = fps; }
         void setBrightness( const float brightness ) {_brightness = brightness;}
         void setAlpha( const float alpha )           { _alpha = alpha;}
         void setFilename( const std::string& filename ) { _filename = filename;}
 
     private:
         eq::uint128_t _frameDataID;
+        eq::uint128_t _dataCacheID;
         std::string   _windowSystem;
         uint32_t      _precision;
+        float         _targetFPS;
         float         _brightness;
         float         _alpha;
         std::string   _filename;
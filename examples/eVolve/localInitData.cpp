@@ -45,6 +45,7 @@ LocalInitData::LocalInitData()
         : _maxFrames( 0xffffffffu )
         , _isResident( false )
         , _ortho( false )
+        , _raycast( false )
 {}
 
 LocalInitData& LocalInitData::operator = ( const LocalInitData& from )
@@ -52,10 +53,12 @@ LocalInitData& LocalInitData::operator = ( const LocalInitData& from )
     _maxFrames   = from._maxFrames;
     _isResident  = from._isResident;
     _ortho       = from._ortho;
+    _raycast     = from._raycast;
 
     setFilename( from.getFilename( ));
     setWindowSystem( from.getWindowSystem( ));
     setPrecision( from.getPrecision( ));
+    setTargetFPS( from.getTargetFPS( ));
     setBrightness( from.getBrightness( ));
     setAlpha( from.getAlpha( ));
     return *this;
@@ -80,6 +83,7 @@ void LocalInitData::parseArguments( const int argc, char** argv )
 
     bool showHelp(false);
     uint32_t userDefinedPrecision(2);
+    float userDefinedTargetFPS(25.f);
     float userDefinedBrightness(1.0f);
     float userDefinedAlpha(1.0f);
     std::string userDefinedModelPath("");
@@ -101,6 +105,10 @@ void LocalInitData::parseArguments( const int argc, char** argv )
         ( "precision,p",
           po::value<uint32_t>(&userDefinedPrecision)->default_value(2),
           "Rendering precision (default 2, bigger is better and slower)")
+        ( "targetFPS,t",
+          po::value<float>(&userDefinedTargetFPS)->default_value(25.f),
+          "Frame rate kept during interaction by using fewer slices, 0 to "
+          "disable (default 25)")
         ( "brightness,b",
           po::value<float>(&userDefinedBrightness)->default_value(1.0f),
           "brightness factor" )
@@ -109,6 +117,8 @@ void LocalInitData::parseArguments( const int argc, char** argv )
           "alpha attenuation" )
         ( "ortho,o",      po::bool_switch(&_ortho)->default_value(false),
           "use orthographic projection" )
+        ( "raycast,g",    po::bool_switch(&_raycast)->default_value(false),
+          "use GPU ray casting with empty space skipping" )
         ( "windowSystem,w",
           po::value<std::string>(&userDefinedWindowSystem),
           wsHelp.c_str( ));
@@ -147,6 +157,8 @@ void LocalInitData::parseArguments( const int argc, char** argv )
 
     if( variableMap.count("precision") > 0 )
         setPrecision( userDefinedPrecision );
+    if( variableMap.count("targetFPS") > 0 )
+        setTargetFPS( userDefinedTargetFPS );
     if( variableMap.count("brightness") > 0 )
         setBrightness( userDefinedBrightness );
     if( variableMap.count("alpha") > 0 )
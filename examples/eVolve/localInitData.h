@@ -44,6 +44,7 @@ namespace eVolve
 
         bool               isResident()     const { return _isResident; }
         bool               getOrtho()       const { return _ortho;  }
+        bool               getRaycast()     const { return _raycast; }
         uint32_t           getMaxFrames()   const { return _maxFrames; }
 
         LocalInitData& operator = ( const LocalInitData& from );
@@ -52,6 +53,7 @@ namespace eVolve
         uint32_t    _maxFrames;
         bool        _isResident;
         bool        _ortho;
+        bool        _raycast;
     };
 }
 
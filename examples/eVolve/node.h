@@ -31,6 +31,7 @@
 
 #include "eVolve.h"
 #include "initData.h"
+#include "volumeData.h"
 
 #include <eq/eq.h>
 
@@ -41,10 +42,16 @@ namespace eVolve
     public:
         Node( eq::Config* parent ) : eq::Node( parent ) {}
 
+        /** @return the volume files shared by all pipes of this node. */
+        VolumeData& getVolumeData() { return _volumeData; }
+
     protected:
         virtual ~Node(){}
 
         virtual bool configInit( const eq::uint128_t& initID );
+
+    private:
+        VolumeData _volumeData;
     };
 }
 
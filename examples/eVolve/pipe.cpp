@@ -62,11 +62,12 @@ bool Pipe::configInit( const eq::uint128_t& initID )
     const bool mapped = config->mapObject( &_frameData, frameDataID );
     LBASSERT( mapped );
 
-    const std::string& filename = initData.getFilename();
+    const std::string filename = config->getFilename();
     const uint32_t precision = initData.getPrecision();
     LBINFO << "Loading model " << filename << std::endl;
 
-    _renderer = new Renderer( filename, precision );
+    Node* node = static_cast< Node* >( getNode( ));
+    _renderer = new Renderer( filename, precision, node->getVolumeData( ));
     LBASSERT( _renderer );
 
     if( !_renderer->loadHeader( initData.getBrightness(), initData.getAlpha( )))
@@ -97,5 +98,11 @@ void Pipe::frameStart( const eq::uint128_t& frameID, const uint32_t frameNumber
     _frameData.sync( frameID );
 
     _renderer->setOrtho( _frameData.useOrtho( ));
+    _renderer->setRaycast( _frameData.useRaycast( ));
+
+    const Config* config = static_cast< const Config* >( getConfig( ));
+    const float targetFPS = config->getInitData().getTargetFPS();
+    _renderer->adaptSlices( _frameData.isIdle(), _frameClock.resetTimef(),
+                            targetFPS > 0.f ? 1000.f / targetFPS : 0.f );
 }
 }
@@ -56,6 +56,7 @@ namespace eVolve
 
     private:
         FrameData _frameData;
+        lunchbox::Clock _frameClock;  //!< time since the last frame start
 
         Renderer*   _renderer;      //!< The renderer, holding the volume
     };
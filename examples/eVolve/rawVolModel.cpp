@@ -28,6 +28,12 @@
 
 #include "rawVolModel.h"
 #include "hlp.h"
+#include "volumeData.h"
+#include "volumeLoader.h"
+
+#include <eq/util/pixelBufferObject.h>
+
+#include <cstring>
 
 namespace eVolve
 {
@@ -50,18 +56,20 @@ static bool readDimensionsAndScaling
 
 
 // Read volume dimensions, scaling and transfer function
-RawVolumeModel::RawVolumeModel( const std::string& filename  )
-        : _headerLoaded( false )
+RawVolumeModel::RawVolumeModel( const std::string& filename, VolumeData& data )
+        : _loader( 0 )
+        , _currentKey( 0 )
+        , _headerLoaded( false )
         , _filename( filename )
+        , _data( data )
         , _preintName  ( 0 )
         , _w( 0 )
         , _h( 0 )
         , _d( 0 )
-        , _tW( 0 )
-        , _tH( 0 )
-        , _tD( 0 )
         , _resolution( 0 )
         , _hasDerivatives( true )
+        , _brickData( 0 )
+        , _brickDataSize( 0 )
         , _glewContext( 0 )
 {}
 
@@ -96,6 +104,7 @@ bool RawVolumeModel::loadHeader( const float brightness, const float alpha )
         return false;
 
     _headerLoaded = true;
+    _loadBricks();
 
     if( brightness != 1.0f )
     {
@@ -132,37 +141,83 @@ bool RawVolumeModel::getVolumeInfo( VolumeInfo& info, const eq::Range& range )
         _preintName = createPreintegrationTable( &_TF[0] );
     }
 
-          VolumePart* volumePart = 0;
-    const int32_t     key        = calcHashKey( range );
-
-    if( _volumeHash.find( key ) == _volumeHash.end( ) )
-    {
-        // new key
-        volumePart = &_volumeHash[ key ];
-        if( !_createVolumeTexture( volumePart->volume, volumePart->TD, range ))
-            return false;
-    }
-    else
-    {   // old key
-        volumePart = &_volumeHash[ key ];
-    }
+    const VolumePart* volumePart = _getVolumePart( calcHashKey( range ),
+                                                   range );
+    if( !volumePart )
+        return false;
 
     info.volume     = volumePart->volume;
     info.TD         = volumePart->TD;
     info.preint     = _preintName;
     info.volScaling = _volScaling;
-    if( _hasDerivatives )
+    info.voxelSize  = volumePart->voxelSize;
+    info.occupancy  = volumePart->occupancy;
+    info.cells      = volumePart->cells;
+    return true;
+}
+
+
+/** Returns the texture of the given range. With a loader, the range is
+    requested asynchronously and the previously used texture is returned
+    until the new one is resident.
+*/
+const RawVolumeModel::VolumePart* RawVolumeModel::_getVolumePart(
+                                const int32_t key, const eq::Range& range )
+{
+    if( !_loader )
     {
-        info.voxelSize.W  = 1.f;
-        info.voxelSize.H  = 1.f;
-        info.voxelSize.D  = 1.f;
-    }else
+        VolumeHash::iterator i = _volumeHash.find( key );
+        if( i == _volumeHash.end( ))
+        {
+            VolumePart part;
+            if( !createVolumeTexture( part, range, _glewContext ))
+                return 0;
+            i = _volumeHash.insert( std::make_pair( key, part )).first;
+        }
+        return &i->second;
+    }
+
+    // pick up all textures finished by the loader
+    VolumeLoader::Result result;
+    while( _loader->tryGetResult( result ))
     {
-        info.voxelSize.W  = 1.f / _tW;
-        info.voxelSize.H  = 1.f / _tH;
-        info.voxelSize.D  = 1.f / _tD;
+        _pending.erase( result.key );
+        if( result.success )
+            _volumeHash[ result.key ] = result.part;
+        else
+            LBERROR << "Can't load volume range" << std::endl;
     }
-    return true;
+
+    VolumeHash::const_iterator i = _volumeHash.find( key );
+    if( i != _volumeHash.end( ))
+    {
+        _currentKey = key;
+        return &i->second;
+    }
+
+    if( _pending.insert( key ).second )
+        _loader->request( key, range );
+
+    // keep rendering with the old texture while the new range is loaded
+    i = _volumeHash.find( _currentKey );
+    if( i != _volumeHash.end( ))
+        return &i->second;
+
+    // nothing to render yet, wait for the requested range
+    while( _pending.find( key ) != _pending.end( ))
+    {
+        result = _loader->getResult();
+        _pending.erase( result.key );
+        if( result.success )
+            _volumeHash[ result.key ] = result.part;
+    }
+
+    i = _volumeHash.find( key );
+    if( i == _volumeHash.end( ))
+        return 0;
+
+    _currentKey = key;
+    return &i->second;
 }
 
 
@@ -195,15 +250,241 @@ static uint32_t calcMinPow2( uint32_t size )
 }
 
 
-/** Reading requested part of volume and derivatives from data file
+/** Read the brick table of the bricked volume, if there is one
 */
-bool RawVolumeModel::_createVolumeTexture(        GLuint&    volume,
-                                                  DataInTextureDimensions& TD,
-                                            const eq::Range& range    )
+void RawVolumeModel::_loadBricks()
+{
+    const std::string filename = _filename + ".bricks";
+    size_t size = 0;
+    const uint8_t* data = _data.map( filename, size );
+    if( !data )
+        return;
+
+    if( size < sizeof( _brickHeader ))
+    {
+        LBWARN << "Ignoring truncated bricked volume " << filename
+               << std::endl;
+        return;
+    }
+    memcpy( &_brickHeader, data, sizeof( _brickHeader ));
+    if( _brickHeader.magic != bricks::MAGIC ||
+        _brickHeader.version != bricks::VERSION ||
+        _brickHeader.width != _w || _brickHeader.height != _h ||
+        _brickHeader.depth != _d || _brickHeader.brickSize == 0 ||
+        _brickHeader.nLevels == 0 || _brickHeader.nLevels > 32 ||
+        _brickHeader.bytes != ( _hasDerivatives ? 4u : 1u ))
+    {
+        LBWARN << "Ignoring incompatible bricked volume " << filename
+               << std::endl;
+        return;
+    }
+
+    const uint32_t brickSize = _brickHeader.brickSize;
+    size_t nBricks = 0;
+    _levelStart.resize( _brickHeader.nLevels );
+    for( uint32_t i = 0; i < _brickHeader.nLevels; ++i )
+    {
+        _levelStart[i] = nBricks;
+        nBricks += size_t(
+            bricks::getNumBricks( bricks::getLevelSize( _w, i ), brickSize )) *
+            bricks::getNumBricks( bricks::getLevelSize( _h, i ), brickSize ) *
+            bricks::getNumBricks( bricks::getLevelSize( _d, i ), brickSize );
+    }
+
+    if( size < sizeof( _brickHeader ) + nBricks * sizeof( bricks::Info ))
+    {
+        LBWARN << "Can't read brick table of " << filename << std::endl;
+        _levelStart.clear();
+        return;
+    }
+    _bricks.resize( nBricks );
+    memcpy( &_bricks[0], data + sizeof( _brickHeader ),
+            nBricks * sizeof( bricks::Info ));
+    _brickData = data;
+    _brickDataSize = size;
+
+    LBLOG( eq::LOG_CUSTOM ) << "bricked volume: " << nBricks << " bricks of "
+                            << brickSize << "^3 in " << _brickHeader.nLevels
+                            << " levels" << std::endl;
+}
+
+
+/** A brick is transparent if the transfer function has no opacity for the
+    range of its values.
+*/
+bool RawVolumeModel::_isTransparent( const bricks::Info& brick ) const
+{
+    for( size_t i = brick.minValue; i <= brick.maxValue; ++i )
+        if( i*4+3 < _TF.size() && _TF[i*4+3] > 0 )
+            return false;
+    return true;
+}
+
+
+/** Select the finest level which fits into a 3D texture
+*/
+uint32_t RawVolumeModel::_selectLevel( const uint32_t depth ) const
+{
+    if( _bricks.empty( ))
+        return 0;
+
+    GLint maxSize = 0;
+    glGetIntegerv( GL_MAX_3D_TEXTURE_SIZE, &maxSize );
+    if( maxSize <= 0 )
+        return 0;
+
+    const uint32_t limit = maxSize;
+    uint32_t level = 0;
+    while( level + 1 < _brickHeader.nLevels &&
+           ( bricks::getLevelSize( _w, level ) > limit ||
+             bricks::getLevelSize( _h, level ) > limit ||
+             calcMinPow2( bricks::getLevelSize( depth, level )) > limit ))
+    {
+        ++level;
+    }
+    return level;
+}
+
+
+/** Copy the bricks intersecting the slices [start, start+depth) of the given
+    level into the padded texture data. Transparent bricks are not read from
+    disk but filled with their minimum value.
+*/
+bool RawVolumeModel::_readBricks( uint8_t* data, const uint32_t level,
+                                  const uint32_t start, const uint32_t depth,
+                                  const uint32_t tW, const uint32_t tH )
+{
+    const uint32_t size  = _brickHeader.brickSize;
+    const uint32_t bytes = _brickHeader.bytes;
+    const uint32_t w     = bricks::getLevelSize( _w, level );
+    const uint32_t h     = bricks::getLevelSize( _h, level );
+    const uint32_t nX    = bricks::getNumBricks( w, size );
+    const uint32_t nY    = bricks::getNumBricks( h, size );
+    const size_t brickBytes = size_t( size ) * size * size * bytes;
+
+    std::vector< uint8_t > transparent( brickBytes );
+    size_t nRead = 0;
+    size_t nSkipped = 0;
+
+    for( uint32_t bz = start / size; bz <= ( start + depth - 1 ) / size; ++bz )
+    {
+        const uint32_t zStart = LB_MAX( bz * size, start );
+        const uint32_t zEnd   = LB_MIN( ( bz + 1 ) * size, start + depth );
+
+        for( uint32_t by = 0; by < nY; ++by )
+        {
+            for( uint32_t bx = 0; bx < nX; ++bx )
+            {
+                const bricks::Info& info =
+                    _bricks[ _levelStart[ level ] + ( bz*nY + by )*nX + bx ];
+
+                const uint8_t* brick = &transparent[0];
+                if( _isTransparent( info ))
+                {
+                    memset( &transparent[0], 0, brickBytes );
+                    for( size_t i = bytes - 1; i < brickBytes; i += bytes )
+                        transparent[i] = info.minValue;
+                    ++nSkipped;
+                }
+                else
+                {
+                    if( info.offset > _brickDataSize ||
+                        _brickDataSize - info.offset < brickBytes )
+                    {
+                        LBERROR << "Can't read brick data" << std::endl;
+                        return false;
+                    }
+                    brick = _brickData + info.offset;
+                    ++nRead;
+                }
+
+                const uint32_t xCount = LB_MIN( size, w - bx*size );
+                const uint32_t yCount = LB_MIN( size, h - by*size );
+                for( uint32_t z = zStart; z < zEnd; ++z )
+                    for( uint32_t y = 0; y < yCount; ++y )
+                    {
+                        const size_t dst = (( size_t( z - start ) * tH +
+                                              by*size + y ) * tW +
+                                            bx*size ) * bytes;
+                        const size_t src = (( size_t( z - bz*size ) * size +
+                                              y ) * size ) * bytes;
+                        memcpy( &data[ dst ], &brick[ src ], xCount * bytes );
+                    }
+            }
+        }
+    }
+
+    LBLOG( eq::LOG_CUSTOM ) << "read " << nRead << " bricks, skipped "
+                            << nSkipped << " transparent bricks" << std::endl;
+    return true;
+}
+
+
+/** Copy requested slices of volume and derivatives from the shared mapping
+    of the raw data file
+*/
+bool RawVolumeModel::_readRaw( uint8_t* data, const uint32_t start,
+                               const uint32_t depth, const uint32_t tW,
+                               const uint32_t tH )
 {
     const uint32_t w = _w;
     const uint32_t h = _h;
-    const uint32_t d = _d;
+    const uint32_t bytes = _hasDerivatives ? 4 : 1;
+    const size_t    wh4 =   size_t( w ) *  h * bytes;
+    const size_t   tWH4 = size_t( tW ) * tH * bytes;
+
+    size_t size = 0;
+    const uint8_t* file = _data.map( _filename, size );
+    if( !file )
+    {
+        LBERROR << "Can't open model data file";
+        return false;
+    }
+    if( size < wh4 * ( start + depth ))
+    {
+        LBERROR << "Model data file " << _filename << " too small"
+                << std::endl;
+        return false;
+    }
+
+    const uint8_t* src = file + wh4*start;
+
+    if( w==tW && h==tH ) // width and height are power of 2
+    {
+        memcpy( &data[0], src, wh4*depth );
+    }
+    else if( w==tW )     // only width is power of 2
+    {
+        for( uint32_t i=0; i<depth; i++ )
+            memcpy( &data[i*tWH4], src + i*wh4, wh4 );
+    }
+    else
+    {               // nor width nor heigh is power of 2
+        const size_t   w4 =   w * bytes;
+        const size_t  tW4 = tW * bytes;
+
+        for( uint32_t i=0; i<depth; i++ )
+            for( uint32_t j=0; j<h; j++ )
+                memcpy( &data[ i*tWH4 + j*tW4], src + i*wh4 + j*w4, w4 );
+    }
+    return true;
+}
+
+
+/** Reading requested part of volume and derivatives from data file,
+    uploading it through a pixel buffer object, if supported, and creating
+    its occupancy grid
+*/
+#define glewGetContext() glewContext
+bool RawVolumeModel::createVolumeTexture(       VolumePart&  part,
+                                          const eq::Range&   range,
+                                          const GLEWContext* glewContext )
+{
+    const uint32_t level = _selectLevel(
+                static_cast< uint32_t >( _d * ( range.end - range.start )));
+    const uint32_t w = bricks::getLevelSize( _w, level );
+    const uint32_t h = bricks::getLevelSize( _h, level );
+    const uint32_t d = bricks::getLevelSize( _d, level );
     const uint32_t bytes = _hasDerivatives ? 4 : 1;
 
     const int32_t bwStart = 2; //border width from left
@@ -223,69 +504,75 @@ bool RawVolumeModel::_createVolumeTexture(        GLuint&    volume,
 
     const uint32_t depth = end-start+1;
 
-    _tW = calcMinPow2( w );
-    _tH = calcMinPow2( h );
-    _tD = calcMinPow2( depth );
+    const uint32_t tW = calcMinPow2( w );
+    const uint32_t tH = calcMinPow2( h );
+    const uint32_t tD = calcMinPow2( depth );
 
     //texture scaling coefficients
-    TD.W  = static_cast<float>( w     ) / static_cast<float>( _tW );
-    TD.H  = static_cast<float>( h     ) / static_cast<float>( _tH );
-    TD.D  = static_cast<float>( e-s+1 ) / static_cast<float>( _tD );
+    DataInTextureDimensions& TD = part.TD;
+    TD.W  = static_cast<float>( w     ) / static_cast<float>( tW );
+    TD.H  = static_cast<float>( h     ) / static_cast<float>( tH );
+    TD.D  = static_cast<float>( e-s+1 ) / static_cast<float>( tD );
     TD.D /= range.end>range.start ? (range.end-range.start) : 1.0f;
 
     // Shift coefficient and left border in texture for depth
     TD.Do = range.start;
-    TD.Db = range.start > 0.0001 ? bwStart / static_cast<float>(_tD) : 0;
+    TD.Db = range.start > 0.0001 ? bwStart / static_cast<float>(tD) : 0;
+
+    if( _hasDerivatives )
+    {
+        part.voxelSize.W  = 1.f;
+        part.voxelSize.H  = 1.f;
+        part.voxelSize.D  = 1.f;
+    }else
+    {
+        part.voxelSize.W  = 1.f / tW;
+        part.voxelSize.H  = 1.f / tH;
+        part.voxelSize.D  = 1.f / tD;
+    }
 
     LBLOG( eq::LOG_CUSTOM )
             << "==============================================="   << std::endl
-            << " w: "  << w << " " << _tW
-            << " h: "  << h << " " << _tH
-            << " d: "  << d << " " << depth << " " << _tD           << std::endl
+            << " w: "  << w << " " << tW
+            << " h: "  << h << " " << tH
+            << " d: "  << d << " " << depth << " " << tD            << std::endl
             << " r: "  << _resolution                              << std::endl
             << " ws: " << TD.W  << " hs: " << TD.H  << " wd: " << TD.D
             << " Do: " << TD.Do << " Db: " << TD.Db                << std::endl
-            << " s= "  << start << " e= "  << end                  << std::endl;
-
-    // Reading of requested part of a volume
-    std::vector<uint8_t> data( _tW*_tH*_tD*bytes, 0 );
-    const uint32_t  wh4 =   w *   h * bytes;
-    const uint32_t tWH4 = _tW * _tH * bytes;
+            << " s= "  << start << " e= "  << end
+            << " level: " << level                                 << std::endl;
 
-    std::ifstream file ( _filename.c_str(), std::ifstream::in |
-                         std::ifstream::binary | std::ifstream::ate );
+    LBASSERT( glewContext );
 
-    if( !file.is_open() )
-    {
-        LBERROR << "Can't open model data file";
+    // Reading of requested part of a volume
+    const size_t size = size_t( tW ) * tH * tD * bytes;
+    std::vector< uint8_t > data( size, 0 );
+    const bool read = _bricks.empty() ?
+                          _readRaw( &data[0], start, depth, tW, tH ) :
+                          _readBricks( &data[0], level, start, depth, tW, tH );
+    if( !read )
         return false;
-    }
-
-    file.seekg( wh4*start, std::ios::beg );
 
-    if( w==_tW && h==_tH ) // width and height are power of 2
+    // Stream the data through a PBO if possible
+    eq::util::PixelBufferObject pbo( glewContext, false );
+    const GLvoid* pixels = &data[0];
+    if( GLEW_ARB_pixel_buffer_object &&
+        pbo.setup( size, GL_WRITE_ONLY_ARB ) == eq::ERROR_NONE )
     {
-        file.read( (char*)( &data[0] ), wh4*depth );
-    }
-    else if( w==_tW )     // only width is power of 2
-    {
-        for( uint32_t i=0; i<depth; i++ )
-            file.read( (char*)( &data[i*tWH4] ), wh4 );
-    }
-    else
-    {               // nor width nor heigh is power of 2
-        const uint32_t   w4 =   w * bytes;
-        const uint32_t  tW4 = _tW * bytes;
-
-        for( uint32_t i=0; i<depth; i++ )
-            for( uint32_t j=0; j<h; j++ )
-                file.read( (char*)( &data[ i*tWH4 + j*tW4] ), w4 );
+        void* mapped = pbo.mapWrite();
+        if( mapped )
+        {
+            memcpy( mapped, &data[0], size );
+            pbo.unmap();
+            pbo.bind();
+            pixels = 0;
+        }
+        else
+            pbo.destroy();
     }
 
-    file.close();
-
-    LBASSERT( _glewContext );
     // create 3D texture
+    GLuint& volume = part.volume;
     glGenTextures( 1, &volume );
     LBLOG( eq::LOG_CUSTOM ) << "generated texture: " << volume << std::endl;
     glBindTexture(GL_TEXTURE_3D, volume);
@@ -299,19 +586,104 @@ bool RawVolumeModel::_createVolumeTexture(        GLuint&    volume,
     if( _hasDerivatives )
     {
         glTexImage3D(   GL_TEXTURE_3D,
-                        0, GL_RGBA, _tW, _tH, _tD,
-                        0, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)(&data[0]) );
+                        0, GL_RGBA, tW, tH, tD,
+                        0, GL_RGBA, GL_UNSIGNED_BYTE, pixels );
     }else
     {
         glTexImage3D(   GL_TEXTURE_3D,
-                        0, GL_ALPHA, _tW, _tH, _tD,
-                        0, GL_ALPHA, GL_UNSIGNED_BYTE, (GLvoid*)(&data[0]) );
+                        0, GL_ALPHA, tW, tH, tD,
+                        0, GL_ALPHA, GL_UNSIGNED_BYTE, pixels );
     }
 
+    pbo.destroy();
+    _createOccupancy( part, &data[0], tW, tH, tD, glewContext );
     return true;
 }
 
 
+/** Computes the minimum and maximum value of each cell of the volume texture,
+    including the neighbouring cells to account for interpolation, and
+    uploads them as a luminance (min) and alpha (max) texture
+*/
+void RawVolumeModel::_createOccupancy( VolumePart& part, const uint8_t* data,
+                                       const uint32_t tW, const uint32_t tH,
+                                       const uint32_t tD,
+                                       const GLEWContext* glewContext ) const
+{
+    const uint32_t cellSize = 8;
+    const uint32_t bytes = _hasDerivatives ? 4 : 1;
+    const uint32_t cW = LB_MIN( cellSize, tW );
+    const uint32_t cH = LB_MIN( cellSize, tH );
+    const uint32_t cD = LB_MIN( cellSize, tD );
+    const uint32_t nX = tW / cW;
+    const uint32_t nY = tH / cH;
+    const uint32_t nZ = tD / cD;
+    const size_t nCells = size_t( nX ) * nY * nZ;
+
+    std::vector< uint8_t > minMax( nCells * 2 );
+    for( size_t i = 0; i < nCells; ++i )
+    {
+        minMax[ i*2 ]   = 255;
+        minMax[ i*2+1 ] = 0;
+    }
+
+    const uint8_t* value = data + bytes - 1;
+    for( uint32_t z = 0; z < tD; ++z )
+        for( uint32_t y = 0; y < tH; ++y )
+        {
+            uint8_t* row = &minMax[ (( z/cD )*nY + y/cH )*nX*2 ];
+            for( uint32_t x = 0; x < tW; ++x, value += bytes )
+            {
+                uint8_t* cell = row + ( x/cW )*2;
+                cell[0] = LB_MIN( cell[0], *value );
+                cell[1] = LB_MAX( cell[1], *value );
+            }
+        }
+
+    // dilate by one cell and one value, since samples are interpolated
+    std::vector< uint8_t > grid( nCells * 2 );
+    for( uint32_t z = 0; z < nZ; ++z )
+        for( uint32_t y = 0; y < nY; ++y )
+            for( uint32_t x = 0; x < nX; ++x )
+            {
+                const uint32_t xEnd = LB_MIN( x+1, nX-1 );
+                const uint32_t yEnd = LB_MIN( y+1, nY-1 );
+                const uint32_t zEnd = LB_MIN( z+1, nZ-1 );
+                int32_t minValue = 255;
+                int32_t maxValue = 0;
+                for( uint32_t k = ( z ? z-1 : 0 ); k <= zEnd; ++k )
+                for( uint32_t j = ( y ? y-1 : 0 ); j <= yEnd; ++j )
+                for( uint32_t i = ( x ? x-1 : 0 ); i <= xEnd; ++i )
+                {
+                    const uint8_t* cell = &minMax[ (( k*nY + j )*nX + i )*2 ];
+                    minValue = LB_MIN( minValue, int32_t( cell[0] ));
+                    maxValue = LB_MAX( maxValue, int32_t( cell[1] ));
+                }
+
+                uint8_t* cell = &grid[ (( z*nY + y )*nX + x )*2 ];
+                cell[0] = uint8_t( LB_MAX( minValue - 1, 0 ));
+                cell[1] = uint8_t( LB_MIN( maxValue + 1, 255 ));
+            }
+
+    part.cells = eq::Vector3f( float( nX ), float( nY ), float( nZ ));
+
+    glGenTextures( 1, &part.occupancy );
+    glBindTexture( GL_TEXTURE_3D, part.occupancy );
+
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_S    , GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_T    , GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_R    , GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST       );
+    glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST       );
+
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+    glTexImage3D( GL_TEXTURE_3D, 0, GL_LUMINANCE_ALPHA, nX, nY, nZ, 0,
+                  GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, &grid[0] );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+}
+#undef glewGetContext
+
+
 /** Volume always represented as cube [-1,-1,-1]..[1,1,1], so if the model
     is not cube it's proportions should be modified. This function makes
     maximum proportion equal to 1.0 to prevent unnecessary rescaling.
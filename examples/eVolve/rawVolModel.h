@@ -29,7 +29,10 @@
 #ifndef EVOLVE_RAW_VOL_MODEL_H
 #define EVOLVE_RAW_VOL_MODEL_H
 
+#include "brickFormat.h"
+
 #include <eq/eq.h>
+#include <set>
 
 namespace eVolve
 {
@@ -75,13 +78,40 @@ namespace eVolve
         VolumeScaling           volScaling; //!< Proportions of volume
         VolumeScaling           voxelSize;  //!< Relative volume size (0..1]
         DataInTextureDimensions TD; //!< Data dimensions within volume texture
+        GLuint                  occupancy; //!< min/max value per cell texture
+        eq::Vector3f            cells;     //!< number of occupancy cells
     };
 
-    /** Load model to texture */
+    class VolumeData;
+    class VolumeLoader;
+
+    /** Load model to texture.
+
+        The volume data is read from the node-wide VolumeData, so that all
+        pipes of a node share one memory-mapped copy of the volume files.
+
+        If a bricked version of the volume exists (see brickFormat.h), only
+        the bricks intersecting the requested range are read, bricks which
+        are fully transparent with the current transfer function are skipped,
+        and a coarser level is used if the range exceeds the maximum 3D
+        texture size.
+
+        If a VolumeLoader is set, new ranges are loaded and uploaded in the
+        loader thread while rendering continues with the last volume texture.
+    */
     class RawVolumeModel
     {
     public:
-        RawVolumeModel( const std::string& filename );
+        struct VolumePart
+        {
+            GLuint                  volume;    //!< 3D texture ID
+            DataInTextureDimensions TD;        //!< Data dimensions in volume
+            VolumeScaling           voxelSize; //!< Relative voxel size
+            GLuint                  occupancy; //!< Occupancy grid texture ID
+            eq::Vector3f            cells;     //!< Occupancy grid size
+        };
+
+        RawVolumeModel( const std::string& filename, VolumeData& data );
 
         bool loadHeader( const float brightness, const float alpha );
 
@@ -98,32 +128,51 @@ namespace eVolve
 
         const GLEWContext* glewGetContext() const { return _glewContext; }
 
-    protected:
+        /** Use the given loader for new ranges, or 0 to load synchronously. */
+        void setLoader( VolumeLoader* loader ) { _loader = loader; }
 
-        bool _createVolumeTexture(    GLuint&                  volume,
-                                      DataInTextureDimensions& TD,
-                                const eq::Range&               range );
+        /**
+         * Read a range of the volume and upload it into a new 3D texture
+         * using the given context. Called from the loader thread if a loader
+         * is set.
+         */
+        bool createVolumeTexture(       VolumePart&  part,
+                                  const eq::Range&   range,
+                                  const GLEWContext* glewContext );
 
     private:
-        struct VolumePart
-        {
-            GLuint                  volume; //!< 3D texture ID
-            DataInTextureDimensions TD;     //!< Data dimensions within volume
-        };
-
-        stde::hash_map< int32_t, VolumePart > _volumeHash; //!< 3D textures info
+        typedef stde::hash_map< int32_t, VolumePart > VolumeHash;
+
+        const VolumePart* _getVolumePart( const int32_t key,
+                                          const eq::Range& range );
+        bool _readRaw( uint8_t* data, const uint32_t start,
+                       const uint32_t depth, const uint32_t tW,
+                       const uint32_t tH );
+        void _loadBricks();
+        bool _readBricks( uint8_t* data, const uint32_t level,
+                          const uint32_t start, const uint32_t depth,
+                          const uint32_t tW, const uint32_t tH );
+        bool _isTransparent( const bricks::Info& brick ) const;
+        uint32_t _selectLevel( const uint32_t depth ) const;
+        void _createOccupancy( VolumePart& part, const uint8_t* data,
+                               const uint32_t tW, const uint32_t tH,
+                               const uint32_t tD,
+                               const GLEWContext* glewContext ) const;
+
+        VolumeHash    _volumeHash;      //!< 3D textures info
+        VolumeLoader* _loader;          //!< asynchronous loader, optional
+        std::set< int32_t > _pending;   //!< ranges requested from the loader
+        int32_t       _currentKey;      //!< last range used for rendering
 
         bool         _headerLoaded;     //!< header is loaded successfully
         std::string  _filename;         //!< name of volume data file
+        VolumeData&  _data;             //!< node-wide mapped volume files
 
         GLuint       _preintName;       //!< preintegration table texture
 
         uint32_t     _w;                //!< volume width
         uint32_t     _h;                //!< volume height
         uint32_t     _d;                //!< volume depth
-        uint32_t     _tW;               //!< volume texture width
-        uint32_t     _tH;               //!< volume texture height
-        uint32_t     _tD;               //!< volume texture depth
         uint32_t     _resolution;       //!< max( _w, _h, _d ) of a model
 
         VolumeScaling _volScaling;      //!< Proportions of volume
@@ -132,6 +181,12 @@ namespace eVolve
 
         bool _hasDerivatives;           //!< true if raw+der used
 
+        bricks::Header _brickHeader;        //!< bricked volume header
+        std::vector< bricks::Info > _bricks; //!< bricks of all levels
+        std::vector< size_t > _levelStart;  //!< index of first level brick
+        const uint8_t* _brickData;          //!< mapped bricked volume file
+        size_t _brickDataSize;              //!< size of the mapped file
+
         const GLEWContext*   _glewContext;    //!< OpenGL function table
     };
 
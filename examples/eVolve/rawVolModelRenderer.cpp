@@ -27,9 +27,14 @@
  */
 
 #include "rawVolModelRenderer.h"
+#include "volumeLoader.h"
 
 #include "fragmentShader.glsl.h"
 #include "vertexShader.glsl.h"
+#include "raycastFragmentShader.glsl.h"
+#include "raycastVertexShader.glsl.h"
+
+#include <cmath>
 
 
 namespace eVolve
@@ -37,12 +42,51 @@ namespace eVolve
 
 
 RawVolumeModelRenderer::RawVolumeModelRenderer( const std::string& filename,
-                                                const uint32_t     precision )
-        : _rawModel(  filename  )
+                                                const uint32_t     precision,
+                                                VolumeData&        data )
+        : _rawModel(  filename, data )
         , _precision( precision )
+        , _sliceScale( 1.f )
         , _glewContext( 0 )
         , _ortho( false )
+        , _raycast( false )
+        , _loader( 0 )
+{
+}
+
+
+RawVolumeModelRenderer::~RawVolumeModelRenderer()
 {
+    stopLoader();
+}
+
+
+void RawVolumeModelRenderer::startLoader( eq::Window* window )
+{
+    if( _loader )
+        return;
+
+    _loader = new VolumeLoader( _rawModel );
+    if( !_loader->setup( window ))
+    {
+        LBWARN << "Can't start volume loader, loading volumes synchronously"
+               << std::endl;
+        delete _loader;
+        _loader = 0;
+        return;
+    }
+    _rawModel.setLoader( _loader );
+}
+
+
+void RawVolumeModelRenderer::stopLoader()
+{
+    if( !_loader )
+        return;
+
+    _rawModel.setLoader( 0 );
+    delete _loader;
+    _loader = 0;
 }
 
 
@@ -66,6 +110,7 @@ static void renderSlices( const SliceClipper& sliceClipper )
 
 
 void RawVolumeModelRenderer::_putVolumeDataToShader(
+        GLhandleARB         shader,
         const VolumeInfo&   volumeInfo,
         const float         sliceDistance,
         const eq::Matrix4f& invRotationM,
@@ -73,8 +118,6 @@ void RawVolumeModelRenderer::_putVolumeDataToShader(
         const int           normalsQuality )
 {
     LBASSERT( _glewContext );
-
-    GLhandleARB shader = _shaders.getProgram();
     LBASSERT( shader );
 
     const DataInTextureDimensions& TD = volumeInfo.TD;
@@ -131,6 +174,9 @@ void RawVolumeModelRenderer::_putVolumeDataToShader(
                                     volumeInfo.voxelSize.H,
                                     volumeInfo.voxelSize.D  ); //f-shader
 
+    tParamNameGL = glGetUniformLocationARB(  shader,  "sampleScale"   );
+    glUniform1fARB( tParamNameGL,  _sliceScale  ); //f-shader
+
     tParamNameGL = glGetUniformLocationARB(  shader,  "normalsQuality");
     glUniform1iARB( tParamNameGL, normalsQuality ); //f-shader
 
@@ -145,6 +191,23 @@ void RawVolumeModelRenderer::_putVolumeDataToShader(
 }
 
 
+void RawVolumeModelRenderer::adaptSlices( const bool idle,
+                                          const float frameTime,
+                                          const float targetTime )
+{
+    if( idle || targetTime <= 0.f || frameTime <= 0.f )
+    {
+        _sliceScale = 1.f;
+        return;
+    }
+
+    // Fill cost is proportional to the slice count. Move halfway towards the
+    // scale meeting the target to avoid oscillation from frame time noise.
+    const float scale = _sliceScale * std::sqrt( frameTime / targetTime );
+    _sliceScale = LB_MIN( LB_MAX( scale, 1.f ), 4.f );
+}
+
+
 bool RawVolumeModelRenderer::render( const eq::Range& range,
                                      const eq::Matrix4d& modelviewM,
                                      const eq::Matrix4f& invRotationM,
@@ -163,16 +226,24 @@ bool RawVolumeModelRenderer::render( const eq::Range& range,
               volumeInfo.volScaling.H,
               volumeInfo.volScaling.D );
 
+    const uint32_t resolution    = _rawModel.getResolution();
+    const double   sliceDistance = 3.6 * _sliceScale /
+                                   ( resolution * _precision );
+
+    if( _raycast && _raycastShaders.getProgram( ))
+    {
+        _renderRaycast( volumeInfo, range, float( sliceDistance ),
+                        invRotationM, taintColor );
+        return true;
+    }
+
     // Enable shaders
     glUseProgramObjectARB( _shaders.getProgram( ));
 
     // Calculate and put necessary data to shaders
-
-    const uint32_t resolution    = _rawModel.getResolution();
-    const double   sliceDistance = 3.6 / ( resolution * _precision );
-
-    _putVolumeDataToShader( volumeInfo, float( sliceDistance ),
-                            invRotationM, taintColor, normalsQuality );
+    _putVolumeDataToShader( _shaders.getProgram(), volumeInfo,
+                            float( sliceDistance ), invRotationM, taintColor,
+                            normalsQuality );
 
     _sliceClipper.updatePerFrameInfo( modelviewM, sliceDistance, range );
 
@@ -191,6 +262,76 @@ bool RawVolumeModelRenderer::render( const eq::Range& range,
 }
 
 
+/** Draw the back faces of the range box, the fragment shader casts a ray
+    from the eye to each back face fragment.
+*/
+static void renderRangeBox( const eq::Range& range )
+{
+    const float zS = -1.f + 2.f * range.start;
+    const float zE = -1.f + 2.f * range.end;
+
+    glBegin( GL_QUADS );
+    // z faces
+    glVertex3f( -1.f, -1.f, zS ); glVertex3f( -1.f,  1.f, zS );
+    glVertex3f(  1.f,  1.f, zS ); glVertex3f(  1.f, -1.f, zS );
+    glVertex3f( -1.f, -1.f, zE ); glVertex3f(  1.f, -1.f, zE );
+    glVertex3f(  1.f,  1.f, zE ); glVertex3f( -1.f,  1.f, zE );
+    // y faces
+    glVertex3f( -1.f, -1.f, zS ); glVertex3f(  1.f, -1.f, zS );
+    glVertex3f(  1.f, -1.f, zE ); glVertex3f( -1.f, -1.f, zE );
+    glVertex3f( -1.f,  1.f, zS ); glVertex3f( -1.f,  1.f, zE );
+    glVertex3f(  1.f,  1.f, zE ); glVertex3f(  1.f,  1.f, zS );
+    // x faces
+    glVertex3f( -1.f, -1.f, zS ); glVertex3f( -1.f, -1.f, zE );
+    glVertex3f( -1.f,  1.f, zE ); glVertex3f( -1.f,  1.f, zS );
+    glVertex3f(  1.f, -1.f, zS ); glVertex3f(  1.f,  1.f, zS );
+    glVertex3f(  1.f,  1.f, zE ); glVertex3f(  1.f, -1.f, zE );
+    glEnd();
+}
+
+
+void RawVolumeModelRenderer::_renderRaycast( const VolumeInfo&   volumeInfo,
+                                             const eq::Range&    range,
+                                             const float         sliceDistance,
+                                             const eq::Matrix4f& invRotationM,
+                                             const eq::Vector4f& taintColor )
+{
+    GLhandleARB shader = _raycastShaders.getProgram();
+    glUseProgramObjectARB( shader );
+
+    glActiveTextureARB( GL_TEXTURE2 );
+    glBindTexture( GL_TEXTURE_3D, volumeInfo.occupancy ); //min, max per cell
+    GLint tParamNameGL = glGetUniformLocationARB( shader, "occupancy" );
+    glUniform1iARB( tParamNameGL, 2 ); //f-shader
+
+    tParamNameGL = glGetUniformLocationARB( shader, "cells" );
+    glUniform3fARB( tParamNameGL, volumeInfo.cells.x(), volumeInfo.cells.y(),
+                                  volumeInfo.cells.z( )); //f-shader
+
+    tParamNameGL = glGetUniformLocationARB( shader, "zStart" );
+    glUniform1fARB( tParamNameGL, -1.f + 2.f * range.start ); //f-shader
+
+    tParamNameGL = glGetUniformLocationARB( shader, "zEnd" );
+    glUniform1fARB( tParamNameGL, -1.f + 2.f * range.end ); //f-shader
+
+    _putVolumeDataToShader( shader, volumeInfo, sliceDistance, invRotationM,
+                            taintColor, 0 );
+
+    glEnable( GL_CULL_FACE );
+    glCullFace( GL_FRONT );
+    glEnable( GL_BLEND );
+    glBlendFuncSeparateEXT( GL_ONE, GL_SRC_ALPHA, GL_ZERO, GL_SRC_ALPHA );
+
+    renderRangeBox( range );
+
+    glDisable( GL_BLEND );
+    glCullFace( GL_BACK );
+    glDisable( GL_CULL_FACE );
+
+    glUseProgramObjectARB( 0 );
+}
+
+
 bool RawVolumeModelRenderer::loadShaders()
 {
     if( !_shaders.loadShaders( vertexShader_glsl, fragmentShader_glsl,
@@ -200,6 +341,14 @@ bool RawVolumeModelRenderer::loadShaders()
         return false;
     }
 
+    if( !_raycastShaders.loadShaders( raycastVertexShader_glsl,
+                                      raycastFragmentShader_glsl,
+                                      _glewContext ))
+    {
+        LBWARN << "Can't load ray casting shaders, using slice rendering"
+               << std::endl;
+    }
+
     LBLOG( eq::LOG_CUSTOM ) << "glsl shaders loaded" << std::endl;
     return true;
 }
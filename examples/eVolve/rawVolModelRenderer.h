@@ -36,12 +36,15 @@
 
 namespace eVolve
 {
+    class VolumeLoader;
 
     class RawVolumeModelRenderer
     {
     public:
         RawVolumeModelRenderer( const std::string& filename,
-                                const uint32_t     precision   = 1 );
+                                const uint32_t     precision,
+                                VolumeData&        data );
+        ~RawVolumeModelRenderer();
 
         bool loadHeader( const float brightness, const float alpha )
         {
@@ -67,26 +70,56 @@ namespace eVolve
                      const int            normalsQuality );
 
         void setPrecision( const uint32_t precision ){ _precision = precision; }
+
+        /**
+         * Adapt the slice distance to the measured frame time.
+         *
+         * While the camera moves, the slice distance is scaled up until the
+         * frame time meets the target time. Idle frames, or a target time of
+         * 0, restore the full slice count. The pre-integrated samples are
+         * opacity-corrected for the larger distance in the shaders.
+         */
+        void adaptSlices( const bool idle, const float frameTime,
+                          const float targetTime );
         void setOrtho( const uint32_t ortho )        { _ortho = ortho; }
 
+        /** Use GPU ray casting instead of view-aligned slices. */
+        void setRaycast( const bool raycast )        { _raycast = raycast; }
+
         const GLEWContext* glewGetContext() { return _glewContext; }
         bool loadShaders();
 
+        /** Start loading new ranges asynchronously in a shared context. */
+        void startLoader( eq::Window* window );
+        void stopLoader();
+
     private:
-        void _putVolumeDataToShader( const VolumeInfo&   volumeInfo,
+        void _putVolumeDataToShader( GLhandleARB         shader,
+                                     const VolumeInfo&   volumeInfo,
                                      const float         sliceDistance,
                                      const eq::Matrix4f& invRotationM,
                                      const eq::Vector4f& taintColor,
                                      const int           normalsQuality );
 
+        void _renderRaycast( const VolumeInfo&   volumeInfo,
+                             const eq::Range&    range,
+                             const float         sliceDistance,
+                             const eq::Matrix4f& invRotationM,
+                             const eq::Vector4f& taintColor );
+
         RawVolumeModel  _rawModel;      //!< volume data
         SliceClipper    _sliceClipper;  //!< frame clipping algorithm
         uint32_t        _precision;     //!< multiplyer for number of slices
+        float           _sliceScale;    //!< interactive slice distance factor
         GLSLShaders     _shaders;       //!< GLSL shaders
+        GLSLShaders     _raycastShaders;//!< GLSL ray casting shaders
 
         const GLEWContext*    _glewContext;   //!< OpenGL function table
 
         bool            _ortho;         //!< ortogonal/perspective projection
+        bool            _raycast;       //!< ray casting/slice rendering
+
+        VolumeLoader*   _loader;        //!< asynchronous volume loader
 
     };
 
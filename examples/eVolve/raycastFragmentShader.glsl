@@ -0,0 +1,181 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#version 110
+
+// Ray casting with pre-integrated classification, empty space skipping using
+// the min/max occupancy grid and early ray termination. Produces the same
+// color and transmittance as the slice renderer for the blend function
+// glBlendFuncSeparate( GL_ONE, GL_SRC_ALPHA, GL_ZERO, GL_SRC_ALPHA ).
+
+uniform sampler3D volume;    // gx, gy, gz, v
+uniform sampler2D preInt;    // r,  g,  b, a
+uniform sampler3D occupancy; // min, max value of each cell in .r, .a
+
+uniform float sliceDistance; // ray step in object space
+uniform float perspProj;
+uniform float shininess;
+uniform vec3  viewVec;
+uniform vec3  sizeVec;
+uniform vec4  taint; // .rgb should be pre-multiplied with .a
+uniform vec3  cells; // size of the occupancy grid
+uniform float sampleScale; // ray step relative to full precision
+
+uniform float W;      //scale for x
+uniform float H;      //scale for y
+uniform float D;      //scale for z
+uniform float Do;     //shift of z
+uniform float Db;     //z offset
+uniform float zStart; //start of the range box in object space
+uniform float zEnd;   //end of the range box in object space
+
+varying vec3 position;
+
+const int   maxSteps    = 4096;
+const float opaque      = 0.01;  // transmittance for early ray termination
+const float transparent = 0.998; // pre-integrated transmittance of empty cells
+
+// Correct a pre-integrated sample for a sample distance of sampleScale times
+// the distance the table was built for. .a is the transmittance.
+vec4 scaleOpacity( vec4 preInt_ )
+{
+    if( sampleScale == 1.0 )
+        return preInt_;
+
+    float transmittance = pow( preInt_.a, sampleScale );
+    float opacity       = 1.0 - preInt_.a;
+    float factor = opacity > 0.001 ? (1.0 - transmittance) / opacity
+                                   : sampleScale;
+    return vec4( preInt_.rgb * factor, transmittance );
+}
+
+vec3 toTexture( vec3 pos )
+{
+    vec3 coord = 0.5 * pos + 0.5;
+    return vec3( coord.x * W, coord.y * H, Db + (coord.z - Do) * D );
+}
+
+vec3 avoidZero( vec3 value )
+{
+    return value + vec3( 1e-6 ) * step( abs( value ), vec3( 1e-6 ));
+}
+
+vec4 shade( vec3 coords, vec4 preInt_ )
+{
+    vec3 lookupMP;
+    if( sizeVec.x > 0.5 )
+        lookupMP = texture3D( volume, coords ).rgb - 0.5;
+    else
+        lookupMP = vec3(
+            texture3D( volume, coords + vec3( sizeVec.x,0.0,0.0) ).a -
+            texture3D( volume, coords + vec3(-sizeVec.x,0.0,0.0) ).a,
+            texture3D( volume, coords + vec3(0.0, sizeVec.y,0.0) ).a -
+            texture3D( volume, coords + vec3(0.0,-sizeVec.y,0.0) ).a,
+            texture3D( volume, coords + vec3(0.0,0.0, sizeVec.z) ).a -
+            texture3D( volume, coords + vec3(0.0,0.0,-sizeVec.z) ).a );
+
+    if( taint.a != 0.0 )
+        preInt_ = vec4( preInt_.rgb*(1.0-taint.a) +
+                        taint.rgb*taint.a*(-log(preInt_.a)),
+                        preInt_.a );
+
+    vec3 tnorm = -normalize( lookupMP );
+
+    vec3 lightVec = normalize( gl_LightSource[0].position.xyz );
+    vec3 reflect  = reflect( -lightVec, tnorm );
+
+    float diffuse = max( dot(lightVec, tnorm), 0.0 );
+
+    float specular = pow(max(dot(reflect, viewVec), 0.0), shininess);
+
+    return vec4(gl_LightSource[0].ambient.rgb  * preInt_.rgb +
+                gl_LightSource[0].diffuse.rgb  * preInt_.rgb * diffuse +
+                gl_LightSource[0].specular.rgb * preInt_.rgb * specular,
+                preInt_.a);
+}
+
+void main (void)
+{
+    // ray through this fragment in object space, ending at the back face
+    vec3 eye     = (gl_ModelViewMatrixInverse * vec4(0.0,0.0,0.0,1.0)).xyz;
+    vec3 viewDir = (gl_ModelViewMatrixInverse * vec4(0.0,0.0,-1.0,0.0)).xyz;
+    vec3 dir = normalize( mix( viewDir, position - eye, perspProj ));
+
+    // ray entry into the range box, clipped at the eye position
+    vec3 back = avoidZero( -dir );
+    vec3 boxMin = vec3( -1.0, -1.0, zStart );
+    vec3 boxMax = vec3(  1.0,  1.0, zEnd );
+    vec3 tBox = ( mix( boxMin, boxMax, step( 0.0, back )) - position ) / back;
+    float len = min( min( tBox.x, tBox.y ), tBox.z );
+    if( perspProj > 0.5 )
+        len = min( len, distance( position, eye ));
+
+    vec3 texStart = toTexture( position - dir * len );
+    vec3 texDir   = toTexture( position - dir * ( len - 1.0 )) - texStart;
+    vec3 cellDir  = avoidZero( texDir );
+
+    vec3  color         = vec3( 0.0 );
+    float transmittance = 1.0;
+    float t             = 0.0;
+    float front         = texture3D( volume, texStart ).a;
+
+    for( int i = 0; i < maxSteps; ++i )
+    {
+        if( t >= len || transmittance < opaque )
+            break;
+
+        vec3 coord = texStart + t * texDir;
+        vec2 range = texture3D( occupancy, coord ).ra;
+
+        if( texture2D( preInt, range ).a > transparent )
+        {
+            // skip to the exit of the empty cell, staying on the step grid
+            vec3 cell  = floor( coord * cells );
+            vec3 bound = ( cell + step( 0.0, cellDir )) / cells;
+            vec3 tCell = ( bound - coord ) / cellDir;
+            float skip = min( min( tCell.x, tCell.y ), tCell.z );
+            t += max( ceil( skip / sliceDistance ), 1.0 ) * sliceDistance;
+            front = texture3D( volume, texStart + t * texDir ).a;
+            continue;
+        }
+
+        float tNext  = min( t + sliceDistance, len );
+        vec3  next   = texStart + tNext * texDir;
+        float value  = texture3D( volume, next ).a;
+
+        vec4 slab = shade( (coord + next) * 0.5,
+                      scaleOpacity( texture2D( preInt, vec2( front, value ))));
+
+        color         += transmittance * slab.rgb;
+        transmittance *= slab.a;
+
+        front = value;
+        t     = tNext;
+    }
+
+    gl_FragColor = vec4( color, transmittance );
+}
@@ -1,5 +1,4 @@
-
-/* Copyright (c) 2007       Maxim Makhinya
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -26,18 +25,13 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef EVOLVE_FRAMES_ORDERER_H
-#define EVOLVE_FRAMES_ORDERER_H
+#version 110
 
-#include <eq/eq.h>
+// object space position on a back face of the range box
+varying vec3 position;
 
-namespace eVolve
+void main(void)
 {
-/** @cond IGNORE */
-void orderFrames( eq::Frames& frames, const eq::Matrix4d& modelviewM,
-                  const eq::Matrix3d& modelviewITM,
-                  const eq::Matrix4f& rotation, const bool orthographic );
-/** @endcond */
+    position    = gl_Vertex.xyz;
+    gl_Position = ftransform();
 }
-
-#endif //EVOLVE_FRAMES_ORDERER_H
@@ -0,0 +1,68 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "volumeData.h"
+
+#include <lunchbox/log.h>
+#include <lunchbox/memoryMap.h>
+#include <lunchbox/scopedMutex.h>
+
+namespace eVolve
+{
+VolumeData::~VolumeData()
+{
+    for( MemoryMaps::const_iterator i = _maps.begin(); i != _maps.end(); ++i )
+        delete i->second;
+    _maps.clear();
+}
+
+const uint8_t* VolumeData::map( const std::string& filename, size_t& size )
+{
+    lunchbox::ScopedWrite mutex( _lock );
+    MemoryMaps::const_iterator i = _maps.find( filename );
+    if( i == _maps.end( ))
+    {
+        lunchbox::MemoryMap* memoryMap = new lunchbox::MemoryMap;
+        if( memoryMap->map( filename ))
+            LBVERB << "Mapped " << filename << " for all pipes" << std::endl;
+        else
+        {
+            delete memoryMap;
+            memoryMap = 0;
+        }
+        i = _maps.insert( std::make_pair( filename, memoryMap )).first;
+    }
+
+    if( !i->second )
+    {
+        size = 0;
+        return 0;
+    }
+    size = i->second->getSize();
+    return static_cast< const uint8_t* >( i->second->getAddress( ));
+}
+}
@@ -0,0 +1,68 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EVOLVE_VOLUME_DATA_H
+#define EVOLVE_VOLUME_DATA_H
+
+#include <lunchbox/lock.h>
+#include <lunchbox/types.h>
+#include <boost/noncopyable.hpp>
+#include <map>
+#include <string>
+
+namespace lunchbox { class MemoryMap; }
+
+namespace eVolve
+{
+/**
+ * Read-only volume files shared by all pipes of a node.
+ *
+ * Each file is memory-mapped once on first use, so that all pipes read their
+ * ranges from the same page cache pages instead of streaming the file
+ * separately into private buffers. Thread-safe.
+ */
+class VolumeData : public boost::noncopyable
+{
+public:
+    VolumeData() {}
+    ~VolumeData();
+
+    /**
+     * @return the start of the mapped file, or 0 if it can't be mapped. The
+     *         mapping stays valid during the lifetime of this object.
+     */
+    const uint8_t* map( const std::string& filename, size_t& size );
+
+private:
+    typedef std::map< std::string, lunchbox::MemoryMap* > MemoryMaps;
+
+    lunchbox::Lock _lock;
+    MemoryMaps _maps;
+};
+}
+
+#endif // EVOLVE_VOLUME_DATA_H
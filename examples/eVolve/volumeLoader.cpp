@@ -0,0 +1,137 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "volumeLoader.h"
+
+#include <eq/client/system.h>
+
+namespace eVolve
+{
+VolumeLoader::VolumeLoader( RawVolumeModel& model )
+    : lunchbox::Thread()
+    , _model( model )
+    , _sharedWindow( 0 )
+{
+}
+
+VolumeLoader::~VolumeLoader()
+{
+    stop();
+}
+
+const GLEWContext* VolumeLoader::glewGetContext() const
+{
+    return _sharedWindow->glewGetContext();
+}
+
+static eq::SystemWindow* initSharedContextWindow( eq::Window* window )
+{
+    LBASSERT( window );
+
+    eq::WindowSettings settings = window->getSettings();
+    settings.setIAttribute( eq::WindowSettings::IATTR_HINT_DRAWABLE, eq::OFF );
+    const eq::Pipe* pipe = window->getPipe();
+    eq::SystemWindow* sharedWindow =
+        pipe->getWindowSystem().createWindow( window, settings );
+
+    if( sharedWindow )
+    {
+        if( !sharedWindow->configInit( ))
+        {
+            LBWARN << "OS Window initialization failed: " << std::endl;
+            delete sharedWindow;
+            sharedWindow = 0;
+        }
+    }
+    else
+    {
+        LBERROR << "Failed to create shared context window for "
+                << pipe->getWindowSystem() << std::endl;
+    }
+
+    window->makeCurrent();
+    return sharedWindow;
+}
+
+bool VolumeLoader::setup( eq::Window* window )
+{
+    LBASSERT( !_sharedWindow );
+    _sharedWindow = initSharedContextWindow( window );
+    if( !_sharedWindow )
+        return false;
+
+    if( start( ))
+        return true;
+
+    _sharedWindow->configExit();
+    delete _sharedWindow;
+    _sharedWindow = 0;
+    return false;
+}
+
+void VolumeLoader::stop()
+{
+    if( !_sharedWindow )
+        return;
+
+    _requests.push( Request( )); // exit loader thread
+    join();
+
+    _sharedWindow->configExit();
+    delete _sharedWindow;
+    _sharedWindow = 0;
+}
+
+void VolumeLoader::request( const int32_t key, const eq::Range& range )
+{
+    _requests.push( Request( key, range ));
+}
+
+void VolumeLoader::run()
+{
+    LBASSERT( _sharedWindow );
+    _sharedWindow->makeCurrent();
+    LBINFO << "volume loader initialized" << std::endl;
+
+    for( ;; )
+    {
+        const Request request = _requests.pop();
+        if( request.exit )
+            break;
+
+        Result result;
+        result.key = request.key;
+        result.success = _model.createVolumeTexture( result.part,
+                                                     request.range,
+                                                     glewGetContext( ));
+
+        // the texture has to be complete before it is used by the renderer
+        EQ_GL_CALL( glFinish( ));
+        _results.push( result );
+    }
+}
+}
@@ -0,0 +1,92 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EVOLVE_VOLUME_LOADER_H
+#define EVOLVE_VOLUME_LOADER_H
+
+#include "rawVolModel.h"
+
+#include <eq/eq.h>
+
+namespace eVolve
+{
+/**
+ * Loads and uploads volume ranges in a thread with a shared context.
+ *
+ * The render thread requests ranges which are not resident yet and keeps
+ * rendering with the last texture until the loader returns the new one.
+ */
+class VolumeLoader : protected lunchbox::Thread
+{
+public:
+    /** The texture created for one requested range. */
+    struct Result
+    {
+        Result() : key( 0 ), success( false ) {}
+
+        int32_t                    key;     //!< range key of the request
+        RawVolumeModel::VolumePart part;    //!< the created texture
+        bool                       success; //!< false if loading failed
+    };
+
+    explicit VolumeLoader( RawVolumeModel& model );
+    ~VolumeLoader();
+
+    /** Create the shared context and start the thread. @return success. */
+    bool setup( eq::Window* window );
+    void stop();
+
+    /** Request the texture of the given range. */
+    void request( const int32_t key, const eq::Range& range );
+
+    bool   tryGetResult( Result& result ) { return _results.tryPop( result ); }
+    Result getResult()                    { return _results.pop();            }
+
+protected:
+    virtual void run();
+    const GLEWContext* glewGetContext() const;
+
+private:
+    struct Request
+    {
+        Request() : key( 0 ), exit( true ) {}
+        Request( const int32_t key_, const eq::Range& range_ )
+            : key( key_ ), range( range_ ), exit( false ) {}
+
+        int32_t   key;
+        eq::Range range;
+        bool      exit;
+    };
+
+    RawVolumeModel&              _model;
+    lunchbox::MTQueue< Request > _requests; //!< ranges to load
+    lunchbox::MTQueue< Result >  _results;  //!< loaded textures
+    eq::SystemWindow*            _sharedWindow;
+};
+}
+
+#endif // EVOLVE_VOLUME_LOADER_H
@@ -80,10 +80,23 @@ bool Window::configInitGL( const eq::uint128_t& )
         return false;
     }
 
+    renderer->startLoader( this );
     _loadLogo();
     return true;
 }
 
+bool Window::configExitGL()
+{
+    Pipe*     pipe     = static_cast<Pipe*>( getPipe() );
+    Renderer* renderer = pipe->getRenderer();
+
+    // the loader's shared context depends on this window
+    if( renderer )
+        renderer->stopLoader();
+
+    return eq::Window::configExitGL();
+}
+
 namespace
 {
 static const std::string _logoTextureName =
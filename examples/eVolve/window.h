@@ -50,6 +50,7 @@ protected:
     virtual ~Window() {}
     virtual bool configInit( const eq::uint128_t& initID );
     virtual bool configInitGL( const eq::uint128_t& initID );
+    virtual bool configExitGL();
     virtual void swapBuffers();
 
 private:
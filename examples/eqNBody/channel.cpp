@@ -45,7 +45,6 @@ Channel::Channel( eq::Window* parent )
     : eq::Channel( parent )
     , _controller( new Controller( glewGetContext( )))
     , _registerMem( true )
-    , _mapMem( true )
 {}
 
 Channel::~Channel()
@@ -77,27 +76,20 @@ void Channel::frameDraw( const eq::uint128_t& frameID )
         sd.registerMemory( getRange() );
         _registerMem = false;
 
-        // Make sure all proxies are mapped before cont'ing
+        // Make sure all pipes are known before cont'ing
         return;
     }
 
-    // 2nd, map remote memory
-    if( _mapMem )
-    {
-        sd.mapMemory();
-        _mapMem = false;
-    }
-
-    // 3rd, synchronize the shared memory
+    // 2nd, receive the ranges of the other pipes
     sd.syncMemory();
 
-    // 4th, update the GPU memory and run one simulation step
+    // 3rd, update the GPU memory and run one simulation step
     const uint32_t nBytes = sd.getNumBytes();
     _controller->setArray( BODYSYSTEM_POSITION, sd.getPos(), nBytes );
     _controller->setArray( BODYSYSTEM_VELOCITY, sd.getVel(), nBytes );
     _controller->compute( sd.getTimeStep(), range );
 
-    // 5th, draw the stars
+    // 4th, draw the stars
     eq::Channel::frameDraw( frameID );
     _controller->draw( sd.getPos(), sd.getCol() );
 
@@ -105,8 +97,7 @@ void Channel::frameDraw( const eq::uint128_t& frameID )
     outlineViewport();
 #endif
 
-    // Finally, redistribute the newly computed data from the GPU to all
-    // interested mappers
+    // Finally, send the newly computed data from the GPU to all other pipes
     sd.updateMemory( range, _controller );
 }
 }
@@ -51,7 +51,6 @@ namespace eqNbody
         Controller*     _controller;
 
         bool _registerMem;
-        bool _mapMem;
     };
 }
 
@@ -214,18 +214,18 @@ void Config::_updateSimulation()
 
 void Config::_registerData( eq::EventICommand& command )
 {
-    const eq::uint128_t pid = command.get< eq::uint128_t >();
+    const eq::uint128_t exchangeID = command.get< eq::uint128_t >();
     const eq::Range range = command.get< eq::Range >();
+    const eq::uint128_t nodeID = command.get< eq::uint128_t >();
 
-    _frameData.addProxyID( pid, range );
+    _frameData.addPeer( exchangeID, nodeID, range );
 }
 
 void Config::_updateData( eq::EventICommand& command )
 {
-    const eq::uint128_t pid = command.get< eq::uint128_t >();
+    const eq::uint128_t exchangeID = command.get< eq::uint128_t >();
     const eq::Range range = command.get< eq::Range >();
-    const eq::uint128_t version = command.get< eq::uint128_t >();
 
-    _frameData.updateProxyID( pid, version, range );
+    _frameData.updatePeer( exchangeID, range );
 }
 }
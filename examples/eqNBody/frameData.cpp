@@ -39,7 +39,7 @@
 
 namespace eqNbody
 {
-FrameData::FrameData() : _statistics( true ) , _numDataProxies(0), _hPos(0)
+FrameData::FrameData() : _statistics( true ) , _numPeers(0), _hPos(0)
                        , _hVel(0), _hCol(0)
 {
     _numBodies      = 0;
@@ -51,7 +51,7 @@ FrameData::FrameData() : _statistics( true ) , _numDataProxies(0), _hPos(0)
 
 FrameData::~FrameData()
 {
-    _numDataProxies = 0;
+    _numPeers = 0;
 }
 
 void FrameData::serialize( co::DataOStream& os, const uint64_t dirtyBits )
@@ -68,9 +68,10 @@ void FrameData::serialize( co::DataOStream& os, const uint64_t dirtyBits )
         os << _statistics << _numBodies << _clusterScale << _velocityScale
            << _deltaTime << _newParameters;
 
-    if( dirtyBits & DIRTY_PROXYDATA )
-        os << _numDataProxies
-           << co::Array< co::ObjectVersion >( _dataProxyID, MAX_NGPUS )
+    if( dirtyBits & DIRTY_PEERDATA )
+        os << _numPeers
+           << co::Array< eq::uint128_t >( _peerExchangeIDs, MAX_NGPUS )
+           << co::Array< eq::uint128_t >( _peerNodeIDs, MAX_NGPUS )
            << co::Array< float >( _dataRanges, MAX_NGPUS );
 }
 
@@ -89,44 +90,42 @@ void FrameData::deserialize( co::DataIStream& is,
         is >> _statistics >> _numBodies >> _clusterScale >> _velocityScale
            >> _deltaTime >> _newParameters;
 
-    if( dirtyBits & DIRTY_PROXYDATA )
-        is >> _numDataProxies
-           >> co::Array< co::ObjectVersion >( _dataProxyID, MAX_NGPUS )
+    if( dirtyBits & DIRTY_PEERDATA )
+        is >> _numPeers
+           >> co::Array< eq::uint128_t >( _peerExchangeIDs, MAX_NGPUS )
+           >> co::Array< eq::uint128_t >( _peerNodeIDs, MAX_NGPUS )
            >> co::Array< float >( _dataRanges, MAX_NGPUS );
 }
 
-void FrameData::addProxyID( const eq::uint128_t& pid, const eq::Range& range )
+void FrameData::addPeer( const eq::uint128_t& exchangeID,
+                         const eq::uint128_t& nodeID, const eq::Range& range )
 {
-    LBASSERT(_numDataProxies < MAX_NGPUS);
+    LBASSERT(_numPeers < MAX_NGPUS);
 
-    _dataProxyID[_numDataProxies].identifier = pid;
-    _dataProxyID[_numDataProxies].version = co::VERSION_NONE;
+    _peerExchangeIDs[_numPeers] = exchangeID;
+    _peerNodeIDs[_numPeers] = nodeID;
+    _dataRanges[_numPeers++] = (range.end - range.start);
 
-    _dataRanges[_numDataProxies++] = (range.end - range.start);
-    setDirty( DIRTY_PROXYDATA );
+    setDirty( DIRTY_PEERDATA );
 }
 
-void FrameData::updateProxyID( const eq::uint128_t& pid,
-                               const eq::uint128_t& version,
-                               const eq::Range& range )
+void FrameData::updatePeer( const eq::uint128_t& exchangeID,
+                            const eq::Range& range )
 {
-    // TODO: Better use a hash here!
-    for(unsigned int i=0; i< _numDataProxies; i++)
+    for(unsigned int i=0; i< _numPeers; i++)
     {
-        if( pid == _dataProxyID[i].identifier )
+        if( exchangeID == _peerExchangeIDs[i] )
         {
-            _dataProxyID[i].version = version;
             _dataRanges[i] = (range.end - range.start);
             break;
         }
     }
-    setDirty( DIRTY_PROXYDATA );
 }
 
 eq::uint128_t FrameData::commit()
 {
     const eq::uint128_t v = co::Serializable::commit();
-    for( unsigned int i = 0; i< _numDataProxies; ++i )
+    for( unsigned int i = 0; i< _numPeers; ++i )
         _dataRanges[i] = 0.0f;
 
     return v;
@@ -136,7 +135,7 @@ bool FrameData::isReady()
 {
     float length = 0.0f;
 
-    for(unsigned int i=0; i<_numDataProxies; i++) {
+    for(unsigned int i=0; i<_numPeers; i++) {
         length += _dataRanges[i];
     }
 
@@ -144,18 +143,6 @@ bool FrameData::isReady()
     return (length == 1.0f) ? true : false;
 }
 
-eq::uint128_t FrameData::getVersionForProxyID( const eq::uint128_t& pid ) const
-{
-    // TODO: Better use a hash here!
-    for( unsigned int i=0; i< _numDataProxies; ++i )
-    {
-        if( pid == getProxyID( i ))
-            return getProxyVersion( i );
-    }
-
-    return 0;
-}
-
 void FrameData::toggleStatistics()
 {
     _statistics = !_statistics;
@@ -188,7 +175,7 @@ void FrameData::initHostData()
 
 void FrameData::exit()
 {
-    _numDataProxies = 0;
+    _numPeers = 0;
     _numBodies      = 0;
 
 #ifdef ENABLE_HOSTALLOC
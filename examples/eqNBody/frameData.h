@@ -60,17 +60,16 @@ namespace eqNbody
         void toggleStatistics();
         bool useStatistics() const { return _statistics; }
 
-        unsigned int getNumDataProxies( void ) const { return _numDataProxies; }
-        eq::uint128_t getProxyID( unsigned int ndx ) const
-            { return _dataProxyID[ndx].identifier; }
-        eq::uint128_t getProxyVersion( unsigned int ndx ) const
-            { return _dataProxyID[ndx].version; }
-        eq::uint128_t getVersionForProxyID( const eq::uint128_t& pid ) const;
-
-        void addProxyID( const eq::uint128_t& pid, const eq::Range& range );
-        void updateProxyID( const eq::uint128_t& pid,
-                            const eq::uint128_t& version,
-                            const eq::Range& range );
+        unsigned int getNumPeers() const { return _numPeers; }
+        eq::uint128_t getPeerExchangeID( unsigned int ndx ) const
+            { return _peerExchangeIDs[ndx]; }
+        eq::uint128_t getPeerNodeID( unsigned int ndx ) const
+            { return _peerNodeIDs[ndx]; }
+
+        void addPeer( const eq::uint128_t& exchangeID,
+                      const eq::uint128_t& nodeID, const eq::Range& range );
+        void updatePeer( const eq::uint128_t& exchangeID,
+                         const eq::Range& range );
 
         virtual eq::uint128_t commit();
         bool isReady();
@@ -100,7 +99,7 @@ namespace eqNbody
         enum DirtyBits
         {
             DIRTY_DATA      = co::Serializable::DIRTY_CUSTOM << 0,
-            DIRTY_PROXYDATA = co::Serializable::DIRTY_CUSTOM << 1,
+            DIRTY_PEERDATA  = co::Serializable::DIRTY_CUSTOM << 1,
             DIRTY_FLAGS     = co::Serializable::DIRTY_CUSTOM << 2
         };
 
@@ -110,9 +109,10 @@ namespace eqNbody
         bool            _statistics;
         bool            _newParameters;
 
-        uint32_t        _numDataProxies;          // total number of proxies
-        co::ObjectVersion _dataProxyID[ MAX_NGPUS ];// ID, version
-        float           _dataRanges[ MAX_NGPUS ]; // ranges covered by proxies
+        uint32_t        _numPeers;                // total number of pipes
+        eq::uint128_t   _peerExchangeIDs[ MAX_NGPUS ]; // data exchange IDs
+        eq::uint128_t   _peerNodeIDs[ MAX_NGPUS ];     // nodes of the pipes
+        float           _dataRanges[ MAX_NGPUS ]; // ranges updated by pipes
 
         uint32_t    _numBodies;     // number of bodies in the simulation
         float       _deltaTime;     // time step
@@ -73,7 +73,6 @@ bool Pipe::configExit()
 
     config->unmapObject( &fd );
     LBASSERT( _data );
-    _data->releaseMemory();
     delete _data;
     return eq::Pipe::configExit();
 }
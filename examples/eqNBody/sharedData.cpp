@@ -29,14 +29,13 @@
  */
 
 #include "sharedData.h"
-#include "sharedDataProxy.h"
 #include "pipe.h"
 #include "config.h"
 #include "controller.h"
 
 namespace eqNbody
 {
-SharedData::SharedData( Config *cfg ) : _cfg( cfg )
+SharedData::SharedData( Config *cfg ) : _sequence( 0 ), _cfg( cfg )
 {
     LBASSERT( _cfg );
 }
@@ -45,94 +44,68 @@ SharedData::~SharedData()
 {
     if( _cfg )
         _cfg = 0;
-
-    for( uint32_t i=0; i< _frameData.getNumDataProxies(); i++ )
-    {
-        delete _proxies[i];
-    }
-    _proxies.clear();
 }
 
 void SharedData::registerMemory( const eq::Range& range )
 {
-    // Initialise the local proxy
+    // Initialise the local range
     unsigned int offset = range.start * _frameData.getNumBodies() * 4;
     unsigned int numBytes = ( range.end - range.start ) *
                             _frameData.getNumBytes();
-    SharedDataProxy *shMem = new SharedDataProxy();
-    _proxies.push_back( shMem );
 
-    shMem->init( offset, numBytes, _frameData.getPos(), _frameData.getVel(),
+    _local.init( offset, numBytes, _frameData.getPos(), _frameData.getVel(),
                  _frameData.getCol() );
+    _exchangeID = lunchbox::UUID( true );
 
-    // Register the proxy object
-    _cfg->registerObject( shMem );
-
-    const eq::uint128_t version = shMem->commit();
-
-    // Let the app know which range is covered by this proxy
-    _sendEvent( DATA_CHANGED, version, shMem->getID(), range );
-}
-
-void SharedData::mapMemory()
-{
-    const SharedDataProxy *shMem = _proxies[0];
-
-    // Initialise the remote shared memory proxies
-    for( uint32_t i=0; i< _frameData.getNumDataProxies(); i++)
-    {
-        const eq::uint128_t& pid = _frameData.getProxyID(i);
-
-        if( pid != shMem->getID() )
-        {
-            SharedDataProxy *readMem = new SharedDataProxy();
-
-            readMem->init( _frameData.getPos(), _frameData.getVel(),
-                           _frameData.getCol() );
-            _proxies.push_back( readMem );
-
-            LBCHECK( _cfg->mapObject( readMem, pid ));
-        }
-    }
-}
-
-void SharedData::releaseMemory()
-{
-    for( uint32_t i=0; i< _frameData.getNumDataProxies(); i++ )
-    {
-        _cfg->releaseObject( _proxies[i] );
-    }
+    // Let the app know which range is covered by this pipe, and where the
+    // others send their ranges to
+    _cfg->sendEvent( DATA_CHANGED ) << _exchangeID << range
+                                    << _cfg->getLocalNode()->getNodeID();
 }
 
 void SharedData::syncMemory()
 {
-    for(unsigned int i=1; i< _frameData.getNumDataProxies(); i++)
-    {
-        const eq::uint128_t& pid = _proxies[i]->getID();
-        const eq::uint128_t version = _frameData.getVersionForProxyID(pid);
-
-        // ...and sync!
-        _proxies[i]->sync( version );
-    }
+    // the initial data is distributed with the frame data
+    if( _sequence == 0 )
+        return;
+
+    // ...receive the ranges computed by all other pipes
+    const size_t nPeers = _frameData.getNumPeers() - 1;
+    const uint32_t numBytes = _frameData.getNumBytes();
+
+    LBCHECK( _cfg->receiveExchange( _exchangeID, 2 * _sequence, nPeers,
+                                    _frameData.getPos(), numBytes ));
+    LBCHECK( _cfg->receiveExchange( _exchangeID, 2 * _sequence + 1, nPeers,
+                                    _frameData.getVel(), numBytes ));
 }
 
 void SharedData::updateMemory(const eq::Range& range, Controller *controller)
 {
-    SharedDataProxy *local = _proxies[0];
-
-    controller->getArray(BODYSYSTEM_POSITION, *local);
-    controller->getArray(BODYSYSTEM_VELOCITY, *local);
+    controller->getArray(BODYSYSTEM_POSITION, _local);
+    controller->getArray(BODYSYSTEM_VELOCITY, _local);
 
-    // Commit the local changes
-    const eq::uint128_t version = local->commit();
+    // Send the local changes directly to all other pipes
+    ++_sequence;
+    _send( 2 * _sequence, _frameData.getPos() );
+    _send( 2 * _sequence + 1, _frameData.getVel() );
 
-    // Tell the others what version to sync.
-    _sendEvent( PROXY_CHANGED, version, local->getID(), range) ;
+    // Tell the app that this range is done
+    _cfg->sendEvent( PROXY_CHANGED ) << _exchangeID << range;
 }
 
-void SharedData::_sendEvent( ConfigEventType type, const eq::uint128_t& version,
-                             const eq::uint128_t& pid, const eq::Range& range )
+void SharedData::_send( const uint32_t sequence, const float* data )
 {
-    _cfg->sendEvent( type ) << pid << range << version;
+    const unsigned int offset = _local.getOffset();
+
+    for( uint32_t i = 0; i < _frameData.getNumPeers(); ++i )
+    {
+        const eq::uint128_t& exchangeID = _frameData.getPeerExchangeID( i );
+        if( exchangeID == _exchangeID )
+            continue;
+
+        _cfg->sendExchange( _frameData.getPeerNodeID( i ), exchangeID,
+                            sequence, offset * sizeof( float ), data + offset,
+                            _local.getNumBytes( ));
+    }
 }
 }
@@ -36,10 +36,10 @@
 
 #include "frameData.h"
 #include "configEvent.h"
+#include "sharedDataProxy.h"
 
 namespace eqNbody
 {
-    class SharedDataProxy;
     class Config;
     class Controller;
 
@@ -53,8 +53,6 @@ namespace eqNbody
         const FrameData& getFrameData() const { return _frameData; }
 
         void registerMemory( const eq::Range& range );
-        void releaseMemory();
-        void mapMemory();
         void syncMemory();
         void updateMemory( const eq::Range& range, Controller *controller );
 
@@ -70,10 +68,11 @@ namespace eqNbody
     protected:
 
     private:
-        void _sendEvent( ConfigEventType type, const eq::uint128_t& version,
-                         const eq::uint128_t& pid, const eq::Range& range);
+        void _send( const uint32_t sequence, const float* data );
 
-        std::vector< SharedDataProxy* >    _proxies;
+        SharedDataProxy _local;     // the range computed by this pipe
+        eq::uint128_t   _exchangeID; // receives the ranges of the others
+        uint32_t        _sequence;  // the last exchanged update
         FrameData _frameData;
         Config*   _cfg;
     };
@@ -35,6 +35,9 @@
 #ifdef WIN32_API
 #  define snprintf _snprintf
 #endif
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
 
 namespace eqPixelBench
 {
@@ -62,6 +65,15 @@ static EnumMap _enums[] = {
     ENUM_MAP_ITEM( DEPTH, 4 ),
     { 0, 0, 0 }};
 #define NUM_IMAGES 8
+
+/** Set the number of CPU compositing threads, 0 for the default. */
+void _setThreads( const uint32_t threads LB_UNUSED )
+{
+#ifdef _OPENMP
+    static const int defaultThreads = omp_get_max_threads();
+    omp_set_num_threads( threads > 0 ? int( threads ) : defaultThreads );
+#endif
+}
 }
 
 Channel::Channel( eq::Window* parent )
@@ -113,11 +125,34 @@ void Channel::frameDraw( const eq::uint128_t& )
 
     setupAssemblyState();
 
-    _testFormats( 1.0f );
-    _testFormats( 0.5f );
-    _testFormats( 2.0f );
-    _testTiledOperations();
-    _testDepthAssemble();
+    const Settings& settings = _getSettings();
+    const eq::PixelViewport& pvp = getPixelViewport();
+    std::vector< eq::Vector2i > sizes = settings.getSizes();
+    if( sizes.empty( ))
+        sizes.push_back( eq::Vector2i( pvp.w, pvp.h ));
+
+    for( size_t i = 0; i < sizes.size(); ++i )
+    {
+        // images larger than the channel are clipped, the results report the
+        // tested area
+        _pvp = pvp;
+        _pvp.w = LB_MIN( sizes[i].x(), pvp.w );
+        _pvp.h = LB_MIN( sizes[i].y(), pvp.h );
+
+        if( settings.getTests() & TEST_FORMATS )
+        {
+            _testFormats( 1.0f );
+            _testFormats( 0.5f );
+            _testFormats( 2.0f );
+        }
+        if( settings.getTests() & TEST_COMPRESSION )
+            _testCompression();
+        if( settings.getTests() & TEST_TILES )
+            _testTiledOperations();
+        if( settings.getTests() & TEST_DEPTH )
+            _testDepthAssemble();
+    }
+    _setThreads( 0 );
 
     resetAssemblyState();
 }
@@ -131,9 +166,10 @@ void Channel::_testFormats( float applyZoom )
     eq::Image*        image  = images[ 0 ];
     LBASSERT( image );
 
-    const eq::PixelViewport& pvp = getPixelViewport();
+    const eq::PixelViewport& pvp = _pvp;
     const eq::Vector2i offset( pvp.x, pvp.y );
     const eq::Zoom zoom( applyZoom, applyZoom );
+    const uint32_t loopTime = _getSettings().getLoopTime();
 
     lunchbox::Clock clock;
     eq::util::ObjectManager& glObjects = getObjectManager();
@@ -171,7 +207,7 @@ void Channel::_testFormats( float applyZoom )
             try
             {
                 clock.reset();
-                while( clock.getTime64() < 100 /*ms*/ )
+                while( clock.getTime64() < loopTime )
                 {
                     image->startReadback( eq::Frame::BUFFER_COLOR, pvp, zoom,
                                           glObjects );
@@ -246,7 +282,7 @@ void Channel::_testTiledOperations()
     const eq::Images& images = _frame.getImages();
     LBASSERT( images[0] );
 
-    const eq::PixelViewport& pvp    = getPixelViewport();
+    const eq::PixelViewport& pvp    = _pvp;
     const eq::Vector2i     offset( pvp.x, pvp.y );
 
     eq::Vector2i area;
@@ -349,14 +385,7 @@ void Channel::_testTiledOperations()
         // CPU
         formatType.str("");
         formatType << "tiles, CPU,   " << tiles+1 << " images";
-
-        std::vector< eq::Frame* > frames;
-        frames.push_back( &_frame );
-
-        clock.reset();
-        eq::Compositor::assembleFramesCPU( frames, this );
-        msec = clock.getTimef();
-        _sendEvent( ASSEMBLE, msec, area, formatType.str(), 0, 0 );
+        _testAssembleCPU( area, formatType.str( ));
     }
 }
 
@@ -369,7 +398,7 @@ void Channel::_testDepthAssemble()
     eq::Image* image  = images[ 0 ];
     LBASSERT( image );
 
-    const eq::PixelViewport& pvp    = getPixelViewport();
+    const eq::PixelViewport& pvp    = _pvp;
     const eq::Vector2i offset( pvp.x, pvp.y );
 
     eq::Vector2i area;
@@ -450,22 +479,124 @@ void Channel::_testDepthAssemble()
         // CPU
         formatType.str("");
         formatType << "depth, CPU,   " << i+1 << " images";
+        _testAssembleCPU( area, formatType.str( ));
+    }
+}
+
+void Channel::_testCompression()
+{
+    glGetError(); // reset
+
+    //----- setup constant data
+    const eq::Images& images = _frame.getImages();
+    eq::Image* image = images[ 0 ];
+    LBASSERT( image );
+
+    const eq::PixelViewport& pvp = _pvp;
+    const eq::Vector2i area( pvp.w, pvp.h );
+    const uint32_t loopTime = _getSettings().getLoopTime();
+
+    lunchbox::Clock clock;
+    eq::util::ObjectManager& glObjects = getObjectManager();
+    const GLEWContext* glewContext = glewGetContext();
 
-        std::vector< eq::Frame* > frames;
-        frames.push_back( &_frame );
+    image->flush();
+    image->setPixelViewport( pvp );
+    image->setAlphaUsage( true );
+    _draw( co::uint128_t( ));
+
+    LBCHECK( image->allocDownloader( eq::Frame::BUFFER_COLOR,
+                                     EQ_COMPRESSOR_TRANSFER_RGBA_TO_BGRA,
+                                     glewContext ));
+    LBCHECK( image->allocDownloader( eq::Frame::BUFFER_DEPTH,
+                             EQ_COMPRESSOR_TRANSFER_DEPTH_TO_DEPTH_UNSIGNED_INT,
+                                     glewContext ));
+    image->startReadback( eq::Frame::BUFFER_COLOR | eq::Frame::BUFFER_DEPTH,
+                          pvp, eq::Zoom::NONE, glObjects );
+    image->finishReadback( glewContext );
+
+    //----- test all CPU compressors for the downloaded data
+    const eq::Frame::Buffer buffers[] = { eq::Frame::BUFFER_COLOR,
+                                          eq::Frame::BUFFER_DEPTH };
+    for( size_t i = 0; i < 2; ++i )
+    {
+        const eq::Frame::Buffer buffer = buffers[i];
+        if( !image->hasPixelData( buffer ))
+            continue;
+
+        const uint64_t dataSizeGPU = image->getPixelDataSize( buffer );
+        const std::vector< uint32_t >& names = image->findCompressors( buffer );
+
+        for( std::vector< uint32_t >::const_iterator j = names.begin();
+             j != names.end(); ++j )
+        {
+            std::stringstream formatType;
+            formatType << std::hex << *j << ':'
+                       << ( buffer == eq::Frame::BUFFER_COLOR ? "BGRA" :
+                                                                "DEPTH" )
+                       << std::dec;
+
+            image->useCompressor( buffer, *j );
+
+            size_t nLoops = 0;
+            uint64_t dataSizeCPU = 0;
+            clock.reset();
+            while( clock.getTime64() < loopTime )
+            {
+                const pression::CompressorResult& result =
+                    image->compressPixelRows( buffer, 0, pvp.h );
+                dataSizeCPU = 0;
+                for( size_t k = 0; k < result.chunks.size(); ++k )
+                    dataSizeCPU += result.chunks[k].getNumBytes();
+                ++nLoops;
+            }
+            const float msec = clock.getTimef() / float( nLoops );
+
+            if( dataSizeCPU == 0 )
+                _sendEvent( COMPRESS, -1.f, area, formatType.str(), 0, 0 );
+            else
+                _sendEvent( COMPRESS, msec, area, formatType.str(),
+                            dataSizeGPU, dataSizeCPU );
+        }
+        image->useCompressor( buffer, EQ_COMPRESSOR_AUTO );
+    }
+    image->setAlphaUsage( false );
+}
+
+void Channel::_testAssembleCPU( const eq::Vector2i& area,
+                                const std::string& formatType )
+{
+    std::vector< eq::Frame* > frames;
+    frames.push_back( &_frame );
+
+    std::vector< uint32_t > threads = _getSettings().getThreads();
+    if( threads.empty( ))
+        threads.push_back( 0 );
+
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < threads.size(); ++i )
+    {
+        _setThreads( threads[i] );
 
         clock.reset();
         eq::Compositor::assembleFramesCPU( frames, this );
-        msec = clock.getTimef();
-        _sendEvent( ASSEMBLE, msec, area, formatType.str(), 0, 0 );
+        const float msec = clock.getTimef();
+        _sendEvent( ASSEMBLE, msec, area, formatType, 0, 0, threads[i] );
     }
 }
 
+const Settings& Channel::_getSettings() const
+{
+    const Config* config = static_cast< const Config* >( getConfig( ));
+    return config->getSettings();
+}
+
 void Channel::_sendEvent( ConfigEventType type, const float msec,
                           const eq::Vector2i& area,
                           const std::string& formatType,
                           const uint64_t dataSizeGPU,
-                          const uint64_t dataSizeCPU )
+                          const uint64_t dataSizeCPU,
+                          const uint32_t threads )
 {
     std::string name = getName();
     if( name.empty( ))
@@ -476,7 +607,8 @@ void Channel::_sendEvent( ConfigEventType type, const float msec,
     }
 
     getConfig()->sendEvent( type )
-        << msec << name << area << formatType << dataSizeGPU << dataSizeCPU;
+        << msec << name << area << formatType << dataSizeGPU << dataSizeCPU
+        << threads;
 }
 
 void Channel::_saveImage( const eq::Image* image,
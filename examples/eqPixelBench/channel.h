@@ -32,6 +32,7 @@
 
 #include <eq/eq.h>
 #include "configEvent.h"
+#include "settings.h"
 
 namespace eqPixelBench
 {
@@ -51,18 +52,23 @@ protected:
 private:
     void _draw( const eq::uint128_t& spin );
     void _testFormats( float applyZoom );
+    void _testCompression();
     void _testTiledOperations();
     void _testDepthAssemble();
+    void _testAssembleCPU( const eq::Vector2i& area,
+                           const std::string& formatType );
+    const Settings& _getSettings() const;
     void _saveImage( const eq::Image* image,
                      const char*      externalformat = "",
                      const char*      info   = "" );
     void _sendEvent( ConfigEventType type, const float msec,
                      const eq::Vector2i& area,
                      const std::string& formatType, const uint64_t dataSizeGPU,
-                     const uint64_t dataSizeCPU );
+                     const uint64_t dataSizeCPU, const uint32_t threads = 0 );
 
 private:
     eq::Frame _frame;
+    eq::PixelViewport _pvp; //!< the tested area of the channel
 };
 }
 
@@ -30,12 +30,46 @@
 #include "config.h"
 #include "configEvent.h"
 
-
 namespace eqPixelBench
 {
+namespace
+{
+const char* _getOperation( const uint32_t type )
+{
+    switch( type )
+    {
+    case READBACK: return "readback";
+    case ASSEMBLE: return "assemble";
+    case COMPRESS: return "compress";
+    case START_LATENCY:
+    default:       return "latency";
+    }
+}
+
+/** @return the string quoted for CSV or JSON output. */
+std::string _quote( const std::string& string, const bool json )
+{
+    std::string quoted( "\"" );
+    for( size_t i = 0; i < string.length(); ++i )
+    {
+        const char c = string[i];
+        if( c == '"' )
+            quoted += json ? "\\\"" : "\"\"";
+        else if( c == '\\' && json )
+            quoted += "\\\\";
+        else
+            quoted += c;
+    }
+    return quoted + "\"";
+}
+}
+
 Config::Config( eq::ServerPtr parent )
         : eq::Config( parent )
         , _clock(0)
+        , _out( &std::cout )
+        , _nResults( 0 )
+        , _nErrors( 0 )
 {
 }
 
@@ -45,6 +79,58 @@ Config::~Config()
     _clock = 0;
 }
 
+bool Config::init()
+{
+    if( !_settings.getOutput().empty( ))
+    {
+        _file.open( _settings.getOutput().c_str( ));
+        if( !_file )
+        {
+            LBERROR << "Can't open " << _settings.getOutput() << std::endl;
+            return false;
+        }
+        _out = &_file;
+    }
+
+    switch( _settings.getOutputFormat( ))
+    {
+    case OUTPUT_CSV:
+        *_out << "operation,channel,format,width,height,threads,msec,"
+              << "mpixPerSec,sizeGPU,sizeCPU,error" << std::endl;
+        break;
+    case OUTPUT_JSON:
+        *_out << "[";
+        break;
+    case OUTPUT_TEXT:
+        break;
+    }
+
+    registerObject( &_settings );
+    if( eq::Config::init( _settings.getID( )))
+        return true;
+
+    deregisterObject( &_settings );
+    return false;
+}
+
+bool Config::exit()
+{
+    const bool ret = eq::Config::exit();
+    if( _settings.isAttached( ))
+        deregisterObject( &_settings );
+
+    if( _settings.getOutputFormat() == OUTPUT_JSON )
+        *_out << std::endl << "]" << std::endl;
+    _out->flush();
+    return ret;
+}
+
+bool Config::loadSettings( const eq::uint128_t& id )
+{
+    LBASSERT( !_settings.isAttached( ));
+    return getClient()->syncObject( &_settings, getApplicationNode(), id );
+}
+
 uint32_t Config::startFrame( const eq::uint128_t& frameID )
 {
     if( !_clock )
@@ -60,59 +146,119 @@ bool Config::handleEvent( eq::EventICommand command )
     {
     case READBACK:
     case ASSEMBLE:
+    case COMPRESS:
     case START_LATENCY:
     {
-        switch( command.getEventType( ))
+        const float msec = command.read< float >();
+        const std::string& name = command.read< std::string >();
+        const eq::Vector2i& area = command.read< eq::Vector2i >();
+        const std::string& formatType = command.read< std::string >();
+        const uint64_t dataSizeGPU = command.read< uint64_t >();
+        const uint64_t dataSizeCPU = command.read< uint64_t >();
+        const uint32_t threads = command.read< uint32_t >();
+
+        _writeResult( command.getEventType(), msec, name, area, formatType,
+                      dataSizeGPU, dataSizeCPU, threads );
+        return true;
+    }
+
+    default:
+        return eq::Config::handleEvent( command );
+    }
+}
+
+void Config::_writeResult( const uint32_t type, const float msec,
+                           const std::string& name, const eq::Vector2i& area,
+                           const std::string& formatType,
+                           const uint64_t dataSizeGPU,
+                           const uint64_t dataSizeCPU, const uint32_t threads )
+{
+    const bool error = msec < 0.0f;
+    if( error )
+        ++_nErrors;
+    const float mpixPerSec = error || msec == 0.f ? 0.f :
+                             area.x() * area.y() / msec / 1048.576f;
+    std::ostream& os = *_out;
+
+    switch( _settings.getOutputFormat( ))
+    {
+    case OUTPUT_CSV:
+        os << _getOperation( type ) << ',' << _quote( name, false ) << ','
+           << _quote( formatType, false ) << ',' << area.x() << ','
+           << area.y() << ',' << threads << ',' << ( error ? 0.f : msec )
+           << ',' << mpixPerSec << ',' << dataSizeGPU << ',' << dataSizeCPU
+           << ',';
+        if( error )
+            os << "0x" << std::hex << static_cast< int >( -msec ) << std::dec;
+        os << std::endl;
+        break;
+
+    case OUTPUT_JSON:
+        os << ( _nResults == 0 ? "" : "," ) << std::endl
+           << "  { \"operation\": \"" << _getOperation( type )
+           << "\", \"channel\": " << _quote( name, true )
+           << ", \"format\": " << _quote( formatType, true )
+           << ", \"width\": " << area.x() << ", \"height\": " << area.y()
+           << ", \"threads\": " << threads
+           << ", \"msec\": " << ( error ? 0.f : msec )
+           << ", \"mpixPerSec\": " << mpixPerSec
+           << ", \"sizeGPU\": " << dataSizeGPU
+           << ", \"sizeCPU\": " << dataSizeCPU;
+        if( error )
+            os << ", \"error\": " << static_cast< int >( -msec );
+        os << " }";
+        break;
+
+    case OUTPUT_TEXT:
+    {
+        switch( type )
         {
         case READBACK:
-            std::cout << "readback";
+            os << "readback";
             break;
         case ASSEMBLE:
-            std::cout << "assemble";
+            os << "assemble";
+            break;
+        case COMPRESS:
+            os << "compress";
             break;
         case START_LATENCY:
         default:
-            std::cout << "        ";
+            os << "        ";
         }
 
-        const float msec = command.read< float >();
-        const std::string& name = command.read< std::string >();
-        const eq::Vector2i& area = command.read< eq::Vector2i >();
-        const std::string& formatType = command.read< std::string >();
-        const uint64_t dataSizeGPU = command.read< uint64_t >();
-        const uint64_t dataSizeCPU = command.read< uint64_t >();
+        os << " \"" << name << "\" " << formatType
+           << std::string( 32-std::min( formatType.length(), size_t( 32 )),
+                           ' ' )
+           << area.x() << "x" << area.y() << ": ";
 
-        std::cout << " \"" << name << "\" " << formatType
-                  << std::string( 32-formatType.length(), ' ' ) << area.x()
-                  << "x" << area.y() << ": ";
-
-        if( msec < 0.0f )
-            std::cout << "error 0x" << std::hex << static_cast< int >( -msec )
-                      << std::dec;
+        if( error )
+            os << "error 0x" << std::hex << static_cast< int >( -msec )
+               << std::dec;
         else
-            std::cout << static_cast< uint32_t >( area.x() * area.y() /
-                                                  msec / 1048.576f )
-                      << "MPix/sec (" << msec << "ms, "
-                      << unsigned(1000.0f / msec) << "FPS)";
+            os << static_cast< uint32_t >( mpixPerSec )
+               << "MPix/sec (" << msec << "ms, "
+               << unsigned(1000.0f / msec) << "FPS)";
+
+        if( threads > 0 )
+            os << " " << threads << " threads ";
 
-        if( command.getEventType() == READBACK )
+        if( type == READBACK || type == COMPRESS )
         {
-            std::cout << area << "( size GPU : " << dataSizeGPU << " bytes ";
-            std::cout << "/ size CPU : " << dataSizeCPU << " bytes ";
-            std::cout << "/ time : " <<  msec << "ms )";
+            os << area << "( size GPU : " << dataSizeGPU << " bytes ";
+            os << "/ size CPU : " << dataSizeCPU << " bytes ";
+            os << "/ time : " <<  msec << "ms )";
         }
-        else if( command.getEventType() == ASSEMBLE )
+        else if( type == ASSEMBLE )
         {
-            std::cout << area << "( size CPU : " << dataSizeCPU << " bytes ";
-            std::cout << "/ time : " <<  msec << "ms )";
+            os << area << "( size CPU : " << dataSizeCPU << " bytes ";
+            os << "/ time : " <<  msec << "ms )";
         }
 
-        std::cout << std::endl;
-        return true;
+        os << std::endl;
+        break;
     }
-
-    default:
-        return eq::Config::handleEvent( command );
     }
+    ++_nResults;
 }
 }
@@ -30,7 +30,10 @@
 #ifndef EQ_PIXELBENCH_CONFIG_H
 #define EQ_PIXELBENCH_CONFIG_H
 
+#include "settings.h"
+
 #include <eq/eq.h>
+#include <fstream>
 
 /** The Equalizer Pixel Transfer Benchmark Utility */
 namespace eqPixelBench
@@ -40,6 +43,24 @@ class Config : public eq::Config
 public:
     Config( eq::ServerPtr parent );
 
+    /** Register the settings and initialize the config. */
+    bool init();
+
+    /** @sa eq::Config::exit, finishes the result output. */
+    virtual bool exit();
+
+    /** Set the settings parsed by the application. */
+    void setSettings( const Settings& settings ) { _settings = settings; }
+
+    /** Map the settings of the application on a render client. */
+    bool loadSettings( const eq::uint128_t& id );
+
+    /** @return the benchmark settings. */
+    const Settings& getSettings() const { return _settings; }
+
+    /** @return the number of failed measurements. */
+    size_t getNErrors() const { return _nErrors; }
+
     /** @sa eq::Config::startFrame */
     virtual uint32_t startFrame( const eq::uint128_t& frameID );
 
@@ -54,6 +75,17 @@ protected:
 
 private:
     lunchbox::Clock* _clock;
+    Settings _settings;
+
+    std::ofstream _file;
+    std::ostream* _out; //!< the result stream, _file or std::cout
+    size_t _nResults;
+    size_t _nErrors;
+
+    void _writeResult( uint32_t type, float msec, const std::string& name,
+                       const eq::Vector2i& area, const std::string& formatType,
+                       uint64_t dataSizeGPU, uint64_t dataSizeCPU,
+                       uint32_t threads );
 };
 }
 
@@ -39,6 +39,7 @@ enum ConfigEventType
 {
     READBACK = eq::Event::USER,
     ASSEMBLE,
+    COMPRESS,
     START_LATENCY
 };
 
@@ -28,6 +28,8 @@
 
 #include "channel.h"
 #include "config.h"
+#include "node.h"
+#include "settings.h"
 #include "window.h"
 
 
@@ -36,6 +38,8 @@ class NodeFactory : public eq::NodeFactory
 public:
     virtual eq::Config*  createConfig( eq::ServerPtr parent )
         { return new eqPixelBench::Config( parent ); }
+    virtual eq::Node* createNode( eq::Config* parent )
+        { return new eqPixelBench::Node( parent ); }
     virtual eq::Window* createWindow( eq::Pipe* parent )
         { return new eqPixelBench::Window( parent ); }
     virtual eq::Channel* createChannel( eq::Window* parent )
@@ -53,6 +57,9 @@ int main( int argc, char** argv )
         return EXIT_FAILURE;
     }
 
+    eqPixelBench::Settings settings;
+    settings.parseArguments( argc, argv );
+
     eq::ClientPtr client = new eq::Client;
     if( !client->initLocal( argc, argv ))
     {
@@ -88,7 +95,8 @@ int main( int argc, char** argv )
     // 4. init config
     lunchbox::Clock clock;
 
-    if( !config->init( co::uint128_t( )))
+    config->setSettings( settings );
+    if( !config->init( ))
     {
         server->releaseConfig( config );
         client->disconnectServer( server );
@@ -107,11 +115,13 @@ int main( int argc, char** argv )
         config->startFrame( co::uint128_t( ));
         config->finishAllFrames();
     }
+    config->handleEvents();
     LBLOG( eq::LOG_CUSTOM ) << "Rendering took " << clock.getTimef() << " ms ("
                             << ( 1.0f / clock.getTimef() * 1000.f) << " FPS)"
                             << std::endl;
 
     // 6. exit config
+    const bool success = config->getNErrors() == 0;
     clock.reset();
     config->exit();
     LBLOG( eq::LOG_CUSTOM ) << "Exit took " << clock.getTimef() << " ms"
@@ -127,5 +137,5 @@ int main( int argc, char** argv )
     client = 0;
 
     eq::exit();
-    return EXIT_SUCCESS;
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,192 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "settings.h"
+
+#pragma warning( disable: 4275 )
+#include <boost/program_options.hpp>
+#pragma warning( default: 4275 )
+
+#include <cstdio>
+
+namespace po = boost::program_options;
+
+namespace eqPixelBench
+{
+namespace
+{
+std::vector< std::string > _split( const std::string& list )
+{
+    std::vector< std::string > items;
+    std::istringstream stream( list );
+    std::string item;
+    while( std::getline( stream, item, ',' ))
+        if( !item.empty( ))
+            items.push_back( item );
+    return items;
+}
+
+void _fail( const std::string& message )
+{
+    LBERROR << message << std::endl;
+    eq::exit(); // cppcheck-suppress unreachableCode
+    ::exit( EXIT_FAILURE );
+}
+}
+
+Settings::Settings()
+    : _tests( TEST_ALL )
+    , _loopTime( 100 )
+    , _outputFormat( OUTPUT_TEXT )
+{}
+
+Settings& Settings::operator = ( const Settings& from )
+{
+    _sizes = from._sizes;
+    _threads = from._threads;
+    _tests = from._tests;
+    _loopTime = from._loopTime;
+    _output = from._output;
+    _outputFormat = from._outputFormat;
+    return *this;
+}
+
+void Settings::parseArguments( const int argc, char** argv )
+{
+    bool showHelp( false );
+    std::string sizes;
+    std::string threads;
+    std::string tests;
+    std::string format;
+
+    po::options_description options( std::string( "eqPixelBench - "
+                                                  "Equalizer pixel transfer "
+                                                  "and compositing benchmark" )
+                                     + " Version " + eq::Version::getString( ));
+    options.add_options()
+        ( "help,h", po::bool_switch(&showHelp)->default_value( false ),
+          "produce help message" )
+        ( "sizes,s", po::value<std::string>( &sizes ),
+          "Image sizes, e.g., 256x256,1920x1080 (default: channel size)" )
+        ( "threads,t", po::value<std::string>( &threads ),
+          "CPU compositing thread counts, e.g., 1,2,4 (default: OpenMP)" )
+        ( "tests", po::value<std::string>( &tests ),
+          "Tests to run (formats,compression,tiles,depth; default: all)" )
+        ( "time", po::value<uint32_t>( &_loopTime )->default_value( 100 ),
+          "Minimum time to repeat each measurement, in ms" )
+        ( "output,o", po::value<std::string>( &_output ),
+          "Write results to the given file (default: stdout)" )
+        ( "format,f", po::value<std::string>( &format ),
+          "Result format (text|csv|json)" );
+
+    po::variables_map variableMap;
+    try
+    {
+        // parse program options, ignore all non related options
+        po::store( po::command_line_parser( argc, argv ).options(
+                       options ).allow_unregistered().run(),
+                   variableMap );
+        po::notify( variableMap );
+    }
+    catch( std::exception& exception )
+    {
+        _fail( std::string( "Error parsing command line: " ) +
+               exception.what( ));
+    }
+
+    if( showHelp )
+    {
+        std::cout << options << std::endl;
+        eq::exit(); // cppcheck-suppress unreachableCode
+        ::exit( EXIT_SUCCESS );
+    }
+
+    const std::vector< std::string >& sizeList = _split( sizes );
+    for( size_t i = 0; i < sizeList.size(); ++i )
+    {
+        int width = 0, height = 0;
+        if( sscanf( sizeList[i].c_str(), "%dx%d", &width, &height ) != 2 ||
+            width <= 0 || height <= 0 )
+        {
+            _fail( "Invalid image size " + sizeList[i] );
+        }
+        _sizes.push_back( eq::Vector2i( width, height ));
+    }
+
+    const std::vector< std::string >& threadList = _split( threads );
+    for( size_t i = 0; i < threadList.size(); ++i )
+    {
+        const int nThreads = atoi( threadList[i].c_str( ));
+        if( nThreads <= 0 )
+            _fail( "Invalid thread count " + threadList[i] );
+        _threads.push_back( nThreads );
+    }
+
+    if( variableMap.count( "tests" ) > 0 )
+    {
+        _tests = 0;
+        const std::vector< std::string >& testList = _split( tests );
+        for( size_t i = 0; i < testList.size(); ++i )
+        {
+            if( testList[i] == "formats" )
+                _tests |= TEST_FORMATS;
+            else if( testList[i] == "compression" )
+                _tests |= TEST_COMPRESSION;
+            else if( testList[i] == "tiles" )
+                _tests |= TEST_TILES;
+            else if( testList[i] == "depth" )
+                _tests |= TEST_DEPTH;
+            else
+                _fail( "Unknown test " + testList[i] );
+        }
+    }
+
+    if( variableMap.count( "format" ) > 0 )
+    {
+        if( format == "text" )
+            _outputFormat = OUTPUT_TEXT;
+        else if( format == "csv" )
+            _outputFormat = OUTPUT_CSV;
+        else if( format == "json" )
+            _outputFormat = OUTPUT_JSON;
+        else
+            _fail( "Unknown result format " + format );
+    }
+}
+
+void Settings::getInstanceData( co::DataOStream& os )
+{
+    os << _sizes << _threads << _tests << _loopTime;
+}
+
+void Settings::applyInstanceData( co::DataIStream& is )
+{
+    is >> _sizes >> _threads >> _tests >> _loopTime;
+}
+
+}
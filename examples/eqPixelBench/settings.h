@@ -0,0 +1,105 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EQ_PIXELBENCH_SETTINGS_H
+#define EQ_PIXELBENCH_SETTINGS_H
+
+#include <eq/eq.h>
+
+namespace eqPixelBench
+{
+/** The benchmarks to run, see Settings::getTests(). */
+enum Test
+{
+    TEST_FORMATS     = LB_BIT1, //!< readback & draw of all transfer plugins
+    TEST_COMPRESSION = LB_BIT2, //!< CPU compression of all compressors
+    TEST_TILES       = LB_BIT3, //!< tiled readback & assembly
+    TEST_DEPTH       = LB_BIT4, //!< depth-based assembly
+    TEST_ALL         = LB_BIT_ALL_32
+};
+
+/** The format of the benchmark results. */
+enum OutputFormat
+{
+    OUTPUT_TEXT,
+    OUTPUT_CSV,
+    OUTPUT_JSON
+};
+
+/**
+ * The benchmark settings.
+ *
+ * Parsed from the command line by the application, and distributed to all
+ * render clients as the config init data.
+ */
+class Settings : public co::Object
+{
+public:
+    Settings();
+    virtual ~Settings() {}
+
+    Settings& operator = ( const Settings& from );
+
+    /** Parse the command line, exits on error or if help was requested. */
+    void parseArguments( const int argc, char** argv );
+
+    /** @return the image sizes to test, empty for the channel size. */
+    const std::vector< eq::Vector2i >& getSizes() const { return _sizes; }
+
+    /** @return the CPU compositing thread counts, empty for the default. */
+    const std::vector< uint32_t >& getThreads() const { return _threads; }
+
+    /** @return the bitmask of Test benchmarks to run. */
+    uint32_t getTests() const { return _tests; }
+
+    /** @return the minimum time to repeat one measurement, in ms. */
+    uint32_t getLoopTime() const { return _loopTime; }
+
+    /** @return the file to write the results to, empty for stdout. */
+    const std::string& getOutput() const { return _output; }
+
+    /** @return the format of the results. */
+    OutputFormat getOutputFormat() const { return _outputFormat; }
+
+protected:
+    virtual void getInstanceData( co::DataOStream& os );
+    virtual void applyInstanceData( co::DataIStream& is );
+
+private:
+    std::vector< eq::Vector2i > _sizes;
+    std::vector< uint32_t > _threads;
+    uint32_t _tests;
+    uint32_t _loopTime;
+
+    // application-only settings
+    std::string _output;
+    OutputFormat _outputFormat;
+};
+}
+
+#endif // EQ_PIXELBENCH_SETTINGS_H
@@ -0,0 +1,175 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark.h"
+
+#include <lunchbox/scopedMutex.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace eqPly
+{
+namespace
+{
+struct Summary
+{
+    Summary() : mean( 0.f ), p50( 0.f ), p95( 0.f ), p99( 0.f ) {}
+
+    float mean;
+    float p50;
+    float p95;
+    float p99;
+};
+
+float _getPercentile( const std::vector< float >& sorted, const float p )
+{
+    // nearest rank
+    const size_t rank = size_t( std::ceil( p * float( sorted.size( ))));
+    return sorted[ LB_MAX( rank, size_t( 1 )) - 1 ];
+}
+
+Summary _summarize( std::vector< float > times )
+{
+    Summary summary;
+    if( times.empty( ))
+        return summary;
+
+    std::sort( times.begin(), times.end( ));
+    float sum = 0.f;
+    for( size_t i = 0; i < times.size(); ++i )
+        sum += times[i];
+
+    summary.mean = sum / float( times.size( ));
+    summary.p50 = _getPercentile( times, .50f );
+    summary.p95 = _getPercentile( times, .95f );
+    summary.p99 = _getPercentile( times, .99f );
+    return summary;
+}
+
+std::ostream& operator << ( std::ostream& os, const Summary& summary )
+{
+    return os << "{ \"mean\": " << summary.mean << ", \"p50\": " << summary.p50
+              << ", \"p95\": " << summary.p95 << ", \"p99\": " << summary.p99
+              << " }";
+}
+}
+
+void Benchmark::start( const uint32_t frameNumber )
+{
+    LBASSERT( frameNumber > 0 );
+    lunchbox::ScopedWrite mutex( _lock );
+    _startFrame = frameNumber;
+}
+
+void Benchmark::stop( const uint32_t frameNumber )
+{
+    LBASSERT( frameNumber > _startFrame );
+    lunchbox::ScopedWrite mutex( _lock );
+    _endFrame = frameNumber;
+}
+
+void Benchmark::addFrameTime( const float time )
+{
+    if( isRecording( ))
+        _frameTimes.push_back( time );
+}
+
+void Benchmark::addStatistic( const eq::Statistic& statistic )
+{
+    if( statistic.type == eq::Statistic::NONE ||
+        statistic.type >= eq::Statistic::ALL )
+    {
+        return;
+    }
+
+    lunchbox::ScopedWrite mutex( _lock );
+    if( _startFrame == 0 || statistic.frameNumber < _startFrame ||
+        ( _endFrame > 0 && statistic.frameNumber >= _endFrame ))
+    {
+        return;
+    }
+
+    _stages[ statistic.type ][ statistic.frameNumber ] +=
+        float( statistic.endTime - statistic.startTime );
+}
+
+bool Benchmark::write( const std::string& filename, const uint32_t runs ) const
+{
+    lunchbox::ScopedWrite mutex( _lock );
+
+    const Summary frameTime = _summarize( _frameTimes );
+    std::cout << "Benchmark: " << _frameTimes.size() << " frames in " << runs
+              << " runs, frame time " << frameTime.mean << " ms mean, "
+              << frameTime.p50 << "/" << frameTime.p95 << "/" << frameTime.p99
+              << " ms p50/p95/p99" << std::endl;
+
+    std::ofstream file( filename.c_str( ));
+    if( !file.is_open( ))
+    {
+        LBERROR << "Can't open benchmark file " << filename << std::endl;
+        return false;
+    }
+
+    file << "{" << std::endl
+         << "  \"frames\": " << _frameTimes.size() << "," << std::endl
+         << "  \"runs\": " << runs << "," << std::endl
+         << "  \"frameTime\": " << frameTime << "," << std::endl
+         << "  \"stages\": {";
+
+    bool first = true;
+    for( size_t i = 0; i < eq::Statistic::ALL; ++i )
+    {
+        const StageTimes& stage = _stages[ i ];
+        if( stage.empty( ))
+            continue;
+
+        Times times;
+        times.reserve( stage.size( ));
+        for( StageTimes::const_iterator j = stage.begin(); j != stage.end();
+             ++j )
+        {
+            times.push_back( j->second );
+        }
+
+        const std::string& name =
+            eq::Statistic::getName( eq::Statistic::Type( i ));
+        const Summary summary = _summarize( times );
+        std::cout << "  " << name << ": " << summary.mean << " ms mean, "
+                  << summary.p50 << "/" << summary.p95 << "/" << summary.p99
+                  << " ms p50/p95/p99" << std::endl;
+
+        file << ( first ? "" : "," ) << std::endl
+             << "    \"" << name << "\": " << summary;
+        first = false;
+    }
+    file << std::endl << "  }" << std::endl << "}" << std::endl;
+    return file.good();
+}
+}
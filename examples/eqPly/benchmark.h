@@ -0,0 +1,85 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EQ_PLY_BENCHMARK_H
+#define EQ_PLY_BENCHMARK_H
+
+#include <eq/eq.h>
+
+#include <lunchbox/lock.h>
+#include <map>
+#include <vector>
+
+namespace eqPly
+{
+/**
+ * Collects the frame times and statistics of a benchmark run.
+ *
+ * The application loop records the frame times, the config adds all received
+ * statistics. Only the frames from start() up to stop() are recorded.
+ */
+class Benchmark
+{
+public:
+    Benchmark() : _startFrame( 0 ), _endFrame( 0 ) {}
+
+    /** Start recording with the given frame. */
+    void start( const uint32_t frameNumber );
+
+    /** Stop recording before the given frame. */
+    void stop( const uint32_t frameNumber );
+
+    /** @return true if start() was called and stop() was not. */
+    bool isRecording() const { return _startFrame > 0 && _endFrame == 0; }
+
+    /** @return true if stop() was called. */
+    bool isStopped() const { return _endFrame > 0; }
+
+    /** Record the time of one frame, in milliseconds, if recording. */
+    void addFrameTime( const float time );
+
+    /** Record a statistic of a recorded frame. Thread safe. */
+    void addStatistic( const eq::Statistic& statistic );
+
+    /** Print a summary and write it as JSON to the given file. */
+    bool write( const std::string& filename, const uint32_t runs ) const;
+
+private:
+    typedef std::vector< float > Times;
+    typedef std::map< uint32_t, float > StageTimes; //!< total time per frame
+
+    uint32_t _startFrame;
+    uint32_t _endFrame;
+    Times _frameTimes;
+
+    mutable lunchbox::Lock _lock;
+    StageTimes _stages[ eq::Statistic::ALL ];
+};
+}
+
+#endif // EQ_PLY_BENCHMARK_H
@@ -45,35 +45,55 @@ CameraAnimation::Step CameraAnimation::getNextStep()
     if( _steps.size() == 1 )
         return _steps[ _curStep ];
 
-    LBASSERT( _curStep < _steps.size()-1 );
+    _advance( _curStep, _curFrame );
+    return _interpolate( _curStep, _curFrame );
+}
+
+CameraAnimation::Step CameraAnimation::getStep( const uint32_t offset ) const
+{
+    if( _steps.size() < 2 )
+        return _steps.empty() ? Step() : _steps.front();
+
+    uint32_t step = _curStep;
+    int32_t frame = _curFrame;
+    for( uint32_t i = 0; i < offset; ++i )
+        _advance( step, frame );
+    return _interpolate( step, frame );
+}
+
+void CameraAnimation::_advance( uint32_t& step, int32_t& frame ) const
+{
+    LBASSERT( step < _steps.size()-1 );
 
-    ++_curFrame;
-    if( _curFrame > _steps[_curStep+1].frame )
+    ++frame;
+    if( frame > _steps[step+1].frame )
     {
-        if( _curStep == _steps.size()-2 )
+        if( step == _steps.size()-2 )
         {
-            _curFrame = 1;
-            _curStep  = 0;
+            frame = 1;
+            step  = 0;
         }
         else
-            ++_curStep;
+            ++step;
     }
-    //else
-    const Step& curStep  = _steps[ _curStep   ];
-    const Step& nextStep = _steps[ _curStep+1 ];
 
-    if( _curFrame < curStep.frame )
-        _curFrame = curStep.frame+1;
+    if( frame < _steps[ step ].frame )
+        frame = _steps[ step ].frame+1;
+}
+
+CameraAnimation::Step CameraAnimation::_interpolate( const uint32_t step,
+                                                     const int32_t frame ) const
+{
+    const Step& curStep  = _steps[ step   ];
+    const Step& nextStep = _steps[ step+1 ];
 
     const float interval  = float( nextStep.frame - curStep.frame );
-    const float curCoeff  = ( nextStep.frame - _curFrame ) / interval;
-    const float nextCoeff = ( _curFrame - curStep.frame ) / interval;
+    const float curCoeff  = ( nextStep.frame - frame ) / interval;
+    const float nextCoeff = ( frame - curStep.frame ) / interval;
 
-    Step result( _curFrame,
+    return Step( frame,
                  curStep.position * curCoeff + nextStep.position * nextCoeff,
                  curStep.rotation * curCoeff + nextStep.rotation * nextCoeff );
-
-    return result;
 }
 
 
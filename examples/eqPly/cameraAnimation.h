@@ -51,6 +51,9 @@ namespace eqPly
 
         Step getNextStep();
 
+        /** @return the step offset frames after the current one. */
+        Step getStep( const uint32_t offset ) const;
+
         uint32_t getCurrentFrame() { return _curFrame; }
 
         const eq::Vector3f& getModelRotation() const { return _modelRotation;}
@@ -74,6 +77,9 @@ namespace eqPly
         };
 
     private:
+        void _advance( uint32_t& step, int32_t& frame ) const;
+        Step _interpolate( const uint32_t step, const int32_t frame ) const;
+
         eq::Vector3f        _modelRotation;
         std::vector< Step > _steps;
         uint32_t            _curStep;
@@ -504,66 +504,9 @@ eq::Vector2f Channel::getJitter() const
     if( !view || view->getIdleSteps() != 256 )
         return eq::Vector2f::ZERO;
 
-    const eq::Vector2i jitterStep = _getJitterStep();
-    if( jitterStep == eq::Vector2i::ZERO )
-        return eq::Vector2f::ZERO;
-
-    const eq::PixelViewport& pvp = getPixelViewport();
-    const float pvp_w = float( pvp.w );
-    const float pvp_h = float( pvp.h );
-    const float frustum_w = float(( getFrustum().get_width( )));
-    const float frustum_h = float(( getFrustum().get_height( )));
-
-    const float pixel_w = frustum_w / pvp_w;
-    const float pixel_h = frustum_h / pvp_h;
-
-    const float sampleSize = 16.f; // sqrt( 256 )
-    const float subpixel_w = pixel_w / sampleSize;
-    const float subpixel_h = pixel_h / sampleSize;
-
-    // Sample value randomly computed within the subpixel
-    lunchbox::RNG rng;
-    const eq::Pixel& pixel = getPixel();
-
-    const float i = ( rng.get< float >() * subpixel_w +
-                      float( jitterStep.x( )) * subpixel_w ) / float( pixel.w );
-    const float j = ( rng.get< float >() * subpixel_h +
-                      float( jitterStep.y( )) * subpixel_h ) / float( pixel.h );
-
-    return eq::Vector2f( i, j );
-}
-
-static const uint32_t _primes[100] = {
-    739, 743, 751, 757, 761, 769, 773, 787, 797, 809, 811, 821, 823, 827, 829,
-    839, 853, 857, 859, 863, 877, 881, 883, 887, 907, 911, 919, 929, 937, 941,
-    947, 953, 967, 971, 977, 983, 991, 997, 1009, 1013, 1019, 1021, 1031, 1033,
-    1039, 1049, 1051, 1061, 1063, 1069, 1087, 1091, 1093, 1097, 1103, 1109,
-    1117, 1123, 1129, 1151, 1153, 1163, 1171, 1181, 1187, 1193, 1201, 1213,
-    1217, 1223, 1229, 1231, 1237, 1249, 1259, 1277, 1279, 1283, 1289, 1291,
-    1297, 1301, 1303, 1307, 1319, 1321, 1327, 1361, 1367, 1373, 1381, 1399,
-    1409, 1423, 1427, 1429, 1433, 1439, 1447, 1451 };
-
-eq::Vector2i Channel::_getJitterStep() const
-{
-    const eq::SubPixel& subPixel = getSubPixel();
-    const uint32_t channelID = subPixel.index;
-    const View* view = static_cast< const View* >( getView( ));
-    if( !view )
-        return eq::Vector2i::ZERO;
-
-    const uint32_t totalSteps = uint32_t( view->getIdleSteps( ));
-    if( totalSteps != 256 )
-        return eq::Vector2i::ZERO;
-
-    const Accum& accum = _accum[ lunchbox::getIndexOfLastBit( getEye()) ];
-    const uint32_t subset = totalSteps / getSubPixel().size;
-    const uint32_t index = ( accum.step * _primes[ channelID % 100 ] )%subset +
-                           ( channelID * subset );
-    const uint32_t sampleSize = 16;
-    const int dx = index % sampleSize;
-    const int dy = index / sampleSize;
-
-    return eq::Vector2i( dx, dy );
+    // consecutive samples are interleaved across the subpixel channels
+    const uint32_t step = uint32_t( view->getIdleSteps() - accum.step );
+    return getJitterSample( step + getSubPixel().index );
 }
 
 const Model* Channel::_getModel()
@@ -578,7 +521,7 @@ const Model* Channel::_getModel()
         id = frameData.getModelID();
     if( id != _modelID )
     {
-        _model = config->getModel( id );
+        _model = config->getModel( id, frameData.getModelFile( id ));
         _modelID = id;
     }
 
@@ -608,23 +551,58 @@ void Channel::_drawModel( const Model* scene )
                                                  frustum.compute_matrix();
     const eq::Matrix4f& view = getHeadTransform();
     const eq::Matrix4f model = rotation * position * modelRotation;
+    const eq::Matrix4f projectionView = projection * view;
 
-    state.setProjectionModelViewMatrix( projection * view * model );
+    state.setProjectionModelViewMatrix( projectionView * model );
     state.setRange( &getRange().start);
 
-    const eq::Pipe* pipe = getPipe();
+    const InitData& initData =
+        static_cast<Config*>( getConfig( ))->getInitData();
+    const eq::PixelViewport& pvp = getPixelViewport();
+    state.setLODThreshold( initData.getLODThreshold( ));
+    // all nodes are drawn while display lists and VBOs are created
+    state.setOcclusionCulling( initData.useOcclusionCulling() &&
+                               state.useFrustumCulling( ));
+    // reuse the cull front of the last frame or tile of this channel and eye
+    const char* key = reinterpret_cast< const char* >( this ) +
+                      lunchbox::getIndexOfLastBit( getEye( ));
+    state.setCullKey( key );
+    state.setViewportSize( float( pvp.w ), float( pvp.h ));
+
+    Pipe* pipe = static_cast< Pipe* >( getPipe( ));
     const GLuint program = state.getProgram( pipe );
     if( program != VertexBufferState::INVALID )
         glUseProgram( program );
 
-    scene->cullDraw( state );
+    // use the cull pass shared by all views of the pipe if it is still valid
+    const Model::DrawList* list = 0;
+    if( !state.useOcclusionCulling() && state.useFrustumCulling( ))
+        list = pipe->getDrawList( scene, key, projectionView, model, state );
+
+    if( list )
+        scene->drawList( state, *list );
+    else
+        scene->cullDraw( state );
+
+    // page in the data of a future frame of a camera animation
+    const eq::Matrix4f& prefetchCamera = frameData.getPrefetchCamera();
+    if( prefetchCamera != eq::Matrix4f::ZERO && state.useFrustumCulling( ))
+    {
+        Model::CullViews views( 1 );
+        views[0].pmv = projectionView * prefetchCamera * modelRotation;
+        views[0].range = state.getRange();
+        views[0].viewportSize[0] = float( pvp.w );
+        views[0].viewportSize[1] = float( pvp.h );
+
+        Model::DrawLists lists;
+        scene->cull( state, views, lists );
+        scene->prefetch( lists.front( ));
+    }
 
     state.setChannel( 0 );
     if( program != VertexBufferState::INVALID )
         glUseProgram( 0 );
 
-    const InitData& initData =
-        static_cast<Config*>( getConfig( ))->getInitData();
     if( initData.useROI( ))
         // declare empty region in case nothing is in frustum
         declareRegion( eq::PixelViewport( ));
@@ -81,9 +81,6 @@ namespace eqPly
         void _initJitter();
         bool _initAccum();
 
-        /** the subpixel for this step. */
-        eq::Vector2i _getJitterStep() const;
-
         const FrameData& _getFrameData() const;
         const Model*     _getModel();
 
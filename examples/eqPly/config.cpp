@@ -32,12 +32,18 @@
 #include "configEvent.h"
 #include "view.h"
 #include "modelAssigner.h"
+#include "modelLoader.h"
 
 #include <admin/addWindow.h>
 #include <admin/removeWindow.h>
 
 namespace eqPly
 {
+namespace
+{
+// number of frames the model data of a camera animation is prefetched ahead
+const uint32_t _prefetchFrames = 8;
+}
 
 Config::Config( eq::ServerPtr parent )
         : eq::Config( parent )
@@ -45,6 +51,8 @@ Config::Config( eq::ServerPtr parent )
         , _spinY( 5 )
         , _advance( 0 )
         , _currentCanvas( 0 )
+        , _idleCanvas( 0 )
+        , _idleRestoreLayout( 0 )
         , _messageTime( 0 )
         , _redraw( true )
         , _useIdleAA( true )
@@ -58,6 +66,13 @@ Config::~Config()
         delete *i;
     _models.clear();
 
+    for( ModelMap::const_iterator i = _mappedModels.begin();
+         i != _mappedModels.end(); ++i )
+    {
+        delete i->second;
+    }
+    _mappedModels.clear();
+
     for( ModelDistsCIter i = _modelDist.begin(); i != _modelDist.end(); ++i )
     {
         LBASSERT( !(*i)->isAttached() );
@@ -82,6 +97,11 @@ bool Config::init()
     _initData.setFrameDataID( _frameData.getID( ));
     registerObject( &_initData );
 
+    // load the models while the render clients are launched, only on the
+    // first config run
+    ModelLoader loader( _models.empty() ? _findModelFiles() : eq::Strings(),
+                        _initData );
+
     // init config
     if( !eq::Config::init( _initData.getID( )))
     {
@@ -89,7 +109,8 @@ bool Config::init()
         return false;
     }
 
-    _loadModels();
+    if( _models.empty( ))
+        _models = loader.getModels();
     _registerModels();
 
     const eq::Canvases& canvases = getCanvases();
@@ -97,6 +118,7 @@ bool Config::init()
         _currentCanvas = 0;
     else
         _currentCanvas = canvases.front();
+    _idleCanvas = 0;
 
     _setMessage( "Welcome to eqPly\nPress F1 for help" );
     return true;
@@ -129,11 +151,9 @@ static bool _isPlyfile( const std::string& filename )
 }
 }
 
-void Config::_loadModels()
+eq::Strings Config::_findModelFiles() const
 {
-    if( !_models.empty( )) // only load on the first config run
-        return;
-
+    eq::Strings plyFiles;
     eq::Strings filenames = _initData.getFilenames();
     while( !filenames.empty( ))
     {
@@ -141,20 +161,7 @@ void Config::_loadModels()
         filenames.pop_back();
 
         if( _isPlyfile( filename ))
-        {
-            Model* model = new Model;
-
-            if( _initData.useInvertedFaces() )
-                model->useInvertedFaces();
-
-            if( !model->readFromFile( filename.c_str( )))
-            {
-                LBWARN << "Can't load model: " << filename << std::endl;
-                delete model;
-            }
-            else
-                _models.push_back( model );
-        }
+            plyFiles.push_back( filename );
         else
         {
             const std::string basename = lunchbox::getFilename( filename );
@@ -168,6 +175,7 @@ void Config::_loadModels()
                 filenames.push_back( filename + '/' + *i );
         }
     }
+    return plyFiles;
 }
 
 void Config::_registerModels()
@@ -193,6 +201,7 @@ void Config::_registerModels()
         LBASSERT( modelDist->isAttached() );
 
         _frameData.setModelID( modelDist->getID( ));
+        _frameData.setModelFile( modelDist->getID(), model->getName( ));
     }
 
     LBASSERT( _modelDist.size() == nModels );
@@ -221,6 +230,7 @@ void Config::_deregisterData()
 
     _initData.setFrameDataID( eq::uint128_t( ));
     _frameData.setModelID( eq::uint128_t( ));
+    _frameData.clearModelFiles();
 }
 
 bool Config::loadInitData( const eq::uint128_t& id )
@@ -229,7 +239,8 @@ bool Config::loadInitData( const eq::uint128_t& id )
     return getClient()->syncObject( &_initData, getApplicationNode(), id );
 }
 
-const Model* Config::getModel( const eq::uint128_t& modelID )
+const Model* Config::getModel( const eq::uint128_t& modelID,
+                               const std::string& filename )
 {
     if( modelID == 0 )
         return 0;
@@ -249,6 +260,19 @@ const Model* Config::getModel( const eq::uint128_t& modelID )
             return _models[ i ];
     }
 
+    // map the binary cache shared by all processes on this host instead of
+    // receiving a private copy of the model
+    ModelMap::const_iterator i = _mappedModels.find( modelID );
+    if( i != _mappedModels.end( ))
+        return i->second;
+
+    Model* mapped = ModelLoader::mapCache( filename, _initData );
+    if( mapped )
+    {
+        _mappedModels[ modelID ] = mapped;
+        return mapped;
+    }
+
     _modelDist.push_back( new ModelDist );
     Model* model = _modelDist.back()->loadModel( getApplicationNode(),
                                                  getClient(), modelID );
@@ -278,9 +302,15 @@ void Config::_updateData()
         _frameData.setModelRotation( modelRotation);
         _frameData.setRotation( curStep.rotation );
         _frameData.setCameraPosition( curStep.position );
+
+        const CameraAnimation::Step& prefetchStep =
+            _animation.getStep( _prefetchFrames );
+        _frameData.setPrefetchCamera( prefetchStep.position,
+                                      prefetchStep.rotation );
     }
     else
     {
+        _frameData.clearPrefetchCamera();
         if( _frameData.usePilotMode())
             _frameData.spinCamera( -0.001f * _spinX, -0.001f * _spinY );
         else
@@ -297,6 +327,7 @@ void Config::_updateData()
     }
     else
         _frameData.setIdle( false );
+    _switchIdleLayout( _frameData.isIdle( ));
 
     _numFramesAA = 0;
 }
@@ -316,6 +347,14 @@ uint32_t Config::getAnimationFrame()
     return _animation.getCurrentFrame();
 }
 
+void Config::addStatistic( const uint32_t originator,
+                           const eq::Statistic& stat )
+{
+    if( _benchmark.isRecording( ))
+        _benchmark.addStatistic( stat );
+    eq::Config::addStatistic( originator, stat );
+}
+
 bool Config::_needNewFrame()
 {
     if( _messageTime > 0 )
@@ -971,6 +1010,48 @@ void Config::_adjustModelScale( const float factor )
     _setMessage( stream.str( ));
 }
 
+namespace
+{
+/** The name of the subpixel layout generated by auto-configuration. */
+const std::string _subpixelLayout( "Subpixel" );
+}
+
+void Config::_switchIdleLayout( const bool idle )
+{
+    // Spread the idle anti-aliasing samples over all GPUs of the subpixel
+    // layout, the channels account for the samples of each source.
+    if( idle )
+    {
+        if( _idleCanvas || !_currentCanvas )
+            return;
+
+        const eq::Layouts& layouts = _currentCanvas->getLayouts();
+        const uint32_t active = _currentCanvas->getActiveLayoutIndex();
+        for( size_t i = 0; i < layouts.size(); ++i )
+        {
+            if( !layouts[i] || layouts[i]->getName() != _subpixelLayout ||
+                i == active )
+            {
+                continue;
+            }
+            _idleCanvas = _currentCanvas;
+            _idleRestoreLayout = active;
+            _idleCanvas->useLayout( uint32_t( i ));
+            return;
+        }
+        return;
+    }
+
+    if( !_idleCanvas )
+        return;
+
+    // restore if the layout is still the one set above
+    const eq::Layout* layout = _idleCanvas->getActiveLayout();
+    if( layout && layout->getName() == _subpixelLayout )
+        _idleCanvas->useLayout( _idleRestoreLayout );
+    _idleCanvas = 0;
+}
+
 void Config::_switchLayout( int32_t increment )
 {
     if( !_currentCanvas )
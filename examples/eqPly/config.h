@@ -35,6 +35,7 @@
 #include "localInitData.h"
 #include "frameData.h"
 #include "cameraAnimation.h"
+#include "benchmark.h"
 
 #include <eq/eq.h>
 #include <eq/admin/base.h>
@@ -67,8 +68,13 @@ public:
     /** Map per-config data to the local node process */
     bool loadInitData( const eq::uint128_t& initDataID );
 
-    /** @return the requested, default model or 0. */
-    const Model* getModel( const eq::uint128_t& id );
+    /**
+     * @param id the identifier of the model distributor.
+     * @param filename the model file, to map its binary cache if present.
+     * @return the requested, default model or 0.
+     */
+    const Model* getModel( const eq::uint128_t& id,
+                           const std::string& filename = std::string( ));
 
     /** @sa eq::Config::handleEvent */
     virtual bool handleEvent( const eq::ConfigEvent* event );
@@ -83,6 +89,9 @@ public:
     /** @return the current animation frame number. */
     uint32_t getAnimationFrame();
 
+    /** @return the benchmark collecting the statistics of recorded frames. */
+    Benchmark& getBenchmark() { return _benchmark; }
+
 protected:
     virtual ~Config();
 
@@ -90,10 +99,16 @@ protected:
     virtual co::uint128_t sync(
         const co::uint128_t& version = co::VERSION_HEAD );
 
+    /** @sa eq::Config::addStatistic */
+    virtual void addStatistic( const uint32_t originator,
+                               const eq::Statistic& stat );
+
 private:
     int         _spinX, _spinY;
     int         _advance;
     eq::Canvas* _currentCanvas;
+    eq::Canvas* _idleCanvas; //!< uses its subpixel layout during idle AA
+    uint32_t _idleRestoreLayout; //!< layout index to use after idle AA
 
     LocalInitData _initData;
     FrameData     _frameData;
@@ -102,7 +117,11 @@ private:
     ModelDists _modelDist;
     lunchbox::Lock  _modelLock;
 
+    typedef std::map< eq::uint128_t, Model* > ModelMap;
+    ModelMap   _mappedModels; //!< models mapped from their binary cache
+
     CameraAnimation _animation;
+    Benchmark _benchmark;
 
     uint64_t _messageTime;
 
@@ -113,7 +132,7 @@ private:
 
     eq::admin::ServerPtr _admin;
 
-    void _loadModels();
+    eq::Strings _findModelFiles() const;
     void _registerModels();
     void _loadPath();
     void _deregisterData();
@@ -131,6 +150,7 @@ private:
     void _adjustResistance( const int delta );
     void _adjustModelScale( const float factor );
     void _switchLayout( int32_t increment );
+    void _switchIdleLayout( const bool idle );
     void _toggleEqualizer();
 
     void _setHeadMatrix( const eq::Matrix4f& matrix );
@@ -118,11 +118,36 @@ int EqPly::run()
     uint32_t maxFrames = _initData.getMaxFrames();
     int lastFrame = 0;
 
+    // benchmark: one warm-up run of the camera path, then the measured runs
+    const std::string& benchmarkFile = _initData.getBenchmarkFilename();
+    const uint32_t benchmarkRuns = _initData.getBenchmarkRuns();
+    bool benchmark = !benchmarkFile.empty() && benchmarkRuns > 0;
+    if( benchmark && _initData.getPathFilename().empty( ))
+    {
+        LBWARN << "Benchmark needs a camera path, ignoring --benchmark"
+               << std::endl;
+        benchmark = false;
+    }
+    Benchmark& results = config->getBenchmark();
+    uint32_t pathRuns = 0;
+    lunchbox::Clock frameClock;
+
     clock.reset();
     while( config->isRunning( ) && maxFrames-- )
     {
-        config->startFrame();
+        frameClock.reset();
+        const uint32_t frameNumber = config->startFrame();
+        if( benchmark && config->getAnimationFrame() == 1 )
+        {
+            ++pathRuns;
+            if( pathRuns == 2 )
+                results.start( frameNumber );
+            else if( pathRuns == benchmarkRuns + 2 )
+                results.stop( frameNumber );
+        }
+
         config->finishFrame();
+        results.addFrameTime( frameClock.getTimef( ));
 
         if( config->getAnimationFrame() == 1 )
         {
@@ -150,6 +175,9 @@ int EqPly::run()
             }
         }
         config->handleEvents(); // process all pending events
+
+        if( results.isStopped( ))
+            break;
     }
     const uint32_t frame = config->finishAllFrames();
     const float time = clock.resetTimef();
@@ -157,6 +185,9 @@ int EqPly::run()
     LBLOG( LOG_STATS ) << time << " ms for " << nFrames << " frames @ "
                        << ( nFrames / time * 1000.f) << " FPS)" << std::endl;
 
+    if( benchmark )
+        results.write( benchmarkFile, benchmarkRuns );
+
     // 5. exit config
     clock.reset();
     config->exit();
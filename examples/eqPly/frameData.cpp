@@ -36,6 +36,7 @@ FrameData::FrameData()
         : _rotation( eq::Matrix4f::ZERO )
         , _modelRotation( eq::Matrix4f::ZERO )
         , _position( eq::Vector3f::ZERO )
+        , _prefetchCamera( eq::Matrix4f::ZERO )
         , _renderMode( triply::RENDER_MODE_DISPLAY_LIST )
         , _colorMode( COLOR_MODEL )
         , _quality( 1.0f )
@@ -54,7 +55,7 @@ void FrameData::serialize( co::DataOStream& os, const uint64_t dirtyBits )
 {
     co::Serializable::serialize( os, dirtyBits );
     if( dirtyBits & DIRTY_CAMERA )
-        os << _position << _rotation << _modelRotation;
+        os << _position << _rotation << _modelRotation << _prefetchCamera;
     if( dirtyBits & DIRTY_FLAGS )
         os << _modelID << _renderMode << _colorMode << _quality << _ortho
            << _statistics << _help << _wireframe << _pilotMode << _idle
@@ -63,13 +64,22 @@ void FrameData::serialize( co::DataOStream& os, const uint64_t dirtyBits )
         os << _currentViewID;
     if( dirtyBits & DIRTY_MESSAGE )
         os << _message;
+    if( dirtyBits & DIRTY_MODELS )
+    {
+        os << uint64_t( _modelFiles.size( ));
+        for( ModelFiles::const_iterator i = _modelFiles.begin();
+             i != _modelFiles.end(); ++i )
+        {
+            os << i->first << i->second;
+        }
+    }
 }
 
 void FrameData::deserialize( co::DataIStream& is, const uint64_t dirtyBits )
 {
     co::Serializable::deserialize( is, dirtyBits );
     if( dirtyBits & DIRTY_CAMERA )
-        is >> _position >> _rotation >> _modelRotation;
+        is >> _position >> _rotation >> _modelRotation >> _prefetchCamera;
     if( dirtyBits & DIRTY_FLAGS )
         is >> _modelID >> _renderMode >> _colorMode >> _quality >> _ortho
            >> _statistics >> _help >> _wireframe >> _pilotMode >> _idle
@@ -78,6 +88,18 @@ void FrameData::deserialize( co::DataIStream& is, const uint64_t dirtyBits )
         is >> _currentViewID;
     if( dirtyBits & DIRTY_MESSAGE )
         is >> _message;
+    if( dirtyBits & DIRTY_MODELS )
+    {
+        uint64_t nModels = 0;
+        is >> nModels;
+        _modelFiles.clear();
+        for( uint64_t i = 0; i < nModels; ++i )
+        {
+            eq::uint128_t id;
+            is >> id;
+            is >> _modelFiles[ id ];
+        }
+    }
 }
 
 void FrameData::setModelID( const eq::uint128_t& id )
@@ -89,6 +111,32 @@ void FrameData::setModelID( const eq::uint128_t& id )
     setDirty( DIRTY_FLAGS );
 }
 
+void FrameData::setModelFile( const eq::uint128_t& id,
+                              const std::string& filename )
+{
+    std::string& current = _modelFiles[ id ];
+    if( current == filename )
+        return;
+
+    current = filename;
+    setDirty( DIRTY_MODELS );
+}
+
+void FrameData::clearModelFiles()
+{
+    if( _modelFiles.empty( ))
+        return;
+
+    _modelFiles.clear();
+    setDirty( DIRTY_MODELS );
+}
+
+std::string FrameData::getModelFile( const eq::uint128_t& id ) const
+{
+    ModelFiles::const_iterator i = _modelFiles.find( id );
+    return i == _modelFiles.end() ? std::string() : i->second;
+}
+
 void FrameData::setColorMode( const ColorMode mode )
 {
     _colorMode = mode;
@@ -235,6 +283,28 @@ void FrameData::setModelRotation(  const eq::Vector3f& rotation )
     setDirty( DIRTY_CAMERA );
 }
 
+void FrameData::setPrefetchCamera( const eq::Vector3f& position,
+                                   const eq::Vector3f& rotation )
+{
+    eq::Matrix4f translation = eq::Matrix4f::IDENTITY;
+    translation.set_translation( position );
+
+    _prefetchCamera = eq::Matrix4f::IDENTITY;
+    _prefetchCamera.rotate_x( rotation.x() );
+    _prefetchCamera.rotate_y( rotation.y() );
+    _prefetchCamera.rotate_z( rotation.z() );
+    _prefetchCamera = _prefetchCamera * translation;
+    setDirty( DIRTY_CAMERA );
+}
+
+void FrameData::clearPrefetchCamera()
+{
+    if( _prefetchCamera == eq::Matrix4f::ZERO )
+        return;
+    _prefetchCamera = eq::Matrix4f::ZERO;
+    setDirty( DIRTY_CAMERA );
+}
+
 void FrameData::reset()
 {
     eq::Matrix4f model = eq::Matrix4f::IDENTITY;
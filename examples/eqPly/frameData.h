@@ -55,6 +55,10 @@ public:
     //*{
     void setModelID( const eq::uint128_t& id );
 
+    /** Set the file of the given model, to map its cache on render nodes. */
+    void setModelFile( const eq::uint128_t& id, const std::string& filename );
+    void clearModelFiles();
+
     void setColorMode( const ColorMode color );
     void setRenderMode( const triply::RenderMode mode );
     void setIdle( const bool idleMode );
@@ -70,6 +74,8 @@ public:
     void toggleCompression();
 
     eq::uint128_t getModelID() const { return _modelID; }
+    /** @return the file of the given model, or an empty string. */
+    std::string getModelFile( const eq::uint128_t& id ) const;
     ColorMode getColorMode() const { return _colorMode; }
     float getQuality() const { return _quality; }
     bool useOrtho() const { return _ortho; }
@@ -91,12 +97,20 @@ public:
     void spinModel(  const float x, const float y, const float z );
     void moveCamera( const float x, const float y, const float z );
 
+    /** Set the camera of a future frame, to prefetch its model data. */
+    void setPrefetchCamera( const eq::Vector3f& position,
+                            const eq::Vector3f& rotation );
+    void clearPrefetchCamera();
+
     const eq::Matrix4f& getCameraRotation() const
         { return _rotation; }
     const eq::Matrix4f& getModelRotation() const
         { return _modelRotation; }
     const eq::Vector3f& getCameraPosition() const
         { return _position; }
+    /** @return the camera of a future frame, or ZERO if not known. */
+    const eq::Matrix4f& getPrefetchCamera() const
+        { return _prefetchCamera; }
     //*}
 
     /** @name View interface. */
@@ -127,13 +141,15 @@ protected:
         DIRTY_CAMERA  = co::Serializable::DIRTY_CUSTOM << 0,
         DIRTY_FLAGS   = co::Serializable::DIRTY_CUSTOM << 1,
         DIRTY_VIEW    = co::Serializable::DIRTY_CUSTOM << 2,
-        DIRTY_MESSAGE = co::Serializable::DIRTY_CUSTOM << 3
+        DIRTY_MESSAGE = co::Serializable::DIRTY_CUSTOM << 3,
+        DIRTY_MODELS  = co::Serializable::DIRTY_CUSTOM << 4
     };
 
 private:
     eq::Matrix4f _rotation;
     eq::Matrix4f _modelRotation;
     eq::Vector3f _position;
+    eq::Matrix4f _prefetchCamera; //!< rotation * translation, or ZERO
 
     eq::uint128_t    _modelID;
     triply::RenderMode  _renderMode;
@@ -149,6 +165,9 @@ private:
 
     eq::uint128_t _currentViewID;
     std::string _message;
+
+    typedef std::map< eq::uint128_t, std::string > ModelFiles;
+    ModelFiles _modelFiles;
 };
 }
 
@@ -54,6 +54,9 @@ InitData::InitData()
     , _invFaces( false )
     , _logo( true )
     , _roi ( true )
+    , _lodThreshold( 0.f )
+    , _occlusion( false )
+    , _quantize( false )
 {}
 
 InitData::~InitData()
@@ -64,13 +67,13 @@ InitData::~InitData()
 void InitData::getInstanceData( co::DataOStream& os )
 {
     os << _frameDataID << _windowSystem << _renderMode << _useGLSL << _invFaces
-       << _logo << _roi;
+       << _logo << _roi << _lodThreshold << _occlusion << _quantize;
 }
 
 void InitData::applyInstanceData( co::DataIStream& is )
 {
     is >> _frameDataID >> _windowSystem >> _renderMode >> _useGLSL >> _invFaces
-       >> _logo >> _roi;
+       >> _logo >> _roi >> _lodThreshold >> _occlusion >> _quantize;
     LBASSERT( _frameDataID != 0 );
 }
 
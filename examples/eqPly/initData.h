@@ -50,6 +50,9 @@ namespace eqPly
         bool               useInvertedFaces() const { return _invFaces; }
         bool               showLogo() const         { return _logo; }
         bool               useROI() const           { return _roi; }
+        float              getLODThreshold() const  { return _lodThreshold; }
+        bool               useOcclusionCulling() const { return _occlusion; }
+        bool               useQuantization() const  { return _quantize; }
 
     protected:
         virtual void getInstanceData( co::DataOStream& os );
@@ -63,6 +66,9 @@ namespace eqPly
         void enableInvertedFaces() { _invFaces = true; }
         void disableLogo()         { _logo     = false; }
         void disableROI()          { _roi      = false; }
+        void setLODThreshold( const float pixels ) { _lodThreshold = pixels; }
+        void enableOcclusionCulling() { _occlusion = true; }
+        void enableQuantization()  { _quantize = true; }
 
     private:
         eq::uint128_t      _frameDataID;
@@ -72,6 +78,9 @@ namespace eqPly
         bool               _invFaces;
         bool               _logo;
         bool               _roi;
+        float              _lodThreshold;
+        bool               _occlusion;
+        bool               _quantize;
     };
 }
 
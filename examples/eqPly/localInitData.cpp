@@ -45,6 +45,7 @@ namespace eqPly
 {
 LocalInitData::LocalInitData()
     : _pathFilename("")
+    , _benchmarkRuns( 3 )
     , _maxFrames( 0xffffffffu )
     , _color( true )
     , _isResident( false )
@@ -60,6 +61,8 @@ LocalInitData& LocalInitData::operator = ( const LocalInitData& from )
     _isResident  = from._isResident;
     _filenames    = from._filenames;
     _pathFilename = from._pathFilename;
+    _benchmarkFilename = from._benchmarkFilename;
+    _benchmarkRuns = from._benchmarkRuns;
 
     setWindowSystem( from.getWindowSystem( ));
     setRenderMode( from.getRenderMode( ));
@@ -71,6 +74,11 @@ LocalInitData& LocalInitData::operator = ( const LocalInitData& from )
         disableLogo();
     if( !from.useROI( ))
         disableROI();
+    setLODThreshold( from.getLODThreshold( ));
+    if( from.useOcclusionCulling( ))
+        enableOcclusionCulling();
+    if( from.useQuantization( ))
+        enableQuantization();
 
     return *this;
 }
@@ -101,6 +109,9 @@ void LocalInitData::parseArguments( const int argc, char** argv )
     bool userDefinedInvertFaces( false );
     bool userDefinedDisableLogo( false );
     bool userDefinedDisableROI( false );
+    float userDefinedLODThreshold( 0.f );
+    bool userDefinedOcclusion( false );
+    bool userDefinedQuantize( false );
 
     const std::string& desc = EqPly::getHelp();
     po::options_description options( desc + " Version " +
@@ -122,7 +133,7 @@ void LocalInitData::parseArguments( const int argc, char** argv )
         ( "windowSystem,w", po::value<std::string>( &userDefinedWindowSystem ),
           wsHelp.c_str() )
         ( "renderMode,c", po::value<std::string>( &userDefinedRenderMode ),
-          "Rendering Mode (immediate|displayList|VBO)" )
+          "Rendering Mode (immediate|displayList|VBO|multiDraw)" )
         ( "glsl,g",
           po::bool_switch(&userDefinedUseGLSL)->default_value( false ),
           "Enable GLSL shaders" )
@@ -131,12 +142,26 @@ void LocalInitData::parseArguments( const int argc, char** argv )
           "Invert faces (valid during binary file creation)" )
         ( "cameraPath,a", po::value<std::string>(&_pathFilename),
           "File containing camera path animation" )
+        ( "benchmark", po::value<std::string>( &_benchmarkFilename ),
+          "Run the camera path with statistics and write a summary to the "
+          "given JSON file" )
+        ( "benchmarkRuns",
+          po::value<uint32_t>( &_benchmarkRuns )->default_value( 3 ),
+          "Number of measured camera path runs after one warm-up run" )
         ( "noOverlay,o",
           po::bool_switch(&userDefinedDisableLogo)->default_value( false ),
           "Disable overlay logo" )
         ( "disableROI,d",
           po::bool_switch(&userDefinedDisableROI)->default_value( false ),
-          "Disable region of interest (ROI)" );
+          "Disable region of interest (ROI)" )
+        ( "lod,l", po::value<float>( &userDefinedLODThreshold ),
+          "Draw simplified subtrees below the given error in pixels" )
+        ( "occlusion",
+          po::bool_switch(&userDefinedOcclusion)->default_value( false ),
+          "Skip subtrees hidden in the last frame using occlusion queries" )
+        ( "quantize",
+          po::bool_switch(&userDefinedQuantize)->default_value( false ),
+          "Draw VBOs with 16 bit positions and normals, implies --glsl" );
 
     po::variables_map variableMap;
 
@@ -189,6 +214,8 @@ void LocalInitData::parseArguments( const int argc, char** argv )
             setRenderMode( triply::RENDER_MODE_DISPLAY_LIST );
         else if( userDefinedRenderMode == "vbo" )
             setRenderMode( triply::RENDER_MODE_BUFFER_OBJECT );
+        else if( userDefinedRenderMode == "multidraw" )
+            setRenderMode( triply::RENDER_MODE_MULTI_DRAW );
     }
 
     if( userDefinedUseGLSL )
@@ -202,6 +229,18 @@ void LocalInitData::parseArguments( const int argc, char** argv )
 
     if( userDefinedDisableROI )
         disableROI();
+
+    if( variableMap.count("lod") > 0 )
+        setLODThreshold( userDefinedLODThreshold );
+
+    if( userDefinedOcclusion )
+        enableOcclusionCulling();
+
+    if( userDefinedQuantize )
+    {
+        enableQuantization();
+        enableGLSL();
+    }
 }
 
 }
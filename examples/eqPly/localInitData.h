@@ -51,6 +51,13 @@ namespace eqPly
         bool               useColor()        const { return _color; }
         bool               isResident()      const { return _isResident; }
 
+        /** @return the JSON output file of the benchmark, or empty. */
+        const std::string& getBenchmarkFilename() const
+            { return _benchmarkFilename; }
+
+        /** @return the number of measured camera path runs. */
+        uint32_t getBenchmarkRuns() const { return _benchmarkRuns; }
+
         const std::vector< std::string >& getFilenames() const
             { return _filenames; }
 
@@ -59,6 +66,8 @@ namespace eqPly
     private:
         eq::Strings _filenames;
         std::string _pathFilename;
+        std::string _benchmarkFilename;
+        uint32_t    _benchmarkRuns;
         uint32_t    _maxFrames;
         bool        _color;
         bool        _isResident;
@@ -0,0 +1,167 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "modelLoader.h"
+
+#include "initData.h"
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+namespace eqPly
+{
+namespace
+{
+lunchbox::Lock _plyLock; //!< serializes the non-reentrant ply parser
+
+bool _hasCache( const std::string& filename )
+{
+    return std::ifstream( Model::getCacheFilename( filename ).c_str( ))
+               .is_open();
+}
+
+Model* _newModel( const InitData& initData )
+{
+    Model* model = new Model;
+    if( initData.useInvertedFaces( ))
+        model->useInvertedFaces();
+    if( initData.useQuantization( ))
+        model->useQuantization();
+    return model;
+}
+}
+
+class ModelLoaderThread : public lunchbox::Thread
+{
+public:
+    explicit ModelLoaderThread( ModelLoader& loader ) : _loader( loader ) {}
+    virtual ~ModelLoaderThread() {}
+
+protected:
+    bool init() override { setName( "ModelLoader" ); return true; }
+    void run() override { _loader._run(); }
+
+private:
+    ModelLoader& _loader;
+};
+
+ModelLoader::ModelLoader( const eq::Strings& filenames,
+                          const InitData& initData )
+    : _filenames( filenames )
+    , _initData( initData )
+    , _models( filenames.size(), 0 )
+    , _next( 0 )
+{
+    const size_t nThreads = std::min( _filenames.size(),
+        size_t( std::max( 1u, std::thread::hardware_concurrency( ))));
+    for( size_t i = 0; i < nThreads; ++i )
+    {
+        ModelLoaderThread* thread = new ModelLoaderThread( *this );
+        if( thread->start( ))
+            _threads.push_back( thread );
+        else
+            delete thread;
+    }
+
+    if( _threads.empty( )) // load in the caller's thread
+        _run();
+}
+
+ModelLoader::~ModelLoader()
+{
+    _join();
+    for( ModelsCIter i = _models.begin(); i != _models.end(); ++i )
+        delete *i;
+}
+
+Models ModelLoader::getModels()
+{
+    _join();
+
+    Models models;
+    for( ModelsCIter i = _models.begin(); i != _models.end(); ++i )
+        if( *i )
+            models.push_back( *i );
+    _models.clear();
+    return models;
+}
+
+Model* ModelLoader::mapCache( const std::string& filename,
+                              const InitData& initData )
+{
+    if( filename.empty() || !_hasCache( filename ))
+        return 0;
+
+    Model* model = _newModel( initData );
+    if( model->readFromFile( filename ))
+        return model;
+
+    delete model;
+    return 0;
+}
+
+void ModelLoader::_run()
+{
+    for( ;; )
+    {
+        const size_t i = size_t( _next++ );
+        if( i >= _filenames.size( ))
+            return;
+
+        const std::string& filename = _filenames[ i ];
+        Model* model = _newModel( _initData );
+
+        bool loaded = false;
+        if( _hasCache( filename ))
+            loaded = model->readFromFile( filename );
+        else
+        {
+            lunchbox::ScopedWrite mutex( _plyLock );
+            loaded = model->readFromFile( filename );
+        }
+
+        if( loaded )
+            _models[ i ] = model;
+        else
+        {
+            LBWARN << "Can't load model: " << filename << std::endl;
+            delete model;
+        }
+    }
+}
+
+void ModelLoader::_join()
+{
+    for( size_t i = 0; i < _threads.size(); ++i )
+    {
+        _threads[i]->join();
+        delete _threads[i];
+    }
+    _threads.clear();
+}
+}
@@ -0,0 +1,80 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EQ_PLY_MODELLOADER_H
+#define EQ_PLY_MODELLOADER_H
+
+#include "eqPly.h"
+
+namespace eqPly
+{
+class InitData;
+class ModelLoaderThread;
+
+/**
+ * Loads models with a pool of threads.
+ *
+ * Models with a binary cache are mapped in parallel. The ply parser is not
+ * reentrant, so models without a cache are converted one at a time.
+ */
+class ModelLoader
+{
+public:
+    /** Start loading the given ply files. */
+    ModelLoader( const eq::Strings& filenames, const InitData& initData );
+
+    /** Wait for the loader threads, deleting the models not taken. */
+    ~ModelLoader();
+
+    /**
+     * Wait until all models are loaded.
+     * @return the loaded models in file order, owned by the caller.
+     */
+    Models getModels();
+
+    /**
+     * Map the binary cache of a model, shared by all processes on this host.
+     * @return the model, or 0 if the model has no binary cache.
+     */
+    static Model* mapCache( const std::string& filename,
+                            const InitData& initData );
+
+private:
+    friend class ModelLoaderThread;
+
+    const eq::Strings _filenames;
+    const InitData& _initData;
+    Models _models; //!< one slot per file, 0 if loading failed
+    lunchbox::a_int32_t _next; //!< the next file to load
+    std::vector< ModelLoaderThread* > _threads;
+
+    void _run();
+    void _join();
+};
+}
+
+#endif // EQ_PLY_MODELLOADER_H
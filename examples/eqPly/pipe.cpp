@@ -32,6 +32,7 @@
 #include "pipe.h"
 
 #include "config.h"
+#include "vertexBufferState.h"
 #include <eq/eq.h>
 
 namespace eqPly
@@ -66,5 +67,79 @@ void Pipe::frameStart( const eq::uint128_t& frameID, const uint32_t frameNumber)
 {
     eq::Pipe::frameStart( frameID, frameNumber );
     _frameData.sync( frameID );
+
+    // forget views which did not draw in the last frame
+    for( SharedCulls::iterator i = _sharedCulls.begin();
+         i != _sharedCulls.end(); ++i )
+    {
+        SharedCull& cull = i->second;
+        cull.culled = false;
+        cull.lists.clear();
+        for( SharedViews::iterator j = cull.views.begin();
+             j != cull.views.end(); )
+        {
+            SharedView& view = j->second;
+            view.culled = false;
+            if( view.used )
+            {
+                view.used = false;
+                ++j;
+            }
+            else
+                cull.views.erase( j++ );
+        }
+    }
+}
+
+namespace
+{
+bool _equals( const Model::CullView& a, const Model::CullView& b )
+{
+    return a.pmv == b.pmv && a.range[0] == b.range[0] &&
+           a.range[1] == b.range[1] &&
+           a.viewportSize[0] == b.viewportSize[0] &&
+           a.viewportSize[1] == b.viewportSize[1];
+}
+}
+
+const Model::DrawList* Pipe::getDrawList( const Model* model, const void* key,
+                                       const eq::Matrix4f& projectionView,
+                                       const eq::Matrix4f& modelMatrix,
+                                       const triply::VertexBufferState& state )
+{
+    SharedCull& cull = _sharedCulls[ model ];
+
+    // a single view culls faster from its own cull front
+    if( !cull.culled && cull.views.size() > 1 )
+    {
+        Model::CullViews views;
+        views.reserve( cull.views.size( ));
+        for( SharedViews::iterator i = cull.views.begin();
+             i != cull.views.end(); ++i )
+        {
+            SharedView& view = i->second;
+            view.view = view.last;
+            view.view.pmv = view.last.pmv * modelMatrix;
+            view.index = views.size();
+            view.culled = true;
+            views.push_back( view.view );
+        }
+        model->cull( state, views, cull.lists );
+        cull.culled = true;
+    }
+
+    Model::CullView request;
+    request.pmv = projectionView * modelMatrix;
+    request.range = state.getRange();
+    request.viewportSize[0] = state.getViewportSize()[0];
+    request.viewportSize[1] = state.getViewportSize()[1];
+
+    SharedView& view = cull.views[ key ];
+    const Model::DrawList* list = view.culled && _equals( view.view, request ) ?
+                                      &cull.lists[ view.index ] : 0;
+    view.last = request;
+    view.last.pmv = projectionView;
+    view.used = true;
+    return list;
 }
 }
@@ -32,6 +32,9 @@
 #include <eq/eq.h>
 
 #include "frameData.h"
+#include "types.h"
+
+#include <map>
 
 namespace eqPly
 {
@@ -51,6 +54,29 @@ namespace eqPly
 
         const FrameData& getFrameData() const { return _frameData; }
 
+        /**
+         * Get the draw list of a view from the cull pass shared by all views
+         * of this pipe.
+         *
+         * The first request of a frame culls the model once for all views
+         * which requested it in the last frame, using their last projection
+         * and head transform with the given model matrix. The list is only
+         * returned if the view did not change since, otherwise the view has
+         * to cull itself. The view is registered for the next frame.
+         *
+         * @param model the model to draw.
+         * @param key the identifier of the view, e.g., the channel and eye.
+         * @param projectionView the projection * head transform of the view.
+         * @param modelMatrix the model transform of the current frame.
+         * @param state the render state with the range and viewport.
+         * @return the draw list, or 0 if the view has to cull itself.
+         */
+        const Model::DrawList*
+        getDrawList( const Model* model, const void* key,
+                     const eq::Matrix4f& projectionView,
+                     const eq::Matrix4f& modelMatrix,
+                     const triply::VertexBufferState& state ); state );
+
     protected:
         virtual ~Pipe() {}
 
@@ -62,6 +88,29 @@ namespace eqPly
 
     private:
         FrameData _frameData;
+
+        struct SharedView
+        {
+            SharedView() : index( 0 ), culled( false ), used( false ) {}
+
+            Model::CullView last; //!< of the last request, without the model
+            Model::CullView view; //!< as culled in the current frame
+            size_t index; //!< of the draw list in the current frame
+            bool culled; //!< part of the cull pass of the current frame
+            bool used; //!< requested since the last frame start
+        };
+        typedef std::map< const void*, SharedView > SharedViews;
+
+        struct SharedCull
+        {
+            SharedCull() : culled( false ) {}
+
+            SharedViews views;
+            Model::DrawLists lists;
+            bool culled; //!< in the current frame
+        };
+        typedef std::map< const Model*, SharedCull > SharedCulls;
+        SharedCulls _sharedCulls;
     };
 }
 
@@ -61,8 +61,17 @@ public:
     GLuint newBufferObject( const void* key ) override
         { return _objectManager.newBuffer( key ); }
 
+    void deleteBufferObject( const void* key ) override
+        { _objectManager.deleteBuffer( key ); }
+
+    GLuint getQuery( const void* key ) override
+        { return _objectManager.getQuery( key ); }
+
+    GLuint newQuery( const void* key ) override
+        { return _objectManager.newQuery( key ); }
+
     void deleteAll()  override
-        { _objectManager.deleteAll(); }
+        { _objectManager.deleteAll(); resetResidency(); }
 
     GLuint getProgram( const void* key )
         { return _objectManager.getProgram( key ); }
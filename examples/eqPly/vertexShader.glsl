@@ -32,18 +32,45 @@
 varying vec3 normalEye;
 varying vec4 positionEye;
 
+// dequantization of quantized leaves, w is 1 for quantized vertices
+uniform vec4 quantOffset;
+uniform vec3 quantScale;
+
+
+// decode an octahedral normal in [-1,1]^2
+vec3 decodeNormal( vec2 encoded )
+{
+    vec3 normal = vec3( encoded, 1.0 - abs( encoded.x ) - abs( encoded.y ));
+    if( normal.z < 0.0 )
+    {
+        vec2 signs = vec2( normal.x >= 0.0 ? 1.0 : -1.0,
+                           normal.y >= 0.0 ? 1.0 : -1.0 );
+        normal.xy = ( 1.0 - abs( normal.yx )) * signs;
+    }
+    return normalize( normal );
+}
+
 
 void main()
 {
+    // quantized positions are relative to the leaf bounding box, normals are
+    // passed as texture coordinates
+    vec4 vertex = gl_Vertex;
+    vec3 normal = gl_Normal;
+    if( quantOffset.w > 0.0 )
+    {
+        vertex = vec4( quantOffset.xyz + gl_Vertex.xyz * quantScale, 1.0 );
+        normal = decodeNormal( gl_MultiTexCoord0.xy / 32767.0 );
+    }
+
     // transform normal to eye coordinates
-    normalEye = normalize( gl_NormalMatrix * gl_Normal );
+    normalEye = normalize( gl_NormalMatrix * normal );
     
     // transform position to eye coordinates
-    positionEye = normalize( gl_ModelViewMatrix * gl_Vertex );
+    positionEye = normalize( gl_ModelViewMatrix * vertex );
     
     // transform position to screen coordinates
-    //gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
-    gl_Position = ftransform();
+    gl_Position = gl_ModelViewProjectionMatrix * vertex;
     
     // pass the vertex colors on to the fragment shader
     gl_FrontColor = gl_Color;
@@ -93,6 +93,16 @@ bool Window::configInitGL( const eq::uint128_t& initID )
     if( initData.useGLSL() )
         _loadShaders();
 
+    // the shader dequantizes the leaf vertices
+    const GLuint program = _state->getProgram( getPipe( ));
+    if( initData.useQuantization() && program != VertexBufferState::INVALID )
+    {
+        _state->setQuantizationUniforms(
+            glGetUniformLocation( program, "quantOffset" ),
+            glGetUniformLocation( program, "quantScale" ));
+        _state->setQuantization( true );
+    }
+
     return true;
 }
 
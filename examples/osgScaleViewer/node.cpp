@@ -103,11 +103,18 @@ bool Node::configInit( const eq::uint128_t& initID )
 
     if( !_model )
         _model = _createSceneGraph();
+
+    // PagedLOD children are loaded by the pager thread, requested during cull
+    _pager = osgDB::DatabasePager::create();
+    _pager->registerPagedLODs( _model.get( ));
     return true;
 }
 
 bool Node::configExit()
 {
+    if( _pager.valid( ))
+        _pager->cancel();
+    _pager = 0;
     _contextID = 0;
     _frameStamp = 0;
     _updateVisitor = 0;
@@ -124,6 +131,11 @@ void Node::frameStart( const eq::uint128_t& frameID,
     const double time = static_cast< double >( getConfig()->getTime( )) / 1000.;
     _frameStamp->setReferenceTime( time );
     _frameStamp->setSimulationTime( time );
+
+    // merge the subgraphs loaded in the background before the update
+    _pager->signalBeginFrame( _frameStamp.get( ));
+    _pager->updateSceneGraph( *_frameStamp );
+
     _updateVisitor->setTraversalNumber( frameNumber );
     _model->accept( *_updateVisitor );
     _model->getBound();
@@ -131,6 +143,13 @@ void Node::frameStart( const eq::uint128_t& frameID,
     eq::Node::frameStart( frameID, frameNumber );
 }
 
+void Node::frameFinish( const eq::uint128_t& frameID,
+                        const uint32_t frameNumber )
+{
+    _pager->signalEndFrame();
+    eq::Node::frameFinish( frameID, frameNumber );
+}
+
 osg::ref_ptr< osg::Node > Node::_createSceneGraph()
 {
     // init scene graph
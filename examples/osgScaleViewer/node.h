@@ -39,6 +39,7 @@
 #include <osg/Light>
 #include <osg/LightSource>
 #include <osg/Node>
+#include <osgDB/DatabasePager>
 
 namespace osgScaleViewer
 {
@@ -55,17 +56,23 @@ namespace osgScaleViewer
         osg::ref_ptr< osg::Node > getModel() { return _model; }
         osg::ref_ptr< osg::FrameStamp > getFrameStamp() { return _frameStamp; }
 
+        /** @return the pager loading the paged subgraphs of the model. */
+        osgDB::DatabasePager* getDatabasePager() { return _pager.get(); }
+
     protected:
         virtual bool configInit( const eq::uint128_t& initID );
         virtual bool configExit();
         virtual void frameStart( const eq::uint128_t& frameID,
                                  const uint32_t frameNumber );
+        virtual void frameFinish( const eq::uint128_t& frameID,
+                                  const uint32_t frameNumber );
 
     private:
         lunchbox::a_int32_t _contextID;
         osg::ref_ptr< osg::Node > _model;
         osg::ref_ptr< osg::FrameStamp > _frameStamp;
         osg::ref_ptr< osg::NodeVisitor > _updateVisitor;
+        osg::ref_ptr< osgDB::DatabasePager > _pager;
 
         osg::ref_ptr< osg::Node > _createSceneGraph();
         osg::ref_ptr< osg::Node > _createSceneGraph( osg::ref_ptr<osg::Image> );
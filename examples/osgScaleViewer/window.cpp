@@ -56,6 +56,8 @@ bool Window::configInitGL( const eq::uint128_t& initID )
         _sceneView->init();
         _sceneView->getState()->setContextID( node->getUniqueContextID( ));
         _sceneView->getRenderStage()->setColorMask( new osg::ColorMask );
+        _sceneView->getCullVisitor()->setDatabaseRequestHandler(
+            node->getDatabasePager( ));
 
         osg::ref_ptr< osg::Node > model = node->getModel();
         _sceneView->setSceneData( model );
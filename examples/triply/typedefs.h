@@ -84,6 +84,8 @@ typedef vmml::matrix< 4, 4, float >   Matrix4f;
 typedef vmml::vector< 4, float >      Vector4f;
 typedef size_t                        Index;
 typedef GLushort                      ShortIndex;
+typedef vmml::vector< 4, int16_t >    QuantizedVertex; // xyz, padding
+typedef vmml::vector< 2, int16_t >    QuantizedNormal; // octahedral
 
 // mesh exception
 struct MeshException : public std::exception
@@ -129,7 +131,16 @@ typedef ArrayWrapper< float, 2 >    Range;
 const Index             LEAF_SIZE( 21845 );
 
 // binary mesh file version, increment if changing the file format
-const unsigned short    FILE_VERSION( 0x0118 );
+const unsigned short    FILE_VERSION( 0x011b );
+
+// alignment of the vertex data arrays in the binary mesh file
+const size_t            ARRAY_ALIGNMENT( 16 );
+
+// range of the quantized vertex components, mapped to [-1,1]
+const float             QUANTIZATION_RANGE( 32767.f );
+
+// number of clustering cells per axis for the point proxies of inner nodes
+const size_t            PROXY_GRID_SIZE( 8 );
 
 // enumeration for the sort axis
 enum Axis
@@ -160,13 +171,15 @@ enum RenderMode
     RENDER_MODE_IMMEDIATE = 0,
     RENDER_MODE_DISPLAY_LIST,
     RENDER_MODE_BUFFER_OBJECT,
+    RENDER_MODE_MULTI_DRAW,
     RENDER_MODE_ALL // must be last
 };
 inline std::ostream& operator << ( std::ostream& os, const RenderMode mode )
 {
     os << ( mode == RENDER_MODE_IMMEDIATE     ? "immediate mode" :
             mode == RENDER_MODE_DISPLAY_LIST  ? "display list mode" :
-            mode == RENDER_MODE_BUFFER_OBJECT ? "VBO mode" : "ERROR" );
+            mode == RENDER_MODE_BUFFER_OBJECT ? "VBO mode" :
+            mode == RENDER_MODE_MULTI_DRAW    ? "multi draw mode" : "ERROR" );
     return os;
 }
 
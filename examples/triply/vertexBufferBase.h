@@ -34,6 +34,7 @@
 #include "api.h"
 #include "typedefs.h"
 #include <fstream>
+#include <vector>
 
 namespace eqPly
 {
@@ -62,6 +63,13 @@ public:
     virtual VertexBufferBase* getLeft() { return 0; }
     virtual VertexBufferBase* getRight() { return 0; }
 
+    /** @return the object space error of the node's proxy, 0 if none. */
+    virtual float getProxyError() const { return 0.f; }
+    /** Draw the simplified point proxy instead of the full subtree. */
+    virtual void drawProxy( VertexBufferState& ) const {}
+    /** Start paging in the mapped data of the subtree in the background. */
+    virtual void prefetch() const {}
+
     PLYLIB_API virtual const BoundingSphere& updateBoundingSphere() = 0;
 
 protected:
@@ -91,7 +99,16 @@ protected:
                             const size_t depth,
                             VertexBufferData& globalData ) = 0;
 
+    virtual void setupData( VertexData& data,
+                            VertexBufferData& globalData ) = 0;
+
+    virtual void setupProxy() = 0;
+    virtual void getProxyPoints( std::vector< Vertex >& vertices,
+                                 std::vector< Normal >& normals,
+                                 std::vector< Color >& colors ) const = 0;
+
     virtual void updateRange() = 0;
+    virtual void setupQuantization( VertexBufferData& globalData ) = 0;
 
     friend class VertexBufferDist;
     BoundingSphere  _boundingSphere;
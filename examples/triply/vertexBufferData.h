@@ -42,12 +42,17 @@ namespace triply
     class VertexBufferData
     {
     public:
+        VertexBufferData() { _clearMapping(); }
+
         void clear()
         {
             vertices.clear();
             colors.clear();
             normals.clear();
             indices.clear();
+            quantizedVertices.clear();
+            quantizedNormals.clear();
+            _clearMapping();
         }
         
         /*  Write the vectors' sizes and contents to the given stream.  */
@@ -57,6 +62,8 @@ namespace triply
             writeVector( os, colors );
             writeVector( os, normals );
             writeVector( os, indices );
+            writeVector( os, quantizedVertices );
+            writeVector( os, quantizedNormals );
         }
         
         /*  Read the vectors' sizes and contents from the given MMF address.  */
@@ -67,21 +74,105 @@ namespace triply
             readVector( addr, colors );
             readVector( addr, normals );
             readVector( addr, indices );
+            readVector( addr, quantizedVertices );
+            readVector( addr, quantizedNormals );
         }
+
+        /*  Reference the vectors' contents in the given MMF address. The
+            mapping has to stay valid until clear() is called, the contents
+            are paged in on first access.  */
+        void mapMemory( char** addr )
+        {
+            clear();
+            mapVector( addr, _vertices );
+            mapVector( addr, _colors );
+            mapVector( addr, _normals );
+            mapVector( addr, _indices );
+            mapVector( addr, _quantizedVertices );
+            mapVector( addr, _quantizedNormals );
+        }
+
+        /*  Accessors for owned or mapped data.  */
+        const Vertex* getVertices() const { return _get( vertices, _vertices );}
+        const Color* getColors() const { return _get( colors, _colors ); }
+        const Normal* getNormals() const { return _get( normals, _normals ); }
+        const ShortIndex* getIndices() const
+            { return _get( indices, _indices ); }
+
+        const QuantizedVertex* getQuantizedVertices() const
+            { return _get( quantizedVertices, _quantizedVertices ); }
+        const QuantizedNormal* getQuantizedNormals() const
+            { return _get( quantizedNormals, _quantizedNormals ); }
+
+        size_t getNumVertices() const
+            { return _vertices.data ? _vertices.size : vertices.size(); }
+        size_t getNumIndices() const
+            { return _indices.data ? _indices.size : indices.size(); }
+        bool hasColors() const
+            { return _colors.data ? _colors.size > 0 : !colors.empty(); }
+        bool hasQuantization() const
+            { return _quantizedVertices.size > 0 || !quantizedVertices.empty(); }
         
         std::vector< Vertex >       vertices;
         std::vector< Color >        colors;
         std::vector< Normal >       normals;
         std::vector< ShortIndex >   indices;
+
+        /*  Optional compressed layout, positions relative to the bounding box
+            of their leaf and octahedral normals, see VertexBufferLeaf.  */
+        std::vector< QuantizedVertex > quantizedVertices;
+        std::vector< QuantizedNormal > quantizedNormals;
         
     private:
-        /*  Helper function to write a vector to output stream.  */
+        /*  A read-only view of an array in the MMF.  */
+        template< class T > struct Mapped
+        {
+            const T* data;
+            size_t   size;
+        };
+
+        Mapped< Vertex >     _vertices;
+        Mapped< Color >      _colors;
+        Mapped< Normal >     _normals;
+        Mapped< ShortIndex > _indices;
+        Mapped< QuantizedVertex > _quantizedVertices;
+        Mapped< QuantizedNormal > _quantizedNormals;
+
+        void _clearMapping()
+        {
+            _vertices.data = 0;
+            _vertices.size = 0;
+            _colors.data = 0;
+            _colors.size = 0;
+            _normals.data = 0;
+            _normals.size = 0;
+            _indices.data = 0;
+            _indices.size = 0;
+            _quantizedVertices.data = 0;
+            _quantizedVertices.size = 0;
+            _quantizedNormals.data = 0;
+            _quantizedNormals.size = 0;
+        }
+
+        template< class T >
+        static const T* _get( const std::vector< T >& v, const Mapped< T >& m )
+        {
+            if( m.size > 0 )
+                return m.data;
+            return v.empty() ? 0 : &v[0];
+        }
+
+        /*  Helper function to write a vector to output stream, the contents
+            are aligned to ARRAY_ALIGNMENT bytes from the start of the file.  */
         template< class T >
         void writeVector( std::ostream& os, std::vector< T >& v )
         {
             size_t length = v.size();
             os.write( reinterpret_cast< char* >( &length ), 
                       sizeof( size_t ) );
+            const size_t pos = size_t( os.tellp( ));
+            const char padding[ ARRAY_ALIGNMENT ] = { 0 };
+            os.write( padding, _getPadding( pos ));
             if( length > 0 )
                 os.write( reinterpret_cast< char* >( &v[0] ), 
                           length * sizeof( T ) );
@@ -91,15 +182,27 @@ namespace triply
         template< class T >
         void readVector( char** addr, std::vector< T >& v )
         {
-            size_t length;
-            memRead( reinterpret_cast< char* >( &length ), addr, 
+            Mapped< T > mapped;
+            mapVector( addr, mapped );
+            v.assign( mapped.data, mapped.data + mapped.size );
+        }
+
+        /*  Helper function to reference a vector in the MMF address.  */
+        template< class T >
+        void mapVector( char** addr, Mapped< T >& m )
+        {
+            memRead( reinterpret_cast< char* >( &m.size ), addr,
                      sizeof( size_t ) );
-            if( length > 0 )
-            {
-                v.resize( length );
-                memRead( reinterpret_cast< char* >( &v[0] ), addr, 
-                         length * sizeof( T ) );
-            }
+            *addr += _getPadding( reinterpret_cast< size_t >( *addr ));
+            m.data = reinterpret_cast< const T* >( *addr );
+            *addr += m.size * sizeof( T );
+        }
+
+        /*  The MMF is page aligned, offsets and addresses align alike.  */
+        static size_t _getPadding( const size_t position )
+        {
+            return ( ARRAY_ALIGNMENT - position % ARRAY_ALIGNMENT ) %
+                   ARRAY_ALIGNMENT;
         }
     };
     
@@ -26,7 +26,6 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
-
 #include "vertexBufferDist.h"
 
 #include "vertexBufferLeaf.h"
@@ -34,6 +33,47 @@
 
 namespace triply
 {
+namespace
+{
+/* The maximum number of kd-tree nodes packed into one bulk blob. */
+const size_t BLOB_NODES = 4096;
+
+enum NodeTag
+{
+    TAG_NODE,
+    TAG_LEAF,
+    TAG_BLOB
+};
+
+size_t _countNodes( const VertexBufferBase* node )
+{
+    const VertexBufferBase* left = node->getLeft();
+    const VertexBufferBase* right = node->getRight();
+    if( !left || !right )
+        return 1;
+    return 1 + _countNodes( left ) + _countNodes( right );
+}
+
+/* Write the array without an intermediate copy, it may be mapped. */
+template< class T >
+void _writeArray( co::DataOStream& os, const T* data, const size_t size )
+{
+    os << uint64_t( size );
+    if( size > 0 )
+        os << co::Array< T >( const_cast< T* >( data ), size );
+}
+
+/* Read the array straight into the storage of the vector. */
+template< class T >
+void _readArray( co::DataIStream& is, std::vector< T >& vector )
+{
+    uint64_t size = 0;
+    is >> size;
+    vector.resize( size_t( size ));
+    if( size > 0 )
+        is >> co::Array< T >( &vector[0], size_t( size ));
+}
+}
 
 VertexBufferDist::VertexBufferDist()
     : _root( 0 )
@@ -41,15 +81,23 @@ VertexBufferDist::VertexBufferDist()
     , _left( 0 )
     , _right( 0 )
     , _isRoot( false )
+    , _isBulk( false )
 {}
 
-VertexBufferDist::VertexBufferDist( VertexBufferRoot* root )
+VertexBufferDist::VertexBufferDist( VertexBufferRoot* root, const bool bulk )
     : _root( root )
     , _node( root )
     , _left( 0 )
     , _right( 0 )
     , _isRoot( true )
+    , _isBulk( bulk )
 {
+    if( bulk )
+    {
+        _createBlobs( root );
+        return;
+    }
+
     if( root->getLeft( ))
         _left = new VertexBufferDist( root, root->getLeft( ));
 
@@ -64,6 +112,7 @@ VertexBufferDist::VertexBufferDist( VertexBufferRoot* root,
         , _left( 0 )
         , _right( 0 )
         , _isRoot( false )
+        , _isBulk( false )
 {
     if( !node )
         return;
@@ -75,12 +124,41 @@ VertexBufferDist::VertexBufferDist( VertexBufferRoot* root,
         _right = new VertexBufferDist( root, node->getRight( ));
 }
 
+VertexBufferDist::VertexBufferDist( VertexBufferRoot* root,
+                                    VertexBufferBase* node, const bool bulk )
+        : _root( root )
+        , _node( node )
+        , _left( 0 )
+        , _right( 0 )
+        , _isRoot( false )
+        , _isBulk( bulk )
+{}
+
 VertexBufferDist::~VertexBufferDist()
 {
     delete _left;
     _left = 0;
     delete _right;
     _right = 0;
+
+    for( Blobs::const_iterator i = _blobs.begin(); i != _blobs.end(); ++i )
+        delete *i;
+    _blobs.clear();
+}
+
+void VertexBufferDist::_createBlobs( VertexBufferBase* node )
+{
+    VertexBufferBase* children[2] = { node->getLeft(), node->getRight() };
+    if( !children[0] || !children[1] )
+        return;
+
+    for( size_t i = 0; i < 2; ++i )
+    {
+        if( _countNodes( children[i] ) <= BLOB_NODES )
+            _blobs.push_back( new VertexBufferDist( _root, children[i], true ));
+        else
+            _createBlobs( children[i] );
+    }
 }
 
 void VertexBufferDist::registerTree( co::LocalNodePtr node )
@@ -93,6 +171,9 @@ void VertexBufferDist::registerTree( co::LocalNodePtr node )
 
     if( _right )
         _right->registerTree( node );
+
+    for( Blobs::const_iterator i = _blobs.begin(); i != _blobs.end(); ++i )
+        LBCHECK( node->registerObject( *i ));
 }
 
 void VertexBufferDist::deregisterTree()
@@ -106,6 +187,9 @@ void VertexBufferDist::deregisterTree()
         _left->deregisterTree();
     if( _right )
         _right->deregisterTree();
+
+    for( Blobs::const_iterator i = _blobs.begin(); i != _blobs.end(); ++i )
+        (*i)->deregisterTree();
 }
 
 VertexBufferRoot* VertexBufferDist::loadModel( co::NodePtr master,
@@ -122,23 +206,65 @@ VertexBufferRoot* VertexBufferDist::loadModel( co::NodePtr master,
     return _root;
 }
 
+void VertexBufferDist::_writeRoot( co::DataOStream& os ) const
+{
+    LBASSERT( _root );
+    const VertexBufferData& data = _root->_data;
+    const size_t nVertices = data.getNumVertices();
+
+    _writeArray( os, data.getVertices(), nVertices );
+    _writeArray( os, data.getColors(), data.hasColors() ? nVertices : 0 );
+    _writeArray( os, data.getNormals(), nVertices );
+    _writeArray( os, data.getIndices(), data.getNumIndices( ));
+    const size_t nQuantized = data.hasQuantization() ? nVertices : 0;
+    _writeArray( os, data.getQuantizedVertices(), nQuantized );
+    _writeArray( os, data.getQuantizedNormals(), nQuantized );
+    os << _root->_name;
+}
+
+void VertexBufferDist::_readRoot( co::DataIStream& is )
+{
+    VertexBufferRoot* root = new VertexBufferRoot;
+    VertexBufferData& data = root->_data;
+
+    _readArray( is, data.vertices );
+    _readArray( is, data.colors );
+    _readArray( is, data.normals );
+    _readArray( is, data.indices );
+    _readArray( is, data.quantizedVertices );
+    _readArray( is, data.quantizedNormals );
+    is >> root->_name;
+
+    _root = root;
+}
+
 void VertexBufferDist::getInstanceData( co::DataOStream& os )
 {
     LBASSERT( _node );
-    os << _isRoot;
+    os << _isRoot << _isBulk;
+
+    if( _isBulk )
+    {
+        if( _isRoot )
+            _writeRoot( os );
+
+        size_t nextBlob = 0;
+        _writeTree( os, _node, nextBlob );
+        LBASSERT( nextBlob == _blobs.size( ));
+        return;
+    }
 
     if( _left && _right )
     {
         os << _left->getID() << _right->getID();
 
         if( _isRoot )
-        {
-            LBASSERT( _root );
-            const VertexBufferData& data = _root->_data;
+            _writeRoot( os );
 
-            os << data.vertices << data.colors << data.normals << data.indices
-               << _root->_name;
-        }
+        const VertexBufferNode* node =
+            static_cast< const VertexBufferNode* >( _node );
+        os << node->_proxyVertices << node->_proxyNormals << node->_proxyColors
+           << node->_proxyBox[0] << node->_proxyBox[1] << node->_proxyError;
     }
     else
     {
@@ -156,28 +282,78 @@ void VertexBufferDist::getInstanceData( co::DataOStream& os )
     os << _node->_boundingSphere << _node->_range;
 }
 
+void VertexBufferDist::_writeTree( co::DataOStream& os,
+                                   const VertexBufferBase* node,
+                                   size_t& nextBlob ) const
+{
+    if( nextBlob < _blobs.size() && _blobs[ nextBlob ]->_node == node )
+    {
+        os << uint8_t( TAG_BLOB ) << _blobs[ nextBlob ]->getID();
+        ++nextBlob;
+        return;
+    }
+
+    if( node->getLeft() && node->getRight( ))
+    {
+        const VertexBufferNode* inner =
+            static_cast< const VertexBufferNode* >( node );
+        os << uint8_t( TAG_NODE )
+           << inner->_proxyVertices << inner->_proxyNormals
+           << inner->_proxyColors << inner->_proxyBox[0] << inner->_proxyBox[1]
+           << inner->_proxyError << node->_boundingSphere << node->_range;
+
+        _writeTree( os, node->getLeft(), nextBlob );
+        _writeTree( os, node->getRight(), nextBlob );
+        return;
+    }
+
+    LBASSERT( dynamic_cast< const VertexBufferLeaf* >( node ));
+    const VertexBufferLeaf* leaf = static_cast< const VertexBufferLeaf* >( node );
+    os << uint8_t( TAG_LEAF )
+       << leaf->_boundingBox[0] << leaf->_boundingBox[1]
+       << uint64_t( leaf->_vertexStart ) << uint64_t( leaf->_indexStart )
+       << uint64_t( leaf->_indexLength ) << leaf->_vertexLength
+       << node->_boundingSphere << node->_range;
+}
+
 void VertexBufferDist::applyInstanceData( co::DataIStream& is )
 {
     LBASSERT( !_node );
 
+    is >> _isRoot >> _isBulk;
+
+    if( _isBulk )
+    {
+        BlobRefs refs;
+        if( _isRoot )
+        {
+            _readRoot( is );
+
+            uint8_t tag = TAG_LEAF;
+            is >> tag;
+            LBASSERT( tag == TAG_NODE );
+            _readNode( is, _root, refs );
+            _node = _root;
+        }
+        else
+            _readTree( is, _node, refs );
+
+        _mapBlobs( is, refs );
+        return;
+    }
+
     VertexBufferNode* node = 0;
     VertexBufferBase* base = 0;
 
     eq::uint128_t leftID, rightID;
-    is >> _isRoot >> leftID >> rightID;
+    is >> leftID >> rightID;
 
     if( leftID != 0 && rightID != 0 )
     {
         if( _isRoot )
         {
-            VertexBufferRoot* root = new VertexBufferRoot;
-            VertexBufferData& data = root->_data;
-
-            is >> data.vertices >> data.colors >> data.normals >> data.indices
-               >> root->_name;
-
-            node  = root;
-            _root = root;
+            _readRoot( is );
+            node = _root;
         }
         else
         {
@@ -185,6 +361,10 @@ void VertexBufferDist::applyInstanceData( co::DataIStream& is )
             node = new VertexBufferNode;
         }
 
+        is >> node->_proxyVertices >> node->_proxyNormals
+           >> node->_proxyColors >> node->_proxyBox[0] >> node->_proxyBox[1]
+           >> node->_proxyError;
+
         base   = node;
         _left  = new VertexBufferDist( _root, 0 );
         _right = new VertexBufferDist( _root, 0 );
@@ -220,4 +400,93 @@ void VertexBufferDist::applyInstanceData( co::DataIStream& is )
     _node = base;
 }
 
+void VertexBufferDist::_readTree( co::DataIStream& is, VertexBufferBase*& slot,
+                                  BlobRefs& refs )
+{
+    LBASSERT( _root );
+    uint8_t tag = TAG_LEAF;
+    is >> tag;
+
+    switch( tag )
+    {
+    case TAG_BLOB:
+    {
+        eq::uint128_t id;
+        is >> id;
+        slot = 0;
+        refs.push_back( BlobRef( id, &slot ));
+        return;
+    }
+    case TAG_NODE:
+    {
+        VertexBufferNode* node = new VertexBufferNode;
+        slot = node;
+        _readNode( is, node, refs );
+        return;
+    }
+    default:
+    {
+        LBASSERT( tag == TAG_LEAF );
+        VertexBufferLeaf* leaf = new VertexBufferLeaf( _root->_data );
+        slot = leaf;
+
+        uint64_t i1, i2, i3;
+        is >> leaf->_boundingBox[0] >> leaf->_boundingBox[1]
+           >> i1 >> i2 >> i3 >> leaf->_vertexLength
+           >> leaf->_boundingSphere >> leaf->_range;
+        leaf->_vertexStart = size_t( i1 );
+        leaf->_indexStart = size_t( i2 );
+        leaf->_indexLength = size_t( i3 );
+        return;
+    }
+    }
+}
+
+void VertexBufferDist::_readNode( co::DataIStream& is, VertexBufferNode* node,
+                                  BlobRefs& refs )
+{
+    is >> node->_proxyVertices >> node->_proxyNormals >> node->_proxyColors
+       >> node->_proxyBox[0] >> node->_proxyBox[1] >> node->_proxyError
+       >> node->_boundingSphere >> node->_range;
+
+    _readTree( is, node->_left, refs );
+    _readTree( is, node->_right, refs );
+}
+
+void VertexBufferDist::_mapBlobs( co::DataIStream& is, const BlobRefs& refs )
+{
+    if( refs.empty( ))
+        return;
+
+    // issue all requests before waiting on the first one
+    co::NodePtr from = is.getRemoteNode();
+    co::LocalNodePtr to = is.getLocalNode();
+    Blobs blobs;
+    std::vector< uint32_t > requests;
+    blobs.reserve( refs.size( ));
+    requests.reserve( refs.size( ));
+
+    for( BlobRefs::const_iterator i = refs.begin(); i != refs.end(); ++i )
+    {
+        VertexBufferDist* blob = new VertexBufferDist( _root, 0 );
+        blobs.push_back( blob );
+        requests.push_back( to->mapObjectNB( blob, i->id, co::VERSION_OLDEST,
+                                             from ));
+    }
+
+    // the blobs are only needed to transport the subtrees
+    for( size_t i = 0; i < blobs.size(); ++i )
+    {
+        VertexBufferDist* blob = blobs[i];
+        if( to->mapObjectSync( requests[i] ))
+        {
+            *refs[i].slot = blob->_node;
+            to->unmapObject( blob );
+        }
+        else
+            LBWARN << "Mapping of model subtree failed" << std::endl;
+        delete blob;
+    }
+}
+
 }
@@ -35,15 +35,23 @@
 #include "typedefs.h"
 
 #include <co/co.h>
+#include <vector>
 
 namespace triply
 {
-/** Uses co::Object to distribute a model, holds a VertexBufferBase node. */
+/**
+ * Uses co::Object to distribute a model, holds a VertexBufferBase node.
+ *
+ * In bulk mode the upper levels of the tree are serialized with the root, and
+ * each subtree below is packed into one blob object. Slaves map all blobs in
+ * one batch, instead of one object per node and tree level.
+ */
 class VertexBufferDist : public co::Object
 {
 public:
     PLYLIB_API VertexBufferDist();
-    PLYLIB_API VertexBufferDist( triply::VertexBufferRoot* root );
+    PLYLIB_API VertexBufferDist( triply::VertexBufferRoot* root,
+                                 bool bulk = true );
     PLYLIB_API virtual ~VertexBufferDist();
 
     PLYLIB_API void registerTree( co::LocalNodePtr node );
@@ -60,11 +68,37 @@ protected:
     PLYLIB_API virtual void applyInstanceData( co::DataIStream& is );
 
 private:
+    struct BlobRef
+    {
+        BlobRef( const eq::uint128_t& id_, VertexBufferBase** slot_ )
+            : id( id_ ), slot( slot_ ) {}
+        eq::uint128_t id;
+        VertexBufferBase** slot; //!< the child pointer of the parent node
+    };
+    typedef std::vector< BlobRef > BlobRefs;
+    typedef std::vector< VertexBufferDist* > Blobs;
+
+    VertexBufferDist( VertexBufferRoot* root, VertexBufferBase* node,
+                      bool bulk );
+
+    void _writeRoot( co::DataOStream& os ) const;
+    void _readRoot( co::DataIStream& is );
+    void _createBlobs( VertexBufferBase* node );
+    void _writeTree( co::DataOStream& os, const VertexBufferBase* node,
+                     size_t& nextBlob ) const;
+    void _readTree( co::DataIStream& is, VertexBufferBase*& slot,
+                    BlobRefs& refs );
+    void _readNode( co::DataIStream& is, VertexBufferNode* node,
+                    BlobRefs& refs );
+    void _mapBlobs( co::DataIStream& is, const BlobRefs& refs );
+
     VertexBufferRoot* _root;
     VertexBufferBase* _node;
     VertexBufferDist* _left;
     VertexBufferDist* _right;
+    Blobs _blobs; //!< the subtrees of a bulk root, in preorder
     bool _isRoot;
+    bool _isBulk;
 };
 }
 
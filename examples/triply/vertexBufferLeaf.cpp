@@ -32,18 +32,224 @@
 #include "vertexBufferData.h"
 #include "vertexBufferState.h"
 #include "vertexData.h"
+#include <algorithm>
+#include <cmath>
 #include <map>
+#ifndef _WIN32
+#   include <stdint.h>
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
 
 namespace triply
 {
+namespace
+{
+/*  Advise the OS to page in the given elements of mapped data.  */
+template< class T >
+void _willNeed( const T* data, const size_t start, const size_t length )
+{
+#ifndef _WIN32
+    if( !data || length == 0 )
+        return;
+    static const uintptr_t pageSize = uintptr_t( sysconf( _SC_PAGESIZE ));
+    const uintptr_t begin = uintptr_t( data + start ) & ~( pageSize - 1 );
+    const uintptr_t end = uintptr_t( data + start + length );
+    posix_madvise( reinterpret_cast< void* >( begin ), end - begin,
+                   POSIX_MADV_WILLNEED );
+#endif
+}
+
+// size of the simulated post-transform vertex cache
+const size_t VERTEX_CACHE_SIZE = 32;
+
+/*  Score of a vertex for the next triangle, after T. Forsyth, "Linear-Speed
+    Vertex Cache Optimisation". Recently used vertices and vertices with few
+    remaining triangles score high.  */
+float _vertexScore( const int cachePosition, const size_t nTriangles )
+{
+    if( nTriangles == 0 )
+        return -1.f;
+
+    float score = 0.f;
+    if( cachePosition >= 0 )
+    {
+        if( cachePosition < 3 ) // used by the last triangle
+            score = .75f;
+        else
+        {
+            const float scale = 1.f / float( VERTEX_CACHE_SIZE - 3 );
+            score = std::pow( 1.f - float( cachePosition - 3 ) * scale, 1.5f );
+        }
+    }
+    return score + 2.f / std::sqrt( float( nTriangles ));
+}
+
+/*  Reorder the triangles greedily for the post-transform vertex cache.  */
+void _optimizeVertexCache( Triangle* triangles, const Index nTriangles )
+{
+    // compact vertex ids and the remaining triangles of each vertex
+    std::map< Index, size_t > ids;
+    std::vector< size_t > corners( nTriangles * 3 );
+    std::vector< std::vector< Index > > vertexTriangles;
+    for( Index t = 0; t < nTriangles; ++t )
+    {
+        for( size_t v = 0; v < 3; ++v )
+        {
+            std::map< Index, size_t >::iterator i = ids.find( triangles[t][v] );
+            if( i == ids.end( ))
+            {
+                i = ids.insert( std::make_pair( triangles[t][v],
+                                                vertexTriangles.size( ))).first;
+                vertexTriangles.push_back( std::vector< Index >( ));
+            }
+            corners[ t * 3 + v ] = i->second;
+            vertexTriangles[ i->second ].push_back( t );
+        }
+    }
+
+    const size_t nVertices = vertexTriangles.size();
+    std::vector< int > cachePositions( nVertices, -1 );
+    std::vector< float > vertexScores( nVertices );
+    for( size_t v = 0; v < nVertices; ++v )
+        vertexScores[v] = _vertexScore( -1, vertexTriangles[v].size( ));
+
+    std::vector< float > triangleScores( nTriangles );
+    for( Index t = 0; t < nTriangles; ++t )
+        triangleScores[t] = vertexScores[ corners[ t * 3 ]] +
+                            vertexScores[ corners[ t * 3 + 1 ]] +
+                            vertexScores[ corners[ t * 3 + 2 ]];
+
+    std::vector< bool > added( nTriangles, false );
+    std::vector< Triangle > result;
+    result.reserve( nTriangles );
+    std::vector< size_t > cache; // most recently used first
+    Index next = 0; // next unadded triangle, if the cache has none left
+    Index best = nTriangles;
+
+    while( result.size() < nTriangles )
+    {
+        if( best == nTriangles )
+        {
+            while( added[ next ] )
+                ++next;
+            best = next;
+        }
+
+        added[ best ] = true;
+        result.push_back( triangles[ best ] );
+
+        // move the vertices of the triangle to the front of the cache
+        std::vector< size_t > newCache;
+        newCache.reserve( VERTEX_CACHE_SIZE + 3 );
+        for( size_t v = 0; v < 3; ++v )
+        {
+            const size_t vertex = corners[ best * 3 + v ];
+            std::vector< Index >& remaining = vertexTriangles[ vertex ];
+            const std::vector< Index >::iterator i =
+                std::find( remaining.begin(), remaining.end(), best );
+            if( i != remaining.end( ))
+                remaining.erase( i );
+            if( std::find( newCache.begin(), newCache.end(), vertex ) ==
+                newCache.end( ))
+            {
+                newCache.push_back( vertex );
+            }
+        }
+        for( size_t i = 0; i < cache.size(); ++i )
+            if( std::find( newCache.begin(), newCache.end(), cache[i] ) ==
+                newCache.end( ))
+            {
+                newCache.push_back( cache[i] );
+            }
+
+        // update the scores of the cached and evicted vertices and pick the
+        // best triangle using them
+        best = nTriangles;
+        float bestScore = -1.f;
+        for( size_t i = 0; i < newCache.size(); ++i )
+        {
+            const size_t vertex = newCache[i];
+            cachePositions[ vertex ] = i < VERTEX_CACHE_SIZE ? int( i ) : -1;
+            vertexScores[ vertex ] =
+                _vertexScore( cachePositions[ vertex ],
+                              vertexTriangles[ vertex ].size( ));
+        }
+        for( size_t i = 0; i < newCache.size(); ++i )
+        {
+            const std::vector< Index >& remaining =
+                vertexTriangles[ newCache[i] ];
+            for( size_t j = 0; j < remaining.size(); ++j )
+            {
+                const Index t = remaining[j];
+                triangleScores[t] = vertexScores[ corners[ t * 3 ]] +
+                                    vertexScores[ corners[ t * 3 + 1 ]] +
+                                    vertexScores[ corners[ t * 3 + 2 ]];
+                if( triangleScores[t] > bestScore )
+                {
+                    bestScore = triangleScores[t];
+                    best = t;
+                }
+            }
+        }
+
+        if( newCache.size() > VERTEX_CACHE_SIZE )
+            newCache.resize( VERTEX_CACHE_SIZE );
+        cache.swap( newCache );
+    }
+
+    std::copy( result.begin(), result.end(), triangles );
+}
+
+/*  Octahedral encoding of a unit normal into two components.  */
+QuantizedNormal _encodeNormal( const Normal& normal )
+{
+    const float length = std::abs( normal.x( )) + std::abs( normal.y( )) +
+                         std::abs( normal.z( ));
+    if( length <= 0.f )
+        return QuantizedNormal( 0, 0 );
+
+    float x = normal.x() / length;
+    float y = normal.y() / length;
+    if( normal.z() < 0.f ) // fold the lower hemisphere over the diagonals
+    {
+        const float foldedX = ( 1.f - std::abs( y )) * ( x >= 0.f ? 1.f : -1.f );
+        const float foldedY = ( 1.f - std::abs( x )) * ( y >= 0.f ? 1.f : -1.f );
+        x = foldedX;
+        y = foldedY;
+    }
+
+    return QuantizedNormal(
+        int16_t( std::floor( x * QUANTIZATION_RANGE + .5f )),
+        int16_t( std::floor( y * QUANTIZATION_RANGE + .5f )));
+}
+}
 
 /*  Finish partial setup - sort, reindex and merge into global data.  */
 void VertexBufferLeaf::setupTree( VertexData& data, const Index start,
                                   const Index length, const Axis axis,
                                   const size_t /*depth*/,
-                                  VertexBufferData& globalData )
+                                  VertexBufferData& /*globalData*/ )
 {
+    // may run concurrently for disjoint ranges, the vertex data is assembled
+    // in tree order by setupData. Until then, the index start and length hold
+    // the range in the triangle list.
     data.sort( start, length, axis );
+    _indexStart = start;
+    _indexLength = length;
+}
+
+/*  Copy the vertices and indices of the sorted triangle range.  */
+void VertexBufferLeaf::setupData( VertexData& data,
+                                  VertexBufferData& globalData )
+{
+    const Index start = _indexStart;
+    const Index length = _indexLength;
+
+    // vertices are copied in the order of their first use below
+    if( data.optimizeVertexCache() && length > 0 )
+        _optimizeVertexCache( &data.triangles[ start ], length );
+
     _vertexStart = globalData.vertices.size();
     _vertexLength = 0;
     _indexStart = globalData.indices.size();
@@ -92,16 +298,16 @@ const BoundingSphere& VertexBufferLeaf::updateBoundingSphere()
     // 3) Expand the sphere to contain all points outside.
 
 
+    const Vertex* vertices = _globalData.getVertices() + _vertexStart;
+    const ShortIndex* indices = _globalData.getIndices() + _indexStart;
+
     // 1a) initialize and compute a bounding box
-    _boundingBox[0] = _globalData.vertices[ _vertexStart +
-                                            _globalData.indices[_indexStart] ];
-    _boundingBox[1] = _globalData.vertices[ _vertexStart +
-                                            _globalData.indices[_indexStart] ];
+    _boundingBox[0] = vertices[ indices[0] ];
+    _boundingBox[1] = vertices[ indices[0] ];
 
-    for( Index i = 1 + _indexStart; i < _indexStart + _indexLength; ++i )
+    for( Index i = 1; i < _indexLength; ++i )
     {
-        const Vertex& vertex = _globalData.vertices[ _vertexStart +
-                                                     _globalData.indices[ i ] ];
+        const Vertex& vertex = vertices[ indices[ i ]];
         _boundingBox[0][0] = std::min( _boundingBox[0][0], vertex[0] );
         _boundingBox[1][0] = std::max( _boundingBox[1][0], vertex[0] );
         _boundingBox[0][1] = std::min( _boundingBox[0][1], vertex[1] );
@@ -128,9 +334,7 @@ const BoundingSphere& VertexBufferLeaf::updateBoundingSphere()
     // 2) test all points to be in the estimated bounding sphere
     for( Index offset = 0; offset < _indexLength; ++offset )
     {
-        const Vertex& vertex =
-            _globalData.vertices[ _vertexStart +
-                                  _globalData.indices[_indexStart + offset] ];
+        const Vertex& vertex = vertices[ indices[ offset ]];
 
         const Vertex centerToPoint   = vertex - center;
         const float  distanceSquared = centerToPoint.squared_length();
@@ -157,9 +361,7 @@ const BoundingSphere& VertexBufferLeaf::updateBoundingSphere()
     // 2a) re-test all points to be in the estimated bounding sphere
     for( Index offset = 0; offset < _indexLength; ++offset )
     {
-        const Vertex& vertex =
-            _globalData.vertices[ _vertexStart +
-                                  _globalData.indices[_indexStart + offset] ];
+        const Vertex& vertex = vertices[ indices[ offset ]];
 
         const Vertex centerToPoint   = vertex - center;
         const float  distanceSquared = centerToPoint.squared_length();
@@ -185,11 +387,28 @@ const BoundingSphere& VertexBufferLeaf::updateBoundingSphere()
 }
 
 
+/*  Provide all vertices of the leaf for the proxy of the parent.  */
+void VertexBufferLeaf::getProxyPoints( std::vector< Vertex >& vertices,
+                                       std::vector< Normal >& normals,
+                                       std::vector< Color >& colors ) const
+{
+    const Vertex* vertexData = _globalData.getVertices() + _vertexStart;
+    const Normal* normalData = _globalData.getNormals() + _vertexStart;
+    vertices.insert( vertices.end(), vertexData, vertexData + _vertexLength );
+    normals.insert( normals.end(), normalData, normalData + _vertexLength );
+    if( _globalData.hasColors( ))
+    {
+        const Color* colorData = _globalData.getColors() + _vertexStart;
+        colors.insert( colors.end(), colorData, colorData + _vertexLength );
+    }
+}
+
+
 /*  Compute the range of this child.  */
 void VertexBufferLeaf::updateRange()
 {
-    _range[0] = 1.0f * _indexStart / _globalData.indices.size();
-    _range[1] = _range[0] + 1.0f * _indexLength / _globalData.indices.size();
+    _range[0] = 1.0f * _indexStart / _globalData.getNumIndices();
+    _range[1] = _range[0] + 1.0f * _indexLength / _globalData.getNumIndices();
 
 #ifndef NDEBUG
     PLYLIBINFO << "updateRange" << "( " << _range[0] << ", " << _range[1]
@@ -197,6 +416,49 @@ void VertexBufferLeaf::updateRange()
 #endif
 }
 
+/*  Quantize the positions relative to the bounding box, which maps to the
+    quantization range, and encode the normals octahedrally.  */
+void VertexBufferLeaf::setupQuantization( VertexBufferData& globalData )
+{
+    Vertex offset, scale;
+    getQuantization( offset, scale );
+
+    const Vertex* vertices = _globalData.getVertices() + _vertexStart;
+    const Normal* normals = _globalData.getNormals() + _vertexStart;
+    QuantizedVertex* quantizedVertices =
+        &globalData.quantizedVertices[ _vertexStart ];
+    QuantizedNormal* quantizedNormals =
+        &globalData.quantizedNormals[ _vertexStart ];
+
+    for( Index i = 0; i < _vertexLength; ++i )
+    {
+        QuantizedVertex& quantized = quantizedVertices[i];
+        for( size_t j = 0; j < 3; ++j )
+        {
+            const float value = ( vertices[i][j] - offset[j] ) / scale[j];
+            quantized[j] = int16_t( std::floor(
+                std::max( -QUANTIZATION_RANGE,
+                          std::min( QUANTIZATION_RANGE, value )) + .5f ));
+        }
+        quantized[3] = 0;
+        quantizedNormals[i] = _encodeNormal( normals[i] );
+    }
+}
+
+/*  The dequantization of the leaf, vertex = offset + quantized * scale.  */
+void VertexBufferLeaf::getQuantization( Vertex& offset, Vertex& scale ) const
+{
+    offset = ( _boundingBox[0] + _boundingBox[1] ) * .5f;
+    scale = ( _boundingBox[1] - _boundingBox[0] ) * ( .5f / QUANTIZATION_RANGE );
+    for( size_t i = 0; i < 3; ++i )
+        scale[i] = std::max( scale[i], std::numeric_limits< float >::min( ));
+}
+
+bool VertexBufferLeaf::useQuantization( const VertexBufferState& state ) const
+{
+    return state.useQuantization() && _globalData.hasQuantization();
+}
+
 #define glewGetContext state.glewGetContext
 
 /*  Set up rendering of the leaf nodes.  */
@@ -211,18 +473,33 @@ void VertexBufferLeaf::setupRendering( VertexBufferState& state,
     case RENDER_MODE_BUFFER_OBJECT:
     {
         const char* charThis = reinterpret_cast< const char* >( this );
+        const bool quantized = useQuantization( state );
 
         if( data[VERTEX_OBJECT] == state.INVALID )
             data[VERTEX_OBJECT] = state.newBufferObject( charThis + 0 );
         glBindBuffer( GL_ARRAY_BUFFER, data[VERTEX_OBJECT] );
-        glBufferData( GL_ARRAY_BUFFER, _vertexLength * sizeof( Vertex ),
-                        &_globalData.vertices[_vertexStart], GL_STATIC_DRAW );
+        if( quantized )
+            glBufferData( GL_ARRAY_BUFFER,
+                          _vertexLength * sizeof( QuantizedVertex ),
+                          _globalData.getQuantizedVertices() + _vertexStart,
+                          GL_STATIC_DRAW );
+        else
+            glBufferData( GL_ARRAY_BUFFER, _vertexLength * sizeof( Vertex ),
+                          _globalData.getVertices() + _vertexStart,
+                          GL_STATIC_DRAW );
 
         if( data[NORMAL_OBJECT] == state.INVALID )
             data[NORMAL_OBJECT] = state.newBufferObject( charThis + 1 );
         glBindBuffer( GL_ARRAY_BUFFER, data[NORMAL_OBJECT] );
-        glBufferData( GL_ARRAY_BUFFER, _vertexLength * sizeof( Normal ),
-                        &_globalData.normals[_vertexStart], GL_STATIC_DRAW );
+        if( quantized )
+            glBufferData( GL_ARRAY_BUFFER,
+                          _vertexLength * sizeof( QuantizedNormal ),
+                          _globalData.getQuantizedNormals() + _vertexStart,
+                          GL_STATIC_DRAW );
+        else
+            glBufferData( GL_ARRAY_BUFFER, _vertexLength * sizeof( Normal ),
+                          _globalData.getNormals() + _vertexStart,
+                          GL_STATIC_DRAW );
 
         if( data[COLOR_OBJECT] == state.INVALID )
             data[COLOR_OBJECT] = state.newBufferObject( charThis + 2 );
@@ -230,15 +507,17 @@ void VertexBufferLeaf::setupRendering( VertexBufferState& state,
         {
             glBindBuffer( GL_ARRAY_BUFFER, data[COLOR_OBJECT] );
             glBufferData( GL_ARRAY_BUFFER, _vertexLength * sizeof( Color ),
-                            &_globalData.colors[_vertexStart], GL_STATIC_DRAW );
+                          _globalData.getColors() + _vertexStart,
+                          GL_STATIC_DRAW );
         }
 
         if( data[INDEX_OBJECT] == state.INVALID )
             data[INDEX_OBJECT] = state.newBufferObject( charThis + 3 );
         glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, data[INDEX_OBJECT] );
         glBufferData( GL_ELEMENT_ARRAY_BUFFER,
-                        _indexLength * sizeof( ShortIndex ),
-                        &_globalData.indices[_indexStart], GL_STATIC_DRAW );
+                      _indexLength * sizeof( ShortIndex ),
+                      _globalData.getIndices() + _indexStart,
+                      GL_STATIC_DRAW );
 
         break;
     }
@@ -261,6 +540,24 @@ void VertexBufferLeaf::setupRendering( VertexBufferState& state,
 }
 
 /*  Draw the leaf.  */
+void VertexBufferLeaf::prefetch() const
+{
+    const QuantizedVertex* quantized = _globalData.getQuantizedVertices();
+    if( quantized )
+    {
+        _willNeed( quantized, _vertexStart, _vertexLength );
+        _willNeed( _globalData.getQuantizedNormals(), _vertexStart,
+                   _vertexLength );
+    }
+    else
+    {
+        _willNeed( _globalData.getVertices(), _vertexStart, _vertexLength );
+        _willNeed( _globalData.getNormals(), _vertexStart, _vertexLength );
+    }
+    _willNeed( _globalData.getColors(), _vertexStart, _vertexLength );
+    _willNeed( _globalData.getIndices(), _indexStart, _indexLength );
+}
+
 void VertexBufferLeaf::draw( VertexBufferState& state ) const
 {
     if( state.stopRendering( ))
@@ -275,6 +572,10 @@ void VertexBufferLeaf::draw( VertexBufferState& state ) const
       case RENDER_MODE_BUFFER_OBJECT:
           renderBufferObject( state );
           return;
+      case RENDER_MODE_MULTI_DRAW:
+          // drawn from the packed buffers of the root in _endRendering
+          state.addDrawCommand( _indexStart, _indexLength, _vertexStart );
+          return;
       case RENDER_MODE_DISPLAY_LIST:
       default:
           renderDisplayList( state );
@@ -301,12 +602,43 @@ void VertexBufferLeaf::renderBufferObject( VertexBufferState& state ) const
         glBindBuffer( GL_ARRAY_BUFFER, buffers[COLOR_OBJECT] );
         glColorPointer( 3, GL_UNSIGNED_BYTE, 0, 0 );
     }
-    glBindBuffer( GL_ARRAY_BUFFER, buffers[NORMAL_OBJECT] );
-    glNormalPointer( GL_FLOAT, 0, 0 );
-    glBindBuffer( GL_ARRAY_BUFFER, buffers[VERTEX_OBJECT] );
-    glVertexPointer( 3, GL_FLOAT, 0, 0 );
+
+    const bool quantized = useQuantization( state );
+    if( quantized )
+    {
+        glBindBuffer( GL_ARRAY_BUFFER, buffers[NORMAL_OBJECT] );
+        glTexCoordPointer( 2, GL_SHORT, 0, 0 );
+        glBindBuffer( GL_ARRAY_BUFFER, buffers[VERTEX_OBJECT] );
+        glVertexPointer( 3, GL_SHORT, sizeof( QuantizedVertex ), 0 );
+
+        Vertex offset, scale;
+        getQuantization( offset, scale );
+        const GLint* uniforms = state.getQuantizationUniforms();
+        glUniform4f( uniforms[0], offset[0], offset[1], offset[2], 1.f );
+        glUniform3f( uniforms[1], scale[0], scale[1], scale[2] );
+    }
+    else
+    {
+        glBindBuffer( GL_ARRAY_BUFFER, buffers[NORMAL_OBJECT] );
+        glNormalPointer( GL_FLOAT, 0, 0 );
+        glBindBuffer( GL_ARRAY_BUFFER, buffers[VERTEX_OBJECT] );
+        glVertexPointer( 3, GL_FLOAT, 0, 0 );
+    }
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, buffers[INDEX_OBJECT] );
     glDrawElements( GL_TRIANGLES, GLsizei(_indexLength), GL_UNSIGNED_SHORT, 0 );
+
+    // proxies and other models are not quantized
+    if( quantized )
+        glUniform4f( state.getQuantizationUniforms()[0], 0.f, 0.f, 0.f, 0.f );
+
+    const size_t vertexSize = ( quantized ?
+                                sizeof( QuantizedVertex ) +
+                                sizeof( QuantizedNormal ) :
+                                sizeof( Vertex ) + sizeof( Normal )) +
+                              ( state.useColors() ? sizeof( Color ) : 0 );
+    state.updateResidency( reinterpret_cast< const char* >( this ), 4,
+                           _vertexLength * vertexSize +
+                           _indexLength * sizeof( ShortIndex ));
 }
 
 
@@ -331,14 +663,19 @@ void VertexBufferLeaf::renderDisplayList( VertexBufferState& state ) const
 inline
 void VertexBufferLeaf::renderImmediate( VertexBufferState& state ) const
 {
+    const ShortIndex* indices = _globalData.getIndices() + _indexStart;
+    const Vertex* vertices = _globalData.getVertices();
+    const Normal* normals = _globalData.getNormals();
+    const Color* colors = _globalData.getColors();
+
     glBegin( GL_TRIANGLES );
     for( Index offset = 0; offset < _indexLength; ++offset )
     {
-        const Index i =_vertexStart + _globalData.indices[_indexStart + offset];
+        const Index i =_vertexStart + indices[ offset ];
         if( state.useColors() )
-            glColor3ubv( &_globalData.colors[i][0] );
-        glNormal3fv( &_globalData.normals[i][0] );
-        glVertex3fv( &_globalData.vertices[i][0] );
+            glColor3ubv( &colors[i][0] );
+        glNormal3fv( &normals[i][0] );
+        glVertex3fv( &vertices[i][0] );
     }
     glEnd();
 }
@@ -45,6 +45,7 @@ public:
 
     virtual void draw( VertexBufferState& state ) const;
     virtual Index getNumberOfVertices() const { return _indexLength; }
+    virtual void prefetch() const;
 
 protected:
     virtual void toStream( std::ostream& os );
@@ -54,10 +55,18 @@ protected:
                             const Index length, const Axis axis,
                             const size_t depth,
                             VertexBufferData& globalData );
+    virtual void setupData( VertexData& data, VertexBufferData& globalData );
+    virtual void setupProxy() {}
+    virtual void getProxyPoints( std::vector< Vertex >& vertices,
+                                 std::vector< Normal >& normals,
+                                 std::vector< Color >& colors ) const;
     virtual const BoundingSphere& updateBoundingSphere();
     virtual void updateRange();
+    virtual void setupQuantization( VertexBufferData& globalData );
 
 private:
+    void getQuantization( Vertex& offset, Vertex& scale ) const;
+    bool useQuantization( const VertexBufferState& state ) const;
     void setupRendering( VertexBufferState& state, GLuint* data ) const;
     void renderImmediate( VertexBufferState& state ) const;
     void renderDisplayList( VertexBufferState& state ) const;
@@ -32,6 +32,7 @@
 #include "vertexBufferLeaf.h"
 #include "vertexBufferState.h"
 #include "vertexData.h"
+#include <cmath>
 #include <set>
 
 namespace triply
@@ -51,6 +52,31 @@ inline static bool _subdivide( const Index length, const size_t depth )
     return ( length / 2 > LEAF_SIZE ) || ( depth < 3 && length > 1 );
 }
 
+/*  Subtrees with at least this many triangles are built by a separate task. */
+static const Index TASK_SIZE = LEAF_SIZE * 16;
+
+/*  Helper function to write a proxy vector to output stream.  */
+template< class T >
+static void _writeVector( std::ostream& os, std::vector< T >& v )
+{
+    size_t length = v.size();
+    os.write( reinterpret_cast< char* >( &length ), sizeof( size_t ));
+    if( length > 0 )
+        os.write( reinterpret_cast< char* >( &v[0] ), length * sizeof( T ));
+}
+
+/*  Helper function to read a proxy vector from the MMF address.  */
+template< class T >
+static void _readVector( char** addr, std::vector< T >& v )
+{
+    size_t length;
+    memRead( reinterpret_cast< char* >( &length ), addr, sizeof( size_t ));
+    v.resize( length );
+    if( length > 0 )
+        memRead( reinterpret_cast< char* >( &v[0] ), addr,
+                 length * sizeof( T ));
+}
+
 /*  Continue kd-tree setup, create intermediary or leaf nodes as required.  */
 void VertexBufferNode::setupTree( VertexData& data, const Index start,
                                   const Index length, const Axis axis,
@@ -63,7 +89,7 @@ void VertexBufferNode::setupTree( VertexData& data, const Index start,
              << depth << " )." << std::endl;
 #endif
 
-    data.sort( start, length, axis );
+    data.partition( start, length, axis );
     const Index median = start + ( length / 2 );
 
     // left child will include elements smaller than the median
@@ -91,13 +117,147 @@ void VertexBufferNode::setupTree( VertexData& data, const Index start,
     const Axis newAxisRight = subdivideRight ? 
                         data.getLongestAxis( median, rightLength ) : AXIS_X;
 
-    static_cast< VertexBufferNode* >
-            ( _left )->setupTree( data, start, leftLength, newAxisLeft, depth+1,
-                                  globalData );
-    static_cast< VertexBufferNode* >
-        ( _right )->setupTree( data, median, rightLength, newAxisRight, depth+1,
-                               globalData );
+    // both children work on disjoint ranges and can be built concurrently
+    VertexBufferNode* left = static_cast< VertexBufferNode* >( _left );
+    VertexBufferNode* right = static_cast< VertexBufferNode* >( _right );
+#pragma omp task if( leftLength >= TASK_SIZE )
+    left->setupTree( data, start, leftLength, newAxisLeft, depth+1,
+                     globalData );
+#pragma omp task if( rightLength >= TASK_SIZE )
+    right->setupTree( data, median, rightLength, newAxisRight, depth+1,
+                      globalData );
+#pragma omp taskwait
+}
 
+
+/*  Assemble the vertex data of the children in tree order.  */
+void VertexBufferNode::setupData( VertexData& data,
+                                  VertexBufferData& globalData )
+{
+    static_cast< VertexBufferNode* >( _left )->setupData( data, globalData );
+    static_cast< VertexBufferNode* >( _right )->setupData( data, globalData );
+}
+
+
+/*  Cluster the children's points into a regular grid over the subtree.  */
+void VertexBufferNode::setupProxy()
+{
+    static_cast< VertexBufferNode* >( _left )->setupProxy();
+    static_cast< VertexBufferNode* >( _right )->setupProxy();
+
+    std::vector< Vertex > vertices;
+    std::vector< Normal > normals;
+    std::vector< Color > colors;
+    static_cast< VertexBufferNode* >( _left )->getProxyPoints( vertices,
+                                                               normals,
+                                                               colors );
+    static_cast< VertexBufferNode* >( _right )->getProxyPoints( vertices,
+                                                                normals,
+                                                                colors );
+
+    const size_t size = PROXY_GRID_SIZE;
+    const size_t nCells = size * size * size;
+    const Vertex center( _boundingSphere.array );
+    const float radius = std::max( _boundingSphere.w(), 1e-6f );
+    const Vertex origin = center - Vertex( radius );
+    const float cellSize = 2.f * radius / float( size );
+    const bool hasColors = colors.size() == vertices.size();
+
+    std::vector< Vertex > positionSums( nCells, Vertex( 0.f ));
+    std::vector< Normal > normalSums( nCells, Normal( 0.f ));
+    std::vector< Vertex > colorSums( nCells, Vertex( 0.f ));
+    std::vector< size_t > counts( nCells, 0 );
+
+    for( size_t i = 0; i < vertices.size(); ++i )
+    {
+        size_t cell = 0;
+        for( size_t j = 0; j < 3; ++j )
+        {
+            const float pos = ( vertices[i][j] - origin[j] ) / cellSize;
+            const size_t index = std::min( size_t( std::max( pos, 0.f )),
+                                           size - 1 );
+            cell = cell * size + index;
+        }
+        positionSums[ cell ] += vertices[i];
+        normalSums[ cell ] += normals[i];
+        if( hasColors )
+            colorSums[ cell ] += Vertex( colors[i][0], colors[i][1],
+                                         colors[i][2] );
+        ++counts[ cell ];
+    }
+
+    _proxyVertices.clear();
+    _proxyNormals.clear();
+    _proxyColors.clear();
+    for( size_t i = 0; i < nCells; ++i )
+    {
+        if( counts[i] == 0 )
+            continue;
+
+        const float weight = 1.f / float( counts[i] );
+        const Vertex position = positionSums[i] * weight;
+        Normal normal = normalSums[i];
+        if( normal.squared_length() > 0.f )
+            normal.normalize();
+
+        if( _proxyVertices.empty( ))
+        {
+            _proxyBox[0] = position;
+            _proxyBox[1] = position;
+        }
+        for( size_t j = 0; j < 3; ++j )
+        {
+            _proxyBox[0][j] = std::min( _proxyBox[0][j], position[j] );
+            _proxyBox[1][j] = std::max( _proxyBox[1][j], position[j] );
+        }
+
+        _proxyVertices.push_back( position );
+        _proxyNormals.push_back( normal );
+        if( hasColors )
+        {
+            const Vertex color = colorSums[i] * weight;
+            _proxyColors.push_back( Color( uint8_t( color[0] ),
+                                           uint8_t( color[1] ),
+                                           uint8_t( color[2] )));
+        }
+    }
+
+    // each point represents vertices within one cell diagonal
+    _proxyError = _proxyVertices.empty() ? 0.f : cellSize * std::sqrt( 3.f );
+}
+
+
+/*  Provide the proxy points for the proxy of the parent.  */
+void VertexBufferNode::getProxyPoints( std::vector< Vertex >& vertices,
+                                       std::vector< Normal >& normals,
+                                       std::vector< Color >& colors ) const
+{
+    vertices.insert( vertices.end(), _proxyVertices.begin(),
+                     _proxyVertices.end( ));
+    normals.insert( normals.end(), _proxyNormals.begin(),
+                    _proxyNormals.end( ));
+    colors.insert( colors.end(), _proxyColors.begin(), _proxyColors.end( ));
+}
+
+
+/*  Draw the point proxy of the subtree.  */
+void VertexBufferNode::drawProxy( VertexBufferState& state ) const
+{
+    if( state.stopRendering( ))
+        return;
+
+    state.updateRegion( _proxyBox );
+    const bool useColors = state.useColors() && !_proxyColors.empty();
+
+    glBegin( GL_POINTS );
+    for( size_t i = 0; i < _proxyVertices.size(); ++i )
+    {
+        if( useColors )
+            glColor3ubv( &_proxyColors[i][0] );
+        glNormal3fv( &_proxyNormals[i][0] );
+        glVertex3fv( &_proxyVertices[i][0] );
+    }
+    glEnd();
 }
 
 
@@ -132,6 +292,14 @@ const BoundingSphere& VertexBufferNode::updateBoundingSphere()
 }
 
 
+/*  Quantize the vertices of the children.  */
+void VertexBufferNode::setupQuantization( VertexBufferData& globalData )
+{
+    static_cast< VertexBufferNode* >( _left )->setupQuantization( globalData );
+    static_cast< VertexBufferNode* >( _right )->setupQuantization( globalData );
+}
+
+
 /*  Compute the range from the children's ranges.  */
 void VertexBufferNode::updateRange()
 {
@@ -171,6 +339,12 @@ void VertexBufferNode::fromMemory( char** addr, VertexBufferData& globalData )
         throw MeshException( "Error reading binary file. Expected a regular "
                              "node, but found something else instead." );
     VertexBufferBase::fromMemory( addr, globalData );
+    _readVector( addr, _proxyVertices );
+    _readVector( addr, _proxyNormals );
+    _readVector( addr, _proxyColors );
+    memRead( reinterpret_cast< char* >( &_proxyBox ), addr,
+             sizeof( BoundingBox ));
+    memRead( reinterpret_cast< char* >( &_proxyError ), addr, sizeof( float ));
     
     // read left child (peek ahead)
     memRead( reinterpret_cast< char* >( &nodeType ), addr, sizeof( size_t ) );
@@ -204,6 +378,11 @@ void VertexBufferNode::toStream( std::ostream& os )
     size_t nodeType = NODE_TYPE;
     os.write( reinterpret_cast< char* >( &nodeType ), sizeof( size_t ) );
     VertexBufferBase::toStream( os );
+    _writeVector( os, _proxyVertices );
+    _writeVector( os, _proxyNormals );
+    _writeVector( os, _proxyColors );
+    os.write( reinterpret_cast< char* >( &_proxyBox ), sizeof( BoundingBox ));
+    os.write( reinterpret_cast< char* >( &_proxyError ), sizeof( float ));
     static_cast< VertexBufferNode* >( _left )->toStream( os );
     static_cast< VertexBufferNode* >( _right )->toStream( os );
 }
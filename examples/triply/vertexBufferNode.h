@@ -39,7 +39,7 @@ namespace triply
 class VertexBufferNode : public VertexBufferBase
 {
 public:
-    VertexBufferNode() : _left( 0 ), _right( 0 ) {}
+    VertexBufferNode() : _left( 0 ), _right( 0 ), _proxyError( 0.f ) {}
     PLYLIB_API virtual ~VertexBufferNode();
 
     PLYLIB_API void draw( VertexBufferState& state ) const override;
@@ -51,6 +51,11 @@ public:
     VertexBufferBase* getLeft() override { return _left; }
     VertexBufferBase* getRight() override { return _right; }
 
+    float getProxyError() const override { return _proxyError; }
+    PLYLIB_API void drawProxy( VertexBufferState& state ) const override;
+    void prefetch() const override
+        { _left->prefetch(); _right->prefetch(); }
+
 protected:
     PLYLIB_API void toStream( std::ostream& os ) override;
     PLYLIB_API void fromMemory( char** addr, VertexBufferData& globalData )
@@ -60,13 +65,29 @@ protected:
                                const Index length, const Axis axis,
                                const size_t depth,
                                VertexBufferData& globalData ) override;
+    PLYLIB_API void setupData( VertexData& data, VertexBufferData& globalData )
+        override;
+    PLYLIB_API void setupProxy() override;
+    PLYLIB_API void getProxyPoints( std::vector< Vertex >& vertices,
+                                    std::vector< Normal >& normals,
+                                    std::vector< Color >& colors ) const
+        override;
     PLYLIB_API const BoundingSphere& updateBoundingSphere() override;
     PLYLIB_API void updateRange() override;
+    PLYLIB_API void setupQuantization( VertexBufferData& globalData )
+        override;
 
 private:
     friend class VertexBufferDist;
     VertexBufferBase*   _left;
     VertexBufferBase*   _right;
+
+    // clustered point representation of the subtree
+    std::vector< Vertex > _proxyVertices;
+    std::vector< Normal > _proxyNormals;
+    std::vector< Color >  _proxyColors;
+    BoundingBox           _proxyBox;
+    float                 _proxyError; //!< object space error of the proxy
 };
 }
 #endif // PLYLIB_VERTEXBUFFERNODE_H
@@ -31,6 +31,10 @@
 #include "vertexBufferRoot.h"
 #include "vertexBufferState.h"
 #include "vertexData.h"
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <set>
 #include <string>
 #include <sstream>
 #include <fcntl.h>
@@ -45,6 +49,166 @@ namespace triply
 
 typedef vmml::frustum_culler< float >  FrustumCuller;
 
+namespace
+{
+/*  Draws node proxies whose projected error is below the LOD threshold.  */
+class ProxySelector
+{
+public:
+    explicit ProxySelector( const VertexBufferState& state )
+        : _pmv( state.getProjectionModelViewMatrix( ))
+        , _range( state.getRange( ))
+        , _threshold( state.getLODThreshold( ))
+    {
+        _setup( state.getViewportSize( ));
+    }
+
+    ProxySelector( const VertexBufferState& state,
+                   const VertexBufferRoot::CullView& view )
+        : _pmv( view.pmv )
+        , _range( view.range )
+        , _threshold( state.getLODThreshold( ))
+    {
+        _setup( view.viewportSize );
+    }
+
+    /** @return the clip space w of the sphere center. */
+    float getW( const BoundingSphere& sphere ) const
+    {
+        return _pmv( 3, 0 ) * sphere.x() + _pmv( 3, 1 ) * sphere.y() +
+               _pmv( 3, 2 ) * sphere.z() + _pmv( 3, 3 );
+    }
+
+    /** @return the distance of the sphere to the eye, <= 0 if it is cut. */
+    float getDistance( const BoundingSphere& sphere ) const
+        { return getW( sphere ) - sphere.w() * _wScale; }
+
+    /**
+     * Select the proxy if the node is fully in range and its projected error
+     * is below the threshold.
+     * @return true if the proxy is to be drawn, with its error in pixels.
+     */
+    bool select( const VertexBufferBase* node, float& pixels ) const
+    {
+        const float proxyError = node->getProxyError();
+        if( _threshold <= 0.f || proxyError <= 0.f ||
+            node->getRange()[0] < _range[0] || node->getRange()[1] >= _range[1])
+        {
+            return false;
+        }
+
+        const float distance = getDistance( node->getBoundingSphere( ));
+        if( distance <= 0.f )
+            return false;
+
+        pixels = proxyError * _pixelScale / distance;
+        return pixels < _threshold;
+    }
+
+    /** Draw the selected proxy of the node with the given pixel error. */
+    static void draw( const VertexBufferBase* node, const float pixels,
+                      VertexBufferState& state )
+    {
+        glPointSize( std::max( pixels, 1.f ));
+        node->drawProxy( state );
+    }
+
+    /** @return true if the proxy was selected and drawn. */
+    bool draw( const VertexBufferBase* node, VertexBufferState& state ) const
+    {
+        float pixels = 0.f;
+        if( !select( node, pixels ))
+            return false;
+        draw( node, pixels, state );
+        return true;
+    }
+
+private:
+    const Matrix4f& _pmv;
+    const Range& _range;
+    const float _threshold;
+    float _pixelScale;
+    float _wScale;
+
+    void _setup( const float* viewportSize )
+    {
+        // scale factors from object space error to pixels
+        const Vertex xAxis( _pmv( 0, 0 ), _pmv( 0, 1 ), _pmv( 0, 2 ));
+        const Vertex yAxis( _pmv( 1, 0 ), _pmv( 1, 1 ), _pmv( 1, 2 ));
+        const Vertex wAxis( _pmv( 3, 0 ), _pmv( 3, 1 ), _pmv( 3, 2 ));
+        _pixelScale = std::max( xAxis.length() * viewportSize[0],
+                                yAxis.length() * viewportSize[1] ) * .5f;
+        _wScale = wAxis.length();
+    }
+};
+
+/*  How the traversal continues at a kd-tree node.  */
+enum Cull
+{
+    CULL_SKIP,  //!< invisible or out of range
+    CULL_DRAW,  //!< draw the full subtree
+    CULL_PROXY, //!< draw the LOD proxy of the subtree
+    CULL_SPLIT  //!< traverse the children
+};
+
+/*  Classifies nodes against the frustum, range and LOD of a state.  */
+class NodeCuller
+{
+public:
+    explicit NodeCuller( const VertexBufferState& state )
+        : _range( state.getRange( ))
+        , _proxies( state )
+        , _useFrustumCulling( state.useFrustumCulling( ))
+    {
+        _culler.setup( state.getProjectionModelViewMatrix( ));
+    }
+
+    NodeCuller( const VertexBufferState& state,
+                const VertexBufferRoot::CullView& view )
+        : _range( view.range )
+        , _proxies( state, view )
+        , _useFrustumCulling( state.useFrustumCulling( ))
+    {
+        _culler.setup( view.pmv );
+    }
+
+    Cull classify( const VertexBufferBase* node, float& pixels ) const
+    {
+        // completely out of range check
+        if( node->getRange()[0] >= _range[1] || node->getRange()[1] < _range[0])
+            return CULL_SKIP;
+
+        // bounding sphere view frustum culling
+        const vmml::Visibility visibility = _useFrustumCulling ?
+                           _culler.test_sphere( node->getBoundingSphere( )) :
+                           vmml::VISIBILITY_FULL;
+        if( visibility == vmml::VISIBILITY_NONE )
+            return CULL_SKIP;
+
+        if( _proxies.select( node, pixels ))
+            return CULL_PROXY;
+
+        if( !node->getLeft() && !node->getRight( ))
+            // drop partial leaves, to be drawn by 'previous' channel
+            return node->getRange()[0] >= _range[0] ? CULL_DRAW : CULL_SKIP;
+
+        // if fully visible and fully in range, render it
+        if( visibility == vmml::VISIBILITY_FULL &&
+            node->getRange()[0] >= _range[0] && node->getRange()[1] < _range[1])
+        {
+            return CULL_DRAW;
+        }
+        return CULL_SPLIT;
+    }
+
+private:
+    const Range& _range;
+    const ProxySelector _proxies;
+    const bool _useFrustumCulling;
+    FrustumCuller _culler;
+};
+}
+
 /*  Determine number of bits used by the current architecture.  */
 size_t getArchitectureBits();
 /*  Determine whether the current architecture is little endian or not.  */
@@ -52,18 +216,30 @@ bool isArchitectureLittleEndian();
 /*  Construct architecture dependent file name.  */
 std::string getArchitectureFilename( const std::string& filename );
 
+VertexBufferRoot::~VertexBufferRoot()
+{
+    _unmap();
+}
+
 /*  Begin kd-tree setup, go through full range starting with x axis.  */
 void VertexBufferRoot::setupTree( VertexData& data )
 {
     // data is VertexData, _data is VertexBufferData
-    _data.clear();
+    _unmap();
 
     const Axis axis = data.getLongestAxis( 0, data.triangles.size() );
 
-    VertexBufferNode::setupTree( data, 0, data.triangles.size(), 
+    // build the subtrees as parallel tasks, then assemble the vertex data
+#pragma omp parallel
+#pragma omp single
+    VertexBufferNode::setupTree( data, 0, data.triangles.size(),
                                  axis, 0, _data );
+    VertexBufferNode::setupData( data, _data );
     VertexBufferNode::updateBoundingSphere();
     VertexBufferNode::updateRange();
+    VertexBufferNode::setupProxy();
+    if( _quantize )
+        _setupQuantization();
 
 #if 0
     // re-test all points to be in the bounding sphere
@@ -83,118 +259,236 @@ void VertexBufferRoot::setupTree( VertexData& data )
 }
 
 // #define LOGCULL
+/*  Cull and draw, starting from the nodes at which the previous cullDraw with
+ *  the same cull key stopped its traversal. Each front node is first merged
+ *  into its ancestors while they stop the traversal as well, and is then
+ *  refined into its children while they are split. Bounding spheres and
+ *  ranges of the children are nested in their parent, so the result is the
+ *  same as a full traversal from the root, at a cost proportional to the
+ *  size of the front and its changes instead of the model size.  */
 void VertexBufferRoot::cullDraw( VertexBufferState& state ) const
 {
+    if( state.useOcclusionCulling() && _occlusionCullDraw( state ))
+        return;
+
     _beginRendering( state );
     
 #ifdef LOGCULL
     size_t verticesRendered = 0;
-    size_t verticesOverlap  = 0;
 #endif
 
-    const Range& range = state.getRange();
-    FrustumCuller culler;
-    culler.setup( state.getProjectionModelViewMatrix( ));
+    const NodeCuller culler( state );
+    VertexBufferState::CullFront& front = state.getCullFront( this );
+    if( front.empty( ))
+        front.push_back( this );
 
-    // start with root node
-    std::vector< const triply::VertexBufferBase* > candidates;
-    candidates.push_back( this );
+    VertexBufferState::CullFront next;
+    next.reserve( front.size( ));
+    std::set< const VertexBufferBase* > merged;
+    std::vector< const VertexBufferBase* > candidates;
+    bool stopped = false;
 
-    while( !candidates.empty() )
+    for( VertexBufferState::CullFront::const_iterator i = front.begin();
+         i != front.end() && !stopped; ++i )
     {
-        if( state.stopRendering( ))
-            return;
-
-        const triply::VertexBufferBase* treeNode = candidates.back();
-        candidates.pop_back();
-            
-        // completely out of range check
-        if( treeNode->getRange()[0] >= range[1] ||
-            treeNode->getRange()[1] < range[0] )
+        const VertexBufferBase* node = *i;
+        float pixels = 0.f;
+        for( const VertexBufferBase* parent = state.getParent( node ); parent;
+             parent = state.getParent( node ))
         {
-            continue;
+            if( culler.classify( parent, pixels ) == CULL_SPLIT )
+                break;
+            node = parent;
         }
+        if( node != *i && !merged.insert( node ).second )
+            continue; // a sibling already merged into this ancestor
 
-        // bounding sphere view frustum culling
-        const vmml::Visibility visibility = state.useFrustumCulling() ?
-                            culler.test_sphere( treeNode->getBoundingSphere( )) :
-                            vmml::VISIBILITY_FULL;
-        switch( visibility )
+        candidates.push_back( node );
+        while( !candidates.empty( ))
         {
-            case vmml::VISIBILITY_FULL:
-                // if fully visible and fully in range, render it
-                if( treeNode->getRange()[0] >= range[0] && 
-                    treeNode->getRange()[1] <  range[1] )
-                {
-                    treeNode->draw( state );
-                    //treeNode->drawBoundingSphere( state );
+            if( state.stopRendering( ))
+            {
+                stopped = true;
+                break;
+            }
+
+            const VertexBufferBase* treeNode = candidates.back();
+            candidates.pop_back();
+
+            switch( culler.classify( treeNode, pixels ))
+            {
+            case CULL_SKIP:
+                break;
+
+            case CULL_PROXY:
+                ProxySelector::draw( treeNode, pixels, state );
+                break;
+
+            case CULL_DRAW:
+                treeNode->draw( state );
+                //treeNode->drawBoundingSphere( state );
 #ifdef LOGCULL
-                    verticesRendered += treeNode->getNumberOfVertices();
+                verticesRendered += treeNode->getNumberOfVertices();
 #endif
-                    break;
-                }
-                // partial range, fall through to partial visibility
+                break;
 
-            case vmml::VISIBILITY_PARTIAL:
+            case CULL_SPLIT:
             {
-                const triply::VertexBufferBase* left  = treeNode->getLeft();
-                const triply::VertexBufferBase* right = treeNode->getRight();
-            
-                if( !left && !right )
+                const VertexBufferBase* left  = treeNode->getLeft();
+                const VertexBufferBase* right = treeNode->getRight();
+                if( left )
                 {
-                    if( treeNode->getRange()[0] >= range[0] )
-                    {
-                        treeNode->draw( state );
-                        //treeNode->drawBoundingSphere( state );
-#ifdef LOGCULL
-                        verticesRendered += treeNode->getNumberOfVertices();
-                        if( visibility == vmml::VISIBILITY_PARTIAL )
-                            verticesOverlap  += treeNode->getNumberOfVertices();
-#endif
-                    }
-                    // else drop, to be drawn by 'previous' channel
+                    state.setParent( left, treeNode );
+                    candidates.push_back( left );
                 }
-                else
+                if( right )
                 {
-                    if( left )
-                        candidates.push_back( left );
-                    if( right )
-                        candidates.push_back( right );
+                    state.setParent( right, treeNode );
+                    candidates.push_back( right );
                 }
-                break;
+                continue;
             }
-            case vmml::VISIBILITY_NONE:
-                // do nothing
-                break;
+            }
+            next.push_back( treeNode );
         }
     }
-    
+
+    // an interrupted traversal keeps the last complete front
+    if( !stopped )
+        front.swap( next );
+
     _endRendering( state );
 
 #ifdef LOGCULL
-    const size_t verticesTotal = model->getNumberOfVertices();
+    const size_t verticesTotal = getNumberOfVertices();
     PLYLIBINFO
         << getName() << " rendered " << verticesRendered * 100 / verticesTotal
-        << "% of model, overlap <= " << verticesOverlap * 100 / verticesTotal
-        << "%" << std::endl;
+        << "% of model from a front of " << front.size() << " nodes"
+        << std::endl;
 #endif    
 }
 
 
+/*  Cull for all views in one traversal. Each node is classified for the
+ *  views which still split the traversal at its parent, and its children are
+ *  only visited while at least one view splits it.  */
+void VertexBufferRoot::cull( const VertexBufferState& state,
+                             const CullViews& views, DrawLists& lists ) const
+{
+    lists.clear();
+    lists.resize( views.size( ));
+
+    typedef uint64_t Mask;
+    const size_t maxViews = sizeof( Mask ) * 8;
+    std::vector< NodeCuller > cullers;
+    std::vector< std::pair< const VertexBufferBase*, Mask > > candidates;
+
+    for( size_t first = 0; first < views.size(); first += maxViews )
+    {
+        const size_t nViews = std::min( views.size() - first, maxViews );
+        cullers.clear();
+        for( size_t i = 0; i < nViews; ++i )
+            cullers.push_back( NodeCuller( state, views[ first + i ] ));
+
+        const Mask all = nViews == maxViews ? Mask( -1 ) :
+                                              ( Mask( 1 ) << nViews ) - 1;
+        candidates.push_back( std::make_pair( this, all ));
+
+        while( !candidates.empty( ))
+        {
+            const VertexBufferBase* treeNode = candidates.back().first;
+            const Mask mask = candidates.back().second;
+            candidates.pop_back();
+
+            Mask split = 0;
+            for( size_t i = 0; i < nViews; ++i )
+            {
+                if( !( mask & ( Mask( 1 ) << i )))
+                    continue;
+
+                float pixels = 0.f;
+                switch( cullers[i].classify( treeNode, pixels ))
+                {
+                case CULL_SKIP:
+                    break;
+                case CULL_PROXY:
+                    lists[ first + i ].push_back( DrawItem( treeNode, pixels ));
+                    break;
+                case CULL_DRAW:
+                    lists[ first + i ].push_back( DrawItem( treeNode, 0.f ));
+                    break;
+                case CULL_SPLIT:
+                    split |= Mask( 1 ) << i;
+                    break;
+                }
+            }
+
+            if( !split )
+                continue;
+            if( treeNode->getLeft( ))
+                candidates.push_back( std::make_pair( treeNode->getLeft(),
+                                                      split ));
+            if( treeNode->getRight( ))
+                candidates.push_back( std::make_pair( treeNode->getRight(),
+                                                      split ));
+        }
+    }
+}
+
+/*  Draw the nodes selected by cull() for one view.  */
+void VertexBufferRoot::drawList( VertexBufferState& state,
+                                 const DrawList& list ) const
+{
+    _beginRendering( state );
+    for( DrawList::const_iterator i = list.begin(); i != list.end(); ++i )
+    {
+        if( state.stopRendering( ))
+            break;
+
+        if( i->proxyPixels > 0.f )
+            ProxySelector::draw( i->node, i->proxyPixels, state );
+        else
+            i->node->draw( state );
+    }
+    _endRendering( state );
+}
+
+
+void VertexBufferRoot::prefetch( const DrawList& list ) const
+{
+    if( !_map )
+        return;
+
+    for( DrawList::const_iterator i = list.begin(); i != list.end(); ++i )
+        if( i->proxyPixels == 0.f ) // proxies are not mapped
+            i->node->prefetch();
+}
+
+
 /*  Set up the common OpenGL state for rendering of all nodes.  */
 void VertexBufferRoot::_beginRendering( VertexBufferState& state ) const
 {
     state.resetRegion();
+    if( state.getLODThreshold() > 0.f )
+        glPushAttrib( GL_POINT_BIT );
     switch( state.getRenderMode() )
     {
 #ifdef GL_ARB_vertex_buffer_object
     case RENDER_MODE_BUFFER_OBJECT:
         glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
         glEnableClientState( GL_VERTEX_ARRAY );
-        glEnableClientState( GL_NORMAL_ARRAY );
+        // quantized leaves pass their normals as texture coordinates
+        if( state.useQuantization() && _data.hasQuantization( ))
+            glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+        else
+            glEnableClientState( GL_NORMAL_ARRAY );
         if( state.useColors() )
             glEnableClientState( GL_COLOR_ARRAY );
+        break;
 #endif
+    case RENDER_MODE_MULTI_DRAW:
+        state.getDrawCommands().clear();
+        break;
     case RENDER_MODE_DISPLAY_LIST:
     case RENDER_MODE_IMMEDIATE:
     default:
@@ -223,13 +517,286 @@ void VertexBufferRoot::_endRendering( VertexBufferState& state ) const
         glBindBuffer( GL_ARRAY_BUFFER_ARB, 0);
         glBindBuffer( GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
         glPopClientAttrib();
+        break;
     }
 #endif
+    case RENDER_MODE_MULTI_DRAW:
+        _multiDraw( state );
+        break;
     case RENDER_MODE_DISPLAY_LIST:
     case RENDER_MODE_IMMEDIATE:
     default:
         ;
     }
+    if( state.getLODThreshold() > 0.f )
+        glPopAttrib();
+}
+
+
+/*  Draw all leaves queued by cullDraw from the packed model buffers.  */
+void VertexBufferRoot::_multiDraw( VertexBufferState& state ) const
+{
+    VertexBufferState::DrawCommands& commands = state.getDrawCommands();
+    if( commands.empty( ))
+        return;
+
+    // the leaf indices are relative to their first vertex, which is the base
+    // vertex of their draw command
+    const size_t INDIRECT_OBJECT = INDEX_OBJECT + 1;
+    const char* key = reinterpret_cast< const char* >( this );
+    GLuint buffers[ INDIRECT_OBJECT + 1 ];
+    bool upload = false;
+    for( size_t i = 0; i <= INDIRECT_OBJECT; ++i )
+    {
+        buffers[i] = state.getBufferObject( key + i );
+        if( buffers[i] != state.INVALID )
+            continue;
+        buffers[i] = state.newBufferObject( key + i );
+        upload = true;
+    }
+
+    if( upload )
+    {
+        glBindBuffer( GL_ARRAY_BUFFER, buffers[VERTEX_OBJECT] );
+        glBufferData( GL_ARRAY_BUFFER,
+                      _data.getNumVertices() * sizeof( Vertex ),
+                      _data.getVertices(), GL_STATIC_DRAW );
+        glBindBuffer( GL_ARRAY_BUFFER, buffers[NORMAL_OBJECT] );
+        glBufferData( GL_ARRAY_BUFFER,
+                      _data.getNumVertices() * sizeof( Normal ),
+                      _data.getNormals(), GL_STATIC_DRAW );
+        if( _data.hasColors( ))
+        {
+            glBindBuffer( GL_ARRAY_BUFFER, buffers[COLOR_OBJECT] );
+            glBufferData( GL_ARRAY_BUFFER,
+                          _data.getNumVertices() * sizeof( Color ),
+                          _data.getColors(), GL_STATIC_DRAW );
+        }
+        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, buffers[INDEX_OBJECT] );
+        glBufferData( GL_ELEMENT_ARRAY_BUFFER,
+                      _data.getNumIndices() * sizeof( ShortIndex ),
+                      _data.getIndices(), GL_STATIC_DRAW );
+    }
+
+    glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_NORMAL_ARRAY );
+    if( state.useColors( ))
+    {
+        glEnableClientState( GL_COLOR_ARRAY );
+        glBindBuffer( GL_ARRAY_BUFFER, buffers[COLOR_OBJECT] );
+        glColorPointer( 3, GL_UNSIGNED_BYTE, 0, 0 );
+    }
+    glBindBuffer( GL_ARRAY_BUFFER, buffers[NORMAL_OBJECT] );
+    glNormalPointer( GL_FLOAT, 0, 0 );
+    glBindBuffer( GL_ARRAY_BUFFER, buffers[VERTEX_OBJECT] );
+    glVertexPointer( 3, GL_FLOAT, 0, 0 );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, buffers[INDEX_OBJECT] );
+
+    // stream this frame's commands, one draw call for all visible leaves
+    glBindBuffer( GL_DRAW_INDIRECT_BUFFER, buffers[INDIRECT_OBJECT] );
+    glBufferData( GL_DRAW_INDIRECT_BUFFER,
+                  commands.size() * sizeof( VertexBufferState::DrawCommand ),
+                  &commands[0], GL_STREAM_DRAW );
+    glMultiDrawElementsIndirect( GL_TRIANGLES, GL_UNSIGNED_SHORT, 0,
+                                 GLsizei( commands.size( )), 0 );
+
+    glBindBuffer( GL_DRAW_INDIRECT_BUFFER, 0 );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+    glPopClientAttrib();
+    commands.clear();
+}
+
+
+namespace
+{
+struct PendingQuery
+{
+    PendingQuery( const VertexBufferBase* n, const GLuint q )
+        : node( n ), query( q ) {}
+
+    const VertexBufferBase* node;
+    GLuint query;
+};
+typedef std::deque< PendingQuery > PendingQueries;
+
+GLuint _obtainQuery( VertexBufferState& state, const void* key )
+{
+    const GLuint query = state.getQuery( key );
+    return query == VertexBufferState::INVALID ? state.newQuery( key ) : query;
+}
+
+/*  Mark the node and all its ancestors visible in the current frame.  */
+void _pullUpVisibility( VertexBufferState& state, const VertexBufferBase* node )
+{
+    for( ; node; node = state.getParent( node ))
+        state.setVisible( node );
+}
+
+/*  Rasterize the box around the bounding sphere without writing pixels.  */
+void _drawBoundingBox( const BoundingSphere& sphere )
+{
+    const float r = sphere.w();
+    const float x[2] = { sphere.x() - r, sphere.x() + r };
+    const float y[2] = { sphere.y() - r, sphere.y() + r };
+    const float z[2] = { sphere.z() - r, sphere.z() + r };
+
+    glBegin( GL_QUADS );
+    for( size_t i = 0; i < 2; ++i )
+    {
+        glVertex3f( x[i], y[0], z[0] ); glVertex3f( x[i], y[1], z[0] );
+        glVertex3f( x[i], y[1], z[1] ); glVertex3f( x[i], y[0], z[1] );
+        glVertex3f( x[0], y[i], z[0] ); glVertex3f( x[1], y[i], z[0] );
+        glVertex3f( x[1], y[i], z[1] ); glVertex3f( x[0], y[i], z[1] );
+        glVertex3f( x[0], y[0], z[i] ); glVertex3f( x[1], y[0], z[i] );
+        glVertex3f( x[1], y[1], z[i] ); glVertex3f( x[0], y[1], z[i] );
+    }
+    glEnd();
+}
+}
+
+/*  Cull and draw using occlusion queries on the kd-tree bounding spheres.
+ *  Nodes visible in the last frame are rendered right away, front to back,
+ *  with a query around each leaf to find out if it is still visible. Nodes
+ *  hidden in the last frame are tested with their bounding box and only
+ *  traversed once their query result arrives, which is polled while other
+ *  nodes are rendered. Visibility is propagated from the leaves to the root
+ *  for the next frame. Returns false if occlusion queries are not usable.  */
+bool VertexBufferRoot::_occlusionCullDraw( VertexBufferState& state ) const
+{
+    // multi draw renders all leaves at the end, too late to query each leaf
+    if( !GLEW_VERSION_1_5 || state.getRenderMode() == RENDER_MODE_MULTI_DRAW )
+        return false;
+
+    _beginRendering( state );
+    state.nextOcclusionFrame();
+
+    const Range& range = state.getRange();
+    FrustumCuller culler;
+    culler.setup( state.getProjectionModelViewMatrix( ));
+    const ProxySelector proxies( state );
+
+    std::vector< const VertexBufferBase* > candidates;
+    candidates.push_back( this );
+    PendingQueries boxQueries;  // nodes hidden last frame, in test order
+    PendingQueries drawQueries; // leaves drawn this frame
+
+    while( !candidates.empty() || !boxQueries.empty( ))
+    {
+        if( state.stopRendering( ))
+            break;
+
+        // traverse nodes found visible as soon as their result is available,
+        // block only if there is no other work left
+        if( !boxQueries.empty( ))
+        {
+            const PendingQuery& pending = boxQueries.front();
+            GLuint available = candidates.empty();
+            if( !available )
+                glGetQueryObjectuiv( pending.query, GL_QUERY_RESULT_AVAILABLE,
+                                     &available );
+            if( available )
+            {
+                GLuint samples = 0;
+                glGetQueryObjectuiv( pending.query, GL_QUERY_RESULT, &samples);
+                if( samples > 0 )
+                {
+                    _pullUpVisibility( state, pending.node );
+                    candidates.push_back( pending.node );
+                }
+                boxQueries.pop_front();
+                continue;
+            }
+        }
+
+        const VertexBufferBase* treeNode = candidates.back();
+        candidates.pop_back();
+
+        // completely out of range check
+        if( treeNode->getRange()[0] >= range[1] ||
+            treeNode->getRange()[1] < range[0] )
+        {
+            continue;
+        }
+
+        const BoundingSphere& sphere = treeNode->getBoundingSphere();
+        if( state.useFrustumCulling() &&
+            culler.test_sphere( sphere ) == vmml::VISIBILITY_NONE )
+        {
+            continue;
+        }
+
+        // boxes cut by the near plane are not rasterized, assume visible
+        if( !state.isVisible( treeNode ) && proxies.getDistance( sphere ) > 0.f)
+        {
+            const GLuint query = _obtainQuery( state, treeNode );
+            glPushAttrib( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT |
+                          GL_POLYGON_BIT );
+            glColorMask( GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE );
+            glDepthMask( GL_FALSE );
+            glDisable( GL_CULL_FACE );
+            glBeginQuery( GL_SAMPLES_PASSED, query );
+            _drawBoundingBox( sphere );
+            glEndQuery( GL_SAMPLES_PASSED );
+            glPopAttrib();
+            boxQueries.push_back( PendingQuery( treeNode, query ));
+            continue;
+        }
+
+        if( proxies.draw( treeNode, state ))
+        {
+            _pullUpVisibility( state, treeNode );
+            continue;
+        }
+
+        const VertexBufferBase* left  = treeNode->getLeft();
+        const VertexBufferBase* right = treeNode->getRight();
+        if( !left && !right )
+        {
+            // else drop, to be drawn by 'previous' channel
+            if( treeNode->getRange()[0] < range[0] )
+                continue;
+
+            const GLuint query = _obtainQuery( state, treeNode );
+            glBeginQuery( GL_SAMPLES_PASSED, query );
+            treeNode->draw( state );
+            glEndQuery( GL_SAMPLES_PASSED );
+            drawQueries.push_back( PendingQuery( treeNode, query ));
+            continue;
+        }
+
+        // push the farther child first to render front to back
+        const VertexBufferBase* first = left;
+        const VertexBufferBase* second = right;
+        if( !first || ( second && proxies.getW( second->getBoundingSphere( ))<
+                                  proxies.getW( first->getBoundingSphere( ))))
+        {
+            std::swap( first, second );
+        }
+        if( second )
+        {
+            state.setParent( second, treeNode );
+            candidates.push_back( second );
+        }
+        if( first )
+        {
+            state.setParent( first, treeNode );
+            candidates.push_back( first );
+        }
+    }
+
+    for( PendingQueries::const_iterator i = drawQueries.begin();
+         i != drawQueries.end(); ++i )
+    {
+        GLuint samples = 0;
+        glGetQueryObjectuiv( i->query, GL_QUERY_RESULT, &samples );
+        if( samples > 0 )
+            _pullUpVisibility( state, i->node );
+    }
+
+    _endRendering( state );
+    return true;
 }
 
 
@@ -264,9 +831,12 @@ bool VertexBufferRoot::_constructFromPly( const std::string& filename )
 {
     PLYLIBINFO << "Constructing new from PLY file." << std::endl;
     
+    // the PLY data is released on return, before the tree is written
     VertexData data;
     if( _invertFaces )
         data.useInvertedFaces();
+    if( _quantize )
+        data.useVertexCacheOptimization();
     if( !data.readPlyFile( filename ) )
     {
         PLYLIBERROR << "Unable to load PLY file." << std::endl;
@@ -276,9 +846,6 @@ bool VertexBufferRoot::_constructFromPly( const std::string& filename )
     data.calculateNormals();
     data.scale( 2.0f );
     setupTree( data );
-    if( !writeToFile( filename ))
-        PLYLIBWARN << "Unable to write binary representation." << std::endl;
-    
     return true;
 }
 
@@ -317,6 +884,7 @@ bool VertexBufferRoot::_readBinary( std::string filename )
 
     if( addr )
     {
+        _unmap();
         try
         {
             fromMemory( addr );
@@ -327,17 +895,25 @@ bool VertexBufferRoot::_readBinary( std::string filename )
             PLYLIBERROR << "Unable to read binary file, an exception occured:  "
                       << e.what() << std::endl;
         }
-        UnmapViewOfFile( addr );
     }
     else
     {
         PLYLIBERROR << "Unable to read binary file, memory mapping failed."
                   << std::endl;
+        CloseHandle( map );
         return false;
     }
 
+    if( result ) // keep mapping for lazy access to the leaf data
+    {
+        _map = addr;
+        _mapHandle = map;
+        return true;
+    }
+    _data.clear();
+    UnmapViewOfFile( addr );
     CloseHandle( map );
-    return result;
+    return false;
     
 #else
     // try to open binary file
@@ -355,6 +931,7 @@ bool VertexBufferRoot::_readBinary( std::string filename )
     bool  result = false;
     if( addr != MAP_FAILED )
     {
+        _unmap();
         try
         {
             fromMemory( addr );
@@ -365,7 +942,17 @@ bool VertexBufferRoot::_readBinary( std::string filename )
             PLYLIBERROR << "Unable to read binary file, an exception occured:  "
                       << e.what() << std::endl;
         }
-        munmap( addr, status.st_size );
+
+        if( result ) // keep mapping for lazy access to the leaf data
+        {
+            _map = addr;
+            _mapSize = status.st_size;
+        }
+        else
+        {
+            _data.clear();
+            munmap( addr, status.st_size );
+        }
     }
     else
     {
@@ -378,29 +965,82 @@ bool VertexBufferRoot::_readBinary( std::string filename )
 #endif
 }
 
+/*  Release the mapping of the binary file and the data referencing it.  */
+void VertexBufferRoot::_unmap()
+{
+    _data.clear();
+    if( !_map )
+        return;
+
+#ifdef WIN32
+    UnmapViewOfFile( _map );
+    CloseHandle( static_cast< HANDLE >( _mapHandle ));
+#else
+    munmap( _map, _mapSize );
+#endif
+    _map = 0;
+    _mapSize = 0;
+    _mapHandle = 0;
+}
+
+/*  Quantize the vertices of all leaves into the owned quantized arrays.  */
+void VertexBufferRoot::_setupQuantization()
+{
+    _data.quantizedVertices.resize( _data.getNumVertices( ));
+    _data.quantizedNormals.resize( _data.getNumVertices( ));
+    VertexBufferNode::setupQuantization( _data );
+}
+
 /*  Read binary kd-tree representation, construct from ply if unavailable.  */
 bool VertexBufferRoot::readFromFile( const std::string& filename )
 {
     if( _readBinary( getArchitectureFilename( filename )))
     {
+        // binaries written without quantization are quantized in memory
+        if( _quantize && !_data.hasQuantization( ))
+            _setupQuantization();
         _name = filename;
         return true;
     }
     if( _constructFromPly( filename ))
     {
+        if( !writeToFile( filename ))
+            PLYLIBWARN << "Unable to write binary representation." << std::endl;
         _name = filename;
         return true;
     }
     return false;
 }
 
-/*  Write binary representation of the kd-tree to file.  */
+/*  Construct from ply, ignoring an existing binary, and write the binary.  */
+bool VertexBufferRoot::convertFromPly( const std::string& filename )
+{
+    _unmap();
+    if( !_constructFromPly( filename ))
+        return false;
+
+    _name = filename;
+    return writeToFile( filename );
+}
+
+std::string VertexBufferRoot::getCacheFilename( const std::string& filename )
+{
+    return getArchitectureFilename( filename );
+}
+
+/*  Write binary representation of the kd-tree to file. The tree is streamed
+ *  into a temporary file which replaces the binary file once complete, so
+ *  readers never see a partially written binary.  */
 bool VertexBufferRoot::writeToFile( const std::string& filename )
 {
+    const std::string binaryName = getArchitectureFilename( filename );
+    const std::string tmpName = binaryName + ".tmp";
     bool result = false;
     
-    std::ofstream output( getArchitectureFilename( filename ).c_str(), 
-                          std::ios::out | std::ios::binary );
+    std::vector< char > buffer( 1024 * 1024 );
+    std::ofstream output;
+    output.rdbuf()->pubsetbuf( &buffer[0], buffer.size( ));
+    output.open( tmpName.c_str(), std::ios::out | std::ios::binary );
     if( output )
     {
         // enable exceptions on stream errors
@@ -408,6 +1048,7 @@ bool VertexBufferRoot::writeToFile( const std::string& filename )
         try
         {
             toStream( output );
+            output.close();
             result = true;
         }
         catch( const std::exception& e )
@@ -415,13 +1056,27 @@ bool VertexBufferRoot::writeToFile( const std::string& filename )
             PLYLIBERROR << "Unable to write binary file, an exception "
                       << "occured:  " << e.what() << std::endl;
         }
-        output.close();
     }
     else
     {
         PLYLIBERROR << "Unable to create binary file." << std::endl;
+        return false;
     }
-    
+
+#ifdef WIN32
+    if( result && !MoveFileEx( tmpName.c_str(), binaryName.c_str(),
+                               MOVEFILE_REPLACE_EXISTING ))
+#else
+    if( result && ::rename( tmpName.c_str(), binaryName.c_str( )) != 0 )
+#endif
+    {
+        PLYLIBERROR << "Unable to replace binary file " << binaryName
+                    << std::endl;
+        result = false;
+    }
+
+    if( !result )
+        ::remove( tmpName.c_str( ));
     return result;
 }
 
@@ -440,7 +1095,7 @@ void VertexBufferRoot::fromMemory( char* start )
     if( nodeType != ROOT_TYPE )
         throw MeshException( "Error reading binary file. Expected the root "
                              "node, but found something else instead." );
-    _data.fromMemory( addr );
+    _data.mapMemory( addr );
     VertexBufferNode::fromMemory( addr, _data );
 }
 
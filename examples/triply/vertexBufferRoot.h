@@ -42,18 +42,77 @@ namespace triply
 class VertexBufferRoot : public VertexBufferNode
 {
 public:
-    PLYLIB_API VertexBufferRoot() : VertexBufferNode(), _invertFaces(false) {}
+    PLYLIB_API VertexBufferRoot()
+        : VertexBufferNode(), _invertFaces( false ), _quantize( false )
+        , _map( 0 ), _mapSize( 0 ), _mapHandle( 0 ) {}
+    PLYLIB_API virtual ~VertexBufferRoot();
 
     PLYLIB_API virtual void cullDraw( VertexBufferState& state ) const;
     PLYLIB_API virtual void draw( VertexBufferState& state ) const;
 
+    /** The destination parameters of one view for cull(). */
+    struct CullView
+    {
+        Matrix4f pmv; //!< projection * modelView matrix
+        Range    range; //!< normalized [0,1] part of the model to draw
+        float    viewportSize[2]; //!< in pixels, for the LOD selection
+    };
+    typedef std::vector< CullView > CullViews;
+
+    /** A node selected by cull(), drawn fully or as a proxy. */
+    struct DrawItem
+    {
+        DrawItem( const VertexBufferBase* n, const float pixels )
+            : node( n ), proxyPixels( pixels ) {}
+
+        const VertexBufferBase* node;
+        float proxyPixels; //!< projected proxy error, 0 for the full node
+    };
+    typedef std::vector< DrawItem > DrawList;
+    typedef std::vector< DrawList > DrawLists;
+
+    /**
+     * Cull the tree for several views in one traversal.
+     *
+     * The frustum culling and LOD settings are taken from the state.
+     *
+     * @param state the render state.
+     * @param views the views to cull for.
+     * @param lists returns one draw list per view.
+     */
+    PLYLIB_API void cull( const VertexBufferState& state,
+                          const CullViews& views, DrawLists& lists ) const;
+
+    /** Draw a list of nodes returned by cull(). */
+    PLYLIB_API void drawList( VertexBufferState& state,
+                              const DrawList& list ) const;
+
+    /**
+     * Start paging in the data of a list of nodes returned by cull().
+     *
+     * Only has an effect if the tree is mapped from its binary cache. The
+     * pages are read asynchronously by the operating system.
+     */
+    PLYLIB_API void prefetch( const DrawList& list ) const;
+
     PLYLIB_API void setupTree( VertexData& data );
     PLYLIB_API bool writeToFile( const std::string& filename );
     PLYLIB_API bool readFromFile( const std::string& filename );
-    bool hasColors() const { return !_data.colors.empty(); }
+
+    /** Build the tree from a PLY file and write its binary cache. */
+    PLYLIB_API bool convertFromPly( const std::string& filename );
+
+    /** @return the name of the binary cache of the given PLY file. */
+    PLYLIB_API static std::string getCacheFilename(
+        const std::string& filename );
+
+    bool hasColors() const { return _data.hasColors(); }
 
     void useInvertedFaces() { _invertFaces = true; }
 
+    /** Provide the quantized vertex layout and optimize new leaf indices. */
+    void useQuantization() { _quantize = true; }
+
     const std::string& getName() const { return _name; }
 
 protected:
@@ -63,14 +122,24 @@ protected:
 private:
     bool _constructFromPly( const std::string& filename );
     bool _readBinary( std::string filename );
+    void _unmap();
+    void _setupQuantization();
 
     void _beginRendering( VertexBufferState& state ) const;
     void _endRendering( VertexBufferState& state ) const;
+    void _multiDraw( VertexBufferState& state ) const;
+    bool _occlusionCullDraw( VertexBufferState& state ) const;
 
     friend class VertexBufferDist;
     VertexBufferData _data;
     bool             _invertFaces;
+    bool             _quantize;
     std::string      _name;
+
+    // the binary file stays mapped, leaf data is paged in on first use
+    char*            _map;
+    size_t           _mapSize;
+    void*            _mapHandle;
 };
 }
 
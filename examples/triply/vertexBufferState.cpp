@@ -37,9 +37,20 @@ VertexBufferState::VertexBufferState( const GLEWContext* glewContext )
         , _renderMode( RENDER_MODE_DISPLAY_LIST )
         , _useColors( false )
         , _useFrustumCulling( true )
+        , _useOcclusionCulling( false )
+        , _useQuantization( false )
+        , _lodThreshold( 0.f )
+        , _residentSize( 0 )
+        , _residencyBudget( 0 )
+        , _occlusionFrame( 1 )
+        , _cullKey( 0 )
 {
     _range[0] = 0.f;
     _range[1] = 1.f;
+    _viewportSize[0] = 1.f;
+    _viewportSize[1] = 1.f;
+    _quantizationUniforms[0] = -1;
+    _quantizationUniforms[1] = -1;
     resetRegion();
     PLYLIBASSERT( glewContext );
 } 
@@ -52,6 +63,13 @@ void VertexBufferState::setRenderMode( const RenderMode mode )
     _renderMode = mode;
 
     // Check if VBO funcs available, else fall back to display lists
+    if( _renderMode == RENDER_MODE_MULTI_DRAW &&
+        !GLEW_ARB_multi_draw_indirect )
+    {
+        PLYLIBINFO << "Multi draw indirect not available, using VBOs"
+                   << std::endl;
+        _renderMode = RENDER_MODE_BUFFER_OBJECT;
+    }
     if( _renderMode == RENDER_MODE_BUFFER_OBJECT && !GLEW_VERSION_1_5 )
     {
         PLYLIBINFO << "VBO not available, using display lists" << std::endl;
@@ -113,6 +131,58 @@ Vector4f VertexBufferState::getRegion() const
     return _region;
 }
 
+void VertexBufferState::updateResidency( const char* key,
+                                         const size_t nBuffers,
+                                         const size_t size )
+{
+    if( _residencyBudget == 0 )
+        return;
+
+    ResidentMap::iterator i = _resident.find( key );
+    if( i == _resident.end( ))
+    {
+        _lru.push_front( key );
+        const Resident resident = { _lru.begin(), nBuffers, size };
+        _resident[ key ] = resident;
+        _residentSize += size;
+    }
+    else
+    {
+        _lru.splice( _lru.begin(), _lru, i->second.lru );
+        _residentSize = _residentSize - i->second.size + size;
+        i->second.size = size;
+    }
+
+    while( _residentSize > _residencyBudget && _lru.size() > 1 )
+    {
+        const char* victim = _lru.back();
+        ResidentMap::iterator j = _resident.find( victim );
+        PLYLIBASSERT( j != _resident.end( ));
+
+        for( size_t k = 0; k < j->second.nBuffers; ++k )
+            deleteBufferObject( victim + k );
+        _residentSize -= j->second.size;
+        _resident.erase( j );
+        _lru.pop_back();
+    }
+}
+
+void VertexBufferState::addDrawCommand( const Index firstIndex,
+                                        const Index count,
+                                        const Index baseVertex )
+{
+    const DrawCommand command = { GLuint( count ), 1, GLuint( firstIndex ),
+                                  GLint( baseVertex ), 0 };
+    _drawCommands.push_back( command );
+}
+
+void VertexBufferState::resetResidency()
+{
+    _lru.clear();
+    _resident.clear();
+    _residentSize = 0;
+}
+
 GLuint VertexBufferStateSimple::getDisplayList( const void* key )
 {
     if( _displayLists.find( key ) == _displayLists.end() )
@@ -141,6 +211,31 @@ GLuint VertexBufferStateSimple::newBufferObject( const void* key )
     return _bufferObjects[key];
 }
         
+void VertexBufferStateSimple::deleteBufferObject( const void* key )
+{
+    GLMap::iterator i = _bufferObjects.find( key );
+    if( i == _bufferObjects.end( ))
+        return;
+
+    glDeleteBuffers( 1, &i->second );
+    _bufferObjects.erase( i );
+}
+
+GLuint VertexBufferStateSimple::getQuery( const void* key )
+{
+    if( _queries.find( key ) == _queries.end() )
+        return INVALID;
+    return _queries[key];
+}
+
+GLuint VertexBufferStateSimple::newQuery( const void* key )
+{
+    if( !GLEW_VERSION_1_5 )
+        return INVALID;
+    glGenQueries( 1, &_queries[key] );
+    return _queries[key];
+}
+
 void VertexBufferStateSimple::deleteAll()
 {
     for( GLMapCIter i = _displayLists.begin(); i != _displayLists.end(); ++i )
@@ -149,8 +244,13 @@ void VertexBufferStateSimple::deleteAll()
     for( GLMapCIter i = _bufferObjects.begin(); i != _bufferObjects.end(); ++i )
         glDeleteBuffers( 1, &(i->second) );
 
+    for( GLMapCIter i = _queries.begin(); i != _queries.end(); ++i )
+        glDeleteQueries( 1, &(i->second) );
+
     _displayLists.clear();
     _bufferObjects.clear();
+    _queries.clear();
+    resetResidency();
 }
 
 }
@@ -33,7 +33,9 @@
 
 #include "api.h"
 #include "typedefs.h"
+#include <list>
 #include <map>
+#include <vector>
 
 namespace triply
 {
@@ -55,6 +57,35 @@ public:
     PLYLIB_API virtual void setFrustumCulling( const bool frustumCullingState )
         { _useFrustumCulling = frustumCullingState; }
 
+    /** @return true if occlusion queries cull nodes hidden last frame. */
+    PLYLIB_API bool useOcclusionCulling() const { return _useOcclusionCulling; }
+    /** Enable or disable occlusion culling, off by default. */
+    PLYLIB_API void setOcclusionCulling( const bool occlusionCulling )
+        { _useOcclusionCulling = occlusionCulling; }
+
+    /**
+     * Draw VBOs with the quantized vertex layout, if the model has one.
+     *
+     * The current program has to dequantize the positions with the offset and
+     * scale uniforms, and to decode the octahedral normals passed as the
+     * first texture coordinates, see setQuantizationUniforms().
+     */
+    PLYLIB_API void setQuantization( const bool quantization )
+        { _useQuantization = quantization; }
+    PLYLIB_API bool useQuantization() const { return _useQuantization; }
+
+    /**
+     * Set the uniform locations of the per-leaf dequantization parameters.
+     *
+     * The offset is a vec4 whose w component is 1 while a quantized leaf is
+     * drawn and 0 otherwise, the scale is a vec3.
+     */
+    PLYLIB_API void setQuantizationUniforms( const GLint offset,
+                                             const GLint scale )
+        { _quantizationUniforms[0] = offset; _quantizationUniforms[1] = scale; }
+    PLYLIB_API const GLint* getQuantizationUniforms() const
+        { return _quantizationUniforms; }
+
     PLYLIB_API void setProjectionModelViewMatrix( const Matrix4f& pmv )
         { _pmvMatrix = pmv; }
     PLYLIB_API const Matrix4f& getProjectionModelViewMatrix() const
@@ -63,6 +94,17 @@ public:
     PLYLIB_API void setRange( const Range& range ) { _range = range; }
     PLYLIB_API const Range& getRange() const { return _range; }
 
+    /** Set the maximum projected error in pixels of drawn node proxies. */
+    PLYLIB_API void setLODThreshold( const float pixels )
+        { _lodThreshold = pixels; }
+    /** @return the LOD threshold in pixels, 0 draws the full model. */
+    PLYLIB_API float getLODThreshold() const { return _lodThreshold; }
+
+    /** Set the size of the destination viewport in pixels. */
+    PLYLIB_API void setViewportSize( const float width, const float height )
+        { _viewportSize[0] = width; _viewportSize[1] = height; }
+    PLYLIB_API const float* getViewportSize() const { return _viewportSize; }
+
     PLYLIB_API void resetRegion();
     PLYLIB_API void updateRegion( const BoundingBox& box );
     PLYLIB_API virtual void declareRegion( const Vector4f& ) {}
@@ -72,8 +114,87 @@ public:
     PLYLIB_API virtual GLuint newDisplayList( const void* key ) = 0;
     PLYLIB_API virtual GLuint getBufferObject( const void* key ) = 0;
     PLYLIB_API virtual GLuint newBufferObject( const void* key ) = 0;
+    PLYLIB_API virtual void deleteBufferObject( const void* key ) = 0;
+    PLYLIB_API virtual GLuint getQuery( const void* key ) = 0;
+    PLYLIB_API virtual GLuint newQuery( const void* key ) = 0;
     PLYLIB_API virtual void deleteAll() = 0;
 
+    /** The nodes at which a cullDraw stopped its traversal. */
+    typedef std::vector< const VertexBufferBase* > CullFront;
+
+    /**
+     * Set the key identifying the destination of the following cullDraws.
+     *
+     * Each cullDraw continues from the front of the last cullDraw of the same
+     * root and key, e.g., the same channel and eye, or the previous tile.
+     */
+    PLYLIB_API void setCullKey( const void* key ) { _cullKey = key; }
+    PLYLIB_API const void* getCullKey() const { return _cullKey; }
+
+    /** @return the cull front of the given root for the current cull key. */
+    PLYLIB_API CullFront& getCullFront( const VertexBufferBase* root )
+        { return _cullFronts[ CullFrontKey( root, _cullKey )]; }
+
+    /** Remember the parent of a traversed kd-tree node. */
+    PLYLIB_API void setParent( const VertexBufferBase* node,
+                               const VertexBufferBase* parent )
+        { _parents[ node ] = parent; }
+
+    /** @return the parent of a node traversed before, or 0. */
+    PLYLIB_API const VertexBufferBase*
+    getParent( const VertexBufferBase* node ) const
+    {
+        Parents::const_iterator i = _parents.find( node );
+        return i == _parents.end() ? 0 : i->second;
+    }
+
+    /** Start the occlusion culling of a new frame. */
+    PLYLIB_API void nextOcclusionFrame() { ++_occlusionFrame; }
+
+    /** Mark the given node as visible in the current frame. */
+    PLYLIB_API void setVisible( const void* node )
+        { _visibleFrames[ node ] = _occlusionFrame; }
+
+    /** @return true if the node was visible in the last or current frame. */
+    PLYLIB_API bool isVisible( const void* node ) const
+    {
+        VisibleFrames::const_iterator i = _visibleFrames.find( node );
+        return i != _visibleFrames.end() && i->second + 1 >= _occlusionFrame;
+    }
+
+    /** Limit the size of resident buffer objects, 0 is unlimited. */
+    PLYLIB_API void setResidencyBudget( const size_t bytes )
+        { _residencyBudget = bytes; }
+    PLYLIB_API size_t getResidencyBudget() const { return _residencyBudget; }
+
+    /**
+     * Mark the nBuffers buffer objects starting at key as most recently used.
+     * Evicts the least recently used buffer objects while the resident size
+     * exceeds the residency budget.
+     */
+    PLYLIB_API void updateResidency( const char* key, const size_t nBuffers,
+                                     const size_t size );
+
+    /** Forget all resident buffer objects, e.g., after deleteAll(). */
+    PLYLIB_API void resetResidency();
+
+    /** An indirect draw command, laid out as expected by OpenGL. */
+    struct DrawCommand
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint  baseVertex;
+        GLuint baseInstance;
+    };
+    typedef std::vector< DrawCommand > DrawCommands;
+
+    /** Queue the draw of an index range for RENDER_MODE_MULTI_DRAW. */
+    PLYLIB_API void addDrawCommand( const Index firstIndex, const Index count,
+                                    const Index baseVertex );
+    /** @return the queued draw commands of the current cullDraw. */
+    PLYLIB_API DrawCommands& getDrawCommands() { return _drawCommands; }
+
     PLYLIB_API const GLEWContext* glewGetContext() const
         { return _glewContext; }
 
@@ -88,8 +209,37 @@ protected:
     Vector4f      _region; //!< normalized x1 y1 x2 y2 region from cullDraw
     bool          _useColors;
     bool          _useFrustumCulling;
+    bool          _useOcclusionCulling;
+    bool          _useQuantization;
+    GLint         _quantizationUniforms[2]; //!< offset, scale
+    float         _lodThreshold;
+    float         _viewportSize[2];
 
 private:
+    typedef std::list< const char* > LRU;
+    struct Resident
+    {
+        LRU::iterator lru;
+        size_t        nBuffers;
+        size_t        size;
+    };
+    typedef std::map< const char*, Resident > ResidentMap;
+    typedef std::map< const void*, uint32_t > VisibleFrames;
+    typedef std::pair< const VertexBufferBase*, const void* > CullFrontKey;
+    typedef std::map< CullFrontKey, CullFront > CullFronts;
+    typedef std::map< const VertexBufferBase*,
+                      const VertexBufferBase* > Parents;
+
+    LRU           _lru; //!< resident buffer keys, most recently used first
+    ResidentMap   _resident;
+    size_t        _residentSize;
+    size_t        _residencyBudget;
+    DrawCommands  _drawCommands;
+    VisibleFrames _visibleFrames; //!< last frame each node was visible in
+    uint32_t      _occlusionFrame;
+    const void*   _cullKey;
+    CullFronts    _cullFronts;
+    Parents       _parents; //!< kd-tree nodes do not know their parent
 };
 
 
@@ -108,11 +258,15 @@ public:
     PLYLIB_API virtual GLuint newDisplayList( const void* key );
     PLYLIB_API virtual GLuint getBufferObject( const void* key );
     PLYLIB_API virtual GLuint newBufferObject( const void* key );
+    PLYLIB_API virtual void deleteBufferObject( const void* key );
+    PLYLIB_API virtual GLuint getQuery( const void* key );
+    PLYLIB_API virtual GLuint newQuery( const void* key );
     PLYLIB_API virtual void deleteAll();
 
 private:
     GLMap  _displayLists;
     GLMap  _bufferObjects;
+    GLMap  _queries;
 };
 } // namespace triply
 
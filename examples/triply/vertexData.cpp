@@ -31,20 +31,297 @@
 #include "ply.h"
 
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
 
 #if (( __GNUC__ > 4 ) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 4)) )
 #  include <parallel/algorithm>
 using __gnu_parallel::sort;
+using __gnu_parallel::nth_element;
 #else
 using std::sort;
+using std::nth_element;
 #endif
 
 using namespace triply;
 
+namespace
+{
+/*  A read-only memory mapping of a whole file.  */
+class MappedFile
+{
+public:
+    explicit MappedFile( const std::string& filename )
+        : _data( 0 )
+        , _size( 0 )
+#ifdef _WIN32
+        , _map( 0 )
+#endif
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFile( filename.c_str(), GENERIC_READ,
+                                  FILE_SHARE_READ, 0, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, 0 );
+        if( file == INVALID_HANDLE_VALUE )
+            return;
+
+        LARGE_INTEGER size;
+        if( GetFileSizeEx( file, &size ) && size.QuadPart > 0 )
+        {
+            _map = CreateFileMapping( file, 0, PAGE_READONLY, 0, 0, 0 );
+            if( _map )
+            {
+                _data = static_cast< const char* >(
+                    MapViewOfFile( _map, FILE_MAP_READ, 0, 0, 0 ));
+                _size = _data ? size_t( size.QuadPart ) : 0;
+            }
+        }
+        CloseHandle( file );
+#else
+        const int fd = open( filename.c_str(), O_RDONLY );
+        if( fd < 0 )
+            return;
+
+        struct stat status;
+        if( fstat( fd, &status ) == 0 && status.st_size > 0 )
+        {
+            void* addr = mmap( 0, status.st_size, PROT_READ, MAP_SHARED, fd,
+                               0 );
+            if( addr != MAP_FAILED )
+            {
+                _data = static_cast< const char* >( addr );
+                _size = status.st_size;
+            }
+        }
+        close( fd );
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if( _data )
+            UnmapViewOfFile( _data );
+        if( _map )
+            CloseHandle( _map );
+#else
+        if( _data )
+            munmap( const_cast< char* >( _data ), _size );
+#endif
+    }
+
+    const char* getData() const { return _data; }
+    size_t getSize() const { return _size; }
+
+private:
+    const char* _data;
+    size_t      _size;
+#ifdef _WIN32
+    HANDLE      _map;
+#endif
+};
+
+/*  A property of a binary PLY element with its offset in the record.  */
+struct BinaryProperty
+{
+    std::string name;
+    int         type;
+    int         countType; //!< type of the list count, 0 for scalars
+    size_t      offset;
+};
+
+/*  A binary PLY element with fixed-size records.  */
+struct BinaryElement
+{
+    std::string                   name;
+    size_t                        count;
+    size_t                        size; //!< record size in bytes
+    std::vector< BinaryProperty > properties;
+
+    const BinaryProperty* find( const std::string& propertyName ) const
+    {
+        for( size_t i = 0; i < properties.size(); ++i )
+            if( properties[i].name == propertyName )
+                return &properties[i];
+        return 0;
+    }
+};
+
+int _getType( const std::string& name )
+{
+    if( name == "char" || name == "int8" )
+        return PLY_CHAR;
+    if( name == "uchar" || name == "uint8" )
+        return PLY_UCHAR;
+    if( name == "short" || name == "int16" )
+        return PLY_SHORT;
+    if( name == "ushort" || name == "uint16" )
+        return PLY_USHORT;
+    if( name == "int" || name == "int32" )
+        return PLY_INT;
+    if( name == "uint" || name == "uint32" )
+        return PLY_UINT;
+    if( name == "float" || name == "float32" )
+        return PLY_FLOAT;
+    if( name == "double" || name == "float64" )
+        return PLY_DOUBLE;
+    return 0;
+}
+
+size_t _getTypeSize( const int type )
+{
+    switch( type )
+    {
+    case PLY_CHAR:
+    case PLY_UCHAR:
+        return 1;
+    case PLY_SHORT:
+    case PLY_USHORT:
+        return 2;
+    case PLY_INT:
+    case PLY_UINT:
+    case PLY_FLOAT:
+        return 4;
+    case PLY_DOUBLE:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+/*  Load one value of the given size, swapping the bytes if needed.  */
+template< class T > inline T _load( const char* data, const bool swap )
+{
+    T value;
+    memcpy( &value, data, sizeof( T ));
+    if( swap )
+    {
+        char* bytes = reinterpret_cast< char* >( &value );
+        std::reverse( bytes, bytes + sizeof( T ));
+    }
+    return value;
+}
+
+inline double _getValue( const char* data, const int type, const bool swap )
+{
+    switch( type )
+    {
+    case PLY_CHAR:   return _load< int8_t >( data, swap );
+    case PLY_UCHAR:  return _load< uint8_t >( data, swap );
+    case PLY_SHORT:  return _load< int16_t >( data, swap );
+    case PLY_USHORT: return _load< uint16_t >( data, swap );
+    case PLY_INT:    return _load< int32_t >( data, swap );
+    case PLY_UINT:   return _load< uint32_t >( data, swap );
+    case PLY_FLOAT:  return _load< float >( data, swap );
+    case PLY_DOUBLE: return _load< double >( data, swap );
+    default:         return 0.;
+    }
+}
+
+inline bool _isLittleEndian()
+{
+    const uint16_t test = 1;
+    return *reinterpret_cast< const uint8_t* >( &test ) == 1;
+}
+
+/*  Parse the header of a binary PLY file. Elements containing lists are only
+    supported for the face indices, assuming triangles.  */
+bool _parseHeader( const char* data, const size_t size, bool& swap,
+                   std::vector< BinaryElement >& elements, size_t& headerSize )
+{
+    static const char endHeader[] = "end_header";
+    const size_t searchSize = std::min( size, size_t( 65536 ));
+    const char* end = std::search( data, data + searchSize, endHeader,
+                                   endHeader + sizeof( endHeader ) - 1 );
+    if( end == data + searchSize )
+        return false;
+
+    const char* body = end + sizeof( endHeader ) - 1;
+    while( body < data + size && *body != '\n' )
+        ++body;
+    if( body == data + size )
+        return false;
+    headerSize = body + 1 - data;
+
+    std::istringstream header( std::string( data, end ));
+    std::string line;
+    if( !std::getline( header, line ) || line.compare( 0, 3, "ply" ) != 0 )
+        return false;
+
+    while( std::getline( header, line ))
+    {
+        std::istringstream words( line );
+        std::string keyword;
+        words >> keyword;
+
+        if( keyword == "format" )
+        {
+            std::string format;
+            words >> format;
+            if( format == "binary_little_endian" )
+                swap = !_isLittleEndian();
+            else if( format == "binary_big_endian" )
+                swap = _isLittleEndian();
+            else
+                return false; // ASCII is handled by plyfile
+        }
+        else if( keyword == "element" )
+        {
+            BinaryElement element;
+            words >> element.name >> element.count;
+            element.size = 0;
+            elements.push_back( element );
+        }
+        else if( keyword == "property" )
+        {
+            if( elements.empty( ))
+                return false;
+
+            BinaryElement& element = elements.back();
+            BinaryProperty property;
+            std::string type;
+            words >> type;
+            property.countType = 0;
+            property.offset = element.size;
+
+            if( type == "list" )
+            {
+                std::string countType;
+                words >> countType >> type;
+                property.countType = _getType( countType );
+                if( element.name != "face" || !property.countType )
+                    return false;
+            }
+
+            words >> property.name;
+            property.type = _getType( type );
+            if( !property.type )
+                return false;
+
+            if( property.countType )
+                element.size += _getTypeSize( property.countType ) +
+                                3 * _getTypeSize( property.type );
+            else
+                element.size += _getTypeSize( property.type );
+            element.properties.push_back( property );
+        }
+    }
+    return true;
+}
+}
+
 /*  Contructor.  */
 VertexData::VertexData()
     : _invertFaces( false )
+    , _optimizeVertexCache( false )
 {
     _boundingBox[0] = Vertex( 0.0f );
     _boundingBox[1] = Vertex( 0.0f );
@@ -145,9 +422,126 @@ void VertexData::readTriangles( PlyFile* file, const int nFaces )
 }
 
 
+/*  Read a binary PLY file with triangle faces directly from a memory mapping,
+    converting the vertex and face records in parallel. Returns false if the
+    file is not supported, to fall back to the generic reader.  */
+bool VertexData::_readBinaryPly( const std::string& filename )
+{
+    const MappedFile file( filename );
+    const char* data = file.getData();
+    if( !data )
+        return false;
+
+    bool swap = false;
+    size_t offset = 0;
+    std::vector< BinaryElement > elements;
+    if( !_parseHeader( data, file.getSize(), swap, elements, offset ))
+        return false;
+
+    const char* vertexData = 0;
+    const char* faceData = 0;
+    const BinaryElement* vertexElement = 0;
+    const BinaryElement* faceElement = 0;
+    for( size_t i = 0; i < elements.size(); ++i )
+    {
+        const BinaryElement& element = elements[i];
+        if( element.name == "vertex" )
+        {
+            vertexElement = &element;
+            vertexData = data + offset;
+        }
+        else if( element.name == "face" )
+        {
+            faceElement = &element;
+            faceData = data + offset;
+        }
+        offset += element.count * element.size;
+    }
+    if( !vertexElement || !faceElement || offset > file.getSize( ))
+        return false;
+
+    const BinaryProperty* x = vertexElement->find( "x" );
+    const BinaryProperty* y = vertexElement->find( "y" );
+    const BinaryProperty* z = vertexElement->find( "z" );
+    const BinaryProperty* red = vertexElement->find( "red" );
+    const BinaryProperty* green = vertexElement->find( "green" );
+    const BinaryProperty* blue = vertexElement->find( "blue" );
+    const BinaryProperty* list = faceElement->find( "vertex_indices" );
+    if( !list )
+        list = faceElement->find( "vertex_index" );
+    if( !x || !y || !z || !list || !list->countType ||
+        x->countType || y->countType || z->countType )
+    {
+        return false;
+    }
+
+    const bool readColors = red && green && blue && !red->countType &&
+                            !green->countType && !blue->countType;
+    const ssize_t nVertices = ssize_t( vertexElement->count );
+    const size_t vertexSize = vertexElement->size;
+    vertices.resize( nVertices );
+    colors.resize( readColors ? nVertices : 0 );
+
+#pragma omp parallel for
+    for( ssize_t i = 0; i < nVertices; ++i )
+    {
+        const char* record = vertexData + i * vertexSize;
+        vertices[i] = Vertex( _getValue( record + x->offset, x->type, swap ),
+                              _getValue( record + y->offset, y->type, swap ),
+                              _getValue( record + z->offset, z->type, swap ));
+        if( readColors )
+            colors[i] = Color(
+                uint8_t( _getValue( record + red->offset, red->type, swap )),
+                uint8_t( _getValue( record + green->offset, green->type,
+                                    swap )),
+                uint8_t( _getValue( record + blue->offset, blue->type,
+                                    swap )));
+    }
+
+    const ssize_t nFaces = ssize_t( faceElement->count );
+    const size_t faceSize = faceElement->size;
+    const size_t countSize = _getTypeSize( list->countType );
+    const size_t indexSize = _getTypeSize( list->type );
+    const size_t ind1 = _invertFaces ? 2 : 0;
+    const size_t ind3 = _invertFaces ? 0 : 2;
+    triangles.resize( nFaces );
+
+    int invalid = 0;
+#pragma omp parallel for reduction( +: invalid )
+    for( ssize_t i = 0; i < nFaces; ++i )
+    {
+        const char* record = faceData + i * faceSize + list->offset;
+        if( _getValue( record, list->countType, swap ) != 3. )
+        {
+            ++invalid;
+            continue;
+        }
+
+        const char* indices = record + countSize;
+        Index face[3];
+        for( size_t j = 0; j < 3; ++j )
+            face[j] = Index( _getValue( indices + j * indexSize, list->type,
+                                        swap ));
+        triangles[i] = Triangle( face[ind1], face[1], face[ind3] );
+    }
+
+    if( invalid > 0 ) // record offsets are wrong, let plyfile report it
+    {
+        vertices.clear();
+        colors.clear();
+        triangles.clear();
+        return false;
+    }
+    return true;
+}
+
+
 /*  Open a PLY file and read vertex, color and index data.  */
 bool VertexData::readPlyFile( const std::string& filename )
 {
+    if( _readBinaryPly( filename ))
+        return true;
+
     int     nPlyElems;
     char**  elemNames;
     int     fileType;
@@ -245,31 +639,39 @@ void VertexData::calculateNormals()
     int wrongNormals = 0;
 #endif
 
-    normals.clear();
-    normals.reserve( vertices.size() );
-
     // initialize all normals to zero
-    for( size_t i = 0; i < vertices.size(); ++i )
-        normals.push_back( Normal( 0, 0, 0 ) );
+    normals.assign( vertices.size(), Normal( 0, 0, 0 ));
 
-    // iterate over all triangles and add their normals to adjacent vertices
-#pragma omp parallel for
-    for( ssize_t i = 0; i < ssize_t( triangles.size( )); ++i )
+    // compute the face normals of a block of triangles in parallel, then add
+    // them to the adjacent vertices serially since triangles share vertices
+    const size_t blockSize = 1024 * 1024;
+    std::vector< Normal > faceNormals( std::min( blockSize, triangles.size( )));
+    for( size_t start = 0; start < triangles.size(); start += blockSize )
     {
-        const Index i0 = triangles[i][0];
-        const Index i1 = triangles[i][1];
-        const Index i2 = triangles[i][2];
-        const Normal normal = vertices[i0].compute_normal( vertices[i1],
-                                                           vertices[i2] );
+        const size_t end = std::min( start + blockSize, triangles.size( ));
+
+#pragma omp parallel for
+        for( ssize_t i = ssize_t( start ); i < ssize_t( end ); ++i )
+        {
+            const Triangle& triangle = triangles[i];
+            const Vertex& v0 = vertices[ triangle[0] ];
+            const Vertex& v1 = vertices[ triangle[1] ];
+            const Vertex& v2 = vertices[ triangle[2] ];
+            faceNormals[ i - start ] = v0.compute_normal( v1, v2 );
+        }
+
+        for( size_t i = start; i < end; ++i )
+        {
+            const Normal& normal = faceNormals[ i - start ];
 #ifndef NDEBUG
-        // count emtpy normals in debug mode
-        if( normal.length() == 0.0f )
-            ++wrongNormals; // racy with OpenMP, but not critical
+            // count emtpy normals in debug mode
+            if( normal.length() == 0.0f )
+                ++wrongNormals;
 #endif
-
-        normals[i0] += normal;
-        normals[i1] += normal;
-        normals[i2] += normal;
+            normals[ triangles[i][0] ] += normal;
+            normals[ triangles[i][1] ] += normal;
+            normals[ triangles[i][2] ] += normal;
+        }
     }
 
     // normalize all the normals
@@ -289,12 +691,25 @@ void VertexData::calculateBoundingBox()
 {
     _boundingBox[0] = vertices[0];
     _boundingBox[1] = vertices[0];
-    for( size_t v = 1; v < vertices.size(); ++v )
+
+#pragma omp parallel
+    {
+        BoundingBox box( _boundingBox );
+#pragma omp for nowait
+        for( ssize_t v = 1; v < ssize_t( vertices.size( )); ++v )
+            for( size_t i = 0; i < 3; ++i )
+            {
+                box[0][i] = std::min( box[0][i], vertices[v][i] );
+                box[1][i] = std::max( box[1][i], vertices[v][i] );
+            }
+
+#pragma omp critical
         for( size_t i = 0; i < 3; ++i )
         {
-            _boundingBox[0][i] = std::min( _boundingBox[0][i], vertices[v][i] );
-            _boundingBox[1][i] = std::max( _boundingBox[1][i], vertices[v][i] );
+            _boundingBox[0][i] = std::min( _boundingBox[0][i], box[0][i] );
+            _boundingBox[1][i] = std::max( _boundingBox[1][i], box[1][i] );
         }
+    }
 }
 
 
@@ -424,3 +839,19 @@ void VertexData::sort( const Index start, const Index length, const Axis axis )
     ::sort( triangles.begin() + start, triangles.begin() + start + length,
             _TriangleSort( *this, axis ) );
 }
+
+
+/*  Partition the index data from start to start + length along the given axis,
+    such that all triangles before the median are smaller than the ones after
+    it. Linear instead of the n log n of a full sort.  */
+void VertexData::partition( const Index start, const Index length,
+                            const Axis axis )
+{
+    PLYLIBASSERT( length > 0 );
+    PLYLIBASSERT( start + length <= triangles.size() );
+
+    ::nth_element( triangles.begin() + start,
+                   triangles.begin() + start + length / 2,
+                   triangles.begin() + start + length,
+                   _TriangleSort( *this, axis ));
+}
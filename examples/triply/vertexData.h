@@ -49,6 +49,8 @@ namespace triply
 
         PLYLIB_API bool readPlyFile( const std::string& file );
         PLYLIB_API void sort( const Index start, const Index length, const Axis axis );
+        PLYLIB_API void partition( const Index start, const Index length,
+                                   const Axis axis );
         PLYLIB_API void scale( const float baseSize = 2.0f );
         PLYLIB_API void calculateNormals();
         PLYLIB_API void calculateBoundingBox();
@@ -57,6 +59,10 @@ namespace triply
 
         void useInvertedFaces() { _invertFaces = true; }
 
+        /*  Reorder the triangles of each leaf for the vertex cache.  */
+        void useVertexCacheOptimization() { _optimizeVertexCache = true; }
+        bool optimizeVertexCache() const { return _optimizeVertexCache; }
+
         std::vector< Vertex >   vertices;
         std::vector< Color >    colors;
         std::vector< Normal >   normals;
@@ -66,9 +72,11 @@ namespace triply
         void readVertices( PlyFile* file, const int nVertices, 
                            const bool readColors );
         void readTriangles( PlyFile* file, const int nFaces );
+        bool _readBinaryPly( const std::string& filename );
 
         BoundingBox _boundingBox;
         bool        _invertFaces;
+        bool        _optimizeVertexCache;
     };
 }
 
@@ -113,6 +113,18 @@ bool Application::run( co::Object* frameData )
     return _impl->run( frameData );
 }
 
+bool Application::addBatchedObject( BatchedObject* object,
+                                    const uint32_t type )
+{
+    if( !_impl || !_impl->isMaster( ))
+    {
+        LBERROR << "Batched objects can only be added to an initialized "
+                << "master application" << std::endl;
+        return false;
+    }
+    return _impl->getConfig()->addBatchedObject( object, type );
+}
+
 bool Application::exit()
 {
     bool retVal = true;
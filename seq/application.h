@@ -71,6 +71,23 @@ public:
      */
     SEQ_API virtual bool run( co::Object* frameData );
 
+    /**
+     * Add an object committed in batch with the frame data.
+     *
+     * All dirty batched objects are serialized into one delta at the beginning
+     * of each frame, and applied in one pass when the render clients
+     * synchronize the frame. The instances on the render clients are created
+     * using createObject() with the given type, and are accessible in the
+     * order of their addition using Renderer::getBatchedObjects(). Must be
+     * called on the master application instance after init().
+     *
+     * @param object the batched object.
+     * @param type the type passed to createObject() on the render clients.
+     * @return true on success, false otherwise.
+     * @version 1.8
+     */
+    SEQ_API bool addBatchedObject( BatchedObject* object, const uint32_t type );
+
     /**
      * Exit this application instance.
      *
@@ -0,0 +1,68 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQSEQUEL_BATCHEDOBJECT_H
+#define EQSEQUEL_BATCHEDOBJECT_H
+
+#include <seq/types.h>
+#include <co/dataIStream.h>    // used inline
+#include <co/dataOStream.h>    // used inline
+#include <co/serializable.h>   // base class
+
+namespace seq
+{
+    /**
+     * A distributed object committed in batch with the frame data.
+     *
+     * Batched objects are not registered individually. The changes of all
+     * dirty batched objects are serialized into the single object map delta of
+     * each frame, and applied on all render clients when they synchronize to
+     * the frame. Subclasses implement serialize() and deserialize(), and mark
+     * their changes using setDirty() as for any co::Serializable.
+     *
+     * @sa Application::addBatchedObject()
+     * @version 1.8
+     */
+    class BatchedObject : public co::Serializable
+    {
+    public:
+        /** Destruct this batched object. @version 1.8 */
+        virtual ~BatchedObject() {}
+
+    protected:
+        /** Construct a new batched object. @version 1.8 */
+        BatchedObject() {}
+
+    private:
+        friend class detail::ObjectMap;
+
+        void _serialize( co::DataOStream& os, const uint64_t dirtyBits )
+        {
+            os << dirtyBits;
+            serialize( os, dirtyBits );
+        }
+
+        void _deserialize( co::DataIStream& is )
+        {
+            uint64_t dirtyBits;
+            is >> dirtyBits;
+            deserialize( is, dirtyBits );
+        }
+
+        void _resetDirty() { unsetDirty( DIRTY_ALL ); }
+    };
+}
+#endif // EQSEQUEL_BATCHEDOBJECT_H
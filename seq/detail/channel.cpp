@@ -32,6 +32,7 @@ namespace detail
 
 Channel::Channel( eq::Window* parent )
         : eq::Channel( parent )
+        , _preparing( false )
 {}
 
 Channel::~Channel()
@@ -98,6 +99,10 @@ void Channel::frameFinish( const uint128_t& frameID, const uint32_t frameNumber)
 
 void Channel::frameClear( const uint128_t& )
 {
+    // prepare the following draw while clearing
+    getPipe()->startPrepare();
+    _preparing = true;
+
     seq::Renderer* const renderer = getRenderer();
     co::Object* const frameData = renderer->getFrameData();
     renderer->clear( frameData );
@@ -105,6 +110,12 @@ void Channel::frameClear( const uint128_t& )
 
 void Channel::frameDraw( const uint128_t& )
 {
+    Pipe* pipe = getPipe();
+    if( !_preparing )
+        pipe->startPrepare();
+    pipe->finishPrepare();
+    _preparing = false;
+
     seq::Renderer* const renderer = getRenderer();
     co::Object* const frameData = renderer->getFrameData();
     renderer->draw( frameData );
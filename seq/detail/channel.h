@@ -65,6 +65,7 @@ namespace detail
         virtual void frameViewFinish( const uint128_t& frameID );
 
     private:
+        bool _preparing; //!< Renderer::prepare() started by frameClear()
     };
 }
 }
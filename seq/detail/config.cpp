@@ -47,5 +47,13 @@ co::Object* Config::getInitData()
     return _objects->getInitData( initData );
 }
 
+bool Config::addBatchedObject( BatchedObject* object, const uint32_t type )
+{
+    LBASSERT( _objects );
+    if( !_objects )
+        return false;
+    return _objects->addBatched( object, type );
+}
+
 }
 }
@@ -47,6 +47,7 @@ namespace detail
         virtual void unmapData() { /* nop */ }
 
         co::Object* getInitData();
+        bool addBatchedObject( BatchedObject* object, const uint32_t type );
 
     protected:
         virtual ~Config() {}
@@ -17,21 +17,70 @@
 
 #include "objectMap.h"
 
+#include <seq/batchedObject.h>
 #include <eq/client/config.h>
 #include <co/dataIStream.h>
 #include <co/dataOStream.h>
+#include <boost/foreach.hpp>
+
+#include <algorithm>
+#include <limits>
 
 namespace seq
 {
 namespace detail
 {
 
+namespace
+{
+/** Terminates the list of changed objects in a batched delta. */
+const uint64_t _endOfBatch = std::numeric_limits< uint64_t >::max();
+}
+
 ObjectMap::ObjectMap( eq::Config& config, co::ObjectFactory &factory )
         : co::ObjectMap( config, factory )
+        , _factory( factory )
+        , _nCommitted( 0 )
+        , _ownsBatched( false )
 {}
 
 ObjectMap::~ObjectMap()
 {
+    if( _ownsBatched )
+    {
+        BOOST_FOREACH( BatchedObject* object, _batched )
+            delete object;
+    }
+}
+
+bool ObjectMap::addBatched( BatchedObject* object, const uint32_t type )
+{
+    LBASSERT( object );
+    LBASSERT( !_ownsBatched );
+    if( !object || _ownsBatched ||
+        std::find( _batched.begin(), _batched.end(), object ) !=
+            _batched.end( ))
+    {
+        return false;
+    }
+
+    _batched.push_back( object );
+    _batchedTypes.push_back( type );
+    setDirty( DIRTY_BATCHED );
+    return true;
+}
+
+uint128_t ObjectMap::commit( const uint32_t incarnation )
+{
+    BOOST_FOREACH( const BatchedObject* object, _batched )
+    {
+        if( object->isDirty( ))
+        {
+            setDirty( DIRTY_BATCHED );
+            break;
+        }
+    }
+    return co::ObjectMap::commit( incarnation );
 }
 
 void ObjectMap::serialize( co::DataOStream& os, const uint64_t dirtyBits )
@@ -42,6 +91,8 @@ void ObjectMap::serialize( co::DataOStream& os, const uint64_t dirtyBits )
         os << _initData;
     if( dirtyBits & DIRTY_FRAMEDATA )
         os << _frameData;
+    if( dirtyBits & DIRTY_BATCHED )
+        _serializeBatched( os, dirtyBits == DIRTY_ALL );
 }
 
 void ObjectMap::deserialize( co::DataIStream& is, const uint64_t dirtyBits )
@@ -52,6 +103,94 @@ void ObjectMap::deserialize( co::DataIStream& is, const uint64_t dirtyBits )
         is >> _initData;
     if( dirtyBits & DIRTY_FRAMEDATA )
         is >> _frameData;
+    if( dirtyBits & DIRTY_BATCHED )
+        _deserializeBatched( is, dirtyBits == DIRTY_ALL );
+}
+
+void ObjectMap::_serializeBatched( co::DataOStream& os, const bool full )
+{
+    // instance data for new slaves, does not consume the changes
+    if( full )
+    {
+        os << uint64_t( _batched.size( ));
+        for( size_t i = 0; i < _batched.size(); ++i )
+        {
+            os << _batchedTypes[i];
+            _batched[i]->_serialize( os, DIRTY_ALL );
+        }
+        return;
+    }
+
+    // delta: all data of new objects, followed by the changed objects
+    os << uint64_t( _batched.size() - _nCommitted );
+    for( size_t i = _nCommitted; i < _batched.size(); ++i )
+    {
+        os << _batchedTypes[i];
+        _batched[i]->_serialize( os, DIRTY_ALL );
+        _batched[i]->_resetDirty();
+    }
+
+    for( size_t i = 0; i < _nCommitted; ++i )
+    {
+        BatchedObject* object = _batched[i];
+        if( !object->isDirty( ))
+            continue;
+
+        os << uint64_t( i );
+        object->_serialize( os, object->getDirty( ));
+        object->_resetDirty();
+    }
+    os << _endOfBatch;
+    _nCommitted = _batched.size();
+}
+
+void ObjectMap::_deserializeBatched( co::DataIStream& is, const bool full )
+{
+    _ownsBatched = true;
+
+    uint64_t nNew = 0;
+    is >> nNew;
+    for( uint64_t i = 0; i < nNew; ++i )
+    {
+        if( !_createBatched( is ))
+            return; // can't skip the unknown data, the rest is unusable
+    }
+
+    if( full )
+        return;
+
+    for( uint64_t i = 0; ; )
+    {
+        is >> i;
+        if( i == _endOfBatch )
+            return;
+
+        LBASSERT( i < _batched.size( ));
+        _batched[ i ]->_deserialize( is );
+    }
+}
+
+bool ObjectMap::_createBatched( co::DataIStream& is )
+{
+    uint32_t type = 0;
+    is >> type;
+
+    co::Object* object = _factory.createObject( type );
+    BatchedObject* batched = dynamic_cast< BatchedObject* >( object );
+    LBASSERTINFO( batched, "Factory did not create a BatchedObject for type "
+                  << type );
+    if( !batched )
+    {
+        LBERROR << "Can't create batched object of type " << type
+                << std::endl;
+        delete object;
+        return false;
+    }
+
+    batched->_deserialize( is );
+    _batched.push_back( batched );
+    _batchedTypes.push_back( type );
+    return true;
 }
 
 void ObjectMap::setInitData( co::Object* object )
@@ -40,6 +40,15 @@ namespace detail
             { return map( _initData, object ); }
         co::Object* getFrameData() { return map( _frameData ); }
 
+        /** Add an object committed with the next frame data. */
+        bool addBatched( BatchedObject* object, const uint32_t type );
+
+        /** @return the batched objects, in the order of their addition. */
+        const BatchedObjects& getBatchedObjects() const { return _batched; }
+
+        uint128_t commit( const uint32_t incarnation = CO_COMMIT_NEXT )
+            override;
+
     protected:
         virtual void serialize( co::DataOStream& os, const uint64_t dirtyBits );
         virtual void deserialize( co::DataIStream& is,
@@ -49,11 +58,22 @@ namespace detail
         uint128_t _initData;
         uint128_t _frameData;
 
+        co::ObjectFactory& _factory;
+        BatchedObjects _batched;
+        std::vector< uint32_t > _batchedTypes;
+        size_t _nCommitted; //!< batched objects known to the slaves
+        bool _ownsBatched; //!< batched objects were created by the factory
+
+        void _serializeBatched( co::DataOStream& os, bool full );
+        void _deserializeBatched( co::DataIStream& is, bool full );
+        bool _createBatched( co::DataIStream& is );
+
         /** The changed parts of the object since the last serialize(). */
         enum DirtyBits
         {
             DIRTY_INITDATA    = co::ObjectMap::DIRTY_CUSTOM << 0, // 4
-            DIRTY_FRAMEDATA   = co::ObjectMap::DIRTY_CUSTOM << 1  // 8
+            DIRTY_FRAMEDATA   = co::ObjectMap::DIRTY_CUSTOM << 1, // 8
+            DIRTY_BATCHED     = co::ObjectMap::DIRTY_CUSTOM << 2  // 16
         };
     };
 }
@@ -25,21 +25,74 @@
 #include <seq/application.h>
 #include <seq/error.h>
 #include <seq/renderer.h>
+#include <lunchbox/monitor.h>
+#include <lunchbox/thread.h>
 
 namespace seq
 {
 namespace detail
 {
+/** Runs Renderer::prepare() for the pipe thread, one task at a time. */
+class PrepareThread : public lunchbox::Thread
+{
+public:
+    explicit PrepareThread( seq::Renderer& renderer )
+        : _renderer( renderer )
+        , _frameData( 0 )
+        , _state( STATE_IDLE )
+    {}
+
+    void run() override
+    {
+        for( ;; )
+        {
+            if( _state.waitNE( STATE_IDLE ) == STATE_STOPPED )
+                return;
+            _renderer.prepare( _frameData );
+            _state = STATE_IDLE;
+        }
+    }
+
+    void post( co::Object* frameData )
+    {
+        finish(); // a clear not followed by a draw
+        _frameData = frameData;
+        _state = STATE_PREPARING;
+    }
+
+    void finish() { _state.waitEQ( STATE_IDLE ); }
+
+    void stop()
+    {
+        finish();
+        _state = STATE_STOPPED;
+        join();
+    }
+
+private:
+    enum State
+    {
+        STATE_IDLE,
+        STATE_PREPARING,
+        STATE_STOPPED
+    };
+
+    seq::Renderer& _renderer;
+    co::Object* _frameData;
+    lunchbox::Monitor< State > _state;
+};
 
 Pipe::Pipe( eq::Node* parent )
         : eq::Pipe( parent )
         , _objects( 0 )
         , _renderer( 0 )
+        , _prepareThread( 0 )
 {}
 
 Pipe::~Pipe()
 {
     LBASSERT( !_objects );
+    LBASSERT( !_prepareThread );
 }
 
 seq::Application* Pipe::getApplication()
@@ -73,6 +126,12 @@ co::Object* Pipe::getFrameData()
     return 0;
 }
 
+const BatchedObjects& Pipe::getBatchedObjects()
+{
+    LBASSERT( _objects );
+    return _objects->getBatchedObjects();
+}
+
 bool Pipe::configInit( const uint128_t& initID )
 {
     if( !eq::Pipe::configInit( initID ))
@@ -88,6 +147,18 @@ bool Pipe::configInit( const uint128_t& initID )
     }
     getRendererImpl()->setPipe( this );
 
+    if( _renderer->usePrepare( ))
+    {
+        _prepareThread = new PrepareThread( *_renderer );
+        if( !_prepareThread->start( ))
+        {
+            LBWARN << "Prepare thread start failed, preparing on pipe thread"
+                   << std::endl;
+            delete _prepareThread;
+            _prepareThread = 0;
+        }
+    }
+
     if( _mapData( initID ))
         return true;
 
@@ -97,6 +168,12 @@ bool Pipe::configInit( const uint128_t& initID )
 
 bool Pipe::configExit()
 {
+    if( _prepareThread )
+    {
+        _prepareThread->stop();
+        delete _prepareThread;
+        _prepareThread = 0;
+    }
     _unmapData();
 
     if( _renderer )
@@ -115,6 +192,20 @@ void Pipe::frameStart( const uint128_t& frameID, const uint32_t frameNumber )
     return eq::Pipe::frameStart( frameID, frameNumber );
 }
 
+void Pipe::startPrepare()
+{
+    if( _prepareThread )
+        _prepareThread->post( getFrameData( ));
+    else if( _renderer->usePrepare( ))
+        _renderer->prepare( getFrameData( ));
+}
+
+void Pipe::finishPrepare()
+{
+    if( _prepareThread )
+        _prepareThread->finish();
+}
+
 bool Pipe::_mapData( const uint128_t& initID )
 {
     LBASSERT( !_objects );
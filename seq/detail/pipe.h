@@ -25,6 +25,8 @@ namespace seq
 {
 namespace detail
 {
+    class PrepareThread;
+
     class Pipe : public eq::Pipe
     {
     public:
@@ -38,6 +40,16 @@ namespace detail
         seq::Renderer* getRenderer() { return _renderer; }
         detail::Renderer* getRendererImpl();
         co::Object* getFrameData();
+        const BatchedObjects& getBatchedObjects();
+        //@}
+
+        /** @name Operations. */
+        //@{
+        /** Start Renderer::prepare() on the worker thread, if used. */
+        void startPrepare();
+
+        /** Wait for the completion of the last startPrepare(). */
+        void finishPrepare();
         //@}
 
     protected:
@@ -55,6 +67,7 @@ namespace detail
 
         ObjectMap* _objects;
         seq::Renderer* _renderer;
+        PrepareThread* _prepareThread;
     };
 }
 }
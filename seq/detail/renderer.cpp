@@ -48,6 +48,11 @@ co::Object* Renderer::getFrameData()
     return _pipe->getFrameData();
 }
 
+const BatchedObjects& Renderer::getBatchedObjects()
+{
+    return _pipe->getBatchedObjects();
+}
+
 const ObjectManager& Renderer::getObjectManager() const
 {
     return _window->getObjectManager();
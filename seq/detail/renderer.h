@@ -35,6 +35,7 @@ namespace detail
         /** @name Data Access. */
         //@{
         co::Object* getFrameData();
+        const BatchedObjects& getBatchedObjects();
         const GLEWContext* glewGetContext() const { return _glewContext; }
 
         const ObjectManager& getObjectManager() const;
@@ -40,6 +40,11 @@ co::Object* Renderer::getFrameData()
     return _impl->getFrameData();
 }
 
+const BatchedObjects& Renderer::getBatchedObjects()
+{
+    return _impl->getBatchedObjects();
+}
+
 const ObjectManager& Renderer::getObjectManager() const
 {
     return _impl->getObjectManager();
@@ -27,8 +27,8 @@ namespace seq
 /**
  * A renderer instance.
  *
- * All calls to one renderer instance are guaranteed to be executed from a
- * single thread.
+ * All calls to one renderer instance, except prepare(), are guaranteed to be
+ * executed from a single thread.
  */
 class Renderer : public co::ObjectFactory
 {
@@ -107,6 +107,28 @@ public:
      */
     virtual void draw( co::Object* frameData ) = 0;
 
+    /**
+     * Prepare the rendering of the scene on a worker thread.
+     *
+     * Called for each draw() if usePrepare() returns true. The call runs
+     * concurrently with clear() of the same task, without a current rendering
+     * context, and with the rendering parameters of the task, e.g.,
+     * getFrustum() and getModelMatrix(). Typically used for culling and
+     * building render lists, which the following draw() submits to OpenGL.
+     *
+     * @param frameData the renderer's instance of the object passed to
+     *                  Config::run.
+     * @version 1.9
+     */
+    virtual void prepare( co::Object* frameData LB_UNUSED ) {}
+
+    /**
+     * @return true if prepare() is to be called before each draw(), false
+     *         otherwise.
+     * @version 1.9
+     */
+    virtual bool usePrepare() const { return false; }
+
     /**
      * Update the near and far planes to tightly enclose the given sphere.
      *
@@ -158,6 +180,14 @@ public:
     detail::Renderer* getImpl() { return _impl; } //!< @internal
     co::Object* getFrameData(); // @warning experimental
 
+    /**
+     * @return the instances of the batched objects, synchronized to the
+     *         current frame.
+     * @sa Application::addBatchedObject()
+     * @version 1.8
+     */
+    SEQ_API const BatchedObjects& getBatchedObjects();
+
     /** @return the application instance for this renderer. @version 1.0 */
     Application& getApplication() { return app_; }
 
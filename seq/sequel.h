@@ -32,6 +32,7 @@
  * underlying Equalizer framework.
  */
 #include <seq/application.h>
+#include <seq/batchedObject.h>
 #include <seq/objectType.h>
 #include <seq/renderer.h>
 #include <eq/eq.h>
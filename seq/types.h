@@ -33,11 +33,13 @@ using eq::util::ObjectManager;
 using namespace eq::util::shader;
 
 class Application;
+class BatchedObject;
 class ObjectFactory;
 class Renderer;
 class ViewData;
 
 typedef lunchbox::RefPtr< Application > ApplicationPtr;
+typedef std::vector< BatchedObject* > BatchedObjects;
 
 /** @cond IGNORE */
 namespace detail
@@ -20,10 +20,13 @@
 #include "ddsbase.h"
 #include "hlp.h"
 
+#include <eVolve/brickFormat.h>
+
 #pragma warning( disable: 4275 )
 #include <boost/program_options.hpp>
 #pragma warning( default: 4275 )
 #include <math.h>
+#include <string.h>
 #ifndef _MSC_VER
 #  include <stdint.h>
 #endif
@@ -48,6 +51,7 @@ namespace eVolve
 using namespace std;
 using hlpFuncs::clip;
 using hlpFuncs::min;
+using hlpFuncs::max;
 using hlpFuncs::hFile;
 
 static int lFailed( const char* msg, int result=1 )
@@ -56,6 +60,328 @@ static int lFailed( const char* msg, int result=1 )
     return result;
 }
 
+/** Slices per slab of the out-of-core conversions, see --slab. */
+static unsigned _slabDepth = 32;
+
+/** Reads consecutive z-slices of a volume from a file or from memory. */
+class SliceSource
+{
+public:
+    /** Extract all channels of each voxel. */
+    static const unsigned ALL_CHANNELS = ~0u;
+
+    /**
+     * Read from a volume file with 'bytes' per voxel, returning the given
+     * channel or all channels. Missing data at the end reads as zero.
+     */
+    SliceSource( const string& filename, const unsigned w, const unsigned h,
+                 const unsigned bytes, const unsigned channel )
+        : _file( filename.c_str(), ifstream::in | ifstream::binary )
+        , _data( 0 )
+        , _voxels( size_t( w ) * h )
+        , _bytes( bytes )
+        , _channel( channel )
+    {}
+
+    /** Read from a one byte per voxel volume in memory. */
+    SliceSource( const unsigned char* data, const unsigned w,
+                 const unsigned h )
+        : _data( data )
+        , _voxels( size_t( w ) * h )
+        , _bytes( 1 )
+        , _channel( 0 )
+    {}
+
+    bool isOpen() const { return _data || _file.is_open(); }
+
+    /** @return the size of one output slice in bytes. */
+    size_t getSliceSize() const
+        { return _channel == ALL_CHANNELS ? _voxels * _bytes : _voxels; }
+
+    /** Read the slices [z, z+n) into dst. @return false on error. */
+    bool read( const unsigned z, const unsigned n, unsigned char* dst )
+    {
+        const size_t size = _voxels * _bytes * n;
+        if( _data )
+        {
+            memcpy( dst, _data + _voxels * z, size );
+            return true;
+        }
+
+        const bool direct = _bytes == 1 || _channel == ALL_CHANNELS;
+        _buffer.resize( direct ? 0 : size );
+        char* in = reinterpret_cast< char* >( direct ? dst : &_buffer[0] );
+
+        _file.clear();
+        _file.seekg( _voxels * _bytes * z, ios::beg );
+        _file.read( in, size );
+        const size_t nRead = _file ? size : size_t( _file.gcount( ));
+        memset( in + nRead, 0, size - nRead );
+        if( _file.bad( ))
+            return false;
+
+        if( !direct )
+        {
+            const size_t nVoxels = _voxels * n;
+            for( size_t i = 0; i < nVoxels; ++i )
+                dst[i] = _buffer[ i * _bytes + _channel ];
+        }
+        return true;
+    }
+
+private:
+    ifstream _file;
+    const unsigned char* const _data;
+    const size_t _voxels;
+    const unsigned _bytes;
+    const unsigned _channel;
+    vector< unsigned char > _buffer;
+};
+
+/** Compute the gradients and density of one slice from its neighbours.
+    The gradient sums of a row are computed first, in a loop without
+    dependencies which the compiler vectorizes.
+*/
+static void computeGradientSlice( const unsigned char* prv,
+                                  const unsigned char* cur,
+                                  const unsigned char* nxt,
+                                  const unsigned w, const unsigned h,
+                                  unsigned char* out )
+{
+    memset( out, 0, size_t( w ) * h * 4 );
+    if( w < 3 || h < 3 )
+        return;
+
+    const int ws = static_cast<int>( w );
+    vector< int > gxs( w ), gys( w ), gzs( w );
+
+    for( unsigned y=1; y<h-1; y++ )
+    {
+        const unsigned char* const curP = cur + size_t( y ) * w;
+        const unsigned char* const prvP = prv + size_t( y ) * w;
+        const unsigned char* const nxtP = nxt + size_t( y ) * w;
+        int* const gx = &gxs[0];
+        int* const gy = &gys[0];
+        int* const gz = &gzs[0];
+
+        for( int x=1; x<ws-1; x++ )
+        {
+            gx[x] =
+                  nxtP[ x+ws+1 ]+ 3*curP[ x+ws+1 ]+   prvP[ x+ws+1 ]+
+                3*nxtP[ x   +1 ]+ 6*curP[ x   +1 ]+ 3*prvP[ x   +1 ]+
+                  nxtP[ x-ws+1 ]+ 3*curP[ x-ws+1 ]+   prvP[ x-ws+1 ]-
+
+                  nxtP[ x+ws-1 ]- 3*curP[ x+ws-1 ]-   prvP[ x+ws-1 ]-
+                3*nxtP[ x   -1 ]- 6*curP[ x   -1 ]- 3*prvP[ x   -1 ]-
+                  nxtP[ x-ws-1 ]- 3*curP[ x-ws-1 ]-   prvP[ x-ws-1 ];
+
+            gy[x] =
+                  nxtP[ x+ws+1 ]+ 3*curP[ x+ws+1 ]+   prvP[ x+ws+1 ]+
+                3*nxtP[ x+ws   ]+ 6*curP[ x+ws   ]+ 3*prvP[ x+ws   ]+
+                  nxtP[ x+ws-1 ]+ 3*curP[ x+ws-1 ]+   prvP[ x+ws-1 ]-
+
+                  nxtP[ x-ws+1 ]- 3*curP[ x-ws+1 ]-   prvP[ x-ws+1 ]-
+                3*nxtP[ x-ws   ]- 6*curP[ x-ws   ]- 3*prvP[ x-ws   ]-
+                  nxtP[ x-ws-1 ]- 3*curP[ x-ws-1 ]-   prvP[ x-ws-1 ];
+
+            gz[x] =
+                  nxtP[ x+ws+1 ]+ 3*nxtP[ x   +1 ]+   nxtP[ x-ws+1 ]+
+                3*nxtP[ x+ws   ]+ 6*nxtP[ x      ]+ 3*nxtP[ x-ws   ]+
+                  nxtP[ x+ws-1 ]+ 3*nxtP[ x   -1 ]+   nxtP[ x-ws-1 ]-
+
+                  prvP[ x+ws+1 ]- 3*prvP[ x   +1 ]-   prvP[ x-ws+1 ]-
+                3*prvP[ x+ws   ]- 6*prvP[ x      ]- 3*prvP[ x-ws   ]-
+                  prvP[ x+ws-1 ]- 3*prvP[ x   -1 ]-   prvP[ x-ws-1 ];
+        }
+
+        unsigned char* const outP = out + size_t( y ) * w * 4;
+        for( int x=1; x<ws-1; x++ )
+        {
+            const int length = static_cast<int>(
+                sqrt( double( gx[x]*gx[x] + gy[x]*gy[x] + gz[x]*gz[x] ) + 1 ));
+
+            outP[ x*4    ] = static_cast<unsigned char>(
+                                 ( gx[x]*255/length + 255 )/2 );
+            outP[ x*4 +1 ] = static_cast<unsigned char>(
+                                 ( gy[x]*255/length + 255 )/2 );
+            outP[ x*4 +2 ] = static_cast<unsigned char>(
+                                 ( gz[x]*255/length + 255 )/2 );
+            outP[ x*4 +3 ] = curP[x];
+        }
+    }
+}
+
+/** Writes the bricks of one level from a stream of its z-slices, and feeds
+    the downsampled slices to the next level. The brick offsets are known
+    upfront, so all levels are written while streaming level 0 and only one
+    slab of bricks is kept per level.
+*/
+class LevelWriter
+{
+public:
+    LevelWriter( ofstream& file, const bricks::Header& header,
+                 const unsigned level, const size_t firstBrick,
+                 const uint64_t dataOffset, vector< bricks::Info >& infos,
+                 LevelWriter* next )
+        : _file( file )
+        , _infos( infos )
+        , _next( next )
+        , _w( bricks::getLevelSize( header.width, level ))
+        , _h( bricks::getLevelSize( header.height, level ))
+        , _d( bricks::getLevelSize( header.depth, level ))
+        , _bytes( header.bytes )
+        , _brickSize( header.brickSize )
+        , _nX( bricks::getNumBricks( _w, _brickSize ))
+        , _nY( bricks::getNumBricks( _h, _brickSize ))
+        , _brickBytes( size_t( _brickSize ) * _brickSize * _brickSize *
+                       _bytes )
+        , _firstBrick( firstBrick )
+        , _dataOffset( dataOffset )
+        , _sliceSize( size_t( _w ) * _h * _bytes )
+        , _slab( _sliceSize * _brickSize )
+        , _bricks( _brickBytes * _nX * _nY )
+        , _z( 0 )
+    {
+        if( _next )
+        {
+            _even.resize( _sliceSize );
+            _down.resize( _next->_sliceSize );
+        }
+    }
+
+    /** Add the next slice of this level. @return false on write errors. */
+    bool addSlice( const unsigned char* slice )
+    {
+        memcpy( &_slab[ ( _z % _brickSize ) * _sliceSize ], slice,
+                _sliceSize );
+
+        if( _next )
+        {
+            // pairs of slices, the last one of an odd depth pairs with itself
+            if( _z % 2 == 1 )
+            {
+                if( !_downsample( &_even[0], slice ))
+                    return false;
+            }
+            else if( _z == _d - 1 )
+            {
+                if( !_downsample( slice, slice ))
+                    return false;
+            }
+            else
+                memcpy( &_even[0], slice, _sliceSize );
+        }
+
+        ++_z;
+        if( _z % _brickSize == 0 || _z == _d )
+            return _writeSlab();
+        return true;
+    }
+
+private:
+    ofstream& _file;
+    vector< bricks::Info >& _infos;
+    LevelWriter* const _next;
+    const unsigned _w, _h, _d;
+    const unsigned _bytes;
+    const unsigned _brickSize;
+    const unsigned _nX, _nY;
+    const size_t _brickBytes;
+    const size_t _firstBrick;
+    const uint64_t _dataOffset;
+    const size_t _sliceSize;
+    vector< unsigned char > _slab; //!< the slices of the current brick row
+    vector< unsigned char > _bricks; //!< the bricks of the current slab
+    vector< unsigned char > _even; //!< the last even slice
+    vector< unsigned char > _down; //!< the downsampled slice
+    unsigned _z; //!< the number of slices added
+
+    /** Downsample two slices into one slice of the next level, averaging
+        all channels of 2x2x2 voxels. */
+    bool _downsample( const unsigned char* a, const unsigned char* b )
+    {
+        const unsigned wD = _next->_w;
+        const unsigned hD = _next->_h;
+        const int nRows = int( hD );
+
+#pragma omp parallel for
+        for( int y = 0; y < nRows; ++y )
+        {
+            const size_t sy0 = 2*y;
+            const size_t sy1 = min( 2*y + 1, int( _h ) - 1 );
+            for( unsigned x = 0; x < wD; ++x )
+            {
+                const size_t sx0 = 2*x;
+                const size_t sx1 = min( 2*x + 1, _w - 1 );
+                const size_t i0 = ( sy0*_w + sx0 )*_bytes;
+                const size_t i1 = ( sy0*_w + sx1 )*_bytes;
+                const size_t i2 = ( sy1*_w + sx0 )*_bytes;
+                const size_t i3 = ( sy1*_w + sx1 )*_bytes;
+                unsigned char* out = &_down[ ( size_t( y )*wD + x )*_bytes ];
+
+                for( unsigned c = 0; c < _bytes; ++c )
+                {
+                    const unsigned sum =
+                        a[ i0+c ] + a[ i1+c ] + a[ i2+c ] + a[ i3+c ] +
+                        b[ i0+c ] + b[ i1+c ] + b[ i2+c ] + b[ i3+c ];
+                    out[c] = static_cast<unsigned char>( ( sum + 4 ) / 8 );
+                }
+            }
+        }
+        return _next->addSlice( &_down[0] );
+    }
+
+    /** Write the bricks of the current slab, repeating border voxels. */
+    bool _writeSlab()
+    {
+        const unsigned bz = ( _z - 1 ) / _brickSize;
+        const unsigned nSlices = _z - bz * _brickSize;
+        const size_t rowBrick = _firstBrick + size_t( bz ) * _nX * _nY;
+        const int nBricks = int( _nX * _nY );
+
+#pragma omp parallel for
+        for( int i = 0; i < nBricks; ++i )
+        {
+            const unsigned bx = i % _nX;
+            const unsigned by = i / _nX;
+            unsigned char minValue = 255;
+            unsigned char maxValue = 0;
+            unsigned char* out = &_bricks[ i * _brickBytes ];
+
+            for( unsigned z = 0; z < _brickSize; ++z )
+            for( unsigned y = 0; y < _brickSize; ++y )
+            {
+                const unsigned sz = min( z, nSlices-1 );
+                const unsigned sy = min( by*_brickSize + y, _h-1 );
+                const unsigned char* row = &_slab[ sz*_sliceSize +
+                                                   size_t( sy )*_w*_bytes ];
+                for( unsigned x = 0; x < _brickSize; ++x )
+                {
+                    const unsigned sx = min( bx*_brickSize + x, _w-1 );
+                    const unsigned char* in = row + size_t( sx )*_bytes;
+                    for( unsigned c = 0; c < _bytes; ++c )
+                        *out++ = in[c];
+
+                    const unsigned char value = in[ _bytes-1 ];
+                    minValue = min( minValue, value );
+                    maxValue = max( maxValue, value );
+                }
+            }
+
+            bricks::Info& info = _infos[ rowBrick + i ];
+            memset( &info, 0, sizeof( info ));
+            info.offset   = _dataOffset + ( rowBrick + i ) * _brickBytes;
+            info.minValue = minValue;
+            info.maxValue = maxValue;
+        }
+
+        // the bricks of one row are consecutive in the file
+        _file.seekp( _infos[ rowBrick ].offset, ios::beg );
+        _file.write( (char*)( &_bricks[0] ), _bricks.size( ));
+        return _file.good();
+    }
+};
+
 int RawConverter::parseArguments( int argc, char** argv )
 {
     try // command line parsing
@@ -76,6 +402,7 @@ int RawConverter::parseArguments( int argc, char** argv )
         bool derToRaw(false);
         bool rawToRaw(false);
         bool pvmToRaw(false);
+        bool rawToBricks(false);
         std::string sourcePath("");
         std::string destinationPath("");
 
@@ -100,6 +427,10 @@ int RawConverter::parseArguments( int argc, char** argv )
               "raw+derivatives -> raw")
             ( "pvm,p", po::bool_switch(&pvmToRaw)->default_value(false),
               "pvm[+sav] -> raw+derivatives+vhf" )
+            ( "brk,b", po::bool_switch(&rawToBricks)->default_value(false),
+              "raw[+derivatives] -> bricked volume" )
+            ( "slab", po::value<unsigned>(&_slabDepth),
+              "slices processed in parallel per slab (default 32)")
             ( "dst,d", po::value<std::string>(&destinationPath),
               "destination file, e.g. Bucky32x32x32_d.raw" )
             ( "src,s", po::value<std::string>(&sourcePath),
@@ -141,6 +472,10 @@ int RawConverter::parseArguments( int argc, char** argv )
             return RawConverter::PvmSavToRawDerVhfConverter(
                 sourcePath, destinationPath );
 
+        if( rawToBricks ) // raw -> bricks
+            return RawConverter::RawToBricksConverter(
+                sourcePath, destinationPath );
+
         if( cmpRawDerivVhf ) // cmp raw+derivations+vhf
             return RawConverter::CompareTwoRawDerVhf(
                 sourcePath, destinationPath );
@@ -190,7 +525,7 @@ static void CreateTransferFunc( int t, unsigned char *transfer );
 
 
 static int calculateAndSaveDerivatives( const string& dst,
-                                        unsigned char *volume,
+                                        SliceSource& source,
                                         const unsigned w,
                                         const unsigned h,
                                         const unsigned d  );
@@ -477,30 +812,13 @@ int RawConverter::RawToRawPlusDerivativesConverter( const string& src,
     std::cout << "Creating derivatives for raw model: "
            << src << " " << w << " x " << h << " x " << d << endl;
 
-//read model
-    vector<unsigned char> volume( w*h*d, 0 );
-
-    std::cout << "Reading model" << endl;
+//calculate and save derivatives
     {
-        ifstream file( src.c_str(),
-                       ifstream::in | ifstream::binary | ifstream::ate );
-
-        if( !file.is_open() )
+        SliceSource source( src, w, h, 1, 0 );
+        if( !source.isOpen() )
             return lFailed( "Can't open volume file" );
 
-        ifstream::pos_type size;
-
-        size = min( (int)file.tellg(), (int)volume.size() );
-
-        file.seekg( 0, ios::beg );
-        file.read( (char*)( &volume[0] ), size );
-
-        file.close();
-    }
-
-//calculate and save derivatives
-    {
-        int result = calculateAndSaveDerivatives( dst, &volume[0], w,  h, d );
+        int result = calculateAndSaveDerivatives( dst, source, w,  h, d );
 
         if( result ) return result;
     }
@@ -526,42 +844,13 @@ int RawConverter::RecalculateDerivatives( const string& src,
     std::cout << "Creating derivatives for raw model: "
            << src << " " << w << " x " << h << " x " << d << endl;
 
-//read model
-    vector<unsigned char> volume( w*h*d*4, 0 );
-
-    std::cout << "Reading model" << endl;
+//calculate and save derivatives from the density channel
     {
-        ifstream file( src.c_str(),
-                       ifstream::in | ifstream::binary | ifstream::ate );
-
-        if( !file.is_open() )
+        SliceSource source( src, w, h, 4, 3 );
+        if( !source.isOpen() )
             return lFailed( "Can't open volume file" );
 
-        ifstream::pos_type size;
-
-        size = min( (int)file.tellg(), (int)volume.size() );
-
-        file.seekg( 0, ios::beg );
-        file.read( (char*)( &volume[0] ), size );
-
-        file.close();
-    }
-//remove derivatives
-    {
-        unsigned char* sr = &volume[3];
-        unsigned char* ds = &volume[0];
-        for( unsigned i = 3; i < w*h*d*4; i+=4 )
-        {
-            *ds = *sr;
-            sr += 4;
-            ++ds;
-        }
-        volume.resize( w*h*d );
-    }
-
-//calculate and save derivatives
-    {
-        int result = calculateAndSaveDerivatives( dst, &volume[0], w, h, d );
+        int result = calculateAndSaveDerivatives( dst, source, w, h, d );
 
         if( result ) return result;
     }
@@ -770,8 +1059,9 @@ int RawConverter::PvmSavToRawDerVhfConverter(     const string& src,
             << endl;
 
     // calculating derivatives
+    SliceSource source( volume, width, height );
     int result =
-        calculateAndSaveDerivatives( dst, volume, width,  height, depth );
+        calculateAndSaveDerivatives( dst, source, width,  height, depth );
 
     free( volume );
     if( result ) return result;
@@ -946,8 +1236,117 @@ int RawConverter::ScaleRawDerFile(                  const string& src,
 }
 
 
+/** Downsample a volume by two in each dimension, averaging all channels
+*/
+int RawConverter::RawToBricksConverter( const string& src, const string& dst )
+{
+    const unsigned brickSize = 32;
+    unsigned w, h, d;
+//read header
+    {
+        string configFileName = src;
+        hFile info( fopen( configFileName.append( ".vhf" ).c_str(), "rb" ) );
+        FILE* file = info.f;
+
+        if( file==NULL ) return lFailed( "Can't open header file" );
+
+        readDimensionsFromSav( file, w, h, d );
+    }
+    const size_t srcLen = src.length();
+    const unsigned bytes =
+        ( srcLen >= 6 && src.substr( srcLen-6, 6 ) == "_d.raw" ) ? 4 : 1;
+
+    std::cout << "Bricking model: " << src << " " << w << " x " << h << " x "
+              << d << ", " << bytes << " bytes per voxel" << endl;
+
+    SliceSource source( src, w, h, bytes, SliceSource::ALL_CHANNELS );
+    if( !source.isOpen() )
+        return lFailed( "Can't open volume file" );
+    {
+        ifstream file( src.c_str(), ifstream::in | ifstream::binary |
+                                    ifstream::ate );
+        if( uint64_t( file.tellg( )) < uint64_t( w )*h*d*bytes )
+            return lFailed( "Volume file is too small" );
+    }
+
+//compute number of levels and brick table layout
+    eVolve::bricks::Header header;
+    header.magic     = eVolve::bricks::MAGIC;
+    header.version   = eVolve::bricks::VERSION;
+    header.width     = w;
+    header.height    = h;
+    header.depth     = d;
+    header.bytes     = bytes;
+    header.brickSize = brickSize;
+    header.nLevels   = 1;
+    while( eVolve::bricks::getLevelSize( w, header.nLevels-1 ) > brickSize ||
+           eVolve::bricks::getLevelSize( h, header.nLevels-1 ) > brickSize ||
+           eVolve::bricks::getLevelSize( d, header.nLevels-1 ) > brickSize )
+    {
+        ++header.nLevels;
+    }
+
+    size_t nBricks = 0;
+    for( unsigned l = 0; l < header.nLevels; ++l )
+        nBricks += size_t(
+            eVolve::bricks::getNumBricks(
+                eVolve::bricks::getLevelSize( w, l ), brickSize )) *
+            eVolve::bricks::getNumBricks(
+                eVolve::bricks::getLevelSize( h, l ), brickSize ) *
+            eVolve::bricks::getNumBricks(
+                eVolve::bricks::getLevelSize( d, l ), brickSize );
+
+    vector< eVolve::bricks::Info > infos( nBricks );
+    const uint64_t dataOffset =
+        sizeof( header ) + nBricks*sizeof( eVolve::bricks::Info );
+
+    ofstream file( dst.c_str(), ofstream::out | ofstream::binary |
+                                ofstream::trunc );
+    if( !file.is_open() )
+        return lFailed( "Can't open destination bricks file" );
+
+//stream level 0 slices through the writers of all levels
+    vector< LevelWriter* > levels( header.nLevels );
+    size_t firstBrick = nBricks;
+    for( int l = header.nLevels-1; l >= 0; --l )
+    {
+        firstBrick -= size_t(
+            eVolve::bricks::getNumBricks(
+                eVolve::bricks::getLevelSize( w, l ), brickSize )) *
+            eVolve::bricks::getNumBricks(
+                eVolve::bricks::getLevelSize( h, l ), brickSize ) *
+            eVolve::bricks::getNumBricks(
+                eVolve::bricks::getLevelSize( d, l ), brickSize );
+        levels[l] = new LevelWriter( file, header, l, firstBrick, dataOffset,
+                                     infos, l+1 < int( header.nLevels ) ?
+                                                levels[l+1] : 0 );
+    }
+
+    bool ok = true;
+    vector<unsigned char> slice( source.getSliceSize( ));
+    for( unsigned z = 0; z < d && ok; ++z )
+        ok = source.read( z, 1, &slice[0] ) && levels[0]->addSlice( &slice[0] );
+
+    for( size_t l = 0; l < levels.size(); ++l )
+        delete levels[l];
+    if( !ok )
+        return lFailed( "Can't write destination bricks file" );
+
+//write header and brick table
+    file.seekp( 0, ios::beg );
+    file.write( (char*)( &header ), sizeof( header ));
+    file.write( (char*)( &infos[0] ), nBricks*sizeof( eVolve::bricks::Info ));
+    if( !file )
+        return lFailed( "Can't write destination bricks file" );
+
+    std::cout << nBricks << " bricks in " << header.nLevels << " levels"
+              << endl << "done" << endl;
+    return 0;
+}
+
+
 static int calculateAndSaveDerivatives( const string& dst,
-                                        unsigned char *volume,
+                                        SliceSource& source,
                                         const unsigned w,
                                         const unsigned h,
                                         const unsigned d  )
@@ -959,76 +1358,46 @@ static int calculateAndSaveDerivatives( const string& dst,
     if( !file.is_open() )
         return lFailed( "Can't open destination volume file" );
 
-    const int wh = w*h;
-
-    const int ws = static_cast<int>( w );
+    // Slabs of slices are processed in parallel, with one halo slice on each
+    // side. Border slices and voxels have no derivatives and stay zero.
+    const size_t sliceSize = size_t( w )*h;
+    const unsigned slab = std::max( _slabDepth, 1u );
+    vector<unsigned char> in( ( slab+2 )*sliceSize );
+    vector<unsigned char> GxGyGzA( slab*sliceSize*4 );
 
-    vector<unsigned char> GxGyGzA( wh*d*4, 0 );
-
-    for( unsigned z=1; z<d-1; z++ )
+    for( unsigned z0 = 0; z0 < d; z0 += slab )
     {
-        const int zwh = z*wh;
+        const unsigned nSlices = min( slab, d - z0 );
+        const unsigned first = z0 > 0 ? z0-1 : 0; // halo slice before
+        const unsigned last  = min( z0 + nSlices + 1, d ); // halo slice after
+        if( !source.read( first, last - first, &in[0] ))
+            return lFailed( "Can't read volume file" );
 
-        const unsigned char *curPz = &volume[0] + zwh;
+        const unsigned char* const base = &in[0] - size_t( first )*sliceSize;
+        const int nSlabSlices = int( nSlices );
 
-        for( unsigned y=1; y<h-1; y++ )
+#pragma omp parallel for
+        for( int i = 0; i < nSlabSlices; ++i )
         {
-            const int zwh_y = zwh + y*w;
-            const unsigned char * curPy = curPz + y*w;
-            for( unsigned x=1; x<w-1; x++ )
-            {
-                const unsigned char * curP = curPy +  x;
-                const unsigned char * prvP = curP  - wh;
-                const unsigned char * nxtP = curP  + wh;
-                int gx =
-                      nxtP[  ws+1 ]+ 3*curP[  ws+1 ]+   prvP[  ws+1 ]+
-                    3*nxtP[     1 ]+ 6*curP[     1 ]+ 3*prvP[     1 ]+
-                      nxtP[ -ws+1 ]+ 3*curP[ -ws+1 ]+   prvP[ -ws+1 ]-
-
-                      nxtP[  ws-1 ]- 3*curP[  ws-1 ]-   prvP[  ws-1 ]-
-                    3*nxtP[    -1 ]- 6*curP[    -1 ]- 3*prvP[    -1 ]-
-                      nxtP[ -ws-1 ]- 3*curP[ -ws-1 ]-   prvP[ -ws-1 ];
-
-                int gy =
-                      nxtP[  ws+1 ]+ 3*curP[  ws+1 ]+   prvP[  ws+1 ]+
-                    3*nxtP[  ws   ]+ 6*curP[  ws   ]+ 3*prvP[  ws   ]+
-                      nxtP[  ws-1 ]+ 3*curP[  ws-1 ]+   prvP[  ws-1 ]-
-
-                      nxtP[ -ws+1 ]- 3*curP[ -ws+1 ]-   prvP[ -ws+1 ]-
-                    3*nxtP[ -ws   ]- 6*curP[ -ws   ]- 3*prvP[ -ws   ]-
-                      nxtP[ -ws-1 ]- 3*curP[ -ws-1 ]-   prvP[ -ws-1 ];
-
-                int gz =
-                      nxtP[  ws+1 ]+ 3*nxtP[    1 ]+   nxtP[ -ws+1 ]+
-                    3*nxtP[  ws   ]+ 6*nxtP[    0 ]+ 3*nxtP[ -ws   ]+
-                      nxtP[  ws-1 ]+ 3*nxtP[   -1 ]+   nxtP[ -ws-1 ]-
-
-                      prvP[  ws+1 ]- 3*prvP[    1 ]-   prvP[ -ws+1 ]-
-                    3*prvP[  ws   ]- 6*prvP[    0 ]- 3*prvP[ -ws   ]-
-                      prvP[  ws-1 ]- 3*prvP[   -1 ]-   prvP[ -ws-1 ];
-
-                int length = static_cast<int>(
-                                        sqrt(double((gx*gx+gy*gy+gz*gz))+1));
-
-                gx = ( gx*255/length + 255 )/2;
-                gy = ( gy*255/length + 255 )/2;
-                gz = ( gz*255/length + 255 )/2;
-
-                GxGyGzA[(zwh_y + x)*4   ] = static_cast<unsigned char>( gx );
-                GxGyGzA[(zwh_y + x)*4 +1] = static_cast<unsigned char>( gy );
-                GxGyGzA[(zwh_y + x)*4 +2] = static_cast<unsigned char>( gz );
-                GxGyGzA[(zwh_y + x)*4 +3] = curP[0];
-            }
+            const unsigned z = z0 + i;
+            unsigned char* out = &GxGyGzA[ i*sliceSize*4 ];
+            if( z == 0 || z >= d-1 )
+                memset( out, 0, sliceSize*4 );
+            else
+                computeGradientSlice( base + ( z-1 )*sliceSize,
+                                      base + z*sliceSize,
+                                      base + ( z+1 )*sliceSize, w, h, out );
         }
-    }
 
-    std::cout << "Writing derivatives: "
-           << dst.c_str() << " " << GxGyGzA.size() << " bytes" <<endl;
+        file.write( (char*)( &GxGyGzA[0] ), nSlices*sliceSize*4 );
+        if( !file )
+            return lFailed( "Can't write destination volume file" );
 
-    file.write( (char*)( &GxGyGzA[0] ), GxGyGzA.size() );
-
-    file.close();
+        std::cout << "\r" << z0 + nSlices << "/" << d << " slices" << flush;
+    }
 
+    std::cout << endl << "Wrote derivatives: " << dst.c_str() << " "
+              << sliceSize*d*4 << " bytes" << endl;
     return 0;
 }
 
@@ -1,5 +1,5 @@
 
-/* Copyright (c) 2012-2014, Stefan Eilemann <eile@eyescale.ch>
+/* Copyright (c) 2012-2015, Stefan Eilemann <eile@eyescale.ch>
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -29,8 +29,29 @@
 #include <eq/eq.h>
 #include <triply/vertexBufferRoot.h>
 
+#include <lunchbox/clock.h>
+#include <lunchbox/lock.h>
+#include <lunchbox/monitor.h>
+#include <lunchbox/scopedMutex.h>
+
+#pragma warning( disable: 4275 )
+#include <boost/program_options.hpp>
+#pragma warning( default: 4275 )
+
+#include <algorithm>
+#include <limits>
+#include <sys/stat.h>
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
+
+namespace po = boost::program_options;
+
 namespace
 {
+/** Estimated peak memory of a conversion in multiples of the PLY size. */
+static const size_t _memoryFactor = 4;
+
 static bool _isPlyfile( const std::string& filename )
 {
     const size_t size = filename.length();
@@ -44,40 +65,189 @@ static bool _isPlyfile( const std::string& filename )
     }
     return true;
 }
+
+/** @return false if the file does not exist. */
+static bool _stat( const std::string& filename, size_t& size, time_t& time )
+{
+    struct stat status;
+    if( ::stat( filename.c_str(), &status ) != 0 )
+        return false;
+    size = size_t( status.st_size );
+    time = status.st_mtime;
+    return true;
+}
+
+/** @return true if the binary of the PLY file is newer than the PLY file. */
+static bool _isConverted( const std::string& filename )
+{
+    size_t size = 0;
+    time_t plyTime = 0;
+    time_t binaryTime = 0;
+    return _stat( filename, size, plyTime ) &&
+           _stat( triply::VertexBufferRoot::getCacheFilename( filename ),
+                  size, binaryTime ) &&
+           binaryTime >= plyTime;
+}
+
+/** Limits the memory used by concurrent conversions. */
+class MemoryBudget
+{
+public:
+    explicit MemoryBudget( const size_t size ) : _size( size ), _used( 0 ) {}
+
+    /** Wait until the given amount fits, a single conversion always fits. */
+    void acquire( const size_t amount )
+    {
+        for( ;; )
+        {
+            size_t used = 0;
+            {
+                lunchbox::ScopedWrite mutex( _lock );
+                used = _used.get();
+                if( used == 0 || used + amount <= _size )
+                {
+                    _used += amount;
+                    return;
+                }
+            }
+            _used.waitNE( used );
+        }
+    }
+
+    void release( const size_t amount )
+    {
+        lunchbox::ScopedWrite mutex( _lock );
+        _used -= amount;
+    }
+
+private:
+    const size_t _size;
+    lunchbox::Lock _lock;
+    lunchbox::Monitor< size_t > _used;
+};
 }
 
 int main( const int argc, char** argv )
 {
-    eq::Strings filenames;
-    for( int i=1; i < argc; ++i )
-        filenames.push_back( argv[i] );
+    eq::Strings inputs;
+    int jobs = 1;
+    size_t memory = 0;
+    bool force = false;
+    bool quiet = false;
 
-    while( !filenames.empty( ))
+#ifdef _OPENMP
+    jobs = omp_get_num_procs();
+#endif
+
+    po::options_description options( "eqPlyConverter - convert PLY files "
+                                     "into binary kd-tree caches" );
+    options.add_options()
+        ( "help,h", "produce help message" )
+        ( "jobs,j", po::value< int >( &jobs )->default_value( jobs ),
+          "number of files converted in parallel" )
+        ( "memory,m", po::value< size_t >( &memory ),
+          "memory budget for parallel conversions in MB, unlimited if 0" )
+        ( "force,f", po::bool_switch( &force ),
+          "convert files with an up-to-date binary" )
+        ( "quiet,q", po::bool_switch( &quiet ), "do not report progress" )
+        ( "input", po::value< eq::Strings >( &inputs ),
+          "PLY files and directories to convert" );
+
+    po::positional_options_description positional;
+    positional.add( "input", -1 );
+
+    po::variables_map variableMap;
+    try
     {
-        const std::string filename = filenames.back();
-        filenames.pop_back();
+        po::store( po::command_line_parser( argc, argv ).options( options ).
+                   positional( positional ).run(), variableMap );
+        po::notify( variableMap );
+    }
+    catch( const std::exception& e )
+    {
+        std::cerr << e.what() << std::endl << options << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if( variableMap.count( "help" ))
+    {
+        std::cout << options << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // collect PLY files, recursively searching directories
+    eq::Strings filenames;
+    while( !inputs.empty( ))
+    {
+        const std::string filename = inputs.back();
+        inputs.pop_back();
 
         if( _isPlyfile( filename ))
         {
-            triply::VertexBufferRoot* model = new triply::VertexBufferRoot;
-            if( !model->readFromFile( filename.c_str( )))
-                LBWARN << "Can't load model: " << filename << std::endl;
-
-            delete model;
+            if( force || !_isConverted( filename ))
+                filenames.push_back( filename );
+            continue;
         }
-        else
-        {
-            const std::string basename = lunchbox::getFilename( filename );
-            if( basename == "." || basename == ".." )
-                continue;
 
-            // recursively search directories
-            const eq::Strings& subFiles =
-                lunchbox::searchDirectory( filename, ".*" );
+        const std::string basename = lunchbox::getFilename( filename );
+        if( basename == "." || basename == ".." )
+            continue;
+
+        const eq::Strings& subFiles = lunchbox::searchDirectory( filename,
+                                                                 ".*" );
+        for( eq::StringsCIter i = subFiles.begin(); i != subFiles.end(); ++i )
+            inputs.push_back( filename + '/' + *i );
+    }
+
+    // largest files first for a better parallel schedule
+    std::vector< std::pair< size_t, std::string > > files;
+    for( eq::StringsCIter i = filenames.begin(); i != filenames.end(); ++i )
+    {
+        size_t size = 0;
+        time_t time = 0;
+        _stat( *i, size, time );
+        files.push_back( std::make_pair( size, *i ));
+    }
+    std::sort( files.rbegin(), files.rend( ));
+
+    MemoryBudget budget( memory == 0 ? std::numeric_limits< size_t >::max() :
+                                       memory * 1024 * 1024 );
+    lunchbox::Lock outputLock;
+    lunchbox::Clock clock;
+    const int nFiles = int( files.size( ));
+    int nDone = 0;
+    int nFailed = 0;
+
+#pragma omp parallel for schedule( dynamic ) num_threads( jobs )
+    for( int i = 0; i < nFiles; ++i )
+    {
+        const std::string& filename = files[i].second;
+        const size_t estimate = files[i].first * _memoryFactor;
+        budget.acquire( estimate );
+
+        const float start = clock.getTimef();
+        triply::VertexBufferRoot* model = new triply::VertexBufferRoot;
+        const bool converted = model->convertFromPly( filename );
+        delete model;
+        budget.release( estimate );
 
-            for(eq::StringsCIter i = subFiles.begin(); i != subFiles.end(); ++i)
-                filenames.push_back( filename + '/' + *i );
+        lunchbox::ScopedWrite mutex( outputLock );
+        ++nDone;
+        if( !converted )
+        {
+            ++nFailed;
+            LBWARN << "Can't convert model: " << filename << std::endl;
         }
+        if( !quiet )
+            std::cout << "[" << nDone << "/" << nFiles << "] " << filename
+                      << ( converted ? "" : " failed" ) << " in "
+                      << ( clock.getTimef() - start ) / 1000.f << " s"
+                      << std::endl;
     }
-    return EXIT_SUCCESS;
+
+    if( !quiet )
+        std::cout << nFiles - nFailed << " of " << nFiles << " files "
+                  << "converted in " << clock.getTimef() / 1000.f << " s"
+                  << std::endl;
+    return nFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
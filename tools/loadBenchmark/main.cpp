@@ -0,0 +1,287 @@
+
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * Runs the equalizers of a config file offline and reports how fast they
+ * converge, how well they balance the load and what they cost on the server.
+ *
+ * The load is either synthetic or replayed from a trace recorded by a running
+ * server with EQ_LOAD_TRACE_FILE set. A replay reproduces the recorded task
+ * assignments unless the equalizers changed, --verify turns differences into
+ * a failure.
+ */
+
+#include <eq/server/config.h>
+#include <eq/server/init.h>
+#include <eq/server/loadBenchmark.h>
+#include <eq/server/loadTrace.h>
+#include <eq/server/loader.h>
+#include <eq/server/server.h>
+
+#pragma warning( disable: 4275 )
+#include <boost/program_options.hpp>
+#pragma warning( default: 4275 )
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace po = boost::program_options;
+using eq::server::LoadBenchmark;
+
+namespace
+{
+typedef std::vector< LoadBenchmark::Result > Results;
+
+void _printSummary( const Results& results, const float epsilon,
+                    const std::string& prefix )
+{
+    float updateTime = 0.f;
+    float maxUpdateTime = 0.f;
+    float loadTime = 0.f;
+    float maxError = 0.f;
+    size_t converged = 0; // first frame of the stable tail
+    for( size_t i = 0; i < results.size(); ++i )
+    {
+        const LoadBenchmark::Result& result = results[i];
+        updateTime += result.updateTime;
+        maxUpdateTime = std::max( maxUpdateTime, result.updateTime );
+        loadTime += result.loadTime;
+        maxError = std::max( maxError, result.assignmentError );
+        if( result.splitChange >= epsilon )
+            converged = i + 1;
+    }
+
+    // imbalance over the last tenth of the run
+    const size_t nTail = std::max( results.size() / 10, size_t( 1 ));
+    float imbalance = 0.f;
+    for( size_t i = results.size() - nTail; i < results.size(); ++i )
+        imbalance += results[i].imbalance;
+    imbalance /= float( nTail );
+
+    const float nFrames = float( results.size( ));
+    std::cout << prefix << "frames " << results.size() << std::endl
+              << prefix << "update " << 1000.f * updateTime / nFrames
+              << " us mean, " << 1000.f * maxUpdateTime << " us max"
+              << std::endl
+              << prefix << "load data " << 1000.f * loadTime / nFrames
+              << " us mean" << std::endl
+              << prefix << "imbalance " << results.front().imbalance
+              << " first, " << imbalance << " last " << nTail << " frames"
+              << std::endl << prefix << "converged ";
+
+    if( converged < results.size( ))
+        std::cout << "after frame " << results[ converged ].frameNumber;
+    else
+        std::cout << "never, split change >= " << epsilon;
+    std::cout << std::endl
+              << prefix << "assignment error " << maxError << " max"
+              << std::endl;
+}
+
+float _getMaxError( const Results& results )
+{
+    float error = 0.f;
+    for( size_t i = 0; i < results.size(); ++i )
+        error = std::max( error, results[i].assignmentError );
+    return error;
+}
+}
+
+int main( const int argc, char** argv )
+{
+    std::string configFile;
+    std::string replayFile;
+    std::string recordFile;
+    std::string format( "text" );
+    uint32_t nFrames = 200;
+    int32_t latency = -1;
+    float epsilon = .001f;
+    bool print = false;
+    bool verify = false;
+    LoadBenchmark::Model model;
+
+    po::options_description options(
+        "eqLoadBenchmark - offline equalizer benchmark" );
+    options.add_options()
+        ( "help,h", "produce help message" )
+        ( "config,c", po::value< std::string >( &configFile ),
+          "config file (.eqc) with the equalizers to benchmark" )
+        ( "frames,n", po::value< uint32_t >( &nFrames )->default_value(
+              nFrames ), "number of frames, all frames of a replay if 0" )
+        ( "replay,r", po::value< std::string >( &replayFile ),
+          "replay a load trace recorded with EQ_LOAD_TRACE_FILE" )
+        ( "record,o", po::value< std::string >( &recordFile ),
+          "record the tasks and load data of the benchmark as a load trace" )
+        ( "print,p", po::bool_switch( &print ),
+          "print the replay trace and exit" )
+        ( "verify", po::bool_switch( &verify ),
+          "fail if a replay deviates from the recorded tasks by epsilon" )
+        ( "format,f", po::value< std::string >( &format )->default_value(
+              format ), "per-frame output: text, csv or none" )
+        ( "latency", po::value< int32_t >( &latency ),
+          "frames until load data arrives, the config latency by default" )
+        ( "epsilon", po::value< float >( &epsilon )->default_value( epsilon ),
+          "split change below which the split is converged or replayed" )
+        ( "frame-time", po::value< float >( &model.frameTime )->default_value(
+              model.frameTime ), "time to render everything (ms)" )
+        ( "assemble-time", po::value< float >( &model.assembleTime ),
+          "time to assemble one input frame (ms)" )
+        ( "hotspot", po::value< float >( &model.hotspot ),
+          "fraction of the cost in a hotspot [0,1]" )
+        ( "hotspot-radius", po::value< float >( &model.hotspotRadius ),
+          "radius of the hotspot" )
+        ( "hotspot-speed", po::value< float >( &model.hotspotSpeed ),
+          "movement of the hotspot in radians per frame" )
+        ( "noise", po::value< float >( &model.noise ),
+          "relative random variation of the task times" )
+        ( "speeds", po::value< std::vector< float > >(
+              &model.speeds )->multitoken(),
+          "speed of each channel, in config file order" );
+
+    po::positional_options_description positional;
+    positional.add( "config", 1 );
+
+    po::variables_map variableMap;
+    try
+    {
+        po::store( po::command_line_parser( argc, argv ).options( options ).
+                   positional( positional ).run(), variableMap );
+        po::notify( variableMap );
+    }
+    catch( const std::exception& e )
+    {
+        std::cerr << e.what() << std::endl << options << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if( variableMap.count( "help" ) || configFile.empty( ))
+    {
+        std::cout << options << std::endl;
+        return variableMap.count( "help" ) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if( print )
+    {
+        eq::server::LoadTrace::Frames frames;
+        if( !eq::server::LoadTrace::read( replayFile, frames ))
+            return EXIT_FAILURE;
+        eq::server::LoadTrace::print( std::cout, frames );
+        return EXIT_SUCCESS;
+    }
+
+    if( nFrames == 0 && replayFile.empty( ))
+    {
+        std::cerr << "Synthetic benchmarks need a number of frames" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if( !eq::server::init( argc, argv ))
+        return EXIT_FAILURE;
+
+    eq::server::Loader loader;
+    eq::server::ServerPtr server = loader.loadFile( configFile );
+    if( !server || server->getConfigs().empty( ))
+    {
+        std::cerr << "Can't load config " << configFile << std::endl;
+        eq::server::exit();
+        return EXIT_FAILURE;
+    }
+
+    eq::server::Loader::addOutputCompounds( server );
+    eq::server::Loader::addDestinationViews( server );
+    eq::server::Loader::addDefaultObserver( server );
+    eq::server::Loader::convertTo11( server );
+    eq::server::Loader::convertTo12( server );
+
+    int result = EXIT_SUCCESS;
+    {
+        LoadBenchmark benchmark( server->getConfigs().front( ));
+        benchmark.setModel( model );
+        if( latency >= 0 )
+            benchmark.setLatency( latency );
+
+        eq::server::LoadTrace::Frames frames;
+        if( !replayFile.empty( ))
+        {
+            if( !eq::server::LoadTrace::read( replayFile, frames ) ||
+                frames.empty( ))
+            {
+                std::cerr << "Can't replay " << replayFile << std::endl;
+                result = EXIT_FAILURE;
+            }
+            benchmark.setReplay( frames );
+        }
+
+        eq::server::LoadTrace recorder;
+        if( !recordFile.empty( ))
+        {
+            if( recorder.open( recordFile ))
+                benchmark.setRecorder( &recorder );
+            else
+                result = EXIT_FAILURE;
+        }
+
+        if( result == EXIT_SUCCESS && benchmark.init( ))
+        {
+            if( format == "csv" )
+                std::cout << "frame,update_us,load_us,imbalance,split_change,"
+                          << "assignment_error,tasks" << std::endl;
+
+            Results results;
+            while( nFrames == 0 ? !benchmark.isReplayDone() :
+                                  results.size() < nFrames )
+            {
+                results.push_back( benchmark.step( ));
+                const LoadBenchmark::Result& frame = results.back();
+                if( format == "csv" )
+                    std::cout << frame.frameNumber << ","
+                              << 1000.f * frame.updateTime << ","
+                              << 1000.f * frame.loadTime << ","
+                              << frame.imbalance << "," << frame.splitChange
+                              << "," << frame.assignmentError << ","
+                              << frame.nTasks << std::endl;
+                else if( format == "text" )
+                    std::cout << "frame " << frame.frameNumber << " update "
+                              << 1000.f * frame.updateTime << " us, load "
+                              << 1000.f * frame.loadTime << " us, imbalance "
+                              << frame.imbalance << ", split change "
+                              << frame.splitChange << ", assignment error "
+                              << frame.assignmentError << ", "
+                              << frame.nTasks << " tasks" << std::endl;
+            }
+            benchmark.exit();
+
+            if( !results.empty( ))
+                _printSummary( results, epsilon,
+                               format == "csv" ? "# " : "" );
+            if( verify && _getMaxError( results ) >= epsilon )
+            {
+                std::cerr << "Replay deviates from the recorded tasks"
+                          << std::endl;
+                result = EXIT_FAILURE;
+            }
+        }
+        else
+            result = EXIT_FAILURE;
+    }
+
+    server->deleteConfigs();
+    if( !eq::server::exit( ))
+        result = EXIT_FAILURE;
+    return result;
+}
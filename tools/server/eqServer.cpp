@@ -26,6 +26,7 @@
 #include <co/global.h>
 #include <co/init.h>
 
+#include <cstdlib>
 #include <iostream>
 
 #define CONFIG "server{ config{ appNode{ pipe {                            \
@@ -81,6 +82,15 @@ int main( const int argc, char** argv )
         return EXIT_FAILURE;
     }
 
+    for( int i = 1; i < argc - 1; ++i )
+    {
+        if( std::string( argv[i] ) == "--eq-metrics-port" &&
+            !server->startMetrics( uint16_t( atoi( argv[i + 1] ))))
+        {
+            LBWARN << "Metrics endpoint not available" << std::endl;
+        }
+    }
+
     server->run();
     server->exitLocal();
     server->deleteConfigs();
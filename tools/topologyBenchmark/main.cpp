@@ -0,0 +1,265 @@
+/* Copyright (c) 2015, Stefan Eilemann <eile@eyescale.ch>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the transfer bandwidths of the local host and writes them to the
+// topology profile used for the automatic pipe thread placement.
+
+#include <eq/eq.h>
+
+#pragma warning( disable: 4275 )
+#include <boost/program_options.hpp>
+#pragma warning( default: 4275 )
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace po = boost::program_options;
+
+namespace
+{
+const size_t _memcpySize = 64 * LB_1MB;
+const uint32_t _nRepeats = 10;
+const int32_t _width = 1920;
+const int32_t _height = 1200;
+
+uint32_t _nSockets = 0;
+lunchbox::Lock _lock;
+std::vector< std::string > _results;
+
+uint32_t _detectSockets()
+{
+    uint32_t nSockets = 0;
+    for( ;; ++nSockets )
+    {
+        std::ostringstream path;
+        path << "/sys/devices/system/node/node" << nSockets;
+        if( !std::ifstream( ( path.str() + "/cpumap" ).c_str( )).is_open( ))
+            break;
+    }
+    return nSockets > 0 ? nSockets : 1;
+}
+
+std::string _getDefaultFilename()
+{
+    // keep in sync with eq::detail::topologyProfile::getFilename()
+    const char* env = ::getenv( "EQ_TOPOLOGY_PROFILE" );
+    if( env )
+        return env;
+    const char* home = ::getenv( "HOME" );
+    return home ? std::string( home ) + "/.eqTopologyProfile" : std::string();
+}
+
+float _getBandwidth( const size_t size, const float time )
+{
+    return time > 0.f ? float( size ) * 1000.f / time / float( LB_1MB ) : 0.f;
+}
+
+void _benchmarkMemcpy()
+{
+    for( uint32_t src = 0; src < _nSockets; ++src )
+    {
+        // first touch on the source socket allocates its memory locally
+        lunchbox::Thread::setAffinity( lunchbox::Thread::SOCKET + src );
+        std::vector< uint8_t > source( _memcpySize, 1 );
+
+        for( uint32_t dst = 0; dst < _nSockets; ++dst )
+        {
+            lunchbox::Thread::setAffinity( lunchbox::Thread::SOCKET + dst );
+            std::vector< uint8_t > destination( _memcpySize, 0 );
+
+            lunchbox::Clock clock;
+            for( uint32_t i = 0; i < _nRepeats; ++i )
+                ::memcpy( &destination[0], &source[0], _memcpySize );
+            const float time = clock.getTimef();
+
+            std::ostringstream result;
+            result << "memcpy " << src << " " << dst << " "
+                   << _getBandwidth( _memcpySize * _nRepeats, time );
+            _results.push_back( result.str( ));
+        }
+    }
+    lunchbox::Thread::setAffinity( lunchbox::Thread::NONE );
+}
+
+class Window : public eq::Window
+{
+public:
+    explicit Window( eq::Pipe* parent ) : eq::Window( parent ) {}
+
+protected:
+    bool configInitGL( const eq::uint128_t& initID ) override
+    {
+        if( !eq::Window::configInitGL( initID ))
+            return false;
+
+        eq::util::FrameBufferObject fbo( glewGetContext( ));
+        if( fbo.init( _width, _height, GL_RGBA, 0, 0 ))
+        {
+            LBWARN << "Can't create FBO for GPU benchmark" << std::endl;
+            return true;
+        }
+
+        const size_t size = _width * _height * 4;
+        const eq::Pipe* pipe = getPipe();
+        for( uint32_t socket = 0; socket < _nSockets; ++socket )
+        {
+            lunchbox::Thread::setAffinity( lunchbox::Thread::SOCKET + socket);
+            std::vector< uint8_t > pixels( size, 0 );
+
+            glFinish();
+            lunchbox::Clock clock;
+            for( uint32_t i = 0; i < _nRepeats; ++i )
+                glReadPixels( 0, 0, _width, _height, GL_BGRA, GL_UNSIGNED_BYTE,
+                              &pixels[0] );
+            const float readback = _getBandwidth( size * _nRepeats,
+                                                  clock.resetTimef( ));
+
+            const eq::util::Texture* texture = fbo.getColorTextures().front();
+            texture->bind();
+            for( uint32_t i = 0; i < _nRepeats; ++i )
+                glTexSubImage2D( texture->getTarget(), 0, 0, 0, _width, _height,
+                                 GL_BGRA, GL_UNSIGNED_BYTE, &pixels[0] );
+            glFinish();
+            const float upload = _getBandwidth( size * _nRepeats,
+                                                clock.getTimef( ));
+
+            std::ostringstream result;
+            result << "gpu " << pipe->getPort() << " " << pipe->getDevice()
+                   << " " << socket << " " << readback << " " << upload;
+
+            lunchbox::ScopedWrite mutex( _lock );
+            _results.push_back( result.str( ));
+        }
+
+        fbo.exit();
+        return true;
+    }
+};
+
+class NodeFactory : public eq::NodeFactory
+{
+public:
+    eq::Window* createWindow( eq::Pipe* parent ) override
+        { return new Window( parent ); }
+};
+
+bool _benchmarkGPUs( int argc, char** argv )
+{
+    bool success = false;
+    NodeFactory nodeFactory;
+    if( !eq::init( argc, argv, &nodeFactory ))
+    {
+        LBERROR << "Equalizer init failed" << std::endl;
+        return false;
+    }
+
+    eq::ClientPtr client = new eq::Client;
+    if( client->initLocal( argc, argv ))
+    {
+        eq::ServerPtr server = new eq::Server;
+        if( client->connectServer( server ))
+        {
+            eq::fabric::ConfigParams configParams;
+            eq::Global::setConfigFile( "local" );
+            eq::Config* config = server->chooseConfig( configParams );
+            if( config )
+            {
+                success = config->init( eq::uint128_t( ));
+                config->exit();
+                server->releaseConfig( config );
+            }
+            else
+                LBERROR << "No matching config on server" << std::endl;
+
+            client->disconnectServer( server );
+        }
+        else
+            LBERROR << "Can't open server" << std::endl;
+
+        client->exitLocal();
+    }
+    eq::exit();
+    return success;
+}
+}
+
+int main( int argc, char** argv )
+{
+    std::string filename = _getDefaultFilename();
+
+    po::options_description options(
+        "eqTopologyBenchmark - measure the transfer bandwidths of this host" );
+    options.add_options()
+        ( "help,h", "produce help message" )
+        ( "sockets,s", po::value< uint32_t >( &_nSockets ),
+          "number of CPU sockets, detected by default" )
+        ( "output,o", po::value< std::string >( &filename )->default_value(
+              filename ), "topology profile to write" );
+
+    po::variables_map variableMap;
+    try
+    {
+        po::store( po::command_line_parser( argc, argv ).options( options ).
+                   allow_unregistered().run(), variableMap );
+        po::notify( variableMap );
+    }
+    catch( const std::exception& e )
+    {
+        std::cerr << e.what() << std::endl << options << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if( variableMap.count( "help" ) || filename.empty( ))
+    {
+        std::cout << options << std::endl;
+        return variableMap.count( "help" ) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if( _nSockets == 0 )
+        _nSockets = _detectSockets();
+
+    _benchmarkMemcpy();
+    if( !_benchmarkGPUs( argc, argv ))
+        LBWARN << "GPU benchmark failed, writing memcpy results only"
+               << std::endl;
+
+    std::ofstream file( filename.c_str( ));
+    if( !file.is_open( ))
+    {
+        LBERROR << "Can't write " << filename << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    for( const std::string& result : _results )
+    {
+        file << result << std::endl;
+        std::cout << result << std::endl;
+    }
+    return EXIT_SUCCESS;
+}